@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/BuiltinWrappers.h>
 #include <AK/ByteBuffer.h>
 #include <AK/Concepts.h>
 #include <AK/MaybeOwned.h>
@@ -63,24 +64,25 @@ public:
         size_t nread = 0;
         while (nread < count) {
             if (m_current_byte.has_value()) {
-                if constexpr (!IsSame<bool, T> && !IsSame<u8, T>) {
-                    // read as many bytes as possible directly
-                    if (((count - nread) >= 8) && is_aligned_to_byte_boundary()) {
-                        // shift existing data over
-                        result <<= 8;
-                        result |= m_current_byte.value();
-                        nread += 8;
-                        m_current_byte.clear();
+                if constexpr (!IsSame<bool, T>) {
+                    // read as many bits as possible from the current byte at once
+                    size_t const bits_left_in_byte = 8 - m_bit_offset;
+                    size_t const bits_to_read = min(count - nread, bits_left_in_byte);
+                    auto const bits = (m_current_byte.value() >> (bits_left_in_byte - bits_to_read)) & ((1u << bits_to_read) - 1);
+                    // shift existing data over
+                    if constexpr (sizeof(T) == 1) {
+                        // Shifting a u8 by its full width is fine, since it is promoted to int first.
+                        result = static_cast<T>((result << bits_to_read) | bits);
                     } else {
-                        auto const bit = (m_current_byte.value() >> (7 - m_bit_offset)) & 1;
-                        result <<= 1;
-                        result |= bit;
-                        ++nread;
-                        if (m_bit_offset++ == 7)
-                            m_current_byte.clear();
+                        result <<= bits_to_read;
+                        result |= bits;
                     }
+                    nread += bits_to_read;
+                    m_bit_offset += bits_to_read;
+                    if (m_bit_offset == 8)
+                        m_current_byte.clear();
                 } else {
-                    // Always take this branch for booleans or u8: there's no purpose in reading more than a single bit
+                    // Always take this branch for booleans: there's no purpose in reading more than a single bit
                     auto const bit = (m_current_byte.value() >> (7 - m_bit_offset)) & 1;
                     if constexpr (IsSame<bool, T>)
                         result = bit;
@@ -101,6 +103,34 @@ public:
         return result;
     }
 
+    /// Reads zero bits up to and including the next one bit, and returns the number of zero bits.
+    /// This decodes a unary number, as used for example in Rice codes, one byte at a time.
+    ErrorOr<size_t> read_unary_zeros()
+    {
+        size_t zero_count = 0;
+        while (true) {
+            if (!m_current_byte.has_value()) {
+                m_current_byte = TRY(m_stream->read_value<u8>());
+                m_bit_offset = 0;
+            }
+
+            u8 const remaining_bits = static_cast<u8>(m_current_byte.value() << m_bit_offset);
+            if (remaining_bits == 0) {
+                zero_count += 8 - m_bit_offset;
+                m_bit_offset = 8;
+                m_current_byte.clear();
+                continue;
+            }
+
+            size_t const leading_zeros = count_leading_zeroes(remaining_bits);
+            zero_count += leading_zeros;
+            m_bit_offset += leading_zeros + 1;
+            if (m_bit_offset == 8)
+                m_current_byte.clear();
+            return zero_count;
+        }
+    }
+
     /// Discards any sub-byte stream positioning the input stream may be keeping track of.
     /// Non-bitwise reads will implicitly call this.
     void align_to_byte_boundary()
@@ -233,6 +263,32 @@ public:
         m_bit_count -= count;
     }
 
+    /// Tries to have at least `count` bits buffered, so that they can be peeked at and discarded without going back to
+    /// the underlying stream. Unlike peek_bits(), reaching the end of the stream first is not an error (and with
+    /// FillWithZero, the missing bits are zero as usual). Returns the number of bits that are buffered.
+    ALWAYS_INLINE ErrorOr<size_t> fill_bit_buffer(size_t count)
+    {
+        VERIFY(count <= bit_buffer_size - bits_per_byte + 1);
+
+        while (count > m_bit_count) {
+            if (m_stream->is_eof()) {
+                if (m_unsatisfiable_read_behavior == UnsatisfiableReadBehavior::FillWithZero)
+                    m_bit_count = count;
+                break;
+            }
+
+            size_t bytes_to_read = (bit_buffer_size - m_bit_count) / bits_per_byte;
+
+            BufferType buffer = 0;
+            auto bytes = TRY(m_stream->read_some({ &buffer, bytes_to_read }));
+
+            m_bit_buffer |= (buffer << m_bit_count);
+            m_bit_count += bytes.size() * bits_per_byte;
+        }
+
+        return m_bit_count;
+    }
+
     /// Discards any sub-byte stream positioning the input stream may be keeping track of.
     /// Non-bitwise reads will implicitly call this.
     u8 align_to_byte_boundary()
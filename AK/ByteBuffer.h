@@ -178,6 +178,12 @@ public:
         m_size = 0;
     }
 
+    // Empties the buffer without giving up its storage, for buffers that are filled and drained over and over.
+    void clear_with_capacity()
+    {
+        m_size = 0;
+    }
+
     enum class ZeroFillNewElements {
         No,
         Yes,
@@ -255,6 +255,26 @@ ErrorOr<size_t> CircularBuffer::copy_from_seekback(size_t distance, size_t lengt
     if (distance > m_seekback_limit)
         return Error::from_string_literal("Tried a seekback copy beyond the seekback limit");
 
+    // Most copies are short and neither read nor write across the end of the buffer, so they can be done directly, a
+    // word at a time if the source is at least a word behind the destination.
+    auto write_span = next_write_span();
+    if (distance > 0 && length <= write_span.size() && distance <= static_cast<size_t>(write_span.data() - m_buffer.data())) {
+        auto* destination = write_span.data();
+        auto const* source = destination - distance;
+
+        size_t offset = 0;
+        if (distance >= sizeof(u64)) {
+            for (; offset + sizeof(u64) <= length; offset += sizeof(u64))
+                __builtin_memcpy(destination + offset, source + offset, sizeof(u64));
+        }
+        for (; offset < length; ++offset)
+            destination[offset] = source[offset];
+
+        m_used_space += length;
+        m_seekback_limit = min(m_seekback_limit + length, capacity());
+        return length;
+    }
+
     auto remaining_length = length;
     while (remaining_length > 0) {
         if (empty_space() == 0)
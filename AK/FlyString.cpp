@@ -11,6 +11,7 @@
 #include <AK/String.h>
 #include <AK/StringData.h>
 #include <AK/StringView.h>
+#include <AK/SwissHashTable.h>
 #include <AK/Utf8View.h>
 
 namespace AK {
@@ -20,9 +21,10 @@ struct FlyStringTableHashTraits : public Traits<Detail::StringData const*> {
     static bool equals(Detail::StringData const* a, Detail::StringData const* b) { return *a == *b; }
 };
 
+// NOTE: Like the reference counts of StringData, this table is not synchronized. FlyStrings must not be shared between threads.
 static auto& all_fly_strings()
 {
-    static Singleton<HashTable<Detail::StringData const*, FlyStringTableHashTraits>> table;
+    static Singleton<SwissHashTable<Detail::StringData const*, FlyStringTableHashTraits>> table;
     return *table;
 }
 
@@ -32,9 +34,10 @@ ErrorOr<FlyString> FlyString::from_utf8(StringView string)
         return FlyString {};
     if (string.length() <= Detail::MAX_SHORT_STRING_BYTE_COUNT)
         return FlyString { TRY(String::from_utf8(string)) };
-    if (auto it = all_fly_strings().find(string.hash(), [&](auto& entry) { return entry->bytes_as_string_view() == string; }); it != all_fly_strings().end())
+    auto hash = string.hash();
+    if (auto it = all_fly_strings().find(hash, [&](auto& entry) { return entry->bytes_as_string_view() == string; }); it != all_fly_strings().end())
         return FlyString { Detail::StringBase(**it) };
-    return FlyString { TRY(String::from_utf8(string)) };
+    return intern_new_string(TRY(String::from_utf8(string)), hash);
 }
 
 FlyString FlyString::from_utf8_without_validation(ReadonlyBytes string)
@@ -43,9 +46,23 @@ FlyString FlyString::from_utf8_without_validation(ReadonlyBytes string)
         return FlyString {};
     if (string.size() <= Detail::MAX_SHORT_STRING_BYTE_COUNT)
         return FlyString { String::from_utf8_without_validation(string) };
-    if (auto it = all_fly_strings().find(StringView(string).hash(), [&](auto& entry) { return entry->bytes_as_string_view() == string; }); it != all_fly_strings().end())
+    auto hash = StringView(string).hash();
+    if (auto it = all_fly_strings().find(hash, [&](auto& entry) { return entry->bytes_as_string_view() == string; }); it != all_fly_strings().end())
         return FlyString { Detail::StringBase(**it) };
-    return FlyString { String::from_utf8_without_validation(string) };
+    return intern_new_string(String::from_utf8_without_validation(string), hash);
+}
+
+// OPTIMIZATION: The callers have just looked the string up and know that it isn't interned yet, so we can skip
+//               the lookup that FlyString(String const&) would do, and hand the string the hash that we already computed.
+FlyString FlyString::intern_new_string(String string, unsigned hash)
+{
+    VERIFY(!string.is_short_string());
+    VERIFY(!string.m_data->is_fly_string());
+
+    string.m_data->set_precomputed_hash(hash);
+    all_fly_strings().set(string.m_data);
+    string.m_data->set_fly_string(true);
+    return FlyString { Detail::StringBase(move(string)) };
 }
 
 FlyString::FlyString(String const& string)
@@ -82,6 +82,8 @@ private:
     {
     }
 
+    static FlyString intern_new_string(String, unsigned hash);
+
     Detail::StringBase m_data;
 };
 
@@ -92,12 +92,18 @@ class HashTable;
 template<typename T, typename TraitsForT = Traits<T>>
 using OrderedHashTable = HashTable<T, TraitsForT, true>;
 
-template<typename K, typename V, typename KeyTraits = Traits<K>, typename ValueTraits = Traits<V>, bool IsOrdered = false>
+template<typename T, typename TraitsForT = Traits<T>, bool IsOrdered = false>
+class SwissHashTable;
+
+template<typename K, typename V, typename KeyTraits = Traits<K>, typename ValueTraits = Traits<V>, bool IsOrdered = false, template<typename, typename, bool> typename Table = HashTable>
 class HashMap;
 
 template<typename K, typename V, typename KeyTraits = Traits<K>, typename ValueTraits = Traits<V>>
 using OrderedHashMap = HashMap<K, V, KeyTraits, ValueTraits, true>;
 
+template<typename K, typename V, typename KeyTraits = Traits<K>, typename ValueTraits = Traits<V>>
+using SwissHashMap = HashMap<K, V, KeyTraits, ValueTraits, false, SwissHashTable>;
+
 template<typename T>
 class Badge;
 
@@ -107,11 +113,25 @@ class FixedArray;
 template<size_t precision, typename Underlying = i32>
 class FixedPoint;
 
-template<typename>
+#ifdef KERNEL
+// FIXME: Try to decrease this.
+inline constexpr size_t default_function_inline_capacity = 6 * sizeof(void*);
+#else
+// Empirically determined to fit most lambdas and functions.
+inline constexpr size_t default_function_inline_capacity = 4 * sizeof(void*);
+#endif
+
+template<typename, size_t inline_capacity = default_function_inline_capacity>
 class Function;
 
+template<size_t inline_capacity, typename Out, typename... In>
+class Function<Out(In...), inline_capacity>;
+
+template<typename>
+class FunctionRef;
+
 template<typename Out, typename... In>
-class Function<Out(In...)>;
+class FunctionRef<Out(In...)>;
 
 template<typename T>
 class NonnullRefPtr;
@@ -174,6 +194,7 @@ using AK::FixedArray;
 using AK::FixedPoint;
 using AK::FlyString;
 using AK::Function;
+using AK::FunctionRef;
 using AK::GenericLexer;
 using AK::HashMap;
 using AK::HashTable;
@@ -200,6 +221,8 @@ using AK::String;
 using AK::StringBuilder;
 using AK::StringImpl;
 using AK::StringView;
+using AK::SwissHashMap;
+using AK::SwissHashTable;
 using AK::TrailingCodePointTransformation;
 using AK::Traits;
 using AK::UnixDateTime;
@@ -30,6 +30,7 @@
 #include <AK/Assertions.h>
 #include <AK/Atomic.h>
 #include <AK/BitCast.h>
+#include <AK/Forward.h>
 #include <AK/Noncopyable.h>
 #include <AK/ScopeGuard.h>
 #include <AK/Span.h>
@@ -48,9 +49,6 @@ namespace AK {
 #    define IGNORE_USE_IN_ESCAPING_LAMBDA
 #endif
 
-template<typename>
-class Function;
-
 template<typename F>
 inline constexpr bool IsFunctionPointer = (IsPointer<F> && IsFunction<RemovePointer<F>>);
 
@@ -58,9 +56,12 @@ inline constexpr bool IsFunctionPointer = (IsPointer<F> && IsFunction<RemovePoin
 template<typename F>
 inline constexpr bool IsFunctionObject = (!IsFunctionPointer<F> && IsRvalueReference<F&&>);
 
-template<typename Out, typename... In>
-class Function<Out(In...)> {
+// A callable that is stored inline if it fits into `InlineCapacity` bytes (including a vtable pointer), and on the heap
+// otherwise. The capacity can be raised for callbacks that are known to capture a lot and are created often.
+template<size_t InlineCapacity, typename Out, typename... In>
+class Function<Out(In...), InlineCapacity> {
     AK_MAKE_NONCOPYABLE(Function);
+    static_assert(InlineCapacity >= sizeof(void*), "Function needs room for at least a pointer");
 
 public:
     using FunctionType = Out(In...);
@@ -127,6 +128,9 @@ public:
 
     explicit operator bool() const { return !!callable_wrapper(); }
 
+    // Whether the callable lives in the inline storage, i.e. creating this Function did not allocate.
+    [[nodiscard]] bool is_stored_inline() const { return m_kind == FunctionKind::Inline; }
+
     template<typename CallableType>
     Function& operator=(CallableType&& callable)
     requires((IsFunctionObject<CallableType> && IsCallableWithArguments<CallableType, Out, In...>))
@@ -307,20 +311,71 @@ private:
     mutable Atomic<u16> m_call_nesting_level { 0 };
 
     static constexpr size_t inline_alignment = max(alignof(CallableWrapperBase), alignof(CallableWrapperBase*));
-#ifndef KERNEL
-    // Empirically determined to fit most lambdas and functions.
-    static constexpr size_t inline_capacity = 4 * sizeof(void*);
-#else
-    // FIXME: Try to decrease this.
-    static constexpr size_t inline_capacity = 6 * sizeof(void*);
-#endif
+    static constexpr size_t inline_capacity = InlineCapacity;
 
     alignas(inline_alignment) u8 m_storage[inline_capacity];
 };
 
+// A non-owning reference to a callable, for callbacks that are only called before the function taking them returns.
+// It never allocates and is cheap to copy, but it doesn't keep the callable alive: it must not be stored, and it must
+// not be bound to a temporary outside of the argument list of a call.
+template<typename Out, typename... In>
+class FunctionRef<Out(In...)> {
+public:
+    using FunctionType = Out(In...);
+    using ReturnType = Out;
+
+    template<typename CallableType>
+    FunctionRef(CallableType&& callable)
+    requires((!IsFunctionPointer<RemoveCVReference<CallableType>> && IsCallableWithArguments<CallableType, Out, In...> && !IsSame<RemoveCVReference<CallableType>, FunctionRef>))
+        : m_call(&call_object<RemoveReference<CallableType>>)
+    {
+        m_target.object = const_cast<void*>(static_cast<void const volatile*>(&callable));
+    }
+
+    template<typename FunctionType>
+    FunctionRef(FunctionType f)
+    requires((IsFunctionPointer<FunctionType> && IsCallableWithArguments<RemovePointer<FunctionType>, Out, In...>))
+        : m_call(&call_function<FunctionType>)
+    {
+        VERIFY(f);
+        m_target.function = reinterpret_cast<void (*)()>(f);
+    }
+
+    FunctionRef(FunctionRef const&) = default;
+    FunctionRef& operator=(FunctionRef const&) = default;
+
+    Out operator()(In... in) const
+    {
+        return m_call(m_target, forward<In>(in)...);
+    }
+
+private:
+    union Target {
+        void* object;
+        void (*function)();
+    };
+
+    template<typename CallableType>
+    static Out call_object(Target target, In... in)
+    {
+        return (*static_cast<CallableType*>(target.object))(forward<In>(in)...);
+    }
+
+    template<typename FunctionType>
+    static Out call_function(Target target, In... in)
+    {
+        return reinterpret_cast<FunctionType>(target.function)(forward<In>(in)...);
+    }
+
+    Target m_target;
+    Out (*m_call)(Target, In...) { nullptr };
+};
+
 }
 
 #if USING_AK_GLOBALLY
 using AK::Function;
+using AK::FunctionRef;
 using AK::IsCallableWithArguments;
 #endif
@@ -7,6 +7,7 @@
 #include <AK/Assertions.h>
 #include <AK/CharacterTypes.h>
 #include <AK/GenericLexer.h>
+#include <AK/MemMem.h>
 #include <AK/ScopeGuard.h>
 #include <AK/StringBuilder.h>
 
@@ -44,8 +45,8 @@ StringView GenericLexer::consume_all()
 StringView GenericLexer::consume_line()
 {
     size_t start = m_index;
-    while (!is_eof() && peek() != '\r' && peek() != '\n')
-        m_index++;
+    auto rest = m_input.substring_view(m_index);
+    m_index += AK::memchr2_optional(rest.characters_without_null_termination(), rest.length(), '\r', '\n').value_or(rest.length());
     size_t length = m_index - start;
 
     consume_specific('\r');
@@ -60,8 +61,7 @@ StringView GenericLexer::consume_line()
 StringView GenericLexer::consume_until(char stop)
 {
     size_t start = m_index;
-    while (!is_eof() && peek() != stop)
-        m_index++;
+    m_index = m_input.find(stop, m_index).value_or(m_input.length());
     size_t length = m_index - start;
 
     if (length == 0)
@@ -72,22 +72,14 @@ StringView GenericLexer::consume_until(char stop)
 // Consume and return characters until the string `stop` is found
 StringView GenericLexer::consume_until(char const* stop)
 {
-    size_t start = m_index;
-    while (!is_eof() && !next_is(stop))
-        m_index++;
-    size_t length = m_index - start;
-
-    if (length == 0)
-        return {};
-    return m_input.substring_view(start, length);
+    return consume_until(StringView { stop, __builtin_strlen(stop) });
 }
 
 // Consume and return characters until the string `stop` is found
 StringView GenericLexer::consume_until(StringView stop)
 {
     size_t start = m_index;
-    while (!is_eof() && !next_is(stop))
-        m_index++;
+    m_index = m_input.find(stop, m_index).value_or(m_input.length());
     size_t length = m_index - start;
 
     if (length == 0)
@@ -17,7 +17,8 @@ namespace AK {
 // A map datastructure, mapping keys K to values V, based on a hash table with closed hashing.
 // HashMap can optionally provide ordered iteration based on the order of keys when IsOrdered = true.
 // HashMap is based on HashTable, which should be used instead if just a set datastructure is required.
-template<typename K, typename V, typename KeyTraits, typename ValueTraits, bool IsOrdered>
+// The table can be replaced by one with the same API, see SwissHashMap.
+template<typename K, typename V, typename KeyTraits, typename ValueTraits, bool IsOrdered, template<typename, typename, bool> typename Table>
 class HashMap {
 private:
     struct Entry {
@@ -93,7 +94,7 @@ public:
         });
     }
 
-    using HashTableType = HashTable<Entry, EntryTraits, IsOrdered>;
+    using HashTableType = Table<Entry, EntryTraits, IsOrdered>;
     using IteratorType = typename HashTableType::Iterator;
     using ConstIteratorType = typename HashTableType::ConstIterator;
 
@@ -18,6 +18,83 @@ constexpr bool is_space(int ch)
     return ch == '\t' || ch == '\n' || ch == '\r' || ch == ' ';
 }
 
+// Returns the number of characters at the start of the input that can be copied into a string verbatim,
+// i.e. everything up to the first quotation mark, reverse solidus or control character.
+static size_t count_literal_string_characters(StringView input)
+{
+    auto const* characters = input.characters_without_null_termination();
+    size_t index = 0;
+
+    // OPTIMIZATION: Look at eight bytes at a time, and only fall back to checking byte by byte once
+    //               a word contains a byte that might be special. These checks never miss such a byte,
+    //               but may report one where there is none; the byte-wise loop below sorts that out.
+    static constexpr u64 ones = 0x0101010101010101;
+    static constexpr u64 high_bits = 0x8080808080808080;
+    auto has_zero_byte = [](u64 word) { return (word - ones) & ~word & high_bits; };
+    for (; index + sizeof(u64) <= input.length(); index += sizeof(u64)) {
+        u64 word;
+        __builtin_memcpy(&word, characters + index, sizeof(word));
+        auto quotes = has_zero_byte(word ^ (ones * '"'));
+        auto reverse_solidi = has_zero_byte(word ^ (ones * '\\'));
+        auto control_characters = (word - ones * 0x20) & ~word & high_bits;
+        if (quotes | reverse_solidi | control_characters)
+            break;
+    }
+
+    for (; index < input.length(); ++index) {
+        char ch = characters[index];
+        if (ch == '"' || ch == '\\' || is_ascii_c0_control(ch))
+            break;
+    }
+    return index;
+}
+
+// Builds a JsonValue tree from the events of the streaming parser.
+class JsonTreeBuilder final : public JsonParser::Visitor {
+public:
+    JsonValue take_root() { return move(m_root); }
+
+    virtual ErrorOr<void> on_object_start() override { return m_stack.try_append({ JsonObject {}, {} }); }
+    virtual ErrorOr<void> on_object_key(StringView key) override
+    {
+        m_stack.last().pending_key = key;
+        return {};
+    }
+    virtual ErrorOr<void> on_object_end() override { return add(JsonValue { move(m_stack.take_last().container.get<JsonObject>()) }); }
+    virtual ErrorOr<void> on_array_start() override { return m_stack.try_append({ JsonArray {}, {} }); }
+    virtual ErrorOr<void> on_array_end() override { return add(JsonValue { move(m_stack.take_last().container.get<JsonArray>()) }); }
+    virtual ErrorOr<void> on_string(StringView string) override { return add(JsonValue { ByteString { string } }); }
+    virtual ErrorOr<void> on_number(JsonValue const& number) override { return add(number); }
+    virtual ErrorOr<void> on_boolean(bool value) override { return add(JsonValue { value }); }
+    virtual ErrorOr<void> on_null() override { return add(JsonValue {}); }
+
+private:
+    struct Container {
+        Variant<JsonObject, JsonArray> container;
+        ByteString pending_key;
+    };
+
+    ErrorOr<void> add(JsonValue value)
+    {
+        if (m_stack.is_empty()) {
+            m_root = move(value);
+            return {};
+        }
+        auto& top = m_stack.last();
+        return top.container.visit(
+            [&](JsonObject& object) -> ErrorOr<void> {
+                object.set(top.pending_key, move(value));
+                return {};
+            },
+            [&](JsonArray& array) -> ErrorOr<void> {
+                return array.append(move(value));
+            });
+    }
+
+    Vector<Container, 16> m_stack;
+    JsonValue m_root;
+};
+
 // ECMA-404 9 String
 // Boils down to
 // STRING = "\"" *("[^\"\\]" | "\\" ("[\"\\bfnrt]" | "u[0-9A-Za-z]{4}")) "\""
@@ -31,11 +108,12 @@ constexpr bool is_space(int ch)
 //                             │                       │
 //                             ╰─── u[0-9A-Za-z]{4}  ──╯
 //
-ErrorOr<ByteString> JsonParser::consume_and_unescape_string()
+ErrorOr<StringView> JsonParser::consume_and_unescape_string()
 {
     if (!consume_specific('"'))
         return Error::from_string_literal("JsonParser: Expected '\"'");
-    StringBuilder final_sb;
+    m_unescaped_string.clear();
+    bool has_escapes = false;
 
     for (;;) {
         // OPTIMIZATION: We try to append as many literal characters as possible at a time
@@ -44,33 +122,35 @@ ErrorOr<ByteString> JsonParser::consume_and_unescape_string()
         //       which puts the, above plain ascii in value, so they will always consist
         //       of a set of "legal" non-special bytes,
         //       hence we don't need to bother with a code-point iterator,
-        //       as a simple byte iterator suffices, which GenericLexer provides by default
-        size_t literal_characters = 0;
-        for (;;) {
-            char ch = peek(literal_characters);
-            // Note: We get a 0 byte when we hit EOF
-            if (ch == 0)
-                return Error::from_string_literal("JsonParser: EOF while parsing String");
-            // Spec: All code points may be placed within the quotation marks except
-            //       for the code points that must be escaped: quotation mark (U+0022),
-            //       reverse solidus (U+005C), and the control characters U+0000 to U+001F.
-            //       There are two-character escape sequence representations of some characters.
-            if (is_ascii_c0_control(ch))
-                return Error::from_string_literal("JsonParser: ASCII control sequence encountered");
-            if (ch == '"' || ch == '\\')
-                break;
-            ++literal_characters;
+        //       as a simple byte iterator suffices
+        size_t literal_characters = count_literal_string_characters(m_input.substring_view(m_index));
+        if (literal_characters == tell_remaining())
+            return Error::from_string_literal("JsonParser: EOF while parsing String");
+
+        // Spec: All code points may be placed within the quotation marks except
+        //       for the code points that must be escaped: quotation mark (U+0022),
+        //       reverse solidus (U+005C), and the control characters U+0000 to U+001F.
+        //       There are two-character escape sequence representations of some characters.
+        char ch = peek(literal_characters);
+        if (is_ascii_c0_control(ch))
+            return Error::from_string_literal("JsonParser: ASCII control sequence encountered");
+
+        // OPTIMIZATION: Strings without escapes are handed out as views into the input, without copying them.
+        if (ch == '"' && !has_escapes) {
+            auto string = consume(literal_characters);
+            ignore(); // '"'
+            return string;
         }
-        final_sb.append(consume(literal_characters));
 
-        // We have checked all cases except end-of-string and escaped characters in the loop above,
-        // so we now only have to handle those two cases
-        char ch = peek();
+        m_unescaped_string.append(consume(literal_characters));
 
+        // We have checked all cases except end-of-string and escaped characters above,
+        // so we now only have to handle those two cases
         if (ch == '"') {
             consume();
             break;
         }
+        has_escapes = true;
 
         ignore(); // '\'
 
@@ -80,27 +160,27 @@ ErrorOr<ByteString> JsonParser::consume_and_unescape_string()
         case '"':
         case '\\':
         case '/':
-            final_sb.append(consume());
+            m_unescaped_string.append(consume());
             break;
         case 'b':
             ignore();
-            final_sb.append('\b');
+            m_unescaped_string.append('\b');
             break;
         case 'f':
             ignore();
-            final_sb.append('\f');
+            m_unescaped_string.append('\f');
             break;
         case 'n':
             ignore();
-            final_sb.append('\n');
+            m_unescaped_string.append('\n');
             break;
         case 'r':
             ignore();
-            final_sb.append('\r');
+            m_unescaped_string.append('\r');
             break;
         case 't':
             ignore();
-            final_sb.append('\t');
+            m_unescaped_string.append('\t');
             break;
         case 'u': {
             ignore(); // 'u'
@@ -119,7 +199,7 @@ ErrorOr<ByteString> JsonParser::consume_and_unescape_string()
             //              However, whether a processor of JSON texts interprets such a surrogate pair as a single code point or as an
             //              explicit surrogate pair is a semantic decision that is determined by the specific processor."
             //             ~ECMA-404, 2nd Edition Dec. 2017, page 5
-            final_sb.append_code_point(code_point.value());
+            m_unescaped_string.append_code_point(code_point.value());
             break;
         }
         default:
@@ -128,26 +208,26 @@ ErrorOr<ByteString> JsonParser::consume_and_unescape_string()
         }
     }
 
-    return final_sb.to_byte_string();
+    return m_unescaped_string.string_view();
 }
 
-ErrorOr<JsonValue> JsonParser::parse_object()
+ErrorOr<void> JsonParser::parse_object(Visitor& visitor)
 {
-    JsonObject object;
     if (!consume_specific('{'))
         return Error::from_string_literal("JsonParser: Expected '{'");
+    TRY(visitor.on_object_start());
     for (;;) {
         ignore_while(is_space);
         if (peek() == '}')
             break;
         ignore_while(is_space);
         auto name = TRY(consume_and_unescape_string());
+        TRY(visitor.on_object_key(name));
         ignore_while(is_space);
         if (!consume_specific(':'))
             return Error::from_string_literal("JsonParser: Expected ':'");
         ignore_while(is_space);
-        auto value = TRY(parse_helper());
-        object.set(name, move(value));
+        TRY(parse_helper(visitor));
         ignore_while(is_space);
         if (peek() == '}')
             break;
@@ -159,20 +239,19 @@ ErrorOr<JsonValue> JsonParser::parse_object()
     }
     if (!consume_specific('}'))
         return Error::from_string_literal("JsonParser: Expected '}'");
-    return JsonValue { move(object) };
+    return visitor.on_object_end();
 }
 
-ErrorOr<JsonValue> JsonParser::parse_array()
+ErrorOr<void> JsonParser::parse_array(Visitor& visitor)
 {
-    JsonArray array;
     if (!consume_specific('['))
         return Error::from_string_literal("JsonParser: Expected '['");
+    TRY(visitor.on_array_start());
     for (;;) {
         ignore_while(is_space);
         if (peek() == ']')
             break;
-        auto element = TRY(parse_helper());
-        TRY(array.append(move(element)));
+        TRY(parse_helper(visitor));
         ignore_while(is_space);
         if (peek() == ']')
             break;
@@ -185,13 +264,7 @@ ErrorOr<JsonValue> JsonParser::parse_array()
     ignore_while(is_space);
     if (!consume_specific(']'))
         return Error::from_string_literal("JsonParser: Expected ']'");
-    return JsonValue { move(array) };
-}
-
-ErrorOr<JsonValue> JsonParser::parse_string()
-{
-    auto string = TRY(consume_and_unescape_string());
-    return JsonValue(move(string));
+    return visitor.on_array_end();
 }
 
 ErrorOr<JsonValue> JsonParser::parse_number()
@@ -296,38 +369,38 @@ ErrorOr<JsonValue> JsonParser::parse_number()
     return fallback_to_double_parse();
 }
 
-ErrorOr<JsonValue> JsonParser::parse_true()
+ErrorOr<void> JsonParser::parse_true()
 {
     if (!consume_specific("true"sv))
         return Error::from_string_literal("JsonParser: Expected 'true'");
-    return JsonValue(true);
+    return {};
 }
 
-ErrorOr<JsonValue> JsonParser::parse_false()
+ErrorOr<void> JsonParser::parse_false()
 {
     if (!consume_specific("false"sv))
         return Error::from_string_literal("JsonParser: Expected 'false'");
-    return JsonValue(false);
+    return {};
 }
 
-ErrorOr<JsonValue> JsonParser::parse_null()
+ErrorOr<void> JsonParser::parse_null()
 {
     if (!consume_specific("null"sv))
         return Error::from_string_literal("JsonParser: Expected 'null'");
-    return JsonValue {};
+    return {};
 }
 
-ErrorOr<JsonValue> JsonParser::parse_helper()
+ErrorOr<void> JsonParser::parse_helper(Visitor& visitor)
 {
     ignore_while(is_space);
     auto type_hint = peek();
     switch (type_hint) {
     case '{':
-        return parse_object();
+        return parse_object(visitor);
     case '[':
-        return parse_array();
+        return parse_array(visitor);
     case '"':
-        return parse_string();
+        return visitor.on_string(TRY(consume_and_unescape_string()));
     case '-':
     case '0':
     case '1':
@@ -339,13 +412,16 @@ ErrorOr<JsonValue> JsonParser::parse_helper()
     case '7':
     case '8':
     case '9':
-        return parse_number();
+        return visitor.on_number(TRY(parse_number()));
     case 'f':
-        return parse_false();
+        TRY(parse_false());
+        return visitor.on_boolean(false);
     case 't':
-        return parse_true();
+        TRY(parse_true());
+        return visitor.on_boolean(true);
     case 'n':
-        return parse_null();
+        TRY(parse_null());
+        return visitor.on_null();
     }
 
     return Error::from_string_literal("JsonParser: Unexpected character");
@@ -353,11 +429,18 @@ ErrorOr<JsonValue> JsonParser::parse_helper()
 
 ErrorOr<JsonValue> JsonParser::parse()
 {
-    auto result = TRY(parse_helper());
+    JsonTreeBuilder builder;
+    TRY(parse(builder));
+    return builder.take_root();
+}
+
+ErrorOr<void> JsonParser::parse(Visitor& visitor)
+{
+    TRY(parse_helper(visitor));
     ignore_while(is_space);
     if (!is_eof())
         return Error::from_string_literal("JsonParser: Didn't consume all input");
-    return result;
+    return {};
 }
 
 }
@@ -8,29 +8,49 @@
 
 #include <AK/GenericLexer.h>
 #include <AK/JsonValue.h>
+#include <AK/StringBuilder.h>
 
 namespace AK {
 
 class JsonParser : private GenericLexer {
 public:
+    // Receives the structure of a JSON document as it is being parsed, without building a JsonValue tree.
+    // NOTE: Strings passed to a visitor may point into the parser's scratch buffer and are only valid during the call.
+    class Visitor {
+    public:
+        virtual ~Visitor() = default;
+
+        virtual ErrorOr<void> on_object_start() { return {}; }
+        virtual ErrorOr<void> on_object_key(StringView) { return {}; }
+        virtual ErrorOr<void> on_object_end() { return {}; }
+        virtual ErrorOr<void> on_array_start() { return {}; }
+        virtual ErrorOr<void> on_array_end() { return {}; }
+        virtual ErrorOr<void> on_string(StringView) { return {}; }
+        virtual ErrorOr<void> on_number(JsonValue const&) { return {}; }
+        virtual ErrorOr<void> on_boolean(bool) { return {}; }
+        virtual ErrorOr<void> on_null() { return {}; }
+    };
+
     explicit JsonParser(StringView input)
         : GenericLexer(input)
     {
     }
 
     ErrorOr<JsonValue> parse();
+    ErrorOr<void> parse(Visitor&);
 
 private:
-    ErrorOr<JsonValue> parse_helper();
+    ErrorOr<void> parse_helper(Visitor&);
 
-    ErrorOr<ByteString> consume_and_unescape_string();
-    ErrorOr<JsonValue> parse_array();
-    ErrorOr<JsonValue> parse_object();
+    ErrorOr<StringView> consume_and_unescape_string();
+    ErrorOr<void> parse_array(Visitor&);
+    ErrorOr<void> parse_object(Visitor&);
     ErrorOr<JsonValue> parse_number();
-    ErrorOr<JsonValue> parse_string();
-    ErrorOr<JsonValue> parse_false();
-    ErrorOr<JsonValue> parse_true();
-    ErrorOr<JsonValue> parse_null();
+    ErrorOr<void> parse_false();
+    ErrorOr<void> parse_true();
+    ErrorOr<void> parse_null();
+
+    StringBuilder m_unescaped_string;
 };
 
 }
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/BuiltinWrappers.h>
+#include <AK/Forward.h>
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <AK/StdLibExtras.h>
+
+namespace AK {
+
+// A bounded queue that any number of threads can enqueue into and dequeue from at the same time, without locks.
+// Every slot has a sequence number that tells which lap around the queue it is ready for, so producers and consumers
+// only ever contend on the position they move along (with a single compare-and-swap), and never on the slot itself.
+// Values come out in the order their producers claimed a slot in, which keeps the order of each single producer.
+template<typename T, size_t Capacity>
+requires(popcount(Capacity) == 1 && Capacity >= 2)
+class MPMCQueue {
+    AK_MAKE_NONCOPYABLE(MPMCQueue);
+    AK_MAKE_NONMOVABLE(MPMCQueue);
+
+public:
+    MPMCQueue()
+    {
+        for (size_t i = 0; i < Capacity; ++i)
+            m_slots[i].sequence.store(i, AK::MemoryOrder::memory_order_relaxed);
+    }
+
+    ~MPMCQueue()
+    {
+        while (try_dequeue().has_value())
+            ;
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+    // Returns false if the queue is full.
+    template<typename U = T>
+    [[nodiscard]] bool try_enqueue(U&& value)
+    {
+        auto position = m_enqueue_position.load(AK::MemoryOrder::memory_order_relaxed);
+        while (true) {
+            auto& slot = m_slots[position & (Capacity - 1)];
+            auto difference = static_cast<ssize_t>(slot.sequence.load(AK::MemoryOrder::memory_order_acquire) - position);
+            if (difference == 0) {
+                // NOTE: If this fails, the position is updated to the current one and we try again from there.
+                if (m_enqueue_position.compare_exchange_strong(position, position + 1, AK::MemoryOrder::memory_order_relaxed)) {
+                    new (slot.storage) T(forward<U>(value));
+                    slot.sequence.store(position + 1, AK::MemoryOrder::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                // The slot still holds the value from the last lap around the queue.
+                return false;
+            } else {
+                position = m_enqueue_position.load(AK::MemoryOrder::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Returns nothing if the queue is empty, or if the value at the front is still being enqueued.
+    Optional<T> try_dequeue()
+    {
+        auto position = m_dequeue_position.load(AK::MemoryOrder::memory_order_relaxed);
+        while (true) {
+            auto& slot = m_slots[position & (Capacity - 1)];
+            auto difference = static_cast<ssize_t>(slot.sequence.load(AK::MemoryOrder::memory_order_acquire) - (position + 1));
+            if (difference == 0) {
+                if (m_dequeue_position.compare_exchange_strong(position, position + 1, AK::MemoryOrder::memory_order_relaxed)) {
+                    auto& value_slot = *reinterpret_cast<T*>(slot.storage);
+                    Optional<T> value = move(value_slot);
+                    value_slot.~T();
+                    slot.sequence.store(position + Capacity, AK::MemoryOrder::memory_order_release);
+                    return value;
+                }
+            } else if (difference < 0) {
+                return {};
+            } else {
+                position = m_dequeue_position.load(AK::MemoryOrder::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Whether every value that was claimed a slot for has been dequeued, including the ones still being enqueued.
+    // Either side may have moved on by the time this returns.
+    bool is_empty() const
+    {
+        auto dequeue_position = m_dequeue_position.load(AK::MemoryOrder::memory_order_acquire);
+        return m_enqueue_position.load(AK::MemoryOrder::memory_order_acquire) == dequeue_position;
+    }
+
+private:
+    struct Slot {
+        Atomic<size_t> sequence;
+        alignas(T) u8 storage[sizeof(T)];
+    };
+
+    // NOTE: The positions only ever go up, and are wrapped around when indexing into the slots.
+    AK_CACHE_ALIGNED Atomic<size_t> m_enqueue_position { 0 };
+    AK_CACHE_ALIGNED Atomic<size_t> m_dequeue_position { 0 };
+    AK_CACHE_ALIGNED Slot m_slots[Capacity];
+};
+
+}
+
+#if USING_AK_GLOBALLY
+using AK::MPMCQueue;
+#endif
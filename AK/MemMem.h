@@ -8,13 +8,89 @@
 
 #include <AK/Array.h>
 #include <AK/Assertions.h>
+#include <AK/BuiltinWrappers.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
 
+#ifdef __SSE2__
+#    include <AK/SIMDExtras.h>
+#endif
+
 namespace AK {
 
 namespace Detail {
+
+template<typename... Needles>
+ALWAYS_INLINE bool matches_any_of(u8 byte, Needles... needles)
+{
+    return ((byte == needles) || ...);
+}
+
+#ifdef __SSE2__
+// Loads 16 bytes and returns a mask with a bit set for each of them that is equal to one of the needles.
+template<typename... Needles>
+ALWAYS_INLINE u32 match_mask_for_16_bytes(u8 const* bytes, Needles... needles)
+{
+    SIMD::u8x16 chunk;
+    __builtin_memcpy(&chunk, bytes, sizeof(chunk));
+    return SIMD::maskbits(((chunk == needles) | ...));
+}
+#else
+// Without vector registers (in the kernel, for example), eight bytes are looked at in a general-purpose register.
+// The lowest byte of the returned word with its high bit set is the first byte equal to one of the needles.
+template<typename... Needles>
+ALWAYS_INLINE u64 match_mask_for_8_bytes(u8 const* bytes, Needles... needles)
+{
+    static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "The lowest bits of a word have to belong to its first byte");
+
+    u64 word;
+    __builtin_memcpy(&word, bytes, sizeof(word));
+    auto has_zero_byte = [](u64 value) { return (value - 0x0101010101010101ull) & ~value & 0x8080808080808080ull; };
+    return (has_zero_byte(word ^ (needles * 0x0101010101010101ull)) | ...);
+}
+#endif
+
+template<typename... Needles>
+inline Optional<size_t> find_first_byte_of(u8 const* haystack, size_t haystack_length, Needles... needles)
+{
+    size_t offset = 0;
+#ifdef __SSE2__
+    for (; offset + 16 <= haystack_length; offset += 16) {
+        if (auto mask = match_mask_for_16_bytes(haystack + offset, needles...); mask != 0)
+            return offset + count_trailing_zeroes(mask);
+    }
+#else
+    for (; offset + 8 <= haystack_length; offset += 8) {
+        if (auto mask = match_mask_for_8_bytes(haystack + offset, needles...); mask != 0)
+            return offset + count_trailing_zeroes(mask) / 8;
+    }
+#endif
+    for (; offset < haystack_length; ++offset) {
+        if (matches_any_of(haystack[offset], needles...))
+            return offset;
+    }
+    return {};
+}
+
+template<typename... Needles>
+inline Optional<size_t> find_last_byte_of(u8 const* haystack, size_t haystack_length, Needles... needles)
+{
+    size_t end = haystack_length;
+#ifdef __SSE2__
+    for (; end >= 16; end -= 16) {
+        if (auto mask = match_mask_for_16_bytes(haystack + end - 16, needles...); mask != 0)
+            return end - 16 + (31 - count_leading_zeroes(mask));
+    }
+#endif
+    // NOTE: The word-at-a-time check only finds the first match within a word reliably, so it's not used here.
+    for (; end > 0; --end) {
+        if (matches_any_of(haystack[end - 1], needles...))
+            return end - 1;
+    }
+    return {};
+}
+
 constexpr void const* bitap_bitwise(void const* haystack, size_t haystack_length, void const* needle, size_t needle_length)
 {
     VERIFY(needle_length < 32);
@@ -101,6 +177,85 @@ requires(requires { (*haystack_begin).data(); (*haystack_begin).size(); })
     return {};
 }
 
+// Returns the offset of the first byte equal to the needle, like memchr().
+inline Optional<size_t> memchr_optional(void const* haystack, size_t haystack_length, u8 needle)
+{
+    return Detail::find_first_byte_of(static_cast<u8 const*>(haystack), haystack_length, needle);
+}
+
+// Returns the offset of the first byte equal to either of the needles.
+inline Optional<size_t> memchr2_optional(void const* haystack, size_t haystack_length, u8 needle1, u8 needle2)
+{
+    return Detail::find_first_byte_of(static_cast<u8 const*>(haystack), haystack_length, needle1, needle2);
+}
+
+// Returns the offset of the first byte equal to any of the needles.
+inline Optional<size_t> memchr3_optional(void const* haystack, size_t haystack_length, u8 needle1, u8 needle2, u8 needle3)
+{
+    return Detail::find_first_byte_of(static_cast<u8 const*>(haystack), haystack_length, needle1, needle2, needle3);
+}
+
+// Returns the offset of the last byte equal to the needle, like memrchr().
+inline Optional<size_t> memrchr_optional(void const* haystack, size_t haystack_length, u8 needle)
+{
+    return Detail::find_last_byte_of(static_cast<u8 const*>(haystack), haystack_length, needle);
+}
+
+namespace Detail {
+
+inline Optional<size_t> linear_memmem(void const* haystack, size_t haystack_length, void const* needle, size_t needle_length)
+{
+    if (needle_length < 32) {
+        auto const* ptr = Detail::bitap_bitwise(haystack, haystack_length, needle, needle_length);
+        if (ptr)
+            return static_cast<size_t>((FlatPtr)ptr - (FlatPtr)haystack);
+        return {};
+    }
+
+    // Fallback to KMP.
+    Array<ReadonlyBytes, 1> spans { ReadonlyBytes { (u8 const*)haystack, haystack_length } };
+    return memmem(spans.begin(), spans.end(), { (u8 const*)needle, needle_length });
+}
+
+#ifdef __SSE2__
+// Finds candidates 16 at a time by comparing the first and the last byte of the needle at once, and only compares
+// the rest of the needle for those. That is very fast for everything but pathological inputs, so if too many of the
+// candidates turn out to be false positives, this gives up and returns the offset it got to in `searched_length`.
+inline Optional<size_t> filtered_memmem(u8 const* haystack, size_t haystack_length, u8 const* needle, size_t needle_length, size_t& searched_length)
+{
+    VERIFY(needle_length >= 2 && needle_length <= haystack_length);
+
+    auto first = needle[0];
+    auto last = needle[needle_length - 1];
+    size_t false_positives = 0;
+
+    size_t offset = 0;
+    for (; offset + needle_length - 1 + 16 <= haystack_length; offset += 16) {
+        auto mask = match_mask_for_16_bytes(haystack + offset, first) & match_mask_for_16_bytes(haystack + offset + needle_length - 1, last);
+        while (mask != 0) {
+            auto candidate = offset + count_trailing_zeroes(mask);
+            if (__builtin_memcmp(haystack + candidate + 1, needle + 1, needle_length - 2) == 0)
+                return candidate;
+            mask &= mask - 1;
+            ++false_positives;
+        }
+        if (false_positives > 64 + offset / 8) {
+            searched_length = offset + 16;
+            return {};
+        }
+    }
+
+    for (; offset + needle_length <= haystack_length; ++offset) {
+        if (haystack[offset] == first && __builtin_memcmp(haystack + offset + 1, needle + 1, needle_length - 1) == 0)
+            return offset;
+    }
+    searched_length = haystack_length;
+    return {};
+}
+#endif
+
+}
+
 inline Optional<size_t> memmem_optional(void const* haystack, size_t haystack_length, void const* needle, size_t needle_length)
 {
     if (needle_length == 0)
@@ -115,16 +270,24 @@ inline Optional<size_t> memmem_optional(void const* haystack, size_t haystack_le
         return {};
     }
 
-    if (needle_length < 32) {
-        auto const* ptr = Detail::bitap_bitwise(haystack, haystack_length, needle, needle_length);
-        if (ptr)
-            return static_cast<size_t>((FlatPtr)ptr - (FlatPtr)haystack);
+    if (needle_length == 1)
+        return memchr_optional(haystack, haystack_length, *static_cast<u8 const*>(needle));
+
+#ifdef __SSE2__
+    size_t searched_length = 0;
+    if (auto offset = Detail::filtered_memmem(static_cast<u8 const*>(haystack), haystack_length, static_cast<u8 const*>(needle), needle_length, searched_length); offset.has_value())
+        return offset;
+    if (searched_length + needle_length > haystack_length)
         return {};
-    }
 
-    // Fallback to KMP.
-    Array<ReadonlyBytes, 1> spans { ReadonlyBytes { (u8 const*)haystack, haystack_length } };
-    return memmem(spans.begin(), spans.end(), { (u8 const*)needle, needle_length });
+    // The filter gave up, carry on with an algorithm that is linear in any case.
+    auto offset = Detail::linear_memmem(static_cast<u8 const*>(haystack) + searched_length, haystack_length - searched_length, needle, needle_length);
+    if (offset.has_value())
+        return searched_length + offset.value();
+    return {};
+#else
+    return Detail::linear_memmem(haystack, haystack_length, needle, needle_length);
+#endif
 }
 
 inline void const* memmem(void const* haystack, size_t haystack_length, void const* needle, size_t needle_length)
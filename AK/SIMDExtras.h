@@ -78,6 +78,19 @@ ALWAYS_INLINE static i32 maskbits(i32x4 mask)
 #endif
 }
 
+// Gathers the most significant bit of each lane, lane 0 ending up in the least significant bit.
+ALWAYS_INLINE static u16 maskbits(i8x16 mask)
+{
+#if defined(__SSE2__)
+    return __builtin_ia32_pmovmskb128((c8x16)mask);
+#else
+    u16 bits = 0;
+    for (size_t i = 0; i < 16; ++i)
+        bits |= static_cast<u16>((static_cast<u8>(mask[i]) >> 7) << i);
+    return bits;
+#endif
+}
+
 ALWAYS_INLINE static bool all(i32x4 mask)
 {
     return maskbits(mask) == 15;
@@ -167,6 +180,20 @@ ALWAYS_INLINE static void store4_masked(VectorType v, UnderlyingType* a, Underly
         *d = v[3];
 }
 
+template<typename VectorType>
+ALWAYS_INLINE static VectorType load_unaligned(void const* a)
+{
+    VectorType v;
+    __builtin_memcpy(&v, a, sizeof(VectorType));
+    return v;
+}
+
+template<typename VectorType>
+ALWAYS_INLINE static void store_unaligned(void* a, VectorType v)
+{
+    __builtin_memcpy(a, &v, sizeof(VectorType));
+}
+
 // Shuffle
 
 template<OneOf<i8x16, u8x16> T>
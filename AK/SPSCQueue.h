@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/BuiltinWrappers.h>
+#include <AK/Forward.h>
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <AK/StdLibExtras.h>
+
+namespace AK {
+
+// A bounded queue between exactly one producer and one consumer thread, neither of which ever takes a lock or waits.
+// Each side keeps a copy of the position of the other side, and only looks at the real one once its copy says that
+// the queue is full (or empty). Most of the time, each side only touches its own cache line that way.
+template<typename T, size_t Capacity>
+requires(popcount(Capacity) == 1)
+class SPSCQueue {
+    AK_MAKE_NONCOPYABLE(SPSCQueue);
+    AK_MAKE_NONMOVABLE(SPSCQueue);
+
+public:
+    SPSCQueue() = default;
+
+    ~SPSCQueue()
+    {
+        for (auto head = m_head.load(AK::MemoryOrder::memory_order_relaxed); head != m_tail.load(AK::MemoryOrder::memory_order_relaxed); ++head)
+            slot(head).~T();
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+    // Only to be called by the producer. Returns false if the queue is full.
+    template<typename U = T>
+    [[nodiscard]] bool try_enqueue(U&& value)
+    {
+        auto tail = m_tail.load(AK::MemoryOrder::memory_order_relaxed);
+        if (tail - m_cached_head == Capacity) {
+            m_cached_head = m_head.load(AK::MemoryOrder::memory_order_acquire);
+            if (tail - m_cached_head == Capacity)
+                return false;
+        }
+        new (&slot(tail)) T(forward<U>(value));
+        m_tail.store(tail + 1, AK::MemoryOrder::memory_order_release);
+        return true;
+    }
+
+    // Only to be called by the consumer.
+    Optional<T> try_dequeue()
+    {
+        auto head = m_head.load(AK::MemoryOrder::memory_order_relaxed);
+        if (head == m_cached_tail) {
+            m_cached_tail = m_tail.load(AK::MemoryOrder::memory_order_acquire);
+            if (head == m_cached_tail)
+                return {};
+        }
+        auto& value_slot = slot(head);
+        Optional<T> value = move(value_slot);
+        value_slot.~T();
+        m_head.store(head + 1, AK::MemoryOrder::memory_order_release);
+        return value;
+    }
+
+    // Either side may have moved on by the time these return.
+    size_t size() const
+    {
+        // NOTE: The head is loaded first, as it can't overtake the tail that is loaded after it.
+        auto head = m_head.load(AK::MemoryOrder::memory_order_acquire);
+        return m_tail.load(AK::MemoryOrder::memory_order_acquire) - head;
+    }
+
+    bool is_empty() const { return size() == 0; }
+
+private:
+    T& slot(size_t position) { return reinterpret_cast<T*>(m_storage)[position & (Capacity - 1)]; }
+
+    // NOTE: The positions only ever go up, and are wrapped around when indexing into the storage.
+    //       The first cache line is written by the consumer only, the second one by the producer only.
+    AK_CACHE_ALIGNED Atomic<size_t> m_head { 0 };
+    size_t m_cached_tail { 0 };
+
+    AK_CACHE_ALIGNED Atomic<size_t> m_tail { 0 };
+    size_t m_cached_head { 0 };
+
+    AK_CACHE_ALIGNED u8 m_storage[sizeof(T) * Capacity];
+};
+
+}
+
+#if USING_AK_GLOBALLY
+using AK::SPSCQueue;
+#endif
@@ -84,6 +84,14 @@ public:
         return m_hash;
     }
 
+    // For callers that already hashed the same bytes, e.g. to look them up in a table.
+    void set_precomputed_hash(unsigned hash) const
+    {
+        VERIFY(!m_has_hash || m_hash == hash);
+        m_hash = hash;
+        m_has_hash = true;
+    }
+
     bool is_fly_string() const { return m_is_fly_string; }
     void set_fly_string(bool is_fly_string) const { m_is_fly_string = is_fly_string; }
 
@@ -384,11 +384,8 @@ Optional<size_t> find(StringView haystack, char needle, size_t start)
 {
     if (start >= haystack.length())
         return {};
-    for (size_t i = start; i < haystack.length(); ++i) {
-        if (haystack[i] == needle)
-            return i;
-    }
-    return {};
+    auto index = AK::memchr_optional(haystack.characters_without_null_termination() + start, haystack.length() - start, needle);
+    return index.has_value() ? (*index + start) : index;
 }
 
 Optional<size_t> find(StringView haystack, StringView needle, size_t start)
@@ -403,11 +400,7 @@ Optional<size_t> find(StringView haystack, StringView needle, size_t start)
 
 Optional<size_t> find_last(StringView haystack, char needle)
 {
-    for (size_t i = haystack.length(); i > 0; --i) {
-        if (haystack[i - 1] == needle)
-            return i - 1;
-    }
-    return {};
+    return AK::memrchr_optional(haystack.characters_without_null_termination(), haystack.length(), needle);
 }
 
 Optional<size_t> find_last(StringView haystack, StringView needle)
@@ -455,6 +448,17 @@ Optional<size_t> find_any_of(StringView haystack, StringView needles, SearchDire
 {
     if (haystack.is_empty() || needles.is_empty())
         return {};
+
+    // OPTIMIZATION: Look for a few needles with a vectorized search, most callers only have that many.
+    if (direction == SearchDirection::Forward && needles.length() <= 3) {
+        auto const* characters = haystack.characters_without_null_termination();
+        if (needles.length() == 1)
+            return AK::memchr_optional(characters, haystack.length(), needles[0]);
+        if (needles.length() == 2)
+            return AK::memchr2_optional(characters, haystack.length(), needles[0], needles[1]);
+        return AK::memchr3_optional(characters, haystack.length(), needles[0], needles[1], needles[2]);
+    }
+
     if (direction == SearchDirection::Forward) {
         for (size_t i = 0; i < haystack.length(); ++i) {
             if (needles.contains(haystack[i]))
@@ -174,11 +174,7 @@ bool StringView::matches(StringView mask, CaseSensitivity case_sensitivity) cons
 
 bool StringView::contains(char needle) const
 {
-    for (char current : *this) {
-        if (current == needle)
-            return true;
-    }
-    return false;
+    return find(needle).has_value();
 }
 
 bool StringView::contains(u32 needle) const
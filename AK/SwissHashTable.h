@@ -0,0 +1,536 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/BuiltinWrappers.h>
+#include <AK/Concepts.h>
+#include <AK/Error.h>
+#include <AK/HashFunctions.h>
+#include <AK/HashMap.h>
+#include <AK/HashTable.h>
+#include <AK/SIMDExtras.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Traits.h>
+#include <AK/Types.h>
+#include <AK/kmalloc.h>
+
+namespace AK {
+
+template<typename SwissHashTableType, typename T>
+class SwissHashTableIterator {
+    friend SwissHashTableType;
+
+public:
+    bool operator==(SwissHashTableIterator const& other) const { return m_slot == other.m_slot; }
+    bool operator!=(SwissHashTableIterator const& other) const { return m_slot != other.m_slot; }
+    T& operator*() { return *m_slot; }
+    T* operator->() { return m_slot; }
+    void operator++() { skip_to_next(); }
+
+private:
+    void skip_to_next()
+    {
+        if (!m_slot)
+            return;
+        do {
+            ++m_slot;
+            ++m_control;
+            if (m_slot == m_end_slot) {
+                m_slot = nullptr;
+                return;
+            }
+        } while (!SwissHashTableType::is_used(*m_control));
+    }
+
+    SwissHashTableIterator(T* slot, u8 const* control, T* end_slot)
+        : m_slot(slot)
+        , m_control(control)
+        , m_end_slot(end_slot)
+    {
+    }
+
+    T* m_slot { nullptr };
+    u8 const* m_control { nullptr };
+    T* m_end_slot { nullptr };
+};
+
+// A set datastructure based on an open addressing hash table in the style of Swiss tables, with the same API as
+// HashTable (except for ordered iteration). Next to the values, the table keeps a control byte for each slot, that
+// tells whether it is free and otherwise holds 7 bits of the hash of its value. Lookups compare a whole group of
+// 16 control bytes with those bits at once, so only slots whose value is very likely to match have to be looked
+// at. This makes lookups considerably cheaper for large tables, and for values that are expensive to compare.
+// Use it with HashMap through SwissHashMap.
+template<typename T, typename TraitsForT, bool IsOrdered>
+class SwissHashTable {
+    static_assert(!IsOrdered, "SwissHashTable does not support ordered iteration");
+
+    static constexpr size_t group_size = 16;
+    // The table is grown once 7/8 of its slots are either used or deleted.
+    static constexpr size_t max_load_factor_numerator = 7;
+    static constexpr size_t max_load_factor_denominator = 8;
+
+    // Free slots have the most significant bit of their control byte set, used ones hold the low 7 bits of the hash.
+    static constexpr u8 control_empty = 0x80;
+    static constexpr u8 control_deleted = 0xfe;
+
+    static constexpr bool is_used(u8 control) { return (control & 0x80) == 0; }
+
+    template<typename, typename>
+    friend class SwissHashTableIterator;
+
+public:
+    SwissHashTable() = default;
+    explicit SwissHashTable(size_t capacity) { MUST(try_ensure_capacity(capacity)); }
+
+    ~SwissHashTable()
+    {
+        if (!m_control)
+            return;
+
+        if constexpr (!IsTriviallyDestructible<T>) {
+            for (size_t i = 0; i < m_capacity; ++i) {
+                if (is_used(m_control[i]))
+                    m_slots[i].~T();
+            }
+        }
+
+        kfree_sized(m_control, size_in_bytes(m_capacity));
+    }
+
+    SwissHashTable(SwissHashTable const& other)
+    {
+        MUST(try_ensure_capacity(other.size()));
+        for (auto& it : other)
+            set(it);
+    }
+
+    SwissHashTable& operator=(SwissHashTable const& other)
+    {
+        SwissHashTable temporary(other);
+        swap(*this, temporary);
+        return *this;
+    }
+
+    SwissHashTable(SwissHashTable&& other) noexcept
+        : m_control(exchange(other.m_control, nullptr))
+        , m_slots(exchange(other.m_slots, nullptr))
+        , m_size(exchange(other.m_size, 0))
+        , m_deleted_count(exchange(other.m_deleted_count, 0))
+        , m_capacity(exchange(other.m_capacity, 0))
+    {
+    }
+
+    SwissHashTable& operator=(SwissHashTable&& other) noexcept
+    {
+        SwissHashTable temporary { move(other) };
+        swap(*this, temporary);
+        return *this;
+    }
+
+    friend void swap(SwissHashTable& a, SwissHashTable& b) noexcept
+    {
+        swap(a.m_control, b.m_control);
+        swap(a.m_slots, b.m_slots);
+        swap(a.m_size, b.m_size);
+        swap(a.m_deleted_count, b.m_deleted_count);
+        swap(a.m_capacity, b.m_capacity);
+    }
+
+    [[nodiscard]] bool is_empty() const { return m_size == 0; }
+    [[nodiscard]] size_t size() const { return m_size; }
+    [[nodiscard]] size_t capacity() const { return m_capacity; }
+
+    template<typename U, size_t N>
+    ErrorOr<void> try_set_from(U (&from_array)[N])
+    {
+        for (size_t i = 0; i < N; ++i)
+            TRY(try_set(from_array[i]));
+        return {};
+    }
+    template<typename U, size_t N>
+    void set_from(U (&from_array)[N])
+    {
+        MUST(try_set_from(from_array));
+    }
+
+    ErrorOr<void> try_ensure_capacity(size_t capacity)
+    {
+        // Like with HashTable, "capacity" is the number of values that can be stored without reallocating.
+        auto required_capacity = capacity_for_size(capacity);
+        if (required_capacity <= m_capacity)
+            return {};
+        return try_rehash(required_capacity);
+    }
+    void ensure_capacity(size_t capacity)
+    {
+        MUST(try_ensure_capacity(capacity));
+    }
+
+    [[nodiscard]] bool contains(T const& value) const
+    {
+        return find(value) != end();
+    }
+
+    template<Concepts::HashCompatible<T> K>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] bool contains(K const& value) const
+    {
+        return find(value) != end();
+    }
+
+    using Iterator = SwissHashTableIterator<SwissHashTable, T>;
+    using ConstIterator = SwissHashTableIterator<SwissHashTable const, T const>;
+
+    [[nodiscard]] Iterator begin()
+    {
+        for (size_t i = 0; i < m_capacity; ++i) {
+            if (is_used(m_control[i]))
+                return Iterator(&m_slots[i], &m_control[i], &m_slots[m_capacity]);
+        }
+        return end();
+    }
+
+    [[nodiscard]] Iterator end()
+    {
+        return Iterator(nullptr, nullptr, nullptr);
+    }
+
+    [[nodiscard]] ConstIterator begin() const
+    {
+        for (size_t i = 0; i < m_capacity; ++i) {
+            if (is_used(m_control[i]))
+                return ConstIterator(&m_slots[i], &m_control[i], &m_slots[m_capacity]);
+        }
+        return end();
+    }
+
+    [[nodiscard]] ConstIterator end() const
+    {
+        return ConstIterator(nullptr, nullptr, nullptr);
+    }
+
+    void clear()
+    {
+        *this = SwissHashTable();
+    }
+
+    void clear_with_capacity()
+    {
+        if (m_capacity == 0)
+            return;
+        if constexpr (!IsTriviallyDestructible<T>) {
+            for (auto& value : *this)
+                value.~T();
+        }
+        __builtin_memset(m_control, control_empty, m_capacity);
+        m_size = 0;
+        m_deleted_count = 0;
+    }
+
+    template<typename U = T>
+    ErrorOr<HashSetResult> try_set(U&& value, HashSetExistingEntryBehavior existing_entry_behavior = HashSetExistingEntryBehavior::Replace)
+    {
+        auto hash = TraitsForT::hash(value);
+        if (auto* existing_value = lookup_with_hash(hash, [&](auto& entry) { return TraitsForT::equals(entry, static_cast<T const&>(value)); })) {
+            if (existing_entry_behavior == HashSetExistingEntryBehavior::Replace) {
+                *existing_value = forward<U>(value);
+                return HashSetResult::ReplacedExistingEntry;
+            }
+            return HashSetResult::KeptExistingEntry;
+        }
+
+        if (should_grow())
+            TRY(try_rehash(capacity_for_size(m_size + 1)));
+
+        insert_new_value(hash, forward<U>(value));
+        return HashSetResult::InsertedNewEntry;
+    }
+    template<typename U = T>
+    HashSetResult set(U&& value, HashSetExistingEntryBehavior existing_entry_behavior = HashSetExistingEntryBehavior::Replace)
+    {
+        return MUST(try_set(forward<U>(value), existing_entry_behavior));
+    }
+
+    template<typename TUnaryPredicate>
+    [[nodiscard]] Iterator find(unsigned hash, TUnaryPredicate predicate)
+    {
+        return iterator_for(lookup_with_hash(hash, move(predicate)));
+    }
+
+    [[nodiscard]] Iterator find(T const& value)
+    {
+        if (is_empty())
+            return end();
+        return find(TraitsForT::hash(value), [&](auto& entry) { return TraitsForT::equals(entry, value); });
+    }
+
+    template<typename TUnaryPredicate>
+    [[nodiscard]] ConstIterator find(unsigned hash, TUnaryPredicate predicate) const
+    {
+        return iterator_for(lookup_with_hash(hash, move(predicate)));
+    }
+
+    [[nodiscard]] ConstIterator find(T const& value) const
+    {
+        if (is_empty())
+            return end();
+        return find(TraitsForT::hash(value), [&](auto& entry) { return TraitsForT::equals(entry, value); });
+    }
+
+    template<Concepts::HashCompatible<T> K>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] Iterator find(K const& value)
+    {
+        if (is_empty())
+            return end();
+        return find(Traits<K>::hash(value), [&](auto& entry) { return Traits<T>::equals(entry, value); });
+    }
+
+    template<Concepts::HashCompatible<T> K, typename TUnaryPredicate>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] Iterator find(K const& value, TUnaryPredicate predicate)
+    {
+        if (is_empty())
+            return end();
+        return find(Traits<K>::hash(value), move(predicate));
+    }
+
+    template<Concepts::HashCompatible<T> K>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] ConstIterator find(K const& value) const
+    {
+        if (is_empty())
+            return end();
+        return find(Traits<K>::hash(value), [&](auto& entry) { return Traits<T>::equals(entry, value); });
+    }
+
+    template<Concepts::HashCompatible<T> K, typename TUnaryPredicate>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] ConstIterator find(K const& value, TUnaryPredicate predicate) const
+    {
+        if (is_empty())
+            return end();
+        return find(Traits<K>::hash(value), move(predicate));
+    }
+
+    bool remove(T const& value)
+    {
+        auto it = find(value);
+        if (it != end()) {
+            remove(it);
+            return true;
+        }
+        return false;
+    }
+
+    template<Concepts::HashCompatible<T> K>
+    requires(IsSame<TraitsForT, Traits<T>>) bool remove(K const& value)
+    {
+        auto it = find(value);
+        if (it != end()) {
+            remove(it);
+            return true;
+        }
+        return false;
+    }
+
+    // This invalidates the iterator
+    void remove(Iterator& iterator)
+    {
+        VERIFY(iterator.m_slot);
+        delete_slot(iterator.m_slot - m_slots);
+        iterator.m_slot = nullptr;
+    }
+
+    template<typename TUnaryPredicate>
+    bool remove_all_matching(TUnaryPredicate const& predicate)
+    {
+        bool has_removed_anything = false;
+        for (size_t i = 0; i < m_capacity; ++i) {
+            if (!is_used(m_control[i]) || !predicate(m_slots[i]))
+                continue;
+            delete_slot(i);
+            has_removed_anything = true;
+        }
+        return has_removed_anything;
+    }
+
+    [[nodiscard]] Vector<T> values() const
+    {
+        Vector<T> list;
+        list.ensure_capacity(size());
+        for (auto& value : *this)
+            list.unchecked_append(value);
+        return list;
+    }
+
+private:
+    // The hash is mixed once more, as both halves of it have to be good: the upper bits pick the group to start
+    // probing at, the lower 7 bits go into the control byte.
+    struct SplitHash {
+        size_t group;
+        u8 control;
+    };
+    SplitHash split_hash(unsigned hash) const
+    {
+        auto mixed_hash = int_hash(hash);
+        return { (mixed_hash >> 7) & (group_count() - 1), static_cast<u8>(mixed_hash & 0x7f) };
+    }
+
+    size_t group_count() const { return m_capacity / group_size; }
+
+    SIMD::i8x16 load_group(size_t group) const
+    {
+        SIMD::i8x16 control;
+        __builtin_memcpy(&control, &m_control[group * group_size], sizeof(control));
+        return control;
+    }
+
+    // NOTE: The groups don't overlap, so a probe sequence that stops at a group with an empty slot never goes beyond
+    //       it. Probing visits each group once, as the number of groups is a power of two.
+    static size_t next_group(size_t group, size_t probe_count, size_t group_mask) { return (group + probe_count) & group_mask; }
+
+    static constexpr size_t size_in_bytes(size_t capacity)
+    {
+        return slots_offset(capacity) + sizeof(T) * capacity;
+    }
+    static constexpr size_t slots_offset(size_t capacity)
+    {
+        return align_up_to(capacity, alignof(T));
+    }
+
+    static size_t capacity_for_size(size_t size)
+    {
+        size_t capacity = group_size;
+        while (size * max_load_factor_denominator > capacity * max_load_factor_numerator)
+            capacity *= 2;
+        return capacity;
+    }
+
+    bool should_grow() const
+    {
+        return (m_size + m_deleted_count + 1) * max_load_factor_denominator > m_capacity * max_load_factor_numerator;
+    }
+
+    Iterator iterator_for(T* slot)
+    {
+        if (!slot)
+            return end();
+        return Iterator(slot, &m_control[slot - m_slots], &m_slots[m_capacity]);
+    }
+    ConstIterator iterator_for(T const* slot) const
+    {
+        if (!slot)
+            return end();
+        return ConstIterator(slot, &m_control[slot - m_slots], &m_slots[m_capacity]);
+    }
+
+    ErrorOr<void> try_rehash(size_t new_capacity)
+    {
+        // Rehashing to the same capacity gets rid of the deleted slots.
+        VERIFY(capacity_for_size(size()) <= new_capacity);
+
+        auto* new_control = static_cast<u8*>(kmalloc(size_in_bytes(new_capacity)));
+        if (!new_control)
+            return Error::from_errno(ENOMEM);
+        __builtin_memset(new_control, control_empty, new_capacity);
+
+        auto* old_control = m_control;
+        auto* old_slots = m_slots;
+        auto old_capacity = m_capacity;
+
+        m_control = new_control;
+        m_slots = reinterpret_cast<T*>(new_control + slots_offset(new_capacity));
+        m_capacity = new_capacity;
+        m_size = 0;
+        m_deleted_count = 0;
+
+        if (!old_control)
+            return {};
+
+        for (size_t i = 0; i < old_capacity; ++i) {
+            if (!is_used(old_control[i]))
+                continue;
+            insert_new_value(TraitsForT::hash(old_slots[i]), move(old_slots[i]));
+            old_slots[i].~T();
+        }
+
+        kfree_sized(old_control, size_in_bytes(old_capacity));
+        return {};
+    }
+
+    template<typename TUnaryPredicate>
+    [[nodiscard]] T* lookup_with_hash(unsigned hash, TUnaryPredicate predicate) const
+    {
+        if (is_empty())
+            return nullptr;
+
+        auto [group, control] = split_hash(hash);
+        auto group_mask = group_count() - 1;
+        auto control_to_match = SIMD::i8x16 {} + static_cast<i8>(control);
+        auto empty_control = SIMD::i8x16 {} + static_cast<i8>(control_empty);
+        for (size_t probe_count = 1;; ++probe_count) {
+            auto group_control = load_group(group);
+            for (u16 matches = SIMD::maskbits(group_control == control_to_match); matches != 0; matches &= matches - 1) {
+                auto index = group * group_size + count_trailing_zeroes(matches);
+                if (predicate(m_slots[index]))
+                    return &m_slots[index];
+            }
+            if (SIMD::maskbits(group_control == empty_control) != 0)
+                return nullptr;
+            group = next_group(group, probe_count, group_mask);
+        }
+    }
+
+    // The value must not be in the table yet, and there has to be room for it.
+    template<typename U = T>
+    void insert_new_value(unsigned hash, U&& value)
+    {
+        auto [group, control] = split_hash(hash);
+        auto group_mask = group_count() - 1;
+        for (size_t probe_count = 1;; ++probe_count) {
+            // Both empty and deleted slots have the most significant bit of their control byte set.
+            if (u16 free_slots = SIMD::maskbits(load_group(group)); free_slots != 0) {
+                auto index = group * group_size + count_trailing_zeroes(free_slots);
+                if (m_control[index] == control_deleted)
+                    --m_deleted_count;
+                new (&m_slots[index]) T(forward<U>(value));
+                m_control[index] = control;
+                ++m_size;
+                return;
+            }
+            group = next_group(group, probe_count, group_mask);
+        }
+    }
+
+    void delete_slot(size_t index)
+    {
+        VERIFY(index < m_capacity);
+        VERIFY(is_used(m_control[index]));
+
+        m_slots[index].~T();
+        --m_size;
+
+        // If the group already has an empty slot, no probe sequence goes beyond it, so this slot can become empty
+        // as well. Otherwise the values that were inserted after this group ran full must still be found.
+        auto empty_control = SIMD::i8x16 {} + static_cast<i8>(control_empty);
+        if (SIMD::maskbits(load_group(index / group_size) == empty_control) != 0) {
+            m_control[index] = control_empty;
+        } else {
+            m_control[index] = control_deleted;
+            ++m_deleted_count;
+        }
+    }
+
+    u8* m_control { nullptr };
+    T* m_slots { nullptr };
+    size_t m_size { 0 };
+    size_t m_deleted_count { 0 };
+    size_t m_capacity { 0 };
+};
+
+}
+
+#if USING_AK_GLOBALLY
+using AK::SwissHashMap;
+using AK::SwissHashTable;
+#endif
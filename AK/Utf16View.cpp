@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <AK/CharacterTypes.h>
 #include <AK/Concepts.h>
 #include <AK/StringBuilder.h>
@@ -12,6 +13,10 @@
 #include <AK/Utf32View.h>
 #include <AK/Utf8View.h>
 
+#ifdef __SSE2__
+#    include <AK/SIMDExtras.h>
+#endif
+
 namespace AK {
 
 static constexpr u16 high_surrogate_min = 0xd800;
@@ -21,31 +26,77 @@ static constexpr u16 low_surrogate_max = 0xdfff;
 static constexpr u32 replacement_code_point = 0xfffd;
 static constexpr u32 first_supplementary_plane_code_point = 0x10000;
 
-template<OneOf<Utf8View, Utf32View> UtfViewType>
-static ErrorOr<Utf16Data> to_utf16_impl(UtfViewType const& view)
-{
-    Utf16Data utf16_data;
-    TRY(utf16_data.try_ensure_capacity(view.length()));
+// Converting ASCII characters between UTF-8 and UTF-16 only changes the width of each code unit, so runs of them are
+// converted in blocks of this many, which the compiler turns into vector instructions.
+static constexpr size_t ascii_block_size = 32;
 
-    for (auto code_point : view)
-        TRY(code_point_to_utf16(utf16_data, code_point));
+static size_t ascii_prefix_length(u16 const* code_units, size_t length)
+{
+    size_t offset = 0;
+
+#ifdef __SSE2__
+    // 16 code units per step, comparing gives all bits set in the code units that aren't ASCII.
+    for (; offset + 16 <= length; offset += 16) {
+        SIMD::u16x8 low;
+        SIMD::u16x8 high;
+        __builtin_memcpy(&low, code_units + offset, sizeof(low));
+        __builtin_memcpy(&high, code_units + offset + 8, sizeof(high));
+        if (SIMD::maskbits(bit_cast<SIMD::i8x16>((low | high) > 0x7F)) != 0)
+            break;
+    }
+#endif
 
-    return utf16_data;
+    while (offset < length && code_units[offset] <= 0x7F)
+        ++offset;
+    return offset;
 }
 
 ErrorOr<Utf16Data> utf8_to_utf16(StringView utf8_view)
 {
-    return to_utf16_impl(Utf8View { utf8_view });
+    return utf8_to_utf16(Utf8View { utf8_view });
 }
 
-ErrorOr<Utf16Data> utf8_to_utf16(Utf8View const& utf8_view)
+ErrorOr<Utf16Data> utf8_to_utf16(Utf8View const& view)
 {
-    return to_utf16_impl(utf8_view);
+    Utf16Data utf16_data;
+    TRY(utf16_data.try_ensure_capacity(view.length()));
+
+    auto string = view.as_string();
+    auto const* bytes = reinterpret_cast<u8 const*>(string.characters_without_null_termination());
+
+    for (size_t offset = 0; offset < string.length();) {
+        // OPTIMIZATION: Widen runs of ASCII characters directly, instead of decoding them one by one.
+        if (auto ascii_length = Utf8View::ascii_prefix_length(string.substring_view(offset)); ascii_length > 0) {
+            TRY(utf16_data.try_ensure_capacity(utf16_data.size() + ascii_length));
+            for (size_t block_offset = 0; block_offset < ascii_length; block_offset += ascii_block_size) {
+                auto block_length = min(ascii_length - block_offset, ascii_block_size);
+                Array<u16, ascii_block_size> block;
+                for (size_t i = 0; i < block_length; ++i)
+                    block[i] = bytes[offset + block_offset + i];
+                utf16_data.unchecked_append(block.data(), block_length);
+            }
+            offset += ascii_length;
+            continue;
+        }
+
+        auto it = view.iterator_at_byte_offset_without_validation(offset);
+        TRY(code_point_to_utf16(utf16_data, *it));
+        ++it;
+        offset = view.byte_offset_of(it);
+    }
+
+    return utf16_data;
 }
 
 ErrorOr<Utf16Data> utf32_to_utf16(Utf32View const& utf32_view)
 {
-    return to_utf16_impl(utf32_view);
+    Utf16Data utf16_data;
+    TRY(utf16_data.try_ensure_capacity(utf32_view.length()));
+
+    for (auto code_point : utf32_view)
+        TRY(code_point_to_utf16(utf16_data, code_point));
+
+    return utf16_data;
 }
 
 ErrorOr<void> code_point_to_utf16(Utf16Data& string, u32 code_point)
@@ -90,24 +141,38 @@ ErrorOr<String> Utf16View::to_utf8(AllowInvalidCodeUnits allow_invalid_code_unit
 {
     StringBuilder builder;
 
-    if (allow_invalid_code_units == AllowInvalidCodeUnits::Yes) {
-        for (auto const* ptr = begin_ptr(); ptr < end_ptr(); ++ptr) {
-            if (is_high_surrogate(*ptr)) {
-                auto const* next = ptr + 1;
-
-                if ((next < end_ptr()) && is_low_surrogate(*next)) {
-                    auto code_point = decode_surrogate_pair(*ptr, *next);
-                    TRY(builder.try_append_code_point(code_point));
-                    ++ptr;
-                    continue;
-                }
+    for (auto const* ptr = begin_ptr(); ptr < end_ptr(); ++ptr) {
+        // OPTIMIZATION: Narrow runs of ASCII characters directly, instead of encoding them one by one.
+        if (auto ascii_length = ascii_prefix_length(ptr, end_ptr() - ptr); ascii_length > 0) {
+            for (size_t block_offset = 0; block_offset < ascii_length; block_offset += ascii_block_size) {
+                auto block_length = min(ascii_length - block_offset, ascii_block_size);
+                Array<char, ascii_block_size> block;
+                for (size_t i = 0; i < block_length; ++i)
+                    block[i] = static_cast<char>(ptr[block_offset + i]);
+                TRY(builder.try_append(block.data(), block_length));
             }
+            ptr += ascii_length - 1;
+            continue;
+        }
 
-            TRY(builder.try_append_code_point(static_cast<u32>(*ptr)));
+        if (is_high_surrogate(*ptr)) {
+            auto const* next = ptr + 1;
+
+            if ((next < end_ptr()) && is_low_surrogate(*next)) {
+                auto code_point = decode_surrogate_pair(*ptr, *next);
+                TRY(builder.try_append_code_point(code_point));
+                ++ptr;
+                continue;
+            }
         }
-    } else {
-        for (auto code_point : *this)
-            TRY(builder.try_append_code_point(code_point));
+
+        // Unpaired surrogates are kept as they are if they are allowed, and replaced otherwise (like the iterator does).
+        if (allow_invalid_code_units == AllowInvalidCodeUnits::No && (is_high_surrogate(*ptr) || is_low_surrogate(*ptr))) {
+            TRY(builder.try_append_code_point(replacement_code_point));
+            continue;
+        }
+
+        TRY(builder.try_append_code_point(static_cast<u32>(*ptr)));
     }
 
     return builder.to_string();
@@ -6,10 +6,15 @@
  */
 
 #include <AK/Assertions.h>
+#include <AK/BuiltinWrappers.h>
 #include <AK/Debug.h>
 #include <AK/Format.h>
 #include <AK/Utf8View.h>
 
+#ifdef __SSE2__
+#    include <AK/SIMDExtras.h>
+#endif
+
 namespace AK {
 
 Utf8CodePointIterator Utf8View::iterator_at_byte_offset(size_t byte_offset) const
@@ -70,15 +75,58 @@ Utf8View Utf8View::unicode_substring_view(size_t code_point_offset, size_t code_
     VERIFY_NOT_REACHED();
 }
 
+size_t Utf8View::ascii_prefix_length(StringView string)
+{
+    static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "The lowest bit of a word has to belong to its first byte");
+
+    auto const* bytes = reinterpret_cast<u8 const*>(string.characters_without_null_termination());
+    size_t length = string.length();
+    size_t offset = 0;
+
+#ifdef __SSE2__
+    // 32 bytes per step, the high bit of every byte ends up in the mask, and that is only set for non-ASCII bytes.
+    for (; offset + 32 <= length; offset += 32) {
+        SIMD::i8x16 low;
+        SIMD::i8x16 high;
+        __builtin_memcpy(&low, bytes + offset, sizeof(low));
+        __builtin_memcpy(&high, bytes + offset + sizeof(low), sizeof(high));
+        u32 mask = SIMD::maskbits(low) | (static_cast<u32>(SIMD::maskbits(high)) << 16);
+        if (mask != 0)
+            return offset + count_trailing_zeroes(mask);
+    }
+#endif
+
+    // Eight bytes per step otherwise, and for what is left over.
+    for (; offset + sizeof(u64) <= length; offset += sizeof(u64)) {
+        u64 word;
+        __builtin_memcpy(&word, bytes + offset, sizeof(word));
+        if (auto high_bits = word & 0x8080808080808080ull; high_bits != 0)
+            return offset + count_trailing_zeroes(high_bits) / 8;
+    }
+
+    while (offset < length && bytes[offset] <= 0x7F)
+        ++offset;
+    return offset;
+}
+
 size_t Utf8View::calculate_length() const
 {
     size_t length = 0;
 
-    for (size_t i = 0; i < m_string.length(); ++length) {
+    for (size_t i = 0; i < m_string.length();) {
+        // OPTIMIZATION: Every ASCII character is a code point of its own, count runs of them many bytes at a time.
+        if (static_cast<u8>(m_string[i]) <= 0x7F) {
+            auto ascii_length = ascii_prefix_length(m_string.substring_view(i));
+            i += ascii_length;
+            length += ascii_length;
+            continue;
+        }
+
         auto [byte_length, code_point, is_valid] = decode_leading_byte(static_cast<u8>(m_string[i]));
 
         // Similar to Utf8CodePointIterator::operator++, if the byte is invalid, try the next byte.
         i += is_valid ? byte_length : 1;
+        ++length;
     }
 
     return length;
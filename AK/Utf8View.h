@@ -131,16 +131,23 @@ public:
     {
         valid_bytes = 0;
 
-        for (auto it = m_string.begin(); it != m_string.end(); ++it) {
-            auto [byte_length, code_point, is_valid] = decode_leading_byte(static_cast<u8>(*it));
+        while (valid_bytes < m_string.length()) {
+            // OPTIMIZATION: ASCII characters are always valid, skip over runs of them many bytes at a time.
+            if (!is_constant_evaluated() && static_cast<u8>(m_string[valid_bytes]) <= 0x7F) {
+                valid_bytes += ascii_prefix_length(m_string.substring_view(valid_bytes));
+                if (valid_bytes == m_string.length())
+                    break;
+            }
+
+            auto [byte_length, code_point, is_valid] = decode_leading_byte(static_cast<u8>(m_string[valid_bytes]));
             if (!is_valid)
                 return false;
 
             for (size_t i = 1; i < byte_length; ++i) {
-                if (++it == m_string.end())
+                if (valid_bytes + i == m_string.length())
                     return false;
 
-                auto [code_point_bits, is_valid] = decode_continuation_byte(static_cast<u8>(*it));
+                auto [code_point_bits, is_valid] = decode_continuation_byte(static_cast<u8>(m_string[valid_bytes + i]));
                 if (!is_valid)
                     return false;
 
@@ -157,6 +164,9 @@ public:
         return true;
     }
 
+    // Returns the number of ASCII characters the string starts with, looking at many bytes at a time.
+    static size_t ascii_prefix_length(StringView);
+
 private:
     friend class Utf8CodePointIterator;
 
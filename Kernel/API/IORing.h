@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+// An I/O ring is a pair of ring buffers shared between a process and the kernel, which is mapped by
+// mmap()ing the file descriptor returned by io_ring_create(). Userspace queues up operations in the
+// submission ring and hands all of them to the kernel with a single io_ring_enter() call, the kernel
+// then posts the results into the completion ring (and the file descriptor becomes readable).
+//
+// Both rings are indexed by free-running counters, an entry lives at (counter & mask). The kernel
+// only ever writes submission_head and completion_tail, userspace only submission_tail and completion_head.
+
+enum class IORingOpcode : u8 {
+    Nop,
+    // Reads into / writes from buffer, at offset or at the current file offset if offset is negative.
+    Read,
+    Write,
+    Fsync,
+    Close,
+};
+
+struct IORingSubmission {
+    IORingOpcode opcode { IORingOpcode::Nop };
+    u8 reserved[3] {};
+    i32 fd { -1 };
+    i64 offset { -1 };
+    u64 buffer { 0 };
+    u64 length { 0 };
+    // Handed back untouched in the completion of this submission.
+    u64 user_data { 0 };
+};
+static_assert(sizeof(IORingSubmission) == 40);
+
+struct IORingCompletion {
+    u64 user_data { 0 };
+    // What the equivalent syscall would have returned, a negated errno code on failure.
+    i64 result { 0 };
+};
+static_assert(sizeof(IORingCompletion) == 16);
+
+struct IORingHeader {
+    u32 submission_head;
+    u32 submission_tail;
+    u32 submission_mask;
+    u32 completion_head;
+    u32 completion_tail;
+    u32 completion_mask;
+    // Offsets of the submission and completion arrays from the start of the mapping.
+    u32 submissions_offset;
+    u32 completions_offset;
+    // How large a mapping of the ring has to be.
+    u32 size;
+};
+
+// The completion ring is larger, so that it doesn't run full while userspace keeps submitting.
+constexpr u32 IO_RING_COMPLETIONS_PER_SUBMISSION = 2;
+constexpr u32 IO_RING_MAX_ENTRIES = 4096;
@@ -6,12 +6,48 @@
 
 #pragma once
 
+#include <Kernel/API/POSIX/sys/types.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 #define TCP_NODELAY 10
 #define TCP_MAXSEG 11
+#define TCP_INFO 12
+#define TCP_CONGESTION 13
+
+#define TCP_CA_NAME_MAX 16
+
+#define TCPI_OPT_SACK 1
+#define TCPI_OPT_WSCALE 2
+
+#define TCP_CA_Open 0
+#define TCP_CA_Recovery 3
+#define TCP_CA_Loss 4
+
+// What getsockopt(TCP_INFO) returns, times are in microseconds.
+struct tcp_info {
+    uint8_t tcpi_options;
+    uint8_t tcpi_snd_wscale;
+    uint8_t tcpi_rcv_wscale;
+    // One of the TCP_CA_* values.
+    uint8_t tcpi_ca_state;
+    uint32_t tcpi_retransmits;
+    uint32_t tcpi_rto;
+    uint32_t tcpi_snd_mss;
+    uint32_t tcpi_rtt;
+    uint32_t tcpi_rttvar;
+    // The unacknowledged and selectively acknowledged bytes that were sent.
+    uint32_t tcpi_unacked;
+    uint32_t tcpi_sacked;
+    // The congestion window and slow start threshold, in bytes.
+    uint32_t tcpi_snd_cwnd;
+    uint32_t tcpi_snd_ssthresh;
+    uint32_t tcpi_snd_wnd;
+    uint32_t tcpi_total_retrans;
+    uint32_t tcpi_fast_retrans;
+};
 
 #ifdef __cplusplus
 }
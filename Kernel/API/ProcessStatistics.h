@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+// /sys/kernel/process_statistics has the same contents as /sys/kernel/processes, but in a compact
+// binary form that is much cheaper to generate and to parse than JSON.
+//
+// The file starts with a ProcessStatisticsHeader, followed by a sequence of records, each beginning
+// with its type. Thread records belong to the process record before them, and the final record is a
+// totals record. Process and thread records are followed by their strings (in the order listed in
+// the struct), each stored as a u16 length followed by that many bytes.
+
+static constexpr u32 process_statistics_magic = 0x54535350; // "PSST"
+static constexpr u32 process_statistics_version = 1;
+
+enum class ProcessStatisticsRecordType : u32 {
+    Process = 1,
+    Thread = 2,
+    Totals = 3,
+};
+
+struct ProcessStatisticsHeader {
+    u32 magic;
+    u32 version;
+};
+static_assert(sizeof(ProcessStatisticsHeader) == 8);
+
+// Followed by the strings name, executable, tty, pledge and veil.
+struct ProcessStatisticsProcessRecord {
+    ProcessStatisticsRecordType type;
+    i32 pid;
+    i32 pgid;
+    i32 pgp;
+    i32 sid;
+    u32 uid;
+    u32 gid;
+    i32 ppid;
+    u8 kernel;
+    u8 dumpable;
+    u8 reserved[6];
+    i64 creation_time;
+    u64 amount_virtual;
+    u64 amount_resident;
+    u64 amount_shared;
+    u64 amount_dirty_private;
+    u64 amount_clean_inode;
+    u64 amount_purgeable_volatile;
+    u64 amount_purgeable_nonvolatile;
+};
+static_assert(sizeof(ProcessStatisticsProcessRecord) == 104);
+
+// Followed by the strings name and state.
+struct ProcessStatisticsThreadRecord {
+    ProcessStatisticsRecordType type;
+    i32 tid;
+    u32 times_scheduled;
+    u32 cpu;
+    u32 priority;
+    u32 syscall_count;
+    u32 inode_faults;
+    u32 zero_faults;
+    u32 cow_faults;
+    u32 reserved;
+    u64 time_user;
+    u64 time_kernel;
+    u64 file_read_bytes;
+    u64 file_write_bytes;
+    u64 unix_socket_read_bytes;
+    u64 unix_socket_write_bytes;
+    u64 ipv4_socket_read_bytes;
+    u64 ipv4_socket_write_bytes;
+};
+static_assert(sizeof(ProcessStatisticsThreadRecord) == 104);
+
+struct ProcessStatisticsTotalsRecord {
+    ProcessStatisticsRecordType type;
+    u32 reserved;
+    u64 total_time;
+    u64 total_time_kernel;
+};
+static_assert(sizeof(ProcessStatisticsTotalsRecord) == 24);
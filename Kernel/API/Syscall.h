@@ -71,6 +71,9 @@ enum class NeedsBigProcessLock {
     S(dump_backtrace, NeedsBigProcessLock::No)             \
     S(dup2, NeedsBigProcessLock::No)                       \
     S(emuctl, NeedsBigProcessLock::No)                     \
+    S(epoll_create1, NeedsBigProcessLock::No)              \
+    S(epoll_ctl, NeedsBigProcessLock::No)                  \
+    S(epoll_wait, NeedsBigProcessLock::No)                 \
     S(execve, NeedsBigProcessLock::Yes)                    \
     S(exit, NeedsBigProcessLock::Yes)                      \
     S(exit_thread, NeedsBigProcessLock::Yes)               \
@@ -86,7 +89,7 @@ enum class NeedsBigProcessLock {
     S(fsmount, NeedsBigProcessLock::No)                    \
     S(fsync, NeedsBigProcessLock::No)                      \
     S(ftruncate, NeedsBigProcessLock::No)                  \
-    S(futex, NeedsBigProcessLock::Yes)                     \
+    S(futex, NeedsBigProcessLock::No)                      \
     S(futimens, NeedsBigProcessLock::No)                   \
     S(get_dir_entries, NeedsBigProcessLock::No)            \
     S(get_root_session_id, NeedsBigProcessLock::No)        \
@@ -114,6 +117,8 @@ enum class NeedsBigProcessLock {
     S(getuid, NeedsBigProcessLock::No)                     \
     S(inode_watcher_add_watch, NeedsBigProcessLock::No)    \
     S(inode_watcher_remove_watch, NeedsBigProcessLock::No) \
+    S(io_ring_create, NeedsBigProcessLock::No)             \
+    S(io_ring_enter, NeedsBigProcessLock::No)              \
     S(ioctl, NeedsBigProcessLock::No)                      \
     S(join_thread, NeedsBigProcessLock::No)                \
     S(jail_create, NeedsBigProcessLock::No)                \
@@ -140,26 +145,28 @@ enum class NeedsBigProcessLock {
     S(pledge, NeedsBigProcessLock::No)                     \
     S(poll, NeedsBigProcessLock::No)                       \
     S(posix_fallocate, NeedsBigProcessLock::No)            \
+    S(posix_spawn, NeedsBigProcessLock::No)                \
     S(prctl, NeedsBigProcessLock::No)                      \
     S(profiling_disable, NeedsBigProcessLock::Yes)         \
     S(profiling_enable, NeedsBigProcessLock::Yes)          \
     S(profiling_free_buffer, NeedsBigProcessLock::Yes)     \
     S(ptrace, NeedsBigProcessLock::Yes)                    \
     S(purge, NeedsBigProcessLock::Yes)                     \
-    S(read, NeedsBigProcessLock::Yes)                      \
-    S(pread, NeedsBigProcessLock::Yes)                     \
+    S(read, NeedsBigProcessLock::No)                       \
+    S(pread, NeedsBigProcessLock::No)                      \
     S(readlink, NeedsBigProcessLock::No)                   \
-    S(readv, NeedsBigProcessLock::Yes)                     \
+    S(readv, NeedsBigProcessLock::No)                      \
     S(realpath, NeedsBigProcessLock::No)                   \
     S(recvfd, NeedsBigProcessLock::No)                     \
-    S(recvmsg, NeedsBigProcessLock::Yes)                   \
+    S(recvmsg, NeedsBigProcessLock::No)                    \
     S(rename, NeedsBigProcessLock::No)                     \
     S(remount, NeedsBigProcessLock::No)                    \
     S(rmdir, NeedsBigProcessLock::No)                      \
     S(scheduler_get_parameters, NeedsBigProcessLock::No)   \
     S(scheduler_set_parameters, NeedsBigProcessLock::No)   \
     S(sendfd, NeedsBigProcessLock::No)                     \
-    S(sendmsg, NeedsBigProcessLock::Yes)                   \
+    S(sendfile, NeedsBigProcessLock::Yes)                  \
+    S(sendmsg, NeedsBigProcessLock::No)                    \
     S(set_mmap_name, NeedsBigProcessLock::No)              \
     S(setegid, NeedsBigProcessLock::No)                    \
     S(seteuid, NeedsBigProcessLock::No)                    \
@@ -199,8 +206,8 @@ enum class NeedsBigProcessLock {
     S(utime, NeedsBigProcessLock::No)                      \
     S(utimensat, NeedsBigProcessLock::No)                  \
     S(waitid, NeedsBigProcessLock::Yes)                    \
-    S(write, NeedsBigProcessLock::Yes)                     \
-    S(pwritev, NeedsBigProcessLock::Yes)                   \
+    S(write, NeedsBigProcessLock::No)                      \
+    S(pwritev, NeedsBigProcessLock::No)                    \
     S(yield, NeedsBigProcessLock::No)
 
 namespace Syscall {
@@ -217,6 +224,18 @@ enum Function {
         __Count
 };
 
+#ifdef KERNEL
+// How often a syscall had to take the big process lock, and how often another thread of the same process was already holding it.
+struct BigLockStatistics {
+    StringView syscall_name;
+    bool needs_big_lock { false };
+    u64 acquisitions { 0 };
+    u64 contentions { 0 };
+};
+
+BigLockStatistics big_lock_statistics(Function);
+#endif
+
 #ifdef AK_OS_SERENITY
 struct StringArgument {
     char const* characters;
@@ -266,6 +285,14 @@ struct SC_poll_params {
     u32 const* sigmask;
 };
 
+struct SC_epoll_wait_params {
+    int epoll_fd;
+    struct epoll_event* events;
+    int max_events;
+    const struct timespec* timeout;
+    u32 const* sigmask;
+};
+
 struct SC_clock_nanosleep_params {
     int clock_id;
     int flags;
@@ -394,6 +421,40 @@ struct SC_execve_params {
     StringListArgument environment;
 };
 
+enum class PosixSpawnFileActionType : u8 {
+    Open,
+    Close,
+    Dup2,
+    Chdir,
+    Fchdir,
+};
+
+struct SC_posix_spawn_file_action {
+    PosixSpawnFileActionType type;
+    int fd;
+    int new_fd;
+    int options;
+    u16 mode;
+    StringArgument path;
+};
+
+struct SC_posix_spawn_params {
+    StringArgument path;
+    StringListArgument arguments;
+    StringListArgument environment;
+    SC_posix_spawn_file_action const* file_actions;
+    size_t file_actions_count;
+    bool reset_ids;
+    bool set_process_group;
+    bool set_priority;
+    bool set_signal_mask;
+    bool create_session;
+    pid_t process_group;
+    int priority;
+    u32 signal_mask;
+    u32 default_signals;
+};
+
 struct SC_readlink_params {
     StringArgument path;
     MutableBufferArgument<char, size_t> buffer;
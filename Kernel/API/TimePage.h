@@ -24,6 +24,11 @@ inline bool time_page_supports(clockid_t clock_id)
 struct TimePage {
     u32 volatile update1;
     struct timespec clocks[CLOCK_ID_COUNT];
+    // If tsc_frequency is non-zero, the precise clocks can be derived from their coarse
+    // counterparts by adding the time elapsed on the TSC since tsc_at_update, up to one tick.
+    u64 tsc_frequency;
+    u64 tsc_at_update;
+    u64 nanoseconds_per_tick;
     u32 volatile update2;
 };
 
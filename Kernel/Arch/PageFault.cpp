@@ -11,6 +11,7 @@
 #include <Kernel/Arch/SafeMem.h>
 #include <Kernel/Tasks/PerformanceManager.h>
 #include <Kernel/Tasks/Thread.h>
+#include <Kernel/Tasks/TraceBuffer.h>
 
 namespace Kernel {
 
@@ -32,6 +33,7 @@ void PageFault::handle(RegisterState& regs)
     }
 
     auto current_thread = Thread::current();
+    TraceBuffer::record(TraceEventType::PageFault, fault_address, regs.ip());
 
     if (current_thread) {
         current_thread->set_handling_page_fault(true);
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+namespace Kernel {
+
+struct PerformanceCounterValues {
+    u64 cycles { 0 };
+    u64 instructions { 0 };
+    u64 cache_misses { 0 };
+    u64 branch_misses { 0 };
+};
+
+namespace PerformanceCounters {
+
+// Starts the hardware performance counters on the current processor, if it has any.
+void initialize(u32 cpu);
+bool is_available();
+
+// Reads the counters of the current processor.
+PerformanceCounterValues read();
+
+// Returns the events counted on the current processor since the baseline was taken, and updates the baseline.
+PerformanceCounterValues take_delta(PerformanceCounterValues& baseline);
+
+}
+
+}
@@ -29,6 +29,7 @@ enum class InterruptsState {
 
 namespace Memory {
 class PageDirectory;
+class TLBFlushBatch;
 }
 
 struct TrapFrame;
@@ -68,6 +69,7 @@ public:
 
     static void flush_tlb_local(VirtualAddress vaddr, size_t page_count);
     static void flush_tlb(Memory::PageDirectory const*, VirtualAddress, size_t);
+    static void flush_tlb(Memory::TLBFlushBatch const&);
 
     void early_initialize(u32 cpu);
     void initialize(u32 cpu);
@@ -245,6 +247,7 @@ struct ProcessorMessage {
 
     enum Type {
         FlushTlb,
+        FlushTlbBatch,
         Callback,
     };
     Type type;
@@ -257,6 +260,7 @@ struct ProcessorMessage {
             u8* ptr;
             size_t page_count;
         } flush_tlb;
+        Memory::TLBFlushBatch const* flush_tlb_batch; // only used for synchronous messages
     };
 
     bool volatile async;
@@ -14,6 +14,7 @@
 #include <Kernel/Arch/aarch64/CPU.h>
 #include <Kernel/Arch/aarch64/CPUID.h>
 #include <Kernel/Interrupts/InterruptDisabler.h>
+#include <Kernel/Memory/TLBFlushBatch.h>
 #include <Kernel/Security/Random.h>
 #include <Kernel/Tasks/Process.h>
 #include <Kernel/Tasks/Scheduler.h>
@@ -86,6 +87,13 @@ void ProcessorBase<T>::flush_tlb(Memory::PageDirectory const*, VirtualAddress va
     flush_tlb_local(vaddr, page_count);
 }
 
+template<typename T>
+void ProcessorBase<T>::flush_tlb(Memory::TLBFlushBatch const& batch)
+{
+    for (auto const& range : batch.ranges())
+        flush_tlb(&batch.page_directory(), range.vaddr, range.page_count);
+}
+
 template<typename T>
 u32 ProcessorBase<T>::clear_critical()
 {
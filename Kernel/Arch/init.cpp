@@ -57,9 +57,11 @@
 #include <Kernel/Sections.h>
 #include <Kernel/Security/Random.h>
 #include <Kernel/Tasks/FinalizerTask.h>
+#include <Kernel/Tasks/PhysicalMemoryTask.h>
 #include <Kernel/Tasks/Process.h>
 #include <Kernel/Tasks/Scheduler.h>
 #include <Kernel/Tasks/SyncTask.h>
+#include <Kernel/Tasks/TraceBuffer.h>
 #include <Kernel/Tasks/WorkQueue.h>
 #include <Kernel/Time/TimeManagement.h>
 #include <Kernel/kstdio.h>
@@ -384,6 +386,8 @@ void init_stage2(void*)
     }
 #endif
 
+    TraceBuffer::initialize();
+
     // Initialize the PCI Bus as early as possible, for early boot (PCI based) serial logging
     PCI::initialize();
     if (!PCI::Access::is_disabled()) {
@@ -414,6 +418,7 @@ void init_stage2(void*)
 
     SyncTask::spawn();
     FinalizerTask::spawn();
+    PhysicalMemoryTask::spawn();
 
     auto boot_profiling = kernel_command_line().is_boot_profiling_enabled();
 
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Arch/PerformanceCounters.h>
+
+namespace Kernel::PerformanceCounters {
+
+// FIXME: Support the hardware performance counters on this architecture.
+
+void initialize(u32)
+{
+}
+
+bool is_available()
+{
+    return false;
+}
+
+PerformanceCounterValues read()
+{
+    return {};
+}
+
+PerformanceCounterValues take_delta(PerformanceCounterValues&)
+{
+    return {};
+}
+
+}
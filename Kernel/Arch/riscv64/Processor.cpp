@@ -8,6 +8,7 @@
 #include <Kernel/Arch/Processor.h>
 #include <Kernel/Arch/TrapFrame.h>
 #include <Kernel/Interrupts/InterruptDisabler.h>
+#include <Kernel/Memory/TLBFlushBatch.h>
 #include <Kernel/Sections.h>
 #include <Kernel/Security/Random.h>
 #include <Kernel/Tasks/Process.h>
@@ -163,6 +164,13 @@ void ProcessorBase<T>::flush_tlb(Memory::PageDirectory const*, VirtualAddress va
     flush_tlb_local(vaddr, page_count);
 }
 
+template<typename T>
+void ProcessorBase<T>::flush_tlb(Memory::TLBFlushBatch const& batch)
+{
+    for (auto const& range : batch.ranges())
+        flush_tlb(&batch.page_directory(), range.vaddr, range.page_count);
+}
+
 template<typename T>
 u32 ProcessorBase<T>::clear_critical()
 {
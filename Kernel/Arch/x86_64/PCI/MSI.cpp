@@ -6,8 +6,10 @@
 
 #include <Kernel/Arch/Interrupts.h>
 #include <Kernel/Arch/PCIMSI.h>
+#include <Kernel/Arch/Processor.h>
 #include <Kernel/Arch/x86_64/Interrupts/APIC.h>
 #include <Kernel/Arch/x86_64/PCI/MSI.h>
+#include <Kernel/Arch/x86_64/ProcessorInfo.h>
 #include <Kernel/Interrupts/InterruptDisabler.h>
 
 namespace Kernel {
@@ -41,6 +43,16 @@ u32 msix_vector_control_register(u32 vector_control, bool mask)
     return (vector_control | msi_vector_control_mask);
 }
 
+u8 msi_destination_id_for_processor(u32 processor_id)
+{
+    VERIFY(processor_id < Processor::count());
+    auto apic_id = Processor::by_id(processor_id).info().apic_id();
+    // NOTE: Without interrupt remapping, messages can only be addressed to the first 256 local APICs.
+    if (apic_id > NumericLimits<u8>::max())
+        return Processor::by_id(0).info().apic_id();
+    return apic_id;
+}
+
 void msi_signal_eoi()
 {
     InterruptDisabler disabler;
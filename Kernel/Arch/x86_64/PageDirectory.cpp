@@ -23,6 +23,7 @@ struct CR3Map {
 };
 
 static Singleton<CR3Map> s_cr3_map;
+static Atomic<u64> s_next_page_directory_id { 1 };
 
 void PageDirectory::register_page_directory(PageDirectory* directory)
 {
@@ -41,7 +42,8 @@ void PageDirectory::deregister_page_directory(PageDirectory* directory)
 LockRefPtr<PageDirectory> PageDirectory::find_current()
 {
     return s_cr3_map->map.with([&](auto& map) {
-        return map.find(read_cr3());
+        // NOTE: The low bits of CR3 hold the PCID if that is enabled.
+        return map.find(PhysicalAddress::physical_page_base(read_cr3()));
     });
 }
 
@@ -52,8 +54,9 @@ void activate_kernel_page_directory(PageDirectory const& pgd)
 
 void activate_page_directory(PageDirectory const& pgd, Thread* current_thread)
 {
-    current_thread->regs().cr3 = pgd.cr3();
-    write_cr3(pgd.cr3());
+    InterruptDisabler disabler;
+    current_thread->regs().set_page_directory(pgd);
+    Processor::current().switch_page_directory(pgd);
 }
 
 UNMAP_AFTER_INIT NonnullLockRefPtr<PageDirectory> PageDirectory::must_create_kernel_page_directory()
@@ -124,7 +127,10 @@ ErrorOr<NonnullLockRefPtr<PageDirectory>> PageDirectory::try_create_for_userspac
     return directory;
 }
 
-PageDirectory::PageDirectory() = default;
+PageDirectory::PageDirectory()
+    : m_id(s_next_page_directory_id.fetch_add(1, AK::MemoryOrder::memory_order_relaxed))
+{
+}
 
 UNMAP_AFTER_INIT void PageDirectory::allocate_kernel_directory()
 {
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/AtomicRefCounted.h>
 #include <AK/Badge.h>
 #include <AK/HashMap.h>
@@ -184,6 +185,23 @@ public:
 
     RecursiveSpinlock<LockRank::None>& get_lock() { return m_lock; }
 
+    // A unique identifier that is never reused, used to tag TLB entries with a PCID.
+    u64 id() const { return m_id; }
+
+    // The processors that currently have this page directory loaded in CR3. Only these
+    // processors need to be interrupted when a userspace range of it is flushed.
+    u64 active_processor_mask() const { return m_active_processor_mask.load(AK::MemoryOrder::memory_order_seq_cst); }
+    void set_active_on_processor(u32 cpu) const { m_active_processor_mask.fetch_or(1ull << cpu, AK::MemoryOrder::memory_order_seq_cst); }
+    void clear_active_on_processor(u32 cpu) const { m_active_processor_mask.fetch_and(~(1ull << cpu), AK::MemoryOrder::memory_order_seq_cst); }
+
+    // Incremented whenever a userspace range is flushed. Processors that skipped the shootdown
+    // because they weren't running this page directory at the time compare it against the value
+    // they saw when they last loaded it, and flush their PCID if it changed in the meantime.
+    // NOTE: The generation has to be bumped *before* looking at the active processor mask,
+    //       while a processor switching to us sets its active bit *before* reading the generation.
+    u64 tlb_generation() const { return m_tlb_generation.load(AK::MemoryOrder::memory_order_seq_cst); }
+    void bump_tlb_generation() const { m_tlb_generation.fetch_add(1, AK::MemoryOrder::memory_order_seq_cst); }
+
     // This has to be public to let the global singleton access the member pointer
     IntrusiveRedBlackTreeNode<FlatPtr, PageDirectory, RawPtr<PageDirectory>> m_tree_node;
 
@@ -197,6 +215,10 @@ private:
     RefPtr<PhysicalRAMPage> m_directory_table;
     RefPtr<PhysicalRAMPage> m_directory_pages[512];
     RecursiveSpinlock<LockRank::None> m_lock {};
+
+    u64 const m_id;
+    mutable Atomic<u64> m_active_processor_mask { 0 };
+    mutable Atomic<u64> m_tlb_generation { 0 };
 };
 
 void activate_kernel_page_directory(PageDirectory const& pgd);
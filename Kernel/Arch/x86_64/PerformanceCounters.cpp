@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/NumericLimits.h>
+#include <AK/SetOnce.h>
+#include <Kernel/Arch/PerformanceCounters.h>
+#include <Kernel/Arch/x86_64/CPUID.h>
+#include <Kernel/Arch/x86_64/MSR.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel::PerformanceCounters {
+
+#define MSR_IA32_PERFEVTSEL0 0x186
+#define MSR_IA32_PERF_GLOBAL_CTRL 0x38f
+
+#define PERFEVTSEL_USR (1 << 16)
+#define PERFEVTSEL_OS (1 << 17)
+#define PERFEVTSEL_EN (1 << 22)
+
+// See Intel SDM Vol. 3B, 20.2.1.2 "Pre-defined Architectural Performance Events".
+struct ArchitecturalEvent {
+    u8 event_select;
+    u8 unit_mask;
+    u8 unavailable_bit; // in CPUID.0AH:EBX
+};
+
+// These are programmed into the general-purpose counters in the order of PerformanceCounterValues.
+static constexpr Array<ArchitecturalEvent, 4> s_events {
+    ArchitecturalEvent { 0x3c, 0x00, 0 }, // UnHalted Core Cycles
+    ArchitecturalEvent { 0xc0, 0x00, 1 }, // Instructions Retired
+    ArchitecturalEvent { 0x2e, 0x41, 4 }, // LLC Misses
+    ArchitecturalEvent { 0xc5, 0x00, 6 }, // Branch Mispredicts Retired
+};
+
+static SetOnce s_available;
+static u64 s_counter_mask;
+
+static u64 read_counter(u32 index)
+{
+    u32 low, high;
+    asm volatile("rdpmc"
+                 : "=a"(low), "=d"(high)
+                 : "c"(index));
+    return ((u64)high << 32) | low;
+}
+
+UNMAP_AFTER_INIT void initialize(u32 cpu)
+{
+    if (cpu != 0 && !s_available.was_set())
+        return;
+
+    if (CPUID(0).eax() < 0xa)
+        return;
+
+    CPUID perfmon(0xa);
+    auto version = perfmon.eax() & 0xff;
+    auto counter_count = (perfmon.eax() >> 8) & 0xff;
+    auto counter_width = (perfmon.eax() >> 16) & 0xff;
+    if (version < 2 || counter_count < s_events.size() || counter_width == 0 || counter_width > 64)
+        return;
+    for (auto& event : s_events) {
+        if (perfmon.ebx() & (1u << event.unavailable_bit))
+            return;
+    }
+
+    for (size_t i = 0; i < s_events.size(); ++i) {
+        MSR event_select(MSR_IA32_PERFEVTSEL0 + i);
+        event_select.set(PERFEVTSEL_USR | PERFEVTSEL_OS | PERFEVTSEL_EN | (s_events[i].unit_mask << 8) | s_events[i].event_select);
+    }
+
+    MSR global_control(MSR_IA32_PERF_GLOBAL_CTRL);
+    global_control.set(global_control.get() | ((1u << s_events.size()) - 1));
+
+    if (cpu == 0) {
+        s_counter_mask = counter_width == 64 ? NumericLimits<u64>::max() : (1ull << counter_width) - 1;
+        s_available.set();
+        dmesgln("PerformanceCounters: Using {} architectural performance counters (version {}, {} bits wide)", s_events.size(), version, counter_width);
+    }
+}
+
+bool is_available()
+{
+    return s_available.was_set();
+}
+
+PerformanceCounterValues read()
+{
+    if (!is_available())
+        return {};
+    return {
+        .cycles = read_counter(0),
+        .instructions = read_counter(1),
+        .cache_misses = read_counter(2),
+        .branch_misses = read_counter(3),
+    };
+}
+
+PerformanceCounterValues take_delta(PerformanceCounterValues& baseline)
+{
+    auto current = read();
+    if (baseline.cycles == 0) {
+        // The baseline was never taken, e.g. because profiling started while the thread was running.
+        baseline = current;
+        return {};
+    }
+    PerformanceCounterValues delta {
+        .cycles = (current.cycles - baseline.cycles) & s_counter_mask,
+        .instructions = (current.instructions - baseline.instructions) & s_counter_mask,
+        .cache_misses = (current.cache_misses - baseline.cache_misses) & s_counter_mask,
+        .branch_misses = (current.branch_misses - baseline.branch_misses) & s_counter_mask,
+    };
+    baseline = current;
+    return delta;
+}
+
+}
@@ -23,6 +23,7 @@
 #include <Kernel/Tasks/Thread.h>
 
 #include <Kernel/Arch/Interrupts.h>
+#include <Kernel/Arch/PerformanceCounters.h>
 #include <Kernel/Arch/Processor.h>
 #include <Kernel/Arch/SafeMem.h>
 #include <Kernel/Arch/TrapFrame.h>
@@ -33,6 +34,7 @@
 
 #include <Kernel/Arch/PageDirectory.h>
 #include <Kernel/Memory/ScopedAddressSpaceSwitcher.h>
+#include <Kernel/Memory/TLBFlushBatch.h>
 
 namespace Kernel {
 
@@ -505,6 +507,15 @@ UNMAP_AFTER_INIT void Processor::cpu_setup()
         write_cr4(read_cr4() | 0x80);
     }
 
+    if (has_feature(CPUFeature::PCID) && has_feature(CPUFeature::PGE)) {
+        // Turn on CR4.PCIDE. This requires CR3[11:0] to be zero, which holds because we
+        // keep running with PCID 0 until the first switch to another page directory.
+        // NOTE: We rely on the quickmap windows being mapped global, otherwise every
+        //       quickmap would invalidate the TLB entries of all other PCIDs.
+        write_cr4(read_cr4() | 0x20000);
+        m_has_pcid = true;
+    }
+
     if (has_feature(CPUFeature::NX)) {
         // Turn on IA32_EFER.NXE
         MSR ia32_efer(MSR_IA32_EFER);
@@ -648,6 +659,8 @@ UNMAP_AFTER_INIT void ProcessorBase<T>::initialize(u32 cpu)
     else
         flush_idt();
 
+    PerformanceCounters::initialize(cpu);
+
     if (cpu == 0) {
         VERIFY((FlatPtr(&s_clean_fpu_state) & 0xF) == 0);
         asm volatile("fninit");
@@ -959,23 +972,109 @@ void ProcessorBase<T>::flush_tlb_local(VirtualAddress vaddr, size_t page_count)
         ptr += PAGE_SIZE;
         page_count--;
     }
+
+    // INVLPG only drops non-global translations of the current PCID, so the other PCIDs
+    // of this processor may still hold stale kernel translations. The quickmap windows
+    // are mapped global, which lets us skip this for the most common case.
+    if (Memory::is_user_address(vaddr) || !Processor::is_initialized())
+        return;
+    auto quickmap_window_base = VirtualAddress(KERNEL_PT1024_BASE);
+    if (vaddr >= quickmap_window_base && vaddr < quickmap_window_base.offset(2 * MiB))
+        return;
+    auto& processor = Processor::current();
+    if (processor.m_has_pcid)
+        processor.note_kernel_tlb_flush();
 }
 
 template<typename T>
 void ProcessorBase<T>::flush_entire_tlb_local()
 {
-    write_cr3(read_cr3());
+    auto cr4 = read_cr4();
+    if (cr4 & 0x80) {
+        // Toggling CR4.PGE flushes all translations, including global ones and those of all PCIDs.
+        write_cr4(cr4 & ~0x80ull);
+        write_cr4(cr4);
+    } else {
+        write_cr3(read_cr3());
+    }
 }
 
 template<typename T>
 void ProcessorBase<T>::flush_tlb(Memory::PageDirectory const* page_directory, VirtualAddress vaddr, size_t page_count)
 {
-    if (s_smp_enabled && (!Memory::is_user_address(vaddr) || Process::current().thread_count() > 1))
-        Processor::smp_broadcast_flush_tlb(page_directory, vaddr, page_count);
+    if (s_smp_enabled)
+        Processor::smp_flush_tlb(page_directory, vaddr, page_count);
     else
         flush_tlb_local(vaddr, page_count);
 }
 
+template<typename T>
+void ProcessorBase<T>::flush_tlb(Memory::TLBFlushBatch const& batch)
+{
+    if (s_smp_enabled) {
+        Processor::smp_flush_tlb(batch);
+        return;
+    }
+    for (auto const& range : batch.ranges())
+        flush_tlb_local(range.vaddr, range.page_count);
+}
+
+void Processor::note_kernel_tlb_flush()
+{
+    ++m_kernel_tlb_generation;
+    if (m_current_pcid_slot < m_pcid_slots.size())
+        m_pcid_slots[m_current_pcid_slot].kernel_tlb_generation = m_kernel_tlb_generation;
+}
+
+FlatPtr Processor::pcid_cr3_bits_for(Memory::PageDirectory const& page_directory)
+{
+    bool needs_flush = false;
+    size_t slot_index = 0;
+    for (; slot_index < m_pcid_slots.size(); ++slot_index) {
+        if (m_pcid_slots[slot_index].page_directory_id == page_directory.id())
+            break;
+    }
+    if (slot_index == m_pcid_slots.size()) {
+        slot_index = m_next_pcid_slot;
+        m_next_pcid_slot = (m_next_pcid_slot + 1) % m_pcid_slots.size();
+        m_pcid_slots[slot_index].page_directory_id = page_directory.id();
+        needs_flush = true;
+    }
+
+    // NOTE: Our bit in the active processor mask is already set at this point, so any flush
+    //       that happens after reading the generation will send us an IPI instead.
+    auto& slot = m_pcid_slots[slot_index];
+    auto tlb_generation = page_directory.tlb_generation();
+    if (slot.tlb_generation != tlb_generation || slot.kernel_tlb_generation != m_kernel_tlb_generation)
+        needs_flush = true;
+    slot.tlb_generation = tlb_generation;
+    slot.kernel_tlb_generation = m_kernel_tlb_generation;
+    m_current_pcid_slot = slot_index;
+
+    FlatPtr bits = slot_index + 1;
+    if (!needs_flush)
+        bits |= 1ull << 63; // Keep the TLB entries tagged with this PCID.
+    return bits;
+}
+
+void Processor::switch_page_directory(Memory::PageDirectory const& page_directory)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+
+    auto const* previous_page_directory = m_active_page_directory;
+    if (previous_page_directory != &page_directory)
+        page_directory.set_active_on_processor(id());
+
+    FlatPtr cr3 = page_directory.cr3();
+    if (m_has_pcid)
+        cr3 |= pcid_cr3_bits_for(page_directory);
+    write_cr3(cr3);
+
+    if (previous_page_directory && previous_page_directory != &page_directory)
+        previous_page_directory->clear_active_on_processor(id());
+    m_active_page_directory = &page_directory;
+}
+
 void Processor::smp_return_to_pool(ProcessorMessage& msg)
 {
     ProcessorMessage* next = nullptr;
@@ -1138,14 +1237,24 @@ bool Processor::smp_process_pending_messages()
                 if (Memory::is_user_address(VirtualAddress(msg->flush_tlb.ptr))) {
                     // We assume that we don't cross into kernel land!
                     VERIFY(Memory::is_user_range(VirtualAddress(msg->flush_tlb.ptr), msg->flush_tlb.page_count * PAGE_SIZE));
-                    if (read_cr3() != msg->flush_tlb.page_directory->cr3()) {
-                        // This processor isn't using this page directory right now, we can ignore this request
+                    if (m_active_page_directory != msg->flush_tlb.page_directory) {
+                        // This processor isn't using this page directory anymore, we can ignore this request
                         dbgln_if(SMP_DEBUG, "SMP[{}]: No need to flush {} pages at {}", current_id(), msg->flush_tlb.page_count, VirtualAddress(msg->flush_tlb.ptr));
                         break;
                     }
                 }
                 flush_tlb_local(VirtualAddress(msg->flush_tlb.ptr), msg->flush_tlb.page_count);
                 break;
+            case ProcessorMessage::FlushTlbBatch: {
+                auto const& batch = *msg->flush_tlb_batch;
+                if (m_active_page_directory != &batch.page_directory() && Memory::is_user_address(batch.ranges().first().vaddr)) {
+                    dbgln_if(SMP_DEBUG, "SMP[{}]: No need to flush {} ranges", current_id(), batch.ranges().size());
+                    break;
+                }
+                for (auto const& range : batch.ranges())
+                    flush_tlb_local(range.vaddr, range.page_count);
+                break;
+            }
             }
 
             bool is_async = msg->async; // Need to cache this value *before* dropping the ref count!
@@ -1233,6 +1342,22 @@ void Processor::smp_broadcast_wait_sync(ProcessorMessage& msg)
     smp_return_to_pool(msg);
 }
 
+void Processor::smp_multicast_message(u64 cpu_mask, ProcessorMessage& msg)
+{
+    dbgln_if(SMP_DEBUG, "SMP[{}]: Multicast message {} to cpus: {:#x}", current_id(), VirtualAddress(&msg), cpu_mask);
+
+    msg.refs.store(popcount(cpu_mask), AK::MemoryOrder::memory_order_release);
+    VERIFY(msg.refs > 0);
+    for_each(
+        [&](Processor& proc) {
+            if (!(cpu_mask & (1ull << proc.id())))
+                return;
+            // Only send an IPI if the target didn't have any messages queued already.
+            if (proc.smp_enqueue_message(msg))
+                APIC::the().send_ipi(proc.id());
+        });
+}
+
 void Processor::smp_unicast_message(u32 cpu, ProcessorMessage& msg, bool async)
 {
     auto& current_processor = Processor::current();
@@ -1272,21 +1397,67 @@ void Processor::smp_unicast(u32 cpu, Function<void()> callback, bool async)
     smp_unicast_message(cpu, msg, async);
 }
 
-void Processor::smp_broadcast_flush_tlb(Memory::PageDirectory const* page_directory, VirtualAddress vaddr, size_t page_count)
+u64 Processor::smp_tlb_flush_targets(Memory::PageDirectory const* page_directory, VirtualAddress vaddr)
+{
+    u64 other_processors = (count() >= 64 ? ~0ull : (1ull << count()) - 1) & ~(1ull << current_id());
+
+    // Kernel mappings are shared by all page directories and may be cached anywhere.
+    if (!page_directory || !Memory::is_user_address(vaddr))
+        return other_processors;
+
+    page_directory->bump_tlb_generation();
+    return page_directory->active_processor_mask() & other_processors;
+}
+
+void Processor::smp_flush_tlb(Memory::PageDirectory const* page_directory, VirtualAddress vaddr, size_t page_count)
 {
+    ScopedCritical critical;
+
+    auto targets = smp_tlb_flush_targets(page_directory, vaddr);
+    if (targets == 0) {
+        flush_tlb_local(vaddr, page_count);
+        return;
+    }
+
     auto& msg = smp_get_from_pool();
     msg.async = false;
     msg.type = ProcessorMessage::FlushTlb;
     msg.flush_tlb.page_directory = page_directory;
     msg.flush_tlb.ptr = vaddr.as_ptr();
     msg.flush_tlb.page_count = page_count;
-    smp_broadcast_message(msg);
+    smp_multicast_message(targets, msg);
     // While the other processors handle this request, we'll flush ours
     flush_tlb_local(vaddr, page_count);
     // Now wait until everybody is done as well
     smp_broadcast_wait_sync(msg);
 }
 
+void Processor::smp_flush_tlb(Memory::TLBFlushBatch const& batch)
+{
+    ScopedCritical critical;
+
+    auto flush_local = [&] {
+        for (auto const& range : batch.ranges())
+            flush_tlb_local(range.vaddr, range.page_count);
+    };
+
+    VERIFY(!batch.is_empty());
+    auto targets = smp_tlb_flush_targets(&batch.page_directory(), batch.ranges().first().vaddr);
+    if (targets == 0) {
+        flush_local();
+        return;
+    }
+
+    // All ranges are sent in one message, so every target processor is interrupted only once.
+    auto& msg = smp_get_from_pool();
+    msg.async = false;
+    msg.type = ProcessorMessage::FlushTlbBatch;
+    msg.flush_tlb_batch = &batch;
+    smp_multicast_message(targets, msg);
+    flush_local();
+    smp_broadcast_wait_sync(msg);
+}
+
 void Processor::smp_broadcast_halt()
 {
     // We don't want to use a message, because this could have been triggered
@@ -1392,7 +1563,7 @@ extern "C" void enter_thread_context(Thread* from_thread, Thread* to_thread)
     Processor::set_fs_base(to_thread->arch_specific_data().fs_base);
 
     if (from_regs.cr3 != to_regs.cr3)
-        write_cr3(to_regs.cr3);
+        processor.switch_page_directory(*to_regs.page_directory);
 
     to_thread->set_cpu(processor.id());
 
@@ -79,6 +79,25 @@ private:
 
     Atomic<ProcessorMessageEntry*> m_message_queue;
 
+    // The page directory currently loaded in CR3, as far as its active processor mask is concerned.
+    Memory::PageDirectory const* m_active_page_directory { nullptr };
+
+    // With PCIDs enabled, a small number of recently used page directories keep their TLB entries
+    // across context switches. Slot i is tagged with PCID i + 1; PCID 0 is only used during boot.
+    struct PCIDSlot {
+        u64 page_directory_id { 0 };
+        u64 tlb_generation { 0 };
+        u64 kernel_tlb_generation { 0 };
+    };
+    static constexpr size_t pcid_slot_count = 8;
+    Array<PCIDSlot, pcid_slot_count> m_pcid_slots;
+    size_t m_current_pcid_slot { pcid_slot_count };
+    size_t m_next_pcid_slot { 0 };
+    // Incremented whenever a non-global kernel mapping is flushed on this processor, which
+    // INVLPG only removes from the current PCID.
+    u64 m_kernel_tlb_generation { 1 };
+    bool m_has_pcid { false };
+
     void gdt_init();
     void write_raw_gdt_entry(u16 selector, u32 low, u32 high);
     void write_gdt_entry(u16 selector, Descriptor& descriptor);
@@ -91,11 +110,16 @@ private:
     static void smp_unicast_message(u32 cpu, ProcessorMessage& msg, bool async);
     static void smp_broadcast_message(ProcessorMessage& msg);
     static void smp_broadcast_wait_sync(ProcessorMessage& msg);
+    static void smp_multicast_message(u64 cpu_mask, ProcessorMessage& msg);
+    static u64 smp_tlb_flush_targets(Memory::PageDirectory const*, VirtualAddress);
     static void smp_broadcast_halt();
 
     void cpu_detect();
     void cpu_setup();
 
+    FlatPtr pcid_cr3_bits_for(Memory::PageDirectory const&);
+    void note_kernel_tlb_flush();
+
     void detect_hypervisor();
     void detect_hypervisor_hyperv(CPUID const& hypervisor_leaf_range);
 
@@ -153,7 +177,10 @@ public:
     bool smp_process_pending_messages();
 
     static void smp_unicast(u32 cpu, Function<void()>, bool async);
-    static void smp_broadcast_flush_tlb(Memory::PageDirectory const*, VirtualAddress, size_t);
+    static void smp_flush_tlb(Memory::PageDirectory const*, VirtualAddress, size_t);
+    static void smp_flush_tlb(Memory::TLBFlushBatch const&);
+
+    void switch_page_directory(Memory::PageDirectory const&);
 
     static void set_fs_base(FlatPtr);
 };
@@ -62,7 +62,7 @@ struct ThreadRegisters {
         else
             cs = GDT_SELECTOR_CODE3 | 3;
 
-        cr3 = space.page_directory().cr3();
+        set_page_directory(space.page_directory());
 
         if (is_kernel_process) {
             set_sp(kernel_stack_top);
@@ -85,8 +85,17 @@ struct ThreadRegisters {
         cs = GDT_SELECTOR_CODE3 | 3;
         rip = entry_ip;
         rsp = userspace_sp;
-        cr3 = space.page_directory().cr3();
+        set_page_directory(space.page_directory());
     }
+
+    void set_page_directory(Memory::PageDirectory const& directory)
+    {
+        cr3 = directory.cr3();
+        page_directory = &directory;
+    }
+
+    // The page directory belonging to cr3, so context switches can keep track of which processors have it loaded.
+    Memory::PageDirectory const* page_directory { nullptr };
 };
 
 }
@@ -124,6 +124,10 @@ UNMAP_AFTER_INIT bool APICTimer::calibrate(HardwareTimerBase& calibration_source
     if (state.supports_tsc) {
         auto delta_tsc = (state.end_tsc - state.start_tsc) * 10;
         dmesgln("APICTimer: CPU clock speed: {}.{} MHz", delta_tsc / 1000000, delta_tsc % 1000000);
+
+        auto& processor = Processor::current();
+        if (processor.has_feature(CPUFeature::CONSTANT_TSC) && processor.has_feature(CPUFeature::NONSTOP_TSC))
+            m_tsc_frequency = delta_tsc;
     }
 #endif
 
@@ -136,6 +140,14 @@ void APICTimer::enable_local_timer()
     APIC::the().setup_local_timer(m_timer_period, m_timer_mode, true);
 }
 
+void APICTimer::enable_local_timer_one_shot(Duration delay)
+{
+    // m_timer_period is the number of bus clock cycles per tick.
+    u64 bus_cycles = (u64)m_timer_period * m_frequency * max(delay.to_nanoseconds(), 0) / 1'000'000'000;
+    bus_cycles = clamp<u64>(bus_cycles, APIC::the().get_timer_divisor(), NumericLimits<u32>::max());
+    APIC::the().setup_local_timer((u32)bus_cycles, APIC::TimerMode::OneShot, true);
+}
+
 void APICTimer::disable_local_timer()
 {
     APIC::the().setup_local_timer(0, APIC::TimerMode::OneShot, false);
@@ -32,14 +32,19 @@ public:
 
     void will_be_destroyed() override { HardwareTimer<GenericInterruptHandler>::will_be_destroyed(); }
     void enable_local_timer();
+    void enable_local_timer_one_shot(Duration delay);
     void disable_local_timer();
 
+    // Only non-zero if the TSC is invariant and can be used for timekeeping.
+    u64 tsc_frequency() const { return m_tsc_frequency; }
+
 private:
     explicit APICTimer(u8, Function<void(RegisterState const&)>);
 
     bool calibrate(HardwareTimerBase&);
 
     u32 m_timer_period { 0 };
+    u64 m_tsc_frequency { 0 };
     APIC::TimerMode m_timer_mode { APIC::TimerMode::Periodic };
 };
 
@@ -121,7 +121,9 @@ PhysicalAddress Device::msix_table_entry_address(u8 irq)
 // mainly useful for MSI/MSIx based interrupt mechanism where the driver
 // needs to program. If the PCI device doesn't support MSIx interrupts, then
 // this function will just return the irq used for pin based interrupt.
-ErrorOr<u8> Device::allocate_irq(u8 index)
+// MSIx interrupts are delivered to `target_processor`, so drivers with a
+// queue per processor can have each queue's completions handled locally.
+ErrorOr<u8> Device::allocate_irq(u8 index, u32 target_processor)
 {
     if (Checked<u8>::addition_would_overflow(m_interrupt_range.m_start_irq, index))
         return Error::from_errno(EINVAL);
@@ -129,9 +131,7 @@ ErrorOr<u8> Device::allocate_irq(u8 index)
     if ((m_interrupt_range.m_type == InterruptType::MSIX) && is_msix_capable()) {
         auto entry_ptr = TRY(Memory::map_typed_writable<MSIxTableEntry volatile>(msix_table_entry_address(index + m_interrupt_range.m_start_irq)));
         entry_ptr->data = msi_data_register(m_interrupt_range.m_start_irq + index, false, false);
-        // TODO: we map all the IRQs to cpu 0 by default. We could attach
-        //  cpu affinity in the future where specific LAPIC id could be used.
-        u64 addr = msi_address_register(0, false, false);
+        u64 addr = msi_address_register(msi_destination_id_for_processor(target_processor), false, false);
         entry_ptr->address_low = addr & 0xffffffff;
         entry_ptr->address_high = addr >> 32;
 
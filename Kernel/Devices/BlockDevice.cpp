@@ -6,6 +6,7 @@
 
 #include <Kernel/Devices/BlockDevice.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/DeviceIdentifiers/BlockDevicesDirectory.h>
+#include <Kernel/Tasks/TraceBuffer.h>
 
 namespace Kernel {
 
@@ -22,6 +23,7 @@ AsyncBlockDeviceRequest::AsyncBlockDeviceRequest(Device& block_device, RequestTy
 
 void AsyncBlockDeviceRequest::start()
 {
+    TraceBuffer::record(TraceEventType::BlockRequestStart, bit_cast<FlatPtr>(this), m_block_index, m_block_count);
     m_block_device.start_request(*this);
 }
 
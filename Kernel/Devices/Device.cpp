@@ -72,15 +72,57 @@ ErrorOr<NonnullRefPtr<OpenFileDescription>> Device::open(int options)
 void Device::process_next_queued_request(Badge<AsyncDeviceRequest>, AsyncDeviceRequest const& completed_request)
 {
     SpinlockLocker lock(m_requests_lock);
-    VERIFY(!m_requests.is_empty());
-    VERIFY(m_requests.first().ptr() == &completed_request);
-    m_requests.remove(m_requests.begin());
-    if (!m_requests.is_empty()) {
-        auto* next_request = m_requests.first().ptr();
-        next_request->do_start(move(lock));
-    }
+    VERIFY(m_requests_in_flight > 0);
+
+    // NOTE: With more than one request in flight, they don't necessarily complete in the order we started them.
+    size_t index = 0;
+    auto it = m_requests.begin();
+    for (; it != m_requests.end() && (*it).ptr() != &completed_request; ++it)
+        ++index;
+    VERIFY(it != m_requests.end());
+    VERIFY(index < m_requests_in_flight);
+    m_requests.remove(it);
+    --m_requests_in_flight;
+
+    start_queued_requests(lock);
+    if (lock.have_lock())
+        lock.unlock();
 
     evaluate_block_conditions();
 }
 
+void Device::plug_requests()
+{
+    SpinlockLocker lock(m_requests_lock);
+    ++m_plug_count;
+}
+
+void Device::unplug_requests()
+{
+    SpinlockLocker lock(m_requests_lock);
+    VERIFY(m_plug_count > 0);
+    if (--m_plug_count == 0)
+        start_queued_requests(lock);
+}
+
+void Device::start_queued_requests(SpinlockLocker<Spinlock<LockRank::None>>& lock)
+{
+    VERIFY(lock.have_lock());
+    // Start the oldest requests that are still waiting, as many as the device can take.
+    while (m_plug_count == 0 && m_requests_in_flight < max_concurrent_requests()) {
+        size_t index = 0;
+        auto it = m_requests.begin();
+        for (; it != m_requests.end() && index < m_requests_in_flight; ++it)
+            ++index;
+        if (it == m_requests.end())
+            return;
+        ++m_requests_in_flight;
+        auto* next_request = (*it).ptr();
+        // NOTE: This drops the lock to start the request, unless that one has been completed already.
+        next_request->do_start(move(lock));
+        if (!lock.have_lock())
+            lock.lock();
+    }
+}
+
 }
@@ -51,15 +51,26 @@ public:
     virtual bool is_openable_by_jailed_processes() const { return false; }
     void process_next_queued_request(Badge<AsyncDeviceRequest>, AsyncDeviceRequest const&);
 
+    // Devices that can work on several requests at once (e.g. multi-queue storage controllers) may have more than one started at a time.
+    // Requests are always started in the order they were made.
+    virtual size_t max_concurrent_requests() const { return 1; }
+
+    // While the request queue is plugged, new requests are only queued up. Unplugging starts them, so a batch
+    // of requests reaches the driver together instead of trickling in one by one.
+    // NOTE: Don't wait for a request while holding a plug, it won't be started until the plug is released.
+    void plug_requests();
+    void unplug_requests();
+
     template<typename AsyncRequestType, typename... Args>
     ErrorOr<NonnullLockRefPtr<AsyncRequestType>> try_make_request(Args&&... args)
     {
         auto request = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) AsyncRequestType(*this, forward<Args>(args)...)));
         SpinlockLocker lock(m_requests_lock);
-        bool was_empty = m_requests.is_empty();
         TRY(m_requests.try_append(request));
-        if (was_empty)
+        if (m_plug_count == 0 && m_requests_in_flight < max_concurrent_requests()) {
+            ++m_requests_in_flight;
             request->do_start(move(lock));
+        }
         return request;
     }
 
@@ -84,7 +95,12 @@ private:
     State m_state { State::Normal };
 
     Spinlock<LockRank::None> m_requests_lock {};
+    // NOTE: The first m_requests_in_flight requests have been started, the rest are waiting for their turn.
     DoublyLinkedList<LockRefPtr<AsyncDeviceRequest>> m_requests;
+    size_t m_requests_in_flight { 0 };
+    size_t m_plug_count { 0 };
+
+    void start_queued_requests(SpinlockLocker<Spinlock<LockRank::None>>&);
 
 protected:
     // FIXME: This pointer will be eventually removed after all nodes in /sys/dev/block/ and
@@ -36,8 +36,8 @@ UNMAP_AFTER_INIT NVMeController::NVMeController(const PCI::DeviceIdentifier& dev
 
 UNMAP_AFTER_INIT ErrorOr<void> NVMeController::initialize(bool is_queue_polled)
 {
-    // Nr of queues = one queue per core
-    auto nr_of_queues = Processor::count();
+    // Nr of queues = one queue per core, unless the controller grants us fewer
+    auto nr_of_queues = min(Processor::count(), MAX_IO_QUEUES);
     auto queue_type = is_queue_polled ? QueueType::Polled : QueueType::IRQ;
 
     PCI::enable_memory_space(device_identifier());
@@ -62,15 +62,20 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::initialize(bool is_queue_polled)
     TRY(create_admin_queue(queue_type));
     VERIFY(m_admin_queue_ready == true);
 
-    VERIFY(IO_QUEUE_SIZE < MQES(caps));
-    dbgln_if(NVME_DEBUG, "NVMe: IO queue depth is: {}", IO_QUEUE_SIZE);
+    m_io_queue_depth = static_cast<u16>(min<u32>(IO_QUEUE_SIZE, MQES(caps)));
+    dbgln_if(NVME_DEBUG, "NVMe: IO queue depth is: {}", m_io_queue_depth);
 
     TRY(identify_and_init_controller());
-    // Create an IO queue per core
+    nr_of_queues = TRY(set_number_of_io_queues(nr_of_queues));
+    dbgln_if(NVME_DEBUG, "NVMe: Using {} IO queues", nr_of_queues);
+
+    // Create an IO queue per core, its completions are delivered to that same core
     for (u32 cpuid = 0; cpuid < nr_of_queues; ++cpuid) {
         // qid is zero is used for admin queue
-        TRY(create_io_queue(cpuid + 1, queue_type));
+        TRY(create_io_queue(cpuid + 1, queue_type, cpuid));
     }
+    if (queue_type == QueueType::IRQ)
+        enable_interrupt_coalescing();
     TRY(identify_and_init_namespaces());
     return {};
 }
@@ -152,6 +157,36 @@ UNMAP_AFTER_INIT void NVMeController::set_admin_q_depth()
     m_controller_regs->aqa = queue_depth | (queue_depth << AQA_ACQ_SHIFT);
 }
 
+UNMAP_AFTER_INIT ErrorOr<u16> NVMeController::set_number_of_io_queues(u16 count)
+{
+    NVMeSubmission sub {};
+    u32 result = 0;
+    sub.op = OP_ADMIN_SET_FEATURES;
+    sub.features.fid = FEATURE_NUMBER_OF_QUEUES;
+    sub.features.dword11 = NUMBER_OF_QUEUES(count, count);
+    if (auto status = submit_admin_command(sub, true, &result); status) {
+        // NOTE: The feature is mandatory, but some controllers fail it once it was set before. Carry on with a single queue then.
+        dmesgln_pci(*this, "Failed to set the number of IO queues, status {:#x}", status);
+        return 1;
+    }
+
+    // The controller returns the number of queues it allocated for us (0 based), which may differ from what we asked for.
+    u16 submission_queues = (result & 0xffff) + 1;
+    u16 completion_queues = (result >> 16) + 1;
+    return min(count, min(submission_queues, completion_queues));
+}
+
+UNMAP_AFTER_INIT void NVMeController::enable_interrupt_coalescing()
+{
+    // Let the controller batch a couple of completions into a single interrupt when we are submitting a lot of IO.
+    NVMeSubmission sub {};
+    sub.op = OP_ADMIN_SET_FEATURES;
+    sub.features.fid = FEATURE_INTERRUPT_COALESCING;
+    sub.features.dword11 = INTERRUPT_COALESCING(INTERRUPT_COALESCING_THRESHOLD, INTERRUPT_COALESCING_TIME);
+    if (auto status = submit_admin_command(sub, true); status)
+        dbgln_if(NVME_DEBUG, "NVMe: Interrupt coalescing is not supported, status {:#x}", status);
+}
+
 UNMAP_AFTER_INIT ErrorOr<void> NVMeController::identify_and_init_namespaces()
 {
 
@@ -181,6 +216,16 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::identify_and_init_namespaces()
             return EFAULT;
         }
     }
+    size_t namespace_count = 0;
+    for (auto nsid : active_namespace_list) {
+        if (nsid == 0)
+            break;
+        ++namespace_count;
+    }
+    // The namespaces share the IO queues, so split the queue entries between them. One entry is always left unused
+    // as a queue with the tail right behind its head is full.
+    size_t max_requests_per_namespace = namespace_count ? max<size_t>(1, (m_io_queue_depth - 1) / namespace_count) : 1;
+
     // Get the NAMESPACE attributes
     {
         NVMeSubmission sub {};
@@ -209,7 +254,7 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::identify_and_init_namespaces()
 
             dbgln_if(NVME_DEBUG, "NVMe: Block count is {} and Block size is {}", block_counts, block_size);
 
-            m_namespaces.append(TRY(NVMeNameSpace::try_create(*this, m_queues, nsid, block_counts, block_size)));
+            m_namespaces.append(TRY(NVMeNameSpace::try_create(*this, m_queues, nsid, block_counts, block_size, max_requests_per_namespace)));
             m_device_count++;
             dbgln_if(NVME_DEBUG, "NVMe: Initialized namespace with NSID: {}", nsid);
         }
@@ -361,14 +406,14 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::create_admin_queue(QueueType queu
     return {};
 }
 
-UNMAP_AFTER_INIT ErrorOr<void> NVMeController::create_io_queue(u8 qid, QueueType queue_type)
+UNMAP_AFTER_INIT ErrorOr<void> NVMeController::create_io_queue(u8 qid, QueueType queue_type, u32 target_processor)
 {
     OwnPtr<Memory::Region> cq_dma_region;
     Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> cq_dma_pages;
     OwnPtr<Memory::Region> sq_dma_region;
     Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> sq_dma_pages;
-    auto cq_size = round_up_to_power_of_two(CQ_SIZE(IO_QUEUE_SIZE), 4096);
-    auto sq_size = round_up_to_power_of_two(SQ_SIZE(IO_QUEUE_SIZE), 4096);
+    auto cq_size = round_up_to_power_of_two(CQ_SIZE(m_io_queue_depth), 4096);
+    auto sq_size = round_up_to_power_of_two(SQ_SIZE(m_io_queue_depth), 4096);
 
     {
         auto buffer = TRY(MM.allocate_dma_buffer_pages(cq_size, "IO CQ queue"sv, Memory::Region::Access::ReadWrite, cq_dma_pages));
@@ -390,7 +435,7 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::create_io_queue(u8 qid, QueueType
         sub.create_cq.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(cq_dma_pages.first()->paddr().as_ptr()));
         sub.create_cq.cqid = qid;
         // The queue size is 0 based
-        sub.create_cq.qsize = AK::convert_between_host_and_little_endian(IO_QUEUE_SIZE - 1);
+        sub.create_cq.qsize = AK::convert_between_host_and_little_endian(m_io_queue_depth - 1);
         auto flags = (queue_type == QueueType::IRQ) ? QUEUE_IRQ_ENABLED : QUEUE_IRQ_DISABLED;
         flags |= QUEUE_PHY_CONTIGUOUS;
         // When using MSIx interrupts, qid is used as an index into the interrupt table
@@ -407,7 +452,7 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::create_io_queue(u8 qid, QueueType
         sub.create_sq.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(sq_dma_pages.first()->paddr().as_ptr()));
         sub.create_sq.sqid = qid;
         // The queue size is 0 based
-        sub.create_sq.qsize = AK::convert_between_host_and_little_endian(IO_QUEUE_SIZE - 1);
+        sub.create_sq.qsize = AK::convert_between_host_and_little_endian(m_io_queue_depth - 1);
         auto flags = QUEUE_PHY_CONTIGUOUS;
         sub.create_sq.cqid = qid;
         sub.create_sq.sq_flags = AK::convert_between_host_and_little_endian(flags);
@@ -430,9 +475,9 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::create_io_queue(u8 qid, QueueType
         .dbbuf_eventidx = move(eventidx_doorbell_regs),
     };
 
-    auto irq = TRY(allocate_irq(qid));
+    auto irq = TRY(allocate_irq(qid, target_processor));
 
-    m_queues.append(TRY(NVMeQueue::try_create(*this, qid, irq, IO_QUEUE_SIZE, move(cq_dma_region), move(sq_dma_region), move(doorbell), queue_type)));
+    m_queues.append(TRY(NVMeQueue::try_create(*this, qid, irq, m_io_queue_depth, move(cq_dma_region), move(sq_dma_region), move(doorbell), queue_type)));
     dbgln_if(NVME_DEBUG, "NVMe: Created IO Queue with QID{}", m_queues.size());
     return {};
 }
@@ -38,11 +38,11 @@ public:
     ErrorOr<void> reset_controller();
     ErrorOr<void> start_controller();
 
-    u16 submit_admin_command(NVMeSubmission& sub, bool sync = false)
+    u16 submit_admin_command(NVMeSubmission& sub, bool sync = false, u32* result = nullptr)
     {
         // First queue is always the admin queue
         if (sync) {
-            return m_admin_queue->submit_sync_sqe(sub);
+            return m_admin_queue->submit_sync_sqe(sub, result);
         }
         m_admin_queue->submit_sqe(sub);
         return 0;
@@ -64,7 +64,9 @@ private:
     ErrorOr<void> identify_and_init_controller();
     NSFeatures get_ns_features(IdentifyNamespace& identify_data_struct);
     ErrorOr<void> create_admin_queue(QueueType queue_type);
-    ErrorOr<void> create_io_queue(u8 qid, QueueType queue_type);
+    ErrorOr<void> create_io_queue(u8 qid, QueueType queue_type, u32 target_processor);
+    ErrorOr<u16> set_number_of_io_queues(u16 count);
+    void enable_interrupt_coalescing();
     void calculate_doorbell_stride()
     {
         m_dbl_stride = (m_controller_regs->cap >> CAP_DBL_SHIFT) & CAP_DBL_MASK;
@@ -83,6 +85,7 @@ private:
     AK::Duration m_ready_timeout;
     PhysicalAddress m_bar { 0 };
     u8 m_dbl_stride { 0 };
+    u16 m_io_queue_depth { IO_QUEUE_SIZE };
     Optional<PCI::InterruptType> m_irq_type;
     QueueType m_queue_type { QueueType::IRQ };
     static Atomic<u8> s_controller_id;
@@ -80,11 +80,11 @@ static constexpr u32 CSTS_SHST(u32 x)
 static constexpr u16 AQA_ACQ_SHIFT = 16;
 static constexpr u8 CQ_WIDTH = 4; // CQ is 16 bytes(2^4) in size.
 static constexpr u8 SQ_WIDTH = 6; // SQ size is 64 bytes(2^6) in size.
-static constexpr u16 CQ_SIZE(u16 q_depth)
+static constexpr u32 CQ_SIZE(u16 q_depth)
 {
     return q_depth << CQ_WIDTH;
 }
-static constexpr u16 SQ_SIZE(u16 q_depth)
+static constexpr u32 SQ_SIZE(u16 q_depth)
 {
     return q_depth << SQ_WIDTH;
 }
@@ -99,7 +99,26 @@ static constexpr u16 CQ_STATUS_FIELD(u16 x)
 }
 
 static constexpr u16 ADMIN_QUEUE_SIZE = 2;
-static constexpr u16 IO_QUEUE_SIZE = 64; // TODO:Need to be configurable
+// Every IO queue entry gets its own page for data transfers, so this is also how much DMA memory each IO queue uses in pages.
+static constexpr u16 IO_QUEUE_SIZE = 256;
+// Every IO queue needs its own interrupt vector next to the admin queue one, and we can't reserve more than 255 of them.
+static constexpr u32 MAX_IO_QUEUES = 64;
+
+// SET FEATURES
+static constexpr u8 FEATURE_NUMBER_OF_QUEUES = 0x7;
+static constexpr u8 FEATURE_INTERRUPT_COALESCING = 0x8;
+static constexpr u32 NUMBER_OF_QUEUES(u16 submission_queues, u16 completion_queues)
+{
+    // Both counts are 0 based
+    return static_cast<u32>(completion_queues - 1) << 16 | static_cast<u16>(submission_queues - 1);
+}
+// Aggregation threshold is 0 based and counts completion entries, aggregation time is in 100us units.
+static constexpr u8 INTERRUPT_COALESCING_THRESHOLD = 8;
+static constexpr u8 INTERRUPT_COALESCING_TIME = 1;
+static constexpr u32 INTERRUPT_COALESCING(u8 threshold, u8 time)
+{
+    return static_cast<u32>(time) << 8 | static_cast<u8>(threshold - 1);
+}
 
 // IDENTIFY
 static constexpr u16 NVMe_IDENTIFY_SIZE = 4096;
@@ -117,6 +136,7 @@ enum AdminCommandOpCode {
     OP_ADMIN_CREATE_COMPLETION_QUEUE = 0x5,
     OP_ADMIN_CREATE_SUBMISSION_QUEUE = 0x1,
     OP_ADMIN_IDENTIFY = 0x6,
+    OP_ADMIN_SET_FEATURES = 0x9,
     OP_ADMIN_DBBUF_CONFIG = 0x7C,
 };
 
@@ -214,6 +234,15 @@ struct [[gnu::packed]] NVMeDBBUFCmd {
     u32 rsvd12[6];
 };
 
+struct [[gnu::packed]] NVMeSetFeaturesCmd {
+    LittleEndian<u32> nsid;
+    LittleEndian<u64> rsvd1[2];
+    struct DataPtr data_ptr;
+    LittleEndian<u32> fid;
+    LittleEndian<u32> dword11;
+    u32 rsvd12[4];
+};
+
 struct [[gnu::packed]] NVMeSubmission {
     u8 op;
     u8 flags;
@@ -225,5 +254,6 @@ struct [[gnu::packed]] NVMeSubmission {
         NVMeCreateCQCmd create_cq;
         NVMeCreateSQCmd create_sq;
         NVMeDBBUFCmd dbbuf_cmd;
+        NVMeSetFeaturesCmd features;
     };
 };
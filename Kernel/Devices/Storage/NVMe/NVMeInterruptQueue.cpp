@@ -11,15 +11,15 @@
 
 namespace Kernel {
 
-ErrorOr<NonnullLockRefPtr<NVMeInterruptQueue>> NVMeInterruptQueue::try_create(PCI::Device& device, NonnullOwnPtr<Memory::Region> rw_dma_region, NonnullRefPtr<Memory::PhysicalRAMPage> rw_dma_page, u16 qid, u8 irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
+ErrorOr<NonnullLockRefPtr<NVMeInterruptQueue>> NVMeInterruptQueue::try_create(PCI::Device& device, NonnullOwnPtr<Memory::Region> rw_dma_region, Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> rw_dma_pages, u16 qid, u8 irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
 {
-    auto queue = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) NVMeInterruptQueue(device, move(rw_dma_region), rw_dma_page, qid, irq, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs))));
+    auto queue = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) NVMeInterruptQueue(device, move(rw_dma_region), move(rw_dma_pages), qid, irq, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs))));
     queue->initialize_interrupt_queue();
     return queue;
 }
 
-UNMAP_AFTER_INIT NVMeInterruptQueue::NVMeInterruptQueue(PCI::Device& device, NonnullOwnPtr<Memory::Region> rw_dma_region, NonnullRefPtr<Memory::PhysicalRAMPage> rw_dma_page, u16 qid, u8 irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
-    : NVMeQueue(move(rw_dma_region), rw_dma_page, qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs))
+UNMAP_AFTER_INIT NVMeInterruptQueue::NVMeInterruptQueue(PCI::Device& device, NonnullOwnPtr<Memory::Region> rw_dma_region, Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> rw_dma_pages, u16 qid, u8 irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
+    : NVMeQueue(move(rw_dma_region), move(rw_dma_pages), qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs))
     , PCI::IRQHandler(device, irq)
 {
 }
@@ -39,20 +39,21 @@ void NVMeInterruptQueue::submit_sqe(NVMeSubmission& sub)
     NVMeQueue::submit_sqe(sub);
 }
 
-void NVMeInterruptQueue::complete_current_request(u16 cmdid, u16 status)
+void NVMeInterruptQueue::complete_current_request(u16 cmdid, u16 status, u32 result)
 {
-    auto work_item_creation_result = g_io_work->try_queue([this, cmdid, status]() {
-        NVMeQueue::complete_current_request(cmdid, status);
+    auto work_item_creation_result = g_io_work->try_queue([this, cmdid, status, result]() {
+        NVMeQueue::complete_current_request(cmdid, status, result);
     });
 
     if (work_item_creation_result.is_error()) {
-        m_requests.with([cmdid, status](auto& requests) {
-            auto& request_pdu = requests.get(cmdid).release_value();
+        m_requests.with([cmdid, status, result](auto& requests) {
+            auto request_pdu = requests.take(cmdid).release_value();
             auto current_request = request_pdu.request;
 
-            current_request->complete(AsyncDeviceRequest::OutOfMemory);
+            if (current_request)
+                current_request->complete(AsyncDeviceRequest::OutOfMemory);
             if (request_pdu.end_io_handler)
-                request_pdu.end_io_handler(status);
+                request_pdu.end_io_handler(status, result);
             request_pdu.clear();
         });
     }
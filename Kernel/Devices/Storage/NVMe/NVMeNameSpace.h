@@ -23,15 +23,18 @@ class NVMeNameSpace : public StorageDevice {
     friend class DeviceManagement;
 
 public:
-    static ErrorOr<NonnullLockRefPtr<NVMeNameSpace>> try_create(NVMeController const&, Vector<NonnullLockRefPtr<NVMeQueue>> queues, u16 nsid, size_t storage_size, size_t lba_size);
+    static ErrorOr<NonnullLockRefPtr<NVMeNameSpace>> try_create(NVMeController const&, Vector<NonnullLockRefPtr<NVMeQueue>> queues, u16 nsid, size_t storage_size, size_t lba_size, size_t max_concurrent_requests);
 
     CommandSet command_set() const override { return CommandSet::NVMe; }
     void start_request(AsyncBlockDeviceRequest& request) override;
+    virtual size_t max_concurrent_requests() const override { return m_max_concurrent_requests; }
 
 private:
-    NVMeNameSpace(LUNAddress, u32 hardware_relative_controller_id, Vector<NonnullLockRefPtr<NVMeQueue>> queues, size_t storage_size, size_t lba_size, u16 nsid);
+    NVMeNameSpace(LUNAddress, u32 hardware_relative_controller_id, Vector<NonnullLockRefPtr<NVMeQueue>> queues, size_t storage_size, size_t lba_size, u16 nsid, size_t max_concurrent_requests);
 
     u16 m_nsid;
+    // NOTE: Requests are started on the queue of the current processor, so this has to fit into a single queue.
+    size_t m_max_concurrent_requests;
     Vector<NonnullLockRefPtr<NVMeQueue>> m_queues;
 };
 
@@ -14,23 +14,24 @@
 namespace Kernel {
 ErrorOr<NonnullLockRefPtr<NVMeQueue>> NVMeQueue::try_create(NVMeController& device, u16 qid, Optional<u8> irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs, QueueType queue_type)
 {
-    // Note: Allocate DMA region for RW operation. For now the requests don't exceed more than 4096 bytes (Storage device takes care of it)
-    RefPtr<Memory::PhysicalRAMPage> rw_dma_page;
-    auto rw_dma_region = TRY(MM.allocate_dma_buffer_page("NVMe Queue Read/Write DMA"sv, Memory::Region::Access::ReadWrite, rw_dma_page));
+    // Note: Allocate DMA region for RW operation, one page per queue entry so every command in flight has its own buffer.
+    // For now the requests don't exceed more than 4096 bytes (Storage device takes care of it)
+    Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> rw_dma_pages;
+    auto rw_dma_region = TRY(MM.allocate_dma_buffer_pages(q_depth * PAGE_SIZE, "NVMe Queue Read/Write DMA"sv, Memory::Region::Access::ReadWrite, rw_dma_pages));
 
-    if (rw_dma_page.is_null())
+    if (rw_dma_pages.size() < q_depth)
         return ENOMEM;
 
     if (queue_type == QueueType::Polled) {
-        auto queue = NVMePollQueue::try_create(move(rw_dma_region), rw_dma_page.release_nonnull(), qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
+        auto queue = NVMePollQueue::try_create(move(rw_dma_region), move(rw_dma_pages), qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
         return queue;
     }
 
-    auto queue = NVMeInterruptQueue::try_create(device, move(rw_dma_region), rw_dma_page.release_nonnull(), qid, irq.release_value(), q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
+    auto queue = NVMeInterruptQueue::try_create(device, move(rw_dma_region), move(rw_dma_pages), qid, irq.release_value(), q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
     return queue;
 }
 
-UNMAP_AFTER_INIT NVMeQueue::NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, Memory::PhysicalRAMPage const& rw_dma_page, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
+UNMAP_AFTER_INIT NVMeQueue::NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> rw_dma_pages, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
     : m_rw_dma_region(move(rw_dma_region))
     , m_qid(qid)
     , m_admin_queue(qid == 0)
@@ -38,7 +39,7 @@ UNMAP_AFTER_INIT NVMeQueue::NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_regio
     , m_cq_dma_region(move(cq_dma_region))
     , m_sq_dma_region(move(sq_dma_region))
     , m_db_regs(move(db_regs))
-    , m_rw_dma_page(rw_dma_page)
+    , m_rw_dma_pages(move(rw_dma_pages))
 
 {
     m_requests.with([q_depth](auto& requests) {
@@ -72,16 +73,18 @@ u32 NVMeQueue::process_cq()
         while (cqe_available()) {
             u16 status;
             u16 cmdid;
+            u32 result;
             ++nr_of_processed_cqes;
             status = CQ_STATUS_FIELD(m_cqe_array[m_cq_head].status);
             cmdid = m_cqe_array[m_cq_head].command_id;
+            result = m_cqe_array[m_cq_head].cmd_spec;
             dbgln_if(NVME_DEBUG, "NVMe: Completion with status {:x} and command identifier {}. CQ_HEAD: {}", status, cmdid, m_cq_head);
 
             if (!requests.contains(cmdid)) {
                 dmesgln("Bogus cmd id: {}", cmdid);
                 VERIFY_NOT_REACHED();
             }
-            complete_current_request(cmdid, status);
+            complete_current_request(cmdid, status, result);
             update_cqe_head();
         }
     });
@@ -108,18 +111,35 @@ void NVMeQueue::submit_sqe(NVMeSubmission& sub)
     update_sq_doorbell();
 }
 
-void NVMeQueue::complete_current_request(u16 cmdid, u16 status)
+u16 NVMeQueue::add_request(NVMeIO io)
 {
-    m_requests.with([this, cmdid, status](auto& requests) {
-        auto& request_pdu = requests.get(cmdid).release_value();
+    return m_requests.with([this, &io](auto& requests) {
+        // NOTE: The caller never has more than queue depth - 1 commands in flight, so there always is a free cid.
+        VERIFY(requests.size() < m_qdepth);
+        u16 cid = m_tag;
+        do {
+            cid = (cid + 1 == m_qdepth) ? 0 : cid + 1;
+        } while (requests.contains(cid));
+        m_tag = cid;
+        // NOTE: The capacity for queue depth entries was ensured up front, so this cannot fail.
+        requests.set(cid, move(io));
+        return cid;
+    });
+}
+
+void NVMeQueue::complete_current_request(u16 cmdid, u16 status, u32 result)
+{
+    m_requests.with([this, cmdid, status, result](auto& requests) {
+        // NOTE: Take the IO out first, completing the request may submit the next one on this queue, which can reuse the cid.
+        auto request_pdu = requests.take(cmdid).release_value();
         auto current_request = request_pdu.request;
         AsyncDeviceRequest::RequestResult req_result = AsyncDeviceRequest::Success;
 
-        ScopeGuard guard = [&req_result, status, &request_pdu] {
+        ScopeGuard guard = [&req_result, status, result, &request_pdu] {
             if (request_pdu.request)
                 request_pdu.request->complete(req_result);
             if (request_pdu.end_io_handler)
-                request_pdu.end_io_handler(status);
+                request_pdu.end_io_handler(status, result);
             request_pdu.clear();
         };
 
@@ -134,7 +154,7 @@ void NVMeQueue::complete_current_request(u16 cmdid, u16 status)
         }
 
         if (current_request->request_type() == AsyncBlockDeviceRequest::RequestType::Read) {
-            if (auto result = current_request->write_to_buffer(current_request->buffer(), m_rw_dma_region->vaddr().as_ptr(), current_request->buffer_size()); result.is_error()) {
+            if (auto copy_result = current_request->write_to_buffer(current_request->buffer(), rw_dma_buffer(cmdid), current_request->buffer_size()); copy_result.is_error()) {
                 req_result = AsyncBlockDeviceRequest::MemoryFault;
                 return;
             }
@@ -142,16 +162,15 @@ void NVMeQueue::complete_current_request(u16 cmdid, u16 status)
     });
 }
 
-u16 NVMeQueue::submit_sync_sqe(NVMeSubmission& sub)
+u16 NVMeQueue::submit_sync_sqe(NVMeSubmission& sub, u32* result)
 {
-    // For now let's use sq tail as a unique command id.
     u16 cmd_status;
-    u16 cid = get_request_cid();
-    sub.cmdid = cid;
-
-    m_requests.with([this, &sub, &cmd_status](auto& requests) {
-        requests.set(sub.cmdid, { nullptr, [this, &cmd_status](u16 status) mutable { cmd_status = status; m_sync_wait_queue.wake_all(); } });
-    });
+    sub.cmdid = add_request({ nullptr, [this, &cmd_status, result](u16 status, u32 command_result) mutable {
+        cmd_status = status;
+        if (result)
+            *result = command_result;
+        m_sync_wait_queue.wake_all();
+    } });
     submit_sqe(sub);
 
     // FIXME: Only sync submissions (usually used for admin commands) use a WaitQueue based IO. Eventually we need to
@@ -168,12 +187,8 @@ void NVMeQueue::read(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32
     sub.rw.slba = AK::convert_between_host_and_little_endian(index);
     // No. of lbas is 0 based
     sub.rw.length = AK::convert_between_host_and_little_endian((count - 1) & 0xFFFF);
-    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_rw_dma_page->paddr().as_ptr()));
-    sub.cmdid = get_request_cid();
-
-    m_requests.with([&sub, &request](auto& requests) {
-        requests.set(sub.cmdid, { request, nullptr });
-    });
+    sub.cmdid = add_request({ request, nullptr });
+    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(rw_dma_page_address(sub.cmdid).as_ptr()));
 
     full_memory_barrier();
     submit_sqe(sub);
@@ -188,15 +203,11 @@ void NVMeQueue::write(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32
     sub.rw.slba = AK::convert_between_host_and_little_endian(index);
     // No. of lbas is 0 based
     sub.rw.length = AK::convert_between_host_and_little_endian((count - 1) & 0xFFFF);
-    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_rw_dma_page->paddr().as_ptr()));
-    sub.cmdid = get_request_cid();
-
-    m_requests.with([&sub, &request](auto& requests) {
-        requests.set(sub.cmdid, { request, nullptr });
-    });
+    sub.cmdid = add_request({ request, nullptr });
+    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(rw_dma_page_address(sub.cmdid).as_ptr()));
 
-    if (auto result = request.read_from_buffer(request.buffer(), m_rw_dma_region->vaddr().as_ptr(), request.buffer_size()); result.is_error()) {
-        complete_current_request(sub.cmdid, AsyncDeviceRequest::MemoryFault);
+    if (auto result = request.read_from_buffer(request.buffer(), rw_dma_buffer(sub.cmdid), request.buffer_size()); result.is_error()) {
+        complete_current_request(sub.cmdid, AsyncDeviceRequest::MemoryFault, 0);
         return;
     }
 
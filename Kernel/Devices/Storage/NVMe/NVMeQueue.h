@@ -46,7 +46,8 @@ struct NVMeIO {
         end_io_handler = nullptr;
     }
     RefPtr<AsyncBlockDeviceRequest> request;
-    Function<void(u16 status)> end_io_handler;
+    // The result is the command specific dword 0 of the completion entry
+    Function<void(u16 status, u32 result)> end_io_handler;
 };
 
 class NVMeController;
@@ -54,7 +55,8 @@ class NVMeQueue : public AtomicRefCounted<NVMeQueue> {
 public:
     static ErrorOr<NonnullLockRefPtr<NVMeQueue>> try_create(NVMeController& device, u16 qid, Optional<u8> irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs, QueueType queue_type);
     bool is_admin_queue() { return m_admin_queue; }
-    u16 submit_sync_sqe(NVMeSubmission&);
+    u16 submit_sync_sqe(NVMeSubmission&, u32* result = nullptr);
+    u32 queue_depth() const { return m_qdepth; }
     void read(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count);
     void write(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count);
     virtual void submit_sqe(NVMeSubmission&);
@@ -83,22 +85,16 @@ protected:
             m_db_regs.mmio_reg->sq_tail = m_sq_tail;
     }
 
-    NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, Memory::PhysicalRAMPage const& rw_dma_page, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs);
+    NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> rw_dma_pages, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs);
 
-    [[nodiscard]] u32 get_request_cid()
-    {
-        u32 expected_tag = m_tag.load(AK::memory_order_acquire);
-
-        for (;;) {
-            u32 cid = expected_tag + 1;
-            if (cid == m_qdepth)
-                cid = 0;
-            if (m_tag.compare_exchange_strong(expected_tag, cid, AK::memory_order_acquire))
-                return cid;
-        }
-    }
+    // Picks a command identifier that is not used by any command still in flight and registers the IO under it.
+    [[nodiscard]] u16 add_request(NVMeIO);
+
+    // Every command identifier has its own page in the RW DMA region, so several commands can be in flight at once.
+    u8* rw_dma_buffer(u16 cmdid) { return m_rw_dma_region->vaddr().offset(cmdid * PAGE_SIZE).as_ptr(); }
+    PhysicalAddress rw_dma_page_address(u16 cmdid) const { return m_rw_dma_pages[cmdid]->paddr(); }
 
-    virtual void complete_current_request(u16 cmdid, u16 status);
+    virtual void complete_current_request(u16 cmdid, u16 status, u32 result);
 
 private:
     bool cqe_available();
@@ -122,7 +118,7 @@ private:
     u16 m_cq_head {};
     bool m_admin_queue { false };
     u32 m_qdepth {};
-    Atomic<u32> m_tag { 0 }; // used for the cid in a submission queue entry
+    u16 m_tag { 0 }; // the last cid handed out, protected by m_requests
     Spinlock<LockRank::Interrupts> m_sq_lock {};
     OwnPtr<Memory::Region> m_cq_dma_region;
     Span<NVMeSubmission> m_sqe_array;
@@ -130,6 +126,6 @@ private:
     Span<NVMeCompletion> m_cqe_array;
     WaitQueue m_sync_wait_queue;
     Doorbell m_db_regs;
-    NonnullRefPtr<Memory::PhysicalRAMPage const> const m_rw_dma_page;
+    Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> const m_rw_dma_pages;
 };
 }
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/IntegralMath.h>
 #include <AK/StringView.h>
 #include <Kernel/API/Ioctl.h>
 #include <Kernel/Debug.h>
@@ -74,6 +75,53 @@ StringView StorageDevice::command_set_to_string_view() const
     VERIFY_NOT_REACHED();
 }
 
+ErrorOr<void> StorageDevice::transfer_whole_blocks(AsyncBlockDeviceRequest::RequestType request_type, u64 index, size_t count, UserOrKernelBuffer const& buffer)
+{
+    auto blocks_per_request = max_blocks_per_request();
+    VERIFY(blocks_per_request > 0);
+
+    Vector<NonnullLockRefPtr<AsyncBlockDeviceRequest>, 32> requests;
+    TRY(requests.try_ensure_capacity(ceil_div(count, blocks_per_request)));
+
+    // Queue up all of the requests before letting the driver see any of them, so drivers
+    // that can work on several requests at once get the whole transfer right away.
+    ErrorOr<void> submit_result {};
+    plug_requests();
+    for (size_t block = 0; block < count; block += blocks_per_request) {
+        auto blocks_in_request = min(blocks_per_request, count - block);
+        auto request_or_error = try_make_request<AsyncBlockDeviceRequest>(request_type, index + block, blocks_in_request, buffer.offset(block * block_size()), blocks_in_request * block_size());
+        if (request_or_error.is_error()) {
+            submit_result = request_or_error.release_error();
+            break;
+        }
+        requests.unchecked_append(request_or_error.release_value());
+    }
+    unplug_requests();
+
+    dbgln_if(STORAGE_DEVICE_DEBUG, "StorageDevice::transfer_whole_blocks() index={}, count={}, requests={}", index, count, requests.size());
+
+    // NOTE: Even if we couldn't submit everything, wait for what we did submit, as it still uses the buffer.
+    for (auto& request : requests) {
+        auto result = request->wait();
+        if (result.wait_result().was_interrupted())
+            return EINTR;
+        if (submit_result.is_error())
+            continue;
+        switch (result.request_result()) {
+        case AsyncDeviceRequest::Failure:
+        case AsyncDeviceRequest::Cancelled:
+            submit_result = Error::from_errno(EIO);
+            break;
+        case AsyncDeviceRequest::MemoryFault:
+            submit_result = Error::from_errno(EFAULT);
+            break;
+        default:
+            break;
+        }
+    }
+    return submit_result;
+}
+
 ErrorOr<size_t> StorageDevice::read(OpenFileDescription&, u64 offset, UserOrKernelBuffer& outbuf, size_t len)
 {
     // NOTE: The last available offset is actually just after the last addressable block.
@@ -85,33 +133,13 @@ ErrorOr<size_t> StorageDevice::read(OpenFileDescription&, u64 offset, UserOrKern
     size_t whole_blocks = nread >> block_size_log();
     size_t remaining = nread - (whole_blocks << block_size_log());
 
-    // PATAChannel will chuck a wobbly if we try to read more than PAGE_SIZE
-    // at a time, because it uses a single page for its DMA buffer.
-    if (whole_blocks >= m_blocks_per_page) {
-        whole_blocks = m_blocks_per_page;
-        remaining = 0;
-    }
-
     if (nread < block_size())
         offset_within_block = offset - (index << block_size_log());
 
     dbgln_if(STORAGE_DEVICE_DEBUG, "StorageDevice::read() index={}, whole_blocks={}, remaining={}", index, whole_blocks, remaining);
 
-    if (whole_blocks > 0) {
-        auto read_request = TRY(try_make_request<AsyncBlockDeviceRequest>(AsyncBlockDeviceRequest::Read, index, whole_blocks, outbuf, whole_blocks * block_size()));
-        auto result = read_request->wait();
-        if (result.wait_result().was_interrupted())
-            return EINTR;
-        switch (result.request_result()) {
-        case AsyncDeviceRequest::Failure:
-        case AsyncDeviceRequest::Cancelled:
-            return EIO;
-        case AsyncDeviceRequest::MemoryFault:
-            return EFAULT;
-        default:
-            break;
-        }
-    }
+    if (whole_blocks > 0)
+        TRY(transfer_whole_blocks(AsyncBlockDeviceRequest::Read, index, whole_blocks, outbuf));
 
     off_t pos = whole_blocks * block_size();
 
@@ -150,13 +178,6 @@ ErrorOr<size_t> StorageDevice::write(OpenFileDescription&, u64 offset, UserOrKer
     size_t whole_blocks = nwrite >> block_size_log();
     size_t remaining = nwrite - (whole_blocks << block_size_log());
 
-    // PATAChannel will chuck a wobbly if we try to write more than PAGE_SIZE
-    // at a time, because it uses a single page for its DMA buffer.
-    if (whole_blocks >= m_blocks_per_page) {
-        whole_blocks = m_blocks_per_page;
-        remaining = 0;
-    }
-
     if (nwrite < block_size())
         offset_within_block = offset - (index << block_size_log());
 
@@ -168,21 +189,8 @@ ErrorOr<size_t> StorageDevice::write(OpenFileDescription&, u64 offset, UserOrKer
 
     dbgln_if(STORAGE_DEVICE_DEBUG, "StorageDevice::write() index={}, whole_blocks={}, remaining={}", index, whole_blocks, remaining);
 
-    if (whole_blocks > 0) {
-        auto write_request = TRY(try_make_request<AsyncBlockDeviceRequest>(AsyncBlockDeviceRequest::Write, index, whole_blocks, inbuf, whole_blocks * block_size()));
-        auto result = write_request->wait();
-        if (result.wait_result().was_interrupted())
-            return EINTR;
-        switch (result.request_result()) {
-        case AsyncDeviceRequest::Failure:
-        case AsyncDeviceRequest::Cancelled:
-            return EIO;
-        case AsyncDeviceRequest::MemoryFault:
-            return EFAULT;
-        default:
-            break;
-        }
-    }
+    if (whole_blocks > 0)
+        TRY(transfer_whole_blocks(AsyncBlockDeviceRequest::Write, index, whole_blocks, inbuf));
 
     off_t pos = whole_blocks * block_size();
 
@@ -85,10 +85,17 @@ public:
 protected:
     StorageDevice(LUNAddress, u32 hardware_relative_controller_id, size_t sector_size, u64);
 
+    // The most blocks a single request handed to start_request() may cover.
+    // Most of our drivers transfer through a single page DMA buffer, so that is the default.
+    virtual size_t max_blocks_per_request() const { return m_blocks_per_page; }
+
     // ^DiskDevice
     virtual StringView class_name() const override;
 
 private:
+    // Splits whole blocks into as few requests as the device allows, submits them as one batch and waits for all of them.
+    ErrorOr<void> transfer_whole_blocks(AsyncBlockDeviceRequest::RequestType, u64 index, size_t count, UserOrKernelBuffer const&);
+
     virtual ErrorOr<void> after_inserting() override;
     virtual void will_be_destroyed() override;
 
@@ -129,6 +129,12 @@ ErrorOr<void> VirtIOBlockDevice::handle_device_config_change()
     return {};
 }
 
+size_t VirtIOBlockDevice::max_blocks_per_request() const
+{
+    // NOTE: This has to pass the internal buffer size check in maybe_start_request().
+    return (INFLIGHT_BUFFER_SIZE - sizeof(VirtIOBlkReqTrailer)) / block_size();
+}
+
 void VirtIOBlockDevice::start_request(AsyncBlockDeviceRequest& request)
 {
     dbgln_if(VIRTIO_DEBUG, "VirtIOBlockDevice::start_request type={}", (int)request.request_type());
@@ -4,10 +4,15 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AnyOf.h>
+#include <AK/FixedArray.h>
 #include <AK/IntrusiveList.h>
+#include <AK/QuickSort.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/BlockBasedFileSystem.h>
+#include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/WorkQueue.h>
 
 namespace Kernel {
 
@@ -16,20 +21,23 @@ struct CacheEntry {
     BlockBasedFileSystem::BlockIndex block_index { 0 };
     u8* data { nullptr };
     bool has_data { false };
+    bool was_referenced { false };
+};
+
+// The disk cache grows one chunk of blocks at a time while there is free memory to spare,
+// and hands chunks back when the MemoryManager runs low on it (see release_unused_memory()).
+struct CacheChunk {
+    NonnullOwnPtr<KBuffer> block_data;
+    FixedArray<CacheEntry> entries;
 };
 
 class DiskCache {
 public:
-    static constexpr size_t EntryCount = 10000;
-    explicit DiskCache(BlockBasedFileSystem& fs, NonnullOwnPtr<KBuffer> cached_block_data, NonnullOwnPtr<KBuffer> entries_buffer)
+    static constexpr size_t ChunkSize = 1 * MiB;
+
+    explicit DiskCache(BlockBasedFileSystem& fs)
         : m_fs(fs)
-        , m_cached_block_data(move(cached_block_data))
-        , m_entries(move(entries_buffer))
     {
-        for (size_t i = 0; i < EntryCount; ++i) {
-            entries()[i].data = m_cached_block_data->data() + i * m_fs->logical_block_size();
-            m_clean_list.append(entries()[i]);
-        }
     }
 
     ~DiskCache() = default;
@@ -37,22 +45,35 @@ public:
     bool is_dirty() const { return !m_dirty_list.is_empty(); }
     bool entry_is_dirty(CacheEntry const& entry) const { return m_dirty_list.contains(entry); }
 
+    size_t dirty_count() const { return m_dirty_count; }
+
     void mark_all_clean()
     {
         while (auto* entry = m_dirty_list.first())
             m_clean_list.prepend(*entry);
+        m_dirty_count = 0;
     }
 
     void mark_dirty(CacheEntry& entry)
     {
+        if (!entry_is_dirty(entry))
+            ++m_dirty_count;
         m_dirty_list.prepend(entry);
     }
 
     void mark_clean(CacheEntry& entry)
     {
+        if (entry_is_dirty(entry))
+            --m_dirty_count;
         m_clean_list.prepend(entry);
     }
 
+    bool has_data_for(BlockBasedFileSystem::BlockIndex block_index) const
+    {
+        auto it = m_hash.find(block_index);
+        return it != m_hash.end() && it->value->has_data;
+    }
+
     CacheEntry* get(BlockBasedFileSystem::BlockIndex block_index) const
     {
         auto it = m_hash.find(block_index);
@@ -60,10 +81,8 @@ public:
             return nullptr;
         auto& entry = const_cast<CacheEntry&>(*it->value);
         VERIFY(entry.block_index == block_index);
-        if (!entry_is_dirty(entry) && (m_clean_list.first() != &entry)) {
-            // Cache hit! Promote the entry to the front of the list.
-            m_clean_list.prepend(entry);
-        }
+        // Cache hit! The entry gets a second chance the next time the clock hand comes by.
+        entry.was_referenced = true;
         return &entry;
     }
 
@@ -72,7 +91,14 @@ public:
         if (auto* entry = get(block_index))
             return entry;
 
-        if (m_clean_list.is_empty()) {
+        if (m_free_list.is_empty() && should_grow())
+            (void)try_grow();
+
+        auto* new_entry = m_free_list.first();
+        if (!new_entry)
+            new_entry = evict_clean_entry();
+
+        if (!new_entry) {
             // Not a single clean entry! Flush writes and try again.
             // NOTE: We want to make sure we only call FileBackedFileSystem flush here,
             //       not some FileBackedFileSystem subclass flush!
@@ -80,21 +106,57 @@ public:
             return ensure(block_index);
         }
 
-        VERIFY(m_clean_list.last());
-        auto& new_entry = *m_clean_list.last();
-        m_clean_list.prepend(new_entry);
-
-        m_hash.remove(new_entry.block_index);
-        TRY(m_hash.try_set(block_index, &new_entry));
-
-        new_entry.block_index = block_index;
-        new_entry.has_data = false;
+        m_clean_list.prepend(*new_entry);
+        new_entry->block_index = block_index;
+        new_entry->has_data = false;
+        new_entry->was_referenced = false;
+        if (auto result = m_hash.try_set(block_index, new_entry); result.is_error()) {
+            m_free_list.append(*new_entry);
+            return result.release_error();
+        }
+        return new_entry;
+    }
 
-        return &new_entry;
+    ErrorOr<void> try_grow() const
+    {
+        auto block_size = m_fs->logical_block_size();
+        auto entry_count = max<size_t>(ChunkSize / block_size, 1);
+        auto block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, entry_count * block_size));
+        auto entries = TRY(FixedArray<CacheEntry>::create(entry_count));
+        TRY(m_chunks.try_append({ move(block_data), move(entries) }));
+
+        auto& chunk = m_chunks.last();
+        for (size_t i = 0; i < chunk.entries.size(); ++i) {
+            chunk.entries[i].data = chunk.block_data->data() + i * block_size;
+            m_free_list.append(chunk.entries[i]);
+        }
+        return {};
     }
 
-    CacheEntry const* entries() const { return (CacheEntry const*)m_entries->data(); }
-    CacheEntry* entries() { return (CacheEntry*)m_entries->data(); }
+    // Gives up to half of the chunks (except for the first one) back to the system, dropping any clean blocks cached in them.
+    // Returns the number of bytes released.
+    size_t release_unused_memory()
+    {
+        if (m_chunks.size() <= 1)
+            return 0;
+        size_t chunks_to_release = m_chunks.size() / 2;
+        size_t released_bytes = 0;
+        for (size_t i = m_chunks.size() - 1; i > 0 && chunks_to_release > 0; --i) {
+            auto& chunk = m_chunks[i];
+            bool has_dirty_entries = any_of(chunk.entries, [&](auto& entry) { return entry_is_dirty(entry); });
+            if (has_dirty_entries)
+                continue;
+            for (auto& entry : chunk.entries) {
+                if (m_clean_list.contains(entry))
+                    m_hash.remove(entry.block_index);
+                entry.list_node.remove();
+            }
+            released_bytes += chunk.block_data->size();
+            m_chunks.remove(i);
+            --chunks_to_release;
+        }
+        return released_bytes;
+    }
 
     template<typename Callback>
     void for_each_dirty_entry(Callback callback)
@@ -104,17 +166,52 @@ public:
     }
 
 private:
+    bool should_grow() const
+    {
+        // Only grab more memory while there's plenty of it, and never more than an eighth of it per file system.
+        auto memory_info = MM.get_system_memory_info();
+        auto cache_size = m_chunks.size() * ChunkSize;
+        if (m_chunks.is_empty())
+            return true;
+        if (memory_info.physical_pages_uncommitted < memory_info.physical_pages / 8)
+            return false;
+        return cache_size < memory_info.physical_pages * PAGE_SIZE / 8;
+    }
+
+    CacheEntry* evict_clean_entry() const
+    {
+        // CLOCK: Walk the clean entries starting at the oldest one, and take the first one that hasn't been
+        //        used since we last came by. The ones that have get their reference bit cleared instead.
+        while (auto* entry = m_clean_list.last()) {
+            if (entry->was_referenced) {
+                entry->was_referenced = false;
+                m_clean_list.prepend(*entry);
+                continue;
+            }
+            m_hash.remove(entry->block_index);
+            return entry;
+        }
+        return nullptr;
+    }
+
     mutable NonnullRefPtr<BlockBasedFileSystem> m_fs;
-    NonnullOwnPtr<KBuffer> m_cached_block_data;
 
-    // NOTE: m_entries must be declared before m_dirty_list and m_clean_list because their entries are allocated from it.
-    // We need to ensure that the destructors of m_dirty_list and m_clean_list are called before m_entries is destroyed.
-    NonnullOwnPtr<KBuffer> m_entries;
+    // NOTE: m_chunks must be declared before the lists because their entries are allocated from it.
+    // We need to ensure that the destructors of the lists are called before m_chunks is destroyed.
+    mutable Vector<CacheChunk> m_chunks;
+    mutable IntrusiveList<&CacheEntry::list_node> m_free_list;
     mutable IntrusiveList<&CacheEntry::list_node> m_dirty_list;
     mutable IntrusiveList<&CacheEntry::list_node> m_clean_list;
     mutable HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
+    size_t m_dirty_count { 0 };
 };
 
+// Once this much data is waiting to be written, we start writing it out in the background instead of waiting for the next sync.
+static constexpr size_t write_behind_threshold = 2 * MiB;
+
+// The largest runs of adjacent blocks we read or write with a single request.
+static constexpr size_t max_block_run_size = 128 * KiB;
+
 BlockBasedFileSystem::BlockBasedFileSystem(OpenFileDescription& file_description)
     : FileBackedFileSystem(file_description)
 {
@@ -136,9 +233,8 @@ ErrorOr<void> BlockBasedFileSystem::initialize_while_locked()
     VERIFY(m_lock.is_locked());
     VERIFY(!is_initialized_while_locked());
     VERIFY(logical_block_size() != 0);
-    auto cached_block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, DiskCache::EntryCount * logical_block_size()));
-    auto entries_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache entries"sv, DiskCache::EntryCount * sizeof(CacheEntry)));
-    auto disk_cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(*this, move(cached_block_data), move(entries_data))));
+    auto disk_cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(*this)));
+    TRY(disk_cache->try_grow());
 
     m_cache.with_exclusive([&](auto& cache) {
         cache = move(disk_cache);
@@ -177,10 +273,24 @@ ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, UserOrKernelBu
 
         cache->mark_dirty(*entry);
         entry->has_data = true;
+        if (cache->dirty_count() * logical_block_size() >= write_behind_threshold)
+            start_write_behind();
         return {};
     });
 }
 
+void BlockBasedFileSystem::start_write_behind()
+{
+    if (m_write_behind_pending.exchange(true))
+        return;
+    auto result = g_file_io_work->try_queue([fs = NonnullRefPtr<BlockBasedFileSystem> { *this }] {
+        fs->m_write_behind_pending = false;
+        fs->flush_writes_impl();
+    });
+    if (result.is_error())
+        m_write_behind_pending = false;
+}
+
 ErrorOr<void> BlockBasedFileSystem::raw_read(BlockIndex index, UserOrKernelBuffer& buffer)
 {
     auto base_offset = index.value() * m_device_block_size;
@@ -199,21 +309,18 @@ ErrorOr<void> BlockBasedFileSystem::raw_write(BlockIndex index, UserOrKernelBuff
 
 ErrorOr<void> BlockBasedFileSystem::raw_read_blocks(BlockIndex index, size_t count, UserOrKernelBuffer& buffer)
 {
-    auto current = buffer;
-    for (auto block = index.value(); block < (index.value() + count); block++) {
-        TRY(raw_read(BlockIndex { block }, current));
-        current = current.offset(device_block_size());
-    }
+    // NOTE: Hand the whole range to the device at once, it knows best how to split it up into requests.
+    auto base_offset = index.value() * m_device_block_size;
+    auto nread = TRY(file_description().read(buffer, base_offset, count * m_device_block_size));
+    VERIFY(nread == count * m_device_block_size);
     return {};
 }
 
 ErrorOr<void> BlockBasedFileSystem::raw_write_blocks(BlockIndex index, size_t count, UserOrKernelBuffer const& buffer)
 {
-    auto current = buffer;
-    for (auto block = index.value(); block < (index.value() + count); block++) {
-        TRY(raw_write(block, current));
-        current = current.offset(device_block_size());
-    }
+    auto base_offset = index.value() * m_device_block_size;
+    auto nwritten = TRY(file_description().write(base_offset, buffer, count * m_device_block_size));
+    VERIFY(nwritten == count * m_device_block_size);
     return {};
 }
 
@@ -272,6 +379,43 @@ ErrorOr<void> BlockBasedFileSystem::read_blocks(BlockIndex index, unsigned count
     return {};
 }
 
+ErrorOr<void> BlockBasedFileSystem::prefetch_blocks(BlockIndex index, size_t count) const
+{
+    VERIFY(m_device_block_size);
+    auto block_size = logical_block_size();
+    auto max_run_length = max<size_t>(max_block_run_size / block_size, 1);
+    auto run_buffer = TRY(ByteBuffer::create_uninitialized(min(count, max_run_length) * block_size));
+    dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::prefetch_blocks {}, count={}", index, count);
+
+    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
+        for (size_t i = 0; i < count;) {
+            if (cache->has_data_for(BlockIndex { index.value() + i })) {
+                ++i;
+                continue;
+            }
+
+            // Read the whole run of blocks we don't have yet with a single request.
+            size_t run_length = 1;
+            while (i + run_length < count && run_length < max_run_length && !cache->has_data_for(BlockIndex { index.value() + i + run_length }))
+                ++run_length;
+            auto run_data_buffer = UserOrKernelBuffer::for_kernel_buffer(run_buffer.data());
+            auto nread = TRY(file_description().read(run_data_buffer, (index.value() + i) * block_size, run_length * block_size));
+            if (nread != run_length * block_size)
+                return EIO;
+
+            for (size_t j = 0; j < run_length; ++j) {
+                auto* entry = TRY(cache->ensure(BlockIndex { index.value() + i + j }));
+                if (entry->has_data)
+                    continue;
+                memcpy(entry->data, run_buffer.data() + j * block_size, block_size);
+                entry->has_data = true;
+            }
+            i += run_length;
+        }
+        return {};
+    });
+}
+
 void BlockBasedFileSystem::flush_specific_block_if_needed(BlockIndex index)
 {
     m_cache.with_exclusive([&](auto& cache) {
@@ -294,17 +438,69 @@ void BlockBasedFileSystem::flush_writes_impl()
     m_cache.with_exclusive([&](auto& cache) {
         if (!cache->is_dirty())
             return;
-        cache->for_each_dirty_entry([&](CacheEntry& entry) {
-            auto base_offset = entry.block_index.value() * logical_block_size();
+
+        will_write_back_dirty_blocks([&](BlockIndex index) -> u8 const* {
+            auto* entry = cache->get(index);
+            if (!entry || !cache->entry_is_dirty(*entry))
+                return nullptr;
+            return entry->data;
+        });
+
+        auto block_size = logical_block_size();
+        auto write_entry = [&](CacheEntry& entry) {
+            auto base_offset = entry.block_index.value() * block_size;
             auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
-            [[maybe_unused]] auto rc = file_description().write(base_offset, entry_data_buffer, logical_block_size());
+            [[maybe_unused]] auto rc = file_description().write(base_offset, entry_data_buffer, block_size);
             ++count;
+        };
+
+        // Write the dirty blocks out in on-disk order, merging runs of adjacent blocks into a single request.
+        // If we can't get the memory to do that, just write them out one by one.
+        Vector<CacheEntry*> dirty_entries;
+        auto max_run_length = max<size_t>(max_block_run_size / block_size, 1);
+        auto run_buffer_or_error = ByteBuffer::create_uninitialized(max_run_length * block_size);
+        if (run_buffer_or_error.is_error() || dirty_entries.try_ensure_capacity(cache->dirty_count()).is_error()) {
+            cache->for_each_dirty_entry(write_entry);
+            cache->mark_all_clean();
+            dbgln("{}: Flushed {} blocks to disk", class_name(), count);
+            return;
+        }
+        auto run_buffer = run_buffer_or_error.release_value();
+
+        cache->for_each_dirty_entry([&](CacheEntry& entry) {
+            dirty_entries.unchecked_append(&entry);
         });
+        quick_sort(dirty_entries, [](auto* a, auto* b) { return a->block_index < b->block_index; });
+
+        for (size_t i = 0; i < dirty_entries.size();) {
+            size_t run_length = 1;
+            while (i + run_length < dirty_entries.size() && run_length < max_run_length && dirty_entries[i + run_length]->block_index.value() == dirty_entries[i]->block_index.value() + run_length)
+                ++run_length;
+            if (run_length == 1) {
+                write_entry(*dirty_entries[i]);
+            } else {
+                for (size_t j = 0; j < run_length; ++j)
+                    memcpy(run_buffer.data() + j * block_size, dirty_entries[i + j]->data, block_size);
+                auto run_data_buffer = UserOrKernelBuffer::for_kernel_buffer(run_buffer.data());
+                [[maybe_unused]] auto rc = file_description().write(dirty_entries[i]->block_index.value() * block_size, run_data_buffer, run_length * block_size);
+                count += run_length;
+            }
+            i += run_length;
+        }
         cache->mark_all_clean();
         dbgln("{}: Flushed {} blocks to disk", class_name(), count);
     });
 }
 
+size_t BlockBasedFileSystem::release_cache_memory()
+{
+    return m_cache.with_exclusive([&](auto& cache) -> size_t {
+        if (!cache)
+            return 0;
+        return cache->release_unused_memory();
+    });
+}
+
 ErrorOr<void> BlockBasedFileSystem::flush_writes()
 {
     flush_writes_impl();
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Function.h>
 #include <Kernel/FileSystem/FileBackedFileSystem.h>
 #include <Kernel/Locking/MutexProtected.h>
 
@@ -22,6 +23,8 @@ public:
     virtual ErrorOr<void> flush_writes() override;
     void flush_writes_impl();
 
+    virtual size_t release_cache_memory() override;
+
 protected:
     explicit BlockBasedFileSystem(OpenFileDescription&);
 
@@ -29,6 +32,7 @@ protected:
 
     ErrorOr<void> read_block(BlockIndex, UserOrKernelBuffer*, size_t count, u64 offset = 0, bool allow_cache = true) const;
     ErrorOr<void> read_blocks(BlockIndex, unsigned count, UserOrKernelBuffer&, bool allow_cache = true) const;
+    ErrorOr<void> prefetch_blocks(BlockIndex, size_t count) const;
 
     ErrorOr<void> raw_read(BlockIndex, UserOrKernelBuffer&);
     ErrorOr<void> raw_write(BlockIndex, UserOrKernelBuffer const&);
@@ -39,14 +43,20 @@ protected:
     ErrorOr<void> write_block(BlockIndex, UserOrKernelBuffer const&, size_t count, u64 offset = 0, bool allow_cache = true);
     ErrorOr<void> write_blocks(BlockIndex, unsigned count, UserOrKernelBuffer const&, bool allow_cache = true);
 
+    // Called with the cache locked, right before its dirty blocks are written back to their place on the disk.
+    // `dirty_block_data` returns what is about to be written to a block, or null if that block isn't dirty.
+    virtual void will_write_back_dirty_blocks(Function<u8 const*(BlockIndex)> const& dirty_block_data) { (void)dirty_block_data; }
+
     u64 m_device_block_size { 512 };
 
     void remove_disk_cache_before_last_unmount();
 
 private:
     void flush_specific_block_if_needed(BlockIndex index);
+    void start_write_behind();
 
     mutable MutexProtected<OwnPtr<DiskCache>> m_cache;
+    Atomic<bool> m_write_behind_pending { false };
 };
 
 }
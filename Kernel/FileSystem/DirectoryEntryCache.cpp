@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Singleton.h>
+#include <Kernel/FileSystem/DirectoryEntryCache.h>
+#include <Kernel/FileSystem/Inode.h>
+
+namespace Kernel {
+
+static Singleton<DirectoryEntryCache> s_the;
+
+DirectoryEntryCache& DirectoryEntryCache::the()
+{
+    return *s_the;
+}
+
+bool DirectoryEntryCache::is_enabled_for(Inode const& directory)
+{
+    return directory.fs().supports_watchers();
+}
+
+Optional<RefPtr<Inode>> DirectoryEntryCache::lookup(Inode const& directory, StringView name)
+{
+    return m_state.with([&](auto& state) -> Optional<RefPtr<Inode>> {
+        auto directory_it = state.directories.find(directory.identifier());
+        if (directory_it == state.directories.end())
+            return {};
+        auto entry_it = directory_it->value->entries.find(name);
+        if (entry_it == directory_it->value->entries.end())
+            return {};
+
+        auto& entry = *entry_it->value;
+        RefPtr<Inode> child;
+        if (!entry.is_negative) {
+            // The child may have gone away since, in which case we have to ask the file system again.
+            auto strong_child = entry.child.strong_ref();
+            if (!strong_child) {
+                remove_entry(state, *directory_it->value, entry);
+                return {};
+            }
+            child = strong_child.ptr();
+        }
+
+        state.lru_list.remove(entry);
+        state.lru_list.prepend(entry);
+        return child;
+    });
+}
+
+u64 DirectoryEntryCache::generation() const
+{
+    return m_state.with([](auto const& state) { return state.generation; });
+}
+
+void DirectoryEntryCache::add(u64 generation, Inode const& directory, StringView name, Inode* child)
+{
+    // NOTE: Failing to allocate anything here just means the next lookup goes to the file system again.
+    LockWeakPtr<Inode> weak_child;
+    if (child) {
+        auto weak_child_or_error = child->try_make_weak_ptr<Inode>();
+        if (weak_child_or_error.is_error())
+            return;
+        weak_child = weak_child_or_error.release_value();
+    }
+    auto name_or_error = KString::try_create(name);
+    if (name_or_error.is_error())
+        return;
+    auto new_entry = adopt_own_if_nonnull(new (nothrow) Entry { name_or_error.release_value(), directory.identifier(), move(weak_child), child == nullptr, {} });
+    if (!new_entry)
+        return;
+
+    m_state.with([&](auto& state) {
+        if (state.generation != generation)
+            return;
+
+        auto directory_it = state.directories.find(directory.identifier());
+        if (directory_it == state.directories.end()) {
+            auto new_directory = adopt_own_if_nonnull(new (nothrow) Directory);
+            if (!new_directory || state.directories.try_set(directory.identifier(), new_directory.release_nonnull()).is_error())
+                return;
+            directory_it = state.directories.find(directory.identifier());
+        }
+        auto& cached_directory = *directory_it->value;
+        if (cached_directory.entries.contains(name))
+            return;
+
+        auto& entry = *new_entry;
+        if (cached_directory.entries.try_set(entry.name->view(), new_entry.release_nonnull()).is_error()) {
+            if (cached_directory.entries.is_empty())
+                state.directories.remove(directory_it);
+            return;
+        }
+        state.lru_list.prepend(entry);
+        ++state.entry_count;
+
+        while (state.entry_count > max_entry_count) {
+            auto& least_recently_used = *state.lru_list.last();
+            auto& entry_directory = *state.directories.get(least_recently_used.directory).value();
+            remove_entry(state, entry_directory, least_recently_used);
+        }
+    });
+}
+
+void DirectoryEntryCache::invalidate(InodeIdentifier directory, StringView name)
+{
+    m_state.with([&](auto& state) {
+        ++state.generation;
+        auto directory_it = state.directories.find(directory);
+        if (directory_it == state.directories.end())
+            return;
+        auto entry_it = directory_it->value->entries.find(name);
+        if (entry_it == directory_it->value->entries.end())
+            return;
+        remove_entry(state, *directory_it->value, *entry_it->value);
+    });
+}
+
+void DirectoryEntryCache::invalidate_directory(InodeIdentifier directory)
+{
+    m_state.with([&](auto& state) {
+        ++state.generation;
+        auto cached_directory = state.directories.take(directory);
+        if (!cached_directory.has_value())
+            return;
+        for (auto& it : (*cached_directory)->entries) {
+            state.lru_list.remove(*it.value);
+            --state.entry_count;
+        }
+    });
+}
+
+void DirectoryEntryCache::remove_entry(State& state, Directory& directory, Entry& entry)
+{
+    auto directory_identifier = entry.directory;
+    state.lru_list.remove(entry);
+    --state.entry_count;
+    directory.entries.remove(entry.name->view());
+    if (directory.entries.is_empty())
+        state.directories.remove(directory_identifier);
+}
+
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/RefPtr.h>
+#include <AK/StringView.h>
+#include <Kernel/FileSystem/InodeIdentifier.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Library/KString.h>
+#include <Kernel/Library/LockWeakPtr.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+
+namespace Kernel {
+
+// Remembers what looking up a name in a directory resulted in, including names that don't exist,
+// so that resolving the same paths over and over again doesn't have to ask the file system every time.
+// Only file systems that notify about every change to their directories (see FileSystem::supports_watchers())
+// take part, an entry is dropped whenever its name is added to or removed from the directory.
+class DirectoryEntryCache {
+    AK_MAKE_NONCOPYABLE(DirectoryEntryCache);
+    AK_MAKE_NONMOVABLE(DirectoryEntryCache);
+
+public:
+    static DirectoryEntryCache& the();
+
+    DirectoryEntryCache() = default;
+
+    static bool is_enabled_for(Inode const& directory);
+
+    // Returns an empty Optional if nothing is known about the name, or a null RefPtr if it's known not to exist.
+    Optional<RefPtr<Inode>> lookup(Inode const& directory, StringView name);
+
+    // Any change to a directory bumps the generation, results of lookups that raced with one aren't cached.
+    u64 generation() const;
+    void add(u64 generation, Inode const& directory, StringView name, Inode* child);
+
+    void invalidate(InodeIdentifier directory, StringView name);
+    void invalidate_directory(InodeIdentifier directory);
+
+private:
+    static constexpr size_t max_entry_count = 8192;
+
+    struct Entry {
+        NonnullOwnPtr<KString> name;
+        InodeIdentifier directory;
+        // A null child means the name doesn't exist in the directory.
+        LockWeakPtr<Inode> child;
+        bool is_negative { false };
+        IntrusiveListNode<Entry> lru_list_node;
+    };
+    using EntryLRUList = IntrusiveList<&Entry::lru_list_node>;
+
+    struct Directory {
+        HashMap<StringView, NonnullOwnPtr<Entry>> entries;
+    };
+
+    struct State {
+        HashMap<InodeIdentifier, NonnullOwnPtr<Directory>> directories;
+        // Most recently used entries come first.
+        EntryLRUList lru_list;
+        size_t entry_count { 0 };
+        u64 generation { 0 };
+    };
+
+    static void remove_entry(State&, Directory&, Entry&);
+
+    SpinlockProtected<State, LockRank::None> m_state {};
+};
+
+}
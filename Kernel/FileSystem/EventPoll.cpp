@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/EventPoll.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+static BlockFlags block_flags_for(u32 events)
+{
+    // Errors and hang-ups are always reported, like with poll().
+    BlockFlags block_flags = BlockFlags::WriteError | BlockFlags::WriteHangUp;
+    if (events & (EPOLLIN | EPOLLRDNORM))
+        block_flags |= BlockFlags::Read;
+    if (events & (EPOLLOUT | EPOLLWRNORM))
+        block_flags |= BlockFlags::Write;
+    if (events & EPOLLPRI)
+        block_flags |= BlockFlags::ReadPriority;
+    if (events & EPOLLWRBAND)
+        block_flags |= BlockFlags::WritePriority;
+    if (events & EPOLLRDHUP)
+        block_flags |= BlockFlags::ReadHangUp;
+    return block_flags;
+}
+
+static u32 events_for(BlockFlags unblocked_flags, u32 requested_events)
+{
+    u32 events = 0;
+    if (has_flag(unblocked_flags, BlockFlags::WriteHangUp))
+        events |= EPOLLHUP;
+    if (has_flag(unblocked_flags, BlockFlags::WriteError))
+        events |= EPOLLERR;
+    if (has_flag(unblocked_flags, BlockFlags::Read))
+        events |= requested_events & (EPOLLIN | EPOLLRDNORM);
+    if (has_flag(unblocked_flags, BlockFlags::ReadPriority))
+        events |= EPOLLPRI;
+    if (!has_flag(unblocked_flags, BlockFlags::WriteHangUp) && has_flag(unblocked_flags, BlockFlags::Write))
+        events |= requested_events & (EPOLLOUT | EPOLLWRNORM);
+    if (has_flag(unblocked_flags, BlockFlags::WritePriority))
+        events |= EPOLLWRBAND;
+    if (has_flag(unblocked_flags, BlockFlags::ReadHangUp))
+        events |= EPOLLRDHUP;
+    return events;
+}
+
+ErrorOr<NonnullRefPtr<EventPoll>> EventPoll::try_create()
+{
+    return adopt_nonnull_ref_or_enomem(new (nothrow) EventPoll);
+}
+
+EventPoll::~EventPoll()
+{
+    // Registrations stop listening when they are destroyed, after that no file can touch the ready list anymore.
+    m_registrations.clear();
+}
+
+EventPoll::Registration::Registration(EventPoll& event_poll, int fd, OpenFileDescription& description, epoll_event const& event)
+    : FileBlockerSet::Listener(description)
+    , event_poll(event_poll)
+    , file(description.file())
+    , fd(fd)
+    , events(event.events)
+    , data(event.data.u64)
+{
+}
+
+EventPoll::Registration::~Registration()
+{
+    blocker_set().remove_listener(*this);
+    event_poll.m_ready_list.with([&](auto& ready_list) {
+        ready_list.remove(*this);
+    });
+}
+
+void EventPoll::Registration::file_state_may_have_changed()
+{
+    event_poll.queue_possibly_ready(*this);
+}
+
+void EventPoll::queue_possibly_ready(Registration& registration)
+{
+    bool was_queued = m_ready_list.with([&](auto& ready_list) {
+        if (registration.ready_list_node.is_in_list())
+            return false;
+        ready_list.append(registration);
+        return true;
+    });
+    if (was_queued)
+        evaluate_block_conditions();
+}
+
+ErrorOr<void> EventPoll::add(int fd, OpenFileDescription& description, epoll_event const& event)
+{
+    // NOTE: Nesting would let a change of state recurse through the listeners of several epoll instances.
+    if (description.file().is_event_poll())
+        return EINVAL;
+
+    MutexLocker locker(m_lock);
+    if (auto existing = m_registrations.get(fd); existing.has_value()) {
+        if (existing.value()->description().ptr() == &description)
+            return EEXIST;
+        m_registrations.remove(fd);
+    }
+
+    auto registration = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Registration(*this, fd, description, event)));
+    auto& registration_ref = *registration;
+    TRY(m_registrations.try_set(fd, move(registration)));
+    registration_ref.blocker_set().add_listener(registration_ref);
+    // The file may already be ready, in which case it won't tell us until its state changes again.
+    queue_possibly_ready(registration_ref);
+    return {};
+}
+
+ErrorOr<void> EventPoll::modify(int fd, OpenFileDescription& description, epoll_event const& event)
+{
+    MutexLocker locker(m_lock);
+    auto registration = m_registrations.get(fd);
+    if (!registration.has_value() || registration.value()->description().ptr() != &description)
+        return ENOENT;
+    registration.value()->events = event.events;
+    registration.value()->data = event.data.u64;
+    registration.value()->is_disabled = false;
+    queue_possibly_ready(*registration.value());
+    return {};
+}
+
+ErrorOr<void> EventPoll::remove(int fd, OpenFileDescription& description)
+{
+    MutexLocker locker(m_lock);
+    auto registration = m_registrations.get(fd);
+    if (!registration.has_value() || registration.value()->description().ptr() != &description)
+        return ENOENT;
+    m_registrations.remove(fd);
+    return {};
+}
+
+ErrorOr<size_t> EventPoll::collect_ready_events(Span<epoll_event> ready_events)
+{
+    MutexLocker locker(m_lock);
+
+    // Level-triggered registrations that were reported go on this list, and back onto the ready list at the end,
+    // so they are looked at again by the next call (and reported for as long as they stay ready).
+    ReadyList reported_list;
+    size_t count = 0;
+    while (count < ready_events.size()) {
+        auto* registration = m_ready_list.with([](auto& ready_list) -> Registration* {
+            if (ready_list.is_empty())
+                return nullptr;
+            return ready_list.take_first();
+        });
+        if (!registration)
+            break;
+
+        auto description = registration->description();
+        if (!description) {
+            // The description was closed, which implicitly removes it from the interest list.
+            m_registrations.remove(registration->fd);
+            continue;
+        }
+        if (registration->is_disabled)
+            continue;
+
+        auto unblocked_flags = description->should_unblock(block_flags_for(registration->events));
+        // NOTE: If this was the last reference, the registration is queued up again and removed in the next iteration.
+        description = nullptr;
+        auto events = events_for(unblocked_flags, registration->events);
+        if (events == 0)
+            continue;
+
+        ready_events[count++] = { events, { .u64 = registration->data } };
+        if (registration->events & EPOLLONESHOT) {
+            registration->is_disabled = true;
+            continue;
+        }
+        if (registration->events & EPOLLET)
+            continue;
+        m_ready_list.with([&](auto&) {
+            // The file may have queued it up again in the meantime, which is just as well.
+            if (!registration->ready_list_node.is_in_list())
+                reported_list.append(*registration);
+        });
+    }
+
+    m_ready_list.with([&](auto& ready_list) {
+        while (!reported_list.is_empty())
+            ready_list.append(*reported_list.take_first());
+    });
+    return count;
+}
+
+bool EventPoll::can_read(OpenFileDescription const&, u64) const
+{
+    return m_ready_list.with([](auto const& ready_list) { return !ready_list.is_empty(); });
+}
+
+ErrorOr<NonnullOwnPtr<KString>> EventPoll::pseudo_path(OpenFileDescription const&) const
+{
+    return KString::try_create(":event-poll:"sv);
+}
+
+}
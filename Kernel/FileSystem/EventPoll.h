@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <Kernel/API/POSIX/sys/epoll.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Locking/Mutex.h>
+
+namespace Kernel {
+
+// The file behind an epoll file descriptor. It keeps a persistent list of the file descriptors it is interested
+// in, each of which listens to the state changes of its file. A change puts the file descriptor on the ready list,
+// so waiting for events only ever looks at file descriptors that may actually be ready, however many are watched.
+// The epoll file descriptor itself is readable while the ready list is not empty, which may be spurious.
+class EventPoll final : public File {
+public:
+    static ErrorOr<NonnullRefPtr<EventPoll>> try_create();
+
+    virtual ~EventPoll() override;
+
+    ErrorOr<void> add(int fd, OpenFileDescription&, epoll_event const&);
+    ErrorOr<void> modify(int fd, OpenFileDescription&, epoll_event const&);
+    ErrorOr<void> remove(int fd, OpenFileDescription&);
+
+    // Fills in the events of the file descriptors that are ready, without blocking.
+    ErrorOr<size_t> collect_ready_events(Span<epoll_event>);
+
+private:
+    class Registration final : public FileBlockerSet::Listener {
+    public:
+        Registration(EventPoll&, int fd, OpenFileDescription&, epoll_event const&);
+        virtual ~Registration() override;
+
+        virtual void file_state_may_have_changed() override;
+
+        using FileBlockerSet::Listener::blocker_set;
+
+        EventPoll& event_poll;
+        // Keeps the file (and with it the blocker set we are listening to) around, even once the description is gone.
+        NonnullRefPtr<File> const file;
+        int const fd { -1 };
+        u32 events { 0 };
+        u64 data { 0 };
+        // Set once an EPOLLONESHOT event has been reported, until the registration is modified.
+        bool is_disabled { false };
+
+        IntrusiveListNode<Registration> ready_list_node;
+    };
+
+    using ReadyList = IntrusiveList<&Registration::ready_list_node>;
+
+    EventPoll() = default;
+
+    void queue_possibly_ready(Registration&);
+
+    virtual StringView class_name() const override { return "EventPoll"sv; }
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual bool is_event_poll() const override { return true; }
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return EINVAL; }
+
+    Mutex m_lock { "EventPoll"sv };
+    // NOTE: A registration is keyed by the file descriptor alone. If the descriptor was closed and its number reused
+    //       for another file, the old registration is stale and is replaced.
+    HashMap<int, NonnullOwnPtr<Registration>> m_registrations;
+
+    // The ready list is protected by a spinlock of its own, files append to it while their listeners are locked.
+    SpinlockProtected<ReadyList, LockRank::None> m_ready_list;
+};
+
+}
@@ -410,6 +410,38 @@ struct ext2_inode_large {
     __u32 i_version_hi;   /* high 32 bits for 64-bit version */
 };
 
+/*
+ * ext4 extent tree, rooted in i_block of inodes with EXT4_EXTENTS_FL set
+ */
+#define EXT4_EXT_MAGIC 0xf30a
+#define EXT4_EXT_MAX_DEPTH 5
+#define EXT4_EXT_INIT_MAX_LEN (1u << 15)                    /* Longest initialized extent */
+#define EXT4_EXT_UNINIT_MAX_LEN (EXT4_EXT_INIT_MAX_LEN - 1) /* Longest uninitialized extent */
+
+struct ext4_extent_header {
+    __u16 eh_magic;      /* EXT4_EXT_MAGIC */
+    __u16 eh_entries;    /* Number of valid entries */
+    __u16 eh_max;        /* Capacity of the node in entries */
+    __u16 eh_depth;      /* Depth of the tree below this node, 0 for leaves */
+    __u32 eh_generation; /* Generation of the tree */
+};
+
+/* Index node entry, pointing at the node covering the blocks starting at ei_block */
+struct ext4_extent_idx {
+    __u32 ei_block;   /* First logical block covered */
+    __u32 ei_leaf_lo; /* Low 32 bits of the physical block of the next level */
+    __u16 ei_leaf_hi; /* High 16 bits of the physical block */
+    __u16 ei_unused;
+};
+
+/* Leaf node entry */
+struct ext4_extent {
+    __u32 ee_block;    /* First logical block */
+    __u16 ee_len;      /* Number of blocks, more than EXT4_EXT_INIT_MAX_LEN means uninitialized */
+    __u16 ee_start_hi; /* High 16 bits of the first physical block */
+    __u32 ee_start_lo; /* Low 32 bits of the first physical block */
+};
+
 #define i_size_high i_dir_acl
 
 #if defined(__KERNEL__) || defined(__linux__)
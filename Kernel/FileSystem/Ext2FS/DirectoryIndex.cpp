@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StdLibExtras.h>
+#include <Kernel/FileSystem/Ext2FS/Definitions.h>
+#include <Kernel/FileSystem/Ext2FS/DirectoryIndex.h>
+
+namespace Kernel {
+
+// NOTE: These have to match what e2fsprogs and Linux compute bit for bit, or the directories we index are unusable elsewhere.
+
+static constexpr u32 htree_eof = 0x7fffffff;
+
+static constexpr u32 rotate_left(u32 value, u32 shift)
+{
+    return (value << shift) | (value >> (32 - shift));
+}
+
+template<typename CharType>
+static u32 legacy_hash(StringView name)
+{
+    u32 hash0 = 0x12a3fe2d;
+    u32 hash1 = 0x37abe8f9;
+    for (auto c : name) {
+        u32 hash = hash1 + (hash0 ^ (static_cast<u32>(static_cast<int>(static_cast<CharType>(c))) * 7152373u));
+        if (hash & 0x80000000)
+            hash -= 0x7fffffff;
+        hash1 = hash0;
+        hash0 = hash;
+    }
+    return hash0 << 1;
+}
+
+// Packs (up to) the next num * 4 bytes of the name into num words, padding them with the name length.
+template<typename CharType>
+static void name_to_hash_buffer(StringView name, u32* buffer, int num)
+{
+    u32 pad = static_cast<u32>(name.length()) | (static_cast<u32>(name.length()) << 8);
+    pad |= pad << 16;
+
+    u32 value = pad;
+    size_t length = min(name.length(), static_cast<size_t>(num * 4));
+    for (size_t i = 0; i < length; ++i) {
+        value = static_cast<u32>(static_cast<int>(static_cast<CharType>(name[i]))) + (value << 8);
+        if ((i % 4) == 3) {
+            *buffer++ = value;
+            value = pad;
+            --num;
+        }
+    }
+    if (--num >= 0)
+        *buffer++ = value;
+    while (--num >= 0)
+        *buffer++ = pad;
+}
+
+static void tea_transform(u32 buffer[4], u32 const in[4])
+{
+    constexpr u32 delta = 0x9e3779b9;
+    u32 sum = 0;
+    u32 b0 = buffer[0];
+    u32 b1 = buffer[1];
+    u32 a = in[0];
+    u32 b = in[1];
+    u32 c = in[2];
+    u32 d = in[3];
+    for (int n = 0; n < 16; ++n) {
+        sum += delta;
+        b0 += ((b1 << 4) + a) ^ (b1 + sum) ^ ((b1 >> 5) + b);
+        b1 += ((b0 << 4) + c) ^ (b0 + sum) ^ ((b0 >> 5) + d);
+    }
+    buffer[0] += b0;
+    buffer[1] += b1;
+}
+
+static void half_md4_transform(u32 buffer[4], u32 const in[8])
+{
+    auto f = [](u32 x, u32 y, u32 z) { return z ^ (x & (y ^ z)); };
+    auto g = [](u32 x, u32 y, u32 z) { return (x & y) + ((x ^ y) & z); };
+    auto h = [](u32 x, u32 y, u32 z) { return x ^ y ^ z; };
+    auto round = [](auto function, u32& a, u32 b, u32 c, u32 d, u32 x, u32 shift) {
+        a = rotate_left(a + function(b, c, d) + x, shift);
+    };
+
+    constexpr u32 k1 = 0;
+    constexpr u32 k2 = 013240474631;
+    constexpr u32 k3 = 015666365641;
+
+    u32 a = buffer[0];
+    u32 b = buffer[1];
+    u32 c = buffer[2];
+    u32 d = buffer[3];
+
+    round(f, a, b, c, d, in[0] + k1, 3);
+    round(f, d, a, b, c, in[1] + k1, 7);
+    round(f, c, d, a, b, in[2] + k1, 11);
+    round(f, b, c, d, a, in[3] + k1, 19);
+    round(f, a, b, c, d, in[4] + k1, 3);
+    round(f, d, a, b, c, in[5] + k1, 7);
+    round(f, c, d, a, b, in[6] + k1, 11);
+    round(f, b, c, d, a, in[7] + k1, 19);
+
+    round(g, a, b, c, d, in[1] + k2, 3);
+    round(g, d, a, b, c, in[3] + k2, 5);
+    round(g, c, d, a, b, in[5] + k2, 9);
+    round(g, b, c, d, a, in[7] + k2, 13);
+    round(g, a, b, c, d, in[0] + k2, 3);
+    round(g, d, a, b, c, in[2] + k2, 5);
+    round(g, c, d, a, b, in[4] + k2, 9);
+    round(g, b, c, d, a, in[6] + k2, 13);
+
+    round(h, a, b, c, d, in[3] + k3, 3);
+    round(h, d, a, b, c, in[7] + k3, 9);
+    round(h, c, d, a, b, in[2] + k3, 11);
+    round(h, b, c, d, a, in[6] + k3, 15);
+    round(h, a, b, c, d, in[1] + k3, 3);
+    round(h, d, a, b, c, in[5] + k3, 9);
+    round(h, c, d, a, b, in[0] + k3, 11);
+    round(h, b, c, d, a, in[4] + k3, 15);
+
+    buffer[0] += a;
+    buffer[1] += b;
+    buffer[2] += c;
+    buffer[3] += d;
+}
+
+template<typename CharType, size_t words, typename Transform>
+static void hash_name_in_chunks(StringView name, u32 buffer[4], Transform transform)
+{
+    u32 in[8];
+    for (size_t offset = 0; offset < name.length(); offset += words * 4) {
+        name_to_hash_buffer<CharType>(name.substring_view(offset), in, words);
+        transform(buffer, in);
+    }
+}
+
+Optional<Ext2FSDirectoryHash> ext2_directory_hash(StringView name, u8 hash_version, u32 const seed[4])
+{
+    u32 buffer[4] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+    if (seed && (seed[0] || seed[1] || seed[2] || seed[3])) {
+        for (size_t i = 0; i < 4; ++i)
+            buffer[i] = seed[i];
+    }
+
+    Ext2FSDirectoryHash result;
+    switch (hash_version) {
+    case EXT2_HASH_LEGACY:
+        result.hash = legacy_hash<i8>(name);
+        break;
+    case EXT2_HASH_LEGACY_UNSIGNED:
+        result.hash = legacy_hash<u8>(name);
+        break;
+    case EXT2_HASH_HALF_MD4:
+    case EXT2_HASH_HALF_MD4_UNSIGNED:
+        if (hash_version == EXT2_HASH_HALF_MD4)
+            hash_name_in_chunks<i8, 8>(name, buffer, half_md4_transform);
+        else
+            hash_name_in_chunks<u8, 8>(name, buffer, half_md4_transform);
+        result.hash = buffer[1];
+        result.minor_hash = buffer[2];
+        break;
+    case EXT2_HASH_TEA:
+    case EXT2_HASH_TEA_UNSIGNED:
+        if (hash_version == EXT2_HASH_TEA)
+            hash_name_in_chunks<i8, 4>(name, buffer, tea_transform);
+        else
+            hash_name_in_chunks<u8, 4>(name, buffer, tea_transform);
+        result.hash = buffer[0];
+        result.minor_hash = buffer[1];
+        break;
+    default:
+        return {};
+    }
+
+    result.hash &= ~1u;
+    if (result.hash == (htree_eof << 1))
+        result.hash = (htree_eof - 1) << 1;
+    return result;
+}
+
+}
@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+// The entries of indexed ("htree") directories are sorted by this hash of their name.
+// The lowest bit is always clear, it is used to mark hash collisions in the index.
+struct Ext2FSDirectoryHash {
+    u32 hash { 0 };
+    u32 minor_hash { 0 };
+};
+
+// Returns an empty Optional for hash versions we don't know, such directories have to be treated as unindexed.
+Optional<Ext2FSDirectoryHash> ext2_directory_hash(StringView name, u8 hash_version, u32 const seed[4]);
+
+}
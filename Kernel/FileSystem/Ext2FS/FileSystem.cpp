@@ -127,14 +127,82 @@ ErrorOr<void> Ext2FS::initialize_while_locked()
 
     m_root_inode = TRY(build_root_inode());
 
+    if (has_flag(get_features_optional(), FeaturesOptional::HasJournal))
+        TRY(initialize_journal());
+
     // Set filesystem to "error" state until we unmount cleanly.
     dmesgln("Ext2FS: Mount successful, setting superblock to error state.");
     m_super_block.s_state = EXT2_ERROR_FS;
+    // Likewise, other implementations have to look at the journal until then.
+    if (m_journal)
+        m_super_block.s_feature_incompat |= EXT3_FEATURE_INCOMPAT_RECOVER;
     TRY(flush_super_block());
 
     return {};
 }
 
+ErrorOr<void> Ext2FS::initialize_journal()
+{
+    VERIFY(m_lock.is_locked());
+    auto needs_recovery = has_flag(get_features_incompatible(), FeaturesIncompatible::NeedsRecovery);
+    if (m_super_block.s_journal_inum == 0) {
+        dmesgln("Ext2FS: Journals on external devices are not supported");
+        if (needs_recovery)
+            return ENOTSUP;
+        return {};
+    }
+
+    auto journal_inode = TRY(get_inode({ fsid(), m_super_block.s_journal_inum }));
+    auto& inode = static_cast<Ext2FSInode&>(*journal_inode);
+    TRY(inode.load_block_map());
+    Vector<BlockIndex> journal_blocks;
+    TRY(journal_blocks.try_ensure_capacity(inode.mapped_block_count()));
+    for (u64 i = 0; i < inode.mapped_block_count(); ++i) {
+        auto block_index = inode.block_index_for(i);
+        if (block_index.value() == 0) {
+            dmesgln("Ext2FS: Journal inode has holes");
+            return EINVAL;
+        }
+        journal_blocks.unchecked_append(block_index);
+    }
+    m_journal = TRY(Ext2FSJournal::try_create(*this, move(journal_blocks)));
+
+    if (m_journal->needs_recovery()) {
+        TRY(m_journal->recover());
+
+        // The journal may have held newer copies of any of the metadata we've looked at so far.
+        auto super_block_buffer = UserOrKernelBuffer::for_kernel_buffer((u8*)&m_super_block);
+        TRY(raw_read_blocks(1024 / device_block_size(), (sizeof(ext2_super_block) / device_block_size()), super_block_buffer));
+        auto blocks_to_read = ceil_div(m_block_group_count * sizeof(ext2_group_desc), logical_block_size());
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(m_cached_group_descriptor_table->data());
+        TRY(read_blocks(first_block_of_block_group_descriptors(), blocks_to_read, buffer));
+        m_cached_bitmaps.clear();
+        m_inode_cache.clear();
+        m_root_inode = TRY(build_root_inode());
+        dmesgln("Ext2FS: Recovered metadata from the journal");
+    }
+
+    if (!m_journal->is_writable()) {
+        dmesgln("Ext2FS: Journal uses features we can't write, continuing without journaling");
+        m_journal = nullptr;
+        m_super_block.s_feature_incompat &= ~EXT3_FEATURE_INCOMPAT_RECOVER;
+    }
+    return {};
+}
+
+ErrorOr<void> Ext2FS::journal_metadata_block(BlockIndex block_index)
+{
+    if (!m_journal)
+        return {};
+    return m_journal->add_metadata_block(block_index);
+}
+
+void Ext2FS::will_write_back_dirty_blocks(Function<u8 const*(BlockIndex)> const& dirty_block_data)
+{
+    if (m_journal)
+        m_journal->commit(dirty_block_data);
+}
+
 Inode& Ext2FS::root_inode()
 {
     return *m_root_inode;
@@ -228,6 +296,13 @@ Ext2FS::FeaturesReadOnly Ext2FS::get_features_readonly() const
     return Ext2FS::FeaturesReadOnly::None;
 }
 
+Ext2FS::FeaturesIncompatible Ext2FS::get_features_incompatible() const
+{
+    if (m_super_block.s_rev_level > 0)
+        return static_cast<Ext2FS::FeaturesIncompatible>(m_super_block.s_feature_incompat);
+    return Ext2FS::FeaturesIncompatible::None;
+}
+
 u64 Ext2FS::inodes_per_block() const
 {
     return EXT2_INODES_PER_BLOCK(&super_block());
@@ -254,6 +329,7 @@ ErrorOr<void> Ext2FS::write_ext2_inode(InodeIndex inode, ext2_inode const& e2ino
     if (!find_block_containing_inode(inode, block_index, offset))
         return EINVAL;
     auto buffer = UserOrKernelBuffer::for_kernel_buffer(const_cast<u8*>((u8 const*)&e2inode));
+    TRY(journal_metadata_block(block_index));
     return write_block(block_index, buffer, inode_size(), offset);
 }
 
@@ -531,10 +607,17 @@ ErrorOr<NonnullRefPtr<Inode>> Ext2FS::create_inode(Ext2FSInode& parent_inode, St
     // For directories, add +1 link count for the "." entry in self.
     e2inode.i_links_count = is_directory(mode);
 
-    if (is_character_device(mode))
+    if (is_character_device(mode)) {
         e2inode.i_block[0] = dev;
-    else if (is_block_device(mode))
+    } else if (is_block_device(mode)) {
         e2inode.i_block[1] = dev;
+    } else if ((is_regular_file(mode) || is_directory(mode)) && has_flag(get_features_incompatible(), FeaturesIncompatible::Extents)) {
+        // Start out with an empty extent tree that lives entirely in i_block.
+        e2inode.i_flags |= EXT4_EXTENTS_FL;
+        auto& header = *reinterpret_cast<ext4_extent_header*>(e2inode.i_block);
+        header.eh_magic = EXT4_EXT_MAGIC;
+        header.eh_max = (sizeof(e2inode.i_block) - sizeof(ext4_extent_header)) / sizeof(ext4_extent);
+    }
 
     auto inode_id = TRY(allocate_inode());
 
@@ -601,6 +684,13 @@ ErrorOr<void> Ext2FS::prepare_to_clear_last_mount(Inode& mount_guest_inode)
     m_inode_cache.clear();
     m_root_inode = nullptr;
 
+    if (m_journal) {
+        // Once everything is written back in place, there is nothing left in the journal to replay.
+        TRY(flush_writes());
+        TRY(m_journal->mark_clean());
+        m_super_block.s_feature_incompat &= ~EXT3_FEATURE_INCOMPAT_RECOVER;
+    }
+
     // Mark filesystem as valid before unmount.
     dmesgln("Ext2FS: Clean unmount, setting superblock to valid state");
     m_super_block.s_state = EXT2_VALID_FS;
@@ -617,7 +707,17 @@ ErrorOr<void> Ext2FS::free_inode(Ext2FSInode& inode)
     dbgln_if(EXT2_DEBUG, "Ext2FS[{}]::free_inode(): Inode {} has no more links, time to delete!", fsid(), inode.index());
 
     // Mark all blocks used by this inode as free.
-    {
+    if (inode.uses_extents()) {
+        Vector<Ext2FSInode::Extent> extents;
+        Vector<BlockIndex> extent_tree_blocks;
+        TRY(inode.compute_extent_list(extents, extent_tree_blocks));
+        for (auto const& extent : extents) {
+            for (size_t i = 0; i < extent.length; ++i)
+                TRY(set_block_allocation_state(extent.physical_block.value() + i, false));
+        }
+        for (auto block_index : extent_tree_blocks)
+            TRY(set_block_allocation_state(block_index, false));
+    } else {
         auto blocks = TRY(inode.compute_block_list_with_meta_blocks());
         for (auto block_index : blocks) {
             VERIFY(block_index <= super_block().s_blocks_count);
@@ -652,6 +752,10 @@ void Ext2FS::flush_block_group_descriptor_table()
     auto first_block_of_bgdt = first_block_of_block_group_descriptors();
     auto buffer = UserOrKernelBuffer::for_kernel_buffer((u8*)block_group_descriptors());
     auto write_bgdt_to_block = [&](BlockIndex index) {
+        for (size_t i = 0; i < blocks_to_write; ++i) {
+            if (auto result = journal_metadata_block(index.value() + i); result.is_error())
+                dbgln("Ext2FS[{}]::flush_block_group_descriptor_table(): Failed to journal blocks: {}", fsid(), result.error());
+        }
         if (auto result = write_blocks(index, blocks_to_write, buffer); result.is_error())
             dbgln("Ext2FS[{}]::flush_block_group_descriptor_table(): Failed to write blocks: {}", fsid(), result.error());
     };
@@ -690,6 +794,8 @@ ErrorOr<void> Ext2FS::flush_writes()
         for (auto& cached_bitmap : m_cached_bitmaps) {
             if (cached_bitmap->dirty) {
                 auto buffer = UserOrKernelBuffer::for_kernel_buffer(cached_bitmap->buffer->data());
+                if (auto result = journal_metadata_block(cached_bitmap->bitmap_block_index); result.is_error())
+                    dbgln("Ext2FS[{}]::flush_writes(): Failed to journal bitmap block: {}", fsid(), result.error());
                 if (auto result = write_block(cached_bitmap->bitmap_block_index, buffer, logical_block_size()); result.is_error()) {
                     dbgln("Ext2FS[{}]::flush_writes(): Failed to write blocks: {}", fsid(), result.error());
                 }
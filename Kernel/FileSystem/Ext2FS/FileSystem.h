@@ -10,6 +10,7 @@
 #include <AK/HashMap.h>
 #include <Kernel/FileSystem/BlockBasedFileSystem.h>
 #include <Kernel/FileSystem/Ext2FS/Definitions.h>
+#include <Kernel/FileSystem/Ext2FS/Journal.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/Library/KBuffer.h>
 #include <Kernel/UnixTypes.h>
@@ -20,12 +21,15 @@ class Ext2FSInode;
 
 class Ext2FS final : public BlockBasedFileSystem {
     friend class Ext2FSInode;
+    friend class Ext2FSJournal;
 
 public:
     // s_feature_compat
     enum class FeaturesOptional : u32 {
         None = 0,
+        HasJournal = EXT3_FEATURE_COMPAT_HAS_JOURNAL,
         ExtendedAttributes = EXT2_FEATURE_COMPAT_EXT_ATTR,
+        DirectoryIndex = EXT2_FEATURE_COMPAT_DIR_INDEX,
     };
     AK_ENUM_BITWISE_FRIEND_OPERATORS(FeaturesOptional);
 
@@ -37,6 +41,14 @@ public:
     };
     AK_ENUM_BITWISE_FRIEND_OPERATORS(FeaturesReadOnly);
 
+    // s_feature_incompat
+    enum class FeaturesIncompatible : u32 {
+        None = 0,
+        NeedsRecovery = EXT3_FEATURE_INCOMPAT_RECOVER,
+        Extents = EXT3_FEATURE_INCOMPAT_EXTENTS,
+    };
+    AK_ENUM_BITWISE_FRIEND_OPERATORS(FeaturesIncompatible);
+
     static ErrorOr<NonnullRefPtr<FileSystem>> try_create(OpenFileDescription&, ReadonlyBytes);
 
     virtual ~Ext2FS() override;
@@ -53,6 +65,7 @@ public:
 
     FeaturesOptional get_features_optional() const;
     FeaturesReadOnly get_features_readonly() const;
+    FeaturesIncompatible get_features_incompatible() const;
 
     virtual StringView class_name() const override { return "Ext2FS"sv; }
     virtual Inode& root_inode() override;
@@ -79,6 +92,11 @@ private:
 
     ErrorOr<void> flush_super_block();
 
+    ErrorOr<void> initialize_journal();
+    // Has to be called before a block holding metadata is modified, so that the change is journaled.
+    ErrorOr<void> journal_metadata_block(BlockIndex);
+    virtual void will_write_back_dirty_blocks(Function<u8 const*(BlockIndex)> const& dirty_block_data) override;
+
     virtual ErrorOr<void> initialize_while_locked() override;
     virtual bool is_initialized_while_locked() override;
 
@@ -140,6 +158,8 @@ private:
 
     Vector<OwnPtr<CachedBitmap>> m_cached_bitmaps;
     RefPtr<Ext2FSInode> m_root_inode;
+
+    OwnPtr<Ext2FSJournal> m_journal;
 };
 
 }
@@ -6,6 +6,7 @@
  */
 
 #include <AK/MemoryStream.h>
+#include <AK/QuickSort.h>
 #include <Kernel/API/POSIX/errno.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/Ext2FS/FileSystem.h>
@@ -49,6 +50,7 @@ ErrorOr<void> Ext2FSInode::write_indirect_block(BlockBasedFileSystem::BlockIndex
     for (unsigned i = 0; i < blocks_indices.size(); ++i)
         MUST(stream.write_value<u32>(blocks_indices[i].value()));
 
+    TRY(fs().journal_metadata_block(block));
     return fs().write_block(block, buffer, block_contents.size());
 }
 
@@ -88,6 +90,7 @@ ErrorOr<void> Ext2FSInode::grow_doubly_indirect_block(BlockBasedFileSystem::Bloc
     }
 
     // Write out the doubly indirect block.
+    TRY(fs().journal_metadata_block(block));
     return fs().write_block(block, buffer, block_contents.size());
 }
 
@@ -162,6 +165,7 @@ ErrorOr<void> Ext2FSInode::grow_triply_indirect_block(BlockBasedFileSystem::Bloc
     }
 
     // Write out the triply indirect block.
+    TRY(fs().journal_metadata_block(block));
     return fs().write_block(block, buffer, block_contents.size());
 }
 
@@ -344,6 +348,7 @@ ErrorOr<Vector<Ext2FS::BlockIndex>> Ext2FSInode::compute_block_list_with_meta_bl
 
 ErrorOr<Vector<Ext2FS::BlockIndex>> Ext2FSInode::compute_block_list_impl(bool include_block_list_blocks) const
 {
+    VERIFY(!uses_extents());
     // FIXME: This is really awkwardly factored.. foo_impl_internal :|
     auto block_list = TRY(compute_block_list_impl_internal(m_raw_inode, include_block_list_blocks));
     while (!block_list.is_empty() && block_list.last() == 0)
@@ -445,6 +450,296 @@ ErrorOr<Vector<Ext2FS::BlockIndex>> Ext2FSInode::compute_block_list_impl_interna
     return list;
 }
 
+ErrorOr<void> Ext2FSInode::compute_extent_list(Vector<Extent>& extents, Vector<BlockBasedFileSystem::BlockIndex>& extent_tree_blocks) const
+{
+    VERIFY(uses_extents());
+    auto root = ReadonlyBytes { reinterpret_cast<u8 const*>(m_raw_inode.i_block), sizeof(m_raw_inode.i_block) };
+    auto root_depth = reinterpret_cast<ext4_extent_header const*>(m_raw_inode.i_block)->eh_depth;
+    if (root_depth > EXT4_EXT_MAX_DEPTH) {
+        dmesgln("Ext2FSInode[{}]::compute_extent_list(): Extent tree is too deep ({})", identifier(), root_depth);
+        return EIO;
+    }
+    return read_extent_tree_node(root, root_depth, extents, extent_tree_blocks);
+}
+
+ErrorOr<void> Ext2FSInode::read_extent_tree_node(ReadonlyBytes node, u16 depth, Vector<Extent>& extents, Vector<BlockBasedFileSystem::BlockIndex>& extent_tree_blocks) const
+{
+    static_assert(sizeof(ext4_extent) == sizeof(ext4_extent_idx));
+    auto const& header = *reinterpret_cast<ext4_extent_header const*>(node.data());
+    if (header.eh_magic != EXT4_EXT_MAGIC || header.eh_depth != depth || sizeof(ext4_extent_header) + header.eh_entries * sizeof(ext4_extent) > node.size()) {
+        dmesgln("Ext2FSInode[{}]::read_extent_tree_node(): Corrupted extent tree node (magic {:04x}, depth {}, {} entries)", identifier(), header.eh_magic, header.eh_depth, header.eh_entries);
+        return EIO;
+    }
+
+    if (depth == 0) {
+        auto const* entries = reinterpret_cast<ext4_extent const*>(node.offset(sizeof(ext4_extent_header)));
+        TRY(extents.try_ensure_capacity(extents.size() + header.eh_entries));
+        for (size_t i = 0; i < header.eh_entries; ++i) {
+            auto const& entry = entries[i];
+            Extent extent;
+            extent.logical_block = entry.ee_block;
+            extent.is_uninitialized = entry.ee_len > EXT4_EXT_INIT_MAX_LEN;
+            extent.length = extent.is_uninitialized ? entry.ee_len - EXT4_EXT_INIT_MAX_LEN : entry.ee_len;
+            extent.physical_block = static_cast<u64>(entry.ee_start_hi) << 32 | entry.ee_start_lo;
+            if (extent.length == 0 || (!extents.is_empty() && extent.logical_block < extents.last().end())) {
+                dmesgln("Ext2FSInode[{}]::read_extent_tree_node(): Invalid extent at logical block {}", identifier(), extent.logical_block);
+                return EIO;
+            }
+            extents.unchecked_append(extent);
+        }
+        return {};
+    }
+
+    auto block_size = fs().logical_block_size();
+    auto child_node = TRY(ByteBuffer::create_uninitialized(block_size));
+    auto const* entries = reinterpret_cast<ext4_extent_idx const*>(node.offset(sizeof(ext4_extent_header)));
+    for (size_t i = 0; i < header.eh_entries; ++i) {
+        BlockBasedFileSystem::BlockIndex child_block_index = static_cast<u64>(entries[i].ei_leaf_hi) << 32 | entries[i].ei_leaf_lo;
+        TRY(extent_tree_blocks.try_append(child_block_index));
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(child_node.data());
+        TRY(fs().read_block(child_block_index, &buffer, block_size));
+        TRY(read_extent_tree_node(child_node.bytes(), depth - 1, extents, extent_tree_blocks));
+    }
+    return {};
+}
+
+Ext2FSInode::Extent const* Ext2FSInode::find_extent(u32 logical_block) const
+{
+    // NOTE: The extents are sorted by their logical block and never overlap.
+    size_t low = 0;
+    size_t high = m_extents.size();
+    while (low < high) {
+        auto middle = low + (high - low) / 2;
+        auto const& extent = m_extents[middle];
+        if (logical_block < extent.logical_block)
+            high = middle;
+        else if (logical_block >= extent.end())
+            low = middle + 1;
+        else
+            return &extent;
+    }
+    return nullptr;
+}
+
+ErrorOr<void> Ext2FSInode::map_extent_block(u32 logical_block, BlockBasedFileSystem::BlockIndex block_index)
+{
+    size_t i = 0;
+    while (i < m_extents.size() && m_extents[i].end() <= logical_block)
+        ++i;
+
+    if (i < m_extents.size() && m_extents[i].logical_block <= logical_block) {
+        // We can only map blocks that were unallocated or part of an uninitialized extent, which we have to split up.
+        auto extent = m_extents[i];
+        VERIFY(extent.is_uninitialized);
+        auto offset_in_extent = logical_block - extent.logical_block;
+        Extent before { extent.logical_block, offset_in_extent, extent.physical_block, true };
+        Extent after { logical_block + 1, extent.length - offset_in_extent - 1, extent.physical_block.value() + offset_in_extent + 1, true };
+        m_extents.remove(i);
+        if (after.length)
+            TRY(m_extents.try_insert(i, after));
+        if (before.length) {
+            TRY(m_extents.try_insert(i, before));
+            ++i;
+        }
+    }
+
+    TRY(m_extents.try_insert(i, Extent { logical_block, 1, block_index, false }));
+
+    auto can_merge = [](Extent const& first, Extent const& second) {
+        return !first.is_uninitialized && !second.is_uninitialized
+            && first.end() == second.logical_block
+            && first.physical_block.value() + first.length == second.physical_block.value()
+            && first.length + second.length <= EXT4_EXT_INIT_MAX_LEN;
+    };
+    if (i + 1 < m_extents.size() && can_merge(m_extents[i], m_extents[i + 1])) {
+        m_extents[i].length += m_extents[i + 1].length;
+        m_extents.remove(i + 1);
+    }
+    if (i > 0 && can_merge(m_extents[i - 1], m_extents[i])) {
+        m_extents[i - 1].length += m_extents[i].length;
+        m_extents.remove(i);
+    }
+    return {};
+}
+
+ErrorOr<BlockBasedFileSystem::BlockIndex> Ext2FSInode::allocate_extent_block_for_write(u32 logical_block, bool zero_fill, bool allow_cache)
+{
+    BlockBasedFileSystem::BlockIndex block_index;
+    if (auto const* extent = find_extent(logical_block)) {
+        VERIFY(extent->is_uninitialized);
+        block_index = extent->physical_block.value() + (logical_block - extent->logical_block);
+    } else {
+        auto blocks = TRY(fs().allocate_blocks(fs().group_index_from_inode(index()), 1));
+        block_index = blocks.first();
+    }
+
+    // Whatever part of the block the write doesn't cover has to read back as zeroes.
+    if (zero_fill) {
+        u8 zero_buffer[max_block_size] {};
+        TRY(fs().write_block(block_index, UserOrKernelBuffer::for_kernel_buffer(zero_buffer), fs().logical_block_size(), 0, allow_cache));
+    }
+
+    TRY(map_extent_block(logical_block, block_index));
+    return block_index;
+}
+
+ErrorOr<void> Ext2FSInode::resize_extent_list(u64 old_block_count, u64 new_block_count)
+{
+    if (new_block_count > NumericLimits<u32>::max())
+        return EFBIG;
+
+    if (new_block_count > old_block_count) {
+        auto blocks = TRY(fs().allocate_blocks(fs().group_index_from_inode(index()), new_block_count - old_block_count));
+        for (size_t i = 0; i < blocks.size(); ++i)
+            TRY(map_extent_block(old_block_count + i, blocks[i]));
+    } else {
+        while (!m_extents.is_empty() && m_extents.last().end() > new_block_count) {
+            auto& extent = m_extents.last();
+            auto first_unused_block = max(static_cast<u64>(extent.logical_block), new_block_count);
+            for (u64 logical_block = first_unused_block; logical_block < extent.end(); ++logical_block) {
+                auto block_index = extent.physical_block.value() + (logical_block - extent.logical_block);
+                if (auto result = fs().set_block_allocation_state(block_index, false); result.is_error()) {
+                    dbgln("Ext2FSInode[{}]::resize_extent_list(): Failed to free block {}: {}", identifier(), block_index, result.error());
+                    return result;
+                }
+            }
+            if (first_unused_block == extent.logical_block)
+                m_extents.take_last();
+            else
+                extent.length = first_unused_block - extent.logical_block;
+        }
+    }
+
+    return flush_extent_tree();
+}
+
+static u32 first_logical_block_of(ext4_extent const& entry) { return entry.ee_block; }
+static u32 first_logical_block_of(ext4_extent_idx const& entry) { return entry.ei_block; }
+
+ErrorOr<void> Ext2FSInode::flush_extent_tree()
+{
+    VERIFY(uses_extents());
+    size_t const block_size = fs().logical_block_size();
+    size_t const entries_in_inode = (sizeof(m_raw_inode.i_block) - sizeof(ext4_extent_header)) / sizeof(ext4_extent);
+    size_t const entries_per_block = (block_size - sizeof(ext4_extent_header)) / sizeof(ext4_extent);
+
+    // Work out how many blocks we need for the tree, packing every node as tightly as we can.
+    size_t tree_block_count = 0;
+    u16 tree_depth = 0;
+    for (size_t entries = m_extents.size(); entries > entries_in_inode; ++tree_depth) {
+        if (tree_depth == EXT4_EXT_MAX_DEPTH)
+            return EFBIG;
+        entries = ceil_div(entries, entries_per_block);
+        tree_block_count += entries;
+    }
+
+    // Reuse the blocks of the previous tree where we can.
+    auto old_tree_block_count = m_extent_tree_blocks.size();
+    if (tree_block_count > old_tree_block_count) {
+        auto new_blocks = TRY(fs().allocate_blocks(fs().group_index_from_inode(index()), tree_block_count - old_tree_block_count));
+        TRY(m_extent_tree_blocks.try_extend(move(new_blocks)));
+    }
+    while (m_extent_tree_blocks.size() > tree_block_count)
+        TRY(fs().set_block_allocation_state(m_extent_tree_blocks.take_last(), false));
+
+    auto write_node = [](u8* node, size_t max_entries, u16 depth, auto entries) {
+        auto& header = *reinterpret_cast<ext4_extent_header*>(node);
+        header.eh_magic = EXT4_EXT_MAGIC;
+        header.eh_entries = entries.size();
+        header.eh_max = max_entries;
+        header.eh_depth = depth;
+        header.eh_generation = 0;
+        memcpy(node + sizeof(ext4_extent_header), entries.data(), entries.size() * sizeof(entries[0]));
+    };
+
+    auto node_contents = TRY(ByteBuffer::create_zeroed(block_size));
+    size_t next_tree_block = 0;
+    u16 depth = 0;
+    // Writes out the nodes of one level of the tree, and returns the index entries pointing at them.
+    auto write_level = [&](auto entries) -> ErrorOr<Vector<ext4_extent_idx>> {
+        Vector<ext4_extent_idx> parent_entries;
+        TRY(parent_entries.try_ensure_capacity(ceil_div(entries.size(), entries_per_block)));
+        for (size_t i = 0; i < entries.size(); i += entries_per_block) {
+            auto node_entries = entries.slice(i, min(entries_per_block, entries.size() - i));
+            auto block_index = m_extent_tree_blocks[next_tree_block++];
+            node_contents.zero_fill();
+            write_node(node_contents.data(), entries_per_block, depth, node_entries);
+            TRY(fs().journal_metadata_block(block_index));
+            TRY(fs().write_block(block_index, UserOrKernelBuffer::for_kernel_buffer(node_contents.data()), block_size));
+
+            ext4_extent_idx parent_entry {};
+            parent_entry.ei_block = first_logical_block_of(node_entries[0]);
+            parent_entry.ei_leaf_lo = block_index.value() & 0xffffffff;
+            parent_entry.ei_leaf_hi = block_index.value() >> 32;
+            parent_entries.unchecked_append(parent_entry);
+        }
+        ++depth;
+        return parent_entries;
+    };
+
+    Vector<ext4_extent> leaf_entries;
+    TRY(leaf_entries.try_ensure_capacity(m_extents.size()));
+    u64 data_block_count = 0;
+    for (auto const& extent : m_extents) {
+        ext4_extent entry {};
+        entry.ee_block = extent.logical_block;
+        entry.ee_len = extent.is_uninitialized ? extent.length + EXT4_EXT_INIT_MAX_LEN : extent.length;
+        entry.ee_start_lo = extent.physical_block.value() & 0xffffffff;
+        entry.ee_start_hi = extent.physical_block.value() >> 32;
+        leaf_entries.unchecked_append(entry);
+        data_block_count += extent.length;
+    }
+
+    memset(m_raw_inode.i_block, 0, sizeof(m_raw_inode.i_block));
+    auto* root = reinterpret_cast<u8*>(m_raw_inode.i_block);
+    if (tree_depth == 0) {
+        write_node(root, entries_in_inode, 0, leaf_entries.span());
+    } else {
+        auto index_entries = TRY(write_level(leaf_entries.span()));
+        while (depth < tree_depth)
+            index_entries = TRY(write_level(index_entries.span()));
+        write_node(root, entries_in_inode, depth, index_entries.span());
+    }
+    VERIFY(next_tree_block == tree_block_count);
+
+    dbgln_if(EXT2_BLOCKLIST_DEBUG, "Ext2FSInode[{}]::flush_extent_tree(): {} extents, tree depth {} with {} blocks", identifier(), m_extents.size(), tree_depth, tree_block_count);
+    m_raw_inode.i_blocks = (data_block_count + tree_block_count) * (block_size / 512);
+    set_metadata_dirty(true);
+    return {};
+}
+
+ErrorOr<void> Ext2FSInode::load_block_map()
+{
+    if (uses_extents()) {
+        if (m_extents.is_empty()) {
+            m_extent_tree_blocks.clear();
+            TRY(compute_extent_list(m_extents, m_extent_tree_blocks));
+        }
+        return {};
+    }
+    if (m_block_list.is_empty())
+        m_block_list = TRY(compute_block_list());
+    return {};
+}
+
+u64 Ext2FSInode::mapped_block_count() const
+{
+    if (uses_extents())
+        return ceil_div(size(), static_cast<u64>(fs().logical_block_size()));
+    return m_block_list.size();
+}
+
+BlockBasedFileSystem::BlockIndex Ext2FSInode::block_index_for(u64 logical_block) const
+{
+    if (!uses_extents())
+        return m_block_list[logical_block];
+    // NOTE: Both holes and uninitialized extents read back as zeroes, so we treat them the same here.
+    auto const* extent = find_extent(logical_block);
+    if (!extent || extent->is_uninitialized)
+        return 0;
+    return extent->physical_block.value() + (logical_block - extent->logical_block);
+}
+
 Ext2FSInode::Ext2FSInode(Ext2FS& fs, InodeIndex index)
     : Inode(fs, index)
 {
@@ -519,9 +814,7 @@ ErrorOr<void> Ext2FSInode::compute_block_list_with_exclusive_locking()
     // traversed, we use another exclusive lock to ensure we always mutate the block list safely.
     VERIFY(m_inode_lock.is_locked());
     MutexLocker block_list_locker(m_block_list_lock);
-    if (m_block_list.is_empty())
-        m_block_list = TRY(compute_block_list());
-    return {};
+    return load_block_map();
 }
 
 ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserOrKernelBuffer& buffer, OpenFileDescription* description) const
@@ -550,7 +843,8 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
     // shared mode.
     TRY(const_cast<Ext2FSInode&>(*this).compute_block_list_with_exclusive_locking());
 
-    if (m_block_list.is_empty()) {
+    auto block_count = mapped_block_count();
+    if (block_count == 0) {
         dmesgln("Ext2FSInode[{}]::read_bytes(): Empty block list", identifier());
         return EIO;
     }
@@ -561,8 +855,8 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
 
     BlockBasedFileSystem::BlockIndex first_block_logical_index = offset / block_size;
     BlockBasedFileSystem::BlockIndex last_block_logical_index = (offset + count) / block_size;
-    if (last_block_logical_index >= m_block_list.size())
-        last_block_logical_index = m_block_list.size() - 1;
+    if (last_block_logical_index >= block_count)
+        last_block_logical_index = block_count - 1;
 
     int offset_into_first_block = offset % block_size;
 
@@ -572,7 +866,7 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
     dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::read_bytes(): Reading up to {} bytes, {} bytes into inode to {}", identifier(), count, offset, buffer.user_or_kernel_ptr());
 
     for (auto bi = first_block_logical_index; remaining_count && bi <= last_block_logical_index; bi = bi.value() + 1) {
-        auto block_index = m_block_list[bi.value()];
+        auto block_index = block_index_for(bi.value());
         size_t offset_into_block = (bi == first_block_logical_index) ? offset_into_first_block : 0;
         size_t num_bytes_to_copy = min((size_t)block_size - offset_into_block, (size_t)remaining_count);
         auto buffer_offset = buffer.offset(nread);
@@ -592,6 +886,40 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
     return nread;
 }
 
+ErrorOr<void> Ext2FSInode::prefetch_locked(off_t offset, size_t count) const
+{
+    VERIFY(m_inode_lock.is_locked());
+    VERIFY(offset >= 0);
+    if (!Kernel::is_regular_file(m_raw_inode.i_mode) || count == 0 || static_cast<u64>(offset) >= size())
+        return {};
+    count = min(count, static_cast<size_t>(size() - offset));
+
+    TRY(const_cast<Ext2FSInode&>(*this).compute_block_list_with_exclusive_locking());
+    auto block_count = mapped_block_count();
+    if (block_count == 0)
+        return {};
+
+    size_t const block_size = fs().logical_block_size();
+    u64 first_block_logical_index = offset / block_size;
+    u64 last_block_logical_index = min((offset + count - 1) / block_size, block_count - 1);
+
+    // Blocks that are next to each other on disk can be fetched with a single read.
+    for (u64 logical_index = first_block_logical_index; logical_index <= last_block_logical_index;) {
+        auto block_index = block_index_for(logical_index);
+        if (block_index.value() == 0) {
+            // This is a hole, there's nothing to fetch.
+            ++logical_index;
+            continue;
+        }
+        size_t run_length = 1;
+        while (logical_index + run_length <= last_block_logical_index && block_index_for(logical_index + run_length).value() == block_index.value() + run_length)
+            ++run_length;
+        TRY(fs().prefetch_blocks(block_index, run_length));
+        logical_index += run_length;
+    }
+    return {};
+}
+
 ErrorOr<void> Ext2FSInode::resize(u64 new_size)
 {
     VERIFY(m_inode_lock.is_locked());
@@ -617,10 +945,12 @@ ErrorOr<void> Ext2FSInode::resize(u64 new_size)
             return ENOSPC;
     }
 
-    if (m_block_list.is_empty())
-        m_block_list = TRY(compute_block_list());
+    TRY(load_block_map());
 
-    if (blocks_needed_after > blocks_needed_before) {
+    if (uses_extents()) {
+        if (blocks_needed_after != blocks_needed_before)
+            TRY(resize_extent_list(blocks_needed_before, blocks_needed_after));
+    } else if (blocks_needed_after > blocks_needed_before) {
         auto blocks = TRY(fs().allocate_blocks(fs().group_index_from_inode(index()), blocks_needed_after - blocks_needed_before));
         TRY(m_block_list.try_extend(move(blocks)));
     } else if (blocks_needed_after < blocks_needed_before) {
@@ -641,7 +971,8 @@ ErrorOr<void> Ext2FSInode::resize(u64 new_size)
         }
     }
 
-    TRY(flush_block_list());
+    if (!uses_extents())
+        TRY(flush_block_list());
 
     m_raw_inode.i_size = new_size;
     if (Kernel::is_regular_file(m_raw_inode.i_mode))
@@ -693,18 +1024,18 @@ ErrorOr<size_t> Ext2FSInode::write_bytes_locked(off_t offset, size_t count, User
 
     TRY(resize(new_size));
 
-    if (m_block_list.is_empty())
-        m_block_list = TRY(compute_block_list());
+    TRY(load_block_map());
 
-    if (m_block_list.is_empty()) {
+    auto block_count = mapped_block_count();
+    if (block_count == 0) {
         dbgln("Ext2FSInode[{}]::write_bytes(): Empty block list", identifier());
         return EIO;
     }
 
     BlockBasedFileSystem::BlockIndex first_block_logical_index = offset / block_size;
     BlockBasedFileSystem::BlockIndex last_block_logical_index = (offset + count) / block_size;
-    if (last_block_logical_index >= m_block_list.size())
-        last_block_logical_index = m_block_list.size() - 1;
+    if (last_block_logical_index >= block_count)
+        last_block_logical_index = block_count - 1;
 
     size_t offset_into_first_block = offset % block_size;
 
@@ -713,21 +1044,34 @@ ErrorOr<size_t> Ext2FSInode::write_bytes_locked(off_t offset, size_t count, User
 
     dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::write_bytes_locked(): Writing {} bytes, {} bytes into inode from {}", identifier(), count, offset, data.user_or_kernel_ptr());
 
+    bool extent_tree_dirty = false;
     for (auto bi = first_block_logical_index; remaining_count && bi <= last_block_logical_index; bi = bi.value() + 1) {
         size_t offset_into_block = (bi == first_block_logical_index) ? offset_into_first_block : 0;
         size_t num_bytes_to_copy = min((size_t)block_size - offset_into_block, (size_t)remaining_count);
-        dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::write_bytes_locked(): Writing block {} (offset_into_block: {})", identifier(), m_block_list[bi.value()], offset_into_block);
-        if (auto result = fs().write_block(m_block_list[bi.value()], data.offset(nwritten), num_bytes_to_copy, offset_into_block, allow_cache); result.is_error()) {
-            dbgln("Ext2FSInode[{}]::write_bytes_locked(): Failed to write block {} (index {})", identifier(), m_block_list[bi.value()], bi);
+        auto block_index = block_index_for(bi.value());
+        if (block_index.value() == 0 && uses_extents()) {
+            // This is a hole or an uninitialized extent, so it needs a block we can write to first.
+            block_index = TRY(allocate_extent_block_for_write(bi.value(), num_bytes_to_copy != (size_t)block_size, allow_cache));
+            extent_tree_dirty = true;
+        }
+        dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::write_bytes_locked(): Writing block {} (offset_into_block: {})", identifier(), block_index, offset_into_block);
+        // The contents of directories are metadata too, unlike those of regular files.
+        if (is_directory())
+            TRY(fs().journal_metadata_block(block_index));
+        if (auto result = fs().write_block(block_index, data.offset(nwritten), num_bytes_to_copy, offset_into_block, allow_cache); result.is_error()) {
+            dbgln("Ext2FSInode[{}]::write_bytes_locked(): Failed to write block {} (index {})", identifier(), block_index, bi);
             return result.release_error();
         }
         remaining_count -= num_bytes_to_copy;
         nwritten += num_bytes_to_copy;
     }
 
+    if (extent_tree_dirty)
+        TRY(flush_extent_tree());
+
     did_modify_contents();
 
-    dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::write_bytes_locked(): After write, i_size={}, i_blocks={} ({} blocks in list)", identifier(), size(), m_raw_inode.i_blocks, m_block_list.size());
+    dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::write_bytes_locked(): After write, i_size={}, i_blocks={} ({} blocks mapped)", identifier(), size(), m_raw_inode.i_blocks, mapped_block_count());
     return nwritten;
 }
 
@@ -792,6 +1136,17 @@ ErrorOr<void> Ext2FSInode::write_directory(Vector<Ext2FSDirectoryEntry>& entries
         directory_size += entry.record_length;
     }
 
+    // Directories that outgrow a single block get an index, so that lookups don't have to scan all of them.
+    if (directory_size > block_size && has_flag(fs().get_features_optional(), Ext2FS::FeaturesOptional::DirectoryIndex)
+        && entries.size() >= 2 && entries[0].name->view() == "."sv && entries[1].name->view() == ".."sv) {
+        if (TRY(write_indexed_directory(entries)))
+            return {};
+    }
+    if (m_raw_inode.i_flags & EXT2_INDEX_FL) {
+        m_raw_inode.i_flags &= ~EXT2_INDEX_FL;
+        set_metadata_dirty(true);
+    }
+
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::write_directory(): New directory contents to write (size {}):", identifier(), directory_size);
 
     auto directory_data = TRY(ByteBuffer::create_uninitialized(directory_size));
@@ -824,6 +1179,513 @@ ErrorOr<void> Ext2FSInode::write_directory(Vector<Ext2FSDirectoryEntry>& entries
     return {};
 }
 
+// The upper bits of the block numbers in the index are reserved for future use.
+static constexpr u32 directory_index_block_mask = 0x0fffffff;
+// "." and ".." (with room for the dx_root_info behind it) come first in the root of an index.
+static constexpr size_t directory_index_root_info_offset = 24;
+// Blocks of the index below the root pretend to be a single unused directory entry.
+static constexpr size_t directory_index_node_entries_offset = 8;
+
+static void write_directory_entry(Bytes block, size_t offset, u32 inode, u16 record_length, StringView name, u8 file_type)
+{
+    auto* entry = reinterpret_cast<ext2_dir_entry_2*>(block.offset_pointer(offset));
+    entry->inode = inode;
+    entry->rec_len = record_length;
+    entry->name_len = name.length();
+    entry->file_type = file_type;
+    memcpy(entry->name, name.characters_without_null_termination(), name.length());
+    memset(entry->name + name.length(), 0, record_length - 8 - name.length());
+}
+
+template<typename Callback>
+static void for_each_entry_in_directory_block(Bytes block, Callback callback)
+{
+    size_t offset = 0;
+    while (offset + 8 <= block.size()) {
+        auto& entry = *reinterpret_cast<ext2_dir_entry_2*>(block.offset_pointer(offset));
+        // Don't trust what we read from disk, a bogus record length would have us wander off the end of the block.
+        if (entry.rec_len < 8 || offset + entry.rec_len > block.size() || EXT2_DIR_REC_LEN(entry.name_len) > entry.rec_len)
+            return;
+        if (callback(offset, entry) == IterationDecision::Break)
+            return;
+        offset += entry.rec_len;
+    }
+}
+
+static Optional<size_t> find_entry_in_directory_block(Bytes block, StringView name)
+{
+    Optional<size_t> result;
+    for_each_entry_in_directory_block(block, [&](size_t offset, ext2_dir_entry_2& entry) {
+        if (entry.inode == 0 || StringView { entry.name, entry.name_len } != name)
+            return IterationDecision::Continue;
+        result = offset;
+        return IterationDecision::Break;
+    });
+    return result;
+}
+
+static bool add_entry_to_directory_block(Bytes block, StringView name, u32 inode, u8 file_type)
+{
+    size_t needed_length = EXT2_DIR_REC_LEN(name.length());
+    bool added = false;
+    for_each_entry_in_directory_block(block, [&](size_t offset, ext2_dir_entry_2& entry) {
+        size_t used_length = entry.inode != 0 ? EXT2_DIR_REC_LEN(entry.name_len) : 0;
+        if (entry.rec_len < used_length + needed_length)
+            return IterationDecision::Continue;
+        if (used_length != 0) {
+            u16 remaining_length = entry.rec_len - used_length;
+            entry.rec_len = used_length;
+            write_directory_entry(block, offset + used_length, inode, remaining_length, name, file_type);
+        } else {
+            write_directory_entry(block, offset, inode, entry.rec_len, name, file_type);
+        }
+        added = true;
+        return IterationDecision::Break;
+    });
+    return added;
+}
+
+static void remove_entry_from_directory_block(Bytes block, size_t offset)
+{
+    Optional<size_t> previous_offset;
+    for_each_entry_in_directory_block(block, [&](size_t entry_offset, ext2_dir_entry_2&) {
+        if (entry_offset == offset)
+            return IterationDecision::Break;
+        previous_offset = entry_offset;
+        return IterationDecision::Continue;
+    });
+
+    auto& entry = *reinterpret_cast<ext2_dir_entry_2*>(block.offset_pointer(offset));
+    if (previous_offset.has_value())
+        reinterpret_cast<ext2_dir_entry_2*>(block.offset_pointer(*previous_offset))->rec_len += entry.rec_len;
+    else
+        entry.inode = 0;
+}
+
+static void initialize_directory_index_node(Bytes block, size_t limit)
+{
+    write_directory_entry(block, 0, 0, block.size(), ""sv, EXT2_FT_UNKNOWN);
+    auto& count_limit = *reinterpret_cast<ext2_dx_countlimit*>(block.offset_pointer(directory_index_node_entries_offset));
+    count_limit.limit = limit;
+    count_limit.count = 0;
+}
+
+static void insert_directory_index_entry(ext2_dx_countlimit& count_limit, size_t index, u32 hash, u32 block)
+{
+    VERIFY(index > 0 && index <= count_limit.count && count_limit.count < count_limit.limit);
+    auto* entries = reinterpret_cast<ext2_dx_entry*>(&count_limit);
+    memmove(entries + index + 1, entries + index, (count_limit.count - index) * sizeof(ext2_dx_entry));
+    entries[index] = { hash, block };
+    ++count_limit.count;
+}
+
+bool Ext2FSInode::has_directory_index() const
+{
+    return is_directory() && (m_raw_inode.i_flags & EXT2_INDEX_FL) && has_flag(fs().get_features_optional(), Ext2FS::FeaturesOptional::DirectoryIndex);
+}
+
+ErrorOr<void> Ext2FSInode::read_directory_block(u32 block, Bytes data)
+{
+    auto block_size = fs().logical_block_size();
+    VERIFY(data.size() == block_size);
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(data.data());
+    auto nread = TRY(read_bytes(static_cast<u64>(block) * block_size, block_size, buffer, nullptr));
+    if (nread != block_size)
+        return EIO;
+    return {};
+}
+
+ErrorOr<void> Ext2FSInode::write_directory_block(u32 block, ReadonlyBytes data)
+{
+    auto block_size = fs().logical_block_size();
+    VERIFY(data.size() == block_size);
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(const_cast<u8*>(data.data()));
+    auto nwritten = TRY(prepare_and_write_bytes_locked(static_cast<u64>(block) * block_size, block_size, buffer, nullptr));
+    set_metadata_dirty(true);
+    if (nwritten != block_size)
+        return EIO;
+    return {};
+}
+
+Optional<Ext2FSDirectoryHash> Ext2FSInode::directory_index_hash(StringView name, u8 hash_version) const
+{
+    auto const& super_block = fs().super_block();
+    // Whether the legacy, half MD4 and TEA hashes treat names as signed or unsigned chars depends on where the filesystem was created.
+    if (hash_version <= EXT2_HASH_TEA && (super_block.s_flags & EXT2_FLAGS_UNSIGNED_HASH))
+        hash_version += EXT2_HASH_LEGACY_UNSIGNED;
+    return ext2_directory_hash(name, hash_version, super_block.s_hash_seed);
+}
+
+ErrorOr<Optional<Ext2FSInode::DirectoryIndexPath>> Ext2FSInode::probe_directory_index(StringView name)
+{
+    VERIFY(m_inode_lock.is_exclusively_locked_by_current_thread());
+    auto block_size = fs().logical_block_size();
+    if (!has_directory_index() || size() < block_size)
+        return Optional<DirectoryIndexPath> {};
+
+    auto root_data = TRY(ByteBuffer::create_uninitialized(block_size));
+    TRY(read_directory_block(0, root_data));
+    auto const& root_info = *reinterpret_cast<ext2_dx_root_info const*>(root_data.offset_pointer(directory_index_root_info_offset));
+    // NOTE: Indexes deeper than one level below the root (the "largedir" feature) aren't supported, we fall back to scanning those.
+    if (root_info.reserved_zero != 0 || root_info.info_length != sizeof(ext2_dx_root_info) || root_info.indirect_levels > 1) {
+        dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::probe_directory_index(): Unsupported directory index, ignoring it", identifier());
+        return Optional<DirectoryIndexPath> {};
+    }
+
+    DirectoryIndexPath path;
+    path.hash_version = root_info.hash_version;
+    auto hash = directory_index_hash(name, path.hash_version);
+    if (!hash.has_value())
+        return Optional<DirectoryIndexPath> {};
+    path.hash = hash.release_value();
+
+    size_t indirect_levels = root_info.indirect_levels;
+    TRY(path.frames.try_append({ 0, move(root_data), directory_index_root_info_offset + sizeof(ext2_dx_root_info), 0 }));
+    while (true) {
+        auto& frame = path.frames.last();
+        auto const& count_limit = frame.count_limit();
+        // NOTE: With metadata checksums the limit leaves room for a checksum tail, which we don't maintain, so we ignore those indexes.
+        if (count_limit.limit != (block_size - frame.entries_offset) / sizeof(ext2_dx_entry) || count_limit.count == 0 || count_limit.count > count_limit.limit) {
+            dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::probe_directory_index(): Bad index block {}, ignoring the index", identifier(), frame.block);
+            return Optional<DirectoryIndexPath> {};
+        }
+
+        // Find the last entry whose hash isn't larger than ours, the first entry covers all hashes below the second one.
+        auto* entries = frame.entries();
+        size_t low = 1;
+        size_t high = count_limit.count;
+        while (low < high) {
+            auto middle = low + (high - low) / 2;
+            if (entries[middle].hash > path.hash.hash)
+                high = middle;
+            else
+                low = middle + 1;
+        }
+        frame.at = low - 1;
+
+        if (path.frames.size() > indirect_levels)
+            break;
+        u32 child_block = entries[frame.at].block & directory_index_block_mask;
+        auto child_data = TRY(ByteBuffer::create_uninitialized(block_size));
+        TRY(read_directory_block(child_block, child_data));
+        TRY(path.frames.try_append({ child_block, move(child_data), directory_index_node_entries_offset, 0 }));
+    }
+    return path;
+}
+
+ErrorOr<bool> Ext2FSInode::advance_directory_index(DirectoryIndexPath& path)
+{
+    auto level = path.frames.size();
+    while (level > 0 && path.frames[level - 1].at + 1 >= path.frames[level - 1].count_limit().count)
+        --level;
+    if (level == 0)
+        return false;
+
+    // Names with the same hash may have been split across leaves, in which case the index
+    // marks the next leaf by setting the lowest bit of its hash. Otherwise, we're done.
+    auto& frame = path.frames[level - 1];
+    ++frame.at;
+    if ((frame.entries()[frame.at].hash & ~1u) != path.hash.hash)
+        return false;
+
+    for (; level < path.frames.size(); ++level) {
+        auto& parent = path.frames[level - 1];
+        auto& child = path.frames[level];
+        child.block = parent.entries()[parent.at].block & directory_index_block_mask;
+        child.at = 0;
+        TRY(read_directory_block(child.block, child.data));
+        auto const& count_limit = child.count_limit();
+        if (count_limit.limit != (child.data.size() - child.entries_offset) / sizeof(ext2_dx_entry) || count_limit.count == 0 || count_limit.count > count_limit.limit)
+            return EIO;
+    }
+    return true;
+}
+
+ErrorOr<Optional<Ext2FSInode::DirectoryEntryLocation>> Ext2FSInode::find_indexed_directory_entry(DirectoryIndexPath& path, StringView name)
+{
+    // "." and ".." aren't part of the index, they are always the first two entries of the root block.
+    if (name == "."sv || name == ".."sv) {
+        auto& root = path.frames.first();
+        auto offset = find_entry_in_directory_block(root.data, name);
+        if (!offset.has_value())
+            return Optional<DirectoryEntryLocation> {};
+        return DirectoryEntryLocation { 0, move(root.data), *offset };
+    }
+
+    auto leaf = TRY(ByteBuffer::create_uninitialized(fs().logical_block_size()));
+    do {
+        auto& frame = path.frames.last();
+        u32 leaf_block = frame.entries()[frame.at].block & directory_index_block_mask;
+        TRY(read_directory_block(leaf_block, leaf));
+        if (auto offset = find_entry_in_directory_block(leaf, name); offset.has_value())
+            return DirectoryEntryLocation { leaf_block, move(leaf), *offset };
+    } while (TRY(advance_directory_index(path)));
+
+    return Optional<DirectoryEntryLocation> {};
+}
+
+ErrorOr<bool> Ext2FSInode::make_room_in_directory_index(DirectoryIndexPath& path)
+{
+    auto block_size = fs().logical_block_size();
+    auto& bottom = path.frames.last();
+    if (bottom.count_limit().count < bottom.count_limit().limit)
+        return true;
+
+    size_t node_limit = (block_size - directory_index_node_entries_offset) / sizeof(ext2_dx_entry);
+    u32 new_block = size() / block_size;
+    auto new_data = TRY(ByteBuffer::create_zeroed(block_size));
+    initialize_directory_index_node(new_data, node_limit);
+    auto& new_count_limit = *reinterpret_cast<ext2_dx_countlimit*>(new_data.offset_pointer(directory_index_node_entries_offset));
+    auto* new_entries = reinterpret_cast<ext2_dx_entry*>(&new_count_limit);
+
+    if (path.frames.size() == 1) {
+        // The root is full, move all of its entries into a new node below it.
+        auto& root = path.frames[0];
+        auto count = root.count_limit().count;
+        memcpy(new_entries, root.entries(), count * sizeof(ext2_dx_entry));
+        new_count_limit = { static_cast<u16>(node_limit), count };
+        TRY(write_directory_block(new_block, new_data));
+
+        root.count_limit().count = 1;
+        root.entries()[0].block = new_block;
+        reinterpret_cast<ext2_dx_root_info*>(root.data.offset_pointer(directory_index_root_info_offset))->indirect_levels = 1;
+        TRY(write_directory_block(0, root.data));
+
+        DirectoryIndexFrame node { new_block, move(new_data), directory_index_node_entries_offset, root.at };
+        root.at = 0;
+        TRY(path.frames.try_append(move(node)));
+        return true;
+    }
+
+    // A node below the root is full, split it in half if the root has room for another one.
+    auto& root = path.frames[0];
+    auto& node = path.frames[1];
+    if (root.count_limit().count >= root.count_limit().limit)
+        return false;
+
+    size_t count = node.count_limit().count;
+    size_t half = count / 2;
+    u32 separator_hash = node.entries()[half].hash;
+    memcpy(new_entries, node.entries() + half, (count - half) * sizeof(ext2_dx_entry));
+    new_count_limit = { static_cast<u16>(node_limit), static_cast<u16>(count - half) };
+    node.count_limit().count = half;
+    insert_directory_index_entry(root.count_limit(), root.at + 1, separator_hash, new_block);
+
+    TRY(write_directory_block(new_block, new_data));
+    TRY(write_directory_block(node.block, node.data));
+    TRY(write_directory_block(0, root.data));
+
+    if (node.at >= half) {
+        ++root.at;
+        node.block = new_block;
+        node.data = move(new_data);
+        node.at -= half;
+    }
+    return true;
+}
+
+ErrorOr<bool> Ext2FSInode::add_indexed_directory_entry(StringView name, InodeIndex inode_index, u8 file_type)
+{
+    auto path = TRY(probe_directory_index(name));
+    if (!path.has_value())
+        return false;
+
+    {
+        auto lookup_path = TRY(probe_directory_index(name));
+        VERIFY(lookup_path.has_value());
+        if (TRY(find_indexed_directory_entry(*lookup_path, name)).has_value())
+            return EEXIST;
+    }
+
+    auto block_size = fs().logical_block_size();
+    u32 leaf_block = path->frames.last().entries()[path->frames.last().at].block & directory_index_block_mask;
+    auto leaf = TRY(ByteBuffer::create_uninitialized(block_size));
+    TRY(read_directory_block(leaf_block, leaf));
+    if (add_entry_to_directory_block(leaf, name, inode_index.value(), file_type)) {
+        TRY(write_directory_block(leaf_block, leaf));
+        return true;
+    }
+
+    // The leaf is full, so split it in two halves by hash, which needs another entry in the index.
+    if (!TRY(make_room_in_directory_index(*path))) {
+        dbgln("Ext2FSInode[{}]::add_indexed_directory_entry(): Directory index is full", identifier());
+        return ENOSPC;
+    }
+
+    struct LeafEntry {
+        u32 hash;
+        size_t offset;
+        size_t length;
+    };
+    Vector<LeafEntry> leaf_entries;
+    size_t total_length = 0;
+    ErrorOr<void> result {};
+    for_each_entry_in_directory_block(leaf, [&](size_t offset, ext2_dir_entry_2& entry) {
+        if (entry.inode == 0)
+            return IterationDecision::Continue;
+        auto hash = directory_index_hash({ entry.name, entry.name_len }, path->hash_version);
+        VERIFY(hash.has_value());
+        size_t length = EXT2_DIR_REC_LEN(entry.name_len);
+        total_length += length;
+        result = leaf_entries.try_append({ hash->hash, offset, length });
+        return result.is_error() ? IterationDecision::Break : IterationDecision::Continue;
+    });
+    TRY(result);
+    VERIFY(leaf_entries.size() >= 2);
+    quick_sort(leaf_entries, [](auto& a, auto& b) { return a.hash < b.hash; });
+
+    size_t split = 0;
+    size_t left_length = 0;
+    while (split + 1 < leaf_entries.size() && left_length + leaf_entries[split].length <= total_length / 2)
+        left_length += leaf_entries[split++].length;
+    if (split == 0)
+        split = 1;
+
+    auto left = TRY(ByteBuffer::create_zeroed(block_size));
+    auto right = TRY(ByteBuffer::create_zeroed(block_size));
+    auto fill_leaf = [&](Bytes block, Span<LeafEntry const> entries) {
+        size_t offset = 0;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            auto const& entry = *reinterpret_cast<ext2_dir_entry_2 const*>(leaf.offset_pointer(entries[i].offset));
+            u16 record_length = i + 1 < entries.size() ? entries[i].length : block.size() - offset;
+            write_directory_entry(block, offset, entry.inode, record_length, { entry.name, entry.name_len }, entry.file_type);
+            offset += record_length;
+        }
+    };
+    fill_leaf(left, leaf_entries.span().slice(0, split));
+    fill_leaf(right, leaf_entries.span().slice(split));
+
+    // If the split went through a run of equal hashes, lookups have to continue into the right half.
+    u32 split_hash = leaf_entries[split].hash;
+    bool continued = split_hash == leaf_entries[split - 1].hash;
+    auto& bottom = path->frames.last();
+    u32 new_leaf_block = size() / block_size;
+    insert_directory_index_entry(bottom.count_limit(), bottom.at + 1, split_hash + continued, new_leaf_block);
+
+    auto added = add_entry_to_directory_block(path->hash.hash >= split_hash ? right.bytes() : left.bytes(), name, inode_index.value(), file_type);
+    VERIFY(added);
+
+    TRY(write_directory_block(new_leaf_block, right));
+    TRY(write_directory_block(leaf_block, left));
+    TRY(write_directory_block(bottom.block, bottom.data));
+    return true;
+}
+
+ErrorOr<bool> Ext2FSInode::write_indexed_directory(Vector<Ext2FSDirectoryEntry>& entries)
+{
+    VERIFY(entries.size() >= 2 && entries[0].name->view() == "."sv && entries[1].name->view() == ".."sv);
+    auto block_size = fs().logical_block_size();
+
+    u8 hash_version = fs().super_block().s_def_hash_version;
+    if (hash_version > EXT2_HASH_TEA)
+        hash_version = EXT2_HASH_HALF_MD4;
+
+    struct IndexedEntry {
+        Ext2FSDirectoryHash hash;
+        Ext2FSDirectoryEntry const* entry;
+    };
+    Vector<IndexedEntry> sorted_entries;
+    TRY(sorted_entries.try_ensure_capacity(entries.size() - 2));
+    for (size_t i = 2; i < entries.size(); ++i) {
+        auto hash = directory_index_hash(entries[i].name->view(), hash_version);
+        VERIFY(hash.has_value());
+        sorted_entries.unchecked_append({ hash.release_value(), &entries[i] });
+    }
+    quick_sort(sorted_entries, [](auto& a, auto& b) {
+        return a.hash.hash < b.hash.hash || (a.hash.hash == b.hash.hash && a.hash.minor_hash < b.hash.minor_hash);
+    });
+
+    // Leave a quarter of every leaf unused, so that adding entries doesn't have to split leaves right away.
+    Vector<size_t> leaf_starts;
+    size_t used_in_leaf = 0;
+    for (size_t i = 0; i < sorted_entries.size(); ++i) {
+        size_t length = EXT2_DIR_REC_LEN(sorted_entries[i].entry->name->length());
+        if (leaf_starts.is_empty() || used_in_leaf + length > block_size * 3 / 4) {
+            TRY(leaf_starts.try_append(i));
+            used_in_leaf = 0;
+        }
+        used_in_leaf += length;
+    }
+    if (leaf_starts.is_empty())
+        return false;
+
+    size_t root_entries_offset = directory_index_root_info_offset + sizeof(ext2_dx_root_info);
+    size_t root_limit = (block_size - root_entries_offset) / sizeof(ext2_dx_entry);
+    size_t node_limit = (block_size - directory_index_node_entries_offset) / sizeof(ext2_dx_entry);
+    size_t leaf_count = leaf_starts.size();
+    size_t node_count = leaf_count <= root_limit ? 0 : ceil_div(leaf_count, node_limit);
+    if (node_count > root_limit)
+        return false;
+
+    dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::write_indexed_directory(): {} entries in {} leaves, {} index nodes", identifier(), entries.size(), leaf_count, node_count);
+
+    auto directory_data = TRY(ByteBuffer::create_zeroed((1 + node_count + leaf_count) * block_size));
+    auto block_at = [&](size_t block) { return directory_data.bytes().slice(block * block_size, block_size); };
+    auto leaf_block = [&](size_t leaf) { return static_cast<u32>(1 + node_count + leaf); };
+    auto leaf_hash = [&](size_t leaf) {
+        auto first = leaf_starts[leaf];
+        u32 hash = sorted_entries[first].hash.hash;
+        // Mark leaves that continue a run of equal hashes from the previous one.
+        if (first > 0 && sorted_entries[first - 1].hash.hash == hash)
+            hash |= 1;
+        return hash;
+    };
+    auto fill_index = [&](ext2_dx_countlimit& count_limit, size_t limit, size_t first_leaf, size_t count) {
+        auto* index_entries = reinterpret_cast<ext2_dx_entry*>(&count_limit);
+        for (size_t i = 0; i < count; ++i)
+            index_entries[i] = { leaf_hash(first_leaf + i), leaf_block(first_leaf + i) };
+        count_limit = { static_cast<u16>(limit), static_cast<u16>(count) };
+    };
+
+    auto root = block_at(0);
+    write_directory_entry(root, 0, entries[0].inode_index.value(), 12, "."sv, entries[0].file_type);
+    write_directory_entry(root, 12, entries[1].inode_index.value(), block_size - 12, ".."sv, entries[1].file_type);
+    *reinterpret_cast<ext2_dx_root_info*>(root.offset_pointer(directory_index_root_info_offset)) = {
+        .reserved_zero = 0,
+        .hash_version = hash_version,
+        .info_length = sizeof(ext2_dx_root_info),
+        .indirect_levels = static_cast<u8>(node_count > 0 ? 1 : 0),
+        .unused_flags = 0,
+    };
+    auto& root_count_limit = *reinterpret_cast<ext2_dx_countlimit*>(root.offset_pointer(root_entries_offset));
+
+    if (node_count == 0) {
+        fill_index(root_count_limit, root_limit, 0, leaf_count);
+    } else {
+        auto* root_entries = reinterpret_cast<ext2_dx_entry*>(&root_count_limit);
+        for (size_t node = 0; node < node_count; ++node) {
+            auto node_data = block_at(1 + node);
+            auto first_leaf = node * node_limit;
+            initialize_directory_index_node(node_data, node_limit);
+            fill_index(*reinterpret_cast<ext2_dx_countlimit*>(node_data.offset_pointer(directory_index_node_entries_offset)), node_limit, first_leaf, min(node_limit, leaf_count - first_leaf));
+            root_entries[node] = { leaf_hash(first_leaf), static_cast<u32>(1 + node) };
+        }
+        root_count_limit = { static_cast<u16>(root_limit), static_cast<u16>(node_count) };
+    }
+
+    for (size_t leaf = 0; leaf < leaf_count; ++leaf) {
+        auto leaf_data = block_at(leaf_block(leaf));
+        auto end = leaf + 1 < leaf_count ? leaf_starts[leaf + 1] : sorted_entries.size();
+        size_t offset = 0;
+        for (size_t i = leaf_starts[leaf]; i < end; ++i) {
+            auto const& entry = *sorted_entries[i].entry;
+            u16 record_length = i + 1 < end ? EXT2_DIR_REC_LEN(entry.name->length()) : block_size - offset;
+            write_directory_entry(leaf_data, offset, entry.inode_index.value(), record_length, entry.name->view(), entry.file_type);
+            offset += record_length;
+        }
+    }
+
+    TRY(resize(directory_data.size()));
+
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(directory_data.data());
+    auto nwritten = TRY(prepare_and_write_bytes_locked(0, directory_data.size(), buffer, nullptr));
+    m_raw_inode.i_flags |= EXT2_INDEX_FL;
+    set_metadata_dirty(true);
+    if (nwritten != directory_data.size())
+        return EIO;
+    return true;
+}
+
 ErrorOr<NonnullRefPtr<Inode>> Ext2FSInode::create_child(StringView name, mode_t mode, dev_t dev, UserID uid, GroupID gid)
 {
     if (Kernel::is_directory(mode))
@@ -842,6 +1704,16 @@ ErrorOr<void> Ext2FSInode::add_child(Inode& child, StringView name, mode_t mode)
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::add_child(): Adding inode {} with name '{}' and mode {:o} to directory {}", identifier(), child.index(), name, mode, index());
     bool has_file_type_attribute = has_flag(fs().get_features_optional(), Ext2FS::FeaturesOptional::ExtendedAttributes);
 
+    if (TRY(add_indexed_directory_entry(name, child.index(), has_file_type_attribute ? to_ext2_file_type(mode) : (u8)EXT2_FT_UNKNOWN))) {
+        TRY(child.increment_link_count());
+        if (!m_lookup_cache.is_empty()) {
+            auto cache_entry_name = TRY(KString::try_create(name));
+            TRY(m_lookup_cache.try_set(move(cache_entry_name), child.index()));
+        }
+        did_add_child(child.identifier(), name);
+        return {};
+    }
+
     Vector<Ext2FSDirectoryEntry> entries;
     TRY(traverse_as_directory([&](auto& entry) -> ErrorOr<void> {
         if (name == entry.name)
@@ -871,6 +1743,27 @@ ErrorOr<void> Ext2FSInode::remove_child(StringView name)
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::remove_child(): Removing '{}'", identifier(), name);
     VERIFY(is_directory());
 
+    // NOTE: "." and ".." share the root block with the index, so removing them goes through write_directory().
+    if (name != "."sv && name != ".."sv) {
+        if (auto path = TRY(probe_directory_index(name)); path.has_value()) {
+            auto location = TRY(find_indexed_directory_entry(*path, name));
+            if (!location.has_value())
+                return ENOENT;
+            InodeIdentifier child_id { fsid(), reinterpret_cast<ext2_dir_entry_2 const*>(location->data.offset_pointer(location->offset))->inode };
+            remove_entry_from_directory_block(location->data, location->offset);
+            TRY(write_directory_block(location->block, location->data));
+
+            if (auto it = m_lookup_cache.find(name); it != m_lookup_cache.end())
+                m_lookup_cache.remove(it);
+
+            auto child_inode = TRY(fs().get_inode(child_id));
+            TRY(child_inode->decrement_link_count());
+
+            did_remove_child(child_id, name);
+            return {};
+        }
+    }
+
     TRY(populate_lookup_cache());
 
     auto it = m_lookup_cache.find(name);
@@ -907,14 +1800,39 @@ ErrorOr<void> Ext2FSInode::replace_child(StringView name, Inode& child)
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::replace_child(): Replacing '{}' with inode {}", identifier(), name, child.index());
     VERIFY(is_directory());
 
-    TRY(populate_lookup_cache());
-
     if (name.length() > EXT2_NAME_LEN)
         return ENAMETOOLONG;
 
-    Vector<Ext2FSDirectoryEntry> entries;
     bool has_file_type_attribute = has_flag(fs().get_features_optional(), Ext2FS::FeaturesOptional::ExtendedAttributes);
 
+    if (auto path = TRY(probe_directory_index(name)); path.has_value()) {
+        auto location = TRY(find_indexed_directory_entry(*path, name));
+        if (!location.has_value())
+            return ENOENT;
+        auto& entry = *reinterpret_cast<ext2_dir_entry_2*>(location->data.offset_pointer(location->offset));
+        auto old_child = TRY(fs().get_inode({ fsid(), entry.inode }));
+
+        TRY(child.increment_link_count());
+        auto maybe_decrement_error = old_child->decrement_link_count();
+        if (maybe_decrement_error.is_error()) {
+            MUST(child.decrement_link_count());
+            return maybe_decrement_error;
+        }
+
+        // FIXME: Like below, the link counts are left inconsistent if this fails.
+        entry.inode = child.index().value();
+        entry.file_type = has_file_type_attribute ? to_ext2_file_type(child.mode()) : (u8)EXT2_FT_UNKNOWN;
+        TRY(write_directory_block(location->block, location->data));
+
+        if (auto it = m_lookup_cache.find(name); it != m_lookup_cache.end())
+            it->value = child.index();
+        return {};
+    }
+
+    TRY(populate_lookup_cache());
+
+    Vector<Ext2FSDirectoryEntry> entries;
+
     Optional<InodeIndex> old_child_index;
     TRY(traverse_as_directory([&](auto& entry) -> ErrorOr<void> {
         auto is_replacing_this_inode = name == entry.name;
@@ -985,13 +1903,28 @@ ErrorOr<NonnullRefPtr<Inode>> Ext2FSInode::lookup(StringView name)
     InodeIndex inode_index;
     {
         MutexLocker locker(m_inode_lock);
-        TRY(populate_lookup_cache());
-        auto it = m_lookup_cache.find(name);
-        if (it == m_lookup_cache.end()) {
-            dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]:lookup(): '{}' not found", identifier(), name);
-            return ENOENT;
+
+        // Indexed directories can be searched without reading (and caching) all of their entries.
+        Optional<DirectoryIndexPath> path;
+        if (m_lookup_cache.is_empty())
+            path = TRY(probe_directory_index(name));
+
+        if (path.has_value()) {
+            auto location = TRY(find_indexed_directory_entry(*path, name));
+            if (!location.has_value()) {
+                dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]:lookup(): '{}' not found", identifier(), name);
+                return ENOENT;
+            }
+            inode_index = reinterpret_cast<ext2_dir_entry_2 const*>(location->data.offset_pointer(location->offset))->inode;
+        } else {
+            TRY(populate_lookup_cache());
+            auto it = m_lookup_cache.find(name);
+            if (it == m_lookup_cache.end()) {
+                dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]:lookup(): '{}' not found", identifier(), name);
+                return ENOENT;
+            }
+            inode_index = it->value;
         }
-        inode_index = it->value;
     }
 
     return fs().get_inode({ fsid(), inode_index });
@@ -1087,13 +2020,12 @@ ErrorOr<int> Ext2FSInode::get_block_address(int index)
 {
     MutexLocker locker(m_inode_lock);
 
-    if (m_block_list.is_empty())
-        m_block_list = TRY(compute_block_list());
+    TRY(load_block_map());
 
-    if (index < 0 || (size_t)index >= m_block_list.size())
+    if (index < 0 || (u64)index >= mapped_block_count())
         return 0;
 
-    return m_block_list[index].value();
+    return block_index_for(index).value();
 }
 
 }
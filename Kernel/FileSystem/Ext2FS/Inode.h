@@ -9,6 +9,7 @@
 #include <AK/HashMap.h>
 #include <Kernel/FileSystem/Ext2FS/Definitions.h>
 #include <Kernel/FileSystem/Ext2FS/DirectoryEntry.h>
+#include <Kernel/FileSystem/Ext2FS/DirectoryIndex.h>
 #include <Kernel/FileSystem/Ext2FS/FileSystem.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/UnixTypes.h>
@@ -28,6 +29,7 @@ public:
 private:
     // ^Inode
     virtual ErrorOr<size_t> read_bytes_locked(off_t, size_t, UserOrKernelBuffer& buffer, OpenFileDescription*) const override;
+    virtual ErrorOr<void> prefetch_locked(off_t, size_t) const override;
     virtual InodeMetadata metadata() const override;
     virtual ErrorOr<void> traverse_as_directory(Function<ErrorOr<void>(FileSystem::DirectoryEntryView const&)>) const override;
     virtual ErrorOr<NonnullRefPtr<Inode>> lookup(StringView name) override;
@@ -47,6 +49,40 @@ private:
 
     ErrorOr<void> write_directory(Vector<Ext2FSDirectoryEntry>&);
     ErrorOr<void> populate_lookup_cache();
+
+    // Indexed ("htree") directories keep a tree of name hashes in their first block(s), pointing at the
+    // leaf blocks holding the directory entries of each hash range, so that we don't have to scan all of them.
+    struct DirectoryIndexFrame {
+        u32 block { 0 };
+        ByteBuffer data;
+        size_t entries_offset { 0 };
+        size_t at { 0 };
+
+        ext2_dx_countlimit& count_limit() { return *reinterpret_cast<ext2_dx_countlimit*>(data.data() + entries_offset); }
+        ext2_dx_entry* entries() { return reinterpret_cast<ext2_dx_entry*>(data.data() + entries_offset); }
+    };
+    struct DirectoryIndexPath {
+        Ext2FSDirectoryHash hash;
+        u8 hash_version { 0 };
+        // The root comes first, the last frame points at the leaf block.
+        Vector<DirectoryIndexFrame, 2> frames;
+    };
+    struct DirectoryEntryLocation {
+        u32 block { 0 };
+        ByteBuffer data;
+        size_t offset { 0 };
+    };
+
+    bool has_directory_index() const;
+    ErrorOr<void> read_directory_block(u32 block, Bytes);
+    ErrorOr<void> write_directory_block(u32 block, ReadonlyBytes);
+    Optional<Ext2FSDirectoryHash> directory_index_hash(StringView name, u8 hash_version) const;
+    ErrorOr<Optional<DirectoryIndexPath>> probe_directory_index(StringView name);
+    ErrorOr<bool> advance_directory_index(DirectoryIndexPath&);
+    ErrorOr<Optional<DirectoryEntryLocation>> find_indexed_directory_entry(DirectoryIndexPath&, StringView name);
+    ErrorOr<bool> add_indexed_directory_entry(StringView name, InodeIndex, u8 file_type);
+    ErrorOr<bool> make_room_in_directory_index(DirectoryIndexPath&);
+    ErrorOr<bool> write_indexed_directory(Vector<Ext2FSDirectoryEntry>&);
     ErrorOr<void> resize(u64);
     ErrorOr<void> write_indirect_block(BlockBasedFileSystem::BlockIndex, Span<BlockBasedFileSystem::BlockIndex>);
     ErrorOr<void> grow_doubly_indirect_block(BlockBasedFileSystem::BlockIndex, size_t, Span<BlockBasedFileSystem::BlockIndex>, Vector<BlockBasedFileSystem::BlockIndex>&, unsigned&);
@@ -55,6 +91,30 @@ private:
     ErrorOr<void> shrink_triply_indirect_block(BlockBasedFileSystem::BlockIndex, size_t, size_t, unsigned&);
     ErrorOr<void> flush_block_list();
 
+    // A run of logically and physically contiguous blocks of an inode that maps its blocks through an extent tree.
+    struct Extent {
+        u32 logical_block { 0 };
+        u32 length { 0 };
+        BlockBasedFileSystem::BlockIndex physical_block { 0 };
+        // Uninitialized extents have their blocks allocated already, but read back as zeroes.
+        bool is_uninitialized { false };
+
+        u32 end() const { return logical_block + length; }
+    };
+
+    bool uses_extents() const { return m_raw_inode.i_flags & EXT4_EXTENTS_FL; }
+    ErrorOr<void> compute_extent_list(Vector<Extent>&, Vector<BlockBasedFileSystem::BlockIndex>& extent_tree_blocks) const;
+    ErrorOr<void> read_extent_tree_node(ReadonlyBytes, u16 depth, Vector<Extent>&, Vector<BlockBasedFileSystem::BlockIndex>& extent_tree_blocks) const;
+    Extent const* find_extent(u32 logical_block) const;
+    ErrorOr<void> map_extent_block(u32 logical_block, BlockBasedFileSystem::BlockIndex);
+    ErrorOr<BlockBasedFileSystem::BlockIndex> allocate_extent_block_for_write(u32 logical_block, bool zero_fill, bool allow_cache);
+    ErrorOr<void> resize_extent_list(u64 old_block_count, u64 new_block_count);
+    ErrorOr<void> flush_extent_tree();
+
+    ErrorOr<void> load_block_map();
+    u64 mapped_block_count() const;
+    BlockBasedFileSystem::BlockIndex block_index_for(u64 logical_block) const;
+
     ErrorOr<void> compute_block_list_with_exclusive_locking();
     ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> compute_block_list() const;
     ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> compute_block_list_with_meta_blocks() const;
@@ -65,7 +125,10 @@ private:
     Ext2FS const& fs() const;
     Ext2FSInode(Ext2FS&, InodeIndex);
 
+    // Inodes that use extents keep their extents and the blocks holding the extent tree instead of a block list.
     Vector<BlockBasedFileSystem::BlockIndex> m_block_list;
+    Vector<Extent> m_extents;
+    Vector<BlockBasedFileSystem::BlockIndex> m_extent_tree_blocks;
     HashMap<NonnullOwnPtr<KString>, InodeIndex> m_lookup_cache;
     ext2_inode m_raw_inode {};
 
@@ -0,0 +1,440 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/HashMap.h>
+#include <AK/QuickSort.h>
+#include <AK/ScopeGuard.h>
+#include <Kernel/FileSystem/Ext2FS/FileSystem.h>
+#include <Kernel/FileSystem/Ext2FS/Journal.h>
+
+namespace Kernel {
+
+// The high 32 bits of the block number are only there if the journal has the 64-bit feature. Version 3 checksum
+// tags have a 32-bit flags field instead of the 16-bit checksum, the low half of which is where the flags are anyway.
+struct [[gnu::packed]] JBD2BlockTag {
+    BigEndian<u32> block_number;
+    BigEndian<u16> checksum;
+    BigEndian<u16> flags;
+    BigEndian<u32> block_number_high;
+};
+
+static constexpr size_t jbd2_uuid_size = 16;
+
+// Journal features we can both replay and write transactions for.
+static constexpr u32 writable_incompat_features = jbd2_feature_incompat_revoke | jbd2_feature_incompat_64bit;
+// Checksums are not verified during the replay, so a journal with these can still be recovered.
+static constexpr u32 recoverable_incompat_features = writable_incompat_features | jbd2_feature_incompat_async_commit | jbd2_feature_incompat_csum_v2 | jbd2_feature_incompat_csum_v3;
+
+ErrorOr<NonnullOwnPtr<Ext2FSJournal>> Ext2FSJournal::try_create(Ext2FS& fs, Vector<BlockIndex> journal_blocks)
+{
+    if (journal_blocks.is_empty())
+        return EINVAL;
+    auto super_block_buffer = TRY(ByteBuffer::create_zeroed(fs.logical_block_size()));
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(super_block_buffer.data());
+    TRY(fs.read_block(journal_blocks[0], &buffer, fs.logical_block_size(), 0, false));
+
+    auto const& super_block = *reinterpret_cast<JBD2SuperBlock const*>(super_block_buffer.data());
+    if (super_block.header.magic != jbd2_magic_number) {
+        dmesgln("Ext2FS: Bad journal super block magic");
+        return EINVAL;
+    }
+    auto type = static_cast<JBD2BlockType>(static_cast<u32>(super_block.header.block_type));
+    if (type != JBD2BlockType::SuperBlockV1 && type != JBD2BlockType::SuperBlockV2) {
+        dmesgln("Ext2FS: Unknown journal super block type {}", static_cast<u32>(type));
+        return EINVAL;
+    }
+    if (super_block.block_size != fs.logical_block_size()) {
+        dmesgln("Ext2FS: Journal block size {} doesn't match the file system's", static_cast<u32>(super_block.block_size));
+        return EINVAL;
+    }
+    if (super_block.first == 0 || super_block.first >= super_block.max_length || super_block.max_length > journal_blocks.size()) {
+        dmesgln("Ext2FS: Journal super block describes a log that doesn't fit into the journal inode");
+        return EINVAL;
+    }
+    if (super_block.start != 0 && (super_block.start < super_block.first || super_block.start >= super_block.max_length)) {
+        dmesgln("Ext2FS: Journal starts outside of its log");
+        return EINVAL;
+    }
+    if (type == JBD2BlockType::SuperBlockV2 && super_block.start != 0 && (super_block.feature_incompat & ~recoverable_incompat_features) != 0) {
+        dmesgln("Ext2FS: Journal needs recovery, but uses unsupported features {:#x}", static_cast<u32>(super_block.feature_incompat));
+        return ENOTSUP;
+    }
+
+    return adopt_nonnull_own_or_enomem(new (nothrow) Ext2FSJournal(fs, move(journal_blocks), move(super_block_buffer)));
+}
+
+Ext2FSJournal::Ext2FSJournal(Ext2FS& fs, Vector<BlockIndex> journal_blocks, ByteBuffer super_block_buffer)
+    : m_fs(fs)
+    , m_journal_blocks(move(journal_blocks))
+    , m_super_block(move(super_block_buffer))
+{
+    auto const& super_block = this->super_block();
+    m_first = super_block.first;
+    m_last = super_block.max_length;
+    m_start = super_block.start;
+    m_head = m_start ? m_start : m_first;
+    m_sequence = super_block.sequence;
+
+    if (static_cast<JBD2BlockType>(static_cast<u32>(super_block.header.block_type)) == JBD2BlockType::SuperBlockV1) {
+        m_is_writable = true;
+    } else {
+        m_is_writable = (super_block.feature_incompat & ~writable_incompat_features) == 0
+            && (super_block.feature_compat & jbd2_feature_compat_checksum) == 0
+            && super_block.feature_ro_compat == 0;
+    }
+}
+
+u32 Ext2FSJournal::incompat_features() const
+{
+    if (static_cast<JBD2BlockType>(static_cast<u32>(super_block().header.block_type)) == JBD2BlockType::SuperBlockV1)
+        return 0;
+    return super_block().feature_incompat;
+}
+
+size_t Ext2FSJournal::tag_size() const
+{
+    auto features = incompat_features();
+    if (features & jbd2_feature_incompat_csum_v3)
+        return 16;
+    size_t size = 8;
+    if (features & jbd2_feature_incompat_csum_v2)
+        size += 2;
+    if (features & jbd2_feature_incompat_64bit)
+        size += 4;
+    return size;
+}
+
+size_t Ext2FSJournal::tags_per_descriptor() const
+{
+    // The first tag is followed by the UUID of the file system, the others say that it's the same.
+    return (m_fs.logical_block_size() - sizeof(JBD2Header) - jbd2_uuid_size) / tag_size();
+}
+
+u32 Ext2FSJournal::free_block_count() const
+{
+    if (!m_start)
+        return capacity() - 1;
+    auto used = m_head >= m_start ? m_head - m_start : capacity() - (m_start - m_head);
+    // One block always stays free, otherwise a full journal would look like an empty one.
+    return capacity() - used - 1;
+}
+
+size_t Ext2FSJournal::max_metadata_blocks_in_transaction(u32 free_blocks) const
+{
+    // A transaction needs a descriptor block for every tags_per_descriptor() blocks, and a commit block.
+    if (free_blocks < 3)
+        return 0;
+    auto tags = tags_per_descriptor();
+    size_t count = (free_blocks - 1) * tags / (tags + 1);
+    while (count > 0 && count + ceil_div(count, tags) + 1 > free_blocks)
+        --count;
+    return count;
+}
+
+ErrorOr<void> Ext2FSJournal::read_journal_block(u32 position, Bytes bytes) const
+{
+    VERIFY(bytes.size() == m_fs.logical_block_size());
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(bytes.data());
+    return m_fs.read_block(m_journal_blocks[position], &buffer, bytes.size(), 0, false);
+}
+
+ErrorOr<void> Ext2FSJournal::write_journal_block(u32 position, u8 const* data)
+{
+    // NOTE: The journal bypasses the disk cache, its blocks have to be on the disk before anything else is written back.
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(const_cast<u8*>(data));
+    return m_fs.write_block(m_journal_blocks[position], buffer, m_fs.logical_block_size(), 0, false);
+}
+
+ErrorOr<void> Ext2FSJournal::write_super_block()
+{
+    auto& super_block = this->super_block();
+    super_block.start = m_start;
+    super_block.sequence = m_sequence;
+    return write_journal_block(0, m_super_block.data());
+}
+
+ErrorOr<void> Ext2FSJournal::mark_clean()
+{
+    if (!m_start)
+        return {};
+    m_start = 0;
+    m_head = m_first;
+    return write_super_block();
+}
+
+template<typename Callback>
+void Ext2FSJournal::for_each_tag(ReadonlyBytes descriptor, Callback callback) const
+{
+    auto tag_size = this->tag_size();
+    bool has_64bit_block_numbers = incompat_features() & jbd2_feature_incompat_64bit;
+    size_t offset = sizeof(JBD2Header);
+    while (offset + tag_size <= descriptor.size()) {
+        JBD2BlockTag tag {};
+        memcpy(&tag, descriptor.offset_pointer(offset), min(tag_size, sizeof(tag)));
+        offset += tag_size;
+
+        auto flags = static_cast<JBD2TagFlags>(static_cast<u16>(tag.flags));
+        u64 block_number = tag.block_number;
+        if (has_64bit_block_numbers)
+            block_number |= static_cast<u64>(tag.block_number_high) << 32;
+        if (!has_flag(flags, JBD2TagFlags::SameUUID))
+            offset += jbd2_uuid_size;
+
+        callback(BlockIndex { block_number }, flags);
+        if (has_flag(flags, JBD2TagFlags::LastTag))
+            break;
+    }
+}
+
+ErrorOr<void> Ext2FSJournal::recover()
+{
+    if (!m_start)
+        return {};
+
+    auto block_size = m_fs.logical_block_size();
+    auto block = TRY(ByteBuffer::create_uninitialized(block_size));
+    auto const& header = *reinterpret_cast<JBD2Header const*>(block.data());
+    auto is_log_block = [&](u32 sequence) {
+        return header.magic == jbd2_magic_number && header.sequence == sequence;
+    };
+
+    // Pass 1: Find the end of the log, which is the first transaction that wasn't committed in full,
+    //         and what blocks committed transactions revoked (their earlier copies must not be replayed).
+    HashMap<BlockIndex, u32> revoked_blocks;
+    Vector<BlockIndex> pending_revokes;
+    auto first_sequence = m_sequence;
+    auto end_sequence = m_sequence;
+    {
+        auto position = m_start;
+        auto sequence = m_sequence;
+        for (u32 count = 0; count < capacity(); ++count) {
+            TRY(read_journal_block(position, block.bytes()));
+            if (!is_log_block(sequence))
+                break;
+            auto type = static_cast<JBD2BlockType>(static_cast<u32>(header.block_type));
+            if (type == JBD2BlockType::Descriptor) {
+                size_t tag_count = 0;
+                for_each_tag(block.bytes(), [&](auto, auto) { ++tag_count; });
+                position = next_position(position);
+                for (size_t i = 0; i < tag_count; ++i)
+                    position = next_position(position);
+                continue;
+            }
+            if (type == JBD2BlockType::Revoke) {
+                auto const& revoke_header = *reinterpret_cast<JBD2RevokeHeader const*>(block.data());
+                size_t record_size = (incompat_features() & jbd2_feature_incompat_64bit) ? 8 : 4;
+                size_t end = min<size_t>(revoke_header.count, block_size);
+                for (size_t offset = sizeof(JBD2RevokeHeader); offset + record_size <= end; offset += record_size) {
+                    u64 block_number = *reinterpret_cast<BigEndian<u32> const*>(block.offset_pointer(offset));
+                    if (record_size == 8)
+                        block_number = (block_number << 32) | *reinterpret_cast<BigEndian<u32> const*>(block.offset_pointer(offset + 4));
+                    TRY(pending_revokes.try_append(block_number));
+                }
+                position = next_position(position);
+                continue;
+            }
+            if (type != JBD2BlockType::Commit)
+                break;
+
+            for (auto revoked_block : pending_revokes)
+                TRY(revoked_blocks.try_set(revoked_block, sequence));
+            pending_revokes.clear_with_capacity();
+            position = next_position(position);
+            end_sequence = ++sequence;
+        }
+    }
+    dmesgln("Ext2FS: Replaying journal transactions {} to {}", first_sequence, end_sequence);
+
+    // Pass 2: Write out the blocks of all committed transactions, in order.
+    m_is_recovering = true;
+    ScopeGuard recovering_guard = [&] { m_is_recovering = false; };
+    {
+        auto position = m_start;
+        auto sequence = m_sequence;
+        auto data = TRY(ByteBuffer::create_uninitialized(block_size));
+        while (sequence != end_sequence) {
+            TRY(read_journal_block(position, block.bytes()));
+            if (!is_log_block(sequence))
+                return EIO;
+            position = next_position(position);
+
+            auto type = static_cast<JBD2BlockType>(static_cast<u32>(header.block_type));
+            if (type == JBD2BlockType::Commit) {
+                ++sequence;
+                continue;
+            }
+            if (type != JBD2BlockType::Descriptor)
+                continue;
+
+            struct Tag {
+                BlockIndex target;
+                JBD2TagFlags flags;
+            };
+            Vector<Tag> tags;
+            ErrorOr<void> result {};
+            for_each_tag(block.bytes(), [&](BlockIndex target, JBD2TagFlags flags) {
+                if (!result.is_error())
+                    result = tags.try_append({ target, flags });
+            });
+            TRY(result);
+
+            for (auto [target, flags] : tags) {
+                auto data_position = position;
+                position = next_position(position);
+                if (auto revoked_in = revoked_blocks.get(target); revoked_in.has_value() && *revoked_in >= sequence)
+                    continue;
+                if (target.value() == 0 || target >= m_fs.super_block().s_blocks_count) {
+                    dmesgln("Ext2FS: Journal refers to invalid block {}", target);
+                    return EINVAL;
+                }
+                TRY(read_journal_block(data_position, data.bytes()));
+                if (has_flag(flags, JBD2TagFlags::Escape))
+                    *reinterpret_cast<BigEndian<u32>*>(data.data()) = jbd2_magic_number;
+                TRY(m_fs.write_block(target, UserOrKernelBuffer::for_kernel_buffer(data.data()), block_size));
+            }
+        }
+    }
+
+    // Everything we replayed has to be in place before the journal may forget about it.
+    m_fs.flush_writes_impl();
+    m_sequence = end_sequence;
+    return mark_clean();
+}
+
+ErrorOr<void> Ext2FSJournal::add_metadata_block(BlockIndex block)
+{
+    return m_metadata_blocks.with([&](auto& metadata_blocks) -> ErrorOr<void> {
+        TRY(metadata_blocks.try_set(block));
+        return {};
+    });
+}
+
+ErrorOr<void> Ext2FSJournal::write_transaction(ReadonlySpan<BlockIndex> blocks, Function<u8 const*(BlockIndex)> const& dirty_block_data)
+{
+    auto block_size = m_fs.logical_block_size();
+    auto tag_size = this->tag_size();
+    auto tags_per_descriptor = this->tags_per_descriptor();
+    auto descriptor = TRY(ByteBuffer::create_zeroed(block_size));
+    auto escaped_data = TRY(ByteBuffer::create_uninitialized(block_size));
+
+    auto write_header = [&](JBD2BlockType type) {
+        descriptor.zero_fill();
+        auto& header = *reinterpret_cast<JBD2Header*>(descriptor.data());
+        header.magic = jbd2_magic_number;
+        header.block_type = to_underlying(type);
+        header.sequence = m_sequence;
+    };
+
+    auto first_position = m_head;
+    auto position = m_head;
+    for (size_t i = 0; i < blocks.size();) {
+        auto tag_count = min(blocks.size() - i, tags_per_descriptor);
+        write_header(JBD2BlockType::Descriptor);
+        auto descriptor_position = position;
+        position = next_position(position);
+
+        size_t offset = sizeof(JBD2Header);
+        for (size_t j = 0; j < tag_count; ++j) {
+            auto block = blocks[i + j];
+            auto const* data = dirty_block_data(block);
+            VERIFY(data);
+
+            JBD2TagFlags flags {};
+            if (j != 0)
+                flags |= JBD2TagFlags::SameUUID;
+            if (j == tag_count - 1)
+                flags |= JBD2TagFlags::LastTag;
+            // A block starting with the magic number would look like one of our own, so it has to be escaped.
+            if (*reinterpret_cast<BigEndian<u32> const*>(data) == jbd2_magic_number) {
+                memcpy(escaped_data.data(), data, block_size);
+                memset(escaped_data.data(), 0, sizeof(u32));
+                data = escaped_data.data();
+                flags |= JBD2TagFlags::Escape;
+            }
+            TRY(write_journal_block(position, data));
+            position = next_position(position);
+
+            JBD2BlockTag tag {};
+            tag.block_number = block.value() & 0xffffffff;
+            tag.flags = to_underlying(flags);
+            tag.block_number_high = block.value() >> 32;
+            memcpy(descriptor.offset_pointer(offset), &tag, tag_size);
+            offset += tag_size;
+            if (j == 0) {
+                memcpy(descriptor.offset_pointer(offset), super_block().uuid, jbd2_uuid_size);
+                offset += jbd2_uuid_size;
+            }
+        }
+        TRY(write_journal_block(descriptor_position, descriptor.data()));
+        i += tag_count;
+    }
+
+    // Only once the commit block is on the disk does the transaction count.
+    write_header(JBD2BlockType::Commit);
+    TRY(write_journal_block(position, descriptor.data()));
+    position = next_position(position);
+
+    // From now on, a replay starts with this transaction, the previous one was written back in full already.
+    m_start = first_position;
+    TRY(write_super_block());
+    m_head = position;
+    ++m_sequence;
+    return {};
+}
+
+ErrorOr<void> Ext2FSJournal::commit_impl(ReadonlySpan<BlockIndex> blocks, Function<u8 const*(BlockIndex)> const& dirty_block_data)
+{
+    // With no metadata changes, there is nothing to commit. Still, the previous transaction must not be replayed
+    // over blocks that might have been freed and reused for file contents since.
+    if (blocks.is_empty())
+        return mark_clean();
+
+    while (!blocks.is_empty()) {
+        auto count = min(blocks.size(), max_metadata_blocks_in_transaction(free_block_count()));
+        if (count < blocks.size() && m_start) {
+            // The previous transaction is in place already, so we can make room by dropping it.
+            TRY(mark_clean());
+            continue;
+        }
+        if (count == 0)
+            return ENOSPC;
+
+        auto transaction_blocks = blocks.slice(0, count);
+        TRY(write_transaction(transaction_blocks, dirty_block_data));
+        blocks = blocks.slice(count);
+        if (blocks.is_empty())
+            break;
+
+        // The rest doesn't fit into the journal alongside this transaction, so we have to write it back ourselves
+        // before the next transaction may overwrite it.
+        for (auto block : transaction_blocks)
+            TRY(m_fs.write_block(block, UserOrKernelBuffer::for_kernel_buffer(const_cast<u8*>(dirty_block_data(block))), m_fs.logical_block_size(), 0, false));
+        TRY(mark_clean());
+    }
+    return {};
+}
+
+void Ext2FSJournal::commit(Function<u8 const*(BlockIndex)> const& dirty_block_data)
+{
+    if (!m_is_writable || m_is_recovering)
+        return;
+
+    // Blocks that were added but aren't dirty (yet) stay around for the next transaction.
+    Vector<BlockIndex> blocks;
+    m_metadata_blocks.with([&](auto& metadata_blocks) {
+        metadata_blocks.remove_all_matching([&](BlockIndex block) {
+            if (!dirty_block_data(block))
+                return false;
+            return !blocks.try_append(block).is_error();
+        });
+    });
+    quick_sort(blocks);
+
+    if (auto result = commit_impl(blocks, dirty_block_data); result.is_error())
+        dbgln("Ext2FS[{}]: Failed to commit {} blocks to the journal: {}", m_fs.fsid(), blocks.size(), result.error());
+}
+
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Endian.h>
+#include <AK/Function.h>
+#include <AK/HashTable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Vector.h>
+#include <Kernel/FileSystem/BlockBasedFileSystem.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+
+namespace Kernel {
+
+class Ext2FS;
+
+// The on-disk format of the journal ext3 and ext4 keep in an inode of the file system ("JBD2"), everything in it is big endian.
+static constexpr u32 jbd2_magic_number = 0xc03b3998;
+
+enum class JBD2BlockType : u32 {
+    Descriptor = 1,
+    Commit = 2,
+    SuperBlockV1 = 3,
+    SuperBlockV2 = 4,
+    Revoke = 5,
+};
+
+enum class JBD2TagFlags : u16 {
+    // The first four bytes of the block were the magic number, and have been zeroed in the journal.
+    Escape = 1,
+    SameUUID = 2,
+    Deleted = 4,
+    LastTag = 8,
+};
+AK_ENUM_BITWISE_OPERATORS(JBD2TagFlags);
+
+static constexpr u32 jbd2_feature_compat_checksum = 0x1;
+static constexpr u32 jbd2_feature_incompat_revoke = 0x1;
+static constexpr u32 jbd2_feature_incompat_64bit = 0x2;
+static constexpr u32 jbd2_feature_incompat_async_commit = 0x4;
+static constexpr u32 jbd2_feature_incompat_csum_v2 = 0x8;
+static constexpr u32 jbd2_feature_incompat_csum_v3 = 0x10;
+
+struct [[gnu::packed]] JBD2Header {
+    BigEndian<u32> magic;
+    BigEndian<u32> block_type;
+    BigEndian<u32> sequence;
+};
+
+struct [[gnu::packed]] JBD2SuperBlock {
+    JBD2Header header;
+
+    BigEndian<u32> block_size;
+    // Total number of blocks in the journal, and the first one that holds log entries.
+    BigEndian<u32> max_length;
+    BigEndian<u32> first;
+
+    // The first transaction that still has to be replayed, there is nothing to do if start is zero.
+    BigEndian<u32> sequence;
+    BigEndian<u32> start;
+
+    BigEndian<u32> error;
+
+    // Only valid in version 2 superblocks.
+    BigEndian<u32> feature_compat;
+    BigEndian<u32> feature_incompat;
+    BigEndian<u32> feature_ro_compat;
+    u8 uuid[16];
+};
+
+struct [[gnu::packed]] JBD2RevokeHeader {
+    JBD2Header header;
+    // The number of bytes of the block in use, including this header.
+    BigEndian<u32> count;
+};
+
+// A metadata journal in the style of ext3's, every flush of the disk cache commits the metadata blocks
+// that changed since the last one as a single transaction before any of them is overwritten in place.
+// After a crash, replaying the last transaction brings the metadata back into a consistent state,
+// so that the file system doesn't have to be checked in full.
+class Ext2FSJournal {
+    AK_MAKE_NONCOPYABLE(Ext2FSJournal);
+    AK_MAKE_NONMOVABLE(Ext2FSJournal);
+
+public:
+    using BlockIndex = BlockBasedFileSystem::BlockIndex;
+
+    // The blocks of the journal inode, in logical order.
+    static ErrorOr<NonnullOwnPtr<Ext2FSJournal>> try_create(Ext2FS&, Vector<BlockIndex> journal_blocks);
+
+    bool needs_recovery() const { return m_start != 0; }
+    ErrorOr<void> recover();
+
+    // We don't know how to produce the checksums some journal features call for, such journals are only replayed.
+    bool is_writable() const { return m_is_writable; }
+
+    // Has to be called before a metadata block is modified, so that it becomes part of the next transaction.
+    ErrorOr<void> add_metadata_block(BlockIndex);
+
+    // Called whenever the disk cache is about to write back its dirty blocks. `dirty_block_data` returns
+    // the contents of a block that is about to be written, or null if it isn't dirty.
+    void commit(Function<u8 const*(BlockIndex)> const& dirty_block_data);
+
+    // Marks the journal as not holding anything that needs to be replayed.
+    ErrorOr<void> mark_clean();
+
+private:
+    Ext2FSJournal(Ext2FS&, Vector<BlockIndex> journal_blocks, ByteBuffer super_block);
+
+    JBD2SuperBlock& super_block() { return *reinterpret_cast<JBD2SuperBlock*>(m_super_block.data()); }
+    JBD2SuperBlock const& super_block() const { return *reinterpret_cast<JBD2SuperBlock const*>(m_super_block.data()); }
+
+    u32 incompat_features() const;
+    size_t tag_size() const;
+    size_t tags_per_descriptor() const;
+    u32 capacity() const { return m_last - m_first; }
+    u32 free_block_count() const;
+    u32 next_position(u32 position) const { return position + 1 == m_last ? m_first : position + 1; }
+    size_t max_metadata_blocks_in_transaction(u32 free_blocks) const;
+
+    ErrorOr<void> read_journal_block(u32 position, Bytes) const;
+    ErrorOr<void> write_journal_block(u32 position, u8 const* data);
+    ErrorOr<void> write_super_block();
+    ErrorOr<void> write_transaction(ReadonlySpan<BlockIndex> blocks, Function<u8 const*(BlockIndex)> const& dirty_block_data);
+    ErrorOr<void> commit_impl(ReadonlySpan<BlockIndex> blocks, Function<u8 const*(BlockIndex)> const& dirty_block_data);
+
+    template<typename Callback>
+    void for_each_tag(ReadonlyBytes descriptor, Callback) const;
+
+    Ext2FS& m_fs;
+    Vector<BlockIndex> m_journal_blocks;
+    ByteBuffer m_super_block;
+
+    // Positions in the journal are logical block numbers of the journal inode, the log lives in [m_first, m_last).
+    u32 m_first { 0 };
+    u32 m_last { 0 };
+    // Where the transaction that would be replayed after a crash starts, zero if there is none.
+    u32 m_start { 0 };
+    // Where the next transaction is written to, and its sequence number.
+    u32 m_head { 0 };
+    u32 m_sequence { 0 };
+    bool m_is_writable { false };
+    // Replayed blocks are written back like any other, but mustn't end up in the journal again.
+    bool m_is_recovering { false };
+
+    SpinlockProtected<HashTable<BlockIndex>, LockRank::None> m_metadata_blocks {};
+};
+
+}
@@ -12,6 +12,37 @@
 
 namespace Kernel {
 
+FileBlockerSet::Listener::Listener(OpenFileDescription& description)
+    : m_blocker_set(description.blocker_set())
+    , m_description(&description)
+{
+}
+
+RefPtr<OpenFileDescription> FileBlockerSet::Listener::description()
+{
+    return m_blocker_set.m_listeners.with([&](auto&) -> RefPtr<OpenFileDescription> {
+        // The description may already be on its way out, in which case it has to be left alone.
+        if (!m_description || !m_description->try_ref())
+            return nullptr;
+        return adopt_ref(*m_description);
+    });
+}
+
+void FileBlockerSet::remove_listeners_for(OpenFileDescription const& description)
+{
+    m_listeners.with([&](auto& listeners) {
+        for (auto it = listeners.begin(); it != listeners.end();) {
+            auto& listener = *it;
+            ++it;
+            if (listener.m_description != &description)
+                continue;
+            listeners.remove(listener);
+            listener.m_description = nullptr;
+            listener.file_state_may_have_changed();
+        }
+    });
+}
+
 File::File() = default;
 File::~File() = default;
 
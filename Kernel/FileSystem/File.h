@@ -8,12 +8,15 @@
 
 #include <AK/AtomicRefCounted.h>
 #include <AK/Error.h>
+#include <AK/IntrusiveList.h>
+#include <AK/RefPtr.h>
 #include <AK/StringView.h>
 #include <AK/Types.h>
 #include <Kernel/Forward.h>
 #include <Kernel/Library/LockWeakable.h>
 #include <Kernel/Library/NonnullLockRefPtr.h>
 #include <Kernel/Library/UserOrKernelBuffer.h>
+#include <Kernel/Locking/SpinlockProtected.h>
 #include <Kernel/Memory/VirtualAddress.h>
 #include <Kernel/UnixTypes.h>
 
@@ -23,8 +26,38 @@ class File;
 
 class FileBlockerSet final : public Thread::BlockerSet {
 public:
+    // Unlike a blocker, a listener isn't tied to a blocked thread and stays around until it is removed again.
+    // It is told every time the state of the file may have changed, which is what epoll is built on.
+    class Listener {
+    public:
+        // Called with the listeners of the file locked, so this must not do much more than take note.
+        virtual void file_state_may_have_changed() = 0;
+
+        // Returns null once the description is being destroyed, the listener is told about that one last time.
+        RefPtr<OpenFileDescription> description();
+
+    protected:
+        // The listener has to keep the file that it listens to alive.
+        explicit Listener(OpenFileDescription&);
+        virtual ~Listener() = default;
+
+        FileBlockerSet& blocker_set() { return m_blocker_set; }
+
+    private:
+        friend class FileBlockerSet;
+
+        FileBlockerSet& m_blocker_set;
+        OpenFileDescription* m_description { nullptr };
+        IntrusiveListNode<Listener> m_list_node;
+    };
+
     FileBlockerSet() { }
 
+    virtual ~FileBlockerSet() override
+    {
+        VERIFY(m_listeners.with([](auto& listeners) { return listeners.is_empty(); }));
+    }
+
     virtual bool should_add_blocker(Thread::Blocker& b, void* data) override
     {
         VERIFY(b.blocker_type() == Thread::Blocker::Type::File);
@@ -34,13 +67,34 @@ public:
 
     void unblock_all_blockers_whose_conditions_are_met()
     {
-        SpinlockLocker lock(m_lock);
-        BlockerSet::unblock_all_blockers_whose_conditions_are_met_locked([&](auto& b, void* data, bool&) {
-            VERIFY(b.blocker_type() == Thread::Blocker::Type::File);
-            auto& blocker = static_cast<Thread::FileBlocker&>(b);
-            return blocker.unblock_if_conditions_are_met(false, data);
+        {
+            SpinlockLocker lock(m_lock);
+            BlockerSet::unblock_all_blockers_whose_conditions_are_met_locked([&](auto& b, void* data, bool&) {
+                VERIFY(b.blocker_type() == Thread::Blocker::Type::File);
+                auto& blocker = static_cast<Thread::FileBlocker&>(b);
+                return blocker.unblock_if_conditions_are_met(false, data);
+            });
+        }
+        m_listeners.with([](auto& listeners) {
+            for (auto& listener : listeners)
+                listener.file_state_may_have_changed();
         });
     }
+
+    void add_listener(Listener& listener)
+    {
+        m_listeners.with([&](auto& listeners) { listeners.append(listener); });
+    }
+
+    void remove_listener(Listener& listener)
+    {
+        m_listeners.with([&](auto& listeners) { listeners.remove(listener); });
+    }
+
+    void remove_listeners_for(OpenFileDescription const&);
+
+private:
+    SpinlockProtected<IntrusiveList<&Listener::m_list_node>, LockRank::None> m_listeners;
 };
 
 // File is the base class for anything that can be referenced by a OpenFileDescription.
@@ -114,6 +168,8 @@ public:
     virtual bool is_character_device() const { return false; }
     virtual bool is_socket() const { return false; }
     virtual bool is_inode_watcher() const { return false; }
+    virtual bool is_event_poll() const { return false; }
+    virtual bool is_io_ring() const { return false; }
     virtual bool is_mount_file() const { return false; }
     virtual bool is_loop_device() const { return false; }
 
@@ -58,6 +58,9 @@ public:
 
     virtual ErrorOr<void> flush_writes() { return {}; }
 
+    // Drops whatever cached data can be dropped without losing anything, returns the number of bytes released.
+    virtual size_t release_cache_memory() { return 0; }
+
     u64 logical_block_size() const { return m_logical_block_size; }
     size_t fragment_size() const { return m_fragment_size; }
 
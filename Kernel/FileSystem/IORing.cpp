@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/IntegralMath.h>
+#include <Kernel/FileSystem/IORing.h>
+#include <Kernel/Memory/MemoryManager.h>
+
+namespace Kernel {
+
+ErrorOr<NonnullRefPtr<IORing>> IORing::try_create(u32 entries)
+{
+    if (entries == 0 || entries > IO_RING_MAX_ENTRIES)
+        return EINVAL;
+    entries = 1u << AK::ceil_log2(entries);
+
+    auto completion_entries = entries * IO_RING_COMPLETIONS_PER_SUBMISSION;
+    auto size = TRY(Memory::page_round_up(header_size + entries * sizeof(IORingSubmission) + completion_entries * sizeof(IORingCompletion)));
+    auto vmobject = TRY(Memory::AnonymousVMObject::try_create_with_size(size, AllocationStrategy::AllocateNow));
+    auto region = TRY(MM.allocate_kernel_region_with_vmobject(*vmobject, size, "IORing"sv, Memory::Region::Access::ReadWrite));
+
+    auto ring = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) IORing(entries, move(vmobject), move(region))));
+    auto& header = ring->header();
+    header.submission_mask = entries - 1;
+    header.completion_mask = completion_entries - 1;
+    header.submissions_offset = header_size;
+    header.completions_offset = header_size + entries * sizeof(IORingSubmission);
+    header.size = size;
+    return ring;
+}
+
+IORing::IORing(u32 entries, NonnullLockRefPtr<Memory::AnonymousVMObject> vmobject, NonnullOwnPtr<Memory::Region> region)
+    : m_entries(entries)
+    , m_vmobject(move(vmobject))
+    , m_region(move(region))
+{
+}
+
+IORing::~IORing() = default;
+
+ErrorOr<u32> IORing::submit(u32 max_count, Function<i64(IORingSubmission const&)> perform)
+{
+    MutexLocker locker(m_lock);
+    auto& header = this->header();
+    auto completion_entries = m_entries * IO_RING_COMPLETIONS_PER_SUBMISSION;
+
+    auto submission_tail = AK::atomic_load(&header.submission_tail, AK::memory_order_acquire);
+    if (submission_tail - m_submission_head > m_entries)
+        return EINVAL;
+
+    u32 submitted = 0;
+    while (submitted < max_count && m_submission_head != submission_tail) {
+        auto completion_head = AK::atomic_load(&header.completion_head, AK::memory_order_acquire);
+        auto pending_completions = m_completion_tail - completion_head;
+        if (pending_completions > completion_entries)
+            return EINVAL;
+        if (pending_completions == completion_entries)
+            break;
+
+        // Copy the submission out first, userspace could be changing it under our feet.
+        IORingSubmission submission = submissions()[m_submission_head & (m_entries - 1)];
+        ++m_submission_head;
+        AK::atomic_store(&header.submission_head, m_submission_head, AK::memory_order_release);
+
+        auto result = perform(submission);
+
+        completions()[m_completion_tail & (completion_entries - 1)] = { submission.user_data, result };
+        ++m_completion_tail;
+        AK::atomic_store(&header.completion_tail, m_completion_tail, AK::memory_order_release);
+        ++submitted;
+    }
+
+    if (submitted > 0)
+        evaluate_block_conditions();
+    return submitted;
+}
+
+bool IORing::can_read(OpenFileDescription const&, u64) const
+{
+    return AK::atomic_load(&header().completion_head, AK::memory_order_acquire) != m_completion_tail;
+}
+
+ErrorOr<NonnullLockRefPtr<Memory::VMObject>> IORing::vmobject_for_mmap(Process&, Memory::VirtualRange const&, u64& offset, bool shared)
+{
+    // A private mapping would be a copy of the rings, which is of no use to anyone.
+    if (offset != 0 || !shared)
+        return EINVAL;
+    return m_vmobject;
+}
+
+ErrorOr<NonnullOwnPtr<KString>> IORing::pseudo_path(OpenFileDescription const&) const
+{
+    return KString::try_create(":io-ring:"sv);
+}
+
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <Kernel/API/IORing.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
+#include <Kernel/Memory/Region.h>
+
+namespace Kernel {
+
+class IORing final : public File {
+public:
+    static ErrorOr<NonnullRefPtr<IORing>> try_create(u32 entries);
+
+    virtual ~IORing() override;
+
+    // Consumes up to max_count submissions, performing each of them and posting its result in the completion ring.
+    // Stops early if the completion ring is full, returns how many submissions were consumed.
+    ErrorOr<u32> submit(u32 max_count, Function<i64(IORingSubmission const&)> perform);
+
+    virtual ErrorOr<NonnullLockRefPtr<Memory::VMObject>> vmobject_for_mmap(Process&, Memory::VirtualRange const&, u64& offset, bool shared) override;
+
+private:
+    IORing(u32 entries, NonnullLockRefPtr<Memory::AnonymousVMObject>, NonnullOwnPtr<Memory::Region>);
+
+    virtual StringView class_name() const override { return "IORing"sv; }
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual bool is_io_ring() const override { return true; }
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return ENOTSUP; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return ENOTSUP; }
+
+    // NOTE: Everything in the mapping can be scribbled over by userspace at any time,
+    //       so we keep our own copies of the indices we're responsible for.
+    IORingHeader& header() const { return *reinterpret_cast<IORingHeader*>(m_region->vaddr().as_ptr()); }
+    IORingSubmission const* submissions() const { return reinterpret_cast<IORingSubmission const*>(m_region->vaddr().offset(header_size).as_ptr()); }
+    IORingCompletion* completions() const { return reinterpret_cast<IORingCompletion*>(m_region->vaddr().offset(header_size + m_entries * sizeof(IORingSubmission)).as_ptr()); }
+
+    static constexpr size_t header_size = 64;
+    static_assert(sizeof(IORingHeader) <= header_size);
+
+    Mutex m_lock { "IORing"sv };
+    u32 const m_entries { 0 };
+    NonnullLockRefPtr<Memory::AnonymousVMObject> m_vmobject;
+    NonnullOwnPtr<Memory::Region> m_region;
+    u32 m_submission_head { 0 };
+    u32 m_completion_tail { 0 };
+};
+
+}
@@ -10,6 +10,7 @@
 #include <AK/StringView.h>
 #include <Kernel/API/InodeWatcherEvent.h>
 #include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/DirectoryEntryCache.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/FileSystem/InodeWatcher.h>
 #include <Kernel/FileSystem/OpenFileDescription.h>
@@ -76,6 +77,9 @@ Inode::Inode(FileSystem& fs, InodeIndex index)
 
 Inode::~Inode()
 {
+    if (DirectoryEntryCache::is_enabled_for(*this))
+        DirectoryEntryCache::the().invalidate_directory(identifier());
+
     m_watchers.for_each([&](auto& watcher) {
         watcher->unregister_by_inode({}, identifier());
     });
@@ -104,13 +108,51 @@ ErrorOr<size_t> Inode::prepare_and_write_bytes_locked(off_t offset, size_t lengt
 {
     VERIFY(m_inode_lock.is_locked());
     TRY(prepare_to_write_data());
-    return write_bytes_locked(offset, length, target_buffer, open_description);
+    auto nwritten = TRY(write_bytes_locked(offset, length, target_buffer, open_description));
+
+    // Shared mappings of this inode must see the new data as well, so update whatever pages of it are resident.
+    if (auto vmobject = m_shared_vmobject.strong_ref()) {
+        for (size_t nupdated = 0; nupdated < nwritten;) {
+            auto position = offset + nupdated;
+            auto offset_in_page = position % PAGE_SIZE;
+            auto chunk_length = min(PAGE_SIZE - offset_in_page, nwritten - nupdated);
+            if (vmobject->is_page_resident(position / PAGE_SIZE)) {
+                u8 chunk_buffer[PAGE_SIZE];
+                TRY(target_buffer.read(chunk_buffer, nupdated, chunk_length));
+                vmobject->copy_to_resident_page(position / PAGE_SIZE, offset_in_page, { chunk_buffer, chunk_length });
+            }
+            nupdated += chunk_length;
+        }
+    }
+    return nwritten;
 }
 
 ErrorOr<size_t> Inode::read_bytes(off_t offset, size_t length, UserOrKernelBuffer& buffer, OpenFileDescription* open_description) const
 {
     MutexLocker locker(m_inode_lock, Mutex::Mode::Shared);
-    return read_bytes_locked(offset, length, buffer, open_description);
+    auto nread = TRY(read_bytes_locked(offset, length, buffer, open_description));
+
+    // Shared mappings of this inode may have been written to without the changes having made it to the file system yet,
+    // so the resident pages of it are what read() has to return.
+    auto vmobject = m_shared_vmobject.strong_ref();
+    if (!vmobject)
+        return nread;
+    for (size_t ncopied = 0; ncopied < nread;) {
+        auto position = offset + ncopied;
+        auto offset_in_page = position % PAGE_SIZE;
+        auto chunk_length = min(PAGE_SIZE - offset_in_page, nread - ncopied);
+        u8 page_buffer[PAGE_SIZE];
+        if (vmobject->copy_from_resident_page(position / PAGE_SIZE, page_buffer))
+            TRY(buffer.write(page_buffer + offset_in_page, ncopied, chunk_length));
+        ncopied += chunk_length;
+    }
+    return nread;
+}
+
+ErrorOr<void> Inode::prefetch(off_t offset, size_t length) const
+{
+    MutexLocker locker(m_inode_lock, Mutex::Mode::Shared);
+    return prefetch_locked(offset, length);
 }
 
 ErrorOr<size_t> Inode::read_until_filled_or_end(off_t offset, size_t length, UserOrKernelBuffer buffer, OpenFileDescription* open_description) const
@@ -226,6 +268,8 @@ void Inode::set_metadata_dirty(bool metadata_dirty)
 
 void Inode::did_add_child(InodeIdentifier, StringView name)
 {
+    DirectoryEntryCache::the().invalidate(identifier(), name);
+
     m_watchers.for_each([&](auto& watcher) {
         watcher->notify_inode_event({}, identifier(), InodeWatcherEvent::Type::ChildCreated, name);
     });
@@ -233,6 +277,8 @@ void Inode::did_add_child(InodeIdentifier, StringView name)
 
 void Inode::did_remove_child(InodeIdentifier, StringView name)
 {
+    DirectoryEntryCache::the().invalidate(identifier(), name);
+
     if (name == "." || name == "..") {
         // These are just aliases and are not interesting to userspace.
         return;
@@ -14,6 +14,7 @@
 #include <Kernel/Memory/PrivateInodeVMObject.h>
 #include <Kernel/Memory/SharedInodeVMObject.h>
 #include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/WorkQueue.h>
 
 namespace Kernel {
 
@@ -33,6 +34,14 @@ ErrorOr<size_t> InodeFile::read(OpenFileDescription& description, u64 offset, Us
     if (nread > 0) {
         Thread::current()->did_file_read(nread);
         evaluate_block_conditions();
+        if (!description.is_direct()) {
+            if (auto range = description.did_read_at(offset, nread); range.has_value()) {
+                // NOTE: Read-ahead is only a hint, so we don't care if we can't queue it.
+                (void)g_file_io_work->try_queue([inode = m_inode, range = range.value()] {
+                    (void)inode->prefetch(range.offset, range.size);
+                });
+            }
+        }
     }
     return nread;
 }
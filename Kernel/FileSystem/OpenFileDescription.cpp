@@ -24,6 +24,8 @@
 
 namespace Kernel {
 
+KMALLOC_DEFINE_SLAB_CACHE(OpenFileDescription);
+
 ErrorOr<NonnullRefPtr<OpenFileDescription>> OpenFileDescription::try_create(Custody& custody)
 {
     auto inode_file = TRY(InodeFile::create(custody.inode()));
@@ -53,6 +55,7 @@ OpenFileDescription::OpenFileDescription(File& file)
 
 OpenFileDescription::~OpenFileDescription()
 {
+    m_file->blocker_set().remove_listeners_for(*this);
     m_file->detach(*this);
     // FIXME: Should this error path be observed somehow?
     (void)m_file->close();
@@ -499,6 +502,37 @@ bool OpenFileDescription::is_direct() const
     return m_state.with([](auto& state) { return state.direct; });
 }
 
+static constexpr u32 initial_read_ahead_window = 16 * KiB;
+static constexpr u32 max_read_ahead_window = 256 * KiB;
+
+Optional<OpenFileDescription::ReadAheadRange> OpenFileDescription::did_read_at(u64 offset, size_t nread)
+{
+    return m_state.with([&](auto& state) -> Optional<ReadAheadRange> {
+        u64 end = offset + nread;
+        bool is_sequential = offset == state.next_sequential_read_offset;
+        state.next_sequential_read_offset = end;
+        if (!is_sequential) {
+            state.read_ahead_offset = 0;
+            state.read_ahead_window = 0;
+            return {};
+        }
+
+        if (state.read_ahead_window == 0)
+            state.read_ahead_window = initial_read_ahead_window;
+
+        // Start reading the next window once the reader has consumed half of the current one.
+        if (state.read_ahead_offset > end + state.read_ahead_window / 2)
+            return {};
+
+        ReadAheadRange range;
+        range.offset = max(state.read_ahead_offset, end);
+        range.size = end + state.read_ahead_window - range.offset;
+        state.read_ahead_offset = range.offset + range.size;
+        state.read_ahead_window = min(state.read_ahead_window * 2, max_read_ahead_window);
+        return range;
+    });
+}
+
 bool OpenFileDescription::is_directory() const
 {
     return m_state.with([](auto& state) { return state.is_directory; });
@@ -25,6 +25,8 @@ public:
 };
 
 class OpenFileDescription final : public AtomicRefCounted<OpenFileDescription> {
+    MAKE_SLAB_CACHE_ALLOCATED(OpenFileDescription);
+
 public:
     static ErrorOr<NonnullRefPtr<OpenFileDescription>> try_create(Custody&);
     static ErrorOr<NonnullRefPtr<OpenFileDescription>> try_create(File&);
@@ -65,6 +67,14 @@ public:
 
     bool is_directory() const;
 
+    struct ReadAheadRange {
+        u64 offset { 0 };
+        size_t size { 0 };
+    };
+
+    // Tracks sequential reads through this description, and returns the range we should read ahead into the cache, if any.
+    Optional<ReadAheadRange> did_read_at(u64 offset, size_t nread);
+
     File& file() { return *m_file; }
     File const& file() const { return *m_file; }
 
@@ -149,6 +159,10 @@ private:
         OwnPtr<OpenFileDescriptionData> data;
         RefPtr<Custody> custody;
         off_t current_offset { 0 };
+        // Where the next read has to start to count as sequential, how far we have read ahead, and by how much we read ahead next time.
+        u64 next_sequential_read_offset { 0 };
+        u64 read_ahead_offset { 0 };
+        u32 read_ahead_window { 0 };
         u32 file_flags { 0 };
         bool readable : 1 { false };
         bool writable : 1 { false };
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/API/Syscall.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/BigLockStatistics.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSBigLockStatistics::SysFSBigLockStatistics(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSBigLockStatistics> SysFSBigLockStatistics::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSBigLockStatistics(parent_directory)).release_nonnull();
+}
+
+ErrorOr<void> SysFSBigLockStatistics::try_generate(KBufferBuilder& builder)
+{
+    auto array = TRY(JsonArraySerializer<>::try_create(builder));
+    for (size_t function = 0; function < Syscall::Function::__Count; ++function) {
+        auto statistics = Syscall::big_lock_statistics(static_cast<Syscall::Function>(function));
+        // Syscalls that don't take the big lock have nothing to report.
+        if (!statistics.needs_big_lock)
+            continue;
+        auto object = TRY(array.add_object());
+        TRY(object.add("syscall"sv, statistics.syscall_name));
+        TRY(object.add("acquisitions"sv, statistics.acquisitions));
+        TRY(object.add("contentions"sv, statistics.contentions));
+        TRY(object.finish());
+    }
+    TRY(array.finish());
+    return {};
+}
+
+}
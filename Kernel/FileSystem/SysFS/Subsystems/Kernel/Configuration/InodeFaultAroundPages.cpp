@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Configuration/InodeFaultAroundPages.h>
+#include <Kernel/Memory/Region.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSInodeFaultAroundPages::SysFSInodeFaultAroundPages(SysFSDirectory const& parent_directory)
+    : SysFSSystemIntegerVariable(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSInodeFaultAroundPages> SysFSInodeFaultAroundPages::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSInodeFaultAroundPages(parent_directory)).release_nonnull();
+}
+
+u64 SysFSInodeFaultAroundPages::value() const
+{
+    return Memory::Region::inode_fault_around_page_count();
+}
+
+ErrorOr<void> SysFSInodeFaultAroundPages::set_value(u64 new_value)
+{
+    if (new_value == 0 || new_value > Memory::Region::max_inode_fault_around_page_count)
+        return EINVAL;
+    Memory::Region::set_inode_fault_around_page_count(new_value);
+    return {};
+}
+
+}
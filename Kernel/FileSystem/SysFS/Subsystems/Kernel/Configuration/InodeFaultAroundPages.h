@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/RefPtr.h>
+#include <AK/Types.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Configuration/IntegerVariable.h>
+#include <Kernel/Library/UserOrKernelBuffer.h>
+
+namespace Kernel {
+
+class SysFSInodeFaultAroundPages final : public SysFSSystemIntegerVariable {
+public:
+    virtual StringView name() const override { return "inode_fault_around_pages"sv; }
+    static NonnullRefPtr<SysFSInodeFaultAroundPages> must_create(SysFSDirectory const&);
+
+private:
+    virtual u64 value() const override;
+    virtual ErrorOr<void> set_value(u64 new_value) override;
+
+    explicit SysFSInodeFaultAroundPages(SysFSDirectory const&);
+};
+
+}
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Configuration/TraceEnabled.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/TraceBuffer.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSTraceEnabled::SysFSTraceEnabled(SysFSDirectory const& parent_directory)
+    : SysFSSystemBooleanVariable(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSTraceEnabled> SysFSTraceEnabled::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSTraceEnabled(parent_directory)).release_nonnull();
+}
+
+bool SysFSTraceEnabled::value() const
+{
+    return TraceBuffer::is_enabled();
+}
+
+void SysFSTraceEnabled::set_value(bool new_value)
+{
+    TraceBuffer::set_enabled(new_value);
+}
+
+}
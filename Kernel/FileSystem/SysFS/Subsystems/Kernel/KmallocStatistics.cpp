@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/FixedArray.h>
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/KmallocStatistics.h>
+#include <Kernel/Heap/kmalloc.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSKmallocStatistics::SysFSKmallocStatistics(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSKmallocStatistics> SysFSKmallocStatistics::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSKmallocStatistics(parent_directory)).release_nonnull();
+}
+
+ErrorOr<void> SysFSKmallocStatistics::try_generate(KBufferBuilder& builder)
+{
+    // NOTE: Slab caches are created on first use, so leave some room for caches that show up in the meantime.
+    auto cache_count = get_kmalloc_cache_stats(nullptr, 0);
+    auto caches = TRY(FixedArray<kmalloc_cache_stats>::create(cache_count + 4));
+    cache_count = min(get_kmalloc_cache_stats(caches.data(), caches.size()), caches.size());
+
+    auto array = TRY(JsonArraySerializer<>::try_create(builder));
+    for (auto const& cache : caches.span().trim(cache_count)) {
+        auto cache_object = TRY(array.add_object());
+        TRY(cache_object.add("name"sv, StringView { cache.name, strlen(cache.name) }));
+        TRY(cache_object.add("object_size"sv, cache.object_size));
+        TRY(cache_object.add("allocations"sv, cache.allocations));
+        TRY(cache_object.add("frees"sv, cache.frees));
+        TRY(cache_object.add("magazine_hits"sv, cache.magazine_hits));
+        TRY(cache_object.add("magazine_refills"sv, cache.magazine_refills));
+        TRY(cache_object.add("magazine_flushes"sv, cache.magazine_flushes));
+        TRY(cache_object.add("contended_lock_acquisitions"sv, cache.contended_lock_acquisitions));
+        TRY(cache_object.add("cached_objects"sv, cache.cached_objects));
+        TRY(cache_object.add("bytes_allocated"sv, cache.bytes_allocated));
+        TRY(cache_object.add("bytes_free"sv, cache.bytes_free));
+        TRY(cache_object.finish());
+    }
+    TRY(array.finish());
+    return {};
+}
+
+}
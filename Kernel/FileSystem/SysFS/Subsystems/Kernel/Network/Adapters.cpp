@@ -45,6 +45,9 @@ ErrorOr<void> SysFSNetworkAdaptersStats::try_generate(KBufferBuilder& builder)
         TRY(obj.add("link_full_duplex"sv, adapter.link_full_duplex()));
         TRY(obj.add("mtu"sv, adapter.mtu()));
         TRY(obj.add("packets_dropped"sv, adapter.packets_dropped()));
+        TRY(obj.add("packets_coalesced"sv, adapter.packets_coalesced()));
+        TRY(obj.add("tcp_checksum_offload"sv, adapter.has_transmit_offload(NetworkAdapter::TransmitOffload::TCPChecksum)));
+        TRY(obj.add("tcp_segmentation_offload"sv, adapter.has_transmit_offload(NetworkAdapter::TransmitOffload::TCPSegmentation)));
         TRY(obj.finish());
         return {};
     }));
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Network/PacketBuffers.h>
+#include <Kernel/Net/PacketBuffer.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSNetworkPacketBufferStats::SysFSNetworkPacketBufferStats(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSNetworkPacketBufferStats> SysFSNetworkPacketBufferStats::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSNetworkPacketBufferStats(parent_directory)).release_nonnull();
+}
+
+ErrorOr<void> SysFSNetworkPacketBufferStats::try_generate(KBufferBuilder& builder)
+{
+    auto array = TRY(JsonArraySerializer<>::try_create(builder));
+    for (auto capacity : { PacketBuffer::small_buffer_capacity, PacketBuffer::large_buffer_capacity }) {
+        auto statistics = PacketBuffer::pool_statistics(capacity);
+        auto obj = TRY(array.add_object());
+        TRY(obj.add("capacity"sv, statistics.capacity));
+        TRY(obj.add("allocated"sv, statistics.allocated));
+        TRY(obj.add("free"sv, statistics.free));
+        TRY(obj.add("reused"sv, statistics.reused));
+        TRY(obj.add("allocation_failures"sv, statistics.allocation_failures));
+        TRY(obj.finish());
+    }
+    TRY(array.finish());
+    return {};
+}
+
+}
@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/RefPtr.h>
+#include <AK/Types.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/GlobalInformation.h>
+#include <Kernel/Library/KBufferBuilder.h>
+#include <Kernel/Library/UserOrKernelBuffer.h>
+
+namespace Kernel {
+
+class SysFSNetworkPacketBufferStats final : public SysFSGlobalInformation {
+public:
+    virtual StringView name() const override { return "packet_buffers"sv; }
+    static NonnullRefPtr<SysFSNetworkPacketBufferStats> must_create(SysFSDirectory const&);
+
+private:
+    explicit SysFSNetworkPacketBufferStats(SysFSDirectory const&);
+    virtual ErrorOr<void> try_generate(KBufferBuilder& builder) override;
+};
+
+}
@@ -6,6 +6,7 @@
 
 #include <AK/JsonObjectSerializer.h>
 #include <AK/Try.h>
+#include <Kernel/API/ProcessStatistics.h>
 #include <Kernel/Devices/TTY/TTY.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Processes.h>
 #include <Kernel/Sections.h>
@@ -24,51 +25,95 @@ UNMAP_AFTER_INIT NonnullRefPtr<SysFSOverallProcesses> SysFSOverallProcesses::mus
     return adopt_ref_if_nonnull(new (nothrow) SysFSOverallProcesses(parent_directory)).release_nonnull();
 }
 
-ErrorOr<void> SysFSOverallProcesses::try_generate(KBufferBuilder& builder)
+UNMAP_AFTER_INIT SysFSOverallProcessStatistics::SysFSOverallProcessStatistics(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
 {
-    auto json = TRY(JsonObjectSerializer<>::try_create(builder));
+}
 
-    // Keep this in sync with CProcessStatistics.
-    auto build_process = [&](JsonArraySerializer<KBufferBuilder>& array, Process const& process) -> ErrorOr<void> {
-        auto process_object = TRY(array.add_object());
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSOverallProcessStatistics> SysFSOverallProcessStatistics::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSOverallProcessStatistics(parent_directory)).release_nonnull();
+}
 
-        if (process.is_user_process()) {
-            StringBuilder pledge_builder;
+static ErrorOr<void> build_pledge_string(StringBuilder& pledge_builder, Process const& process)
+{
+    if (!process.is_user_process())
+        return {};
 
 #define __ENUMERATE_PLEDGE_PROMISE(promise)    \
     if (process.has_promised(Pledge::promise)) \
         TRY(pledge_builder.try_append(#promise " "sv));
-            ENUMERATE_PLEDGE_PROMISES
+    ENUMERATE_PLEDGE_PROMISES
 #undef __ENUMERATE_PLEDGE_PROMISE
+    return {};
+}
 
-            TRY(process_object.add("pledge"sv, pledge_builder.string_view()));
-
-            switch (process.veil_state()) {
-            case VeilState::None:
-                TRY(process_object.add("veil"sv, "None"));
-                break;
-            case VeilState::Dropped:
-                TRY(process_object.add("veil"sv, "Dropped"));
-                break;
-            case VeilState::Locked:
-                TRY(process_object.add("veil"sv, "Locked"));
-                break;
-            case VeilState::LockedInherited:
-                // Note: We don't reveal if the locked state is either by our choice
-                // or someone else applied it.
-                TRY(process_object.add("veil"sv, "Locked"));
-                break;
-            }
-        } else {
-            TRY(process_object.add("pledge"sv, ""sv));
-            TRY(process_object.add("veil"sv, ""sv));
-        }
+static StringView veil_state_string(Process const& process)
+{
+    if (!process.is_user_process())
+        return ""sv;
+
+    switch (process.veil_state()) {
+    case VeilState::None:
+        return "None"sv;
+    case VeilState::Dropped:
+        return "Dropped"sv;
+    case VeilState::Locked:
+    case VeilState::LockedInherited:
+        // Note: We don't reveal if the locked state is either by our choice
+        // or someone else applied it.
+        return "Locked"sv;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+struct ProcessMemoryStatistics {
+    size_t amount_virtual { 0 };
+    size_t amount_resident { 0 };
+    size_t amount_dirty_private { 0 };
+    size_t amount_clean_inode { 0 };
+    size_t amount_shared { 0 };
+    size_t amount_purgeable_volatile { 0 };
+    size_t amount_purgeable_nonvolatile { 0 };
+};
+
+static ErrorOr<ProcessMemoryStatistics> memory_statistics(Process const& process)
+{
+    return process.address_space().with([&](auto& space) -> ErrorOr<ProcessMemoryStatistics> {
+        return ProcessMemoryStatistics {
+            .amount_virtual = space->amount_virtual(),
+            .amount_resident = space->amount_resident(),
+            .amount_dirty_private = space->amount_dirty_private(),
+            .amount_clean_inode = TRY(space->amount_clean_inode()),
+            .amount_shared = space->amount_shared(),
+            .amount_purgeable_volatile = space->amount_purgeable_volatile(),
+            .amount_purgeable_nonvolatile = space->amount_purgeable_nonvolatile(),
+        };
+    });
+}
+
+static ProcessGroupID tty_pgid(Process const& process)
+{
+    if (auto tty = process.tty())
+        return tty->pgid();
+    return 0;
+}
+
+ErrorOr<void> SysFSOverallProcesses::try_generate(KBufferBuilder& builder)
+{
+    auto json = TRY(JsonObjectSerializer<>::try_create(builder));
+
+    // Keep this in sync with CProcessStatistics.
+    auto build_process = [&](JsonArraySerializer<KBufferBuilder>& array, Process const& process) -> ErrorOr<void> {
+        auto process_object = TRY(array.add_object());
+
+        StringBuilder pledge_builder;
+        TRY(build_pledge_string(pledge_builder, process));
+        TRY(process_object.add("pledge"sv, pledge_builder.string_view()));
+        TRY(process_object.add("veil"sv, veil_state_string(process)));
 
         TRY(process_object.add("pid"sv, process.pid().value()));
-        ProcessGroupID tty_pgid = 0;
-        if (auto tty = process.tty())
-            tty_pgid = tty->pgid();
-        TRY(process_object.add("pgid"sv, tty_pgid.value()));
+        TRY(process_object.add("pgid"sv, tty_pgid(process).value()));
         TRY(process_object.add("pgp"sv, process.pgid().value()));
         TRY(process_object.add("sid"sv, process.sid().value()));
         auto credentials = process.credentials();
@@ -85,32 +130,14 @@ ErrorOr<void> SysFSOverallProcesses::try_generate(KBufferBuilder& builder)
         TRY(process_object.add("executable"sv, process.executable() ? TRY(process.executable()->try_serialize_absolute_path())->view() : ""sv));
         TRY(process_object.add("creation_time"sv, process.creation_time().nanoseconds_since_epoch()));
 
-        size_t amount_virtual = 0;
-        size_t amount_resident = 0;
-        size_t amount_dirty_private = 0;
-        size_t amount_clean_inode = 0;
-        size_t amount_shared = 0;
-        size_t amount_purgeable_volatile = 0;
-        size_t amount_purgeable_nonvolatile = 0;
-
-        TRY(process.address_space().with([&](auto& space) -> ErrorOr<void> {
-            amount_virtual = space->amount_virtual();
-            amount_resident = space->amount_resident();
-            amount_dirty_private = space->amount_dirty_private();
-            amount_clean_inode = TRY(space->amount_clean_inode());
-            amount_shared = space->amount_shared();
-            amount_purgeable_volatile = space->amount_purgeable_volatile();
-            amount_purgeable_nonvolatile = space->amount_purgeable_nonvolatile();
-            return {};
-        }));
-
-        TRY(process_object.add("amount_virtual"sv, amount_virtual));
-        TRY(process_object.add("amount_resident"sv, amount_resident));
-        TRY(process_object.add("amount_dirty_private"sv, amount_dirty_private));
-        TRY(process_object.add("amount_clean_inode"sv, amount_clean_inode));
-        TRY(process_object.add("amount_shared"sv, amount_shared));
-        TRY(process_object.add("amount_purgeable_volatile"sv, amount_purgeable_volatile));
-        TRY(process_object.add("amount_purgeable_nonvolatile"sv, amount_purgeable_nonvolatile));
+        auto memory = TRY(memory_statistics(process));
+        TRY(process_object.add("amount_virtual"sv, memory.amount_virtual));
+        TRY(process_object.add("amount_resident"sv, memory.amount_resident));
+        TRY(process_object.add("amount_dirty_private"sv, memory.amount_dirty_private));
+        TRY(process_object.add("amount_clean_inode"sv, memory.amount_clean_inode));
+        TRY(process_object.add("amount_shared"sv, memory.amount_shared));
+        TRY(process_object.add("amount_purgeable_volatile"sv, memory.amount_purgeable_volatile));
+        TRY(process_object.add("amount_purgeable_nonvolatile"sv, memory.amount_purgeable_nonvolatile));
         TRY(process_object.add("dumpable"sv, process.is_dumpable()));
         TRY(process_object.add("kernel"sv, process.is_kernel_process()));
         auto thread_array = TRY(process_object.add_array("threads"sv));
@@ -123,6 +150,10 @@ ErrorOr<void> SysFSOverallProcesses::try_generate(KBufferBuilder& builder)
             TRY(thread_object.add("tid"sv, thread.tid().value()));
             TRY(thread.name().with([&](auto& thread_name) { return thread_object.add("name"sv, thread_name.representable_view()); }));
             TRY(thread_object.add("times_scheduled"sv, thread.times_scheduled()));
+            auto wakeup_latency_histogram = TRY(thread_object.add_array("wakeup_latency_histogram"sv));
+            for (auto count : thread.wakeup_latency_histogram())
+                TRY(wakeup_latency_histogram.add(count));
+            TRY(wakeup_latency_histogram.finish());
             TRY(thread_object.add("time_user"sv, thread.time_in_user()));
             TRY(thread_object.add("time_kernel"sv, thread.time_in_kernel()));
             TRY(thread_object.add("state"sv, thread.state_string()));
@@ -165,4 +196,102 @@ ErrorOr<void> SysFSOverallProcesses::try_generate(KBufferBuilder& builder)
     return {};
 }
 
+template<typename T>
+static ErrorOr<void> append_record(KBufferBuilder& builder, T const& record)
+{
+    return builder.append_bytes({ reinterpret_cast<u8 const*>(&record), sizeof(record) });
+}
+
+static ErrorOr<void> append_string(KBufferBuilder& builder, StringView string)
+{
+    u16 length = min(string.length(), NumericLimits<u16>::max());
+    TRY(builder.append_bytes({ reinterpret_cast<u8 const*>(&length), sizeof(length) }));
+    return builder.append_bytes(string.bytes().trim(length));
+}
+
+ErrorOr<void> SysFSOverallProcessStatistics::try_generate(KBufferBuilder& builder)
+{
+    TRY(append_record(builder, ProcessStatisticsHeader { .magic = process_statistics_magic, .version = process_statistics_version }));
+
+    auto build_process = [&](Process const& process) -> ErrorOr<void> {
+        auto memory = TRY(memory_statistics(process));
+        auto credentials = process.credentials();
+        TRY(append_record(builder, ProcessStatisticsProcessRecord {
+                                       .type = ProcessStatisticsRecordType::Process,
+                                       .pid = process.pid().value(),
+                                       .pgid = tty_pgid(process).value(),
+                                       .pgp = process.pgid().value(),
+                                       .sid = process.sid().value(),
+                                       .uid = credentials->uid().value(),
+                                       .gid = credentials->gid().value(),
+                                       .ppid = process.ppid().value(),
+                                       .kernel = process.is_kernel_process(),
+                                       .dumpable = process.is_dumpable(),
+                                       .reserved = {},
+                                       .creation_time = process.creation_time().nanoseconds_since_epoch(),
+                                       .amount_virtual = memory.amount_virtual,
+                                       .amount_resident = memory.amount_resident,
+                                       .amount_shared = memory.amount_shared,
+                                       .amount_dirty_private = memory.amount_dirty_private,
+                                       .amount_clean_inode = memory.amount_clean_inode,
+                                       .amount_purgeable_volatile = memory.amount_purgeable_volatile,
+                                       .amount_purgeable_nonvolatile = memory.amount_purgeable_nonvolatile,
+                                   }));
+
+        TRY(process.name().with([&](auto& process_name) { return append_string(builder, process_name.representable_view()); }));
+        if (process.executable())
+            TRY(append_string(builder, TRY(process.executable()->try_serialize_absolute_path())->view()));
+        else
+            TRY(append_string(builder, ""sv));
+        if (process.tty())
+            TRY(append_string(builder, TRY(process.tty()->pseudo_name())->view()));
+        else
+            TRY(append_string(builder, ""sv));
+        StringBuilder pledge_builder;
+        TRY(build_pledge_string(pledge_builder, process));
+        TRY(append_string(builder, pledge_builder.string_view()));
+        TRY(append_string(builder, veil_state_string(process)));
+
+        return process.try_for_each_thread([&](Thread const& thread) -> ErrorOr<void> {
+            SpinlockLocker locker(thread.get_lock());
+            TRY(append_record(builder, ProcessStatisticsThreadRecord {
+                                           .type = ProcessStatisticsRecordType::Thread,
+                                           .tid = thread.tid().value(),
+                                           .times_scheduled = thread.times_scheduled(),
+                                           .cpu = thread.cpu(),
+                                           .priority = thread.priority(),
+                                           .syscall_count = thread.syscall_count(),
+                                           .inode_faults = thread.inode_faults(),
+                                           .zero_faults = thread.zero_faults(),
+                                           .cow_faults = thread.cow_faults(),
+                                           .reserved = 0,
+                                           .time_user = thread.time_in_user(),
+                                           .time_kernel = thread.time_in_kernel(),
+                                           .file_read_bytes = thread.file_read_bytes(),
+                                           .file_write_bytes = thread.file_write_bytes(),
+                                           .unix_socket_read_bytes = thread.unix_socket_read_bytes(),
+                                           .unix_socket_write_bytes = thread.unix_socket_write_bytes(),
+                                           .ipv4_socket_read_bytes = thread.ipv4_socket_read_bytes(),
+                                           .ipv4_socket_write_bytes = thread.ipv4_socket_write_bytes(),
+                                       }));
+            TRY(thread.name().with([&](auto& thread_name) { return append_string(builder, thread_name.representable_view()); }));
+            return append_string(builder, thread.state_string());
+        });
+    };
+
+    // FIXME: Do we actually want to expose the colonel process in a Jail environment?
+    TRY(build_process(*Scheduler::colonel()));
+    TRY(Process::for_each_in_same_jail([&](Process& process) -> ErrorOr<void> {
+        return build_process(process);
+    }));
+
+    auto total_time_scheduled = Scheduler::get_total_time_scheduled();
+    return append_record(builder, ProcessStatisticsTotalsRecord {
+                                      .type = ProcessStatisticsRecordType::Totals,
+                                      .reserved = 0,
+                                      .total_time = total_time_scheduled.total,
+                                      .total_time_kernel = total_time_scheduled.total_kernel,
+                                  });
+}
+
 }
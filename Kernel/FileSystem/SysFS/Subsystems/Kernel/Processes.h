@@ -27,4 +27,18 @@ private:
     virtual bool is_readable_by_jailed_processes() const override { return true; }
 };
 
+// The same information as SysFSOverallProcesses, in the binary format described in Kernel/API/ProcessStatistics.h.
+class SysFSOverallProcessStatistics final : public SysFSGlobalInformation {
+public:
+    virtual StringView name() const override { return "process_statistics"sv; }
+
+    static NonnullRefPtr<SysFSOverallProcessStatistics> must_create(SysFSDirectory const& parent_directory);
+
+private:
+    explicit SysFSOverallProcessStatistics(SysFSDirectory const& parent_directory);
+    virtual ErrorOr<void> try_generate(KBufferBuilder& builder) override;
+
+    virtual bool is_readable_by_jailed_processes() const override { return true; }
+};
+
 }
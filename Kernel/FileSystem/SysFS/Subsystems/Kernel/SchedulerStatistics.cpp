@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/Arch/Processor.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/SchedulerStatistics.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/Scheduler.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSSchedulerStatistics::SysFSSchedulerStatistics(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSSchedulerStatistics> SysFSSchedulerStatistics::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSSchedulerStatistics(parent_directory)).release_nonnull();
+}
+
+ErrorOr<void> SysFSSchedulerStatistics::try_generate(KBufferBuilder& builder)
+{
+    auto json = TRY(JsonObjectSerializer<>::try_create(builder));
+    TRY(json.add("latency_histogram_bucket_count"sv, scheduler_latency_histogram_bucket_count));
+
+    auto processors = TRY(json.add_array("processors"sv));
+    // NOTE: Processor::count() is not maintained on every architecture, but there is always at least one processor.
+    auto processor_count = max(Processor::count(), 1u);
+    for (u32 cpu = 0; cpu < processor_count; ++cpu) {
+        auto statistics = Scheduler::processor_statistics(cpu);
+        auto processor_object = TRY(processors.add_object());
+        TRY(processor_object.add("processor"sv, cpu));
+        TRY(processor_object.add("context_switches"sv, statistics.context_switches));
+        TRY(processor_object.add("threads_stolen"sv, statistics.threads_stolen));
+        TRY(processor_object.add("ready_queue_depth"sv, statistics.ready_queue_depth));
+        TRY(processor_object.add("max_ready_queue_depth"sv, statistics.max_ready_queue_depth));
+        auto histogram_array = TRY(processor_object.add_array("wakeup_latency_histogram"sv));
+        for (auto count : statistics.wakeup_latency_histogram)
+            TRY(histogram_array.add(count));
+        TRY(histogram_array.finish());
+        TRY(processor_object.finish());
+    }
+    TRY(processors.finish());
+
+    TRY(json.finish());
+    return {};
+}
+
+}
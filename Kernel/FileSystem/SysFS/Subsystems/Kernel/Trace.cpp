@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Trace.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/TraceBuffer.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSKernelTrace::SysFSKernelTrace(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSKernelTrace> SysFSKernelTrace::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSKernelTrace(parent_directory)).release_nonnull();
+}
+
+mode_t SysFSKernelTrace::permissions() const
+{
+    return S_IRUSR;
+}
+
+ErrorOr<void> SysFSKernelTrace::try_generate(KBufferBuilder& builder)
+{
+    return TraceBuffer::to_json(builder);
+}
+
+}
@@ -16,6 +16,7 @@
 #include <Kernel/Devices/DeviceManagement.h>
 #include <Kernel/Devices/Loop/LoopDevice.h>
 #include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/DirectoryEntryCache.h>
 #include <Kernel/FileSystem/FileBackedFileSystem.h>
 #include <Kernel/FileSystem/FileSystem.h>
 #include <Kernel/FileSystem/OpenFileDescription.h>
@@ -278,6 +279,20 @@ void VirtualFileSystem::sync_filesystems()
     }
 }
 
+size_t VirtualFileSystem::release_file_system_cache_memory()
+{
+    Vector<NonnullRefPtr<FileSystem>, 32> file_systems;
+    m_file_systems_list.with([&](auto const& list) {
+        for (auto& fs : list)
+            file_systems.append(fs);
+    });
+
+    size_t released_bytes = 0;
+    for (auto& fs : file_systems)
+        released_bytes += fs->release_cache_memory();
+    return released_bytes;
+}
+
 void VirtualFileSystem::lock_all_filesystems()
 {
     Vector<NonnullRefPtr<FileSystem>, 32> file_systems;
@@ -1184,6 +1199,29 @@ static bool safe_to_follow_symlink(Credentials const& credentials, Inode const&
     return false;
 }
 
+static ErrorOr<NonnullRefPtr<Inode>> lookup_child(Inode& directory, StringView name)
+{
+    if (!DirectoryEntryCache::is_enabled_for(directory))
+        return directory.lookup(name);
+
+    auto& cache = DirectoryEntryCache::the();
+    if (auto cached_child = cache.lookup(directory, name); cached_child.has_value()) {
+        if (!cached_child.value())
+            return ENOENT;
+        return cached_child.release_value().release_nonnull();
+    }
+
+    auto generation = cache.generation();
+    auto child_or_error = directory.lookup(name);
+    if (child_or_error.is_error()) {
+        if (child_or_error.error().code() == ENOENT)
+            cache.add(generation, directory, name, nullptr);
+        return child_or_error.release_error();
+    }
+    cache.add(generation, directory, name, child_or_error.value().ptr());
+    return child_or_error.release_value();
+}
+
 ErrorOr<NonnullRefPtr<Custody>> VirtualFileSystem::resolve_path_without_veil(Credentials const& credentials, StringView path, NonnullRefPtr<Custody> base, RefPtr<Custody>* out_parent, int options, int symlink_recursion_level)
 {
     if (symlink_recursion_level >= symlink_recursion_limit)
@@ -1223,7 +1261,7 @@ ErrorOr<NonnullRefPtr<Custody>> VirtualFileSystem::resolve_path_without_veil(Cre
         }
 
         // Okay, let's look up this part.
-        auto child_or_error = parent.inode().lookup(part);
+        auto child_or_error = lookup_child(parent.inode(), part);
         if (child_or_error.is_error()) {
             if (out_parent) {
                 // ENOENT with a non-null parent custody signals to caller that
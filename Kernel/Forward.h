@@ -22,6 +22,7 @@ class Device;
 class DeviceControlDevice;
 class DiskCache;
 class DoubleBuffer;
+class EventPoll;
 class File;
 class FATInode;
 class OpenFileDescription;
@@ -32,6 +33,7 @@ class IPv4Socket;
 class Inode;
 class InodeIdentifier;
 class InodeWatcher;
+class IORing;
 class MountFile;
 class Jail;
 class KBuffer;
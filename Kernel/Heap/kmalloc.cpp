@@ -10,6 +10,7 @@
 #include <Kernel/Debug.h>
 #include <Kernel/Heap/Heap.h>
 #include <Kernel/Heap/kmalloc.h>
+#include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/Library/Panic.h>
 #include <Kernel/Library/StdLib.h>
@@ -28,6 +29,7 @@ static_assert(is_power_of_two(CHUNK_SIZE));
 
 static constexpr size_t INITIAL_KMALLOC_MEMORY_SIZE = 2 * MiB;
 static constexpr size_t KMALLOC_DEFAULT_ALIGNMENT = 16;
+static constexpr size_t KMALLOC_MAGAZINE_CAPACITY = 16;
 
 // Treat the heap as logically separate from .bss
 __attribute__((section(".heap"))) static u8 initial_kmalloc_memory[INITIAL_KMALLOC_MEMORY_SIZE];
@@ -55,12 +57,13 @@ public:
     static constexpr size_t block_size = 64 * KiB;
     static constexpr FlatPtr block_mask = ~(block_size - 1);
 
-    KmallocSlabBlock(size_t slab_size)
+    KmallocSlabBlock(size_t slab_size, size_t slab_alignment)
         : m_slab_size(slab_size)
-        , m_slab_count((block_size - sizeof(KmallocSlabBlock)) / slab_size)
     {
+        auto first_slab_offset = align_up_to((FlatPtr)&m_data, slab_alignment) - (FlatPtr)&m_data;
+        m_slab_count = (block_size - sizeof(KmallocSlabBlock) - first_slab_offset) / slab_size;
         for (size_t i = 0; i < m_slab_count; ++i) {
-            auto* freelist_entry = (FreelistEntry*)(void*)(&m_data[i * slab_size]);
+            auto* freelist_entry = (FreelistEntry*)(void*)(&m_data[first_slab_offset + i * slab_size]);
             freelist_entry->next = m_freelist;
             m_freelist = freelist_entry;
         }
@@ -129,8 +132,9 @@ private:
 
 class KmallocSlabheap {
 public:
-    KmallocSlabheap(size_t slab_size)
+    KmallocSlabheap(size_t slab_size, size_t slab_alignment = KMALLOC_DEFAULT_ALIGNMENT)
         : m_slab_size(slab_size)
+        , m_slab_alignment(slab_alignment)
     {
     }
 
@@ -146,7 +150,7 @@ public:
                 dbgln_if(KMALLOC_DEBUG, "OOM while growing slabheap ({})", m_slab_size);
                 return nullptr;
             }
-            auto* block = new (slot) KmallocSlabBlock(m_slab_size);
+            auto* block = new (slot) KmallocSlabBlock(m_slab_size, m_slab_alignment);
             m_usable_blocks.append(*block);
         }
         auto* block = m_usable_blocks.first();
@@ -218,11 +222,157 @@ public:
 
 private:
     size_t m_slab_size { 0 };
+    size_t m_slab_alignment { 0 };
 
     KmallocSlabBlock::List m_usable_blocks;
     KmallocSlabBlock::List m_full_blocks;
 };
 
+// A slabheap with a magazine of free objects for every processor in front of it, so that
+// most allocations and frees don't have to take the global kmalloc lock.
+// Objects sitting in a magazine are accounted as allocated by the slabheap.
+class KmallocCache {
+public:
+    KmallocCache(char const* name, size_t slab_size, size_t slab_alignment = KMALLOC_DEFAULT_ALIGNMENT)
+        : m_name(name)
+        , m_slabheap(slab_size, slab_alignment)
+    {
+    }
+
+    char const* name() const { return m_name; }
+    size_t slab_size() const { return m_slabheap.slab_size(); }
+    KmallocSlabheap& slabheap() { return m_slabheap; }
+
+    void* allocate(size_t requested_size, CallerWillInitializeMemory caller_will_initialize_memory)
+    {
+#ifndef HAS_ADDRESS_SANITIZER
+        if (Processor::is_initialized()) {
+            void* ptr = nullptr;
+            {
+                InterruptDisabler disabler;
+                auto& magazine = m_magazines[Processor::current_id()];
+                ++magazine.counters.allocations;
+                if (magazine.count > 0)
+                    ++magazine.counters.magazine_hits;
+                else if (!refill_magazine(magazine))
+                    return nullptr;
+                ptr = magazine.objects[--magazine.count];
+            }
+            if (caller_will_initialize_memory == CallerWillInitializeMemory::No)
+                memset(ptr, KMALLOC_SCRUB_BYTE, slab_size());
+            return ptr;
+        }
+#endif
+        SpinlockLocker lock(s_lock);
+        ++m_early_allocations;
+        return m_slabheap.allocate(requested_size, caller_will_initialize_memory);
+    }
+
+    void deallocate(void* ptr)
+    {
+#ifndef HAS_ADDRESS_SANITIZER
+        if (Processor::is_initialized()) {
+            memset(ptr, KFREE_SCRUB_BYTE, slab_size());
+            InterruptDisabler disabler;
+            auto& magazine = m_magazines[Processor::current_id()];
+            ++magazine.counters.frees;
+            if (magazine.count == KMALLOC_MAGAZINE_CAPACITY)
+                flush_magazine(magazine);
+            magazine.objects[magazine.count++] = ptr;
+            return;
+        }
+#endif
+        SpinlockLocker lock(s_lock);
+        ++m_early_frees;
+        m_slabheap.deallocate(ptr);
+    }
+
+    // NOTE: Needs to be called with the kmalloc lock held.
+    kmalloc_cache_stats statistics() const
+    {
+        kmalloc_cache_stats stats {};
+        stats.name = m_name;
+        stats.object_size = m_slabheap.slab_size();
+        stats.allocations = m_early_allocations;
+        stats.frees = m_early_frees;
+        // NOTE: The counters are only ever written by their own processor, so these might be slightly out of date.
+        for (auto const& magazine : m_magazines) {
+            stats.allocations += magazine.counters.allocations;
+            stats.frees += magazine.counters.frees;
+            stats.magazine_hits += magazine.counters.magazine_hits;
+            stats.magazine_refills += magazine.counters.magazine_refills;
+            stats.magazine_flushes += magazine.counters.magazine_flushes;
+            stats.contended_lock_acquisitions += magazine.counters.contended_lock_acquisitions;
+            stats.cached_objects += magazine.count;
+        }
+        stats.bytes_allocated = m_slabheap.allocated_bytes();
+        stats.bytes_free = m_slabheap.free_bytes();
+        return stats;
+    }
+
+    IntrusiveListNode<KmallocCache> list_node;
+    using List = IntrusiveList<&KmallocCache::list_node>;
+
+private:
+    struct Counters {
+        size_t allocations { 0 };
+        size_t frees { 0 };
+        size_t magazine_hits { 0 };
+        size_t magazine_refills { 0 };
+        size_t magazine_flushes { 0 };
+        size_t contended_lock_acquisitions { 0 };
+    };
+
+    struct Magazine {
+        void* objects[KMALLOC_MAGAZINE_CAPACITY];
+        size_t count { 0 };
+        Counters counters;
+    };
+
+    static void note_kmalloc_lock_acquisition(Magazine& magazine)
+    {
+        if (s_lock.is_locked() && !s_lock.is_locked_by_current_processor())
+            ++magazine.counters.contended_lock_acquisitions;
+    }
+
+    bool refill_magazine(Magazine& magazine)
+    {
+        note_kmalloc_lock_acquisition(magazine);
+        SpinlockLocker lock(s_lock);
+        ++magazine.counters.magazine_refills;
+        // NOTE: Growing the slabheap may end up in kmalloc() again, which is fine as long as we only
+        //       touch the magazine in between slabheap calls.
+        while (magazine.count < KMALLOC_MAGAZINE_CAPACITY / 2) {
+            auto* ptr = m_slabheap.allocate(m_slabheap.slab_size(), CallerWillInitializeMemory::Yes);
+            if (!ptr)
+                break;
+            magazine.objects[magazine.count++] = ptr;
+        }
+        return magazine.count > 0;
+    }
+
+    void flush_magazine(Magazine& magazine)
+    {
+        note_kmalloc_lock_acquisition(magazine);
+        SpinlockLocker lock(s_lock);
+        ++magazine.counters.magazine_flushes;
+        // Give back the objects that were freed the longest time ago, and keep the cache-hot ones.
+        constexpr size_t flush_count = KMALLOC_MAGAZINE_CAPACITY / 2;
+        for (size_t i = 0; i < flush_count; ++i)
+            m_slabheap.deallocate(magazine.objects[i]);
+        for (size_t i = flush_count; i < magazine.count; ++i)
+            magazine.objects[i - flush_count] = magazine.objects[i];
+        magazine.count -= flush_count;
+    }
+
+    char const* m_name { nullptr };
+    KmallocSlabheap m_slabheap;
+    Magazine m_magazines[KERNEL_MAX_CPU_COUNT];
+    // Allocations that happened before the processor was initialized.
+    size_t m_early_allocations { 0 };
+    size_t m_early_frees { 0 };
+};
+
 struct KmallocGlobalData {
     static constexpr size_t minimum_subheap_size = 1 * MiB;
 
@@ -239,15 +389,20 @@ struct KmallocGlobalData {
         subheaps.append(*subheap);
     }
 
+    KmallocCache* cache_for(size_t size, size_t alignment)
+    {
+        for (auto& cache : slab_caches) {
+            if (size <= cache.slab_size() && alignment <= cache.slab_size())
+                return &cache;
+        }
+        return nullptr;
+    }
+
+    // NOTE: Allocations that fit into a slab are served by the slab caches instead, see kmalloc_impl().
     void* allocate(size_t size, size_t alignment, CallerWillInitializeMemory caller_will_initialize_memory)
     {
         VERIFY(!expansion_in_progress);
 
-        for (auto& slabheap : slabheaps) {
-            if (size <= slabheap.slab_size() && alignment <= slabheap.slab_size())
-                return slabheap.allocate(size, caller_will_initialize_memory);
-        }
-
         for (auto& subheap : subheaps) {
             if (auto* ptr = subheap.allocator.allocate(size, alignment, caller_will_initialize_memory))
                 return ptr;
@@ -258,13 +413,12 @@ struct KmallocGlobalData {
             // FIXME: We should propagate a freed pointer, to find the specific subheap it belonged to
             //        This would save us iterating over them in the next step and remove a recursion
             bool did_purge = false;
-            for (auto& slabheap : slabheaps) {
-                if (slabheap.try_purge()) {
-                    dbgln_if(KMALLOC_DEBUG, "Kmalloc purged block(s) from slabheap of size {} to avoid expansion", slabheap.slab_size());
-                    did_purge = true;
-                    break;
-                }
-            }
+            for_each_cache([&](KmallocCache& cache) {
+                if (did_purge || !cache.slabheap().try_purge())
+                    return;
+                dbgln_if(KMALLOC_DEBUG, "Kmalloc purged block(s) from slab cache {} to avoid expansion", cache.name());
+                did_purge = true;
+            });
             if (did_purge)
                 return allocate(size, alignment, caller_will_initialize_memory);
         }
@@ -281,11 +435,7 @@ struct KmallocGlobalData {
     {
         VERIFY(!expansion_in_progress);
         VERIFY(is_valid_kmalloc_address(VirtualAddress { ptr }));
-
-        for (auto& slabheap : slabheaps) {
-            if (size <= slabheap.slab_size())
-                return slabheap.deallocate(ptr);
-        }
+        (void)size;
 
         for (auto& subheap : subheaps) {
             if (subheap.allocator.contains(ptr)) {
@@ -297,23 +447,21 @@ struct KmallocGlobalData {
         PANIC("Bogus pointer passed to kfree_sized({:p}, {})", ptr, size);
     }
 
-    size_t allocated_bytes() const
+    size_t allocated_bytes()
     {
         size_t total = 0;
         for (auto const& subheap : subheaps)
             total += subheap.allocator.allocated_bytes();
-        for (auto const& slabheap : slabheaps)
-            total += slabheap.allocated_bytes();
+        for_each_cache([&](KmallocCache& cache) { total += cache.slabheap().allocated_bytes(); });
         return total;
     }
 
-    size_t free_bytes() const
+    size_t free_bytes()
     {
         size_t total = 0;
         for (auto const& subheap : subheaps)
             total += subheap.allocator.free_bytes();
-        for (auto const& slabheap : slabheaps)
-            total += slabheap.free_bytes();
+        for_each_cache([&](KmallocCache& cache) { total += cache.slabheap().free_bytes(); });
         return total;
     }
 
@@ -410,9 +558,26 @@ struct KmallocGlobalData {
         return expansion_data->virtual_range.contains(vaddr);
     }
 
+    template<typename Callback>
+    void for_each_cache(Callback callback)
+    {
+        for (auto& cache : slab_caches)
+            callback(cache);
+        for (auto& cache : typed_caches)
+            callback(cache);
+    }
+
     KmallocSubheap::List subheaps;
 
-    KmallocSlabheap slabheaps[6] = { 16, 32, 64, 128, 256, 512 };
+    KmallocCache slab_caches[6] = {
+        { "kmalloc-16", 16 },
+        { "kmalloc-32", 32 },
+        { "kmalloc-64", 64 },
+        { "kmalloc-128", 128 },
+        { "kmalloc-256", 256 },
+        { "kmalloc-512", 512 },
+    };
+    KmallocCache::List typed_caches;
 
     bool expansion_in_progress { false };
 };
@@ -439,6 +604,19 @@ UNMAP_AFTER_INIT void kmalloc_init()
     s_lock.initialize();
 }
 
+static void did_kmalloc(size_t size, void* ptr)
+{
+    Thread* current_thread = Thread::current();
+    if (!current_thread)
+        current_thread = Processor::idle_thread();
+    if (current_thread) {
+        // FIXME: By the time we check this, we have already allocated above.
+        //        This means that in the case of an infinite recursion, we can't catch it this way.
+        VERIFY(current_thread->is_allocation_enabled());
+        PerformanceManager::add_kmalloc_perf_event(*current_thread, size, (FlatPtr)ptr);
+    }
+}
+
 static void* kmalloc_impl(size_t size, size_t alignment, CallerWillInitializeMemory caller_will_initialize_memory)
 {
     // Catch bad callers allocating under spinlock.
@@ -449,26 +627,22 @@ static void* kmalloc_impl(size_t size, size_t alignment, CallerWillInitializeMem
     // Alignment must be a power of two.
     VERIFY(is_power_of_two(alignment));
 
-    SpinlockLocker lock(s_lock);
-    ++g_kmalloc_call_count;
-
     if (g_dump_kmalloc_stacks && Kernel::g_kernel_symbols_available.was_set()) {
+        SpinlockLocker lock(s_lock);
         dbgln("kmalloc({})", size);
         Kernel::dump_backtrace();
     }
 
-    void* ptr = g_kmalloc_global->allocate(size, alignment, caller_will_initialize_memory);
-
-    Thread* current_thread = Thread::current();
-    if (!current_thread)
-        current_thread = Processor::idle_thread();
-    if (current_thread) {
-        // FIXME: By the time we check this, we have already allocated above.
-        //        This means that in the case of an infinite recursion, we can't catch it this way.
-        VERIFY(current_thread->is_allocation_enabled());
-        PerformanceManager::add_kmalloc_perf_event(*current_thread, size, (FlatPtr)ptr);
+    void* ptr = nullptr;
+    if (auto* cache = g_kmalloc_global->cache_for(size, alignment)) {
+        ptr = cache->allocate(size, caller_will_initialize_memory);
+    } else {
+        SpinlockLocker lock(s_lock);
+        ++g_kmalloc_call_count;
+        ptr = g_kmalloc_global->allocate(size, alignment, caller_will_initialize_memory);
     }
 
+    did_kmalloc(size, ptr);
     return ptr;
 }
 
@@ -488,6 +662,17 @@ void* kcalloc(size_t count, size_t size)
     return ptr;
 }
 
+static void did_kfree(void* ptr)
+{
+    Thread* current_thread = Thread::current();
+    if (!current_thread)
+        current_thread = Processor::idle_thread();
+    if (current_thread) {
+        VERIFY(current_thread->is_allocation_enabled());
+        PerformanceManager::add_kfree_perf_event(*current_thread, 0, (FlatPtr)ptr);
+    }
+}
+
 void kfree_sized(void* ptr, size_t size)
 {
     if (!ptr)
@@ -500,19 +685,18 @@ void kfree_sized(void* ptr, size_t size)
         Processor::verify_no_spinlocks_held();
     }
 
+    if (auto* cache = g_kmalloc_global->cache_for(size, 1)) {
+        did_kfree(ptr);
+        cache->deallocate(ptr);
+        return;
+    }
+
     SpinlockLocker lock(s_lock);
     ++g_kfree_call_count;
     ++g_nested_kfree_calls;
 
-    if (g_nested_kfree_calls == 1) {
-        Thread* current_thread = Thread::current();
-        if (!current_thread)
-            current_thread = Processor::idle_thread();
-        if (current_thread) {
-            VERIFY(current_thread->is_allocation_enabled());
-            PerformanceManager::add_kfree_perf_event(*current_thread, 0, (FlatPtr)ptr);
-        }
-    }
+    if (g_nested_kfree_calls == 1)
+        did_kfree(ptr);
 
     g_kmalloc_global->deallocate(ptr, size);
     --g_nested_kfree_calls;
@@ -522,10 +706,8 @@ size_t kmalloc_good_size(size_t size)
 {
     VERIFY(size > 0);
     // NOTE: There's no need to take the kmalloc lock, as the kmalloc slab-heaps (and their sizes) are constant
-    for (auto const& slabheap : g_kmalloc_global->slabheaps) {
-        if (size <= slabheap.slab_size())
-            return slabheap.slab_size();
-    }
+    if (auto* cache = g_kmalloc_global->cache_for(size, 1))
+        return cache->slab_size();
     return round_up_to_power_of_two(size + Heap<CHUNK_SIZE>::AllocationHeaderSize, CHUNK_SIZE) - Heap<CHUNK_SIZE>::AllocationHeaderSize;
 }
 
@@ -604,4 +786,79 @@ void get_kmalloc_stats(kmalloc_stats& stats)
     stats.bytes_free = g_kmalloc_global->free_bytes();
     stats.kmalloc_call_count = g_kmalloc_call_count;
     stats.kfree_call_count = g_kfree_call_count;
+    g_kmalloc_global->for_each_cache([&](KmallocCache& cache) {
+        auto cache_stats = cache.statistics();
+        stats.kmalloc_call_count += cache_stats.allocations;
+        stats.kfree_call_count += cache_stats.frees;
+    });
+}
+
+size_t get_kmalloc_cache_stats(kmalloc_cache_stats* buffer, size_t max_count)
+{
+    SpinlockLocker lock(s_lock);
+    size_t cache_count = 0;
+    g_kmalloc_global->for_each_cache([&](KmallocCache& cache) {
+        if (cache_count < max_count)
+            buffer[cache_count] = cache.statistics();
+        ++cache_count;
+    });
+    return cache_count;
+}
+
+KmallocCache* KmallocSlabCache::ensure_cache()
+{
+    if (auto* cache = AK::atomic_load(&m_cache, AK::MemoryOrder::memory_order_acquire))
+        return cache;
+
+    auto* storage = kmalloc(sizeof(KmallocCache));
+    if (!storage)
+        return nullptr;
+
+    SpinlockLocker lock(s_lock);
+    if (m_cache) {
+        // Someone else was faster.
+        kfree_sized(storage, sizeof(KmallocCache));
+        return m_cache;
+    }
+
+    auto slab_size = round_up_to_power_of_two(max(m_object_size, sizeof(void*)), max(m_alignment, KMALLOC_DEFAULT_ALIGNMENT));
+    auto* cache = new (storage) KmallocCache(m_name, slab_size, max(m_alignment, KMALLOC_DEFAULT_ALIGNMENT));
+    g_kmalloc_global->typed_caches.append(*cache);
+    AK::atomic_store(&m_cache, cache, AK::MemoryOrder::memory_order_release);
+    return cache;
+}
+
+void* KmallocSlabCache::allocate(size_t size)
+{
+    // Subclasses that don't have their own slab cache end up here as well.
+    if (size != m_object_size)
+        return kmalloc_aligned(size, max(m_alignment, KMALLOC_DEFAULT_ALIGNMENT));
+
+    if constexpr (KMALLOC_VERIFY_NO_SPINLOCK_HELD) {
+        Processor::verify_no_spinlocks_held();
+    }
+
+    auto* cache = ensure_cache();
+    if (!cache)
+        return nullptr;
+    auto* ptr = cache->allocate(size, CallerWillInitializeMemory::No);
+    did_kmalloc(size, ptr);
+    return ptr;
+}
+
+void KmallocSlabCache::deallocate(void* ptr, size_t size)
+{
+    if (!ptr)
+        return;
+
+    if (size != m_object_size) {
+        kfree_sized(ptr, size);
+        return;
+    }
+
+    // NOTE: The cache has to exist already, since we allocated this object from it.
+    auto* cache = AK::atomic_load(&m_cache, AK::MemoryOrder::memory_order_acquire);
+    VERIFY(cache);
+    did_kfree(ptr);
+    cache->deallocate(ptr);
 }
@@ -31,6 +31,31 @@ public:                                                                      \
                                                                              \
 private:
 
+// Allocates objects of this type from a dedicated slab cache with per-processor magazines.
+// The cache itself has to be defined with KMALLOC_DEFINE_SLAB_CACHE(type) in a .cpp file.
+#define MAKE_SLAB_CACHE_ALLOCATED(type)                                                 \
+public:                                                                                 \
+    [[nodiscard]] void* operator new(size_t size)                                       \
+    {                                                                                   \
+        void* ptr = s_slab_cache.allocate(size);                                        \
+        VERIFY(ptr);                                                                    \
+        return ptr;                                                                     \
+    }                                                                                   \
+    [[nodiscard]] void* operator new(size_t size, std::nothrow_t const&) noexcept       \
+    {                                                                                   \
+        return s_slab_cache.allocate(size);                                             \
+    }                                                                                   \
+    void operator delete(void* ptr, size_t size) noexcept                               \
+    {                                                                                   \
+        s_slab_cache.deallocate(ptr, size);                                             \
+    }                                                                                   \
+                                                                                        \
+private:                                                                                \
+    static KmallocSlabCache s_slab_cache
+
+#define KMALLOC_DEFINE_SLAB_CACHE(type) \
+    constinit KmallocSlabCache type::s_slab_cache { #type, sizeof(type), alignof(type) }
+
 // The C++ standard specifies that the nothrow allocation tag should live in the std namespace.
 // Otherwise, `new (std::nothrow)` calls wouldn't get resolved.
 namespace std { // NOLINT(cert-dcl58-cpp) These declarations must be in ::std and we are not using <new>
@@ -55,6 +80,45 @@ struct kmalloc_stats {
 };
 void get_kmalloc_stats(kmalloc_stats&);
 
+struct kmalloc_cache_stats {
+    char const* name;
+    size_t object_size;
+    size_t allocations;
+    size_t frees;
+    size_t magazine_hits;
+    size_t magazine_refills;
+    size_t magazine_flushes;
+    size_t contended_lock_acquisitions;
+    size_t cached_objects;
+    size_t bytes_allocated;
+    size_t bytes_free;
+};
+// Fills in the statistics of up to max_count slab caches, and returns the total number of caches.
+size_t get_kmalloc_cache_stats(kmalloc_cache_stats*, size_t max_count);
+
+class KmallocCache;
+
+class KmallocSlabCache {
+public:
+    constexpr KmallocSlabCache(char const* name, size_t object_size, size_t alignment)
+        : m_name(name)
+        , m_object_size(object_size)
+        , m_alignment(alignment)
+    {
+    }
+
+    [[nodiscard]] void* allocate(size_t);
+    void deallocate(void*, size_t);
+
+private:
+    KmallocCache* ensure_cache();
+
+    char const* m_name { nullptr };
+    size_t m_object_size { 0 };
+    size_t m_alignment { 0 };
+    KmallocCache* m_cache { nullptr }; // Created on first use.
+};
+
 extern bool g_dump_kmalloc_stacks;
 
 inline void* operator new(size_t, void* p) { return p; }
@@ -37,6 +37,10 @@ public:
 
     bool is_empty() const { return m_empty; }
 
+    size_t capacity() const { return m_capacity; }
+    // Never shrinks below the amount of data that is currently buffered.
+    ErrorOr<void> try_set_capacity(size_t);
+
     size_t space_for_writing() const { return m_space_for_writing; }
     size_t immediately_readable() const
     {
@@ -50,12 +54,14 @@ public:
     }
 
 private:
-    explicit DoubleBuffer(size_t capacity, NonnullOwnPtr<KBuffer> storage);
+    explicit DoubleBuffer(StringView name, size_t capacity, NonnullOwnPtr<KBuffer> storage);
     void flip();
     void compute_lockfree_metadata();
 
     ErrorOr<size_t> read_impl(UserOrKernelBuffer&, size_t, MutexLocker&, bool advance_buffer_index);
 
+    StringView m_name;
+
     struct InnerBuffer {
         u8* data { nullptr };
         size_t size { 0 };
@@ -5,18 +5,26 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ScopeGuard.h>
 #include <AK/SetOnce.h>
 #include <Kernel/Debug.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/Locking/LockLocation.h>
 #include <Kernel/Locking/Mutex.h>
 #include <Kernel/Locking/Spinlock.h>
+#include <Kernel/Tasks/PerformanceManager.h>
 #include <Kernel/Tasks/Thread.h>
+#include <Kernel/Time/TimeManagement.h>
 
 extern SetOnce g_not_in_early_boot;
 
 namespace Kernel {
 
+// How often we check whether the holder of a contended mutex is still running before giving up and blocking,
+// and how long we pause between those checks.
+static constexpr size_t max_adaptive_spin_attempts = 64;
+static constexpr size_t pauses_per_adaptive_spin_attempt = 32;
+
 void Mutex::lock(Mode mode, [[maybe_unused]] LockLocation const& location)
 {
     // NOTE: This may be called from an interrupt handler (not an IRQ handler)
@@ -31,6 +39,22 @@ void Mutex::lock(Mode mode, [[maybe_unused]] LockLocation const& location)
     auto* current_thread = Thread::current();
 
     SpinlockLocker lock(m_lock);
+
+    Optional<MonotonicTime> contention_start;
+    auto note_contention = [&] {
+        if (current_thread && !contention_start.has_value() && PerformanceManager::is_profiling_mutex_contention(*current_thread))
+            contention_start = TimeManagement::the().monotonic_time(TimePrecision::Precise);
+    };
+    ScopeGuard report_contention = [&] {
+        if (contention_start.has_value())
+            PerformanceManager::add_mutex_wait_event(*current_thread, *this, TimeManagement::the().monotonic_time(TimePrecision::Precise) - contention_start.value());
+    };
+
+    if (m_mode == Mode::Exclusive && m_holder != bit_cast<uintptr_t>(current_thread)) {
+        note_contention();
+        spin_while_holder_is_running(lock);
+    }
+
     bool did_block = false;
     Mode current_mode = m_mode;
     switch (current_mode) {
@@ -41,6 +65,8 @@ void Mutex::lock(Mode mode, [[maybe_unused]] LockLocation const& location)
         VERIFY(m_shared_holders == 0);
         if (mode == Mode::Exclusive) {
             m_holder = bit_cast<uintptr_t>(current_thread);
+            if (current_thread)
+                did_acquire_exclusively(*current_thread);
         } else {
             VERIFY(mode == Mode::Shared);
             ++m_shared_holders;
@@ -61,10 +87,13 @@ void Mutex::lock(Mode mode, [[maybe_unused]] LockLocation const& location)
     case Mode::Exclusive: {
         VERIFY(m_holder);
         if (m_holder != bit_cast<uintptr_t>(current_thread)) {
+            note_contention();
             block(*current_thread, mode, lock, 1);
             did_block = true;
             // If we blocked then m_mode should have been updated to what we requested
             VERIFY(m_mode == mode);
+            if (m_mode == Mode::Exclusive)
+                did_acquire_exclusively(*current_thread);
         }
 
         if (m_mode == Mode::Exclusive) {
@@ -107,9 +136,11 @@ void Mutex::lock(Mode mode, [[maybe_unused]] LockLocation const& location)
             // and is asking to upgrade the lock to be exclusive without first releasing the shared lock. We have no
             // allocation-free way to detect such a scenario, so if you suspect that this is the cause of your deadlock,
             // try turning on LOCK_SHARED_UPGRADE_DEBUG.
+            note_contention();
             block(*current_thread, mode, lock, 1);
             did_block = true;
             VERIFY(m_mode == mode);
+            did_acquire_exclusively(*current_thread);
         }
 
         dbgln_if(LOCK_TRACE_DEBUG, "Mutex::lock @ {} ({}): acquire {}, currently shared, locks held {}", this, m_name, mode_to_string(mode), m_times_locked);
@@ -203,6 +234,16 @@ void Mutex::unlock()
     if (m_times_locked == 0) {
         VERIFY(current_mode == Mode::Exclusive ? !m_holder : m_shared_holders == 0);
 
+        if (current_mode == Mode::Exclusive && m_exclusively_acquired_at.has_value()) {
+            auto hold_time = TimeManagement::the().monotonic_time(TimePrecision::Precise) - m_exclusively_acquired_at.release_value();
+            bool has_waiters = m_blocked_thread_lists.with([](auto& lists) {
+                return !lists.exclusive.is_empty() || !lists.shared.is_empty() || !lists.exclusive_big_lock.is_empty();
+            });
+            // Uncontended critical sections are not interesting, no matter how long they are.
+            if (has_waiters && current_thread)
+                PerformanceManager::add_mutex_hold_event(*current_thread, *this, hold_time);
+        }
+
         m_mode = Mode::Unlocked;
         unblock_waiters(current_mode);
     }
@@ -244,6 +285,35 @@ void Mutex::block(Thread& current_thread, Mode mode, SpinlockLocker<Spinlock<Loc
     });
 }
 
+void Mutex::spin_while_holder_is_running(SpinlockLocker<Spinlock<LockRank::None>>& lock)
+{
+    // If the holder is currently running on another processor, it is likely to release the mutex soon,
+    // so spinning for a short while is much cheaper than going through the scheduler twice. If it isn't
+    // running (or is waiting for our processor), spinning would only delay it further, so we block right away.
+    for (size_t attempt = 0; attempt < max_adaptive_spin_attempts; ++attempt) {
+        if (m_mode != Mode::Exclusive)
+            return;
+
+        // NOTE: The holder can't go away while we hold m_lock, as it would have to unlock the mutex first.
+        auto const* holder = bit_cast<Thread const*>(m_holder);
+        if (holder->state() != Thread::State::Running || holder->cpu() == Processor::current_id())
+            return;
+
+        lock.unlock();
+        for (size_t i = 0; i < pauses_per_adaptive_spin_attempt; ++i)
+            Processor::pause();
+        lock.lock();
+    }
+}
+
+void Mutex::did_acquire_exclusively(Thread& current_thread)
+{
+    if (PerformanceManager::is_profiling_mutex_contention(current_thread))
+        m_exclusively_acquired_at = TimeManagement::the().monotonic_time(TimePrecision::Precise);
+    else
+        m_exclusively_acquired_at.clear();
+}
+
 void Mutex::unblock_waiters(Mode previous_mode)
 {
     VERIFY(m_times_locked == 0);
@@ -310,6 +380,7 @@ auto Mutex::force_unlock_exclusive_if_locked(u32& lock_count_to_restore) -> Mode
         current_thread->holding_lock(*this, -(int)m_times_locked, {});
 #endif
         m_holder = 0;
+        m_exclusively_acquired_at.clear();
         VERIFY(m_times_locked > 0);
         lock_count_to_restore = m_times_locked;
         m_times_locked = 0;
@@ -336,6 +407,8 @@ void Mutex::restore_exclusive_lock(u32 lock_count, [[maybe_unused]] LockLocation
     auto* current_thread = Thread::current();
     bool did_block = false;
     SpinlockLocker lock(m_lock);
+    if (m_mode == Mode::Exclusive && m_holder != bit_cast<uintptr_t>(current_thread))
+        spin_while_holder_is_running(lock);
     [[maybe_unused]] auto previous_mode = m_mode;
     if (m_mode == Mode::Exclusive && m_holder != bit_cast<uintptr_t>(current_thread)) {
         block(*current_thread, Mode::Exclusive, lock, lock_count);
@@ -351,6 +424,7 @@ void Mutex::restore_exclusive_lock(u32 lock_count, [[maybe_unused]] LockLocation
     if (did_block) {
         VERIFY(m_times_locked > 0);
         VERIFY(m_holder == bit_cast<uintptr_t>(current_thread));
+        did_acquire_exclusively(*current_thread);
     } else {
         if (m_mode == Mode::Unlocked) {
             m_mode = Mode::Exclusive;
@@ -358,6 +432,7 @@ void Mutex::restore_exclusive_lock(u32 lock_count, [[maybe_unused]] LockLocation
             m_times_locked = lock_count;
             VERIFY(!m_holder);
             m_holder = bit_cast<uintptr_t>(current_thread);
+            did_acquire_exclusively(*current_thread);
         } else {
             VERIFY(m_mode == Mode::Exclusive);
             VERIFY(m_holder == bit_cast<uintptr_t>(current_thread));
@@ -10,6 +10,8 @@
 #include <AK/Assertions.h>
 #include <AK/Atomic.h>
 #include <AK/HashMap.h>
+#include <AK/Optional.h>
+#include <AK/Time.h>
 #include <AK/Types.h>
 #include <Kernel/Forward.h>
 #include <Kernel/Locking/LockLocation.h>
@@ -85,6 +87,8 @@ private:
     // FIXME: Allow any lock rank.
     void block(Thread&, Mode, SpinlockLocker<Spinlock<LockRank::None>>&, u32);
     void unblock_waiters(Mode);
+    void spin_while_holder_is_running(SpinlockLocker<Spinlock<LockRank::None>>&);
+    void did_acquire_exclusively(Thread&);
 
     StringView m_name;
     Mode m_mode { Mode::Unlocked };
@@ -125,6 +129,10 @@ private:
 #if LOCK_SHARED_UPGRADE_DEBUG
     HashMap<uintptr_t, u32> m_shared_holders_map;
 #endif
+
+    // Only recorded while mutex contention is being profiled, so that we can report how long
+    // a contended lock was held for when it gets released.
+    Optional<MonotonicTime> m_exclusively_acquired_at;
 };
 
 class MutexLocker {
@@ -12,6 +12,7 @@
 #include <Kernel/Memory/AnonymousVMObject.h>
 #include <Kernel/Memory/InodeVMObject.h>
 #include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Memory/TLBFlushBatch.h>
 #include <Kernel/Security/Random.h>
 #include <Kernel/Tasks/PerformanceManager.h>
 #include <Kernel/Tasks/PowerStateSwitchTask.h>
@@ -108,23 +109,31 @@ ErrorOr<void> AddressSpace::unmap_mmap_range(VirtualAddress addr, size_t size)
 
     Vector<Region*, 2> new_regions;
 
+    // The unmapped regions (and with them their physical pages) have to stay alive until the TLB
+    // flush batch has been flushed, which happens once for all of them before they are destroyed.
+    Vector<NonnullOwnPtr<Region>, 2> unmapped_regions;
+    TRY(unmapped_regions.try_ensure_capacity(regions.size()));
+    TLBFlushBatch tlb_flush_batch(page_directory());
+
     for (auto* old_region : regions) {
+        // Remove the old region from our regions tree. If it's not a full match, we're going to
+        // add another region with the exact same start address.
+        unmapped_regions.unchecked_append(take_region(*old_region));
+        auto& region = *unmapped_regions.last();
+        region.unmap(ShouldFlushTLB::No);
+        tlb_flush_batch.add(region.vaddr(), region.page_count());
+
         // If it's a full match we can remove the entire old region.
-        if (old_region->range().intersect(range_to_unmap).size() == old_region->size()) {
-            deallocate_region(*old_region);
+        if (region.range().intersect(range_to_unmap).size() == region.size())
             continue;
-        }
-
-        // Remove the old region from our regions tree, since were going to add another region
-        // with the exact same start address.
-        auto region = take_region(*old_region);
-        region->unmap();
 
         // Otherwise, split the regions and collect them for future mapping.
-        auto split_regions = TRY(try_split_region_around_range(*region, range_to_unmap));
+        auto split_regions = TRY(try_split_region_around_range(region, range_to_unmap));
         TRY(new_regions.try_extend(split_regions));
     }
 
+    tlb_flush_batch.flush();
+
     // And finally map the new region(s) into our page directory.
     for (auto* new_region : new_regions) {
         // TODO: Ideally we should do this in a way that can be rolled back on failure, as failing here
@@ -148,6 +157,7 @@ ErrorOr<Region*> AddressSpace::try_allocate_split_region(Region const& source_re
     new_region->set_syscall_region(source_region.is_syscall_region());
     new_region->set_mmap(source_region.is_mmap(), source_region.mmapped_from_readable(), source_region.mmapped_from_writable());
     new_region->set_stack(source_region.is_stack());
+    new_region->set_wants_huge_pages(source_region.wants_huge_pages());
     size_t page_offset_in_source_region = (offset_in_vmobject - source_region.offset_in_vmobject()) / PAGE_SIZE;
     for (size_t i = 0; i < new_region->page_count(); ++i) {
         if (source_region.should_cow(page_offset_in_source_region + i))
@@ -143,6 +143,7 @@ ErrorOr<NonnullLockRefPtr<AnonymousVMObject>> AnonymousVMObject::try_create_with
 AnonymousVMObject::AnonymousVMObject(FixedArray<RefPtr<PhysicalRAMPage>>&& new_physical_pages, AllocationStrategy strategy, Optional<CommittedPhysicalPageSet> committed_pages)
     : VMObject(move(new_physical_pages))
     , m_unused_committed_pages(move(committed_pages))
+    , m_has_movable_pages(true)
 {
     if (strategy == AllocationStrategy::AllocateNow) {
         // Allocate all pages right now. We know we can get all because we committed the amount needed
@@ -172,6 +173,7 @@ AnonymousVMObject::AnonymousVMObject(LockWeakPtr<AnonymousVMObject> other, Nonnu
     : VMObject(move(new_physical_pages))
     , m_cow_parent(move(other))
     , m_shared_committed_cow_pages(move(shared_committed_cow_pages))
+    , m_has_movable_pages(true)
     , m_purgeable(m_cow_parent.strong_ref()->m_purgeable)
 {
 }
@@ -214,6 +216,53 @@ size_t AnonymousVMObject::purge()
     return total_pages_purged;
 }
 
+size_t AnonymousVMObject::migrate_pages(Badge<MemoryManager>, PhysicalAddress lower, PhysicalAddress upper, Span<RefPtr<PhysicalRAMPage>> replacement_pages)
+{
+    if (!m_has_movable_pages)
+        return 0;
+
+    SpinlockLocker lock(m_lock);
+
+    // Kernel code may have handed out the physical addresses of its memory (e.g. to a device), so leave it alone.
+    bool has_user_regions_only = true;
+    size_t region_count = 0;
+    for_each_region([&](Region& region) {
+        ++region_count;
+        if (!region.is_user())
+            has_user_regions_only = false;
+    });
+    if (region_count == 0 || !has_user_regions_only)
+        return 0;
+
+    size_t migrated_page_count = 0;
+    for (size_t page_index = 0; page_index < page_count() && migrated_page_count < replacement_pages.size(); ++page_index) {
+        auto& page_slot = m_physical_pages[page_index];
+        if (!page_slot || page_slot->is_shared_zero_page() || page_slot->is_lazy_committed_page())
+            continue;
+        if (page_slot->paddr() < lower || page_slot->paddr() >= upper)
+            continue;
+        // Pages shared with other VMObjects (COW after fork) or referenced by anyone else have to stay where they are.
+        if (page_slot->ref_count() != 1)
+            continue;
+
+        // Unmap the page first, so nobody can write to it behind our back while it's being copied.
+        // Anyone touching it in the meantime faults and waits for our lock, then maps the new page.
+        for_each_region([&](Region& region) {
+            region.unmap_vmobject_page(page_index);
+        });
+
+        auto& replacement_page = replacement_pages[migrated_page_count++];
+        VERIFY(replacement_page);
+        u8 page_buffer[PAGE_SIZE];
+        MM.copy_physical_page(*page_slot, page_buffer);
+        auto* quickmapped_page = MM.quickmap_page(*replacement_page);
+        memcpy(quickmapped_page, page_buffer, PAGE_SIZE);
+        MM.unquickmap_page();
+        swap(page_slot, replacement_page);
+    }
+    return migrated_page_count;
+}
+
 ErrorOr<void> AnonymousVMObject::set_volatile(bool is_volatile, bool& was_purged)
 {
     VERIFY(is_purgeable());
@@ -276,6 +325,34 @@ NonnullRefPtr<PhysicalRAMPage> AnonymousVMObject::allocate_committed_page(Badge<
     return m_unused_committed_pages->take_one();
 }
 
+bool AnonymousVMObject::try_install_huge_page_block(Badge<Region>, size_t first_page_index, Span<NonnullRefPtr<PhysicalRAMPage>> physical_pages)
+{
+    SpinlockLocker lock(m_lock);
+
+    // Pages shared with a fork()'ed relative have to be copied one by one.
+    if (m_shared_committed_cow_pages || !m_cow_parent.is_null())
+        return false;
+
+    if (first_page_index + physical_pages.size() > page_count())
+        return false;
+
+    // Only install the block if none of the pages in it have been faulted in yet.
+    for (size_t i = 0; i < physical_pages.size(); ++i) {
+        auto const& page = m_physical_pages[first_page_index + i];
+        if (!page || !(page->is_shared_zero_page() || page->is_lazy_committed_page()))
+            return false;
+    }
+
+    for (size_t i = 0; i < physical_pages.size(); ++i) {
+        auto& page = m_physical_pages[first_page_index + i];
+        // The block was allocated separately, so give back the pages we had committed for this range.
+        if (page->is_lazy_committed_page())
+            m_unused_committed_pages->uncommit_one();
+        page = physical_pages[i];
+    }
+    return true;
+}
+
 ErrorOr<void> AnonymousVMObject::ensure_cow_map()
 {
     if (m_cow_map.is_null())
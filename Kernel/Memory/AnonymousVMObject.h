@@ -26,6 +26,7 @@ public:
     virtual ErrorOr<NonnullLockRefPtr<VMObject>> try_clone() override;
 
     [[nodiscard]] NonnullRefPtr<PhysicalRAMPage> allocate_committed_page(Badge<Region>);
+    [[nodiscard]] bool try_install_huge_page_block(Badge<Region>, size_t first_page_index, Span<NonnullRefPtr<PhysicalRAMPage>>);
     PageFaultResponse handle_cow_fault(size_t, VirtualAddress);
     size_t cow_pages() const;
     bool should_cow(size_t page_index, bool) const;
@@ -38,6 +39,10 @@ public:
 
     size_t purge();
 
+    // Moves resident pages in [lower, upper) into the given replacement pages, which end up holding the old pages afterwards.
+    // Returns how many of the replacement pages were used up.
+    size_t migrate_pages(Badge<MemoryManager>, PhysicalAddress lower, PhysicalAddress upper, Span<RefPtr<PhysicalRAMPage>> replacement_pages);
+
 private:
     class SharedCommittedCowPages;
 
@@ -85,6 +90,9 @@ private:
     LockWeakPtr<AnonymousVMObject> m_cow_parent;
     LockRefPtr<SharedCommittedCowPages> m_shared_committed_cow_pages;
 
+    // Only pages we allocated ourselves may be moved elsewhere, not the ones someone handed to us (DMA buffers, MMIO, ...)
+    bool m_has_movable_pages { false };
+
     bool m_purgeable { false };
     bool m_volatile { false };
     bool m_was_purged { false };
@@ -1152,6 +1152,8 @@ ErrorOr<CommittedPhysicalPageSet> MemoryManager::commit_physical_pages(size_t pa
 {
     VERIFY(page_count > 0);
     auto result = m_global_data.with([&](auto& global_data) -> ErrorOr<CommittedPhysicalPageSet> {
+        if (global_data.system_memory_info.physical_pages_uncommitted < page_count)
+            drain_free_page_caches(global_data);
         if (global_data.system_memory_info.physical_pages_uncommitted < page_count) {
             dbgln("MM: Unable to commit {} pages, have only {}", page_count, global_data.system_memory_info.physical_pages_uncommitted);
             return ENOMEM;
@@ -1199,7 +1201,18 @@ void MemoryManager::uncommit_physical_pages(Badge<CommittedPhysicalPageSet>, siz
 
 void MemoryManager::deallocate_physical_page(PhysicalAddress paddr)
 {
+    if (try_return_page_to_free_page_cache(paddr))
+        return;
+
     return m_global_data.with([&](auto& global_data) {
+        return_pages_to_physical_regions(global_data, { &paddr, 1 });
+    });
+}
+
+void MemoryManager::return_pages_to_physical_regions(GlobalData& global_data, Span<PhysicalAddress const> pages)
+{
+    for (auto paddr : pages) {
+        bool returned = false;
         // Are we returning a user page?
         for (auto& region : global_data.physical_regions) {
             if (!region->contains(paddr))
@@ -1212,10 +1225,251 @@ void MemoryManager::deallocate_physical_page(PhysicalAddress paddr)
             // committed and allocated are only freed upon request. Once
             // returned there is no guarantee being able to get them back.
             ++global_data.system_memory_info.physical_pages_uncommitted;
+            returned = true;
+            break;
+        }
+        if (!returned)
+            PANIC("MM: deallocate_physical_page couldn't figure out region for page @ {}", paddr);
+    }
+}
+
+// NOTE: A free page cache lock may be taken while holding the global lock (see drain_free_page_caches()), but never
+//       the other way around. This is why the functions below drop the cache lock before talking to the physical regions.
+//       The same goes for the zeroed page pool lock.
+
+RefPtr<PhysicalRAMPage> MemoryManager::take_page_from_free_page_cache()
+{
+    auto* data = Processor::current().get_specific<MemoryManagerData>();
+    if (!data)
+        return nullptr;
+
+    {
+        SpinlockLocker locker(data->m_free_page_cache_lock);
+        if (data->m_free_page_cache_count > 0)
+            return PhysicalRAMPage::create(data->m_free_page_cache[--data->m_free_page_cache_count]);
+    }
+
+    // The cache is empty, grab a whole batch of pages from the physical regions while we have the global lock anyway.
+    Array<PhysicalAddress, MemoryManagerData::free_page_cache_batch_size> batch;
+    size_t batch_count = 0;
+    m_global_data.with([&](auto& global_data) {
+        auto pages_to_take = min(batch.size(), global_data.system_memory_info.physical_pages_uncommitted);
+        for (auto& region : global_data.physical_regions) {
+            while (batch_count < pages_to_take) {
+                auto paddr = region->take_free_page_address();
+                if (!paddr.has_value())
+                    break;
+                batch[batch_count++] = paddr.value();
+            }
+        }
+        global_data.system_memory_info.physical_pages_uncommitted -= batch_count;
+        global_data.system_memory_info.physical_pages_used += batch_count;
+    });
+
+    if (batch_count == 0)
+        return nullptr;
+
+    auto page = batch[--batch_count];
+    if (batch_count > 0) {
+        SpinlockLocker locker(data->m_free_page_cache_lock);
+        auto pages_to_cache = min(batch_count, data->m_free_page_cache.size() - data->m_free_page_cache_count);
+        for (size_t i = 0; i < pages_to_cache; ++i)
+            data->m_free_page_cache[data->m_free_page_cache_count++] = batch[--batch_count];
+    }
+    if (batch_count > 0) {
+        // Someone else filled up the cache in the meantime, give back the rest.
+        m_global_data.with([&](auto& global_data) {
+            return_pages_to_physical_regions(global_data, batch.span().trim(batch_count));
+        });
+    }
+    return PhysicalRAMPage::create(page);
+}
+
+bool MemoryManager::try_return_page_to_free_page_cache(PhysicalAddress paddr)
+{
+    auto* data = Processor::current().get_specific<MemoryManagerData>();
+    if (!data)
+        return false;
+
+    Array<PhysicalAddress, MemoryManagerData::free_page_cache_batch_size> batch;
+    {
+        SpinlockLocker locker(data->m_free_page_cache_lock);
+        if (data->m_free_page_cache_count < data->m_free_page_cache.size()) {
+            data->m_free_page_cache[data->m_free_page_cache_count++] = paddr;
+            return true;
+        }
+
+        // The cache is full, so flush the older half of it and keep the hot pages at the top.
+        for (size_t i = 0; i < batch.size(); ++i)
+            batch[i] = data->m_free_page_cache[i];
+        for (size_t i = batch.size(); i < data->m_free_page_cache_count; ++i)
+            data->m_free_page_cache[i - batch.size()] = data->m_free_page_cache[i];
+        data->m_free_page_cache_count -= batch.size();
+        data->m_free_page_cache[data->m_free_page_cache_count++] = paddr;
+    }
+
+    m_global_data.with([&](auto& global_data) {
+        return_pages_to_physical_regions(global_data, batch.span());
+    });
+    return true;
+}
+
+size_t MemoryManager::drain_free_page_caches(GlobalData& global_data)
+{
+    // NOTE: Processor::count() is not maintained on every architecture, but there is always at least one processor.
+    size_t drained_page_count = 0;
+    auto processor_count = max(Processor::count(), 1u);
+    for (u32 cpu = 0; cpu < processor_count; ++cpu) {
+        auto* data = Processor::by_id(cpu).get_specific<MemoryManagerData>();
+        if (!data)
+            continue;
+        SpinlockLocker locker(data->m_free_page_cache_lock);
+        return_pages_to_physical_regions(global_data, data->m_free_page_cache.span().trim(data->m_free_page_cache_count));
+        drained_page_count += data->m_free_page_cache_count;
+        data->m_free_page_cache_count = 0;
+    }
+    m_zeroed_page_pool.with([&](auto& pool) {
+        return_pages_to_physical_regions(global_data, pool.pages.span().trim(pool.count));
+        drained_page_count += pool.count;
+        pool.count = 0;
+    });
+    if (drained_page_count > 0)
+        dbgln("MM: Drained {} pages from the free page caches", drained_page_count);
+    return drained_page_count;
+}
+
+RefPtr<PhysicalRAMPage> MemoryManager::take_page_from_zeroed_page_pool()
+{
+    return m_zeroed_page_pool.with([](auto& pool) -> RefPtr<PhysicalRAMPage> {
+        if (pool.count == 0)
+            return nullptr;
+        return PhysicalRAMPage::create(pool.pages[--pool.count]);
+    });
+}
+
+bool MemoryManager::is_under_memory_pressure()
+{
+    return m_global_data.with([](auto& global_data) {
+        auto& info = global_data.system_memory_info;
+        return info.physical_pages_uncommitted < info.physical_pages / 16;
+    });
+}
+
+size_t MemoryManager::refill_zeroed_page_pool(size_t max_page_count)
+{
+    Array<PhysicalAddress, MemoryManagerData::free_page_cache_batch_size> batch;
+    size_t batch_count = 0;
+    m_global_data.with([&](auto& global_data) {
+        // Don't hoard memory that is about to be needed elsewhere, keep some of it around for commits and allocations.
+        auto& info = global_data.system_memory_info;
+        auto target_page_count = min<size_t>(ZeroedPagePool::capacity, info.physical_pages / 64);
+        auto reserved_page_count = info.physical_pages / 16;
+        if (info.physical_pages_uncommitted <= reserved_page_count)
             return;
+        auto pool_count = m_zeroed_page_pool.with([](auto& pool) { return pool.count; });
+        if (pool_count >= target_page_count)
+            return;
+        auto pages_to_take = min(min(batch.size(), max_page_count), min(target_page_count - pool_count, info.physical_pages_uncommitted - reserved_page_count));
+        for (auto& region : global_data.physical_regions) {
+            while (batch_count < pages_to_take) {
+                auto paddr = region->take_free_page_address();
+                if (!paddr.has_value())
+                    break;
+                batch[batch_count++] = paddr.value();
+            }
         }
-        PANIC("MM: deallocate_physical_page couldn't figure out region for page @ {}", paddr);
+        info.physical_pages_uncommitted -= batch_count;
+        info.physical_pages_used += batch_count;
     });
+
+    for (size_t i = 0; i < batch_count; ++i) {
+        InterruptDisabler disabler;
+        auto* ptr = quickmap_page(batch[i]);
+        memset(ptr, 0, PAGE_SIZE);
+        unquickmap_page();
+    }
+
+    auto pooled_page_count = m_zeroed_page_pool.with([&](auto& pool) {
+        auto pages_to_pool = min(batch_count, pool.pages.size() - pool.count);
+        for (size_t i = 0; i < pages_to_pool; ++i)
+            pool.pages[pool.count++] = batch[i];
+        return pages_to_pool;
+    });
+    if (pooled_page_count < batch_count) {
+        m_global_data.with([&](auto& global_data) {
+            return_pages_to_physical_regions(global_data, batch.span().slice(pooled_page_count, batch_count - pooled_page_count));
+        });
+    }
+    return pooled_page_count;
+}
+
+size_t MemoryManager::compact_physical_memory()
+{
+    // Compaction empties out one mostly free PhysicalZone by moving the anonymous user pages still living in it
+    // elsewhere. Once those are gone, the buddy allocator coalesces the zone back into large contiguous blocks.
+    static constexpr size_t migration_batch_size = 32;
+
+    PhysicalRegion* physical_region = nullptr;
+    PhysicalZone* zone = nullptr;
+    m_global_data.with([&](auto& global_data) {
+        drain_free_page_caches(global_data);
+        for (auto& region : global_data.physical_regions) {
+            zone = region->select_zone_to_evacuate();
+            if (zone) {
+                physical_region = region.ptr();
+                break;
+            }
+        }
+    });
+    if (!zone)
+        return 0;
+
+    auto lower = zone->base();
+    auto upper = zone->base().offset(zone->page_count() * PAGE_SIZE);
+
+    size_t migrated_page_count = 0;
+    for (;;) {
+        // NOTE: The replacement pages have to be taken up front, since we can't take the global lock while iterating
+        //       over all VMObjects. Whatever is left in here once we're done (the old pages, and any replacement pages
+        //       we didn't need) is freed when this goes out of scope.
+        Array<RefPtr<PhysicalRAMPage>, migration_batch_size> pages;
+        size_t page_count = 0;
+        m_global_data.with([&](auto& global_data) {
+            auto& info = global_data.system_memory_info;
+            auto pages_to_take = min(pages.size(), info.physical_pages_uncommitted);
+            while (page_count < pages_to_take) {
+                auto paddr = physical_region->take_free_page_address_outside_of(*zone);
+                if (!paddr.has_value())
+                    break;
+                pages[page_count++] = PhysicalRAMPage::create(paddr.value());
+            }
+            info.physical_pages_uncommitted -= page_count;
+            info.physical_pages_used += page_count;
+        });
+        if (page_count == 0)
+            break;
+
+        size_t batch_migrated_page_count = 0;
+        for_each_vmobject([&](VMObject& vmobject) {
+            if (vmobject.is_anonymous())
+                batch_migrated_page_count += static_cast<AnonymousVMObject&>(vmobject).migrate_pages({}, lower, upper, pages.span().slice(batch_migrated_page_count, page_count - batch_migrated_page_count));
+            return batch_migrated_page_count == page_count ? IterationDecision::Break : IterationDecision::Continue;
+        });
+        migrated_page_count += batch_migrated_page_count;
+
+        // We've run out of things to move.
+        if (batch_migrated_page_count < page_count)
+            break;
+    }
+
+    // The old pages went into our free page cache, put them back into the zone so it can coalesce.
+    m_global_data.with([&](auto& global_data) {
+        drain_free_page_caches(global_data);
+    });
+
+    if (migrated_page_count > 0)
+        dbgln("MM: Compaction moved {} pages out of the physical zone @ {}", migrated_page_count, lower);
+    return migrated_page_count;
 }
 
 RefPtr<PhysicalRAMPage> MemoryManager::find_free_physical_page(bool committed)
@@ -1249,6 +1503,18 @@ RefPtr<PhysicalRAMPage> MemoryManager::find_free_physical_page(bool committed)
 
 NonnullRefPtr<PhysicalRAMPage> MemoryManager::allocate_committed_physical_page(Badge<CommittedPhysicalPageSet>, ShouldZeroFill should_zero_fill)
 {
+    if (should_zero_fill == ShouldZeroFill::Yes) {
+        if (auto page = take_page_from_zeroed_page_pool()) {
+            // The pooled page was already accounted for as used, so the page we committed to is now free to be used by anyone.
+            m_global_data.with([&](auto& global_data) {
+                VERIFY(global_data.system_memory_info.physical_pages_committed > 0);
+                global_data.system_memory_info.physical_pages_committed--;
+                global_data.system_memory_info.physical_pages_uncommitted++;
+            });
+            return page.release_nonnull();
+        }
+    }
+
     auto page = find_free_physical_page(true);
     VERIFY(page);
     if (should_zero_fill == ShouldZeroFill::Yes) {
@@ -1262,10 +1528,36 @@ NonnullRefPtr<PhysicalRAMPage> MemoryManager::allocate_committed_physical_page(B
 
 ErrorOr<NonnullRefPtr<PhysicalRAMPage>> MemoryManager::allocate_physical_page(ShouldZeroFill should_zero_fill, bool* did_purge)
 {
-    return m_global_data.with([&](auto&) -> ErrorOr<NonnullRefPtr<PhysicalRAMPage>> {
+    if (should_zero_fill == ShouldZeroFill::Yes) {
+        if (auto page = take_page_from_zeroed_page_pool()) {
+            if (did_purge)
+                *did_purge = false;
+            return page.release_nonnull();
+        }
+    }
+
+    if (auto page = take_page_from_free_page_cache()) {
+        if (should_zero_fill == ShouldZeroFill::Yes) {
+            InterruptDisabler disabler;
+            auto* ptr = quickmap_page(*page);
+            memset(ptr, 0, PAGE_SIZE);
+            unquickmap_page();
+        }
+        if (did_purge)
+            *did_purge = false;
+        return page.release_nonnull();
+    }
+
+    return m_global_data.with([&](auto& global_data) -> ErrorOr<NonnullRefPtr<PhysicalRAMPage>> {
         auto page = find_free_physical_page(false);
         bool purged_pages = false;
 
+        if (!page) {
+            // Other processors may be sitting on free pages in their caches, take those back first.
+            if (drain_free_page_caches(global_data) > 0)
+                page = find_free_physical_page(false);
+        }
+
         if (!page) {
             // We didn't have a single free physical page. Let's try to free something up!
             // First, we look for a purgeable VMObject in the volatile state.
@@ -1384,6 +1676,8 @@ PageDirectoryEntry* MemoryManager::quickmap_pd(PageDirectory& directory, size_t
         pte.set_present(true);
         pte.set_writable(true);
         pte.set_user_allowed(false);
+        // NOTE: Quickmap windows are global so invalidating them doesn't affect the other PCIDs.
+        pte.set_global(true);
         flush_tlb_local(vaddr);
     }
     return (PageDirectoryEntry*)vaddr.get();
@@ -1402,6 +1696,7 @@ PageTableEntry* MemoryManager::quickmap_pt(PhysicalAddress pt_paddr)
         pte.set_present(true);
         pte.set_writable(true);
         pte.set_user_allowed(false);
+        pte.set_global(true);
         flush_tlb_local(vaddr);
     }
     return (PageTableEntry*)vaddr.get();
@@ -1422,6 +1717,7 @@ u8* MemoryManager::quickmap_page(PhysicalAddress const& physical_address)
         pte.set_present(true);
         pte.set_writable(true);
         pte.set_user_allowed(false);
+        pte.set_global(true);
         flush_tlb_local(vaddr);
     }
     return vaddr.as_ptr();
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/Badge.h>
 #include <AK/Concepts.h>
 #include <AK/HashTable.h>
@@ -34,6 +35,9 @@ constexpr FlatPtr page_round_down(FlatPtr x)
     return ((FlatPtr)(x)) & ~(PAGE_SIZE - 1);
 }
 
+// The size of the memory a single page directory entry can map.
+static constexpr size_t HUGE_PAGE_SIZE = 2 * MiB;
+
 inline FlatPtr virtual_to_low_physical(FlatPtr virtual_)
 {
     return virtual_ - physical_to_virtual_offset;
@@ -88,6 +92,15 @@ struct MemoryManagerData {
 
     Spinlock<LockRank::None> m_quickmap_in_use {};
     InterruptsState m_quickmap_previous_interrupts_state;
+
+    // A small per-processor stash of free physical pages, refilled from and flushed to the
+    // physical regions in batches, so that most page (de)allocations don't need the global lock.
+    // NOTE: Pages in here are accounted for as used, not as uncommitted.
+    static constexpr size_t free_page_cache_capacity = 64;
+    static constexpr size_t free_page_cache_batch_size = free_page_cache_capacity / 2;
+    Spinlock<LockRank::None> m_free_page_cache_lock {};
+    Array<PhysicalAddress, free_page_cache_capacity> m_free_page_cache;
+    size_t m_free_page_cache_count { 0 };
 };
 
 // This class represents a set of committed physical pages.
@@ -127,6 +140,7 @@ class MemoryManager {
     friend class AnonymousVMObject;
     friend class Region;
     friend class RegionTree;
+    friend class SharedInodeVMObject;
     friend class VMObject;
     friend struct ::KmallocGlobalData;
 
@@ -189,6 +203,11 @@ public:
 
     SystemMemoryInfo get_system_memory_info();
 
+    // These are called by the PhysicalMemoryTask whenever it gets to run, see Tasks/PhysicalMemoryTask.cpp.
+    size_t refill_zeroed_page_pool(size_t max_page_count);
+    size_t compact_physical_memory();
+    bool is_under_memory_pressure();
+
     template<IteratorFunction<VMObject&> Callback>
     static void for_each_vmobject(Callback callback)
     {
@@ -274,6 +293,13 @@ private:
 
     RefPtr<PhysicalRAMPage> find_free_physical_page(bool);
 
+    RefPtr<PhysicalRAMPage> take_page_from_free_page_cache();
+    bool try_return_page_to_free_page_cache(PhysicalAddress);
+    void return_pages_to_physical_regions(GlobalData&, Span<PhysicalAddress const>);
+    size_t drain_free_page_caches(GlobalData&);
+
+    RefPtr<PhysicalRAMPage> take_page_from_zeroed_page_pool();
+
     ALWAYS_INLINE u8* quickmap_page(PhysicalRAMPage& page)
     {
         return quickmap_page(page.paddr());
@@ -305,6 +331,16 @@ private:
     size_t m_physical_page_entries_count { 0 };
 
     SpinlockProtected<GlobalData, LockRank::None> m_global_data;
+
+    // Pages that have already been zero-filled ahead of time, so that allocations asking
+    // for zeroed memory (mostly anonymous page faults) don't have to do it themselves.
+    // NOTE: Pages in here are accounted for as used, not as uncommitted.
+    struct ZeroedPagePool {
+        static constexpr size_t capacity = 1024;
+        Array<PhysicalAddress, capacity> pages;
+        size_t count { 0 };
+    };
+    SpinlockProtected<ZeroedPagePool, LockRank::None> m_zeroed_page_pool {};
 };
 
 inline bool PhysicalRAMPage::is_shared_zero_page() const
@@ -104,8 +104,16 @@ Vector<NonnullRefPtr<PhysicalRAMPage>> PhysicalRegion::take_contiguous_free_page
 
 RefPtr<PhysicalRAMPage> PhysicalRegion::take_free_page()
 {
-    if (m_usable_zones.is_empty())
+    auto paddr = take_free_page_address();
+    if (!paddr.has_value())
         return nullptr;
+    return PhysicalRAMPage::create(paddr.value());
+}
+
+Optional<PhysicalAddress> PhysicalRegion::take_free_page_address()
+{
+    if (m_usable_zones.is_empty())
+        return {};
 
     auto& zone = *m_usable_zones.first();
     auto page = zone.allocate_block(0);
@@ -116,7 +124,46 @@ RefPtr<PhysicalRAMPage> PhysicalRegion::take_free_page()
         m_full_zones.append(zone);
     }
 
-    return PhysicalRAMPage::create(page.value());
+    return page.value();
+}
+
+PhysicalZone* PhysicalRegion::select_zone_to_evacuate()
+{
+    // Only zones that are mostly free are worth the trouble, everything in them has to be copied somewhere else.
+    PhysicalZone* best_zone = nullptr;
+    size_t best_zone_used_pages = 0;
+    size_t total_available_pages = 0;
+    for (auto& zone : m_zones) {
+        total_available_pages += zone->available();
+        auto used_pages = zone->page_count() - zone->available();
+        if (used_pages == 0 || used_pages > zone->page_count() / 8)
+            continue;
+        if (!best_zone || used_pages < best_zone_used_pages) {
+            best_zone = zone.ptr();
+            best_zone_used_pages = used_pages;
+        }
+    }
+    if (!best_zone || total_available_pages - best_zone->available() < best_zone_used_pages)
+        return nullptr;
+
+    // Move the zone to the back of the line, so regular allocations fill up the other zones instead.
+    if (!m_full_zones.contains(*best_zone))
+        m_usable_zones.append(*best_zone);
+    return best_zone;
+}
+
+Optional<PhysicalAddress> PhysicalRegion::take_free_page_address_outside_of(PhysicalZone const& excluded_zone)
+{
+    for (auto& zone : m_usable_zones) {
+        if (&zone == &excluded_zone)
+            continue;
+        auto page = zone.allocate_block(0);
+        VERIFY(page.has_value());
+        if (zone.is_empty())
+            m_full_zones.append(zone);
+        return page.value();
+    }
+    return {};
 }
 
 void PhysicalRegion::return_page(PhysicalAddress paddr)
@@ -35,9 +35,14 @@ public:
     OwnPtr<PhysicalRegion> try_take_pages_from_beginning(size_t);
 
     RefPtr<PhysicalRAMPage> take_free_page();
+    Optional<PhysicalAddress> take_free_page_address();
     Vector<NonnullRefPtr<PhysicalRAMPage>> take_contiguous_free_pages(size_t count);
     void return_page(PhysicalAddress);
 
+    // Memory compaction support, see MemoryManager::compact_physical_memory().
+    PhysicalZone* select_zone_to_evacuate();
+    Optional<PhysicalAddress> take_free_page_address_outside_of(PhysicalZone const&);
+
 private:
     PhysicalRegion(PhysicalAddress lower, PhysicalAddress upper);
 
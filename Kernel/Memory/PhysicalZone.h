@@ -31,6 +31,7 @@ public:
 
     void dump() const;
     size_t available() const { return m_page_count - (m_used_chunks / 2); }
+    size_t page_count() const { return m_page_count; }
 
     bool is_empty() const { return available() == 0; }
 
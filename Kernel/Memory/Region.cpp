@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ByteBuffer.h>
 #include <AK/StringView.h>
 #include <Kernel/Arch/PageDirectory.h>
 #include <Kernel/Arch/PageFault.h>
@@ -117,6 +118,7 @@ ErrorOr<NonnullOwnPtr<Region>> Region::try_clone()
         region->set_mmap(m_mmap, m_mmapped_from_readable, m_mmapped_from_writable);
         region->set_shared(m_shared);
         region->set_syscall_region(is_syscall_region());
+        region->set_wants_huge_pages(m_wants_huge_pages);
         return region;
     }
 
@@ -142,6 +144,7 @@ ErrorOr<NonnullOwnPtr<Region>> Region::try_clone()
     }
     clone_region->set_syscall_region(is_syscall_region());
     clone_region->set_mmap(m_mmap, m_mmapped_from_readable, m_mmapped_from_writable);
+    clone_region->set_wants_huge_pages(m_wants_huge_pages);
     return clone_region;
 }
 
@@ -279,6 +282,24 @@ bool Region::remap_vmobject_page(size_t page_index, NonnullRefPtr<PhysicalRAMPag
     return success;
 }
 
+void Region::unmap_vmobject_page(size_t page_index)
+{
+    if (!m_page_directory)
+        return;
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+
+    // NOTE: `page_index` is a VMObject page index, so first we convert it to a Region page index.
+    if (!translate_vmobject_page(page_index))
+        return;
+
+    auto page_vaddr = vaddr_from_page_index(page_index);
+    auto* pte = MM.pte(*m_page_directory, page_vaddr);
+    if (!pte || !pte->is_present())
+        return;
+    pte->clear();
+    MemoryManager::flush_tlb(m_page_directory, page_vaddr);
+}
+
 void Region::unmap(ShouldFlushTLB should_flush_tlb)
 {
     if (!m_page_directory)
@@ -352,6 +373,19 @@ ErrorOr<void> Region::map(PageDirectory& page_directory, PhysicalAddress paddr,
     return ENOMEM;
 }
 
+bool Region::can_be_mapped_lazily() const
+{
+    // Only anonymous and inode-backed memory knows how to fault its pages back in.
+    return is_user() && (vmobject().is_anonymous() || vmobject().is_inode());
+}
+
+void Region::map_lazily(PageDirectory& page_directory)
+{
+    VERIFY(can_be_mapped_lazily());
+    SpinlockLocker page_lock(page_directory.get_lock());
+    set_page_directory(page_directory);
+}
+
 void Region::remap()
 {
     VERIFY(m_page_directory);
@@ -413,6 +447,13 @@ PageFaultResponse Region::handle_fault(PageFault const& fault)
                 return PageFaultResponse::OutOfMemory;
             return PageFaultResponse::Continue;
         }
+        if (page_slot) {
+            // The page is resident, it just hasn't been mapped into this page directory yet (see map_lazily() and unmap_vmobject_page()).
+            dbgln_if(PAGE_FAULT_DEBUG, "NP(lazy) fault in Region({})[{}] at {}", this, page_index_in_region, fault.vaddr());
+            if (!remap_vmobject_page(translate_to_vmobject_page(page_index_in_region), *page_slot))
+                return PageFaultResponse::OutOfMemory;
+            return PageFaultResponse::Continue;
+        }
         dbgln("BUG! Unexpected NP fault at {}", fault.vaddr());
         dbgln("     - Physical page slot pointer: {:p}", page_slot.ptr());
         if (page_slot) {
@@ -482,6 +523,14 @@ PageFaultResponse Region::handle_fault(PageFault const& fault)
         return PageFaultResponse::Continue;
     }
 
+    if (page_slot) {
+        // The page is resident, it just hasn't been mapped into this page directory yet (see map_lazily() and unmap_vmobject_page()).
+        dbgln_if(PAGE_FAULT_DEBUG, "Lazy page fault in Region({})[{}] at {}", this, page_index_in_region, fault.vaddr());
+        if (!remap_vmobject_page(translate_to_vmobject_page(page_index_in_region), *page_slot))
+            return PageFaultResponse::OutOfMemory;
+        return PageFaultResponse::Continue;
+    }
+
     dbgln("Unexpected page fault in Region({})[{}] at {}", this, page_index_in_region, fault.vaddr());
     return PageFaultResponse::ShouldCrash;
 #endif
@@ -497,6 +546,11 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region, Physica
     if (current_thread != nullptr)
         current_thread->did_zero_fault();
 
+    if (m_wants_huge_pages) {
+        if (auto response = try_handle_huge_zero_fault(page_index_in_region); response.has_value())
+            return response.release_value();
+    }
+
     RefPtr<PhysicalRAMPage> new_physical_page;
 
     if (page_in_slot_at_time_of_fault.is_lazy_committed_page()) {
@@ -535,6 +589,45 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region, Physica
     return PageFaultResponse::Continue;
 }
 
+Optional<PageFaultResponse> Region::try_handle_huge_zero_fault(size_t page_index_in_region)
+{
+    // Try to back the whole huge page sized block around the fault with one physically contiguous
+    // allocation, so that we take a single fault instead of one per page. If anything about the block
+    // doesn't work out, we return an empty Optional and the caller falls back to faulting in one page.
+    constexpr size_t pages_per_huge_page = HUGE_PAGE_SIZE / PAGE_SIZE;
+
+    auto block_base = VirtualAddress { align_down_to(vaddr_from_page_index(page_index_in_region).get(), HUGE_PAGE_SIZE) };
+    if (!m_range.contains(VirtualRange { block_base, HUGE_PAGE_SIZE }))
+        return {};
+
+    auto first_page_index_in_region = page_index_from_address(block_base);
+    auto first_page_index_in_vmobject = translate_to_vmobject_page(first_page_index_in_region);
+
+    auto physical_pages_or_error = MM.allocate_contiguous_physical_pages(HUGE_PAGE_SIZE);
+    if (physical_pages_or_error.is_error()) {
+        dbgln_if(PAGE_FAULT_DEBUG, "      >> No contiguous memory for huge page at {}, falling back", block_base);
+        return {};
+    }
+    auto physical_pages = physical_pages_or_error.release_value();
+    VERIFY(physical_pages.size() == pages_per_huge_page);
+
+    auto& anonymous_vmobject = static_cast<AnonymousVMObject&>(vmobject());
+    if (!anonymous_vmobject.try_install_huge_page_block({}, first_page_index_in_vmobject, physical_pages.span()))
+        return {};
+
+    dbgln_if(PAGE_FAULT_DEBUG, "      >> ALLOCATED HUGE {} for {}", physical_pages.first()->paddr(), block_base);
+
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    for (size_t i = 0; i < pages_per_huge_page; ++i) {
+        if (!map_individual_page_impl(first_page_index_in_region + i, physical_pages[i])) {
+            dmesgln("MM: try_handle_huge_zero_fault was unable to allocate a page table to map {}", block_base);
+            return PageFaultResponse::OutOfMemory;
+        }
+    }
+    MemoryManager::flush_tlb(m_page_directory, block_base, pages_per_huge_page);
+    return PageFaultResponse::Continue;
+}
+
 PageFaultResponse Region::handle_cow_fault(size_t page_index_in_region)
 {
     auto current_thread = Thread::current();
@@ -551,6 +644,44 @@ PageFaultResponse Region::handle_cow_fault(size_t page_index_in_region)
     return response;
 }
 
+static Atomic<u32> s_inode_fault_around_page_count { 16 };
+
+u32 Region::inode_fault_around_page_count()
+{
+    return s_inode_fault_around_page_count.load(AK::MemoryOrder::memory_order_relaxed);
+}
+
+void Region::set_inode_fault_around_page_count(u32 page_count)
+{
+    s_inode_fault_around_page_count.store(clamp(page_count, 1u, max_inode_fault_around_page_count), AK::MemoryOrder::memory_order_relaxed);
+}
+
+void Region::map_cached_inode_pages_around(size_t page_index_in_region)
+{
+    // Map every page in the fault-around window that is already in the VMObject,
+    // so that touching any of them later on doesn't take another fault.
+    auto window = inode_fault_around_page_count();
+    if (window <= 1)
+        return;
+
+    auto first_page_index = (page_index_in_region / window) * window;
+    auto end_page_index = min(first_page_index + window, page_count());
+
+    // NOTE: The VMObject lock has to be taken before the page directory lock, like everywhere else.
+    SpinlockLocker vmobject_locker(vmobject().m_lock);
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    for (size_t page_index = first_page_index; page_index < end_page_index; ++page_index) {
+        if (page_index == page_index_in_region)
+            continue;
+        auto& page_slot = physical_page_slot(page_index);
+        if (page_slot.is_null())
+            continue;
+        if (!map_individual_page_impl(page_index, page_slot))
+            break;
+    }
+    MemoryManager::flush_tlb(m_page_directory, vaddr_from_page_index(first_page_index), end_page_index - first_page_index);
+}
+
 PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region)
 {
     VERIFY(vmobject().is_inode());
@@ -561,6 +692,7 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region)
     auto page_index_in_vmobject = translate_to_vmobject_page(page_index_in_region);
     auto& vmobject_physical_page_slot = inode_vmobject.physical_pages()[page_index_in_vmobject];
 
+    size_t pages_to_read = 1;
     {
         // NOTE: The VMObject lock is required when manipulating the VMObject's physical page slot.
         SpinlockLocker locker(inode_vmobject.m_lock);
@@ -568,21 +700,45 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region)
             dbgln_if(PAGE_FAULT_DEBUG, "handle_inode_fault: Page faulted in by someone else before reading, remapping.");
             if (!remap_vmobject_page(page_index_in_vmobject, *vmobject_physical_page_slot))
                 return PageFaultResponse::OutOfMemory;
+            locker.unlock();
+            map_cached_inode_pages_around(page_index_in_region);
             return PageFaultResponse::Continue;
         }
+
+        // If the page right before this one is already resident, this looks like a sequential access pattern
+        // (e.g. the dynamic loader walking through a library), so read the following pages along with this one.
+        auto physical_pages = inode_vmobject.physical_pages();
+        if (page_index_in_vmobject > 0 && !physical_pages[page_index_in_vmobject - 1].is_null()) {
+            auto max_pages_to_read = min<size_t>(inode_fault_around_page_count(), page_count() - page_index_in_region);
+            while (pages_to_read < max_pages_to_read && physical_pages[page_index_in_vmobject + pages_to_read].is_null())
+                ++pages_to_read;
+        }
     }
 
-    dbgln_if(PAGE_FAULT_DEBUG, "Inode fault in {} page index: {}", name(), page_index_in_region);
+    dbgln_if(PAGE_FAULT_DEBUG, "Inode fault in {} page index: {}, reading {} page(s)", name(), page_index_in_region, pages_to_read);
 
     auto current_thread = Thread::current();
     if (current_thread)
         current_thread->did_inode_fault();
 
-    u8 page_buffer[PAGE_SIZE];
+    u8 single_page_buffer[PAGE_SIZE];
+    ByteBuffer read_ahead_buffer;
+    Bytes page_buffer { single_page_buffer, PAGE_SIZE };
+    if (pages_to_read > 1) {
+        auto buffer_or_error = ByteBuffer::create_uninitialized(pages_to_read * PAGE_SIZE);
+        if (buffer_or_error.is_error()) {
+            // Not being able to read ahead is no reason to fail the fault, just read the one page we need.
+            pages_to_read = 1;
+        } else {
+            read_ahead_buffer = buffer_or_error.release_value();
+            page_buffer = read_ahead_buffer.bytes();
+        }
+    }
+
     auto& inode = inode_vmobject.inode();
 
-    auto buffer = UserOrKernelBuffer::for_kernel_buffer(page_buffer);
-    auto result = inode.read_bytes(page_index_in_vmobject * PAGE_SIZE, PAGE_SIZE, buffer, nullptr);
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(page_buffer.data());
+    auto result = inode.read_bytes(page_index_in_vmobject * PAGE_SIZE, pages_to_read * PAGE_SIZE, buffer, nullptr);
 
     if (result.is_error()) {
         dmesgln("handle_inode_fault: Error ({}) while reading from inode", result.error());
@@ -595,44 +751,50 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region)
     if (nread == 0)
         return PageFaultResponse::BusError;
 
-    if (nread < PAGE_SIZE) {
+    // Don't install pages past the end of the file, faulting on those has to raise a bus error.
+    pages_to_read = min(pages_to_read, ceil_div(nread, static_cast<size_t>(PAGE_SIZE)));
+
+    if (nread < pages_to_read * PAGE_SIZE) {
         // If we read less than a page, zero out the rest to avoid leaking uninitialized data.
-        memset(page_buffer + nread, 0, PAGE_SIZE - nread);
+        memset(page_buffer.data() + nread, 0, pages_to_read * PAGE_SIZE - nread);
     }
 
-    // Allocate a new physical page, and copy the read inode contents into it.
-    auto new_physical_page_or_error = MM.allocate_physical_page(MemoryManager::ShouldZeroFill::No);
-    if (new_physical_page_or_error.is_error()) {
-        dmesgln("MM: handle_inode_fault was unable to allocate a physical page");
-        return PageFaultResponse::OutOfMemory;
-    }
-    auto new_physical_page = new_physical_page_or_error.release_value();
-    {
-        InterruptDisabler disabler;
-        u8* dest_ptr = MM.quickmap_page(*new_physical_page);
-        memcpy(dest_ptr, page_buffer, PAGE_SIZE);
-        MM.unquickmap_page();
-    }
+    for (size_t i = 0; i < pages_to_read; ++i) {
+        // Allocate a new physical page, and copy the read inode contents into it.
+        auto new_physical_page_or_error = MM.allocate_physical_page(MemoryManager::ShouldZeroFill::No);
+        if (new_physical_page_or_error.is_error()) {
+            if (i > 0)
+                break;
+            dmesgln("MM: handle_inode_fault was unable to allocate a physical page");
+            return PageFaultResponse::OutOfMemory;
+        }
+        auto new_physical_page = new_physical_page_or_error.release_value();
+        {
+            InterruptDisabler disabler;
+            u8* dest_ptr = MM.quickmap_page(*new_physical_page);
+            memcpy(dest_ptr, page_buffer.offset_pointer(i * PAGE_SIZE), PAGE_SIZE);
+            MM.unquickmap_page();
+        }
 
-    {
         // NOTE: The VMObject lock is required when manipulating the VMObject's physical page slot.
         SpinlockLocker locker(inode_vmobject.m_lock);
-
-        if (!vmobject_physical_page_slot.is_null()) {
+        auto& page_slot = inode_vmobject.physical_pages()[page_index_in_vmobject + i];
+        if (!page_slot.is_null()) {
             // Someone else faulted in this page while we were reading from the inode.
-            // No harm done (other than some duplicate work), remap the page here and return.
+            // No harm done (other than some duplicate work), we'll map their page instead.
             dbgln_if(PAGE_FAULT_DEBUG, "handle_inode_fault: Page faulted in by someone else, remapping.");
-            if (!remap_vmobject_page(page_index_in_vmobject, *vmobject_physical_page_slot))
-                return PageFaultResponse::OutOfMemory;
-            return PageFaultResponse::Continue;
+            continue;
         }
-
-        vmobject_physical_page_slot = new_physical_page;
+        page_slot = move(new_physical_page);
     }
 
-    if (!remap_vmobject_page(page_index_in_vmobject, *vmobject_physical_page_slot))
-        return PageFaultResponse::OutOfMemory;
+    {
+        SpinlockLocker locker(inode_vmobject.m_lock);
+        if (!remap_vmobject_page(page_index_in_vmobject, *vmobject_physical_page_slot))
+            return PageFaultResponse::OutOfMemory;
+    }
 
+    map_cached_inode_pages_around(page_index_in_region);
     return PageFaultResponse::Continue;
 }
 
@@ -105,11 +105,21 @@ public:
     [[nodiscard]] bool is_write_combine() const { return m_write_combine; }
     ErrorOr<void> set_write_combine(bool);
 
+    // Anonymous regions that want huge pages get a physically contiguous huge page worth
+    // of memory faulted in at once for every suitably aligned block they contain.
+    [[nodiscard]] bool wants_huge_pages() const { return m_wants_huge_pages; }
+    void set_wants_huge_pages(bool wants_huge_pages) { m_wants_huge_pages = wants_huge_pages; }
+
     [[nodiscard]] bool is_user() const { return !is_kernel(); }
     [[nodiscard]] bool is_kernel() const { return vaddr().get() < USER_RANGE_BASE || vaddr().get() >= kernel_mapping_base; }
 
     PageFaultResponse handle_fault(PageFault const&);
 
+    // How many pages around an inode fault get mapped (if they are already resident) or read in ahead.
+    static constexpr u32 max_inode_fault_around_page_count = 64;
+    static u32 inode_fault_around_page_count();
+    static void set_inode_fault_around_page_count(u32);
+
     ErrorOr<NonnullOwnPtr<Region>> try_clone();
 
     [[nodiscard]] bool contains(VirtualAddress vaddr) const
@@ -209,11 +219,20 @@ public:
     void set_page_directory(PageDirectory&);
     ErrorOr<void> map(PageDirectory&, ShouldFlushTLB = ShouldFlushTLB::Yes);
     ErrorOr<void> map(PageDirectory&, PhysicalAddress, ShouldFlushTLB = ShouldFlushTLB::Yes);
+
+    // Attaches the region to a page directory without populating any page table entries.
+    // They are filled in by handle_fault() as the pages are touched for the first time.
+    [[nodiscard]] bool can_be_mapped_lazily() const;
+    void map_lazily(PageDirectory&);
+
     void unmap(ShouldFlushTLB = ShouldFlushTLB::Yes);
     void unmap_with_locks_held(ShouldFlushTLB, SpinlockLocker<RecursiveSpinlock<LockRank::None>>& pd_locker);
 
     void remap();
 
+    // Clears the page table entry of a single VMObject page, so the next access faults it back in (see handle_fault()).
+    void unmap_vmobject_page(size_t page_index);
+
     [[nodiscard]] bool is_mapped() const { return m_page_directory != nullptr; }
 
     void clear_to_zero();
@@ -244,7 +263,9 @@ private:
 
     [[nodiscard]] PageFaultResponse handle_cow_fault(size_t page_index);
     [[nodiscard]] PageFaultResponse handle_inode_fault(size_t page_index);
+    void map_cached_inode_pages_around(size_t page_index);
     [[nodiscard]] PageFaultResponse handle_zero_fault(size_t page_index, PhysicalRAMPage& page_in_slot_at_time_of_fault);
+    [[nodiscard]] Optional<PageFaultResponse> try_handle_huge_zero_fault(size_t page_index);
 
     [[nodiscard]] bool map_individual_page_impl(size_t page_index);
     [[nodiscard]] bool map_individual_page_impl(size_t page_index, RefPtr<PhysicalRAMPage>);
@@ -266,6 +287,7 @@ private:
     bool m_write_combine : 1 { false };
     bool m_mmapped_from_readable : 1 { false };
     bool m_mmapped_from_writable : 1 { false };
+    bool m_wants_huge_pages : 1 { false };
 
     SetOnce m_immutable;
     SetOnce m_initially_loaded_executable_segment;
@@ -69,4 +69,30 @@ ErrorOr<void> SharedInodeVMObject::sync(off_t offset_in_pages, size_t pages)
     return {};
 }
 
+bool SharedInodeVMObject::is_page_resident(size_t page_index) const
+{
+    SpinlockLocker locker(m_lock);
+    return page_index < page_count() && m_physical_pages[page_index];
+}
+
+bool SharedInodeVMObject::copy_from_resident_page(size_t page_index, u8 page_buffer[PAGE_SIZE]) const
+{
+    SpinlockLocker locker(m_lock);
+    if (page_index >= page_count() || !m_physical_pages[page_index])
+        return false;
+    MM.copy_physical_page(*m_physical_pages[page_index], page_buffer);
+    return true;
+}
+
+void SharedInodeVMObject::copy_to_resident_page(size_t page_index, size_t offset_in_page, ReadonlyBytes bytes)
+{
+    VERIFY(offset_in_page + bytes.size() <= PAGE_SIZE);
+    SpinlockLocker locker(m_lock);
+    if (page_index >= page_count() || !m_physical_pages[page_index])
+        return;
+    auto* quickmapped_page = MM.quickmap_page(*m_physical_pages[page_index]);
+    memcpy(quickmapped_page + offset_in_page, bytes.data(), bytes.size());
+    MM.unquickmap_page();
+}
+
 }
@@ -21,6 +21,11 @@ public:
 
     ErrorOr<void> sync(off_t offset_in_pages = 0, size_t pages = -1);
 
+    // NOTE: These keep read() and write() coherent with shared mappings of the inode, see Inode::read_bytes() and Inode::write_bytes().
+    bool is_page_resident(size_t page_index) const;
+    bool copy_from_resident_page(size_t page_index, u8 page_buffer[PAGE_SIZE]) const;
+    void copy_to_resident_page(size_t page_index, size_t offset_in_page, ReadonlyBytes);
+
 private:
     virtual bool is_shared_inode() const override { return true; }
 
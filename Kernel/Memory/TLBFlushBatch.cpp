@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Arch/Processor.h>
+#include <Kernel/Memory/TLBFlushBatch.h>
+
+namespace Kernel::Memory {
+
+void TLBFlushBatch::add(VirtualAddress vaddr, size_t page_count)
+{
+    if (page_count == 0)
+        return;
+
+    if (m_range_count > 0) {
+        auto& last_range = m_ranges[m_range_count - 1];
+        if (last_range.vaddr.offset(last_range.page_count * PAGE_SIZE) == vaddr) {
+            last_range.page_count += page_count;
+            return;
+        }
+    }
+
+    if (m_range_count == m_ranges.size())
+        flush();
+
+    m_ranges[m_range_count++] = { vaddr, page_count };
+}
+
+void TLBFlushBatch::flush()
+{
+    if (m_range_count == 0)
+        return;
+    Processor::flush_tlb(*this);
+    m_range_count = 0;
+}
+
+}
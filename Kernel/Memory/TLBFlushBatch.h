@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Noncopyable.h>
+#include <AK/Span.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Memory/VirtualAddress.h>
+
+namespace Kernel::Memory {
+
+// Collects the ranges of a page directory that have to be flushed from the TLB,
+// so that other processors only have to be interrupted once for all of them.
+// NOTE: Whoever unmaps the pages has to keep them alive until the batch is flushed!
+class TLBFlushBatch {
+    AK_MAKE_NONCOPYABLE(TLBFlushBatch);
+    AK_MAKE_NONMOVABLE(TLBFlushBatch);
+
+public:
+    static constexpr size_t max_range_count = 8;
+
+    struct Range {
+        VirtualAddress vaddr;
+        size_t page_count { 0 };
+    };
+
+    explicit TLBFlushBatch(PageDirectory const& page_directory)
+        : m_page_directory(page_directory)
+    {
+    }
+
+    ~TLBFlushBatch() { flush(); }
+
+    void add(VirtualAddress, size_t page_count);
+    void flush();
+
+    PageDirectory const& page_directory() const { return m_page_directory; }
+    ReadonlySpan<Range> ranges() const { return m_ranges.span().trim(m_range_count); }
+    bool is_empty() const { return m_range_count == 0; }
+
+private:
+    PageDirectory const& m_page_directory;
+    Array<Range, max_range_count> m_ranges;
+    size_t m_range_count { 0 };
+};
+
+}
@@ -50,7 +50,7 @@ ErrorOr<NonnullRefPtr<Socket>> IPv4Socket::create(int type, int protocol)
     if (type == SOCK_DGRAM)
         return TRY(UDPSocket::try_create(protocol, move(receive_buffer)));
     if (type == SOCK_RAW) {
-        auto raw_socket = adopt_ref_if_nonnull(new (nothrow) IPv4Socket(type, protocol, move(receive_buffer), {}));
+        auto raw_socket = adopt_ref_if_nonnull(new (nothrow) IPv4Socket(type, protocol, move(receive_buffer)));
         if (raw_socket)
             return raw_socket.release_nonnull();
         return ENOMEM;
@@ -58,16 +58,12 @@ ErrorOr<NonnullRefPtr<Socket>> IPv4Socket::create(int type, int protocol)
     return EINVAL;
 }
 
-IPv4Socket::IPv4Socket(int type, int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, OwnPtr<KBuffer> optional_scratch_buffer)
+IPv4Socket::IPv4Socket(int type, int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer)
     : Socket(AF_INET, type, protocol)
     , m_receive_buffer(move(receive_buffer))
-    , m_scratch_buffer(move(optional_scratch_buffer))
 {
     dbgln_if(IPV4_SOCKET_DEBUG, "IPv4Socket({}) created with type={}, protocol={}", this, type, protocol);
     m_buffer_mode = type == SOCK_STREAM ? BufferMode::Bytes : BufferMode::Packets;
-    if (m_buffer_mode == BufferMode::Bytes) {
-        VERIFY(m_scratch_buffer);
-    }
 
     all_sockets().with_exclusive([&](auto& table) {
         table.append(*this);
@@ -230,17 +226,14 @@ ErrorOr<size_t> IPv4Socket::sendto(OpenFileDescription&, UserOrKernelBuffer cons
     if (type() == SOCK_RAW) {
         auto ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
         data_length = min(data_length, routing_decision.adapter->mtu() - ipv4_payload_offset);
-        auto packet = routing_decision.adapter->acquire_packet_buffer(ipv4_payload_offset + data_length);
+        auto packet = PacketBuffer::try_create(ipv4_payload_offset + data_length);
         if (!packet)
             return set_so_error(ENOMEM);
         routing_decision.adapter->fill_in_ipv4_header(*packet, local_address(), routing_decision.next_hop,
             m_peer_address, (IPv4Protocol)protocol(), data_length, m_type_of_service, m_ttl);
-        if (auto result = data.read(packet->buffer->data() + ipv4_payload_offset, data_length); result.is_error()) {
-            routing_decision.adapter->release_packet_buffer(*packet);
+        if (auto result = data.read(packet->buffer->data() + ipv4_payload_offset, data_length); result.is_error())
             return set_so_error(result.release_error());
-        }
         routing_decision.adapter->send_packet(packet->bytes());
-        routing_decision.adapter->release_packet_buffer(*packet);
         return data_length;
     }
 
@@ -316,7 +309,7 @@ ErrorOr<size_t> IPv4Socket::receive_packet_buffered(OpenFileDescription& descrip
 
             dbgln_if(IPV4_SOCKET_DEBUG, "IPv4Socket({}): recvfrom without blocking {} bytes, packets in queue: {}",
                 this,
-                packet->data->size(),
+                packet->data.size(),
                 m_receive_queue.size());
         }
     }
@@ -353,10 +346,10 @@ ErrorOr<size_t> IPv4Socket::receive_packet_buffered(OpenFileDescription& descrip
 
         dbgln_if(IPV4_SOCKET_DEBUG, "IPv4Socket({}): recvfrom with blocking {} bytes, packets in queue: {}",
             this,
-            packet->data->size(),
+            packet->data.size(),
             m_receive_queue.size());
     }
-    VERIFY(packet->data);
+    VERIFY(packet->buffer);
 
     packet_timestamp = packet->timestamp;
 
@@ -376,12 +369,12 @@ ErrorOr<size_t> IPv4Socket::receive_packet_buffered(OpenFileDescription& descrip
     }
 
     if (type() == SOCK_RAW) {
-        size_t bytes_written = min(packet->data->size(), buffer_length);
-        SOCKET_TRY(buffer.write(packet->data->data(), bytes_written));
+        size_t bytes_written = min(packet->data.size(), buffer_length);
+        SOCKET_TRY(buffer.write(packet->data.data(), bytes_written));
         return bytes_written;
     }
 
-    return protocol_receive(packet->data->bytes(), buffer, buffer_length, flags);
+    return protocol_receive(packet->data, buffer, buffer_length, flags);
 }
 
 ErrorOr<size_t> IPv4Socket::recvfrom(OpenFileDescription& description, UserOrKernelBuffer& buffer, size_t buffer_length, int flags, Userspace<sockaddr*> user_addr, Userspace<socklen_t*> user_addr_length, UnixDateTime& packet_timestamp, bool blocking)
@@ -417,7 +410,7 @@ ErrorOr<size_t> IPv4Socket::recvfrom(OpenFileDescription& description, UserOrKer
     return total_nreceived;
 }
 
-bool IPv4Socket::did_receive(IPv4Address const& source_address, u16 source_port, ReadonlyBytes packet, UnixDateTime const& packet_timestamp)
+bool IPv4Socket::did_receive(IPv4Address const& source_address, u16 source_port, PacketBuffer& packet_buffer, ReadonlyBytes packet)
 {
     MutexLocker locker(mutex());
 
@@ -435,11 +428,12 @@ bool IPv4Socket::did_receive(IPv4Address const& source_address, u16 source_port,
             VERIFY(m_can_read);
             return false;
         }
-        auto scratch_buffer = UserOrKernelBuffer::for_kernel_buffer(m_scratch_buffer->data());
-        auto nreceived_or_error = protocol_receive(packet, scratch_buffer, m_scratch_buffer->size(), 0);
-        if (nreceived_or_error.is_error())
+        // The payload is at the end of the packet, and goes straight from there into the receive buffer.
+        auto payload_size_or_error = protocol_size(packet);
+        if (payload_size_or_error.is_error())
             return false;
-        auto nwritten_or_error = m_receive_buffer->write(scratch_buffer, nreceived_or_error.value());
+        auto payload = packet.slice(packet_size - payload_size_or_error.value());
+        auto nwritten_or_error = m_receive_buffer->write(UserOrKernelBuffer::for_kernel_buffer(const_cast<u8*>(payload.data())), payload.size());
         if (nwritten_or_error.is_error())
             return false;
         set_can_read(!m_receive_buffer->is_empty());
@@ -448,12 +442,7 @@ bool IPv4Socket::did_receive(IPv4Address const& source_address, u16 source_port,
             dbgln("IPv4Socket({}): did_receive refusing packet since queue is full.", this);
             return false;
         }
-        auto data_or_error = KBuffer::try_create_with_bytes("IPv4Socket: Packet buffer"sv, packet);
-        if (data_or_error.is_error()) {
-            dbgln("IPv4Socket: did_receive unable to allocate storage for incoming packet.");
-            return false;
-        }
-        auto result = m_receive_queue.try_append({ source_address, source_port, packet_timestamp, data_or_error.release_value() });
+        auto result = m_receive_queue.try_append({ source_address, source_port, packet_buffer.timestamp, packet_buffer, packet });
         if (result.is_error()) {
             dbgln("IPv4Socket: Dropped incoming packet because appending to the receive queue failed.");
             return false;
@@ -508,10 +497,10 @@ ErrorOr<NonnullOwnPtr<KString>> IPv4Socket::pseudo_path(OpenFileDescription cons
     return KString::try_create(builder.string_view());
 }
 
-ErrorOr<void> IPv4Socket::setsockopt(int level, int option, Userspace<void const*> user_value, socklen_t user_value_size)
+ErrorOr<void> IPv4Socket::setsockopt(OpenFileDescription& description, int level, int option, Userspace<void const*> user_value, socklen_t user_value_size)
 {
     if (level != IPPROTO_IP)
-        return Socket::setsockopt(level, option, user_value, user_value_size);
+        return Socket::setsockopt(description, level, option, user_value, user_value_size);
 
     MutexLocker locker(mutex());
 
@@ -866,7 +855,7 @@ ErrorOr<void> IPv4Socket::ioctl(OpenFileDescription&, unsigned request, Userspac
             readable = static_cast<int>(m_receive_buffer->immediately_readable());
         } else {
             if (m_receive_queue.size() != 0u) {
-                readable = static_cast<int>(TRY(protocol_size(m_receive_queue.first().data->bytes())));
+                readable = static_cast<int>(TRY(protocol_size(m_receive_queue.first().data)));
             }
         }
 
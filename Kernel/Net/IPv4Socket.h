@@ -14,6 +14,7 @@
 #include <Kernel/Locking/MutexProtected.h>
 #include <Kernel/Net/IPv4.h>
 #include <Kernel/Net/IPv4SocketTuple.h>
+#include <Kernel/Net/PacketBuffer.h>
 #include <Kernel/Net/Socket.h>
 
 namespace Kernel {
@@ -37,12 +38,13 @@ public:
     virtual bool can_write(OpenFileDescription const&, u64) const override;
     virtual ErrorOr<size_t> sendto(OpenFileDescription&, UserOrKernelBuffer const&, size_t, int, Userspace<sockaddr const*>, socklen_t) override;
     virtual ErrorOr<size_t> recvfrom(OpenFileDescription&, UserOrKernelBuffer&, size_t, int flags, Userspace<sockaddr*>, Userspace<socklen_t*>, UnixDateTime&, bool blocking) override;
-    virtual ErrorOr<void> setsockopt(int level, int option, Userspace<void const*>, socklen_t) override;
+    virtual ErrorOr<void> setsockopt(OpenFileDescription&, int level, int option, Userspace<void const*>, socklen_t) override;
     virtual ErrorOr<void> getsockopt(OpenFileDescription&, int level, int option, Userspace<void*>, Userspace<socklen_t*>) override;
 
     virtual ErrorOr<void> ioctl(OpenFileDescription&, unsigned request, Userspace<void*> arg) override;
 
-    bool did_receive(IPv4Address const& peer_address, u16 peer_port, ReadonlyBytes, UnixDateTime const&);
+    // `ipv4_packet` is somewhere in `packet`, which the socket may hold on to until the data has been read.
+    bool did_receive(IPv4Address const& peer_address, u16 peer_port, PacketBuffer& packet, ReadonlyBytes ipv4_packet);
 
     IPv4Address const& local_address() const { return m_local_address; }
     u16 local_port() const { return m_local_port; }
@@ -71,7 +73,7 @@ public:
 protected:
     static constexpr size_t receive_buffer_size = 256 * KiB;
 
-    IPv4Socket(int type, int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, OwnPtr<KBuffer> optional_scratch_buffer);
+    IPv4Socket(int type, int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer);
     virtual StringView class_name() const override { return "IPv4Socket"sv; }
 
     void set_bound() { m_bound.set(); }
@@ -114,7 +116,9 @@ private:
         IPv4Address peer_address;
         u16 peer_port;
         UnixDateTime timestamp;
-        OwnPtr<KBuffer> data;
+        // The IPv4 packet, which lives in the buffer it was received into.
+        RefPtr<PacketBuffer> buffer;
+        ReadonlyBytes data;
     };
 
     SinglyLinkedList<ReceivedPacket, CountingSizeCalculationPolicy> m_receive_queue;
@@ -133,8 +137,6 @@ private:
 
     BufferMode m_buffer_mode { BufferMode::Packets };
 
-    OwnPtr<KBuffer> m_scratch_buffer;
-
     IntrusiveListNode<IPv4Socket> m_list_node;
 
 public:
@@ -231,6 +231,8 @@ UNMAP_AFTER_INIT ErrorOr<void> E1000ENetworkAdapter::initialize(Badge<Networking
 
     setup_link();
     setup_interrupts();
+
+    set_transmit_offloads(TransmitOffload::TCPChecksum | TransmitOffload::TCPSegmentation, tx_buffer_size - sizeof(EthernetFrameHeader));
     return {};
 }
 
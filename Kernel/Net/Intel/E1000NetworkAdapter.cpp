@@ -10,6 +10,7 @@
 #include <Kernel/Debug.h>
 #include <Kernel/Net/Intel/E1000NetworkAdapter.h>
 #include <Kernel/Net/NetworkingManagement.h>
+#include <Kernel/Net/TCP.h>
 #include <Kernel/Sections.h>
 
 namespace Kernel {
@@ -81,6 +82,20 @@ namespace Kernel {
 #define CMD_VLE (1 << 6)  // VLAN Packet Enable
 #define CMD_IDE (1 << 7)  // Interrupt Delay Enable
 
+// Extended Transmit Descriptors
+
+#define CMD_TSE (1 << 2)   // TCP Segmentation Enable
+#define CMD_DEXT (1 << 5)  // Descriptor Extension
+#define DTYP_DATA (1 << 4) // Data Descriptor, in the cso field
+
+#define TUCMD_TCP (1 << 0)  // Packet is TCP
+#define TUCMD_IP (1 << 1)   // Packet is IPv4
+#define TUCMD_TSE (1 << 2)  // TCP Segmentation Enable
+#define TUCMD_DEXT (1 << 5) // Descriptor Extension
+
+#define POPTS_IXSM (1 << 0) // Insert IP Checksum
+#define POPTS_TXSM (1 << 1) // Insert TCP Checksum
+
 // TCTL Register
 
 #define TCTL_EN (1 << 1)      // Transmit Enable
@@ -208,6 +223,8 @@ UNMAP_AFTER_INIT ErrorOr<void> E1000NetworkAdapter::initialize(Badge<NetworkingM
 
     m_link_up = ((in32(REG_STATUS) & STATUS_LU) != 0);
 
+    set_transmit_offloads(TransmitOffload::TCPChecksum | TransmitOffload::TCPSegmentation, tx_buffer_size - sizeof(EthernetFrameHeader));
+
     return {};
 }
 
@@ -401,18 +418,71 @@ u32 E1000NetworkAdapter::in32(u16 address)
 }
 
 void E1000NetworkAdapter::send_raw(ReadonlyBytes payload)
+{
+    transmit(payload, {});
+}
+
+void E1000NetworkAdapter::send_raw_with_offload(ReadonlyBytes payload, TransmitOffloadRequest const& offload)
+{
+    transmit(payload, offload);
+}
+
+void E1000NetworkAdapter::transmit(ReadonlyBytes payload, TransmitOffloadRequest const& offload)
 {
     disable_irq();
     size_t tx_current = in32(REG_TXDESCTAIL) % number_of_tx_descriptors;
     dbgln_if(E1000_DEBUG, "E1000: Sending packet ({} bytes)", payload.size());
     auto* tx_descriptors = (e1000_tx_desc*)m_tx_descriptors_region->vaddr().as_ptr();
+    bool const segment = offload.segment_size != 0;
+    size_t const header_size = offload.tcp_header_offset + offload.tcp_header_size;
+
+    if (segment) {
+        // The data of a packet that will be segmented is preceded by a context descriptor that describes its headers.
+        static constexpr size_t ipv4_checksum_offset = 10;
+        auto& context = *reinterpret_cast<e1000_tx_context_desc*>(&tx_descriptors[tx_current]);
+        context.ipcss = offload.tcp_header_offset - sizeof(IPv4Packet);
+        context.ipcso = context.ipcss + ipv4_checksum_offset;
+        context.ipcse = offload.tcp_header_offset - 1;
+        context.tucss = offload.tcp_header_offset;
+        context.tucso = offload.tcp_header_offset + TCPPacket::checksum_offset;
+        context.tucse = 0;
+        context.paylen_dtyp_tucmd = (payload.size() - header_size) | ((TUCMD_DEXT | TUCMD_TSE | TUCMD_IP | TUCMD_TCP) << 24);
+        context.status = 0;
+        context.hdrlen = header_size;
+        context.mss = offload.segment_size;
+        tx_current = (tx_current + 1) % number_of_tx_descriptors;
+    }
+
     auto& descriptor = tx_descriptors[tx_current];
-    VERIFY(payload.size() <= 8192);
-    auto* vptr = (void*)m_tx_buffers[tx_current];
+    VERIFY(payload.size() <= tx_buffer_size);
+    auto* vptr = (u8*)m_tx_buffers[tx_current];
     memcpy(vptr, payload.data(), payload.size());
+    // A context descriptor may have been in this slot before.
+    descriptor.addr = m_tx_buffer_region->physical_page(tx_buffer_size / PAGE_SIZE * tx_current)->paddr().get();
     descriptor.length = payload.size();
     descriptor.status = 0;
-    descriptor.cmd = CMD_EOP | CMD_IFCS | CMD_RS;
+    if (segment) {
+        // The adapter fills in the length and checksum of every segment's IPv4 header, and it expects
+        // the TCP checksum field to hold the sum of the pseudo header without the length.
+        auto& ipv4 = *reinterpret_cast<IPv4Packet*>(vptr + offload.tcp_header_offset - sizeof(IPv4Packet));
+        ipv4.set_length(0);
+        ipv4.set_checksum(0);
+        auto& tcp = *reinterpret_cast<TCPPacket*>(vptr + offload.tcp_header_offset);
+        u32 checksum = tcp.checksum() + (~(payload.size() - offload.tcp_header_offset) & 0xffff);
+        tcp.set_checksum((checksum >> 16) + (checksum & 0xffff));
+
+        descriptor.cso = DTYP_DATA;
+        descriptor.css = POPTS_IXSM | POPTS_TXSM;
+        descriptor.cmd = CMD_EOP | CMD_IFCS | CMD_RS | CMD_TSE | CMD_DEXT;
+    } else if (offload.tcp_header_offset != 0) {
+        descriptor.cso = offload.tcp_header_offset + TCPPacket::checksum_offset;
+        descriptor.css = offload.tcp_header_offset;
+        descriptor.cmd = CMD_EOP | CMD_IFCS | CMD_RS | CMD_IC;
+    } else {
+        descriptor.cso = 0;
+        descriptor.css = 0;
+        descriptor.cmd = CMD_EOP | CMD_IFCS | CMD_RS;
+    }
     dbgln_if(E1000_DEBUG, "E1000: Using tx descriptor {} (head is at {})", tx_current, in32(REG_TXDESCHEAD));
     tx_current = (tx_current + 1) % number_of_tx_descriptors;
     Processor::disable_interrupts();
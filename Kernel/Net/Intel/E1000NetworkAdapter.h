@@ -28,6 +28,7 @@ public:
     virtual ~E1000NetworkAdapter() override;
 
     virtual void send_raw(ReadonlyBytes) override;
+    virtual void send_raw_with_offload(ReadonlyBytes, TransmitOffloadRequest const&) override;
     virtual bool link_up() override { return m_link_up; }
     virtual i32 link_speed() override;
     virtual bool link_full_duplex() override;
@@ -70,6 +71,25 @@ protected:
         uint16_t volatile special { 0 };
     };
 
+    // Describes the headers of the packets that follow to the adapter, so that it can fill in their
+    // checksums and split them into segments. The data descriptors after it use the extended format,
+    // which is a e1000_tx_desc with the descriptor type in cso and the packet options in css.
+    struct [[gnu::packed]] e1000_tx_context_desc {
+        uint8_t volatile ipcss { 0 };
+        uint8_t volatile ipcso { 0 };
+        uint16_t volatile ipcse { 0 };
+        uint8_t volatile tucss { 0 };
+        uint8_t volatile tucso { 0 };
+        uint16_t volatile tucse { 0 };
+        uint32_t volatile paylen_dtyp_tucmd { 0 };
+        uint8_t volatile status { 0 };
+        uint8_t volatile hdrlen { 0 };
+        uint16_t volatile mss { 0 };
+    };
+    static_assert(sizeof(e1000_tx_context_desc) == sizeof(e1000_tx_desc));
+
+    void transmit(ReadonlyBytes, TransmitOffloadRequest const&);
+
     virtual void detect_eeprom();
     virtual u32 read_eeprom(u8 address);
     void read_mac_address();
@@ -20,6 +20,10 @@
 
 namespace Kernel {
 
+// Bounds for SO_SNDBUF and SO_RCVBUF. Each buffer is allocated twice over, since it's a DoubleBuffer.
+static constexpr size_t minimum_buffer_size = 4 * KiB;
+static constexpr size_t maximum_buffer_size = 1 * MiB;
+
 static Singleton<MutexProtected<LocalSocket::List>> s_list;
 
 static MutexProtected<LocalSocket::List>& all_sockets()
@@ -334,6 +338,20 @@ DoubleBuffer* LocalSocket::send_buffer_for(OpenFileDescription& description)
     return nullptr;
 }
 
+DoubleBuffer* LocalSocket::buffer_for_option(OpenFileDescription& description, int option)
+{
+    // Allow sizing the buffers before connecting, from the perspective of the side that will connect.
+    auto role = this->role(description);
+    if (role == Role::None || role == Role::Connecting)
+        role = Role::Connected;
+    if (role != Role::Connected && role != Role::Accepted)
+        return nullptr;
+    bool is_send_buffer = option == SO_SNDBUF;
+    if (role == Role::Connected)
+        return is_send_buffer ? m_for_server.ptr() : m_for_client.ptr();
+    return is_send_buffer ? m_for_client.ptr() : m_for_server.ptr();
+}
+
 ErrorOr<size_t> LocalSocket::recvfrom(OpenFileDescription& description, UserOrKernelBuffer& buffer, size_t buffer_size, int, Userspace<sockaddr*>, Userspace<socklen_t*>, UnixDateTime&, bool blocking)
 {
     auto* socket_buffer = receive_buffer_for(description);
@@ -404,9 +422,17 @@ ErrorOr<void> LocalSocket::getsockopt(OpenFileDescription& description, int leve
 
     switch (option) {
     case SO_SNDBUF:
-        return ENOTSUP;
-    case SO_RCVBUF:
-        return ENOTSUP;
+    case SO_RCVBUF: {
+        if (size < sizeof(int))
+            return EINVAL;
+        auto* buffer = buffer_for_option(description, option);
+        if (!buffer)
+            return ENOTCONN;
+        int buffer_size = buffer->capacity();
+        TRY(copy_to_user(static_ptr_cast<int*>(value), &buffer_size));
+        size = sizeof(int);
+        return copy_to_user(value_size, &size);
+    }
     case SO_PEERCRED: {
         if (size < sizeof(ucred))
             return EINVAL;
@@ -433,6 +459,26 @@ ErrorOr<void> LocalSocket::getsockopt(OpenFileDescription& description, int leve
     }
 }
 
+ErrorOr<void> LocalSocket::setsockopt(OpenFileDescription& description, int level, int option, Userspace<void const*> user_value, socklen_t user_value_size)
+{
+    if (level != SOL_SOCKET || (option != SO_SNDBUF && option != SO_RCVBUF))
+        return Socket::setsockopt(description, level, option, user_value, user_value_size);
+
+    MutexLocker locker(mutex());
+
+    if (user_value_size != sizeof(int))
+        return EINVAL;
+    int requested_size = TRY(copy_typed_from_user(static_ptr_cast<int const*>(user_value)));
+    if (requested_size < 0)
+        return EINVAL;
+    auto* buffer = buffer_for_option(description, option);
+    if (!buffer)
+        return ENOTCONN;
+    TRY(buffer->try_set_capacity(clamp(static_cast<size_t>(requested_size), minimum_buffer_size, maximum_buffer_size)));
+    evaluate_block_conditions();
+    return {};
+}
+
 ErrorOr<void> LocalSocket::ioctl(OpenFileDescription& description, unsigned request, Userspace<void*> arg)
 {
     switch (request) {
@@ -509,6 +555,20 @@ ErrorOr<void> LocalSocket::sendfd(OpenFileDescription const& socket_description,
     return {};
 }
 
+ErrorOr<void> LocalSocket::sendfds(OpenFileDescription const& socket_description, Vector<NonnullRefPtr<OpenFileDescription>>&& passing_descriptions)
+{
+    MutexLocker locker(mutex());
+    auto role = this->role(socket_description);
+    if (role != Role::Connected && role != Role::Accepted)
+        return set_so_error(EINVAL);
+    auto& queue = sendfd_queue_for(socket_description);
+    // FIXME: Figure out how we should limit this properly.
+    if (queue.size() + passing_descriptions.size() > 128)
+        return set_so_error(EBUSY);
+    SOCKET_TRY(queue.try_extend(move(passing_descriptions)));
+    return {};
+}
+
 ErrorOr<NonnullRefPtr<OpenFileDescription>> LocalSocket::recvfd(OpenFileDescription const& socket_description)
 {
     MutexLocker locker(mutex());
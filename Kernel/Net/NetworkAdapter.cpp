@@ -5,11 +5,11 @@
  */
 
 #include <Kernel/Heap/kmalloc.h>
-#include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/Library/StdLib.h>
 #include <Kernel/Net/EtherType.h>
 #include <Kernel/Net/NetworkAdapter.h>
 #include <Kernel/Net/NetworkingManagement.h>
+#include <Kernel/Net/TCP.h>
 #include <Kernel/Tasks/Process.h>
 
 namespace Kernel {
@@ -28,6 +28,37 @@ void NetworkAdapter::send_packet(ReadonlyBytes packet)
     send_raw(packet);
 }
 
+void NetworkAdapter::send_packet(ReadonlyBytes packet, TransmitOffloadRequest const& offload)
+{
+    if (offload.tcp_header_offset == 0) {
+        send_packet(packet);
+        return;
+    }
+    VERIFY(can_offload(offload));
+    m_packets_out++;
+    m_bytes_out += packet.size();
+    send_raw_with_offload(packet, offload);
+}
+
+bool NetworkAdapter::can_offload(TransmitOffloadRequest const& offload) const
+{
+    if (offload.segment_size != 0)
+        return has_transmit_offload(TransmitOffload::TCPSegmentation);
+    if (offload.tcp_header_offset != 0)
+        return has_transmit_offload(TransmitOffload::TCPChecksum);
+    return true;
+}
+
+void NetworkAdapter::set_transmit_offloads(TransmitOffload offloads, size_t maximum_segmentation_offload_size)
+{
+    if (has_flag(offloads, TransmitOffload::TCPSegmentation)) {
+        VERIFY(has_flag(offloads, TransmitOffload::TCPChecksum));
+        VERIFY(maximum_segmentation_offload_size > mtu());
+    }
+    m_transmit_offloads = offloads;
+    m_maximum_segmentation_offload_size = maximum_segmentation_offload_size;
+}
+
 void NetworkAdapter::send(MACAddress const& destination, ARPPacket const& packet)
 {
     size_t size_in_bytes = sizeof(EthernetFrameHeader) + sizeof(ARPPacket);
@@ -44,10 +75,10 @@ void NetworkAdapter::send(MACAddress const& destination, ARPPacket const& packet
     send_packet({ (u8 const*)eth, size_in_bytes });
 }
 
-void NetworkAdapter::fill_in_ipv4_header(PacketWithTimestamp& packet, IPv4Address const& source_ipv4, MACAddress const& destination_mac, IPv4Address const& destination_ipv4, IPv4Protocol protocol, size_t payload_size, u8 type_of_service, u8 ttl)
+void NetworkAdapter::fill_in_ipv4_header(PacketBuffer& packet, IPv4Address const& source_ipv4, MACAddress const& destination_mac, IPv4Address const& destination_ipv4, IPv4Protocol protocol, size_t payload_size, u8 type_of_service, u8 ttl)
 {
     size_t ipv4_packet_size = sizeof(IPv4Packet) + payload_size;
-    VERIFY(ipv4_packet_size <= mtu());
+    VERIFY(ipv4_packet_size <= max<size_t>(mtu(), m_maximum_segmentation_offload_size));
 
     size_t ethernet_frame_size = ipv4_payload_offset() + payload_size;
     VERIFY(packet.buffer->size() == ethernet_frame_size);
@@ -69,84 +100,187 @@ void NetworkAdapter::fill_in_ipv4_header(PacketWithTimestamp& packet, IPv4Addres
     ipv4.set_checksum(ipv4.compute_checksum());
 }
 
+void NetworkAdapter::set_receive_queue_count(size_t count)
+{
+    VERIFY(count > 0 && count <= max_receive_queues);
+    SpinlockLocker locker(m_receive_queues_lock);
+    m_receive_queue_count = count;
+}
+
+size_t NetworkAdapter::receive_queue_for_frame(ReadonlyBytes frame, size_t queue_count)
+{
+    // Everything that isn't part of a TCP or UDP flow (ARP, ICMP, fragments, ...) goes to the first queue.
+    constexpr size_t minimum_flow_frame_size = sizeof(EthernetFrameHeader) + sizeof(IPv4Packet) + 2 * sizeof(u16);
+    if (queue_count == 1 || frame.size() < minimum_flow_frame_size)
+        return 0;
+    auto& eth = *reinterpret_cast<EthernetFrameHeader const*>(frame.data());
+    if (eth.ether_type() != EtherType::IPv4)
+        return 0;
+    auto& ipv4 = *static_cast<IPv4Packet const*>(eth.payload());
+    if (ipv4.protocol() != (u8)IPv4Protocol::TCP && ipv4.protocol() != (u8)IPv4Protocol::UDP)
+        return 0;
+    if (ipv4.fragment_offset() != 0 || (ipv4.flags() & (u16)IPv4PacketFlags::MoreFragments))
+        return 0;
+
+    // Both TCP and UDP headers start with the source and destination ports.
+    u32 ports;
+    memcpy(&ports, ipv4.payload(), sizeof(ports));
+    auto addresses_hash = pair_int_hash(ipv4.source().to_u32(), ipv4.destination().to_u32());
+    return pair_int_hash(addresses_hash, ports) % queue_count;
+}
+
 void NetworkAdapter::did_receive(ReadonlyBytes payload)
 {
-    InterruptDisabler disabler;
+    // This is the only time the frame is copied, from here on everyone shares the same buffer.
+    auto packet = PacketBuffer::try_create(payload.size());
+    if (packet)
+        memcpy(packet->buffer->data(), payload.data(), payload.size());
+
+    SpinlockLocker locker(m_receive_queues_lock);
     m_packets_in++;
     m_bytes_in += payload.size();
 
-    if (m_packet_queue_size == max_packet_buffers) {
+    if (m_packet_queue_size == max_queued_packets) {
         m_packets_dropped++;
         return;
     }
 
-    auto packet = acquire_packet_buffer(payload.size());
     if (!packet) {
         dbgln("Discarding packet because we're out of memory");
         return;
     }
 
-    memcpy(packet->buffer->data(), payload.data(), payload.size());
-
-    m_packet_queue.append(*packet);
+    auto queue_index = receive_queue_for_frame(payload, m_receive_queue_count);
+    m_receive_queues[queue_index].append(*packet);
     m_packet_queue_size++;
+    locker.unlock();
 
     if (on_receive)
-        on_receive();
+        on_receive(queue_index);
 }
 
-size_t NetworkAdapter::dequeue_packet(u8* buffer, size_t buffer_size, UnixDateTime& packet_timestamp)
+// Returns the TCP header of a frame that carries nothing but data for an established connection.
+static TCPPacket const* coalescable_tcp_segment(ReadonlyBytes frame)
 {
-    InterruptDisabler disabler;
-    if (m_packet_queue.is_empty())
-        return 0;
-    auto packet_with_timestamp = m_packet_queue.take_first();
-    m_packet_queue_size--;
-    packet_timestamp = packet_with_timestamp->timestamp;
-    auto& packet_buffer = packet_with_timestamp->buffer;
-    size_t packet_size = packet_buffer->size();
-    VERIFY(packet_size <= buffer_size);
-    memcpy(buffer, packet_buffer->data(), packet_size);
-    release_packet_buffer(*packet_with_timestamp);
-    return packet_size;
+    if (frame.size() < sizeof(EthernetFrameHeader) + sizeof(IPv4Packet) + sizeof(TCPPacket))
+        return nullptr;
+    auto& eth = *reinterpret_cast<EthernetFrameHeader const*>(frame.data());
+    if (eth.ether_type() != EtherType::IPv4)
+        return nullptr;
+    auto& ipv4 = *static_cast<IPv4Packet const*>(eth.payload());
+    if (ipv4.internet_header_length() != 5 || ipv4.protocol() != (u8)IPv4Protocol::TCP || ipv4.is_a_fragment())
+        return nullptr;
+    if (ipv4.length() > frame.size() - sizeof(EthernetFrameHeader))
+        return nullptr;
+    auto& tcp = *static_cast<TCPPacket const*>(ipv4.payload());
+    if (tcp.header_size() < sizeof(TCPPacket) || ipv4.payload_size() <= tcp.header_size())
+        return nullptr;
+    if (tcp.flags() != TCPFlags::ACK && tcp.flags() != (TCPFlags::ACK | TCPFlags::PSH))
+        return nullptr;
+    return &tcp;
 }
 
-RefPtr<PacketWithTimestamp> NetworkAdapter::acquire_packet_buffer(size_t size)
+// Whether the payload of `next_frame` can be appended to the segment in `frame`, which is the case if it directly
+// follows it on the same connection, and its headers don't differ in anything else. This saves the TCP code from
+// going through every segment of a bulk transfer on its own (what other systems call generic receive offload).
+static bool can_coalesce_tcp_segments(ReadonlyBytes frame, ReadonlyBytes next_frame)
 {
-    auto packet = m_unused_packets.with([size](auto& unused_packets) -> RefPtr<PacketWithTimestamp> {
-        if (unused_packets.is_empty())
-            return nullptr;
+    auto const* tcp = coalescable_tcp_segment(frame);
+    auto const* next_tcp = coalescable_tcp_segment(next_frame);
+    if (!tcp || !next_tcp)
+        return false;
+    // A push asks for the data to be delivered right away, it ends the coalesced segment.
+    if (tcp->flags() & TCPFlags::PSH)
+        return false;
 
-        auto unused_packet = unused_packets.take_first();
+    auto const& ipv4 = *reinterpret_cast<IPv4Packet const*>(frame.offset(sizeof(EthernetFrameHeader)));
+    auto const& next_ipv4 = *reinterpret_cast<IPv4Packet const*>(next_frame.offset(sizeof(EthernetFrameHeader)));
+    if (ipv4.source() != next_ipv4.source() || ipv4.destination() != next_ipv4.destination() || ipv4.dscp_and_ecn() != next_ipv4.dscp_and_ecn())
+        return false;
+    if (tcp->source_port() != next_tcp->source_port() || tcp->destination_port() != next_tcp->destination_port())
+        return false;
+    if (tcp->ack_number() != next_tcp->ack_number() || tcp->window_size() != next_tcp->window_size())
+        return false;
+    auto header_size = tcp->header_size();
+    if (header_size != next_tcp->header_size() || memcmp(tcp + 1, next_tcp + 1, header_size - sizeof(TCPPacket)) != 0)
+        return false;
 
-        if (unused_packet->buffer->capacity() >= size)
-            return unused_packet;
+    size_t payload_size = ipv4.payload_size() - header_size;
+    if (next_tcp->sequence_number() != tcp->sequence_number() + payload_size)
+        return false;
+    size_t next_payload_size = next_ipv4.payload_size() - header_size;
+    return ipv4.length() + next_payload_size <= NumericLimits<u16>::max();
+}
 
-        unused_packets.append(*unused_packet);
-        return nullptr;
-    });
+// Note that the TCP checksum of the coalesced segment is meaningless, received checksums aren't verified.
+static void coalesce_tcp_segment(PacketBuffer& packet, ReadonlyBytes next_frame)
+{
+    auto& ipv4 = *reinterpret_cast<IPv4Packet*>(packet.buffer->data() + sizeof(EthernetFrameHeader));
+    auto& tcp = *reinterpret_cast<TCPPacket*>(packet.buffer->data() + sizeof(EthernetFrameHeader) + sizeof(IPv4Packet));
+    auto const& next_ipv4 = *reinterpret_cast<IPv4Packet const*>(next_frame.offset(sizeof(EthernetFrameHeader)));
+    auto const& next_tcp = *static_cast<TCPPacket const*>(next_ipv4.payload());
+    size_t next_payload_size = next_ipv4.payload_size() - next_tcp.header_size();
 
-    if (packet) {
-        packet->timestamp = kgettimeofday();
-        packet->buffer->set_size(size);
-        return packet;
-    }
+    // Ethernet frames may be padded, the coalesced one ends right after the IPv4 packet.
+    size_t packet_size = sizeof(EthernetFrameHeader) + ipv4.length();
+    VERIFY(packet_size + next_payload_size <= packet.buffer->capacity());
+    memcpy(packet.buffer->data() + packet_size, next_tcp.payload(), next_payload_size);
+    packet.buffer->set_size(packet_size + next_payload_size);
 
-    auto buffer_or_error = KBuffer::try_create_with_size("NetworkAdapter: Packet buffer"sv, size, Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow);
-    if (buffer_or_error.is_error())
-        return {};
-    packet = adopt_ref_if_nonnull(new (nothrow) PacketWithTimestamp { buffer_or_error.release_value(), kgettimeofday() });
-    if (!packet)
-        return {};
-    packet->buffer->set_size(size);
-    return packet;
+    tcp.set_flags(next_tcp.flags());
+    ipv4.set_length(ipv4.length() + next_payload_size);
+    ipv4.set_checksum(0);
+    ipv4.set_checksum(ipv4.compute_checksum());
 }
 
-void NetworkAdapter::release_packet_buffer(PacketWithTimestamp& packet)
+RefPtr<PacketBuffer> NetworkAdapter::dequeue_packet(size_t queue_index, size_t& frame_count)
 {
-    m_unused_packets.with([&packet](auto& unused_packets) {
-        unused_packets.append(packet);
-    });
+    SpinlockLocker locker(m_receive_queues_lock);
+    auto& queue = m_receive_queues[queue_index];
+    if (queue.is_empty())
+        return nullptr;
+    auto packet = queue.take_first();
+    m_packet_queue_size--;
+    locker.unlock();
+    frame_count = 1;
+
+    if (!coalescable_tcp_segment(packet->bytes()))
+        return packet;
+
+    // The first segment that is coalesced moves the packet into a buffer that is large enough for all of them.
+    auto make_room_for_coalesced_segments = [&] {
+        if (packet->buffer->capacity() >= PacketBuffer::large_buffer_capacity)
+            return true;
+        auto large_packet = PacketBuffer::try_create(PacketBuffer::large_buffer_capacity);
+        if (!large_packet)
+            return false;
+        large_packet->buffer->set_size(packet->buffer->size());
+        memcpy(large_packet->buffer->data(), packet->buffer->data(), packet->buffer->size());
+        large_packet->timestamp = packet->timestamp;
+        packet = move(large_packet);
+        return true;
+    };
+
+    // Every queue only has a single reader, so a frame can be put back where it was taken from.
+    for (;;) {
+        locker.lock();
+        if (queue.is_empty())
+            break;
+        auto next_packet = queue.take_first();
+        m_packet_queue_size--;
+        locker.unlock();
+
+        if (!can_coalesce_tcp_segments(packet->bytes(), next_packet->bytes()) || !make_room_for_coalesced_segments()) {
+            locker.lock();
+            queue.prepend(*next_packet);
+            m_packet_queue_size++;
+            break;
+        }
+        coalesce_tcp_segment(*packet, next_packet->bytes());
+        m_packets_coalesced++;
+        frame_count++;
+    }
+    return packet;
 }
 
 void NetworkAdapter::set_ipv4_address(IPv4Address const& address)
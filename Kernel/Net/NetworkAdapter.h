@@ -6,8 +6,10 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/AtomicRefCounted.h>
 #include <AK/ByteBuffer.h>
+#include <AK/EnumBits.h>
 #include <AK/Function.h>
 #include <AK/IntrusiveList.h>
 #include <AK/MACAddress.h>
@@ -17,10 +19,12 @@
 #include <Kernel/Library/LockWeakPtr.h>
 #include <Kernel/Library/LockWeakable.h>
 #include <Kernel/Library/UserOrKernelBuffer.h>
+#include <Kernel/Locking/Spinlock.h>
 #include <Kernel/Net/ARP.h>
 #include <Kernel/Net/EthernetFrameHeader.h>
 #include <Kernel/Net/ICMP.h>
 #include <Kernel/Net/IPv4.h>
+#include <Kernel/Net/PacketBuffer.h>
 
 namespace Kernel {
 
@@ -28,20 +32,6 @@ class NetworkAdapter;
 
 using NetworkByteBuffer = AK::Detail::ByteBuffer<1500>;
 
-struct PacketWithTimestamp final : public AtomicRefCounted<PacketWithTimestamp> {
-    PacketWithTimestamp(NonnullOwnPtr<KBuffer> buffer, UnixDateTime timestamp)
-        : buffer(move(buffer))
-        , timestamp(timestamp)
-    {
-    }
-
-    ReadonlyBytes bytes() { return buffer->bytes(); }
-
-    NonnullOwnPtr<KBuffer> buffer;
-    UnixDateTime timestamp;
-    IntrusiveListNode<PacketWithTimestamp, RefPtr<PacketWithTimestamp>> packet_node;
-};
-
 class NetworkingManagement;
 class NetworkAdapter
     : public AtomicRefCounted<NetworkAdapter>
@@ -54,6 +44,25 @@ public:
 
     static constexpr i32 LINKSPEED_INVALID = -1;
 
+    // Work on outgoing packets that the adapter can take off our hands.
+    enum class TransmitOffload : u8 {
+        None = 0,
+        // The adapter fills in the TCP checksum. The checksum field has to hold the sum of the pseudo header.
+        TCPChecksum = 1 << 0,
+        // The adapter splits TCP segments that are larger than the MSS (TSO), this implies TCPChecksum.
+        TCPSegmentation = 1 << 1,
+    };
+    AK_ENUM_BITWISE_FRIEND_OPERATORS(TransmitOffload);
+
+    // What the adapter still has to do to a packet before it goes out on the wire.
+    struct TransmitOffloadRequest {
+        // Where the TCP header starts in the frame, zero if the packet can be sent as it is.
+        u16 tcp_header_offset { 0 };
+        u16 tcp_header_size { 0 };
+        // If non-zero, the payload goes out in segments of this size, each with a copy of the headers.
+        u16 segment_size { 0 };
+    };
+
     virtual ~NetworkAdapter();
 
     virtual StringView class_name() const = 0;
@@ -77,11 +86,20 @@ public:
     void set_ipv4_netmask(IPv4Address const&);
 
     void send(MACAddress const&, ARPPacket const&);
-    void fill_in_ipv4_header(PacketWithTimestamp&, IPv4Address const&, MACAddress const&, IPv4Address const&, IPv4Protocol, size_t, u8 type_of_service, u8 ttl);
+    void fill_in_ipv4_header(PacketBuffer&, IPv4Address const&, MACAddress const&, IPv4Address const&, IPv4Protocol, size_t, u8 type_of_service, u8 ttl);
 
-    size_t dequeue_packet(u8* buffer, size_t buffer_size, UnixDateTime& packet_timestamp);
+    // Received frames are spread over several queues by the flow they belong to, so that the packets
+    // of one TCP or UDP flow always end up in the same queue (and thus are processed in order),
+    // while different flows can be processed on different processors at the same time.
+    static constexpr size_t max_receive_queues = 8;
+    size_t receive_queue_count() const { return m_receive_queue_count; }
+    void set_receive_queue_count(size_t);
 
-    bool has_queued_packets() const { return !m_packet_queue.is_empty(); }
+    // Consecutive in-order segments of the same TCP connection that are waiting in the queue are
+    // coalesced into a single one, `frame_count` is the number of received frames that went into the packet.
+    RefPtr<PacketBuffer> dequeue_packet(size_t queue_index, size_t& frame_count);
+
+    bool has_queued_packets(size_t queue_index) const { return !m_receive_queues[queue_index].is_empty(); }
 
     u32 mtu() const { return m_mtu; }
     void set_mtu(u32 mtu) { m_mtu = mtu; }
@@ -91,22 +109,30 @@ public:
     u32 packets_out() const { return m_packets_out; }
     u32 bytes_out() const { return m_bytes_out; }
     u32 packets_dropped() const { return m_packets_dropped; }
+    u32 packets_coalesced() const { return m_packets_coalesced; }
 
-    RefPtr<PacketWithTimestamp> acquire_packet_buffer(size_t);
-    void release_packet_buffer(PacketWithTimestamp&);
+    TransmitOffload transmit_offloads() const { return m_transmit_offloads; }
+    bool has_transmit_offload(TransmitOffload offload) const { return has_flag(m_transmit_offloads, offload); }
+    // The largest IPv4 packet that may be handed to the adapter for segmentation.
+    size_t maximum_segmentation_offload_size() const { return m_maximum_segmentation_offload_size; }
+    bool can_offload(TransmitOffloadRequest const&) const;
 
     constexpr size_t layer3_payload_offset() const { return sizeof(EthernetFrameHeader); }
     constexpr size_t ipv4_payload_offset() const { return layer3_payload_offset() + sizeof(IPv4Packet); }
 
-    Function<void()> on_receive;
+    Function<void(size_t queue_index)> on_receive;
 
     void send_packet(ReadonlyBytes);
+    void send_packet(ReadonlyBytes, TransmitOffloadRequest const&);
 
 protected:
     NetworkAdapter(StringView);
     void set_mac_address(MACAddress const& mac_address) { m_mac_address = mac_address; }
+    void set_transmit_offloads(TransmitOffload, size_t maximum_segmentation_offload_size = 0);
     void did_receive(ReadonlyBytes);
     virtual void send_raw(ReadonlyBytes) = 0;
+    // Only called with requests for the offloads the adapter advertised.
+    virtual void send_raw_with_offload(ReadonlyBytes, TransmitOffloadRequest const&) { VERIFY_NOT_REACHED(); }
 
 private:
     MACAddress m_mac_address;
@@ -114,13 +140,16 @@ private:
     IPv4Address m_ipv4_netmask;
 
     // FIXME: Make this configurable
-    static constexpr size_t max_packet_buffers = 1024;
+    static constexpr size_t max_queued_packets = 1024;
+
+    using PacketList = IntrusiveList<&PacketBuffer::packet_node>;
 
-    using PacketList = IntrusiveList<&PacketWithTimestamp::packet_node>;
+    static size_t receive_queue_for_frame(ReadonlyBytes, size_t queue_count);
 
-    PacketList m_packet_queue;
+    Spinlock<LockRank::None> m_receive_queues_lock {};
+    Array<PacketList, max_receive_queues> m_receive_queues;
+    size_t m_receive_queue_count { 1 };
     size_t m_packet_queue_size { 0 };
-    SpinlockProtected<PacketList, LockRank::None> m_unused_packets {};
     FixedStringBuffer<IFNAMSIZ> m_name;
     u32 m_packets_in { 0 };
     u32 m_bytes_in { 0 };
@@ -128,6 +157,9 @@ private:
     u32 m_bytes_out { 0 };
     u32 m_mtu { 1500 };
     u32 m_packets_dropped { 0 };
+    u32 m_packets_coalesced { 0 };
+    TransmitOffload m_transmit_offloads { TransmitOffload::None };
+    size_t m_maximum_segmentation_offload_size { 0 };
 };
 
 }
@@ -25,38 +25,103 @@
 
 namespace Kernel {
 
+// Every receive queue of the network adapters is drained by a worker thread of its own, the first one
+// of them being the Network Task's main thread, which also takes care of retransmitting TCP packets.
+struct ReceiveWorker {
+    size_t queue_index { 0 };
+    WaitQueue packet_wait_queue;
+    Atomic<size_t> pending_packets { 0 };
+    // A socket's packets are always received by the same worker, so the worker can keep its delayed ACKs to itself.
+    HashTable<NonnullRefPtr<TCPSocket>> delayed_ack_sockets;
+};
+
 static void handle_arp(EthernetFrameHeader const&, size_t frame_size);
-static void handle_ipv4(EthernetFrameHeader const&, size_t frame_size, UnixDateTime const& packet_timestamp);
-static void handle_icmp(EthernetFrameHeader const&, IPv4Packet const&, UnixDateTime const& packet_timestamp);
-static void handle_udp(IPv4Packet const&, UnixDateTime const& packet_timestamp);
-static void handle_tcp(IPv4Packet const&, UnixDateTime const& packet_timestamp);
-static void send_delayed_tcp_ack(TCPSocket& socket);
+static void handle_ipv4(ReceiveWorker&, PacketBuffer&, EthernetFrameHeader const&, size_t frame_size);
+static void handle_icmp(PacketBuffer&, EthernetFrameHeader const&, IPv4Packet const&);
+static void handle_udp(PacketBuffer&, IPv4Packet const&);
+static void handle_tcp(ReceiveWorker&, PacketBuffer&, IPv4Packet const&);
+static void send_delayed_tcp_ack(ReceiveWorker&, TCPSocket& socket);
 static void send_tcp_rst(IPv4Packet const& ipv4_packet, TCPPacket const& tcp_packet, RefPtr<NetworkAdapter> adapter);
-static void flush_delayed_tcp_acks();
+static void flush_delayed_tcp_acks(ReceiveWorker&);
 static void retransmit_tcp_packets();
 
-static Thread* network_task = nullptr;
-static HashTable<NonnullRefPtr<TCPSocket>>* delayed_ack_sockets;
+static Process* network_task = nullptr;
+static Array<ReceiveWorker, NetworkAdapter::max_receive_queues>* receive_workers;
+static size_t receive_worker_count = 1;
 
 [[noreturn]] static void NetworkTask_main(void*);
+[[noreturn]] static void receive_worker_main(void*);
 
 void NetworkTask::spawn()
 {
-    auto [_, first_thread] = MUST(Process::create_kernel_process("Network Task"sv, NetworkTask_main, nullptr));
-    network_task = first_thread;
+    auto [process, _] = MUST(Process::create_kernel_process("Network Task"sv, NetworkTask_main, nullptr));
+    network_task = process.ptr();
 }
 
 bool NetworkTask::is_current()
 {
-    return Thread::current() == network_task;
+    return &Thread::current()->process() == network_task;
+}
+
+static RefPtr<PacketBuffer> dequeue_packet(ReceiveWorker& worker)
+{
+    if (worker.pending_packets.load() == 0)
+        return nullptr;
+    RefPtr<PacketBuffer> packet;
+    NetworkingManagement::the().for_each([&](auto& adapter) {
+        if (packet || !adapter.has_queued_packets(worker.queue_index))
+            return;
+        size_t frame_count = 0;
+        packet = adapter.dequeue_packet(worker.queue_index, frame_count);
+        worker.pending_packets -= frame_count;
+        dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued packet from {} into queue {} ({} bytes, {} frames)", adapter.name(), worker.queue_index, packet ? packet->buffer->size() : 0, frame_count);
+    });
+    return packet;
+}
+
+static void process_next_packet(ReceiveWorker& worker)
+{
+    auto packet = dequeue_packet(worker);
+    if (!packet) {
+        auto timeout_time = Duration::from_milliseconds(500);
+        auto timeout = Thread::BlockTimeout { false, &timeout_time };
+        [[maybe_unused]] auto result = worker.packet_wait_queue.wait_on(timeout, "NetworkTask"sv);
+        return;
+    }
+    size_t packet_size = packet->buffer->size();
+    if (packet_size < sizeof(EthernetFrameHeader)) {
+        dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", packet_size);
+        return;
+    }
+    auto& eth = *(EthernetFrameHeader const*)packet->buffer->data();
+    dbgln_if(ETHERNET_DEBUG, "NetworkTask: From {} to {}, ether_type={:#04x}, packet_size={}", eth.source().to_string(), eth.destination().to_string(), eth.ether_type(), packet_size);
+
+    switch (eth.ether_type()) {
+    case EtherType::ARP:
+        handle_arp(eth, packet_size);
+        break;
+    case EtherType::IPv4:
+        handle_ipv4(worker, *packet, eth, packet_size);
+        break;
+    case EtherType::IPv6:
+        // ignore
+        break;
+    default:
+        dbgln_if(ETHERNET_DEBUG, "NetworkTask: Unknown ethernet type {:#04x}", eth.ether_type());
+    }
 }
 
 void NetworkTask_main(void*)
 {
-    delayed_ack_sockets = new HashTable<NonnullRefPtr<TCPSocket>>;
+    receive_workers = new Array<ReceiveWorker, NetworkAdapter::max_receive_queues>;
+
+    // NOTE: Processor::count() is not maintained on every architecture, but there is always at least one processor.
+    receive_worker_count = min(max(Processor::count(), 1u), NetworkAdapter::max_receive_queues);
+    for (size_t i = 0; i < receive_worker_count; ++i) {
+        auto& worker = (*receive_workers)[i];
+        worker.queue_index = i;
+    }
 
-    WaitQueue packet_wait_queue;
-    int pending_packets = 0;
     NetworkingManagement::the().for_each([&](auto& adapter) {
         dmesgln("NetworkTask: {} network adapter found: hw={}", adapter.class_name(), adapter.mac_address().to_string());
 
@@ -65,69 +130,42 @@ void NetworkTask_main(void*)
             adapter.set_ipv4_netmask({ 255, 0, 0, 0 });
         }
 
-        adapter.on_receive = [&]() {
-            pending_packets++;
-            packet_wait_queue.wake_all();
+        adapter.set_receive_queue_count(receive_worker_count);
+        adapter.on_receive = [](size_t queue_index) {
+            auto& worker = (*receive_workers)[queue_index];
+            worker.pending_packets++;
+            worker.packet_wait_queue.wake_all();
         };
     });
 
-    auto dequeue_packet = [&pending_packets](u8* buffer, size_t buffer_size, UnixDateTime& packet_timestamp) -> size_t {
-        if (pending_packets == 0)
-            return 0;
-        size_t packet_size = 0;
-        NetworkingManagement::the().for_each([&](auto& adapter) {
-            if (packet_size || !adapter.has_queued_packets())
-                return;
-            packet_size = adapter.dequeue_packet(buffer, buffer_size, packet_timestamp);
-            pending_packets--;
-            dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued packet from {} ({} bytes)", adapter.name(), packet_size);
-        });
-        return packet_size;
-    };
-
-    size_t buffer_size = 64 * KiB;
-    auto region_or_error = MM.allocate_kernel_region(buffer_size, "Kernel Packet Buffer"sv, Memory::Region::Access::ReadWrite);
-    if (region_or_error.is_error())
-        TODO();
-    auto buffer_region = region_or_error.release_value();
-    auto buffer = (u8*)buffer_region->vaddr().get();
-    UnixDateTime packet_timestamp;
+    auto& main_worker = (*receive_workers)[0];
+    for (size_t i = 1; i < receive_worker_count; ++i) {
+        auto& worker = (*receive_workers)[i];
+        auto name = MUST(KString::formatted("Network Task #{}", i));
+        MUST(Process::current().create_kernel_thread(receive_worker_main, &worker, THREAD_PRIORITY_NORMAL, name->view(), THREAD_AFFINITY_DEFAULT, false));
+    }
+    dmesgln("NetworkTask: Processing received packets on {} thread(s)", receive_worker_count);
 
     while (!Process::current().is_dying()) {
-        flush_delayed_tcp_acks();
+        flush_delayed_tcp_acks(main_worker);
         retransmit_tcp_packets();
-        size_t packet_size = dequeue_packet(buffer, buffer_size, packet_timestamp);
-        if (!packet_size) {
-            auto timeout_time = Duration::from_milliseconds(500);
-            auto timeout = Thread::BlockTimeout { false, &timeout_time };
-            [[maybe_unused]] auto result = packet_wait_queue.wait_on(timeout, "NetworkTask"sv);
-            continue;
-        }
-        if (packet_size < sizeof(EthernetFrameHeader)) {
-            dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", packet_size);
-            continue;
-        }
-        auto& eth = *(EthernetFrameHeader const*)buffer;
-        dbgln_if(ETHERNET_DEBUG, "NetworkTask: From {} to {}, ether_type={:#04x}, packet_size={}", eth.source().to_string(), eth.destination().to_string(), eth.ether_type(), packet_size);
-
-        switch (eth.ether_type()) {
-        case EtherType::ARP:
-            handle_arp(eth, packet_size);
-            break;
-        case EtherType::IPv4:
-            handle_ipv4(eth, packet_size, packet_timestamp);
-            break;
-        case EtherType::IPv6:
-            // ignore
-            break;
-        default:
-            dbgln_if(ETHERNET_DEBUG, "NetworkTask: Unknown ethernet type {:#04x}", eth.ether_type());
-        }
+        process_next_packet(main_worker);
     }
     Process::current().sys$exit(0);
     VERIFY_NOT_REACHED();
 }
 
+void receive_worker_main(void* data)
+{
+    auto& worker = *static_cast<ReceiveWorker*>(data);
+    while (!Process::current().is_dying()) {
+        flush_delayed_tcp_acks(worker);
+        process_next_packet(worker);
+    }
+    Thread::current()->exit();
+    VERIFY_NOT_REACHED();
+}
+
 void handle_arp(EthernetFrameHeader const& eth, size_t frame_size)
 {
     constexpr size_t minimum_arp_frame_size = sizeof(EthernetFrameHeader) + sizeof(ARPPacket);
@@ -176,7 +214,7 @@ void handle_arp(EthernetFrameHeader const& eth, size_t frame_size)
     }
 }
 
-void handle_ipv4(EthernetFrameHeader const& eth, size_t frame_size, UnixDateTime const& packet_timestamp)
+void handle_ipv4(ReceiveWorker& worker, PacketBuffer& received_packet, EthernetFrameHeader const& eth, size_t frame_size)
 {
     constexpr size_t minimum_ipv4_frame_size = sizeof(EthernetFrameHeader) + sizeof(IPv4Packet);
     if (frame_size < minimum_ipv4_frame_size) {
@@ -210,18 +248,18 @@ void handle_ipv4(EthernetFrameHeader const& eth, size_t frame_size, UnixDateTime
 
     switch ((IPv4Protocol)packet.protocol()) {
     case IPv4Protocol::ICMP:
-        return handle_icmp(eth, packet, packet_timestamp);
+        return handle_icmp(received_packet, eth, packet);
     case IPv4Protocol::UDP:
-        return handle_udp(packet, packet_timestamp);
+        return handle_udp(received_packet, packet);
     case IPv4Protocol::TCP:
-        return handle_tcp(packet, packet_timestamp);
+        return handle_tcp(worker, received_packet, packet);
     default:
         dbgln_if(IPV4_DEBUG, "handle_ipv4: Unhandled protocol {:#02x}", packet.protocol());
         break;
     }
 }
 
-void handle_icmp(EthernetFrameHeader const& eth, IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timestamp)
+void handle_icmp(PacketBuffer& received_packet, EthernetFrameHeader const& eth, IPv4Packet const& ipv4_packet)
 {
     auto& icmp_header = *static_cast<ICMPHeader const*>(ipv4_packet.payload());
     dbgln_if(ICMP_DEBUG, "handle_icmp: source={}, destination={}, type={:#02x}, code={:#02x}", ipv4_packet.source().to_string(), ipv4_packet.destination().to_string(), icmp_header.type(), icmp_header.code());
@@ -235,7 +273,7 @@ void handle_icmp(EthernetFrameHeader const& eth, IPv4Packet const& ipv4_packet,
             }
         });
         for (auto& socket : icmp_sockets)
-            socket->did_receive(ipv4_packet.source(), 0, { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, packet_timestamp);
+            socket->did_receive(ipv4_packet.source(), 0, received_packet, { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() });
     }
 
     auto adapter = NetworkingManagement::the().from_ipv4_address(ipv4_packet.destination());
@@ -251,7 +289,7 @@ void handle_icmp(EthernetFrameHeader const& eth, IPv4Packet const& ipv4_packet,
             return;
         }
         auto ipv4_payload_offset = adapter->ipv4_payload_offset();
-        auto packet = adapter->acquire_packet_buffer(ipv4_payload_offset + icmp_packet_size);
+        auto packet = PacketBuffer::try_create(ipv4_payload_offset + icmp_packet_size);
         if (!packet) {
             dbgln("Could not allocate packet buffer while sending ICMP packet");
             return;
@@ -268,11 +306,10 @@ void handle_icmp(EthernetFrameHeader const& eth, IPv4Packet const& ipv4_packet,
         response.header.set_checksum(internet_checksum(&response, icmp_packet_size));
         // FIXME: What is the right TTL value here? Is 64 ok? Should we use the same TTL as the echo request?
         adapter->send_packet(packet->bytes());
-        adapter->release_packet_buffer(*packet);
     }
 }
 
-void handle_udp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timestamp)
+void handle_udp(PacketBuffer& received_packet, IPv4Packet const& ipv4_packet)
 {
     if (ipv4_packet.payload_size() < sizeof(UDPPacket)) {
         dbgln("handle_udp: Packet too small ({}, need {})", ipv4_packet.payload_size(), sizeof(UDPPacket));
@@ -297,10 +334,10 @@ void handle_udp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
     auto& destination = ipv4_packet.destination();
 
     if (destination == IPv4Address(255, 255, 255, 255) || NetworkingManagement::the().from_ipv4_address(destination) || socket->multicast_memberships().contains_slow(destination))
-        socket->did_receive(ipv4_packet.source(), udp_packet.source_port(), { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, packet_timestamp);
+        socket->did_receive(ipv4_packet.source(), udp_packet.source_port(), received_packet, { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() });
 }
 
-void send_delayed_tcp_ack(TCPSocket& socket)
+void send_delayed_tcp_ack(ReceiveWorker& worker, TCPSocket& socket)
 {
     VERIFY(socket.mutex().is_locked());
     if (!socket.should_delay_next_ack()) {
@@ -308,13 +345,13 @@ void send_delayed_tcp_ack(TCPSocket& socket)
         return;
     }
 
-    delayed_ack_sockets->set(move(socket));
+    worker.delayed_ack_sockets.set(move(socket));
 }
 
-void flush_delayed_tcp_acks()
+void flush_delayed_tcp_acks(ReceiveWorker& worker)
 {
     Vector<NonnullRefPtr<TCPSocket>, 32> remaining_sockets;
-    for (auto& socket : *delayed_ack_sockets) {
+    for (auto& socket : worker.delayed_ack_sockets) {
         MutexLocker locker(socket->mutex());
         if (socket->should_delay_next_ack()) {
             MUST(remaining_sockets.try_append(*socket));
@@ -323,12 +360,12 @@ void flush_delayed_tcp_acks()
         [[maybe_unused]] auto result = socket->send_ack();
     }
 
-    if (remaining_sockets.size() != delayed_ack_sockets->size()) {
-        delayed_ack_sockets->clear();
+    if (remaining_sockets.size() != worker.delayed_ack_sockets.size()) {
+        worker.delayed_ack_sockets.clear();
         if (remaining_sockets.size() > 0)
             dbgln("flush_delayed_tcp_acks: {} sockets remaining", remaining_sockets.size());
         for (auto&& socket : remaining_sockets)
-            delayed_ack_sockets->set(move(socket));
+            worker.delayed_ack_sockets.set(move(socket));
     }
 }
 
@@ -344,7 +381,7 @@ void send_tcp_rst(IPv4Packet const& ipv4_packet, TCPPacket const& tcp_packet, Re
     size_t const tcp_header_size = sizeof(TCPPacket) + options_size;
     size_t const buffer_size = ipv4_payload_offset + tcp_header_size;
 
-    auto packet = routing_decision.adapter->acquire_packet_buffer(buffer_size);
+    auto packet = PacketBuffer::try_create(buffer_size);
     if (!packet)
         return;
     routing_decision.adapter->fill_in_ipv4_header(*packet, ipv4_packet.destination(),
@@ -363,10 +400,9 @@ void send_tcp_rst(IPv4Packet const& ipv4_packet, TCPPacket const& tcp_packet, Re
     rst_packet.set_checksum(TCPSocket::compute_tcp_checksum(ipv4_packet.source(), ipv4_packet.destination(), rst_packet, 0));
 
     routing_decision.adapter->send_packet(packet->bytes());
-    routing_decision.adapter->release_packet_buffer(*packet);
 }
 
-void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timestamp)
+void handle_tcp(ReceiveWorker& worker, PacketBuffer& received_packet, IPv4Packet const& ipv4_packet)
 {
     if (ipv4_packet.payload_size() < sizeof(TCPPacket)) {
         dbgln("handle_tcp: IPv4 payload is too small to be a TCP packet ({}, need {})", ipv4_packet.payload_size(), sizeof(TCPPacket));
@@ -430,19 +466,9 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
     dbgln_if(TCP_DEBUG, "handle_tcp: got socket {}; state={}", socket->tuple().to_string(), TCPSocket::to_string(socket->state()));
 
     socket->receive_tcp_packet(tcp_packet, ipv4_packet.payload_size());
-    Optional<u8> send_window_scale;
-    if (tcp_packet.has_syn()) {
-        tcp_packet.for_each_option([&send_window_scale](auto const& option) {
-            if (option.kind() != TCPOptionKind::WindowScale)
-                return;
-            if (option.length() != sizeof(TCPOptionWindowScale))
-                return;
-            auto scale = static_cast<TCPOptionWindowScale const&>(option).value();
-            if (scale > 14)
-                return; // Maximum allowed as per RFC7323
-            send_window_scale = scale;
-        });
-    }
+    TCPSocket::SynOptions syn_options;
+    if (tcp_packet.has_syn())
+        syn_options = TCPSocket::parse_syn_options(tcp_packet);
 
     switch (socket->state()) {
     case TCPSocket::State::Closed:
@@ -475,10 +501,9 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
             dbgln_if(TCP_DEBUG, "handle_tcp: created new client socket with tuple {}", client->tuple().to_string());
             client->set_sequence_number(1000);
             client->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
+            client->set_syn_options(syn_options);
             [[maybe_unused]] auto rc2 = client->send_tcp_packet(TCPFlags::SYN | TCPFlags::ACK);
             client->set_state(TCPSocket::State::SynReceived);
-            if (send_window_scale.has_value())
-                client->set_send_window_scale(*send_window_scale);
             return;
         }
         default:
@@ -490,23 +515,21 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
         switch (tcp_packet.flags()) {
         case TCPFlags::SYN:
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
+            socket->set_syn_options(syn_options);
             (void)socket->send_tcp_packet(TCPFlags::SYN | TCPFlags::ACK);
             socket->set_state(TCPSocket::State::SynReceived);
-            if (send_window_scale.has_value())
-                socket->set_send_window_scale(*send_window_scale);
             return;
         case TCPFlags::ACK | TCPFlags::SYN:
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
+            socket->set_syn_options(syn_options);
             (void)socket->send_ack(true);
             socket->set_state(TCPSocket::State::Established);
             socket->set_setup_state(Socket::SetupState::Completed);
             socket->set_connected(true);
-            if (send_window_scale.has_value())
-                socket->set_send_window_scale(*send_window_scale);
             return;
         case TCPFlags::ACK | TCPFlags::FIN:
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
-            send_delayed_tcp_ack(*socket);
+            send_delayed_tcp_ack(worker, *socket);
             socket->set_state(TCPSocket::State::Closed);
             socket->set_error(TCPSocket::Error::FINDuringConnect);
             socket->set_setup_state(Socket::SetupState::Completed);
@@ -620,11 +643,11 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
             return;
         case TCPFlags::ACK:
             if (payload_size) {
-                if (socket->did_receive(ipv4_packet.source(), tcp_packet.source_port(), { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, packet_timestamp)) {
+                if (socket->did_receive(ipv4_packet.source(), tcp_packet.source_port(), received_packet, { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() })) {
                     socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
                     dbgln_if(TCP_DEBUG, "Got packet with ack_no={}, seq_no={}, payload_size={}, acking it with new ack_no={}, seq_no={}",
                         tcp_packet.ack_number(), tcp_packet.sequence_number(), payload_size, socket->ack_number(), socket->sequence_number());
-                    send_delayed_tcp_ack(*socket);
+                    send_delayed_tcp_ack(worker, *socket);
                 }
             }
             return;
@@ -654,8 +677,11 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
         }
 
         if (tcp_packet.sequence_number() != socket->ack_number()) {
-            dbgln_if(TCP_DEBUG, "Discarding out of order packet: seq {} vs. ack {}", tcp_packet.sequence_number(), socket->ack_number());
-            if (socket->duplicate_acks() < TCPSocket::maximum_duplicate_acks) {
+            dbgln_if(TCP_DEBUG, "Queueing out of order packet: seq {} vs. ack {}", tcp_packet.sequence_number(), socket->ack_number());
+            if (!tcp_packet.has_fin())
+                socket->queue_out_of_order_packet(received_packet, ipv4_packet, tcp_packet, payload_size);
+            // With SACK, every duplicate ACK tells the peer a bit more about what we have received.
+            if (socket->sack_permitted() || socket->duplicate_acks() < TCPSocket::maximum_duplicate_acks) {
                 dbgln_if(TCP_DEBUG, "Sending ACK with same ack number to trigger fast retransmission");
                 socket->set_duplicate_acks(socket->duplicate_acks() + 1);
                 [[maybe_unused]] auto result = socket->send_ack(true);
@@ -667,21 +693,25 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
 
         if (tcp_packet.has_fin()) {
             if (payload_size != 0)
-                socket->did_receive(ipv4_packet.source(), tcp_packet.source_port(), { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, packet_timestamp);
+                socket->did_receive(ipv4_packet.source(), tcp_packet.source_port(), received_packet, { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() });
 
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
-            send_delayed_tcp_ack(*socket);
+            send_delayed_tcp_ack(worker, *socket);
             socket->set_state(TCPSocket::State::CloseWait);
             socket->set_connected(false);
             return;
         }
 
         if (payload_size) {
-            if (socket->did_receive(ipv4_packet.source(), tcp_packet.source_port(), { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, packet_timestamp)) {
+            if (socket->did_receive(ipv4_packet.source(), tcp_packet.source_port(), received_packet, { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() })) {
                 socket->set_ack_number(tcp_packet.sequence_number() + payload_size);
                 dbgln_if(TCP_DEBUG, "Got packet with ack_no={}, seq_no={}, payload_size={}, acking it with new ack_no={}, seq_no={}",
                     tcp_packet.ack_number(), tcp_packet.sequence_number(), payload_size, socket->ack_number(), socket->sequence_number());
-                send_delayed_tcp_ack(*socket);
+                // RFC 5681: "A TCP receiver SHOULD send an immediate ACK when the incoming segment fills in all or part of a gap in the sequence space."
+                if (socket->receive_queued_out_of_order_packets())
+                    (void)socket->send_ack(true);
+                else
+                    send_delayed_tcp_ack(worker, *socket);
             }
         }
     }
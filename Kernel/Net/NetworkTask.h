@@ -10,6 +10,7 @@ namespace Kernel {
 class NetworkTask {
 public:
     static void spawn();
+    // Whether the current thread is one of the threads processing received packets.
     static bool is_current();
 };
 }
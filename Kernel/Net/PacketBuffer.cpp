@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Singleton.h>
+#include <AK/Vector.h>
+#include <Kernel/Heap/kmalloc.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+#include <Kernel/Net/PacketBuffer.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+KMALLOC_DEFINE_SLAB_CACHE(PacketBuffer);
+
+// Every size of buffer has a pool of its own. The pools are bounded, buffers that don't fit into them anymore are freed.
+template<size_t Capacity, size_t MaximumFreeBuffers>
+struct PacketBufferPool {
+    static constexpr size_t capacity = Capacity;
+
+    Vector<NonnullOwnPtr<KBuffer>, MaximumFreeBuffers> free_buffers;
+    size_t allocated { 0 };
+    u64 reused { 0 };
+    u64 allocation_failures { 0 };
+
+    PacketBuffer::PoolStatistics statistics() const
+    {
+        return { capacity, allocated, free_buffers.size(), reused, allocation_failures };
+    }
+};
+
+struct PacketBufferPools {
+    PacketBufferPool<PacketBuffer::small_buffer_capacity, 1024> small;
+    PacketBufferPool<PacketBuffer::large_buffer_capacity, 32> large;
+    // Packets larger than a large buffer don't come from a pool, but we still want to know when they can't be allocated.
+    u64 unpooled_allocation_failures { 0 };
+};
+
+static Singleton<SpinlockProtected<PacketBufferPools, LockRank::None>> s_pools;
+
+template<typename Callback>
+static auto with_pool_for(PacketBufferPools& pools, size_t capacity, Callback callback)
+{
+    if (capacity <= PacketBuffer::small_buffer_capacity)
+        return callback(pools.small);
+    return callback(pools.large);
+}
+
+static ErrorOr<NonnullOwnPtr<KBuffer>> take_storage(size_t size)
+{
+    if (size > PacketBuffer::large_buffer_capacity)
+        return KBuffer::try_create_with_size("PacketBuffer"sv, size, Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow);
+
+    auto storage = s_pools->with([&](auto& pools) -> OwnPtr<KBuffer> {
+        return with_pool_for(pools, size, [](auto& pool) -> OwnPtr<KBuffer> {
+            if (pool.free_buffers.is_empty())
+                return nullptr;
+            ++pool.reused;
+            return pool.free_buffers.take_last();
+        });
+    });
+    if (storage)
+        return storage.release_nonnull();
+
+    size_t capacity = size <= PacketBuffer::small_buffer_capacity ? PacketBuffer::small_buffer_capacity : PacketBuffer::large_buffer_capacity;
+    auto storage_or_error = KBuffer::try_create_with_size("PacketBuffer"sv, capacity, Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow);
+    s_pools->with([&](auto& pools) {
+        with_pool_for(pools, capacity, [&](auto& pool) {
+            if (storage_or_error.is_error())
+                ++pool.allocation_failures;
+            else
+                ++pool.allocated;
+        });
+    });
+    return storage_or_error;
+}
+
+static void recycle_storage(NonnullOwnPtr<KBuffer> storage)
+{
+    auto capacity = storage->capacity();
+    if (capacity != PacketBuffer::small_buffer_capacity && capacity != PacketBuffer::large_buffer_capacity)
+        return;
+    s_pools->with([&](auto& pools) {
+        with_pool_for(pools, capacity, [&](auto& pool) {
+            if (pool.free_buffers.size() < pool.free_buffers.capacity()) {
+                pool.free_buffers.unchecked_append(move(storage));
+                return;
+            }
+            --pool.allocated;
+        });
+    });
+}
+
+RefPtr<PacketBuffer> PacketBuffer::try_create(size_t size)
+{
+    auto storage_or_error = take_storage(size);
+    if (storage_or_error.is_error()) {
+        if (size > large_buffer_capacity)
+            s_pools->with([](auto& pools) { ++pools.unpooled_allocation_failures; });
+        return nullptr;
+    }
+    auto storage = storage_or_error.release_value();
+    storage->set_size(size);
+    auto* packet = new (nothrow) PacketBuffer(move(storage), kgettimeofday());
+    if (!packet) {
+        recycle_storage(move(storage));
+        return nullptr;
+    }
+    return adopt_ref(*packet);
+}
+
+PacketBuffer::PacketBuffer(NonnullOwnPtr<KBuffer>&& storage, UnixDateTime timestamp)
+    : buffer(move(storage))
+    , timestamp(timestamp)
+{
+}
+
+PacketBuffer::~PacketBuffer()
+{
+    recycle_storage(move(buffer));
+}
+
+PacketBuffer::PoolStatistics PacketBuffer::pool_statistics(size_t capacity)
+{
+    return s_pools->with([&](auto& pools) {
+        if (capacity <= small_buffer_capacity)
+            return pools.small.statistics();
+        if (capacity <= large_buffer_capacity)
+            return pools.large.statistics();
+        return PoolStatistics { .allocation_failures = pools.unpooled_allocation_failures };
+    });
+}
+
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/AtomicRefCounted.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Time.h>
+#include <Kernel/Library/KBuffer.h>
+
+namespace Kernel {
+
+// A single packet, either on its way out or on its way from the adapter that received it to the sockets that
+// it is meant for (which may keep hold of it until it is read). All of them share one pointer to the packet,
+// instead of copying it around. Once the last reference is gone, the memory of the packet goes back into
+// a pool, so that it can be reused for the next one without having to allocate a new region.
+class PacketBuffer final : public AtomicRefCounted<PacketBuffer> {
+    AK_MAKE_NONCOPYABLE(PacketBuffer);
+    AK_MAKE_NONMOVABLE(PacketBuffer);
+
+public:
+    // Ordinary Ethernet frames fit into the small buffers, the large ones are for packets of up to 64 KiB
+    // that are segmented by the adapter, or coalesced from several received segments.
+    static constexpr size_t small_buffer_capacity = PAGE_SIZE;
+    static constexpr size_t large_buffer_capacity = 64 * KiB + PAGE_SIZE;
+
+    static RefPtr<PacketBuffer> try_create(size_t size);
+
+    ~PacketBuffer();
+
+    ReadonlyBytes bytes() { return buffer->bytes(); }
+
+    NonnullOwnPtr<KBuffer> buffer;
+    UnixDateTime timestamp;
+    IntrusiveListNode<PacketBuffer, RefPtr<PacketBuffer>> packet_node;
+
+    struct PoolStatistics {
+        size_t capacity { 0 };
+        // Buffers that are currently allocated, in use or waiting in the pool.
+        size_t allocated { 0 };
+        size_t free { 0 };
+        u64 reused { 0 };
+        u64 allocation_failures { 0 };
+    };
+    static PoolStatistics pool_statistics(size_t capacity);
+
+    MAKE_SLAB_CACHE_ALLOCATED(PacketBuffer);
+
+private:
+    PacketBuffer(NonnullOwnPtr<KBuffer>&&, UnixDateTime);
+};
+
+}
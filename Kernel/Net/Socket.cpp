@@ -74,7 +74,7 @@ ErrorOr<void> Socket::queue_connection_from(NonnullRefPtr<Socket> peer)
     return {};
 }
 
-ErrorOr<void> Socket::setsockopt(int level, int option, Userspace<void const*> user_value, socklen_t user_value_size)
+ErrorOr<void> Socket::setsockopt(OpenFileDescription&, int level, int option, Userspace<void const*> user_value, socklen_t user_value_size)
 {
     MutexLocker locker(mutex());
 
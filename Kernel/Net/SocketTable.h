@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Error.h>
+#include <AK/HashFunctions.h>
+#include <AK/HashMap.h>
+#include <AK/Traits.h>
+#include <Kernel/Locking/MutexProtected.h>
+
+namespace Kernel {
+
+// The sockets of a protocol, by the key that incoming packets are matched with. The table is split into shards
+// that each have a lock of their own, so looking up the socket for a packet only contends with whatever happens
+// on the same shard. Lookups are by far the most common operation, they only take the lock for reading.
+// Which shard a key is on is determined by ShardTraits, keys that have to be looked up together can be kept on
+// the same shard that way.
+template<typename Key, typename Socket, typename ShardTraits = Traits<Key>, size_t ShardCount = 64>
+class SocketTable {
+public:
+    using Shard = MutexProtected<HashMap<Key, Socket*>>;
+
+    template<typename Callback>
+    decltype(auto) with_shared(Key const& key, Callback callback) const
+    {
+        return m_shards[shard_index(key)].with_shared(move(callback));
+    }
+
+    template<typename Callback>
+    decltype(auto) with_exclusive(Key const& key, Callback callback)
+    {
+        return m_shards[shard_index(key)].with_exclusive(move(callback));
+    }
+
+    template<typename Callback>
+    void for_each_shared(Callback callback) const
+    {
+        for (auto const& shard : m_shards)
+            shard.for_each_shared(callback);
+    }
+
+    template<typename Callback>
+    ErrorOr<void> try_for_each_shared(Callback callback) const
+    {
+        for (auto const& shard : m_shards) {
+            TRY(shard.with_shared([&](auto const& table) -> ErrorOr<void> {
+                for (auto const& it : table)
+                    TRY(callback(it));
+                return {};
+            }));
+        }
+        return {};
+    }
+
+private:
+    // The hash is mixed once more, as the hash tables within the shards use the same one to pick their buckets.
+    static size_t shard_index(Key const& key) { return int_hash(ShardTraits::hash(key)) % ShardCount; }
+
+    Array<Shard, ShardCount> m_shards;
+};
+
+}
@@ -74,13 +74,50 @@ private:
     NetworkOrdered<u8> m_value;
 };
 
+class [[gnu::packed]] TCPOptionSACKPermitted : public TCPOption {
+public:
+    TCPOptionSACKPermitted()
+        : TCPOption(TCPOptionKind::SACKPermitted, sizeof(TCPOptionSACKPermitted))
+    {
+    }
+};
+
+// RFC 2018: A block of data that was received after a gap, the right edge is the sequence number right after it.
+struct [[gnu::packed]] TCPSACKBlock {
+    NetworkOrdered<u32> left_edge;
+    NetworkOrdered<u32> right_edge;
+};
+
+class [[gnu::packed]] TCPOptionSACK : public TCPOption {
+public:
+    // Without the timestamp option, there is room for four blocks in the 40 bytes of options.
+    static constexpr size_t maximum_block_count = 4;
+
+    explicit TCPOptionSACK(size_t block_count)
+        : TCPOption(TCPOptionKind::SACK, sizeof(TCPOptionSACK) + block_count * sizeof(TCPSACKBlock))
+    {
+    }
+
+    size_t block_count() const { return (length() - sizeof(TCPOptionSACK)) / sizeof(TCPSACKBlock); }
+    TCPSACKBlock const* blocks() const { return reinterpret_cast<TCPSACKBlock const*>(this + 1); }
+};
+
 static_assert(AssertSize<TCPOptionMSS, 4>());
+static_assert(AssertSize<TCPOptionSACKPermitted, 2>());
+static_assert(AssertSize<TCPSACKBlock, 8>());
+
+// Comparisons of sequence numbers have to take wrapping around into account.
+constexpr bool tcp_sequence_number_before(u32 a, u32 b) { return static_cast<i32>(a - b) < 0; }
+constexpr bool tcp_sequence_number_before_or_equal(u32 a, u32 b) { return static_cast<i32>(a - b) <= 0; }
 
 class [[gnu::packed]] TCPPacket {
 public:
     TCPPacket() = default;
     ~TCPPacket() = default;
 
+    // Where the checksum is in the header, for adapters that fill it in.
+    static constexpr size_t checksum_offset = 16;
+
     size_t header_size() const { return data_offset() * sizeof(u32); }
 
     u16 source_port() const { return m_source_port; }
@@ -135,6 +172,8 @@ public:
             }
             if (option->length() < sizeof(TCPOption))
                 return; // minimal option length
+            if (option->length() > (size_t)options_end - (size_t)next_option)
+                return; // option doesn't fit into the header
             callback(*option);
             next_option += option->length();
         }
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Net/TCPCongestionControl.h>
+
+namespace Kernel {
+
+// RFC 6928: "The upper bound for the initial window will be min (10*MSS, max (2*MSS, 14600))".
+static u32 initial_window_for(u32 maximum_segment_size)
+{
+    return min(10 * maximum_segment_size, max(2 * maximum_segment_size, 14600u));
+}
+
+TCPCongestionControl::TCPCongestionControl(u32 maximum_segment_size)
+    : m_maximum_segment_size(maximum_segment_size)
+    , m_congestion_window(initial_window_for(maximum_segment_size))
+{
+}
+
+void TCPCongestionControl::set_maximum_segment_size(u32 maximum_segment_size)
+{
+    m_maximum_segment_size = maximum_segment_size;
+    if (!m_has_seen_ack)
+        m_congestion_window = initial_window_for(maximum_segment_size);
+}
+
+void TCPCongestionControl::on_ack(u32 bytes_acked, MonotonicTime now, Duration smoothed_rtt)
+{
+    m_has_seen_ack = true;
+    if (m_congestion_window < m_slow_start_threshold) {
+        // RFC 5681: "During slow start, a TCP increments cwnd by at most SMSS bytes for each ACK received
+        //  that cumulatively acknowledges new data."
+        m_congestion_window += min(bytes_acked, m_maximum_segment_size);
+        return;
+    }
+    grow_in_congestion_avoidance(bytes_acked, now, smoothed_rtt);
+}
+
+void TCPCongestionControl::on_enter_fast_recovery(u32 bytes_in_flight, MonotonicTime now)
+{
+    m_has_seen_ack = true;
+    m_slow_start_threshold = slow_start_threshold_after_loss(bytes_in_flight, now);
+    // RFC 5681: "set cwnd to ssthresh plus 3*SMSS. This artificially "inflates" the congestion window by the number
+    //  of segments (three) that have left the network and which the receiver has buffered."
+    m_congestion_window = m_slow_start_threshold + 3 * m_maximum_segment_size;
+}
+
+void TCPCongestionControl::on_duplicate_ack_in_fast_recovery()
+{
+    m_congestion_window += m_maximum_segment_size;
+}
+
+void TCPCongestionControl::on_partial_ack_in_fast_recovery(u32 bytes_acked)
+{
+    // RFC 6582: "deflate the congestion window by the amount of new data acknowledged by the cumulative acknowledgment
+    //  field. If the partial ACK acknowledges at least one SMSS of new data, then add back SMSS bytes to the congestion window."
+    m_congestion_window -= min(bytes_acked, m_congestion_window);
+    if (bytes_acked >= m_maximum_segment_size)
+        m_congestion_window += m_maximum_segment_size;
+    m_congestion_window = max(m_congestion_window, m_maximum_segment_size);
+}
+
+void TCPCongestionControl::on_exit_fast_recovery(u32 bytes_in_flight)
+{
+    // RFC 6582: "Set cwnd to either (1) min (ssthresh, max(FlightSize, SMSS) + SMSS) or (2) ssthresh".
+    m_congestion_window = min(m_slow_start_threshold, max(bytes_in_flight, m_maximum_segment_size) + m_maximum_segment_size);
+}
+
+void TCPCongestionControl::on_retransmit_timeout(u32 bytes_in_flight, MonotonicTime now)
+{
+    m_has_seen_ack = true;
+    m_slow_start_threshold = slow_start_threshold_after_loss(bytes_in_flight, now);
+    // RFC 5681: "Furthermore, upon a timeout (as specified in [RFC2988]) cwnd MUST be set to no more than
+    //  the loss window, LW, which equals 1 full-sized segment"
+    m_congestion_window = m_maximum_segment_size;
+}
+
+class TCPNewReno final : public TCPCongestionControl {
+public:
+    explicit TCPNewReno(u32 maximum_segment_size)
+        : TCPCongestionControl(maximum_segment_size)
+    {
+    }
+
+    virtual Algorithm algorithm() const override { return Algorithm::NewReno; }
+
+private:
+    virtual u32 slow_start_threshold_after_loss(u32 bytes_in_flight, MonotonicTime) override
+    {
+        // RFC 5681: "ssthresh = max (FlightSize / 2, 2*SMSS)"
+        m_bytes_acked_in_congestion_avoidance = 0;
+        return max(bytes_in_flight / 2, 2 * m_maximum_segment_size);
+    }
+
+    virtual void grow_in_congestion_avoidance(u32 bytes_acked, MonotonicTime, Duration) override
+    {
+        // Appropriate byte counting (RFC 3465), the window grows by one segment per window of acknowledged data.
+        m_bytes_acked_in_congestion_avoidance += bytes_acked;
+        if (m_bytes_acked_in_congestion_avoidance >= m_congestion_window) {
+            m_bytes_acked_in_congestion_avoidance -= m_congestion_window;
+            m_congestion_window += m_maximum_segment_size;
+        }
+    }
+
+    u32 m_bytes_acked_in_congestion_avoidance { 0 };
+};
+
+// Integer cube root, from Hacker's Delight.
+static u64 cube_root(u64 value)
+{
+    u64 root = 0;
+    for (int shift = 63; shift >= 0; shift -= 3) {
+        root *= 2;
+        u64 bit = 3 * root * (root + 1) + 1;
+        if ((value >> shift) >= bit) {
+            value -= bit << shift;
+            ++root;
+        }
+    }
+    return root;
+}
+
+// CUBIC, as described in RFC 9438. The window grows along a cubic function of the time since the last loss,
+// which makes it flatten out around the window size at which that loss happened and probe beyond it quickly
+// afterwards, independently of the round-trip time. We don't have floating point in the kernel, so everything
+// is computed in bytes and milliseconds, with C = 0.4 and beta = 0.7.
+class TCPCubic final : public TCPCongestionControl {
+public:
+    explicit TCPCubic(u32 maximum_segment_size)
+        : TCPCongestionControl(maximum_segment_size)
+    {
+    }
+
+    virtual Algorithm algorithm() const override { return Algorithm::Cubic; }
+
+private:
+    static constexpr u64 beta_numerator = 7;
+    static constexpr u64 beta_denominator = 10;
+    // The cubic function is only evaluated this far away from its inflection point, which keeps it from overflowing.
+    static constexpr i64 maximum_time_from_inflection_point_ms = 60'000;
+
+    virtual u32 slow_start_threshold_after_loss(u32, MonotonicTime) override
+    {
+        // RFC 9438, 4.7: With fast convergence, a flow that lost before reaching the previous maximum releases some bandwidth.
+        if (m_congestion_window < m_window_max)
+            m_window_max = static_cast<u32>(static_cast<u64>(m_congestion_window) * (beta_denominator + beta_numerator) / (2 * beta_denominator));
+        else
+            m_window_max = m_congestion_window;
+        m_epoch_start.clear();
+        return max(static_cast<u32>(static_cast<u64>(m_congestion_window) * beta_numerator / beta_denominator), 2 * m_maximum_segment_size);
+    }
+
+    virtual void grow_in_congestion_avoidance(u32 bytes_acked, MonotonicTime now, Duration smoothed_rtt) override
+    {
+        if (!m_epoch_start.has_value()) {
+            m_epoch_start = now;
+            m_window_estimate = m_congestion_window;
+            if (m_congestion_window < m_window_max) {
+                // K = cubic_root((W_max - cwnd_epoch) / C), converted from segments and seconds to bytes and milliseconds.
+                u64 distance = m_window_max - m_congestion_window;
+                m_time_to_window_max_ms = cube_root(distance * 2'500'000'000 / m_maximum_segment_size);
+            } else {
+                m_window_max = m_congestion_window;
+                m_time_to_window_max_ms = 0;
+            }
+        }
+
+        // W_cubic(t) = C * (t - K)^3 + W_max, looking one round-trip ahead.
+        auto t = (now - *m_epoch_start + smoothed_rtt).to_milliseconds();
+        auto offset = clamp(t - static_cast<i64>(m_time_to_window_max_ms), -maximum_time_from_inflection_point_ms, maximum_time_from_inflection_point_ms);
+        i64 cubic_growth = offset * offset * offset / 1000 * 4 * m_maximum_segment_size / 10'000'000;
+        i64 target = clamp(static_cast<i64>(m_window_max) + cubic_growth, static_cast<i64>(m_congestion_window), static_cast<i64>(m_congestion_window) * 3 / 2);
+
+        // RFC 9438, 4.3: The Reno-friendly region, an estimate of what NewReno would have achieved, using alpha = 3 * (1 - beta) / (1 + beta).
+        m_window_estimate += static_cast<u32>(static_cast<u64>(bytes_acked) * m_maximum_segment_size * 9 / 17 / m_congestion_window);
+        if (target < m_window_estimate) {
+            m_congestion_window = max(m_congestion_window, m_window_estimate);
+            return;
+        }
+
+        // "cwnd MUST be incremented by (target - cwnd)/cwnd for each received new ACK"
+        m_congestion_window += static_cast<u32>((target - m_congestion_window) * bytes_acked / m_congestion_window);
+    }
+
+    u32 m_window_max { 0 };
+    u32 m_window_estimate { 0 };
+    u64 m_time_to_window_max_ms { 0 };
+    Optional<MonotonicTime> m_epoch_start;
+};
+
+ErrorOr<NonnullOwnPtr<TCPCongestionControl>> TCPCongestionControl::try_create(Algorithm algorithm, u32 maximum_segment_size)
+{
+    switch (algorithm) {
+    case Algorithm::NewReno:
+        return adopt_nonnull_own_or_enomem(new (nothrow) TCPNewReno(maximum_segment_size));
+    case Algorithm::Cubic:
+        return adopt_nonnull_own_or_enomem(new (nothrow) TCPCubic(maximum_segment_size));
+    }
+    VERIFY_NOT_REACHED();
+}
+
+Optional<TCPCongestionControl::Algorithm> TCPCongestionControl::algorithm_from_name(StringView name)
+{
+    if (name == "newreno"sv || name == "reno"sv)
+        return Algorithm::NewReno;
+    if (name == "cubic"sv)
+        return Algorithm::Cubic;
+    return {};
+}
+
+StringView TCPCongestionControl::name_of(Algorithm algorithm)
+{
+    switch (algorithm) {
+    case Algorithm::NewReno:
+        return "newreno"sv;
+    case Algorithm::Cubic:
+        return "cubic"sv;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+}
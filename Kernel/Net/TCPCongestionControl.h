@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <AK/Time.h>
+
+namespace Kernel {
+
+enum class TCPCongestionControlAlgorithm {
+    NewReno,
+    Cubic,
+};
+
+// Decides how many bytes a TCP connection may have in flight, see RFC 5681. All algorithms share slow start
+// and fast recovery (RFC 6582), they differ in how the window grows once it has reached the slow start threshold
+// and in how far it is cut back after a loss.
+class TCPCongestionControl {
+    AK_MAKE_NONCOPYABLE(TCPCongestionControl);
+    AK_MAKE_NONMOVABLE(TCPCongestionControl);
+
+public:
+    using Algorithm = TCPCongestionControlAlgorithm;
+    static constexpr Algorithm default_algorithm = Algorithm::Cubic;
+
+    static ErrorOr<NonnullOwnPtr<TCPCongestionControl>> try_create(Algorithm, u32 maximum_segment_size);
+
+    static Optional<Algorithm> algorithm_from_name(StringView);
+    static StringView name_of(Algorithm);
+
+    virtual ~TCPCongestionControl() = default;
+
+    virtual Algorithm algorithm() const = 0;
+    StringView name() const { return name_of(algorithm()); }
+
+    u32 congestion_window() const { return m_congestion_window; }
+    u32 slow_start_threshold() const { return m_slow_start_threshold; }
+    u32 maximum_segment_size() const { return m_maximum_segment_size; }
+    void set_maximum_segment_size(u32);
+
+    // New data was acknowledged while not recovering from a loss.
+    void on_ack(u32 bytes_acked, MonotonicTime now, Duration smoothed_rtt);
+
+    // The third duplicate ACK in a row arrived, the first unacknowledged segment is about to be retransmitted.
+    void on_enter_fast_recovery(u32 bytes_in_flight, MonotonicTime now);
+    void on_duplicate_ack_in_fast_recovery();
+    // Only some of the data that was in flight when fast recovery started has been acknowledged.
+    void on_partial_ack_in_fast_recovery(u32 bytes_acked);
+    void on_exit_fast_recovery(u32 bytes_in_flight);
+
+    void on_retransmit_timeout(u32 bytes_in_flight, MonotonicTime now);
+
+protected:
+    explicit TCPCongestionControl(u32 maximum_segment_size);
+
+    // Called on every loss, before the congestion window is reduced.
+    virtual u32 slow_start_threshold_after_loss(u32 bytes_in_flight, MonotonicTime now) = 0;
+    virtual void grow_in_congestion_avoidance(u32 bytes_acked, MonotonicTime now, Duration smoothed_rtt) = 0;
+
+    u32 m_maximum_segment_size { 0 };
+    u32 m_congestion_window { 0 };
+    u32 m_slow_start_threshold { NumericLimits<u32>::max() };
+
+private:
+    bool m_has_seen_ack { false };
+};
+
+}
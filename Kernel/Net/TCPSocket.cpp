@@ -15,6 +15,7 @@
 #include <Kernel/Net/NetworkAdapter.h>
 #include <Kernel/Net/NetworkingManagement.h>
 #include <Kernel/Net/Routing.h>
+#include <Kernel/Net/SocketTable.h>
 #include <Kernel/Net/TCP.h>
 #include <Kernel/Net/TCPSocket.h>
 #include <Kernel/Security/Random.h>
@@ -23,28 +24,59 @@
 
 namespace Kernel {
 
+// Sockets that are bound, but not connected to a peer, which includes the listening ones. Their shards are picked
+// by local port alone, so that a packet can be matched with a socket that is bound to its destination address and
+// with one that is bound to any address in a single lookup.
+struct TCPListeningSocketShardTraits {
+    static unsigned hash(IPv4SocketTuple const& tuple) { return tuple.local_port(); }
+};
+
+using TCPConnectedSocketTable = SocketTable<IPv4SocketTuple, TCPSocket>;
+using TCPListeningSocketTable = SocketTable<IPv4SocketTuple, TCPSocket, TCPListeningSocketShardTraits>;
+
+static Singleton<TCPConnectedSocketTable> s_connected_sockets;
+static Singleton<TCPListeningSocketTable> s_listening_sockets;
+
+static bool is_listening_tuple(IPv4SocketTuple const& tuple)
+{
+    return tuple.peer_address().is_zero() && tuple.peer_port() == 0;
+}
+
+template<typename Callback>
+static decltype(auto) with_sockets_exclusive(IPv4SocketTuple const& tuple, Callback callback)
+{
+    if (is_listening_tuple(tuple))
+        return s_listening_sockets->with_exclusive(tuple, move(callback));
+    return s_connected_sockets->with_exclusive(tuple, move(callback));
+}
+
 void TCPSocket::for_each(Function<void(TCPSocket const&)> callback)
 {
-    sockets_by_tuple().for_each_shared([&](auto const& it) {
+    auto for_each_socket = [&](auto const& it) {
         callback(*it.value);
-    });
+    };
+    s_connected_sockets->for_each_shared(for_each_socket);
+    s_listening_sockets->for_each_shared(for_each_socket);
 }
 
 ErrorOr<void> TCPSocket::try_for_each(Function<ErrorOr<void>(TCPSocket const&)> callback)
 {
-    return sockets_by_tuple().with_shared([&](auto const& sockets) -> ErrorOr<void> {
-        for (auto& it : sockets)
-            TRY(callback(*it.value));
-        return {};
-    });
+    auto for_each_socket = [&](auto const& it) -> ErrorOr<void> {
+        return callback(*it.value);
+    };
+    TRY(s_connected_sockets->try_for_each_shared(for_each_socket));
+    return s_listening_sockets->try_for_each_shared(for_each_socket);
 }
 
 bool TCPSocket::unref() const
 {
-    bool did_hit_zero = sockets_by_tuple().with_exclusive([&](auto& table) {
+    // The lookups take a reference while holding the lock of the shard that the socket is registered on,
+    // so that is the lock which has to be held while dropping the last one.
+    auto registered_tuple = m_registered_socket_tuple.value_or(tuple());
+    bool did_hit_zero = with_sockets_exclusive(registered_tuple, [&](auto& table) {
         if (deref_base())
             return false;
-        table.remove(tuple());
+        table.remove(registered_tuple);
         const_cast<TCPSocket&>(*this).revoke_weak_ptrs();
         return true;
     });
@@ -115,20 +147,18 @@ MutexProtected<HashMap<IPv4SocketTuple, RefPtr<TCPSocket>>>& TCPSocket::closing_
     return *s_socket_closing;
 }
 
-static Singleton<MutexProtected<HashMap<IPv4SocketTuple, TCPSocket*>>> s_socket_tuples;
-
-MutexProtected<HashMap<IPv4SocketTuple, TCPSocket*>>& TCPSocket::sockets_by_tuple()
-{
-    return *s_socket_tuples;
-}
-
 RefPtr<TCPSocket> TCPSocket::from_tuple(IPv4SocketTuple const& tuple)
 {
-    return sockets_by_tuple().with_shared([&](auto const& table) -> RefPtr<TCPSocket> {
-        auto exact_match = table.get(tuple);
-        if (exact_match.has_value())
-            return { *exact_match.value() };
+    auto exact_match = s_connected_sockets->with_shared(tuple, [&](auto const& table) -> RefPtr<TCPSocket> {
+        auto match = table.get(tuple);
+        if (match.has_value())
+            return { *match.value() };
+        return {};
+    });
+    if (exact_match)
+        return exact_match;
 
+    return s_listening_sockets->with_shared(tuple, [&](auto const& table) -> RefPtr<TCPSocket> {
         auto address_tuple = IPv4SocketTuple(tuple.local_address(), tuple.local_port(), IPv4Address(), 0);
         auto address_match = table.get(address_tuple);
         if (address_match.has_value())
@@ -145,12 +175,14 @@ RefPtr<TCPSocket> TCPSocket::from_tuple(IPv4SocketTuple const& tuple)
 ErrorOr<NonnullRefPtr<TCPSocket>> TCPSocket::try_create_client(IPv4Address const& new_local_address, u16 new_local_port, IPv4Address const& new_peer_address, u16 new_peer_port)
 {
     auto tuple = IPv4SocketTuple(new_local_address, new_local_port, new_peer_address, new_peer_port);
-    return sockets_by_tuple().with_exclusive([&](auto& table) -> ErrorOr<NonnullRefPtr<TCPSocket>> {
+    return with_sockets_exclusive(tuple, [&](auto& table) -> ErrorOr<NonnullRefPtr<TCPSocket>> {
         if (table.contains(tuple))
             return EEXIST;
 
         auto receive_buffer = TRY(try_create_receive_buffer());
         auto client = TRY(TCPSocket::try_create(protocol(), move(receive_buffer)));
+        if (client->congestion_control().algorithm() != congestion_control().algorithm())
+            TRY(client->set_congestion_control_algorithm(congestion_control().algorithm()));
 
         client->set_setup_state(SetupState::InProgress);
         client->set_local_address(new_local_address);
@@ -184,10 +216,11 @@ void TCPSocket::release_for_accept(NonnullRefPtr<TCPSocket> socket)
     [[maybe_unused]] auto rc = queue_connection_from(move(socket));
 }
 
-TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, NonnullRefPtr<Timer> timer)
-    : IPv4Socket(SOCK_STREAM, protocol, move(receive_buffer), move(scratch_buffer))
+TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullRefPtr<Timer> timer, NonnullOwnPtr<TCPCongestionControl> congestion_control)
+    : IPv4Socket(SOCK_STREAM, protocol, move(receive_buffer))
     , m_last_ack_sent_time(TimeManagement::the().monotonic_time())
     , m_last_retransmit_time(TimeManagement::the().monotonic_time())
+    , m_congestion_control(move(congestion_control))
     , m_timer(timer)
 {
 }
@@ -201,10 +234,9 @@ TCPSocket::~TCPSocket()
 
 ErrorOr<NonnullRefPtr<TCPSocket>> TCPSocket::try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer)
 {
-    // Note: Scratch buffer is only used for SOCK_STREAM sockets.
-    auto scratch_buffer = TRY(KBuffer::try_create_with_size("TCPSocket: Scratch buffer"sv, 65536));
     auto timer = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Timer));
-    return adopt_nonnull_ref_or_enomem(new (nothrow) TCPSocket(protocol, move(receive_buffer), move(scratch_buffer), timer));
+    auto congestion_control = TRY(TCPCongestionControl::try_create(TCPCongestionControl::default_algorithm, default_maximum_segment_size));
+    return adopt_nonnull_ref_or_enomem(new (nothrow) TCPSocket(protocol, move(receive_buffer), timer, move(congestion_control)));
 }
 
 ErrorOr<size_t> TCPSocket::protocol_size(ReadonlyBytes raw_ipv4_packet)
@@ -231,7 +263,9 @@ ErrorOr<size_t> TCPSocket::protocol_send(UserOrKernelBuffer const& data, size_t
     RoutingDecision routing_decision = route_to(peer_address(), local_address(), adapter);
     if (routing_decision.is_zero())
         return set_so_error(EHOSTUNREACH);
-    size_t mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
+    size_t mss = maximum_segment_size(*routing_decision.adapter);
+    if (m_congestion_control->maximum_segment_size() != mss)
+        m_congestion_control->set_maximum_segment_size(mss);
 
     if (!m_no_delay) {
         // RFC 896 (Nagle’s algorithm): https://www.ietf.org/rfc/rfc0896
@@ -245,11 +279,43 @@ ErrorOr<size_t> TCPSocket::protocol_send(UserOrKernelBuffer const& data, size_t
             return set_so_error(EAGAIN);
     }
 
-    data_length = min(data_length, mss);
+    // With segmentation offload, the adapter splits a larger segment into ones of MSS bytes on its own.
+    size_t segment_size = mss;
+    if (routing_decision.adapter->has_transmit_offload(NetworkAdapter::TransmitOffload::TCPSegmentation)) {
+        auto maximum_payload_size = routing_decision.adapter->maximum_segmentation_offload_size() - sizeof(IPv4Packet) - maximum_tcp_header_size;
+        segment_size = max(mss, maximum_payload_size / mss * mss);
+    }
+
+    data_length = min(data_length, segment_size);
+    auto bytes_in_flight = m_unacked_packets.with_shared([&](auto const& packets) { return packets.bytes_in_flight(); });
+    if (data_length > mss)
+        data_length = max(mss, min(data_length, send_window_space(bytes_in_flight) / mss * mss));
+    if (!can_send_segment(data_length, bytes_in_flight))
+        return set_so_error(EAGAIN);
+
     TRY(send_tcp_packet(TCPFlags::PSH | TCPFlags::ACK, &data, data_length, &routing_decision));
     return data_length;
 }
 
+size_t TCPSocket::maximum_segment_size(NetworkAdapter const& adapter) const
+{
+    return min<size_t>(adapter.mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket), m_peer_maximum_segment_size);
+}
+
+bool TCPSocket::can_send_segment(size_t size, size_t bytes_in_flight) const
+{
+    // There always has to be a way to make progress, a lone segment may be sent even if it doesn't fit into the windows.
+    if (bytes_in_flight == 0)
+        return true;
+    return size <= send_window_space(bytes_in_flight);
+}
+
+size_t TCPSocket::send_window_space(size_t bytes_in_flight) const
+{
+    auto window = min<size_t>(m_congestion_control->congestion_window(), m_send_window_size);
+    return window > bytes_in_flight ? window - bytes_in_flight : 0;
+}
+
 ErrorOr<void> TCPSocket::send_ack(bool allow_duplicate)
 {
     if (!allow_duplicate && m_last_ack_number_sent == m_ack_number)
@@ -266,18 +332,33 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
 
     auto ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
 
-    bool const has_mss_option = flags & TCPFlags::SYN;
-    bool const has_window_scale_option = flags & TCPFlags::SYN;
-    size_t const options_size = (has_mss_option ? sizeof(TCPOptionMSS) : 0) + (has_window_scale_option ? sizeof(TCPOptionWindowScale) : 0);
+    // A SYN|ACK may only carry the options the peer's SYN did (RFC 7323 and RFC 2018).
+    bool const is_syn = flags & TCPFlags::SYN;
+    bool const is_syn_ack = is_syn && (flags & TCPFlags::ACK);
+    bool const has_mss_option = is_syn;
+    bool const has_window_scale_option = is_syn && (!is_syn_ack || m_window_scaling_supported);
+    bool const has_sack_permitted_option = is_syn && (!is_syn_ack || m_sack_permitted);
+
+    Array<TCPSACKBlock, TCPOptionSACK::maximum_block_count> sack_blocks;
+    size_t sack_block_count = 0;
+    if (!is_syn && (flags & TCPFlags::ACK) && m_sack_permitted)
+        sack_block_count = build_sack_blocks(sack_blocks.span());
+    // The SACK option is preceded by two NOPs, to keep the blocks aligned.
+    size_t const sack_option_size = sack_block_count > 0 ? 2 + sizeof(TCPOptionSACK) + sack_block_count * sizeof(TCPSACKBlock) : 0;
+
+    size_t const options_size = (has_mss_option ? sizeof(TCPOptionMSS) : 0)
+        + (has_window_scale_option ? sizeof(TCPOptionWindowScale) : 0)
+        + (has_sack_permitted_option ? sizeof(TCPOptionSACKPermitted) : 0)
+        + sack_option_size;
     size_t const tcp_header_size = sizeof(TCPPacket) + align_up_to(options_size, 4);
     size_t const buffer_size = ipv4_payload_offset + tcp_header_size + payload_size;
-    auto packet = routing_decision.adapter->acquire_packet_buffer(buffer_size);
+    auto packet = PacketBuffer::try_create(buffer_size);
     if (!packet)
         return set_so_error(ENOMEM);
     routing_decision.adapter->fill_in_ipv4_header(*packet, local_address(),
         routing_decision.next_hop, peer_address(), IPv4Protocol::TCP,
         buffer_size - ipv4_payload_offset, type_of_service(), ttl());
-    memset(packet->buffer->data() + ipv4_payload_offset, 0, sizeof(TCPPacket));
+    memset(packet->buffer->data() + ipv4_payload_offset, 0, tcp_header_size);
     auto& tcp_packet = *(TCPPacket*)(packet->buffer->data() + ipv4_payload_offset);
     VERIFY(local_port());
     tcp_packet.set_source_port(local_port());
@@ -291,10 +372,8 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
     tcp_packet.set_flags(flags);
 
     if (payload) {
-        if (auto result = payload->read(tcp_packet.payload(), payload_size); result.is_error()) {
-            routing_decision.adapter->release_packet_buffer(*packet);
+        if (auto result = payload->read(tcp_packet.payload(), payload_size); result.is_error())
             return set_so_error(result.release_error());
-        }
     }
 
     if (flags & TCPFlags::ACK) {
@@ -303,6 +382,7 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
         tcp_packet.set_ack_number(m_ack_number);
     }
 
+    auto const sequence_number = m_sequence_number;
     if (flags & TCPFlags::SYN) {
         ++m_sequence_number;
     } else {
@@ -311,6 +391,7 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
 
     u8* next_option = packet->buffer->data() + ipv4_payload_offset + sizeof(TCPPacket);
     if (has_mss_option) {
+        // This is what we can receive, which doesn't depend on what the peer can.
         u16 mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
         TCPOptionMSS mss_option { mss };
         memcpy(next_option, &mss_option, sizeof(mss_option));
@@ -321,16 +402,46 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
         memcpy(next_option, &window_scale_option, sizeof(window_scale_option));
         next_option += sizeof(window_scale_option);
     }
+    if (has_sack_permitted_option) {
+        TCPOptionSACKPermitted sack_permitted_option;
+        memcpy(next_option, &sack_permitted_option, sizeof(sack_permitted_option));
+        next_option += sizeof(sack_permitted_option);
+    }
+    if (sack_block_count > 0) {
+        *next_option++ = to_underlying(TCPOptionKind::Nop);
+        *next_option++ = to_underlying(TCPOptionKind::Nop);
+        TCPOptionSACK sack_option { sack_block_count };
+        memcpy(next_option, &sack_option, sizeof(sack_option));
+        next_option += sizeof(sack_option);
+        memcpy(next_option, sack_blocks.data(), sack_block_count * sizeof(TCPSACKBlock));
+        next_option += sack_block_count * sizeof(TCPSACKBlock);
+    }
     if ((options_size % 4) != 0)
         *next_option = to_underlying(TCPOptionKind::End);
 
-    tcp_packet.set_checksum(compute_tcp_checksum(local_address(), peer_address(), tcp_packet, payload_size));
+    NetworkAdapter::TransmitOffloadRequest offload;
+    if (routing_decision.adapter->has_transmit_offload(NetworkAdapter::TransmitOffload::TCPChecksum)) {
+        tcp_packet.set_checksum(compute_tcp_pseudo_header_checksum(local_address(), peer_address(), tcp_header_size + payload_size));
+        offload.tcp_header_offset = ipv4_payload_offset;
+        offload.tcp_header_size = tcp_header_size;
+        if (payload_size > maximum_segment_size(*routing_decision.adapter)) {
+            VERIFY(routing_decision.adapter->has_transmit_offload(NetworkAdapter::TransmitOffload::TCPSegmentation));
+            offload.segment_size = maximum_segment_size(*routing_decision.adapter);
+        }
+    } else {
+        tcp_packet.set_checksum(compute_tcp_checksum(local_address(), peer_address(), tcp_packet, payload_size));
+    }
 
     bool expect_ack { tcp_packet.has_syn() || payload_size > 0 };
     if (expect_ack) {
         bool append_failed { false };
         m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
-            auto result = unacked_packets.packets.try_append({ m_sequence_number, packet, ipv4_payload_offset, *routing_decision.adapter });
+            auto now = TimeManagement::the().monotonic_time();
+            // RFC 6298: "Every time a packet containing data is sent (including a retransmission), if the timer
+            //  is not running, start it running so that it will expire after RTO seconds"
+            if (unacked_packets.packets.is_empty())
+                m_last_retransmit_time = now;
+            auto result = unacked_packets.packets.try_append({ sequence_number, m_sequence_number, packet, ipv4_payload_offset, 0, now, payload_size, false, offload });
             if (result.is_error()) {
                 dbgln("TCPSocket: Dropped outbound packet because try_append() failed");
                 append_failed = true;
@@ -345,9 +456,7 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
 
     m_packets_out++;
     m_bytes_out += buffer_size;
-    routing_decision.adapter->send_packet(packet->bytes());
-    if (!expect_ack)
-        routing_decision.adapter->release_packet_buffer(*packet);
+    routing_decision.adapter->send_packet(packet->bytes(), offload);
 
     return {};
 }
@@ -356,31 +465,106 @@ void TCPSocket::receive_tcp_packet(TCPPacket const& packet, u16 size)
 {
     if (packet.has_ack()) {
         u32 ack_number = packet.ack_number();
+        size_t payload_size = size - packet.header_size();
+        auto now = TimeManagement::the().monotonic_time();
 
         dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet: {}", ack_number);
 
+        // RFC 7323: "The window field in a segment where the SYN bit is set (i.e., a <SYN> or <SYN,ACK>) MUST NOT be scaled."
+        u32 send_window_size = packet.window_size();
+        if (!packet.has_syn())
+            send_window_size <<= m_send_window_scale;
+        bool const window_changed = send_window_size != m_send_window_size;
+        m_send_window_size = send_window_size;
+
+        bool should_retransmit = false;
         int removed = 0;
         m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+            if (m_sack_permitted) {
+                packet.for_each_option([&](auto const& option) {
+                    if (option.kind() != TCPOptionKind::SACK || (option.length() - sizeof(TCPOptionSACK)) % sizeof(TCPSACKBlock) != 0)
+                        return;
+                    auto const& sack_option = static_cast<TCPOptionSACK const&>(option);
+                    for (size_t i = 0; i < sack_option.block_count(); ++i) {
+                        u32 left_edge = sack_option.blocks()[i].left_edge;
+                        u32 right_edge = sack_option.blocks()[i].right_edge;
+                        for (auto& unacked_packet : unacked_packets.packets) {
+                            if (unacked_packet.sacked || unacked_packet.payload_size == 0)
+                                continue;
+                            if (tcp_sequence_number_before_or_equal(left_edge, unacked_packet.sequence_number) && tcp_sequence_number_before_or_equal(unacked_packet.ack_number, right_edge)) {
+                                unacked_packet.sacked = true;
+                                unacked_packets.sacked_size += unacked_packet.payload_size;
+                            }
+                        }
+                    }
+                });
+            }
+
+            bool const had_unacked_packets = !unacked_packets.packets.is_empty();
+            size_t bytes_acked = 0;
+            Optional<MonotonicTime> rtt_sample_sent_time;
             while (!unacked_packets.packets.is_empty()) {
                 auto& packet = unacked_packets.packets.first();
 
                 dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: iterate: {}", packet.ack_number);
 
-                if (packet.ack_number <= ack_number) {
-                    auto old_adapter = packet.adapter.strong_ref();
-                    if (old_adapter)
-                        old_adapter->release_packet_buffer(*packet.buffer);
-                    TCPPacket& tcp_packet = *(TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
-                    if (m_send_window_size != tcp_packet.window_size()) {
-                        m_send_window_size = tcp_packet.window_size() << m_send_window_scale;
+                if (!tcp_sequence_number_before_or_equal(packet.ack_number, ack_number))
+                    break;
+
+                unacked_packets.size -= packet.payload_size;
+                if (packet.sacked)
+                    unacked_packets.sacked_size -= packet.payload_size;
+                bytes_acked += packet.payload_size;
+                // Karn's algorithm: Retransmitted segments don't tell us anything about the round-trip time.
+                if (packet.tx_counter == 0)
+                    rtt_sample_sent_time = packet.sent_time;
+                unacked_packets.packets.take_first();
+                removed++;
+            }
+
+            if (removed > 0) {
+                evaluate_block_conditions();
+                if (rtt_sample_sent_time.has_value())
+                    update_rtt(now - *rtt_sample_sent_time);
+                m_duplicate_acks_received = 0;
+                m_last_retransmit_time = now;
+
+                auto bytes_in_flight = unacked_packets.bytes_in_flight();
+                bool const recovered = tcp_sequence_number_before_or_equal(m_recovery_point, ack_number);
+                switch (m_recovery_state) {
+                case RecoveryState::FastRecovery:
+                    if (recovered) {
+                        m_congestion_control->on_exit_fast_recovery(bytes_in_flight);
+                        m_recovery_state = RecoveryState::None;
+                    } else {
+                        m_congestion_control->on_partial_ack_in_fast_recovery(bytes_acked);
+                        should_retransmit = true;
                     }
-                    auto payload_size = packet.buffer->buffer->data() + packet.buffer->buffer->size() - (u8*)tcp_packet.payload();
-                    unacked_packets.size -= payload_size;
-                    evaluate_block_conditions();
-                    unacked_packets.packets.take_first();
-                    removed++;
-                } else {
                     break;
+                case RecoveryState::Loss:
+                    if (recovered)
+                        m_recovery_state = RecoveryState::None;
+                    else
+                        should_retransmit = true;
+                    m_congestion_control->on_ack(bytes_acked, now, m_smoothed_rtt);
+                    break;
+                case RecoveryState::None:
+                    m_congestion_control->on_ack(bytes_acked, now, m_smoothed_rtt);
+                    break;
+                }
+            } else if (had_unacked_packets && payload_size == 0 && !packet.has_syn() && !packet.has_fin() && !window_changed
+                && ack_number == unacked_packets.packets.first().sequence_number) {
+                // RFC 5681: "The fast retransmit algorithm uses the arrival of 3 duplicate ACKs [...] as an indication that a segment has been lost."
+                ++m_duplicate_acks_received;
+                if (m_recovery_state == RecoveryState::FastRecovery) {
+                    m_congestion_control->on_duplicate_ack_in_fast_recovery();
+                } else if (m_recovery_state == RecoveryState::None && m_duplicate_acks_received == 3) {
+                    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) entering fast recovery at {}", this, ack_number);
+                    m_congestion_control->on_enter_fast_recovery(unacked_packets.bytes_in_flight(), now);
+                    m_recovery_state = RecoveryState::FastRecovery;
+                    m_recovery_point = m_sequence_number;
+                    ++m_fast_retransmits;
+                    should_retransmit = true;
                 }
             }
 
@@ -391,12 +575,164 @@ void TCPSocket::receive_tcp_packet(TCPPacket const& packet, u16 size)
 
             dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet acknowledged {} packets", removed);
         });
+
+        if (should_retransmit)
+            retransmit_first_unacked_packet();
     }
 
     m_packets_in++;
     m_bytes_in += packet.header_size() + size;
 }
 
+void TCPSocket::update_rtt(Duration sample)
+{
+    // RFC 6298, 2.2 and 2.3.
+    if (!m_has_rtt_sample) {
+        m_smoothed_rtt = sample;
+        m_rtt_variance = Duration::from_microseconds(sample.to_microseconds() / 2);
+        m_has_rtt_sample = true;
+    } else {
+        auto deviation = m_smoothed_rtt.to_microseconds() - sample.to_microseconds();
+        if (deviation < 0)
+            deviation = -deviation;
+        m_rtt_variance = Duration::from_microseconds((3 * m_rtt_variance.to_microseconds() + deviation) / 4);
+        m_smoothed_rtt = Duration::from_microseconds((7 * m_smoothed_rtt.to_microseconds() + sample.to_microseconds()) / 8);
+    }
+    auto timeout = m_smoothed_rtt + Duration::from_microseconds(4 * m_rtt_variance.to_microseconds());
+    m_retransmit_timeout = clamp(timeout, minimum_retransmit_timeout, maximum_retransmit_timeout);
+}
+
+TCPSocket::SynOptions TCPSocket::parse_syn_options(TCPPacket const& packet)
+{
+    SynOptions options;
+    packet.for_each_option([&options](auto const& option) {
+        switch (option.kind()) {
+        case TCPOptionKind::WindowScale: {
+            if (option.length() != sizeof(TCPOptionWindowScale))
+                return;
+            auto scale = static_cast<TCPOptionWindowScale const&>(option).value();
+            if (scale > 14)
+                return; // Maximum allowed as per RFC7323
+            options.window_scale = scale;
+            return;
+        }
+        case TCPOptionKind::MSS:
+            if (option.length() != sizeof(TCPOptionMSS))
+                return;
+            options.maximum_segment_size = static_cast<TCPOptionMSS const&>(option).value();
+            return;
+        case TCPOptionKind::SACKPermitted:
+            if (option.length() != sizeof(TCPOptionSACKPermitted))
+                return;
+            options.sack_permitted = true;
+            return;
+        default:
+            return;
+        }
+    });
+    return options;
+}
+
+void TCPSocket::set_syn_options(SynOptions const& options)
+{
+    if (options.window_scale.has_value())
+        set_send_window_scale(*options.window_scale);
+    if (options.maximum_segment_size.has_value() && *options.maximum_segment_size > 0)
+        m_peer_maximum_segment_size = *options.maximum_segment_size;
+    m_sack_permitted = options.sack_permitted;
+}
+
+void TCPSocket::queue_out_of_order_packet(PacketBuffer& packet_buffer, IPv4Packet const& ipv4_packet, TCPPacket const& tcp_packet, size_t payload_size)
+{
+    u32 sequence_number = tcp_packet.sequence_number();
+    u32 end = sequence_number + payload_size;
+    // Only segments that fit into what we advertised as our receive window are worth keeping.
+    if (payload_size == 0 || !tcp_sequence_number_before(m_ack_number, sequence_number) || end - m_ack_number > available_space_in_receive_buffer())
+        return;
+    if (m_out_of_order_packets.size() >= maximum_out_of_order_packets)
+        return;
+
+    size_t index = 0;
+    for (; index < m_out_of_order_packets.size(); ++index) {
+        auto const& queued_packet = m_out_of_order_packets[index];
+        if (queued_packet.sequence_number == sequence_number && queued_packet.end == end) {
+            m_last_out_of_order_sequence_number = sequence_number;
+            return;
+        }
+        if (tcp_sequence_number_before(sequence_number, queued_packet.sequence_number))
+            break;
+    }
+
+    // The IPv4 packet lives in the packet buffer, which we keep alive instead of copying it out.
+    ReadonlyBytes ipv4_packet_bytes { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() };
+    if (m_out_of_order_packets.try_insert(index, { sequence_number, end, ipv4_packet.source(), tcp_packet.source_port(), packet_buffer, ipv4_packet_bytes }).is_error())
+        return;
+    m_last_out_of_order_sequence_number = sequence_number;
+}
+
+bool TCPSocket::receive_queued_out_of_order_packets()
+{
+    bool received_any = false;
+    while (!m_out_of_order_packets.is_empty()) {
+        auto& packet = m_out_of_order_packets.first();
+        if (tcp_sequence_number_before(m_ack_number, packet.sequence_number))
+            break;
+        // A segment that starts before the next expected byte has been (at least partly) received in another one,
+        // the peer will retransmit whatever part of it is still missing.
+        if (packet.sequence_number == m_ack_number) {
+            if (!did_receive(packet.source_address, packet.source_port, *packet.buffer, packet.ipv4_packet))
+                break;
+            m_ack_number = packet.end;
+            received_any = true;
+        }
+        m_out_of_order_packets.take_first();
+    }
+    return received_any;
+}
+
+size_t TCPSocket::build_sack_blocks(Span<TCPSACKBlock> blocks) const
+{
+    auto for_each_range = [this](auto callback) {
+        for (size_t i = 0; i < m_out_of_order_packets.size();) {
+            u32 left_edge = m_out_of_order_packets[i].sequence_number;
+            u32 right_edge = m_out_of_order_packets[i].end;
+            bool contains_last_received = left_edge == m_last_out_of_order_sequence_number;
+            for (++i; i < m_out_of_order_packets.size() && m_out_of_order_packets[i].sequence_number == right_edge; ++i) {
+                contains_last_received |= m_out_of_order_packets[i].sequence_number == m_last_out_of_order_sequence_number;
+                right_edge = m_out_of_order_packets[i].end;
+            }
+            if (callback(left_edge, right_edge, contains_last_received) == IterationDecision::Break)
+                return;
+        }
+    };
+
+    // RFC 2018: "The first SACK block (i.e., the one immediately following the kind and length fields in the option)
+    //  MUST specify the contiguous block of data containing the segment which triggered this ACK"
+    size_t count = 0;
+    for_each_range([&](u32 left_edge, u32 right_edge, bool contains_last_received) {
+        if (!contains_last_received)
+            return IterationDecision::Continue;
+        blocks[count++] = { left_edge, right_edge };
+        return IterationDecision::Break;
+    });
+    for_each_range([&](u32 left_edge, u32 right_edge, bool contains_last_received) {
+        if (count == blocks.size())
+            return IterationDecision::Break;
+        if (!contains_last_received || count == 0)
+            blocks[count++] = { left_edge, right_edge };
+        return IterationDecision::Continue;
+    });
+    return count;
+}
+
+ErrorOr<void> TCPSocket::set_congestion_control_algorithm(TCPCongestionControl::Algorithm algorithm)
+{
+    if (m_congestion_control->algorithm() == algorithm)
+        return {};
+    m_congestion_control = TRY(TCPCongestionControl::try_create(algorithm, m_congestion_control->maximum_segment_size()));
+    return {};
+}
+
 bool TCPSocket::should_delay_next_ack() const
 {
     // FIXME: We don't know the MSS here so make a reasonable guess.
@@ -413,7 +749,7 @@ bool TCPSocket::should_delay_next_ack() const
     return true;
 }
 
-NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(IPv4Address const& source, IPv4Address const& destination, TCPPacket const& packet, u16 payload_size)
+NetworkOrdered<u16> TCPSocket::compute_tcp_pseudo_header_checksum(IPv4Address const& source, IPv4Address const& destination, u16 tcp_length)
 {
     union PseudoHeader {
         struct [[gnu::packed]] {
@@ -427,11 +763,7 @@ NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(IPv4Address const& source, I
     };
     static_assert(sizeof(PseudoHeader) == 12);
 
-    Checked<u16> packet_size = packet.header_size();
-    packet_size += payload_size;
-    VERIFY(!packet_size.has_overflow());
-
-    PseudoHeader pseudo_header { .header = { source, destination, 0, (u8)IPv4Protocol::TCP, packet_size.value() } };
+    PseudoHeader pseudo_header { .header = { source, destination, 0, (u8)IPv4Protocol::TCP, tcp_length } };
 
     u32 checksum = 0;
     auto* raw_pseudo_header = pseudo_header.raw;
@@ -440,6 +772,16 @@ NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(IPv4Address const& source, I
         if (checksum > 0xffff)
             checksum = (checksum >> 16) + (checksum & 0xffff);
     }
+    return static_cast<u16>(checksum);
+}
+
+NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(IPv4Address const& source, IPv4Address const& destination, TCPPacket const& packet, u16 payload_size)
+{
+    Checked<u16> packet_size = packet.header_size();
+    packet_size += payload_size;
+    VERIFY(!packet_size.has_overflow());
+
+    u32 checksum = compute_tcp_pseudo_header_checksum(source, destination, packet_size.value());
     auto* raw_packet = bit_cast<u16*>(&packet);
     for (size_t i = 0; i < packet.header_size() / sizeof(u16); ++i) {
         checksum += AK::convert_between_host_and_network_endian(raw_packet[i]);
@@ -462,10 +804,10 @@ NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(IPv4Address const& source, I
     return ~(checksum & 0xffff);
 }
 
-ErrorOr<void> TCPSocket::setsockopt(int level, int option, Userspace<void const*> user_value, socklen_t user_value_size)
+ErrorOr<void> TCPSocket::setsockopt(OpenFileDescription& description, int level, int option, Userspace<void const*> user_value, socklen_t user_value_size)
 {
     if (level != IPPROTO_TCP)
-        return IPv4Socket::setsockopt(level, option, user_value, user_value_size);
+        return IPv4Socket::setsockopt(description, level, option, user_value, user_value_size);
 
     MutexLocker locker(mutex());
 
@@ -479,6 +821,13 @@ ErrorOr<void> TCPSocket::setsockopt(int level, int option, Userspace<void const*
             return EINVAL;
         m_no_delay = value;
         return {};
+    case TCP_CONGESTION: {
+        auto name = TRY(Process::get_syscall_name_string_fixed_buffer<TCP_CA_NAME_MAX>(static_ptr_cast<char const*>(user_value), min<size_t>(user_value_size, TCP_CA_NAME_MAX)));
+        auto algorithm = TCPCongestionControl::algorithm_from_name(name.representable_view());
+        if (!algorithm.has_value())
+            return ENOENT;
+        return set_congestion_control_algorithm(*algorithm);
+    }
     default:
         dbgln("setsockopt({}) at IPPROTO_TCP not implemented.", option);
         return ENOPROTOOPT;
@@ -504,6 +853,55 @@ ErrorOr<void> TCPSocket::getsockopt(OpenFileDescription& description, int level,
         size = sizeof(nodelay);
         return copy_to_user(value_size, &size);
     }
+    case TCP_CONGESTION: {
+        auto name = m_congestion_control->name();
+        if (size < name.length() + 1)
+            return EINVAL;
+        char name_buffer[TCP_CA_NAME_MAX] {};
+        VERIFY(name.copy_characters_to_buffer(name_buffer, sizeof(name_buffer)));
+        size = name.length() + 1;
+        TRY(copy_to_user(static_ptr_cast<char*>(value), name_buffer, size));
+        return copy_to_user(value_size, &size);
+    }
+    case TCP_INFO: {
+        tcp_info info {};
+        if (m_sack_permitted)
+            info.tcpi_options |= TCPI_OPT_SACK;
+        if (m_window_scaling_supported) {
+            info.tcpi_options |= TCPI_OPT_WSCALE;
+            info.tcpi_snd_wscale = m_send_window_scale;
+            info.tcpi_rcv_wscale = receive_window_scale();
+        }
+        switch (m_recovery_state) {
+        case RecoveryState::None:
+            info.tcpi_ca_state = TCP_CA_Open;
+            break;
+        case RecoveryState::FastRecovery:
+            info.tcpi_ca_state = TCP_CA_Recovery;
+            break;
+        case RecoveryState::Loss:
+            info.tcpi_ca_state = TCP_CA_Loss;
+            break;
+        }
+        info.tcpi_retransmits = m_retransmit_attempts;
+        info.tcpi_rto = m_retransmit_timeout.to_microseconds();
+        info.tcpi_snd_mss = m_congestion_control->maximum_segment_size();
+        info.tcpi_rtt = m_smoothed_rtt.to_microseconds();
+        info.tcpi_rttvar = m_rtt_variance.to_microseconds();
+        m_unacked_packets.with_shared([&](auto const& unacked_packets) {
+            info.tcpi_unacked = unacked_packets.size;
+            info.tcpi_sacked = unacked_packets.sacked_size;
+        });
+        info.tcpi_snd_cwnd = m_congestion_control->congestion_window();
+        info.tcpi_snd_ssthresh = m_congestion_control->slow_start_threshold();
+        info.tcpi_snd_wnd = m_send_window_size;
+        info.tcpi_total_retrans = m_retransmitted_packets;
+        info.tcpi_fast_retrans = m_fast_retransmits;
+
+        size = min<socklen_t>(size, sizeof(info));
+        TRY(copy_to_user(static_ptr_cast<u8*>(value), &info, size));
+        return copy_to_user(value_size, &size);
+    }
     default:
         dbgln("getsockopt({}) at IPPROTO_TCP not implemented.", option);
         return ENOPROTOOPT;
@@ -530,33 +928,35 @@ ErrorOr<void> TCPSocket::protocol_bind()
         constexpr u16 ephemeral_port_range_size = last_ephemeral_port - first_ephemeral_port;
         u16 first_scan_port = first_ephemeral_port + get_good_random<u16>() % ephemeral_port_range_size;
 
-        return sockets_by_tuple().with_exclusive([&](auto& table) -> ErrorOr<void> {
-            u16 port = first_scan_port;
-            while (true) {
-                IPv4SocketTuple proposed_tuple(local_address(), port, peer_address(), peer_port());
-
-                auto it = table.find(proposed_tuple);
-                if (it == table.end()) {
-                    set_local_port(port);
-                    m_registered_socket_tuple = proposed_tuple;
-                    table.set(proposed_tuple, this);
-                    dbgln_if(TCP_SOCKET_DEBUG, "...allocated port {}, tuple {}", port, proposed_tuple.to_string());
-                    return {};
-                }
-                ++port;
-                if (port > last_ephemeral_port)
-                    port = first_ephemeral_port;
-                if (port == first_scan_port)
-                    break;
+        u16 port = first_scan_port;
+        while (true) {
+            IPv4SocketTuple proposed_tuple(local_address(), port, peer_address(), peer_port());
+
+            bool allocated = with_sockets_exclusive(proposed_tuple, [&](auto& table) -> bool {
+                if (table.contains(proposed_tuple))
+                    return false;
+                set_local_port(port);
+                m_registered_socket_tuple = proposed_tuple;
+                table.set(proposed_tuple, this);
+                return true;
+            });
+            if (allocated) {
+                dbgln_if(TCP_SOCKET_DEBUG, "...allocated port {}, tuple {}", port, proposed_tuple.to_string());
+                return {};
             }
-            return set_so_error(EADDRINUSE);
-        });
+            ++port;
+            if (port > last_ephemeral_port)
+                port = first_ephemeral_port;
+            if (port == first_scan_port)
+                break;
+        }
+        return set_so_error(EADDRINUSE);
     } else {
         // Verify that the user-supplied port is not already used by someone else.
-        bool ok = sockets_by_tuple().with_exclusive([&](auto& table) -> bool {
-            if (table.contains(tuple()))
+        auto socket_tuple = tuple();
+        bool ok = with_sockets_exclusive(socket_tuple, [&](auto& table) -> bool {
+            if (table.contains(socket_tuple))
                 return false;
-            auto socket_tuple = tuple();
             m_registered_socket_tuple = socket_tuple;
             table.set(socket_tuple, this);
             return true;
@@ -588,18 +988,22 @@ ErrorOr<void> TCPSocket::protocol_connect(OpenFileDescription& description)
     TRY(ensure_bound());
     if (m_registered_socket_tuple.has_value() && m_registered_socket_tuple != tuple()) {
         // If the socket was manually bound (using bind(2)) instead of implicitly using connect,
-        // it will already be registered in the TCPSocket sockets_by_tuple table, under the previous
-        // socket tuple. We replace the entry in the table to ensure it is also properly removed on
-        // socket deletion, to prevent a dangling reference.
-        TRY(sockets_by_tuple().with_exclusive([this](auto& table) -> ErrorOr<void> {
-            auto removed = table.remove(*m_registered_socket_tuple);
-            VERIFY(removed);
-            if (table.contains(tuple()))
+        // it will already be registered in the table of listening sockets, under the previous socket
+        // tuple. We move the entry to the table of connected sockets to ensure it is also properly
+        // removed on socket deletion, to prevent a dangling reference. The new entry is added first,
+        // so the socket stays registered under the previous tuple if the new one is already in use.
+        auto socket_tuple = tuple();
+        TRY(with_sockets_exclusive(socket_tuple, [&](auto& table) -> ErrorOr<void> {
+            if (table.contains(socket_tuple))
                 return set_so_error(EADDRINUSE);
-            table.set(tuple(), this);
+            table.set(socket_tuple, this);
             return {};
         }));
-        m_registered_socket_tuple = tuple();
+        with_sockets_exclusive(*m_registered_socket_tuple, [&](auto& table) {
+            auto removed = table.remove(*m_registered_socket_tuple);
+            VERIFY(removed);
+        });
+        m_registered_socket_tuple = socket_tuple;
     }
 
     m_sequence_number = get_good_random<u32>();
@@ -704,11 +1108,11 @@ void TCPSocket::retransmit_packets()
 
     // RFC6298 says we should have at least one second between retransmits. According to
     // RFC1122 we must do exponential backoff - even for SYN packets.
-    i64 retransmit_interval = 1;
-    for (decltype(m_retransmit_attempts) i = 0; i < m_retransmit_attempts; i++)
-        retransmit_interval *= 2;
+    auto retransmit_interval = m_retransmit_timeout;
+    for (decltype(m_retransmit_attempts) i = 0; i < m_retransmit_attempts && retransmit_interval < maximum_retransmit_timeout; i++)
+        retransmit_interval += retransmit_interval;
 
-    if (m_last_retransmit_time > now - Duration::from_seconds(retransmit_interval))
+    if (m_last_retransmit_time > now - retransmit_interval)
         return;
 
     dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) handling retransmit", this);
@@ -723,6 +1127,33 @@ void TCPSocket::retransmit_packets()
         return;
     }
 
+    auto adapter = bound_interface().with([](auto& bound_device) -> RefPtr<NetworkAdapter> { return bound_device; });
+    auto routing_decision = route_to(peer_address(), local_address(), adapter);
+    if (routing_decision.is_zero())
+        return;
+
+    m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+        if (unacked_packets.packets.is_empty())
+            return;
+
+        m_congestion_control->on_retransmit_timeout(unacked_packets.bytes_in_flight(), now);
+        m_recovery_state = RecoveryState::Loss;
+        m_recovery_point = m_sequence_number;
+        m_duplicate_acks_received = 0;
+
+        // RFC 2018: "After a retransmit timeout the data sender SHOULD turn off all of the SACKed bits, since the timeout
+        //  might indicate that the data receiver has reneged."
+        for (auto& packet : unacked_packets.packets)
+            packet.sacked = false;
+        unacked_packets.sacked_size = 0;
+
+        // The congestion window is down to a single segment now, the rest is retransmitted as the acknowledgements come in.
+        retransmit_packet(unacked_packets.packets.first(), routing_decision);
+    });
+}
+
+void TCPSocket::retransmit_first_unacked_packet()
+{
     auto adapter = bound_interface().with([](auto& bound_device) -> RefPtr<NetworkAdapter> { return bound_device; });
     auto routing_decision = route_to(peer_address(), local_address(), adapter);
     if (routing_decision.is_zero())
@@ -730,40 +1161,62 @@ void TCPSocket::retransmit_packets()
 
     m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
         for (auto& packet : unacked_packets.packets) {
-            packet.tx_counter++;
-
-            if constexpr (TCP_SOCKET_DEBUG) {
-                auto& tcp_packet = *(TCPPacket const*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
-                dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
-                    local_address(), local_port(),
-                    peer_address(), peer_port(),
-                    (tcp_packet.has_syn() ? "SYN " : ""),
-                    (tcp_packet.has_ack() ? "ACK " : ""),
-                    (tcp_packet.has_fin() ? "FIN " : ""),
-                    (tcp_packet.has_rst() ? "RST " : ""),
-                    tcp_packet.sequence_number(),
-                    tcp_packet.ack_number(),
-                    packet.tx_counter);
-            }
+            if (packet.sacked)
+                continue;
+            retransmit_packet(packet, routing_decision);
+            return;
+        }
+    });
+}
 
-            size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
-            if (ipv4_payload_offset != packet.ipv4_payload_offset) {
-                // FIXME: Add support for this. This can happen if after a route change
-                // we ended up on another adapter which doesn't have the same layer 2 type
-                // like the previous adapter.
-                VERIFY_NOT_REACHED();
-            }
+void TCPSocket::retransmit_packet(OutgoingPacket& packet, RoutingDecision const& routing_decision)
+{
+    packet.tx_counter++;
+
+    if constexpr (TCP_SOCKET_DEBUG) {
+        auto& tcp_packet = *(TCPPacket const*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
+        dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
+            local_address(), local_port(),
+            peer_address(), peer_port(),
+            (tcp_packet.has_syn() ? "SYN " : ""),
+            (tcp_packet.has_ack() ? "ACK " : ""),
+            (tcp_packet.has_fin() ? "FIN " : ""),
+            (tcp_packet.has_rst() ? "RST " : ""),
+            tcp_packet.sequence_number(),
+            tcp_packet.ack_number(),
+            packet.tx_counter);
+    }
+
+    size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
+    if (ipv4_payload_offset != packet.ipv4_payload_offset) {
+        // FIXME: Add support for this. This can happen if after a route change
+        // we ended up on another adapter which doesn't have the same layer 2 type
+        // like the previous adapter.
+        VERIFY_NOT_REACHED();
+    }
 
-            auto packet_buffer = packet.buffer->bytes();
+    auto packet_buffer = packet.buffer->bytes();
 
-            routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
-                local_address(), routing_decision.next_hop, peer_address(),
-                IPv4Protocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
-            routing_decision.adapter->send_packet(packet_buffer);
-            m_packets_out++;
-            m_bytes_out += packet_buffer.size();
+    // The packet may have been prepared for an adapter that could do more work on it than this one.
+    if (!routing_decision.adapter->can_offload(packet.offload)) {
+        if (packet.offload.segment_size != 0) {
+            // FIXME: Split up the segment ourselves.
+            dbgln("TCPSocket: Can't retransmit a segment of {} bytes through {}, it doesn't support segmentation offload", packet.payload_size, routing_decision.adapter->name());
+            return;
         }
-    });
+        auto& tcp_packet = *(TCPPacket*)(packet.buffer->buffer->data() + ipv4_payload_offset);
+        tcp_packet.set_checksum(0);
+        tcp_packet.set_checksum(compute_tcp_checksum(local_address(), peer_address(), tcp_packet, packet.payload_size));
+        packet.offload = {};
+    }
+
+    routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
+        local_address(), routing_decision.next_hop, peer_address(),
+        IPv4Protocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
+    routing_decision.adapter->send_packet(packet_buffer, packet.offload);
+    m_packets_out++;
+    m_bytes_out += packet_buffer.size();
+    m_retransmitted_packets++;
 }
 
 bool TCPSocket::can_write(OpenFileDescription const& file_description, u64 size) const
@@ -778,7 +1231,7 @@ bool TCPSocket::can_write(OpenFileDescription const& file_description, u64 size)
         return true;
 
     return m_unacked_packets.with_shared([&](auto& unacked_packets) {
-        return unacked_packets.size + size <= m_send_window_size;
+        return can_send_segment(m_congestion_control->maximum_segment_size(), unacked_packets.bytes_in_flight());
     });
 }
 }
@@ -15,6 +15,8 @@
 #include <Kernel/Library/LockWeakPtr.h>
 #include <Kernel/Locking/MutexProtected.h>
 #include <Kernel/Net/IPv4Socket.h>
+#include <Kernel/Net/TCP.h>
+#include <Kernel/Net/TCPCongestionControl.h>
 #include <Kernel/Time/TimerQueue.h>
 
 namespace Kernel {
@@ -143,6 +145,30 @@ public:
         m_send_window_scale = scale;
     }
 
+    // What the peer told us about itself in its SYN segment.
+    struct SynOptions {
+        Optional<u8> window_scale;
+        Optional<u16> maximum_segment_size;
+        bool sack_permitted { false };
+    };
+    static SynOptions parse_syn_options(TCPPacket const&);
+    void set_syn_options(SynOptions const&);
+
+    bool sack_permitted() const { return m_sack_permitted; }
+
+    // Holds on to a segment that arrived after a gap, until the data in front of it has arrived as well.
+    void queue_out_of_order_packet(PacketBuffer&, IPv4Packet const&, TCPPacket const&, size_t payload_size);
+    // Passes the queued segments that are in order now on to the receive buffer, returns whether there were any.
+    bool receive_queued_out_of_order_packets();
+
+    TCPCongestionControl const& congestion_control() const { return *m_congestion_control; }
+    ErrorOr<void> set_congestion_control_algorithm(TCPCongestionControl::Algorithm);
+
+    Duration smoothed_rtt() const { return m_smoothed_rtt; }
+    Duration retransmit_timeout() const { return m_retransmit_timeout; }
+    u32 retransmitted_packets() const { return m_retransmitted_packets; }
+    u32 fast_retransmits() const { return m_fast_retransmits; }
+
     // FIXME: Make this configurable?
     static constexpr u32 maximum_duplicate_acks = 5;
     void set_duplicate_acks(u32 acks) { m_duplicate_acks = acks; }
@@ -154,7 +180,6 @@ public:
 
     bool should_delay_next_ack() const;
 
-    static MutexProtected<HashMap<IPv4SocketTuple, TCPSocket*>>& sockets_by_tuple();
     static RefPtr<TCPSocket> from_tuple(IPv4SocketTuple const& tuple);
 
     static MutexProtected<HashMap<IPv4SocketTuple, RefPtr<TCPSocket>>>& closing_sockets();
@@ -172,15 +197,17 @@ public:
     virtual bool can_write(OpenFileDescription const&, u64) const override;
 
     static NetworkOrdered<u16> compute_tcp_checksum(IPv4Address const& source, IPv4Address const& destination, TCPPacket const&, u16 payload_size);
+    // The sum of the pseudo header (before it is complemented), this is what adapters that offload checksums expect to find in the checksum field.
+    static NetworkOrdered<u16> compute_tcp_pseudo_header_checksum(IPv4Address const& source, IPv4Address const& destination, u16 tcp_length);
 
-    virtual ErrorOr<void> setsockopt(int level, int option, Userspace<void const*>, socklen_t) override;
+    virtual ErrorOr<void> setsockopt(OpenFileDescription&, int level, int option, Userspace<void const*>, socklen_t) override;
     virtual ErrorOr<void> getsockopt(OpenFileDescription&, int level, int option, Userspace<void*>, Userspace<socklen_t*>) override;
 
 protected:
     void set_direction(Direction direction) { m_direction = direction; }
 
 private:
-    explicit TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, NonnullRefPtr<Timer> timer);
+    explicit TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullRefPtr<Timer> timer, NonnullOwnPtr<TCPCongestionControl>);
     virtual StringView class_name() const override { return "TCPSocket"sv; }
 
     virtual void shut_down_for_writing() override;
@@ -198,6 +225,21 @@ private:
     void enqueue_for_retransmit();
     void dequeue_for_retransmit();
 
+    struct OutgoingPacket;
+    void retransmit_packet(OutgoingPacket&, RoutingDecision const&);
+    void retransmit_first_unacked_packet();
+    void update_rtt(Duration sample);
+
+    size_t maximum_segment_size(NetworkAdapter const&) const;
+    bool can_send_segment(size_t size, size_t bytes_in_flight) const;
+    size_t send_window_space(size_t bytes_in_flight) const;
+    size_t build_sack_blocks(Span<TCPSACKBlock>) const;
+
+    // RFC 9293: "If an MSS Option is not received at connection setup, TCP implementations MUST assume a default send MSS of 536"
+    static constexpr u16 default_maximum_segment_size = 536;
+    // The data offset field counts 32-bit words in four bits.
+    static constexpr size_t maximum_tcp_header_size = 15 * sizeof(u32);
+
     static constexpr size_t receive_window_scale()
     {
         auto buffer_size_bit_length = AK::log2(receive_buffer_size) + 1;
@@ -220,21 +262,31 @@ private:
     u32 m_bytes_out { 0 };
 
     struct OutgoingPacket {
+        // The first sequence number of the segment, and the one right after it (which is what the peer acknowledges).
+        u32 sequence_number { 0 };
         u32 ack_number { 0 };
-        RefPtr<PacketWithTimestamp> buffer;
+        RefPtr<PacketBuffer> buffer;
         size_t ipv4_payload_offset;
-        LockWeakPtr<NetworkAdapter> adapter;
         int tx_counter { 0 };
+        MonotonicTime sent_time;
+        size_t payload_size { 0 };
+        // The peer told us it received this segment, even though it can't acknowledge it yet (RFC 2018).
+        bool sacked { false };
+        NetworkAdapter::TransmitOffloadRequest offload;
     };
 
     struct UnackedPackets {
         SinglyLinkedList<OutgoingPacket> packets;
         size_t size { 0 };
+        size_t sacked_size { 0 };
+
+        size_t bytes_in_flight() const { return size - sacked_size; }
     };
 
     MutexProtected<UnackedPackets> m_unacked_packets;
 
     u32 m_duplicate_acks { 0 };
+    u32 m_duplicate_acks_received { 0 };
 
     u32 m_last_ack_number_sent { 0 };
     MonotonicTime m_last_ack_sent_time;
@@ -245,6 +297,29 @@ private:
     static constexpr u32 maximum_retransmits = 5;
     MonotonicTime m_last_retransmit_time;
     u32 m_retransmit_attempts { 0 };
+    u32 m_retransmitted_packets { 0 };
+    u32 m_fast_retransmits { 0 };
+
+    // RFC 6298: The retransmission timeout is derived from the measured round-trip times, but never below a second.
+    static constexpr Duration minimum_retransmit_timeout = Duration::from_seconds(1);
+    static constexpr Duration maximum_retransmit_timeout = Duration::from_seconds(60);
+    Duration m_smoothed_rtt;
+    Duration m_rtt_variance;
+    bool m_has_rtt_sample { false };
+    Duration m_retransmit_timeout { minimum_retransmit_timeout };
+
+    NonnullOwnPtr<TCPCongestionControl> m_congestion_control;
+
+    enum class RecoveryState {
+        None,
+        // Recovering from a loss detected by duplicate ACKs, RFC 6582.
+        FastRecovery,
+        // Recovering after the retransmission timer expired.
+        Loss,
+    };
+    RecoveryState m_recovery_state { RecoveryState::None };
+    // Loss recovery is over once everything up to here has been acknowledged.
+    u32 m_recovery_point { 0 };
 
     // Default to maximum window size. receive_tcp_packet() will update from the
     // peer's advertised window size.
@@ -252,6 +327,22 @@ private:
     bool m_window_scaling_supported { false };
     size_t m_send_window_scale { 0 };
 
+    u16 m_peer_maximum_segment_size { default_maximum_segment_size };
+    bool m_sack_permitted { false };
+
+    struct OutOfOrderPacket {
+        u32 sequence_number { 0 };
+        u32 end { 0 };
+        IPv4Address source_address;
+        u16 source_port { 0 };
+        NonnullRefPtr<PacketBuffer> buffer;
+        ReadonlyBytes ipv4_packet;
+    };
+    static constexpr size_t maximum_out_of_order_packets = 256;
+    // Sorted by sequence number.
+    Vector<OutOfOrderPacket> m_out_of_order_packets;
+    u32 m_last_out_of_order_sequence_number { 0 };
+
     bool m_no_delay { false };
 
     IntrusiveListNode<TCPSocket> m_retransmit_list_node;
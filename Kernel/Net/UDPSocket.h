@@ -9,6 +9,7 @@
 #include <AK/Error.h>
 #include <Kernel/Locking/MutexProtected.h>
 #include <Kernel/Net/IPv4Socket.h>
+#include <Kernel/Net/SocketTable.h>
 
 namespace Kernel {
 
@@ -24,7 +25,8 @@ public:
 private:
     explicit UDPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer);
     virtual StringView class_name() const override { return "UDPSocket"sv; }
-    static MutexProtected<HashMap<u16, UDPSocket*>>& sockets_by_port();
+    using SocketsByPort = SocketTable<u16, UDPSocket>;
+    static SocketsByPort& sockets_by_port();
 
     virtual ErrorOr<size_t> protocol_receive(ReadonlyBytes raw_ipv4_packet, UserOrKernelBuffer& buffer, size_t buffer_size, int flags) override;
     virtual ErrorOr<size_t> protocol_send(UserOrKernelBuffer const&, size_t) override;
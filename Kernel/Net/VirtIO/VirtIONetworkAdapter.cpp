@@ -7,6 +7,7 @@
 #include <Kernel/Bus/PCI/IDs.h>
 #include <Kernel/Bus/VirtIO/Transport/PCIe/TransportLink.h>
 #include <Kernel/Net/NetworkingManagement.h>
+#include <Kernel/Net/TCP.h>
 #include <Kernel/Net/VirtIO/VirtIONetworkAdapter.h>
 
 namespace Kernel {
@@ -90,6 +91,8 @@ static constexpr u16 TRANSMITQ = 1;
 static constexpr size_t MAX_RX_FRAME_SIZE = 1514; // Non-jumbo Ethernet frame limit.
 static constexpr size_t RX_BUFFER_SIZE = sizeof(VirtIONetHdr) * MAX_RX_FRAME_SIZE;
 static constexpr u16 MAX_INFLIGHT_PACKETS = 128;
+// The largest IPv4 packet.
+static constexpr size_t max_segmentation_offload_size = 65535;
 
 UNMAP_AFTER_INIT ErrorOr<bool> VirtIONetworkAdapter::probe(PCI::DeviceIdentifier const& pci_device_identifier)
 {
@@ -137,10 +140,22 @@ UNMAP_AFTER_INIT ErrorOr<void> VirtIONetworkAdapter::initialize_virtio_resources
             negotiated |= VIRTIO_NET_F_SPEED_DUPLEX;
         if (is_feature_set(supported_features, VIRTIO_NET_F_MTU))
             negotiated |= VIRTIO_NET_F_MTU;
+        if (is_feature_set(supported_features, VIRTIO_NET_F_CSUM)) {
+            negotiated |= VIRTIO_NET_F_CSUM;
+            if (is_feature_set(supported_features, VIRTIO_NET_F_HOST_TSO4))
+                negotiated |= VIRTIO_NET_F_HOST_TSO4;
+        }
         return negotiated;
     }));
 
     TRY(handle_device_config_change());
+
+    auto offloads = TransmitOffload::None;
+    if (is_feature_accepted(VIRTIO_NET_F_CSUM))
+        offloads |= TransmitOffload::TCPChecksum;
+    if (is_feature_accepted(VIRTIO_NET_F_HOST_TSO4) && mtu() < max_segmentation_offload_size)
+        offloads |= TransmitOffload::TCPSegmentation;
+    set_transmit_offloads(offloads, has_flag(offloads, TransmitOffload::TCPSegmentation) ? max_segmentation_offload_size : 0);
     TRY(setup_queues(2)); // receive & transmit
 
     finish_init();
@@ -253,6 +268,26 @@ static bool copy_data_to_chain(VirtIO::QueueChain& chain, Memory::RingBuffer& ri
 }
 
 void VirtIONetworkAdapter::send_raw(ReadonlyBytes payload)
+{
+    VirtIONetHdr hdr {};
+    send_with_header(hdr, payload);
+}
+
+void VirtIONetworkAdapter::send_raw_with_offload(ReadonlyBytes payload, TransmitOffloadRequest const& offload)
+{
+    VirtIONetHdr hdr {};
+    hdr.flags = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+    hdr.csum_start = offload.tcp_header_offset;
+    hdr.csum_offset = TCPPacket::checksum_offset;
+    if (offload.segment_size != 0) {
+        hdr.gso_type = VIRTIO_NET_HDR_GSO_TCPV4;
+        hdr.gso_size = offload.segment_size;
+        hdr.hdr_len = offload.tcp_header_offset + offload.tcp_header_size;
+    }
+    send_with_header(hdr, payload);
+}
+
+void VirtIONetworkAdapter::send_with_header(VirtIONetHdr const& hdr, ReadonlyBytes payload)
 {
     dbgln_if(VIRTIO_DEBUG, "VirtIONetworkAdapter: send_raw length={}", payload.size());
 
@@ -268,8 +303,7 @@ void VirtIONetworkAdapter::send_raw(ReadonlyBytes payload)
     }
 
     // FIXME: Handle errors from pushing to the chain and rewind the RingBuffer.
-    VirtIONetHdr hdr {};
-    VERIFY(copy_data_to_chain(chain, *m_tx_buffers, reinterpret_cast<u8*>(&hdr), sizeof(hdr)));
+    VERIFY(copy_data_to_chain(chain, *m_tx_buffers, reinterpret_cast<u8 const*>(&hdr), sizeof(hdr)));
     VERIFY(copy_data_to_chain(chain, *m_tx_buffers, payload.data(), payload.size()));
 
     supply_chain_and_notify(TRANSMITQ, chain);
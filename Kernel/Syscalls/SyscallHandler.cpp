@@ -5,6 +5,8 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
+#include <AK/Atomic.h>
 #include <Kernel/API/Syscall.h>
 #include <Kernel/Arch/RegisterState.h>
 #include <Kernel/Arch/TrapFrame.h>
@@ -15,6 +17,7 @@
 #include <Kernel/Tasks/Process.h>
 #include <Kernel/Tasks/Scheduler.h>
 #include <Kernel/Tasks/ThreadTracer.h>
+#include <Kernel/Tasks/TraceBuffer.h>
 
 namespace Kernel {
 
@@ -28,14 +31,34 @@ using HandlerWithRegisterState = auto (Process::*)(RegisterState&) -> ErrorOr<Fl
 struct HandlerMetadata {
     Handler handler;
     NeedsBigProcessLock needs_lock;
+    StringView name;
 };
 
-#define __ENUMERATE_SYSCALL(sys_call, needs_lock) { bit_cast<Handler>(&Process::sys$##sys_call), needs_lock },
+#define __ENUMERATE_SYSCALL(sys_call, needs_lock) { bit_cast<Handler>(&Process::sys$##sys_call), needs_lock, #sys_call##sv },
 static HandlerMetadata const s_syscall_table[] = {
     ENUMERATE_SYSCALLS(__ENUMERATE_SYSCALL)
 };
 #undef __ENUMERATE_SYSCALL
 
+struct BigLockCounters {
+    Atomic<u64, AK::MemoryOrder::memory_order_relaxed> acquisitions { 0 };
+    Atomic<u64, AK::MemoryOrder::memory_order_relaxed> contentions { 0 };
+};
+static Array<BigLockCounters, Function::__Count> s_big_lock_counters;
+
+BigLockStatistics big_lock_statistics(Function function)
+{
+    VERIFY(function < Function::__Count);
+    auto const& metadata = s_syscall_table[function];
+    auto const& counters = s_big_lock_counters[function];
+    return {
+        .syscall_name = metadata.name,
+        .needs_big_lock = metadata.needs_lock == NeedsBigProcessLock::Yes,
+        .acquisitions = counters.acquisitions.load(),
+        .contentions = counters.contentions.load(),
+    };
+}
+
 ErrorOr<FlatPtr> handle(RegisterState& regs, FlatPtr function, FlatPtr arg1, FlatPtr arg2, FlatPtr arg3, FlatPtr arg4)
 {
     VERIFY_INTERRUPTS_ENABLED();
@@ -62,6 +85,11 @@ ErrorOr<FlatPtr> handle(RegisterState& regs, FlatPtr function, FlatPtr arg1, Fla
     MutexLocker mutex_locker;
     auto const needs_big_lock = syscall_metadata.needs_lock == NeedsBigProcessLock::Yes;
     if (needs_big_lock) {
+        auto& counters = s_big_lock_counters[function];
+        ++counters.acquisitions;
+        // NOTE: We never hold the big lock on syscall entry, so if it's locked, another thread is holding it.
+        if (process.big_lock().is_locked())
+            ++counters.contentions;
         mutex_locker.attach_and_lock(process.big_lock());
     };
 
@@ -165,6 +193,8 @@ NEVER_INLINE void syscall_handler(TrapFrame* trap)
     FlatPtr arg4;
     regs.capture_syscall_params(function, arg1, arg2, arg3, arg4);
 
+    TraceBuffer::record(TraceEventType::SyscallEnter, function, arg1);
+
     auto result = Syscall::handle(regs, function, arg1, arg2, arg3, arg4);
 
     if (result.is_error()) {
@@ -173,6 +203,8 @@ NEVER_INLINE void syscall_handler(TrapFrame* trap)
         regs.set_return_reg(result.value());
     }
 
+    TraceBuffer::record(TraceEventType::SyscallExit, function, result.is_error() ? -result.error().code() : result.value());
+
     if (auto* tracer = process.tracer(); tracer && tracer->is_tracing_syscalls()) {
         tracer->set_trace_syscalls(false);
         process.tracer_trap(*current_thread, regs); // this triggers SIGTRAP and stops the thread!
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ScopeGuard.h>
+#include <Kernel/FileSystem/EventPoll.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+// Bounds the kernel buffer that events are collected into, anything beyond that is picked up by the next call.
+static constexpr size_t maximum_events_per_wait = 256;
+
+ErrorOr<FlatPtr> Process::sys$epoll_create1(int flags)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    if (flags & ~EPOLL_CLOEXEC)
+        return EINVAL;
+
+    auto event_poll = TRY(EventPoll::try_create());
+    auto description = TRY(OpenFileDescription::try_create(move(event_poll)));
+    description->set_readable(true);
+
+    u32 fd_flags = 0;
+    if (flags & EPOLL_CLOEXEC)
+        fd_flags |= FD_CLOEXEC;
+
+    return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<FlatPtr> {
+        auto new_fd = TRY(fds.allocate());
+        fds[new_fd.fd].set(move(description), fd_flags);
+        return new_fd.fd;
+    });
+}
+
+ErrorOr<FlatPtr> Process::sys$epoll_ctl(int epoll_fd, int op, int fd, Userspace<epoll_event const*> user_event)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto epoll_description = TRY(open_file_description(epoll_fd));
+    if (!epoll_description->file().is_event_poll())
+        return EINVAL;
+    auto& event_poll = static_cast<EventPoll&>(epoll_description->file());
+
+    auto description = TRY(open_file_description(fd));
+    if (description == epoll_description)
+        return EINVAL;
+
+    switch (op) {
+    case EPOLL_CTL_ADD:
+        TRY(event_poll.add(fd, *description, TRY(copy_typed_from_user(user_event))));
+        return 0;
+    case EPOLL_CTL_MOD:
+        TRY(event_poll.modify(fd, *description, TRY(copy_typed_from_user(user_event))));
+        return 0;
+    case EPOLL_CTL_DEL:
+        TRY(event_poll.remove(fd, *description));
+        return 0;
+    default:
+        return EINVAL;
+    }
+}
+
+ErrorOr<FlatPtr> Process::sys$epoll_wait(Userspace<Syscall::SC_epoll_wait_params const*> user_params)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto params = TRY(copy_typed_from_user(user_params));
+    if (params.max_events <= 0)
+        return EINVAL;
+
+    auto description = TRY(open_file_description(params.epoll_fd));
+    if (!description->file().is_event_poll())
+        return EINVAL;
+    auto& event_poll = static_cast<EventPoll&>(description->file());
+
+    Thread::BlockTimeout timeout;
+    if (params.timeout) {
+        auto timeout_time = TRY(copy_time_from_user(params.timeout));
+        timeout = Thread::BlockTimeout(false, &timeout_time);
+    }
+
+    sigset_t sigmask = {};
+    if (params.sigmask)
+        TRY(copy_from_user(&sigmask, params.sigmask));
+
+    Vector<epoll_event> events;
+    TRY(events.try_resize(min(static_cast<size_t>(params.max_events), maximum_events_per_wait)));
+
+    auto* current_thread = Thread::current();
+
+    u32 previous_signal_mask = 0;
+    if (params.sigmask)
+        previous_signal_mask = current_thread->update_signal_mask(sigmask);
+    ScopeGuard rollback_signal_mask([&]() {
+        if (params.sigmask)
+            current_thread->update_signal_mask(previous_signal_mask);
+    });
+
+    for (;;) {
+        auto count = TRY(event_poll.collect_ready_events(events.span()));
+        if (count > 0) {
+            TRY(copy_n_to_user(params.events, events.data(), count));
+            return count;
+        }
+
+        // NOTE: Being woken up only means that something is on the ready list, it may not be ready anymore.
+        //       The timeout is absolute from here on, so waiting again doesn't extend it.
+        auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
+        auto result = current_thread->block<Thread::ReadBlocker>(timeout, *description, unblock_flags);
+        if (result.was_interrupted())
+            return EINTR;
+        if (result == Thread::BlockResult::InterruptedByTimeout) {
+            count = TRY(event_poll.collect_ready_events(events.span()));
+            if (count > 0)
+                TRY(copy_n_to_user(params.events, events.data(), count));
+            return count;
+        }
+    }
+}
+
+}
@@ -428,7 +428,7 @@ ErrorOr<void> Process::do_exec(NonnullRefPtr<OpenFileDescription> main_program_d
     VERIFY(!Processor::in_critical());
     auto main_program_metadata = main_program_description->metadata();
     // NOTE: Don't allow running SUID binaries at all if we are in a jail.
-    TRY(Process::current().jail().with([&](auto const& my_jail) -> ErrorOr<void> {
+    TRY(jail().with([&](auto const& my_jail) -> ErrorOr<void> {
         if (my_jail && (main_program_metadata.is_setuid() || main_program_metadata.is_setgid())) {
             return Error::from_errno(EPERM);
         }
@@ -569,9 +569,6 @@ ErrorOr<void> Process::do_exec(NonnullRefPtr<OpenFileDescription> main_program_d
         property = {};
     });
 
-    auto* current_thread = Thread::current();
-    current_thread->reset_signals_for_exec();
-
     clear_signal_handlers_for_exec();
 
     clear_futex_queues_on_exec();
@@ -588,6 +585,7 @@ ErrorOr<void> Process::do_exec(NonnullRefPtr<OpenFileDescription> main_program_d
         m_fds.with_exclusive([&](auto& fds) { fds[main_program_fd_allocation->fd].set(move(main_program_description), FD_CLOEXEC); });
     }
 
+    auto* current_thread = Thread::current();
     new_main_thread = nullptr;
     if (&current_thread->process() == this) {
         new_main_thread = current_thread;
@@ -599,6 +597,9 @@ ErrorOr<void> Process::do_exec(NonnullRefPtr<OpenFileDescription> main_program_d
     }
     VERIFY(new_main_thread);
 
+    // NOTE: This isn't necessarily the current thread, posix_spawn() execs on behalf of a freshly created child.
+    new_main_thread->reset_signals_for_exec();
+
     auto credentials = this->credentials();
     auto auxv = generate_auxiliary_vector(load_result.load_base, load_result.entry_eip, credentials->uid(), credentials->euid(), credentials->gid(), credentials->egid(), path->view(), main_program_fd_allocation);
 
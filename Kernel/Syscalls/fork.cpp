@@ -15,17 +15,16 @@
 
 namespace Kernel {
 
-ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
+ErrorOr<ProcessID> Process::create_child_process(Function<ErrorOr<void>(Process& child, Thread& child_first_thread)> set_up_child)
 {
-    VERIFY_NO_PROCESS_BIG_LOCK(this);
-    TRY(require_promise(Pledge::proc));
-
     auto credentials = this->credentials();
     auto child_and_first_thread = TRY(Process::create_with_forked_name(credentials->uid(), credentials->gid(), pid(), m_is_kernel_process, current_directory(), executable(), tty(), this));
     auto& child = child_and_first_thread.process;
     auto& child_first_thread = child_and_first_thread.first_thread;
 
-    ArmedScopeGuard thread_finalizer_guard = [&child_first_thread]() {
+    ArmedScopeGuard thread_finalizer_guard = [&child, &child_first_thread]() {
+        // NOTE: We never told anyone about this child, so make sure its death isn't reported to us either.
+        child->with_mutable_protected_data([](auto& protected_data) { protected_data.ppid = 0; });
         SpinlockLocker lock(g_scheduler_lock);
         child_first_thread->detach();
         child_first_thread->set_state(Thread::State::Dying);
@@ -118,64 +117,7 @@ ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
     // A child process created via fork(2) inherits a copy of its parent's alternate signal stack settings.
     child_first_thread->m_alternative_signal_stack = Thread::current()->m_alternative_signal_stack;
 
-    auto& child_regs = child_first_thread->m_regs;
-#if ARCH(X86_64)
-    child_regs.rax = 0; // fork() returns 0 in the child :^)
-    child_regs.rbx = regs.rbx;
-    child_regs.rcx = regs.rcx;
-    child_regs.rdx = regs.rdx;
-    child_regs.rbp = regs.rbp;
-    child_regs.rsp = regs.userspace_rsp;
-    child_regs.rsi = regs.rsi;
-    child_regs.rdi = regs.rdi;
-    child_regs.r8 = regs.r8;
-    child_regs.r9 = regs.r9;
-    child_regs.r10 = regs.r10;
-    child_regs.r11 = regs.r11;
-    child_regs.r12 = regs.r12;
-    child_regs.r13 = regs.r13;
-    child_regs.r14 = regs.r14;
-    child_regs.r15 = regs.r15;
-    child_regs.rflags = regs.rflags;
-    child_regs.rip = regs.rip;
-    child_regs.cs = regs.cs;
-
-    dbgln_if(FORK_DEBUG, "fork: child will begin executing at {:#04x}:{:p} with stack {:p}, kstack {:p}",
-        child_regs.cs, child_regs.rip, child_regs.rsp, child_regs.rsp0);
-#elif ARCH(AARCH64)
-    child_regs.x[0] = 0; // fork() returns 0 in the child :^)
-    for (size_t i = 1; i < array_size(child_regs.x); ++i)
-        child_regs.x[i] = regs.x[i];
-    child_regs.spsr_el1 = regs.spsr_el1;
-    child_regs.elr_el1 = regs.elr_el1;
-    child_regs.sp_el0 = regs.sp_el0;
-    child_regs.tpidr_el0 = regs.tpidr_el0;
-#elif ARCH(RISCV64)
-    for (size_t i = 0; i < array_size(child_regs.x); ++i)
-        child_regs.x[i] = regs.x[i];
-    child_regs.x[9] = 0; // fork() returns 0 in the child :^)
-    child_regs.sstatus = regs.sstatus;
-    child_regs.pc = regs.sepc;
-    dbgln_if(FORK_DEBUG, "fork: child will begin executing at {:p} with stack {:p}, kstack {:p}",
-        child_regs.pc, child_regs.sp(), child_regs.kernel_sp);
-#else
-#    error Unknown architecture
-#endif
-
-    TRY(address_space().with([&](auto& parent_space) {
-        return child->address_space().with([&](auto& child_space) -> ErrorOr<void> {
-            if (parent_space->enforces_syscall_regions())
-                child_space->set_enforces_syscall_regions();
-            for (auto& region : parent_space->region_tree().regions()) {
-                dbgln_if(FORK_DEBUG, "fork: cloning Region '{}' @ {}", region.name(), region.vaddr());
-                auto region_clone = TRY(region.try_clone());
-                TRY(region_clone->map(child_space->page_directory(), Memory::ShouldFlushTLB::No));
-                TRY(child_space->region_tree().place_specifically(*region_clone, region.range()));
-                (void)region_clone.leak_ptr();
-            }
-            return {};
-        });
-    }));
+    TRY(set_up_child(*child, *child_first_thread));
 
     thread_finalizer_guard.disarm();
     remove_from_jail_process_list.disarm();
@@ -188,8 +130,82 @@ ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
     child_first_thread->set_affinity(Thread::current()->affinity());
     child_first_thread->set_state(Thread::State::Runnable);
 
-    auto child_pid = child->pid().value();
+    return child->pid();
+}
+
+ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::proc));
+
+    auto child_pid = TRY(create_child_process([&](Process& child, Thread& child_first_thread) -> ErrorOr<void> {
+        auto& child_regs = child_first_thread.m_regs;
+#if ARCH(X86_64)
+        child_regs.rax = 0; // fork() returns 0 in the child :^)
+        child_regs.rbx = regs.rbx;
+        child_regs.rcx = regs.rcx;
+        child_regs.rdx = regs.rdx;
+        child_regs.rbp = regs.rbp;
+        child_regs.rsp = regs.userspace_rsp;
+        child_regs.rsi = regs.rsi;
+        child_regs.rdi = regs.rdi;
+        child_regs.r8 = regs.r8;
+        child_regs.r9 = regs.r9;
+        child_regs.r10 = regs.r10;
+        child_regs.r11 = regs.r11;
+        child_regs.r12 = regs.r12;
+        child_regs.r13 = regs.r13;
+        child_regs.r14 = regs.r14;
+        child_regs.r15 = regs.r15;
+        child_regs.rflags = regs.rflags;
+        child_regs.rip = regs.rip;
+        child_regs.cs = regs.cs;
+
+        dbgln_if(FORK_DEBUG, "fork: child will begin executing at {:#04x}:{:p} with stack {:p}, kstack {:p}",
+            child_regs.cs, child_regs.rip, child_regs.rsp, child_regs.rsp0);
+#elif ARCH(AARCH64)
+        child_regs.x[0] = 0; // fork() returns 0 in the child :^)
+        for (size_t i = 1; i < array_size(child_regs.x); ++i)
+            child_regs.x[i] = regs.x[i];
+        child_regs.spsr_el1 = regs.spsr_el1;
+        child_regs.elr_el1 = regs.elr_el1;
+        child_regs.sp_el0 = regs.sp_el0;
+        child_regs.tpidr_el0 = regs.tpidr_el0;
+#elif ARCH(RISCV64)
+        for (size_t i = 0; i < array_size(child_regs.x); ++i)
+            child_regs.x[i] = regs.x[i];
+        child_regs.x[9] = 0; // fork() returns 0 in the child :^)
+        child_regs.sstatus = regs.sstatus;
+        child_regs.pc = regs.sepc;
+        dbgln_if(FORK_DEBUG, "fork: child will begin executing at {:p} with stack {:p}, kstack {:p}",
+            child_regs.pc, child_regs.sp(), child_regs.kernel_sp);
+#else
+#    error Unknown architecture
+#endif
+
+        TRY(address_space().with([&](auto& parent_space) {
+            return child.address_space().with([&](auto& child_space) -> ErrorOr<void> {
+                if (parent_space->enforces_syscall_regions())
+                    child_space->set_enforces_syscall_regions();
+                for (auto& region : parent_space->region_tree().regions()) {
+                    dbgln_if(FORK_DEBUG, "fork: cloning Region '{}' @ {}", region.name(), region.vaddr());
+                    auto region_clone = TRY(region.try_clone());
+                    // NOTE: Most of the parent's pages are never touched by the child before it calls exec(),
+                    //       so we let the page fault handler populate the child's page tables on demand.
+                    if (region_clone->can_be_mapped_lazily())
+                        region_clone->map_lazily(child_space->page_directory());
+                    else
+                        TRY(region_clone->map(child_space->page_directory(), Memory::ShouldFlushTLB::No));
+                    TRY(child_space->region_tree().place_specifically(*region_clone, region.range()));
+                    (void)region_clone.leak_ptr();
+                }
+                return {};
+            });
+        }));
+        return {};
+    }));
 
-    return child_pid;
+    return child_pid.value();
 }
+
 }
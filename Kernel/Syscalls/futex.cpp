@@ -90,7 +90,7 @@ ErrorOr<GlobalFutexKey> Process::get_futex_key(FlatPtr user_address, bool shared
 
 ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> user_params)
 {
-    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
     auto params = TRY(copy_typed_from_user(user_params));
 
     Thread::BlockTimeout timeout;
@@ -106,12 +106,13 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
     switch (cmd) {
     case FUTEX_WAIT:
     case FUTEX_WAIT_BITSET:
-    case FUTEX_REQUEUE:
-    case FUTEX_CMP_REQUEUE: {
+    case FUTEX_LOCK_PI: {
+        // NOTE: FUTEX_REQUEUE and FUTEX_CMP_REQUEUE use this argument as val2 (the requeue limit), not as a timeout.
         if (params.timeout) {
             auto timeout_time = TRY(copy_time_from_user(params.timeout));
             bool is_absolute = cmd != FUTEX_WAIT;
-            clockid_t clock_id = use_realtime_clock ? CLOCK_REALTIME_COARSE : CLOCK_MONOTONIC_COARSE;
+            // FUTEX_LOCK_PI timeouts are always measured against CLOCK_REALTIME.
+            clockid_t clock_id = (use_realtime_clock || cmd == FUTEX_LOCK_PI) ? CLOCK_REALTIME_COARSE : CLOCK_MONOTONIC_COARSE;
             timeout = Thread::BlockTimeout(is_absolute, &timeout_time, nullptr, clock_id);
         }
         if (cmd == FUTEX_WAIT_BITSET && params.val3 == FUTEX_BITSET_MATCH_ANY)
@@ -169,7 +170,7 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
     auto user_address = FlatPtr(params.userspace_address);
     auto user_address2 = FlatPtr(params.userspace_address2);
 
-    auto do_wait = [&](u32 bitset) -> ErrorOr<FlatPtr> {
+    auto do_wait = [&](u32 expected_value, u32 bitset) -> ErrorOr<FlatPtr> {
         bool did_create;
         LockRefPtr<FutexQueue> futex_queue;
         auto futex_key = TRY(get_futex_key(user_address, shared));
@@ -177,8 +178,8 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
             auto user_value = user_atomic_load_relaxed(params.userspace_address);
             if (!user_value.has_value())
                 return EFAULT;
-            if (user_value.value() != params.val) {
-                dbgln_if(FUTEX_DEBUG, "futex wait: EAGAIN. user value: {:p} @ {:p} != val: {}", user_value.value(), params.userspace_address, params.val);
+            if (user_value.value() != expected_value) {
+                dbgln_if(FUTEX_DEBUG, "futex wait: EAGAIN. user value: {:p} @ {:p} != val: {}", user_value.value(), params.userspace_address, expected_value);
                 return EAGAIN;
             }
             atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
@@ -238,9 +239,88 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
         return woken_or_requeued;
     };
 
+    auto do_lock_pi = [&](bool try_only) -> ErrorOr<FlatPtr> {
+        auto* current_thread = Thread::current();
+        u32 tid = current_thread->tid().value();
+        bool did_wait = false;
+        for (;;) {
+            auto user_value = user_atomic_load_relaxed(params.userspace_address);
+            if (!user_value.has_value())
+                return EFAULT;
+            u32 value = user_value.value();
+            u32 owner_tid = value & FUTEX_TID_MASK;
+
+            if (owner_tid == 0) {
+                // The lock is free, try to claim it. If we had to wait for it, others might still be waiting as well,
+                // so make sure our unlock goes through the kernel to wake them.
+                u32 expected = value;
+                u32 new_value = tid | (value & FUTEX_WAITERS) | (did_wait ? FUTEX_WAITERS : 0);
+                auto exchanged = user_atomic_compare_exchange_relaxed(params.userspace_address, expected, new_value);
+                if (!exchanged.has_value())
+                    return EFAULT;
+                if (exchanged.value()) {
+                    atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
+                    return 0;
+                }
+                continue;
+            }
+            if (owner_tid == tid)
+                return EDEADLK;
+            if (try_only)
+                return EAGAIN;
+
+            if (!(value & FUTEX_WAITERS)) {
+                u32 expected = value;
+                auto exchanged = user_atomic_compare_exchange_relaxed(params.userspace_address, expected, value | FUTEX_WAITERS);
+                if (!exchanged.has_value())
+                    return EFAULT;
+                if (!exchanged.value())
+                    continue;
+                value |= FUTEX_WAITERS;
+            }
+
+            // Lend our priority to the owner so that it can't be starved by threads with a priority between ours and its own.
+            auto owner = Thread::from_tid_in_same_jail(owner_tid);
+            if (!owner)
+                return ESRCH;
+            owner->boost_priority(current_thread->priority());
+
+            did_wait = true;
+            auto result = do_wait(value, 0);
+            if (result.is_error() && result.error().code() != EAGAIN)
+                return result.release_error();
+        }
+    };
+
+    auto do_unlock_pi = [&]() -> ErrorOr<FlatPtr> {
+        auto* current_thread = Thread::current();
+        u32 tid = current_thread->tid().value();
+        for (;;) {
+            auto user_value = user_atomic_load_relaxed(params.userspace_address);
+            if (!user_value.has_value())
+                return EFAULT;
+            u32 value = user_value.value();
+            if ((value & FUTEX_TID_MASK) != tid)
+                return EPERM;
+
+            atomic_thread_fence(AK::MemoryOrder::memory_order_release);
+            u32 expected = value;
+            auto exchanged = user_atomic_compare_exchange_relaxed(params.userspace_address, expected, 0);
+            if (!exchanged.has_value())
+                return EFAULT;
+            if (!exchanged.value())
+                continue;
+
+            current_thread->clear_priority_boost();
+            if (value & FUTEX_WAITERS)
+                TRY(do_wake(user_address, 1, {}));
+            return 0;
+        }
+    };
+
     switch (cmd) {
     case FUTEX_WAIT:
-        return do_wait(0);
+        return do_wait(params.val, 0);
 
     case FUTEX_WAKE:
         return TRY(do_wake(user_address, params.val, {}));
@@ -313,11 +393,20 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
     case FUTEX_CMP_REQUEUE:
         return do_requeue(params.val3);
 
+    case FUTEX_LOCK_PI:
+        return do_lock_pi(false);
+
+    case FUTEX_TRYLOCK_PI:
+        return do_lock_pi(true);
+
+    case FUTEX_UNLOCK_PI:
+        return do_unlock_pi();
+
     case FUTEX_WAIT_BITSET:
         VERIFY(params.val3 != FUTEX_BITSET_MATCH_ANY); // we should have turned it into FUTEX_WAIT
         if (params.val3 == 0)
             return EINVAL;
-        return do_wait(params.val3);
+        return do_wait(params.val, params.val3);
 
     case FUTEX_WAKE_BITSET:
         VERIFY(params.val3 != FUTEX_BITSET_MATCH_ANY); // we should have turned it into FUTEX_WAKE
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <Kernel/FileSystem/IORing.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+ErrorOr<FlatPtr> Process::sys$io_ring_create(u32 entries, int options)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto ring = TRY(IORing::try_create(entries));
+    auto description = TRY(OpenFileDescription::try_create(move(ring)));
+    // NOTE: The ring has to be writable to be mapped shared and writable, it can't be written to otherwise.
+    description->set_readable(true);
+    description->set_writable(true);
+
+    u32 fd_flags = 0;
+    if (options & O_CLOEXEC)
+        fd_flags |= FD_CLOEXEC;
+
+    return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<FlatPtr> {
+        auto new_fd = TRY(fds.allocate());
+        fds[new_fd.fd].set(move(description), fd_flags);
+        return new_fd.fd;
+    });
+}
+
+ErrorOr<FlatPtr> Process::sys$io_ring_enter(int fd, u32 to_submit)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto description = TRY(open_file_description(fd));
+    if (!description->file().is_io_ring())
+        return EBADF;
+    auto& ring = static_cast<IORing&>(description->file());
+
+    return TRY(ring.submit(to_submit, [this](IORingSubmission const& submission) -> i64 {
+        auto result = perform_io_ring_submission(submission);
+        if (result.is_error())
+            return -static_cast<i64>(result.error().code());
+        return static_cast<i64>(result.value());
+    }));
+}
+
+ErrorOr<FlatPtr> Process::perform_io_ring_submission(IORingSubmission const& submission)
+{
+    if (submission.length > NumericLimits<ssize_t>::max())
+        return EINVAL;
+    auto length = static_cast<size_t>(submission.length);
+
+    switch (submission.opcode) {
+    case IORingOpcode::Nop:
+        return 0;
+    case IORingOpcode::Read: {
+        Userspace<u8*> buffer { static_cast<FlatPtr>(submission.buffer) };
+        if (submission.offset < 0)
+            return read_impl(submission.fd, buffer, length);
+        return pread_impl(submission.fd, buffer, length, submission.offset);
+    }
+    case IORingOpcode::Write: {
+        Userspace<u8 const*> buffer { static_cast<FlatPtr>(submission.buffer) };
+        if (submission.offset < 0)
+            return sys$write(submission.fd, buffer, length);
+        if (length == 0)
+            return 0;
+        auto description = TRY(open_file_description(submission.fd));
+        if (!description->is_writable())
+            return EBADF;
+        if (!description->file().is_seekable())
+            return EINVAL;
+        auto user_buffer = TRY(UserOrKernelBuffer::for_user_buffer(buffer, length));
+        return do_write(*description, user_buffer, length, submission.offset);
+    }
+    case IORingOpcode::Fsync:
+        return sys$fsync(submission.fd);
+    case IORingOpcode::Close:
+        return close_impl(submission.fd);
+    }
+    return EINVAL;
+}
+
+}
@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Checked.h>
+#include <Kernel/Debug.h>
+#include <Kernel/Devices/TTY/TTY.h>
+#include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/FileSystem/VirtualFileSystem.h>
+#include <Kernel/Memory/ScopedAddressSpaceSwitcher.h>
+#include <Kernel/Net/LocalSocket.h>
+#include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/ProcessGroup.h>
+#include <Kernel/Tasks/Scheduler.h>
+
+namespace Kernel {
+
+static ErrorOr<void> copy_user_strings(Syscall::StringListArgument const& list, Vector<NonnullOwnPtr<KString>>& output)
+{
+    if (!list.length)
+        return {};
+    Checked<size_t> size = sizeof(*list.strings);
+    size *= list.length;
+    if (size.has_overflow())
+        return EOVERFLOW;
+    Vector<Syscall::StringArgument, 32> strings;
+    TRY(strings.try_resize(list.length));
+    TRY(copy_from_user(strings.data(), list.strings, size.value()));
+    for (size_t i = 0; i < list.length; ++i) {
+        auto string = TRY(try_copy_kstring_from_user(strings[i]));
+        TRY(output.try_append(move(string)));
+    }
+    return {};
+}
+
+// NOTE: This creates the child and execs the new program in it directly, without ever cloning our address space.
+//       Everything a fork()ed child would have done before calling exec() is described by the file actions and flags.
+ErrorOr<FlatPtr> Process::sys$posix_spawn(Userspace<Syscall::SC_posix_spawn_params const*> user_params)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::proc));
+    TRY(require_promise(Pledge::exec));
+
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    if (params.arguments.length > ARG_MAX || params.environment.length > ARG_MAX || params.file_actions_count > ARG_MAX)
+        return E2BIG;
+
+    // NOTE: The caller is expected to always pass at least one argument by convention,
+    //       the program path that was passed as params.path.
+    if (params.arguments.length == 0)
+        return EINVAL;
+
+    auto path = TRY(get_syscall_path_argument(params.path));
+
+    Vector<NonnullOwnPtr<KString>> arguments;
+    TRY(copy_user_strings(params.arguments, arguments));
+
+    Vector<NonnullOwnPtr<KString>> environment;
+    TRY(copy_user_strings(params.environment, environment));
+
+    // NOTE: Everything has to be copied out of our address space up front, exec() leaves us in the child's.
+    Vector<Syscall::SC_posix_spawn_file_action> file_actions;
+    Vector<OwnPtr<KString>> file_action_paths;
+    if (params.file_actions_count) {
+        Checked<size_t> size = sizeof(*params.file_actions);
+        size *= params.file_actions_count;
+        if (size.has_overflow())
+            return EOVERFLOW;
+        TRY(file_actions.try_resize(params.file_actions_count));
+        TRY(copy_from_user(file_actions.data(), params.file_actions, size.value()));
+    }
+    for (auto const& action : file_actions) {
+        OwnPtr<KString> action_path;
+        switch (action.type) {
+        case Syscall::PosixSpawnFileActionType::Open:
+            if (action.options & O_WRONLY)
+                TRY(require_promise(Pledge::wpath));
+            else if (action.options & O_RDONLY)
+                TRY(require_promise(Pledge::rpath));
+            if (action.options & O_CREAT)
+                TRY(require_promise(Pledge::cpath));
+            if (action.options & (O_NOFOLLOW_NOERROR | O_UNLINK_INTERNAL))
+                return EINVAL;
+            action_path = TRY(get_syscall_path_argument(action.path));
+            break;
+        case Syscall::PosixSpawnFileActionType::Chdir:
+            TRY(require_promise(Pledge::rpath));
+            action_path = TRY(get_syscall_path_argument(action.path));
+            break;
+        case Syscall::PosixSpawnFileActionType::Close:
+        case Syscall::PosixSpawnFileActionType::Dup2:
+        case Syscall::PosixSpawnFileActionType::Fchdir:
+            break;
+        default:
+            return EINVAL;
+        }
+        TRY(file_action_paths.try_append(move(action_path)));
+    }
+
+    auto apply_file_action = [](Process& child, Syscall::SC_posix_spawn_file_action const& action, OwnPtr<KString> const& action_path) -> ErrorOr<void> {
+        auto validate_fd = [](int fd) -> ErrorOr<void> {
+            if (fd < 0 || static_cast<size_t>(fd) >= OpenFileDescriptions::max_open())
+                return EBADF;
+            return {};
+        };
+
+        switch (action.type) {
+        case Syscall::PosixSpawnFileActionType::Open: {
+            TRY(validate_fd(action.fd));
+            auto base = child.current_directory();
+            auto description = TRY(VirtualFileSystem::the().open(child, child.credentials(), action_path->view(), action.options, (action.mode & 0777) & ~child.umask(), *base));
+            if (description->inode() && description->inode()->bound_socket())
+                return ENXIO;
+            child.m_fds.with_exclusive([&](auto& fds) {
+                if (!fds.m_fds_metadatas[action.fd].is_allocated())
+                    fds.m_fds_metadatas[action.fd].allocate();
+                fds[action.fd].set(move(description), (action.options & O_CLOEXEC) ? FD_CLOEXEC : 0);
+            });
+            return {};
+        }
+        case Syscall::PosixSpawnFileActionType::Close: {
+            auto description = TRY(child.open_file_description(action.fd));
+            auto result = description->close();
+            child.m_fds.with_exclusive([&](auto& fds) { fds[action.fd] = {}; });
+            return result;
+        }
+        case Syscall::PosixSpawnFileActionType::Dup2:
+            return child.m_fds.with_exclusive([&](auto& fds) -> ErrorOr<void> {
+                auto description = TRY(fds.open_file_description(action.fd));
+                if (action.fd == action.new_fd)
+                    return {};
+                TRY(validate_fd(action.new_fd));
+                if (!fds.m_fds_metadatas[action.new_fd].is_allocated())
+                    fds.m_fds_metadatas[action.new_fd].allocate();
+                fds[action.new_fd].set(move(description));
+                return {};
+            });
+        case Syscall::PosixSpawnFileActionType::Chdir: {
+            auto base = child.current_directory();
+            RefPtr<Custody> new_directory = TRY(VirtualFileSystem::the().open_directory(child.credentials(), action_path->view(), *base));
+            child.m_current_directory.with([&](auto& current_directory) {
+                swap(current_directory, new_directory);
+            });
+            return {};
+        }
+        case Syscall::PosixSpawnFileActionType::Fchdir: {
+            auto description = TRY(child.open_file_description(action.fd));
+            if (!description->is_directory())
+                return ENOTDIR;
+            if (!description->metadata().may_execute(child.credentials()))
+                return EACCES;
+            child.m_current_directory.with([&](auto& current_directory) {
+                current_directory = description->custody();
+            });
+            return {};
+        }
+        }
+        VERIFY_NOT_REACHED();
+    };
+
+    auto set_up_child = [&](Process& child, Thread& child_first_thread) -> ErrorOr<void> {
+        if (params.reset_ids) {
+            auto credentials = child.credentials();
+            auto new_credentials = TRY(Credentials::create(
+                credentials->uid(),
+                credentials->gid(),
+                credentials->uid(),
+                credentials->gid(),
+                credentials->suid(),
+                credentials->sgid(),
+                credentials->extra_gids(),
+                credentials->sid(),
+                credentials->pgid()));
+            child.with_mutable_protected_data([&](auto& protected_data) {
+                protected_data.credentials = move(new_credentials);
+            });
+        }
+
+        if (params.set_process_group) {
+            // NOTE: This mirrors what sys$setpgid() checks when a parent moves its child into another process group.
+            auto new_pgid = params.process_group ? ProcessGroupID(params.process_group) : ProcessGroupID(child.pid().value());
+            auto new_sid = get_sid_from_pgid(new_pgid);
+            if (new_sid != -1 && child.sid() != new_sid)
+                return EPERM;
+            if (new_sid == -1 && new_pgid != child.pid().value())
+                return EPERM;
+            auto process_group = TRY(ProcessGroup::find_or_create(new_pgid));
+            auto credentials = child.credentials();
+            auto new_credentials = TRY(Credentials::create(
+                credentials->uid(),
+                credentials->gid(),
+                credentials->euid(),
+                credentials->egid(),
+                credentials->suid(),
+                credentials->sgid(),
+                credentials->extra_gids(),
+                credentials->sid(),
+                new_pgid));
+            child.with_mutable_protected_data([&](auto& protected_data) {
+                protected_data.credentials = move(new_credentials);
+                protected_data.process_group = move(process_group);
+            });
+        }
+
+        if (params.set_priority) {
+            if (params.priority < THREAD_PRIORITY_MIN || params.priority > THREAD_PRIORITY_MAX)
+                return EINVAL;
+            SpinlockLocker lock(g_scheduler_lock);
+            child_first_thread.set_priority(static_cast<u32>(params.priority));
+        }
+
+        for (size_t signal = 1; signal < NSIG; ++signal) {
+            if (params.default_signals & (1u << (signal - 1)))
+                child.m_signal_action_data[signal] = {};
+        }
+
+        if (params.set_signal_mask)
+            child_first_thread.update_signal_mask(params.signal_mask);
+
+        if (params.create_session) {
+            auto process_group = TRY(ProcessGroup::create_if_unused_pgid(ProcessGroupID(child.pid().value())));
+            auto credentials = child.credentials();
+            auto new_credentials = TRY(Credentials::create(
+                credentials->uid(),
+                credentials->gid(),
+                credentials->euid(),
+                credentials->egid(),
+                credentials->suid(),
+                credentials->sgid(),
+                credentials->extra_gids(),
+                SessionID(child.pid().value()),
+                credentials->pgid()));
+            child.with_mutable_protected_data([&](auto& protected_data) {
+                protected_data.tty = nullptr;
+                protected_data.process_group = move(process_group);
+                protected_data.credentials = move(new_credentials);
+            });
+        }
+
+        for (size_t i = 0; i < file_actions.size(); ++i)
+            TRY(apply_file_action(child, file_actions[i], file_action_paths[i]));
+
+        dbgln_if(FORK_DEBUG, "posix_spawn: child={} path={}", child, path);
+
+        Thread* new_main_thread = nullptr;
+        InterruptsState previous_interrupts_state = InterruptsState::Enabled;
+        {
+            // NOTE: exec() switches this processor over to the child's new address space to load the program.
+            ScopedAddressSpaceSwitcher address_space_switcher(*this);
+            TRY(child.exec(move(path), move(arguments), move(environment), new_main_thread, previous_interrupts_state));
+
+            // NOTE: exec() leaves us in a critical section, expecting us to switch to the new main thread.
+            //       That thread belongs to the child though, so just undo that and let the scheduler pick it up.
+            Processor::restore_interrupts_state(previous_interrupts_state);
+            Processor::leave_critical();
+        }
+        VERIFY(&new_main_thread->process() == &child);
+        return {};
+    };
+
+    // NOTE: set_up_child captures too much to fit into a kernel Function's inline storage, so pass it by reference.
+    auto child_pid = TRY(create_child_process([&set_up_child](Process& child, Thread& child_first_thread) {
+        return set_up_child(child, child_first_thread);
+    }));
+
+    return child_pid.value();
+}
+
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+// Large enough to hand a TCP socket a good amount of data at once, small enough to not be a burden on kmalloc.
+static constexpr size_t sendfile_chunk_size = 64 * KiB;
+
+ErrorOr<FlatPtr> Process::sys$sendfile(int out_fd, int in_fd, Userspace<off_t*> user_offset, size_t count)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+    if (count > NumericLimits<ssize_t>::max())
+        return EINVAL;
+
+    auto in_description = TRY(open_file_description(in_fd));
+    if (!in_description->is_readable())
+        return EBADF;
+    // NOTE: Only inodes can be read without blocking, which is what allows us to do this in one go.
+    if (!in_description->file().is_inode() || in_description->is_directory())
+        return EINVAL;
+    auto out_description = TRY(open_file_description(out_fd));
+    if (!out_description->is_writable())
+        return EBADF;
+
+    Optional<off_t> offset;
+    if (user_offset) {
+        offset = TRY(copy_typed_from_user(user_offset));
+        if (*offset < 0)
+            return EINVAL;
+        if (!in_description->file().is_seekable())
+            return ESPIPE;
+    }
+
+    dbgln_if(IO_DEBUG, "sys$sendfile({}, {}, {}, {})", out_fd, in_fd, offset, count);
+    if (count == 0)
+        return 0;
+
+    // The data only ever passes through this buffer, instead of being copied out to userspace and back in again.
+    auto buffer = TRY(ByteBuffer::create_uninitialized(min(count, sendfile_chunk_size)));
+    auto kernel_buffer = UserOrKernelBuffer::for_kernel_buffer(buffer.data());
+
+    size_t total_nwritten = 0;
+    while (total_nwritten < count) {
+        auto chunk_size = min(count - total_nwritten, buffer.size());
+        auto nread_or_error = offset.has_value()
+            ? in_description->read(kernel_buffer, *offset + total_nwritten, chunk_size)
+            : in_description->read(kernel_buffer, chunk_size);
+        if (nread_or_error.is_error()) {
+            if (total_nwritten > 0)
+                break;
+            return nread_or_error.release_error();
+        }
+        auto nread = nread_or_error.value();
+        if (nread == 0)
+            break;
+
+        auto nwritten_or_error = do_write(*out_description, kernel_buffer, nread);
+        auto nwritten = nwritten_or_error.is_error() ? 0 : nwritten_or_error.value();
+        // Whatever we read but couldn't send must not count as consumed from the file's offset.
+        if (!offset.has_value() && nwritten < nread)
+            TRY(in_description->seek(-static_cast<off_t>(nread - nwritten), SEEK_CUR));
+        if (nwritten_or_error.is_error()) {
+            if (total_nwritten > 0)
+                break;
+            return nwritten_or_error.release_error();
+        }
+        total_nwritten += nwritten;
+        if (nwritten < nread)
+            break;
+    }
+
+    if (offset.has_value()) {
+        off_t new_offset = *offset + total_nwritten;
+        TRY(copy_to_user(user_offset, &new_offset));
+    }
+    return total_nwritten;
+}
+
+}
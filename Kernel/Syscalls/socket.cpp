@@ -181,17 +181,21 @@ ErrorOr<FlatPtr> Process::sys$shutdown(int sockfd, int how)
 
 ErrorOr<FlatPtr> Process::sys$sendmsg(int sockfd, Userspace<const struct msghdr*> user_msg, int flags)
 {
-    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
     TRY(require_promise(Pledge::stdio));
     auto msg = TRY(copy_typed_from_user(user_msg));
 
-    if (msg.msg_iovlen != 1)
-        return ENOTSUP; // FIXME: Support this :)
-    Vector<iovec, 1> iovs;
+    if (msg.msg_iovlen > IOV_MAX)
+        return EMSGSIZE;
+    Vector<iovec, 8> iovs;
     TRY(iovs.try_resize(msg.msg_iovlen));
     TRY(copy_n_from_user(iovs.data(), msg.msg_iov, msg.msg_iovlen));
-    if (iovs[0].iov_len > NumericLimits<ssize_t>::max())
-        return EINVAL;
+    size_t total_length = 0;
+    for (auto& iov : iovs) {
+        total_length += iov.iov_len;
+        if (total_length > NumericLimits<ssize_t>::max())
+            return EINVAL;
+    }
 
     Userspace<sockaddr const*> user_addr((FlatPtr)msg.msg_name);
     socklen_t addr_length = msg.msg_namelen;
@@ -217,54 +221,100 @@ ErrorOr<FlatPtr> Process::sys$sendmsg(int sockfd, Userspace<const struct msghdr*
                 auto& local_socket = static_cast<LocalSocket&>(socket);
                 int* fds = (int*)CMSG_DATA(cmsg);
                 size_t nfds = (cmsg->cmsg_len - CMSG_ALIGN(sizeof(struct cmsghdr))) / sizeof(int);
-                for (size_t i = 0; i < nfds; ++i) {
-                    TRY(local_socket.sendfd(*description, TRY(open_file_description(fds[i]))));
-                }
+                // Look up all passed descriptions under a single lock, and queue them in one go.
+                auto passing_descriptions = TRY(m_fds.with_shared([&](auto& process_fds) -> ErrorOr<Vector<NonnullRefPtr<OpenFileDescription>>> {
+                    Vector<NonnullRefPtr<OpenFileDescription>> descriptions;
+                    TRY(descriptions.try_ensure_capacity(nfds));
+                    for (size_t i = 0; i < nfds; ++i)
+                        descriptions.unchecked_append(TRY(process_fds.open_file_description(fds[i])));
+                    return descriptions;
+                }));
+                TRY(local_socket.sendfds(*description, move(passing_descriptions)));
             }
         }
     }
 
-    auto data_buffer = TRY(UserOrKernelBuffer::for_user_buffer((u8*)iovs[0].iov_base, iovs[0].iov_len));
+    auto send_buffer = [&](UserOrKernelBuffer const& data_buffer, size_t length, bool may_block) -> ErrorOr<size_t> {
+        while (true) {
+            while (!description->can_write()) {
+                if (!may_block)
+                    return EAGAIN;
 
-    while (true) {
-        while (!description->can_write()) {
-            if (!description->is_blocking()) {
-                return EAGAIN;
+                auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
+                if (Thread::current()->block<Thread::WriteBlocker>({}, *description, unblock_flags).was_interrupted()) {
+                    return EINTR;
+                }
+                // TODO: handle exceptions in unblock_flags
             }
 
-            auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
-            if (Thread::current()->block<Thread::WriteBlocker>({}, *description, unblock_flags).was_interrupted()) {
-                return EINTR;
+            auto bytes_sent_or_error = socket.sendto(*description, data_buffer, length, flags, user_addr, addr_length);
+            if (bytes_sent_or_error.is_error()) {
+                if ((flags & MSG_NOSIGNAL) == 0 && bytes_sent_or_error.error().code() == EPIPE)
+                    Thread::current()->send_signal(SIGPIPE, &Process::current());
+                return bytes_sent_or_error.release_error();
             }
-            // TODO: handle exceptions in unblock_flags
+
+            auto bytes_sent = bytes_sent_or_error.release_value();
+            if (bytes_sent > 0 || length == 0)
+                return bytes_sent;
         }
+    };
 
-        auto bytes_sent_or_error = socket.sendto(*description, data_buffer, iovs[0].iov_len, flags, user_addr, addr_length);
-        if (bytes_sent_or_error.is_error()) {
-            if ((flags & MSG_NOSIGNAL) == 0 && bytes_sent_or_error.error().code() == EPIPE)
-                Thread::current()->send_signal(SIGPIPE, &Process::current());
-            return bytes_sent_or_error.release_error();
+    if (iovs.size() == 1 || (socket.type() != SOCK_STREAM && !iovs.is_empty())) {
+        if (iovs.size() == 1) {
+            auto data_buffer = TRY(UserOrKernelBuffer::for_user_buffer((u8*)iovs[0].iov_base, iovs[0].iov_len));
+            return TRY(send_buffer(data_buffer, iovs[0].iov_len, description->is_blocking()));
         }
 
-        auto bytes_sent = bytes_sent_or_error.release_value();
-        if (bytes_sent > 0)
-            return bytes_sent;
+        // Message boundaries have to be preserved, so gather the whole datagram first.
+        auto gathered = TRY(ByteBuffer::create_uninitialized(total_length));
+        size_t offset = 0;
+        for (auto& iov : iovs) {
+            TRY(copy_from_user(gathered.offset_pointer(offset), iov.iov_base, iov.iov_len));
+            offset += iov.iov_len;
+        }
+        return TRY(send_buffer(UserOrKernelBuffer::for_kernel_buffer(gathered.data()), total_length, description->is_blocking()));
     }
+
+    // Stream sockets copy each segment straight from userspace into the socket buffer. Only block until
+    // the first byte has been sent, like a short write() would.
+    size_t total_sent = 0;
+    for (auto& iov : iovs) {
+        if (iov.iov_len == 0)
+            continue;
+        auto data_buffer = TRY(UserOrKernelBuffer::for_user_buffer((u8*)iov.iov_base, iov.iov_len));
+        auto bytes_sent_or_error = send_buffer(data_buffer, iov.iov_len, total_sent == 0 && description->is_blocking());
+        if (bytes_sent_or_error.is_error()) {
+            if (total_sent == 0)
+                return bytes_sent_or_error.release_error();
+            break;
+        }
+        total_sent += bytes_sent_or_error.value();
+        if (bytes_sent_or_error.value() < iov.iov_len)
+            break;
+    }
+    return total_sent;
 }
 
 ErrorOr<FlatPtr> Process::sys$recvmsg(int sockfd, Userspace<struct msghdr*> user_msg, int flags)
 {
-    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
     TRY(require_promise(Pledge::stdio));
 
     struct msghdr msg;
     TRY(copy_from_user(&msg, user_msg));
 
-    if (msg.msg_iovlen != 1)
-        return ENOTSUP; // FIXME: Support this :)
-    Vector<iovec, 1> iovs;
+    if (msg.msg_iovlen > IOV_MAX)
+        return EMSGSIZE;
+    Vector<iovec, 8> iovs;
     TRY(iovs.try_resize(msg.msg_iovlen));
     TRY(copy_n_from_user(iovs.data(), msg.msg_iov, msg.msg_iovlen));
+    size_t total_length = 0;
+    for (auto& iov : iovs) {
+        total_length += iov.iov_len;
+        if (total_length > NumericLimits<ssize_t>::max())
+            return EINVAL;
+    }
 
     Userspace<sockaddr*> user_addr((FlatPtr)msg.msg_name);
     Userspace<socklen_t*> user_addr_length(msg.msg_name ? (FlatPtr)&user_msg.unsafe_userspace_ptr()->msg_namelen : 0);
@@ -277,17 +327,56 @@ ErrorOr<FlatPtr> Process::sys$recvmsg(int sockfd, Userspace<struct msghdr*> user
     if (socket.is_shut_down_for_reading())
         return 0;
 
-    auto data_buffer = TRY(UserOrKernelBuffer::for_user_buffer((u8*)iovs[0].iov_base, iovs[0].iov_len));
     UnixDateTime timestamp {};
     bool blocking = (flags & MSG_DONTWAIT) ? false : description->is_blocking();
-    auto result = socket.recvfrom(*description, data_buffer, iovs[0].iov_len, flags, user_addr, user_addr_length, timestamp, blocking);
+    auto receive = [&]() -> ErrorOr<size_t> {
+        if (iovs.size() == 1) {
+            auto data_buffer = TRY(UserOrKernelBuffer::for_user_buffer((u8*)iovs[0].iov_base, iovs[0].iov_len));
+            return socket.recvfrom(*description, data_buffer, iovs[0].iov_len, flags, user_addr, user_addr_length, timestamp, blocking);
+        }
+
+        if (socket.type() != SOCK_STREAM) {
+            // Receive the whole datagram at once, then scatter it.
+            auto gathered = TRY(ByteBuffer::create_uninitialized(total_length));
+            auto gathered_buffer = UserOrKernelBuffer::for_kernel_buffer(gathered.data());
+            auto nreceived = TRY(socket.recvfrom(*description, gathered_buffer, total_length, flags, user_addr, user_addr_length, timestamp, blocking));
+            size_t offset = 0;
+            for (auto& iov : iovs) {
+                if (offset >= min(nreceived, total_length))
+                    break;
+                auto chunk_length = min(iov.iov_len, min(nreceived, total_length) - offset);
+                TRY(copy_to_user(iov.iov_base, gathered.offset_pointer(offset), chunk_length));
+                offset += chunk_length;
+            }
+            return nreceived;
+        }
+
+        // Stream sockets copy straight from the socket buffer into each segment. Only block for the first byte.
+        size_t total_received = 0;
+        for (auto& iov : iovs) {
+            if (iov.iov_len == 0)
+                continue;
+            auto data_buffer = TRY(UserOrKernelBuffer::for_user_buffer((u8*)iov.iov_base, iov.iov_len));
+            auto nreceived_or_error = socket.recvfrom(*description, data_buffer, iov.iov_len, flags, user_addr, user_addr_length, timestamp, total_received == 0 && blocking);
+            if (nreceived_or_error.is_error()) {
+                if (total_received == 0)
+                    return nreceived_or_error.release_error();
+                break;
+            }
+            total_received += nreceived_or_error.value();
+            if (nreceived_or_error.value() < iov.iov_len)
+                break;
+        }
+        return total_received;
+    };
+    auto result = receive();
 
     if (result.is_error())
         return result.release_error();
 
     int msg_flags = 0;
 
-    if (result.value() > iovs[0].iov_len) {
+    if (result.value() > total_length) {
         VERIFY(socket.type() != SOCK_STREAM);
         msg_flags |= MSG_TRUNC;
     }
@@ -317,11 +406,15 @@ ErrorOr<FlatPtr> Process::sys$recvmsg(int sockfd, Userspace<struct msghdr*> user
         auto& local_socket = static_cast<LocalSocket&>(socket);
         auto descriptions = TRY(local_socket.recvfds(description, space_for_fds));
         Vector<int> fdnums;
-        for (auto& description : descriptions) {
-            auto fd_allocation = TRY(m_fds.with_exclusive([](auto& fds) { return fds.allocate(); }));
-            m_fds.with_exclusive([&](auto& fds) { fds[fd_allocation.fd].set(*description, 0); });
-            fdnums.append(fd_allocation.fd);
-        }
+        TRY(fdnums.try_ensure_capacity(descriptions.size()));
+        TRY(m_fds.with_exclusive([&](auto& fds) -> ErrorOr<void> {
+            for (auto& description : descriptions) {
+                auto fd_allocation = TRY(fds.allocate());
+                fds[fd_allocation.fd].set(*description, 0);
+                fdnums.unchecked_append(fd_allocation.fd);
+            }
+            return {};
+        }));
         if (!fdnums.is_empty())
             TRY(try_add_cmsg(SOL_SOCKET, SCM_RIGHTS, fdnums.data(), fdnums.size() * sizeof(int)));
     }
@@ -408,7 +501,7 @@ ErrorOr<FlatPtr> Process::sys$setsockopt(Userspace<Syscall::SC_setsockopt_params
         return ENOTSOCK;
     auto& socket = *description->socket();
     REQUIRE_PROMISE_FOR_SOCKET_DOMAIN(socket.domain());
-    TRY(socket.setsockopt(params.level, params.option, user_value, params.value_size));
+    TRY(socket.setsockopt(*description, params.level, params.option, user_value, params.value_size));
     return 0;
 }
 
@@ -61,7 +61,7 @@ ErrorOr<FlatPtr> Process::sys$create_thread(void* (*entry)(void*), Userspace<Sys
 
 #if ARCH(X86_64)
     regs.set_flags(0x0202);
-    regs.cr3 = address_space().with([](auto& space) { return space->page_directory().cr3(); });
+    address_space().with([&](auto& space) { regs.set_page_directory(space->page_directory()); });
 
     // Set up the argument registers expected by pthread_create_helper.
     regs.rdi = (FlatPtr)params.entry;
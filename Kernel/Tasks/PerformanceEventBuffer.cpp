@@ -9,6 +9,7 @@
 #include <AK/JsonObjectSerializer.h>
 #include <AK/ScopeGuard.h>
 #include <AK/StackUnwinder.h>
+#include <Kernel/Arch/PerformanceCounters.h>
 #include <Kernel/Arch/RegisterState.h>
 #include <Kernel/Arch/SafeMem.h>
 #include <Kernel/FileSystem/Custody.h>
@@ -106,8 +107,17 @@ ErrorOr<void> PerformanceEventBuffer::append_with_ip_and_bp(ProcessID pid, Threa
     event.lost_samples = lost_samples;
 
     switch (type) {
-    case PERF_EVENT_SAMPLE:
+    case PERF_EVENT_SAMPLE: {
+        // Samples are always taken of the current thread.
+        PerformanceCounterValues counters;
+        if (auto* current_thread = Thread::current(); current_thread && current_thread->tid() == tid && PerformanceCounters::is_available())
+            counters = PerformanceCounters::take_delta(current_thread->performance_counter_baseline());
+        event.data.sample.cycles = counters.cycles;
+        event.data.sample.instructions = counters.instructions;
+        event.data.sample.cache_misses = counters.cache_misses;
+        event.data.sample.branch_misses = counters.branch_misses;
         break;
+    }
     case PERF_EVENT_MALLOC:
         event.data.malloc.size = arg1;
         event.data.malloc.ptr = arg2;
@@ -171,6 +181,11 @@ ErrorOr<void> PerformanceEventBuffer::append_with_ip_and_bp(ProcessID pid, Threa
     case PERF_EVENT_FILESYSTEM:
         event.data.filesystem = filesystem_event;
         break;
+    case PERF_EVENT_MUTEX_WAIT:
+    case PERF_EVENT_MUTEX_HOLD:
+        event.data.mutex.mutex = arg1;
+        event.data.mutex.duration_ns = arg2;
+        break;
     default:
         return EINVAL;
     }
@@ -227,12 +242,20 @@ ErrorOr<void> PerformanceEventBuffer::to_json_impl(Serializer& object) const
         if (!show_kernel_addresses) {
             if (event.type == PERF_EVENT_KMALLOC || event.type == PERF_EVENT_KFREE)
                 continue;
+            if (event.type == PERF_EVENT_MUTEX_WAIT || event.type == PERF_EVENT_MUTEX_HOLD)
+                continue;
         }
 
         auto event_object = TRY(array.add_object());
         switch (event.type) {
         case PERF_EVENT_SAMPLE:
             TRY(event_object.add("type"sv, "sample"));
+            if (PerformanceCounters::is_available()) {
+                TRY(event_object.add("cycles"sv, event.data.sample.cycles));
+                TRY(event_object.add("instructions"sv, event.data.sample.instructions));
+                TRY(event_object.add("cache_misses"sv, event.data.sample.cache_misses));
+                TRY(event_object.add("branch_misses"sv, event.data.sample.branch_misses));
+            }
             break;
         case PERF_EVENT_MALLOC:
             TRY(event_object.add("type"sv, "malloc"));
@@ -299,6 +322,16 @@ ErrorOr<void> PerformanceEventBuffer::to_json_impl(Serializer& object) const
             TRY(event_object.add("arg1"sv, event.data.signpost.arg1));
             TRY(event_object.add("arg2"sv, event.data.signpost.arg2));
             break;
+        case PERF_EVENT_MUTEX_WAIT:
+            TRY(event_object.add("type"sv, "mutex_wait"sv));
+            TRY(event_object.add("mutex"sv, static_cast<u64>(event.data.mutex.mutex)));
+            TRY(event_object.add("durationNs"sv, event.data.mutex.duration_ns));
+            break;
+        case PERF_EVENT_MUTEX_HOLD:
+            TRY(event_object.add("type"sv, "mutex_hold"sv));
+            TRY(event_object.add("mutex"sv, static_cast<u64>(event.data.mutex.mutex)));
+            TRY(event_object.add("durationNs"sv, event.data.mutex.duration_ns));
+            break;
         case PERF_EVENT_FILESYSTEM:
             TRY(event_object.add("type"sv, "filesystem"sv));
             TRY(event_object.add("durationNs"sv, event.data.filesystem.durationNs));
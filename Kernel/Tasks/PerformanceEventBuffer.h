@@ -15,6 +15,13 @@ namespace Kernel {
 class KBufferBuilder;
 struct RegisterState;
 
+struct [[gnu::packed]] SamplePerformanceEvent {
+    u64 cycles;
+    u64 instructions;
+    u64 cache_misses;
+    u64 branch_misses;
+};
+
 struct [[gnu::packed]] MallocPerformanceEvent {
     size_t size;
     FlatPtr ptr;
@@ -69,6 +76,11 @@ struct [[gnu::packed]] SignpostPerformanceEvent {
     FlatPtr arg2;
 };
 
+struct [[gnu::packed]] MutexPerformanceEvent {
+    FlatPtr mutex;
+    u64 duration_ns;
+};
+
 struct [[gnu::packed]] ReadPerformanceEvent {
     int fd;
     size_t size;
@@ -145,6 +157,7 @@ struct [[gnu::packed]] PerformanceEvent {
     u64 timestamp;
     u32 lost_samples;
     union {
+        SamplePerformanceEvent sample;
         MallocPerformanceEvent malloc;
         FreePerformanceEvent free;
         MmapPerformanceEvent mmap;
@@ -157,6 +170,7 @@ struct [[gnu::packed]] PerformanceEvent {
         KFreePerformanceEvent kfree;
         SignpostPerformanceEvent signpost;
         FilesystemEvent filesystem;
+        MutexPerformanceEvent mutex;
     } data;
     static constexpr size_t max_stack_frame_count = 64;
     FlatPtr stack[max_stack_frame_count];
@@ -84,6 +84,10 @@ public:
 
     static void add_context_switch_perf_event(Thread& current_thread, Thread& next_thread)
     {
+        // Samples of the next thread should only account for the hardware events since it was scheduled.
+        if (PerformanceCounters::is_available() && next_thread.process().current_perf_events_buffer())
+            next_thread.performance_counter_baseline() = PerformanceCounters::read();
+
         if (current_thread.is_profiling_suppressed())
             return;
         if (auto* event_buffer = current_thread.process().current_perf_events_buffer()) {
@@ -109,6 +113,33 @@ public:
         }
     }
 
+    static bool is_profiling_mutex_contention(Thread& current_thread)
+    {
+        if (current_thread.is_profiling_suppressed())
+            return false;
+        if ((g_profiling_event_mask & (PERF_EVENT_MUTEX_WAIT | PERF_EVENT_MUTEX_HOLD)) == 0)
+            return false;
+        return current_thread.process().current_perf_events_buffer() != nullptr;
+    }
+
+    static void add_mutex_wait_event(Thread& current_thread, Mutex const& mutex, Duration wait_time)
+    {
+        if (current_thread.is_profiling_suppressed())
+            return;
+        if (auto* event_buffer = current_thread.process().current_perf_events_buffer()) {
+            [[maybe_unused]] auto res = event_buffer->append(PERF_EVENT_MUTEX_WAIT, bit_cast<FlatPtr>(&mutex), static_cast<FlatPtr>(wait_time.to_nanoseconds()), {});
+        }
+    }
+
+    static void add_mutex_hold_event(Thread& current_thread, Mutex const& mutex, Duration hold_time)
+    {
+        if (current_thread.is_profiling_suppressed())
+            return;
+        if (auto* event_buffer = current_thread.process().current_perf_events_buffer()) {
+            [[maybe_unused]] auto res = event_buffer->append(PERF_EVENT_MUTEX_HOLD, bit_cast<FlatPtr>(&mutex), static_cast<FlatPtr>(hold_time.to_nanoseconds()), {});
+        }
+    }
+
     static void add_page_fault_event(Thread& thread, RegisterState const& regs)
     {
         if (thread.is_profiling_suppressed())
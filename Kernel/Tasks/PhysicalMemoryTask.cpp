@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/VirtualFileSystem.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/PhysicalMemoryTask.h>
+#include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/Scheduler.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+static constexpr StringView physical_memory_task_name = "Physical Memory Task"sv;
+
+// NOTE: This only runs when nothing more important wants the processor, so the work it does is "free".
+static void physical_memory_task(void*)
+{
+    Thread::current()->set_priority(THREAD_PRIORITY_MIN);
+
+    static constexpr size_t zeroing_batch_size = 16;
+    static constexpr auto compaction_interval = Duration::from_seconds(10);
+
+    auto last_compaction = TimeManagement::the().monotonic_time();
+    while (!Process::current().is_dying()) {
+        // Caches only get to keep memory that nobody else needs.
+        if (MM.is_under_memory_pressure()) {
+            if (auto released_bytes = VirtualFileSystem::the().release_file_system_cache_memory())
+                dbgln("{}: Released {} KiB of file system caches", physical_memory_task_name, released_bytes / KiB);
+        }
+
+        while (MM.refill_zeroed_page_pool(zeroing_batch_size) > 0)
+            Scheduler::yield();
+
+        auto now = TimeManagement::the().monotonic_time();
+        if (now - last_compaction >= compaction_interval) {
+            MM.compact_physical_memory();
+            last_compaction = now;
+        }
+
+        (void)Thread::current()->sleep(Duration::from_milliseconds(100));
+    }
+    Process::current().sys$exit(0);
+    VERIFY_NOT_REACHED();
+}
+
+UNMAP_AFTER_INIT void PhysicalMemoryTask::spawn()
+{
+    MUST(Process::create_kernel_process(physical_memory_task_name, physical_memory_task, nullptr));
+}
+
+}
@@ -15,7 +15,9 @@
 #include <AK/RefPtr.h>
 #include <AK/Userspace.h>
 #include <AK/Variant.h>
+#include <Kernel/API/IORing.h>
 #include <Kernel/API/POSIX/select.h>
+#include <Kernel/API/POSIX/sys/epoll.h>
 #include <Kernel/API/POSIX/sys/resource.h>
 #include <Kernel/API/Syscall.h>
 #ifdef ENABLE_KERNEL_COVERAGE_COLLECTION
@@ -332,6 +334,11 @@ public:
     ErrorOr<FlatPtr> sys$create_inode_watcher(u32 flags);
     ErrorOr<FlatPtr> sys$inode_watcher_add_watch(Userspace<Syscall::SC_inode_watcher_add_watch_params const*> user_params);
     ErrorOr<FlatPtr> sys$inode_watcher_remove_watch(int fd, int wd);
+    ErrorOr<FlatPtr> sys$epoll_create1(int flags);
+    ErrorOr<FlatPtr> sys$epoll_ctl(int epoll_fd, int op, int fd, Userspace<epoll_event const*>);
+    ErrorOr<FlatPtr> sys$epoll_wait(Userspace<Syscall::SC_epoll_wait_params const*>);
+    ErrorOr<FlatPtr> sys$io_ring_create(u32 entries, int options);
+    ErrorOr<FlatPtr> sys$io_ring_enter(int fd, u32 to_submit);
     ErrorOr<FlatPtr> sys$dbgputstr(Userspace<char const*>, size_t);
     ErrorOr<FlatPtr> sys$dump_backtrace();
     ErrorOr<FlatPtr> sys$gettid();
@@ -392,6 +399,7 @@ public:
     ErrorOr<FlatPtr> sys$readlink(Userspace<Syscall::SC_readlink_params const*>);
     ErrorOr<FlatPtr> sys$fork(RegisterState&);
     ErrorOr<FlatPtr> sys$execve(Userspace<Syscall::SC_execve_params const*>);
+    ErrorOr<FlatPtr> sys$posix_spawn(Userspace<Syscall::SC_posix_spawn_params const*>);
     ErrorOr<FlatPtr> sys$dup2(int old_fd, int new_fd);
     ErrorOr<FlatPtr> sys$sigaction(int signum, Userspace<sigaction const*> act, Userspace<sigaction*> old_act);
     ErrorOr<FlatPtr> sys$sigaltstack(Userspace<stack_t const*> ss, Userspace<stack_t*> old_ss);
@@ -437,6 +445,7 @@ public:
     ErrorOr<FlatPtr> sys$accept4(Userspace<Syscall::SC_accept4_params const*>);
     ErrorOr<FlatPtr> sys$connect(int sockfd, Userspace<sockaddr const*>, socklen_t);
     ErrorOr<FlatPtr> sys$shutdown(int sockfd, int how);
+    ErrorOr<FlatPtr> sys$sendfile(int out_fd, int in_fd, Userspace<off_t*> offset, size_t count);
     ErrorOr<FlatPtr> sys$sendmsg(int sockfd, Userspace<const struct msghdr*>, int flags);
     ErrorOr<FlatPtr> sys$recvmsg(int sockfd, Userspace<struct msghdr*>, int flags);
     ErrorOr<FlatPtr> sys$getsockopt(Userspace<Syscall::SC_getsockopt_params const*>);
@@ -678,6 +687,10 @@ private:
     static ErrorOr<ProcessAndFirstThread> create_with_forked_name(UserID, GroupID, ProcessID ppid, bool is_kernel_process, RefPtr<Custody> current_directory = nullptr, RefPtr<Custody> executable = nullptr, RefPtr<TTY> = nullptr, Process* fork_parent = nullptr);
     static ErrorOr<ProcessAndFirstThread> create(StringView name, UserID, GroupID, ProcessID ppid, bool is_kernel_process, RefPtr<Custody> current_directory = nullptr, RefPtr<Custody> executable = nullptr, RefPtr<TTY> = nullptr, Process* fork_parent = nullptr);
     ErrorOr<NonnullRefPtr<Thread>> attach_resources(NonnullOwnPtr<Memory::AddressSpace>&&, Process* fork_parent);
+
+    // Creates a child that inherits everything from this process that fork(2) says it should.
+    // The child's address space and register state are left to `set_up_child`.
+    ErrorOr<ProcessID> create_child_process(Function<ErrorOr<void>(Process& child, Thread& child_first_thread)> set_up_child);
     static ProcessID allocate_pid();
 
     void kill_threads_except_self();
@@ -718,6 +731,7 @@ private:
     ErrorOr<FlatPtr> read_impl(int fd, Userspace<u8*> buffer, size_t size);
     ErrorOr<FlatPtr> pread_impl(int fd, Userspace<u8*>, size_t, off_t);
     ErrorOr<FlatPtr> readv_impl(int fd, Userspace<const struct iovec*> iov, int iov_count);
+    ErrorOr<FlatPtr> perform_io_ring_submission(IORingSubmission const&);
 
 public:
     ErrorOr<void> traverse_as_directory(FileSystemID, Function<ErrorOr<void>(FileSystem::DirectoryEntryView const&)> callback) const;
@@ -16,6 +16,7 @@
 #include <Kernel/Tasks/PerformanceManager.h>
 #include <Kernel/Tasks/Process.h>
 #include <Kernel/Tasks/Scheduler.h>
+#include <Kernel/Tasks/TraceBuffer.h>
 #include <Kernel/Time/TimeManagement.h>
 #include <Kernel/kstdio.h>
 
@@ -44,9 +45,29 @@ struct ThreadReadyQueues {
     u32 mask {};
     static constexpr size_t count = sizeof(mask) * 8;
     Array<ThreadReadyQueue, count> queues;
+    u32 thread_count { 0 };
+    u32 max_thread_count { 0 };
 };
 
-static Singleton<SpinlockProtected<ThreadReadyQueues, LockRank::None>> g_ready_queues;
+// Thread affinity masks are 32 bits wide, so we can never schedule on more processors than that.
+static constexpr size_t max_scheduler_processors = sizeof(u32) * 8;
+
+// Every processor has its own set of ready queues, so that scheduling decisions on one
+// processor don't have to serialize with those on all the others. Idle processors steal
+// work from the queues of busy ones.
+static Singleton<Array<SpinlockProtected<ThreadReadyQueues, LockRank::None>, max_scheduler_processors>> g_ready_queues;
+
+// Bit N is set if processor N has at least one thread in its ready queues. This lets
+// processors looking for work skip empty queues without taking their locks.
+static Atomic<u32> s_nonempty_ready_queues_mask { 0 };
+
+struct ProcessorSchedulingCounters {
+    Atomic<u64> context_switches { 0 };
+    Atomic<u64> threads_stolen { 0 };
+    Array<Atomic<u64>, scheduler_latency_histogram_bucket_count> wakeup_latency_histogram {};
+};
+
+static Array<ProcessorSchedulingCounters, max_scheduler_processors> s_processor_counters;
 
 static SpinlockProtected<TotalTimeScheduled, LockRank::None> g_total_time_scheduled {};
 
@@ -64,74 +85,133 @@ static inline u32 thread_priority_to_priority_index(u32 thread_priority)
     return priority_bucket;
 }
 
-Thread& Scheduler::pull_next_runnable_thread()
+static u32 ready_queue_cpu_for(Thread const& thread)
 {
-    auto affinity_mask = 1u << Processor::current_id();
-
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread& {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                thread.m_runnable_priority = -1;
-                ready_queue.thread_list.remove(thread);
-                if (ready_queue.thread_list.is_empty())
-                    ready_queues.mask &= ~(1u << priority);
-                // Mark it as active because we are using this thread. This is similar
-                // to comparing it with Processor::current_thread, but when there are
-                // multiple processors there's no easy way to check whether the thread
-                // is actually still needed. This prevents accidental finalization when
-                // a thread is no longer in Running state, but running on another core.
-
-                // We need to mark it active here so that this thread won't be
-                // scheduled on another core if it were to be queued before actually
-                // switching to it.
-                // FIXME: Figure out a better way maybe?
-                thread.set_active(true);
-                return thread;
-            }
-            priority_mask &= ~(1u << priority);
-        }
+    // Prefer the processor the thread last ran on, as its caches are most likely still warm.
+    // Otherwise, fall back to the first processor the thread is allowed to run on.
+    auto affinity = thread.affinity();
+    VERIFY(affinity != 0);
+    auto last_cpu = thread.cpu();
+    if (last_cpu < max_scheduler_processors && (affinity & (1u << last_cpu)))
+        return last_cpu;
+    return bit_scan_forward(affinity) - 1;
+}
 
-        auto* idle_thread = Processor::idle_thread();
-        idle_thread->set_active(true);
-        return *idle_thread;
-    });
+static u64 wakeup_latency_clock()
+{
+    // NOTE: The scheduler time source may be counting TSC ticks, but we want latencies in real time.
+    return (u64)TimeManagement::the().monotonic_time(TimePrecision::Precise).nanoseconds();
 }
 
-Thread* Scheduler::peek_next_runnable_thread()
+size_t Scheduler::latency_histogram_bucket_for(u64 latency_in_ns)
 {
-    auto affinity_mask = 1u << Processor::current_id();
-
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread* {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
+    auto latency_in_us = latency_in_ns / 1000;
+    if (latency_in_us == 0)
+        return 0;
+    size_t bucket = sizeof(latency_in_us) * 8 - 1 - count_leading_zeroes(latency_in_us);
+    return min(bucket, scheduler_latency_histogram_bucket_count - 1);
+}
+
+void Scheduler::record_wakeup_latency(Thread& thread, u32 cpu)
+{
+    auto now = wakeup_latency_clock();
+    auto latency = now > thread.m_runnable_since ? now - thread.m_runnable_since : 0;
+    auto bucket = latency_histogram_bucket_for(latency);
+    s_processor_counters[cpu].wakeup_latency_histogram[bucket].fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+    thread.m_wakeup_latency_histogram[bucket].fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+}
+
+Thread* Scheduler::find_runnable_thread(ThreadReadyQueues& ready_queues, u32 cpu, u32 affinity_mask, TakeThread take_thread)
+{
+    auto priority_mask = ready_queues.mask;
+    while (priority_mask != 0) {
+        auto priority = bit_scan_forward(priority_mask);
+        VERIFY(priority > 0);
+        auto& ready_queue = ready_queues.queues[--priority];
+        for (auto& thread : ready_queue.thread_list) {
+            VERIFY(thread.m_runnable_priority == (int)priority);
+            VERIFY(thread.m_runnable_cpu == cpu);
+            if (thread.is_active())
+                continue;
+            if (!(thread.affinity() & affinity_mask))
+                continue;
+            if (take_thread == TakeThread::No)
                 return &thread;
+            thread.m_runnable_priority = -1;
+            ready_queue.thread_list.remove(thread);
+            --ready_queues.thread_count;
+            if (ready_queue.thread_list.is_empty()) {
+                ready_queues.mask &= ~(1u << priority);
+                if (ready_queues.mask == 0)
+                    s_nonempty_ready_queues_mask.fetch_and(~(1u << cpu), AK::MemoryOrder::memory_order_relaxed);
             }
-            priority_mask &= ~(1u << priority);
+            // Mark it as active because we are using this thread. This is similar
+            // to comparing it with Processor::current_thread, but when there are
+            // multiple processors there's no easy way to check whether the thread
+            // is actually still needed. This prevents accidental finalization when
+            // a thread is no longer in Running state, but running on another core.
+
+            // We need to mark it active here so that this thread won't be
+            // scheduled on another core if it were to be queued before actually
+            // switching to it.
+            // FIXME: Figure out a better way maybe?
+            thread.set_active(true);
+            return &thread;
         }
+        priority_mask &= ~(1u << priority);
+    }
+    return nullptr;
+}
 
-        // Unlike in pull_next_runnable_thread() we don't want to fall back to
-        // the idle thread. We just want to see if we have any other thread ready
-        // to be scheduled.
-        return nullptr;
-    });
+Thread* Scheduler::find_runnable_thread_for_current_processor(TakeThread take_thread)
+{
+    auto current_cpu = Processor::current_id();
+    auto affinity_mask = 1u << current_cpu;
+
+    // Always look at our own queues first.
+    if (auto* thread = (*g_ready_queues)[current_cpu].with([&](auto& ready_queues) { return find_runnable_thread(ready_queues, current_cpu, affinity_mask, take_thread); })) {
+        if (take_thread == TakeThread::Yes)
+            record_wakeup_latency(*thread, current_cpu);
+        return thread;
+    }
+
+    // Nothing to do locally, try to steal work from other processors. We start with our
+    // neighbour so that idle processors don't all pile onto the same victim.
+    auto victims_mask = s_nonempty_ready_queues_mask.load(AK::MemoryOrder::memory_order_relaxed) & ~affinity_mask;
+    for (u32 offset = 1; victims_mask != 0 && offset < max_scheduler_processors; offset++) {
+        auto cpu = (current_cpu + offset) % max_scheduler_processors;
+        if (!(victims_mask & (1u << cpu)))
+            continue;
+        victims_mask &= ~(1u << cpu);
+        auto* thread = (*g_ready_queues)[cpu].with([&](auto& ready_queues) { return find_runnable_thread(ready_queues, cpu, affinity_mask, take_thread); });
+        if (thread) {
+            dbgln_if(SCHEDULER_DEBUG, "Scheduler[{}]: {} {} from processor {}", current_cpu, take_thread == TakeThread::Yes ? "Stealing"sv : "Could steal"sv, *thread, cpu);
+            if (take_thread == TakeThread::Yes) {
+                s_processor_counters[current_cpu].threads_stolen.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+                record_wakeup_latency(*thread, current_cpu);
+            }
+            return thread;
+        }
+    }
+    return nullptr;
+}
+
+Thread& Scheduler::pull_next_runnable_thread()
+{
+    if (auto* thread = find_runnable_thread_for_current_processor(TakeThread::Yes))
+        return *thread;
+
+    auto* idle_thread = Processor::idle_thread();
+    idle_thread->set_active(true);
+    return *idle_thread;
+}
+
+Thread* Scheduler::peek_next_runnable_thread()
+{
+    // Unlike in pull_next_runnable_thread() we don't want to fall back to
+    // the idle thread. We just want to see if we have any other thread ready
+    // to be scheduled.
+    return find_runnable_thread_for_current_processor(TakeThread::No);
 }
 
 bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
@@ -139,22 +219,30 @@ bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
     if (thread.is_idle_thread())
         return true;
 
-    return g_ready_queues->with([&](auto& ready_queues) {
+    if (check_affinity && !(thread.affinity() & (1 << Processor::current_id())))
+        return false;
+
+    // NOTE: m_runnable_cpu is only ever changed while holding g_scheduler_lock,
+    //       so it's safe to read before locking the ready queues it names.
+    VERIFY(g_scheduler_lock.is_locked_by_current_processor());
+    auto cpu = thread.m_runnable_cpu;
+    return (*g_ready_queues)[cpu].with([&](auto& ready_queues) {
         auto priority = thread.m_runnable_priority;
         if (priority < 0) {
             VERIFY(!thread.m_ready_queue_node.is_in_list());
             return false;
         }
 
-        if (check_affinity && !(thread.affinity() & (1 << Processor::current_id())))
-            return false;
-
         VERIFY(ready_queues.mask & (1u << priority));
         auto& ready_queue = ready_queues.queues[priority];
         thread.m_runnable_priority = -1;
         ready_queue.thread_list.remove(thread);
-        if (ready_queue.thread_list.is_empty())
+        --ready_queues.thread_count;
+        if (ready_queue.thread_list.is_empty()) {
             ready_queues.mask &= ~(1u << priority);
+            if (ready_queues.mask == 0)
+                s_nonempty_ready_queues_mask.fetch_and(~(1u << cpu), AK::MemoryOrder::memory_order_relaxed);
+        }
         return true;
     });
 }
@@ -165,16 +253,24 @@ void Scheduler::enqueue_runnable_thread(Thread& thread)
     if (thread.is_idle_thread())
         return;
     auto priority = thread_priority_to_priority_index(thread.priority());
+    auto cpu = ready_queue_cpu_for(thread);
+    thread.m_runnable_since = wakeup_latency_clock();
 
-    g_ready_queues->with([&](auto& ready_queues) {
+    (*g_ready_queues)[cpu].with([&](auto& ready_queues) {
         VERIFY(thread.m_runnable_priority < 0);
         thread.m_runnable_priority = (int)priority;
+        thread.m_runnable_cpu = cpu;
         VERIFY(!thread.m_ready_queue_node.is_in_list());
         auto& ready_queue = ready_queues.queues[priority];
         bool was_empty = ready_queue.thread_list.is_empty();
         ready_queue.thread_list.append(thread);
-        if (was_empty)
+        if (++ready_queues.thread_count > ready_queues.max_thread_count)
+            ready_queues.max_thread_count = ready_queues.thread_count;
+        if (was_empty) {
+            if (ready_queues.mask == 0)
+                s_nonempty_ready_queues_mask.fetch_or(1u << cpu, AK::MemoryOrder::memory_order_relaxed);
             ready_queues.mask |= (1u << priority);
+        }
     });
 }
 
@@ -267,6 +363,8 @@ void Scheduler::context_switch(Thread* thread)
     if (from_thread == thread)
         return;
 
+    s_processor_counters[Processor::current_id()].context_switches.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+
     // If the last process hasn't blocked (still marked as running),
     // mark it as runnable for the next round, unless it's supposed
     // to be stopped, in which case just mark it as such.
@@ -293,6 +391,7 @@ void Scheduler::context_switch(Thread* thread)
     thread->set_state(Thread::State::Running);
 
     PerformanceManager::add_context_switch_perf_event(*from_thread, *thread);
+    TraceBuffer::record(TraceEventType::ContextSwitch, thread->pid().value(), thread->tid().value());
 
     proc.switch_context(from_thread, thread);
 
@@ -485,7 +584,9 @@ void Scheduler::idle_loop(void*)
 
     for (;;) {
         proc.idle_begin();
+        TimeManagement::the().enter_tickless_idle();
         proc.wait_for_interrupt();
+        TimeManagement::the().leave_tickless_idle();
         proc.idle_end();
         VERIFY_INTERRUPTS_ENABLED();
         yield();
@@ -508,6 +609,22 @@ TotalTimeScheduled Scheduler::get_total_time_scheduled()
     return g_total_time_scheduled.with([&](auto& total_time_scheduled) { return total_time_scheduled; });
 }
 
+SchedulerProcessorStatistics Scheduler::processor_statistics(u32 cpu)
+{
+    VERIFY(cpu < max_scheduler_processors);
+    SchedulerProcessorStatistics statistics;
+    (*g_ready_queues)[cpu].with([&](auto& ready_queues) {
+        statistics.ready_queue_depth = ready_queues.thread_count;
+        statistics.max_ready_queue_depth = ready_queues.max_thread_count;
+    });
+    auto& counters = s_processor_counters[cpu];
+    statistics.context_switches = counters.context_switches.load(AK::MemoryOrder::memory_order_relaxed);
+    statistics.threads_stolen = counters.threads_stolen.load(AK::MemoryOrder::memory_order_relaxed);
+    for (size_t i = 0; i < scheduler_latency_histogram_bucket_count; ++i)
+        statistics.wakeup_latency_histogram[i] = counters.wakeup_latency_histogram[i].load(AK::MemoryOrder::memory_order_relaxed);
+    return statistics;
+}
+
 void dump_thread_list(bool with_stack_traces)
 {
     dbgln("Scheduler thread list for processor {}:", Processor::current_id());
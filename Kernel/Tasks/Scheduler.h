@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/Assertions.h>
 #include <AK/Function.h>
 #include <AK/IntrusiveList.h>
@@ -24,11 +25,27 @@ extern WaitQueue* g_finalizer_wait_queue;
 extern Atomic<bool> g_finalizer_has_work;
 extern RecursiveSpinlock<LockRank::None> g_scheduler_lock;
 
+struct ThreadReadyQueues;
+
 struct TotalTimeScheduled {
     u64 total { 0 };
     u64 total_kernel { 0 };
 };
 
+// Bucket N of a wakeup latency histogram counts threads that waited between 2^N and 2^(N+1)
+// microseconds in a ready queue before getting to run. The first bucket also counts
+// everything below one microsecond, and the last one everything above its lower bound.
+static constexpr size_t scheduler_latency_histogram_bucket_count = 16;
+using SchedulerLatencyHistogram = Array<u64, scheduler_latency_histogram_bucket_count>;
+
+struct SchedulerProcessorStatistics {
+    u64 context_switches { 0 };
+    u64 threads_stolen { 0 };
+    u32 ready_queue_depth { 0 };
+    u32 max_ready_queue_depth { 0 };
+    SchedulerLatencyHistogram wakeup_latency_histogram {};
+};
+
 class Scheduler {
 public:
     static void initialize();
@@ -55,6 +72,17 @@ public:
     static bool is_initialized();
     static TotalTimeScheduled get_total_time_scheduled();
     static void add_time_scheduled(u64, bool);
+    static size_t latency_histogram_bucket_for(u64 latency_in_ns);
+    static SchedulerProcessorStatistics processor_statistics(u32 cpu);
+
+private:
+    enum class TakeThread {
+        No,
+        Yes,
+    };
+    static Thread* find_runnable_thread(ThreadReadyQueues&, u32 cpu, u32 affinity_mask, TakeThread);
+    static Thread* find_runnable_thread_for_current_processor(TakeThread);
+    static void record_wakeup_latency(Thread&, u32 cpu);
 };
 
 }
@@ -34,6 +34,8 @@ namespace Kernel {
 
 static Singleton<SpinlockProtected<Thread::GlobalList, LockRank::None>> s_list;
 
+KMALLOC_DEFINE_SLAB_CACHE(Thread);
+
 SpinlockProtected<Thread::GlobalList, LockRank::None>& Thread::all_instances()
 {
     return *s_list;
@@ -21,6 +21,7 @@
 #include <Kernel/API/POSIX/select.h>
 #include <Kernel/API/POSIX/signal_numbers.h>
 #include <Kernel/Arch/ArchSpecificThreadData.h>
+#include <Kernel/Arch/PerformanceCounters.h>
 #include <Kernel/Arch/RegisterState.h>
 #include <Kernel/Arch/ThreadRegisters.h>
 #include <Kernel/Debug.h>
@@ -59,6 +60,7 @@ class Thread
     , public LockWeakable<Thread> {
     AK_MAKE_NONCOPYABLE(Thread);
     AK_MAKE_NONMOVABLE(Thread);
+    MAKE_SLAB_CACHE_ALLOCATED(Thread);
 
     friend class Mutex;
     friend class Process;
@@ -82,7 +84,16 @@ public:
     ProcessID pid() const;
 
     void set_priority(u32 p) { m_priority = p; }
-    u32 priority() const { return m_priority; }
+    u32 priority() const { return max(m_priority, m_priority_boost.load(AK::MemoryOrder::memory_order_relaxed)); }
+
+    // Priority inheritance: a thread blocked on a PI futex owned by this thread lends us its priority until we unlock it.
+    void boost_priority(u32 priority)
+    {
+        u32 current_boost = m_priority_boost.load(AK::MemoryOrder::memory_order_relaxed);
+        while (current_boost < priority && !m_priority_boost.compare_exchange_strong(current_boost, priority, AK::MemoryOrder::memory_order_relaxed))
+            ;
+    }
+    void clear_priority_boost() { m_priority_boost.store(0, AK::MemoryOrder::memory_order_relaxed); }
 
     void detach()
     {
@@ -766,6 +777,13 @@ public:
 
     void did_schedule() { ++m_times_scheduled; }
     u32 times_scheduled() const { return m_times_scheduled; }
+    SchedulerLatencyHistogram wakeup_latency_histogram() const
+    {
+        SchedulerLatencyHistogram histogram {};
+        for (size_t i = 0; i < histogram.size(); ++i)
+            histogram[i] = m_wakeup_latency_histogram[i].load(AK::MemoryOrder::memory_order_relaxed);
+        return histogram;
+    }
 
     void resume_from_stopped();
 
@@ -1062,6 +1080,8 @@ public:
     bool is_profiling_suppressed() const { return m_is_profiling_suppressed; }
     void set_profiling_suppressed() { m_is_profiling_suppressed = true; }
 
+    PerformanceCounterValues& performance_counter_baseline() { return m_performance_counter_baseline; }
+
     bool is_promise_violation_pending() const { return m_is_promise_violation_pending; }
     void set_promise_violation_pending(bool value) { m_is_promise_violation_pending = value; }
 
@@ -1094,6 +1114,9 @@ private:
 
     IntrusiveListNode<Thread> m_process_thread_list_node;
     int m_runnable_priority { -1 };
+    u32 m_runnable_cpu { 0 };
+    u64 m_runnable_since { 0 };
+    Array<Atomic<u32>, scheduler_latency_histogram_bucket_count> m_wakeup_latency_histogram {};
 
     friend class WaitQueue;
 
@@ -1226,6 +1249,7 @@ private:
     State m_state { Thread::State::Invalid };
     SpinlockProtected<Name, LockRank::None> m_name;
     u32 m_priority { THREAD_PRIORITY_NORMAL };
+    Atomic<u32> m_priority_boost { 0 };
 
     State m_stop_state { Thread::State::Invalid };
 
@@ -1241,6 +1265,7 @@ private:
     NonnullRefPtr<Timer> const m_block_timer;
 
     bool m_is_profiling_suppressed { false };
+    PerformanceCounterValues m_performance_counter_baseline;
 
     void yield_and_release_relock_big_lock();
 
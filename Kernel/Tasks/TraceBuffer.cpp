@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/API/SyscallString.h>
+#include <Kernel/Arch/Processor.h>
+#include <Kernel/Library/KBufferBuilder.h>
+#include <Kernel/Library/ScopedCritical.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/Thread.h>
+#include <Kernel/Tasks/TraceBuffer.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+static_assert(is_power_of_two(TraceBuffer::events_per_processor));
+
+struct ProcessorTraceRing {
+    Atomic<u64> next_index { 0 };
+    TraceEvent* events { nullptr };
+};
+
+static Array<ProcessorTraceRing, MAX_CPU_COUNT> s_rings;
+Atomic<bool> TraceBuffer::s_enabled { false };
+
+UNMAP_AFTER_INIT void TraceBuffer::initialize()
+{
+    for (u32 cpu = 0; cpu < Processor::count(); ++cpu) {
+        auto* events = new (nothrow) TraceEvent[events_per_processor];
+        if (!events) {
+            dmesgln("TraceBuffer: Failed to allocate the trace ring for CPU #{}", cpu);
+            return;
+        }
+        s_rings[cpu].events = events;
+    }
+    set_enabled(true);
+}
+
+void TraceBuffer::record_slow(TraceEventType type, FlatPtr arg1, FlatPtr arg2, FlatPtr arg3)
+{
+    // Stay on this processor while writing to its ring. Interrupts may still record
+    // events in between, so the slot is claimed atomically.
+    ScopedCritical critical;
+    auto& ring = s_rings[Processor::current_id()];
+    if (!ring.events)
+        return;
+
+    auto index = ring.next_index.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+    auto& event = ring.events[index & (events_per_processor - 1)];
+    event.sequence.store(0, AK::MemoryOrder::memory_order_relaxed);
+    AK::atomic_thread_fence(AK::MemoryOrder::memory_order_release);
+
+    auto* current_thread = Thread::current();
+    event.timestamp = TimeManagement::scheduler_current_time();
+    event.pid = current_thread ? current_thread->pid().value() : 0;
+    event.tid = current_thread ? current_thread->tid().value() : 0;
+    event.type = type;
+    event.args[0] = arg1;
+    event.args[1] = arg2;
+    event.args[2] = arg3;
+    event.sequence.store(index + 1, AK::MemoryOrder::memory_order_release);
+}
+
+static StringView to_string(TraceEventType type)
+{
+    switch (type) {
+    case TraceEventType::SyscallEnter:
+        return "syscall_enter"sv;
+    case TraceEventType::SyscallExit:
+        return "syscall_exit"sv;
+    case TraceEventType::PageFault:
+        return "page_fault"sv;
+    case TraceEventType::ContextSwitch:
+        return "context_switch"sv;
+    case TraceEventType::BlockRequestStart:
+        return "block_request_start"sv;
+    case TraceEventType::DeviceRequestComplete:
+        return "device_request_complete"sv;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+ErrorOr<void> TraceBuffer::to_json(KBufferBuilder& builder)
+{
+    auto object = TRY(JsonObjectSerializer<>::try_create(builder));
+    TRY(object.add("enabled"sv, is_enabled()));
+    // 0 if the frequency of the scheduler clock is unknown.
+    TRY(object.add("timestamp_frequency"sv, TimeManagement::scheduler_current_time_frequency()));
+
+    auto array = TRY(object.add_array("events"sv));
+    for (u32 cpu = 0; cpu < Processor::count(); ++cpu) {
+        auto& ring = s_rings[cpu];
+        if (!ring.events)
+            continue;
+
+        auto end = ring.next_index.load(AK::MemoryOrder::memory_order_acquire);
+        auto start = end > events_per_processor ? end - events_per_processor : 0;
+        for (auto index = start; index < end; ++index) {
+            auto& slot = ring.events[index & (events_per_processor - 1)];
+            if (slot.sequence.load(AK::MemoryOrder::memory_order_acquire) != index + 1)
+                continue;
+            auto timestamp = slot.timestamp;
+            auto pid = slot.pid;
+            auto tid = slot.tid;
+            auto type = slot.type;
+            FlatPtr args[3] = { slot.args[0], slot.args[1], slot.args[2] };
+            // Skip the event if it was overwritten while we copied it.
+            AK::atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
+            if (slot.sequence.load(AK::MemoryOrder::memory_order_relaxed) != index + 1)
+                continue;
+
+            auto event_object = TRY(array.add_object());
+            TRY(event_object.add("cpu"sv, cpu));
+            TRY(event_object.add("timestamp"sv, timestamp));
+            TRY(event_object.add("pid"sv, pid));
+            TRY(event_object.add("tid"sv, tid));
+            TRY(event_object.add("type"sv, to_string(type)));
+            switch (type) {
+            case TraceEventType::SyscallEnter:
+                TRY(event_object.add("syscall"sv, Syscall::to_string(static_cast<Syscall::Function>(args[0]))));
+                TRY(event_object.add("arg1"sv, static_cast<u64>(args[1])));
+                break;
+            case TraceEventType::SyscallExit:
+                TRY(event_object.add("syscall"sv, Syscall::to_string(static_cast<Syscall::Function>(args[0]))));
+                TRY(event_object.add("result"sv, static_cast<i64>(args[1])));
+                break;
+            case TraceEventType::PageFault:
+                TRY(event_object.add("address"sv, static_cast<u64>(args[0])));
+                TRY(event_object.add("ip"sv, static_cast<u64>(args[1])));
+                break;
+            case TraceEventType::ContextSwitch:
+                TRY(event_object.add("next_pid"sv, static_cast<u64>(args[0])));
+                TRY(event_object.add("next_tid"sv, static_cast<u64>(args[1])));
+                break;
+            case TraceEventType::BlockRequestStart:
+                TRY(event_object.add("request"sv, static_cast<u64>(args[0])));
+                TRY(event_object.add("block_index"sv, static_cast<u64>(args[1])));
+                TRY(event_object.add("block_count"sv, static_cast<u64>(args[2])));
+                break;
+            case TraceEventType::DeviceRequestComplete:
+                TRY(event_object.add("request"sv, static_cast<u64>(args[0])));
+                TRY(event_object.add("result"sv, static_cast<u64>(args[1])));
+                break;
+            }
+            TRY(event_object.finish());
+        }
+    }
+    TRY(array.finish());
+    TRY(object.finish());
+    return {};
+}
+
+}
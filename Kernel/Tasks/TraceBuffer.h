@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Error.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+class KBufferBuilder;
+
+enum class TraceEventType : u32 {
+    SyscallEnter,
+    SyscallExit,
+    PageFault,
+    ContextSwitch,
+    BlockRequestStart,
+    DeviceRequestComplete,
+};
+
+struct TraceEvent {
+    Atomic<u64> sequence { 0 }; // index + 1 once the event is fully written
+    u64 timestamp;              // in units of TimeManagement::scheduler_current_time()
+    u32 pid;
+    u32 tid;
+    TraceEventType type;
+    FlatPtr args[3];
+};
+
+// A cheap, always-on trace of kernel activity, kept in a fixed-size ring per processor.
+// Recording never takes a lock: each processor only ever writes to its own ring.
+class TraceBuffer {
+public:
+    static constexpr size_t events_per_processor = 2048;
+
+    static void initialize();
+
+    static bool is_enabled() { return s_enabled.load(AK::MemoryOrder::memory_order_relaxed); }
+    static void set_enabled(bool enabled) { s_enabled.store(enabled, AK::MemoryOrder::memory_order_relaxed); }
+
+    static void record(TraceEventType type, FlatPtr arg1 = 0, FlatPtr arg2 = 0, FlatPtr arg3 = 0)
+    {
+        if (is_enabled())
+            record_slow(type, arg1, arg2, arg3);
+    }
+
+    static ErrorOr<void> to_json(KBufferBuilder&);
+
+private:
+    static void record_slow(TraceEventType, FlatPtr arg1, FlatPtr arg2, FlatPtr arg3);
+
+    static Atomic<bool> s_enabled;
+};
+
+}
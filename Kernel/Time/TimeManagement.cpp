@@ -65,6 +65,17 @@ u64 TimeManagement::scheduler_current_time()
     return s_scheduler_current_time();
 }
 
+u64 TimeManagement::scheduler_current_time_frequency()
+{
+    if (s_scheduler_current_time == current_time_monotonic)
+        return 1'000'000'000;
+#if ARCH(X86_64)
+    return the().m_tsc_frequency;
+#else
+    return 0;
+#endif
+}
+
 ErrorOr<void> TimeManagement::validate_clock_id(clockid_t clock_id)
 {
     switch (clock_id) {
@@ -193,6 +204,7 @@ UNMAP_AFTER_INIT void TimeManagement::initialize([[maybe_unused]] u32 cpu)
             if (auto* apic_timer = APIC::the().initialize_timers(*s_the->m_system_timer)) {
                 dmesgln("Duration: Using APIC timer as system timer");
                 s_the->set_system_timer(*apic_timer);
+                s_the->m_tsc_frequency = apic_timer->tsc_frequency();
             }
         }
     } else {
@@ -549,9 +561,17 @@ void TimeManagement::increment_time_since_boot()
 
 void TimeManagement::system_timer_tick(RegisterState const& regs)
 {
+    auto* current_thread = Processor::current_thread();
+    bool is_idle = current_thread && current_thread->is_idle_thread();
+    if (is_idle) {
+        // Go back to ticking, in case the one-shot timer fired before the idle loop started waiting.
+        the().leave_tickless_idle();
+    }
+
     if (Processor::current_in_irq() <= 1) {
-        // Don't expire timers while handling IRQs
-        TimerQueue::the().fire();
+        // Don't expire timers while handling IRQs.
+        // An idle processor can afford to query the precise time, which lets timers expire between ticks.
+        TimerQueue::the().fire(is_idle ? TimePrecision::Precise : TimePrecision::Coarse);
     }
     Scheduler::timer_tick(regs);
 }
@@ -574,12 +594,51 @@ bool TimeManagement::disable_profile_timer()
     return true;
 }
 
+void TimeManagement::enter_tickless_idle()
+{
+#if ARCH(X86_64)
+    // The bootstrap processor keeps ticking, as it drives timekeeping and wakes up the others.
+    if (Processor::is_bootstrap_processor() || !APIC::initialized())
+        return;
+    auto* apic_timer = APIC::the().get_timer();
+    if (!apic_timer)
+        return;
+
+    // Instead of ticking periodically, only wake up for the next timer that is due.
+    // Newly runnable threads wake us up with an IPI, but don't stay asleep forever in case we miss one.
+    static constexpr auto maximum_idle_duration = Duration::from_milliseconds(100);
+    auto idle_duration = TimerQueue::the().time_until_next_timer_due().value_or(maximum_idle_duration);
+
+    InterruptDisabler disabler;
+    apic_timer->enable_local_timer_one_shot(min(idle_duration, maximum_idle_duration));
+#endif
+}
+
+void TimeManagement::leave_tickless_idle()
+{
+#if ARCH(X86_64)
+    if (Processor::is_bootstrap_processor() || !APIC::initialized())
+        return;
+    if (auto* apic_timer = APIC::the().get_timer()) {
+        InterruptDisabler disabler;
+        apic_timer->enable_local_timer();
+    }
+#endif
+}
+
 void TimeManagement::update_time_page()
 {
     auto& page = time_page();
     u32 update_iteration = AK::atomic_fetch_add(&page.update2, 1u, AK::MemoryOrder::memory_order_acquire);
     page.clocks[CLOCK_REALTIME_COARSE] = m_epoch_time.to_timespec();
     page.clocks[CLOCK_MONOTONIC_COARSE] = monotonic_time(TimePrecision::Coarse).time_since_start({}).to_timespec();
+#if ARCH(X86_64)
+    if (m_tsc_frequency != 0) {
+        page.tsc_frequency = m_tsc_frequency;
+        page.tsc_at_update = read_tsc();
+        page.nanoseconds_per_tick = 1'000'000'000ull / m_time_ticks_per_second;
+    }
+#endif
     AK::atomic_store(&page.update1, update_iteration + 1u, AK::MemoryOrder::memory_order_release);
 }
 
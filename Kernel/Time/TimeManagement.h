@@ -40,6 +40,8 @@ public:
     static TimeManagement& the();
 
     static u64 scheduler_current_time();
+    // Units of scheduler_current_time() per second, or 0 if unknown.
+    static u64 scheduler_current_time_frequency();
 
     static ErrorOr<void> validate_clock_id(clockid_t);
     // This API cannot distinguish returned time types; prefer the clock-specific functions instead.
@@ -65,6 +67,10 @@ public:
     bool enable_profile_timer();
     bool disable_profile_timer();
 
+    // Called by the idle loop of each processor around waiting for an interrupt.
+    void enter_tickless_idle();
+    void leave_tickless_idle();
+
     u64 uptime_ms() const;
     static UnixDateTime now();
 
@@ -109,6 +115,9 @@ private:
     Atomic<u32> m_update2 { 0 };
 
     u32 m_time_ticks_per_second { 0 }; // may be different from interrupts/second (e.g. hpet)
+#if ARCH(X86_64)
+    u64 m_tsc_frequency { 0 }; // only set if the TSC is invariant
+#endif
     SetOnce m_can_query_precise_time;
     bool m_updating_time { false }; // may only be accessed from the BSP!
 
@@ -174,7 +174,7 @@ void TimerQueue::remove_timer_locked(Queue& queue, Timer& timer)
     timer.unref();
 }
 
-void TimerQueue::fire()
+void TimerQueue::fire(TimePrecision precision)
 {
     SpinlockLocker lock(g_timerqueue_lock);
 
@@ -183,7 +183,7 @@ void TimerQueue::fire()
         VERIFY(timer);
         VERIFY(queue.next_timer_due == timer->m_expires);
 
-        while (timer && timer->now(true) > timer->m_expires) {
+        while (timer && timer->now(precision == TimePrecision::Coarse) >= timer->m_expires) {
             queue.list.remove(*timer);
 
             m_timers_executing.append(*timer);
@@ -219,6 +219,25 @@ void TimerQueue::fire()
         fire_timers(m_timer_queue_realtime);
 }
 
+Optional<Duration> TimerQueue::time_until_next_timer_due()
+{
+    SpinlockLocker lock(g_timerqueue_lock);
+
+    Optional<Duration> time_until_due;
+    auto check_queue = [&](Queue& queue, clockid_t clock_id) {
+        if (queue.list.is_empty())
+            return;
+        auto now = TimeManagement::the().current_time(clock_id);
+        auto remaining = queue.next_timer_due > now ? queue.next_timer_due - now : Duration::zero();
+        if (!time_until_due.has_value() || remaining < *time_until_due)
+            time_until_due = remaining;
+    };
+
+    check_queue(m_timer_queue_monotonic, CLOCK_MONOTONIC);
+    check_queue(m_timer_queue_realtime, CLOCK_REALTIME);
+    return time_until_due;
+}
+
 void TimerQueue::update_next_timer_due(Queue& queue)
 {
     VERIFY(g_timerqueue_lock.is_locked());
@@ -9,6 +9,7 @@
 #include <AK/AtomicRefCounted.h>
 #include <AK/Function.h>
 #include <AK/IntrusiveList.h>
+#include <AK/Optional.h>
 #include <AK/OwnPtr.h>
 #include <AK/Time.h>
 #include <Kernel/Library/NonnullLockRefPtr.h>
@@ -90,7 +91,8 @@ public:
     TimerId add_timer(NonnullRefPtr<Timer>&&);
     bool add_timer_without_id(NonnullRefPtr<Timer>, clockid_t, Duration const&, Function<void()>&&);
     bool cancel_timer(Timer& timer, bool* was_in_use = nullptr);
-    void fire();
+    void fire(TimePrecision = TimePrecision::Coarse);
+    Optional<Duration> time_until_next_timer_due();
 
 private:
     struct Queue {
@@ -18,6 +18,7 @@
 #include <AK/TypeCasts.h>
 #include <Ladybird/Qt/TabBar.h>
 #include <Ladybird/Utilities.h>
+#include <LibCore/StandardPaths.h>
 #include <LibWeb/CSS/PreferredColorScheme.h>
 #include <LibWeb/Loader/UserAgent.h>
 #include <LibWebView/CookieJar.h>
@@ -365,6 +366,23 @@ BrowserWindow::BrowserWindow(Vector<URL::URL> const& initial_urls, WebView::Cook
         }
     });
 
+    auto* record_rendering_trace_action = new QAction("Record Rendering Trace", this);
+    record_rendering_trace_action->setCheckable(true);
+    debug_menu->addAction(record_rendering_trace_action);
+    QObject::connect(record_rendering_trace_action, &QAction::triggered, this, [this, record_rendering_trace_action] {
+        if (record_rendering_trace_action->isChecked()) {
+            debug_request("record-rendering-trace", "on");
+            return;
+        }
+        debug_request("record-rendering-trace", "off");
+        if (m_current_tab) {
+            auto rendering_trace_path = m_current_tab->view().dump_rendering_trace(Core::StandardPaths::tempfile_directory());
+            warnln("\033[33;1mDumped rendering trace into {}"
+                   "\033[0m",
+                rendering_trace_path);
+        }
+    });
+
     auto* clear_cache_action = new QAction("Clear &Cache", this);
     clear_cache_action->setShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_C));
     clear_cache_action->setIcon(load_icon_from_uri("resource://icons/browser/clear-cache.png"sv));
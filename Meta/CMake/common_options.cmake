@@ -23,6 +23,7 @@ serenity_option(INCLUDE_WASM_SPEC_TESTS OFF CACHE BOOL "Download and include the
 serenity_option(INCLUDE_FLAC_SPEC_TESTS OFF CACHE BOOL "Download and include the FLAC spec testsuite")
 serenity_option(ENABLE_CACERT_DOWNLOAD ON CACHE BOOL "Enable download of cacert.pem at build time")
 serenity_option(ENABLE_ACCELERATED_GRAPHICS ON CACHE BOOL "Enable use of accelerated graphics APIs")
+serenity_option(ENABLE_LIBJS_POINTER_COMPRESSION OFF CACHE BOOL "Allocate the LibJS heap from a single 4 GiB reservation and store some cell pointers as 32-bit offsets into it")
 
 serenity_option(HACKSTUDIO_BUILD OFF CACHE BOOL "Automatically enabled when building from HackStudio")
 
@@ -561,10 +561,67 @@ void do_message_for_proxy(SourceGenerator message_generator, Endpoint const& end
     })~~~");
     };
 
+    auto do_implement_request_proxy = [&]() {
+        ByteString promise_type = "Empty";
+        if (message.outputs.size() == 1)
+            promise_type = message.outputs[0].type;
+        else if (!message.outputs.is_empty())
+            promise_type = message_name(endpoint.name, message.name, true);
+
+        message_generator.set("message.name", message.name);
+        message_generator.set("message.pascal_name", pascal_case(message.name));
+        message_generator.set("message.promise_type", promise_type);
+        message_generator.appendln(R"~~~(
+    NonnullRefPtr<Core::Promise<@message.promise_type@>> request_@message.name@()~~~");
+
+        for (size_t i = 0; i < message.inputs.size(); ++i) {
+            auto const& parameter = message.inputs[i];
+            auto argument_generator = message_generator.fork();
+            argument_generator.set("argument.type", parameter.type);
+            argument_generator.set("argument.name", parameter.name);
+            argument_generator.append("@argument.type@ @argument.name@");
+            if (i != message.inputs.size() - 1)
+                argument_generator.append(", ");
+        }
+
+        message_generator.append(R"~~~() {
+        return m_connection.template send_async<Messages::@endpoint.name@::@message.pascal_name@>()~~~");
+
+        for (size_t i = 0; i < message.inputs.size(); ++i) {
+            auto const& parameter = message.inputs[i];
+            auto argument_generator = message_generator.fork();
+            argument_generator.set("argument.name", parameter.name);
+            if (is_primitive_or_simple_type(parameter.type))
+                argument_generator.append("@argument.name@");
+            else
+                argument_generator.append("move(@argument.name@)");
+            if (i != message.inputs.size() - 1)
+                argument_generator.append(", ");
+        }
+
+        message_generator.append(R"~~~()->template map<@message.promise_type@>([](auto& response) {)~~~");
+        if (message.outputs.size() == 1) {
+            message_generator.set("output.name", message.outputs[0].name);
+            message_generator.append(R"~~~(
+            return response->take_@output.name@();)~~~");
+        } else if (!message.outputs.is_empty()) {
+            message_generator.append(R"~~~(
+            return move(*response);)~~~");
+        } else {
+            message_generator.append(R"~~~(
+            (void)response;
+            return Empty {};)~~~");
+        }
+        message_generator.appendln(R"~~~(
+        });
+    })~~~");
+    };
+
     do_implement_proxy(message.name, message.inputs, message.is_synchronous, false);
     if (message.is_synchronous) {
         do_implement_proxy(message.name, message.inputs, false, false);
         do_implement_proxy(message.name, message.inputs, true, true);
+        do_implement_request_proxy();
     }
 }
 
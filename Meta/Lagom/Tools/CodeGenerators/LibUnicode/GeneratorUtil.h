@@ -129,56 +129,76 @@ static constexpr Array<@type@, @size@ + 1> @name@ { {
 )~~~");
     }
 
+    // Rather than generating an array of spans (each of which would require a relocation when the
+    // library is loaded), all lists are flattened into a single array of values, and each list is
+    // located within that array by its offset.
     void generate(SourceGenerator& generator, StringView type, StringView name)
     requires(StorageTypeIsList<StorageType>)
     {
+        constexpr size_t max_values_per_row = 10;
+
+        size_t total_values = 0;
+        for (auto const& list : m_storage)
+            total_values += list.size();
+
         generator.set("type"sv, type);
         generator.set("name"sv, name);
+        generator.set("size"sv, ByteString::number(m_storage.size()));
+        generator.set("total_values"sv, ByteString::number(total_values));
 
-        for (size_t i = 0; i < m_storage.size(); ++i) {
-            auto const& list = m_storage[i];
-
-            generator.set("index"sv, ByteString::number(i));
-            generator.set("size"sv, ByteString::number(list.size()));
+        generator.append(R"~~~(
+static constexpr Array<@type@, @total_values@> @name@_values { {
+    )~~~");
 
-            generator.append(R"~~~(
-static constexpr Array<@type@, @size@> @name@@index@ { {)~~~");
+        size_t values_in_current_row = 0;
 
-            bool first = true;
+        for (auto const& list : m_storage) {
             for (auto const& value : list) {
-                generator.append(first ? " "sv : ", "sv);
-                generator.append(ByteString::formatted("{}", value));
-                first = false;
-            }
+                if (values_in_current_row++ > 0)
+                    generator.append(" ");
 
-            generator.append(" } };");
-        }
+                generator.append(ByteString::formatted("{},", value));
 
-        generator.set("size"sv, ByteString::number(m_storage.size()));
+                if (values_in_current_row == max_values_per_row) {
+                    values_in_current_row = 0;
+                    generator.append("\n    ");
+                }
+            }
+        }
 
         generator.append(R"~~~(
+} };
 
-static constexpr Array<ReadonlySpan<@type@>, @size@ + 1> @name@ { {
-    {})~~~");
-
-        constexpr size_t max_values_per_row = 10;
-        size_t values_in_current_row = 1;
-
-        for (size_t i = 0; i < m_storage.size(); ++i) {
-            if (values_in_current_row++ > 0)
-                generator.append(", ");
+static constexpr Array<u32, @size@ + 2> @name@_offsets { {
+    0, 0)~~~");
 
-            generator.set("index"sv, ByteString::number(i));
-            generator.append("@name@@index@.span()");
+        size_t offset = 0;
+        values_in_current_row = 2;
 
-            if (values_in_current_row == max_values_per_row) {
-                values_in_current_row = 0;
+        for (auto const& list : m_storage) {
+            if (values_in_current_row++ == max_values_per_row) {
+                values_in_current_row = 1;
                 generator.append(",\n    ");
+            } else {
+                generator.append(", ");
             }
+
+            offset += list.size();
+            generator.append(ByteString::number(offset));
         }
 
         generator.append(R"~~~(
 } };
+
+static constexpr struct {
+    constexpr ReadonlySpan<@type@> at(size_t index) const
+    {
+        auto offset = @name@_offsets.at(index);
+        return @name@_values.span().slice(offset, @name@_offsets.at(index + 1) - offset);
+    }
+
+    constexpr ReadonlySpan<@type@> operator[](size_t index) const { return at(index); }
+} @name@;
 )~~~");
     }
 
@@ -427,6 +427,42 @@ TEST_CASE(find_copy_in_seekback)
     }
 }
 
+TEST_CASE(copy_from_seekback)
+{
+    auto circular_buffer = MUST(CircularBuffer::create_empty(64));
+
+    {
+        auto written_bytes = circular_buffer.write("abcdefghij"sv.bytes());
+        EXPECT_EQ(written_bytes, 10ul);
+    }
+
+    {
+        // A copy that is far enough back to go a word at a time.
+        auto copied_bytes = TRY_OR_FAIL(circular_buffer.copy_from_seekback(10, 19));
+        EXPECT_EQ(copied_bytes, 19ul);
+    }
+
+    {
+        // A copy that overlaps itself, repeating the last three bytes.
+        auto copied_bytes = TRY_OR_FAIL(circular_buffer.copy_from_seekback(3, 11));
+        EXPECT_EQ(copied_bytes, 11ul);
+    }
+
+    Array<u8, 40> result;
+    auto read_bytes = circular_buffer.read(result);
+    EXPECT_EQ(StringView { read_bytes }, "abcdefghijabcdefghijabcdefghighighighigh"sv);
+
+    {
+        // Now the copy has to wrap around the end of the buffer.
+        auto copied_bytes = TRY_OR_FAIL(circular_buffer.copy_from_seekback(40, 30));
+        EXPECT_EQ(copied_bytes, 30ul);
+    }
+
+    Array<u8, 30> wrapped_result;
+    read_bytes = circular_buffer.read(wrapped_result);
+    EXPECT_EQ(StringView { read_bytes }, "abcdefghijabcdefghijabcdefghig"sv);
+}
+
 BENCHMARK_CASE(looping_copy_from_seekback)
 {
     auto circular_buffer = MUST(CircularBuffer::create_empty(16 * MiB));
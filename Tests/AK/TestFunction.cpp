@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Array.h>
+#include <AK/Function.h>
+#include <AK/NonnullOwnPtr.h>
+
+TEST_CASE(construct)
+{
+    Function<int()> empty;
+    EXPECT(!empty);
+
+    Function<int()> function = [] { return 42; };
+    EXPECT(function);
+    EXPECT_EQ(function(), 42);
+    EXPECT(function.is_stored_inline());
+
+    function = nullptr;
+    EXPECT(!function);
+}
+
+TEST_CASE(function_pointer)
+{
+    static int (*const square)(int) = [](int value) { return value * value; };
+    Function<int(int)> function = square;
+    EXPECT_EQ(function(7), 49);
+    EXPECT(function.raw_capture_range().is_empty());
+}
+
+TEST_CASE(large_capture_is_stored_outline)
+{
+    Array<u64, 8> values { 1, 2, 3, 4, 5, 6, 7, 8 };
+    Function<u64()> function = [values] { return values[7]; };
+    EXPECT(!function.is_stored_inline());
+    EXPECT_EQ(function(), 8u);
+}
+
+TEST_CASE(custom_inline_capacity)
+{
+    Array<u64, 8> values { 1, 2, 3, 4, 5, 6, 7, 8 };
+    Function<u64(), 10 * sizeof(void*)> function = [values] { return values[7]; };
+    EXPECT(function.is_stored_inline());
+    EXPECT_EQ(function(), 8u);
+
+    auto moved = move(function);
+    EXPECT(!function);
+    EXPECT(moved.is_stored_inline());
+    EXPECT_EQ(moved(), 8u);
+}
+
+TEST_CASE(move_only_capture)
+{
+    auto value = make<int>(13);
+    Function<int(), 8 * sizeof(void*)> function = [value = move(value)] { return *value; };
+    auto moved = move(function);
+    EXPECT_EQ(moved(), 13);
+}
+
+static int call_twice(FunctionRef<int(int)> callback)
+{
+    return callback(callback(1));
+}
+
+TEST_CASE(function_ref)
+{
+    int calls = 0;
+    EXPECT_EQ(call_twice([&](int value) {
+        ++calls;
+        return value + 10;
+    }),
+        21);
+    EXPECT_EQ(calls, 2);
+
+    static int (*const negate)(int) = [](int value) { return -value; };
+    EXPECT_EQ(call_twice(negate), 1);
+
+    Function<int(int)> function = [](int value) { return value * 3; };
+    EXPECT_EQ(call_twice(function), 9);
+}
+
+TEST_CASE(function_ref_mutable_lambda)
+{
+    auto counter = [count = 0](int) mutable { return ++count; };
+    EXPECT_EQ(call_twice(counter), 2);
+    EXPECT_EQ(call_twice(counter), 4);
+}
+
+static constexpr size_t benchmark_iterations = 1'000'000;
+
+// Captures more than fits into the default inline capacity, so every Function created with it allocates.
+#define LARGE_CAPTURE_LAMBDA [a, b, c, d, e, &sum](u64 value) { sum += a + b + c + d + e + value; }
+
+BENCHMARK_CASE(large_capture_default_capacity)
+{
+    u64 a = 1, b = 2, c = 3, d = 4, e = 5, sum = 0;
+    for (size_t i = 0; i < benchmark_iterations; ++i) {
+        Function<void(u64)> function = LARGE_CAPTURE_LAMBDA;
+        function(i);
+    }
+    EXPECT(sum > 0);
+}
+
+BENCHMARK_CASE(large_capture_custom_capacity)
+{
+    u64 a = 1, b = 2, c = 3, d = 4, e = 5, sum = 0;
+    for (size_t i = 0; i < benchmark_iterations; ++i) {
+        Function<void(u64), 8 * sizeof(void*)> function = LARGE_CAPTURE_LAMBDA;
+        EXPECT(function.is_stored_inline());
+        function(i);
+    }
+    EXPECT(sum > 0);
+}
+
+static void call_with(FunctionRef<void(u64)> callback, u64 value)
+{
+    callback(value);
+}
+
+BENCHMARK_CASE(large_capture_function_ref)
+{
+    u64 a = 1, b = 2, c = 3, d = 4, e = 5, sum = 0;
+    for (size_t i = 0; i < benchmark_iterations; ++i)
+        call_with(LARGE_CAPTURE_LAMBDA, i);
+    EXPECT(sum > 0);
+}
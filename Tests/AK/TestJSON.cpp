@@ -9,6 +9,7 @@
 #include <AK/ByteString.h>
 #include <AK/HashMap.h>
 #include <AK/JsonObject.h>
+#include <AK/JsonParser.h>
 #include <AK/JsonValue.h>
 #include <AK/StringBuilder.h>
 
@@ -567,3 +568,98 @@ TEST_CASE(json_value_as_integer)
     EXPECT(!very_large_value.is_integer<i32>());
     EXPECT(very_large_value.is_integer<i64>());
 }
+
+class EventRecorder final : public JsonParser::Visitor {
+public:
+    StringBuilder events;
+
+    virtual ErrorOr<void> on_object_start() override { return events.try_append("{ "sv); }
+    virtual ErrorOr<void> on_object_key(StringView key) override { return events.try_appendff("key:{} ", key); }
+    virtual ErrorOr<void> on_object_end() override { return events.try_append("} "sv); }
+    virtual ErrorOr<void> on_array_start() override { return events.try_append("[ "sv); }
+    virtual ErrorOr<void> on_array_end() override { return events.try_append("] "sv); }
+    virtual ErrorOr<void> on_string(StringView string) override { return events.try_appendff("string:{} ", string); }
+    virtual ErrorOr<void> on_number(JsonValue const& number) override { return events.try_appendff("number:{} ", number.serialized<StringBuilder>()); }
+    virtual ErrorOr<void> on_boolean(bool value) override { return events.try_appendff("bool:{} ", value); }
+    virtual ErrorOr<void> on_null() override { return events.try_append("null "sv); }
+};
+
+TEST_CASE(json_parser_visitor_events)
+{
+    EventRecorder recorder;
+    TRY_OR_FAIL(JsonParser(R"({"a": [1, -2.5, "x\ny"], "b": {"c": true, "d": null}, "e": false})"sv).parse(recorder));
+    EXPECT_EQ(recorder.events.string_view(), "{ key:a [ number:1 number:-2.5 string:x\ny ] key:b { key:c bool:true key:d null } key:e bool:false } "sv);
+
+    EventRecorder failing_recorder;
+    EXPECT(JsonParser(R"({"a": [1, 2)"sv).parse(failing_recorder).is_error());
+    EXPECT_EQ(failing_recorder.events.string_view(), "{ key:a [ number:1 number:2 "sv);
+}
+
+TEST_CASE(json_parser_visitor_can_stop_parsing)
+{
+    class FirstKeyFinder final : public JsonParser::Visitor {
+    public:
+        virtual ErrorOr<void> on_object_key(StringView key) override
+        {
+            first_key = key;
+            return Error::from_errno(ECANCELED);
+        }
+        ByteString first_key;
+    };
+
+    FirstKeyFinder finder;
+    auto result = JsonParser(R"({"pid": 1, "broken": )"sv).parse(finder);
+    EXPECT(result.is_error());
+    EXPECT_EQ(result.error().code(), ECANCELED);
+    EXPECT_EQ(finder.first_key, "pid"sv);
+}
+
+TEST_CASE(json_parse_strings_across_word_boundaries)
+{
+    // Place the special characters at every offset relative to the parser's eight-byte scanning.
+    for (size_t prefix_length = 0; prefix_length < 17; ++prefix_length) {
+        auto prefix = ByteString::repeated('a', prefix_length);
+
+        auto plain = JsonValue::from_string(ByteString::formatted("\"{}\"", prefix));
+        EXPECT_EQ(plain.value().as_string(), prefix);
+
+        auto escaped = JsonValue::from_string(ByteString::formatted("\"{}\\\"{}\\\\\"", prefix, prefix));
+        EXPECT_EQ(escaped.value().as_string(), ByteString::formatted("{}\"{}\\", prefix, prefix));
+
+        EXPECT(JsonValue::from_string(ByteString::formatted("\"{}\n\"", prefix)).is_error());
+        EXPECT(JsonValue::from_string(ByteString::formatted("\"{}", prefix)).is_error());
+    }
+
+    auto utf8 = JsonValue::from_string("\"\xc3\xa4\xc3\xb6\xc3\xbc\xe2\x82\xac and more than eight bytes\""sv);
+    EXPECT_EQ(utf8.value().as_string(), "\xc3\xa4\xc3\xb6\xc3\xbc\xe2\x82\xac and more than eight bytes"sv);
+}
+
+static ByteString const& large_json_document()
+{
+    static ByteString document = [] {
+        StringBuilder builder;
+        builder.append("{\"processes\":["sv);
+        for (size_t i = 0; i < 1000; ++i) {
+            if (i != 0)
+                builder.append(',');
+            builder.appendff(R"({{"pid":{},"name":"process_{}","executable":"/usr/bin/process_{}","kernel":false,"amount_virtual":{},"threads":[{{"tid":{},"state":"Running","time_user":{}}}]}})", i, i, i, i * 4096, i, i * 1000);
+        }
+        builder.append("]}"sv);
+        return builder.to_byte_string();
+    }();
+    return document;
+}
+
+BENCHMARK_CASE(parse_tree)
+{
+    for (size_t i = 0; i < 10; ++i)
+        EXPECT(!JsonValue::from_string(large_json_document()).is_error());
+}
+
+BENCHMARK_CASE(parse_events)
+{
+    for (size_t i = 0; i < 10; ++i) {
+        JsonParser::Visitor visitor;
+        EXPECT(!JsonParser(large_json_document()).parse(visitor).is_error());
+    }
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/ByteString.h>
+#include <AK/MPMCQueue.h>
+#include <AK/OwnPtr.h>
+
+TEST_CASE(basic)
+{
+    MPMCQueue<int, 4> ints;
+    EXPECT(ints.is_empty());
+    EXPECT(!ints.try_dequeue().has_value());
+
+    EXPECT(ints.try_enqueue(1));
+    EXPECT(ints.try_enqueue(2));
+    EXPECT(ints.try_enqueue(3));
+    EXPECT(ints.try_enqueue(4));
+    EXPECT(!ints.try_enqueue(5));
+    EXPECT(!ints.is_empty());
+
+    EXPECT_EQ(ints.try_dequeue(), 1);
+    EXPECT(ints.try_enqueue(5));
+    EXPECT_EQ(ints.try_dequeue(), 2);
+    EXPECT_EQ(ints.try_dequeue(), 3);
+    EXPECT_EQ(ints.try_dequeue(), 4);
+    EXPECT_EQ(ints.try_dequeue(), 5);
+    EXPECT(ints.is_empty());
+}
+
+TEST_CASE(wrap_around)
+{
+    MPMCQueue<size_t, 2> queue;
+    for (size_t i = 0; i < 100; ++i) {
+        EXPECT(queue.try_enqueue(i));
+        EXPECT(queue.try_enqueue(i + 1));
+        EXPECT(!queue.try_enqueue(i + 2));
+        EXPECT_EQ(queue.try_dequeue(), i);
+        EXPECT_EQ(queue.try_dequeue(), i + 1);
+    }
+    EXPECT(queue.is_empty());
+}
+
+TEST_CASE(move_only_type)
+{
+    MPMCQueue<OwnPtr<ByteString>, 4> strings;
+    OwnPtr<ByteString> string = make<ByteString>("ABC");
+    EXPECT(strings.try_enqueue(move(string)));
+    EXPECT(!string);
+
+    OwnPtr<ByteString> full = make<ByteString>("DEF");
+    EXPECT(strings.try_enqueue(make<ByteString>("GHI")));
+    EXPECT(strings.try_enqueue(make<ByteString>("JKL")));
+    EXPECT(strings.try_enqueue(make<ByteString>("MNO")));
+    // A value that didn't fit is left alone.
+    EXPECT(!strings.try_enqueue(move(full)));
+    EXPECT(full);
+
+    EXPECT_EQ(*strings.try_dequeue().value(), "ABC");
+}
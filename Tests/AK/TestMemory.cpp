@@ -76,6 +76,48 @@ TEST_CASE(kmp_two_chunks)
     EXPECT(!result_3.has_value());
 }
 
+TEST_CASE(memchr)
+{
+    // Long enough for the vectorized search, with the needle at every position relative to its blocks.
+    for (size_t position = 0; position < 70; ++position) {
+        Array<u8, 70> haystack {};
+        haystack.fill('a');
+        haystack[position] = 'x';
+        if (position + 5 < haystack.size())
+            haystack[position + 5] = 'y';
+
+        EXPECT_EQ(AK::memchr_optional(haystack.data(), haystack.size(), 'x'), position);
+        EXPECT_EQ(AK::memchr2_optional(haystack.data(), haystack.size(), 'y', 'x'), position);
+        EXPECT_EQ(AK::memchr3_optional(haystack.data(), haystack.size(), 'z', 'y', 'x'), position);
+        EXPECT_EQ(AK::memrchr_optional(haystack.data(), haystack.size(), 'x'), position);
+        EXPECT(!AK::memchr_optional(haystack.data(), haystack.size(), 'z').has_value());
+        EXPECT(!AK::memchr_optional(haystack.data(), position, 'x').has_value());
+    }
+
+    Array<u8, 40> zeroes {};
+    EXPECT_EQ(AK::memrchr_optional(zeroes.data(), zeroes.size(), 0), 39u);
+    EXPECT(!AK::memchr_optional(zeroes.data(), 0, 0).has_value());
+}
+
+TEST_CASE(memmem_filtered)
+{
+    auto haystack = ByteString::formatted("{}needle{}", ByteString::repeated('-', 100), ByteString::repeated('-', 100));
+    for (size_t start = 0; start < 105; ++start) {
+        auto result = AK::memmem_optional(haystack.characters() + start, haystack.length() - start, "needle", 6);
+        if (start <= 100)
+            EXPECT_EQ(result, 100 - start);
+        else
+            EXPECT(!result.has_value());
+    }
+
+    // Every candidate matches the first and the last byte of the needle here, so the search has to fall back.
+    auto repetitive_haystack = ByteString::formatted("{}ab", ByteString::repeated('a', 10000));
+    auto repetitive_needle = ByteString::formatted("{}ab", ByteString::repeated('a', 20));
+    EXPECT_EQ(AK::memmem_optional(repetitive_haystack.characters(), repetitive_haystack.length(), repetitive_needle.characters(), repetitive_needle.length()), 9980u);
+    auto missing_needle = ByteString::formatted("{}b", ByteString::repeated('a', 40));
+    EXPECT(!AK::memmem_optional(repetitive_haystack.characters(), repetitive_haystack.length() - 1, missing_needle.characters(), missing_needle.length()).has_value());
+}
+
 TEST_CASE(timing_safe_compare)
 {
     ByteString data_set = "abcdefghijklmnopqrstuvwxyz123456789";
@@ -84,3 +126,17 @@ TEST_CASE(timing_safe_compare)
     ByteString reversed = data_set.reverse();
     EXPECT_EQ(false, AK::timing_safe_compare(data_set.characters(), reversed.characters(), reversed.length()));
 }
+
+BENCHMARK_CASE(memmem_long_haystack)
+{
+    auto haystack = ByteString::formatted("{}needle", ByteString::repeated('-', 1 * MiB));
+    for (size_t i = 0; i < 100; ++i)
+        EXPECT_EQ(AK::memmem_optional(haystack.characters(), haystack.length(), "needle", 6), 1 * MiB);
+}
+
+BENCHMARK_CASE(memchr_long_haystack)
+{
+    auto haystack = ByteString::formatted("{}x", ByteString::repeated('-', 1 * MiB));
+    for (size_t i = 0; i < 100; ++i)
+        EXPECT_EQ(AK::memchr_optional(haystack.characters(), haystack.length(), 'x'), 1 * MiB);
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/ByteString.h>
+#include <AK/SPSCQueue.h>
+
+TEST_CASE(basic)
+{
+    SPSCQueue<int, 4> ints;
+    EXPECT(ints.is_empty());
+    EXPECT(!ints.try_dequeue().has_value());
+
+    EXPECT(ints.try_enqueue(1));
+    EXPECT(ints.try_enqueue(2));
+    EXPECT(ints.try_enqueue(3));
+    EXPECT(ints.try_enqueue(4));
+    EXPECT(!ints.try_enqueue(5));
+    EXPECT_EQ(ints.size(), 4u);
+
+    EXPECT_EQ(ints.try_dequeue(), 1);
+    EXPECT(ints.try_enqueue(5));
+    EXPECT_EQ(ints.try_dequeue(), 2);
+    EXPECT_EQ(ints.try_dequeue(), 3);
+    EXPECT_EQ(ints.try_dequeue(), 4);
+    EXPECT_EQ(ints.try_dequeue(), 5);
+    EXPECT(ints.is_empty());
+}
+
+TEST_CASE(wrap_around)
+{
+    SPSCQueue<size_t, 8> queue;
+    for (size_t i = 0; i < 100; ++i) {
+        EXPECT(queue.try_enqueue(i));
+        EXPECT(queue.try_enqueue(i + 1));
+        EXPECT_EQ(queue.try_dequeue(), i);
+        EXPECT_EQ(queue.try_dequeue(), i + 1);
+    }
+    EXPECT(queue.is_empty());
+}
+
+TEST_CASE(complex_type)
+{
+    SPSCQueue<ByteString, 2> strings;
+    EXPECT(strings.try_enqueue("ABC"));
+    EXPECT(strings.try_enqueue("DEF"));
+    EXPECT(!strings.try_enqueue("GHI"));
+    EXPECT_EQ(strings.try_dequeue(), "ABC");
+
+    // The destructor takes care of what is left in the queue.
+    EXPECT(strings.try_enqueue("GHI"));
+}
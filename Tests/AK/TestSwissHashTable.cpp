@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/ByteString.h>
+#include <AK/HashTable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/SwissHashTable.h>
+#include <AK/Vector.h>
+
+TEST_CASE(construct)
+{
+    using IntTable = SwissHashTable<int>;
+    EXPECT(IntTable().is_empty());
+    EXPECT_EQ(IntTable().size(), 0u);
+    EXPECT(IntTable().begin() == IntTable().end());
+}
+
+TEST_CASE(basic_move)
+{
+    SwissHashTable<int> foo;
+    foo.set(1);
+    EXPECT_EQ(foo.size(), 1u);
+    auto bar = move(foo);
+    EXPECT_EQ(bar.size(), 1u);
+    EXPECT_EQ(foo.size(), 0u);
+    foo = move(bar);
+    EXPECT_EQ(bar.size(), 0u);
+    EXPECT_EQ(foo.size(), 1u);
+}
+
+TEST_CASE(copy)
+{
+    SwissHashTable<ByteString> strings;
+    strings.set("One");
+    strings.set("Two");
+
+    auto copy = strings;
+    strings.remove("One");
+    EXPECT_EQ(copy.size(), 2u);
+    EXPECT(copy.contains("One"sv));
+    EXPECT(copy.contains("Two"sv));
+    EXPECT_EQ(strings.size(), 1u);
+}
+
+TEST_CASE(populate)
+{
+    SwissHashTable<ByteString> strings;
+    strings.set("One");
+    strings.set("Two");
+    strings.set("Three");
+
+    EXPECT_EQ(strings.is_empty(), false);
+    EXPECT_EQ(strings.size(), 3u);
+}
+
+TEST_CASE(range_loop)
+{
+    SwissHashTable<ByteString> strings;
+    EXPECT_EQ(strings.set("One"), AK::HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(strings.set("Two"), AK::HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(strings.set("Three"), AK::HashSetResult::InsertedNewEntry);
+
+    int loop_counter = 0;
+    for (auto& it : strings) {
+        EXPECT_EQ(it.is_empty(), false);
+        ++loop_counter;
+    }
+    EXPECT_EQ(loop_counter, 3);
+}
+
+TEST_CASE(replace_and_keep)
+{
+    SwissHashTable<ByteString> strings;
+    EXPECT_EQ(strings.set("One"), AK::HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(strings.set("One"), AK::HashSetResult::ReplacedExistingEntry);
+    EXPECT_EQ(strings.set("One", AK::HashSetExistingEntryBehavior::Keep), AK::HashSetResult::KeptExistingEntry);
+    EXPECT_EQ(strings.size(), 1u);
+}
+
+TEST_CASE(table_remove)
+{
+    SwissHashTable<ByteString> strings;
+    EXPECT_EQ(strings.set("One"), AK::HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(strings.set("Two"), AK::HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(strings.set("Three"), AK::HashSetResult::InsertedNewEntry);
+
+    EXPECT_EQ(strings.remove("One"), true);
+    EXPECT_EQ(strings.size(), 2u);
+    EXPECT(strings.find("Two") != strings.end());
+    EXPECT(strings.find("Three") != strings.end());
+
+    EXPECT_EQ(strings.remove("Three"), true);
+    EXPECT_EQ(strings.size(), 1u);
+    EXPECT(strings.find("Two") != strings.end());
+    EXPECT(strings.find("One") == strings.end());
+    EXPECT(strings.find("Three") == strings.end());
+}
+
+TEST_CASE(remove_all_matching)
+{
+    SwissHashTable<int> ints;
+
+    ints.set(1);
+    ints.set(2);
+    ints.set(3);
+    ints.set(4);
+
+    EXPECT_EQ(ints.size(), 4u);
+
+    EXPECT_EQ(ints.remove_all_matching([&](int value) { return value > 2; }), true);
+    EXPECT_EQ(ints.remove_all_matching([&](int) { return false; }), false);
+
+    EXPECT_EQ(ints.size(), 2u);
+    EXPECT(ints.contains(1));
+    EXPECT(ints.contains(2));
+
+    EXPECT_EQ(ints.remove_all_matching([&](int) { return true; }), true);
+
+    EXPECT(ints.is_empty());
+
+    EXPECT_EQ(ints.remove_all_matching([&](int) { return true; }), false);
+}
+
+TEST_CASE(iterator_removal)
+{
+    SwissHashTable<int> map;
+    map.set(0);
+    map.set(1);
+
+    auto it = map.begin();
+    map.remove(it);
+    EXPECT_EQ(it, map.end());
+    EXPECT_EQ(map.size(), 1u);
+}
+
+TEST_CASE(many_ints)
+{
+    SwissHashTable<int> ints;
+    for (int i = 0; i < 100'000; ++i)
+        EXPECT_EQ(ints.set(i), AK::HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(ints.size(), 100'000u);
+
+    size_t count = 0;
+    for (auto value : ints) {
+        EXPECT(value >= 0 && value < 100'000);
+        ++count;
+    }
+    EXPECT_EQ(count, 100'000u);
+
+    for (int i = 0; i < 100'000; i += 2)
+        EXPECT_EQ(ints.remove(i), true);
+    for (int i = 0; i < 100'000; ++i)
+        EXPECT_EQ(ints.contains(i), i % 2 == 1);
+}
+
+TEST_CASE(many_strings)
+{
+    SwissHashTable<ByteString> strings;
+    for (int i = 0; i < 999; ++i) {
+        EXPECT_EQ(strings.set(ByteString::number(i)), AK::HashSetResult::InsertedNewEntry);
+    }
+    EXPECT_EQ(strings.size(), 999u);
+    for (int i = 0; i < 999; ++i) {
+        EXPECT_EQ(strings.remove(ByteString::number(i)), true);
+    }
+    EXPECT_EQ(strings.is_empty(), true);
+}
+
+TEST_CASE(many_collisions)
+{
+    struct StringCollisionTraits : public DefaultTraits<ByteString> {
+        static unsigned hash(ByteString const&) { return 0; }
+    };
+
+    SwissHashTable<ByteString, StringCollisionTraits> strings;
+    for (int i = 0; i < 999; ++i) {
+        EXPECT_EQ(strings.set(ByteString::number(i)), AK::HashSetResult::InsertedNewEntry);
+    }
+
+    EXPECT_EQ(strings.set("foo"), AK::HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(strings.size(), 1000u);
+
+    for (int i = 0; i < 999; ++i) {
+        EXPECT_EQ(strings.remove(ByteString::number(i)), true);
+    }
+
+    EXPECT(strings.find("foo") != strings.end());
+}
+
+TEST_CASE(space_reuse)
+{
+    struct StringCollisionTraits : public DefaultTraits<ByteString> {
+        static unsigned hash(ByteString const&) { return 0; }
+    };
+
+    SwissHashTable<ByteString, StringCollisionTraits> strings;
+
+    // Add a few items to allow it to do initial resizing.
+    EXPECT_EQ(strings.set("0"), AK::HashSetResult::InsertedNewEntry);
+    for (int i = 1; i < 5; ++i) {
+        EXPECT_EQ(strings.set(ByteString::number(i)), AK::HashSetResult::InsertedNewEntry);
+        EXPECT_EQ(strings.remove(ByteString::number(i - 1)), true);
+    }
+
+    auto capacity = strings.capacity();
+
+    for (int i = 5; i < 999; ++i) {
+        EXPECT_EQ(strings.set(ByteString::number(i)), AK::HashSetResult::InsertedNewEntry);
+        EXPECT_EQ(strings.remove(ByteString::number(i - 1)), true);
+    }
+
+    EXPECT_EQ(strings.capacity(), capacity);
+}
+
+TEST_CASE(capacity_leak)
+{
+    SwissHashTable<int> table;
+    for (size_t i = 0; i < 10000; ++i) {
+        table.set(i);
+        table.remove(i);
+    }
+    EXPECT(table.capacity() < 100u);
+}
+
+TEST_CASE(non_trivial_type_table)
+{
+    SwissHashTable<NonnullOwnPtr<int>> table;
+
+    table.set(make<int>(3));
+    table.set(make<int>(11));
+
+    for (int i = 0; i < 1'000; ++i) {
+        table.set(make<int>(-i));
+    }
+    for (int i = 0; i < 10'000; ++i) {
+        table.set(make<int>(i));
+        table.remove(make<int>(i));
+    }
+
+    EXPECT_EQ(table.remove_all_matching([&](auto&) { return true; }), true);
+    EXPECT(table.is_empty());
+    EXPECT_EQ(table.remove_all_matching([&](auto&) { return true; }), false);
+}
+
+TEST_CASE(clear_with_capacity)
+{
+    SwissHashTable<int> ints;
+    for (int i = 0; i < 1'000; ++i)
+        ints.set(i);
+    auto capacity = ints.capacity();
+
+    ints.clear_with_capacity();
+    EXPECT(ints.is_empty());
+    EXPECT_EQ(ints.capacity(), capacity);
+    EXPECT(!ints.contains(1));
+
+    ints.set(1);
+    EXPECT_EQ(ints.size(), 1u);
+}
+
+TEST_CASE(values)
+{
+    SwissHashTable<int> table;
+
+    table.set(10);
+    table.set(30);
+    table.set(20);
+
+    Vector<int> values = table.values();
+
+    EXPECT_EQ(values.size(), table.size());
+    EXPECT(values.contains_slow(10));
+    EXPECT(values.contains_slow(20));
+    EXPECT(values.contains_slow(30));
+}
+
+TEST_CASE(swiss_hash_map)
+{
+    SwissHashMap<ByteString, int> map;
+    for (int i = 0; i < 1'000; ++i)
+        map.set(ByteString::number(i), i);
+    EXPECT_EQ(map.size(), 1'000u);
+    EXPECT_EQ(map.get("500"sv), 500);
+    EXPECT(!map.get("1000"sv).has_value());
+
+    map.remove_all_matching([](auto&, int value) { return value % 2 == 0; });
+    EXPECT_EQ(map.size(), 500u);
+    EXPECT(!map.contains("500"sv));
+    EXPECT_EQ(map.get("501"sv), 501);
+}
+
+BENCHMARK_CASE(lookup)
+{
+    SwissHashTable<int> table;
+    for (int i = 0; i < 100'000; ++i)
+        table.set(i);
+    size_t found = 0;
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 200'000; ++i)
+            found += table.contains(i);
+    }
+    EXPECT_EQ(found, 1'000'000u);
+}
+
+BENCHMARK_CASE(lookup_hash_table)
+{
+    HashTable<int> table;
+    for (int i = 0; i < 100'000; ++i)
+        table.set(i);
+    size_t found = 0;
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 200'000; ++i)
+            found += table.contains(i);
+    }
+    EXPECT_EQ(found, 1'000'000u);
+}
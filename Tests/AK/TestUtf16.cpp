@@ -8,6 +8,7 @@
 
 #include <AK/Array.h>
 #include <AK/String.h>
+#include <AK/StringBuilder.h>
 #include <AK/StringView.h>
 #include <AK/Types.h>
 #include <AK/Utf16View.h>
@@ -67,6 +68,29 @@ TEST_CASE(encode_utf8)
     }
 }
 
+TEST_CASE(transcode_long_utf8)
+{
+    // Long enough for the ASCII fast paths, with a non-ASCII character at every position relative to their blocks.
+    for (size_t position = 0; position < 80; ++position) {
+        StringBuilder builder;
+        builder.append_repeated('a', position);
+        builder.append_code_point(0x1f600);
+        builder.append_repeated('b', 80 - position);
+        auto utf8 = builder.to_byte_string();
+
+        auto utf16 = MUST(AK::utf8_to_utf16(utf8));
+        EXPECT_EQ(utf16.size(), 82u);
+        EXPECT_EQ(utf16[position], 0xd83du);
+        EXPECT_EQ(utf16[position + 1], 0xde00u);
+        if (position > 0)
+            EXPECT_EQ(utf16[position - 1], 'a');
+        EXPECT_EQ(utf16[position + 2], 'b');
+
+        Utf16View view { utf16 };
+        EXPECT_EQ(MUST(view.to_utf8()), utf8.view());
+    }
+}
+
 TEST_CASE(decode_utf16)
 {
     // Same string as the decode_utf8 test.
@@ -336,3 +360,12 @@ TEST_CASE(starts_with)
     EXPECT(!emoji.starts_with(u"a"));
     EXPECT(!emoji.starts_with(u"🙃"));
 }
+
+BENCHMARK_CASE(transcode_ascii)
+{
+    auto string = ByteString::repeated('a', 1 * MiB);
+    for (size_t i = 0; i < 20; ++i) {
+        auto utf16 = MUST(AK::utf8_to_utf16(string));
+        EXPECT_EQ(MUST(Utf16View { utf16 }.to_utf8()).bytes().size(), string.length());
+    }
+}
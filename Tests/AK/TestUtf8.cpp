@@ -123,6 +123,31 @@ TEST_CASE(validate_overlong_utf8)
     EXPECT(valid_bytes == 2);
 }
 
+TEST_CASE(validate_long_utf8)
+{
+    // Long enough for the ASCII fast path, with the interesting byte at every position relative to its blocks.
+    for (size_t position = 0; position < 80; ++position) {
+        ByteBuffer buffer;
+        buffer.resize(80);
+        buffer.bytes().fill('a');
+
+        buffer[position] = 0xff;
+        Utf8View invalid { StringView { buffer.bytes() } };
+        size_t valid_bytes = 0;
+        EXPECT(!invalid.validate(valid_bytes));
+        EXPECT_EQ(valid_bytes, position);
+
+        if (position + 1 < buffer.size()) {
+            buffer[position] = 0xc3;
+            buffer[position + 1] = 0xa9;
+            Utf8View valid { StringView { buffer.bytes() } };
+            EXPECT(valid.validate(valid_bytes));
+            EXPECT_EQ(valid_bytes, buffer.size());
+            EXPECT_EQ(valid.length(), buffer.size() - 1);
+        }
+    }
+}
+
 TEST_CASE(iterate_utf8)
 {
     Utf8View view("Some weird characters \u00A9\u266A\uA755"sv);
@@ -295,3 +320,10 @@ TEST_CASE(trim)
         EXPECT_EQ(view.trim(whitespace, TrimMode::Right).as_string(), "\u180E");
     }
 }
+
+BENCHMARK_CASE(validate_ascii)
+{
+    auto string = ByteString::repeated('a', 1 * MiB);
+    for (size_t i = 0; i < 100; ++i)
+        EXPECT(Utf8View { string }.validate());
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/ByteBuffer.h>
+#include <AK/Random.h>
+#include <LibCore/System.h>
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Each benchmark moves a fixed amount of data per run, so the throughput is the transfer size divided by the time
+// reported for a run. Run with --bench, and with --benchmark_json to record the results.
+
+static constexpr size_t transfer_size = 16 * MiB;
+static constexpr size_t transfer_chunk_size = 64 * KiB;
+
+static constexpr auto ext2_file_path = "/home/anon/.ext2_benchmark"sv;
+static constexpr size_t random_io_block_size = 4 * KiB;
+static constexpr size_t random_io_reads_per_run = 1024;
+
+static void* write_transfer(void* argument)
+{
+    auto fd = *static_cast<int*>(argument);
+    Array<u8, transfer_chunk_size> chunk {};
+    for (size_t written = 0; written < transfer_size;) {
+        auto nwritten = MUST(Core::System::write(fd, chunk.span().trim(transfer_size - written)));
+        written += nwritten;
+    }
+    return nullptr;
+}
+
+// Writes the transfer into one end of a connection on a separate thread, while this thread reads it from the other.
+static void transfer_between(int write_fd, int read_fd)
+{
+    pthread_t writer;
+    VERIFY(pthread_create(&writer, nullptr, write_transfer, &write_fd) == 0);
+
+    Array<u8, transfer_chunk_size> chunk;
+    size_t total_read = 0;
+    while (total_read < transfer_size) {
+        auto nread = MUST(Core::System::read(read_fd, chunk));
+        VERIFY(nread > 0);
+        total_read += nread;
+    }
+
+    VERIFY(pthread_join(writer, nullptr) == 0);
+    EXPECT_EQ(total_read, transfer_size);
+}
+
+BENCHMARK_CASE(pipe_bandwidth)
+{
+    auto fds = MUST(Core::System::pipe2(O_CLOEXEC));
+    transfer_between(fds[1], fds[0]);
+    MUST(Core::System::close(fds[0]));
+    MUST(Core::System::close(fds[1]));
+}
+
+BENCHMARK_CASE(local_socket_bandwidth)
+{
+    Array<int, 2> fds;
+    MUST(Core::System::socketpair(AF_LOCAL, SOCK_STREAM, 0, fds.data()));
+    transfer_between(fds[0], fds[1]);
+    MUST(Core::System::close(fds[0]));
+    MUST(Core::System::close(fds[1]));
+}
+
+BENCHMARK_CASE(tcp_loopback_bandwidth)
+{
+    auto server_fd = MUST(Core::System::socket(AF_INET, SOCK_STREAM, 0));
+
+    sockaddr_in address {};
+    address.sin_family = AF_INET;
+    address.sin_port = 0;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    MUST(Core::System::bind(server_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)));
+    MUST(Core::System::listen(server_fd, 1));
+
+    socklen_t address_length = sizeof(address);
+    MUST(Core::System::getsockname(server_fd, reinterpret_cast<sockaddr*>(&address), &address_length));
+
+    auto client_fd = MUST(Core::System::socket(AF_INET, SOCK_STREAM, 0));
+    MUST(Core::System::connect(client_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)));
+    auto accepted_fd = MUST(Core::System::accept(server_fd, nullptr, nullptr));
+
+    transfer_between(client_fd, accepted_fd);
+
+    MUST(Core::System::close(accepted_fd));
+    MUST(Core::System::close(client_fd));
+    MUST(Core::System::close(server_fd));
+}
+
+BENCHMARK_CASE(ext2_sequential_write)
+{
+    auto fd = MUST(Core::System::open(ext2_file_path, O_CREAT | O_TRUNC | O_WRONLY, 0600));
+
+    Array<u8, transfer_chunk_size> chunk {};
+    for (size_t written = 0; written < transfer_size; written += chunk.size())
+        MUST(Core::System::write(fd, chunk));
+    MUST(Core::System::fsync(fd));
+
+    MUST(Core::System::close(fd));
+    MUST(Core::System::unlink(ext2_file_path));
+}
+
+// The file is unlinked right away, so it is cleaned up when the process exits, however that happens.
+static int create_unlinked_ext2_file()
+{
+    auto fd = MUST(Core::System::open(ext2_file_path, O_CREAT | O_TRUNC | O_RDWR, 0600));
+    MUST(Core::System::unlink(ext2_file_path));
+
+    auto contents = MUST(ByteBuffer::create_uninitialized(transfer_chunk_size));
+    fill_with_random(contents);
+    for (size_t written = 0; written < transfer_size; written += contents.size())
+        MUST(Core::System::write(fd, contents));
+    MUST(Core::System::fsync(fd));
+    return fd;
+}
+
+static int ext2_file_fd = create_unlinked_ext2_file();
+
+BENCHMARK_CASE(ext2_sequential_read)
+{
+
+    Array<u8, transfer_chunk_size> chunk;
+    size_t total_read = 0;
+    for (;;) {
+        auto nread = pread(ext2_file_fd, chunk.data(), chunk.size(), total_read);
+        VERIFY(nread >= 0);
+        if (nread == 0)
+            break;
+        total_read += nread;
+    }
+    EXPECT_EQ(total_read, transfer_size);
+}
+
+BENCHMARK_CASE(ext2_random_read)
+{
+    Array<u8, random_io_block_size> block;
+    for (size_t i = 0; i < random_io_reads_per_run; ++i) {
+        auto offset = get_random_uniform(transfer_size / random_io_block_size) * random_io_block_size;
+        auto nread = pread(ext2_file_fd, block.data(), block.size(), offset);
+        EXPECT_EQ(static_cast<size_t>(nread), random_io_block_size);
+    }
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/System.h>
+#include <LibTest/TestCase.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Run with --bench, and with --benchmark_json to record the results (and --benchmark_baseline to compare a later
+// build against them).
+
+static constexpr size_t syscalls_per_run = 10'000;
+static constexpr size_t page_fault_region_size = 16 * MiB;
+
+BENCHMARK_CASE(syscall_round_trip)
+{
+    // NOTE: Unlike getpid(), LibC doesn't cache the result of getuid(), so each call is an actual syscall.
+    for (size_t i = 0; i < syscalls_per_run; ++i)
+        (void)getuid();
+}
+
+BENCHMARK_CASE(fork_and_wait)
+{
+    auto pid = MUST(Core::System::fork());
+    if (pid == 0)
+        _exit(0);
+    auto result = MUST(Core::System::waitpid(pid));
+    EXPECT(WIFEXITED(result.status));
+}
+
+BENCHMARK_CASE(fork_exec_and_wait)
+{
+    auto pid = MUST(Core::System::fork());
+    if (pid == 0) {
+        char const* arguments[] = { "/bin/true", nullptr };
+        execv(arguments[0], const_cast<char**>(arguments));
+        _exit(1);
+    }
+    auto result = MUST(Core::System::waitpid(pid));
+    EXPECT(WIFEXITED(result.status));
+    EXPECT_EQ(WEXITSTATUS(result.status), 0);
+}
+
+BENCHMARK_CASE(posix_spawn_and_wait)
+{
+    char const* arguments[] = { "/bin/true", nullptr };
+    auto pid = MUST(Core::System::posix_spawn("/bin/true"sv, nullptr, nullptr, const_cast<char**>(arguments), environ));
+    auto result = MUST(Core::System::waitpid(pid));
+    EXPECT(WIFEXITED(result.status));
+    EXPECT_EQ(WEXITSTATUS(result.status), 0);
+}
+
+BENCHMARK_CASE(anonymous_page_faults)
+{
+    // Every page of a fresh anonymous mapping faults in a zeroed page on its first write.
+    auto* region = static_cast<u8*>(MUST(Core::System::mmap(nullptr, page_fault_region_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, 0, 0)));
+    for (size_t offset = 0; offset < page_fault_region_size; offset += PAGE_SIZE)
+        region[offset] = 1;
+    MUST(Core::System::munmap(region, page_fault_region_size));
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/System.h>
+#include <LibTest/TestCase.h>
+#include <sys/epoll.h>
+
+static void watch(int epoll_fd, int fd, u32 events, int op = EPOLL_CTL_ADD)
+{
+    epoll_event event { .events = events, .data = { .fd = fd } };
+    MUST(Core::System::epoll_ctl(epoll_fd, op, fd, &event));
+}
+
+static int wait_for_events(int epoll_fd, Span<epoll_event> events, int timeout = 0)
+{
+    return MUST(Core::System::epoll_wait(epoll_fd, events, timeout));
+}
+
+TEST_CASE(level_triggered_is_reported_while_ready)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create1(EPOLL_CLOEXEC));
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+    watch(epoll_fd, pipe_fds[0], EPOLLIN);
+
+    epoll_event events[4];
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 0);
+
+    MUST(Core::System::write(pipe_fds[1], "x"sv.bytes()));
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 1);
+    EXPECT_EQ(events[0].data.fd, pipe_fds[0]);
+    EXPECT_EQ(events[0].events, EPOLLIN);
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 1);
+
+    char buffer;
+    MUST(Core::System::read(pipe_fds[0], { &buffer, 1 }));
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 0);
+
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+    MUST(Core::System::close(epoll_fd));
+}
+
+TEST_CASE(edge_triggered_is_reported_once_per_change)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create1(0));
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+    watch(epoll_fd, pipe_fds[0], EPOLLIN | EPOLLET);
+
+    epoll_event events[4];
+    MUST(Core::System::write(pipe_fds[1], "x"sv.bytes()));
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 1);
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 0);
+
+    MUST(Core::System::write(pipe_fds[1], "y"sv.bytes()));
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 1);
+
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+    MUST(Core::System::close(epoll_fd));
+}
+
+TEST_CASE(oneshot_is_rearmed_by_modify)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create1(0));
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+    watch(epoll_fd, pipe_fds[0], EPOLLIN | EPOLLONESHOT);
+
+    epoll_event events[4];
+    MUST(Core::System::write(pipe_fds[1], "x"sv.bytes()));
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 1);
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 0);
+
+    watch(epoll_fd, pipe_fds[0], EPOLLIN | EPOLLONESHOT, EPOLL_CTL_MOD);
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 1);
+
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+    MUST(Core::System::close(epoll_fd));
+}
+
+TEST_CASE(closing_writer_makes_reader_readable)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create1(0));
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+    watch(epoll_fd, pipe_fds[0], EPOLLIN);
+
+    MUST(Core::System::close(pipe_fds[1]));
+    epoll_event events[4];
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 1);
+    EXPECT(events[0].events & EPOLLIN);
+
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(epoll_fd));
+}
+
+TEST_CASE(closing_removes_from_interest_list)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create1(0));
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+    watch(epoll_fd, pipe_fds[0], EPOLLIN);
+
+    MUST(Core::System::write(pipe_fds[1], "x"sv.bytes()));
+    MUST(Core::System::close(pipe_fds[0]));
+    epoll_event events[4];
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 0);
+
+    // The file descriptor can be watched again once it has been reused.
+    auto other_pipe_fds = MUST(Core::System::pipe2(0));
+    EXPECT_EQ(other_pipe_fds[0], pipe_fds[0]);
+    watch(epoll_fd, other_pipe_fds[0], EPOLLIN);
+
+    MUST(Core::System::close(pipe_fds[1]));
+    MUST(Core::System::close(other_pipe_fds[0]));
+    MUST(Core::System::close(other_pipe_fds[1]));
+    MUST(Core::System::close(epoll_fd));
+}
+
+TEST_CASE(control_errors)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create1(0));
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+    epoll_event event { .events = EPOLLIN, .data = { .u64 = 0 } };
+
+    auto result = Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_MOD, pipe_fds[0], &event);
+    EXPECT_EQ(result.error().code(), ENOENT);
+    MUST(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipe_fds[0], &event));
+    result = Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipe_fds[0], &event);
+    EXPECT_EQ(result.error().code(), EEXIST);
+    result = Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, epoll_fd, &event);
+    EXPECT_EQ(result.error().code(), EINVAL);
+    MUST(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, pipe_fds[0], nullptr));
+    result = Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, pipe_fds[0], nullptr);
+    EXPECT_EQ(result.error().code(), ENOENT);
+
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+    MUST(Core::System::close(epoll_fd));
+}
+
+TEST_CASE(wait_times_out)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create1(0));
+    epoll_event events[4];
+    EXPECT_EQ(wait_for_events(epoll_fd, events, 10), 0);
+    MUST(Core::System::close(epoll_fd));
+}
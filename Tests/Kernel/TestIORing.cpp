@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/IORing.h>
+#include <LibCore/System.h>
+#include <LibTest/TestCase.h>
+
+TEST_CASE(io_ring_write_then_read)
+{
+    char pattern[] = "/tmp/io_ring.XXXXXX";
+    auto fd = MUST(Core::System::mkstemp(pattern));
+    MUST(Core::System::unlink({ pattern, sizeof(pattern) - 1 }));
+
+    auto ring = MUST(Core::IORing::create(4));
+
+    auto data = "Hello, friends!"sv;
+    Vector<ErrorOr<size_t>> results;
+    for (size_t i = 0; i < 3; ++i) {
+        MUST(ring->write(fd, data.bytes(), i * data.length(), [&](auto result) { results.append(move(result)); }));
+    }
+    MUST(ring->submit());
+    EXPECT_EQ(ring->process_completions(), 3u);
+    EXPECT_EQ(results.size(), 3u);
+    for (auto& result : results)
+        EXPECT_EQ(result.value(), data.length());
+
+    char buffer[16] {};
+    Optional<ErrorOr<size_t>> read_result;
+    MUST(ring->read(fd, { buffer, data.length() }, data.length(), [&](auto result) { read_result = move(result); }));
+    MUST(ring->submit());
+    ring->process_completions();
+    EXPECT_EQ(read_result.value().value(), data.length());
+    EXPECT_EQ(StringView(buffer, data.length()), data);
+
+    MUST(Core::System::close(fd));
+}
+
+TEST_CASE(io_ring_reports_errors)
+{
+    auto ring = MUST(Core::IORing::create(4));
+
+    Optional<ErrorOr<size_t>> result;
+    MUST(ring->fsync(-1, [&](auto fsync_result) { result = move(fsync_result); }));
+    MUST(ring->submit());
+    ring->process_completions();
+    EXPECT(result.value().is_error());
+    EXPECT_EQ(result.value().error().code(), EBADF);
+}
+
+TEST_CASE(io_ring_more_operations_than_entries)
+{
+    auto ring = MUST(Core::IORing::create(2));
+
+    auto fd = MUST(Core::System::open("/dev/zero"sv, O_RDONLY));
+    u8 buffer[8];
+    size_t completed = 0;
+    for (size_t i = 0; i < 16; ++i) {
+        MUST(ring->read(fd, { buffer, sizeof(buffer) }, {}, [&](auto result) {
+            EXPECT_EQ(result.value(), sizeof(buffer));
+            ++completed;
+        }));
+    }
+    MUST(ring->submit());
+    ring->process_completions();
+    EXPECT_EQ(completed, 16u);
+    EXPECT_EQ(ring->pending_count(), 0u);
+
+    MUST(Core::System::close(fd));
+}
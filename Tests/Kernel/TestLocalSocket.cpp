@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <LibCore/System.h>
+#include <LibTest/TestCase.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+static Array<int, 2> create_socket_pair()
+{
+    Array<int, 2> fds;
+    MUST(Core::System::socketpair(AF_LOCAL, SOCK_STREAM, 0, fds.data()));
+    return fds;
+}
+
+static size_t get_buffer_size(int fd, int option)
+{
+    int size = 0;
+    socklen_t size_length = sizeof(size);
+    MUST(Core::System::getsockopt(fd, SOL_SOCKET, option, &size, &size_length));
+    return size;
+}
+
+TEST_CASE(buffer_size_options)
+{
+    auto fds = create_socket_pair();
+
+    EXPECT_EQ(get_buffer_size(fds[0], SO_SNDBUF), 64 * KiB);
+    EXPECT_EQ(get_buffer_size(fds[0], SO_RCVBUF), 64 * KiB);
+
+    int size = 256 * KiB;
+    MUST(Core::System::setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &size, sizeof(size)));
+    EXPECT_EQ(get_buffer_size(fds[0], SO_SNDBUF), 256 * KiB);
+    // The send buffer of one side is the receive buffer of the other.
+    EXPECT_EQ(get_buffer_size(fds[1], SO_RCVBUF), 256 * KiB);
+    EXPECT_EQ(get_buffer_size(fds[0], SO_RCVBUF), 64 * KiB);
+
+    // Requests are clamped to a sensible range.
+    size = 1;
+    MUST(Core::System::setsockopt(fds[0], SOL_SOCKET, SO_RCVBUF, &size, sizeof(size)));
+    EXPECT_EQ(get_buffer_size(fds[0], SO_RCVBUF), 4 * KiB);
+
+    MUST(Core::System::close(fds[0]));
+    MUST(Core::System::close(fds[1]));
+}
+
+TEST_CASE(resizing_preserves_buffered_data)
+{
+    auto fds = create_socket_pair();
+
+    auto data = "Well hello friends!"sv;
+    EXPECT_EQ(MUST(Core::System::write(fds[0], data.bytes())), data.length());
+
+    int size = 128 * KiB;
+    MUST(Core::System::setsockopt(fds[1], SOL_SOCKET, SO_RCVBUF, &size, sizeof(size)));
+
+    char buffer[32] {};
+    EXPECT_EQ(MUST(Core::System::read(fds[1], { buffer, sizeof(buffer) })), data.length());
+    EXPECT_EQ(StringView(buffer, data.length()), data);
+
+    MUST(Core::System::close(fds[0]));
+    MUST(Core::System::close(fds[1]));
+}
+
+TEST_CASE(vectored_sendmsg_and_recvmsg)
+{
+    auto fds = create_socket_pair();
+
+    char header[] = "header:";
+    char payload[] = "payload";
+    Array<iovec, 2> send_iovs {
+        iovec { header, sizeof(header) - 1 },
+        iovec { payload, sizeof(payload) - 1 },
+    };
+    msghdr send_message {};
+    send_message.msg_iov = send_iovs.data();
+    send_message.msg_iovlen = send_iovs.size();
+    EXPECT_EQ(MUST(Core::System::sendmsg(fds[0], &send_message, 0)), sizeof(header) + sizeof(payload) - 2);
+
+    char first[4] {};
+    char second[32] {};
+    Array<iovec, 2> receive_iovs {
+        iovec { first, sizeof(first) },
+        iovec { second, sizeof(second) },
+    };
+    msghdr receive_message {};
+    receive_message.msg_iov = receive_iovs.data();
+    receive_message.msg_iovlen = receive_iovs.size();
+    EXPECT_EQ(MUST(Core::System::recvmsg(fds[1], &receive_message, 0)), sizeof(header) + sizeof(payload) - 2);
+    EXPECT_EQ(StringView(first, sizeof(first)), "head"sv);
+    EXPECT_EQ(StringView(second, 10), "er:payload"sv);
+
+    MUST(Core::System::close(fds[0]));
+    MUST(Core::System::close(fds[1]));
+}
+
+BENCHMARK_CASE(ipc_throughput_large_messages)
+{
+    static constexpr size_t message_size = 1 * MiB;
+    static constexpr size_t message_count = 64;
+
+    auto fds = create_socket_pair();
+    int size = 1 * MiB;
+    MUST(Core::System::setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &size, sizeof(size)));
+
+    auto pid = MUST(Core::System::fork());
+    if (pid == 0) {
+        MUST(Core::System::close(fds[0]));
+        auto buffer = MUST(ByteBuffer::create_uninitialized(message_size));
+        size_t remaining = message_size * message_count;
+        while (remaining > 0)
+            remaining -= MUST(Core::System::read(fds[1], buffer.bytes().trim(remaining)));
+        _exit(0);
+    }
+    MUST(Core::System::close(fds[1]));
+
+    auto message = MUST(ByteBuffer::create_zeroed(message_size));
+    for (size_t i = 0; i < message_count; ++i) {
+        auto bytes = message.bytes();
+        while (!bytes.is_empty())
+            bytes = bytes.slice(MUST(Core::System::write(fds[0], bytes)));
+    }
+
+    MUST(Core::System::close(fds[0]));
+    MUST(Core::System::waitpid(pid));
+}
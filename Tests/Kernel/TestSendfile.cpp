@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/System.h>
+#include <LibTest/TestCase.h>
+#include <sys/sendfile.h>
+
+static int create_temporary_file(StringView contents)
+{
+    char pattern[] = "/tmp/sendfile.XXXXXX";
+    auto fd = MUST(Core::System::mkstemp(pattern));
+    MUST(Core::System::unlink({ pattern, sizeof(pattern) - 1 }));
+    EXPECT_EQ(MUST(Core::System::write(fd, contents.bytes())), contents.length());
+    MUST(Core::System::lseek(fd, 0, SEEK_SET));
+    return fd;
+}
+
+TEST_CASE(sendfile_into_pipe)
+{
+    auto data = "Well hello friends!"sv;
+    auto in_fd = create_temporary_file(data);
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+
+    EXPECT_EQ(MUST(Core::System::sendfile(pipe_fds[1], in_fd, nullptr, 4)), 4u);
+    EXPECT_EQ(MUST(Core::System::sendfile(pipe_fds[1], in_fd, nullptr, 1024)), data.length() - 4);
+    EXPECT_EQ(MUST(Core::System::sendfile(pipe_fds[1], in_fd, nullptr, 1024)), 0u);
+    EXPECT_EQ(MUST(Core::System::lseek(in_fd, 0, SEEK_CUR)), static_cast<off_t>(data.length()));
+
+    char buffer[32] {};
+    EXPECT_EQ(MUST(Core::System::read(pipe_fds[0], { buffer, sizeof(buffer) })), data.length());
+    EXPECT_EQ(StringView(buffer, data.length()), data);
+
+    MUST(Core::System::close(in_fd));
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+}
+
+TEST_CASE(sendfile_at_offset)
+{
+    auto data = "Well hello friends!"sv;
+    auto in_fd = create_temporary_file(data);
+    auto out_fd = create_temporary_file(""sv);
+
+    off_t offset = 5;
+    EXPECT_EQ(MUST(Core::System::sendfile(out_fd, in_fd, &offset, 5)), 5u);
+    EXPECT_EQ(offset, 10);
+    // The file offset of the input must not move.
+    EXPECT_EQ(MUST(Core::System::lseek(in_fd, 0, SEEK_CUR)), 0);
+
+    char buffer[8] {};
+    MUST(Core::System::lseek(out_fd, 0, SEEK_SET));
+    EXPECT_EQ(MUST(Core::System::read(out_fd, { buffer, sizeof(buffer) })), 5u);
+    EXPECT_EQ(StringView(buffer, 5), "hello"sv);
+
+    MUST(Core::System::close(in_fd));
+    MUST(Core::System::close(out_fd));
+}
+
+TEST_CASE(sendfile_errors)
+{
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+    auto in_fd = create_temporary_file("x"sv);
+
+    // Only files can be sent from.
+    EXPECT_EQ(sendfile(pipe_fds[1], pipe_fds[0], nullptr, 1), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    EXPECT_EQ(sendfile(pipe_fds[0], in_fd, nullptr, 1), -1);
+    EXPECT_EQ(errno, EBADF);
+
+    off_t offset = -1;
+    EXPECT_EQ(sendfile(pipe_fds[1], in_fd, &offset, 1), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    MUST(Core::System::close(in_fd));
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+}
@@ -7,9 +7,12 @@
 #include <AK/JsonArray.h>
 #include <LibCore/File.h>
 #include <LibTest/TestCase.h>
+#include <errno.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <pthread.h>
 #include <semaphore.h>
+#include <string.h>
 #include <sys/socket.h>
 
 static constexpr u16 port = 1337;
@@ -170,3 +173,56 @@ TEST_CASE(socket_connect_after_bind)
     unlink("/tmp/tmp-client.test");
     unlink("/tmp/tmp.test");
 }
+
+TEST_CASE(tcp_congestion_control)
+{
+    pthread_t server = start_tcp_server();
+
+    int client_fd = socket(AF_INET, SOCK_STREAM, 0);
+    EXPECT(client_fd >= 0);
+
+    char name[TCP_CA_NAME_MAX] {};
+    socklen_t name_length = sizeof(name);
+    int rc = getsockopt(client_fd, IPPROTO_TCP, TCP_CONGESTION, name, &name_length);
+    EXPECT_EQ(rc, 0);
+    EXPECT_EQ(StringView(name, strlen(name)), "cubic"sv);
+
+    rc = setsockopt(client_fd, IPPROTO_TCP, TCP_CONGESTION, "nonexistent", strlen("nonexistent"));
+    EXPECT_EQ(rc, -1);
+    EXPECT_EQ(errno, ENOENT);
+
+    rc = setsockopt(client_fd, IPPROTO_TCP, TCP_CONGESTION, "newreno", strlen("newreno"));
+    EXPECT_EQ(rc, 0);
+    name_length = sizeof(name);
+    rc = getsockopt(client_fd, IPPROTO_TCP, TCP_CONGESTION, name, &name_length);
+    EXPECT_EQ(rc, 0);
+    EXPECT_EQ(StringView(name, strlen(name)), "newreno"sv);
+
+    sockaddr_in sin {};
+    sin.sin_family = AF_INET;
+    sin.sin_port = htons(port);
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    rc = connect(client_fd, (sockaddr*)(&sin), sizeof(sin));
+    EXPECT_EQ(rc, 0);
+
+    u8 data = 'A';
+    int nwritten = send(client_fd, &data, sizeof(data), 0);
+    EXPECT_EQ(nwritten, 1);
+
+    tcp_info info {};
+    socklen_t info_length = sizeof(info);
+    rc = getsockopt(client_fd, IPPROTO_TCP, TCP_INFO, &info, &info_length);
+    EXPECT_EQ(rc, 0);
+    EXPECT_EQ(info_length, sizeof(info));
+    // Both ends are our own, so both of them offered SACK and window scaling.
+    EXPECT(info.tcpi_options & TCPI_OPT_SACK);
+    EXPECT(info.tcpi_options & TCPI_OPT_WSCALE);
+    EXPECT(info.tcpi_snd_cwnd >= info.tcpi_snd_mss);
+    EXPECT_EQ(info.tcpi_ca_state, TCP_CA_Open);
+
+    rc = close(client_fd);
+    EXPECT_EQ(rc, 0);
+
+    rc = pthread_join(server, nullptr);
+    EXPECT_EQ(rc, 0);
+}
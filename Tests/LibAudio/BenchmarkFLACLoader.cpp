@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibAudio/FlacWriter.h>
+#include <LibAudio/Loader.h>
+#include <LibCore/File.h>
+#include <LibFileSystem/TempFile.h>
+#include <LibTest/TestCase.h>
+
+#ifdef AK_OS_SERENITY
+#    define TEST_INPUT(x) ("/usr/Tests/LibAudio/WAV/" x)
+#else
+#    define TEST_INPUT(x) ("WAV/" x)
+#endif
+
+// There are no FLAC files in the repository, so we encode the WAV test inputs with our own encoder.
+static ByteBuffer encode_as_flac(StringView wav_path)
+{
+    auto loader = MUST(Audio::Loader::create(wav_path));
+    auto temp_file = MUST(FileSystem::TempFile::create_temp_file());
+
+    auto output_file = MUST(Core::File::open(temp_file->path(), Core::File::OpenMode::Write | Core::File::OpenMode::Truncate));
+    auto writer = MUST(Audio::FlacWriter::create(move(output_file), loader->sample_rate(), loader->num_channels(), loader->bits_per_sample()));
+    while (true) {
+        auto samples = MUST(loader->get_more_samples());
+        if (samples.is_empty())
+            break;
+        MUST(writer->write_samples(samples.span()));
+    }
+    MUST(writer->finalize());
+
+    auto input_file = MUST(Core::File::open(temp_file->path(), Core::File::OpenMode::Read));
+    return MUST(input_file->read_until_eof());
+}
+
+static void decode_all_samples(ReadonlyBytes flac_data)
+{
+    auto loader = MUST(Audio::Loader::create(flac_data));
+    while (true) {
+        auto samples = MUST(loader->get_more_samples());
+        if (samples.is_empty())
+            break;
+    }
+}
+
+auto mono_flac = encode_as_flac(TEST_INPUT("tone_44100_mono.wav"sv));
+auto stereo_flac = encode_as_flac(TEST_INPUT("tone_44100_stereo.wav"sv));
+
+BENCHMARK_CASE(decode_mono_44khz)
+{
+    decode_all_samples(mono_flac);
+}
+
+BENCHMARK_CASE(decode_stereo_44khz)
+{
+    decode_all_samples(stereo_flac);
+}
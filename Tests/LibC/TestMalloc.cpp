@@ -6,9 +6,13 @@
 
 #include <LibTest/TestCase.h>
 
+#include <AK/Vector.h>
 #include <errno.h>
 #include <mallocdefs.h>
+#include <pthread.h>
+#include <serenity.h>
 #include <stdlib.h>
+#include <string.h>
 
 TEST_CASE(malloc_limits)
 {
@@ -38,3 +42,86 @@ TEST_CASE(malloc_limits)
         return Test::Crash::Failure::DidNotCrash;
     });
 }
+
+TEST_CASE(malloc_free_across_threads)
+{
+    static constexpr size_t allocation_count = 1000;
+    static constexpr size_t thread_count = 4;
+
+    // Each thread allocates chunks of all the small size classes, which are freed by the main thread after the
+    // allocating thread has exited, and the other way around.
+    Vector<u8*> main_thread_allocations;
+    for (size_t i = 0; i < allocation_count; ++i) {
+        auto* ptr = static_cast<u8*>(malloc(i % 512 + 1));
+        memset(ptr, static_cast<u8>(i), i % 512 + 1);
+        main_thread_allocations.append(ptr);
+    }
+
+    struct ThreadState {
+        Vector<u8*> allocations_to_free;
+        Vector<u8*> allocations;
+    };
+    ThreadState states[thread_count];
+    for (size_t i = 0; i < thread_count; ++i) {
+        for (size_t j = i; j < allocation_count; j += thread_count)
+            states[i].allocations_to_free.append(main_thread_allocations[j]);
+    }
+
+    pthread_t threads[thread_count];
+    for (size_t i = 0; i < thread_count; ++i) {
+        auto rc = pthread_create(&threads[i], nullptr, [](void* argument) -> void* {
+            auto& state = *static_cast<ThreadState*>(argument);
+            for (auto* ptr : state.allocations_to_free)
+                free(ptr);
+            for (size_t j = 0; j < allocation_count; ++j) {
+                auto* ptr = static_cast<u8*>(malloc(j % 512 + 1));
+                memset(ptr, static_cast<u8>(j), j % 512 + 1);
+                state.allocations.append(ptr);
+            }
+            return nullptr;
+        },
+            &states[i]);
+        EXPECT_EQ(rc, 0);
+    }
+    for (auto thread : threads)
+        EXPECT_EQ(pthread_join(thread, nullptr), 0);
+
+    for (auto& state : states) {
+        for (size_t j = 0; j < allocation_count; ++j) {
+            auto* ptr = state.allocations[j];
+            for (size_t k = 0; k < j % 512 + 1; ++k)
+                EXPECT_EQ(ptr[k], static_cast<u8>(j));
+            free(ptr);
+        }
+    }
+}
+
+TEST_CASE(malloc_stats)
+{
+    // 2032 bytes is beyond what threads cache, so the chunks are accounted to the size class right away.
+    static constexpr size_t size_class = 7;
+    static constexpr size_t allocation_count = 100;
+
+    serenity_malloc_stats before {};
+    EXPECT_EQ(serenity_get_malloc_stats(&before), 0);
+    EXPECT_EQ(before.size_classes[size_class].chunk_size, 2032u);
+    EXPECT_EQ(before.block_size, ChunkedBlock::block_size);
+
+    void* allocations[allocation_count];
+    for (auto& allocation : allocations)
+        allocation = malloc(2000);
+
+    serenity_malloc_stats during {};
+    EXPECT_EQ(serenity_get_malloc_stats(&during), 0);
+    auto const& stats = during.size_classes[size_class];
+    EXPECT_EQ(stats.used_chunk_count, before.size_classes[size_class].used_chunk_count + allocation_count);
+    EXPECT(stats.chunk_count >= stats.used_chunk_count);
+    EXPECT(stats.block_count * (ChunkedBlock::block_size / 2032) >= stats.chunk_count);
+
+    for (auto* allocation : allocations)
+        free(allocation);
+
+    serenity_malloc_stats after {};
+    EXPECT_EQ(serenity_get_malloc_stats(&after), 0);
+    EXPECT_EQ(after.size_classes[size_class].used_chunk_count, before.size_classes[size_class].used_chunk_count);
+}
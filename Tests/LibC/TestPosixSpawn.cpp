@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+static int wait_for_exit_status(pid_t pid)
+{
+    int status = 0;
+    EXPECT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT(WIFEXITED(status));
+    return WEXITSTATUS(status);
+}
+
+TEST_CASE(spawn_reports_exit_status)
+{
+    pid_t pid = 0;
+    char const* argv[] = { "sh", "-c", "exit 42", nullptr };
+    EXPECT_EQ(posix_spawn(&pid, "/bin/sh", nullptr, nullptr, const_cast<char* const*>(argv), environ), 0);
+    EXPECT_EQ(wait_for_exit_status(pid), 42);
+}
+
+TEST_CASE(spawn_reports_missing_executable)
+{
+    pid_t pid = 0;
+    char const* argv[] = { "does-not-exist", nullptr };
+    EXPECT_EQ(posix_spawn(&pid, "/bin/does-not-exist", nullptr, nullptr, const_cast<char* const*>(argv), environ), ENOENT);
+    EXPECT_EQ(posix_spawnp(&pid, "does-not-exist", nullptr, nullptr, const_cast<char* const*>(argv), environ), ENOENT);
+}
+
+TEST_CASE(spawnp_searches_path)
+{
+    pid_t pid = 0;
+    char const* argv[] = { "true", nullptr };
+    EXPECT_EQ(posix_spawnp(&pid, "true", nullptr, nullptr, const_cast<char* const*>(argv), environ), 0);
+    EXPECT_EQ(wait_for_exit_status(pid), 0);
+}
+
+TEST_CASE(spawn_performs_file_actions)
+{
+    char path[] = "/tmp/posix_spawn.XXXXXX";
+    int fd = mkstemp(path);
+    EXPECT(fd >= 0);
+    close(fd);
+
+    posix_spawn_file_actions_t file_actions;
+    posix_spawn_file_actions_init(&file_actions);
+    posix_spawn_file_actions_addopen(&file_actions, STDOUT_FILENO, path, O_WRONLY | O_TRUNC, 0);
+    posix_spawn_file_actions_addchdir(&file_actions, "/tmp");
+
+    pid_t pid = 0;
+    char const* argv[] = { "sh", "-c", "pwd", nullptr };
+    EXPECT_EQ(posix_spawn(&pid, "/bin/sh", &file_actions, nullptr, const_cast<char* const*>(argv), environ), 0);
+    EXPECT_EQ(wait_for_exit_status(pid), 0);
+    posix_spawn_file_actions_destroy(&file_actions);
+
+    char buffer[16] {};
+    fd = open(path, O_RDONLY);
+    EXPECT(fd >= 0);
+    EXPECT_EQ(read(fd, buffer, sizeof(buffer) - 1), 5);
+    close(fd);
+    unlink(path);
+    EXPECT_EQ(strcmp(buffer, "/tmp\n"), 0);
+}
+
+TEST_CASE(spawn_reports_failing_file_action)
+{
+    posix_spawn_file_actions_t file_actions;
+    posix_spawn_file_actions_init(&file_actions);
+    posix_spawn_file_actions_addchdir(&file_actions, "/does/not/exist");
+
+    pid_t pid = 0;
+    char const* argv[] = { "true", nullptr };
+    EXPECT_EQ(posix_spawn(&pid, "/bin/true", &file_actions, nullptr, const_cast<char* const*>(argv), environ), ENOENT);
+    posix_spawn_file_actions_destroy(&file_actions);
+}
+
+TEST_CASE(spawn_applies_attributes)
+{
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+    posix_spawnattr_setpgroup(&attr, 0);
+
+    pid_t pid = 0;
+    char const* argv[] = { "true", nullptr };
+    EXPECT_EQ(posix_spawn(&pid, "/bin/true", nullptr, &attr, const_cast<char* const*>(argv), environ), 0);
+    EXPECT_EQ(getpgid(pid), pid);
+    EXPECT_EQ(wait_for_exit_status(pid), 0);
+    posix_spawnattr_destroy(&attr);
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+
+static constexpr int thread_count = 4;
+static constexpr int iterations_per_thread = 10000;
+
+static void init_mutex(pthread_mutex_t& mutex, int type, int protocol)
+{
+    pthread_mutexattr_t attr;
+    EXPECT_EQ(pthread_mutexattr_init(&attr), 0);
+    EXPECT_EQ(pthread_mutexattr_settype(&attr, type), 0);
+    EXPECT_EQ(pthread_mutexattr_setprotocol(&attr, protocol), 0);
+    EXPECT_EQ(pthread_mutex_init(&mutex, &attr), 0);
+    EXPECT_EQ(pthread_mutexattr_destroy(&attr), 0);
+}
+
+TEST_CASE(mutexattr_protocol)
+{
+    pthread_mutexattr_t attr;
+    EXPECT_EQ(pthread_mutexattr_init(&attr), 0);
+
+    int protocol = -1;
+    EXPECT_EQ(pthread_mutexattr_getprotocol(&attr, &protocol), 0);
+    EXPECT_EQ(protocol, PTHREAD_PRIO_NONE);
+
+    EXPECT_EQ(pthread_mutexattr_setprotocol(&attr, PTHREAD_PRIO_INHERIT), 0);
+    EXPECT_EQ(pthread_mutexattr_getprotocol(&attr, &protocol), 0);
+    EXPECT_EQ(protocol, PTHREAD_PRIO_INHERIT);
+
+    EXPECT_EQ(pthread_mutexattr_setprotocol(&attr, 1234), ENOTSUP);
+}
+
+TEST_CASE(priority_inherit_trylock)
+{
+    pthread_mutex_t mutex;
+    init_mutex(mutex, PTHREAD_MUTEX_NORMAL, PTHREAD_PRIO_INHERIT);
+
+    EXPECT_EQ(pthread_mutex_trylock(&mutex), 0);
+    EXPECT_EQ(static_cast<int>(mutex.lock), gettid());
+
+    pthread_t thread;
+    pthread_create(
+        &thread, nullptr, [](void* arg) -> void* {
+            auto* mutex = static_cast<pthread_mutex_t*>(arg);
+            return reinterpret_cast<void*>(static_cast<uintptr_t>(pthread_mutex_trylock(mutex)));
+        },
+        &mutex);
+    void* result = nullptr;
+    pthread_join(thread, &result);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(result), static_cast<uintptr_t>(EBUSY));
+
+    EXPECT_EQ(pthread_mutex_unlock(&mutex), 0);
+    EXPECT_EQ(mutex.lock, 0u);
+}
+
+TEST_CASE(priority_inherit_recursive)
+{
+    pthread_mutex_t mutex;
+    init_mutex(mutex, PTHREAD_MUTEX_RECURSIVE, PTHREAD_PRIO_INHERIT);
+
+    EXPECT_EQ(pthread_mutex_lock(&mutex), 0);
+    EXPECT_EQ(pthread_mutex_lock(&mutex), 0);
+    EXPECT_EQ(pthread_mutex_unlock(&mutex), 0);
+    EXPECT_EQ(static_cast<int>(mutex.lock), gettid());
+    EXPECT_EQ(pthread_mutex_unlock(&mutex), 0);
+    EXPECT_EQ(mutex.lock, 0u);
+}
+
+struct ContendedState {
+    pthread_mutex_t mutex;
+    int counter { 0 };
+};
+
+TEST_CASE(priority_inherit_contended)
+{
+    ContendedState state;
+    init_mutex(state.mutex, PTHREAD_MUTEX_NORMAL, PTHREAD_PRIO_INHERIT);
+
+    pthread_t threads[thread_count];
+    for (auto& thread : threads) {
+        pthread_create(
+            &thread, nullptr, [](void* arg) -> void* {
+                auto& state = *static_cast<ContendedState*>(arg);
+                for (int i = 0; i < iterations_per_thread; ++i) {
+                    pthread_mutex_lock(&state.mutex);
+                    state.counter++;
+                    pthread_mutex_unlock(&state.mutex);
+                }
+                return nullptr;
+            },
+            &state);
+    }
+    for (auto& thread : threads)
+        pthread_join(thread, nullptr);
+
+    EXPECT_EQ(state.counter, thread_count * iterations_per_thread);
+    EXPECT_EQ(state.mutex.lock, 0u);
+}
+
+struct BroadcastState {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool go { false };
+    int waiting { 0 };
+    int woken { 0 };
+};
+
+static void test_broadcast_wakes_all_waiters(int protocol)
+{
+    BroadcastState state;
+    init_mutex(state.mutex, PTHREAD_MUTEX_NORMAL, protocol);
+    EXPECT_EQ(pthread_cond_init(&state.cond, nullptr), 0);
+
+    pthread_t threads[thread_count];
+    for (auto& thread : threads) {
+        pthread_create(
+            &thread, nullptr, [](void* arg) -> void* {
+                auto& state = *static_cast<BroadcastState*>(arg);
+                pthread_mutex_lock(&state.mutex);
+                state.waiting++;
+                while (!state.go)
+                    pthread_cond_wait(&state.cond, &state.mutex);
+                state.woken++;
+                pthread_mutex_unlock(&state.mutex);
+                return nullptr;
+            },
+            &state);
+    }
+
+    for (;;) {
+        pthread_mutex_lock(&state.mutex);
+        if (state.waiting == thread_count)
+            break;
+        pthread_mutex_unlock(&state.mutex);
+        usleep(1000);
+    }
+    state.go = true;
+    EXPECT_EQ(pthread_cond_broadcast(&state.cond), 0);
+    pthread_mutex_unlock(&state.mutex);
+
+    for (auto& thread : threads)
+        pthread_join(thread, nullptr);
+    EXPECT_EQ(state.woken, thread_count);
+}
+
+TEST_CASE(cond_broadcast_requeues_waiters)
+{
+    test_broadcast_wakes_all_waiters(PTHREAD_PRIO_NONE);
+}
+
+TEST_CASE(cond_broadcast_priority_inherit)
+{
+    test_broadcast_wakes_all_waiters(PTHREAD_PRIO_INHERIT);
+}
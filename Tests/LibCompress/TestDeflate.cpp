@@ -69,6 +69,50 @@ TEST_CASE(invalid_canonical_code)
     EXPECT(Compress::CanonicalCode::from_bytes(code).is_error());
 }
 
+TEST_CASE(canonical_code_long_codes)
+{
+    // Code lengths of 1 to 14 bits, and two of 15 bits, so that some codes don't fit into the prefix table.
+    Array<u8, 16> code;
+    for (size_t i = 0; i < 15; ++i)
+        code[i] = i + 1;
+    code[15] = 15;
+
+    auto const huffman = TRY_OR_FAIL(Compress::CanonicalCode::from_bytes(code));
+
+    Array<u32, 20> const symbols { 15, 0, 14, 1, 1, 13, 2, 12, 3, 0, 0, 11, 4, 10, 5, 9, 6, 8, 7, 15 };
+
+    AllocatingMemoryStream memory_stream;
+    {
+        LittleEndianOutputBitStream output_stream { MaybeOwned<Stream>(memory_stream) };
+        for (auto symbol : symbols)
+            TRY_OR_FAIL(huffman.write_symbol(output_stream, symbol));
+        TRY_OR_FAIL(output_stream.align_to_byte_boundary());
+        TRY_OR_FAIL(output_stream.flush_buffer_to_stream());
+    }
+    auto encoded = TRY_OR_FAIL(memory_stream.read_until_eof());
+
+    {
+        FixedMemoryStream input_stream { encoded.bytes() };
+        LittleEndianInputBitStream bit_stream { MaybeOwned<Stream>(input_stream) };
+        for (auto symbol : symbols)
+            EXPECT_EQ(TRY_OR_FAIL(huffman.read_symbol(bit_stream)), symbol);
+    }
+
+    // Pairs of literals can be decoded together, which must not change the result.
+    {
+        FixedMemoryStream input_stream { encoded.bytes() };
+        LittleEndianInputBitStream bit_stream { MaybeOwned<Stream>(input_stream) };
+        Vector<u32> decoded;
+        while (decoded.size() < symbols.size()) {
+            Optional<u8> next_literal;
+            decoded.append(TRY_OR_FAIL(huffman.read_symbol(bit_stream, next_literal)));
+            if (next_literal.has_value())
+                decoded.append(next_literal.value());
+        }
+        EXPECT_EQ(decoded.span(), symbols.span());
+    }
+}
+
 TEST_CASE(deflate_decompress_compressed_block)
 {
     Array<u8, 28> const compressed {
@@ -156,6 +200,30 @@ TEST_CASE(deflate_round_trip_compress_large)
     EXPECT(uncompressed == original);
 }
 
+TEST_CASE(deflate_round_trip_compress_fastest)
+{
+    auto original = ByteBuffer::create_zeroed(Compress::DeflateCompressor::block_size * 2).release_value();
+    fill_with_random(original.bytes().trim(1024));
+    for (size_t i = 1024; i < original.size(); ++i)
+        original[i] = original[i % 1024] ^ (i % 7 == 0 ? 0xff : 0);
+    auto compressed = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all(original, Compress::DeflateCompressor::CompressionLevel::FASTEST));
+    EXPECT(compressed.size() < original.size());
+    auto uncompressed = TRY_OR_FAIL(Compress::DeflateDecompressor::decompress_all(compressed));
+    EXPECT(uncompressed == original);
+}
+
+TEST_CASE(deflate_round_trip_compress_parallel)
+{
+    // Inputs this large are compressed in independent chunks, and the result has to decompress to the original input.
+    auto size = Compress::DeflateCompressor::parallel_compression_threshold + 12345;
+    auto original = ByteBuffer::create_zeroed(size).release_value();
+    for (size_t offset = 0; offset < size; offset += 4096)
+        fill_with_random(original.bytes().slice(offset, min<size_t>(512, size - offset)));
+    auto compressed = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all(original, Compress::DeflateCompressor::CompressionLevel::FASTEST));
+    auto uncompressed = TRY_OR_FAIL(Compress::DeflateDecompressor::decompress_all(compressed));
+    EXPECT(uncompressed == original);
+}
+
 TEST_CASE(deflate_compress_literals)
 {
     // This byte array is known to not produce any back references with our lz77 implementation even at the highest compression settings
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Array.h>
+#include <AK/MemoryStream.h>
+#include <LibCompress/Zstd.h>
+#include <LibCore/File.h>
+
+static void run_test(StringView const file_name)
+{
+    // This makes sure that the tests will run both on target and in Lagom.
+#ifdef AK_OS_SERENITY
+    ByteString path = ByteString::formatted("/usr/Tests/LibCompress/zstd-test-files/{}", file_name);
+#else
+    ByteString path = ByteString::formatted("zstd-test-files/{}", file_name);
+#endif
+
+    auto cmp_file = MUST(Core::File::open(path, Core::File::OpenMode::Read));
+    auto cmp_data = MUST(cmp_file->read_until_eof());
+
+    ByteString path_compressed = ByteString::formatted("{}.zst", path);
+
+    auto file = MUST(Core::File::open(path_compressed, Core::File::OpenMode::Read));
+    auto zstd_stream = MUST(Compress::ZstdDecompressor::create(MaybeOwned<Stream> { *file }));
+    auto data = TRY_OR_FAIL(zstd_stream->read_until_eof());
+
+    EXPECT_EQ(data, cmp_data);
+}
+
+TEST_CASE(zstd_decompress_simple)
+{
+    // A single segment with raw literals and one sequence, followed by a checksum.
+    Array<u8, 27> const compressed {
+        0x28, 0xB5, 0x2F, 0xFD, 0x24, 0x36, 0x75, 0x00, 0x00, 0x40, 0x48, 0x65, 0x6C, 0x6C,
+        0x6F, 0x20, 0x68, 0x0A, 0x01, 0x00, 0xC7, 0x2C, 0x46, 0xA6, 0x57, 0xFC, 0xC1
+    };
+
+    EXPECT(Compress::ZstdDecompressor::is_likely_compressed(compressed));
+    auto decompressed = TRY_OR_FAIL(Compress::ZstdDecompressor::decompress_all(compressed));
+    EXPECT_EQ(decompressed.bytes(), "Hello hello hello hello hello hello hello hello hello\n"sv.bytes());
+}
+
+TEST_CASE(zstd_decompress_lorem)
+{
+    run_test("lorem.txt"sv);
+}
+
+TEST_CASE(zstd_decompress_happy3rd_html)
+{
+    run_test("happy3rd.html"sv);
+}
+
+TEST_CASE(zstd_decompress_raw_block)
+{
+    run_test("random.bin"sv);
+}
+
+TEST_CASE(zstd_decompress_multiple_frames)
+{
+    // Two frames, with a skippable frame in between.
+    run_test("frames.txt"sv);
+}
+
+TEST_CASE(zstd_decompress_zeroes)
+{
+#ifdef AK_OS_SERENITY
+    auto file = MUST(Core::File::open("/usr/Tests/LibCompress/zstd-test-files/zeroes.bin.zst"sv, Core::File::OpenMode::Read));
+#else
+    auto file = MUST(Core::File::open("zstd-test-files/zeroes.bin.zst"sv, Core::File::OpenMode::Read));
+#endif
+    auto compressed = MUST(file->read_until_eof());
+
+    auto decompressed = TRY_OR_FAIL(Compress::ZstdDecompressor::decompress_all(compressed));
+    EXPECT_EQ(decompressed.size(), 200000u);
+    for (auto byte : decompressed.bytes())
+        EXPECT_EQ(byte, 0);
+}
+
+TEST_CASE(zstd_reject_invalid_checksum)
+{
+    Array<u8, 27> compressed {
+        0x28, 0xB5, 0x2F, 0xFD, 0x24, 0x36, 0x75, 0x00, 0x00, 0x40, 0x48, 0x65, 0x6C, 0x6C,
+        0x6F, 0x20, 0x68, 0x0A, 0x01, 0x00, 0xC7, 0x2C, 0x46, 0xA6, 0x57, 0xFC, 0xC2
+    };
+
+    EXPECT(Compress::ZstdDecompressor::decompress_all(compressed).is_error());
+}
+
+TEST_CASE(zstd_reject_truncated_frame)
+{
+    Array<u8, 20> compressed {
+        0x28, 0xB5, 0x2F, 0xFD, 0x24, 0x36, 0x75, 0x00, 0x00, 0x40, 0x48, 0x65, 0x6C, 0x6C,
+        0x6F, 0x20, 0x68, 0x0A, 0x01, 0x00
+    };
+
+    EXPECT(Compress::ZstdDecompressor::decompress_all(compressed).is_error());
+}
+
+TEST_CASE(zstd_reject_dictionary)
+{
+    // A frame header with a 1-byte dictionary ID.
+    Array<u8, 10> compressed { 0x28, 0xB5, 0x2F, 0xFD, 0x21, 0x07, 0x00, 0x01, 0x00, 0x00 };
+
+    EXPECT(Compress::ZstdDecompressor::decompress_all(compressed).is_error());
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/QuickSort.h>
+#include <AK/Random.h>
+#include <AK/Vector.h>
+#include <LibCore/TimerWheel.h>
+#include <LibTest/TestCase.h>
+
+namespace {
+
+struct TestEntry : public Core::TimerWheel::Entry {
+    size_t id { 0 };
+};
+
+Vector<u64> advance(Core::TimerWheel& wheel, u64 tick)
+{
+    Core::TimerWheel::EntryList expired;
+    wheel.advance_to(tick, expired);
+
+    Vector<u64> ticks;
+    while (auto* entry = expired.take_first())
+        ticks.append(entry->expiration_tick());
+    return ticks;
+}
+
+}
+
+TEST_CASE(expires_in_order)
+{
+    Core::TimerWheel wheel;
+    Array<TestEntry, 5> entries;
+    u64 ticks[] = { 70, 5, 5000, 1, 300'000 };
+    for (size_t i = 0; i < entries.size(); ++i)
+        wheel.schedule(entries[i], ticks[i]);
+
+    EXPECT_EQ(wheel.next_expiration_tick(), 1u);
+    EXPECT_EQ(advance(wheel, 0), Vector<u64> {});
+    EXPECT_EQ(advance(wheel, 5), (Vector<u64> { 1, 5 }));
+    EXPECT_EQ(wheel.next_expiration_tick(), 70u);
+    EXPECT_EQ(advance(wheel, 4999), Vector<u64> { 70 });
+    EXPECT_EQ(wheel.next_expiration_tick(), 5000u);
+    EXPECT_EQ(advance(wheel, 1'000'000), (Vector<u64> { 5000, 300'000 }));
+    EXPECT(wheel.is_empty());
+    EXPECT(!wheel.next_expiration_tick().has_value());
+}
+
+TEST_CASE(schedule_in_the_past)
+{
+    Core::TimerWheel wheel { 1000 };
+    TestEntry entry;
+    wheel.schedule(entry, 10);
+    EXPECT_EQ(wheel.next_expiration_tick(), 1000u);
+    EXPECT_EQ(advance(wheel, 1000), Vector<u64> { 10 });
+    EXPECT(!entry.is_scheduled());
+}
+
+TEST_CASE(unschedule)
+{
+    Core::TimerWheel wheel;
+    TestEntry a;
+    TestEntry b;
+    wheel.schedule(a, 100);
+    wheel.schedule(b, 200);
+    EXPECT(a.is_scheduled());
+
+    wheel.unschedule(a);
+    EXPECT(!a.is_scheduled());
+    EXPECT_EQ(wheel.next_expiration_tick(), 200u);
+    wheel.unschedule(a);
+
+    EXPECT_EQ(advance(wheel, 1000), Vector<u64> { 200 });
+    EXPECT(wheel.is_empty());
+}
+
+TEST_CASE(far_future)
+{
+    Core::TimerWheel wheel;
+    TestEntry near;
+    TestEntry far;
+    u64 far_tick = 1ull << 40;
+    wheel.schedule(near, 10);
+    wheel.schedule(far, far_tick);
+
+    EXPECT_EQ(advance(wheel, 10), Vector<u64> { 10 });
+    EXPECT_EQ(advance(wheel, far_tick - 1), Vector<u64> {});
+    EXPECT(far.is_scheduled());
+    EXPECT_EQ(wheel.next_expiration_tick(), far_tick);
+    EXPECT_EQ(advance(wheel, far_tick), Vector<u64> { far_tick });
+}
+
+TEST_CASE(random_schedules_match_sorted_order)
+{
+    Core::TimerWheel wheel;
+    Vector<TestEntry> entries;
+    entries.resize(10'000);
+
+    u64 now = 0;
+    Vector<u64> remaining;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        entries[i].id = i;
+        // Mostly short timeouts, with a few of them far away.
+        u64 tick = now + (get_random_uniform(10) == 0 ? get_random<u32>() : get_random_uniform(100'000));
+        wheel.schedule(entries[i], tick);
+    }
+
+    for (size_t i = 0; i < entries.size(); i += 3)
+        wheel.unschedule(entries[i]);
+    for (auto const& entry : entries) {
+        if (entry.is_scheduled())
+            remaining.append(entry.expiration_tick());
+    }
+    quick_sort(remaining);
+
+    size_t next = 0;
+    while (!wheel.is_empty()) {
+        auto expiration = wheel.next_expiration_tick();
+        VERIFY(expiration.has_value());
+        EXPECT(next == remaining.size() || *expiration <= remaining[next]);
+
+        now = max(now + 1 + get_random_uniform(50'000), *expiration);
+        for (auto tick : advance(wheel, now)) {
+            EXPECT(tick <= now);
+            EXPECT_EQ(tick, remaining[next]);
+            ++next;
+        }
+        EXPECT(next == remaining.size() || remaining[next] > now);
+    }
+    EXPECT_EQ(next, remaining.size());
+}
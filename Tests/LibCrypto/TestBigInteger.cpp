@@ -8,6 +8,7 @@
 #include <LibCrypto/BigInt/SignedBigInteger.h>
 #include <LibCrypto/BigInt/UnsignedBigInteger.h>
 #include <LibCrypto/NumberTheory/ModularFunctions.h>
+#include <LibCrypto/NumberTheory/MontgomeryContext.h>
 #include <LibTest/TestCase.h>
 #include <math.h>
 
@@ -335,6 +336,32 @@ TEST_CASE(test_bigint_modular_power_extra_tests)
     }
 }
 
+TEST_CASE(test_bigint_montgomery_context)
+{
+    // 2^1279 - 1 is a Mersenne prime, so Fermat's little theorem applies, and its size makes power() use the largest window.
+    auto prime = Crypto::UnsignedBigInteger { 1 }.shift_left(1279).minus(1);
+    auto prime_minus_one = prime.minus(1);
+    Crypto::NumberTheory::MontgomeryContext context { prime };
+
+    for (u32 base : { 2u, 3u, 65537u })
+        EXPECT_EQ(context.power(base, prime_minus_one), 1);
+
+    EXPECT_EQ(context.power(3, 0), 1);
+    EXPECT_EQ(context.power(prime.plus(5), 1), 5);
+    EXPECT_EQ(context.multiply(prime_minus_one, prime_minus_one), 1);
+    EXPECT_EQ(context.multiply(prime.plus(2), 3), 6);
+}
+
+BENCHMARK_CASE(bigint_modular_power_2048_bits)
+{
+    // An odd modulus and a full-size exponent, like the ones of RSA private key operations.
+    auto modulus = Crypto::UnsignedBigInteger { 1 }.shift_left(2048).minus(159);
+    auto exponent = modulus.minus(12345);
+
+    for (u32 base = 2; base < 12; ++base)
+        (void)Crypto::NumberTheory::ModularPower(base, exponent, modulus);
+}
+
 TEST_CASE(test_bigint_primality_test)
 {
     struct {
@@ -139,3 +139,29 @@ TEST_CASE(test_vector_3)
     auto expected = ReadonlyBytes { ciphertext, 127 };
     EXPECT_EQ(result, expected);
 }
+
+TEST_CASE(test_many_blocks_at_once)
+{
+    // Long inputs have several blocks generated at a time, which has to give the same key stream as one block at a
+    // time, including for a length that isn't a multiple of the batch size.
+    u8 key[32];
+    u8 nonce[12];
+    fill_with_random(key);
+    fill_with_random(nonce);
+    auto plaintext = MUST(ByteBuffer::create_uninitialized(64 * 13 + 5));
+    fill_with_random(plaintext);
+
+    auto result = MUST(ByteBuffer::create_uninitialized(plaintext.size()));
+    auto output = result.bytes();
+    Crypto::Cipher::ChaCha20 cipher(ReadonlyBytes { key, 32 }, ReadonlyBytes { nonce, 12 }, 7);
+    cipher.encrypt(plaintext, output);
+
+    auto one_block_at_a_time = MUST(ByteBuffer::create_uninitialized(plaintext.size()));
+    Crypto::Cipher::ChaCha20 block_cipher(ReadonlyBytes { key, 32 }, ReadonlyBytes { nonce, 12 }, 7);
+    for (size_t offset = 0; offset < plaintext.size(); offset += 64) {
+        auto block_output = one_block_at_a_time.bytes().slice(offset);
+        block_cipher.encrypt(plaintext.bytes().slice(offset, min<size_t>(64, plaintext.size() - offset)), block_output);
+    }
+
+    EXPECT_EQ(result, one_block_at_a_time);
+}
@@ -207,3 +207,47 @@ TEST_CASE(test_aead_encrypt_and_decrypt)
     EXPECT(Crypto::AEAD::ChaCha20Poly1305::verify_tag(encrypted, decrypted));
     EXPECT_EQ(decrypted.bytes().slice(0, encrypted.bytes().size() - 16), plaintext.bytes());
 }
+
+TEST_CASE(test_aead_encrypt_whole_blocks)
+{
+    // With lengths that are multiples of 16, neither the AAD nor the ciphertext is followed by padding.
+    u8 key[32] = {
+        0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x8b, 0x8c, 0x8d, 0x8e, 0x8f,
+        0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0x9b, 0x9c, 0x9d, 0x9e, 0x9f
+    };
+    u8 nonce[12] = { 0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47 };
+    u8 aad[16] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f };
+    u8 plaintext[64] = {
+        0x00, 0x07, 0x0e, 0x15, 0x1c, 0x23, 0x2a, 0x31, 0x38, 0x3f, 0x46, 0x4d, 0x54, 0x5b, 0x62, 0x69,
+        0x70, 0x77, 0x7e, 0x85, 0x8c, 0x93, 0x9a, 0xa1, 0xa8, 0xaf, 0xb6, 0xbd, 0xc4, 0xcb, 0xd2, 0xd9,
+        0xe0, 0xe7, 0xee, 0xf5, 0xfc, 0x03, 0x0a, 0x11, 0x18, 0x1f, 0x26, 0x2d, 0x34, 0x3b, 0x42, 0x49,
+        0x50, 0x57, 0x5e, 0x65, 0x6c, 0x73, 0x7a, 0x81, 0x88, 0x8f, 0x96, 0x9d, 0xa4, 0xab, 0xb2, 0xb9
+    };
+    u8 expected_ciphertext[64] = {
+        0x9f, 0x7c, 0xe7, 0x48, 0x1d, 0xde, 0x6a, 0x8b, 0x2d, 0xdd, 0xc9, 0xb6, 0x62, 0xda, 0x68, 0xc7,
+        0xb1, 0xb7, 0xf6, 0xba, 0x85, 0x92, 0xf4, 0x7f, 0x75, 0x25, 0x66, 0x3a, 0x91, 0x49, 0xd1, 0x7c,
+        0xae, 0x79, 0x25, 0xcd, 0x50, 0x8d, 0x54, 0x3a, 0xa0, 0xc5, 0x94, 0x22, 0xce, 0xe0, 0x10, 0xa1,
+        0x25, 0x53, 0xec, 0x0b, 0xd2, 0x1a, 0x17, 0xce, 0xe8, 0x2b, 0x13, 0x52, 0xb5, 0x13, 0xa9, 0xe0
+    };
+    u8 expected_tag[16] = {
+        0x73, 0x4f, 0x9e, 0xf9, 0xaf, 0x09, 0x00, 0x71, 0xa7, 0xbd, 0x53, 0x7c, 0x1b, 0xd4, 0xd4, 0xb4
+    };
+
+    Crypto::AEAD::ChaCha20Poly1305 aead(ReadonlyBytes { key, 32 }, ReadonlyBytes { nonce, 12 });
+    auto encrypted = MUST(aead.encrypt(ReadonlyBytes { aad, 16 }, ReadonlyBytes { plaintext, 64 }));
+
+    EXPECT_EQ(encrypted.bytes().slice(0, 64), ReadonlyBytes(expected_ciphertext, 64));
+    EXPECT_EQ(encrypted.bytes().slice(64), ReadonlyBytes(expected_tag, 16));
+}
+
+BENCHMARK_CASE(encrypt)
+{
+    u8 key[32] {};
+    u8 nonce[12] {};
+    auto plaintext = MUST(ByteBuffer::create_zeroed(16 * KiB));
+    Crypto::AEAD::ChaCha20Poly1305 aead(ReadonlyBytes { key, 32 }, ReadonlyBytes { nonce, 12 });
+    for (size_t i = 0; i < 1000; ++i) {
+        auto encrypted = MUST(aead.encrypt({}, plaintext));
+        AK::taint_for_optimizer(encrypted);
+    }
+}
@@ -8,6 +8,7 @@
 #include <LibCrypto/Curves/SECPxxxr1.h>
 #include <LibCrypto/Curves/X25519.h>
 #include <LibCrypto/Curves/X448.h>
+#include <LibCrypto/Hash/SHA2.h>
 #include <LibTest/TestCase.h>
 
 TEST_CASE(test_x25519)
@@ -306,3 +307,69 @@ TEST_CASE(test_secp384r1)
     auto generated_public = MUST(curve.generate_public_key(private_key));
     EXPECT_EQ(expected_public_key.span(), generated_public);
 }
+
+TEST_CASE(test_secp256r1_verify)
+{
+    // clang-format off
+    u8 public_key_data[65] {
+        0x04, 0xe8, 0x8e, 0xd3, 0x17, 0xcd, 0x35, 0xa1, 0xb9, 0x4f, 0x41, 0x67, 0xd4, 0x94, 0x4d, 0xeb,
+        0x8f, 0xa8, 0xb1, 0xef, 0xe8, 0x41, 0xc4, 0x3b, 0xca, 0x9b, 0x4b, 0x06, 0x01, 0x54, 0xda, 0xb6,
+        0x77, 0x1d, 0x7a, 0x3f, 0xdb, 0x73, 0x0e, 0xc7, 0xe7, 0x82, 0xa6, 0x62, 0xac, 0xf3, 0xf2, 0xaa,
+        0x03, 0xd0, 0x87, 0x67, 0x2d, 0x5a, 0x09, 0x66, 0x9a, 0x0b, 0xe5, 0xbb, 0xcf, 0x40, 0xe5, 0x2d,
+        0x44,
+    };
+    u8 signature_data[72] {
+        0x30, 0x46, 0x02, 0x21, 0x00, 0xbf, 0x08, 0x0e, 0xe6, 0xf5, 0x0c, 0x54, 0x99, 0x6f, 0xf9, 0xbb,
+        0x3e, 0xae, 0xcc, 0x42, 0xda, 0xeb, 0xc2, 0x33, 0x61, 0xec, 0xb6, 0xa6, 0x8a, 0x70, 0x66, 0x7a,
+        0xeb, 0xfb, 0x01, 0x18, 0x09, 0x02, 0x21, 0x00, 0xdf, 0xce, 0x70, 0xd7, 0xdc, 0xb0, 0x66, 0xae,
+        0x08, 0x85, 0x9f, 0xfc, 0x35, 0x01, 0x37, 0xcb, 0xce, 0x3e, 0x50, 0x06, 0xdd, 0x7c, 0x84, 0x9a,
+        0x6e, 0x14, 0x8c, 0x32, 0x11, 0xf7, 0x48, 0x68,
+    };
+    // clang-format on
+
+    ReadonlyBytes public_key { public_key_data, sizeof(public_key_data) };
+    ReadonlyBytes signature { signature_data, sizeof(signature_data) };
+
+    Crypto::Curves::SECP256r1 curve;
+
+    auto digest = Crypto::Hash::SHA256::hash("Well hello friends!"sv);
+    EXPECT(MUST(curve.verify(digest.bytes(), public_key, signature)));
+
+    auto other_digest = Crypto::Hash::SHA256::hash("Well hello enemies!"sv);
+    EXPECT(!MUST(curve.verify(other_digest.bytes(), public_key, signature)));
+}
+
+TEST_CASE(test_secp384r1_verify)
+{
+    // clang-format off
+    u8 public_key_data[97] {
+        0x04, 0xb6, 0x6c, 0x11, 0xd9, 0x21, 0x96, 0x56, 0xcb, 0x8d, 0x58, 0xfb, 0x20, 0x03, 0xdb, 0x51,
+        0x24, 0xd4, 0x20, 0x1f, 0xf8, 0x16, 0x23, 0x0a, 0x60, 0xa8, 0x17, 0xee, 0xaa, 0x88, 0x72, 0xe2,
+        0x84, 0x95, 0x40, 0x43, 0x08, 0x5d, 0xf4, 0x64, 0x01, 0x1b, 0x8c, 0xa8, 0x17, 0xd1, 0xef, 0x21,
+        0x6c, 0xff, 0x40, 0x90, 0x0f, 0x0d, 0xce, 0xd0, 0x1a, 0x49, 0x11, 0x9c, 0x62, 0xe1, 0xd3, 0x7a,
+        0x35, 0x35, 0x02, 0x93, 0xb9, 0xd0, 0x55, 0x70, 0x0d, 0x92, 0x71, 0x44, 0x97, 0x82, 0xc1, 0x6d,
+        0xf7, 0x1d, 0x44, 0xa0, 0xe5, 0xb1, 0x1e, 0xd7, 0x02, 0x2e, 0xbf, 0x94, 0x8d, 0xa3, 0xcb, 0x98,
+        0x9c,
+    };
+    u8 signature_data[104] {
+        0x30, 0x66, 0x02, 0x31, 0x00, 0xe7, 0xcc, 0x8e, 0x03, 0x6d, 0xdf, 0xff, 0x80, 0x0b, 0x5b, 0x45,
+        0x5a, 0x67, 0x73, 0xf7, 0x27, 0x4c, 0x46, 0x54, 0xc7, 0xab, 0x48, 0x8b, 0x16, 0xa0, 0xb9, 0x13,
+        0x10, 0x03, 0x93, 0xfc, 0x4f, 0x1e, 0x97, 0x79, 0x6d, 0xf7, 0x23, 0x02, 0x3a, 0x0a, 0xef, 0x91,
+        0x3b, 0x41, 0x9f, 0xb4, 0x0b, 0x02, 0x31, 0x00, 0x82, 0xe9, 0xd3, 0x47, 0xb3, 0x64, 0x6f, 0xb7,
+        0xe7, 0x6f, 0xc7, 0xa6, 0x97, 0x42, 0xf6, 0xef, 0x20, 0x43, 0x0f, 0x37, 0x0a, 0x4d, 0x8a, 0x53,
+        0x14, 0xef, 0x50, 0xb5, 0xfc, 0x6d, 0x54, 0x73, 0x74, 0xa2, 0x0d, 0x7a, 0x62, 0xc7, 0x65, 0x95,
+        0x5b, 0x7d, 0x30, 0xd1, 0x75, 0xdc, 0x63, 0x66,
+    };
+    // clang-format on
+
+    ReadonlyBytes public_key { public_key_data, sizeof(public_key_data) };
+    ReadonlyBytes signature { signature_data, sizeof(signature_data) };
+
+    Crypto::Curves::SECP384r1 curve;
+
+    auto digest = Crypto::Hash::SHA384::hash("Well hello friends!"sv);
+    EXPECT(MUST(curve.verify(digest.bytes(), public_key, signature)));
+
+    auto other_digest = Crypto::Hash::SHA384::hash("Well hello enemies!"sv);
+    EXPECT(!MUST(curve.verify(other_digest.bytes(), public_key, signature)));
+}
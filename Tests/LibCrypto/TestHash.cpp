@@ -208,6 +208,29 @@ TEST_CASE(test_SHA1_hash_split_into_blocks)
     EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA1::digest_size()) == 0);
 }
 
+TEST_CASE(test_SHA1_hash_million_characters)
+{
+    u8 result[] {
+        0x34, 0xaa, 0x97, 0x3c, 0xd4, 0xc4, 0xda, 0xa4, 0xf6, 0x1e, 0xeb, 0x2b, 0xdb, 0xad, 0x27, 0x31, 0x65, 0x34, 0x01, 0x6f
+    };
+    auto hasher = Crypto::Hash::SHA1 {};
+    // An odd update size makes some updates start with a partially filled block, and others end with one.
+    for (size_t i = 0; i < 1'000'000; i += 1000)
+        hasher.update(ByteString::repeated('a', 1000));
+    auto digest = hasher.digest();
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA1::digest_size()) == 0);
+}
+
+BENCHMARK_CASE(SHA1)
+{
+    auto data = ByteBuffer::create_uninitialized(16 * MiB).release_value();
+    fill_with_random(data);
+    for (size_t i = 0; i < 10; ++i) {
+        auto digest = Crypto::Hash::SHA1::hash(data);
+        AK::taint_for_optimizer(digest);
+    }
+}
+
 TEST_CASE(test_SHA256_name)
 {
     Crypto::Hash::SHA256 sha;
@@ -241,6 +264,65 @@ TEST_CASE(test_SHA256_hash_split_into_blocks)
     EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA256::digest_size()) == 0);
 }
 
+TEST_CASE(test_SHA256_hash_million_characters)
+{
+    u8 result[] {
+        0xcd, 0xc7, 0x6e, 0x5c, 0x99, 0x14, 0xfb, 0x92, 0x81, 0xa1, 0xc7, 0xe2, 0x84, 0xd7, 0x3e, 0x67, 0xf1, 0x80, 0x9a, 0x48, 0xa4, 0x97, 0x20, 0x0e, 0x04, 0x6d, 0x39, 0xcc, 0xc7, 0x11, 0x2c, 0xd0
+    };
+    auto hasher = Crypto::Hash::SHA256 {};
+    for (size_t i = 0; i < 1'000'000; i += 1000)
+        hasher.update(ByteString::repeated('a', 1000));
+    auto digest = hasher.digest();
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA256::digest_size()) == 0);
+}
+
+TEST_CASE(test_SHA256_hash_many)
+{
+    // Lengths around one and two blocks, to cover messages whose padding does and doesn't need an extra block.
+    Vector<ByteBuffer> buffers;
+    Vector<ReadonlyBytes> messages;
+    for (size_t length = 0; length < 200; ++length) {
+        auto buffer = ByteBuffer::create_uninitialized(length).release_value();
+        fill_with_random(buffer);
+        buffers.append(move(buffer));
+    }
+    for (auto const& buffer : buffers)
+        messages.append(buffer.bytes());
+
+    Vector<Crypto::Hash::SHA256::DigestType> digests;
+    digests.resize(messages.size());
+    Crypto::Hash::SHA256::hash_many(messages, digests);
+
+    for (size_t i = 0; i < messages.size(); ++i)
+        EXPECT(digests[i] == Crypto::Hash::SHA256::hash(buffers[i]));
+}
+
+BENCHMARK_CASE(SHA256)
+{
+    auto data = ByteBuffer::create_uninitialized(16 * MiB).release_value();
+    fill_with_random(data);
+    for (size_t i = 0; i < 10; ++i) {
+        auto digest = Crypto::Hash::SHA256::hash(data);
+        AK::taint_for_optimizer(digest);
+    }
+}
+
+BENCHMARK_CASE(SHA256_hash_many_small_messages)
+{
+    auto data = ByteBuffer::create_uninitialized(64 * KiB).release_value();
+    fill_with_random(data);
+    Vector<ReadonlyBytes> messages;
+    for (size_t offset = 0; offset < data.size(); offset += 64)
+        messages.append(data.bytes().slice(offset, 64));
+
+    Vector<Crypto::Hash::SHA256::DigestType> digests;
+    digests.resize(messages.size());
+    for (size_t i = 0; i < 100; ++i) {
+        Crypto::Hash::SHA256::hash_many(messages, digests);
+        AK::taint_for_optimizer(digests);
+    }
+}
+
 TEST_CASE(test_SHA384_name)
 {
     Crypto::Hash::SHA384 sha;
@@ -376,3 +376,45 @@ TEST_CASE(0012_blend_equations)
     context->present();
     expect_bitmap_equals_reference(context->frontbuffer(), "0012_blend_equations"sv);
 }
+
+TEST_CASE(0013_draw_elements_with_shared_vertices_matches_immediate_mode)
+{
+    auto draw_immediate = [] {
+        float const colors[][3] = { { 1.f, 0.f, 0.f }, { 0.f, 1.f, 0.f }, { 0.f, 0.f, 1.f }, { 1.f, 1.f, 0.f } };
+        float const vertices[][2] = { { -.5f, -.5f }, { .5f, -.5f }, { .5f, .5f }, { -.5f, .5f } };
+        u8 const indices[] = { 0, 1, 2, 2, 3, 0 };
+
+        glBegin(GL_TRIANGLES);
+        for (auto index : indices) {
+            glColor3fv(colors[index]);
+            glVertex2fv(vertices[index]);
+        }
+        glEnd();
+    };
+
+    auto immediate_context = create_testing_context(64, 64);
+    draw_immediate();
+    EXPECT_EQ(glGetError(), 0u);
+    immediate_context->present();
+
+    auto indexed_context = create_testing_context(64, 64);
+    float const colors[] = { 1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f, 1.f, 1.f, 0.f };
+    float const vertices[] = { -.5f, -.5f, .5f, -.5f, .5f, .5f, -.5f, .5f };
+    u8 const indices[] = { 0, 1, 2, 2, 3, 0 };
+
+    glEnableClientState(GL_COLOR_ARRAY);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glColorPointer(3, GL_FLOAT, 0, colors);
+    glVertexPointer(2, GL_FLOAT, 0, vertices);
+
+    auto const list_index = glGenLists(1);
+    glNewList(list_index, GL_COMPILE);
+    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_BYTE, indices);
+    glEndList();
+
+    glCallList(list_index);
+    EXPECT_EQ(glGetError(), 0u);
+    indexed_context->present();
+
+    EXPECT(immediate_context->frontbuffer()->visually_equals(indexed_context->frontbuffer()));
+}
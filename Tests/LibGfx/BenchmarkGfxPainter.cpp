@@ -52,3 +52,97 @@ BENCHMARK_CASE(fill_with_gradient)
         painter.fill_rect_with_gradient(bitmap->rect(), Color::Blue, Color::Red);
     }
 }
+
+BENCHMARK_CASE(fill_with_alpha)
+{
+    int const run_count = 100;
+    int const bitmap_size = 2000;
+
+    auto bitmap = TRY_OR_FAIL(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }));
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.fill_rect(bitmap->rect(), Color(Color::Blue).with_alpha(100));
+    }
+}
+
+BENCHMARK_CASE(blit_opaque)
+{
+    int const run_count = 100;
+    int const bitmap_size = 2000;
+
+    auto bitmap = TRY_OR_FAIL(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }));
+    auto source_bitmap = TRY_OR_FAIL(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { bitmap_size, bitmap_size }));
+    source_bitmap->fill(Color::Red);
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.blit({ 0, 0 }, source_bitmap, source_bitmap->rect());
+    }
+}
+
+BENCHMARK_CASE(blit_with_alpha)
+{
+    int const run_count = 100;
+    int const bitmap_size = 2000;
+
+    auto bitmap = TRY_OR_FAIL(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { bitmap_size, bitmap_size }));
+    bitmap->fill(Color::White);
+    auto source_bitmap = TRY_OR_FAIL(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { bitmap_size, bitmap_size }));
+    source_bitmap->fill(Color(Color::Red).with_alpha(100));
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.blit({ 0, 0 }, source_bitmap, source_bitmap->rect());
+    }
+}
+
+BENCHMARK_CASE(blit_with_opacity)
+{
+    int const run_count = 100;
+    int const bitmap_size = 2000;
+
+    auto bitmap = TRY_OR_FAIL(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }));
+    auto source_bitmap = TRY_OR_FAIL(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }));
+    source_bitmap->fill(Color::Red);
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.blit({ 0, 0 }, source_bitmap, source_bitmap->rect(), 0.5f);
+    }
+}
+
+BENCHMARK_CASE(draw_scaled_bitmap_bilinear)
+{
+    int const run_count = 10;
+    int const bitmap_size = 2000;
+
+    auto bitmap = TRY_OR_FAIL(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }));
+    auto source_bitmap = TRY_OR_FAIL(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size / 3, bitmap_size / 3 }));
+    source_bitmap->fill(Color::Red);
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.draw_scaled_bitmap(bitmap->rect(), source_bitmap, source_bitmap->rect(), 1.0f, Gfx::Painter::ScalingMode::BilinearBlend);
+    }
+}
+
+BENCHMARK_CASE(fill_path_with_alpha)
+{
+    int const run_count = 100;
+    int const bitmap_size = 2000;
+
+    auto bitmap = TRY_OR_FAIL(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }));
+    Gfx::Painter painter(bitmap);
+
+    Gfx::Path path;
+    path.move_to({ bitmap_size / 2, 0 });
+    path.line_to({ bitmap_size - 1, bitmap_size / 2 });
+    path.line_to({ bitmap_size / 2, bitmap_size - 1 });
+    path.line_to({ 0, bitmap_size / 2 });
+    path.close();
+
+    for (int run = 0; run < run_count; run++) {
+        painter.fill_path(path, Color(Color::Blue).with_alpha(100), Gfx::Painter::WindingRule::Nonzero);
+    }
+}
@@ -168,6 +168,26 @@ TEST_CASE(test_jpeg)
     (void)TRY_OR_FAIL((get_roundtrip_bitmap<Gfx::JPEGWriter, Gfx::JPEGImageDecoderPlugin>(TRY_OR_FAIL(create_test_rgb_bitmap()))));
 }
 
+TEST_CASE(test_jpeg_restart_interval)
+{
+    // Restart markers don't change the encoded samples, so the decoded bitmaps must be identical with and without them.
+    // The larger size makes the decoder process the restart intervals in parallel.
+    for (auto size : { Gfx::IntSize { 47, 33 }, Gfx::IntSize { 1024, 512 } }) {
+        auto bitmap = TRY_OR_FAIL(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, size));
+        for (int y = 0; y < bitmap->height(); ++y)
+            for (int x = 0; x < bitmap->width(); ++x)
+                bitmap->set_pixel(x, y, Gfx::Color(x * 255 / bitmap->width(), y * 255 / bitmap->height(), (x * y) % 256));
+
+        auto without_restart_markers = TRY_OR_FAIL(encode_bitmap<Gfx::JPEGWriter>(bitmap, Gfx::JPEGEncoderOptions {}));
+        auto with_restart_markers = TRY_OR_FAIL(encode_bitmap<Gfx::JPEGWriter>(bitmap, Gfx::JPEGEncoderOptions { .restart_interval = 7 }));
+        EXPECT(with_restart_markers.size() > without_restart_markers.size());
+
+        auto expected = TRY_OR_FAIL(expect_single_frame_of_size(*TRY_OR_FAIL(Gfx::JPEGImageDecoderPlugin::create(without_restart_markers)), size));
+        auto decoded = TRY_OR_FAIL(expect_single_frame_of_size(*TRY_OR_FAIL(Gfx::JPEGImageDecoderPlugin::create(with_restart_markers)), size));
+        expect_bitmaps_equal(*decoded, *expected);
+    }
+}
+
 TEST_CASE(test_png)
 {
     TRY_OR_FAIL((test_roundtrip<Gfx::PNGWriter, Gfx::PNGImageDecoderPlugin>(TRY_OR_FAIL(create_test_rgb_bitmap()))));
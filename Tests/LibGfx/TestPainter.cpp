@@ -53,3 +53,107 @@ TEST_CASE(draw_rect_rough_bounds)
     painter.draw_rect(Gfx::IntRect(0, 0, 1, 1), Color::Black, true);
     painter.draw_rect(Gfx::IntRect(9, 9, 1, 1), Color::Black, true);
 }
+
+static Color test_pattern_color(int x, int y, u8 alpha)
+{
+    return Color(x * 37 + y * 11, x * 5 + y * 61, x * 23 + y * 7, alpha);
+}
+
+TEST_CASE(blit_with_alpha_matches_color_blend)
+{
+    // Rows are wide enough to go through the four-pixel blending path, with some pixels left over.
+    auto source_bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 13, 5 }));
+    for (int y = 0; y < source_bitmap->height(); ++y) {
+        for (int x = 0; x < source_bitmap->width(); ++x) {
+            u8 alpha = y == 0 ? 0xff : (x * 47 + y * 29) & 0xff;
+            source_bitmap->set_pixel(x, y, test_pattern_color(x, y, alpha));
+        }
+    }
+
+    for (auto format : { Gfx::BitmapFormat::BGRx8888, Gfx::BitmapFormat::BGRA8888 }) {
+        for (float opacity : { 1.0f, 0.5f }) {
+            auto bitmap = MUST(Gfx::Bitmap::create(format, { 20, 10 }));
+            for (int y = 0; y < bitmap->height(); ++y) {
+                for (int x = 0; x < bitmap->width(); ++x) {
+                    // Leave some of the destination translucent, which needs the full blending formula.
+                    u8 alpha = (format == Gfx::BitmapFormat::BGRA8888 && x % 5 == 0) ? 0x80 : 0xff;
+                    bitmap->set_pixel(x, y, test_pattern_color(y, x, alpha));
+                }
+            }
+            auto expected_bitmap = MUST(bitmap->clone());
+
+            Gfx::IntPoint position { 3, 2 };
+            for (int y = 0; y < source_bitmap->height(); ++y) {
+                for (int x = 0; x < source_bitmap->width(); ++x) {
+                    auto source_color = source_bitmap->get_pixel(x, y);
+                    float pixel_opacity = source_color.alpha() / 255.0;
+                    source_color.set_alpha(255 * (opacity * pixel_opacity));
+                    auto destination_color = expected_bitmap->get_pixel(position.x() + x, position.y() + y);
+                    expected_bitmap->set_pixel(position.x() + x, position.y() + y, destination_color.blend(source_color));
+                }
+            }
+
+            Gfx::Painter painter(bitmap);
+            painter.blit(position, source_bitmap, source_bitmap->rect(), opacity);
+
+            for (int y = 0; y < bitmap->height(); ++y) {
+                for (int x = 0; x < bitmap->width(); ++x)
+                    EXPECT_EQ(bitmap->get_pixel(x, y), expected_bitmap->get_pixel(x, y));
+            }
+        }
+    }
+}
+
+TEST_CASE(fill_rect_with_alpha_matches_color_blend)
+{
+    auto color = Color(10, 200, 30, 100);
+    for (auto format : { Gfx::BitmapFormat::BGRx8888, Gfx::BitmapFormat::BGRA8888 }) {
+        auto bitmap = MUST(Gfx::Bitmap::create(format, { 11, 6 }));
+        for (int y = 0; y < bitmap->height(); ++y) {
+            for (int x = 0; x < bitmap->width(); ++x)
+                bitmap->set_pixel(x, y, test_pattern_color(x, y, x == 2 ? 0 : 0xff));
+        }
+        auto expected_bitmap = MUST(bitmap->clone());
+        for (int y = 1; y < bitmap->height(); ++y) {
+            for (int x = 1; x < bitmap->width(); ++x)
+                expected_bitmap->set_pixel(x, y, expected_bitmap->get_pixel(x, y).blend(color));
+        }
+
+        Gfx::Painter painter(bitmap);
+        painter.fill_rect({ 1, 1, 10, 5 }, color);
+
+        for (int y = 0; y < bitmap->height(); ++y) {
+            for (int x = 0; x < bitmap->width(); ++x)
+                EXPECT_EQ(bitmap->get_pixel(x, y), expected_bitmap->get_pixel(x, y));
+        }
+    }
+}
+
+TEST_CASE(fill_path_with_translucent_color)
+{
+    Gfx::Path path;
+    path.move_to({ 2, 2 });
+    path.line_to({ 18, 2 });
+    path.line_to({ 18, 18 });
+    path.line_to({ 2, 18 });
+    path.close();
+
+    auto color = Color(255, 0, 0, 128);
+    auto even_odd_bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { 20, 20 }));
+    even_odd_bitmap->fill(Color::White);
+    Gfx::Painter even_odd_painter(even_odd_bitmap);
+    even_odd_painter.fill_path(path, color, Gfx::Painter::WindingRule::EvenOdd);
+
+    auto non_zero_bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { 20, 20 }));
+    non_zero_bitmap->fill(Color::White);
+    Gfx::Painter non_zero_painter(non_zero_bitmap);
+    non_zero_painter.fill_path(path, color, Gfx::Painter::WindingRule::Nonzero);
+
+    // Fully covered pixels are blended as whole spans.
+    EXPECT_EQ(even_odd_bitmap->get_pixel(10, 10), Color(Color::White).blend(color));
+    EXPECT_EQ(even_odd_bitmap->get_pixel(0, 0), Color::White);
+    for (int y = 0; y < even_odd_bitmap->height(); ++y) {
+        for (int x = 0; x < even_odd_bitmap->width(); ++x)
+            EXPECT_EQ(even_odd_bitmap->get_pixel(x, y), non_zero_bitmap->get_pixel(x, y));
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Filters/StackBlurFilter.h>
+#include <LibTest/TestCase.h>
+
+static NonnullRefPtr<Gfx::Bitmap> create_bitmap_with_square(Gfx::IntSize size, Gfx::IntRect square)
+{
+    auto bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, size));
+    bitmap->fill(Gfx::Color::Transparent);
+    for (int y = square.top(); y < square.bottom(); ++y) {
+        for (int x = square.left(); x < square.right(); ++x)
+            bitmap->set_pixel(x, y, Gfx::Color::Red);
+    }
+    return bitmap;
+}
+
+TEST_CASE(blur_uniform_bitmap)
+{
+    auto bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 37, 21 }));
+    bitmap->fill(Gfx::Color(0x12, 0x34, 0x56));
+
+    Gfx::StackBlurFilter { *bitmap }.process_rgba(5);
+    for (int y = 0; y < bitmap->height(); ++y) {
+        for (int x = 0; x < bitmap->width(); ++x)
+            EXPECT_EQ(bitmap->get_pixel(x, y), Gfx::Color(0x12, 0x34, 0x56));
+    }
+}
+
+TEST_CASE(blur_is_symmetric)
+{
+    // 50 columns is more than one band of lines, and the square is in the middle of both bands.
+    auto bitmap = create_bitmap_with_square({ 50, 50 }, { 20, 20, 10, 10 });
+    Gfx::StackBlurFilter { *bitmap }.process_rgba(8, Gfx::Color::Red);
+
+    for (int y = 0; y < 50; ++y) {
+        for (int x = 0; x < 50; ++x) {
+            auto color = bitmap->get_pixel(x, y);
+            EXPECT_EQ(color, bitmap->get_pixel(49 - x, y));
+            EXPECT_EQ(color, bitmap->get_pixel(x, 49 - y));
+        }
+    }
+
+    EXPECT(bitmap->get_pixel(25, 25).alpha() > bitmap->get_pixel(15, 25).alpha());
+    EXPECT(bitmap->get_pixel(15, 25).alpha() > 0);
+    EXPECT_EQ(bitmap->get_pixel(0, 0).alpha(), 0);
+}
+
+TEST_CASE(blur_large_bitmap_matches_small_bitmap)
+{
+    // The large bitmap is blurred on several threads. Far away from the edges, it has to look like the small one.
+    auto small_bitmap = create_bitmap_with_square({ 64, 64 }, { 24, 24, 16, 16 });
+    auto large_bitmap = create_bitmap_with_square({ 700, 500 }, { 324, 224, 16, 16 });
+
+    Gfx::StackBlurFilter { *small_bitmap }.process_rgba(10, Gfx::Color::Red);
+    Gfx::StackBlurFilter { *large_bitmap }.process_rgba(10, Gfx::Color::Red);
+
+    for (int y = 0; y < 64; ++y) {
+        for (int x = 0; x < 64; ++x)
+            EXPECT_EQ(small_bitmap->get_pixel(x, y), large_bitmap->get_pixel(x + 300, y + 200));
+    }
+}
+
+TEST_CASE(blur_with_radius_above_255)
+{
+    auto bitmap = create_bitmap_with_square({ 800, 800 }, { 350, 350, 100, 100 });
+    Gfx::StackBlurFilter { *bitmap }.process_rgba(600, Gfx::Color::Red);
+
+    // The square is spread out over the whole bitmap, so nothing is opaque anymore, but nothing is fully transparent either.
+    auto center = bitmap->get_pixel(400, 400);
+    EXPECT(center.alpha() > 0);
+    EXPECT(center.alpha() < 64);
+    EXPECT(bitmap->get_pixel(400, 0).alpha() <= center.alpha());
+}
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibGfx/Font/GlyphBitmapCache.h>
 #include <LibGfx/Font/WOFF2/Font.h>
 #include <LibTest/TestCase.h>
 
@@ -34,3 +35,49 @@ TEST_CASE(malformed_woff2)
         EXPECT(font_or_error.is_error());
     }
 }
+
+TEST_CASE(glyph_bitmap_cache)
+{
+    auto& cache = Gfx::GlyphBitmapCache::the();
+    auto initial_size = cache.size_in_bytes();
+
+    auto file = MUST(Core::MappedFile::map(TEST_INPUT("woff2/incorrect_sfnt_size.woff2"sv)));
+    {
+        auto font = TRY_OR_FAIL(WOFF2::Font::try_load_from_externally_owned_memory(file->bytes()));
+        auto bitmap = cache.rasterize_glyph(*font, 1.0f, 1.0f, 1, { 0, 0 });
+        auto size_with_one_glyph = cache.size_in_bytes();
+        EXPECT(size_with_one_glyph > initial_size);
+
+        // The second lookup is served from the cache...
+        EXPECT_EQ(cache.rasterize_glyph(*font, 1.0f, 1.0f, 1, { 0, 0 }), bitmap);
+        EXPECT_EQ(cache.size_in_bytes(), size_with_one_glyph);
+
+        // ...while other subpixel offsets and scales are separate glyphs.
+        (void)cache.rasterize_glyph(*font, 1.0f, 1.0f, 1, { 1, 0 });
+        (void)cache.rasterize_glyph(*font, 2.0f, 2.0f, 1, { 0, 0 });
+        EXPECT(cache.size_in_bytes() > size_with_one_glyph);
+    }
+
+    // Glyphs of a typeface are dropped along with it.
+    EXPECT_EQ(cache.size_in_bytes(), initial_size);
+}
+
+TEST_CASE(glyph_bitmap_cache_budget)
+{
+    auto& cache = Gfx::GlyphBitmapCache::the();
+    auto file = MUST(Core::MappedFile::map(TEST_INPUT("woff2/incorrect_sfnt_size.woff2"sv)));
+    auto font = TRY_OR_FAIL(WOFF2::Font::try_load_from_externally_owned_memory(file->bytes()));
+
+    for (u32 glyph_id = 0; glyph_id < font->glyph_count(); ++glyph_id)
+        (void)cache.rasterize_glyph(*font, 1.0f, 1.0f, glyph_id, { 0, 0 });
+    EXPECT(cache.size_in_bytes() > 0);
+
+    cache.set_budget_in_bytes(0);
+    EXPECT_EQ(cache.size_in_bytes(), 0u);
+
+    // Glyphs are still handed out when the cache can't hold on to them.
+    (void)cache.rasterize_glyph(*font, 1.0f, 1.0f, 1, { 0, 0 });
+    EXPECT_EQ(cache.size_in_bytes(), 0u);
+
+    cache.set_budget_in_bytes(Gfx::GlyphBitmapCache::default_budget_in_bytes);
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Hex.h>
+#include <LibHTTP/HPack.h>
+
+using HTTP::HPack::Header;
+
+static void expect_headers(Vector<Header> const& actual, Vector<Header> const& expected)
+{
+    EXPECT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < min(actual.size(), expected.size()); ++i) {
+        EXPECT_EQ(actual[i].name, expected[i].name);
+        EXPECT_EQ(actual[i].value, expected[i].value);
+    }
+}
+
+static Vector<Header> decode(HTTP::HPack::Decoder& decoder, StringView hex_encoded_header_block)
+{
+    auto header_block = MUST(decode_hex(hex_encoded_header_block));
+    return MUST(decoder.decode(header_block));
+}
+
+static Vector<Header> const first_request { { ":method", "GET" }, { ":scheme", "http" }, { ":path", "/" }, { ":authority", "www.example.com" } };
+static Vector<Header> const second_request { { ":method", "GET" }, { ":scheme", "http" }, { ":path", "/" }, { ":authority", "www.example.com" }, { "cache-control", "no-cache" } };
+static Vector<Header> const third_request { { ":method", "GET" }, { ":scheme", "https" }, { ":path", "/index.html" }, { ":authority", "www.example.com" }, { "custom-key", "custom-value" } };
+
+// https://www.rfc-editor.org/rfc/rfc7541#appendix-C.3
+TEST_CASE(decode_requests_without_huffman_coding)
+{
+    HTTP::HPack::Decoder decoder;
+
+    expect_headers(decode(decoder, "828684410f7777772e6578616d706c652e636f6d"sv), first_request);
+    EXPECT_EQ(decoder.dynamic_table().size(), 57u);
+
+    expect_headers(decode(decoder, "828684be58086e6f2d6361636865"sv), second_request);
+    EXPECT_EQ(decoder.dynamic_table().size(), 110u);
+
+    expect_headers(decode(decoder, "828785bf400a637573746f6d2d6b65790c637573746f6d2d76616c7565"sv), third_request);
+    EXPECT_EQ(decoder.dynamic_table().size(), 164u);
+}
+
+// https://www.rfc-editor.org/rfc/rfc7541#appendix-C.4
+TEST_CASE(encode_and_decode_requests_with_huffman_coding)
+{
+    HTTP::HPack::Encoder encoder;
+    HTTP::HPack::Decoder decoder;
+
+    auto check = [&](Vector<Header> const& headers, StringView expected_hex_encoded_header_block) {
+        auto header_block = encoder.encode(headers);
+        EXPECT_EQ(encode_hex(header_block), expected_hex_encoded_header_block);
+        expect_headers(MUST(decoder.decode(header_block)), headers);
+        EXPECT_EQ(decoder.dynamic_table().size(), encoder.dynamic_table().size());
+    };
+
+    check(first_request, "828684418cf1e3c2e5f23a6ba0ab90f4ff"sv);
+    check(second_request, "828684be5886a8eb10649cbf"sv);
+    check(third_request, "828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf"sv);
+    EXPECT_EQ(decoder.dynamic_table().size(), 164u);
+}
+
+// https://www.rfc-editor.org/rfc/rfc7541#appendix-C.6
+TEST_CASE(decode_responses_with_eviction)
+{
+    HTTP::HPack::Decoder decoder { 256 };
+
+    expect_headers(decode(decoder, "488264025885aec3771a4b6196d07abe941054d444a8200595040b8166e082a62d1bff6e919d29ad171863c78f0b97c8e9ae82ae43d3"sv),
+        { { ":status", "302" }, { "cache-control", "private" }, { "date", "Mon, 21 Oct 2013 20:13:21 GMT" }, { "location", "https://www.example.com" } });
+    EXPECT_EQ(decoder.dynamic_table().size(), 222u);
+
+    expect_headers(decode(decoder, "4883640effc1c0bf"sv),
+        { { ":status", "307" }, { "cache-control", "private" }, { "date", "Mon, 21 Oct 2013 20:13:21 GMT" }, { "location", "https://www.example.com" } });
+    EXPECT_EQ(decoder.dynamic_table().size(), 222u);
+
+    expect_headers(decode(decoder, "88c16196d07abe941054d444a8200595040b8166e084a62d1bffc05a839bd9ab77ad94e7821dd7f2e6c7b335dfdfcd5b3960d5af27087f3672c1ab270fb5291f9587316065c003ed4ee5b1063d5007"sv),
+        { { ":status", "200" }, { "cache-control", "private" }, { "date", "Mon, 21 Oct 2013 20:13:22 GMT" }, { "location", "https://www.example.com" }, { "content-encoding", "gzip" }, { "set-cookie", "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1" } });
+    EXPECT_EQ(decoder.dynamic_table().size(), 215u);
+    EXPECT_EQ(decoder.dynamic_table().entry_count(), 3u);
+}
+
+TEST_CASE(huffman_round_trip)
+{
+    for (size_t byte = 0; byte < 256; ++byte) {
+        auto string = ByteString::repeated(static_cast<char>(byte), 3);
+        ByteBuffer encoded;
+        HTTP::HPack::encode_huffman(encoded, string);
+        EXPECT_EQ(encoded.size(), HTTP::HPack::huffman_encoded_length(string));
+        EXPECT_EQ(MUST(HTTP::HPack::decode_huffman(encoded)), string);
+    }
+}
+
+TEST_CASE(reject_invalid_header_blocks)
+{
+    auto fails_to_decode = [](StringView hex_encoded_header_block) {
+        HTTP::HPack::Decoder decoder;
+        return decoder.decode(MUST(decode_hex(hex_encoded_header_block))).is_error();
+    };
+
+    // Index 0, and an index past the end of the empty dynamic table.
+    EXPECT(fails_to_decode("80"sv));
+    EXPECT(fails_to_decode("be"sv));
+
+    // A string that is longer than the header block.
+    EXPECT(fails_to_decode("4005"sv));
+
+    // A Huffman-encoded "a" followed by 11 bits of padding, when padding must be shorter than a byte.
+    EXPECT(fails_to_decode("00821fff00"sv));
+
+    // A dynamic table size update larger than the default limit, and one after a header field.
+    EXPECT(fails_to_decode("3fe21f"sv));
+    EXPECT(fails_to_decode("823f01"sv));
+}
+
+TEST_CASE(dynamic_table_size_updates)
+{
+    HTTP::HPack::Encoder encoder;
+    HTTP::HPack::Decoder decoder;
+
+    expect_headers(MUST(decoder.decode(encoder.encode(first_request))), first_request);
+    EXPECT_EQ(decoder.dynamic_table().entry_count(), 1u);
+
+    // Shrinking the table to nothing and growing it again must still evict everything on the other end.
+    encoder.set_maximum_dynamic_table_size(0);
+    encoder.set_maximum_dynamic_table_size(100);
+    auto header_block = encoder.encode(first_request);
+    EXPECT_EQ(encode_hex(header_block.bytes().trim(3)), "203f45"sv);
+    expect_headers(MUST(decoder.decode(header_block)), first_request);
+    EXPECT_EQ(decoder.dynamic_table().maximum_size(), 100u);
+    EXPECT_EQ(decoder.dynamic_table().entry_count(), 1u);
+}
+
+TEST_CASE(sensitive_headers_are_never_indexed)
+{
+    HTTP::HPack::Encoder encoder;
+    auto header_block = encoder.encode(Vector<Header> { { "Authorization", "Basic c2VjcmV0" } });
+    EXPECT_EQ(header_block[0] & 0xf0, 0x10);
+    EXPECT_EQ(encoder.dynamic_table().entry_count(), 0u);
+
+    HTTP::HPack::Decoder decoder;
+    expect_headers(MUST(decoder.decode(header_block)), { { "authorization", "Basic c2VjcmV0" } });
+    EXPECT_EQ(decoder.dynamic_table().entry_count(), 0u);
+}
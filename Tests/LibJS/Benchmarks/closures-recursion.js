@@ -0,0 +1,41 @@
+// Recursive calls, closures and generators, like Octane's EarleyBoyer and Kraken's function-heavy tests.
+
+function fib(n) {
+    return n < 2 ? n : fib(n - 1) + fib(n - 2);
+}
+
+function makeCounter() {
+    let count = 0;
+    return {
+        increment: () => ++count,
+        get: () => count,
+    };
+}
+
+function* range(start, end) {
+    for (let i = start; i < end; ++i) yield i;
+}
+
+function compose(...functions) {
+    return value => functions.reduceRight((accumulator, f) => f(accumulator), value);
+}
+
+if (fib(25) !== 75025) throw new Error("Wrong fib(25)");
+
+const counters = [];
+for (let i = 0; i < 1000; ++i) counters.push(makeCounter());
+for (let round = 0; round < 100; ++round) {
+    for (const counter of counters) counter.increment();
+}
+if (counters.reduce((sum, counter) => sum + counter.get(), 0) !== 100000) throw new Error("Wrong counter sum");
+
+let sum = 0;
+for (const value of range(0, 100000)) sum += value;
+if (sum !== 4999950000) throw new Error("Wrong range sum: " + sum);
+
+const addOne = x => x + 1;
+const double = x => x * 2;
+const pipeline = compose(addOne, double, addOne);
+let result = 0;
+for (let i = 0; i < 50000; ++i) result = pipeline(i);
+if (result !== 2 * 50000 + 1) throw new Error("Wrong pipeline result: " + result);
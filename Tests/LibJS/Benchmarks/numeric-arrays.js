@@ -0,0 +1,67 @@
+// Blurs a grayscale image and multiplies matrices, like Kraken's imaging and Octane's NavierStokes. Mostly array
+// accesses and floating-point arithmetic.
+
+const width = 200;
+const height = 200;
+const image = new Float64Array(width * height);
+for (let y = 0; y < height; ++y) {
+    for (let x = 0; x < width; ++x)
+        image[y * width + x] = ((x * y) % 255) / 255;
+}
+
+function blur(source, radius) {
+    const result = new Float64Array(source.length);
+    for (let y = 0; y < height; ++y) {
+        for (let x = 0; x < width; ++x) {
+            let sum = 0;
+            let count = 0;
+            for (let dy = -radius; dy <= radius; ++dy) {
+                const sy = y + dy;
+                if (sy < 0 || sy >= height) continue;
+                for (let dx = -radius; dx <= radius; ++dx) {
+                    const sx = x + dx;
+                    if (sx < 0 || sx >= width) continue;
+                    sum += source[sy * width + sx];
+                    ++count;
+                }
+            }
+            result[y * width + x] = sum / count;
+        }
+    }
+    return result;
+}
+
+const blurred = blur(image, 2);
+let average = 0;
+for (const value of blurred) average += value;
+average /= blurred.length;
+if (!(average > 0.4 && average < 0.6)) throw new Error("Wrong average: " + average);
+
+const size = 80;
+const a = [];
+const b = [];
+for (let i = 0; i < size; ++i) {
+    a.push([]);
+    b.push([]);
+    for (let j = 0; j < size; ++j) {
+        a[i].push(i === j ? 2 : 0);
+        b[i].push(i + j);
+    }
+}
+
+const c = [];
+for (let i = 0; i < size; ++i) {
+    const row = new Array(size).fill(0);
+    for (let k = 0; k < size; ++k) {
+        const aik = a[i][k];
+        for (let j = 0; j < size; ++j)
+            row[j] += aik * b[k][j];
+    }
+    c.push(row);
+}
+
+for (let i = 0; i < size; ++i) {
+    for (let j = 0; j < size; ++j) {
+        if (c[i][j] !== 2 * (i + j)) throw new Error("Wrong product at " + i + "," + j);
+    }
+}
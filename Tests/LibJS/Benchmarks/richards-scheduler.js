@@ -0,0 +1,91 @@
+// A small task scheduler in the spirit of Octane's Richards: polymorphic method calls and property accesses.
+
+class Packet {
+    constructor(link, id, kind) {
+        this.link = link;
+        this.id = id;
+        this.kind = kind;
+        this.count = 0;
+    }
+}
+
+class Task {
+    constructor(scheduler, id, priority) {
+        this.scheduler = scheduler;
+        this.id = id;
+        this.priority = priority;
+        this.queue = [];
+        this.processed = 0;
+    }
+
+    enqueue(packet) {
+        this.queue.push(packet);
+    }
+
+    hasWork() {
+        return this.queue.length > 0;
+    }
+}
+
+class IdleTask extends Task {
+    run() {
+        const packet = new Packet(null, this.id, 0);
+        this.scheduler.send(packet, 1 + (this.processed++ % 3));
+    }
+
+    hasWork() {
+        return this.scheduler.idleBudget-- > 0;
+    }
+}
+
+class WorkerTask extends Task {
+    run() {
+        const packet = this.queue.shift();
+        packet.count += this.id;
+        ++this.processed;
+        this.scheduler.send(packet, 4);
+    }
+}
+
+class DeviceTask extends Task {
+    run() {
+        const packet = this.queue.shift();
+        packet.count *= 2;
+        ++this.processed;
+        this.scheduler.checksum = (this.scheduler.checksum + packet.count) | 0;
+    }
+}
+
+class Scheduler {
+    constructor(idleBudget) {
+        this.idleBudget = idleBudget;
+        this.checksum = 0;
+        this.tasks = [new IdleTask(this, 0, 0), new WorkerTask(this, 1, 1), new WorkerTask(this, 2, 1), new WorkerTask(this, 3, 2), new DeviceTask(this, 4, 3)];
+    }
+
+    send(packet, taskId) {
+        this.tasks[taskId].enqueue(packet);
+    }
+
+    schedule() {
+        let didWork = true;
+        while (didWork) {
+            didWork = false;
+            for (let i = this.tasks.length - 1; i >= 0; --i) {
+                const task = this.tasks[i];
+                if (task.hasWork()) {
+                    task.run();
+                    didWork = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+const scheduler = new Scheduler(100000);
+scheduler.schedule();
+
+const processed = scheduler.tasks.map(task => task.processed);
+if (processed[0] !== 100000 || processed[4] !== 100000) throw new Error("Wrong task counts: " + processed);
+if (scheduler.checksum !== 399998) throw new Error("Wrong checksum: " + scheduler.checksum);
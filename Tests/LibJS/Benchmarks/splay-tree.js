@@ -0,0 +1,143 @@
+// Inserts and removes nodes of a splay tree with payloads, like Octane's Splay. Mostly stresses the GC.
+
+class Node {
+    constructor(key, value) {
+        this.key = key;
+        this.value = value;
+        this.left = null;
+        this.right = null;
+    }
+}
+
+class SplayTree {
+    constructor() {
+        this.root = null;
+    }
+
+    splay(key) {
+        if (this.root === null) return;
+        const dummy = new Node(null, null);
+        let left = dummy;
+        let right = dummy;
+        let current = this.root;
+        while (true) {
+            if (key < current.key) {
+                if (current.left === null) break;
+                if (key < current.left.key) {
+                    const tmp = current.left;
+                    current.left = tmp.right;
+                    tmp.right = current;
+                    current = tmp;
+                    if (current.left === null) break;
+                }
+                right.left = current;
+                right = current;
+                current = current.left;
+            } else if (key > current.key) {
+                if (current.right === null) break;
+                if (key > current.right.key) {
+                    const tmp = current.right;
+                    current.right = tmp.left;
+                    tmp.left = current;
+                    current = tmp;
+                    if (current.right === null) break;
+                }
+                left.right = current;
+                left = current;
+                current = current.right;
+            } else {
+                break;
+            }
+        }
+        left.right = current.left;
+        right.left = current.right;
+        current.left = dummy.right;
+        current.right = dummy.left;
+        this.root = current;
+    }
+
+    insert(key, value) {
+        if (this.root === null) {
+            this.root = new Node(key, value);
+            return;
+        }
+        this.splay(key);
+        if (this.root.key === key) return;
+        const node = new Node(key, value);
+        if (key > this.root.key) {
+            node.left = this.root;
+            node.right = this.root.right;
+            this.root.right = null;
+        } else {
+            node.right = this.root;
+            node.left = this.root.left;
+            this.root.left = null;
+        }
+        this.root = node;
+    }
+
+    remove(key) {
+        this.splay(key);
+        if (this.root === null || this.root.key !== key) return false;
+        if (this.root.left === null) {
+            this.root = this.root.right;
+        } else {
+            const right = this.root.right;
+            this.root = this.root.left;
+            this.splay(key);
+            this.root.right = right;
+        }
+        return true;
+    }
+
+    size() {
+        let count = 0;
+        const stack = [];
+        if (this.root !== null) stack.push(this.root);
+        while (stack.length > 0) {
+            const node = stack.pop();
+            ++count;
+            if (node.left !== null) stack.push(node.left);
+            if (node.right !== null) stack.push(node.right);
+        }
+        return count;
+    }
+}
+
+function makePayload(depth, key) {
+    if (depth === 0) return { array: [0, 1, 2, 3, 4, 5, 6, 7, 8, 9], string: "String for key " + key };
+    return { left: makePayload(depth - 1, key), right: makePayload(depth - 1, key) };
+}
+
+let seed = 49734321;
+function random() {
+    seed = (Math.imul(seed, 1103515245) + 12345) & 0x7fffffff;
+    return seed;
+}
+
+const present = new Set();
+function randomUnusedKey() {
+    let key = random();
+    while (present.has(key)) key = random();
+    present.add(key);
+    return key;
+}
+
+const tree = new SplayTree();
+const keys = [];
+for (let i = 0; i < 4000; ++i) {
+    const key = randomUnusedKey();
+    keys.push(key);
+    tree.insert(key, makePayload(3, key));
+}
+
+for (let i = 0; i < 20000; ++i) {
+    const index = random() % keys.length;
+    if (!tree.remove(keys[index])) throw new Error("Failed to remove key " + keys[index]);
+    present.delete(keys[index]);
+    const key = randomUnusedKey();
+    keys[index] = key;
+    tree.insert(key, makePayload(3, key));
+}
+
+if (tree.size() !== keys.length) throw new Error("Wrong tree size: " + tree.size());
@@ -0,0 +1,33 @@
+// Builds, splits, searches and rewrites strings, like Kraken's JSON and string tests.
+
+const words = ["lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing", "elit", "sed", "do"];
+
+let text = "";
+for (let i = 0; i < 20000; ++i) {
+    text += words[(i * 7) % words.length];
+    text += i % 10 === 9 ? ".\n" : " ";
+}
+
+const lines = text.split("\n");
+let capitalized = 0;
+const rewritten = lines.map(line => {
+    const trimmed = line.trim();
+    if (trimmed.length === 0) return trimmed;
+    ++capitalized;
+    return trimmed[0].toUpperCase() + trimmed.slice(1).replace(/\bsit\b/g, "SIT");
+});
+
+const counts = new Map();
+for (const word of text.split(/[\s.]+/)) {
+    if (word.length === 0) continue;
+    counts.set(word, (counts.get(word) ?? 0) + 1);
+}
+
+const summary = JSON.stringify(Object.fromEntries(counts));
+const parsed = JSON.parse(summary);
+
+let total = 0;
+for (const word of words) total += parsed[word];
+if (total !== 20000) throw new Error("Wrong word count: " + total);
+if (capitalized !== 2000) throw new Error("Wrong line count: " + capitalized);
+if (rewritten.join("\n").split("SIT").length - 1 !== parsed["sit"]) throw new Error("Wrong replacement count");
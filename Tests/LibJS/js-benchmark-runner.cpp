@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteString.h>
+#include <AK/Format.h>
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/LexicalPath.h>
+#include <AK/QuickSort.h>
+#include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/DirIterator.h>
+#include <LibCore/Directory.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/File.h>
+#include <LibFileSystem/FileSystem.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Runtime/ValueInlines.h>
+#include <LibJS/Script.h>
+#include <LibMain/Main.h>
+#include <math.h>
+
+// Runs each benchmark script in a fresh VM, so that no run benefits from caches, shapes or a heap warmed up by an
+// earlier one. Benchmarks are plain scripts that throw if they computed the wrong result.
+
+struct BenchmarkRun {
+    Duration parse_time;
+    Duration run_time;
+    u64 garbage_collections { 0 };
+    Duration total_gc_pause_time;
+    Duration longest_gc_pause_time;
+    JS::Bytecode::PropertyLookupCacheStatistics property_lookups;
+    u64 executed_instructions { 0 };
+};
+
+static double to_milliseconds(Duration duration)
+{
+    return static_cast<double>(duration.to_microseconds()) / 1000.0;
+}
+
+static ErrorOr<BenchmarkRun> run_benchmark(StringView path, StringView source, bool collect_execution_statistics)
+{
+    auto vm = TRY(JS::VM::create());
+    auto root_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+    auto& realm = *root_execution_context->realm;
+
+    auto& interpreter = vm->bytecode_interpreter();
+    if (collect_execution_statistics)
+        interpreter.set_collects_execution_statistics(true);
+
+    BenchmarkRun run;
+
+    auto timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+    auto script_or_error = JS::Script::parse(source, realm, path);
+    if (script_or_error.is_error()) {
+        warnln("{}: {}", path, script_or_error.error()[0].to_byte_string());
+        return Error::from_string_literal("Failed to parse benchmark");
+    }
+    run.parse_time = timer.elapsed_time();
+
+    timer.start();
+    auto result = interpreter.run(*script_or_error.value());
+    run.run_time = timer.elapsed_time();
+
+    if (result.is_error()) {
+        auto error = result.throw_completion().value()->to_string_without_side_effects();
+        warnln("{}: Uncaught exception: {}", path, error);
+        return Error::from_string_literal("Benchmark threw an exception");
+    }
+
+    auto const& gc_statistics = vm->heap().garbage_collection_statistics();
+    run.garbage_collections = gc_statistics.number_of_collections;
+    run.total_gc_pause_time = gc_statistics.total_pause_time;
+    run.longest_gc_pause_time = gc_statistics.longest_pause_time;
+    run.property_lookups = interpreter.property_lookup_cache_statistics();
+    if (collect_execution_statistics)
+        run.executed_instructions = interpreter.executed_instructions();
+
+    return run;
+}
+
+static JsonObject run_to_json(BenchmarkRun const& run)
+{
+    JsonObject object;
+    object.set("parse_ms", to_milliseconds(run.parse_time));
+    object.set("run_ms", to_milliseconds(run.run_time));
+    object.set("gc_collections", run.garbage_collections);
+    object.set("gc_total_pause_ms", to_milliseconds(run.total_gc_pause_time));
+    object.set("gc_longest_pause_ms", to_milliseconds(run.longest_gc_pause_time));
+    return object;
+}
+
+static JsonObject property_lookups_to_json(JS::Bytecode::PropertyLookupCacheStatistics const& statistics)
+{
+    JsonObject object;
+    object.set("monomorphic_hits", statistics.monomorphic_hits);
+    object.set("polymorphic_hits", statistics.polymorphic_hits);
+    object.set("megamorphic_hits", statistics.megamorphic_hits);
+    object.set("misses", statistics.misses);
+    object.set("sites_gone_megamorphic", statistics.sites_gone_megamorphic);
+    return object;
+}
+
+static ErrorOr<void> collect_benchmarks(Vector<ByteString>& paths, StringView path)
+{
+    if (!FileSystem::is_directory(path)) {
+        TRY(paths.try_append(path));
+        return {};
+    }
+
+    TRY(Core::Directory::for_each_entry(path, Core::DirIterator::SkipDots, [&](Core::DirectoryEntry const& entry, Core::Directory const&) -> ErrorOr<IterationDecision> {
+        if (entry.type != Core::DirectoryEntry::Type::Directory && entry.name.ends_with(".js"sv))
+            TRY(paths.try_append(LexicalPath::join(path, entry.name).string()));
+        return IterationDecision::Continue;
+    }));
+    return {};
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    Vector<StringView> benchmark_paths;
+    int iterations = 5;
+    bool collect_execution_statistics = false;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Run JavaScript benchmarks and print their timings, GC pauses and bytecode statistics as JSON.");
+    args_parser.add_option(iterations, "Number of timed runs of each benchmark (default: 5)", "iterations", 'n', "n");
+    args_parser.add_option(collect_execution_statistics, "Count the executed bytecode instructions in one extra, untimed run of each benchmark", "execution-statistics", 's');
+    args_parser.add_positional_argument(benchmark_paths, "Benchmark scripts, or directories of them", "paths");
+    args_parser.parse(arguments);
+
+    if (iterations <= 0) {
+        warnln("Invalid number of iterations: {}", iterations);
+        return 1;
+    }
+
+    Vector<ByteString> paths;
+    for (auto path : benchmark_paths)
+        TRY(collect_benchmarks(paths, path));
+    quick_sort(paths);
+
+    JsonArray benchmarks;
+    double sum_of_log_median_run_times = 0;
+
+    for (auto const& path : paths) {
+        warnln("Running {}", path);
+
+        auto file = TRY(Core::File::open(path, Core::File::OpenMode::Read));
+        auto source = TRY(file->read_until_eof());
+
+        Vector<BenchmarkRun> runs;
+        JsonArray runs_json;
+        for (int i = 0; i < iterations; ++i) {
+            auto run = TRY(run_benchmark(path, source, false));
+            runs_json.must_append(run_to_json(run));
+            TRY(runs.try_append(move(run)));
+        }
+
+        quick_sort(runs, [](auto const& a, auto const& b) { return a.run_time < b.run_time; });
+        auto const& median_run = runs[runs.size() / 2];
+        auto median_run_ms = max(to_milliseconds(median_run.run_time), 0.001);
+        sum_of_log_median_run_times += log(median_run_ms);
+
+        JsonObject benchmark;
+        benchmark.set("name", LexicalPath::title(path));
+        benchmark.set("median_run_ms", median_run_ms);
+        benchmark.set("runs", move(runs_json));
+        benchmark.set("property_lookups", property_lookups_to_json(median_run.property_lookups));
+
+        if (collect_execution_statistics) {
+            auto run = TRY(run_benchmark(path, source, true));
+            benchmark.set("executed_instructions", run.executed_instructions);
+        }
+
+        benchmarks.must_append(move(benchmark));
+    }
+
+    // Like Octane and Kraken, summarize all benchmarks with a geometric mean, so that no single benchmark dominates.
+    // The score is the number of times per second that an "average" benchmark could run, i.e. higher is better.
+    JsonObject report;
+    report.set("iterations", iterations);
+    report.set("benchmarks", move(benchmarks));
+    if (!paths.is_empty()) {
+        auto geometric_mean_ms = exp(sum_of_log_median_run_times / paths.size());
+        report.set("geometric_mean_run_ms", geometric_mean_ms);
+        report.set("score", 1000.0 / geometric_mean_ms);
+    }
+    outln("{}", report.to_byte_string());
+
+    return 0;
+}
@@ -998,6 +998,20 @@ BENCHMARK_CASE(fork_performance)
     EXPECT_EQ(result.success, true);
 }
 
+BENCHMARK_CASE(prefilter_literal_prefix)
+{
+    Regex<ECMA262> re("foo\\d+");
+    auto result = re.search(ByteString::formatted("{}foo42", g_lots_of_a_s));
+    EXPECT_EQ(result.success, true);
+}
+
+BENCHMARK_CASE(prefilter_starting_bytes)
+{
+    Regex<ECMA262> re("[xyz]\\d+");
+    auto result = re.search(ByteString::formatted("{}y42", g_lots_of_a_s));
+    EXPECT_EQ(result.success, true);
+}
+
 TEST_CASE(optimizer_atomic_groups)
 {
     Array tests {
@@ -1078,6 +1092,73 @@ TEST_CASE(optimizer_alternation)
     }
 }
 
+TEST_CASE(lazy_dfa)
+{
+    Array tests {
+        // Pattern, Subject, Expected match
+        Tuple { "a+b"sv, "xaab ab"sv, "aab"sv },
+        Tuple { "a*?b"sv, "aab"sv, "aab"sv },
+        Tuple { "x[a-z]+?y"sv, "xabyzy"sv, "xaby"sv },
+        Tuple { "foo|foobar|fo"sv, "foobar"sv, "foo"sv },
+        Tuple { "(?:ab|a)(?:bc|c)?"sv, "abc"sv, "abc"sv },
+        Tuple { "^ab*"sv, "abbbc"sv, "abbb"sv },
+        Tuple { "ab*$"sv, "abab"sv, "ab"sv },
+        Tuple { "(?:x|y|)*z"sv, "xyxyqxz"sv, "xz"sv },
+        // These take exponential time to backtrack through.
+        Tuple { "(a|a)*b"sv, "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaab"sv, "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaab"sv },
+        Tuple { "(?:a|b|)+?c"sv, "zzaabc"sv, "aabc"sv },
+    };
+
+    for (auto& test : tests) {
+        Regex<ECMA262> re(test.get<0>(), (ECMAScriptFlags)regex::AllFlags::SkipSubExprResults);
+        EXPECT(re.lazy_dfa);
+
+        auto result = re.search(test.get<1>());
+        EXPECT(result.success);
+        EXPECT_EQ(result.matches.first().view.string_view(), test.get<2>());
+    }
+
+    // Backreferences and lookarounds still need the backtracking matcher.
+    Regex<ECMA262> has_backreference("(a)\\1"sv);
+    EXPECT(!has_backreference.lazy_dfa);
+
+    Regex<ECMA262> has_lookahead("a(?=b)"sv);
+    EXPECT(!has_lookahead.lazy_dfa);
+}
+
+TEST_CASE(search_prefilter)
+{
+    Array tests {
+        // Pattern, Subject, Expected matches
+        Tuple { "foo\\d+"sv, "foo fo1 foo12 xfoo3"sv, Vector { "foo12"sv, "foo3"sv } },
+        Tuple { "(?:ab|a)1"sv, "a ab1 a1 b1"sv, Vector { "ab1"sv, "a1"sv } },
+        Tuple { "[xy]z+"sv, "az xzz yz"sv, Vector { "xzz"sv, "yz"sv } },
+        Tuple { "\\d+\\.\\d*"sv, "v1.2 and 10. or ."sv, Vector { "1.2"sv, "10."sv } },
+    };
+
+    for (auto& test : tests) {
+        Regex<ECMA262> re(test.get<0>());
+        auto result = re.search(test.get<1>());
+        EXPECT_EQ(result.matches.size(), test.get<2>().size());
+        for (size_t i = 0; i < min(result.matches.size(), test.get<2>().size()); ++i)
+            EXPECT_EQ(result.matches[i].view.string_view(), test.get<2>()[i]);
+    }
+
+    Regex<ECMA262> prefix("foo\\d+"sv);
+    EXPECT_EQ(prefix.parser_result.optimization_data.literal_prefix, "foo"sv);
+
+    // A case insensitive pattern can't look for its prefix as is, but still knows which bytes it can start with.
+    Regex<ECMA262> insensitive("foo\\d+"sv, ECMAScriptFlags::Insensitive);
+    EXPECT(!insensitive.parser_result.optimization_data.literal_prefix.has_value());
+    EXPECT(insensitive.parser_result.optimization_data.starting_bytes.has_value());
+    EXPECT_EQ(insensitive.search("FOO1 fOo2"sv).matches.size(), 2u);
+
+    // Patterns that can match the empty string start anywhere.
+    Regex<ECMA262> optional("a*"sv);
+    EXPECT(!optional.parser_result.optimization_data.literal_prefix.has_value());
+    EXPECT(!optional.parser_result.optimization_data.starting_bytes.has_value());
+}
+
 TEST_CASE(posix_basic_dollar_is_end_anchor)
 {
     // Ensure that a dollar sign at the end only matches the end of the line.
@@ -192,3 +192,31 @@ TEST_CASE(heap_free_storage)
     auto new_heap_size = MUST(heap->file_size_in_bytes());
     EXPECT(new_heap_size <= heap_size);
 }
+
+TEST_CASE(heap_write_storage_larger_than_buffer_pool)
+{
+    ScopeGuard guard([]() { MUST(Core::System::unlink(db_path)); });
+
+    // Write storage spanning more blocks than the buffer pool can hold, so dirty pages need to be evicted
+    StringBuilder builder;
+    for (size_t i = 0; i < SQL::Block::DATA_SIZE * (SQL::Heap::BUFFER_POOL_SIZE + 16); ++i)
+        MUST(builder.try_append(static_cast<char>('a' + i % 26)));
+    auto long_string = builder.string_view();
+
+    SQL::Block::Index storage_block_id = 0;
+    {
+        auto heap = create_heap();
+        storage_block_id = heap->request_new_block_index();
+        TRY_OR_FAIL(heap->write_storage(storage_block_id, long_string.bytes()));
+
+        auto stored_long_string = TRY_OR_FAIL(heap->read_storage(storage_block_id));
+        EXPECT_EQ(long_string.bytes(), stored_long_string.bytes());
+    }
+
+    // Reopen the database file and read back the storage from disk
+    {
+        auto heap = create_heap();
+        auto stored_long_string = TRY_OR_FAIL(heap->read_storage(storage_block_id));
+        EXPECT_EQ(long_string.bytes(), stored_long_string.bytes());
+    }
+}
@@ -664,6 +664,48 @@ TEST_CASE(select_with_offset_out_of_bounds)
     EXPECT_EQ(result.size(), 0u);
 }
 
+TEST_CASE(select_with_where_limit_and_offset)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+    create_table(database);
+    for (auto count = 0; count < 100; count++) {
+        auto result = execute(database,
+            ByteString::formatted("INSERT INTO TestSchema.TestTable ( TextColumn, IntColumn ) VALUES ( 'Test_{}', {} );", count, count));
+        EXPECT(result.size() == 1);
+    }
+    auto result = execute(database, "SELECT TextColumn, IntColumn FROM TestSchema.TestTable WHERE IntColumn < 50 LIMIT 5 OFFSET 5;");
+    EXPECT_EQ(result.size(), 5u);
+    for (auto& row : result)
+        EXPECT(row.row[1].to_int<i32>().value() < 50);
+
+    result = execute(database, "SELECT TextColumn, IntColumn FROM TestSchema.TestTable WHERE IntColumn < 50 LIMIT 0;");
+    EXPECT_EQ(result.size(), 0u);
+}
+
+TEST_CASE(explain_select)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+    create_table(database);
+
+    auto expect_plan = [&](StringView sql, Vector<StringView> expected_steps) {
+        auto result = execute(database, sql);
+        EXPECT_EQ(result.command(), SQL::SQLCommand::Explain);
+        EXPECT_EQ(result.size(), expected_steps.size());
+        for (size_t i = 0; i < min(result.size(), expected_steps.size()); ++i)
+            EXPECT_EQ(result[i].row[0].to_byte_string(), expected_steps[i]);
+    };
+
+    expect_plan("EXPLAIN SELECT * FROM TestSchema.TestTable;"sv, { "SCAN TABLE TESTSCHEMA.TESTTABLE"sv });
+    expect_plan("EXPLAIN SELECT * FROM TestSchema.TestTable WHERE IntColumn = 1 LIMIT 10 OFFSET 5;"sv,
+        { "SCAN TABLE TESTSCHEMA.TESTTABLE"sv, "FILTER DURING SCAN"sv, "LIMIT 10 OFFSET 5"sv, "STOP SCAN AFTER 15 ROWS"sv });
+    expect_plan("EXPLAIN SELECT * FROM TestSchema.TestTable ORDER BY IntColumn LIMIT 10;"sv,
+        { "SCAN TABLE TESTSCHEMA.TESTTABLE"sv, "SORT"sv, "LIMIT 10 OFFSET 0"sv });
+}
+
 TEST_CASE(describe_table)
 {
     ScopeGuard guard([]() { unlink(db_name); });
@@ -1060,4 +1102,49 @@ TEST_CASE(update_all_rows)
     }
 }
 
+
+TEST_CASE(transaction)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    {
+        auto database = MUST(SQL::Database::create(db_name));
+        MUST(database->open());
+        create_table(database);
+
+        auto commit_result = try_execute(database, "COMMIT;");
+        EXPECT(commit_result.is_error());
+        EXPECT_EQ(commit_result.release_error().error(), SQL::SQLErrorCode::NoActiveTransaction);
+
+        auto result = execute(database, "BEGIN TRANSACTION;");
+        EXPECT_EQ(result.command(), SQL::SQLCommand::Begin);
+        EXPECT(database->is_in_transaction());
+
+        auto begin_result = try_execute(database, "BEGIN;");
+        EXPECT(begin_result.is_error());
+        EXPECT_EQ(begin_result.release_error().error(), SQL::SQLErrorCode::TransactionAlreadyActive);
+
+        result = execute(database, "INSERT INTO TestSchema.TestTable VALUES ( 'Test_1', 1 ), ( 'Test_2', 2 ), ( 'Test_3', 3 );");
+        EXPECT_EQ(result.size(), 3u);
+        result = execute(database, "INSERT INTO TestSchema.TestTable VALUES ( 'Test_4', 4 );");
+        EXPECT_EQ(result.size(), 1u);
+
+        result = execute(database, "SELECT IntColumn FROM TestSchema.TestTable;");
+        EXPECT_EQ(result.size(), 4u);
+
+        result = execute(database, "COMMIT;");
+        EXPECT_EQ(result.command(), SQL::SQLCommand::Commit);
+        EXPECT(!database->is_in_transaction());
+    }
+    {
+        auto database = MUST(SQL::Database::create(db_name));
+        MUST(database->open());
+
+        auto result = execute(database, "SELECT IntColumn FROM TestSchema.TestTable ORDER BY IntColumn;");
+        EXPECT_EQ(result.size(), 4u);
+
+        for (auto i = 0u; i < 4; ++i)
+            EXPECT_EQ(result[i].row[0], i + 1);
+    }
+}
+
 }
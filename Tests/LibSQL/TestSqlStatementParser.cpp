@@ -783,3 +783,41 @@ TEST_CASE(describe_table)
     validate("DESCRIBE TABLE TableName;"sv, {}, "TABLENAME"sv);
     validate("DESCRIBE TABLE SchemaName.TableName;"sv, "SCHEMANAME"sv, "TABLENAME"sv);
 }
+
+TEST_CASE(explain)
+{
+    EXPECT(parse("EXPLAIN"sv).is_error());
+    EXPECT(parse("EXPLAIN;"sv).is_error());
+    EXPECT(parse("EXPLAIN DESCRIBE TABLE TableName;"sv).is_error());
+
+    auto statement = TRY_OR_FAIL(parse("EXPLAIN SELECT * FROM TableName WHERE ColumnName = 1;"sv));
+    EXPECT(is<SQL::AST::Explain>(*statement));
+
+    auto const& explain_statement = static_cast<const SQL::AST::Explain&>(*statement);
+    EXPECT_EQ(explain_statement.select_statement()->table_or_subquery_list().size(), 1u);
+    EXPECT(!explain_statement.select_statement()->where_clause().is_null());
+}
+
+TEST_CASE(transaction)
+{
+    EXPECT(parse("BEGIN"sv).is_error());
+    EXPECT(parse("BEGIN TRANSACTION"sv).is_error());
+    EXPECT(parse("BEGIN TABLE;"sv).is_error());
+    EXPECT(parse("COMMIT TABLE;"sv).is_error());
+
+    auto validate_begin = [](StringView sql) {
+        auto statement = TRY_OR_FAIL(parse(sql));
+        EXPECT(is<SQL::AST::BeginTransaction>(*statement));
+    };
+    auto validate_commit = [](StringView sql) {
+        auto statement = TRY_OR_FAIL(parse(sql));
+        EXPECT(is<SQL::AST::CommitTransaction>(*statement));
+    };
+
+    validate_begin("BEGIN;"sv);
+    validate_begin("BEGIN TRANSACTION;"sv);
+    validate_commit("COMMIT;"sv);
+    validate_commit("COMMIT TRANSACTION;"sv);
+    validate_commit("END;"sv);
+    validate_commit("END TRANSACTION;"sv);
+}
@@ -668,6 +668,30 @@ TEST_CASE(serialize_tuple)
     EXPECT_EQ(tuple2[1], 42);
 }
 
+TEST_CASE(serialize_tuple_with_known_descriptor)
+{
+    NonnullRefPtr<SQL::TupleDescriptor> descriptor = adopt_ref(*new SQL::TupleDescriptor);
+    descriptor->append({ "schema", "table", "col1", SQL::SQLType::Text, SQL::Order::Ascending });
+    descriptor->append({ "schema", "table", "col2", SQL::SQLType::Integer, SQL::Order::Descending });
+    descriptor->append({ "schema", "table", "col3", SQL::SQLType::Float, SQL::Order::Ascending });
+    SQL::Tuple tuple(descriptor);
+
+    tuple["col1"] = "Test";
+    tuple["col2"] = 42;
+
+    SQL::Serializer serializer;
+    serializer.serialize<SQL::Tuple>(tuple);
+    EXPECT_EQ(serializer.offset(), tuple.length());
+
+    serializer.rewind();
+    auto tuple2 = serializer.deserialize<SQL::Tuple>(descriptor);
+    EXPECT_EQ(tuple2.descriptor()->size(), 3u);
+    EXPECT_EQ(tuple2.descriptor()->at(1).name, "col2"sv);
+    EXPECT_EQ(tuple2["col1"], "Test"sv);
+    EXPECT_EQ(tuple2["col2"], 42);
+    EXPECT(tuple2["col3"].is_null());
+}
+
 TEST_CASE(copy_tuple)
 {
     NonnullRefPtr<SQL::TupleDescriptor> descriptor = adopt_ref(*new SQL::TupleDescriptor);
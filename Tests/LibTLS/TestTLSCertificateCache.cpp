@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Base64.h>
+#include <LibCrypto/Hash/SHA2.h>
+#include <LibTLS/CertificateCache.h>
+#include <LibTest/TestCase.h>
+
+// A self-signed P-256 certificate for "cache.example".
+static constexpr auto certificate_der_base64 = "MIIBhzCCAS2gAwIBAgIUMhw8fGzepPiiCwHrxBZ/5nPHmL8wCgYIKoZIzj0EAwIwGDEWMBQGA1UEAwwNY2FjaGUuZXhhbXBsZTAgFw0yNjEwMTQxNjM0NTFaGA8yMTI2MDkyMDE2MzQ1MVowGDEWMBQGA1UEAwwNY2FjaGUuZXhhbXBsZTBZMBMGByqGSM49AgEGCCqGSM49AwEHA0IABGpSTPy4yJDC5H9GN9amrHCwpzYkqCmD2zKu0i5ANYp0YXsnGQ1hu0itB7xAHSecqO6M6hJSwhs9rxfHajsIKRGjUzBRMB0GA1UdDgQWBBRIE5u8K9dtwqW1osfx8qaoSe/q9zAfBgNVHSMEGDAWgBRIE5u8K9dtwqW1osfx8qaoSe/q9zAPBgNVHRMBAf8EBTADAQH/MAoGCCqGSM49BAMCA0gAMEUCIQCk0TZZvj8ovuqOq8b/9vjPa8kZ33/Sv+ZpH+fXzeZ+8wIgDwxt9EYq6QbdcB2HSb8UCIgGqTr/DYzeWSkr6ZQZHBU="sv;
+
+TEST_CASE(certificate_cache_parses_each_certificate_once)
+{
+    auto der = TRY_OR_FAIL(decode_base64(certificate_der_base64));
+    auto& cache = TLS::CertificateCache::the();
+
+    auto first = TRY_OR_FAIL(cache.parse_certificate(der));
+    auto second = TRY_OR_FAIL(cache.parse_certificate(der));
+
+    auto digest = Crypto::Hash::SHA256::hash(der);
+    EXPECT_EQ(first.fingerprint.bytes(), digest.bytes());
+    EXPECT_EQ(second.fingerprint.bytes(), digest.bytes());
+    EXPECT_EQ(second.subject.common_name(), "cache.example"sv);
+    EXPECT_EQ(second.tbs_asn1.bytes(), first.tbs_asn1.bytes());
+}
+
+TEST_CASE(certificate_cache_remembers_verified_chains)
+{
+    auto der = TRY_OR_FAIL(decode_base64(certificate_der_base64));
+    auto& cache = TLS::CertificateCache::the();
+
+    Vector<TLS::Certificate> chain;
+    chain.append(TRY_OR_FAIL(cache.parse_certificate(der)));
+
+    auto key = TLS::CertificateCache::chain_key(chain);
+    EXPECT(key.has_value());
+    EXPECT(!cache.is_verified_chain(*key));
+
+    cache.did_verify_chain(*key, chain.first().validity.not_after);
+    EXPECT(cache.is_verified_chain(*key));
+
+    // A chain stops being trusted once one of its certificates has expired.
+    cache.did_verify_chain(*key, UnixDateTime::now() - AK::Duration::from_seconds(1));
+    EXPECT(!cache.is_verified_chain(*key));
+
+    // Certificates that weren't parsed through the cache have no fingerprint to identify the chain with.
+    chain.append(TRY_OR_FAIL(TLS::Certificate::parse_certificate(der)));
+    EXPECT(!TLS::CertificateCache::chain_key(chain).has_value());
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTLS/SessionCache.h>
+#include <LibTest/TestCase.h>
+
+static TLS::SessionCache::Session make_session(StringView session_id, AK::Duration lifetime)
+{
+    TLS::SessionCache::Session session;
+    session.session_id = MUST(ByteBuffer::copy(session_id.bytes()));
+    session.master_key = MUST(ByteBuffer::create_zeroed(48));
+    session.cipher = TLS::CipherSuite::TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256;
+    session.expiration_time = MonotonicTime::now_coarse() + lifetime;
+    return session;
+}
+
+TEST_CASE(session_cache_store_and_lookup)
+{
+    auto& cache = TLS::SessionCache::the();
+    cache.store("store.example"sv, make_session("first"sv, AK::Duration::from_seconds(60)));
+
+    auto session = cache.session_for("store.example"sv);
+    EXPECT(session.has_value());
+    EXPECT_EQ(session->session_id.bytes(), "first"sv.bytes());
+    EXPECT(!cache.session_for("other.example"sv).has_value());
+
+    // A newer session replaces the old one.
+    cache.store("store.example"sv, make_session("second"sv, AK::Duration::from_seconds(60)));
+    EXPECT_EQ(cache.session_for("store.example"sv)->session_id.bytes(), "second"sv.bytes());
+
+    cache.remove("store.example"sv);
+    EXPECT(!cache.session_for("store.example"sv).has_value());
+}
+
+TEST_CASE(session_cache_drops_expired_sessions)
+{
+    auto& cache = TLS::SessionCache::the();
+    cache.store("expired.example"sv, make_session("expired"sv, AK::Duration::from_seconds(-1)));
+    EXPECT(!cache.session_for("expired.example"sv).has_value());
+}
+
+TEST_CASE(session_cache_is_bounded)
+{
+    auto& cache = TLS::SessionCache::the();
+    for (size_t i = 0; i < TLS::SessionCache::maximum_session_count; ++i)
+        cache.store(ByteString::formatted("host{}.example", i), make_session("id"sv, AK::Duration::from_seconds(60 + i)));
+
+    // The session closest to expiring makes room for the new one.
+    cache.store("new.example"sv, make_session("id"sv, AK::Duration::from_seconds(3600)));
+    EXPECT(cache.session_for("new.example"sv).has_value());
+    EXPECT(!cache.session_for("host0.example"sv).has_value());
+    EXPECT(cache.session_for("host1.example"sv).has_value());
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/Benchmark.h>
+#include <LibTest/TestCase.h>
+
+TEST_CASE(statistics)
+{
+    auto statistics = Test::BenchmarkStatistics::compute({ 50, 10, 40, 20, 30 });
+    EXPECT_EQ(statistics.sample_count, 5u);
+    EXPECT_EQ(statistics.min, 10u);
+    EXPECT_EQ(statistics.max, 50u);
+    EXPECT_EQ(statistics.median, 30u);
+    EXPECT_EQ(statistics.first_quartile, 20u);
+    EXPECT_EQ(statistics.third_quartile, 40u);
+    EXPECT_EQ(statistics.p90, 46u);
+    EXPECT_APPROXIMATE(statistics.mean, 30.0);
+    EXPECT_APPROXIMATE(statistics.standard_deviation, 15.8113883);
+    EXPECT_APPROXIMATE(statistics.relative_median_absolute_deviation, 1.0 / 3.0);
+
+    auto empty = Test::BenchmarkStatistics::compute({});
+    EXPECT_EQ(empty.sample_count, 0u);
+}
+
+TEST_CASE(statistics_ignore_outliers)
+{
+    auto statistics = Test::BenchmarkStatistics::compute({ 100, 101, 99, 100, 5000 });
+    EXPECT_EQ(statistics.median, 100u);
+    EXPECT(statistics.relative_median_absolute_deviation <= 0.01);
+    EXPECT(statistics.standard_deviation > 1000);
+}
+
+TEST_CASE(compare_against_baseline)
+{
+    auto baseline = Test::BenchmarkStatistics::compute({ 95, 100, 105 });
+
+    auto faster = Test::compare_against_baseline(Test::BenchmarkStatistics::compute({ 45, 50, 55 }), baseline, 0.05);
+    EXPECT_APPROXIMATE(faster.ratio, 0.5);
+    EXPECT(!faster.is_regression);
+
+    auto noisy = Test::compare_against_baseline(Test::BenchmarkStatistics::compute({ 60, 110, 160 }), baseline, 0.05);
+    EXPECT(!noisy.is_regression);
+
+    auto slower = Test::compare_against_baseline(Test::BenchmarkStatistics::compute({ 190, 200, 210 }), baseline, 0.05);
+    EXPECT_APPROXIMATE(slower.ratio, 2.0);
+    EXPECT(slower.is_regression);
+}
+
+TEST_CASE(runner_repetitions)
+{
+    size_t runs = 0;
+    Test::BenchmarkRunner runner { { .warmup_runs = 2, .min_runs = 3 } };
+    auto result = runner.run("runs", [&] {
+        ++runs;
+        return true;
+    });
+    EXPECT_EQ(runs, 5u);
+    EXPECT_EQ(result.nanoseconds.sample_count, 3u);
+    EXPECT_EQ(result.warmup_runs, 2u);
+}
+
+TEST_CASE(runner_stops_on_failure)
+{
+    size_t runs = 0;
+    Test::BenchmarkRunner runner { { .min_runs = 10 } };
+    auto result = runner.run("failure", [&] {
+        return ++runs < 4;
+    });
+    EXPECT_EQ(runs, 4u);
+    EXPECT_EQ(result.nanoseconds.sample_count, 4u);
+}
+
+TEST_CASE(runner_min_time)
+{
+    Test::BenchmarkRunner runner { { .max_runs = 100'000, .min_time_ms = 1 } };
+    auto result = runner.run("min_time", [] {
+        return true;
+    });
+    EXPECT(result.nanoseconds.sample_count >= 5u);
+    EXPECT(result.nanoseconds.sample_count <= 100'000u);
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/MPMCQueue.h>
+#include <AK/SPSCQueue.h>
+#include <AK/Vector.h>
+#include <LibTest/TestCase.h>
+#include <LibThreading/Thread.h>
+#include <sched.h>
+
+static constexpr size_t values_per_producer = 100'000;
+
+TEST_CASE(spsc_queue_keeps_order)
+{
+    SPSCQueue<size_t, 64> queue;
+    auto producer = Threading::Thread::construct([&] {
+        for (size_t i = 0; i < values_per_producer; ++i) {
+            while (!queue.try_enqueue(i))
+                sched_yield();
+        }
+        return 0;
+    });
+    producer->start();
+
+    size_t expected = 0;
+    while (expected < values_per_producer) {
+        auto value = queue.try_dequeue();
+        if (!value.has_value()) {
+            sched_yield();
+            continue;
+        }
+        if (value.value() != expected) {
+            FAIL("Value out of order");
+            break;
+        }
+        ++expected;
+    }
+    (void)producer->join();
+    EXPECT(queue.is_empty());
+}
+
+TEST_CASE(mpmc_queue_delivers_everything_once)
+{
+    static constexpr size_t thread_count = 4;
+    MPMCQueue<size_t, 128> queue;
+    Array<Atomic<u64>, thread_count> sums {};
+    Atomic<size_t> received { 0 };
+
+    Vector<NonnullRefPtr<Threading::Thread>> threads;
+    for (size_t producer = 0; producer < thread_count; ++producer) {
+        threads.append(Threading::Thread::construct([&, producer] {
+            for (size_t i = 0; i < values_per_producer; ++i) {
+                // NOTE: The producer goes into the top bits, so consumers can check the order per producer.
+                while (!queue.try_enqueue((producer << 32) | i))
+                    sched_yield();
+            }
+            return 0;
+        }));
+    }
+    for (size_t consumer = 0; consumer < thread_count; ++consumer) {
+        threads.append(Threading::Thread::construct([&, consumer] {
+            Array<Optional<size_t>, thread_count> last_seen {};
+            while (received.load() < thread_count * values_per_producer) {
+                auto value = queue.try_dequeue();
+                if (!value.has_value()) {
+                    sched_yield();
+                    continue;
+                }
+                ++received;
+                auto producer = value.value() >> 32;
+                auto index = value.value() & 0xffffffff;
+                EXPECT(!last_seen[producer].has_value() || last_seen[producer].value() < index);
+                last_seen[producer] = index;
+                sums[consumer] += index;
+            }
+            return 0;
+        }));
+    }
+    for (auto& thread : threads)
+        thread->start();
+    for (auto& thread : threads)
+        (void)thread->join();
+
+    u64 sum = 0;
+    for (auto& consumer_sum : sums)
+        sum += consumer_sum.load();
+    EXPECT_EQ(received.load(), thread_count * values_per_producer);
+    EXPECT_EQ(sum, thread_count * (values_per_producer * (values_per_producer - 1) / 2));
+    EXPECT(queue.is_empty());
+}
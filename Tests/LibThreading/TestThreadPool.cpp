@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Random.h>
+#include <AK/Vector.h>
+#include <LibTest/TestCase.h>
+#include <LibThreading/Parallel.h>
+#include <LibThreading/ThreadPool.h>
+
+TEST_CASE(submit_and_wait_for_all)
+{
+    Atomic<size_t> count { 0 };
+    Threading::ThreadPool<Function<void()>> pool { 4 };
+    for (size_t i = 0; i < 1000; ++i)
+        pool.submit([&] { ++count; });
+    pool.wait_for_all();
+    EXPECT_EQ(count.load(), 1000u);
+}
+
+TEST_CASE(custom_handler)
+{
+    Atomic<u64> sum { 0 };
+    Threading::ThreadPool<u64> pool { [&](u64 value) { sum += value; }, 3 };
+    for (u64 i = 1; i <= 100; ++i)
+        pool.submit(i);
+    pool.wait_for_all();
+    EXPECT_EQ(sum.load(), 5050u);
+}
+
+TEST_CASE(work_submitted_from_workers)
+{
+    Atomic<size_t> count { 0 };
+    Threading::TaskPool pool { 4 };
+    for (size_t i = 0; i < 10; ++i) {
+        pool.submit([&] {
+            for (size_t j = 0; j < 100; ++j)
+                pool.submit([&] { ++count; });
+        });
+    }
+    pool.wait_for_all();
+    EXPECT_EQ(count.load(), 1000u);
+}
+
+TEST_CASE(nested_task_groups)
+{
+    Atomic<size_t> count { 0 };
+    Threading::TaskPool pool { 2 };
+    Threading::TaskGroup outer { pool };
+    for (size_t i = 0; i < 8; ++i) {
+        outer.spawn([&] {
+            Threading::TaskGroup inner { pool };
+            for (size_t j = 0; j < 8; ++j)
+                inner.spawn([&] { ++count; });
+            inner.join();
+            EXPECT(count.load() >= 8u);
+        });
+    }
+    outer.join();
+    EXPECT_EQ(count.load(), 64u);
+}
+
+TEST_CASE(task_group_without_workers)
+{
+    size_t count = 0;
+    Threading::TaskPool pool { Optional<size_t> { 0 } };
+    Threading::TaskGroup group { pool };
+    for (size_t i = 0; i < 10; ++i)
+        group.spawn([&] { ++count; });
+    group.join();
+    EXPECT_EQ(count, 10u);
+}
+
+TEST_CASE(parallel_for)
+{
+    Threading::TaskPool pool { 4 };
+    Vector<u32> values;
+    values.resize(10'007);
+
+    Threading::parallel_for(pool, values.size(), [&](size_t index) { values[index] += index; });
+    for (size_t i = 0; i < values.size(); ++i)
+        EXPECT_EQ(values[i], i);
+
+    Threading::parallel_for_each(pool, values.span(), [](u32& value) { value *= 2; });
+    for (size_t i = 0; i < values.size(); ++i)
+        EXPECT_EQ(values[i], i * 2);
+
+    size_t calls = 0;
+    Threading::parallel_for(pool, 0, [&](size_t) { ++calls; });
+    Threading::parallel_for(pool, 1, [&](size_t) { ++calls; });
+    EXPECT_EQ(calls, 1u);
+}
+
+TEST_CASE(parallel_sort)
+{
+    Threading::TaskPool pool { 4 };
+
+    for (size_t size : { 0, 1, 100, 4097, 100'000 }) {
+        Vector<u32> values;
+        for (size_t i = 0; i < size; ++i)
+            values.append(get_random<u32>());
+        Threading::parallel_sort(pool, values.span());
+        for (size_t i = 1; i < values.size(); ++i)
+            EXPECT(values[i - 1] <= values[i]);
+    }
+
+    // Lots of duplicates, and already sorted input in reverse.
+    Vector<u32> values;
+    for (size_t i = 0; i < 100'000; ++i)
+        values.append(get_random_uniform(4));
+    for (size_t i = 100'000; i > 0; --i)
+        values.append(i);
+    Threading::parallel_sort(pool, values.span(), [](u32 a, u32 b) { return a > b; });
+    for (size_t i = 1; i < values.size(); ++i)
+        EXPECT(values[i - 1] >= values[i]);
+}
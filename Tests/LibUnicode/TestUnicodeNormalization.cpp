@@ -93,3 +93,14 @@ TEST_CASE(normalize_nfkc)
     EXPECT_EQ(normalize("\u0958"sv, NormalizationForm::NFKC), "\u0915\u093C"sv);
     EXPECT_EQ(normalize("\u2126"sv, NormalizationForm::NFKC), "\u03A9"sv);
 }
+
+TEST_CASE(normalize_quick_check)
+{
+    // Text below U+0300 is already in NFC, but not necessarily in the other forms.
+    EXPECT_EQ(normalize("Am\u00E9lie \u00BD"sv, NormalizationForm::NFC), "Am\u00E9lie \u00BD"sv);
+    EXPECT_EQ(normalize("Am\u00E9lie \u00BD"sv, NormalizationForm::NFD), "Ame\u0301lie \u00BD"sv);
+    EXPECT_EQ(normalize("Am\u00E9lie \u00BD"sv, NormalizationForm::NFKC), "Am\u00E9lie 1\u20442"sv);
+
+    // A combining mark after such text must still be composed.
+    EXPECT_EQ(normalize("Ame\u0301lie"sv, NormalizationForm::NFC), "Am\u00E9lie"sv);
+}
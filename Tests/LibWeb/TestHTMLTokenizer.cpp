@@ -219,6 +219,31 @@ TEST_CASE(doctype)
     EXPECT_END_TAG_TOKEN(html, 23u, 27u);
 }
 
+TEST_CASE(long_quoted_attribute_values)
+{
+    auto tokens = run_tokenizer("<p foo=\"hello world &amp; goodbye\" bar='one two'>"sv);
+    BEGIN_ENUMERATION(tokens);
+    EXPECT_START_TAG_TOKEN(p, 1u, 48u);
+    EXPECT_TAG_TOKEN_ATTRIBUTE_COUNT(2);
+    EXPECT_TAG_TOKEN_ATTRIBUTE(foo, "hello world & goodbye", 3u, 6u, 7u, 34u);
+    EXPECT_TAG_TOKEN_ATTRIBUTE(bar, "one two", 35u, 38u, 39u, 48u);
+    EXPECT_END_OF_FILE_TOKEN();
+    END_ENUMERATION();
+}
+
+BENCHMARK_CASE(tokenize_long_document)
+{
+    StringBuilder builder;
+    for (size_t i = 0; i < 10'000; ++i)
+        builder.append("<div class=\"some-long-class-name another-class\" title='A fairly long title attribute'>Some text content, with a few words in it.</div>\n"sv);
+    auto input = builder.to_byte_string();
+
+    for (size_t i = 0; i < 10; ++i) {
+        auto tokens = run_tokenizer(input);
+        EXPECT(tokens.last().is_end_of_file());
+    }
+}
+
 // NOTE: This relies on the format of HTMLToken::to_string() staying the same.
 //       If that changes, or something is added to the test HTML, the hash needs to be adjusted.
 TEST_CASE(regression)
@@ -41,3 +41,51 @@ TEST_CASE(predefined_character_reference)
     auto const& content = node.children[0]->content.get<XML::Node::Text>();
     EXPECT_EQ(content.builder.string_view(), "Well hello &, <, >, ', and \"!");
 }
+
+TEST_CASE(attribute_values)
+{
+    XML::Parser parser("<a plain=\"value\" single='it&apos;s' mixed=\"1 &lt; 2 &amp;&amp; 3\"/>"sv);
+    auto document = MUST(parser.parse());
+
+    auto const& node = document.root().content.get<XML::Node::Element>();
+    EXPECT_EQ(node.attributes.get("plain"sv), "value"sv);
+    EXPECT_EQ(node.attributes.get("single"sv), "it's"sv);
+    EXPECT_EQ(node.attributes.get("mixed"sv), "1 < 2 && 3"sv);
+}
+
+TEST_CASE(character_data_stops_at_cdata_end)
+{
+    XML::Parser parser("<a>one ] two ]] three ]]> four</a>"sv);
+    EXPECT(parser.parse().is_error());
+}
+
+TEST_CASE(listener_events)
+{
+    struct TestListener : public XML::Listener {
+        virtual void element_start(XML::Name const& name, HashMap<XML::Name, ByteString> const& attributes) override
+        {
+            events.append(ByteString::formatted("start {} {}", name, attributes.size()));
+        }
+        virtual void element_end(XML::Name const& name) override { events.append(ByteString::formatted("end {}", name)); }
+        virtual void text(StringView text) override { events.append(ByteString::formatted("text {}", text)); }
+
+        Vector<ByteString> events;
+    };
+
+    XML::Parser parser("<root a=\"1\"><item>x &amp; y</item><item/></root>"sv);
+    TestListener listener;
+    MUST(parser.parse_with_listener(listener));
+
+    Vector<ByteString> expected {
+        "start root 1",
+        "start item 0",
+        "text x ",
+        "text &",
+        "text  y",
+        "end item",
+        "start item 0",
+        "end item",
+        "end root",
+    };
+    EXPECT_EQ(listener.events, expected);
+}
@@ -401,6 +401,36 @@ void BrowserWindow::build_menus(StringView const man_file)
     debug_menu->add_action(GUI::Action::create("Clear &Cache", { Mod_Ctrl | Mod_Shift, Key_C }, g_icon_bag.clear_cache, [this](auto&) {
         active_tab().view().debug_request("clear-cache");
     }));
+    auto sample_javascript_stacks_action = GUI::Action::create_checkable(
+        "Sample &JavaScript Stacks", [this](auto& action) {
+            active_tab().view().debug_request("sample-javascript-stacks", action.is_checked() ? "on" : "off");
+        },
+        this);
+    sample_javascript_stacks_action->set_checked(false);
+    debug_menu->add_action(sample_javascript_stacks_action);
+    auto collect_execution_statistics_action = GUI::Action::create_checkable(
+        "Collect JavaScript &Execution Statistics", [this](auto& action) {
+            active_tab().view().debug_request("collect-execution-statistics", action.is_checked() ? "on" : "off");
+        },
+        this);
+    collect_execution_statistics_action->set_checked(false);
+    debug_menu->add_action(collect_execution_statistics_action);
+    auto record_rendering_trace_action = GUI::Action::create_checkable(
+        "Record &Rendering Trace", [this](auto& action) {
+            if (action.is_checked()) {
+                active_tab().view().debug_request("record-rendering-trace", "on");
+                return;
+            }
+            active_tab().view().debug_request("record-rendering-trace", "off");
+            auto path = active_tab().view().dump_rendering_trace(Core::StandardPaths::downloads_directory());
+            if (path.is_error())
+                GUI::MessageBox::show_error(this, MUST(String::formatted("Failed to save rendering trace: {}", path.error())));
+            else
+                GUI::MessageBox::show(this, MUST(String::formatted("Rendering trace saved to {}", path.value())), "Rendering Trace"sv);
+        },
+        this);
+    record_rendering_trace_action->set_checked(false);
+    debug_menu->add_action(record_rendering_trace_action);
 
     m_user_agent_spoof_actions.set_exclusive(true);
     auto spoof_user_agent_menu = debug_menu->add_submenu("Spoof &User Agent"_string);
@@ -118,10 +118,13 @@ void Cell::update_data(Badge<Sheet>)
         }
 
         for (auto& ref : m_referencing_cells) {
-            if (ref) {
-                ref->m_dirty = true;
-                ref->update();
-            }
+            if (!ref)
+                continue;
+            // Cells of our own sheet are already queued up (in dependency order) by Sheet::update().
+            if (m_sheet->is_updating_in_dependency_order() && &ref->sheet() == m_sheet.ptr())
+                continue;
+            ref->m_dirty = true;
+            ref->update();
         }
     }
 
@@ -49,6 +49,7 @@ struct Cell : public Weakable<Cell> {
     void set_data(JS::Value new_data);
     bool dirty() const { return m_dirty; }
     void clear_dirty() { m_dirty = false; }
+    void mark_dirty() { m_dirty = true; }
 
     StringView name_for_javascript(Sheet const& sheet) const
     {
@@ -133,12 +133,55 @@ void Sheet::update()
         }
     }
 
-    for (auto& cell : cells_copy)
-        update(cell);
+    // Recalculate the changed cells and everything that depends on them, each exactly once and only after all of its inputs.
+    auto cells_to_update = cells_in_dependency_order(move(cells_copy));
+    for (auto& cell : cells_to_update)
+        cell.mark_dirty();
+
+    {
+        TemporaryChange updating_in_order { m_is_updating_in_dependency_order, true };
+        for (auto& cell : cells_to_update)
+            update(cell);
+    }
 
     m_visited_cells_in_update.clear();
 }
 
+Vector<Cell&> Sheet::cells_in_dependency_order(Vector<Cell&> changed_cells)
+{
+    // This is the reverse post-order of a depth-first walk from the changed cells to the cells referencing them,
+    // which puts every cell after all the cells it references (reference cycles end up in some arbitrary order).
+    HashTable<Cell*> seen_cells;
+    Vector<Cell&> cells_in_post_order;
+    struct StackEntry {
+        Cell* cell;
+        size_t next_reference_index { 0 };
+    };
+    Vector<StackEntry> stack;
+
+    for (auto& changed_cell : changed_cells) {
+        if (seen_cells.set(&changed_cell) != AK::HashSetResult::InsertedNewEntry)
+            continue;
+        stack.append({ &changed_cell, 0 });
+
+        while (!stack.is_empty()) {
+            auto& entry = stack.last();
+            auto const& referencing_cells = entry.cell->referencing_cells();
+            if (entry.next_reference_index < referencing_cells.size()) {
+                auto& referencing_cell = referencing_cells[entry.next_reference_index++];
+                if (referencing_cell && &referencing_cell->sheet() == this && seen_cells.set(referencing_cell.ptr()) == AK::HashSetResult::InsertedNewEntry)
+                    stack.append({ referencing_cell.ptr(), 0 });
+                continue;
+            }
+            cells_in_post_order.append(*entry.cell);
+            stack.take_last();
+        }
+    }
+
+    cells_in_post_order.reverse();
+    return cells_in_post_order;
+}
+
 void Sheet::update(Cell& cell)
 {
     if (m_should_ignore_updates) {
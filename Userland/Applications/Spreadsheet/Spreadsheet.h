@@ -130,6 +130,7 @@ public:
 
     Cell*& current_evaluated_cell() { return m_current_cell_being_evaluated; }
     bool has_been_visited(Cell* cell) const { return m_visited_cells_in_update.contains(cell); }
+    bool is_updating_in_dependency_order() const { return m_is_updating_in_dependency_order; }
 
     Workbook const& workbook() const { return m_workbook; }
 
@@ -154,6 +155,8 @@ private:
     explicit Sheet(Workbook&);
     explicit Sheet(StringView name, Workbook&);
 
+    Vector<Cell&> cells_in_dependency_order(Vector<Cell&> changed_cells);
+
     ByteString m_name;
     Vector<ByteString> m_columns;
     size_t m_rows { 0 };
@@ -171,6 +174,7 @@ private:
     HashTable<Cell*> m_visited_cells_in_update;
     bool m_should_ignore_updates { false };
     bool m_update_requested { false };
+    bool m_is_updating_in_dependency_order { false };
     mutable Optional<JsonObject> m_cached_documentation;
 };
 
@@ -26,6 +26,9 @@ Workbook::Workbook(Vector<NonnullRefPtr<Sheet>>&& sheets, GUI::Window& parent_wi
     , m_main_execution_context(JS::ExecutionContext::create(m_vm->heap()))
     , m_parent_window(parent_window)
 {
+    // Cells are re-evaluated over and over with the same formulas, keep their parse trees (and bytecode) around.
+    m_vm->enable_program_cache();
+
     auto& realm = *m_root_execution_context->realm;
     auto& vm = realm.vm();
     m_workbook_object = vm.heap().allocate<WorkbookObject>(realm, realm, *this);
@@ -446,7 +446,7 @@ ErrorOr<String> ProcessModel::read_command_line(pid_t pid)
 ErrorOr<void> ProcessModel::ensure_process_statistics_file()
 {
     if (!m_process_statistics_file || !m_process_statistics_file->is_open())
-        m_process_statistics_file = TRY(Core::File::open("/sys/kernel/processes"sv, Core::File::OpenMode::Read));
+        m_process_statistics_file = TRY(Core::ProcessStatisticsReader::open_statistics_file());
 
     return {};
 }
@@ -57,7 +57,7 @@ ErrorOr<NonnullRefPtr<CatDog>> CatDog::create()
 }
 
 CatDog::CatDog()
-    : m_proc_all(MUST(Core::File::open("/sys/kernel/processes"sv, Core::File::OpenMode::Read)))
+    : m_proc_all(MUST(Core::ProcessStatisticsReader::open_statistics_file()))
 {
     m_idle_sleep_timer.start();
 }
@@ -90,6 +90,7 @@ public:
     virtual ~DefaultDocumentClient() override = default;
     virtual void document_did_append_line() override {};
     virtual void document_did_insert_line(size_t) override {};
+    virtual void document_did_insert_lines(size_t, size_t) override {};
     virtual void document_did_remove_line(size_t) override {};
     virtual void document_did_remove_all_lines() override {};
     virtual void document_did_change(GUI::AllowCallback) override {};
@@ -22,6 +22,10 @@
 
 namespace Profiler {
 
+// NOTE: These have to match what LibJS uses for its samples of the JavaScript stack, see LibJS/SamplingProfiler.h.
+static constexpr StringView javascript_stack_signpost_prefix = "JavaScript stack\n"sv;
+static constexpr StringView javascript_interpreter_symbol_prefix = "JS::Bytecode::Interpreter::"sv;
+
 static void sort_profile_nodes(Vector<NonnullRefPtr<ProfileNode>>& nodes)
 {
     quick_sort(nodes.begin(), nodes.end(), [](auto& a, auto& b) {
@@ -40,6 +44,8 @@ Profile::Profile(Vector<Process> processes, Vector<Event> events)
     for (size_t i = 0; i < m_events.size(); ++i) {
         if (m_events[i].data.has<Event::SignpostData>())
             m_signpost_indices.append(i);
+        if (m_events[i].is_javascript_sample)
+            m_pids_with_javascript_samples.set(m_events[i].pid);
     }
 
     m_first_timestamp = m_events.first().timestamp;
@@ -116,6 +122,13 @@ void Profile::rebuild_tree()
         if (!process_filter_contains(event.pid, event.serial))
             continue;
 
+        // NOTE: The samples of the JavaScript stack and the samples of the native stack inside the interpreter cover
+        //       the same time, so only one kind of them is included.
+        if (m_pids_with_javascript_samples.contains(event.pid)) {
+            if (m_show_javascript_frames ? event.is_in_javascript_interpreter : event.is_javascript_sample)
+                continue;
+        }
+
         if (event.data.has<Event::SignpostData>()) {
             m_filtered_signpost_indices.append(event_index);
             continue;
@@ -129,6 +142,11 @@ void Profile::rebuild_tree()
         if (event.data.has<Event::FreeData>())
             continue;
 
+        auto add_self_hardware_events = [&](ProfileNode& node) {
+            if (auto* sample_data = event.data.get_pointer<Event::SampleData>())
+                node.add_self_hardware_events(sample_data->cycles, sample_data->instructions, sample_data->cache_misses);
+        };
+
         auto for_each_frame = [&]<typename Callback>(Callback callback) {
             if (!m_inverted) {
                 for (size_t i = 0; i < event.frames.size(); ++i) {
@@ -165,6 +183,7 @@ void Profile::rebuild_tree()
                 if (is_innermost_frame) {
                     node->add_event_address(address);
                     node->increment_self_count();
+                    add_self_hardware_events(*node);
                 }
                 return IterationDecision::Continue;
             });
@@ -203,6 +222,7 @@ void Profile::rebuild_tree()
                     if (j == event.frames.size() - 1) {
                         node->add_event_address(address);
                         node->increment_self_count();
+                        add_self_hardware_events(*node);
                     }
                 }
             }
@@ -309,6 +329,7 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
         auto const& perf_event = perf_event_value.as_object();
 
         Event event;
+        StringView javascript_stack;
 
         event.serial = next_serial;
         next_serial.increment();
@@ -320,22 +341,34 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
         auto type_string = perf_event.get_byte_string("type"sv).value_or({});
 
         if (type_string == "sample"sv) {
-            event.data = Event::SampleData {};
-        } else if (type_string == "kmalloc"sv) {
+            event.data = Event::SampleData {
+                .cycles = perf_event.get_u64("cycles"sv).value_or(0),
+                .instructions = perf_event.get_u64("instructions"sv).value_or(0),
+                .cache_misses = perf_event.get_u64("cache_misses"sv).value_or(0),
+                .branch_misses = perf_event.get_u64("branch_misses"sv).value_or(0),
+            };
+        } else if (type_string == "kmalloc"sv || type_string == "malloc"sv) {
             event.data = Event::MallocData {
                 .ptr = perf_event.get_addr("ptr"sv).value_or(0),
                 .size = perf_event.get_integer<size_t>("size"sv).value_or(0),
             };
-        } else if (type_string == "kfree"sv) {
+        } else if (type_string == "kfree"sv || type_string == "free"sv) {
             event.data = Event::FreeData {
                 .ptr = perf_event.get_addr("ptr"sv).value_or(0),
             };
         } else if (type_string == "signpost"sv) {
             auto string_id = perf_event.get_addr("arg1"sv).value_or(0);
-            event.data = Event::SignpostData {
-                .string = profile_strings.get(string_id).value_or(ByteString::formatted("Signpost #{}", string_id)),
-                .arg = perf_event.get_addr("arg2"sv).value_or(0),
-            };
+            auto string = profile_strings.get(string_id).value_or(ByteString::formatted("Signpost #{}", string_id));
+            if (string.starts_with(javascript_stack_signpost_prefix)) {
+                event.data = Event::SampleData {};
+                event.is_javascript_sample = true;
+                javascript_stack = string.substring_view(javascript_stack_signpost_prefix.length());
+            } else {
+                event.data = Event::SignpostData {
+                    .string = move(string),
+                    .arg = perf_event.get_addr("arg2"sv).value_or(0),
+                };
+            }
         } else if (type_string == "mmap"sv) {
             auto ptr = perf_event.get_addr("ptr"sv).value_or(0);
             auto size = perf_event.get_integer<size_t>("size"sv).value_or(0);
@@ -467,6 +500,11 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
             }
 
             event.data = fsdata;
+        } else if (type_string == "mutex_wait"sv || type_string == "mutex_hold"sv) {
+            event.data = Event::MutexData {
+                .mutex = perf_event.get_addr("mutex"sv).value_or(0),
+                .duration = Duration::from_nanoseconds(perf_event.get_integer<u64>("durationNs"sv).value_or(0)),
+            };
         } else {
             dbgln("Unknown event type '{}'", type_string);
             VERIFY_NOT_REACHED();
@@ -507,6 +545,21 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
             event.frames.append({ object_name, symbol, (FlatPtr)ptr, offset });
         }
 
+        auto interpreter_frame_index = event.frames.find_first_index_if([](auto const& frame) {
+            return frame.symbol.starts_with(javascript_interpreter_symbol_prefix);
+        });
+        event.is_in_javascript_interpreter = interpreter_frame_index.has_value();
+
+        if (event.is_javascript_sample) {
+            // The native part of the stack ends with the profiler taking the sample, so everything from the outermost
+            // interpreter frame onwards is replaced with the JavaScript frames.
+            if (interpreter_frame_index.has_value())
+                event.frames.shrink(*interpreter_frame_index);
+            auto javascript_frames = javascript_stack.split_view('\n');
+            for (auto const& frame : javascript_frames.in_reverse())
+                event.frames.append({ "JavaScript"sv, frame, 0, 0 });
+        }
+
         if (event.frames.size() < 2)
             continue;
 
@@ -629,6 +682,15 @@ void Profile::set_show_top_functions(bool show)
     rebuild_tree();
 }
 
+void Profile::set_show_javascript_frames(bool show)
+{
+    if (m_show_javascript_frames == show)
+        return;
+    m_show_javascript_frames = show;
+    rebuild_tree();
+    m_samples_model->invalidate();
+}
+
 void Profile::set_show_percentages(bool show_percentages)
 {
     if (m_show_percentages == show_percentages)
@@ -94,6 +94,16 @@ public:
     void increment_event_count() { ++m_event_count; }
     void increment_self_count() { ++m_self_count; }
 
+    u64 self_cycles() const { return m_self_cycles; }
+    u64 self_instructions() const { return m_self_instructions; }
+    u64 self_cache_misses() const { return m_self_cache_misses; }
+    void add_self_hardware_events(u64 cycles, u64 instructions, u64 cache_misses)
+    {
+        m_self_cycles += cycles;
+        m_self_instructions += instructions;
+        m_self_cache_misses += cache_misses;
+    }
+
     void sort_children();
 
     HashMap<FlatPtr, size_t> const& events_per_address() const { return m_events_per_address; }
@@ -125,6 +135,9 @@ private:
     u32 m_offset { 0 };
     u32 m_event_count { 0 };
     u32 m_self_count { 0 };
+    u64 m_self_cycles { 0 };
+    u64 m_self_instructions { 0 };
+    u64 m_self_cache_misses { 0 };
     u64 m_timestamp { 0 };
     Vector<NonnullRefPtr<ProfileNode>> m_children;
     HashMap<FlatPtr, size_t> m_events_per_address;
@@ -181,9 +194,18 @@ public:
         u32 lost_samples { 0 };
         bool in_kernel { false };
 
+        // Samples of the JavaScript stack have the JavaScript frames spliced in where the interpreter would have been.
+        bool is_javascript_sample { false };
+        bool is_in_javascript_interpreter { false };
+
         Vector<Frame> frames;
 
+        // Hardware events counted since the previous sample of the same thread, if the kernel supports it.
         struct SampleData {
+            u64 cycles {};
+            u64 instructions {};
+            u64 cache_misses {};
+            u64 branch_misses {};
         };
 
         struct MallocData {
@@ -262,7 +284,13 @@ public:
             Variant<OpenEventData, CloseEventData, ReadvEventData, ReadEventData, PreadEventData> data;
         };
 
-        Variant<nullptr_t, SampleData, MallocData, FreeData, SignpostData, MmapData, MunmapData, ProcessCreateData, ProcessExecData, ThreadCreateData, FilesystemEventData> data { nullptr };
+        // Time spent waiting for a contended kernel mutex, or time a contended mutex was held for.
+        struct MutexData {
+            FlatPtr mutex {};
+            Duration duration;
+        };
+
+        Variant<nullptr_t, SampleData, MallocData, FreeData, SignpostData, MmapData, MunmapData, ProcessCreateData, ProcessExecData, ThreadCreateData, FilesystemEventData, MutexData> data { nullptr };
     };
 
     Vector<Event> const& events() const { return m_events; }
@@ -289,6 +317,9 @@ public:
 
     void set_show_top_functions(bool);
 
+    bool has_javascript_samples() const { return !m_pids_with_javascript_samples.is_empty(); }
+    void set_show_javascript_frames(bool);
+
     bool show_percentages() const { return m_show_percentages; }
     void set_show_percentages(bool);
 
@@ -352,6 +383,8 @@ private:
 
     bool m_inverted { false };
     bool m_show_top_functions { false };
+    bool m_show_javascript_frames { true };
+    HashTable<pid_t> m_pids_with_javascript_samples;
     bool m_show_percentages { false };
 };
 
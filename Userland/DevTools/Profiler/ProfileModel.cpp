@@ -87,6 +87,10 @@ ErrorOr<String> ProfileModel::column_name(int column) const
         return "Stack Frame"_string;
     case Column::SymbolAddress:
         return "Symbol Address"_string;
+    case Column::SelfInstructionsPerCycle:
+        return "Self IPC"_string;
+    case Column::SelfCacheMisses:
+        return "Self Cache Misses"_string;
     default:
         VERIFY_NOT_REACHED();
     }
@@ -96,7 +100,8 @@ GUI::Variant ProfileModel::data(GUI::ModelIndex const& index, GUI::ModelRole rol
 {
     auto* node = static_cast<ProfileNode*>(index.internal_data());
     if (role == GUI::ModelRole::TextAlignment) {
-        if (index.column() == Column::SampleCount || index.column() == Column::SelfCount)
+        if (index.column() == Column::SampleCount || index.column() == Column::SelfCount
+            || index.column() == Column::SelfInstructionsPerCycle || index.column() == Column::SelfCacheMisses)
             return Gfx::TextAlignment::CenterRight;
     }
     if (role == GUI::ModelRole::Icon) {
@@ -138,6 +143,17 @@ GUI::Variant ProfileModel::data(GUI::ModelIndex const& index, GUI::ModelRole rol
                 return "";
             return ByteString::formatted("{:p} (offset {:p})", node->address(), node->address() - library->base);
         }
+        // The hardware event columns stay empty if the kernel didn't record any hardware events.
+        if (index.column() == Column::SelfInstructionsPerCycle) {
+            if (node->self_cycles() == 0)
+                return "";
+            return ByteString::formatted("{:.2}", static_cast<double>(node->self_instructions()) / static_cast<double>(node->self_cycles()));
+        }
+        if (index.column() == Column::SelfCacheMisses) {
+            if (node->self_cycles() == 0)
+                return "";
+            return node->self_cache_misses();
+        }
         return {};
     }
     return {};
@@ -27,6 +27,8 @@ public:
         ObjectName,
         StackFrame,
         SymbolAddress,
+        SelfInstructionsPerCycle,
+        SelfCacheMisses,
         __Count
     };
 
@@ -289,6 +289,13 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     top_functions_action->set_checked(false);
     view_menu->add_action(top_functions_action);
 
+    auto javascript_frames_action = GUI::Action::create_checkable("Show &JavaScript Frames", { Mod_Ctrl, Key_J }, [&](auto& action) {
+        profile->set_show_javascript_frames(action.is_checked());
+    });
+    javascript_frames_action->set_checked(true);
+    javascript_frames_action->set_enabled(profile->has_javascript_samples());
+    view_menu->add_action(javascript_frames_action);
+
     auto percent_action = GUI::Action::create_checkable("Show &Percentages", { Mod_Ctrl, Key_P }, [&](auto& action) {
         profile->set_show_percentages(action.is_checked());
         tree_view.update();
@@ -85,15 +85,6 @@ void main() {
 }
 )";
 
-char const* solid_color_fragment_shader_source = R"(
-#version 330 core
-uniform vec4 uColor;
-out vec4 fragColor;
-void main() {
-    fragColor = uColor;
-}
-)";
-
 char const* blit_vertex_shader_source = R"(
 #version 330 core
 in vec4 aVertexPosition;
@@ -195,7 +186,6 @@ NonnullOwnPtr<Painter> Painter::create(Context& context, NonnullRefPtr<Canvas> c
 Painter::Painter(Context& context, NonnullRefPtr<Canvas> canvas)
     : m_context(context)
     , m_target_canvas(canvas)
-    , m_rectangle_program(Program::create(Program::Name::RectangleProgram, vertex_shader_source, solid_color_fragment_shader_source))
     , m_rounded_rectangle_program(Program::create(Program::Name::RoundedRectangleProgram, vertex_shader_source, rect_with_rounded_corners_fragment_shader_source))
     , m_blit_program(Program::create(Program::Name::BlitProgram, blit_vertex_shader_source, blit_fragment_shader_source))
     , m_linear_gradient_program(Program::create(Program::Name::LinearGradientProgram, linear_gradient_vertex_shader_source, linear_gradient_fragment_shader_source))
@@ -208,10 +198,18 @@ Painter::Painter(Context& context, NonnullRefPtr<Canvas> canvas)
 
 Painter::~Painter()
 {
+    flush_batched_rects();
+}
+
+Canvas const& Painter::canvas()
+{
+    flush_batched_rects();
+    return *m_target_canvas;
 }
 
 void Painter::clear(Gfx::Color color)
 {
+    flush_batched_rects();
     bind_target_canvas();
     GL::clear_color(color);
 }
@@ -237,33 +235,74 @@ static Array<GLfloat, 8> rect_to_vertices(Gfx::FloatRect const& rect)
 
 void Painter::fill_rect(Gfx::FloatRect rect, Gfx::Color color)
 {
-    bind_target_canvas();
+    // Solid rects are by far the most common draw, so instead of issuing a draw call for each of them, they are
+    // collected with per-vertex colors and drawn all at once before anything else touches the target canvas.
+    auto rect_in_clip_space = to_clip_space(transform().map(rect));
+    auto [red, green, blue, alpha] = gfx_color_to_opengl_color(color);
 
-    // Draw a filled rect (with `color`) using OpenGL after mapping it through the current transform.
+    // p0 --- p1
+    // | \     |
+    // |   \   |
+    // |     \ |
+    // p2 --- p3
+
+    Array<Gfx::FloatPoint, 6> const triangle_vertices {
+        rect_in_clip_space.top_left(),
+        rect_in_clip_space.top_right(),
+        rect_in_clip_space.bottom_right(),
+        rect_in_clip_space.top_left(),
+        rect_in_clip_space.bottom_right(),
+        rect_in_clip_space.bottom_left(),
+    };
 
-    auto vertices = rect_to_vertices(to_clip_space(transform().map(rect)));
+    m_batched_rect_vertices.ensure_capacity(m_batched_rect_vertices.size() + 12);
+    m_batched_rect_colors.ensure_capacity(m_batched_rect_colors.size() + 24);
+    for (auto const& vertex : triangle_vertices) {
+        m_batched_rect_vertices.unchecked_append(vertex.x());
+        m_batched_rect_vertices.unchecked_append(vertex.y());
+        m_batched_rect_colors.unchecked_append(red * alpha);
+        m_batched_rect_colors.unchecked_append(green * alpha);
+        m_batched_rect_colors.unchecked_append(blue * alpha);
+        m_batched_rect_colors.unchecked_append(alpha);
+    }
+}
 
-    auto vbo = GL::create_buffer();
-    GL::upload_to_buffer(vbo, vertices);
+void Painter::flush_batched_rects()
+{
+    if (m_batched_rect_vertices.is_empty())
+        return;
+
+    bind_target_canvas();
 
     auto vao = GL::create_vertex_array();
     GL::bind_vertex_array(vao);
-    GL::bind_buffer(vbo);
 
-    auto [red, green, blue, alpha] = gfx_color_to_opengl_color(color);
+    auto vbo_vertices = GL::create_buffer();
+    GL::upload_to_buffer(vbo_vertices, m_batched_rect_vertices);
 
-    m_rectangle_program.use();
+    auto vbo_colors = GL::create_buffer();
+    GL::upload_to_buffer(vbo_colors, m_batched_rect_colors);
 
-    auto position_attribute = m_rectangle_program.get_attribute_location("aVertexPosition");
-    auto color_uniform = m_rectangle_program.get_uniform_location("uColor");
+    // The colors are premultiplied, so this is the same blending that a single rect with a color uniform would use.
+    m_linear_gradient_program.use();
+    auto position_attribute = m_linear_gradient_program.get_attribute_location("aVertexPosition");
+    auto color_attribute = m_linear_gradient_program.get_attribute_location("aColor");
 
-    GL::set_uniform(color_uniform, red, green, blue, alpha);
+    GL::bind_buffer(vbo_vertices);
     GL::set_vertex_attribute(position_attribute, 0, 2);
-    GL::enable_blending(GL::BlendFactor::SrcAlpha, GL::BlendFactor::OneMinusSrcAlpha, GL::BlendFactor::One, GL::BlendFactor::One);
-    GL::draw_arrays(GL::DrawPrimitive::TriangleFan, 4);
 
-    GL::delete_buffer(vbo);
+    GL::bind_buffer(vbo_colors);
+    GL::set_vertex_attribute(color_attribute, 0, 4);
+
+    GL::enable_blending(GL::BlendFactor::One, GL::BlendFactor::OneMinusSrcAlpha, GL::BlendFactor::One, GL::BlendFactor::One);
+    GL::draw_arrays(GL::DrawPrimitive::Triangles, m_batched_rect_vertices.size() / 2);
+
+    GL::delete_buffer(vbo_vertices);
+    GL::delete_buffer(vbo_colors);
     GL::delete_vertex_array(vao);
+
+    m_batched_rect_vertices.clear_with_capacity();
+    m_batched_rect_colors.clear_with_capacity();
 }
 
 void Painter::fill_rect_with_rounded_corners(Gfx::IntRect const& rect, Color const& color, CornerRadius const& top_left_radius, CornerRadius const& top_right_radius, CornerRadius const& bottom_left_radius, CornerRadius const& bottom_right_radius, BlendingMode blending_mode)
@@ -273,6 +312,7 @@ void Painter::fill_rect_with_rounded_corners(Gfx::IntRect const& rect, Color con
 
 void Painter::fill_rect_with_rounded_corners(Gfx::FloatRect const& rect, Color const& color, CornerRadius const& top_left_radius, CornerRadius const& top_right_radius, CornerRadius const& bottom_left_radius, CornerRadius const& bottom_right_radius, BlendingMode blending_mode)
 {
+    flush_batched_rects();
     bind_target_canvas();
 
     auto transformed_rect = transform().map(rect);
@@ -323,8 +363,6 @@ void Painter::draw_line(Gfx::IntPoint a, Gfx::IntPoint b, float thickness, Gfx::
 
 void Painter::draw_line(Gfx::FloatPoint a, Gfx::FloatPoint b, float thickness, Color color)
 {
-    bind_target_canvas();
-
     auto midpoint = (a + b) / 2.0f;
     auto length = a.distance_from(b);
     auto angle = AK::atan2(b.y() - a.y(), b.x() - a.x());
@@ -334,29 +372,7 @@ void Painter::draw_line(Gfx::FloatPoint a, Gfx::FloatPoint b, float thickness, C
     };
     auto rect = Gfx::FloatRect(midpoint - offset, { length, thickness });
 
-    auto vertices = rect_to_vertices(to_clip_space(transform().map(rect)));
-
-    auto vbo = GL::create_buffer();
-    GL::upload_to_buffer(vbo, vertices);
-
-    auto vao = GL::create_vertex_array();
-    GL::bind_vertex_array(vao);
-    GL::bind_buffer(vbo);
-
-    auto [red, green, blue, alpha] = gfx_color_to_opengl_color(color);
-
-    m_rectangle_program.use();
-
-    auto position_attribute = m_rectangle_program.get_attribute_location("aVertexPosition");
-    auto color_uniform = m_rectangle_program.get_uniform_location("uColor");
-
-    GL::set_uniform(color_uniform, red, green, blue, alpha);
-    GL::set_vertex_attribute(position_attribute, 0, 2);
-    GL::enable_blending(GL::BlendFactor::SrcAlpha, GL::BlendFactor::OneMinusSrcAlpha, GL::BlendFactor::One, GL::BlendFactor::One);
-    GL::draw_arrays(GL::DrawPrimitive::TriangleFan, 4);
-
-    GL::delete_buffer(vbo);
-    GL::delete_vertex_array(vao);
+    fill_rect(rect, color);
 }
 
 void Painter::draw_scaled_bitmap(Gfx::IntRect const& dest_rect, Gfx::Bitmap const& bitmap, Gfx::IntRect const& src_rect, ScalingMode scaling_mode)
@@ -409,6 +425,7 @@ void Painter::draw_scaled_bitmap(Gfx::FloatRect const& dst_rect, Gfx::Bitmap con
 
 void Painter::draw_glyph_run(Span<Gfx::DrawGlyphOrEmoji const> glyph_run, Color const& color)
 {
+    flush_batched_rects();
     bind_target_canvas();
 
     Vector<GLfloat> vertices;
@@ -507,6 +524,7 @@ void Painter::fill_rect_with_linear_gradient(Gfx::IntRect const& rect, ReadonlyS
 
 void Painter::fill_rect_with_linear_gradient(Gfx::FloatRect const& rect, ReadonlySpan<Gfx::ColorStop> stops, float angle, Optional<float> repeat_length)
 {
+    flush_batched_rects();
     bind_target_canvas();
 
     // FIXME: Implement support for angle and repeat_length
@@ -605,18 +623,21 @@ void Painter::save()
 
 void Painter::restore()
 {
+    flush_batched_rects();
     VERIFY(!m_state_stack.is_empty());
     m_state_stack.take_last();
 }
 
 void Painter::set_clip_rect(Gfx::IntRect rect)
 {
+    flush_batched_rects();
     state().clip_rect = transform().map(rect);
     GL::enable_scissor_test(transform().map(rect));
 }
 
 void Painter::clear_clip_rect()
 {
+    flush_batched_rects();
     state().clip_rect = { { 0, 0 }, m_target_canvas->size() };
     GL::disable_scissor_test();
 }
@@ -630,6 +651,7 @@ void Painter::bind_target_canvas()
 
 void Painter::flush(Gfx::Bitmap& bitmap)
 {
+    flush_batched_rects();
     m_target_canvas->bind();
     GL::read_pixels({ 0, 0, bitmap.width(), bitmap.height() }, bitmap);
 }
@@ -653,6 +675,7 @@ void Painter::blit_canvas(Gfx::FloatRect const& dst_rect, Canvas const& canvas,
 
 void Painter::blit_scaled_texture(Gfx::FloatRect const& dst_rect, GL::Texture const& texture, Gfx::FloatRect const& src_rect, ScalingMode scaling_mode, float opacity, Optional<Gfx::AffineTransform> affine_transform, BlendingMode blending_mode)
 {
+    flush_batched_rects();
     bind_target_canvas();
 
     m_blit_program.use();
@@ -723,6 +746,7 @@ void Painter::blit_scaled_texture(Gfx::FloatRect const& dst_rect, GL::Texture co
 
 void Painter::blit_blurred_texture(Gfx::FloatRect const& dst_rect, GL::Texture const& texture, Gfx::FloatRect const& src_rect, int radius, BlurDirection direction, ScalingMode scaling_mode)
 {
+    flush_batched_rects();
     bind_target_canvas();
 
     m_blur_program.use();
@@ -34,7 +34,7 @@ public:
     Painter(Context&, NonnullRefPtr<Canvas>);
     ~Painter();
 
-    Canvas const& canvas() { return *m_target_canvas; }
+    Canvas const& canvas();
 
     void clear(Gfx::Color);
 
@@ -77,6 +77,10 @@ public:
 
     void flush(Gfx::Bitmap&);
 
+    // Submits the solid rects that have been collected since the last draw call. This happens automatically before
+    // any other drawing, but has to be done explicitly before the target canvas is read by another painter.
+    void flush_batched_rects();
+
     void fill_rect_with_linear_gradient(Gfx::IntRect const&, ReadonlySpan<Gfx::ColorStop>, float angle, Optional<float> repeat_length = {});
     void fill_rect_with_linear_gradient(Gfx::FloatRect const&, ReadonlySpan<Gfx::ColorStop>, float angle, Optional<float> repeat_length = {});
 
@@ -120,11 +124,13 @@ private:
 
     NonnullRefPtr<Canvas> m_target_canvas;
 
-    Program m_rectangle_program;
     Program m_rounded_rectangle_program;
     Program m_blit_program;
     Program m_linear_gradient_program;
     Program m_blur_program;
+
+    Vector<GLfloat> m_batched_rect_vertices;
+    Vector<GLfloat> m_batched_rect_colors;
 };
 
 }
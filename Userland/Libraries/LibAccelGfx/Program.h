@@ -16,7 +16,6 @@ class Program {
 
 public:
     enum class Name {
-        RectangleProgram,
         RoundedRectangleProgram,
         BlitProgram,
         LinearGradientProgram,
@@ -41,6 +41,9 @@ Optional<Zip> Zip::try_create(ReadonlyBytes buffer)
     if (end_of_central_directory.disk_number != 0 || end_of_central_directory.central_directory_start_disk != 0 || end_of_central_directory.disk_records_count != end_of_central_directory.total_records_count)
         return {}; // TODO: support multi-volume zip archives
 
+    HashMap<StringView, size_t> member_offsets;
+    if (member_offsets.try_ensure_capacity(end_of_central_directory.total_records_count).is_error())
+        return {};
     size_t member_offset = end_of_central_directory.central_directory_offset;
     for (size_t i = 0; i < end_of_central_directory.total_records_count; i++) {
         CentralDirectoryRecord central_directory_record {};
@@ -67,6 +70,10 @@ Optional<Zip> Zip::try_create(ReadonlyBytes buffer)
             return {};
         if (buffer.size() - (local_file_header.compressed_data - buffer.data()) < central_directory_record.compressed_size)
             return {};
+        // If a name occurs more than once, the first record wins, just like with a linear search.
+        StringView name { central_directory_record.name, central_directory_record.name_length };
+        if (!member_offsets.contains(name))
+            member_offsets.set(name, member_offset);
         member_offset += central_directory_record.size();
     }
 
@@ -74,36 +81,52 @@ Optional<Zip> Zip::try_create(ReadonlyBytes buffer)
         end_of_central_directory.total_records_count,
         end_of_central_directory.central_directory_offset,
         buffer,
+        move(member_offsets),
     };
 }
 
+ErrorOr<ZipMember> Zip::member_at_offset(size_t central_directory_record_offset) const
+{
+    CentralDirectoryRecord central_directory_record {};
+    VERIFY(central_directory_record.read(m_input_data.slice(central_directory_record_offset)));
+    LocalFileHeader local_file_header {};
+    VERIFY(local_file_header.read(m_input_data.slice(central_directory_record.local_file_header_offset)));
+
+    ZipMember member;
+    member.name = TRY(String::from_utf8({ central_directory_record.name, central_directory_record.name_length }));
+    member.compressed_data = { local_file_header.compressed_data, central_directory_record.compressed_size };
+    member.compression_method = central_directory_record.compression_method;
+    member.uncompressed_size = central_directory_record.uncompressed_size;
+    member.crc32 = central_directory_record.crc32;
+    member.modification_time = central_directory_record.modification_time;
+    member.modification_date = central_directory_record.modification_date;
+    member.is_directory = central_directory_record.external_attributes & zip_directory_external_attribute || member.name.bytes_as_string_view().ends_with('/'); // FIXME: better directory detection
+    return member;
+}
+
 ErrorOr<bool> Zip::for_each_member(Function<ErrorOr<IterationDecision>(ZipMember const&)> callback) const
 {
     size_t member_offset = m_members_start_offset;
     for (size_t i = 0; i < m_member_count; i++) {
-        CentralDirectoryRecord central_directory_record {};
-        VERIFY(central_directory_record.read(m_input_data.slice(member_offset)));
-        LocalFileHeader local_file_header {};
-        VERIFY(local_file_header.read(m_input_data.slice(central_directory_record.local_file_header_offset)));
-
-        ZipMember member;
-        member.name = TRY(String::from_utf8({ central_directory_record.name, central_directory_record.name_length }));
-        member.compressed_data = { local_file_header.compressed_data, central_directory_record.compressed_size };
-        member.compression_method = central_directory_record.compression_method;
-        member.uncompressed_size = central_directory_record.uncompressed_size;
-        member.crc32 = central_directory_record.crc32;
-        member.modification_time = central_directory_record.modification_time;
-        member.modification_date = central_directory_record.modification_date;
-        member.is_directory = central_directory_record.external_attributes & zip_directory_external_attribute || member.name.bytes_as_string_view().ends_with('/'); // FIXME: better directory detection
-
+        auto member = TRY(member_at_offset(member_offset));
         if (TRY(callback(member)) == IterationDecision::Break)
             return false;
 
+        CentralDirectoryRecord central_directory_record {};
+        VERIFY(central_directory_record.read(m_input_data.slice(member_offset)));
         member_offset += central_directory_record.size();
     }
     return true;
 }
 
+ErrorOr<Optional<ZipMember>> Zip::member_with_name(StringView name) const
+{
+    auto member_offset = m_member_offsets.get(name);
+    if (!member_offset.has_value())
+        return OptionalNone {};
+    return TRY(member_at_offset(*member_offset));
+}
+
 ErrorOr<Statistics> Zip::calculate_statistics() const
 {
     size_t file_count = 0;
@@ -10,6 +10,7 @@
 #include <AK/Array.h>
 #include <AK/DOSPackedTime.h>
 #include <AK/Function.h>
+#include <AK/HashMap.h>
 #include <AK/IterationDecision.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/Stream.h>
@@ -256,20 +257,28 @@ class Zip {
 public:
     static Optional<Zip> try_create(ReadonlyBytes buffer);
     ErrorOr<bool> for_each_member(Function<ErrorOr<IterationDecision>(ZipMember const&)>) const;
+    ErrorOr<Optional<ZipMember>> member_with_name(StringView) const;
     ErrorOr<Statistics> calculate_statistics() const;
 
 private:
     static bool find_end_of_central_directory_offset(ReadonlyBytes, size_t& offset);
 
-    Zip(u16 member_count, size_t members_start_offset, ReadonlyBytes input_data)
+    Zip(u16 member_count, size_t members_start_offset, ReadonlyBytes input_data, HashMap<StringView, size_t> member_offsets)
         : m_member_count { member_count }
         , m_members_start_offset { members_start_offset }
         , m_input_data { input_data }
+        , m_member_offsets { move(member_offsets) }
     {
     }
+
+    ErrorOr<ZipMember> member_at_offset(size_t central_directory_record_offset) const;
+
     u16 m_member_count { 0 };
     size_t m_members_start_offset { 0 };
     ReadonlyBytes m_input_data;
+
+    // Maps member names (pointing into m_input_data) to the offset of their central directory record.
+    HashMap<StringView, size_t> m_member_offsets;
 };
 
 class ZipOutputStream {
@@ -762,6 +762,64 @@ ErrorOr<Vector<i64>, LoaderError> FlacLoaderPlugin::decode_verbatim(FlacSubframe
     return decoded;
 }
 
+// As long as all samples fit into the subframe's bit depth, a prediction can never overflow 64 bits:
+// The coefficients have at most 15 bits and there are at most 32 of them, so a prediction has at most 33 + 15 + 5 = 53 bits.
+// In this case the saturating arithmetic of the general LPC restoration is not needed,
+// and with a fixed order the compiler can fully unroll (and, where the target allows it, vectorize) the prediction.
+// Returns the index of the first sample that still needs to be restored with saturating arithmetic.
+template<size_t Order>
+static size_t restore_lpc_signal_in_range(Span<i64> decoded, ReadonlySpan<i64> coefficients, u8 lpc_shift, u8 bits_per_sample)
+{
+    Array<i64, Order> fixed_coefficients;
+    for (size_t t = 0; t < Order; ++t)
+        fixed_coefficients[t] = coefficients[t];
+
+    i64 const sample_limit = static_cast<i64>(1) << bits_per_sample;
+    for (size_t i = Order; i < decoded.size(); ++i) {
+        i64 prediction = 0;
+        for (size_t t = 0; t < Order; ++t)
+            prediction += fixed_coefficients[t] * decoded[i - t - 1];
+        auto const sample = decoded[i] + (prediction >> lpc_shift);
+        decoded[i] = sample;
+        if (sample >= sample_limit || sample < -sample_limit) [[unlikely]]
+            return i + 1;
+    }
+    return decoded.size();
+}
+
+static size_t restore_lpc_signal_in_range(Span<i64> decoded, ReadonlySpan<i64> coefficients, u8 lpc_shift, u8 order, u8 bits_per_sample)
+{
+    // Larger orders are not allowed in the FLAC subset and therefore rare.
+    switch (order) {
+    case 1:
+        return restore_lpc_signal_in_range<1>(decoded, coefficients, lpc_shift, bits_per_sample);
+    case 2:
+        return restore_lpc_signal_in_range<2>(decoded, coefficients, lpc_shift, bits_per_sample);
+    case 3:
+        return restore_lpc_signal_in_range<3>(decoded, coefficients, lpc_shift, bits_per_sample);
+    case 4:
+        return restore_lpc_signal_in_range<4>(decoded, coefficients, lpc_shift, bits_per_sample);
+    case 5:
+        return restore_lpc_signal_in_range<5>(decoded, coefficients, lpc_shift, bits_per_sample);
+    case 6:
+        return restore_lpc_signal_in_range<6>(decoded, coefficients, lpc_shift, bits_per_sample);
+    case 7:
+        return restore_lpc_signal_in_range<7>(decoded, coefficients, lpc_shift, bits_per_sample);
+    case 8:
+        return restore_lpc_signal_in_range<8>(decoded, coefficients, lpc_shift, bits_per_sample);
+    case 9:
+        return restore_lpc_signal_in_range<9>(decoded, coefficients, lpc_shift, bits_per_sample);
+    case 10:
+        return restore_lpc_signal_in_range<10>(decoded, coefficients, lpc_shift, bits_per_sample);
+    case 11:
+        return restore_lpc_signal_in_range<11>(decoded, coefficients, lpc_shift, bits_per_sample);
+    case 12:
+        return restore_lpc_signal_in_range<12>(decoded, coefficients, lpc_shift, bits_per_sample);
+    default:
+        return order;
+    }
+}
+
 // 11.28. SUBFRAME_LPC
 // Decode a subframe encoded with a custom linear predictor coding, i.e. the subframe provides the polynomial order and coefficients
 ErrorOr<void, LoaderError> FlacLoaderPlugin::decode_custom_lpc(Vector<i64>& decoded, FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input)
@@ -809,7 +867,11 @@ ErrorOr<void, LoaderError> FlacLoaderPlugin::decode_custom_lpc(Vector<i64>& deco
     TRY(decode_residual(decoded, subframe, bit_input));
 
     // approximate the waveform with the predictor
-    for (size_t i = subframe.order; i < m_current_frame->sample_count; ++i) {
+    size_t restored_samples = subframe.order;
+    if (lpc_shift >= 0)
+        restored_samples = restore_lpc_signal_in_range(decoded.span().trim(m_current_frame->sample_count), coefficients, lpc_shift, subframe.order, subframe.bits_per_sample - subframe.wasted_bits_per_sample);
+
+    for (size_t i = restored_samples; i < m_current_frame->sample_count; ++i) {
         // (see below)
         Checked<i64> sample = 0;
         for (size_t t = 0; t < subframe.order; ++t) {
@@ -926,19 +988,13 @@ MaybeLoaderError FlacLoaderPlugin::decode_residual(Vector<i64>& decoded, FlacSub
     if (residual_mode == FlacResidualMode::Rice4Bit) {
         // 11.30.2. RESIDUAL_CODING_METHOD_PARTITIONED_EXP_GOLOMB
         // decode a single Rice partition with four bits for the order k
-        for (size_t i = 0; i < partitions; ++i) {
-            // FIXME: Write into the decode buffer directly.
-            auto rice_partition = TRY(decode_rice_partition(4, partitions, i, subframe, bit_input));
-            decoded.extend(move(rice_partition));
-        }
+        for (size_t i = 0; i < partitions; ++i)
+            TRY(decode_rice_partition(decoded, 4, partitions, i, subframe, bit_input));
     } else if (residual_mode == FlacResidualMode::Rice5Bit) {
         // 11.30.3. RESIDUAL_CODING_METHOD_PARTITIONED_EXP_GOLOMB2
         // five bits equivalent
-        for (size_t i = 0; i < partitions; ++i) {
-            // FIXME: Write into the decode buffer directly.
-            auto rice_partition = TRY(decode_rice_partition(5, partitions, i, subframe, bit_input));
-            decoded.extend(move(rice_partition));
-        }
+        for (size_t i = 0; i < partitions; ++i)
+            TRY(decode_rice_partition(decoded, 5, partitions, i, subframe, bit_input));
     } else
         return LoaderError { LoaderError::Category::Format, static_cast<size_t>(m_current_sample_or_frame), "Reserved residual coding method" };
 
@@ -947,7 +1003,7 @@ MaybeLoaderError FlacLoaderPlugin::decode_residual(Vector<i64>& decoded, FlacSub
 
 // 11.30.2.1. EXP_GOLOMB_PARTITION and 11.30.3.1. EXP_GOLOMB2_PARTITION
 // Decode a single Rice partition as part of the residual, every partition can have its own Rice parameter k
-ALWAYS_INLINE ErrorOr<Vector<i64>, LoaderError> FlacLoaderPlugin::decode_rice_partition(u8 partition_type, u32 partitions, u32 partition_index, FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input)
+ALWAYS_INLINE MaybeLoaderError FlacLoaderPlugin::decode_rice_partition(Vector<i64>& decoded, u8 partition_type, u32 partitions, u32 partition_index, FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input)
 {
     // 11.30.2.2. EXP GOLOMB PARTITION ENCODING PARAMETER and 11.30.3.2. EXP-GOLOMB2 PARTITION ENCODING PARAMETER
     u8 k = TRY(bit_input.read_bits<u8>(partition_type));
@@ -963,32 +1019,32 @@ ALWAYS_INLINE ErrorOr<Vector<i64>, LoaderError> FlacLoaderPlugin::decode_rice_pa
         residual_sample_count -= subframe.order;
     }
 
-    Vector<i64> rice_partition;
-    rice_partition.resize(residual_sample_count);
+    // The residuals are written into the decode buffer directly.
+    TRY(decoded.try_ensure_capacity(decoded.size() + residual_sample_count));
 
     // escape code for unencoded binary partition
     if (k == (1 << partition_type) - 1) {
         u8 unencoded_bps = TRY(bit_input.read_bits<u8>(5));
         if (unencoded_bps != 0) {
-            for (size_t r = 0; r < residual_sample_count; ++r) {
-                rice_partition[r] = sign_extend(TRY(bit_input.read_bits<u32>(unencoded_bps)), unencoded_bps);
-            }
+            for (size_t r = 0; r < residual_sample_count; ++r)
+                decoded.unchecked_append(sign_extend(TRY(bit_input.read_bits<u32>(unencoded_bps)), unencoded_bps));
+        } else {
+            for (size_t r = 0; r < residual_sample_count; ++r)
+                decoded.unchecked_append(0);
         }
     } else {
-        for (size_t r = 0; r < residual_sample_count; ++r) {
-            rice_partition[r] = TRY(decode_unsigned_exp_golomb(k, bit_input));
-        }
+        for (size_t r = 0; r < residual_sample_count; ++r)
+            decoded.unchecked_append(TRY(decode_unsigned_exp_golomb(k, bit_input)));
     }
 
-    return rice_partition;
+    return {};
 }
 
 // Decode a single number encoded with Rice/Exponential-Golomb encoding (the unsigned variant)
 ALWAYS_INLINE ErrorOr<i32> decode_unsigned_exp_golomb(u8 k, BigEndianInputBitStream& bit_input)
 {
-    u8 q = 0;
-    while (TRY(bit_input.read_bit()) == 0)
-        ++q;
+    // most significant bits (quotient), unary-coded
+    u32 q = TRY(bit_input.read_unary_zeros());
 
     // least significant bits (remainder)
     u32 rem = TRY(bit_input.read_bits<u32>(k));
@@ -10,6 +10,8 @@
 #include "MP3Types.h"
 #include <AK/Endian.h>
 #include <AK/FixedArray.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
 #include <LibCore/File.h>
 
 namespace Audio {
@@ -81,6 +83,7 @@ MaybeLoaderError MP3LoaderPlugin::reset()
 {
     TRY(seek(0));
     m_synthesis_buffer = {};
+    m_synthesis_buffer_offset = {};
     m_loaded_samples = 0;
     TRY(m_bit_reservoir.discard(m_bit_reservoir.used_buffer_size()));
     return {};
@@ -94,6 +97,7 @@ MaybeLoaderError MP3LoaderPlugin::seek(int const position)
         m_loaded_samples = seek_entry->sample_index;
     }
     m_synthesis_buffer = {};
+    m_synthesis_buffer_offset = {};
     TRY(m_bit_reservoir.discard(m_bit_reservoir.used_buffer_size()));
     return {};
 }
@@ -315,7 +319,7 @@ ErrorOr<MP3::MP3Frame, LoaderError> MP3LoaderPlugin::read_frame_data(MP3::Header
                 for (size_t band_index = 0; band_index < 32; band_index++) {
                     in_samples[band_index] = granule.filter_bank_input[band_index][sample_index];
                 }
-                synthesis(m_synthesis_buffer[channel_index], in_samples, granule.pcm[sample_index]);
+                synthesis(m_synthesis_buffer[channel_index], m_synthesis_buffer_offset[channel_index], in_samples, granule.pcm[sample_index]);
             }
         }
     }
@@ -807,58 +811,61 @@ void MP3LoaderPlugin::transform_samples_to_time(Array<float, MP3::granule_size>
 
     } else {
         s_mdct_36.transform(ReadonlySpan<float>(input).slice(input_offset, 18), output);
-        for (size_t i = 0; i < 36; i++) {
+        auto const& window = [&]() -> Array<float, 36> const& {
             switch (block_type) {
             case MP3::BlockType::Normal:
-                output[i] *= MP3::Tables::WindowBlockTypeNormal[i];
-                break;
+                return MP3::Tables::WindowBlockTypeNormal;
             case MP3::BlockType::Start:
-                output[i] *= MP3::Tables::WindowBlockTypeStart[i];
-                break;
+                return MP3::Tables::WindowBlockTypeStart;
             case MP3::BlockType::End:
-                output[i] *= MP3::Tables::WindowBlockTypeEnd[i];
-                break;
+                return MP3::Tables::WindowBlockTypeEnd;
             case MP3::BlockType::Short:
-                VERIFY_NOT_REACHED();
                 break;
             }
-        }
+            VERIFY_NOT_REACHED();
+        }();
+        for (size_t i = 0; i < 36; i++)
+            output[i] *= window[i];
     }
 }
 
 // ISO/IEC 11172-3 (Figure A.2)
-void MP3LoaderPlugin::synthesis(Array<float, 1024>& V, Array<float, 32>& samples, Array<float, 32>& result)
+// V is used as a ring buffer starting at V_offset, instead of shifting all of its values for every call.
+// Since the offset is always a multiple of 64, none of the 32-value runs accessed below wrap around.
+void MP3LoaderPlugin::synthesis(Array<float, 1024>& V, size_t& V_offset, Array<float, 32> const& samples, Array<float, 32>& result)
 {
-    for (size_t i = 1023; i >= 64; i--) {
-        V[i] = V[i - 64];
-    }
-
-    for (size_t i = 0; i < 64; i++) {
-        V[i] = 0;
-        for (size_t k = 0; k < 32; k++) {
-            float const N = MP3::Tables::SynthesisSubbandFilterCoefficients[i][k];
-            V[i] += N * samples[k];
-        }
-    }
-
-    Array<float, 512> U;
-    for (size_t i = 0; i < 8; i++) {
-        for (size_t j = 0; j < 32; j++) {
-            U[i * 64 + j] = V[i * 128 + j];
-            U[i * 64 + 32 + j] = V[i * 128 + 96 + j];
-        }
-    }
-
-    Array<float, 512> W;
-    for (size_t i = 0; i < 512; i++) {
-        W[i] = U[i] * MP3::Tables::WindowSynthesis[i];
-    }
-
-    for (size_t j = 0; j < 32; j++) {
-        result[j] = 0;
-        for (size_t k = 0; k < 16; k++) {
-            result[j] += W[j + 32 * k];
+    using AK::SIMD::f32x4;
+    using AK::SIMD::load_unaligned;
+    using AK::SIMD::store_unaligned;
+
+    // The filter coefficients are transposed, so that four values of V can be computed at once.
+    static auto const filter_coefficients_by_sample = [] {
+        Array<Array<float, 64>, 32> coefficients;
+        for (size_t i = 0; i < 64; i++) {
+            for (size_t k = 0; k < 32; k++)
+                coefficients[k][i] = MP3::Tables::SynthesisSubbandFilterCoefficients[i][k];
+        }
+        return coefficients;
+    }();
+
+    V_offset = (V_offset + V.size() - 64) % V.size();
+    auto* new_values = &V[V_offset];
+    for (size_t i = 0; i < 64; i += 4) {
+        f32x4 value {};
+        for (size_t k = 0; k < 32; k++)
+            value += samples[k] * load_unaligned<f32x4>(&filter_coefficients_by_sample[k][i]);
+        store_unaligned(&new_values[i], value);
+    }
+
+    // This builds the vector U from V and windows it into W, while summing up the 16 values of W for each output sample.
+    auto V_at = [&](size_t index) { return &V[(V_offset + index) % V.size()]; };
+    for (size_t j = 0; j < 32; j += 4) {
+        f32x4 sum {};
+        for (size_t i = 0; i < 8; i++) {
+            sum += load_unaligned<f32x4>(V_at(i * 128 + j)) * load_unaligned<f32x4>(&MP3::Tables::WindowSynthesis[i * 64 + j]);
+            sum += load_unaligned<f32x4>(V_at(i * 128 + 96 + j)) * load_unaligned<f32x4>(&MP3::Tables::WindowSynthesis[i * 64 + 32 + j]);
         }
+        store_unaligned(&result[j], sum);
     }
 }
 
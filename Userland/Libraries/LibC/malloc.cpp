@@ -5,8 +5,10 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Atomic.h>
 #include <AK/BuiltinWrappers.h>
 #include <AK/Debug.h>
+#include <AK/HashFunctions.h>
 #include <AK/ScopedValueRollback.h>
 #include <AK/Vector.h>
 #include <errno.h>
@@ -26,11 +28,13 @@ public:
         : m_mutex(mutex)
     {
         lock();
+        // NOTE: Locks may be nested, the heap only becomes stable again once the outermost one is released.
+        m_heap_was_stable = __heap_is_stable;
         __heap_is_stable = false;
     }
     ALWAYS_INLINE ~PthreadMutexLocker()
     {
-        __heap_is_stable = true;
+        __heap_is_stable = m_heap_was_stable;
         unlock();
     }
     ALWAYS_INLINE void lock() { pthread_mutex_lock(&m_mutex); }
@@ -38,21 +42,33 @@ public:
 
 private:
     pthread_mutex_t& m_mutex;
+    bool m_heap_was_stable { true };
 };
 
 #define RECYCLE_BIG_ALLOCATIONS
 
-static pthread_mutex_t s_malloc_mutex = PTHREAD_MUTEX_INITIALIZER;
+// Each size class has a lock of its own, the empty blocks that are shared between them have this one.
+// A size class lock may be held while taking this one, but not the other way around.
+static pthread_mutex_t s_empty_blocks_mutex = PTHREAD_MUTEX_INITIALIZER;
 bool __heap_is_stable = true;
 
 constexpr size_t number_of_hot_chunked_blocks_to_keep_around = 16;
 constexpr size_t number_of_cold_chunked_blocks_to_keep_around = 16;
 constexpr size_t number_of_big_blocks_to_keep_around_per_size_class = 8;
 
+// The smallest size classes (up to 496 bytes) are cached per thread, they make up the bulk of allocations.
+// Chunks move between a thread cache and its size class in batches, so the lock is only taken every so often.
+constexpr size_t number_of_thread_cached_size_classes = 6;
+constexpr size_t number_of_chunks_to_cache_per_thread = 32;
+constexpr size_t thread_cache_batch_size = 16;
+static_assert(number_of_thread_cached_size_classes <= num_size_classes);
+static_assert(thread_cache_batch_size <= number_of_chunks_to_cache_per_thread);
+
 static bool s_log_malloc = false;
 static bool s_scrub_malloc = true;
 static bool s_scrub_free = true;
 static bool s_profiling = false;
+static size_t s_profiling_sample_interval = 0;
 static bool s_in_userspace_emulator = false;
 
 ALWAYS_INLINE static void ue_notify_malloc(void const* ptr, size_t size)
@@ -92,6 +108,78 @@ struct MemoryAuditingSuppressor {
     }
 };
 
+// The sampling profiler reports an allocation roughly every s_profiling_sample_interval allocated bytes.
+// The sampled allocations are remembered here, so their frees can be reported as well (and only theirs).
+// If the table runs full, allocations just aren't sampled until there is room again.
+static constexpr size_t sampled_allocation_table_size = 4096;
+static constexpr size_t sampled_allocation_probe_limit = 8;
+static Atomic<FlatPtr> s_sampled_allocations[sampled_allocation_table_size];
+static Atomic<size_t> s_sampled_allocation_count;
+#ifndef NO_TLS
+static __thread ssize_t s_bytes_until_next_sample;
+#endif
+
+#ifndef NO_TLS
+static bool remember_sampled_allocation(void* ptr)
+{
+    auto address = reinterpret_cast<FlatPtr>(ptr);
+    auto index = ptr_hash(address);
+    for (size_t i = 0; i < sampled_allocation_probe_limit; ++i) {
+        FlatPtr expected = 0;
+        if (s_sampled_allocations[(index + i) % sampled_allocation_table_size].compare_exchange_strong(expected, address, AK::memory_order_relaxed)) {
+            s_sampled_allocation_count.fetch_add(1, AK::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
+static bool forget_sampled_allocation(void* ptr)
+{
+    if (s_sampled_allocation_count.load(AK::memory_order_relaxed) == 0)
+        return false;
+    auto address = reinterpret_cast<FlatPtr>(ptr);
+    auto index = ptr_hash(address);
+    for (size_t i = 0; i < sampled_allocation_probe_limit; ++i) {
+        auto expected = address;
+        if (s_sampled_allocations[(index + i) % sampled_allocation_table_size].compare_exchange_strong(expected, 0, AK::memory_order_relaxed)) {
+            s_sampled_allocation_count.fetch_sub(1, AK::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+ALWAYS_INLINE static void profile_malloc(void const* ptr, size_t size)
+{
+    if (s_profiling) {
+        perf_event(PERF_EVENT_MALLOC, size, reinterpret_cast<FlatPtr>(ptr));
+        return;
+    }
+#ifndef NO_TLS
+    if (!s_profiling_sample_interval)
+        return;
+    s_bytes_until_next_sample -= size;
+    if (s_bytes_until_next_sample > 0)
+        return;
+    s_bytes_until_next_sample = s_profiling_sample_interval;
+    if (remember_sampled_allocation(const_cast<void*>(ptr)))
+        perf_event(PERF_EVENT_MALLOC, size, reinterpret_cast<FlatPtr>(ptr));
+#endif
+}
+
+ALWAYS_INLINE static void profile_free(void const* ptr)
+{
+    if (s_profiling) {
+        perf_event(PERF_EVENT_FREE, reinterpret_cast<FlatPtr>(ptr), 0);
+        return;
+    }
+    if (s_profiling_sample_interval && ptr && forget_sampled_allocation(const_cast<void*>(ptr)))
+        perf_event(PERF_EVENT_FREE, reinterpret_cast<FlatPtr>(ptr), 0);
+}
+
+// NOTE: The statistics are updated under the lock of whichever part of the heap they concern, so they are approximate.
 struct MallocStats {
     size_t number_of_malloc_calls;
 
@@ -114,6 +202,9 @@ struct MallocStats {
     size_t number_of_hot_keeps;
     size_t number_of_cold_keeps;
     size_t number_of_frees;
+
+    size_t number_of_thread_cache_refills;
+    size_t number_of_thread_cache_flushes;
 };
 static MallocStats g_malloc_stats = {};
 
@@ -123,6 +214,7 @@ static size_t s_cold_empty_block_count { 0 };
 static ChunkedBlock* s_cold_empty_blocks[number_of_cold_chunked_blocks_to_keep_around] { nullptr };
 
 struct Allocator {
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
     size_t size { 0 };
     size_t block_count { 0 };
     ChunkedBlock::List usable_blocks;
@@ -130,9 +222,21 @@ struct Allocator {
 };
 
 struct BigAllocator {
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
     Vector<BigAllocationBlock*, number_of_big_blocks_to_keep_around_per_size_class> blocks;
 };
 
+#ifndef NO_TLS
+struct ThreadCache {
+    struct Bin {
+        size_t count;
+        void* chunks[number_of_chunks_to_cache_per_thread];
+    };
+    Bin bins[number_of_thread_cached_size_classes];
+};
+static __thread ThreadCache s_thread_cache;
+#endif
+
 // Allocators will be initialized in __malloc_init.
 // We can not rely on global constructors to initialize them,
 // because they must be initialized before other global constructors
@@ -292,93 +396,64 @@ enum class CallerWillInitializeMemory {
 __thread bool s_allocation_enabled = true;
 #endif
 
-static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializeMemory caller_will_initialize_memory)
+static ErrorOr<void*> allocate_big_block(size_t size, size_t align)
 {
-#ifndef NO_TLS
-    VERIFY(s_allocation_enabled);
-#endif
-
-    // Align must be a power of 2.
-    if (popcount(align) != 1)
-        return EINVAL;
-
-    // FIXME: Support larger than 32KiB alignments (if you dare).
-    if (sizeof(BigAllocationBlock) + align >= ChunkedBlock::block_size)
-        return EINVAL;
-
-    if (s_log_malloc)
-        dbgln("LibC: malloc({})", size);
-
-    if (!size) {
-        // Legally we could just return a null pointer here, but this is more
-        // compatible with existing software.
-        size = 1;
+    size_t real_size = round_up_to_power_of_two(sizeof(BigAllocationBlock) + size + ((align > 16) ? align : 0), ChunkedBlock::block_size);
+    if (real_size < size) {
+        dbgln_if(MALLOC_DEBUG, "LibC: Detected overflow trying to do big allocation of size {} for {}", real_size, size);
+        return ENOMEM;
     }
-
-    g_malloc_stats.number_of_malloc_calls++;
-
-    size_t good_size;
-    auto* allocator = allocator_for_size(size, good_size, align);
-
-    PthreadMutexLocker locker(s_malloc_mutex);
-
-    if (!allocator) {
-        size_t real_size = round_up_to_power_of_two(sizeof(BigAllocationBlock) + size + ((align > 16) ? align : 0), ChunkedBlock::block_size);
-        if (real_size < size) {
-            dbgln_if(MALLOC_DEBUG, "LibC: Detected overflow trying to do big allocation of size {} for {}", real_size, size);
-            return ENOMEM;
-        }
 #ifdef RECYCLE_BIG_ALLOCATIONS
-        if (auto* allocator = big_allocator_for_size(real_size)) {
-            if (!allocator->blocks.is_empty()) {
-                g_malloc_stats.number_of_big_allocator_hits++;
-                auto* block = allocator->blocks.take_last();
-                int rc = madvise(block, real_size, MADV_SET_NONVOLATILE);
-                bool this_block_was_purged = rc == 1;
-                if (rc < 0) {
-                    perror("madvise");
-                    VERIFY_NOT_REACHED();
-                }
-                if (mprotect(block, real_size, PROT_READ | PROT_WRITE) < 0) {
-                    perror("mprotect");
-                    VERIFY_NOT_REACHED();
-                }
-                if (this_block_was_purged) {
-                    g_malloc_stats.number_of_big_allocator_purge_hits++;
-                    new (block) BigAllocationBlock(real_size);
-                }
-
-                void* ptr = reinterpret_cast<void*>(round_up_to_power_of_two(reinterpret_cast<uintptr_t>(&block->m_slot[0]), align));
-
-                ue_notify_malloc(ptr, size);
-                return ptr;
+    if (auto* allocator = big_allocator_for_size(real_size)) {
+        PthreadMutexLocker locker(allocator->mutex);
+        if (!allocator->blocks.is_empty()) {
+            g_malloc_stats.number_of_big_allocator_hits++;
+            auto* block = allocator->blocks.take_last();
+            int rc = madvise(block, real_size, MADV_SET_NONVOLATILE);
+            bool this_block_was_purged = rc == 1;
+            if (rc < 0) {
+                perror("madvise");
+                VERIFY_NOT_REACHED();
+            }
+            if (mprotect(block, real_size, PROT_READ | PROT_WRITE) < 0) {
+                perror("mprotect");
+                VERIFY_NOT_REACHED();
+            }
+            if (this_block_was_purged) {
+                g_malloc_stats.number_of_big_allocator_purge_hits++;
+                new (block) BigAllocationBlock(real_size);
             }
+
+            return reinterpret_cast<void*>(round_up_to_power_of_two(reinterpret_cast<uintptr_t>(&block->m_slot[0]), align));
         }
+    }
 #endif
-        auto* block = (BigAllocationBlock*)TRY(os_alloc(real_size, "malloc: BigAllocationBlock"));
-        g_malloc_stats.number_of_big_allocs++;
-        new (block) BigAllocationBlock(real_size);
+    auto* block = (BigAllocationBlock*)TRY(os_alloc(real_size, "malloc: BigAllocationBlock"));
+    g_malloc_stats.number_of_big_allocs++;
+    new (block) BigAllocationBlock(real_size);
 
-        void* ptr = reinterpret_cast<void*>(round_up_to_power_of_two(reinterpret_cast<uintptr_t>(&block->m_slot[0]), align));
-        ue_notify_malloc(ptr, size);
-        return ptr;
-    }
+    return reinterpret_cast<void*>(round_up_to_power_of_two(reinterpret_cast<uintptr_t>(&block->m_slot[0]), align));
+}
 
+static ChunkedBlock* take_empty_block(size_t good_size)
+{
     ChunkedBlock* block = nullptr;
-    void* ptr = nullptr;
-    for (auto& current : allocator->usable_blocks) {
-        if (current.free_chunks()) {
-            ptr = try_allocate_chunk_aligned(align, current);
-            if (ptr) {
-                block = &current;
-                break;
-            }
+    bool block_is_cold = false;
+    {
+        PthreadMutexLocker locker(s_empty_blocks_mutex);
+        if (s_hot_empty_block_count) {
+            g_malloc_stats.number_of_hot_empty_block_hits++;
+            block = s_hot_empty_blocks[--s_hot_empty_block_count];
+        } else if (s_cold_empty_block_count) {
+            g_malloc_stats.number_of_cold_empty_block_hits++;
+            block = s_cold_empty_blocks[--s_cold_empty_block_count];
+            block_is_cold = true;
         }
     }
+    if (!block)
+        return nullptr;
 
-    if (!block && s_hot_empty_block_count) {
-        g_malloc_stats.number_of_hot_empty_block_hits++;
-        block = s_hot_empty_blocks[--s_hot_empty_block_count];
+    if (!block_is_cold) {
         if (block->m_size != good_size) {
             new (block) ChunkedBlock(good_size);
             ue_notify_chunk_size_changed(block, good_size);
@@ -386,40 +461,58 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
             snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
             set_mmap_name(block, ChunkedBlock::block_size, buffer);
         }
-        allocator->usable_blocks.append(*block);
+        return block;
     }
 
-    if (!block && s_cold_empty_block_count) {
-        g_malloc_stats.number_of_cold_empty_block_hits++;
-        block = s_cold_empty_blocks[--s_cold_empty_block_count];
-        int rc = madvise(block, ChunkedBlock::block_size, MADV_SET_NONVOLATILE);
-        bool this_block_was_purged = rc == 1;
-        if (rc < 0) {
-            perror("madvise");
-            VERIFY_NOT_REACHED();
-        }
-        rc = mprotect(block, ChunkedBlock::block_size, PROT_READ | PROT_WRITE);
-        if (rc < 0) {
-            perror("mprotect");
-            VERIFY_NOT_REACHED();
-        }
-        if (this_block_was_purged || block->m_size != good_size) {
-            if (this_block_was_purged)
-                g_malloc_stats.number_of_cold_empty_block_purge_hits++;
-            new (block) ChunkedBlock(good_size);
-            ue_notify_chunk_size_changed(block, good_size);
+    int rc = madvise(block, ChunkedBlock::block_size, MADV_SET_NONVOLATILE);
+    bool this_block_was_purged = rc == 1;
+    if (rc < 0) {
+        perror("madvise");
+        VERIFY_NOT_REACHED();
+    }
+    rc = mprotect(block, ChunkedBlock::block_size, PROT_READ | PROT_WRITE);
+    if (rc < 0) {
+        perror("mprotect");
+        VERIFY_NOT_REACHED();
+    }
+    if (this_block_was_purged || block->m_size != good_size) {
+        if (this_block_was_purged)
+            g_malloc_stats.number_of_cold_empty_block_purge_hits++;
+        new (block) ChunkedBlock(good_size);
+        ue_notify_chunk_size_changed(block, good_size);
+    }
+    return block;
+}
+
+// The lock of the allocator has to be held.
+static ErrorOr<void*> allocate_chunk(Allocator& allocator, size_t align)
+{
+    ChunkedBlock* block = nullptr;
+    void* ptr = nullptr;
+    for (auto& current : allocator.usable_blocks) {
+        if (current.free_chunks()) {
+            ptr = try_allocate_chunk_aligned(align, current);
+            if (ptr) {
+                block = &current;
+                break;
+            }
         }
-        allocator->usable_blocks.append(*block);
+    }
+
+    if (!block) {
+        block = take_empty_block(allocator.size);
+        if (block)
+            allocator.usable_blocks.append(*block);
     }
 
     if (!block) {
         g_malloc_stats.number_of_block_allocs++;
         char buffer[64];
-        snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
+        snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", allocator.size);
         block = (ChunkedBlock*)TRY(os_alloc(ChunkedBlock::block_size, buffer));
-        new (block) ChunkedBlock(good_size);
-        allocator->usable_blocks.append(*block);
-        ++allocator->block_count;
+        new (block) ChunkedBlock(allocator.size);
+        allocator.usable_blocks.append(*block);
+        ++allocator.block_count;
     }
 
     if (!ptr) {
@@ -429,14 +522,138 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
     VERIFY(ptr);
     if (block->is_full()) {
         g_malloc_stats.number_of_blocks_full++;
-        dbgln_if(MALLOC_DEBUG, "Block {:p} is now full in size class {}", block, good_size);
-        allocator->usable_blocks.remove(*block);
-        allocator->full_blocks.append(*block);
+        dbgln_if(MALLOC_DEBUG, "Block {:p} is now full in size class {}", block, allocator.size);
+        allocator.usable_blocks.remove(*block);
+        allocator.full_blocks.append(*block);
     }
     dbgln_if(MALLOC_DEBUG, "LibC: allocated {:p} (chunk in block {:p}, size {})", ptr, block, block->bytes_per_chunk());
+    return ptr;
+}
+
+// The lock of the allocator has to be held.
+static void free_chunk(Allocator& allocator, void* ptr)
+{
+    auto* block = (ChunkedBlock*)((FlatPtr)ptr & ChunkedBlock::block_mask);
+
+    auto* entry = (FreelistEntry*)ptr;
+    entry->next = block->m_freelist;
+    block->m_freelist = entry;
+
+    if (block->is_full()) {
+        dbgln_if(MALLOC_DEBUG, "Block {:p} no longer full in size class {}", block, allocator.size);
+        g_malloc_stats.number_of_freed_full_blocks++;
+        allocator.full_blocks.remove(*block);
+        allocator.usable_blocks.prepend(*block);
+    }
+
+    ++block->m_free_chunks;
+
+    if (!block->used_chunks()) {
+        allocator.usable_blocks.remove(*block);
+        {
+            PthreadMutexLocker locker(s_empty_blocks_mutex);
+            if (s_hot_empty_block_count < number_of_hot_chunked_blocks_to_keep_around) {
+                dbgln_if(MALLOC_DEBUG, "Keeping hot block {:p} around", block);
+                g_malloc_stats.number_of_hot_keeps++;
+                s_hot_empty_blocks[s_hot_empty_block_count++] = block;
+                return;
+            }
+            if (s_cold_empty_block_count < number_of_cold_chunked_blocks_to_keep_around) {
+                dbgln_if(MALLOC_DEBUG, "Keeping cold block {:p} around", block);
+                g_malloc_stats.number_of_cold_keeps++;
+                // NOTE: This has to happen before the lock is released, after that someone else may take the block.
+                mprotect(block, ChunkedBlock::block_size, PROT_NONE);
+                madvise(block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
+                s_cold_empty_blocks[s_cold_empty_block_count++] = block;
+                return;
+            }
+        }
+        dbgln_if(MALLOC_DEBUG, "Releasing block {:p} for size class {}", block, allocator.size);
+        g_malloc_stats.number_of_frees++;
+        --allocator.block_count;
+        os_free(block, ChunkedBlock::block_size);
+    }
+}
+
+#ifndef NO_TLS
+static ErrorOr<void> refill_thread_cache(Allocator& allocator, ThreadCache::Bin& bin)
+{
+    PthreadMutexLocker locker(allocator.mutex);
+    g_malloc_stats.number_of_thread_cache_refills++;
+    while (bin.count < thread_cache_batch_size) {
+        auto ptr_or_error = allocate_chunk(allocator, 16);
+        if (ptr_or_error.is_error()) {
+            // Whatever we got so far is good enough.
+            if (bin.count > 0)
+                break;
+            return ptr_or_error.release_error();
+        }
+        bin.chunks[bin.count++] = ptr_or_error.value();
+    }
+    return {};
+}
+
+static void flush_thread_cache(Allocator& allocator, ThreadCache::Bin& bin, size_t count)
+{
+    PthreadMutexLocker locker(allocator.mutex);
+    g_malloc_stats.number_of_thread_cache_flushes++;
+    for (size_t i = 0; i < count; ++i)
+        free_chunk(allocator, bin.chunks[--bin.count]);
+}
+#endif
+
+static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializeMemory caller_will_initialize_memory)
+{
+#ifndef NO_TLS
+    VERIFY(s_allocation_enabled);
+#endif
+
+    // Align must be a power of 2.
+    if (popcount(align) != 1)
+        return EINVAL;
+
+    // FIXME: Support larger than 32KiB alignments (if you dare).
+    if (sizeof(BigAllocationBlock) + align >= ChunkedBlock::block_size)
+        return EINVAL;
+
+    if (s_log_malloc)
+        dbgln("LibC: malloc({})", size);
+
+    if (!size) {
+        // Legally we could just return a null pointer here, but this is more
+        // compatible with existing software.
+        size = 1;
+    }
+
+    g_malloc_stats.number_of_malloc_calls++;
+
+    size_t good_size;
+    auto* allocator = allocator_for_size(size, good_size, align);
+
+    if (!allocator) {
+        auto* ptr = TRY(allocate_big_block(size, align));
+        ue_notify_malloc(ptr, size);
+        return ptr;
+    }
+
+    void* ptr = nullptr;
+#ifndef NO_TLS
+    // Every chunk is 16-byte aligned, so the thread cache can serve anything that doesn't ask for more.
+    size_t size_class = allocator - allocators();
+    if (align <= 16 && size_class < number_of_thread_cached_size_classes) {
+        auto& bin = s_thread_cache.bins[size_class];
+        if (bin.count == 0)
+            TRY(refill_thread_cache(*allocator, bin));
+        ptr = bin.chunks[--bin.count];
+    }
+#endif
+    if (!ptr) {
+        PthreadMutexLocker locker(allocator->mutex);
+        ptr = TRY(allocate_chunk(*allocator, align));
+    }
 
     if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
-        memset(ptr, MALLOC_SCRUB_BYTE, block->m_size);
+        memset(ptr, MALLOC_SCRUB_BYTE, good_size);
 
     ue_notify_malloc(ptr, size);
     return ptr;
@@ -458,12 +675,11 @@ static void free_impl(void* ptr)
     void* block_base = (void*)((FlatPtr)ptr & ChunkedBlock::ChunkedBlock::block_mask);
     size_t magic = *(size_t*)block_base;
 
-    PthreadMutexLocker locker(s_malloc_mutex);
-
     if (magic == MAGIC_BIGALLOC_HEADER) {
         auto* block = (BigAllocationBlock*)block_base;
 #ifdef RECYCLE_BIG_ALLOCATIONS
         if (auto* allocator = big_allocator_for_size(block->m_size)) {
+            PthreadMutexLocker locker(allocator->mutex);
             if (allocator->blocks.size() < number_of_big_blocks_to_keep_around_per_size_class) {
                 g_malloc_stats.number_of_big_allocator_keeps++;
                 allocator->blocks.append(block);
@@ -493,46 +709,23 @@ static void free_impl(void* ptr)
     if (s_scrub_free)
         memset(ptr, FREE_SCRUB_BYTE, block->bytes_per_chunk());
 
-    auto* entry = (FreelistEntry*)ptr;
-    entry->next = block->m_freelist;
-    block->m_freelist = entry;
+    // NOTE: The chunk size of a block only changes once it is empty, which it can't be while this chunk is in use.
+    size_t good_size;
+    auto* allocator = allocator_for_size(block->m_size, good_size);
 
-    if (block->is_full()) {
-        size_t good_size;
-        auto* allocator = allocator_for_size(block->m_size, good_size);
-        dbgln_if(MALLOC_DEBUG, "Block {:p} no longer full in size class {}", block, good_size);
-        g_malloc_stats.number_of_freed_full_blocks++;
-        allocator->full_blocks.remove(*block);
-        allocator->usable_blocks.prepend(*block);
+#ifndef NO_TLS
+    size_t size_class = allocator - allocators();
+    if (size_class < number_of_thread_cached_size_classes) {
+        auto& bin = s_thread_cache.bins[size_class];
+        if (bin.count == number_of_chunks_to_cache_per_thread)
+            flush_thread_cache(*allocator, bin, thread_cache_batch_size);
+        bin.chunks[bin.count++] = ptr;
+        return;
     }
+#endif
 
-    ++block->m_free_chunks;
-
-    if (!block->used_chunks()) {
-        size_t good_size;
-        auto* allocator = allocator_for_size(block->m_size, good_size);
-        if (s_hot_empty_block_count < number_of_hot_chunked_blocks_to_keep_around) {
-            dbgln_if(MALLOC_DEBUG, "Keeping hot block {:p} around", block);
-            g_malloc_stats.number_of_hot_keeps++;
-            allocator->usable_blocks.remove(*block);
-            s_hot_empty_blocks[s_hot_empty_block_count++] = block;
-            return;
-        }
-        if (s_cold_empty_block_count < number_of_cold_chunked_blocks_to_keep_around) {
-            dbgln_if(MALLOC_DEBUG, "Keeping cold block {:p} around", block);
-            g_malloc_stats.number_of_cold_keeps++;
-            allocator->usable_blocks.remove(*block);
-            s_cold_empty_blocks[s_cold_empty_block_count++] = block;
-            mprotect(block, ChunkedBlock::block_size, PROT_NONE);
-            madvise(block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
-            return;
-        }
-        dbgln_if(MALLOC_DEBUG, "Releasing block {:p} for size class {}", block, good_size);
-        g_malloc_stats.number_of_frees++;
-        allocator->usable_blocks.remove(*block);
-        --allocator->block_count;
-        os_free(block, ChunkedBlock::block_size);
-    }
+    PthreadMutexLocker locker(allocator->mutex);
+    free_chunk(*allocator, ptr);
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/malloc.html
@@ -546,9 +739,7 @@ void* malloc(size_t size)
         return nullptr;
     }
 
-    if (s_profiling)
-        perf_event(PERF_EVENT_MALLOC, size, reinterpret_cast<FlatPtr>(ptr_or_error.value()));
-
+    profile_malloc(ptr_or_error.value(), size);
     return ptr_or_error.value();
 }
 
@@ -556,8 +747,7 @@ void* malloc(size_t size)
 void free(void* ptr)
 {
     MemoryAuditingSuppressor suppressor;
-    if (s_profiling)
-        perf_event(PERF_EVENT_FREE, reinterpret_cast<FlatPtr>(ptr), 0);
+    profile_free(ptr);
     ue_notify_free(ptr);
     free_impl(ptr);
 }
@@ -579,6 +769,7 @@ void* calloc(size_t count, size_t size)
     }
 
     memset(ptr_or_error.value(), 0, new_size);
+    profile_malloc(ptr_or_error.value(), new_size);
     return ptr_or_error.value();
 }
 
@@ -591,6 +782,7 @@ int posix_memalign(void** memptr, size_t alignment, size_t size)
     if (ptr_or_error.is_error())
         return ptr_or_error.error().code();
 
+    profile_malloc(ptr_or_error.value(), size);
     *memptr = ptr_or_error.value();
     return 0;
 }
@@ -605,6 +797,7 @@ void* aligned_alloc(size_t alignment, size_t size)
         return nullptr;
     }
 
+    profile_malloc(ptr_or_error.value(), size);
     return ptr_or_error.value();
 }
 
@@ -672,6 +865,8 @@ void __malloc_init()
         s_log_malloc = true;
     if (secure_getenv("LIBC_PROFILE_MALLOC"))
         s_profiling = true;
+    if (auto* interval = secure_getenv("LIBC_PROFILE_MALLOC_SAMPLE_INTERVAL"))
+        s_profiling_sample_interval = strtoul(interval, nullptr, 10);
 
     for (size_t i = 0; i < num_size_classes; ++i) {
         new (&allocators()[i]) Allocator();
@@ -681,6 +876,62 @@ void __malloc_init()
     new (&big_allocators()[0])(BigAllocator);
 }
 
+void __malloc_thread_exit()
+{
+#ifndef NO_TLS
+    // Hand the chunks cached by this thread back, nobody else can get at them.
+    for (size_t i = 0; i < number_of_thread_cached_size_classes; ++i) {
+        auto& bin = s_thread_cache.bins[i];
+        if (bin.count > 0)
+            flush_thread_cache(allocators()[i], bin, bin.count);
+    }
+#endif
+}
+
+static_assert(SERENITY_MALLOC_SIZE_CLASS_COUNT == num_size_classes);
+
+int serenity_get_malloc_stats(struct serenity_malloc_stats* stats)
+{
+    if (!stats) {
+        errno = EFAULT;
+        return -1;
+    }
+
+    MemoryAuditingSuppressor suppressor;
+    *stats = {};
+    stats->block_size = ChunkedBlock::block_size;
+
+    for (size_t i = 0; i < num_size_classes; ++i) {
+        auto& allocator = allocators()[i];
+        auto& size_class = stats->size_classes[i];
+        size_class.chunk_size = allocator.size;
+
+        PthreadMutexLocker locker(allocator.mutex);
+        auto add_block = [&](ChunkedBlock const& block) {
+            ++size_class.block_count;
+            size_class.chunk_count += block.chunk_capacity();
+            size_class.used_chunk_count += block.used_chunks();
+        };
+        for (auto& block : allocator.usable_blocks)
+            add_block(block);
+        for (auto& block : allocator.full_blocks)
+            add_block(block);
+    }
+
+    {
+        PthreadMutexLocker locker(s_empty_blocks_mutex);
+        stats->hot_empty_block_count = s_hot_empty_block_count;
+        stats->cold_empty_block_count = s_cold_empty_block_count;
+    }
+
+#ifdef RECYCLE_BIG_ALLOCATIONS
+    auto& big_allocator = big_allocators()[0];
+    PthreadMutexLocker locker(big_allocator.mutex);
+    stats->cached_big_allocation_block_count = big_allocator.blocks.size();
+#endif
+    return 0;
+}
+
 void serenity_dump_malloc_stats()
 {
     dbgln("# malloc() calls: {}", g_malloc_stats.number_of_malloc_calls);
@@ -704,5 +955,8 @@ void serenity_dump_malloc_stats()
     dbgln("number of hot keeps: {}", g_malloc_stats.number_of_hot_keeps);
     dbgln("number of cold keeps: {}", g_malloc_stats.number_of_cold_keeps);
     dbgln("number of frees: {}", g_malloc_stats.number_of_frees);
+    dbgln();
+    dbgln("thread cache refills: {}", g_malloc_stats.number_of_thread_cache_refills);
+    dbgln("thread cache flushes: {}", g_malloc_stats.number_of_thread_cache_flushes);
 }
 }
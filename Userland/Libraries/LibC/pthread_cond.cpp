@@ -155,7 +155,16 @@ int pthread_cond_broadcast(pthread_cond_t* cond)
     pthread_mutex_t* mutex = AK::atomic_load(&cond->mutex, AK::memory_order_relaxed);
     VERIFY(mutex);
 
-    int rc = futex(&cond->value, FUTEX_REQUEUE | FUTEX_PRIVATE_FLAG, -1, nullptr, &mutex->lock, INT_MAX);
+    // Priority-inheriting mutexes are owned through the kernel, so their waiters can't be moved onto the lock word.
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT) {
+        int rc = futex_wake(&cond->value, INT_MAX, false);
+        VERIFY(rc >= 0);
+        return 0;
+    }
+
+    // Wake a single waiter and move everyone else over to the mutex. Since the woken thread takes the mutex
+    // pessimistically, each unlock will wake the next requeued waiter, so they don't all stampede on the mutex at once.
+    int rc = futex(&cond->value, FUTEX_REQUEUE | FUTEX_PRIVATE_FLAG, 1, reinterpret_cast<timespec const*>(static_cast<uintptr_t>(INT_MAX)), &mutex->lock, 0);
     VERIFY(rc >= 0);
     return 0;
 }
@@ -104,12 +104,53 @@ int pthread_mutex_init(pthread_mutex_t* mutex, pthread_mutexattr_t const* attrib
     mutex->owner = 0;
     mutex->level = 0;
     mutex->type = attributes ? attributes->type : __PTHREAD_MUTEX_NORMAL;
+    mutex->protocol = attributes ? attributes->protocol : __PTHREAD_PRIO_NONE;
+    return 0;
+}
+
+// Priority-inheriting mutexes store the owner's TID in the lock word, so that the kernel knows whose priority
+// to boost while others are waiting for it. Contention is handled entirely by the kernel.
+static int pthread_mutex_lock_pi(pthread_mutex_t* mutex, bool try_only)
+{
+    u32 tid = gettid();
+    u32 expected = MUTEX_UNLOCKED;
+    if (!AK::atomic_compare_exchange_strong(&mutex->lock, expected, tid, AK::memory_order_acquire)) {
+        if (mutex->type == __PTHREAD_MUTEX_RECURSIVE && (expected & FUTEX_TID_MASK) == tid) {
+            // We already own the mutex!
+            mutex->level++;
+            return 0;
+        }
+        if (try_only)
+            return EBUSY;
+        int rc = futex(&mutex->lock, FUTEX_LOCK_PI | FUTEX_PRIVATE_FLAG, 0, nullptr, nullptr, 0);
+        if (rc < 0)
+            return errno;
+    }
+
+    if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
+        AK::atomic_store(&mutex->owner, pthread_self(), AK::memory_order_relaxed);
+    mutex->level = 0;
+    return 0;
+}
+
+static int pthread_mutex_unlock_pi(pthread_mutex_t* mutex)
+{
+    u32 expected = gettid();
+    if (AK::atomic_compare_exchange_strong(&mutex->lock, expected, MUTEX_UNLOCKED, AK::memory_order_release)) [[likely]]
+        return 0;
+    // Someone is waiting on us, let the kernel hand the mutex over.
+    int rc = futex(&mutex->lock, FUTEX_UNLOCK_PI | FUTEX_PRIVATE_FLAG, 0, nullptr, nullptr, 0);
+    if (rc < 0)
+        return errno;
     return 0;
 }
 
 // https://pubs.opengroup.org/onlinepubs/009695399/functions/pthread_mutex_trylock.html
 int pthread_mutex_trylock(pthread_mutex_t* mutex)
 {
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT)
+        return pthread_mutex_lock_pi(mutex, true);
+
     u32 expected = MUTEX_UNLOCKED;
     bool exchanged = AK::atomic_compare_exchange_strong(&mutex->lock, expected, MUTEX_LOCKED_NO_NEED_TO_WAKE, AK::memory_order_acquire);
 
@@ -132,6 +173,9 @@ int pthread_mutex_trylock(pthread_mutex_t* mutex)
 // https://pubs.opengroup.org/onlinepubs/009695399/functions/pthread_mutex_lock.html
 int pthread_mutex_lock(pthread_mutex_t* mutex)
 {
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT)
+        return pthread_mutex_lock_pi(mutex, false);
+
     // Fast path: attempt to claim the mutex without waiting.
     u32 value = MUTEX_UNLOCKED;
     bool exchanged = AK::atomic_compare_exchange_strong(&mutex->lock, value, MUTEX_LOCKED_NO_NEED_TO_WAKE, AK::memory_order_acquire);
@@ -170,6 +214,9 @@ int __pthread_mutex_lock_pessimistic_np(pthread_mutex_t* mutex)
     // Same as pthread_mutex_lock(), but always set MUTEX_LOCKED_NEED_TO_WAKE,
     // and also don't bother checking for already owning the mutex recursively,
     // because we know we don't. Used in the condition variable implementation.
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT)
+        return pthread_mutex_lock_pi(mutex, false);
+
     u32 value = AK::atomic_exchange(&mutex->lock, MUTEX_LOCKED_NEED_TO_WAKE, AK::memory_order_acquire);
     while (value != MUTEX_UNLOCKED) {
         futex_wait(&mutex->lock, value, nullptr, 0, false);
@@ -193,6 +240,9 @@ int pthread_mutex_unlock(pthread_mutex_t* mutex)
     if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
         AK::atomic_store(&mutex->owner, 0, AK::memory_order_relaxed);
 
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT)
+        return pthread_mutex_unlock_pi(mutex);
+
     u32 value = AK::atomic_exchange(&mutex->lock, MUTEX_UNLOCKED, AK::memory_order_release);
     if (value == MUTEX_LOCKED_NEED_TO_WAKE) [[unlikely]] {
         int rc = futex_wake(&mutex->lock, 1, false);
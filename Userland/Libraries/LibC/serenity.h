@@ -61,6 +61,9 @@ int get_stack_bounds(uintptr_t* user_stack_base, size_t* user_stack_size);
 
 int anon_create(size_t size, int options);
 
+int io_ring_create(unsigned entries, int options);
+int io_ring_enter(int fd, unsigned to_submit);
+
 int serenity_readlink(char const* path, size_t path_length, char* buffer, size_t buffer_size);
 
 int getkeymap(char* name_buffer, size_t name_buffer_size, uint32_t* map, uint32_t* shift_map, uint32_t* alt_map, uint32_t* altgr_map, uint32_t* shift_altgr_map);
@@ -72,4 +75,27 @@ int emuctl(uintptr_t command, uintptr_t arg0, uintptr_t arg1);
 
 int serenity_open(char const* path, size_t path_length, int options, ...);
 
+#define SERENITY_MALLOC_SIZE_CLASS_COUNT 12
+
+struct serenity_malloc_size_class_stats {
+    size_t chunk_size;
+    // The blocks that are currently in use by this size class, and the chunks within them.
+    size_t block_count;
+    size_t chunk_count;
+    // Includes chunks that are cached by a thread, as those aren't available to the other threads.
+    // Whatever isn't used is lost to fragmentation, as the blocks can't be reused before all their chunks are free.
+    size_t used_chunk_count;
+};
+
+struct serenity_malloc_stats {
+    struct serenity_malloc_size_class_stats size_classes[SERENITY_MALLOC_SIZE_CLASS_COUNT];
+    size_t block_size;
+    // Empty blocks that are kept around for any size class. Cold ones may have been purged by the kernel.
+    size_t hot_empty_block_count;
+    size_t cold_empty_block_count;
+    size_t cached_big_allocation_block_count;
+};
+
+int serenity_get_malloc_stats(struct serenity_malloc_stats*);
+
 __END_DECLS
@@ -276,13 +276,10 @@ char* strchrnul(char const* str, int c)
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/memchr.html
 void* memchr(void const* ptr, int c, size_t size)
 {
-    char ch = c;
-    auto* cptr = (char const*)ptr;
-    for (size_t i = 0; i < size; ++i) {
-        if (cptr[i] == ch)
-            return const_cast<char*>(cptr + i);
-    }
-    return nullptr;
+    auto offset = AK::memchr_optional(ptr, size, static_cast<u8>(c));
+    if (!offset.has_value())
+        return nullptr;
+    return const_cast<u8*>(static_cast<u8 const*>(ptr) + offset.value());
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/strrchr.html
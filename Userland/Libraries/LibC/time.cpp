@@ -471,8 +471,62 @@ static Kernel::TimePage* get_kernel_time_page()
     return s_kernel_time_page;
 }
 
+#if ARCH(X86_64)
+static bool read_precise_time_from_kernel_time_page(clockid_t clock_id, struct timespec* ts)
+{
+    clockid_t coarse_clock_id;
+    switch (clock_id) {
+    case CLOCK_REALTIME:
+        coarse_clock_id = CLOCK_REALTIME_COARSE;
+        break;
+    case CLOCK_MONOTONIC:
+        coarse_clock_id = CLOCK_MONOTONIC_COARSE;
+        break;
+    default:
+        return false;
+    }
+
+    auto* kernel_time_page = get_kernel_time_page();
+    if (!kernel_time_page)
+        return false;
+
+    u32 update_iteration;
+    u64 tsc_frequency;
+    u64 elapsed_tsc;
+    u64 nanoseconds_per_tick;
+    do {
+        update_iteration = AK::atomic_load(&kernel_time_page->update1, AK::memory_order_acquire);
+        tsc_frequency = kernel_time_page->tsc_frequency;
+        *ts = kernel_time_page->clocks[coarse_clock_id];
+        auto tsc_at_update = kernel_time_page->tsc_at_update;
+        nanoseconds_per_tick = kernel_time_page->nanoseconds_per_tick;
+        auto tsc = __builtin_ia32_rdtsc();
+        elapsed_tsc = tsc > tsc_at_update ? tsc - tsc_at_update : 0;
+    } while (update_iteration != AK::atomic_load(&kernel_time_page->update2, AK::memory_order_acquire));
+
+    if (tsc_frequency == 0)
+        return false;
+
+    // Never advance past the next tick, otherwise the clock could appear to go backwards once the kernel updates it.
+    elapsed_tsc = min(elapsed_tsc, tsc_frequency);
+    u64 elapsed_nanoseconds = min(elapsed_tsc * 1'000'000'000ull / tsc_frequency, nanoseconds_per_tick);
+
+    ts->tv_nsec += elapsed_nanoseconds;
+    while (ts->tv_nsec >= 1'000'000'000) {
+        ts->tv_nsec -= 1'000'000'000;
+        ++ts->tv_sec;
+    }
+    return true;
+}
+#endif
+
 int clock_gettime(clockid_t clock_id, struct timespec* ts)
 {
+#if ARCH(X86_64)
+    if (ts && read_precise_time_from_kernel_time_page(clock_id, ts))
+        return 0;
+#endif
+
     if (Kernel::time_page_supports(clock_id)) {
         if (!ts) {
             errno = EFAULT;
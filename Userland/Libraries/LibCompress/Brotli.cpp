@@ -4,7 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
-#include <AK/BinarySearch.h>
+#include <AK/BuiltinWrappers.h>
 #include <AK/QuickSort.h>
 #include <LibCompress/Brotli.h>
 #include <LibCompress/BrotliDictionary.h>
@@ -13,19 +13,84 @@ namespace Compress {
 
 ErrorOr<size_t> Brotli::CanonicalCode::read_symbol(LittleEndianInputBitStream& input_stream) const
 {
-    size_t code_bits = 1;
+    if (m_prefix_table.is_empty())
+        return Error::from_string_literal("no matching code found");
 
-    while (code_bits < (1 << 16)) {
-        // FIXME: This is very inefficient and could greatly be improved by implementing this
-        //        algorithm: https://www.hanshq.net/zip.html#huffdec
-        size_t index;
-        if (binary_search(m_symbol_codes.span(), code_bits, &index))
-            return m_symbol_values[index];
+    // Near the end of the stream there may be fewer bits left than the longest code, which is only a problem if the
+    // code actually needs them.
+    auto buffered_bits = TRY(input_stream.fill_bit_buffer(max_code_length));
+    auto bits = TRY(input_stream.peek_bits<u16>(min(buffered_bits, max_code_length)));
 
-        code_bits = (code_bits << 1) | TRY(input_stream.read_bit());
+    auto entry = m_prefix_table[bits & ((1u << m_root_bits) - 1)];
+    if (entry.subtable_bits != 0)
+        entry = m_prefix_table[entry.value + ((bits >> m_root_bits) & ((1u << entry.subtable_bits) - 1))];
+
+    if (entry.code_length == invalid_code_length)
+        return Error::from_string_literal("no matching code found");
+    if (entry.code_length > buffered_bits)
+        return Error::from_string_literal("eof");
+
+    input_stream.discard_previously_peeked_bits(entry.code_length);
+    return entry.value;
+}
+
+ErrorOr<void> Brotli::CanonicalCode::build_prefix_table()
+{
+    // The bits of a code are read starting with the most significant one, but the bit stream hands them out starting
+    // with the least significant one, so the tables are indexed by the reversed code.
+    auto code_length = [](size_t code) { return count_required_bits(code) - 1; };
+    auto reversed_code = [](size_t code, size_t length) {
+        size_t reversed = 0;
+        for (size_t i = 0; i < length; ++i)
+            reversed |= ((code >> i) & 1) << (length - 1 - i);
+        return reversed;
+    };
+
+    size_t longest_code_length = 0;
+    for (auto code : m_symbol_codes)
+        longest_code_length = max(longest_code_length, code_length(code));
+    VERIFY(longest_code_length <= max_code_length);
+
+    m_root_bits = min(longest_code_length, root_table_bits);
+    size_t root_mask = (1u << m_root_bits) - 1;
+    TRY(m_prefix_table.try_resize(1u << m_root_bits));
+
+    // Size each second-level table for the longest code that starts with its prefix.
+    for (auto code : m_symbol_codes) {
+        auto length = code_length(code);
+        if (length <= m_root_bits)
+            continue;
+        auto& entry = m_prefix_table[reversed_code(code, length) & root_mask];
+        entry.subtable_bits = max<u8>(entry.subtable_bits, length - m_root_bits);
     }
+    for (auto& entry : m_prefix_table) {
+        if (entry.subtable_bits == 0)
+            continue;
+        entry.value = m_prefix_table.size();
+        TRY(m_prefix_table.try_resize(m_prefix_table.size() + (1u << entry.subtable_bits)));
+    }
+
+    for (size_t i = 0; i < m_symbol_codes.size(); ++i) {
+        auto length = code_length(m_symbol_codes[i]);
+        auto reversed = reversed_code(m_symbol_codes[i], length);
+        PrefixTableEntry symbol_entry { static_cast<u16>(m_symbol_values[i]), static_cast<u8>(length), 0 };
+
+        if (length <= m_root_bits) {
+            for (size_t index = reversed; index <= root_mask; index += 1u << length) {
+                if (m_prefix_table[index].subtable_bits != 0)
+                    return Error::from_string_literal("invalid prefix code");
+                m_prefix_table[index] = symbol_entry;
+            }
+            continue;
+        }
 
-    return Error::from_string_literal("no matching code found");
+        auto const& root_entry = m_prefix_table[reversed & root_mask];
+        auto remaining_length = length - m_root_bits;
+        for (size_t index = reversed >> m_root_bits; index < (1u << root_entry.subtable_bits); index += 1u << remaining_length)
+            m_prefix_table[root_entry.value + index] = symbol_entry;
+    }
+
+    return {};
 }
 
 BrotliDecompressionStream::BrotliDecompressionStream(MaybeOwned<Stream> stream)
@@ -227,6 +292,7 @@ ErrorOr<Brotli::CanonicalCode> Brotli::CanonicalCode::read_simple_prefix_code(Li
         }
     }
 
+    TRY(code.build_prefix_table());
     return code;
 }
 
@@ -286,6 +352,8 @@ ErrorOr<Brotli::CanonicalCode> Brotli::CanonicalCode::read_complex_prefix_code(L
         }
     }
 
+    TRY(temp_code.build_prefix_table());
+
     // Read the actual prefix code_value
     sum = 0;
     size_t i = 0;
@@ -381,6 +449,7 @@ ErrorOr<Brotli::CanonicalCode> Brotli::CanonicalCode::read_complex_prefix_code(L
         }
     }
 
+    TRY(final_code.build_prefix_table());
     return final_code;
 }
 
@@ -577,7 +646,7 @@ ErrorOr<Bytes> BrotliDecompressionStream::read_some(Bytes output_buffer)
             size_t window_bits = TRY(read_window_length());
             m_window_size = (1 << window_bits) - 16;
 
-            m_lookback_buffer = TRY(LookbackBuffer::try_create(m_window_size));
+            m_lookback_buffer = TRY(LookbackBuffer::try_create(1 << window_bits));
 
             m_current_state = State::Idle;
         } else if (m_current_state == State::Idle) {
@@ -736,8 +805,7 @@ ErrorOr<Bytes> BrotliDecompressionStream::read_some(Bytes output_buffer)
                 return Error::from_string_literal("eof");
 
             // TODO: Replace the home-grown LookbackBuffer with AK::CircularBuffer.
-            for (auto c : uncompressed_bytes)
-                m_lookback_buffer.value().write(c);
+            m_lookback_buffer.value().write(uncompressed_bytes);
 
             m_bytes_left -= uncompressed_bytes.size();
             bytes_read += uncompressed_bytes.size();
@@ -780,19 +848,22 @@ ErrorOr<Bytes> BrotliDecompressionStream::read_some(Bytes output_buffer)
                 m_current_state = State::CompressedDistance;
             }
         } else if (m_current_state == State::CompressedLiteral) {
-            if (m_literal_block.length == 0) {
-                TRY(block_read_new_state(m_literal_block));
-            }
-            m_literal_block.length--;
+            // Stay in this state for as long as possible, rather than going through the state machine for every literal.
+            while (bytes_read < output_buffer.size() && m_insert_length > 0 && m_bytes_left > 0) {
+                if (m_literal_block.length == 0) {
+                    TRY(block_read_new_state(m_literal_block));
+                }
+                m_literal_block.length--;
 
-            size_t literal_code_index = literal_code_index_from_context();
-            size_t literal_value = TRY(m_literal_codes[literal_code_index].read_symbol(m_input_stream));
+                size_t literal_code_index = literal_code_index_from_context();
+                size_t literal_value = TRY(m_literal_codes[literal_code_index].read_symbol(m_input_stream));
 
-            output_buffer[bytes_read] = literal_value;
-            m_lookback_buffer.value().write(literal_value);
-            bytes_read++;
-            m_insert_length--;
-            m_bytes_left--;
+                output_buffer[bytes_read] = literal_value;
+                m_lookback_buffer.value().write(literal_value);
+                bytes_read++;
+                m_insert_length--;
+                m_bytes_left--;
+            }
 
             if (m_bytes_left == 0)
                 m_current_state = State::Idle;
@@ -881,6 +952,8 @@ ErrorOr<Bytes> BrotliDecompressionStream::read_some(Bytes output_buffer)
                 size_t offset = ((2 + (hcode & 1)) << ndistbits) - 4;
                 distance = ((offset + dextra) << m_postfix_bits) + lcode + m_direct_distances + 1;
             }
+            if (distance == 0)
+                return Error::from_string_literal("invalid distance");
             m_distance = distance;
 
             size_t total_written = m_lookback_buffer.value().total_written();
@@ -906,13 +979,12 @@ ErrorOr<Bytes> BrotliDecompressionStream::read_some(Bytes output_buffer)
                 m_current_state = State::CompressedCopy;
             }
         } else if (m_current_state == State::CompressedCopy) {
-            u8 copy_value = m_lookback_buffer.value().lookback(m_distance);
+            size_t copy_length = min(min(m_copy_length, m_bytes_left), output_buffer.size() - bytes_read);
+            m_lookback_buffer.value().copy_from_lookback(m_distance, output_buffer.slice(bytes_read, copy_length));
 
-            output_buffer[bytes_read] = copy_value;
-            m_lookback_buffer.value().write(copy_value);
-            bytes_read++;
-            m_copy_length--;
-            m_bytes_left--;
+            bytes_read += copy_length;
+            m_copy_length -= copy_length;
+            m_bytes_left -= copy_length;
 
             if (m_bytes_left == 0)
                 m_current_state = State::Idle;
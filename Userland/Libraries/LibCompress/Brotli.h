@@ -18,9 +18,6 @@ namespace Brotli {
 class CanonicalCode {
 public:
     CanonicalCode() = default;
-    CanonicalCode(Vector<size_t> codes, Vector<size_t> values)
-        : m_symbol_codes(move(codes))
-        , m_symbol_values(move(values)) {};
 
     static ErrorOr<CanonicalCode> read_prefix_code(LittleEndianInputBitStream&, size_t alphabet_size);
     static ErrorOr<CanonicalCode> read_simple_prefix_code(LittleEndianInputBitStream&, size_t alphabet_size);
@@ -31,8 +28,27 @@ public:
 private:
     static ErrorOr<size_t> read_complex_prefix_code_length(LittleEndianInputBitStream&);
 
+    ErrorOr<void> build_prefix_table();
+
+    static constexpr size_t max_code_length = 15;
+
+    // Symbols are looked up by the first root_table_bits bits of their code. Entries for longer codes instead point to
+    // a second-level table, which is indexed by the remaining bits.
+    static constexpr size_t root_table_bits = 8;
+    static constexpr u8 invalid_code_length = 0xff;
+
+    struct PrefixTableEntry {
+        u16 value { 0 }; // The symbol, or the offset of the second-level table.
+        u8 code_length { invalid_code_length };
+        u8 subtable_bits { 0 };
+    };
+
+    // Each code is stored with a leading 1 bit, which marks its length.
     Vector<size_t> m_symbol_codes;
     Vector<size_t> m_symbol_values;
+
+    Vector<PrefixTableEntry> m_prefix_table;
+    size_t m_root_bits { 0 };
 };
 
 }
@@ -71,8 +87,10 @@ public:
         }
 
     public:
+        // The size has to be a power of two, so that offsets can wrap around with a mask.
         static ErrorOr<LookbackBuffer> try_create(size_t size)
         {
+            VERIFY(is_power_of_two(size));
             auto buffer = TRY(FixedArray<u8>::create(size));
             return LookbackBuffer { buffer };
         }
@@ -80,15 +98,21 @@ public:
         void write(u8 value)
         {
             m_buffer[m_offset] = value;
-            m_offset = (m_offset + 1) % m_buffer.size();
+            m_offset = (m_offset + 1) & (m_buffer.size() - 1);
             m_total_written++;
         }
 
+        void write(ReadonlyBytes bytes)
+        {
+            for (auto value : bytes)
+                write(value);
+        }
+
         u8 lookback(size_t offset) const
         {
             VERIFY(offset <= m_total_written);
             VERIFY(offset <= m_buffer.size());
-            size_t index = (m_offset + m_buffer.size() - offset) % m_buffer.size();
+            size_t index = (m_offset - offset) & (m_buffer.size() - 1);
             return m_buffer[index];
         }
 
@@ -96,10 +120,22 @@ public:
         {
             if (offset > m_total_written || offset > m_buffer.size())
                 return fallback;
+            size_t index = (m_offset - offset) & (m_buffer.size() - 1);
+            return m_buffer[index];
+        }
+
+        // Fills the output with the bytes starting at the given distance back, including the ones written on the way.
+        void copy_from_lookback(size_t offset, Bytes output)
+        {
             VERIFY(offset <= m_total_written);
             VERIFY(offset <= m_buffer.size());
-            size_t index = (m_offset + m_buffer.size() - offset) % m_buffer.size();
-            return m_buffer[index];
+            size_t mask = m_buffer.size() - 1;
+            for (auto& value : output) {
+                value = m_buffer[(m_offset - offset) & mask];
+                m_buffer[m_offset] = value;
+                m_offset = (m_offset + 1) & mask;
+            }
+            m_total_written += output.size();
         }
 
         size_t total_written() { return m_total_written; }
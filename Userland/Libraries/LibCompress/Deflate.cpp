@@ -7,12 +7,12 @@
 
 #include <AK/Array.h>
 #include <AK/Assertions.h>
-#include <AK/BinarySearch.h>
 #include <AK/MemoryStream.h>
 #include <string.h>
 
 #include <LibCompress/Deflate.h>
 #include <LibCompress/Huffman.h>
+#include <LibThreading/Parallel.h>
 
 namespace Compress {
 
@@ -22,31 +22,16 @@ static constexpr u8 deflate_special_code_length_long_zeros = 18;
 
 static constexpr int EndOfBlock = 256;
 
+// NOTE: These are initialized on first use in a thread-safe manner, as blocks may be compressed on several threads at once.
 CanonicalCode const& CanonicalCode::fixed_literal_codes()
 {
-    static CanonicalCode code;
-    static bool initialized = false;
-
-    if (initialized)
-        return code;
-
-    code = MUST(CanonicalCode::from_bytes(fixed_literal_bit_lengths));
-    initialized = true;
-
+    static CanonicalCode const code = MUST(CanonicalCode::from_bytes(fixed_literal_bit_lengths));
     return code;
 }
 
 CanonicalCode const& CanonicalCode::fixed_distance_codes()
 {
-    static CanonicalCode code;
-    static bool initialized = false;
-
-    if (initialized)
-        return code;
-
-    code = MUST(CanonicalCode::from_bytes(fixed_distance_bit_lengths));
-    initialized = true;
-
+    static CanonicalCode const code = MUST(CanonicalCode::from_bytes(fixed_distance_bit_lengths));
     return code;
 }
 
@@ -64,7 +49,8 @@ ErrorOr<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
     }
 
     if (non_zero_symbols == 1) { // special case - only 1 symbol
-        code.m_prefix_table[0] = PrefixTableEntry { static_cast<u16>(last_non_zero), 1u };
+        TRY(code.m_prefix_table.try_resize(2));
+        code.m_prefix_table[0] = PrefixTableEntry { .symbol_value = static_cast<u16>(last_non_zero), .code_length = 1 };
         code.m_prefix_table[1] = code.m_prefix_table[0];
         code.m_max_prefixed_code_length = 1;
 
@@ -87,7 +73,7 @@ ErrorOr<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
     size_t number_of_prefix_codes = 0;
 
     auto next_code = 0;
-    for (size_t code_length = 1; code_length <= 15; ++code_length) {
+    for (size_t code_length = 1; code_length <= max_code_length; ++code_length) {
         next_code <<= 1;
         auto start_bit = 1 << code_length;
 
@@ -109,7 +95,10 @@ ErrorOr<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
 
                 code.m_max_prefixed_code_length = code_length;
             } else {
-                code.m_symbol_codes.append(start_bit | next_code);
+                if (code.m_long_code_count[code_length]++ == 0) {
+                    code.m_first_long_code[code_length] = next_code;
+                    code.m_first_long_code_index[code_length] = code.m_symbol_values.size();
+                }
                 code.m_symbol_values.append(symbol);
             }
 
@@ -124,9 +113,11 @@ ErrorOr<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
         }
     }
 
-    if (next_code != (1 << 15))
+    if (next_code != (1 << max_code_length))
         return Error::from_string_literal("Failed to decode code lengths");
 
+    TRY(code.m_prefix_table.try_resize(1 << code.m_max_prefixed_code_length));
+
     for (auto [symbol_code, symbol_value, code_length] : prefix_codes) {
         if (code_length == 0 || code_length > CanonicalCode::max_allowed_prefixed_code_length)
             break;
@@ -136,41 +127,91 @@ ErrorOr<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
 
         for (size_t j = 0; j < (1u << shift); ++j) {
             auto index = fast_reverse16(symbol_code + j, code.m_max_prefixed_code_length);
-            code.m_prefix_table[index] = PrefixTableEntry { symbol_value, code_length };
+            code.m_prefix_table[index] = PrefixTableEntry { .symbol_value = symbol_value, .code_length = static_cast<u8>(code_length) };
         }
     }
 
+    // Where the bits that remain of an index after a literal's code are enough to decode another literal, remember that
+    // one as well, so that runs of literals only take one lookup per two literals.
+    for (size_t index = 0; index < code.m_prefix_table.size(); ++index) {
+        auto& entry = code.m_prefix_table[index];
+        if (entry.code_length == 0 || entry.symbol_value >= 256)
+            continue;
+
+        auto const& next_entry = code.m_prefix_table[index >> entry.code_length];
+        if (next_entry.code_length == 0 || next_entry.symbol_value >= 256)
+            continue;
+        if (entry.code_length + next_entry.code_length > code.m_max_prefixed_code_length)
+            continue;
+
+        entry.next_literal = static_cast<u8>(next_entry.symbol_value);
+        entry.literal_pair_code_length = entry.code_length + next_entry.code_length;
+    }
+
     return code;
 }
 
-ErrorOr<u32> CanonicalCode::read_symbol(LittleEndianInputBitStream& stream) const
+ALWAYS_INLINE ErrorOr<u32> CanonicalCode::read_symbol_impl(LittleEndianInputBitStream& stream, Optional<u8>* next_literal) const
 {
-    auto prefix = TRY(stream.peek_bits<size_t>(m_max_prefixed_code_length));
+    if (m_prefix_table.is_empty())
+        return Error::from_string_literal("Reading a symbol of an empty canonical code");
+
+    // Buffer enough bits for the longest code up front, so that a single peek covers any symbol. Near the end of the
+    // stream there may be fewer bits than that left, which is only a problem if the code actually needs them.
+    auto buffered_bits = TRY(stream.fill_bit_buffer(max_code_length));
+    auto bits = TRY(stream.peek_bits<u16>(min(buffered_bits, max_code_length)));
+
+    auto const& entry = m_prefix_table[bits & ((1u << m_max_prefixed_code_length) - 1)];
 
-    if (auto [symbol_value, code_length] = m_prefix_table[prefix]; code_length != 0) {
-        stream.discard_previously_peeked_bits(code_length);
-        return symbol_value;
+    if (next_literal && entry.literal_pair_code_length != 0 && entry.literal_pair_code_length <= buffered_bits) {
+        stream.discard_previously_peeked_bits(entry.literal_pair_code_length);
+        *next_literal = entry.next_literal;
+        return entry.symbol_value;
     }
 
-    auto code_bits = TRY(stream.read_bits<u16>(m_max_prefixed_code_length));
-    code_bits = fast_reverse16(code_bits, m_max_prefixed_code_length);
-    code_bits |= 1 << m_max_prefixed_code_length;
+    if (entry.code_length != 0) {
+        if (entry.code_length > buffered_bits)
+            return Error::from_string_literal("Reached end-of-stream in the middle of a symbol");
+        stream.discard_previously_peeked_bits(entry.code_length);
+        return entry.symbol_value;
+    }
 
-    for (size_t i = m_max_prefixed_code_length; i < 16; ++i) {
-        size_t index;
-        if (binary_search(m_symbol_codes.span(), code_bits, &index))
-            return m_symbol_values[index];
+    return read_long_symbol(stream, bits, buffered_bits);
+}
 
-        code_bits = code_bits << 1 | TRY(stream.read_bit());
+ErrorOr<u32> CanonicalCode::read_symbol(LittleEndianInputBitStream& stream) const
+{
+    return read_symbol_impl(stream, nullptr);
+}
+
+ErrorOr<u32> CanonicalCode::read_symbol(LittleEndianInputBitStream& stream, Optional<u8>& next_literal) const
+{
+    return read_symbol_impl(stream, &next_literal);
+}
+
+ErrorOr<u32> CanonicalCode::read_long_symbol(LittleEndianInputBitStream& stream, u16 bits, size_t buffered_bits) const
+{
+    // The code is longer than the prefix table covers, so look for it among the longer codes, one length at a time.
+    auto reversed_bits = fast_reverse16(bits, max_code_length);
+
+    for (size_t code_length = m_max_prefixed_code_length + 1; code_length <= min(buffered_bits, max_code_length); ++code_length) {
+        u16 code_bits = reversed_bits >> (max_code_length - code_length);
+
+        if (u16 offset = code_bits - m_first_long_code[code_length]; offset < m_long_code_count[code_length]) {
+            stream.discard_previously_peeked_bits(code_length);
+            return m_symbol_values[m_first_long_code_index[code_length] + offset];
+        }
     }
 
+    if (buffered_bits < max_code_length)
+        return Error::from_string_literal("Reached end-of-stream in the middle of a symbol");
     return Error::from_string_literal("Symbol exceeds maximum symbol number");
 }
 
 DeflateDecompressor::CompressedBlock::CompressedBlock(DeflateDecompressor& decompressor, CanonicalCode literal_codes, Optional<CanonicalCode> distance_codes)
     : m_decompressor(decompressor)
-    , m_literal_codes(literal_codes)
-    , m_distance_codes(distance_codes)
+    , m_literal_codes(move(literal_codes))
+    , m_distance_codes(move(distance_codes))
 {
 }
 
@@ -179,37 +220,61 @@ ErrorOr<bool> DeflateDecompressor::CompressedBlock::try_read_more()
     if (m_eof == true)
         return false;
 
-    auto const symbol = TRY(m_literal_codes.read_symbol(*m_decompressor.m_input_stream));
-
-    if (symbol >= 286)
-        return Error::from_string_literal("Invalid deflate literal/length symbol");
+    auto& input_stream = *m_decompressor.m_input_stream;
+    auto& output_buffer = m_decompressor.m_output_buffer;
+
+    // Literals are collected here and written to the output buffer in batches, instead of one at a time.
+    Array<u8, 64> literals;
+    size_t literal_count = 0;
+    auto flush_literals = [&] {
+        if (literal_count == 0)
+            return;
+        auto written_bytes = output_buffer.write(literals.span().trim(literal_count));
+        VERIFY(written_bytes == literal_count);
+        literal_count = 0;
+    };
 
-    if (symbol < EndOfBlock) {
-        u8 byte_symbol = symbol;
-        m_decompressor.m_output_buffer.write({ &byte_symbol, sizeof(byte_symbol) });
-        return true;
-    }
+    // Decode as many symbols as the output buffer is guaranteed to have space for, rather than going back to the caller
+    // after every single one.
+    while (output_buffer.empty_space() >= literal_count + max_back_reference_length) {
+        Optional<u8> next_literal;
+        auto const symbol = TRY(m_literal_codes.read_symbol(input_stream, next_literal));
+
+        if (symbol >= 286)
+            return Error::from_string_literal("Invalid deflate literal/length symbol");
+
+        if (symbol < EndOfBlock) {
+            literals[literal_count++] = symbol;
+            if (next_literal.has_value())
+                literals[literal_count++] = next_literal.value();
+            if (literal_count >= literals.size() - 1)
+                flush_literals();
+            continue;
+        }
 
-    if (symbol == EndOfBlock) {
-        m_eof = true;
-        return false;
-    }
+        flush_literals();
 
-    if (!m_distance_codes.has_value())
-        return Error::from_string_literal("Distance codes have not been initialized");
+        if (symbol == EndOfBlock) {
+            // Some data might have been decoded before the end of the block, so only report the end on the next call.
+            m_eof = true;
+            return true;
+        }
 
-    auto const length = TRY(m_decompressor.decode_length(symbol));
-    auto const distance_symbol = TRY(m_distance_codes.value().read_symbol(*m_decompressor.m_input_stream));
-    if (distance_symbol >= 30)
-        return Error::from_string_literal("Invalid deflate distance symbol");
+        if (!m_distance_codes.has_value())
+            return Error::from_string_literal("Distance codes have not been initialized");
 
-    auto const distance = TRY(m_decompressor.decode_distance(distance_symbol));
+        auto const length = TRY(m_decompressor.decode_length(symbol));
+        auto const distance_symbol = TRY(m_distance_codes.value().read_symbol(input_stream));
+        if (distance_symbol >= 30)
+            return Error::from_string_literal("Invalid deflate distance symbol");
 
-    auto copied_length = TRY(m_decompressor.m_output_buffer.copy_from_seekback(distance, length));
+        auto const distance = TRY(m_decompressor.decode_distance(distance_symbol));
 
-    // TODO: What should we do if the output buffer is full?
-    VERIFY(copied_length == length);
+        auto copied_length = TRY(output_buffer.copy_from_seekback(distance, length));
+        VERIFY(copied_length == length);
+    }
 
+    flush_literals();
     return true;
 }
 
@@ -298,7 +363,7 @@ ErrorOr<Bytes> DeflateDecompressor::read_some(Bytes bytes)
                 TRY(decode_codes(literal_codes, distance_codes));
 
                 m_state = State::ReadingCompressedBlock;
-                new (&m_compressed_block) CompressedBlock(*this, literal_codes, distance_codes);
+                new (&m_compressed_block) CompressedBlock(*this, move(literal_codes), move(distance_codes));
 
                 continue;
             }
@@ -309,7 +374,15 @@ ErrorOr<Bytes> DeflateDecompressor::read_some(Bytes bytes)
         if (m_state == State::ReadingCompressedBlock) {
             auto nread = m_output_buffer.read(slice).size();
 
-            while (nread < slice.size() && TRY(m_compressed_block.try_read_more())) {
+            while (nread < slice.size() && !m_pending_error.has_value()) {
+                auto read_more_or_error = m_compressed_block.try_read_more();
+                if (read_more_or_error.is_error()) {
+                    // Symbols are decoded in batches, so there may be data before the error. Handing it out first
+                    // gets the most out of truncated input.
+                    m_pending_error = read_more_or_error.release_error();
+                } else if (!read_more_or_error.value()) {
+                    break;
+                }
                 nread += m_output_buffer.read(slice.slice(nread)).size();
             }
 
@@ -317,6 +390,12 @@ ErrorOr<Bytes> DeflateDecompressor::read_some(Bytes bytes)
             if (nread == slice.size())
                 break;
 
+            if (m_pending_error.has_value()) {
+                if (total_read > 0)
+                    break;
+                return m_pending_error.release_value();
+            }
+
             m_compressed_block.~CompressedBlock();
             m_state = State::Idle;
 
@@ -624,13 +703,46 @@ void DeflateCompressor::lz77_compress_block()
         m_distance_frequencies[distance_to_base(distance)]++;
     };
 
+    // our block starts at block_size and is m_pending_block_size in length
+    auto block_end = block_size + m_pending_block_size;
+
+    if (m_compression_level == CompressionLevel::FASTEST) {
+        // Greedily take whatever match the most recent position with the same hash offers, and only bother hashing the
+        // positions inside short matches, as skipping over long ones is where most of the time is saved.
+        auto current_position = block_size;
+        while (current_position < block_end - min_match_length + 1) {
+            auto hash = hash_sequence(&m_rolling_window[current_position]);
+            auto candidate = m_hash_head[hash];
+            insert_hash(current_position, hash);
+
+            size_t match_length = 0;
+            if (candidate != empty_slot)
+                match_length = compare_match_candidate(current_position, candidate, min_match_length - 1, min(max_match_length, block_end - current_position));
+
+            if (match_length == 0) {
+                emit_literal(m_rolling_window[current_position++]);
+                continue;
+            }
+
+            emit_back_reference(current_position - candidate, match_length);
+
+            if (match_length <= max_inserted_match_length) {
+                for (size_t j = current_position + 1; j < min(current_position + match_length, block_end - min_match_length + 1); j++)
+                    insert_hash(j, hash_sequence(&m_rolling_window[j]));
+            }
+            current_position += match_length;
+        }
+
+        while (current_position < block_end)
+            emit_literal(m_rolling_window[current_position++]);
+        return;
+    }
+
     size_t previous_match_length = 0;
     size_t previous_match_position = 0;
 
     VERIFY(m_compression_constants.great_match_length <= max_match_length);
 
-    // our block starts at block_size and is m_pending_block_size in length
-    auto block_end = block_size + m_pending_block_size;
     size_t current_position;
     for (current_position = block_size; current_position < block_end - min_match_length + 1; current_position++) {
         auto hash = hash_sequence(&m_rolling_window[current_position]);
@@ -959,8 +1071,83 @@ ErrorOr<void> DeflateCompressor::final_flush()
     return {};
 }
 
+ErrorOr<void> DeflateCompressor::sync_flush()
+{
+    VERIFY(!m_finished);
+    if (m_pending_block_size != 0)
+        TRY(flush());
+
+    // An empty, non-final uncompressed block, which gets us to a byte boundary.
+    TRY(m_output_stream->write_bits(0b000u, 3));
+    TRY(m_output_stream->align_to_byte_boundary());
+    TRY(m_output_stream->write_value<LittleEndian<u16>>(0));
+    TRY(m_output_stream->write_value<LittleEndian<u16>>(0xffff));
+    TRY(m_output_stream->flush_buffer_to_stream());
+    return {};
+}
+
+// The workers that large inputs are compressed on, started the first time they're needed.
+static Threading::TaskPool& task_pool()
+{
+    static Threading::TaskPool pool;
+    return pool;
+}
+
+ErrorOr<ByteBuffer> DeflateCompressor::compress_all_in_parallel(ReadonlyBytes bytes, CompressionLevel compression_level)
+{
+    // Like pigz, compress the chunks independently and string them together. Every chunk but the last one ends with a
+    // sync flush, which puts the next chunk on a byte boundary. We don't lose anything by not letting back references
+    // reach into the previous chunk, as they never reach beyond the current block anyway.
+    auto chunk_count = ceil_div(bytes.size(), parallel_chunk_size);
+
+    Vector<Optional<ErrorOr<ByteBuffer>>> compressed_chunks;
+    TRY(compressed_chunks.try_resize(chunk_count));
+
+    auto compress_chunk = [&](size_t index) -> ErrorOr<ByteBuffer> {
+        auto chunk = bytes.slice(index * parallel_chunk_size, min(parallel_chunk_size, bytes.size() - index * parallel_chunk_size));
+
+        AllocatingMemoryStream output_stream;
+        auto deflate_stream = TRY(DeflateCompressor::construct(MaybeOwned<Stream>(output_stream), compression_level));
+        TRY(deflate_stream->write_until_depleted(chunk));
+
+        if (index == chunk_count - 1) {
+            TRY(deflate_stream->final_flush());
+        } else {
+            TRY(deflate_stream->sync_flush());
+            // The stream is continued by the next chunk's compressor, this one is done.
+            deflate_stream->m_finished = true;
+        }
+
+        auto buffer = TRY(ByteBuffer::create_uninitialized(output_stream.used_buffer_size()));
+        TRY(output_stream.read_until_filled(buffer));
+        return buffer;
+    };
+
+    Threading::parallel_for(
+        task_pool(), chunk_count, [&](size_t index) {
+            compressed_chunks[index] = compress_chunk(index);
+        },
+        1);
+
+    size_t compressed_size = 0;
+    for (auto& compressed_chunk : compressed_chunks) {
+        if (compressed_chunk->is_error())
+            return compressed_chunk->release_error();
+        compressed_size += compressed_chunk->value().size();
+    }
+
+    ByteBuffer buffer;
+    TRY(buffer.try_ensure_capacity(compressed_size));
+    for (auto& compressed_chunk : compressed_chunks)
+        buffer.append(compressed_chunk->value());
+    return buffer;
+}
+
 ErrorOr<ByteBuffer> DeflateCompressor::compress_all(ReadonlyBytes bytes, CompressionLevel compression_level)
 {
+    if (bytes.size() >= parallel_compression_threshold && compression_level != CompressionLevel::STORE)
+        return compress_all_in_parallel(bytes, compression_level);
+
     auto output_stream = TRY(try_make<AllocatingMemoryStream>());
     auto deflate_stream = TRY(DeflateCompressor::construct(MaybeOwned<Stream>(*output_stream), compression_level));
 
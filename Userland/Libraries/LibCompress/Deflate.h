@@ -25,24 +25,41 @@ public:
     ErrorOr<u32> read_symbol(LittleEndianInputBitStream&) const;
     ErrorOr<void> write_symbol(LittleEndianOutputBitStream&, u32) const;
 
+    // Like read_symbol(), but if the symbol is a literal (i.e. below 256) that is followed by another literal, and both
+    // of their codes fit into the prefix table together, the second literal is decoded as well and put in next_literal.
+    ErrorOr<u32> read_symbol(LittleEndianInputBitStream&, Optional<u8>& next_literal) const;
+
     static CanonicalCode const& fixed_literal_codes();
     static CanonicalCode const& fixed_distance_codes();
 
     static ErrorOr<CanonicalCode> from_bytes(ReadonlyBytes);
 
 private:
-    static constexpr size_t max_allowed_prefixed_code_length = 8;
+    static constexpr size_t max_code_length = 15;
+    static constexpr size_t max_allowed_prefixed_code_length = 10;
 
     struct PrefixTableEntry {
         u16 symbol_value { 0 };
-        u16 code_length { 0 };
+        u8 code_length { 0 };
+
+        // If both the symbol and the one decoded from the bits after its code are literals, the second literal and the
+        // combined length of both codes.
+        u8 next_literal { 0 };
+        u8 literal_pair_code_length { 0 };
     };
 
-    // Decompression - indexed by code
-    Vector<u16, 286> m_symbol_codes;
+    ErrorOr<u32> read_symbol_impl(LittleEndianInputBitStream&, Optional<u8>* next_literal) const;
+    ErrorOr<u32> read_long_symbol(LittleEndianInputBitStream&, u16 bits, size_t buffered_bits) const;
+
+    // Decompression of codes that are too long for the prefix table. The canonical codes of each length are consecutive
+    // numbers, so all we need to know per length is the first code, how many there are, and where their symbols start.
+    Array<u16, max_code_length + 1> m_first_long_code {};
+    Array<u16, max_code_length + 1> m_long_code_count {};
+    Array<u16, max_code_length + 1> m_first_long_code_index {};
     Vector<u16, 286> m_symbol_values;
 
-    Array<PrefixTableEntry, 1 << max_allowed_prefixed_code_length> m_prefix_table {};
+    // Indexed by the next m_max_prefixed_code_length bits of the input, and only as large as that needs.
+    Vector<PrefixTableEntry> m_prefix_table;
     size_t m_max_prefixed_code_length { 0 };
 
     // Compression - indexed by symbol
@@ -119,6 +136,9 @@ private:
 
     bool m_read_final_block { false };
 
+    // An error that came up after some data was decoded, reported once that data has been read.
+    Optional<Error> m_pending_error;
+
     State m_state { State::Idle };
     union {
         CompressedBlock m_compressed_block;
@@ -140,6 +160,14 @@ public:
     static constexpr size_t max_match_length = 258; // matches longer than these cannot be encoded using huffman codes
     static constexpr u16 empty_slot = UINT16_MAX;
 
+    // With CompressionLevel::FASTEST, only the positions inside matches up to this long are added to the hash table.
+    static constexpr size_t max_inserted_match_length = 4;
+
+    // compress_all() splits inputs of at least parallel_compression_threshold bytes into chunks of this size, which are
+    // compressed on separate threads.
+    static constexpr size_t parallel_chunk_size = 8 * block_size;
+    static constexpr size_t parallel_compression_threshold = 4 * parallel_chunk_size;
+
     struct CompressionConstants {
         size_t good_match_length;  // Once we find a match of at least this length (a good enough match) we reduce max_chain to lower processing time
         size_t max_lazy_length;    // If the match is at least this long we dont defer matching to the next byte (which takes time) as its good enough
@@ -150,6 +178,7 @@ public:
     // These constants were shamelessly "borrowed" from zlib
     static constexpr CompressionConstants compression_constants[] = {
         { 0, 0, 0, 0 },
+        { 0, 0, max_match_length, 1 }, // a single probe of the hash table, and no lazy matching
         { 4, 4, 8, 4 },
         { 8, 16, 128, 128 },
         { 32, 258, 258, 4096 },
@@ -158,6 +187,7 @@ public:
 
     enum class CompressionLevel : int {
         STORE = 0,
+        FASTEST,
         FAST,
         GOOD,
         GREAT,
@@ -174,9 +204,15 @@ public:
     virtual void close() override;
     ErrorOr<void> final_flush();
 
+    // Compresses everything that was written so far, and ends it on a byte boundary with an empty uncompressed block,
+    // so that the output so far can be decompressed without waiting for the rest (like zlib's Z_SYNC_FLUSH).
+    ErrorOr<void> sync_flush();
+
     static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes bytes, CompressionLevel = CompressionLevel::GOOD);
 
 private:
+    static ErrorOr<ByteBuffer> compress_all_in_parallel(ReadonlyBytes bytes, CompressionLevel);
+
     DeflateCompressor(NonnullOwnPtr<LittleEndianOutputBitStream>, CompressionLevel = CompressionLevel::GOOD);
 
     Bytes pending_block() { return { m_rolling_window + block_size, block_size }; }
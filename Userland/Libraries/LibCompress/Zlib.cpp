@@ -64,16 +64,31 @@ void ZlibDecompressor::close()
 {
 }
 
+static DeflateCompressor::CompressionLevel deflate_compression_level(ZlibCompressionLevel compression_level)
+{
+    switch (compression_level) {
+    case ZlibCompressionLevel::Fastest:
+        return DeflateCompressor::CompressionLevel::FASTEST;
+    case ZlibCompressionLevel::Fast:
+        return DeflateCompressor::CompressionLevel::FAST;
+    case ZlibCompressionLevel::Default:
+        return DeflateCompressor::CompressionLevel::GOOD;
+    case ZlibCompressionLevel::Best:
+        // FIXME: Find a way to compress with Deflate's "Best" compression level.
+        return DeflateCompressor::CompressionLevel::GREAT;
+    }
+    VERIFY_NOT_REACHED();
+}
+
 ErrorOr<NonnullOwnPtr<ZlibCompressor>> ZlibCompressor::construct(MaybeOwned<Stream> stream, ZlibCompressionLevel compression_level)
 {
     // Zlib only defines Deflate as a compression method.
     auto compression_method = ZlibCompressionMethod::Deflate;
 
-    // FIXME: Find a way to compress with Deflate's "Best" compression level.
-    auto compressor_stream = TRY(DeflateCompressor::construct(MaybeOwned(*stream), static_cast<DeflateCompressor::CompressionLevel>(compression_level)));
+    auto compressor_stream = TRY(DeflateCompressor::construct(MaybeOwned(*stream), deflate_compression_level(compression_level)));
 
     auto zlib_compressor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) ZlibCompressor(move(stream), move(compressor_stream))));
-    TRY(zlib_compressor->write_header(compression_method, compression_level));
+    TRY(write_header(*zlib_compressor->m_output_stream, compression_method, compression_level));
 
     return zlib_compressor;
 }
@@ -89,7 +104,7 @@ ZlibCompressor::~ZlibCompressor()
     VERIFY(m_finished);
 }
 
-ErrorOr<void> ZlibCompressor::write_header(ZlibCompressionMethod compression_method, ZlibCompressionLevel compression_level)
+ErrorOr<void> ZlibCompressor::write_header(Stream& stream, ZlibCompressionMethod compression_method, ZlibCompressionLevel compression_level)
 {
     u8 compression_info = 0;
     if (compression_method == ZlibCompressionMethod::Deflate) {
@@ -108,7 +123,7 @@ ErrorOr<void> ZlibCompressor::write_header(ZlibCompressionMethod compression_met
 
     // FIXME: Support pre-defined dictionaries.
 
-    TRY(m_output_stream->write_value(header.as_u16));
+    TRY(stream.write_value(header.as_u16));
 
     return {};
 }
@@ -159,11 +174,15 @@ ErrorOr<void> ZlibCompressor::finish()
 ErrorOr<ByteBuffer> ZlibCompressor::compress_all(ReadonlyBytes bytes, ZlibCompressionLevel compression_level)
 {
     auto output_stream = TRY(try_make<AllocatingMemoryStream>());
-    auto zlib_stream = TRY(ZlibCompressor::construct(MaybeOwned<Stream>(*output_stream), compression_level));
+    TRY(write_header(*output_stream, ZlibCompressionMethod::Deflate, compression_level));
 
-    TRY(zlib_stream->write_until_depleted(bytes));
+    // Compressing the whole input at once lets large inputs be compressed in parallel.
+    auto compressed = TRY(DeflateCompressor::compress_all(bytes, deflate_compression_level(compression_level)));
+    TRY(output_stream->write_until_depleted(compressed));
 
-    TRY(zlib_stream->finish());
+    Crypto::Checksum::Adler32 adler_checksum;
+    adler_checksum.update(bytes);
+    TRY(output_stream->write_value<NetworkOrdered<u32>>(adler_checksum.digest()));
 
     auto buffer = TRY(ByteBuffer::create_uninitialized(output_stream->used_buffer_size()));
     TRY(output_stream->read_until_filled(buffer.bytes()));
@@ -0,0 +1,987 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BuiltinWrappers.h>
+#include <AK/Endian.h>
+#include <AK/IntegralMath.h>
+#include <AK/MemoryStream.h>
+#include <LibCompress/Zstd.h>
+
+namespace Compress {
+
+namespace {
+
+// Reads a bitstream front to back, starting with the least significant bit of each byte. Bits past the end read as
+// zero, which is only an error if they are actually consumed.
+class ForwardBitReader {
+public:
+    explicit ForwardBitReader(ReadonlyBytes bytes)
+        : m_bytes(bytes)
+    {
+    }
+
+    u32 peek_bits(size_t count) const
+    {
+        VERIFY(count <= 32);
+        size_t byte_index = m_position / 8;
+        u64 word = 0;
+        if (byte_index < m_bytes.size())
+            __builtin_memcpy(&word, m_bytes.offset_pointer(byte_index), min(sizeof(word), m_bytes.size() - byte_index));
+        word = AK::convert_between_host_and_little_endian(word);
+        return (word >> (m_position % 8)) & ((1ull << count) - 1);
+    }
+
+    u32 read_bits(size_t count)
+    {
+        auto bits = peek_bits(count);
+        m_position += count;
+        return bits;
+    }
+
+    void discard_bits(size_t count) { m_position += count; }
+
+    ErrorOr<size_t> consumed_bytes() const
+    {
+        if (m_position > m_bytes.size() * 8)
+            return Error::from_string_literal("Zstd FSE table description is truncated");
+        return ceil_div(m_position, 8zu);
+    }
+
+private:
+    ReadonlyBytes m_bytes;
+    size_t m_position { 0 };
+};
+
+// Reads a bitstream back to front, starting below the highest set bit of its last byte, which marks the end of the
+// stream. Bits before the start read as zero, and leave the position negative when they are consumed.
+class ReverseBitReader {
+public:
+    static ErrorOr<ReverseBitReader> create(ReadonlyBytes bytes)
+    {
+        if (bytes.is_empty() || bytes.last() == 0)
+            return Error::from_string_literal("Zstd bitstream is missing its end marker");
+        return ReverseBitReader { bytes, static_cast<i64>((bytes.size() - 1) * 8 + count_required_bits(bytes.last()) - 1) };
+    }
+
+    u64 peek_bits(size_t count) const
+    {
+        VERIFY(count <= 56);
+        if (count == 0)
+            return 0;
+
+        i64 start = m_position - static_cast<i64>(count);
+        if (start >= 0)
+            return (load_word(start / 8) >> (start % 8)) & ((1ull << count) - 1);
+        if (m_position <= 0)
+            return 0;
+        return (load_word(0) << -start) & ((1ull << count) - 1);
+    }
+
+    u64 read_bits(size_t count)
+    {
+        auto bits = peek_bits(count);
+        m_position -= count;
+        return bits;
+    }
+
+    void discard_bits(size_t count) { m_position -= count; }
+
+    bool has_overflowed() const { return m_position < 0; }
+    bool is_exhausted() const { return m_position == 0; }
+
+private:
+    ReverseBitReader(ReadonlyBytes bytes, i64 position)
+        : m_bytes(bytes)
+        , m_position(position)
+    {
+    }
+
+    u64 load_word(size_t byte_index) const
+    {
+        u64 word = 0;
+        if (byte_index + sizeof(word) <= m_bytes.size())
+            __builtin_memcpy(&word, m_bytes.offset_pointer(byte_index), sizeof(word));
+        else
+            __builtin_memcpy(&word, m_bytes.offset_pointer(byte_index), m_bytes.size() - byte_index);
+        return AK::convert_between_host_and_little_endian(word);
+    }
+
+    ReadonlyBytes m_bytes;
+    i64 m_position { 0 };
+};
+
+template<typename T>
+static ErrorOr<T> read_little_endian(ReadonlyBytes bytes, size_t offset, size_t size)
+{
+    if (offset + size > bytes.size())
+        return Error::from_string_literal("Zstd block is truncated");
+    T value = 0;
+    for (size_t i = 0; i < size; ++i)
+        value |= static_cast<T>(bytes[offset + i]) << (8 * i);
+    return value;
+}
+
+// RFC 8878 section 4.1.1: FSE table description.
+static ErrorOr<Zstd::FSETable> read_fse_table(ReadonlyBytes bytes, size_t& bytes_read, size_t max_symbol, u8 max_accuracy_log)
+{
+    ForwardBitReader reader { bytes };
+
+    u8 accuracy_log = reader.read_bits(4) + 5;
+    if (accuracy_log > max_accuracy_log)
+        return Error::from_string_literal("Zstd FSE table has a larger-than-allowed accuracy log");
+
+    i32 remaining = (1 << accuracy_log) + 1;
+    i32 threshold = 1 << accuracy_log;
+    size_t number_of_bits = accuracy_log + 1;
+
+    Vector<i16, 256> normalized_counts;
+    while (remaining > 1) {
+        if (normalized_counts.size() > max_symbol)
+            return Error::from_string_literal("Zstd FSE table has too many symbols");
+
+        // Values smaller than `max` use one bit less, since there is only room for `remaining` more probability.
+        i32 bits = reader.peek_bits(number_of_bits);
+        i32 max = (2 * threshold - 1) - remaining;
+        i32 value;
+        if ((bits & (threshold - 1)) < max) {
+            value = bits & (threshold - 1);
+            reader.discard_bits(number_of_bits - 1);
+        } else {
+            value = bits & (2 * threshold - 1);
+            if (value >= threshold)
+                value -= max;
+            reader.discard_bits(number_of_bits);
+        }
+
+        // A value of 0 stands for a "less than 1" probability, which takes up one state like a probability of 1.
+        i16 count = value - 1;
+        remaining -= count < 0 ? -count : count;
+        if (remaining < 1)
+            return Error::from_string_literal("Zstd FSE table has an invalid probability distribution");
+        TRY(normalized_counts.try_append(count));
+
+        if (count == 0) {
+            // A zero probability is followed by the number of further zero probabilities, in 2-bit chunks.
+            while (true) {
+                auto repeat = reader.read_bits(2);
+                if (normalized_counts.size() + repeat > max_symbol + 1)
+                    return Error::from_string_literal("Zstd FSE table has too many symbols");
+                for (size_t i = 0; i < repeat; ++i)
+                    TRY(normalized_counts.try_append(0));
+                if (repeat != 3)
+                    break;
+            }
+        }
+
+        while (remaining < threshold) {
+            --number_of_bits;
+            threshold >>= 1;
+        }
+    }
+
+    bytes_read = TRY(reader.consumed_bytes());
+    return Zstd::FSETable::create(normalized_counts, accuracy_log);
+}
+
+static ErrorOr<void> decode_huffman_stream(Zstd::HuffmanTable const& table, ReadonlyBytes stream, Bytes output)
+{
+    auto reader = TRY(ReverseBitReader::create(stream));
+    auto max_number_of_bits = table.max_number_of_bits();
+
+    for (auto& byte : output) {
+        auto const& entry = table[reader.peek_bits(max_number_of_bits)];
+        byte = entry.symbol;
+        reader.discard_bits(entry.number_of_bits);
+    }
+
+    if (!reader.is_exhausted())
+        return Error::from_string_literal("Zstd Huffman stream does not match its regenerated size");
+    return {};
+}
+
+// RFC 8878 section 3.1.1.3.2.1.1: Default distributions.
+constexpr Array<i16, 36> literal_length_default_distribution {
+    4, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 2, 1, 1, 1, 1, 1, -1, -1, -1, -1
+};
+constexpr u8 literal_length_default_accuracy_log = 6;
+
+constexpr Array<i16, 53> match_length_default_distribution {
+    1, 4, 3, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1, -1, -1
+};
+constexpr u8 match_length_default_accuracy_log = 6;
+
+constexpr Array<i16, 29> offset_default_distribution {
+    1, 1, 1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1
+};
+constexpr u8 offset_default_accuracy_log = 5;
+
+// RFC 8878 section 3.1.1.3.2.1.1: Literals length codes and match length codes.
+struct LengthCode {
+    u32 baseline;
+    u8 number_of_bits;
+};
+
+constexpr Array<LengthCode, 36> literal_length_codes { {
+    { 0, 0 }, { 1, 0 }, { 2, 0 }, { 3, 0 }, { 4, 0 }, { 5, 0 }, { 6, 0 }, { 7, 0 }, { 8, 0 }, { 9, 0 }, { 10, 0 },
+    { 11, 0 }, { 12, 0 }, { 13, 0 }, { 14, 0 }, { 15, 0 }, { 16, 1 }, { 18, 1 }, { 20, 1 }, { 22, 1 }, { 24, 2 },
+    { 28, 2 }, { 32, 3 }, { 40, 3 }, { 48, 4 }, { 64, 6 }, { 128, 7 }, { 256, 8 }, { 512, 9 }, { 1024, 10 },
+    { 2048, 11 }, { 4096, 12 }, { 8192, 13 }, { 16384, 14 }, { 32768, 15 }, { 65536, 16 },
+} };
+
+constexpr Array<LengthCode, 53> match_length_codes { {
+    { 3, 0 }, { 4, 0 }, { 5, 0 }, { 6, 0 }, { 7, 0 }, { 8, 0 }, { 9, 0 }, { 10, 0 }, { 11, 0 }, { 12, 0 }, { 13, 0 },
+    { 14, 0 }, { 15, 0 }, { 16, 0 }, { 17, 0 }, { 18, 0 }, { 19, 0 }, { 20, 0 }, { 21, 0 }, { 22, 0 }, { 23, 0 },
+    { 24, 0 }, { 25, 0 }, { 26, 0 }, { 27, 0 }, { 28, 0 }, { 29, 0 }, { 30, 0 }, { 31, 0 }, { 32, 0 }, { 33, 0 },
+    { 34, 0 }, { 35, 1 }, { 37, 1 }, { 39, 1 }, { 41, 1 }, { 43, 2 }, { 47, 2 }, { 51, 3 }, { 59, 3 }, { 67, 4 },
+    { 83, 4 }, { 99, 5 }, { 131, 7 }, { 259, 8 }, { 515, 9 }, { 1027, 10 }, { 2051, 11 }, { 4099, 12 }, { 8195, 13 },
+    { 16387, 14 }, { 32771, 15 }, { 65539, 16 },
+} };
+
+constexpr size_t max_offset_code = 31;
+
+constexpr u8 max_literal_length_accuracy_log = 9;
+constexpr u8 max_match_length_accuracy_log = 9;
+constexpr u8 max_offset_accuracy_log = 8;
+constexpr u8 max_huffman_weight_accuracy_log = 6;
+
+}
+
+namespace Zstd {
+
+ErrorOr<FSETable> FSETable::create(ReadonlySpan<i16> normalized_counts, u8 accuracy_log)
+{
+    // RFC 8878 section 4.1.1: From normalized distribution to decoding tables.
+    size_t table_size = 1u << accuracy_log;
+    FSETable table;
+    table.m_accuracy_log = accuracy_log;
+    TRY(table.m_entries.try_resize(table_size));
+
+    Vector<u16, 256> next_state_counters;
+    TRY(next_state_counters.try_resize(normalized_counts.size()));
+
+    // Symbols with a "less than 1" probability get a single state each, at the end of the table.
+    size_t high_threshold = table_size - 1;
+    for (size_t symbol = 0; symbol < normalized_counts.size(); ++symbol) {
+        if (normalized_counts[symbol] == -1) {
+            table.m_entries[high_threshold--].symbol = symbol;
+            next_state_counters[symbol] = 1;
+        } else {
+            next_state_counters[symbol] = normalized_counts[symbol];
+        }
+    }
+
+    // The other symbols are spread across the remaining states.
+    size_t position = 0;
+    size_t step = (table_size >> 1) + (table_size >> 3) + 3;
+    size_t mask = table_size - 1;
+    for (size_t symbol = 0; symbol < normalized_counts.size(); ++symbol) {
+        for (i16 i = 0; i < normalized_counts[symbol]; ++i) {
+            table.m_entries[position].symbol = symbol;
+            do {
+                position = (position + step) & mask;
+            } while (position > high_threshold);
+        }
+    }
+    if (position != 0)
+        return Error::from_string_literal("Zstd FSE table has an invalid probability distribution");
+
+    for (auto& entry : table.m_entries) {
+        u16 next_state = next_state_counters[entry.symbol]++;
+        entry.number_of_bits = accuracy_log - (count_required_bits(next_state) - 1);
+        entry.baseline = (next_state << entry.number_of_bits) - table_size;
+    }
+
+    return table;
+}
+
+ErrorOr<FSETable> FSETable::create_rle(u8 symbol)
+{
+    FSETable table;
+    TRY(table.m_entries.try_append({ symbol, 0, 0 }));
+    return table;
+}
+
+ErrorOr<HuffmanTable> HuffmanTable::create(ReadonlySpan<u8> weights)
+{
+    // RFC 8878 section 4.2.1: Huffman tree description.
+    if (weights.size() > 255)
+        return Error::from_string_literal("Zstd Huffman tree has too many symbols");
+
+    u32 weight_sum = 0;
+    for (auto weight : weights) {
+        if (weight > max_code_length)
+            return Error::from_string_literal("Zstd Huffman tree has a larger-than-allowed weight");
+        if (weight > 0)
+            weight_sum += 1u << (weight - 1);
+    }
+    if (weight_sum == 0)
+        return Error::from_string_literal("Zstd Huffman tree has no symbols");
+
+    // The weights add up to a power of two, which determines the weight of the last symbol.
+    u8 max_number_of_bits = count_required_bits(weight_sum);
+    if (max_number_of_bits > max_code_length)
+        return Error::from_string_literal("Zstd Huffman tree has a larger-than-allowed code length");
+    u32 last_weight_value = (1u << max_number_of_bits) - weight_sum;
+    if (!is_power_of_two(last_weight_value))
+        return Error::from_string_literal("Zstd Huffman tree has an invalid last weight");
+
+    Vector<u8, 256> all_weights;
+    TRY(all_weights.try_append(weights.data(), weights.size()));
+    TRY(all_weights.try_append(count_required_bits(last_weight_value)));
+
+    HuffmanTable table;
+    table.m_max_number_of_bits = max_number_of_bits;
+    TRY(table.m_entries.try_resize(1u << max_number_of_bits));
+
+    // The longest codes come first, and codes of the same length are in symbol order.
+    size_t position = 0;
+    for (u8 weight = 1; weight <= max_number_of_bits; ++weight) {
+        for (size_t symbol = 0; symbol < all_weights.size(); ++symbol) {
+            if (all_weights[symbol] != weight)
+                continue;
+            size_t entry_count = 1u << (weight - 1);
+            Entry entry { static_cast<u8>(symbol), static_cast<u8>(max_number_of_bits + 1 - weight) };
+            for (size_t i = 0; i < entry_count; ++i)
+                table.m_entries[position++] = entry;
+        }
+    }
+    VERIFY(position == table.m_entries.size());
+
+    return table;
+}
+
+}
+
+static constexpr u64 xxhash64_prime1 = 0x9E3779B185EBCA87;
+static constexpr u64 xxhash64_prime2 = 0xC2B2AE3D27D4EB4F;
+static constexpr u64 xxhash64_prime3 = 0x165667B19E3779F9;
+static constexpr u64 xxhash64_prime4 = 0x85EBCA77C2B2AE63;
+static constexpr u64 xxhash64_prime5 = 0x27D4EB2F165667C5;
+
+static constexpr u64 rotate_left(u64 value, size_t bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static u64 xxhash64_round(u64 accumulator, u64 input)
+{
+    accumulator += input * xxhash64_prime2;
+    accumulator = rotate_left(accumulator, 31);
+    return accumulator * xxhash64_prime1;
+}
+
+static u64 xxhash64_merge_round(u64 accumulator, u64 value)
+{
+    accumulator ^= xxhash64_round(0, value);
+    return accumulator * xxhash64_prime1 + xxhash64_prime4;
+}
+
+static u64 read_u64_le(u8 const* data)
+{
+    u64 value;
+    __builtin_memcpy(&value, data, sizeof(value));
+    return AK::convert_between_host_and_little_endian(value);
+}
+
+void ZstdDecompressor::XXHash64::update(ReadonlyBytes bytes)
+{
+    m_total_size += bytes.size();
+
+    auto process_stripe = [this](u8 const* stripe) {
+        for (size_t i = 0; i < 4; ++i)
+            m_accumulators[i] = xxhash64_round(m_accumulators[i], read_u64_le(stripe + 8 * i));
+    };
+
+    if (m_buffer_size > 0) {
+        auto fill = min(sizeof(m_buffer) - m_buffer_size, bytes.size());
+        __builtin_memcpy(m_buffer + m_buffer_size, bytes.data(), fill);
+        m_buffer_size += fill;
+        bytes = bytes.slice(fill);
+        if (m_buffer_size < sizeof(m_buffer))
+            return;
+        process_stripe(m_buffer);
+        m_buffer_size = 0;
+    }
+
+    while (bytes.size() >= sizeof(m_buffer)) {
+        process_stripe(bytes.data());
+        bytes = bytes.slice(sizeof(m_buffer));
+    }
+
+    __builtin_memcpy(m_buffer, bytes.data(), bytes.size());
+    m_buffer_size = bytes.size();
+}
+
+u64 ZstdDecompressor::XXHash64::digest() const
+{
+    u64 hash;
+    if (m_total_size >= sizeof(m_buffer)) {
+        hash = rotate_left(m_accumulators[0], 1) + rotate_left(m_accumulators[1], 7) + rotate_left(m_accumulators[2], 12) + rotate_left(m_accumulators[3], 18);
+        for (auto accumulator : m_accumulators)
+            hash = xxhash64_merge_round(hash, accumulator);
+    } else {
+        hash = m_accumulators[2] + xxhash64_prime5;
+    }
+    hash += m_total_size;
+
+    size_t offset = 0;
+    for (; offset + 8 <= m_buffer_size; offset += 8) {
+        hash ^= xxhash64_round(0, read_u64_le(m_buffer + offset));
+        hash = rotate_left(hash, 27) * xxhash64_prime1 + xxhash64_prime4;
+    }
+    if (offset + 4 <= m_buffer_size) {
+        u32 value;
+        __builtin_memcpy(&value, m_buffer + offset, sizeof(value));
+        hash ^= static_cast<u64>(AK::convert_between_host_and_little_endian(value)) * xxhash64_prime1;
+        hash = rotate_left(hash, 23) * xxhash64_prime2 + xxhash64_prime3;
+        offset += 4;
+    }
+    for (; offset < m_buffer_size; ++offset) {
+        hash ^= m_buffer[offset] * xxhash64_prime5;
+        hash = rotate_left(hash, 11) * xxhash64_prime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= xxhash64_prime2;
+    hash ^= hash >> 29;
+    hash *= xxhash64_prime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+ZstdDecompressor::ZstdDecompressor(MaybeOwned<Stream> stream)
+    : m_stream(move(stream))
+{
+}
+
+ErrorOr<NonnullOwnPtr<ZstdDecompressor>> ZstdDecompressor::create(MaybeOwned<Stream> stream)
+{
+    return adopt_nonnull_own_or_enomem(new (nothrow) ZstdDecompressor(move(stream)));
+}
+
+ErrorOr<ByteBuffer> ZstdDecompressor::decompress_all(ReadonlyBytes bytes)
+{
+    auto memory_stream = TRY(try_make<FixedMemoryStream>(bytes));
+    auto zstd_stream = TRY(ZstdDecompressor::create(move(memory_stream)));
+    return zstd_stream->read_until_eof();
+}
+
+bool ZstdDecompressor::is_likely_compressed(ReadonlyBytes bytes)
+{
+    if (bytes.size() < sizeof(u32))
+        return false;
+    return (bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<u32>(bytes[3]) << 24)) == frame_magic;
+}
+
+ErrorOr<bool> ZstdDecompressor::read_frame_header()
+{
+    // Streams like files only know that they reached their end after trying to read past it, so the end of the last
+    // frame can only be noticed here.
+    u8 magic_bytes[4];
+    auto first_bytes = TRY(m_stream->read_some({ magic_bytes, sizeof(magic_bytes) }));
+    if (first_bytes.is_empty())
+        return false;
+    TRY(m_stream->read_until_filled({ magic_bytes + first_bytes.size(), sizeof(magic_bytes) - first_bytes.size() }));
+
+    // RFC 8878 section 3.1: Frames.
+    u32 magic = TRY(read_little_endian<u32>({ magic_bytes, sizeof(magic_bytes) }, 0, sizeof(magic_bytes)));
+    if ((magic & skippable_frame_magic_mask) == skippable_frame_magic) {
+        u32 frame_size = TRY(m_stream->read_value<LittleEndian<u32>>());
+        TRY(m_stream->discard(frame_size));
+        return true;
+    }
+    if (magic != frame_magic)
+        return Error::from_string_literal("Zstd frame has an invalid magic");
+
+    // RFC 8878 section 3.1.1.1: Frame header.
+    u8 descriptor = TRY(m_stream->read_value<u8>());
+    u8 frame_content_size_flag = descriptor >> 6;
+    bool single_segment = descriptor & (1 << 5);
+    if (descriptor & (1 << 3))
+        return Error::from_string_literal("Zstd frame header has a non-null reserved bit");
+    m_frame_header.has_checksum = descriptor & (1 << 2);
+    u8 dictionary_id_flag = descriptor & 0b11;
+
+    if (!single_segment) {
+        u8 window_descriptor = TRY(m_stream->read_value<u8>());
+        u8 exponent = window_descriptor >> 3;
+        u8 mantissa = window_descriptor & 0b111;
+        u64 window_base = 1ull << (10 + exponent);
+        m_frame_header.window_size = window_base + (window_base / 8) * mantissa;
+    }
+
+    auto read_field = [&](size_t size) -> ErrorOr<u64> {
+        u8 bytes[8] {};
+        TRY(m_stream->read_until_filled({ bytes, size }));
+        return read_little_endian<u64>({ bytes, size }, 0, size);
+    };
+
+    constexpr Array<size_t, 4> dictionary_id_sizes { 0, 1, 2, 4 };
+    if (TRY(read_field(dictionary_id_sizes[dictionary_id_flag])) != 0)
+        return Error::from_string_literal("Zstd frames that need a dictionary are not supported");
+
+    constexpr Array<size_t, 4> frame_content_size_sizes { 0, 2, 4, 8 };
+    size_t frame_content_size_size = frame_content_size_flag == 0 && single_segment ? 1 : frame_content_size_sizes[frame_content_size_flag];
+    m_frame_header.content_size.clear();
+    if (frame_content_size_size != 0) {
+        u64 content_size = TRY(read_field(frame_content_size_size));
+        if (frame_content_size_size == 2)
+            content_size += 256;
+        m_frame_header.content_size = content_size;
+    }
+
+    // A single segment holds the whole frame, so it serves as the window.
+    if (single_segment)
+        m_frame_header.window_size = m_frame_header.content_size.value();
+
+    if (m_frame_header.window_size > max_window_size)
+        return Error::from_string_literal("Zstd frame has a larger-than-allowed window size");
+
+    size_t window_capacity = max<u64>(m_frame_header.window_size, 1);
+    if (!m_window.has_value() || m_window->capacity() != window_capacity)
+        m_window = TRY(CircularBuffer::create_empty(window_capacity));
+    else
+        m_window->clear();
+
+    m_frame_output_size = 0;
+    m_checksum = {};
+    m_repeated_offsets[0] = 1;
+    m_repeated_offsets[1] = 4;
+    m_repeated_offsets[2] = 8;
+    m_huffman_table.clear();
+    m_literal_length_table.clear();
+    m_offset_table.clear();
+    m_match_length_table.clear();
+
+    m_state = State::Block;
+    return true;
+}
+
+ErrorOr<void> ZstdDecompressor::read_block()
+{
+    // RFC 8878 section 3.1.1.2: Blocks.
+    u8 header_bytes[3];
+    TRY(m_stream->read_until_filled({ header_bytes, sizeof(header_bytes) }));
+    u32 header = header_bytes[0] | (header_bytes[1] << 8) | (header_bytes[2] << 16);
+
+    bool last_block = header & 1;
+    u8 block_type = (header >> 1) & 0b11;
+    size_t block_size = header >> 3;
+
+    if (block_size > max_block_size)
+        return Error::from_string_literal("Zstd block is larger than allowed");
+
+    m_block_output_size = 0;
+    switch (block_type) {
+    case 0: {
+        // Raw block
+        TRY(m_block.try_resize(block_size));
+        TRY(m_stream->read_until_filled(m_block));
+        TRY(write_output(m_block));
+        break;
+    }
+    case 1: {
+        // RLE block, with a block size that is the size of the regenerated data
+        u8 value = TRY(m_stream->read_value<u8>());
+        u8 run[256];
+        __builtin_memset(run, value, sizeof(run));
+        for (size_t remaining = block_size; remaining > 0;) {
+            auto chunk_size = min(remaining, sizeof(run));
+            TRY(write_output({ run, chunk_size }));
+            remaining -= chunk_size;
+        }
+        break;
+    }
+    case 2: {
+        // Compressed block
+        TRY(m_block.try_resize(block_size));
+        TRY(m_stream->read_until_filled(m_block));
+        TRY(decode_compressed_block(m_block));
+        break;
+    }
+    default:
+        return Error::from_string_literal("Zstd block has a reserved block type");
+    }
+
+    if (last_block)
+        m_state = State::FrameEnd;
+    return {};
+}
+
+ErrorOr<void> ZstdDecompressor::read_frame_end()
+{
+    if (m_frame_header.content_size.has_value() && m_frame_header.content_size.value() != m_frame_output_size)
+        return Error::from_string_literal("Zstd frame does not match its content size");
+
+    if (m_frame_header.has_checksum) {
+        u32 checksum = TRY(m_stream->read_value<LittleEndian<u32>>());
+        if (checksum != static_cast<u32>(m_checksum.digest()))
+            return Error::from_string_literal("Zstd frame has an invalid checksum");
+    }
+
+    m_state = State::FrameHeader;
+    return {};
+}
+
+ErrorOr<void> ZstdDecompressor::decode_compressed_block(ReadonlyBytes block)
+{
+    // RFC 8878 section 3.1.1.3: Compressed blocks.
+    ReadonlyBytes literals;
+    auto literals_section_size = TRY(decode_literals_section(block, literals));
+    return decode_sequences_section(block.slice(literals_section_size), literals);
+}
+
+ErrorOr<size_t> ZstdDecompressor::decode_literals_section(ReadonlyBytes block, ReadonlyBytes& literals)
+{
+    // RFC 8878 section 3.1.1.3.1: Literals section.
+    if (block.is_empty())
+        return Error::from_string_literal("Zstd block is truncated");
+
+    u8 literals_block_type = block[0] & 0b11;
+    u8 size_format = (block[0] >> 2) & 0b11;
+
+    if (literals_block_type == 0 || literals_block_type == 1) {
+        // Raw and RLE literals
+        size_t header_size;
+        size_t regenerated_size;
+        if ((size_format & 1) == 0) {
+            header_size = 1;
+            regenerated_size = block[0] >> 3;
+        } else {
+            header_size = size_format == 1 ? 2 : 3;
+            regenerated_size = TRY(read_little_endian<u32>(block, 0, header_size)) >> 4;
+        }
+
+        if (literals_block_type == 0) {
+            if (header_size + regenerated_size > block.size())
+                return Error::from_string_literal("Zstd block is truncated");
+            literals = block.slice(header_size, regenerated_size);
+            return header_size + regenerated_size;
+        }
+
+        if (header_size + 1 > block.size())
+            return Error::from_string_literal("Zstd block is truncated");
+        if (regenerated_size > max_block_size)
+            return Error::from_string_literal("Zstd literals section is larger than allowed");
+        TRY(m_literals_buffer.try_resize(regenerated_size));
+        m_literals_buffer.bytes().fill(block[header_size]);
+        literals = m_literals_buffer;
+        return header_size + 1;
+    }
+
+    // Compressed and treeless literals
+    size_t stream_count = size_format == 0 ? 1 : 4;
+    size_t header_size = size_format < 2 ? 3 : size_format + 2;
+    size_t field_size = size_format < 2 ? 10 : 4 * size_format + 6;
+
+    u64 header = TRY(read_little_endian<u64>(block, 0, header_size));
+    size_t regenerated_size = (header >> 4) & ((1u << field_size) - 1);
+    size_t compressed_size = (header >> (4 + field_size)) & ((1u << field_size) - 1);
+
+    if (regenerated_size > max_block_size)
+        return Error::from_string_literal("Zstd literals section is larger than allowed");
+    if (header_size + compressed_size > block.size())
+        return Error::from_string_literal("Zstd block is truncated");
+
+    auto data = block.slice(header_size, compressed_size);
+    if (literals_block_type == 2) {
+        auto tree_description_size = TRY(read_huffman_table(data));
+        data = data.slice(tree_description_size);
+    } else if (!m_huffman_table.has_value()) {
+        return Error::from_string_literal("Zstd treeless literals block has no previous Huffman tree");
+    }
+
+    TRY(m_literals_buffer.try_resize(regenerated_size));
+    literals = m_literals_buffer;
+
+    if (stream_count == 1) {
+        TRY(decode_huffman_stream(*m_huffman_table, data, m_literals_buffer));
+        return header_size + compressed_size;
+    }
+
+    // Four streams, whose first three sizes are given by a jump table, and which regenerate a quarter of the literals
+    // each (with the last one regenerating the rest).
+    if (data.size() < 6)
+        return Error::from_string_literal("Zstd literals jump table is truncated");
+    size_t stream_sizes[4];
+    stream_sizes[0] = TRY(read_little_endian<u16>(data, 0, 2));
+    stream_sizes[1] = TRY(read_little_endian<u16>(data, 2, 2));
+    stream_sizes[2] = TRY(read_little_endian<u16>(data, 4, 2));
+    size_t streams_size = data.size() - 6;
+    if (stream_sizes[0] + stream_sizes[1] + stream_sizes[2] > streams_size)
+        return Error::from_string_literal("Zstd literals jump table is invalid");
+    stream_sizes[3] = streams_size - stream_sizes[0] - stream_sizes[1] - stream_sizes[2];
+
+    size_t segment_size = ceil_div(regenerated_size, 4zu);
+    if (3 * segment_size > regenerated_size)
+        return Error::from_string_literal("Zstd literals section is too small for four streams");
+
+    size_t stream_offset = 6;
+    for (size_t i = 0; i < 4; ++i) {
+        auto output_size = i < 3 ? segment_size : regenerated_size - 3 * segment_size;
+        TRY(decode_huffman_stream(*m_huffman_table, data.slice(stream_offset, stream_sizes[i]), m_literals_buffer.bytes().slice(i * segment_size, output_size)));
+        stream_offset += stream_sizes[i];
+    }
+
+    return header_size + compressed_size;
+}
+
+ErrorOr<size_t> ZstdDecompressor::read_huffman_table(ReadonlyBytes data)
+{
+    // RFC 8878 section 4.2.1: Huffman tree description.
+    if (data.is_empty())
+        return Error::from_string_literal("Zstd Huffman tree description is truncated");
+
+    u8 header = data[0];
+    Vector<u8, 256> weights;
+
+    if (header >= 128) {
+        // The weights are stored directly, as 4-bit values.
+        size_t weight_count = header - 127;
+        size_t description_size = 1 + ceil_div(weight_count, 2zu);
+        if (description_size > data.size())
+            return Error::from_string_literal("Zstd Huffman tree description is truncated");
+
+        for (size_t i = 0; i < weight_count; ++i) {
+            u8 byte = data[1 + i / 2];
+            TRY(weights.try_append(i % 2 == 0 ? byte >> 4 : byte & 0xf));
+        }
+
+        m_huffman_table = TRY(Zstd::HuffmanTable::create(weights));
+        return description_size;
+    }
+
+    // The weights are compressed with FSE, using two interleaved states.
+    size_t description_size = 1 + header;
+    if (description_size > data.size())
+        return Error::from_string_literal("Zstd Huffman tree description is truncated");
+    auto compressed_weights = data.slice(1, header);
+
+    size_t table_size = 0;
+    auto table = TRY(read_fse_table(compressed_weights, table_size, 255, max_huffman_weight_accuracy_log));
+    auto reader = TRY(ReverseBitReader::create(compressed_weights.slice(table_size)));
+
+    u32 states[2];
+    states[0] = reader.read_bits(table.accuracy_log());
+    states[1] = reader.read_bits(table.accuracy_log());
+
+    // Decoding stops once updating a state goes past the start of the bitstream, after which the other state still
+    // holds one last symbol.
+    for (size_t current = 0;; current ^= 1) {
+        auto const& entry = table[states[current]];
+        TRY(weights.try_append(entry.symbol));
+        states[current] = entry.baseline + reader.read_bits(entry.number_of_bits);
+
+        if (reader.has_overflowed()) {
+            TRY(weights.try_append(table[states[current ^ 1]].symbol));
+            break;
+        }
+        if (weights.size() > 255)
+            return Error::from_string_literal("Zstd Huffman tree has too many symbols");
+    }
+
+    m_huffman_table = TRY(Zstd::HuffmanTable::create(weights));
+    return description_size;
+}
+
+ErrorOr<void> ZstdDecompressor::decode_sequences_section(ReadonlyBytes data, ReadonlyBytes literals)
+{
+    // RFC 8878 section 3.1.1.3.2: Sequences section.
+    if (data.is_empty())
+        return Error::from_string_literal("Zstd sequences section is truncated");
+
+    size_t sequence_count;
+    size_t offset;
+    if (data[0] < 128) {
+        sequence_count = data[0];
+        offset = 1;
+    } else if (data[0] < 255) {
+        sequence_count = ((data[0] - 128) << 8) + TRY(read_little_endian<u8>(data, 1, 1));
+        offset = 2;
+    } else {
+        sequence_count = TRY(read_little_endian<u16>(data, 1, 2)) + 0x7F00;
+        offset = 3;
+    }
+
+    if (sequence_count == 0)
+        return write_output(literals);
+
+    if (offset >= data.size())
+        return Error::from_string_literal("Zstd sequences section is truncated");
+    u8 compression_modes = data[offset++];
+    if ((compression_modes & 0b11) != 0)
+        return Error::from_string_literal("Zstd sequences section has non-null reserved bits");
+
+    auto read_table = [&](Optional<Zstd::FSETable>& table, u8 mode, ReadonlySpan<i16> default_distribution, u8 default_accuracy_log, size_t max_symbol, u8 max_accuracy_log) -> ErrorOr<void> {
+        switch (mode) {
+        case 0:
+            table = TRY(Zstd::FSETable::create(default_distribution, default_accuracy_log));
+            return {};
+        case 1: {
+            u8 symbol = TRY(read_little_endian<u8>(data, offset++, 1));
+            if (symbol > max_symbol)
+                return Error::from_string_literal("Zstd sequences section has an invalid RLE symbol");
+            table = TRY(Zstd::FSETable::create_rle(symbol));
+            return {};
+        }
+        case 2: {
+            size_t table_size = 0;
+            table = TRY(read_fse_table(data.slice(offset), table_size, max_symbol, max_accuracy_log));
+            offset += table_size;
+            return {};
+        }
+        case 3:
+            if (!table.has_value())
+                return Error::from_string_literal("Zstd sequences section repeats a table that does not exist");
+            return {};
+        default:
+            VERIFY_NOT_REACHED();
+        }
+    };
+
+    TRY(read_table(m_literal_length_table, compression_modes >> 6, literal_length_default_distribution, literal_length_default_accuracy_log, literal_length_codes.size() - 1, max_literal_length_accuracy_log));
+    TRY(read_table(m_offset_table, (compression_modes >> 4) & 0b11, offset_default_distribution, offset_default_accuracy_log, max_offset_code, max_offset_accuracy_log));
+    TRY(read_table(m_match_length_table, (compression_modes >> 2) & 0b11, match_length_default_distribution, match_length_default_accuracy_log, match_length_codes.size() - 1, max_match_length_accuracy_log));
+
+    if (offset > data.size())
+        return Error::from_string_literal("Zstd sequences section is truncated");
+    auto reader = TRY(ReverseBitReader::create(data.slice(offset)));
+
+    auto const& literal_length_table = *m_literal_length_table;
+    auto const& offset_table = *m_offset_table;
+    auto const& match_length_table = *m_match_length_table;
+
+    u32 literal_length_state = reader.read_bits(literal_length_table.accuracy_log());
+    u32 offset_state = reader.read_bits(offset_table.accuracy_log());
+    u32 match_length_state = reader.read_bits(match_length_table.accuracy_log());
+
+    size_t literals_offset = 0;
+    for (size_t i = 0; i < sequence_count; ++i) {
+        auto const& literal_length_entry = literal_length_table[literal_length_state];
+        auto const& offset_entry = offset_table[offset_state];
+        auto const& match_length_entry = match_length_table[match_length_state];
+
+        // The additional bits are read in the order offset, match length, literals length.
+        u8 offset_code = offset_entry.symbol;
+        u32 offset_value = (1u << offset_code) + reader.read_bits(offset_code);
+        auto const& match_length_code = match_length_codes[match_length_entry.symbol];
+        size_t match_length = match_length_code.baseline + reader.read_bits(match_length_code.number_of_bits);
+        auto const& literal_length_code = literal_length_codes[literal_length_entry.symbol];
+        size_t literal_length = literal_length_code.baseline + reader.read_bits(literal_length_code.number_of_bits);
+
+        // RFC 8878 section 3.2.2: Repeat offsets.
+        u32 match_offset;
+        if (offset_value > 3) {
+            match_offset = offset_value - 3;
+            m_repeated_offsets[2] = m_repeated_offsets[1];
+            m_repeated_offsets[1] = m_repeated_offsets[0];
+        } else {
+            // Without literals, the repeated offsets are shifted by one.
+            u32 index = offset_value - 1 + (literal_length == 0 ? 1 : 0);
+            if (index == 0) {
+                match_offset = m_repeated_offsets[0];
+            } else {
+                match_offset = index == 3 ? m_repeated_offsets[0] - 1 : m_repeated_offsets[index];
+                if (index != 1)
+                    m_repeated_offsets[2] = m_repeated_offsets[1];
+                m_repeated_offsets[1] = m_repeated_offsets[0];
+            }
+        }
+        m_repeated_offsets[0] = match_offset;
+
+        // The states are updated in the order literals length, match length, offset, except after the last sequence.
+        if (i + 1 < sequence_count) {
+            literal_length_state = literal_length_entry.baseline + reader.read_bits(literal_length_entry.number_of_bits);
+            match_length_state = match_length_entry.baseline + reader.read_bits(match_length_entry.number_of_bits);
+            offset_state = offset_entry.baseline + reader.read_bits(offset_entry.number_of_bits);
+        }
+
+        if (literal_length > literals.size() - literals_offset)
+            return Error::from_string_literal("Zstd sequence uses more literals than there are");
+        TRY(write_output(literals.slice(literals_offset, literal_length)));
+        literals_offset += literal_length;
+
+        TRY(copy_match(match_offset, match_length));
+    }
+
+    if (!reader.is_exhausted())
+        return Error::from_string_literal("Zstd sequences bitstream does not match its sequence count");
+
+    return write_output(literals.slice(literals_offset));
+}
+
+ErrorOr<void> ZstdDecompressor::write_output(ReadonlyBytes bytes)
+{
+    m_block_output_size += bytes.size();
+    if (m_block_output_size > min(max_block_size, m_window->capacity()))
+        return Error::from_string_literal("Zstd block regenerates more data than allowed");
+
+    auto written = m_window->write(bytes);
+    VERIFY(written == bytes.size());
+    m_frame_output_size += bytes.size();
+    return {};
+}
+
+ErrorOr<void> ZstdDecompressor::copy_match(size_t offset, size_t length)
+{
+    if (offset == 0 || offset > m_frame_output_size || offset > m_frame_header.window_size)
+        return Error::from_string_literal("Zstd match offset is out of range");
+
+    m_block_output_size += length;
+    if (m_block_output_size > min(max_block_size, m_window->capacity()))
+        return Error::from_string_literal("Zstd block regenerates more data than allowed");
+
+    auto copied = TRY(m_window->copy_from_seekback(offset, length));
+    VERIFY(copied == length);
+    m_frame_output_size += length;
+    return {};
+}
+
+ErrorOr<Bytes> ZstdDecompressor::read_some(Bytes bytes)
+{
+    while (!m_window.has_value() || m_window->used_space() == 0) {
+        switch (m_state) {
+        case State::FrameHeader:
+            if (!TRY(read_frame_header()))
+                return bytes.trim(0);
+            break;
+        case State::Block:
+            TRY(read_block());
+            break;
+        case State::FrameEnd:
+            TRY(read_frame_end());
+            break;
+        }
+    }
+
+    auto read_bytes = m_window->read(bytes);
+    m_checksum.update(read_bytes);
+    return read_bytes;
+}
+
+ErrorOr<size_t> ZstdDecompressor::write_some(ReadonlyBytes)
+{
+    return Error::from_errno(EBADF);
+}
+
+bool ZstdDecompressor::is_eof() const
+{
+    if (m_window.has_value() && m_window->used_space() > 0)
+        return false;
+    return m_state == State::FrameHeader && m_stream->is_eof();
+}
+
+bool ZstdDecompressor::is_open() const
+{
+    return m_stream->is_open();
+}
+
+void ZstdDecompressor::close()
+{
+}
+
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/CircularBuffer.h>
+#include <AK/MaybeOwned.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Stream.h>
+#include <AK/Vector.h>
+
+namespace Compress {
+
+namespace Zstd {
+
+// Decoding table of a finite state entropy code, RFC 8878 section 4.1.
+class FSETable {
+public:
+    struct Entry {
+        u8 symbol { 0 };
+        u8 number_of_bits { 0 };
+        u16 baseline { 0 };
+    };
+
+    static ErrorOr<FSETable> create(ReadonlySpan<i16> normalized_counts, u8 accuracy_log);
+    static ErrorOr<FSETable> create_rle(u8 symbol);
+
+    u8 accuracy_log() const { return m_accuracy_log; }
+    Entry const& operator[](size_t state) const { return m_entries[state]; }
+
+private:
+    Vector<Entry> m_entries;
+    u8 m_accuracy_log { 0 };
+};
+
+// Decoding table of the Huffman code used for literals, RFC 8878 section 4.2. It is indexed by the next
+// max_number_of_bits() bits of the stream.
+class HuffmanTable {
+public:
+    struct Entry {
+        u8 symbol { 0 };
+        u8 number_of_bits { 0 };
+    };
+
+    static constexpr size_t max_code_length = 11;
+
+    // The weight of the last symbol is implied by those of the others.
+    static ErrorOr<HuffmanTable> create(ReadonlySpan<u8> weights);
+
+    u8 max_number_of_bits() const { return m_max_number_of_bits; }
+    Entry const& operator[](size_t index) const { return m_entries[index]; }
+
+private:
+    Vector<Entry> m_entries;
+    u8 m_max_number_of_bits { 0 };
+};
+
+}
+
+// Decompresses Zstandard frames, as described in RFC 8878. Skippable frames are skipped, and frames that need a
+// dictionary are rejected.
+class ZstdDecompressor : public Stream {
+public:
+    static constexpr u32 frame_magic = 0xFD2FB528;
+    static constexpr u32 skippable_frame_magic = 0x184D2A50;
+    static constexpr u32 skippable_frame_magic_mask = 0xFFFFFFF0;
+
+    static constexpr size_t max_block_size = 128 * KiB;
+
+    // RFC 8878 only requires decoders to support windows of up to 8 MiB; this is what the reference implementation
+    // accepts by default.
+    static constexpr u64 max_window_size = 128 * MiB;
+
+    static ErrorOr<NonnullOwnPtr<ZstdDecompressor>> create(MaybeOwned<Stream>);
+    static ErrorOr<ByteBuffer> decompress_all(ReadonlyBytes);
+
+    static bool is_likely_compressed(ReadonlyBytes bytes);
+
+    virtual ErrorOr<Bytes> read_some(Bytes) override;
+    virtual ErrorOr<size_t> write_some(ReadonlyBytes) override;
+    virtual bool is_eof() const override;
+    virtual bool is_open() const override;
+    virtual void close() override;
+
+private:
+    enum class State {
+        FrameHeader,
+        Block,
+        FrameEnd,
+    };
+
+    struct FrameHeader {
+        u64 window_size { 0 };
+        Optional<u64> content_size;
+        bool has_checksum { false };
+    };
+
+    // The checksum of a frame is the lower half of its XXH64 digest, with a seed of 0.
+    class XXHash64 {
+    public:
+        void update(ReadonlyBytes);
+        u64 digest() const;
+
+    private:
+        u64 m_accumulators[4] { 0x60ea27eeadc0b5d6, 0xc2b2ae3d27d4eb4f, 0, 0x61c8864e7a143579 };
+        u8 m_buffer[32];
+        size_t m_buffer_size { 0 };
+        u64 m_total_size { 0 };
+    };
+
+    explicit ZstdDecompressor(MaybeOwned<Stream>);
+
+    ErrorOr<bool> read_frame_header();
+    ErrorOr<void> read_block();
+    ErrorOr<void> read_frame_end();
+
+    ErrorOr<void> decode_compressed_block(ReadonlyBytes);
+    ErrorOr<size_t> decode_literals_section(ReadonlyBytes, ReadonlyBytes& literals);
+    ErrorOr<size_t> read_huffman_table(ReadonlyBytes);
+    ErrorOr<void> decode_sequences_section(ReadonlyBytes, ReadonlyBytes literals);
+
+    ErrorOr<void> write_output(ReadonlyBytes);
+    ErrorOr<void> copy_match(size_t offset, size_t length);
+
+    MaybeOwned<Stream> m_stream;
+    State m_state { State::FrameHeader };
+
+    FrameHeader m_frame_header;
+    u64 m_frame_output_size { 0 };
+    u64 m_block_output_size { 0 };
+    XXHash64 m_checksum;
+
+    Optional<CircularBuffer> m_window;
+    ByteBuffer m_block;
+
+    ByteBuffer m_literals_buffer;
+    u32 m_repeated_offsets[3] { 1, 4, 8 };
+    Optional<Zstd::HuffmanTable> m_huffman_table;
+    Optional<Zstd::FSETable> m_literal_length_table;
+    Optional<Zstd::FSETable> m_offset_table;
+    Optional<Zstd::FSETable> m_match_length_table;
+};
+
+}
@@ -4,7 +4,8 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
-#include <AK/BinaryHeap.h>
+#include <AK/AnyOf.h>
+#include <AK/IntegralMath.h>
 #include <AK/Singleton.h>
 #include <AK/TemporaryChange.h>
 #include <AK/Time.h>
@@ -16,6 +17,7 @@
 #include <LibCore/Socket.h>
 #include <LibCore/System.h>
 #include <LibCore/ThreadEventQueue.h>
+#include <LibCore/TimerWheel.h>
 #include <pthread.h>
 #include <sys/select.h>
 #include <unistd.h>
@@ -31,6 +33,36 @@ static pthread_rwlock_t s_thread_data_lock_impl;
 static pthread_rwlock_t* s_thread_data_lock = nullptr;
 thread_local pthread_t s_thread_id;
 
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+u32 notification_type_to_epoll_events(NotificationType type)
+{
+    u32 events = 0;
+    if (has_flag(type, NotificationType::Read))
+        events |= EPOLLIN;
+    if (has_flag(type, NotificationType::Write))
+        events |= EPOLLOUT;
+    return events;
+}
+
+NotificationType epoll_events_to_notification_type(u32 events)
+{
+    NotificationType type = NotificationType::None;
+    if (events & EPOLLIN)
+        type |= NotificationType::Read;
+    if (events & EPOLLOUT)
+        type |= NotificationType::Write;
+    if (events & EPOLLHUP)
+        type |= NotificationType::HangUp;
+    if (events & EPOLLERR)
+        type |= NotificationType::Error;
+    return type;
+}
+#else
+bool has_flag(int value, int flag)
+{
+    return (value & flag) == flag;
+}
+
 short notification_type_to_poll_events(NotificationType type)
 {
     short events = 0;
@@ -41,20 +73,31 @@ short notification_type_to_poll_events(NotificationType type)
     return events;
 }
 
-bool has_flag(int value, int flag)
+NotificationType poll_events_to_notification_type(short revents)
 {
-    return (value & flag) == flag;
+    NotificationType type = NotificationType::None;
+    if (has_flag(revents, POLLIN))
+        type |= NotificationType::Read;
+    if (has_flag(revents, POLLOUT))
+        type |= NotificationType::Write;
+    if (has_flag(revents, POLLHUP))
+        type |= NotificationType::HangUp;
+    if (has_flag(revents, POLLERR))
+        type |= NotificationType::Error;
+    return type;
 }
+#endif
 
-class EventLoopTimeout {
+class EventLoopTimeout : public TimerWheel::Entry {
 public:
-    static constexpr ssize_t INVALID_INDEX = NumericLimits<ssize_t>::max();
-
     EventLoopTimeout() { }
     virtual ~EventLoopTimeout() = default;
 
     virtual void fire(TimeoutSet& timeout_set, MonotonicTime time) = 0;
 
+    // How much later than its fire time the timeout may fire, so that it can fire together with others.
+    virtual Duration slack() const { return {}; }
+
     MonotonicTime fire_time() const { return m_fire_time; }
 
     void absolutize(Badge<TimeoutSet>, MonotonicTime current_time)
@@ -62,19 +105,11 @@ public:
         m_fire_time = current_time + m_duration;
     }
 
-    ssize_t& index(Badge<TimeoutSet>) { return m_index; }
-    void set_index(Badge<TimeoutSet>, ssize_t index) { m_index = index; }
-
-    bool is_scheduled() const { return m_index != INVALID_INDEX; }
-
 protected:
     union {
         Duration m_duration;
         MonotonicTime m_fire_time;
     };
-
-private:
-    ssize_t m_index = INVALID_INDEX;
 };
 
 class TimeoutSet {
@@ -83,88 +118,72 @@ public:
 
     Optional<MonotonicTime> next_timer_expiration()
     {
-        if (!m_heap.is_empty()) {
-            return m_heap.peek_min()->fire_time();
-        } else {
-            return {};
-        }
+        if (auto tick = m_wheel.next_expiration_tick(); tick.has_value())
+            return time_of_tick(*tick);
+        return {};
     }
 
     void absolutize_relative_timeouts(MonotonicTime current_time)
     {
-        for (auto timeout : m_scheduled_timeouts) {
-            timeout->absolutize({}, current_time);
-            m_heap.insert(timeout);
+        while (auto* timeout = m_scheduled_timeouts.take_first()) {
+            auto& event_loop_timeout = static_cast<EventLoopTimeout&>(*timeout);
+            event_loop_timeout.absolutize({}, current_time);
+            schedule_absolute(&event_loop_timeout);
         }
-        m_scheduled_timeouts.clear();
     }
 
     size_t fire_expired(MonotonicTime current_time)
     {
+        TimerWheel::EntryList expired;
+        m_wheel.advance_to(max<i64>(0, (current_time - m_origin).to_truncated_milliseconds()), expired);
+
+        // NOTE: Firing a timeout may unschedule any of the others, which also takes them off this list.
         size_t fired_count = 0;
-        while (!m_heap.is_empty()) {
-            auto& timeout = *m_heap.peek_min();
-
-            if (timeout.fire_time() <= current_time) {
-                ++fired_count;
-                m_heap.pop_min();
-                timeout.set_index({}, EventLoopTimeout::INVALID_INDEX);
-                timeout.fire(*this, current_time);
-            } else {
-                break;
-            }
+        while (auto* timeout = expired.take_first()) {
+            ++fired_count;
+            static_cast<EventLoopTimeout&>(*timeout).fire(*this, current_time);
         }
         return fired_count;
     }
 
     void schedule_relative(EventLoopTimeout* timeout)
     {
-        timeout->set_index({}, -1 - static_cast<ssize_t>(m_scheduled_timeouts.size()));
-        m_scheduled_timeouts.append(timeout);
+        m_scheduled_timeouts.append(*timeout);
     }
 
     void schedule_absolute(EventLoopTimeout* timeout)
     {
-        m_heap.insert(timeout);
+        // NOTE: A timeout never fires before its time, so the millisecond it is in has to have passed completely.
+        auto tick = static_cast<u64>(max<i64>(0, (timeout->fire_time() - m_origin).to_milliseconds()));
+
+        // Timeouts that don't need to be precise are moved to a multiple of a power of two milliseconds, so that ones
+        // with nearly the same fire time fire together, and we wake up only once for all of them.
+        if (auto slack = timeout->slack().to_truncated_milliseconds(); slack > 1) {
+            auto granularity = 1ull << AK::log2(static_cast<u64>(slack));
+            tick = (tick + granularity - 1) & ~(granularity - 1);
+        }
+        m_wheel.schedule(*timeout, tick);
     }
 
     void unschedule(EventLoopTimeout* timeout)
     {
-        if (timeout->index({}) < 0) {
-            size_t i = -1 - timeout->index({});
-            size_t j = m_scheduled_timeouts.size() - 1;
-            VERIFY(m_scheduled_timeouts[i] == timeout);
-            swap(m_scheduled_timeouts[i], m_scheduled_timeouts[j]);
-            swap(m_scheduled_timeouts[i]->index({}), m_scheduled_timeouts[j]->index({}));
-            (void)m_scheduled_timeouts.take_last();
-        } else {
-            m_heap.pop(timeout->index({}));
-        }
-        timeout->set_index({}, EventLoopTimeout::INVALID_INDEX);
+        m_wheel.unschedule(*timeout);
     }
 
     void clear()
     {
-        for (auto* timeout : m_heap.nodes_in_arbitrary_order())
-            timeout->set_index({}, EventLoopTimeout::INVALID_INDEX);
-        m_heap.clear();
-        for (auto* timeout : m_scheduled_timeouts)
-            timeout->set_index({}, EventLoopTimeout::INVALID_INDEX);
+        m_wheel.clear();
         m_scheduled_timeouts.clear();
     }
 
 private:
-    IntrusiveBinaryHeap<
-        EventLoopTimeout*,
-        decltype([](EventLoopTimeout* a, EventLoopTimeout* b) {
-            return a->fire_time() < b->fire_time();
-        }),
-        decltype([](EventLoopTimeout* timeout, size_t index) {
-            timeout->set_index({}, static_cast<ssize_t>(index));
-        }),
-        8>
-        m_heap;
-    Vector<EventLoopTimeout*, 8> m_scheduled_timeouts;
+    MonotonicTime time_of_tick(u64 tick) const { return m_origin + Duration::from_milliseconds(static_cast<i64>(tick)); }
+
+    // The timeouts are kept in a wheel of millisecond ticks since the set was created.
+    MonotonicTime m_origin { MonotonicTime::now_coarse() };
+    TimerWheel m_wheel;
+    // Timeouts that are relative to the start of the next iteration of the event loop, which is when they are added to the wheel.
+    TimerWheel::EntryList m_scheduled_timeouts;
 };
 
 class EventLoopTimer final : public EventLoopTimeout {
@@ -190,9 +209,9 @@ public:
                 timeout_set.schedule_absolute(this);
             } else {
                 // NOTE: Unfortunately we need to treat timeouts with the zero interval in a
-                //       special way. TimeoutSet::schedule_absolute for them will result in an
-                //       infinite loop. TimeoutSet::schedule_relative, on the other hand, will do a
-                //       correct thing of scheduling them for the next iteration of the loop.
+                //       special way. TimeoutSet::schedule_absolute would only fire them once the
+                //       current millisecond has passed. TimeoutSet::schedule_relative, on the other
+                //       hand, will do a correct thing of scheduling them for the next iteration of the loop.
                 m_duration = {};
                 timeout_set.schedule_relative(this);
             }
@@ -207,6 +226,12 @@ public:
             ThreadEventQueue::current().post_event(*strong_owner, make<TimerEvent>());
     }
 
+    virtual Duration slack() const override
+    {
+        // NOTE: This is little enough not to be noticed, but lets timers with similar intervals share wakeups.
+        return min(Duration::from_milliseconds(interval.to_milliseconds() / 32), Duration::from_milliseconds(16));
+    }
+
     Duration interval;
     bool should_reload { false };
     TimerShouldFireWhenNotVisible fire_when_not_visible { TimerShouldFireWhenNotVisible::No };
@@ -251,9 +276,46 @@ struct ThreadData {
     ThreadData()
     {
         pid = getpid();
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+        initialize_epoll();
+#endif
         initialize_wake_pipe();
     }
 
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+    void initialize_epoll()
+    {
+        // NOTE: After a fork, the inherited epoll file descriptor still refers to the interest list of the parent.
+        if (epoll_fd != -1)
+            close(epoll_fd);
+        epoll_fd = MUST(Core::System::epoll_create1(EPOLL_CLOEXEC));
+    }
+
+    // Tells the kernel what the notifiers on the given file descriptor are interested in altogether.
+    void update_epoll_interest(int fd, int op)
+    {
+        auto it = notifiers_by_fd.find(fd);
+        if (it == notifiers_by_fd.end()) {
+            // The file descriptor may already have been closed, which removed it from the interest list as well.
+            (void)Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+            return;
+        }
+
+        epoll_event event { .events = 0, .data = { .fd = fd } };
+        for (auto* notifier : it->value)
+            event.events |= notification_type_to_epoll_events(notifier->type());
+
+        auto result = Core::System::epoll_ctl(epoll_fd, op, fd, &event);
+        // The kernel may disagree about the file descriptor being on the interest list if it was closed and reused.
+        if (result.is_error() && result.error().code() == EEXIST)
+            result = Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &event);
+        else if (result.is_error() && result.error().code() == ENOENT)
+            result = Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+        if (result.is_error())
+            dbgln("EventLoopImplementationUnix: Unable to watch fd {}: {}", fd, result.error());
+    }
+#endif
+
     void initialize_wake_pipe()
     {
         if (wake_pipe_fds[0] != -1)
@@ -264,17 +326,29 @@ struct ThreadData {
         wake_pipe_fds = MUST(Core::System::pipe2(O_CLOEXEC));
 
         // The wake pipe informs us of POSIX signals as well as manual calls to wake()
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+        epoll_event event { .events = EPOLLIN, .data = { .fd = wake_pipe_fds[0] } };
+        MUST(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_pipe_fds[0], &event));
+#else
         VERIFY(poll_fds.size() == 0);
         poll_fds.append({ .fd = wake_pipe_fds[0], .events = POLLIN, .revents = 0 });
         notifier_by_index.append(nullptr);
+#endif
     }
 
     // Each thread has its own timers, notifiers and a wake pipe.
     TimeoutSet timeouts;
 
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+    // The interest list is kept by the kernel, so waiting for events doesn't have to pass every watched file descriptor.
+    int epoll_fd { -1 };
+    // Several notifiers may watch the same file descriptor, which can only be on the interest list once.
+    HashMap<int, Vector<Notifier*, 1>> notifiers_by_fd;
+#else
     Vector<pollfd> poll_fds;
     HashMap<Notifier*, size_t> notifier_by_ptr;
     Vector<Notifier*> notifier_by_index;
+#endif
 
     // The wake pipe is used to notify another event loop that someone has called wake(), or a signal has been received.
     // wake() writes 0i32 into the pipe, signals write the signal number (guaranteed non-zero).
@@ -366,7 +440,12 @@ retry:
 
 try_select_again:
     // select() and wait for file system events, calls to wake(), POSIX signals, or timer expirations.
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+    Array<epoll_event, 64> epoll_events;
+    ErrorOr<int> error_or_marked_fd_count = System::epoll_wait(thread_data.epoll_fd, epoll_events.span(), should_wait_forever ? -1 : timeout);
+#else
     ErrorOr<int> error_or_marked_fd_count = System::poll(thread_data.poll_fds, should_wait_forever ? -1 : timeout);
+#endif
     auto time_after_poll = MonotonicTime::now_coarse();
     // Because POSIX, we might spuriously return from select() with EINTR; just select again.
     if (error_or_marked_fd_count.is_error()) {
@@ -376,9 +455,18 @@ try_select_again:
         VERIFY_NOT_REACHED();
     }
 
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+    auto marked_epoll_events = epoll_events.span().trim(error_or_marked_fd_count.value());
+    bool wake_pipe_is_readable = any_of(marked_epoll_events, [&](auto const& event) {
+        return event.data.fd == thread_data.wake_pipe_fds[0] && (event.events & EPOLLIN);
+    });
+#else
+    bool wake_pipe_is_readable = has_flag(thread_data.poll_fds[0].revents, POLLIN);
+#endif
+
     // We woke up due to a call to wake() or a POSIX signal.
     // Handle signals and see whether we need to handle events as well.
-    if (has_flag(thread_data.poll_fds[0].revents, POLLIN)) {
+    if (wake_pipe_is_readable) {
         int wake_events[8];
         ssize_t nread;
         // We might receive another signal while read()ing here. The signal will go to the handle_signal properly,
@@ -407,26 +495,32 @@ try_select_again:
             goto retry;
     }
 
+    // Handle file system notifiers by making them normal events.
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+    for (auto const& event : marked_epoll_events) {
+        if (event.data.fd == thread_data.wake_pipe_fds[0])
+            continue;
+        auto it = thread_data.notifiers_by_fd.find(event.data.fd);
+        if (it == thread_data.notifiers_by_fd.end())
+            continue;
+
+        auto type = epoll_events_to_notification_type(event.events);
+        for (auto* notifier : it->value) {
+            auto notifier_type = type & notifier->type();
+            if (notifier_type != NotificationType::None)
+                ThreadEventQueue::current().post_event(*notifier, make<NotifierActivationEvent>(notifier->fd(), notifier_type));
+        }
+    }
+#else
     if (error_or_marked_fd_count.value() != 0) {
-        // Handle file system notifiers by making them normal events.
         for (size_t i = 1; i < thread_data.poll_fds.size(); ++i) {
-            auto& revents = thread_data.poll_fds[i].revents;
             auto& notifier = *thread_data.notifier_by_index[i];
-
-            NotificationType type = NotificationType::None;
-            if (has_flag(revents, POLLIN))
-                type |= NotificationType::Read;
-            if (has_flag(revents, POLLOUT))
-                type |= NotificationType::Write;
-            if (has_flag(revents, POLLHUP))
-                type |= NotificationType::HangUp;
-            if (has_flag(revents, POLLERR))
-                type |= NotificationType::Error;
-            type &= notifier.type();
+            auto type = poll_events_to_notification_type(thread_data.poll_fds[i].revents) & notifier.type();
             if (type != NotificationType::None)
                 ThreadEventQueue::current().post_event(notifier, make<NotifierActivationEvent>(notifier.fd(), type));
         }
     }
+#endif
 
     // Handle expired timers.
     thread_data.timeouts.fire_expired(time_after_poll);
@@ -503,9 +597,14 @@ void EventLoopImplementationUnix::notify_forked_and_in_child()
 {
     auto& thread_data = ThreadData::the();
     thread_data.timeouts.clear();
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+    thread_data.notifiers_by_fd.clear();
+    thread_data.initialize_epoll();
+#else
     thread_data.poll_fds.clear();
     thread_data.notifier_by_ptr.clear();
     thread_data.notifier_by_index.clear();
+#endif
     thread_data.initialize_wake_pipe();
     if (auto* info = signals_info<false>()) {
         info->signal_handlers.clear();
@@ -658,6 +757,11 @@ void EventLoopManagerUnix::register_notifier(Notifier& notifier)
 {
     auto& thread_data = ThreadData::the();
 
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+    auto& notifiers = thread_data.notifiers_by_fd.ensure(notifier.fd());
+    notifiers.append(&notifier);
+    thread_data.update_epoll_interest(notifier.fd(), notifiers.size() == 1 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD);
+#else
     thread_data.notifier_by_ptr.set(&notifier, thread_data.poll_fds.size());
     thread_data.notifier_by_index.append(&notifier);
     thread_data.poll_fds.append({
@@ -665,6 +769,7 @@ void EventLoopManagerUnix::register_notifier(Notifier& notifier)
         .events = notification_type_to_poll_events(notifier.type()),
         .revents = 0,
     });
+#endif
 
     notifier.set_owner_thread(s_thread_id);
 }
@@ -673,6 +778,14 @@ void EventLoopManagerUnix::unregister_notifier(Notifier& notifier)
 {
     auto& thread_data = ThreadData::for_thread(notifier.owner_thread());
 
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+    auto it = thread_data.notifiers_by_fd.find(notifier.fd());
+    VERIFY(it != thread_data.notifiers_by_fd.end());
+    VERIFY(it->value.remove_first_matching([&](auto* other) { return other == &notifier; }));
+    if (it->value.is_empty())
+        thread_data.notifiers_by_fd.remove(it);
+    thread_data.update_epoll_interest(notifier.fd(), EPOLL_CTL_MOD);
+#else
     auto it = thread_data.notifier_by_ptr.find(&notifier);
     VERIFY(it != thread_data.notifier_by_ptr.end());
 
@@ -686,6 +799,7 @@ void EventLoopManagerUnix::unregister_notifier(Notifier& notifier)
     }
     thread_data.poll_fds.take_last();
     thread_data.notifier_by_index.take_last();
+#endif
 }
 
 void EventLoopManagerUnix::did_post_event()
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/ScopeGuard.h>
+#include <LibCore/IORing.h>
+#include <LibCore/System.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+
+namespace Core {
+
+ErrorOr<NonnullOwnPtr<IORing>> IORing::create(u32 entries)
+{
+    auto fd = TRY(System::io_ring_create(entries, O_CLOEXEC));
+    ArmedScopeGuard close_fd = [fd] { (void)System::close(fd); };
+
+    // The size of the mapping is only known once we've looked at the header.
+    auto* header = static_cast<IORingHeader*>(TRY(System::mmap(nullptr, PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)));
+    auto size = header->size;
+    TRY(System::munmap(header, PAGE_SIZE));
+    auto* mapping = static_cast<u8*>(TRY(System::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0, 0, "IORing"sv)));
+
+    close_fd.disarm();
+    return adopt_nonnull_own_or_enomem(new (nothrow) IORing(fd, mapping));
+}
+
+IORing::IORing(int fd, u8* mapping)
+    : m_fd(fd)
+    , m_mapping(mapping)
+    , m_header(reinterpret_cast<IORingHeader*>(mapping))
+    , m_submissions(reinterpret_cast<IORingSubmission*>(mapping + m_header->submissions_offset))
+    , m_completions(reinterpret_cast<IORingCompletion*>(mapping + m_header->completions_offset))
+{
+    m_notifier = Notifier::construct(m_fd, Notifier::Type::Read);
+    m_notifier->on_activation = [this] {
+        process_completions();
+    };
+}
+
+IORing::~IORing()
+{
+    m_notifier->close();
+    (void)System::munmap(m_mapping, m_header->size);
+    (void)System::close(m_fd);
+}
+
+ErrorOr<void> IORing::read(int fd, Bytes buffer, Optional<u64> offset, Callback callback)
+{
+    return queue({ IORingOpcode::Read, {}, fd, offset.has_value() ? static_cast<i64>(*offset) : -1, reinterpret_cast<FlatPtr>(buffer.data()), buffer.size(), 0 }, move(callback));
+}
+
+ErrorOr<void> IORing::write(int fd, ReadonlyBytes buffer, Optional<u64> offset, Callback callback)
+{
+    return queue({ IORingOpcode::Write, {}, fd, offset.has_value() ? static_cast<i64>(*offset) : -1, reinterpret_cast<FlatPtr>(buffer.data()), buffer.size(), 0 }, move(callback));
+}
+
+ErrorOr<void> IORing::fsync(int fd, Callback callback)
+{
+    return queue({ IORingOpcode::Fsync, {}, fd, -1, 0, 0, 0 }, move(callback));
+}
+
+ErrorOr<void> IORing::close(int fd, Callback callback)
+{
+    return queue({ IORingOpcode::Close, {}, fd, -1, 0, 0, 0 }, move(callback));
+}
+
+u32 IORing::queued_count() const
+{
+    return m_header->submission_tail - AK::atomic_load(&m_header->submission_head, AK::memory_order_acquire);
+}
+
+ErrorOr<void> IORing::queue(IORingSubmission submission, Callback callback)
+{
+    // If the submission ring is full, make room by handing what we have to the kernel first.
+    if (queued_count() > m_header->submission_mask)
+        TRY(submit());
+
+    submission.user_data = m_next_user_data++;
+    TRY(m_callbacks.try_set(submission.user_data, move(callback)));
+
+    auto tail = m_header->submission_tail;
+    m_submissions[tail & m_header->submission_mask] = submission;
+    AK::atomic_store(&m_header->submission_tail, tail + 1, AK::memory_order_release);
+    return {};
+}
+
+ErrorOr<void> IORing::submit()
+{
+    while (auto count = queued_count()) {
+        auto submitted = TRY(System::io_ring_enter(m_fd, count));
+        // The kernel stops taking submissions while the completion ring is full, so empty it out and try again.
+        if (submitted < count && process_completions() == 0 && submitted == 0)
+            return Error::from_errno(EBUSY);
+    }
+    return {};
+}
+
+size_t IORing::process_completions()
+{
+    size_t processed = 0;
+    // NOTE: Callbacks may end up processing completions themselves, so always start over from the shared head.
+    while (true) {
+        auto head = m_header->completion_head;
+        if (head == AK::atomic_load(&m_header->completion_tail, AK::memory_order_acquire))
+            break;
+        auto completion = m_completions[head & m_header->completion_mask];
+        AK::atomic_store(&m_header->completion_head, head + 1, AK::memory_order_release);
+        ++processed;
+
+        auto callback = m_callbacks.take(completion.user_data);
+        if (!callback.has_value() || !*callback)
+            continue;
+        if (completion.result < 0)
+            (*callback)(Error::from_errno(static_cast<int>(-completion.result)));
+        else
+            (*callback)(static_cast<size_t>(completion.result));
+    }
+    return processed;
+}
+
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <Kernel/API/IORing.h>
+#include <LibCore/Notifier.h>
+
+namespace Core {
+
+// Batches file and socket I/O through a ring shared with the kernel, so that any number of
+// queued operations only costs a single syscall. Completions are picked up by the event loop
+// of the thread that created the ring, or explicitly with process_completions().
+class IORing {
+    AK_MAKE_NONCOPYABLE(IORing);
+    AK_MAKE_NONMOVABLE(IORing);
+
+public:
+    using Callback = Function<void(ErrorOr<size_t>)>;
+
+    static ErrorOr<NonnullOwnPtr<IORing>> create(u32 entries = 256);
+    ~IORing();
+
+    // These only queue up an operation, it is started by the next submit().
+    // The memory of the buffers has to stay around until the callback is called.
+    ErrorOr<void> read(int fd, Bytes, Optional<u64> offset, Callback);
+    ErrorOr<void> write(int fd, ReadonlyBytes, Optional<u64> offset, Callback);
+    ErrorOr<void> fsync(int fd, Callback);
+    ErrorOr<void> close(int fd, Callback);
+
+    ErrorOr<void> submit();
+
+    // Calls the callbacks of all completed operations, returns how many there were.
+    size_t process_completions();
+
+    size_t pending_count() const { return m_callbacks.size(); }
+
+private:
+    IORing(int fd, u8* mapping);
+
+    ErrorOr<void> queue(IORingSubmission, Callback);
+    u32 queued_count() const;
+
+    int m_fd { -1 };
+    u8* m_mapping { nullptr };
+    IORingHeader* m_header { nullptr };
+    IORingSubmission* m_submissions { nullptr };
+    IORingCompletion* m_completions { nullptr };
+    u64 m_next_user_data { 0 };
+    HashMap<u64, Callback> m_callbacks;
+    RefPtr<Notifier> m_notifier;
+};
+
+}
@@ -8,6 +8,7 @@
 #include <AK/JsonArray.h>
 #include <AK/JsonObject.h>
 #include <AK/JsonValue.h>
+#include <Kernel/API/ProcessStatistics.h>
 #include <LibCore/File.h>
 #include <LibCore/ProcessStatisticsReader.h>
 #include <pwd.h>
@@ -16,13 +17,152 @@ namespace Core {
 
 HashMap<uid_t, ByteString> ProcessStatisticsReader::s_usernames;
 
-ErrorOr<AllProcessesStatistics> ProcessStatisticsReader::get_all(SeekableStream& proc_all_file, bool include_usernames)
+namespace {
+
+class BinaryRecordReader {
+public:
+    explicit BinaryRecordReader(ReadonlyBytes data)
+        : m_data(data)
+    {
+    }
+
+    bool is_eof() const { return m_data.is_empty(); }
+
+    template<typename T>
+    ErrorOr<T> peek() const
+    {
+        if (m_data.size() < sizeof(T))
+            return Error::from_string_literal("Truncated process statistics");
+        T value;
+        __builtin_memcpy(&value, m_data.data(), sizeof(T));
+        return value;
+    }
+
+    template<typename T>
+    ErrorOr<T> read()
+    {
+        auto value = TRY(peek<T>());
+        m_data = m_data.slice(sizeof(T));
+        return value;
+    }
+
+    ErrorOr<ByteString> read_string()
+    {
+        auto length = TRY(read<u16>());
+        if (m_data.size() < length)
+            return Error::from_string_literal("Truncated process statistics");
+        ByteString string { StringView { m_data.trim(length) } };
+        m_data = m_data.slice(length);
+        return string;
+    }
+
+private:
+    ReadonlyBytes m_data;
+};
+
+}
+
+static bool is_binary_process_statistics(ReadonlyBytes data)
 {
-    TRY(proc_all_file.seek(0, SeekMode::SetPosition));
+    if (data.size() < sizeof(ProcessStatisticsHeader))
+        return false;
+    ProcessStatisticsHeader header;
+    __builtin_memcpy(&header, data.data(), sizeof(header));
+    return header.magic == process_statistics_magic;
+}
+
+static ErrorOr<AllProcessesStatistics> parse_binary_process_statistics(ReadonlyBytes data)
+{
+    BinaryRecordReader reader { data };
+    auto header = TRY(reader.read<ProcessStatisticsHeader>());
+    if (header.version != process_statistics_version)
+        return Error::from_string_literal("Unsupported process statistics version");
 
     AllProcessesStatistics all_processes_statistics;
+    while (!reader.is_eof()) {
+        switch (TRY(reader.peek<ProcessStatisticsRecordType>())) {
+        case ProcessStatisticsRecordType::Process: {
+            auto record = TRY(reader.read<ProcessStatisticsProcessRecord>());
+            Core::ProcessStatistics process;
+            process.pid = record.pid;
+            process.pgid = record.pgid;
+            process.pgp = record.pgp;
+            process.sid = record.sid;
+            process.uid = record.uid;
+            process.gid = record.gid;
+            process.ppid = record.ppid;
+            process.kernel = record.kernel;
+            process.creation_time = UnixDateTime::from_nanoseconds_since_epoch(record.creation_time);
+            process.amount_virtual = record.amount_virtual;
+            process.amount_resident = record.amount_resident;
+            process.amount_shared = record.amount_shared;
+            process.amount_dirty_private = record.amount_dirty_private;
+            process.amount_clean_inode = record.amount_clean_inode;
+            process.amount_purgeable_volatile = record.amount_purgeable_volatile;
+            process.amount_purgeable_nonvolatile = record.amount_purgeable_nonvolatile;
+            process.name = TRY(reader.read_string());
+            process.executable = TRY(reader.read_string());
+            process.tty = TRY(reader.read_string());
+            process.pledge = TRY(reader.read_string());
+            process.veil = TRY(reader.read_string());
+            TRY(all_processes_statistics.processes.try_append(move(process)));
+            break;
+        }
+        case ProcessStatisticsRecordType::Thread: {
+            if (all_processes_statistics.processes.is_empty())
+                return Error::from_string_literal("Thread record without a process");
+            auto record = TRY(reader.read<ProcessStatisticsThreadRecord>());
+            Core::ThreadStatistics thread;
+            thread.tid = record.tid;
+            thread.times_scheduled = record.times_scheduled;
+            thread.time_user = record.time_user;
+            thread.time_kernel = record.time_kernel;
+            thread.syscall_count = record.syscall_count;
+            thread.inode_faults = record.inode_faults;
+            thread.zero_faults = record.zero_faults;
+            thread.cow_faults = record.cow_faults;
+            thread.unix_socket_read_bytes = record.unix_socket_read_bytes;
+            thread.unix_socket_write_bytes = record.unix_socket_write_bytes;
+            thread.ipv4_socket_read_bytes = record.ipv4_socket_read_bytes;
+            thread.ipv4_socket_write_bytes = record.ipv4_socket_write_bytes;
+            thread.file_read_bytes = record.file_read_bytes;
+            thread.file_write_bytes = record.file_write_bytes;
+            thread.cpu = record.cpu;
+            thread.priority = record.priority;
+            thread.name = TRY(reader.read_string());
+            thread.state = TRY(reader.read_string());
+            TRY(all_processes_statistics.processes.last().threads.try_append(move(thread)));
+            break;
+        }
+        case ProcessStatisticsRecordType::Totals: {
+            auto record = TRY(reader.read<ProcessStatisticsTotalsRecord>());
+            all_processes_statistics.total_time_scheduled = record.total_time;
+            all_processes_statistics.total_time_scheduled_kernel = record.total_time_kernel;
+            break;
+        }
+        default:
+            return Error::from_string_literal("Unknown process statistics record");
+        }
+    }
+    return all_processes_statistics;
+}
+
+ErrorOr<AllProcessesStatistics> ProcessStatisticsReader::get_all(SeekableStream& proc_all_file, bool include_usernames)
+{
+    TRY(proc_all_file.seek(0, SeekMode::SetPosition));
 
     auto file_contents = TRY(proc_all_file.read_until_eof());
+
+    if (is_binary_process_statistics(file_contents)) {
+        auto all_processes_statistics = TRY(parse_binary_process_statistics(file_contents));
+        if (include_usernames) {
+            for (auto& process : all_processes_statistics.processes)
+                process.username = username_from_uid(process.uid);
+        }
+        return all_processes_statistics;
+    }
+
+    AllProcessesStatistics all_processes_statistics;
     auto json_obj = TRY(JsonValue::from_string(file_contents)).as_object();
     json_obj.get_array("processes"sv)->for_each([&](auto& value) {
         JsonObject const& process_object = value.as_object();
@@ -89,9 +229,17 @@ ErrorOr<AllProcessesStatistics> ProcessStatisticsReader::get_all(SeekableStream&
     return all_processes_statistics;
 }
 
+ErrorOr<NonnullOwnPtr<Core::File>> ProcessStatisticsReader::open_statistics_file()
+{
+    // Prefer the binary variant, but fall back to JSON for callers that only unveiled the latter.
+    if (auto binary_file = Core::File::open("/sys/kernel/process_statistics"sv, Core::File::OpenMode::Read); !binary_file.is_error())
+        return binary_file.release_value();
+    return Core::File::open("/sys/kernel/processes"sv, Core::File::OpenMode::Read);
+}
+
 ErrorOr<AllProcessesStatistics> ProcessStatisticsReader::get_all(bool include_usernames)
 {
-    auto proc_all_file = TRY(Core::File::open("/sys/kernel/processes"sv, Core::File::OpenMode::Read));
+    auto proc_all_file = TRY(open_statistics_file());
     return get_all(*proc_all_file, include_usernames);
 }
 
@@ -9,6 +9,7 @@
 #include <AK/ByteString.h>
 #include <AK/Time.h>
 #include <AK/Vector.h>
+#include <LibCore/Forward.h>
 #include <unistd.h>
 
 namespace Core {
@@ -76,6 +77,9 @@ public:
     static ErrorOr<AllProcessesStatistics> get_all(SeekableStream&, bool include_usernames = true);
     static ErrorOr<AllProcessesStatistics> get_all(bool include_usernames = true);
 
+    // Opens the kernel's process statistics, for callers that want to keep the file around and pass it to get_all() repeatedly.
+    static ErrorOr<NonnullOwnPtr<Core::File>> open_statistics_file();
+
 private:
     static ByteString username_from_uid(uid_t);
     static HashMap<uid_t, ByteString> s_usernames;
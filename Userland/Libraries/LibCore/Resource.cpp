@@ -96,6 +96,10 @@ ByteBuffer Resource::release_data() &&
 {
     VERIFY(!m_data.has<DirectoryTag>());
 
+    // NOTE: Someone else who loaded the same resource is still using the data.
+    if (ref_count() > 1)
+        return clone_data();
+
     if (m_data.has<NonnullOwnPtr<Core::MappedFile>>())
         return MUST(ByteBuffer::copy(m_data.get<NonnullOwnPtr<Core::MappedFile>>()->bytes()));
     return move(m_data).get<ByteBuffer>();
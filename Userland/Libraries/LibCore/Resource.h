@@ -14,13 +14,18 @@
 #include <AK/String.h>
 #include <AK/StringView.h>
 #include <AK/Variant.h>
+#include <AK/Weakable.h>
 #include <LibCore/File.h>
 #include <LibCore/MappedFile.h>
 
 namespace Core {
 
-class Resource : public RefCounted<Resource> {
+class Resource
+    : public RefCounted<Resource>
+    , public Weakable<Resource> {
 public:
+    // NOTE: Files are mapped into memory rather than read, and loading a file that is still loaded hands out the same
+    //       resource again (unless the file has changed since), so its data is only ever mapped once per thread.
     static ErrorOr<NonnullRefPtr<Resource>> load_from_filesystem(StringView);
     static ErrorOr<NonnullRefPtr<Resource>> load_from_uri(StringView);
 
@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/HashMap.h>
+#include <AK/WeakPtr.h>
 #include <LibCore/DirIterator.h>
 #include <LibCore/ResourceImplementation.h>
 #include <LibCore/ResourceImplementationFile.h>
@@ -40,7 +42,47 @@ NonnullRefPtr<Resource> ResourceImplementation::make_directory_resource(String f
     return adopt_ref(*new Resource(move(full_path), Resource::Scheme::Resource, Resource::DirectoryTag {}, modified_time));
 }
 
+// NOTE: The reference counts of resources aren't atomic, so every thread has its own resources.
+static thread_local HashMap<ByteString, WeakPtr<Resource>> s_loaded_files;
+
+static RefPtr<Resource> find_loaded_file(StringView uri)
+{
+    auto it = s_loaded_files.find(uri);
+    if (it == s_loaded_files.end())
+        return nullptr;
+
+    auto resource = it->value.strong_ref();
+    if (!resource) {
+        s_loaded_files.remove(it);
+        return nullptr;
+    }
+
+    // The file might have been replaced since we've mapped it.
+    auto st = System::stat(resource->filesystem_path());
+    if (st.is_error() || st.value().st_mtime != resource->modified_time() || static_cast<size_t>(st.value().st_size) != resource->data().size()) {
+        s_loaded_files.remove(it);
+        return nullptr;
+    }
+    return resource;
+}
+
 ErrorOr<NonnullRefPtr<Resource>> ResourceImplementation::load_from_uri(StringView uri)
+{
+    if (auto resource = find_loaded_file(uri))
+        return resource.release_nonnull();
+
+    auto resource = TRY(load_from_uri_uncached(uri));
+    if (resource->is_file()) {
+        // Forget about the files that nobody uses anymore every now and then.
+        static constexpr size_t loaded_files_to_keep_without_pruning = 256;
+        if (s_loaded_files.size() >= loaded_files_to_keep_without_pruning)
+            s_loaded_files.remove_all_matching([](auto&, auto& file) { return !file; });
+        TRY(s_loaded_files.try_set(uri, resource->make_weak_ptr()));
+    }
+    return resource;
+}
+
+ErrorOr<NonnullRefPtr<Resource>> ResourceImplementation::load_from_uri_uncached(StringView uri)
 {
     StringView const file_scheme = "file://"sv;
     StringView const resource_scheme = "resource://"sv;
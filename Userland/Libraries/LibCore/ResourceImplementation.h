@@ -24,6 +24,8 @@ public:
     static ResourceImplementation& the();
 
 protected:
+    ErrorOr<NonnullRefPtr<Resource>> load_from_uri_uncached(StringView);
+
     virtual ErrorOr<NonnullRefPtr<Resource>> load_from_resource_scheme_uri(StringView) = 0;
     virtual Vector<String> child_names_for_resource_scheme(Resource const&) = 0;
     virtual String filesystem_path_for_resource_scheme(String const&) = 0;
@@ -193,6 +193,13 @@ public:
     ErrorOr<void> set_blocking(bool enabled) override { return m_helper.set_blocking(enabled); }
     ErrorOr<void> set_close_on_exec(bool enabled) override { return m_helper.set_close_on_exec(enabled); }
 
+    Optional<int> fd() const
+    {
+        if (!is_open())
+            return {};
+        return m_helper.fd();
+    }
+
     virtual ~TCPSocket() override { close(); }
 
 private:
@@ -431,6 +438,9 @@ public:
 
     virtual size_t buffer_size() const override { return m_helper.buffer_size(); }
 
+    // NOTE: Only writes go straight through to the underlying socket, it may have been read from into our buffer already.
+    T& underlying_socket() { return m_helper.stream(); }
+
     virtual ~BufferedSocket() override = default;
 
 private:
@@ -34,6 +34,7 @@
 #    include <LibSystem/syscall.h>
 #    include <serenity.h>
 #    include <sys/ptrace.h>
+#    include <sys/sendfile.h>
 #    include <sys/sysmacros.h>
 #endif
 
@@ -238,6 +239,14 @@ ErrorOr<void> sendfd(int sockfd, int fd)
     return {};
 }
 
+ErrorOr<size_t> sendfile(int out_fd, int in_fd, off_t* offset, size_t count)
+{
+    auto rc = ::sendfile(out_fd, in_fd, offset, count);
+    if (rc < 0)
+        return Error::from_syscall("sendfile"sv, -errno);
+    return static_cast<size_t>(rc);
+}
+
 ErrorOr<int> recvfd(int sockfd, int options)
 {
     auto fd = ::recvfd(sockfd, options);
@@ -288,6 +297,18 @@ ErrorOr<void> remount(StringView target, int flags)
     HANDLE_SYSCALL_RETURN_VALUE("remount", rc, {});
 }
 
+ErrorOr<int> io_ring_create(u32 entries, int options)
+{
+    int rc = syscall(SC_io_ring_create, entries, options);
+    HANDLE_SYSCALL_RETURN_VALUE("io_ring_create", rc, rc);
+}
+
+ErrorOr<u32> io_ring_enter(int fd, u32 to_submit)
+{
+    int rc = syscall(SC_io_ring_enter, fd, to_submit);
+    HANDLE_SYSCALL_RETURN_VALUE("io_ring_enter", rc, static_cast<u32>(rc));
+}
+
 ErrorOr<void> mount(int source_fd, StringView target, StringView fs_type, int flags)
 {
     if (target.is_null() || fs_type.is_null())
@@ -1731,6 +1752,31 @@ ErrorOr<int> poll(Span<struct pollfd> poll_fds, int timeout)
     return { rc };
 }
 
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+ErrorOr<int> epoll_create1(int flags)
+{
+    auto const rc = ::epoll_create1(flags);
+    if (rc < 0)
+        return Error::from_syscall("epoll_create1"sv, -errno);
+    return { rc };
+}
+
+ErrorOr<void> epoll_ctl(int epoll_fd, int op, int fd, struct epoll_event* event)
+{
+    if (::epoll_ctl(epoll_fd, op, fd, event) < 0)
+        return Error::from_syscall("epoll_ctl"sv, -errno);
+    return {};
+}
+
+ErrorOr<int> epoll_wait(int epoll_fd, Span<struct epoll_event> events, int timeout)
+{
+    auto const rc = ::epoll_wait(epoll_fd, events.data(), events.size(), timeout);
+    if (rc < 0)
+        return Error::from_syscall("epoll_wait"sv, -errno);
+    return { rc };
+}
+#endif
+
 #ifdef AK_OS_SERENITY
 ErrorOr<void> posix_fallocate(int fd, off_t offset, off_t length)
 {
@@ -35,6 +35,10 @@
 #    include <Kernel/API/Jail.h>
 #endif
 
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+#    include <sys/epoll.h>
+#endif
+
 #if !defined(AK_OS_BSD_GENERIC) && !defined(AK_OS_ANDROID)
 #    include <shadow.h>
 #endif
@@ -56,6 +60,7 @@ ErrorOr<void> pledge(StringView promises, StringView execpromises = {});
 ErrorOr<void> unveil(StringView path, StringView permissions);
 ErrorOr<void> unveil_after_exec(StringView path, StringView permissions);
 ErrorOr<void> sendfd(int sockfd, int fd);
+ErrorOr<size_t> sendfile(int out_fd, int in_fd, off_t* offset, size_t count);
 ErrorOr<int> recvfd(int sockfd, int options);
 ErrorOr<void> ptrace_peekbuf(pid_t tid, void const* tracee_addr, Bytes destination_buf);
 ErrorOr<void> mount(int source_fd, StringView target, StringView fs_type, int flags);
@@ -63,6 +68,8 @@ ErrorOr<void> bindmount(int source_fd, StringView target, int flags);
 ErrorOr<int> fsopen(StringView fs_type, int flags);
 ErrorOr<void> fsmount(int mount_fd, int source_fd, StringView target_path);
 ErrorOr<void> remount(StringView target, int flags);
+ErrorOr<int> io_ring_create(u32 entries, int options);
+ErrorOr<u32> io_ring_enter(int fd, u32 to_submit);
 ErrorOr<void> umount(StringView mount_point);
 ErrorOr<long> ptrace(int request, pid_t tid, void* address, void* data);
 ErrorOr<void> disown(pid_t pid);
@@ -240,6 +247,12 @@ ErrorOr<void> access(StringView pathname, int mode, int flags = 0);
 ErrorOr<ByteString> readlink(StringView pathname);
 ErrorOr<int> poll(Span<struct pollfd>, int timeout);
 
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+ErrorOr<int> epoll_create1(int flags);
+ErrorOr<void> epoll_ctl(int epoll_fd, int op, int fd, struct epoll_event*);
+ErrorOr<int> epoll_wait(int epoll_fd, Span<struct epoll_event>, int timeout);
+#endif
+
 #ifdef AK_OS_SERENITY
 ErrorOr<void> create_block_device(StringView name, mode_t mode, unsigned major, unsigned minor);
 ErrorOr<void> create_char_device(StringView name, mode_t mode, unsigned major, unsigned minor);
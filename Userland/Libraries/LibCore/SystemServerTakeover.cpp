@@ -12,6 +12,7 @@ namespace Core {
 
 HashMap<ByteString, int> s_overtaken_sockets {};
 bool s_overtaken_sockets_parsed { false };
+bool s_overtaken_sockets_deferred { false };
 
 static void parse_sockets_from_system_server()
 {
@@ -30,11 +31,30 @@ static void parse_sockets_from_system_server()
         s_overtaken_sockets.set(params[0].to_byte_string(), params[1].to_number<int>().value());
     }
 
+    constexpr auto socket_takeover_deferred = "SOCKET_TAKEOVER_DEFERRED";
+    s_overtaken_sockets_deferred = getenv(socket_takeover_deferred) != nullptr;
+
     s_overtaken_sockets_parsed = true;
     // We wouldn't want our children to think we're passing
-    // them a socket either, so unset the env variable.
+    // them a socket either, so unset the env variables.
     unsetenv(socket_takeover);
+    unsetenv(socket_takeover_deferred);
+}
+
+#ifdef AK_OS_SERENITY
+static ErrorOr<int> receive_deferred_socket(int takeover_fd)
+{
+    // We were spawned ahead of time, and SystemServer hands us the actual socket once a client connects. The socket is
+    // followed by a single byte, which is what we are actually waiting for.
+    u8 wake_up = 0;
+    if (TRY(Core::System::recv(takeover_fd, &wake_up, sizeof(wake_up), 0)) == 0)
+        return Error::from_string_literal("SystemServer closed the socket takeover connection");
+
+    auto fd = TRY(Core::System::recvfd(takeover_fd, 0));
+    TRY(Core::System::close(takeover_fd));
+    return fd;
 }
+#endif
 
 ErrorOr<NonnullOwnPtr<Core::LocalSocket>> take_over_socket_from_system_server(ByteString const& socket_path)
 {
@@ -53,6 +73,13 @@ ErrorOr<NonnullOwnPtr<Core::LocalSocket>> take_over_socket_from_system_server(By
         fd = it->value;
     }
 
+#ifdef AK_OS_SERENITY
+    if (s_overtaken_sockets_deferred)
+        fd = TRY(receive_deferred_socket(fd));
+#else
+    VERIFY(!s_overtaken_sockets_deferred);
+#endif
+
     // Sanity check: it has to be a socket.
     auto stat = TRY(Core::System::fstat(fd));
 
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/MPMCQueue.h>
 #include <AK/Vector.h>
 #include <LibCore/DeferredInvocationContext.h>
 #include <LibCore/EventLoopImplementation.h>
@@ -12,6 +13,7 @@
 #include <LibCore/ThreadEventQueue.h>
 #include <LibThreading/Mutex.h>
 #include <errno.h>
+#include <sched.h>
 
 namespace Core {
 
@@ -33,8 +35,13 @@ struct ThreadEventQueue::Private {
         NonnullOwnPtr<Event> event;
     };
 
+    // Events are posted from any thread, but only the thread the queue belongs to takes them out.
+    MPMCQueue<QueuedEvent, 512> queued_events;
+
     Threading::Mutex mutex;
-    Vector<QueuedEvent, 128> queued_events;
+    // Once the lock-free queue is full, events are posted here instead, until the queue is drained again.
+    Vector<QueuedEvent> overflowed_events;
+    Atomic<bool> has_overflowed_events { false };
     Vector<NonnullRefPtr<Promise<NonnullRefPtr<EventReceiver>>>, 16> pending_promises;
     bool warned_promise_count { false };
 };
@@ -59,9 +66,12 @@ ThreadEventQueue::~ThreadEventQueue() = default;
 
 void ThreadEventQueue::post_event(Core::EventReceiver& receiver, NonnullOwnPtr<Core::Event> event)
 {
-    {
+    Private::QueuedEvent queued_event { receiver, move(event) };
+    // NOTE: Events that come after an overflowed event have to overflow as well, so they stay in order.
+    if (m_private->has_overflowed_events.load(AK::MemoryOrder::memory_order_acquire) || !m_private->queued_events.try_enqueue(move(queued_event))) {
         Threading::MutexLocker lock(m_private->mutex);
-        m_private->queued_events.empend(receiver, move(event));
+        m_private->overflowed_events.append(move(queued_event));
+        m_private->has_overflowed_events.store(true, AK::MemoryOrder::memory_order_release);
     }
     Core::EventLoopManager::the().did_post_event();
 }
@@ -83,10 +93,29 @@ void ThreadEventQueue::cancel_all_pending_jobs()
 
 size_t ThreadEventQueue::process()
 {
-    decltype(m_private->queued_events) events;
+    Vector<Private::QueuedEvent, 128> events;
+    while (true) {
+        auto queued_event = m_private->queued_events.try_dequeue();
+        if (!queued_event.has_value())
+            break;
+        events.append(queued_event.release_value());
+    }
     {
         Threading::MutexLocker locker(m_private->mutex);
-        events = move(m_private->queued_events);
+        if (m_private->has_overflowed_events.load(AK::MemoryOrder::memory_order_acquire)) {
+            // Everything in the queue was posted before the overflowed events, so it is taken out first. That includes
+            // events that another thread is still in the middle of enqueueing.
+            while (!m_private->queued_events.is_empty()) {
+                if (auto queued_event = m_private->queued_events.try_dequeue(); queued_event.has_value())
+                    events.append(queued_event.release_value());
+                else
+                    sched_yield();
+            }
+            for (auto& queued_event : m_private->overflowed_events)
+                events.append(move(queued_event));
+            m_private->overflowed_events.clear();
+            m_private->has_overflowed_events.store(false, AK::MemoryOrder::memory_order_release);
+        }
         m_private->pending_promises.remove_all_matching([](auto& job) { return job->is_resolved() || job->is_rejected(); });
     }
 
@@ -125,8 +154,7 @@ size_t ThreadEventQueue::process()
 
 bool ThreadEventQueue::has_pending_events() const
 {
-    Threading::MutexLocker locker(m_private->mutex);
-    return !m_private->queued_events.is_empty();
+    return !m_private->queued_events.is_empty() || m_private->has_overflowed_events.load(AK::MemoryOrder::memory_order_acquire);
 }
 
 }
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BuiltinWrappers.h>
+#include <AK/IntegralMath.h>
+#include <LibCore/TimerWheel.h>
+
+namespace Core {
+
+bool TimerWheel::is_empty() const
+{
+    for (auto const& level : m_levels) {
+        if (level.occupied_slots != 0)
+            return false;
+    }
+    return m_expired.is_empty() && m_far_future.is_empty();
+}
+
+u64 TimerWheel::slot_start(u64 current_tick, size_t level, size_t slot)
+{
+    // NOTE: The slots of a level cover the ticks that share the slot of the level above with the current one.
+    auto block_bits = bits_per_level * (level + 1);
+    auto block_start = (current_tick >> block_bits) << block_bits;
+    return block_start + (static_cast<u64>(slot) << (bits_per_level * level));
+}
+
+u64 TimerWheel::first_tick_beyond_levels(u64 current_tick)
+{
+    constexpr auto bits = bits_per_level * level_count;
+    return ((current_tick >> bits) + 1) << bits;
+}
+
+void TimerWheel::schedule(Entry& entry, u64 tick)
+{
+    VERIFY(!entry.is_scheduled());
+    entry.m_tick = tick;
+
+    if (tick <= m_current_tick) {
+        entry.m_level = expired_level;
+        m_expired.append(entry);
+        return;
+    }
+
+    // The lowest level whose slots still reach the tick is the one with the highest bit that differs from now.
+    auto level = AK::log2(tick ^ m_current_tick) / bits_per_level;
+    if (level >= level_count) {
+        entry.m_level = far_future_level;
+        m_far_future.append(entry);
+        return;
+    }
+
+    auto slot = (tick >> (bits_per_level * level)) & (slots_per_level - 1);
+    auto& wheel_level = m_levels[level];
+    auto slot_bit = 1ull << slot;
+    if (!(wheel_level.occupied_slots & slot_bit)) {
+        wheel_level.occupied_slots |= slot_bit;
+        wheel_level.earliest_ticks[slot] = tick;
+    } else {
+        wheel_level.earliest_ticks[slot] = min(wheel_level.earliest_ticks[slot], tick);
+    }
+
+    wheel_level.slots[slot].append(entry);
+    entry.m_level = level;
+    entry.m_slot = slot;
+}
+
+void TimerWheel::unschedule(Entry& entry)
+{
+    if (!entry.is_scheduled())
+        return;
+    entry.m_list_node.remove();
+    remove_from_slot_if_empty(entry);
+}
+
+void TimerWheel::remove_from_slot_if_empty(Entry const& entry)
+{
+    if (entry.m_level >= level_count)
+        return;
+    auto& level = m_levels[entry.m_level];
+    if (level.slots[entry.m_slot].is_empty())
+        level.occupied_slots &= ~(1ull << entry.m_slot);
+}
+
+Optional<TimerWheel::NextSlot> TimerWheel::next_slot_to_process() const
+{
+    Optional<NextSlot> next;
+    for (size_t i = 0; i < level_count; ++i) {
+        auto const& level = m_levels[i];
+        if (level.occupied_slots == 0)
+            continue;
+        auto slot = count_trailing_zeroes(level.occupied_slots);
+        auto start = slot_start(m_current_tick, i, slot);
+        if (!next.has_value() || start < next->start)
+            next = NextSlot { start, static_cast<u8>(i), static_cast<u8>(slot) };
+    }
+
+    if (!m_far_future.is_empty()) {
+        auto start = first_tick_beyond_levels(m_current_tick);
+        if (!next.has_value() || start < next->start)
+            next = NextSlot { start, far_future_level, 0 };
+    }
+    return next;
+}
+
+Optional<u64> TimerWheel::next_expiration_tick() const
+{
+    if (!m_expired.is_empty())
+        return m_current_tick;
+
+    // NOTE: The slots of a level are in order, so the first occupied one of each level holds the earliest entry of it.
+    Optional<u64> earliest;
+    for (auto const& level : m_levels) {
+        if (level.occupied_slots == 0)
+            continue;
+        auto tick = level.earliest_ticks[count_trailing_zeroes(level.occupied_slots)];
+        if (!earliest.has_value() || tick < *earliest)
+            earliest = tick;
+    }
+
+    if (!m_far_future.is_empty()) {
+        auto tick = first_tick_beyond_levels(m_current_tick);
+        if (!earliest.has_value() || tick < *earliest)
+            earliest = tick;
+    }
+    return earliest;
+}
+
+void TimerWheel::advance_to(u64 tick, EntryList& expired)
+{
+    // Every slot that the wheel passes on the way is emptied into the levels below it (or into the expired entries,
+    // for the lowest level), which never puts an entry back into a slot that has already been passed.
+    while (true) {
+        auto next = next_slot_to_process();
+        if (!next.has_value() || next->start > tick)
+            break;
+        m_current_tick = next->start;
+
+        if (next->level == far_future_level) {
+            EntryList far_future;
+            while (auto* entry = m_far_future.take_first())
+                far_future.append(*entry);
+            while (auto* entry = far_future.take_first())
+                schedule(*entry, entry->m_tick);
+            continue;
+        }
+
+        auto& level = m_levels[next->level];
+        auto& slot = level.slots[next->slot];
+        level.occupied_slots &= ~(1ull << next->slot);
+        while (auto* entry = slot.take_first())
+            schedule(*entry, entry->m_tick);
+    }
+
+    if (tick > m_current_tick)
+        m_current_tick = tick;
+
+    while (auto* entry = m_expired.take_first())
+        expired.append(*entry);
+}
+
+void TimerWheel::clear()
+{
+    for (auto& level : m_levels) {
+        for (auto& slot : level.slots)
+            slot.clear();
+        level.occupied_slots = 0;
+    }
+    m_expired.clear();
+    m_far_future.clear();
+}
+
+}
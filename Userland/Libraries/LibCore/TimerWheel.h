@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/IntrusiveList.h>
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <AK/Types.h>
+
+namespace Core {
+
+// A hierarchical timing wheel, which keeps timers sorted by the tick that they expire at, in constant time per timer.
+// Every level of the wheel has 64 slots, each of which covers 64 times as many ticks as a slot of the level below.
+// A timer goes into the lowest level that still reaches its tick, and moves down a level whenever the wheel gets to
+// the slot that it is in, until it reaches the lowest level and expires.
+class TimerWheel {
+    AK_MAKE_NONCOPYABLE(TimerWheel);
+    AK_MAKE_NONMOVABLE(TimerWheel);
+
+public:
+    class Entry {
+    public:
+        u64 expiration_tick() const { return m_tick; }
+        bool is_scheduled() const { return m_list_node.is_in_list(); }
+
+    private:
+        friend class TimerWheel;
+
+        IntrusiveListNode<Entry> m_list_node;
+        u64 m_tick { 0 };
+        u8 m_level { 0 };
+        u8 m_slot { 0 };
+    };
+
+    using EntryList = IntrusiveList<&Entry::m_list_node>;
+
+    explicit TimerWheel(u64 current_tick = 0)
+        : m_current_tick(current_tick)
+    {
+    }
+
+    u64 current_tick() const { return m_current_tick; }
+    bool is_empty() const;
+
+    // If the tick has already passed, the entry expires with the next call to advance_to().
+    void schedule(Entry&, u64 tick);
+    void unschedule(Entry&);
+
+    // No entry expires before this, but after unscheduling entries, none might expire at it either.
+    Optional<u64> next_expiration_tick() const;
+
+    // Moves the wheel forward, and appends every entry that has expired by then to the list, in the order of their ticks.
+    void advance_to(u64 tick, EntryList& expired);
+
+    void clear();
+
+private:
+    static constexpr size_t bits_per_level = 6;
+    static constexpr size_t slots_per_level = 1 << bits_per_level;
+    // NOTE: With that, a wheel of millisecond ticks reaches more than two years into the future.
+    static constexpr size_t level_count = 6;
+    static constexpr u8 expired_level = 0xff;
+    static constexpr u8 far_future_level = 0xfe;
+
+    struct Level {
+        Array<EntryList, slots_per_level> slots;
+        // The earliest tick in each slot, which may be too early again once entries are unscheduled.
+        Array<u64, slots_per_level> earliest_ticks {};
+        u64 occupied_slots { 0 };
+    };
+
+    static u64 slot_start(u64 current_tick, size_t level, size_t slot);
+    static u64 first_tick_beyond_levels(u64 current_tick);
+
+    struct NextSlot {
+        u64 start;
+        u8 level;
+        u8 slot;
+    };
+    Optional<NextSlot> next_slot_to_process() const;
+
+    void remove_from_slot_if_empty(Entry const&);
+
+    u64 m_current_tick { 0 };
+    Array<Level, level_count> m_levels;
+    EntryList m_expired;
+    // Entries too far into the future for any level, these are spread among the levels once the wheel gets closer.
+    EntryList m_far_future;
+};
+
+}
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/ByteBuffer.h>
+#include <LibCrypto/Verification.h>
 
 namespace Crypto::AEAD {
 
@@ -18,15 +19,28 @@ public:
         m_nonce = MUST(ByteBuffer::copy(nonce));
     }
 
+    // Protocols like TLS use one key with a different nonce for each message.
+    void set_nonce(ReadonlyBytes nonce)
+    {
+        m_nonce = MUST(ByteBuffer::copy(nonce));
+    }
+
     ErrorOr<ByteBuffer> encrypt(ReadonlyBytes aad, ReadonlyBytes plaintext);
     ErrorOr<ByteBuffer> decrypt(ReadonlyBytes aad, ReadonlyBytes ciphertext);
+
+    // These work on buffers provided by the caller, and the output may be the same memory as the input.
+    // Decryption only happens if the tag matches, so a forged message never overwrites the ciphertext.
+    ErrorOr<void> encrypt(ReadonlyBytes aad, ReadonlyBytes plaintext, Bytes ciphertext, Bytes tag);
+    ErrorOr<VerificationConsistency> decrypt(ReadonlyBytes aad, ReadonlyBytes ciphertext, Bytes plaintext, ReadonlyBytes tag);
     ErrorOr<ByteBuffer> poly1305_key();
     static bool verify_tag(ReadonlyBytes encrypted, ReadonlyBytes decrypted);
 
 private:
-    u8 pad_to_16(ReadonlyBytes data)
+    static ErrorOr<ByteBuffer> compute_tag(ReadonlyBytes otk, ReadonlyBytes aad, ReadonlyBytes ciphertext);
+
+    static u8 pad_to_16(ReadonlyBytes data)
     {
-        return 16 - (data.size() % 16);
+        return (16 - (data.size() % 16)) % 16;
     }
 
     ByteBuffer m_key;
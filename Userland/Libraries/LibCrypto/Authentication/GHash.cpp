@@ -9,6 +9,11 @@
 #include <AK/Types.h>
 #include <LibCrypto/Authentication/GHash.h>
 
+#if ARCH(X86_64) && !defined(KERNEL)
+#    include <cpuid.h>
+#    include <immintrin.h>
+#endif
+
 namespace {
 
 static u32 to_u32(u8 const* b)
@@ -23,12 +28,113 @@ static void to_u8s(u8* b, u32 const* w)
     }
 }
 
+#if ARCH(X86_64) && !defined(KERNEL)
+
+static bool cpu_has_pclmul()
+{
+    static bool const has_pclmul = [] {
+        u32 eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+            return false;
+        return (ecx & bit_PCLMUL) && (ecx & bit_SSSE3);
+    }();
+    return has_pclmul;
+}
+
+// Multiplication in GF(2^128) of two byte-reflected elements, as described in Intel's "Intel Carry-Less Multiplication
+// Instruction and its Usage for Computing the GCM Mode" (Algorithm 2 and 4, with the reflected reduction).
+[[gnu::target("pclmul,ssse3")]] static __m128i clmul_galois_multiply(__m128i a, __m128i b)
+{
+    auto low = _mm_clmulepi64_si128(a, b, 0x00);
+    auto middle = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01));
+    auto high = _mm_clmulepi64_si128(a, b, 0x11);
+    low = _mm_xor_si128(low, _mm_slli_si128(middle, 8));
+    high = _mm_xor_si128(high, _mm_srli_si128(middle, 8));
+
+    // The operands are bit-reflected, so the 256-bit product has to be shifted left by one.
+    auto low_carries = _mm_srli_epi32(low, 31);
+    auto high_carries = _mm_srli_epi32(high, 31);
+    low = _mm_slli_epi32(low, 1);
+    high = _mm_slli_epi32(high, 1);
+    high = _mm_or_si128(high, _mm_srli_si128(low_carries, 12));
+    high = _mm_or_si128(high, _mm_slli_si128(high_carries, 4));
+    low = _mm_or_si128(low, _mm_slli_si128(low_carries, 4));
+
+    // Reduce modulo x^128 + x^7 + x^2 + x + 1.
+    auto first = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(low, 31), _mm_slli_epi32(low, 30)), _mm_slli_epi32(low, 25));
+    auto first_carries = _mm_srli_si128(first, 4);
+    low = _mm_xor_si128(low, _mm_slli_si128(first, 12));
+    auto second = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(low, 1), _mm_srli_epi32(low, 2)), _mm_srli_epi32(low, 7));
+    second = _mm_xor_si128(second, first_carries);
+    low = _mm_xor_si128(low, second);
+    return _mm_xor_si128(high, low);
+}
+
+// GHASH works on blocks as big-endian numbers, so their bytes are reversed to make the most significant one come last.
+[[gnu::target("pclmul,ssse3")]] static __m128i clmul_load_block(u8 const* data)
+{
+    auto const reverse_bytes = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data)), reverse_bytes);
+}
+
+// h_powers holds H, H^2, H^3 and H^4. With those, four blocks can be multiplied independently of each other, and only
+// their sum depends on the previous tag: ((((X + B0)H + B1)H + B2)H + B3)H = (X + B0)H^4 + B1H^3 + B2H^2 + B3H.
+[[gnu::target("pclmul,ssse3")]] static __m128i clmul_ghash_update(__m128i tag, __m128i const (&h_powers)[4], ReadonlyBytes buffer)
+{
+    size_t offset = 0;
+    for (; offset + 64 <= buffer.size(); offset += 64) {
+        auto product = clmul_galois_multiply(_mm_xor_si128(tag, clmul_load_block(buffer.offset(offset))), h_powers[3]);
+        product = _mm_xor_si128(product, clmul_galois_multiply(clmul_load_block(buffer.offset(offset + 16)), h_powers[2]));
+        product = _mm_xor_si128(product, clmul_galois_multiply(clmul_load_block(buffer.offset(offset + 32)), h_powers[1]));
+        tag = _mm_xor_si128(product, clmul_galois_multiply(clmul_load_block(buffer.offset(offset + 48)), h_powers[0]));
+    }
+
+    for (; offset + 16 <= buffer.size(); offset += 16)
+        tag = clmul_galois_multiply(_mm_xor_si128(tag, clmul_load_block(buffer.offset(offset))), h_powers[0]);
+
+    if (offset < buffer.size()) {
+        u8 last_block[16] {};
+        buffer.slice(offset).copy_to({ last_block, sizeof(last_block) });
+        tag = clmul_galois_multiply(_mm_xor_si128(tag, clmul_load_block(last_block)), h_powers[0]);
+    }
+
+    return tag;
+}
+
+[[gnu::target("pclmul,ssse3")]] static void clmul_ghash_process(u32 const (&key)[4], ReadonlyBytes aad, ReadonlyBytes cipher, u8 (&digest)[16])
+{
+    __m128i h_powers[4];
+    h_powers[0] = _mm_set_epi32(key[0], key[1], key[2], key[3]);
+    for (size_t i = 1; i < 4; ++i)
+        h_powers[i] = clmul_galois_multiply(h_powers[i - 1], h_powers[0]);
+
+    auto tag = _mm_setzero_si128();
+    tag = clmul_ghash_update(tag, h_powers, aad);
+    tag = clmul_ghash_update(tag, h_powers, cipher);
+
+    auto lengths = _mm_set_epi64x(8 * static_cast<u64>(aad.size()), 8 * static_cast<u64>(cipher.size()));
+    tag = clmul_galois_multiply(_mm_xor_si128(tag, lengths), h_powers[0]);
+
+    auto const reverse_bytes = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(digest), _mm_shuffle_epi8(tag, reverse_bytes));
+}
+
+#endif
+
 }
 
 namespace Crypto::Authentication {
 
 GHash::TagType GHash::process(ReadonlyBytes aad, ReadonlyBytes cipher)
 {
+#if ARCH(X86_64) && !defined(KERNEL)
+    if (cpu_has_pclmul()) {
+        TagType digest;
+        clmul_ghash_process(m_key, aad, cipher, digest.data);
+        return digest;
+    }
+#endif
+
     u32 tag[4] { 0, 0, 0, 0 };
 
     auto transform_one = [&](auto& buf) {
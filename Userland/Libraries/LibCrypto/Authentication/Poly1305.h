@@ -10,11 +10,13 @@
 
 namespace Crypto::Authentication {
 
+// The accumulator and r are kept in three limbs of 44, 44 and 42 bits, so that products of two limbs fit comfortably
+// into 128 bits, and a block takes nine multiplications.
 struct State {
-    u32 r[4] {};
-    u32 s[4] {};
-    u64 a[8] {};
-    u8 blocks[17] {};
+    u64 r[3] {};
+    u64 s[2] {};
+    u64 h[3] {};
+    u8 blocks[16] {};
     u8 block_count {};
 };
 
@@ -26,7 +28,7 @@ public:
     ErrorOr<ByteBuffer> digest();
 
 private:
-    void process_block();
+    void process_blocks(u8 const* data, size_t block_count, u64 high_bit);
 
     State m_state;
 };
@@ -8,8 +8,82 @@
 #include <LibCrypto/Cipher/AES.h>
 #include <LibCrypto/Cipher/AESTables.h>
 
+#if ARCH(X86_64) && !defined(KERNEL)
+#    include <cpuid.h>
+#    include <immintrin.h>
+#endif
+
 namespace Crypto::Cipher {
 
+#if ARCH(X86_64) && !defined(KERNEL)
+
+static bool cpu_has_aes_ni()
+{
+    static bool const has_aes_ni = [] {
+        u32 eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+            return false;
+        return (ecx & bit_AES) && (ecx & bit_SSSE3);
+    }();
+    return has_aes_ni;
+}
+
+template<Intent intent>
+[[gnu::target("aes,ssse3")]] static __m128i aes_ni_process_round(__m128i block, __m128i round_key)
+{
+    if constexpr (intent == Intent::Encryption)
+        return _mm_aesenc_si128(block, round_key);
+    else
+        return _mm_aesdec_si128(block, round_key);
+}
+
+template<Intent intent>
+[[gnu::target("aes,ssse3")]] static __m128i aes_ni_process_last_round(__m128i block, __m128i round_key)
+{
+    if constexpr (intent == Intent::Encryption)
+        return _mm_aesenclast_si128(block, round_key);
+    else
+        return _mm_aesdeclast_si128(block, round_key);
+}
+
+// Encrypts or decrypts consecutive blocks, with the key schedule that the table-based implementation below uses. The
+// decryption key schedule is the one of the "equivalent inverse cipher", which happens to be what AESDEC expects.
+template<Intent intent>
+[[gnu::target("aes,ssse3")]] static void aes_ni_process_blocks(AESCipherKey const& key, u8 const* in, u8* out, size_t block_count)
+{
+    // The round keys are stored as big-endian words, while the instructions work on the bytes in memory order.
+    auto const swap_bytes_of_words = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    auto const rounds = key.rounds();
+    __m128i round_keys[15];
+    for (size_t i = 0; i <= rounds; ++i)
+        round_keys[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(key.round_keys() + 4 * i)), swap_bytes_of_words);
+
+    // Each round of one block depends on the previous one, so processing several blocks side by side is what keeps
+    // the AES units busy.
+    static constexpr size_t blocks_per_batch = 8;
+    size_t block = 0;
+    for (; block + blocks_per_batch <= block_count; block += blocks_per_batch) {
+        __m128i state[blocks_per_batch];
+        for (size_t i = 0; i < blocks_per_batch; ++i)
+            state[i] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in + (block + i) * 16)), round_keys[0]);
+        for (size_t round = 1; round < rounds; ++round) {
+            for (size_t i = 0; i < blocks_per_batch; ++i)
+                state[i] = aes_ni_process_round<intent>(state[i], round_keys[round]);
+        }
+        for (size_t i = 0; i < blocks_per_batch; ++i)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + (block + i) * 16), aes_ni_process_last_round<intent>(state[i], round_keys[rounds]));
+    }
+
+    for (; block < block_count; ++block) {
+        auto state = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in + block * 16)), round_keys[0]);
+        for (size_t round = 1; round < rounds; ++round)
+            state = aes_ni_process_round<intent>(state, round_keys[round]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + block * 16), aes_ni_process_last_round<intent>(state, round_keys[rounds]));
+    }
+}
+
+#endif
+
 template<typename T>
 constexpr u32 get_key(T pt)
 {
@@ -196,8 +270,35 @@ void AESCipherKey::expand_decrypt_key(ReadonlyBytes user_key, size_t bits)
     }
 }
 
+void AESCipher::encrypt_blocks(ReadonlyBytes in, Bytes out)
+{
+    VERIFY(in.size() % AESCipherBlock::block_size() == 0);
+    VERIFY(out.size() >= in.size());
+
+#if ARCH(X86_64) && !defined(KERNEL)
+    if (cpu_has_aes_ni()) {
+        aes_ni_process_blocks<Intent::Encryption>(key(), in.data(), out.data(), in.size() / AESCipherBlock::block_size());
+        return;
+    }
+#endif
+
+    AESCipherBlock block;
+    for (size_t offset = 0; offset < in.size(); offset += AESCipherBlock::block_size()) {
+        block.overwrite(in.slice(offset, AESCipherBlock::block_size()));
+        encrypt_block(block, block);
+        block.bytes().copy_to(out.slice(offset));
+    }
+}
+
 void AESCipher::encrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 {
+#if ARCH(X86_64) && !defined(KERNEL)
+    if (cpu_has_aes_ni()) {
+        aes_ni_process_blocks<Intent::Encryption>(key(), in.bytes().data(), out.bytes().data(), 1);
+        return;
+    }
+#endif
+
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
     size_t r { 0 };
 
@@ -287,6 +388,13 @@ void AESCipher::encrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 
 void AESCipher::decrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 {
+#if ARCH(X86_64) && !defined(KERNEL)
+    if (cpu_has_aes_ni()) {
+        aes_ni_process_blocks<Intent::Decryption>(key(), in.bytes().data(), out.bytes().data(), 1);
+        return;
+    }
+#endif
+
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
     size_t r { 0 };
 
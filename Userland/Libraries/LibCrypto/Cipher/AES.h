@@ -119,6 +119,9 @@ public:
     virtual void encrypt_block(BlockType const& in, BlockType& out) override;
     virtual void decrypt_block(BlockType const& in, BlockType& out) override;
 
+    // Encrypts whole blocks independently of each other. This is much faster than one block at a time with AES-NI.
+    void encrypt_blocks(ReadonlyBytes in, Bytes out);
+
 #ifndef KERNEL
     virtual ByteString class_name() const override
     {
@@ -6,8 +6,14 @@
 
 #include <AK/ByteReader.h>
 #include <AK/Endian.h>
+#include <AK/NumericLimits.h>
+#include <AK/SIMD.h>
 #include <LibCrypto/Cipher/ChaCha20.h>
 
+#if ARCH(X86_64)
+#    include <cpuid.h>
+#endif
+
 namespace Crypto::Cipher {
 
 ChaCha20::ChaCha20(ReadonlyBytes key, ReadonlyBytes nonce, u32 initial_counter)
@@ -111,9 +117,139 @@ void ChaCha20::do_quarter_round(u32& a, u32& b, u32& c, u32& d)
     rotl(b, 7);
 }
 
-void ChaCha20::run_cipher(ReadonlyBytes input, Bytes& output)
+template<typename VectorType>
+ALWAYS_INLINE static VectorType rotate_left(VectorType value, u32 bits)
+{
+    return (value << bits) | (value >> (32 - bits));
+}
+
+template<typename VectorType>
+ALWAYS_INLINE static void quarter_round(VectorType& a, VectorType& b, VectorType& c, VectorType& d)
+{
+    a += b;
+    d = rotate_left(d ^ a, 16);
+    c += d;
+    b = rotate_left(b ^ c, 12);
+    a += b;
+    d = rotate_left(d ^ a, 8);
+    c += d;
+    b = rotate_left(b ^ c, 7);
+}
+
+// Generates as many consecutive blocks of key stream as the vector has lanes. Each lane works on its own block, so the
+// rounds are exactly those of generate_block(), just on several counter values at once.
+template<typename VectorType>
+ALWAYS_INLINE static void generate_blocks_in_parallel(u32 const (&state)[16], u8* key_stream)
+{
+    static constexpr size_t lane_count = sizeof(VectorType) / sizeof(u32);
+
+    VectorType initial[16];
+    for (size_t i = 0; i < 16; ++i)
+        initial[i] = VectorType {} + state[i];
+    for (size_t lane = 0; lane < lane_count; ++lane)
+        initial[12][lane] += lane;
+
+    VectorType x[16];
+    for (size_t i = 0; i < 16; ++i)
+        x[i] = initial[i];
+
+    for (size_t i = 0; i < 20; i += 2) {
+        quarter_round(x[0], x[4], x[8], x[12]);
+        quarter_round(x[1], x[5], x[9], x[13]);
+        quarter_round(x[2], x[6], x[10], x[14]);
+        quarter_round(x[3], x[7], x[11], x[15]);
+
+        quarter_round(x[0], x[5], x[10], x[15]);
+        quarter_round(x[1], x[6], x[11], x[12]);
+        quarter_round(x[2], x[7], x[8], x[13]);
+        quarter_round(x[3], x[4], x[9], x[14]);
+    }
+
+    for (size_t i = 0; i < 16; ++i)
+        x[i] += initial[i];
+
+    for (size_t lane = 0; lane < lane_count; ++lane) {
+        for (size_t i = 0; i < 16; ++i)
+            ByteReader::store(key_stream + lane * 64 + i * 4, AK::convert_between_host_and_little_endian(static_cast<u32>(x[i][lane])));
+    }
+}
+
+static void generate_four_blocks(u32 const (&state)[16], u8* key_stream)
 {
+    generate_blocks_in_parallel<AK::SIMD::u32x4>(state, key_stream);
+}
+
+#if ARCH(X86_64)
+static bool cpu_has_avx2()
+{
+    static bool const has_avx2 = [] {
+        u32 eax, ebx, ecx, edx;
+        // The OS has to save the YMM registers too, which it tells with OSXSAVE and XCR0.
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_OSXSAVE) || !(ecx & bit_AVX))
+            return false;
+        u32 xcr0_low, xcr0_high;
+        asm volatile("xgetbv"
+                     : "=a"(xcr0_low), "=d"(xcr0_high)
+                     : "c"(0));
+        if ((xcr0_low & 0b110) != 0b110)
+            return false;
+        if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+            return false;
+        return (ebx & bit_AVX2) != 0;
+    }();
+    return has_avx2;
+}
+
+[[gnu::target("avx2")]] static void generate_eight_blocks_with_avx2(u32 const (&state)[16], u8* key_stream)
+{
+    generate_blocks_in_parallel<AK::SIMD::u32x8>(state, key_stream);
+}
+#endif
+
+static void xor_bytes(u8 const* input, u8 const* key_stream, u8* output, size_t length)
+{
+    size_t i = 0;
+    for (; i + sizeof(AK::SIMD::u8x16) <= length; i += sizeof(AK::SIMD::u8x16)) {
+        AK::SIMD::u8x16 input_bytes, key_stream_bytes;
+        __builtin_memcpy(&input_bytes, input + i, sizeof(input_bytes));
+        __builtin_memcpy(&key_stream_bytes, key_stream + i, sizeof(key_stream_bytes));
+        auto output_bytes = input_bytes ^ key_stream_bytes;
+        __builtin_memcpy(output + i, &output_bytes, sizeof(output_bytes));
+    }
+    for (; i < length; ++i)
+        output[i] = input[i] ^ key_stream[i];
+}
+
+size_t ChaCha20::run_cipher_in_parallel(ReadonlyBytes input, Bytes& output)
+{
+    u8 key_stream[8 * 64];
     size_t offset = 0;
+
+    auto run_batches = [&](size_t block_count, auto generate_blocks) {
+        // The lanes all share the upper word of a 64-bit counter, so it must not wrap around within a batch.
+        while (input.size() - offset >= block_count * 64 && m_state[12] <= NumericLimits<u32>::max() - (block_count - 1)) {
+            generate_blocks(m_state, key_stream);
+            xor_bytes(input.offset_pointer(offset), key_stream, output.offset_pointer(offset), block_count * 64);
+            offset += block_count * 64;
+
+            m_state[12] += block_count;
+            if (m_state[12] == 0)
+                m_state[13]++;
+        }
+    };
+
+#if ARCH(X86_64)
+    if (cpu_has_avx2())
+        run_batches(8, generate_eight_blocks_with_avx2);
+#endif
+    run_batches(4, generate_four_blocks);
+
+    return offset;
+}
+
+void ChaCha20::run_cipher(ReadonlyBytes input, Bytes& output)
+{
+    size_t offset = run_cipher_in_parallel(input, output);
     size_t block_offset = 0;
     while (offset < input.size()) {
         if (block_offset == 0 || block_offset >= 64) {
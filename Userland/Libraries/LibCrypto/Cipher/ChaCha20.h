@@ -24,6 +24,7 @@ public:
 
 private:
     void run_cipher(ReadonlyBytes input, Bytes& output);
+    size_t run_cipher_in_parallel(ReadonlyBytes input, Bytes& output);
     ALWAYS_INLINE void do_quarter_round(u32& a, u32& b, u32& c, u32& d);
 
     u32 m_state[16] {};
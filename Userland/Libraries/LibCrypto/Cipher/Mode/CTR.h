@@ -170,6 +170,33 @@ protected:
         size_t offset { 0 };
         auto block_size = cipher.block_size();
 
+        // Ciphers that can encrypt many blocks at once get a batch of counter blocks at a time, as those don't depend
+        // on each other.
+        if constexpr (requires { cipher.encrypt_blocks(ReadonlyBytes {}, Bytes {}); }) {
+            constexpr size_t batch_size = T::block_size() * 8;
+            u8 counter_blocks[batch_size];
+            u8 key_stream_blocks[batch_size];
+
+            while (length >= batch_size) {
+                for (size_t i = 0; i < batch_size; i += block_size) {
+                    __builtin_memcpy(counter_blocks + i, iv.data(), block_size);
+                    increment(iv);
+                }
+                cipher.encrypt_blocks({ counter_blocks, batch_size }, { key_stream_blocks, batch_size });
+
+                VERIFY(offset + batch_size <= out.size());
+                if (in) {
+                    for (size_t i = 0; i < batch_size; ++i)
+                        out[offset + i] = key_stream_blocks[i] ^ (*in)[offset + i];
+                } else {
+                    __builtin_memcpy(out.offset(offset), key_stream_blocks, batch_size);
+                }
+
+                length -= batch_size;
+                offset += batch_size;
+            }
+        }
+
         while (length > 0) {
             m_cipher_block.overwrite(iv.slice(0, block_size));
 
@@ -222,24 +222,26 @@ public:
         u1 = from_montgomery_order(u1);
         u2 = from_montgomery_order(u2);
 
-        JacobianPoint point1 = TRY(generate_public_key_internal(u1));
-        JacobianPoint point2 = TRY(compute_coordinate_internal(u2, pubkey_point));
-
-        // Convert the input point into Montgomery form
-        point1.x = to_montgomery(point1.x);
-        point1.y = to_montgomery(point1.y);
-        point1.z = to_montgomery(point1.z);
+        AK::FixedMemoryStream generator_point_stream { GENERATOR_POINT };
+        JacobianPoint generator_point = TRY(read_uncompressed_point(generator_point_stream));
 
-        VERIFY(is_point_on_curve(point1));
+        // Convert the input points into Montgomery form
+        generator_point.x = to_montgomery(generator_point.x);
+        generator_point.y = to_montgomery(generator_point.y);
+        generator_point.z = to_montgomery(generator_point.z);
+        pubkey_point.x = to_montgomery(pubkey_point.x);
+        pubkey_point.y = to_montgomery(pubkey_point.y);
+        pubkey_point.z = to_montgomery(pubkey_point.z);
 
-        // Convert the input point into Montgomery form
-        point2.x = to_montgomery(point2.x);
-        point2.y = to_montgomery(point2.y);
-        point2.z = to_montgomery(point2.z);
+        if (!is_point_on_curve(pubkey_point))
+            return Error::from_string_literal("SECPxxxr1: point is not on the curve");
 
-        VERIFY(is_point_on_curve(point2));
+        // G + Q is needed below, which is only defined by the doubling formula or is the point at infinity if the
+        // public key is G or -G. Nobody uses the private key 1 or n - 1 anyway.
+        if (pubkey_point.x.is_equal_to_constant_time(generator_point.x))
+            return Error::from_string_literal("SECPxxxr1: public key is the generator point");
 
-        JacobianPoint result = point_add(point1, point2);
+        JacobianPoint result = compute_linear_combination_internal(u1, generator_point, u2, pubkey_point);
 
         // Convert from Jacobian coordinates back to Affine coordinates
         convert_jacobian_to_affine(result);
@@ -258,13 +260,6 @@ public:
     }
 
 private:
-    ErrorOr<JacobianPoint> generate_public_key_internal(StorageType a)
-    {
-        AK::FixedMemoryStream generator_point_stream { GENERATOR_POINT };
-        JacobianPoint point = TRY(read_uncompressed_point(generator_point_stream));
-        return compute_coordinate_internal(a, point);
-    }
-
     ErrorOr<JacobianPoint> compute_coordinate_internal(StorageType scalar, JacobianPoint point)
     {
         // FIXME: This will slightly bias the distribution of client secrets
@@ -315,6 +310,40 @@ private:
         return result;
     }
 
+    JacobianPoint compute_linear_combination_internal(StorageType scalar_a, JacobianPoint const& point_a, StorageType scalar_b, JacobianPoint const& point_b)
+    {
+        // Computes scalar_a * point_a + scalar_b * point_b with a single chain of doublings, adding point_a, point_b or
+        // their sum for each pair of bits (Shamir's trick). This takes about half the work of two scalar multiplications.
+        // The points have to be in Montgomery form, and must not be equal or each other's inverse.
+        // NOTE: This is only used to verify signatures, so no secrets are involved and this doesn't need to be constant-time.
+        scalar_a = modular_reduce_order(scalar_a);
+        scalar_b = modular_reduce_order(scalar_b);
+
+        JacobianPoint const sum_of_points = point_add(point_a, point_b);
+
+        auto bit_at = [](StorageType const& value, size_t index) {
+            return (value.span()[index / AK::Detail::native_word_size] >> (index % AK::Detail::native_word_size)) & 1;
+        };
+
+        JacobianPoint result { 0, 0, 0 };
+        bool result_is_point_at_infinity = true;
+        for (size_t i = KEY_BIT_SIZE; i-- > 0;) {
+            if (!result_is_point_at_infinity)
+                result = point_double(result);
+
+            auto bit_a = bit_at(scalar_a, i);
+            auto bit_b = bit_at(scalar_b, i);
+            if (!bit_a && !bit_b)
+                continue;
+
+            auto const& addend = bit_a && bit_b ? sum_of_points : (bit_a ? point_a : point_b);
+            result = result_is_point_at_infinity ? addend : point_add(result, addend);
+            result_is_point_at_infinity = false;
+        }
+
+        return result;
+    }
+
     static ErrorOr<JacobianPoint> read_uncompressed_point(Stream& stream)
     {
         // Make sure the point is uncompressed
@@ -637,15 +666,14 @@ private:
 
     void convert_jacobian_to_affine(JacobianPoint& point)
     {
+        // Only invert Z once, as the inversion costs as much as a few hundred multiplications.
+        StorageType z_inverse = modular_inverse(point.z);
         StorageType temp;
         // X' = X/Z^2
-        temp = modular_square(point.z);
-        temp = modular_inverse(temp);
+        temp = modular_square(z_inverse);
         point.x = modular_multiply(point.x, temp);
         // Y' = Y/Z^3
-        temp = modular_square(point.z);
-        temp = modular_multiply(temp, point.z);
-        temp = modular_inverse(temp);
+        temp = modular_multiply(temp, z_inverse);
         point.y = modular_multiply(point.y, temp);
         // Z' = 1
         point.z = to_montgomery(1u);
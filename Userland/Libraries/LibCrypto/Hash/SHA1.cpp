@@ -10,6 +10,11 @@
 #include <AK/Types.h>
 #include <LibCrypto/Hash/SHA1.h>
 
+#if ARCH(X86_64) && !defined(KERNEL)
+#    include <cpuid.h>
+#    include <immintrin.h>
+#endif
+
 namespace Crypto::Hash {
 
 static constexpr auto ROTATE_LEFT(u32 value, size_t bits)
@@ -17,6 +22,74 @@ static constexpr auto ROTATE_LEFT(u32 value, size_t bits)
     return (value << bits) | (value >> (32 - bits));
 }
 
+#if ARCH(X86_64) && !defined(KERNEL)
+
+static bool cpu_has_sha_ni()
+{
+    static bool const has_sha_ni = [] {
+        u32 eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSSE3) || !(ecx & bit_SSE4_1))
+            return false;
+        if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+            return false;
+        return (ebx & bit_SHA) != 0;
+    }();
+    return has_sha_ni;
+}
+
+[[gnu::target("sha,sse4.1")]] static __m128i sha_ni_sha1_rounds(__m128i abcd, __m128i e, size_t group)
+{
+    // The round function is an immediate operand, so it can't be computed.
+    switch (group / 5) {
+    case 0:
+        return _mm_sha1rnds4_epu32(abcd, e, 0);
+    case 1:
+        return _mm_sha1rnds4_epu32(abcd, e, 1);
+    case 2:
+        return _mm_sha1rnds4_epu32(abcd, e, 2);
+    default:
+        return _mm_sha1rnds4_epu32(abcd, e, 3);
+    }
+}
+
+[[gnu::target("sha,sse4.1")]] static void sha_ni_sha1_transform(u32 (&state)[5], u8 const* data, size_t block_count)
+{
+    // The SHA instructions keep A in the highest lane, and E in the highest lane of a register of its own.
+    auto const reverse_bytes = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    auto abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(state)), 0x1b);
+    auto e = _mm_set_epi32(state[4], 0, 0, 0);
+
+    for (; block_count > 0; --block_count, data += SHA1::block_size()) {
+        auto const saved_abcd = abcd;
+        auto const saved_e = e;
+
+        // Each group of four rounds uses four words of the message schedule, of which only the last 16 are kept.
+        __m128i words[4];
+        auto next_e = _mm_setzero_si128();
+        for (size_t group = 0; group < 20; ++group) {
+            auto& group_words = words[group % 4];
+            if (group < 4) {
+                group_words = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + 16 * group)), reverse_bytes);
+            } else {
+                auto partial_words = _mm_sha1msg1_epu32(group_words, words[(group - 3) % 4]);
+                group_words = _mm_sha1msg2_epu32(_mm_xor_si128(partial_words, words[(group - 2) % 4]), words[(group - 1) % 4]);
+            }
+
+            auto group_e = group == 0 ? _mm_add_epi32(e, group_words) : _mm_sha1nexte_epu32(next_e, group_words);
+            next_e = abcd;
+            abcd = sha_ni_sha1_rounds(abcd, group_e, group);
+        }
+
+        e = _mm_sha1nexte_epu32(next_e, saved_e);
+        abcd = _mm_add_epi32(abcd, saved_abcd);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1b));
+    state[4] = _mm_extract_epi32(e, 3);
+}
+
+#endif
+
 inline void SHA1::transform(u8 const* data)
 {
     u32 blocks[80];
@@ -67,16 +140,38 @@ inline void SHA1::transform(u8 const* data)
     secure_zero(blocks, 16 * sizeof(u32));
 }
 
+void SHA1::transform_blocks(u8 const* data, size_t block_count)
+{
+#if ARCH(X86_64) && !defined(KERNEL)
+    if (cpu_has_sha_ni()) {
+        sha_ni_sha1_transform(m_state, data, block_count);
+        return;
+    }
+#endif
+    for (; block_count > 0; --block_count, data += BlockSize)
+        transform(data);
+}
+
 void SHA1::update(u8 const* message, size_t length)
 {
     while (length > 0) {
+        // Whole blocks are hashed right from the message, without going through the buffer.
+        if (m_data_length == 0 && length >= BlockSize) {
+            auto block_count = length / BlockSize;
+            transform_blocks(message, block_count);
+            m_bit_length += block_count * BlockSize * 8;
+            message += block_count * BlockSize;
+            length -= block_count * BlockSize;
+            continue;
+        }
+
         size_t copy_bytes = AK::min(length, BlockSize - m_data_length);
         __builtin_memcpy(m_data_buffer + m_data_length, message, copy_bytes);
         message += copy_bytes;
         length -= copy_bytes;
         m_data_length += copy_bytes;
         if (m_data_length == BlockSize) {
-            transform(m_data_buffer);
+            transform_blocks(m_data_buffer, 1);
             m_bit_length += BlockSize * 8;
             m_data_length = 0;
         }
@@ -111,7 +206,7 @@ SHA1::DigestType SHA1::peek()
         m_data_buffer[i++] = 0x80;
         while (i < BlockSize)
             m_data_buffer[i++] = 0x00;
-        transform(m_data_buffer);
+        transform_blocks(m_data_buffer, 1);
 
         // Then start another block with BlockSize - 8 bytes of zeros
         __builtin_memset(m_data_buffer, 0, FinalBlockDataSize);
@@ -128,7 +223,7 @@ SHA1::DigestType SHA1::peek()
     m_data_buffer[BlockSize - 7] = m_bit_length >> 48;
     m_data_buffer[BlockSize - 8] = m_bit_length >> 56;
 
-    transform(m_data_buffer);
+    transform_blocks(m_data_buffer, 1);
 
     for (i = 0; i < 4; ++i) {
         digest.data[i + 0] = (m_state[0] >> (24 - i * 8)) & 0x000000ff;
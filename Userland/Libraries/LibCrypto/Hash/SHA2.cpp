@@ -8,6 +8,11 @@
 #include <AK/Types.h>
 #include <LibCrypto/Hash/SHA2.h>
 
+#if ARCH(X86_64) && !defined(KERNEL)
+#    include <cpuid.h>
+#    include <immintrin.h>
+#endif
+
 namespace Crypto::Hash {
 constexpr static auto ROTRIGHT(u32 a, size_t b) { return (a >> b) | (a << (32 - b)); }
 constexpr static auto CH(u32 x, u32 y, u32 z) { return (x & y) ^ (z & ~x); }
@@ -66,6 +71,275 @@ inline void SHA256::transform(u8 const* data)
     m_state[7] += h;
 }
 
+#if ARCH(X86_64) && !defined(KERNEL)
+
+static bool cpu_has_sha_ni()
+{
+    static bool const has_sha_ni = [] {
+        u32 eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSSE3) || !(ecx & bit_SSE4_1))
+            return false;
+        if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+            return false;
+        return (ebx & bit_SHA) != 0;
+    }();
+    return has_sha_ni;
+}
+
+static bool cpu_has_avx2()
+{
+    static bool const has_avx2 = [] {
+        u32 eax, ebx, ecx, edx;
+        // The OS has to save the YMM registers too, which it tells with OSXSAVE and XCR0.
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_OSXSAVE) || !(ecx & bit_AVX))
+            return false;
+        u32 xcr0_low, xcr0_high;
+        asm volatile("xgetbv"
+                     : "=a"(xcr0_low), "=d"(xcr0_high)
+                     : "c"(0));
+        if ((xcr0_low & 0b110) != 0b110)
+            return false;
+        if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+            return false;
+        return (ebx & bit_AVX2) != 0;
+    }();
+    return has_avx2;
+}
+
+[[gnu::target("sha,sse4.1")]] static void sha_ni_sha256_transform(u32 (&state)[8], u8 const* data, size_t block_count)
+{
+    // The SHA instructions want the state as ABEF and CDGH, with A and C in the highest lanes.
+    auto const swap_bytes_of_words = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    auto dcba = _mm_loadu_si128(reinterpret_cast<__m128i const*>(state));
+    auto hgfe = _mm_loadu_si128(reinterpret_cast<__m128i const*>(state + 4));
+    auto cdab = _mm_shuffle_epi32(dcba, 0xb1);
+    auto efgh = _mm_shuffle_epi32(hgfe, 0x1b);
+    auto abef = _mm_alignr_epi8(cdab, efgh, 8);
+    auto cdgh = _mm_blend_epi16(efgh, cdab, 0xf0);
+
+    for (; block_count > 0; --block_count, data += SHA256::block_size()) {
+        auto const saved_abef = abef;
+        auto const saved_cdgh = cdgh;
+
+        // Each group of four rounds uses four words of the message schedule, of which only the last 16 are kept.
+        __m128i words[4];
+        for (size_t group = 0; group < 16; ++group) {
+            auto& group_words = words[group % 4];
+            if (group < 4) {
+                group_words = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + 16 * group)), swap_bytes_of_words);
+            } else {
+                auto partial_words = _mm_sha256msg1_epu32(group_words, words[(group - 3) % 4]);
+                partial_words = _mm_add_epi32(partial_words, _mm_alignr_epi8(words[(group - 1) % 4], words[(group - 2) % 4], 4));
+                group_words = _mm_sha256msg2_epu32(partial_words, words[(group - 1) % 4]);
+            }
+
+            auto message = _mm_add_epi32(group_words, _mm_loadu_si128(reinterpret_cast<__m128i const*>(SHA256Constants::RoundConstants + 4 * group)));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, message);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(message, 0x0e));
+        }
+
+        abef = _mm_add_epi32(abef, saved_abef);
+        cdgh = _mm_add_epi32(cdgh, saved_cdgh);
+    }
+
+    auto feba = _mm_shuffle_epi32(abef, 0x1b);
+    auto dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_blend_epi16(feba, dchg, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), _mm_alignr_epi8(dchg, feba, 8));
+}
+
+template<int bits>
+[[gnu::target("avx2")]] static __m256i avx2_rotate_right(__m256i value)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(value, bits), _mm256_slli_epi32(value, 32 - bits));
+}
+
+static u32 read_unaligned_word(u8 const* data)
+{
+    u32 word;
+    __builtin_memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+// Runs one block of each of eight independent messages through the compression function, one message per 32-bit lane.
+// state[i] holds the i-th state word of every lane.
+[[gnu::target("avx2")]] static void avx2_sha256_transform_lanes(u32 (&state)[8][8], u8 const* const (&blocks)[8])
+{
+    auto const swap_bytes_of_words = _mm256_set_epi8(
+        12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+        12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+    __m256i schedule[16];
+    for (size_t i = 0; i < 16; ++i) {
+        auto words = _mm256_setr_epi32(
+            read_unaligned_word(blocks[0] + 4 * i), read_unaligned_word(blocks[1] + 4 * i),
+            read_unaligned_word(blocks[2] + 4 * i), read_unaligned_word(blocks[3] + 4 * i),
+            read_unaligned_word(blocks[4] + 4 * i), read_unaligned_word(blocks[5] + 4 * i),
+            read_unaligned_word(blocks[6] + 4 * i), read_unaligned_word(blocks[7] + 4 * i));
+        schedule[i] = _mm256_shuffle_epi8(words, swap_bytes_of_words);
+    }
+
+    __m256i working[8];
+    for (size_t i = 0; i < 8; ++i)
+        working[i] = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(state[i]));
+    auto a = working[0], b = working[1], c = working[2], d = working[3],
+         e = working[4], f = working[5], g = working[6], h = working[7];
+
+    for (size_t i = 0; i < 64; ++i) {
+        auto& word = schedule[i % 16];
+        if (i >= 16) {
+            auto const& w2 = schedule[(i - 2) % 16];
+            auto const& w15 = schedule[(i - 15) % 16];
+            auto sign1 = _mm256_xor_si256(_mm256_xor_si256(avx2_rotate_right<17>(w2), avx2_rotate_right<19>(w2)), _mm256_srli_epi32(w2, 10));
+            auto sign0 = _mm256_xor_si256(_mm256_xor_si256(avx2_rotate_right<7>(w15), avx2_rotate_right<18>(w15)), _mm256_srli_epi32(w15, 3));
+            word = _mm256_add_epi32(_mm256_add_epi32(word, sign0), _mm256_add_epi32(sign1, schedule[(i - 7) % 16]));
+        }
+
+        auto ep1 = _mm256_xor_si256(_mm256_xor_si256(avx2_rotate_right<6>(e), avx2_rotate_right<11>(e)), avx2_rotate_right<25>(e));
+        auto ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        auto temp0 = _mm256_add_epi32(_mm256_add_epi32(h, ep1), _mm256_add_epi32(ch, _mm256_add_epi32(word, _mm256_set1_epi32(SHA256Constants::RoundConstants[i]))));
+        auto ep0 = _mm256_xor_si256(_mm256_xor_si256(avx2_rotate_right<2>(a), avx2_rotate_right<13>(a)), avx2_rotate_right<22>(a));
+        auto maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        auto temp1 = _mm256_add_epi32(ep0, maj);
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32(d, temp0);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32(temp0, temp1);
+    }
+
+    __m256i const results[8] { a, b, c, d, e, f, g, h };
+    for (size_t i = 0; i < 8; ++i)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(state[i]), _mm256_add_epi32(working[i], results[i]));
+}
+
+// Hashes messages eight at a time, each in its own lane. Whenever a message is done, the next one takes over its lane,
+// so messages of different lengths don't leave lanes idle for long.
+static void avx2_sha256_hash_many(ReadonlySpan<ReadonlyBytes> messages, Span<SHA256::DigestType> digests)
+{
+    static constexpr size_t lane_count = 8;
+    static constexpr size_t block_size = SHA256::block_size();
+
+    struct Lane {
+        size_t message_index { 0 };
+        u8 const* message_blocks { nullptr };
+        size_t message_block_count { 0 };
+
+        // The last bytes of the message, followed by the padding and length.
+        u8 final_blocks[2 * block_size];
+        size_t final_block_count { 0 };
+
+        size_t next_block { 0 };
+    };
+
+    static u8 const unused_lane_block[block_size] {};
+
+    Lane lanes[lane_count];
+    bool lane_is_busy[lane_count] {};
+    alignas(32) u32 state[8][lane_count];
+    size_t next_message_index = 0;
+
+    auto start_next_message = [&](size_t lane_index) {
+        auto& lane = lanes[lane_index];
+        if (next_message_index == messages.size()) {
+            lane_is_busy[lane_index] = false;
+            return;
+        }
+
+        lane.message_index = next_message_index++;
+        auto message = messages[lane.message_index];
+        lane.message_blocks = message.data();
+        lane.message_block_count = message.size() / block_size;
+        lane.next_block = 0;
+
+        auto remaining_bytes = message.slice(lane.message_block_count * block_size);
+        lane.final_block_count = remaining_bytes.size() + 9 <= block_size ? 1 : 2;
+        auto final_bytes = Bytes { lane.final_blocks, lane.final_block_count * block_size };
+        final_bytes.fill(0);
+        remaining_bytes.copy_to(final_bytes);
+        final_bytes[remaining_bytes.size()] = 0x80;
+        u64 bit_length = static_cast<u64>(message.size()) * 8;
+        for (size_t i = 0; i < 8; ++i)
+            final_bytes[final_bytes.size() - 1 - i] = bit_length >> (8 * i);
+
+        for (size_t i = 0; i < 8; ++i)
+            state[i][lane_index] = SHA256Constants::InitializationHashes[i];
+        lane_is_busy[lane_index] = true;
+    };
+
+    for (size_t i = 0; i < lane_count; ++i)
+        start_next_message(i);
+
+    while (true) {
+        u8 const* blocks[lane_count];
+        bool any_lane_is_busy = false;
+        for (size_t i = 0; i < lane_count; ++i) {
+            auto& lane = lanes[i];
+            if (!lane_is_busy[i]) {
+                blocks[i] = unused_lane_block;
+                continue;
+            }
+            any_lane_is_busy = true;
+            if (lane.next_block < lane.message_block_count)
+                blocks[i] = lane.message_blocks + lane.next_block * block_size;
+            else
+                blocks[i] = lane.final_blocks + (lane.next_block - lane.message_block_count) * block_size;
+        }
+        if (!any_lane_is_busy)
+            break;
+
+        avx2_sha256_transform_lanes(state, blocks);
+
+        for (size_t i = 0; i < lane_count; ++i) {
+            auto& lane = lanes[i];
+            if (!lane_is_busy[i] || ++lane.next_block < lane.message_block_count + lane.final_block_count)
+                continue;
+
+            auto& digest = digests[lane.message_index];
+            for (size_t word = 0; word < 8; ++word) {
+                for (size_t byte = 0; byte < 4; ++byte)
+                    digest.data[word * 4 + byte] = state[word][i] >> (24 - byte * 8);
+            }
+            start_next_message(i);
+        }
+    }
+}
+
+#endif
+
+void SHA256::transform_blocks(u8 const* data, size_t block_count)
+{
+#if ARCH(X86_64) && !defined(KERNEL)
+    if (cpu_has_sha_ni()) {
+        sha_ni_sha256_transform(m_state, data, block_count);
+        return;
+    }
+#endif
+    for (; block_count > 0; --block_count, data += BlockSize)
+        transform(data);
+}
+
+void SHA256::hash_many(ReadonlySpan<ReadonlyBytes> messages, Span<DigestType> digests)
+{
+    VERIFY(messages.size() == digests.size());
+
+#if ARCH(X86_64) && !defined(KERNEL)
+    // One block through the SHA extensions costs about as much as a sixth of a block in each of the eight AVX2 lanes, so
+    // with those, hashing side by side only pays off if there are enough messages to keep nearly every lane busy.
+    size_t minimum_message_count_for_avx2 = cpu_has_sha_ni() ? 64 : 2;
+    if (cpu_has_avx2() && messages.size() >= minimum_message_count_for_avx2) {
+        avx2_sha256_hash_many(messages, digests);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < messages.size(); ++i)
+        digests[i] = hash(messages[i].data(), messages[i].size());
+}
+
 template<size_t BlockSize, typename Callback>
 void update_buffer(u8* buffer, u8 const* input, size_t length, size_t& data_length, Callback callback)
 {
@@ -84,10 +358,27 @@ void update_buffer(u8* buffer, u8 const* input, size_t length, size_t& data_leng
 
 void SHA256::update(u8 const* message, size_t length)
 {
-    update_buffer<BlockSize>(m_data_buffer, message, length, m_data_length, [&]() {
-        transform(m_data_buffer);
+    auto on_full_buffer = [&]() {
+        transform_blocks(m_data_buffer, 1);
         m_bit_length += BlockSize * 8;
-    });
+    };
+
+    if (m_data_length > 0) {
+        auto copy_bytes = AK::min(length, BlockSize - m_data_length);
+        update_buffer<BlockSize>(m_data_buffer, message, copy_bytes, m_data_length, on_full_buffer);
+        message += copy_bytes;
+        length -= copy_bytes;
+    }
+
+    // Whole blocks are hashed right from the message, without going through the buffer.
+    if (auto block_count = length / BlockSize; block_count > 0) {
+        transform_blocks(message, block_count);
+        m_bit_length += block_count * BlockSize * 8;
+        message += block_count * BlockSize;
+        length -= block_count * BlockSize;
+    }
+
+    update_buffer<BlockSize>(m_data_buffer, message, length, m_data_length, on_full_buffer);
 }
 
 SHA256::DigestType SHA256::digest()
@@ -111,7 +402,7 @@ SHA256::DigestType SHA256::peek()
         m_data_buffer[i++] = 0x80;
         while (i < BlockSize)
             m_data_buffer[i++] = 0x00;
-        transform(m_data_buffer);
+        transform_blocks(m_data_buffer, 1);
 
         // Then start another block with BlockSize - 8 bytes of zeros
         __builtin_memset(m_data_buffer, 0, FinalBlockDataSize);
@@ -128,7 +419,7 @@ SHA256::DigestType SHA256::peek()
     m_data_buffer[BlockSize - 7] = m_bit_length >> 48;
     m_data_buffer[BlockSize - 8] = m_bit_length >> 56;
 
-    transform(m_data_buffer);
+    transform_blocks(m_data_buffer, 1);
 
     // SHA uses big-endian and we assume little-endian
     // FIXME: looks like a thing for AK::NetworkOrdered,
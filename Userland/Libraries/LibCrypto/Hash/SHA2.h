@@ -99,6 +99,10 @@ public:
     static DigestType hash(ByteBuffer const& buffer) { return hash(buffer.data(), buffer.size()); }
     static DigestType hash(StringView buffer) { return hash((u8 const*)buffer.characters_without_null_termination(), buffer.length()); }
 
+    // Hashes each of the messages into the digest at the same index. Where the CPU allows it, several messages are hashed
+    // side by side, which is a lot faster than one after the other for many small messages.
+    static void hash_many(ReadonlySpan<ReadonlyBytes> messages, Span<DigestType> digests);
+
 #ifndef KERNEL
     virtual ByteString class_name() const override
     {
@@ -116,6 +120,7 @@ public:
 
 private:
     inline void transform(u8 const*);
+    void transform_blocks(u8 const*, size_t block_count);
 
     u8 m_data_buffer[BlockSize] {};
     size_t m_data_length { 0 };
@@ -7,6 +7,7 @@
 #include <AK/Debug.h>
 #include <LibCrypto/BigInt/Algorithms/UnsignedBigIntegerAlgorithms.h>
 #include <LibCrypto/NumberTheory/ModularFunctions.h>
+#include <LibCrypto/NumberTheory/MontgomeryContext.h>
 
 namespace Crypto::NumberTheory {
 
@@ -41,19 +42,8 @@ UnsignedBigInteger ModularPower(UnsignedBigInteger const& b, UnsignedBigInteger
     if (m == 1)
         return 0;
 
-    if (m.is_odd()) {
-        UnsignedBigInteger temp_z0 { 0 };
-        UnsignedBigInteger temp_rr { 0 };
-        UnsignedBigInteger temp_one { 0 };
-        UnsignedBigInteger temp_z { 0 };
-        UnsignedBigInteger temp_zz { 0 };
-        UnsignedBigInteger temp_x { 0 };
-        UnsignedBigInteger temp_extra { 0 };
-
-        UnsignedBigInteger result;
-        UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocations(b, e, m, temp_z0, temp_rr, temp_one, temp_z, temp_zz, temp_x, temp_extra, result);
-        return result;
-    }
+    if (m.is_odd())
+        return MontgomeryContext { m }.power(b, e);
 
     UnsignedBigInteger ep { e };
     UnsignedBigInteger base { b };
@@ -133,16 +123,19 @@ static bool MR_primality_test(UnsignedBigInteger n, Vector<UnsignedBigInteger, 2
         return n == 2;
     }
 
+    // n is odd from here on, so all the witnesses can share the values derived from it.
+    MontgomeryContext context { n };
+
     for (auto& a : tests) {
         // Technically: VERIFY(2 <= a && a <= n - 2)
         VERIFY(a < n);
-        auto x = ModularPower(a, d, n);
+        auto x = context.power(a, d);
         if (x == 1 || x == predecessor)
             continue;
         bool skip_this_witness = false;
         // r − 1 iterations.
         for (size_t i = 0; i < r - 1; ++i) {
-            x = ModularPower(x, 2, n);
+            x = context.multiply(x, x);
             if (x == predecessor) {
                 skip_this_witness = true;
                 break;
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StdLibExtras.h>
+#include <AK/TypedTransfer.h>
+#include <LibCrypto/NumberTheory/MontgomeryContext.h>
+
+namespace Crypto::NumberTheory {
+
+using AK::Detail::DoubleWord;
+using AK::Detail::sub_words;
+
+static constexpr size_t bits_in_word = sizeof(AK::Detail::NativeWord) * 8;
+
+// Computes (1 / value) % 2^bits_in_word for an odd value.
+static AK::Detail::NativeWord inverse_modulo_word_size(AK::Detail::NativeWord value)
+{
+    VERIFY(value & 1);
+
+    // Every odd number is its own inverse modulo 8, and each step of Newton's iteration doubles the number of correct
+    // low bits from there.
+    auto inverse = value;
+    for (size_t correct_bits = 3; correct_bits < bits_in_word; correct_bits *= 2)
+        inverse *= 2 - value * inverse;
+    return inverse;
+}
+
+// Picks the window that minimizes the number of multiplications for the exponent, as the table of powers takes
+// 2^window_size - 2 multiplications to fill. These are the thresholds used by OpenSSL's BN_window_bits_for_exponent_size.
+static size_t window_size_for_exponent(size_t exponent_bits)
+{
+    if (exponent_bits > 671)
+        return 6;
+    if (exponent_bits > 239)
+        return 5;
+    if (exponent_bits > 79)
+        return 4;
+    if (exponent_bits > 23)
+        return 3;
+    return 1;
+}
+
+static size_t exponent_window(UnsignedBigInteger const& exponent, size_t bit_offset, size_t window_size)
+{
+    auto const& words = exponent.words();
+    size_t window = 0;
+    for (size_t i = window_size; i-- > 0;) {
+        auto bit = bit_offset + i;
+        auto word_index = bit / UnsignedBigInteger::BITS_IN_WORD;
+        window <<= 1;
+        if (word_index < words.size())
+            window |= (words[word_index] >> (bit % UnsignedBigInteger::BITS_IN_WORD)) & 1;
+    }
+    return window;
+}
+
+MontgomeryContext::MontgomeryContext(UnsignedBigInteger const& modulus)
+    : m_modulus(modulus)
+{
+    VERIFY(m_modulus.is_odd());
+    m_modulus.clamp_to_trimmed_length();
+
+    m_limb_count = ceil_div(m_modulus.trimmed_length(), words_per_limb);
+    m_modulus_limbs = to_limbs(m_modulus);
+    m_modulus_inverse = -inverse_modulo_word_size(m_modulus_limbs[0]);
+
+    // R = 2^(bits_in_word * limb count), which is larger than the modulus.
+    auto r_mod_modulus = UnsignedBigInteger { 1 }.shift_left(bits_in_word * m_limb_count).divided_by(m_modulus).remainder;
+    auto r_squared_mod_modulus = r_mod_modulus.shift_left(bits_in_word * m_limb_count).divided_by(m_modulus).remainder;
+    m_one = to_limbs(r_mod_modulus);
+    m_r_squared = to_limbs(r_squared_mod_modulus);
+}
+
+MontgomeryContext::Limbs MontgomeryContext::to_limbs(UnsignedBigInteger const& value) const
+{
+    VERIFY(value.trimmed_length() <= m_limb_count * words_per_limb);
+
+    Limbs limbs;
+    limbs.resize(m_limb_count);
+    for (size_t i = 0; i < value.trimmed_length(); ++i)
+        limbs[i / words_per_limb] |= static_cast<Word>(value.words()[i]) << ((i % words_per_limb) * UnsignedBigInteger::BITS_IN_WORD);
+    return limbs;
+}
+
+UnsignedBigInteger MontgomeryContext::from_limbs(Word const* limbs) const
+{
+    Vector<UnsignedBigInteger::Word, STARTING_WORD_SIZE> words;
+    words.resize(m_limb_count * words_per_limb);
+    for (size_t i = 0; i < words.size(); ++i)
+        words[i] = static_cast<UnsignedBigInteger::Word>(limbs[i / words_per_limb] >> ((i % words_per_limb) * UnsignedBigInteger::BITS_IN_WORD));
+
+    UnsignedBigInteger result { move(words) };
+    result.clamp_to_trimmed_length();
+    return result;
+}
+
+MontgomeryContext::Limbs MontgomeryContext::reduce(UnsignedBigInteger const& value) const
+{
+    if (value < m_modulus)
+        return to_limbs(value);
+    return to_limbs(value.divided_by(m_modulus).remainder);
+}
+
+MontgomeryContext::Limbs MontgomeryContext::to_montgomery(UnsignedBigInteger const& value) const
+{
+    auto limbs = reduce(value);
+    multiply(limbs.data(), m_r_squared.data(), limbs.data());
+    return limbs;
+}
+
+UnsignedBigInteger MontgomeryContext::from_montgomery(Word const* value) const
+{
+    Limbs one;
+    one.resize(m_limb_count);
+    one[0] = 1;
+
+    Limbs limbs;
+    limbs.resize(m_limb_count);
+    multiply(value, one.data(), limbs.data());
+    return from_limbs(limbs.data());
+}
+
+// Coarsely Integrated Operand Scanning, from Koç, Acar and Kaliski, "Analyzing and Comparing Montgomery Multiplication
+// Algorithms". The inputs have to be smaller than the modulus, and so is the result.
+void MontgomeryContext::multiply(Word const* left, Word const* right, Word* result) const
+{
+    using DoubleWordType = DoubleWord<Word>;
+
+    auto n = m_limb_count;
+    auto const* modulus = m_modulus_limbs.data();
+
+    Vector<Word, 66> t_storage;
+    t_storage.resize(n + 2);
+    auto* t = t_storage.data();
+
+    for (size_t i = 0; i < n; ++i) {
+        // t += left * right[i]
+        Word carry = 0;
+        for (size_t j = 0; j < n; ++j) {
+            auto product = static_cast<DoubleWordType>(left[j]) * right[i] + t[j] + carry;
+            t[j] = static_cast<Word>(product);
+            carry = static_cast<Word>(product >> bits_in_word);
+        }
+        auto sum = static_cast<DoubleWordType>(t[n]) + carry;
+        t[n] = static_cast<Word>(sum);
+        t[n + 1] = static_cast<Word>(sum >> bits_in_word);
+
+        // t = (t + m * modulus) / 2^bits_in_word, where m is chosen so that the lowest word becomes zero.
+        Word m = t[0] * m_modulus_inverse;
+        auto product = static_cast<DoubleWordType>(m) * modulus[0] + t[0];
+        carry = static_cast<Word>(product >> bits_in_word);
+        for (size_t j = 1; j < n; ++j) {
+            product = static_cast<DoubleWordType>(m) * modulus[j] + t[j] + carry;
+            t[j - 1] = static_cast<Word>(product);
+            carry = static_cast<Word>(product >> bits_in_word);
+        }
+        sum = static_cast<DoubleWordType>(t[n]) + carry;
+        t[n - 1] = static_cast<Word>(sum);
+        t[n] = t[n + 1] + static_cast<Word>(sum >> bits_in_word);
+    }
+
+    // t < 2 * modulus, so subtracting the modulus once, if t isn't already smaller than it, brings it into range. Both
+    // are computed, so that the timing doesn't depend on which one is picked.
+    bool borrow = false;
+    for (size_t j = 0; j < n; ++j)
+        result[j] = sub_words(t[j], modulus[j], borrow);
+
+    // The subtraction only underflows if t is smaller than the modulus, unless t overflowed into t[n].
+    auto keep_t_mask = static_cast<Word>(0) - static_cast<Word>(borrow && t[n] == 0);
+    for (size_t j = 0; j < n; ++j)
+        result[j] = (t[j] & keep_t_mask) | (result[j] & ~keep_t_mask);
+}
+
+UnsignedBigInteger MontgomeryContext::multiply(UnsignedBigInteger const& left, UnsignedBigInteger const& right) const
+{
+    // left * (right * R) * R^-1 = left * right, so only one side has to be converted.
+    auto left_limbs = reduce(left);
+    auto right_limbs = to_montgomery(right);
+    multiply(left_limbs.data(), right_limbs.data(), left_limbs.data());
+    return from_limbs(left_limbs.data());
+}
+
+UnsignedBigInteger MontgomeryContext::power(UnsignedBigInteger const& base, UnsignedBigInteger const& exponent) const
+{
+    auto n = m_limb_count;
+
+    auto exponent_bits = exponent.one_based_index_of_highest_set_bit();
+    if (exponent_bits == 0)
+        return from_montgomery(m_one.data());
+
+    auto window_size = window_size_for_exponent(exponent_bits);
+
+    // powers[i] = base^i, in Montgomery form.
+    Vector<Word> powers;
+    powers.resize((1u << window_size) * n);
+    auto power_at = [&](size_t index) { return powers.data() + index * n; };
+
+    auto base_limbs = to_montgomery(base);
+    AK::TypedTransfer<Word>::copy(power_at(0), m_one.data(), n);
+    AK::TypedTransfer<Word>::copy(power_at(1), base_limbs.data(), n);
+    for (size_t i = 2; i < (1u << window_size); ++i)
+        multiply(power_at(i - 1), power_at(1), power_at(i));
+
+    auto window_count = ceil_div(exponent_bits, window_size);
+
+    Limbs result;
+    result.resize(n);
+    AK::TypedTransfer<Word>::copy(result.data(), power_at(exponent_window(exponent, (window_count - 1) * window_size, window_size)), n);
+
+    for (size_t window = window_count - 1; window-- > 0;) {
+        for (size_t i = 0; i < window_size; ++i)
+            multiply(result.data(), result.data(), result.data());
+        multiply(result.data(), power_at(exponent_window(exponent, window * window_size, window_size)), result.data());
+    }
+
+    return from_montgomery(result.data());
+}
+
+}
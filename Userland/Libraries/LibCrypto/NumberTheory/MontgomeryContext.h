@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/BigIntBase.h>
+#include <AK/Vector.h>
+#include <LibCrypto/BigInt/UnsignedBigInteger.h>
+
+namespace Crypto::NumberTheory {
+
+// Modular arithmetic in Montgomery form for one odd modulus, so that the values derived from the modulus (like R^2 mod
+// modulus) are only computed once, however many operations are done with it.
+// https://en.wikipedia.org/wiki/Montgomery_modular_multiplication
+//
+// Internally, numbers are kept in native words (64 bits wide where the platform has a 128-bit product), instead of the
+// 32-bit words of UnsignedBigInteger, which cuts the number of word multiplications by four.
+class MontgomeryContext {
+public:
+    explicit MontgomeryContext(UnsignedBigInteger const& modulus);
+
+    UnsignedBigInteger const& modulus() const { return m_modulus; }
+
+    // (left * right) % modulus
+    UnsignedBigInteger multiply(UnsignedBigInteger const& left, UnsignedBigInteger const& right) const;
+
+    // (base ^ exponent) % modulus, using fixed-window exponentiation. The sequence of multiplications only depends on the
+    // length of the exponent, not on the value of its bits.
+    UnsignedBigInteger power(UnsignedBigInteger const& base, UnsignedBigInteger const& exponent) const;
+
+private:
+    using Word = AK::Detail::NativeWord;
+    using Limbs = Vector<Word, 64>;
+
+    static constexpr size_t words_per_limb = sizeof(Word) / sizeof(UnsignedBigInteger::Word);
+
+    Limbs to_limbs(UnsignedBigInteger const&) const;
+    UnsignedBigInteger from_limbs(Word const*) const;
+
+    // Returns the limbs of value % modulus.
+    Limbs reduce(UnsignedBigInteger const&) const;
+
+    Limbs to_montgomery(UnsignedBigInteger const&) const;
+    UnsignedBigInteger from_montgomery(Word const*) const;
+
+    // result = left * right * R^-1 % modulus. The result may alias either input.
+    void multiply(Word const* left, Word const* right, Word* result) const;
+
+    UnsignedBigInteger m_modulus;
+    size_t m_limb_count { 0 };
+    Limbs m_modulus_limbs;
+    Limbs m_r_squared;
+    Limbs m_one;
+
+    // -modulus^-1 mod 2^bit_width<Word>
+    Word m_modulus_inverse { 0 };
+};
+
+}
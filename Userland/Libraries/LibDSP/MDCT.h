@@ -8,6 +8,8 @@
 
 #include <AK/Array.h>
 #include <AK/Math.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
 #include <AK/Span.h>
 
 namespace DSP {
@@ -19,7 +21,7 @@ public:
     {
         for (size_t n = 0; n < N; n++) {
             for (size_t k = 0; k < N / 2; k++) {
-                m_phi[n][k] = AK::cos<float>(AK::Pi<float> / (2 * N) * (2 * static_cast<float>(n) + 1 + N / 2.0f) * static_cast<float>(2 * k + 1));
+                m_phi[k][n] = AK::cos<float>(AK::Pi<float> / (2 * N) * (2 * static_cast<float>(n) + 1 + N / 2.0f) * static_cast<float>(2 * k + 1));
             }
         }
     }
@@ -28,16 +30,26 @@ public:
     {
         VERIFY(N == 2 * data.size());
         VERIFY(N == output.size());
-        for (size_t n = 0; n < N; n++) {
-            output[n] = 0;
-            for (size_t k = 0; k < N / 2; k++) {
-                output[n] += data[k] * m_phi[n][k];
+        // The basis functions are stored by k, so that four consecutive outputs can be accumulated at once.
+        if constexpr (N % 4 == 0) {
+            for (size_t n = 0; n < N; n += 4) {
+                AK::SIMD::f32x4 sum {};
+                for (size_t k = 0; k < N / 2; k++)
+                    sum += data[k] * AK::SIMD::load_unaligned<AK::SIMD::f32x4>(&m_phi[k][n]);
+                AK::SIMD::store_unaligned(&output[n], sum);
+            }
+        } else {
+            for (size_t n = 0; n < N; n++) {
+                output[n] = 0;
+                for (size_t k = 0; k < N / 2; k++) {
+                    output[n] += data[k] * m_phi[k][n];
+                }
             }
         }
     }
 
 private:
-    Array<Array<float, N / 2>, N> m_phi;
+    Array<Array<float, N>, N / 2> m_phi;
 };
 
 }
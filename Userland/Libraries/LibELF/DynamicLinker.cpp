@@ -15,6 +15,7 @@
 #include <AK/Platform.h>
 #include <AK/Random.h>
 #include <AK/ScopeGuard.h>
+#include <AK/Time.h>
 #include <AK/Vector.h>
 #include <Kernel/API/VirtualMemoryAnnotations.h>
 #include <Kernel/API/prctl_numbers.h>
@@ -65,12 +66,27 @@ static ByteString s_cwd;
 
 static bool s_allowed_to_check_environment_variables { false };
 static bool s_do_breakpoint_trap_before_entry { false };
+static bool s_print_statistics { false };
 static StringView s_ld_library_path;
 static StringView s_main_program_pledge_promises;
 static ByteString s_loader_pledge_promises;
 
 static HashMap<StringView, DynamicObject::SymbolLookupResult> s_magic_functions;
 
+// Most symbols (e.g. those from LibC and AK) are referenced by many of the objects that are linked together, each of
+// which would otherwise search all global objects again. This cache only exists while link_main_library() runs with the
+// loader lock held, so that lazy PLT fixups on other threads never observe it.
+static HashMap<StringView, Optional<DynamicObject::SymbolLookupResult>>* s_link_time_symbol_cache = nullptr;
+
+// Reported on startup when LD_DEBUG=statistics is set.
+static struct {
+    size_t global_symbol_lookups { 0 };
+    size_t cached_global_symbol_lookups { 0 };
+    Duration mapping_time;
+    Duration relocation_time;
+    Duration initialization_time;
+} s_statistics;
+
 Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol(StringView name)
 {
     auto symbol = DynamicObject::HashSymbol { name };
@@ -89,6 +105,22 @@ Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol(
     return {};
 }
 
+Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol_while_linking(StringView name)
+{
+    if (!s_link_time_symbol_cache)
+        return lookup_global_symbol(name);
+
+    ++s_statistics.global_symbol_lookups;
+    if (auto cached_result = s_link_time_symbol_cache->get(name); cached_result.has_value()) {
+        ++s_statistics.cached_global_symbol_lookups;
+        return cached_result.release_value();
+    }
+
+    auto result = lookup_global_symbol(name);
+    s_link_time_symbol_cache->set(name, result);
+    return result;
+}
+
 static Result<NonnullRefPtr<DynamicLoader>, DlErrorMessage> map_library(ByteString const& filepath, int fd)
 {
     VERIFY(filepath.starts_with('/'));
@@ -114,6 +146,10 @@ static Result<NonnullRefPtr<DynamicLoader>, DlErrorMessage> map_library(ByteStri
     auto main_library_object = loader->map();
     s_global_objects.set(filepath, *main_library_object);
 
+    // A new global object might define symbols that previously couldn't be resolved.
+    if (s_link_time_symbol_cache)
+        s_link_time_symbol_cache->clear();
+
     return loader;
 }
 
@@ -374,6 +410,13 @@ static ErrorOr<void, DlErrorMessage> link_main_library(int flags, DependencyOrde
     for (auto& loader : objects.load_order)
         VERIFY(!loader->map());
 
+    // Initializers may dlopen() further libraries, which links them with their own cache.
+    HashMap<StringView, Optional<DynamicObject::SymbolLookupResult>> link_time_symbol_cache;
+    auto* outer_link_time_symbol_cache = exchange(s_link_time_symbol_cache, &link_time_symbol_cache);
+    ScopeGuard restore_link_time_symbol_cache = [&] { s_link_time_symbol_cache = outer_link_time_symbol_cache; };
+
+    auto relocation_start_time = MonotonicTime::now();
+
     // FIXME: Are there any observable differences between doing stages 2 and 3 in topological vs
     //        load order? POSIX says to do relocations in load order but does the order really
     //        matter here?
@@ -413,9 +456,14 @@ static ErrorOr<void, DlErrorMessage> link_main_library(int flags, DependencyOrde
 
     drop_loader_promise("prot_exec"sv);
 
+    auto initialization_start_time = MonotonicTime::now();
+    s_statistics.relocation_time += initialization_start_time - relocation_start_time;
+
     for (auto& loader : objects.topological_order)
         loader->load_stage_4();
 
+    s_statistics.initialization_time += MonotonicTime::now() - initialization_start_time;
+
     return {};
 }
 
@@ -614,6 +662,16 @@ static void __call_fini_functions()
     }
 }
 
+static void print_statistics(size_t object_count)
+{
+    warnln("Loader.so: {}: startup statistics", s_main_program_path);
+    warnln("    objects loaded:         {}", object_count);
+    warnln("    global symbol lookups:  {} ({} cached)", s_statistics.global_symbol_lookups, s_statistics.cached_global_symbol_lookups);
+    warnln("    mapping:                {} us", s_statistics.mapping_time.to_microseconds());
+    warnln("    relocation:             {} us", s_statistics.relocation_time.to_microseconds());
+    warnln("    initialization:         {} us", s_statistics.initialization_time.to_microseconds());
+}
+
 static char** __environ_value()
 {
     return s_envp;
@@ -627,6 +685,14 @@ static void read_environment_variables()
             s_do_breakpoint_trap_before_entry = true;
         }
 
+        constexpr auto debug_options_string = "LD_DEBUG="sv;
+        if (env_string.starts_with(debug_options_string)) {
+            env_string.substring_view(debug_options_string.length()).for_each_split_view(',', SplitBehavior::Nothing, [](StringView option) {
+                if (option == "statistics"sv)
+                    s_print_statistics = true;
+            });
+        }
+
         constexpr auto library_path_string = "LD_LIBRARY_PATH="sv;
         if (env_string.starts_with(library_path_string)) {
             s_ld_library_path = env_string.substring_view(library_path_string.length());
@@ -679,6 +745,8 @@ EntryPointFunction ELF::DynamicLinker::linker_main(ByteString&& main_program_pat
 
     s_main_program_path = main_program_path;
 
+    auto mapping_start_time = MonotonicTime::now();
+
     // NOTE: We always map the main library first, since it may require
     //       placement at a specific address.
     auto result1 = map_library(main_program_path, main_program_fd);
@@ -721,6 +789,7 @@ Examples of static-pie ELF objects are ELF packers, and the system dynamic loade
     }
 
     auto objects = result2.release_value();
+    s_statistics.mapping_time = MonotonicTime::now() - mapping_start_time;
 
     dbgln_if(DYNAMIC_LOAD_DEBUG, "loaded all dependencies");
     for ([[maybe_unused]] auto& object : objects.load_order) {
@@ -738,6 +807,9 @@ Examples of static-pie ELF objects are ELF packers, and the system dynamic loade
 
     drop_loader_promise("rpath"sv);
 
+    if (s_print_statistics)
+        print_statistics(objects.load_order.size());
+
     auto& main_executable_loader = objects.load_order.first();
     auto entry_point = main_executable_loader->image().entry();
     if (main_executable_loader->is_dynamic())
@@ -520,7 +520,7 @@ DynamicLoader::RelocationResult DynamicLoader::do_direct_relocation(DynamicObjec
         // in large inheritance hierarchies are involved, there might be tens of references to
         // the same symbol. We can avoid redundant lookups by keeping track of the previous result.
         if (!cached_result.has_value() || !cached_result.value().symbol.definitely_equals(symbol))
-            cached_result = DynamicLoader::CachedLookupResult { symbol, DynamicLoader::lookup_symbol(symbol) };
+            cached_result = DynamicLoader::CachedLookupResult { symbol, DynamicLoader::lookup_symbol_while_linking(symbol) };
         return cached_result.value().result;
     };
 
@@ -823,6 +823,14 @@ Optional<DynamicObject::SymbolLookupResult> DynamicLoader::lookup_symbol(const E
     return DynamicObject::SymbolLookupResult { symbol.value(), symbol.size(), symbol.address(), symbol.bind(), symbol.type(), &symbol.object() };
 }
 
+Optional<DynamicObject::SymbolLookupResult> DynamicLoader::lookup_symbol_while_linking(const ELF::DynamicObject::Symbol& symbol)
+{
+    if (symbol.is_undefined() || symbol.bind() == STB_WEAK)
+        return DynamicLinker::lookup_global_symbol_while_linking(symbol.name());
+
+    return lookup_symbol(symbol);
+}
+
 void DynamicLoader::compute_topological_order(Vector<NonnullRefPtr<DynamicLoader>>& topological_order)
 {
     VERIFY(m_topological_ordering_state == TopologicalOrderingState::NotVisited);
@@ -81,6 +81,7 @@ public:
     bool is_dynamic() const { return image().is_dynamic(); }
 
     static Optional<DynamicObject::SymbolLookupResult> lookup_symbol(const ELF::DynamicObject::Symbol&);
+    static Optional<DynamicObject::SymbolLookupResult> lookup_symbol_while_linking(const ELF::DynamicObject::Symbol&);
     void copy_initial_tls_data_into(Bytes buffer) const;
 
     DynamicObject& dynamic_object() { return *m_dynamic_object; }
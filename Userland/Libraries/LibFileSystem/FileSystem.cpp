@@ -193,6 +193,31 @@ static ErrorOr<ByteString> get_duplicate_file_name(StringView path)
     return current_name;
 }
 
+static ErrorOr<void> copy_file_contents(Core::File& destination, Core::File& source, struct stat const& source_stat)
+{
+#ifdef AK_OS_SERENITY
+    // Let the kernel move the data over, rather than reading all of it into memory first.
+    if (S_ISREG(source_stat.st_mode)) {
+        while (TRY(Core::System::sendfile(destination.fd(), source.fd(), nullptr, 1 * MiB)) > 0)
+            ;
+        return {};
+    }
+#else
+    (void)source_stat;
+#endif
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(1 * MiB));
+    while (true) {
+        auto bytes_read = TRY(source.read_some(buffer));
+
+        if (bytes_read.is_empty())
+            break;
+
+        TRY(destination.write_until_depleted(bytes_read));
+    }
+    return {};
+}
+
 ErrorOr<void> copy_file(StringView destination_path, StringView source_path, struct stat const& source_stat, Core::File& source, PreserveMode preserve_mode)
 {
     auto destination_or_error = Core::File::open(destination_path, Core::File::OpenMode::Write, 0666);
@@ -208,14 +233,7 @@ ErrorOr<void> copy_file(StringView destination_path, StringView source_path, str
     if (source_stat.st_size > 0)
         TRY(destination->truncate(source_stat.st_size));
 
-    while (true) {
-        auto bytes_read = TRY(source.read_until_eof());
-
-        if (bytes_read.is_empty())
-            break;
-
-        TRY(destination->write_until_depleted(bytes_read));
-    }
+    TRY(copy_file_contents(*destination, source, source_stat));
 
     auto my_umask = umask(0);
     umask(my_umask);
@@ -340,22 +358,46 @@ ErrorOr<void> move_file(StringView destination_path, StringView source_path, Pre
     return Core::System::unlink(source_path);
 }
 
-ErrorOr<void> remove(StringView path, RecursionMode mode)
+static ErrorOr<void> remove_directory(StringView path)
 {
-    if (is_directory(path) && mode == RecursionMode::Allowed) {
-        auto di = Core::DirIterator(path, Core::DirIterator::SkipParentAndBaseDir);
-        if (di.has_error())
-            return di.error();
+    auto di = Core::DirIterator(path, Core::DirIterator::SkipParentAndBaseDir);
+    if (di.has_error())
+        return di.error();
+
+    while (di.has_next()) {
+        auto entry = di.next();
+        if (!entry.has_value())
+            break;
 
-        while (di.has_next())
-            TRY(remove(di.next_full_path(), RecursionMode::Allowed));
+        auto entry_path = LexicalPath::join(path, entry->name).string();
 
-        TRY(Core::System::rmdir(path));
-    } else {
-        TRY(Core::System::unlink(path));
+        // Go by the type we got from the directory listing, so most entries don't need an extra stat().
+        // This also makes sure that we remove symlinks rather than whatever they point to.
+        switch (entry->type) {
+        case Core::DirectoryEntry::Type::Directory:
+            TRY(remove_directory(entry_path));
+            break;
+        case Core::DirectoryEntry::Type::Unknown:
+            TRY(remove(entry_path, RecursionMode::Allowed));
+            break;
+        default:
+            TRY(Core::System::unlink(entry_path));
+            break;
+        }
     }
 
-    return {};
+    if (di.has_error())
+        return di.error();
+
+    return Core::System::rmdir(path);
+}
+
+ErrorOr<void> remove(StringView path, RecursionMode mode)
+{
+    if (is_directory(path) && mode == RecursionMode::Allowed)
+        return remove_directory(path);
+
+    return Core::System::unlink(path);
 }
 
 ErrorOr<off_t> size_from_stat(StringView path)
@@ -135,41 +135,48 @@ void GLContext::gl_end()
     RETURN_WITH_ERROR_IF(!m_in_draw_state, GL_INVALID_OPERATION);
     m_in_draw_state = false;
 
-    sync_device_config();
+    draw_vertex_list(m_current_draw_mode);
+}
 
-    GPU::PrimitiveType primitive_type;
-    switch (m_current_draw_mode) {
+static GPU::PrimitiveType to_primitive_type(GLenum mode)
+{
+    switch (mode) {
     case GL_LINE_LOOP:
-        primitive_type = GPU::PrimitiveType::LineLoop;
-        break;
+        return GPU::PrimitiveType::LineLoop;
     case GL_LINE_STRIP:
-        primitive_type = GPU::PrimitiveType::LineStrip;
-        break;
+        return GPU::PrimitiveType::LineStrip;
     case GL_LINES:
-        primitive_type = GPU::PrimitiveType::Lines;
-        break;
+        return GPU::PrimitiveType::Lines;
     case GL_POINTS:
-        primitive_type = GPU::PrimitiveType::Points;
-        break;
+        return GPU::PrimitiveType::Points;
     case GL_TRIANGLES:
-        primitive_type = GPU::PrimitiveType::Triangles;
-        break;
+        return GPU::PrimitiveType::Triangles;
     case GL_TRIANGLE_STRIP:
     case GL_QUAD_STRIP:
-        primitive_type = GPU::PrimitiveType::TriangleStrip;
-        break;
+        return GPU::PrimitiveType::TriangleStrip;
     case GL_TRIANGLE_FAN:
     case GL_POLYGON:
-        primitive_type = GPU::PrimitiveType::TriangleFan;
-        break;
+        return GPU::PrimitiveType::TriangleFan;
     case GL_QUADS:
-        primitive_type = GPU::PrimitiveType::Quads;
-        break;
+        return GPU::PrimitiveType::Quads;
     default:
         VERIFY_NOT_REACHED();
     }
+}
+
+void GLContext::draw_vertex_list(GLenum mode)
+{
+    sync_device_config();
+
+    m_rasterizer->draw_primitives(to_primitive_type(mode), m_vertex_list);
+    m_vertex_list.clear_with_capacity();
+}
+
+void GLContext::draw_indexed_vertex_list(GLenum mode, Vector<u32> const& indices)
+{
+    sync_device_config();
 
-    m_rasterizer->draw_primitives(primitive_type, m_vertex_list);
+    m_rasterizer->draw_indexed_primitives(to_primitive_type(mode), m_vertex_list, indices);
     m_vertex_list.clear_with_capacity();
 }
 
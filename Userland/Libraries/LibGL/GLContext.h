@@ -254,6 +254,25 @@ private:
 
     ErrorOr<ByteBuffer> build_extension_string();
 
+    // Vertices read from the client arrays by glDrawArrays() or glDrawElements() while compiling a display list.
+    // Attributes whose array was disabled take their current value when the list is executed.
+    struct CompiledVertexArrays {
+        GLenum mode;
+        Vector<GPU::Vertex> vertices;
+        Vector<u32> indices;
+        bool indexed { false };
+        bool color_array_enabled { false };
+        bool normal_array_enabled { false };
+        Vector<bool> texture_coord_arrays_enabled;
+    };
+
+    GPU::Vertex read_vertex_from_client_arrays(int index) const;
+    void read_indexed_vertices_from_client_arrays(GLsizei count, GLenum type, void const* indices);
+    void compile_vertex_arrays(GLenum mode, bool indexed);
+    void draw_compiled_vertex_arrays(CompiledVertexArrays const&);
+    void draw_vertex_list(GLenum mode);
+    void draw_indexed_vertex_list(GLenum mode, Vector<u32> const& indices);
+
     template<typename T>
     T* store_in_listing(T value)
     {
@@ -323,6 +342,8 @@ private:
     FloatVector3 m_current_vertex_normal { 0.0f, 0.0f, 1.0f };
 
     Vector<GPU::Vertex> m_vertex_list;
+    Vector<u32> m_vertex_indices;
+    HashMap<u32, u32> m_vertex_list_index_by_element;
 
     GLenum m_error = GL_NO_ERROR;
     bool m_in_draw_state = false;
@@ -517,10 +538,12 @@ private:
             decltype(&GLContext::gl_get_light),
             decltype(&GLContext::gl_clip_plane),
             decltype(&GLContext::gl_copy_tex_sub_image_2d),
-            decltype(&GLContext::gl_point_size)>;
+            decltype(&GLContext::gl_point_size),
+            decltype(&GLContext::draw_compiled_vertex_arrays)>;
 
         using ExtraSavedArguments = Variant<
-            FloatMatrix4x4>;
+            FloatMatrix4x4,
+            CompiledVertexArrays>;
 
         Vector<NonnullOwnPtr<ExtraSavedArguments>> saved_arguments;
         Vector<FunctionsAndArgs> entries;
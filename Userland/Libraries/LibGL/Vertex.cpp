@@ -89,6 +89,110 @@ void GLContext::gl_array_element(GLint i)
     }
 }
 
+// Reads the vertex at the given index from the client arrays. Attributes without an enabled array take their current
+// value, as if the vertex had been specified through glArrayElement().
+GPU::Vertex GLContext::read_vertex_from_client_arrays(int index) const
+{
+    GPU::Vertex vertex;
+
+    float position[4] { 0.f, 0.f, 0.f, 1.f };
+    read_from_vertex_attribute_pointer(m_client_vertex_pointer, index, position);
+    vertex.position = { position[0], position[1], position[2], position[3] };
+
+    if (m_client_side_color_array_enabled) {
+        float color[4] { 0.f, 0.f, 0.f, 1.f };
+        read_from_vertex_attribute_pointer(m_client_color_pointer, index, color);
+        vertex.color = { color[0], color[1], color[2], color[3] };
+    } else {
+        vertex.color = m_current_vertex_color;
+    }
+
+    for (size_t t = 0; t < m_client_tex_coord_pointer.size(); ++t) {
+        if (m_client_side_texture_coord_array_enabled[t]) {
+            float tex_coords[4] { 0.f, 0.f, 0.f, 1.f };
+            read_from_vertex_attribute_pointer(m_client_tex_coord_pointer[t], index, tex_coords);
+            vertex.tex_coords[t] = { tex_coords[0], tex_coords[1], tex_coords[2], tex_coords[3] };
+        } else {
+            vertex.tex_coords[t] = m_current_vertex_tex_coord[t];
+        }
+    }
+
+    if (m_client_side_normal_array_enabled) {
+        float normal[3];
+        read_from_vertex_attribute_pointer(m_client_normal_pointer, index, normal);
+        vertex.normal = { normal[0], normal[1], normal[2] };
+    } else {
+        vertex.normal = m_current_vertex_normal;
+    }
+
+    return vertex;
+}
+
+// Reads every referenced vertex into the vertex list once and stores the indices into that list. Vertices that are
+// shared by several primitives are then also only transformed and lit once by the device.
+void GLContext::read_indexed_vertices_from_client_arrays(GLsizei count, GLenum type, void const* indices)
+{
+    m_vertex_list_index_by_element.clear_with_capacity();
+    m_vertex_indices.ensure_capacity(count);
+
+    for (int index = 0; index < count; index++) {
+        u32 element = 0;
+        switch (type) {
+        case GL_UNSIGNED_BYTE:
+            element = reinterpret_cast<GLubyte const*>(indices)[index];
+            break;
+        case GL_UNSIGNED_SHORT:
+            element = reinterpret_cast<GLushort const*>(indices)[index];
+            break;
+        case GL_UNSIGNED_INT:
+            element = reinterpret_cast<GLuint const*>(indices)[index];
+            break;
+        }
+
+        auto vertex_index = m_vertex_list_index_by_element.ensure(element, [&] {
+            m_vertex_list.append(read_vertex_from_client_arrays(static_cast<int>(element)));
+            return static_cast<u32>(m_vertex_list.size() - 1);
+        });
+        m_vertex_indices.unchecked_append(vertex_index);
+    }
+}
+
+void GLContext::compile_vertex_arrays(GLenum mode, bool indexed)
+{
+    auto* arrays = store_in_listing(CompiledVertexArrays {
+        .mode = mode,
+        .vertices = m_vertex_list,
+        .indices = indexed ? m_vertex_indices : Vector<u32> {},
+        .indexed = indexed,
+        .color_array_enabled = m_client_side_color_array_enabled,
+        .normal_array_enabled = m_client_side_normal_array_enabled,
+        .texture_coord_arrays_enabled = m_client_side_texture_coord_array_enabled,
+    });
+    append_to_listing<&GLContext::draw_compiled_vertex_arrays>(*arrays);
+}
+
+void GLContext::draw_compiled_vertex_arrays(CompiledVertexArrays const& arrays)
+{
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+
+    m_vertex_list.extend(arrays.vertices);
+    for (auto& vertex : m_vertex_list) {
+        if (!arrays.color_array_enabled)
+            vertex.color = m_current_vertex_color;
+        for (size_t t = 0; t < arrays.texture_coord_arrays_enabled.size(); ++t) {
+            if (!arrays.texture_coord_arrays_enabled[t])
+                vertex.tex_coords[t] = m_current_vertex_tex_coord[t];
+        }
+        if (!arrays.normal_array_enabled)
+            vertex.normal = m_current_vertex_normal;
+    }
+
+    if (arrays.indexed)
+        draw_indexed_vertex_list(arrays.mode, arrays.indices);
+    else
+        draw_vertex_list(arrays.mode);
+}
+
 void GLContext::gl_color(GLfloat r, GLfloat g, GLfloat b, GLfloat a)
 {
     APPEND_TO_CALL_LIST_AND_RETURN_IF_NEEDED(gl_color, r, g, b, a);
@@ -121,8 +225,7 @@ void GLContext::gl_color_pointer(GLint size, GLenum type, GLsizei stride, void c
 
 void GLContext::gl_draw_arrays(GLenum mode, GLint first, GLsizei count)
 {
-    // NOTE: This always dereferences data; display list support is deferred to the
-    //       individual vertex attribute calls such as `gl_color`, `gl_normal` etc.
+    // NOTE: This always dereferences data; display lists store the vertices that were read from the arrays.
     RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
 
     // FIXME: Some modes are still missing (GL_POINTS, GL_LINE_STRIP, GL_LINE_LOOP, GL_LINES)
@@ -136,42 +239,28 @@ void GLContext::gl_draw_arrays(GLenum mode, GLint first, GLsizei count)
 
     RETURN_WITH_ERROR_IF(count < 0, GL_INVALID_VALUE);
 
-    auto last = first + count;
-    gl_begin(mode);
-    for (int i = first; i < last; i++) {
-        if (m_client_side_color_array_enabled) {
-            float color[4] { 0.f, 0.f, 0.f, 1.f };
-            read_from_vertex_attribute_pointer(m_client_color_pointer, i, color);
-            gl_color(color[0], color[1], color[2], color[3]);
-        }
-
-        for (size_t t = 0; t < m_client_tex_coord_pointer.size(); ++t) {
-            if (m_client_side_texture_coord_array_enabled[t]) {
-                float tex_coords[4] { 0.f, 0.f, 0.f, 1.f };
-                read_from_vertex_attribute_pointer(m_client_tex_coord_pointer[t], i, tex_coords);
-                gl_multi_tex_coord(GL_TEXTURE0 + t, tex_coords[0], tex_coords[1], tex_coords[2], tex_coords[3]);
-            }
-        }
+    if (!m_client_side_vertex_array_enabled)
+        return;
 
-        if (m_client_side_normal_array_enabled) {
-            float normal[3];
-            read_from_vertex_attribute_pointer(m_client_normal_pointer, i, normal);
-            gl_normal(normal[0], normal[1], normal[2]);
-        }
-
-        if (m_client_side_vertex_array_enabled) {
-            float vertex[4] { 0.f, 0.f, 0.f, 1.f };
-            read_from_vertex_attribute_pointer(m_client_vertex_pointer, i, vertex);
-            gl_vertex(vertex[0], vertex[1], vertex[2], vertex[3]);
+    auto last = first + count;
+    m_vertex_list.ensure_capacity(count);
+    for (int i = first; i < last; i++)
+        m_vertex_list.unchecked_append(read_vertex_from_client_arrays(i));
+
+    if (should_append_to_listing()) {
+        compile_vertex_arrays(mode, false);
+        if (!should_execute_after_appending_to_listing()) {
+            m_vertex_list.clear_with_capacity();
+            return;
         }
     }
-    gl_end();
+
+    draw_vertex_list(mode);
 }
 
 void GLContext::gl_draw_elements(GLenum mode, GLsizei count, GLenum type, void const* indices)
 {
-    // NOTE: This always dereferences data; display list support is deferred to the
-    //       individual vertex attribute calls such as `gl_color`, `gl_normal` etc.
+    // NOTE: This always dereferences data; display lists store the vertices that were read from the arrays.
     RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
 
     // FIXME: Some modes are still missing (GL_POINTS, GL_LINE_STRIP, GL_LINE_LOOP, GL_LINES)
@@ -196,48 +285,22 @@ void GLContext::gl_draw_elements(GLenum mode, GLsizei count, GLenum type, void c
         index_data = m_element_array_buffer->offset_data(data_offset);
     }
 
-    gl_begin(mode);
-    for (int index = 0; index < count; index++) {
-        int i = 0;
-        switch (type) {
-        case GL_UNSIGNED_BYTE:
-            i = reinterpret_cast<GLubyte const*>(index_data)[index];
-            break;
-        case GL_UNSIGNED_SHORT:
-            i = reinterpret_cast<GLushort const*>(index_data)[index];
-            break;
-        case GL_UNSIGNED_INT:
-            i = reinterpret_cast<GLuint const*>(index_data)[index];
-            break;
-        }
-
-        if (m_client_side_color_array_enabled) {
-            float color[4] { 0.f, 0.f, 0.f, 1.f };
-            read_from_vertex_attribute_pointer(m_client_color_pointer, i, color);
-            gl_color(color[0], color[1], color[2], color[3]);
-        }
+    if (!m_client_side_vertex_array_enabled)
+        return;
 
-        for (size_t t = 0; t < m_client_tex_coord_pointer.size(); ++t) {
-            if (m_client_side_texture_coord_array_enabled[t]) {
-                float tex_coords[4] { 0.f, 0.f, 0.f, 1.f };
-                read_from_vertex_attribute_pointer(m_client_tex_coord_pointer[t], i, tex_coords);
-                gl_multi_tex_coord(GL_TEXTURE0 + t, tex_coords[0], tex_coords[1], tex_coords[2], tex_coords[3]);
-            }
-        }
-
-        if (m_client_side_normal_array_enabled) {
-            float normal[3];
-            read_from_vertex_attribute_pointer(m_client_normal_pointer, i, normal);
-            gl_normal(normal[0], normal[1], normal[2]);
-        }
+    read_indexed_vertices_from_client_arrays(count, type, index_data);
 
-        if (m_client_side_vertex_array_enabled) {
-            float vertex[4] { 0.f, 0.f, 0.f, 1.f };
-            read_from_vertex_attribute_pointer(m_client_vertex_pointer, i, vertex);
-            gl_vertex(vertex[0], vertex[1], vertex[2], vertex[3]);
+    if (should_append_to_listing()) {
+        compile_vertex_arrays(mode, true);
+        if (!should_execute_after_appending_to_listing()) {
+            m_vertex_list.clear_with_capacity();
+            m_vertex_indices.clear_with_capacity();
+            return;
         }
     }
-    gl_end();
+
+    draw_indexed_vertex_list(mode, m_vertex_indices);
+    m_vertex_indices.clear_with_capacity();
 }
 
 void GLContext::gl_normal(GLfloat nx, GLfloat ny, GLfloat nz)
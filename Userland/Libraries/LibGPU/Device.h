@@ -40,6 +40,7 @@ public:
     virtual DeviceInfo info() const = 0;
 
     virtual void draw_primitives(PrimitiveType, Vector<Vertex>& vertices) = 0;
+    virtual void draw_indexed_primitives(PrimitiveType, Vector<Vertex>& vertices, Vector<u32> const& indices) = 0;
     virtual void resize(Gfx::IntSize min_size) = 0;
     virtual void clear_color(FloatVector4 const&) = 0;
     virtual void clear_depth(DepthType) = 0;
@@ -12,13 +12,17 @@
 #include <AK/StringBuilder.h>
 #include <AK/Types.h>
 #include <LibCore/DirIterator.h>
+#include <LibCore/Directory.h>
+#include <LibCore/File.h>
 #include <LibCore/StandardPaths.h>
+#include <LibCore/System.h>
 #include <LibFileSystem/FileSystem.h>
 #include <LibGUI/AbstractView.h>
 #include <LibGUI/FileIconProvider.h>
 #include <LibGUI/FileSystemModel.h>
 #include <LibGUI/Painter.h>
 #include <LibGfx/Bitmap.h>
+#include <LibGfx/ImageFormats/PNGWriter.h>
 #include <LibImageDecoderClient/Client.h>
 #include <LibThreading/BackgroundAction.h>
 #include <LibThreading/MutexProtected.h>
@@ -42,12 +46,14 @@ ModelIndex FileSystemModel::Node::index(int column) const
     VERIFY_NOT_REACHED();
 }
 
-bool FileSystemModel::Node::fetch_data(ByteString const& full_path, bool is_root)
+bool FileSystemModel::Node::fetch_data(ByteString const& full_path, bool is_root, int parent_directory_fd)
 {
     struct stat st;
     int rc;
     if (is_root)
         rc = stat(full_path.characters(), &st);
+    else if (parent_directory_fd != AT_FDCWD)
+        rc = fstatat(parent_directory_fd, LexicalPath::basename(full_path).characters(), &st, AT_SYMLINK_NOFOLLOW);
     else
         rc = lstat(full_path.characters(), &st);
     if (rc < 0) {
@@ -133,7 +139,8 @@ void FileSystemModel::Node::traverse_if_needed()
     Vector<NonnullOwnPtr<Node>> file_children;
 
     for (auto& child_name : child_names) {
-        auto maybe_child = create_child(child_name);
+        // Stat relative to the directory we are already reading, so the kernel doesn't have to walk the full path again for every entry.
+        auto maybe_child = create_child(child_name, di.fd());
         if (!maybe_child)
             continue;
 
@@ -182,12 +189,12 @@ bool FileSystemModel::Node::can_delete_or_move() const
     return m_can_delete_or_move.value();
 }
 
-OwnPtr<FileSystemModel::Node> FileSystemModel::Node::create_child(ByteString const& child_name)
+OwnPtr<FileSystemModel::Node> FileSystemModel::Node::create_child(ByteString const& child_name, int parent_directory_fd)
 {
     ByteString child_path = LexicalPath::join(full_path(), child_name).string();
     auto child = adopt_own(*new Node(m_model));
 
-    bool ok = child->fetch_data(child_path, false);
+    bool ok = child->fetch_data(child_path, false, parent_directory_fd);
     if (!ok)
         return {};
 
@@ -700,11 +707,48 @@ struct ThumbnailCache {
 static Threading::MutexProtected<ThumbnailCache> s_thumbnail_cache {};
 static Threading::MutexProtected<RefPtr<ImageDecoderClient::Client>> s_image_decoder_client {};
 
-static ErrorOr<NonnullRefPtr<Gfx::Bitmap>> render_thumbnail(StringView path)
+// Rendered thumbnails are also kept on disk, so opening a directory again (in any process) doesn't have to decode the
+// possibly huge original images again. A cached thumbnail mirrors the path of its original, and carries its mtime.
+static ByteString thumbnail_cache_directory()
 {
-    Core::EventLoop event_loop;
-    Gfx::IntSize const thumbnail_size { 32, 32 };
+    return ByteString::formatted("{}/thumbnails", Core::StandardPaths::cache_directory());
+}
 
+static ByteString cached_thumbnail_path_for(StringView path, Gfx::IntSize thumbnail_size)
+{
+    return ByteString::formatted("{}/{}x{}{}.png", thumbnail_cache_directory(), thumbnail_size.width(), thumbnail_size.height(), path);
+}
+
+static bool is_cached_thumbnail_up_to_date(StringView cached_thumbnail_path, struct stat const& original_stat)
+{
+    auto cached_stat = Core::System::stat(cached_thumbnail_path);
+    if (cached_stat.is_error())
+        return false;
+    return cached_stat.value().st_mtim.tv_sec == original_stat.st_mtim.tv_sec
+        && cached_stat.value().st_mtim.tv_nsec == original_stat.st_mtim.tv_nsec;
+}
+
+static ErrorOr<void> store_cached_thumbnail(ByteString const& cached_thumbnail_path, Gfx::Bitmap const& thumbnail, struct stat const& original_stat)
+{
+    TRY(Core::Directory::create(LexicalPath(cached_thumbnail_path).parent(), Core::Directory::CreateDirectories::Yes, 0700));
+
+    // Write to a temporary file first, so other processes never see a partially written thumbnail.
+    auto temporary_path = ByteString::formatted("{}.{}", cached_thumbnail_path, getpid());
+    auto encoded_thumbnail = TRY(Gfx::PNGWriter::encode(thumbnail));
+    auto file = TRY(Core::File::open(temporary_path, Core::File::OpenMode::Write | Core::File::OpenMode::Truncate, 0600));
+    TRY(file->write_until_depleted(encoded_thumbnail));
+    file->close();
+
+    struct timespec const times[2] = { { 0, UTIME_OMIT }, original_stat.st_mtim };
+    if (auto result = Core::System::utimensat(AT_FDCWD, temporary_path, times, 0); result.is_error()) {
+        (void)Core::System::unlink(temporary_path);
+        return result.release_error();
+    }
+    return Core::System::rename(temporary_path, cached_thumbnail_path);
+}
+
+static ErrorOr<NonnullRefPtr<Gfx::Bitmap>> decode_thumbnail(StringView path, Gfx::IntSize thumbnail_size)
+{
     auto file = TRY(Core::MappedFile::map(path));
     auto decoded_image = TRY(s_image_decoder_client.with_locked([=, &file](auto& maybe_client) -> ErrorOr<Optional<ImageDecoderClient::DecodedImage>> {
         if (!maybe_client) {
@@ -736,6 +780,30 @@ static ErrorOr<NonnullRefPtr<Gfx::Bitmap>> render_thumbnail(StringView path)
     return thumbnail;
 }
 
+static ErrorOr<NonnullRefPtr<Gfx::Bitmap>> render_thumbnail(StringView path)
+{
+    Core::EventLoop event_loop;
+    Gfx::IntSize const thumbnail_size { 32, 32 };
+
+    // Don't cache thumbnails of the cached thumbnails themselves.
+    if (path.starts_with(thumbnail_cache_directory()))
+        return decode_thumbnail(path, thumbnail_size);
+
+    auto original_stat = TRY(Core::System::stat(path));
+    auto cached_thumbnail_path = cached_thumbnail_path_for(path, thumbnail_size);
+    if (is_cached_thumbnail_up_to_date(cached_thumbnail_path, original_stat)) {
+        // If the cached thumbnail turns out to be unusable, just render it again.
+        if (auto cached_thumbnail = decode_thumbnail(cached_thumbnail_path, thumbnail_size); !cached_thumbnail.is_error())
+            return cached_thumbnail.release_value();
+    }
+
+    auto thumbnail = TRY(decode_thumbnail(path, thumbnail_size));
+    // Failing to write the cache (e.g. because we can't write to it) shouldn't keep us from showing the thumbnail.
+    if (auto result = store_cached_thumbnail(cached_thumbnail_path, thumbnail, original_stat); result.is_error())
+        dbgln("Failed to cache thumbnail for {}: {}", path, result.error());
+    return thumbnail;
+}
+
 bool FileSystemModel::fetch_thumbnail_for(Node const& node)
 {
     auto path = node.full_path();
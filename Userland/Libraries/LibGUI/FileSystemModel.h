@@ -12,6 +12,7 @@
 #include <LibCore/ElapsedTimer.h>
 #include <LibCore/FileWatcher.h>
 #include <LibGUI/Model.h>
+#include <fcntl.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <time.h>
@@ -97,9 +98,9 @@ public:
         ModelIndex index(int column) const;
         void traverse_if_needed();
         void reify_if_needed();
-        bool fetch_data(ByteString const& full_path, bool is_root);
+        bool fetch_data(ByteString const& full_path, bool is_root, int parent_directory_fd = AT_FDCWD);
 
-        OwnPtr<Node> create_child(ByteString const& child_name);
+        OwnPtr<Node> create_child(ByteString const& child_name, int parent_directory_fd = AT_FDCWD);
     };
 
     static NonnullRefPtr<FileSystemModel> create(Optional<ByteString> root_path = "/", Mode mode = Mode::FilesAndDirectories)
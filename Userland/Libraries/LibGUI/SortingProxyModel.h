@@ -38,7 +38,7 @@ public:
 
     virtual bool is_column_sortable(int column_index) const override;
 
-    virtual bool less_than(ModelIndex const&, ModelIndex const&) const;
+    bool less_than(ModelIndex const&, ModelIndex const&) const;
 
     ModelIndex map_to_source(ModelIndex const&) const;
     ModelIndex map_to_proxy(ModelIndex const&) const;
@@ -61,6 +61,7 @@ private:
 
     using InternalMapIterator = HashMap<ModelIndex, NonnullOwnPtr<Mapping>>::IteratorType;
 
+    Variant sort_key(ModelIndex const&) const;
     void sort_mapping(Mapping&, int column, SortOrder);
 
     // ^ModelClient
@@ -13,6 +13,7 @@
 #include <AK/ScopeGuard.h>
 #include <AK/StdLibExtras.h>
 #include <AK/StringBuilder.h>
+#include <AK/TemporaryChange.h>
 #include <AK/Utf8View.h>
 #include <LibCore/Timer.h>
 #include <LibGUI/TextDocument.h>
@@ -123,6 +124,29 @@ void TextDocument::insert_line(size_t line_index, NonnullOwnPtr<TextDocumentLine
     }
 }
 
+void TextDocument::insert_lines(size_t line_index, Vector<NonnullOwnPtr<TextDocumentLine>> new_lines)
+{
+    auto count = new_lines.size();
+    if (count == 0)
+        return;
+
+    // Rebuild the line list in one go, rather than shifting the following lines down once per inserted line.
+    Vector<NonnullOwnPtr<TextDocumentLine>> lines;
+    lines.ensure_capacity(m_lines.size() + count);
+    for (size_t i = 0; i < line_index; ++i)
+        lines.unchecked_append(move(m_lines[i]));
+    for (auto& line : new_lines)
+        lines.unchecked_append(move(line));
+    for (size_t i = line_index; i < m_lines.size(); ++i)
+        lines.unchecked_append(move(m_lines[i]));
+    m_lines = move(lines);
+
+    if (m_client_notifications_enabled) {
+        for (auto* client : m_clients)
+            client->document_did_insert_lines(line_index, count);
+    }
+}
+
 NonnullOwnPtr<TextDocumentLine> TextDocument::take_line(size_t line_index)
 {
     auto line = lines().take(line_index);
@@ -1050,13 +1074,62 @@ void UncommentSelection::redo()
     m_document.set_all_cursors(m_range.start());
 }
 
-TextPosition TextDocument::insert_at(TextPosition const& position, StringView text, Client const* client)
+TextPosition TextDocument::insert_at(TextPosition const& position, StringView text, Client const*)
 {
-    TextPosition cursor = position;
-    Utf8View utf8_view(text);
-    for (auto code_point : utf8_view)
-        cursor = insert_at(cursor, code_point, client);
-    return cursor;
+    if (text.is_empty())
+        return position;
+
+    auto append_code_points = [](Vector<u32>& code_points, StringView segment) {
+        for (auto code_point : Utf8View { segment })
+            code_points.append(code_point);
+    };
+
+    // Build each affected line in full before handing it to the document, so that clients are only
+    // notified once per line (and once overall), rather than once for every inserted code point.
+    auto segments = text.split_view('\n', SplitBehavior::KeepEmpty);
+    auto& first_line = line(position.line());
+
+    Vector<u32> rest_of_first_line;
+    rest_of_first_line.append(first_line.code_points() + position.column(), first_line.length() - position.column());
+
+    Vector<u32> first_line_text;
+    first_line_text.append(first_line.code_points(), position.column());
+    append_code_points(first_line_text, segments.first());
+
+    if (segments.size() == 1) {
+        auto column = first_line_text.size();
+        first_line_text.extend(move(rest_of_first_line));
+        first_line.set_text(*this, move(first_line_text));
+        return { position.line(), column };
+    }
+
+    size_t last_column = 0;
+    Vector<NonnullOwnPtr<TextDocumentLine>> new_lines;
+    {
+        TemporaryChange disable_notifications { m_client_notifications_enabled, false };
+
+        first_line.set_text(*this, move(first_line_text));
+
+        new_lines.ensure_capacity(segments.size() - 1);
+        for (size_t i = 1; i < segments.size(); ++i) {
+            Vector<u32> line_text;
+            append_code_points(line_text, segments[i]);
+            if (i == segments.size() - 1) {
+                last_column = line_text.size();
+                line_text.extend(move(rest_of_first_line));
+            }
+
+            auto new_line = make<TextDocumentLine>(*this);
+            new_line->set_text(*this, move(line_text));
+            new_lines.unchecked_append(move(new_line));
+        }
+    }
+
+    auto inserted_line_count = new_lines.size();
+    insert_lines(position.line() + 1, move(new_lines));
+    notify_did_change();
+
+    return { position.line() + inserted_line_count, last_column };
 }
 
 TextPosition TextDocument::insert_at(TextPosition const& position, u32 code_point, Client const*)
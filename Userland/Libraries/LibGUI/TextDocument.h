@@ -46,6 +46,7 @@ public:
         virtual ~Client() = default;
         virtual void document_did_append_line() = 0;
         virtual void document_did_insert_line(size_t) = 0;
+        virtual void document_did_insert_lines(size_t first_line_index, size_t count) = 0;
         virtual void document_did_remove_line(size_t) = 0;
         virtual void document_did_remove_all_lines() = 0;
         virtual void document_did_change(AllowCallback = AllowCallback::Yes) = 0;
@@ -78,6 +79,7 @@ public:
     void remove_line(size_t line_index);
     void remove_all_lines();
     void insert_line(size_t line_index, NonnullOwnPtr<TextDocumentLine>);
+    void insert_lines(size_t line_index, Vector<NonnullOwnPtr<TextDocumentLine>>);
 
     void register_client(Client&);
     void unregister_client(Client&);
@@ -2277,6 +2277,22 @@ void TextEditor::document_did_insert_line(size_t line_index)
     update();
 }
 
+void TextEditor::document_did_insert_lines(size_t first_line_index, size_t count)
+{
+    Vector<NonnullOwnPtr<LineData>> line_data;
+    line_data.ensure_capacity(m_line_data.size() + count);
+    for (size_t i = 0; i < first_line_index; ++i)
+        line_data.unchecked_append(move(m_line_data[i]));
+    for (size_t i = 0; i < count; ++i)
+        line_data.unchecked_append(make<LineData>());
+    for (size_t i = first_line_index; i < m_line_data.size(); ++i)
+        line_data.unchecked_append(move(m_line_data[i]));
+    m_line_data = move(line_data);
+
+    recompute_all_visual_lines();
+    update();
+}
+
 void TextEditor::document_did_change(AllowCallback allow_callback)
 {
     did_change(allow_callback);
@@ -299,6 +299,7 @@ private:
     // ^TextDocument::Client
     virtual void document_did_append_line() override;
     virtual void document_did_insert_line(size_t) override;
+    virtual void document_did_insert_lines(size_t first_line_index, size_t count) override;
     virtual void document_did_remove_line(size_t) override;
     virtual void document_did_remove_all_lines() override;
     virtual void document_did_change(AllowCallback = AllowCallback::Yes) override;
@@ -261,6 +261,16 @@ public:
         if (source.alpha() == 0)
             return *this;
 
+        // Over an opaque color the divisor below is always 255 * 255, so we can skip the divisions by a variable.
+        if (alpha() == 255) {
+            int const source_weight = source.alpha();
+            int const destination_weight = 255 - source_weight;
+            u8 r = (red() * destination_weight + source.red() * source_weight) / 255;
+            u8 g = (green() * destination_weight + source.green() * source_weight) / 255;
+            u8 b = (blue() * destination_weight + source.blue() * source_weight) / 255;
+            return Color(r, g, b, 255);
+        }
+
         int const d = 255 * (alpha() + source.alpha()) - alpha() * source.alpha();
         u8 r = (red() * alpha() * (255 - source.alpha()) + source.red() * 255 * source.alpha()) / d;
         u8 g = (green() * alpha() * (255 - source.alpha()) + source.green() * 255 * source.alpha()) / d;
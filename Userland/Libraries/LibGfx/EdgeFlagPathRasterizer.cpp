@@ -5,6 +5,7 @@
  */
 
 #include <AK/Array.h>
+#include <AK/BuiltinWrappers.h>
 #include <AK/Debug.h>
 #include <AK/IntegralMath.h>
 #include <AK/Types.h>
@@ -327,17 +328,16 @@ auto EdgeFlagPathRasterizer<SamplesPerPixel>::accumulate_non_zero_scanline(EdgeE
     VERIFY(edge_extent.max_x < static_cast<int>(m_scanline.size()));
     for (int x = edge_extent.min_x; x <= edge_extent.max_x; x += 1) {
         if (auto edges = m_scanline.data()[x]) {
-            // We only need to process the windings when we hit some edges.
-            for (auto y_sub = 0u; y_sub < SamplesPerPixel; y_sub++) {
+            // We only need to process the windings when we hit some edges, and only for the subpixels that have one.
+            for (; edges; edges &= edges - 1) {
+                auto y_sub = count_trailing_zeroes(edges);
                 auto subpixel_bit = 1 << y_sub;
-                if (edges & subpixel_bit) {
-                    auto winding = m_windings.data()[x].counts[y_sub];
-                    auto previous_winding_count = acc.winding.counts[y_sub];
-                    acc.winding.counts[y_sub] += winding;
-                    // Toggle fill on change to/from zero.
-                    if (bool(previous_winding_count) ^ bool(acc.winding.counts[y_sub]))
-                        acc.sample ^= subpixel_bit;
-                }
+                auto winding = m_windings.data()[x].counts[y_sub];
+                auto previous_winding_count = acc.winding.counts[y_sub];
+                acc.winding.counts[y_sub] += winding;
+                // Toggle fill on change to/from zero.
+                if (bool(previous_winding_count) ^ bool(acc.winding.counts[y_sub]))
+                    acc.sample ^= subpixel_bit;
             }
         }
         sample_callback(x, acc.sample);
@@ -369,11 +369,14 @@ void EdgeFlagPathRasterizer<SamplesPerPixel>::write_pixel(BitmapFormat format, A
 }
 
 template<unsigned SamplesPerPixel>
-void EdgeFlagPathRasterizer<SamplesPerPixel>::fast_fill_solid_color_span(ARGB32* scanline_ptr, int start, int end, Color color)
+void EdgeFlagPathRasterizer<SamplesPerPixel>::fast_fill_solid_color_span(Painter& painter, ARGB32* scanline_ptr, int scanline, int start, int end, Color color)
 {
     auto start_x = start + m_blit_origin.x();
     auto end_x = end + m_blit_origin.x();
-    fast_u32_fill(scanline_ptr + start_x, color.value(), end_x - start_x + 1);
+    if (color.alpha() == 255)
+        return fast_u32_fill(scanline_ptr + start_x, color.value(), end_x - start_x + 1);
+    // Fully covered pixels get the paint color as is, so the whole span can be blended at once.
+    painter.fill_physical_rect({ start_x, scanline + m_blit_origin.y(), end_x - start_x + 1, 1 }, color);
 }
 
 template<unsigned SamplesPerPixel>
@@ -407,11 +410,9 @@ FLATTEN __attribute__((hot)) void EdgeFlagPathRasterizer<SamplesPerPixel>::write
             write_pixel(dest_format, dest_ptr, scanline, x, sample, color_or_function);
         });
     };
-    // Fast fill case: Track spans of solid color and set the entire span via a fast_u32_fill().
-    // Used for opaque colors (i.e. alpha == 255).
+    // Fast fill case: Track spans of full coverage and fill or blend the entire span at once.
+    // Used for solid colors.
     auto write_scanline_with_fast_fills = [&](Color color) {
-        if (color.alpha() != 255)
-            return write_scanline_pixelwise(color);
         constexpr SampleType full_converage = NumericLimits<SampleType>::max();
         int full_converage_count = 0;
         accumulate_scanline<WindingRule>(clipped_extent, acc, [&](int x, SampleType sample) {
@@ -422,12 +423,12 @@ FLATTEN __attribute__((hot)) void EdgeFlagPathRasterizer<SamplesPerPixel>::write
                 write_pixel(dest_format, dest_ptr, scanline, x, sample, color);
             }
             if (full_converage_count > 0) {
-                fast_fill_solid_color_span(dest_ptr, x - full_converage_count, x - 1, color);
+                fast_fill_solid_color_span(painter, dest_ptr, scanline, x - full_converage_count, x - 1, color);
                 full_converage_count = 0;
             }
         });
         if (full_converage_count > 0)
-            fast_fill_solid_color_span(dest_ptr, clipped_extent.max_x - full_converage_count + 1, clipped_extent.max_x, color);
+            fast_fill_solid_color_span(painter, dest_ptr, scanline, clipped_extent.max_x - full_converage_count + 1, clipped_extent.max_x, color);
     };
     switch_on_color_or_function(
         color_or_function, write_scanline_with_fast_fills, write_scanline_pixelwise);
@@ -7,6 +7,9 @@
 #pragma once
 
 #include "Filter.h"
+#include <AK/Array.h>
+#include <AK/Math.h>
+#include <AK/Optional.h>
 #include <AK/StringView.h>
 #include <LibGfx/Matrix.h>
 #include <LibGfx/Matrix4x4.h>
@@ -101,40 +104,90 @@ public:
 
         Bitmap* render_target_bitmap = (&target != &source) ? &target : apply_cache.m_target.ptr();
 
-        // FIXME: Help! I am naive!
+        // Kernel rows are indexed by the x offset, columns by the y offset.
         constexpr static ssize_t offset = N / 2;
-        for (auto i_ = 0; i_ < target_rect.width(); ++i_) {
-            ssize_t i = i_ + target_rect.x();
-            for (auto j_ = 0; j_ < target_rect.height(); ++j_) {
-                ssize_t j = j_ + target_rect.y();
-                FloatVector3 value(0, 0, 0);
-                for (auto k = 0l; k < (ssize_t)N; ++k) {
-                    auto ki = i + k - offset;
-                    if (ki < source_rect.x() || ki >= source_rect.right()) {
-                        if (parameters.should_wrap())
-                            ki = (ki + source.size().width()) % source.size().width(); // TODO: fix up using source_rect
-                        else
+        auto const source_x = [&](ssize_t x) -> Optional<ssize_t> {
+            if (x >= source_rect.x() && x < source_rect.right())
+                return x;
+            if (!parameters.should_wrap())
+                return {};
+            return (x + source.size().width()) % source.size().width(); // TODO: fix up using source_rect
+        };
+        auto const source_y = [&](ssize_t y) -> Optional<ssize_t> {
+            if (y >= source_rect.y() && y < source_rect.bottom())
+                return y;
+            if (!parameters.should_wrap())
+                return {};
+            return (y + source.size().height()) % source.size().height(); // TODO: fix up using source_rect
+        };
+        auto const store = [&](ssize_t i, ssize_t j, FloatVector3 value) {
+            value.clamp(0, 255);
+            render_target_bitmap->set_pixel(i, j, Color(value.x(), value.y(), value.z(), source.get_pixel(i + source_delta_x, j + source_delta_y).alpha()));
+        };
+
+        // Blur kernels are the product of a horizontal and a vertical kernel. Those are applied as two passes of N
+        // samples each, instead of one pass of N * N samples.
+        if (auto separated_kernel = separate(parameters.kernel()); separated_kernel.has_value()) {
+            auto const& [horizontal_kernel, vertical_kernel] = *separated_kernel;
+
+            // The horizontal pass covers the N / 2 rows above and below the target rect as well, one row of
+            // `target_rect.width()` results each. Rows outside of the source are marked as missing.
+            auto row_count = target_rect.height() + N - 1;
+            Vector<FloatVector3> horizontal_pass;
+            horizontal_pass.resize(row_count * target_rect.width());
+            Vector<bool> row_is_present;
+            row_is_present.resize(row_count);
+
+            for (size_t row = 0; row < row_count; ++row) {
+                auto lj = source_y(target_rect.y() + static_cast<ssize_t>(row) - offset);
+                row_is_present[row] = lj.has_value();
+                if (!lj.has_value())
+                    continue;
+                for (auto i_ = 0; i_ < target_rect.width(); ++i_) {
+                    ssize_t i = i_ + target_rect.x();
+                    FloatVector3 value(0, 0, 0);
+                    for (auto k = 0l; k < (ssize_t)N; ++k) {
+                        auto ki = source_x(i + k - offset);
+                        if (!ki.has_value())
                             continue;
+                        auto pixel = source.get_pixel(*ki, *lj);
+                        value = value + FloatVector3(pixel.red(), pixel.green(), pixel.blue()) * horizontal_kernel[k];
                     }
+                    horizontal_pass[row * target_rect.width() + i_] = value;
+                }
+            }
 
+            for (auto j_ = 0; j_ < target_rect.height(); ++j_) {
+                for (auto i_ = 0; i_ < target_rect.width(); ++i_) {
+                    FloatVector3 value(0, 0, 0);
+                    for (auto l = 0ul; l < N; ++l) {
+                        if (row_is_present[j_ + l])
+                            value = value + horizontal_pass[(j_ + l) * target_rect.width() + i_] * vertical_kernel[l];
+                    }
+                    store(i_ + target_rect.x(), j_ + target_rect.y(), value);
+                }
+            }
+        } else {
+            // Go row by row, so that neighboring samples are next to each other in memory.
+            for (auto j_ = 0; j_ < target_rect.height(); ++j_) {
+                ssize_t j = j_ + target_rect.y();
+                for (auto i_ = 0; i_ < target_rect.width(); ++i_) {
+                    ssize_t i = i_ + target_rect.x();
+                    FloatVector3 value(0, 0, 0);
                     for (auto l = 0l; l < (ssize_t)N; ++l) {
-                        auto lj = j + l - offset;
-                        if (lj < source_rect.y() || lj >= source_rect.bottom()) {
-                            if (parameters.should_wrap())
-                                lj = (lj + source.size().height()) % source.size().height(); // TODO: fix up using source_rect
-                            else
+                        auto lj = source_y(j + l - offset);
+                        if (!lj.has_value())
+                            continue;
+                        for (auto k = 0l; k < (ssize_t)N; ++k) {
+                            auto ki = source_x(i + k - offset);
+                            if (!ki.has_value())
                                 continue;
+                            auto pixel = source.get_pixel(*ki, *lj);
+                            value = value + FloatVector3(pixel.red(), pixel.green(), pixel.blue()) * parameters.kernel().elements()[k][l];
                         }
-
-                        auto pixel = source.get_pixel(ki, lj);
-                        FloatVector3 pixel_value(pixel.red(), pixel.green(), pixel.blue());
-
-                        value = value + pixel_value * parameters.kernel().elements()[k][l];
                     }
+                    store(i, j, value);
                 }
-
-                value.clamp(0, 255);
-                render_target_bitmap->set_pixel(i, j, Color(value.x(), value.y(), value.z(), source.get_pixel(i + source_delta_x, j + source_delta_y).alpha()));
             }
         }
 
@@ -149,6 +202,47 @@ public:
             }
         }
     }
+
+private:
+    struct SeparatedKernel {
+        Array<float, N> horizontal;
+        Array<float, N> vertical;
+    };
+
+    // Returns the two one-dimensional kernels whose product is `kernel`, if there are any.
+    static Optional<SeparatedKernel> separate(Gfx::Matrix<N, float> const& kernel)
+    {
+        auto const& elements = kernel.elements();
+
+        // Divide by the largest element, to stay away from the rounding errors of tiny ones.
+        size_t pivot_k = 0;
+        size_t pivot_l = 0;
+        for (size_t k = 0; k < N; ++k) {
+            for (size_t l = 0; l < N; ++l) {
+                if (AK::fabs(elements[k][l]) > AK::fabs(elements[pivot_k][pivot_l])) {
+                    pivot_k = k;
+                    pivot_l = l;
+                }
+            }
+        }
+        auto pivot = elements[pivot_k][pivot_l];
+        if (pivot == 0)
+            return {};
+
+        SeparatedKernel separated;
+        for (size_t i = 0; i < N; ++i) {
+            separated.horizontal[i] = elements[i][pivot_l];
+            separated.vertical[i] = elements[pivot_k][i] / pivot;
+        }
+
+        for (size_t k = 0; k < N; ++k) {
+            for (size_t l = 0; l < N; ++l) {
+                if (AK::fabs(separated.horizontal[k] * separated.vertical[l] - elements[k][l]) > AK::fabs(pivot) * 1e-5f)
+                    return {};
+            }
+        }
+        return separated;
+    }
 };
 
 }
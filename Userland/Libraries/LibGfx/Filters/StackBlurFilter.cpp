@@ -12,8 +12,10 @@
 #include <AK/Array.h>
 #include <AK/IntegralMath.h>
 #include <AK/Math.h>
+#include <AK/SIMD.h>
 #include <AK/Vector.h>
 #include <LibGfx/Filters/StackBlurFilter.h>
+#include <LibThreading/Parallel.h>
 
 namespace Gfx {
 
@@ -39,274 +41,194 @@ constexpr auto mult_table = [] {
     return lut;
 }();
 
-// Note: This is named to be consistent with the algorithm, but it's actually a simple circular buffer.
-struct BlurStack {
-    BlurStack(size_t size)
-    {
-        m_data.resize(size);
-    }
-
-    struct Iterator {
-        friend BlurStack;
-
-        ALWAYS_INLINE Color& operator*()
-        {
-            return m_data.at(m_idx);
-        }
+using AK::SIMD::u32x4;
 
-        ALWAYS_INLINE Color* operator->()
-        {
-            return &m_data.at(m_idx);
-        }
-
-        ALWAYS_INLINE Iterator operator++()
-        {
-            // Note: This seemed to profile slightly better than %
-            if (++m_idx >= m_data.size())
-                m_idx = 0;
-            return *this;
-        }
+// Lines are blurred in bands of this many lines that move along in lockstep. For the vertical pass, this means that
+// each step reads one cache line of adjacent pixels instead of a single pixel from a different row.
+static constexpr size_t lines_per_band = 16;
 
-        ALWAYS_INLINE Iterator operator++(int)
-        {
-            auto prev_it = *this;
-            ++*(this);
-            return prev_it;
-        }
+// Below this, spreading the blur over several threads costs more than it saves.
+static constexpr size_t parallel_blur_threshold_in_pixels = 256 * 256;
 
-    private:
-        Iterator(size_t idx, Span<Color> data)
-            : m_idx(idx)
-            , m_data(data)
-        {
-        }
+static Threading::TaskPool& task_pool()
+{
+    static Threading::TaskPool pool;
+    return pool;
+}
 
-        size_t m_idx;
-        Span<Color> m_data;
-    };
+ALWAYS_INLINE static u32x4 unpack_channels(ARGB32 pixel)
+{
+    AK::SIMD::u8x4 channels;
+    __builtin_memcpy(&channels, &pixel, sizeof(channels));
+    return __builtin_convertvector(channels, u32x4);
+}
 
-    Iterator iterator_from_position(size_t position)
-    {
-        VERIFY(position < m_data.size());
-        return Iterator(position, m_data);
-    }
+ALWAYS_INLINE static ARGB32 pack_channels(u32x4 channels)
+{
+    auto const bytes = __builtin_convertvector(channels, AK::SIMD::u8x4);
+    ARGB32 pixel;
+    __builtin_memcpy(&pixel, &bytes, sizeof(pixel));
+    return pixel;
+}
 
-private:
-    Vector<Color, 512> m_data;
+struct BlurParameters {
+    uint radius;
+    uint length;
+    ARGB32 fill_color;
 };
 
+// Blurs `line_count` lines of `length` pixels, which start at `first_pixel`. Consecutive lines start `line_step`
+// pixels apart, and consecutive pixels of a line are `pixel_step` pixels apart.
+//
 // This is an implementation of StackBlur by Mario Klingemann (https://observablehq.com/@jobleonard/mario-klingemans-stackblur)
 // (Link is to a secondary source as the original site is now down)
-FLATTEN void StackBlurFilter::process_rgba(u8 radius, Color fill_color)
+static void blur_band(ARGB32* first_pixel, size_t line_step, size_t pixel_step, size_t line_count, BlurParameters const& parameters)
 {
-    // TODO: Implement a plain RGB version of this (if required)
+    VERIFY(line_count <= lines_per_band);
+
+    uint const radius = parameters.radius;
+    uint const length = parameters.length;
+    uint const div = 2 * radius + 1;
+    uint const radius_plus_1 = radius + 1;
+    uint const sum_factor = radius_plus_1 * (radius_plus_1 + 1) / 2;
+    u32 const sum_mult = mult_table[radius - 1];
+    u32 const sum_shift = shift_table[radius - 1];
+
+    // Fully transparent pixels are blurred as if they had the fill color, so that they don't darken their neighbors.
+    auto const get_pixel = [&](size_t line, uint position) {
+        ARGB32 pixel = first_pixel[line * line_step + position * pixel_step];
+        return (pixel >> 24) == 0 ? parameters.fill_color : pixel;
+    };
 
-    if (radius == 0)
-        return;
+    // All the sums here work to approximate a gaussian. Each holds the four channels of one line.
+    // Note: Only about 17 bits are actually used in each sum.
+    Array<u32x4, lines_per_band> in_sums {};
+    Array<u32x4, lines_per_band> out_sums {};
+    Array<u32x4, lines_per_band> sums {};
+
+    // Note: This is named to be consistent with the algorithm, but it's actually a simple circular buffer.
+    // It holds the last `div` pixels of each line, interleaved so that one step of the band touches a single row of it.
+    Vector<ARGB32, lines_per_band * 64> blur_stack;
+    blur_stack.resize(div * lines_per_band);
+    auto const stack_entry = [&](uint index, size_t line) -> ARGB32& {
+        return blur_stack[index * lines_per_band + line];
+    };
 
-    fill_color = fill_color.with_alpha(0);
+    for (size_t line = 0; line < line_count; ++line) {
+        auto color = get_pixel(line, 0);
+        for (uint i = 0; i < radius_plus_1; i++)
+            stack_entry(i, line) = color;
 
-    uint width = m_bitmap.width();
-    uint height = m_bitmap.height();
+        auto channels = unpack_channels(color);
+        in_sums[line] = u32x4 {};
+        out_sums[line] = radius_plus_1 * channels;
+        sums[line] = sum_factor * channels;
 
-    uint div = 2 * radius + 1;
-    uint radius_plus_1 = radius + 1;
-    uint sum_factor = radius_plus_1 * (radius_plus_1 + 1) / 2;
+        for (uint i = 1; i <= radius; i++) {
+            auto color = get_pixel(line, min(i, length - 1));
+            stack_entry(radius + i, line) = color;
 
-    auto get_pixel = [&](int x, int y) {
-        auto color = m_bitmap.get_pixel<StorageFormat::BGRA8888>(x, y);
-        if (color.alpha() == 0)
-            return fill_color;
-        return color;
-    };
+            auto channels = unpack_channels(color);
+            sums[line] += channels * (radius_plus_1 - i);
+            in_sums[line] += channels;
+        }
+    }
 
-    auto set_pixel = [&](int x, int y, Color color) {
-        return m_bitmap.set_pixel<StorageFormat::BGRA8888>(x, y, color);
-    };
+    uint stack_in = 0;
+    uint stack_out = radius_plus_1;
+    for (uint position = 0; position < length; position++) {
+        // The pixel that enters the stack is always ahead of the one that is written, so this works in place.
+        auto const incoming_position = min(position + radius_plus_1, length - 1);
 
-    BlurStack blur_stack { div };
-    auto const stack_start = blur_stack.iterator_from_position(0);
-    auto const stack_end = blur_stack.iterator_from_position(radius_plus_1);
-    auto stack_iterator = stack_start;
+        for (size_t line = 0; line < line_count; ++line) {
+            auto blurred = (sums[line] * sum_mult) >> sum_shift;
+            first_pixel[line * line_step + position * pixel_step] = blurred[3] != 0 ? pack_channels(blurred) : parameters.fill_color;
 
-    auto const sum_mult = mult_table[radius - 1];
-    auto const sum_shift = shift_table[radius - 1];
+            sums[line] -= out_sums[line];
+            out_sums[line] -= unpack_channels(stack_entry(stack_in, line));
 
-    for (uint y = 0; y < height; y++) {
-        stack_iterator = stack_start;
+            auto color = get_pixel(line, incoming_position);
+            stack_entry(stack_in, line) = color;
+            in_sums[line] += unpack_channels(color);
+            sums[line] += in_sums[line];
 
-        auto color = get_pixel(0, y);
-        for (uint i = 0; i < radius_plus_1; i++)
-            *(stack_iterator++) = color;
-
-        // All the sums here work to approximate a gaussian.
-        // Note: Only about 17 bits are actually used in each sum.
-        uint red_in_sum = 0;
-        uint green_in_sum = 0;
-        uint blue_in_sum = 0;
-        uint alpha_in_sum = 0;
-        uint red_out_sum = radius_plus_1 * color.red();
-        uint green_out_sum = radius_plus_1 * color.green();
-        uint blue_out_sum = radius_plus_1 * color.blue();
-        uint alpha_out_sum = radius_plus_1 * color.alpha();
-        uint red_sum = sum_factor * color.red();
-        uint green_sum = sum_factor * color.green();
-        uint blue_sum = sum_factor * color.blue();
-        uint alpha_sum = sum_factor * color.alpha();
+            auto outgoing = unpack_channels(stack_entry(stack_out, line));
+            out_sums[line] += outgoing;
+            in_sums[line] -= outgoing;
+        }
 
-        for (uint i = 1; i <= radius; i++) {
-            auto color = get_pixel(min(i, width - 1), y);
+        // Note: This seemed to profile slightly better than %
+        if (++stack_in >= div)
+            stack_in = 0;
+        if (++stack_out >= div)
+            stack_out = 0;
+    }
+}
 
-            auto bias = radius_plus_1 - i;
-            *stack_iterator = color;
-            red_sum += color.red() * bias;
-            green_sum += color.green() * bias;
-            blue_sum += color.blue() * bias;
-            alpha_sum += color.alpha() * bias;
+static void blur_lines(ARGB32* first_pixel, size_t line_step, size_t pixel_step, size_t line_count, BlurParameters const& parameters, bool in_parallel)
+{
+    auto const blur_band_at = [&](size_t band) {
+        auto first_line = band * lines_per_band;
+        blur_band(first_pixel + first_line * line_step, line_step, pixel_step, min(lines_per_band, line_count - first_line), parameters);
+    };
 
-            red_in_sum += color.red();
-            green_in_sum += color.green();
-            blue_in_sum += color.blue();
-            alpha_in_sum += color.alpha();
+    size_t band_count = ceil_div(line_count, lines_per_band);
+    if (!in_parallel) {
+        for (size_t band = 0; band < band_count; ++band)
+            blur_band_at(band);
+        return;
+    }
+    Threading::parallel_for(task_pool(), band_count, blur_band_at);
+}
 
-            ++stack_iterator;
-        }
+// Note: Radii above MAX_RADIUS blur a downscaled copy of the bitmap, which is then scaled back up.
+FLATTEN void StackBlurFilter::process_rgba(int radius, Color fill_color)
+{
+    // TODO: Implement a plain RGB version of this (if required)
 
-        auto stack_in_iterator = stack_start;
-        auto stack_out_iterator = stack_end;
-
-        for (uint x = 0; x < width; x++) {
-            auto alpha = (alpha_sum * sum_mult) >> sum_shift;
-            if (alpha != 0)
-                set_pixel(x, y, Color((red_sum * sum_mult) >> sum_shift, (green_sum * sum_mult) >> sum_shift, (blue_sum * sum_mult) >> sum_shift, alpha));
-            else
-                set_pixel(x, y, fill_color);
-
-            red_sum -= red_out_sum;
-            green_sum -= green_out_sum;
-            blue_sum -= blue_out_sum;
-            alpha_sum -= alpha_out_sum;
-
-            red_out_sum -= stack_in_iterator->red();
-            green_out_sum -= stack_in_iterator->green();
-            blue_out_sum -= stack_in_iterator->blue();
-            alpha_out_sum -= stack_in_iterator->alpha();
-
-            auto color = get_pixel(min(x + radius_plus_1, width - 1), y);
-            *stack_in_iterator = color;
-            red_in_sum += color.red();
-            green_in_sum += color.green();
-            blue_in_sum += color.blue();
-            alpha_in_sum += color.alpha();
-
-            red_sum += red_in_sum;
-            green_sum += green_in_sum;
-            blue_sum += blue_in_sum;
-            alpha_sum += alpha_in_sum;
-
-            ++stack_in_iterator;
-
-            color = *stack_out_iterator;
-            red_out_sum += color.red();
-            green_out_sum += color.green();
-            blue_out_sum += color.blue();
-            alpha_out_sum += color.alpha();
-
-            red_in_sum -= color.red();
-            green_in_sum -= color.green();
-            blue_in_sum -= color.blue();
-            alpha_in_sum -= color.alpha();
-
-            ++stack_out_iterator;
-        }
+    if (radius <= 0 || m_bitmap.physical_width() == 0 || m_bitmap.physical_height() == 0)
+        return;
+
+    if (static_cast<size_t>(radius) > MAX_RADIUS - 1) {
+        if (process_rgba_downscaled(radius, fill_color))
+            return;
+        radius = MAX_RADIUS - 1;
     }
 
-    for (uint x = 0; x < width; x++) {
-        stack_iterator = stack_start;
+    fill_color = fill_color.with_alpha(0);
 
-        auto color = get_pixel(x, 0);
-        for (uint i = 0; i < radius_plus_1; i++)
-            *(stack_iterator++) = color;
-
-        uint red_in_sum = 0;
-        uint green_in_sum = 0;
-        uint blue_in_sum = 0;
-        uint alpha_in_sum = 0;
-        uint red_out_sum = radius_plus_1 * color.red();
-        uint green_out_sum = radius_plus_1 * color.green();
-        uint blue_out_sum = radius_plus_1 * color.blue();
-        uint alpha_out_sum = radius_plus_1 * color.alpha();
-        uint red_sum = sum_factor * color.red();
-        uint green_sum = sum_factor * color.green();
-        uint blue_sum = sum_factor * color.blue();
-        uint alpha_sum = sum_factor * color.alpha();
+    uint width = m_bitmap.physical_width();
+    uint height = m_bitmap.physical_height();
+    ARGB32* pixels = m_bitmap.scanline(0);
+    size_t pitch = m_bitmap.pitch() / sizeof(ARGB32);
+    bool in_parallel = static_cast<size_t>(width) * height >= parallel_blur_threshold_in_pixels;
 
-        for (uint i = 1; i <= radius; i++) {
-            auto color = get_pixel(x, min(i, height - 1));
+    // Blur all rows, then all columns.
+    blur_lines(pixels, pitch, 1, height, { static_cast<uint>(radius), width, fill_color.value() }, in_parallel);
+    blur_lines(pixels, 1, pitch, width, { static_cast<uint>(radius), height, fill_color.value() }, in_parallel);
+}
 
-            auto bias = radius_plus_1 - i;
-            *stack_iterator = color;
-            red_sum += color.red() * bias;
-            green_sum += color.green() * bias;
-            blue_sum += color.blue() * bias;
-            alpha_sum += color.alpha() * bias;
+bool StackBlurFilter::process_rgba_downscaled(int radius, Color fill_color)
+{
+    // The blur hides the detail that is lost by scaling, as long as the scale factor is small compared to the radius.
+    int factor = ceil_div(radius, static_cast<int>(MAX_RADIUS - 1));
+    IntSize downscaled_size { ceil_div(m_bitmap.physical_width(), factor), ceil_div(m_bitmap.physical_height(), factor) };
 
-            red_in_sum += color.red();
-            green_in_sum += color.green();
-            blue_in_sum += color.blue();
-            alpha_in_sum += color.alpha();
+    auto downscaled_or_error = m_bitmap.scaled_to_size(downscaled_size);
+    if (downscaled_or_error.is_error())
+        return false;
+    auto downscaled = downscaled_or_error.release_value();
 
-            ++stack_iterator;
-        }
+    StackBlurFilter { *downscaled }.process_rgba(radius / factor, fill_color);
 
-        auto stack_in_iterator = stack_start;
-        auto stack_out_iterator = stack_end;
-
-        for (uint y = 0; y < height; y++) {
-            auto alpha = (alpha_sum * sum_mult) >> sum_shift;
-            if (alpha != 0)
-                set_pixel(x, y, Color((red_sum * sum_mult) >> sum_shift, (green_sum * sum_mult) >> sum_shift, (blue_sum * sum_mult) >> sum_shift, alpha));
-            else
-                set_pixel(x, y, fill_color);
-
-            red_sum -= red_out_sum;
-            green_sum -= green_out_sum;
-            blue_sum -= blue_out_sum;
-            alpha_sum -= alpha_out_sum;
-
-            red_out_sum -= stack_in_iterator->red();
-            green_out_sum -= stack_in_iterator->green();
-            blue_out_sum -= stack_in_iterator->blue();
-            alpha_out_sum -= stack_in_iterator->alpha();
-
-            auto color = get_pixel(x, min(y + radius_plus_1, height - 1));
-            *stack_in_iterator = color;
-            red_in_sum += color.red();
-            green_in_sum += color.green();
-            blue_in_sum += color.blue();
-            alpha_in_sum += color.alpha();
-
-            red_sum += red_in_sum;
-            green_sum += green_in_sum;
-            blue_sum += blue_in_sum;
-            alpha_sum += alpha_in_sum;
-
-            ++stack_in_iterator;
-
-            color = *stack_out_iterator;
-            red_out_sum += color.red();
-            green_out_sum += color.green();
-            blue_out_sum += color.blue();
-            alpha_out_sum += color.alpha();
-
-            red_in_sum -= color.red();
-            green_in_sum -= color.green();
-            blue_in_sum -= color.blue();
-            alpha_in_sum -= color.alpha();
-
-            ++stack_out_iterator;
-        }
-    }
+    auto upscaled_or_error = downscaled->scaled_to_size(m_bitmap.physical_size());
+    if (upscaled_or_error.is_error())
+        return false;
+    auto upscaled = upscaled_or_error.release_value();
+
+    for (int y = 0; y < m_bitmap.physical_height(); ++y)
+        __builtin_memcpy(m_bitmap.scanline(y), upscaled->scanline(y), m_bitmap.physical_width() * sizeof(ARGB32));
+    return true;
 }
 
 }
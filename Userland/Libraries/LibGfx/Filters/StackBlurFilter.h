@@ -17,10 +17,12 @@ public:
     {
     }
 
-    // Note: The radius is a u8 for reason! This implementation can only handle radii from 0 to 255.
-    void process_rgba(u8 radius, Color fill_color = Color::NamedColor::White);
+    // Note: The blur itself can only handle radii from 0 to 255. Larger radii are approximated by blurring at a lower resolution.
+    void process_rgba(int radius, Color fill_color = Color::NamedColor::White);
 
 private:
+    bool process_rgba_downscaled(int radius, Color fill_color);
+
     Bitmap& m_bitmap;
 };
 
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BitCast.h>
+#include <AK/NeverDestroyed.h>
+#include <LibGfx/Font/GlyphBitmapCache.h>
+#include <LibGfx/Font/VectorFont.h>
+
+namespace Gfx {
+
+// Typefaces may still be destroyed during exit, after static destructors would have run.
+static NeverDestroyed<GlyphBitmapCache> s_the;
+
+GlyphBitmapCache& GlyphBitmapCache::the()
+{
+    return *s_the;
+}
+
+unsigned GlyphBitmapCache::KeyTraits::hash(Key const& key)
+{
+    auto scale_hash = pair_int_hash(bit_cast<u32>(key.x_scale), bit_cast<u32>(key.y_scale));
+    auto glyph_hash = pair_int_hash(key.glyph_id, (key.subpixel_offset.x << 8) | key.subpixel_offset.y);
+    return pair_int_hash(ptr_hash(key.font), pair_int_hash(scale_hash, glyph_hash));
+}
+
+RefPtr<Bitmap> GlyphBitmapCache::rasterize_glyph(VectorFont const& font, float x_scale, float y_scale, u32 glyph_id, GlyphSubpixelOffset subpixel_offset)
+{
+    Key key { &font, x_scale, y_scale, glyph_id, subpixel_offset };
+    if (auto it = m_entries.find(key); it != m_entries.end()) {
+        auto& entry = *it->value;
+        m_entries_least_recently_used_first.append(entry);
+        return entry.bitmap;
+    }
+
+    auto bitmap = font.rasterize_glyph(glyph_id, x_scale, y_scale, subpixel_offset);
+
+    // Glyphs without a bitmap (like spaces) are cached as well, so only count the entry itself for them.
+    auto entry = make<Entry>(key, bitmap, sizeof(Entry) + (bitmap ? bitmap->size_in_bytes() : 0));
+    m_size_in_bytes += entry->size_in_bytes;
+    m_entries_least_recently_used_first.append(*entry);
+    m_entries.set(key, move(entry));
+
+    evict_until_within_budget();
+    return bitmap;
+}
+
+void GlyphBitmapCache::purge(VectorFont const& font)
+{
+    m_entries.remove_all_matching([&](Key const& key, NonnullOwnPtr<Entry>& entry) {
+        if (key.font != &font)
+            return false;
+        m_size_in_bytes -= entry->size_in_bytes;
+        entry->list_node.remove();
+        return true;
+    });
+}
+
+void GlyphBitmapCache::set_budget_in_bytes(size_t budget_in_bytes)
+{
+    m_budget_in_bytes = budget_in_bytes;
+    evict_until_within_budget();
+}
+
+void GlyphBitmapCache::remove(Entry& entry)
+{
+    m_size_in_bytes -= entry.size_in_bytes;
+    entry.list_node.remove();
+    auto key = entry.key;
+    m_entries.remove(key);
+}
+
+void GlyphBitmapCache::evict_until_within_budget()
+{
+    while (m_size_in_bytes > m_budget_in_bytes && !m_entries_least_recently_used_first.is_empty())
+        remove(*m_entries_least_recently_used_first.first());
+}
+
+}
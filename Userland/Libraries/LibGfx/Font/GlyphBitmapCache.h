@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Font/Font.h>
+
+namespace Gfx {
+
+class VectorFont;
+
+// Rasterized glyphs of all vector fonts in the process, so that every size and subpixel offset of a glyph is only
+// rasterized once, no matter how many ScaledFonts come and go for it. Once the cache is over its budget, the least
+// recently used glyphs are evicted first.
+class GlyphBitmapCache {
+    AK_MAKE_NONCOPYABLE(GlyphBitmapCache);
+    AK_MAKE_NONMOVABLE(GlyphBitmapCache);
+
+public:
+    static constexpr size_t default_budget_in_bytes = 16 * MiB;
+
+    static GlyphBitmapCache& the();
+
+    GlyphBitmapCache() = default;
+
+    RefPtr<Bitmap> rasterize_glyph(VectorFont const&, float x_scale, float y_scale, u32 glyph_id, GlyphSubpixelOffset);
+
+    // Called when a typeface goes away, since its glyphs can never be looked up again.
+    void purge(VectorFont const&);
+
+    size_t size_in_bytes() const { return m_size_in_bytes; }
+    size_t budget_in_bytes() const { return m_budget_in_bytes; }
+    void set_budget_in_bytes(size_t);
+
+private:
+    struct Key {
+        VectorFont const* font;
+        float x_scale;
+        float y_scale;
+        u32 glyph_id;
+        GlyphSubpixelOffset subpixel_offset;
+
+        bool operator==(Key const&) const = default;
+    };
+
+    struct KeyTraits : public DefaultTraits<Key> {
+        static unsigned hash(Key const&);
+    };
+
+    struct Entry {
+        Key key;
+        RefPtr<Bitmap> bitmap;
+        size_t size_in_bytes { 0 };
+
+        IntrusiveListNode<Entry> list_node;
+        using List = IntrusiveList<&Entry::list_node>;
+    };
+
+    void remove(Entry&);
+    void evict_until_within_budget();
+
+    HashMap<Key, NonnullOwnPtr<Entry>, KeyTraits> m_entries;
+    Entry::List m_entries_least_recently_used_first;
+    size_t m_size_in_bytes { 0 };
+    size_t m_budget_in_bytes { default_budget_in_bytes };
+};
+
+}
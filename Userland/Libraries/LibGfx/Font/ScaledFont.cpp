@@ -4,9 +4,11 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/CharacterTypes.h>
 #include <AK/Utf32View.h>
 #include <AK/Utf8View.h>
 #include <LibGfx/Font/Emoji.h>
+#include <LibGfx/Font/GlyphBitmapCache.h>
 #include <LibGfx/Font/ScaledFont.h>
 
 namespace Gfx {
@@ -73,14 +75,7 @@ ALWAYS_INLINE float ScaledFont::unicode_view_width(T const& view) const
 
 RefPtr<Gfx::Bitmap> ScaledFont::rasterize_glyph(u32 glyph_id, GlyphSubpixelOffset subpixel_offset) const
 {
-    GlyphIndexWithSubpixelOffset index { glyph_id, subpixel_offset };
-    auto glyph_iterator = m_cached_glyph_bitmaps.find(index);
-    if (glyph_iterator != m_cached_glyph_bitmaps.end())
-        return glyph_iterator->value;
-
-    auto glyph_bitmap = m_font->rasterize_glyph(glyph_id, m_x_scale, m_y_scale, subpixel_offset);
-    m_cached_glyph_bitmaps.set(index, glyph_bitmap);
-    return glyph_bitmap;
+    return GlyphBitmapCache::the().rasterize_glyph(*m_font, m_x_scale, m_y_scale, glyph_id, subpixel_offset);
 }
 
 bool ScaledFont::append_glyph_path_to(Gfx::Path& path, u32 glyph_id) const
@@ -109,6 +104,13 @@ float ScaledFont::glyph_left_bearing(u32 code_point) const
 
 float ScaledFont::glyph_width(u32 code_point) const
 {
+    if (is_ascii(code_point)) {
+        auto& cached_width = m_cached_ascii_glyph_widths[code_point];
+        if (!cached_width.has_value())
+            cached_width = m_font->glyph_advance(glyph_id_for_code_point(code_point), m_x_scale, m_y_scale, m_point_width, m_point_height);
+        return *cached_width;
+    }
+
     auto id = glyph_id_for_code_point(code_point);
     return m_font->glyph_advance(id, m_x_scale, m_y_scale, m_point_width, m_point_height);
 }
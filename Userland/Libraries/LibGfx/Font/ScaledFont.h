@@ -7,20 +7,13 @@
 
 #pragma once
 
-#include <AK/HashMap.h>
+#include <AK/Array.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/Font/Font.h>
 #include <LibGfx/Font/VectorFont.h>
 
 namespace Gfx {
 
-struct GlyphIndexWithSubpixelOffset {
-    u32 glyph_id;
-    GlyphSubpixelOffset subpixel_offset;
-
-    bool operator==(GlyphIndexWithSubpixelOffset const&) const = default;
-};
-
 class ScaledFont final : public Gfx::Font {
 public:
     ScaledFont(NonnullRefPtr<VectorFont>, float point_width, float point_height, unsigned dpi_x = DEFAULT_DPI, unsigned dpi_y = DEFAULT_DPI);
@@ -80,7 +73,9 @@ private:
     float m_y_scale { 0.0f };
     float m_point_width { 0.0f };
     float m_point_height { 0.0f };
-    mutable HashMap<GlyphIndexWithSubpixelOffset, RefPtr<Gfx::Bitmap>> m_cached_glyph_bitmaps;
+
+    // Text is mostly ASCII, so we remember the advances of those glyphs instead of asking the font every time.
+    mutable Array<Optional<float>, 128> m_cached_ascii_glyph_widths;
     Gfx::FontPixelMetrics m_pixel_metrics;
 
     float m_pixel_size { 0.0f };
@@ -91,15 +86,3 @@ private:
 };
 
 }
-
-namespace AK {
-
-template<>
-struct Traits<Gfx::GlyphIndexWithSubpixelOffset> : public DefaultTraits<Gfx::GlyphIndexWithSubpixelOffset> {
-    static unsigned hash(Gfx::GlyphIndexWithSubpixelOffset const& index)
-    {
-        return pair_int_hash(index.glyph_id, (index.subpixel_offset.x << 8) | index.subpixel_offset.y);
-    }
-};
-
-}
@@ -4,13 +4,18 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibGfx/Font/GlyphBitmapCache.h>
 #include <LibGfx/Font/ScaledFont.h>
 #include <LibGfx/Font/VectorFont.h>
 
 namespace Gfx {
 
 VectorFont::VectorFont() = default;
-VectorFont::~VectorFont() = default;
+
+VectorFont::~VectorFont()
+{
+    GlyphBitmapCache::the().purge(*this);
+}
 
 NonnullRefPtr<ScaledFont> VectorFont::scaled_font(float point_size) const
 {
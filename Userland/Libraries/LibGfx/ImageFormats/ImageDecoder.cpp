@@ -88,16 +88,21 @@ static ErrorOr<OwnPtr<ImageDecoderPlugin>> probe_and_sniff_for_appropriate_plugi
     return OwnPtr<ImageDecoderPlugin> {};
 }
 
-ErrorOr<RefPtr<ImageDecoder>> ImageDecoder::try_create_for_raw_bytes(ReadonlyBytes bytes, Optional<ByteString> mime_type)
+ErrorOr<OwnPtr<ImageDecoderPlugin>> ImageDecoder::create_plugin_for_raw_bytes(ReadonlyBytes bytes, Optional<ByteString> const& mime_type)
 {
     if (auto plugin = TRY(probe_and_sniff_for_appropriate_plugin(bytes)); plugin)
-        return adopt_ref_if_nonnull(new (nothrow) ImageDecoder(plugin.release_nonnull()));
+        return plugin;
 
-    if (mime_type.has_value()) {
-        if (OwnPtr<ImageDecoderPlugin> plugin = TRY(probe_and_sniff_for_appropriate_plugin_with_known_mime_type(mime_type.value(), bytes)); plugin)
-            return adopt_ref_if_nonnull(new (nothrow) ImageDecoder(plugin.release_nonnull()));
-    }
+    if (mime_type.has_value())
+        return probe_and_sniff_for_appropriate_plugin_with_known_mime_type(mime_type.value(), bytes);
 
+    return OwnPtr<ImageDecoderPlugin> {};
+}
+
+ErrorOr<RefPtr<ImageDecoder>> ImageDecoder::try_create_for_raw_bytes(ReadonlyBytes bytes, Optional<ByteString> mime_type)
+{
+    if (auto plugin = TRY(create_plugin_for_raw_bytes(bytes, mime_type)); plugin)
+        return adopt_ref_if_nonnull(new (nothrow) ImageDecoder(plugin.release_nonnull()));
     return RefPtr<ImageDecoder> {};
 }
 
@@ -106,4 +111,66 @@ ImageDecoder::ImageDecoder(NonnullOwnPtr<ImageDecoderPlugin> plugin)
 {
 }
 
+IncrementalImageDecoder::IncrementalImageDecoder(Optional<ByteString> mime_type)
+    : m_mime_type(move(mime_type))
+{
+}
+
+ErrorOr<void> IncrementalImageDecoder::append_data(ReadonlyBytes data)
+{
+    VERIFY(!is_finished());
+    TRY(m_data.try_append(data));
+    return {};
+}
+
+ErrorOr<void> IncrementalImageDecoder::finish()
+{
+    VERIFY(!is_finished());
+    auto decoder = TRY(ImageDecoder::try_create_for_raw_bytes(m_data, m_mime_type));
+    if (!decoder)
+        return Error::from_string_literal("IncrementalImageDecoder: Unsupported image format");
+    m_size = decoder->size();
+    m_decoder = move(decoder);
+
+    // Partial frames might be less accurate than the complete one, don't hand them out anymore.
+    m_last_frame = {};
+    return {};
+}
+
+ErrorOr<Optional<PartialImageFrameDescriptor>> IncrementalImageDecoder::decode_available_data()
+{
+    if (is_finished()) {
+        if (!m_last_frame.has_value()) {
+            auto frame = TRY(m_decoder->frame(0));
+            m_last_frame = PartialImageFrameDescriptor { frame.image, m_decoder->height() };
+        }
+        return m_last_frame;
+    }
+
+    // Plugins decode from the start of the data every time, so wait until it has grown by half before trying again.
+    // This keeps the work done for all the partial frames within a small multiple of decoding the image once.
+    static constexpr size_t minimum_data_size_increase = 4 * KiB;
+    if (m_data.size() < max(m_data_size_at_last_decode + minimum_data_size_increase, m_data_size_at_last_decode * 3 / 2))
+        return m_last_frame;
+    m_data_size_at_last_decode = m_data.size();
+
+    // Errors are expected while the data is incomplete, they are only reported by finish().
+    auto plugin_or_error = ImageDecoder::create_plugin_for_raw_bytes(m_data, m_mime_type);
+    if (plugin_or_error.is_error() || !plugin_or_error.value())
+        return m_last_frame;
+    auto plugin = plugin_or_error.release_value().release_nonnull();
+    m_size = plugin->size();
+
+    if (!plugin->supports_partial_decoding())
+        return m_last_frame;
+    auto frame_or_error = plugin->partial_frame();
+    if (frame_or_error.is_error())
+        return m_last_frame;
+
+    auto frame = frame_or_error.release_value();
+    if (frame.decoded_row_count > 0 && (!m_last_frame.has_value() || frame.decoded_row_count >= m_last_frame->decoded_row_count))
+        m_last_frame = move(frame);
+    return m_last_frame;
+}
+
 }
@@ -8,6 +8,7 @@
 
 #include <AK/ByteBuffer.h>
 #include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
 #include <AK/OwnPtr.h>
 #include <AK/RefCounted.h>
 #include <AK/RefPtr.h>
@@ -26,6 +27,14 @@ struct ImageFrameDescriptor {
     int duration { 0 };
 };
 
+struct PartialImageFrameDescriptor {
+    RefPtr<Bitmap> image;
+
+    // The rows of `image` from the top that contain decoded pixels, possibly only a coarse version of them if the
+    // format stores the image in several passes. The rows below are unspecified.
+    int decoded_row_count { 0 };
+};
+
 struct VectorImageFrameDescriptor {
     RefPtr<VectorGraphic> image;
     int duration { 0 };
@@ -82,6 +91,9 @@ public:
     virtual size_t frame_count() { return 1; }
     virtual size_t first_animated_frame_index() { return 0; }
 
+    // `ideal_size` is a hint for the size the frame is going to be displayed at. Vector formats render at that size,
+    // raster formats may return a smaller bitmap than size() if they can decode one more cheaply, but never one that is
+    // smaller than `ideal_size`.
     virtual ErrorOr<ImageFrameDescriptor> frame(size_t index, Optional<IntSize> ideal_size = {}) = 0;
 
     virtual Optional<Metadata const&> metadata() { return OptionalNone {}; }
@@ -92,6 +104,12 @@ public:
     virtual ErrorOr<NonnullRefPtr<CMYKBitmap>> cmyk_frame() { VERIFY_NOT_REACHED(); }
     virtual ErrorOr<VectorImageFrameDescriptor> vector_frame(size_t) { VERIFY_NOT_REACHED(); }
 
+    // Override these if the first frame can be decoded from the beginning of the image data, while the rest of it is
+    // still being downloaded. The data passed to create() may then end at any byte, and partial_frame() returns
+    // whatever could be decoded from it. This is the only call made on such a plugin, see IncrementalImageDecoder.
+    virtual bool supports_partial_decoding() const { return false; }
+    virtual ErrorOr<PartialImageFrameDescriptor> partial_frame() { VERIFY_NOT_REACHED(); }
+
 protected:
     ImageDecoderPlugin() = default;
 };
@@ -123,9 +141,48 @@ public:
     ErrorOr<VectorImageFrameDescriptor> vector_frame(size_t index) { return m_plugin->vector_frame(index); }
 
 private:
+    friend class IncrementalImageDecoder;
+
+    static ErrorOr<OwnPtr<ImageDecoderPlugin>> create_plugin_for_raw_bytes(ReadonlyBytes, Optional<ByteString> const& mime_type);
+
     explicit ImageDecoder(NonnullOwnPtr<ImageDecoderPlugin>);
 
     NonnullOwnPtr<ImageDecoderPlugin> mutable m_plugin;
 };
 
+// Decodes an image while its data is still arriving, so that it can be displayed before the download finishes.
+// Plugins without support for partial decoding only produce a frame once all the data has been appended.
+class IncrementalImageDecoder {
+    AK_MAKE_NONCOPYABLE(IncrementalImageDecoder);
+    AK_MAKE_NONMOVABLE(IncrementalImageDecoder);
+
+public:
+    explicit IncrementalImageDecoder(Optional<ByteString> mime_type = {});
+
+    ErrorOr<void> append_data(ReadonlyBytes);
+
+    // Call this once all the data has been appended, it fails if the data isn't a supported image.
+    ErrorOr<void> finish();
+    bool is_finished() const { return m_decoder; }
+
+    // Known as soon as the data received so far contains the image header.
+    Optional<IntSize> size() const { return m_size; }
+
+    // Decodes the first frame from the data received so far. Returns the previous result if too little data arrived
+    // since then, and nothing if the data doesn't contain any pixels yet. Once finish() succeeded, this is the
+    // complete frame.
+    ErrorOr<Optional<PartialImageFrameDescriptor>> decode_available_data();
+
+    // The decoder for all the data, for everything beyond the first frame. Only available once finish() succeeded.
+    RefPtr<ImageDecoder> decoder() const { return m_decoder; }
+
+private:
+    Optional<ByteString> m_mime_type;
+    ByteBuffer m_data;
+    Optional<IntSize> m_size;
+    size_t m_data_size_at_last_decode { 0 };
+    Optional<PartialImageFrameDescriptor> m_last_frame;
+    RefPtr<ImageDecoder> m_decoder;
+};
+
 }
@@ -11,8 +11,11 @@
 #include <AK/FixedArray.h>
 #include <AK/HashMap.h>
 #include <AK/Math.h>
+#include <AK/MemMem.h>
 #include <AK/MemoryStream.h>
 #include <AK/NumericLimits.h>
+#include <AK/SIMDExtras.h>
+#include <AK/SIMDMath.h>
 #include <AK/String.h>
 #include <AK/Try.h>
 #include <AK/Vector.h>
@@ -20,9 +23,13 @@
 #include <LibGfx/ImageFormats/JPEGShared.h>
 #include <LibGfx/ImageFormats/TIFFLoader.h>
 #include <LibGfx/ImageFormats/TIFFMetadata.h>
+#include <LibThreading/Parallel.h>
 
 namespace Gfx {
 
+using AK::SIMD::f32x4;
+using AK::SIMD::i32x4;
+
 struct MacroblockMeta {
     u32 total { 0 };
     u32 padded_total { 0 };
@@ -227,6 +234,45 @@ public:
         return {};
     }
 
+    // Reads the entropy-coded data of a scan as-is, up to the marker that follows it, which is saved for the next
+    // read_u16(). The offsets of the restart markers in the returned data are appended to `restart_marker_offsets`.
+    ErrorOr<ByteBuffer> read_entropy_coded_data(Vector<size_t>& restart_marker_offsets)
+    {
+        VERIFY(!m_saved_marker.has_value());
+
+        ByteBuffer data;
+        while (true) {
+            if (m_byte_offset == m_current_size)
+                TRY(refill_buffer());
+
+            // Everything up to the next 0xFF is data, copy it in one go.
+            auto const available = m_buffer.span().slice(m_byte_offset, m_current_size - m_byte_offset);
+            auto const next_ff = AK::memchr_optional(available.data(), available.size(), 0xFF);
+            size_t const data_size = next_ff.value_or(available.size());
+            TRY(data.try_append(available.data(), data_size));
+            m_byte_offset += data_size;
+            if (!next_ff.has_value())
+                continue;
+
+            ++m_byte_offset;
+            u8 next_byte = TRY(read_u8());
+            while (next_byte == 0xFF)
+                next_byte = TRY(read_u8());
+
+            Marker const marker = 0xFF00 | next_byte;
+            if (marker >= JPEG_RST0 && marker <= JPEG_RST7) {
+                TRY(restart_marker_offsets.try_append(data.size()));
+            } else if (next_byte != 0x00) {
+                m_saved_marker = marker;
+                return data;
+            }
+
+            // Stuffed zero bytes and restart markers are kept, the Huffman stream takes care of them.
+            TRY(data.try_append(0xFF));
+            TRY(data.try_append(next_byte));
+        }
+    }
+
     Optional<u16>& saved_marker(Badge<HuffmanStream>)
     {
         return m_saved_marker;
@@ -404,6 +450,17 @@ struct Scan {
     {
     }
 
+    // Restart intervals are independent of each other, so they can be decoded from separate streams.
+    Scan(Scan const& other, HuffmanStream stream)
+        : components(other.components)
+        , spectral_selection_start(other.spectral_selection_start)
+        , spectral_selection_end(other.spectral_selection_end)
+        , successive_approximation_high(other.successive_approximation_high)
+        , successive_approximation_low(other.successive_approximation_low)
+        , huffman_stream(stream)
+    {
+    }
+
     // B.2.3 - Scan header syntax
     Vector<ScanComponent, 4> components;
 
@@ -415,6 +472,10 @@ struct Scan {
     HuffmanStream huffman_stream;
 
     u64 end_of_bands_run_count { 0 };
+    Array<i16, 4> previous_dc_values {};
+
+    // Where decoding stopped if the data is truncated, see JPEGImageDecoderPlugin::partial_frame().
+    u32 decoded_mcu_count { 0 };
 
     // See the note on Figure B.4 - Scan header syntax
     bool are_components_interleaved() const
@@ -470,7 +531,6 @@ struct JPEGLoadingContext {
     u16 dc_restart_interval { 0 };
     HashMap<u8, HuffmanTable> dc_tables;
     HashMap<u8, HuffmanTable> ac_tables;
-    Array<i16, 4> previous_dc_values {};
     MacroblockMeta mblock_meta;
     JPEGStream stream;
     JPEGDecoderOptions options;
@@ -481,6 +541,13 @@ struct JPEGLoadingContext {
 
     Optional<ICCMultiChunkState> icc_multi_chunk_state;
     Optional<ByteBuffer> icc_data;
+
+    // Set for partial decoding, the data then ends wherever the download currently is.
+    bool allow_truncated_data { false };
+    u32 decoded_row_count { 0 };
+
+    // The bitmap is 1/2, 1/4 or 1/8 of the image's size if a smaller frame was requested.
+    u8 scale_denominator { 1 };
 };
 
 static inline auto* get_component(Macroblock& block, unsigned component)
@@ -516,7 +583,7 @@ enum class JPEGDecodingMode {
 };
 
 template<JPEGDecodingMode DecodingMode>
-static ErrorOr<void> add_dc(JPEGLoadingContext& context, Macroblock& macroblock, ScanComponent const& scan_component)
+static ErrorOr<void> add_dc(JPEGLoadingContext const& context, Scan& scan, Macroblock& macroblock, ScanComponent const& scan_component)
 {
     auto maybe_table = context.dc_tables.get(scan_component.dc_destination_id);
     if (!maybe_table.has_value()) {
@@ -525,7 +592,6 @@ static ErrorOr<void> add_dc(JPEGLoadingContext& context, Macroblock& macroblock,
     }
 
     auto& dc_table = maybe_table.value();
-    auto& scan = *context.current_scan;
 
     auto* select_component = get_component(macroblock, scan_component.component.index);
     auto& coefficient = select_component[0];
@@ -553,7 +619,7 @@ static ErrorOr<void> add_dc(JPEGLoadingContext& context, Macroblock& macroblock,
     if (dc_length != 0 && dc_diff < (1 << (dc_length - 1)))
         dc_diff -= (1 << dc_length) - 1;
 
-    auto& previous_dc = context.previous_dc_values[scan_component.component.index];
+    auto& previous_dc = scan.previous_dc_values[scan_component.component.index];
     previous_dc += dc_diff;
     coefficient = previous_dc << scan.successive_approximation_low;
 
@@ -597,7 +663,7 @@ static bool is_progressive(StartOfFrame::FrameType frame_type)
 }
 
 template<JPEGDecodingMode DecodingMode>
-static ErrorOr<void> add_ac(JPEGLoadingContext& context, Macroblock& macroblock, ScanComponent const& scan_component)
+static ErrorOr<void> add_ac(JPEGLoadingContext const& context, Scan& scan, Macroblock& macroblock, ScanComponent const& scan_component)
 {
     auto maybe_table = context.ac_tables.get(scan_component.ac_destination_id);
     if (!maybe_table.has_value()) {
@@ -608,8 +674,6 @@ static ErrorOr<void> add_ac(JPEGLoadingContext& context, Macroblock& macroblock,
     auto& ac_table = maybe_table.value();
     auto* select_component = get_component(macroblock, scan_component.component.index);
 
-    auto& scan = *context.current_scan;
-
     // Compute the AC coefficients.
 
     // 0th coefficient is the dc, which is already handled
@@ -731,14 +795,14 @@ static ErrorOr<void> add_ac(JPEGLoadingContext& context, Macroblock& macroblock,
  * we are dealing with three components) will fill up the blocks with chroma data.
  */
 template<JPEGDecodingMode DecodingMode>
-static ErrorOr<void> build_macroblocks(JPEGLoadingContext& context, Vector<Macroblock>& macroblocks, u32 hcursor, u32 vcursor)
+static ErrorOr<void> build_macroblocks(JPEGLoadingContext const& context, Scan& scan, Vector<Macroblock>& macroblocks, u32 hcursor, u32 vcursor)
 {
-    for (auto const& scan_component : context.current_scan->components) {
+    for (auto const& scan_component : scan.components) {
         for (u8 vfactor_i = 0; vfactor_i < scan_component.component.sampling_factors.vertical; vfactor_i++) {
             for (u8 hfactor_i = 0; hfactor_i < scan_component.component.sampling_factors.horizontal; hfactor_i++) {
                 // A.2.3 - Interleaved order
                 u32 macroblock_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
-                if (!context.current_scan->are_components_interleaved()) {
+                if (!scan.are_components_interleaved()) {
                     macroblock_index = vcursor * context.mblock_meta.hpadded_count + (hfactor_i + (hcursor * scan_component.component.sampling_factors.vertical) + (vfactor_i * scan_component.component.sampling_factors.horizontal));
 
                     // A.2.4 Completion of partial MCU
@@ -756,17 +820,17 @@ static ErrorOr<void> build_macroblocks(JPEGLoadingContext& context, Vector<Macro
                 Macroblock& block = macroblocks[macroblock_index];
 
                 if constexpr (DecodingMode == JPEGDecodingMode::Sequential) {
-                    TRY(add_dc<DecodingMode>(context, block, scan_component));
-                    TRY(add_ac<DecodingMode>(context, block, scan_component));
+                    TRY(add_dc<DecodingMode>(context, scan, block, scan_component));
+                    TRY(add_ac<DecodingMode>(context, scan, block, scan_component));
                 } else {
-                    if (context.current_scan->spectral_selection_start == 0)
-                        TRY(add_dc<DecodingMode>(context, block, scan_component));
-                    if (context.current_scan->spectral_selection_end != 0)
-                        TRY(add_ac<DecodingMode>(context, block, scan_component));
+                    if (scan.spectral_selection_start == 0)
+                        TRY(add_dc<DecodingMode>(context, scan, block, scan_component));
+                    if (scan.spectral_selection_end != 0)
+                        TRY(add_ac<DecodingMode>(context, scan, block, scan_component));
 
                     // G.1.2.2 - Progressive encoding of AC coefficients with Huffman coding
-                    if (context.current_scan->end_of_bands_run_count > 0) {
-                        --context.current_scan->end_of_bands_run_count;
+                    if (scan.end_of_bands_run_count > 0) {
+                        --scan.end_of_bands_run_count;
                         continue;
                     }
                 }
@@ -789,61 +853,152 @@ static bool is_dct_based(StartOfFrame::FrameType frame_type)
         || frame_type == StartOfFrame::FrameType::Differential_Progressive_DCT_Arithmetic;
 }
 
-static void reset_decoder(JPEGLoadingContext& context)
+static void reset_decoder(JPEGLoadingContext const& context, Scan& scan)
 {
     // G.1.2.2 - Progressive encoding of AC coefficients with Huffman coding
-    context.current_scan->end_of_bands_run_count = 0;
+    scan.end_of_bands_run_count = 0;
 
     // E.2.4 Control procedure for decoding a restart interval
     if (is_dct_based(context.frame.type)) {
-        context.previous_dc_values = {};
+        scan.previous_dc_values = {};
         return;
     }
 
     VERIFY_NOT_REACHED();
 }
 
-static ErrorOr<void> decode_huffman_stream(JPEGLoadingContext& context, Vector<Macroblock>& macroblocks)
+static u32 mcu_count(JPEGLoadingContext const& context)
 {
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.sampling_factors.vertical) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.sampling_factors.horizontal) {
-            // FIXME: This is likely wrong for non-interleaved scans.
-            VERIFY(context.mblock_meta.hpadded_count % context.sampling_factors.horizontal == 0);
-            u32 number_of_mcus_decoded_so_far = ((vcursor / context.sampling_factors.vertical) * context.mblock_meta.hpadded_count + hcursor) / context.sampling_factors.horizontal;
+    return (context.mblock_meta.hpadded_count / context.sampling_factors.horizontal) * (context.mblock_meta.vpadded_count / context.sampling_factors.vertical);
+}
 
-            auto& huffman_stream = context.current_scan->huffman_stream;
+static ErrorOr<void> decode_mcus(JPEGLoadingContext const& context, Scan& scan, Vector<Macroblock>& macroblocks, u32 first_mcu, u32 end_mcu)
+{
+    // FIXME: This is likely wrong for non-interleaved scans.
+    VERIFY(context.mblock_meta.hpadded_count % context.sampling_factors.horizontal == 0);
+    u32 const mcus_per_row = context.mblock_meta.hpadded_count / context.sampling_factors.horizontal;
 
-            if (context.dc_restart_interval > 0) {
-                if (number_of_mcus_decoded_so_far != 0 && number_of_mcus_decoded_so_far % context.dc_restart_interval == 0) {
-                    reset_decoder(context);
+    for (u32 number_of_mcus_decoded_so_far = first_mcu; number_of_mcus_decoded_so_far < end_mcu; ++number_of_mcus_decoded_so_far) {
+        u32 const vcursor = (number_of_mcus_decoded_so_far / mcus_per_row) * context.sampling_factors.vertical;
+        u32 const hcursor = (number_of_mcus_decoded_so_far % mcus_per_row) * context.sampling_factors.horizontal;
 
-                    // Restart markers are stored in byte boundaries. Advance the huffman stream cursor to
-                    //  the 0th bit of the next byte.
-                    TRY(huffman_stream.advance_to_byte_boundary());
+        auto& huffman_stream = scan.huffman_stream;
 
-                    // Skip the restart marker (RSTn).
-                    TRY(huffman_stream.discard_bits(8));
-                }
+        if (context.dc_restart_interval > 0) {
+            if (number_of_mcus_decoded_so_far != first_mcu && number_of_mcus_decoded_so_far % context.dc_restart_interval == 0) {
+                reset_decoder(context, scan);
+
+                // Restart markers are stored in byte boundaries. Advance the huffman stream cursor to
+                //  the 0th bit of the next byte.
+                TRY(huffman_stream.advance_to_byte_boundary());
+
+                // Skip the restart marker (RSTn).
+                TRY(huffman_stream.discard_bits(8));
             }
+        }
 
-            auto result = [&]() {
-                if (is_progressive(context.frame.type))
-                    return build_macroblocks<JPEGDecodingMode::Progressive>(context, macroblocks, hcursor, vcursor);
-                return build_macroblocks<JPEGDecodingMode::Sequential>(context, macroblocks, hcursor, vcursor);
-            }();
+        auto result = [&]() {
+            if (is_progressive(context.frame.type))
+                return build_macroblocks<JPEGDecodingMode::Progressive>(context, scan, macroblocks, hcursor, vcursor);
+            return build_macroblocks<JPEGDecodingMode::Sequential>(context, scan, macroblocks, hcursor, vcursor);
+        }();
 
-            if (result.is_error()) {
-                if constexpr (JPEG_DEBUG) {
-                    dbgln("Failed to build Macroblock {}: {}", number_of_mcus_decoded_so_far, result.error());
-                    dbgln("Huffman stream byte offset {:#x}", context.stream.byte_offset());
-                }
-                return result.release_error();
+        if (result.is_error()) {
+            if constexpr (JPEG_DEBUG) {
+                dbgln("Failed to build Macroblock {}: {}", number_of_mcus_decoded_so_far, result.error());
+                dbgln("Huffman stream byte offset {:#x}", context.stream.byte_offset());
             }
+            scan.decoded_mcu_count = number_of_mcus_decoded_so_far;
+            return result.release_error();
         }
     }
     return {};
 }
 
+// Below this, spreading the work over several threads costs more than it saves.
+static constexpr u32 parallel_decoding_threshold_in_macroblocks = 4096;
+
+static bool should_decode_in_parallel(JPEGLoadingContext const& context)
+{
+    return context.mblock_meta.padded_total >= parallel_decoding_threshold_in_macroblocks;
+}
+
+static Threading::TaskPool& task_pool()
+{
+    static Threading::TaskPool pool;
+    return pool;
+}
+
+static ErrorOr<void> decode_restart_intervals_in_parallel(JPEGLoadingContext& context, Scan const& scan, Vector<Macroblock>& macroblocks)
+{
+    // Restart intervals don't depend on each other, so they can be decoded at the same time once the restart markers
+    // that separate them have been found. Only that part is done sequentially.
+    Vector<size_t> restart_marker_offsets;
+    auto const data = TRY(context.stream.read_entropy_coded_data(restart_marker_offsets));
+
+    u32 const total_mcu_count = mcu_count(context);
+    size_t const interval_count = ceil_div(total_mcu_count, static_cast<u32>(context.dc_restart_interval));
+
+    // If restart markers are missing, the intervals can't be told apart, so decode everything as a single chunk.
+    size_t chunk_count = 1;
+    if (restart_marker_offsets.size() == interval_count - 1)
+        chunk_count = min(interval_count, (task_pool().concurrency() + 1) * 4);
+    size_t const intervals_per_chunk = ceil_div(interval_count, chunk_count);
+    chunk_count = ceil_div(interval_count, intervals_per_chunk);
+
+    auto const decode_chunk = [&](size_t chunk_index) -> ErrorOr<void> {
+        size_t const first_interval = chunk_index * intervals_per_chunk;
+        size_t const end_interval = min(first_interval + intervals_per_chunk, interval_count);
+        size_t const start = first_interval == 0 ? 0 : restart_marker_offsets[first_interval - 1] + sizeof(Marker);
+        size_t const end = end_interval == interval_count ? data.size() : restart_marker_offsets[end_interval - 1];
+
+        // The Huffman stream reads a bit past the data it needs, so end the chunk with a marker to make it read zeroes.
+        auto chunk_data = TRY(ByteBuffer::create_uninitialized(end - start + sizeof(Marker)));
+        data.bytes().slice(start, end - start).copy_to(chunk_data);
+        chunk_data[end - start] = JPEG_EOI >> 8;
+        chunk_data[end - start + 1] = JPEG_EOI & 0xFF;
+
+        auto chunk_stream = TRY(JPEGStream::create(make<FixedMemoryStream>(chunk_data.bytes())));
+        Scan chunk_scan { scan, HuffmanStream { chunk_stream } };
+        u32 const first_mcu = first_interval * context.dc_restart_interval;
+        u32 const end_mcu = min<u32>(end_interval * context.dc_restart_interval, total_mcu_count);
+        return decode_mcus(context, chunk_scan, macroblocks, first_mcu, end_mcu);
+    };
+
+    Vector<Optional<Error>> errors;
+    TRY(errors.try_resize(chunk_count));
+    Threading::parallel_for(
+        task_pool(), chunk_count, [&](size_t chunk_index) {
+            if (auto result = decode_chunk(chunk_index); result.is_error())
+                errors[chunk_index] = result.release_error();
+        },
+        1);
+
+    for (auto& error : errors) {
+        if (error.has_value())
+            return error.release_value();
+    }
+    return {};
+}
+
+static ErrorOr<void> decode_huffman_stream(JPEGLoadingContext& context, Vector<Macroblock>& macroblocks)
+{
+    auto& scan = *context.current_scan;
+
+    // Truncated data misses the restart marker at the end of the last interval, so it's decoded sequentially.
+    if (!is_progressive(context.frame.type) && context.dc_restart_interval > 0 && scan.are_components_interleaved() && should_decode_in_parallel(context) && !context.allow_truncated_data)
+        return decode_restart_intervals_in_parallel(context, scan, macroblocks);
+
+    auto result = decode_mcus(context, scan, macroblocks, 0, mcu_count(context));
+    if (result.is_error() && context.allow_truncated_data) {
+        // The MCU that was cut off may be incomplete, so only count the rows of MCUs before it.
+        u32 const mcus_per_row = context.mblock_meta.hpadded_count / context.sampling_factors.horizontal;
+        u32 const decoded_row_count = (scan.decoded_mcu_count / mcus_per_row) * context.sampling_factors.vertical * 8;
+        context.decoded_row_count = max(context.decoded_row_count, min(decoded_row_count, static_cast<u32>(context.frame.height)));
+    }
+    return result;
+}
+
 static bool is_frame_marker(Marker const marker)
 {
     // B.1.1.3 - Marker assignments
@@ -1407,39 +1562,37 @@ static ErrorOr<void> skip_segment(JPEGStream& stream)
     return {};
 }
 
-static void dequantize(JPEGLoadingContext& context, Vector<Macroblock>& macroblocks)
+ALWAYS_INLINE static i32x4 load_i32x4(i16 const* values)
 {
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.sampling_factors.vertical) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.sampling_factors.horizontal) {
-            for (u32 i = 0; i < context.components.size(); i++) {
-                auto const& component = context.components[i];
-
-                auto const& table = context.quantization_tables[component.quantization_table_id];
-
-                for (u32 vfactor_i = 0; vfactor_i < component.sampling_factors.vertical; vfactor_i++) {
-                    for (u32 hfactor_i = 0; hfactor_i < component.sampling_factors.horizontal; hfactor_i++) {
-                        u32 macroblock_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
-                        Macroblock& block = macroblocks[macroblock_index];
-                        auto* block_component = get_component(block, i);
-                        for (u32 k = 0; k < 64; k++)
-                            block_component[k] *= table[k];
-                    }
-                }
-            }
-        }
-    }
+    AK::SIMD::i16x4 result;
+    __builtin_memcpy(&result, values, sizeof(result));
+    return __builtin_convertvector(result, i32x4);
 }
 
-static void inverse_dct_8x8(i16* block_component)
+ALWAYS_INLINE static void store_i16x4(i16* values, i32x4 vector)
 {
-    // Does a 2-D IDCT by doing two 1-D IDCTs as described in https://unix4lyfe.org/dct/
-    // The 1-D DCT idea is described at https://unix4lyfe.org/dct-1d/, read aan.cc from bottom to top.
-    static float const m0 = 2.0f * AK::cos(1.0f / 16.0f * 2.0f * AK::Pi<float>);
-    static float const m1 = 2.0f * AK::cos(2.0f / 16.0f * 2.0f * AK::Pi<float>);
-    static float const m3 = 2.0f * AK::cos(2.0f / 16.0f * 2.0f * AK::Pi<float>);
-    static float const m5 = 2.0f * AK::cos(3.0f / 16.0f * 2.0f * AK::Pi<float>);
-    static float const m2 = m0 - m5;
-    static float const m4 = m0 + m5;
+    auto const result = __builtin_convertvector(vector, AK::SIMD::i16x4);
+    __builtin_memcpy(values, &result, sizeof(result));
+}
+
+ALWAYS_INLINE static void transpose_4x4(f32x4& a, f32x4& b, f32x4& c, f32x4& d)
+{
+    f32x4 const t0 { a[0], b[0], c[0], d[0] };
+    f32x4 const t1 { a[1], b[1], c[1], d[1] };
+    f32x4 const t2 { a[2], b[2], c[2], d[2] };
+    f32x4 const t3 { a[3], b[3], c[3], d[3] };
+    a = t0;
+    b = t1;
+    c = t2;
+    d = t3;
+}
+
+using ScaledQuantizationTable = Array<float, 64>;
+
+static ScaledQuantizationTable scale_quantization_table(Array<u16, 64> const& table)
+{
+    // The 1-D IDCT below expects its inputs to be scaled by these factors, for both the rows and the columns. As in
+    // libjpeg's jidctflt.c, they are folded into the dequantization so that it's only done once per coefficient.
     static float const s0 = AK::cos(0.0f / 16.0f * AK::Pi<float>) / AK::sqrt(8.0f);
     static float const s1 = AK::cos(1.0f / 16.0f * AK::Pi<float>) / 2.0f;
     static float const s2 = AK::cos(2.0f / 16.0f * AK::Pi<float>) / 2.0f;
@@ -1448,193 +1601,153 @@ static void inverse_dct_8x8(i16* block_component)
     static float const s5 = AK::cos(5.0f / 16.0f * AK::Pi<float>) / 2.0f;
     static float const s6 = AK::cos(6.0f / 16.0f * AK::Pi<float>) / 2.0f;
     static float const s7 = AK::cos(7.0f / 16.0f * AK::Pi<float>) / 2.0f;
+    float const scale_factors[8] = { s0, s1, s2, s3, s4, s5, s6, s7 };
 
-    for (u32 k = 0; k < 8; ++k) {
-        float const g0 = block_component[0 * 8 + k] * s0;
-        float const g1 = block_component[4 * 8 + k] * s4;
-        float const g2 = block_component[2 * 8 + k] * s2;
-        float const g3 = block_component[6 * 8 + k] * s6;
-        float const g4 = block_component[5 * 8 + k] * s5;
-        float const g5 = block_component[1 * 8 + k] * s1;
-        float const g6 = block_component[7 * 8 + k] * s7;
-        float const g7 = block_component[3 * 8 + k] * s3;
-
-        float const f0 = g0;
-        float const f1 = g1;
-        float const f2 = g2;
-        float const f3 = g3;
-        float const f4 = g4 - g7;
-        float const f5 = g5 + g6;
-        float const f6 = g5 - g6;
-        float const f7 = g4 + g7;
-
-        float const e0 = f0;
-        float const e1 = f1;
-        float const e2 = f2 - f3;
-        float const e3 = f2 + f3;
-        float const e4 = f4;
-        float const e5 = f5 - f7;
-        float const e6 = f6;
-        float const e7 = f5 + f7;
-        float const e8 = f4 + f6;
-
-        float const d0 = e0;
-        float const d1 = e1;
-        float const d2 = e2 * m1;
-        float const d3 = e3;
-        float const d4 = e4 * m2;
-        float const d5 = e5 * m3;
-        float const d6 = e6 * m4;
-        float const d7 = e7;
-        float const d8 = e8 * m5;
-
-        float const c0 = d0 + d1;
-        float const c1 = d0 - d1;
-        float const c2 = d2 - d3;
-        float const c3 = d3;
-        float const c4 = d4 + d8;
-        float const c5 = d5 + d7;
-        float const c6 = d6 - d8;
-        float const c7 = d7;
-        float const c8 = c5 - c6;
-
-        float const b0 = c0 + c3;
-        float const b1 = c1 + c2;
-        float const b2 = c1 - c2;
-        float const b3 = c0 - c3;
-        float const b4 = c4 - c8;
-        float const b5 = c8;
-        float const b6 = c6 - c7;
-        float const b7 = c7;
-
-        block_component[0 * 8 + k] = b0 + b7;
-        block_component[1 * 8 + k] = b1 + b6;
-        block_component[2 * 8 + k] = b2 + b5;
-        block_component[3 * 8 + k] = b3 + b4;
-        block_component[4 * 8 + k] = b3 - b4;
-        block_component[5 * 8 + k] = b2 - b5;
-        block_component[6 * 8 + k] = b1 - b6;
-        block_component[7 * 8 + k] = b0 - b7;
-    }
-    for (u32 l = 0; l < 8; ++l) {
-        float const g0 = block_component[l * 8 + 0] * s0;
-        float const g1 = block_component[l * 8 + 4] * s4;
-        float const g2 = block_component[l * 8 + 2] * s2;
-        float const g3 = block_component[l * 8 + 6] * s6;
-        float const g4 = block_component[l * 8 + 5] * s5;
-        float const g5 = block_component[l * 8 + 1] * s1;
-        float const g6 = block_component[l * 8 + 7] * s7;
-        float const g7 = block_component[l * 8 + 3] * s3;
-
-        float const f0 = g0;
-        float const f1 = g1;
-        float const f2 = g2;
-        float const f3 = g3;
-        float const f4 = g4 - g7;
-        float const f5 = g5 + g6;
-        float const f6 = g5 - g6;
-        float const f7 = g4 + g7;
-
-        float const e0 = f0;
-        float const e1 = f1;
-        float const e2 = f2 - f3;
-        float const e3 = f2 + f3;
-        float const e4 = f4;
-        float const e5 = f5 - f7;
-        float const e6 = f6;
-        float const e7 = f5 + f7;
-        float const e8 = f4 + f6;
-
-        float const d0 = e0;
-        float const d1 = e1;
-        float const d2 = e2 * m1;
-        float const d3 = e3;
-        float const d4 = e4 * m2;
-        float const d5 = e5 * m3;
-        float const d6 = e6 * m4;
-        float const d7 = e7;
-        float const d8 = e8 * m5;
-
-        float const c0 = d0 + d1;
-        float const c1 = d0 - d1;
-        float const c2 = d2 - d3;
-        float const c3 = d3;
-        float const c4 = d4 + d8;
-        float const c5 = d5 + d7;
-        float const c6 = d6 - d8;
-        float const c7 = d7;
-        float const c8 = c5 - c6;
-
-        float const b0 = c0 + c3;
-        float const b1 = c1 + c2;
-        float const b2 = c1 - c2;
-        float const b3 = c0 - c3;
-        float const b4 = c4 - c8;
-        float const b5 = c8;
-        float const b6 = c6 - c7;
-        float const b7 = c7;
-
-        block_component[l * 8 + 0] = b0 + b7;
-        block_component[l * 8 + 1] = b1 + b6;
-        block_component[l * 8 + 2] = b2 + b5;
-        block_component[l * 8 + 3] = b3 + b4;
-        block_component[l * 8 + 4] = b3 - b4;
-        block_component[l * 8 + 5] = b2 - b5;
-        block_component[l * 8 + 6] = b1 - b6;
-        block_component[l * 8 + 7] = b0 - b7;
-    }
-}
-
-static void inverse_dct(JPEGLoadingContext const& context, Vector<Macroblock>& macroblocks)
-{
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.sampling_factors.vertical) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.sampling_factors.horizontal) {
-            for (u32 component_i = 0; component_i < context.components.size(); component_i++) {
-                auto& component = context.components[component_i];
-                for (u8 vfactor_i = 0; vfactor_i < component.sampling_factors.vertical; vfactor_i++) {
-                    for (u8 hfactor_i = 0; hfactor_i < component.sampling_factors.horizontal; hfactor_i++) {
-                        u32 macroblock_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
-                        Macroblock& block = macroblocks[macroblock_index];
-                        auto* block_component = get_component(block, component_i);
-                        inverse_dct_8x8(block_component);
-                    }
-                }
-            }
+    ScaledQuantizationTable scaled_table;
+    for (u32 row = 0; row < 8; ++row) {
+        for (u32 column = 0; column < 8; ++column)
+            scaled_table[row * 8 + column] = table[row * 8 + column] * scale_factors[row] * scale_factors[column];
+    }
+    return scaled_table;
+}
+
+ALWAYS_INLINE static void inverse_dct_8(f32x4 (&values)[8])
+{
+    // Does a 1-D IDCT of four rows or columns at once, as described in https://unix4lyfe.org/dct/
+    // The 1-D DCT idea is described at https://unix4lyfe.org/dct-1d/, read aan.cc from bottom to top.
+    static float const m0 = 2.0f * AK::cos(1.0f / 16.0f * 2.0f * AK::Pi<float>);
+    static float const m1 = 2.0f * AK::cos(2.0f / 16.0f * 2.0f * AK::Pi<float>);
+    static float const m3 = 2.0f * AK::cos(2.0f / 16.0f * 2.0f * AK::Pi<float>);
+    static float const m5 = 2.0f * AK::cos(3.0f / 16.0f * 2.0f * AK::Pi<float>);
+    static float const m2 = m0 - m5;
+    static float const m4 = m0 + m5;
+
+    f32x4 const g0 = values[0];
+    f32x4 const g1 = values[4];
+    f32x4 const g2 = values[2];
+    f32x4 const g3 = values[6];
+    f32x4 const g4 = values[5];
+    f32x4 const g5 = values[1];
+    f32x4 const g6 = values[7];
+    f32x4 const g7 = values[3];
+
+    f32x4 const f4 = g4 - g7;
+    f32x4 const f5 = g5 + g6;
+    f32x4 const f6 = g5 - g6;
+    f32x4 const f7 = g4 + g7;
+
+    f32x4 const e2 = g2 - g3;
+    f32x4 const e3 = g2 + g3;
+    f32x4 const e5 = f5 - f7;
+    f32x4 const e7 = f5 + f7;
+    f32x4 const e8 = f4 + f6;
+
+    f32x4 const d2 = e2 * m1;
+    f32x4 const d4 = f4 * m2;
+    f32x4 const d5 = e5 * m3;
+    f32x4 const d6 = f6 * m4;
+    f32x4 const d8 = e8 * m5;
+
+    f32x4 const c0 = g0 + g1;
+    f32x4 const c1 = g0 - g1;
+    f32x4 const c2 = d2 - e3;
+    f32x4 const c4 = d4 + d8;
+    f32x4 const c5 = d5 + e7;
+    f32x4 const c6 = d6 - d8;
+    f32x4 const c8 = c5 - c6;
+
+    f32x4 const b0 = c0 + e3;
+    f32x4 const b1 = c1 + c2;
+    f32x4 const b2 = c1 - c2;
+    f32x4 const b3 = c0 - e3;
+    f32x4 const b4 = c4 - c8;
+    f32x4 const b6 = c6 - e7;
+
+    values[0] = b0 + e7;
+    values[1] = b1 + b6;
+    values[2] = b2 + c8;
+    values[3] = b3 + b4;
+    values[4] = b3 - b4;
+    values[5] = b2 - c8;
+    values[6] = b1 - b6;
+    values[7] = b0 - e7;
+}
+
+static void inverse_dct_8x8(i16* block_component, ScaledQuantizationTable const& table, u8 precision)
+{
+    // A 2-D IDCT is two 1-D IDCTs, one over the columns and one over the rows. The block is processed as two halves of
+    // four columns, with one vector per row, so that each 1-D IDCT transforms four columns (and then rows) at once.
+    f32x4 halves[2][8];
+    for (u32 half = 0; half < 2; ++half) {
+        for (u32 row = 0; row < 8; ++row) {
+            auto const offset = row * 8 + half * 4;
+            f32x4 scale;
+            __builtin_memcpy(&scale, &table[offset], sizeof(scale));
+            halves[half][row] = __builtin_convertvector(load_i32x4(&block_component[offset]), f32x4) * scale;
         }
+        inverse_dct_8(halves[half]);
+    }
+
+    // Transpose the 4x4 sub-blocks, so that each half now holds four rows with one vector per column.
+    for (u32 half = 0; half < 2; ++half) {
+        transpose_4x4(halves[half][0], halves[half][1], halves[half][2], halves[half][3]);
+        transpose_4x4(halves[half][4], halves[half][5], halves[half][6], halves[half][7]);
     }
+    for (u32 i = 0; i < 4; ++i)
+        swap(halves[0][4 + i], halves[1][i]);
 
     // F.2.1.5 - Inverse DCT (IDCT)
-    auto const level_shift = 1 << (context.frame.precision - 1);
-    auto const max_value = (1 << context.frame.precision) - 1;
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.sampling_factors.vertical) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.sampling_factors.horizontal) {
-            for (u8 vfactor_i = 0; vfactor_i < context.sampling_factors.vertical; ++vfactor_i) {
-                for (u8 hfactor_i = 0; hfactor_i < context.sampling_factors.horizontal; ++hfactor_i) {
-                    u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hcursor + hfactor_i);
-                    for (u8 i = 0; i < 8; ++i) {
-                        for (u8 j = 0; j < 8; ++j) {
-
-                            // FIXME: This just truncate all coefficients, it's an easy way to support (read hack)
-                            //        12 bits JPEGs without rewriting all color transformations.
-                            auto const clamp_to_8_bits = [&](u16 color) -> u8 {
-                                if (context.frame.precision == 8)
-                                    return static_cast<u8>(color);
-                                return static_cast<u8>(color >> 4);
-                            };
-
-                            macroblocks[mb_index].r[i * 8 + j] = clamp_to_8_bits(clamp(macroblocks[mb_index].r[i * 8 + j] + level_shift, 0, max_value));
-                            macroblocks[mb_index].g[i * 8 + j] = clamp_to_8_bits(clamp(macroblocks[mb_index].g[i * 8 + j] + level_shift, 0, max_value));
-                            macroblocks[mb_index].b[i * 8 + j] = clamp_to_8_bits(clamp(macroblocks[mb_index].b[i * 8 + j] + level_shift, 0, max_value));
-                            macroblocks[mb_index].k[i * 8 + j] = clamp_to_8_bits(clamp(macroblocks[mb_index].k[i * 8 + j] + level_shift, 0, max_value));
-                        }
-                    }
-                }
+    // FIXME: 12 bits JPEGs are truncated to 8 bits, it's an easy way to support (read hack) them without rewriting all
+    //        color transformations.
+    float const output_scale = precision == 8 ? 1.0f : 1.0f / 16.0f;
+    float const level_shift = 1 << (precision - 1);
+    for (u32 half = 0; half < 2; ++half) {
+        inverse_dct_8(halves[half]);
+        transpose_4x4(halves[half][0], halves[half][1], halves[half][2], halves[half][3]);
+        transpose_4x4(halves[half][4], halves[half][5], halves[half][6], halves[half][7]);
+        for (u32 row = 0; row < 4; ++row) {
+            for (u32 column_half = 0; column_half < 2; ++column_half) {
+                // Round to the nearest value by adding one half, as the conversion truncates.
+                auto const samples = AK::SIMD::clamp((halves[half][column_half * 4 + row] + level_shift) * output_scale + 0.5f, 0.0f, 255.0f);
+                store_i16x4(&block_component[(half * 4 + row) * 8 + column_half * 4], __builtin_convertvector(samples, i32x4));
             }
         }
     }
 }
 
-static void undo_subsampling(JPEGLoadingContext const& context, Vector<Macroblock>& macroblocks)
+// When the image is downscaled to 1/8, each block becomes a single pixel, which is just the average of its samples.
+// That's the DC coefficient, see A.3.3 - FDCT and IDCT (informative), so the full IDCT can be skipped.
+static void inverse_dct_8x8_dc_only(i16* block_component, u16 quantization, u8 precision)
+{
+    float const output_scale = precision == 8 ? 1.0f : 1.0f / 16.0f;
+    float const level_shift = 1 << (precision - 1);
+    auto const sample = static_cast<i16>(clamp((block_component[0] * quantization / 8.0f + level_shift) * output_scale + 0.5f, 0.0f, 255.0f));
+    for (u8 i = 0; i < 64; ++i)
+        block_component[i] = sample;
+}
+
+template<u8 VerticalFactor, u8 HorizontalFactor>
+static void upsample_component(JPEGLoadingContext const& context, Vector<Macroblock>& macroblocks, u32 component_i, u32 hcursor, u32 vcursor)
+{
+    // The component is stored subsampled in the top-left block of the MCU, which is about to be overwritten.
+    i16 source[64];
+    __builtin_memcpy(source, get_component(macroblocks[vcursor * context.mblock_meta.hpadded_count + hcursor], component_i), sizeof(source));
+
+    for (u8 vfactor_i = 0; vfactor_i < VerticalFactor; vfactor_i++) {
+        for (u8 hfactor_i = 0; hfactor_i < HorizontalFactor; hfactor_i++) {
+            u32 macroblock_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
+            auto* block_component_destination = get_component(macroblocks[macroblock_index], component_i);
+            for (u8 i = 0; i < 8; ++i) {
+                // The component is 8x8 subsampled 2x2. Upsample its 2x2 4x4 tiles.
+                auto const* source_row = &source[(i / VerticalFactor + 4 * vfactor_i) * 8 + 4 * hfactor_i];
+                for (u8 j = 0; j < 8; ++j)
+                    block_component_destination[i * 8 + j] = source_row[j / HorizontalFactor];
+            }
+        }
+    }
+}
+
+static void undo_subsampling(JPEGLoadingContext const& context, Vector<Macroblock>& macroblocks, u32 vcursor)
 {
     // The first component has sampling factors of context.sampling_factors, while the others
     // divide the first component's sampling factors. This is enforced by read_start_of_frame().
@@ -1649,56 +1762,78 @@ static void undo_subsampling(JPEGLoadingContext const& context, Vector<Macrobloc
         if (component.sampling_factors == context.sampling_factors)
             continue;
 
-        for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.sampling_factors.vertical) {
-            for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.sampling_factors.horizontal) {
-                u32 const component_block_index = vcursor * context.mblock_meta.hpadded_count + hcursor;
-                Macroblock& component_block = macroblocks[component_block_index];
-                auto* block_component_source = get_component(component_block, component_i);
-
-                // Overflows are intentional.
-                for (u8 vfactor_i = context.sampling_factors.vertical - 1; vfactor_i < context.sampling_factors.vertical; --vfactor_i) {
-                    for (u8 hfactor_i = context.sampling_factors.horizontal - 1; hfactor_i < context.sampling_factors.horizontal; --hfactor_i) {
-                        u32 macroblock_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
-                        Macroblock& block = macroblocks[macroblock_index];
-                        auto* block_component_destination = get_component(block, component_i);
-                        for (u8 i = 7; i < 8; --i) {
-                            for (u8 j = 7; j < 8; --j) {
-                                u8 const pixel = i * 8 + j;
-                                // The component is 8x8 subsampled 2x2. Upsample its 2x2 4x4 tiles.
-                                u32 const component_pxrow = (i / context.sampling_factors.vertical) + 4 * vfactor_i;
-                                u32 const component_pxcol = (j / context.sampling_factors.horizontal) + 4 * hfactor_i;
-                                u32 const component_pixel = component_pxrow * 8 + component_pxcol;
-                                block_component_destination[pixel] = block_component_source[component_pixel];
-                            }
-                        }
-                    }
+        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.sampling_factors.horizontal) {
+            // Both factors are either 1 or 2, see validate_sampling_factors_and_modify_context().
+            if (context.sampling_factors.vertical == 2 && context.sampling_factors.horizontal == 2)
+                upsample_component<2, 2>(context, macroblocks, component_i, hcursor, vcursor);
+            else if (context.sampling_factors.vertical == 2)
+                upsample_component<2, 1>(context, macroblocks, component_i, hcursor, vcursor);
+            else if (context.sampling_factors.horizontal == 2)
+                upsample_component<1, 2>(context, macroblocks, component_i, hcursor, vcursor);
+        }
+    }
+}
+
+static void reconstruct_samples(JPEGLoadingContext const& context, Array<ScaledQuantizationTable, 4> const& scaled_quantization_tables, Vector<Macroblock>& macroblocks, u32 vcursor)
+{
+    for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.sampling_factors.horizontal) {
+        for (u32 component_i = 0; component_i < context.components.size(); component_i++) {
+            auto& component = context.components[component_i];
+            auto const& table = scaled_quantization_tables[component.quantization_table_id];
+            for (u8 vfactor_i = 0; vfactor_i < component.sampling_factors.vertical; vfactor_i++) {
+                for (u8 hfactor_i = 0; hfactor_i < component.sampling_factors.horizontal; hfactor_i++) {
+                    u32 macroblock_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
+                    Macroblock& block = macroblocks[macroblock_index];
+                    if (context.scale_denominator == 8)
+                        inverse_dct_8x8_dc_only(get_component(block, component_i), context.quantization_tables[component.quantization_table_id][0], context.frame.precision);
+                    else
+                        inverse_dct_8x8(get_component(block, component_i), table, context.frame.precision);
                 }
             }
         }
     }
+    undo_subsampling(context, macroblocks, vcursor);
 }
 
-static void ycbcr_to_rgb(Vector<Macroblock>& macroblocks)
+static void ycbcr_to_rgb(Span<Macroblock> macroblocks)
 {
     // Conversion from YCbCr to RGB isn't specified in the first JPEG specification but in the JFIF extension:
     // See: https://www.itu.int/rec/dologin_pub.asp?lang=f&id=T-REC-T.871-201105-I!!PDF-E&type=items
     // 7 - Conversion to and from RGB
+    auto const clamp_to_8_bits = [](i32x4 value) {
+        value = value < 0 ? 0 : value;
+        return value > 255 ? 255 : value;
+    };
+
     for (auto& macroblock : macroblocks) {
         auto* y = macroblock.y;
         auto* cb = macroblock.cb;
         auto* cr = macroblock.cr;
-        for (u8 i = 0; i < 64; ++i) {
-            int r = y[i] + 1.402f * (cr[i] - 128);
-            int g = y[i] - 0.3441f * (cb[i] - 128) - 0.7141f * (cr[i] - 128);
-            int b = y[i] + 1.772f * (cb[i] - 128);
-            y[i] = clamp(r, 0, 255);
-            cb[i] = clamp(g, 0, 255);
-            cr[i] = clamp(b, 0, 255);
+        for (u8 i = 0; i < 64; i += 4) {
+            auto const luma = __builtin_convertvector(load_i32x4(&y[i]), f32x4);
+            auto const blue_difference = __builtin_convertvector(load_i32x4(&cb[i]) - 128, f32x4);
+            auto const red_difference = __builtin_convertvector(load_i32x4(&cr[i]) - 128, f32x4);
+            auto const r = __builtin_convertvector(luma + 1.402f * red_difference, i32x4);
+            auto const g = __builtin_convertvector(luma - 0.3441f * blue_difference - 0.7141f * red_difference, i32x4);
+            auto const b = __builtin_convertvector(luma + 1.772f * blue_difference, i32x4);
+            store_i16x4(&y[i], clamp_to_8_bits(r));
+            store_i16x4(&cb[i], clamp_to_8_bits(g));
+            store_i16x4(&cr[i], clamp_to_8_bits(b));
         }
     }
 }
 
-static void invert_colors_for_adobe_images(JPEGLoadingContext const& context, Vector<Macroblock>& macroblocks)
+static void grayscale_to_rgb(Span<Macroblock> macroblocks)
+{
+    // This is what ycbcr_to_rgb() does with Cb and Cr being equal to 128 (zero before the level shift), but as the
+    // chroma blocks aren't decoded for grayscale images, set R, G and B directly.
+    for (auto& macroblock : macroblocks) {
+        __builtin_memcpy(macroblock.g, macroblock.r, sizeof(macroblock.g));
+        __builtin_memcpy(macroblock.b, macroblock.r, sizeof(macroblock.b));
+    }
+}
+
+static void invert_colors_for_adobe_images(JPEGLoadingContext const& context, Span<Macroblock> macroblocks)
 {
     if (!context.color_transform.has_value())
         return;
@@ -1719,7 +1854,7 @@ static void invert_colors_for_adobe_images(JPEGLoadingContext const& context, Ve
     }
 }
 
-static void ycck_to_cmyk(Vector<Macroblock>& macroblocks)
+static void ycck_to_cmyk(Span<Macroblock> macroblocks)
 {
     // 7 - Conversions between colour encodings
     // YCCK is obtained from CMYK by converting the CMY channels to YCC channel.
@@ -1737,23 +1872,26 @@ static void ycck_to_cmyk(Vector<Macroblock>& macroblocks)
     }
 }
 
-static ErrorOr<void> handle_color_transform(JPEGLoadingContext const& context, Vector<Macroblock>& macroblocks)
+static ErrorOr<void> ensure_color_transform_is_supported(JPEGLoadingContext const& context)
+{
+    // https://www.itu.int/rec/dologin_pub.asp?lang=e&id=T-REC-T.872-201206-I!!PDF-E&type=items
+    // 6.5.3 - APP14 marker segment for colour encoding
+    if (context.color_transform == ColorTransform::CmykOrRgb && context.components.size() != 1) {
+        // Note: components.size() == 3 means that we have an RGB image, so no color transformation is needed.
+        if (context.components.size() != 3 && context.components.size() != 4)
+            return Error::from_string_literal("Wrong number of components for CMYK or RGB, aborting.");
+    }
+    return {};
+}
+
+static void handle_color_transform(JPEGLoadingContext const& context, Span<Macroblock> macroblocks)
 {
     // Note: This is non-standard but some encoder still add the App14 segment for grayscale images.
     //       So let's ignore the color transform value if we only have one component.
     if (context.color_transform.has_value() && context.components.size() != 1) {
-        // https://www.itu.int/rec/dologin_pub.asp?lang=e&id=T-REC-T.872-201206-I!!PDF-E&type=items
-        // 6.5.3 - APP14 marker segment for colour encoding
-
         switch (*context.color_transform) {
         case ColorTransform::CmykOrRgb:
-            if (context.components.size() == 4) {
-                // Nothing to do here.
-            } else if (context.components.size() == 3) {
-                // Note: components.size() == 3 means that we have an RGB image, so no color transformation is needed.
-            } else {
-                return Error::from_string_literal("Wrong number of components for CMYK or RGB, aborting.");
-            }
+            // Nothing to do here, see ensure_color_transform_is_supported().
             break;
         case ColorTransform::YCbCr:
             ycbcr_to_rgb(macroblocks);
@@ -1762,8 +1900,7 @@ static ErrorOr<void> handle_color_transform(JPEGLoadingContext const& context, V
             ycck_to_cmyk(macroblocks);
             break;
         }
-
-        return {};
+        return;
     }
 
     // No App14 segment is present, assuming :
@@ -1773,56 +1910,128 @@ static ErrorOr<void> handle_color_transform(JPEGLoadingContext const& context, V
     if (context.components.size() == 3)
         ycbcr_to_rgb(macroblocks);
 
-    if (context.components.size() == 1) {
-        // With Cb and Cr being equal to zero, this function assign the Y
-        // value (luminosity) to R, G and B. Providing a proper conversion
-        // from grayscale to RGB.
-        ycbcr_to_rgb(macroblocks);
+    if (context.components.size() == 1)
+        grayscale_to_rgb(macroblocks);
+}
+
+static i16 average_samples(i16 const* samples, u32 first_sample_index, u32 scale_denominator)
+{
+    i32 sum = 0;
+    for (u32 row = 0; row < scale_denominator; ++row) {
+        for (u32 column = 0; column < scale_denominator; ++column)
+            sum += samples[first_sample_index + row * 8 + column];
     }
+    u32 const sample_count = scale_denominator * scale_denominator;
+    return static_cast<i16>((sum + sample_count / 2) / sample_count);
+}
 
-    return {};
+// Each pixel of a downscaled bitmap is the average of a square of samples, which always lies within a single block.
+template<typename Callback>
+static void for_each_downscaled_pixel(JPEGLoadingContext const& context, IntSize bitmap_size, ReadonlySpan<Macroblock> mcu_row, u32 vcursor, Callback callback)
+{
+    u32 const scale_denominator = context.scale_denominator;
+    u32 const end_y = min(static_cast<u32>(bitmap_size.height()), (vcursor + context.sampling_factors.vertical) * 8 / scale_denominator);
+    for (u32 y = vcursor * 8 / scale_denominator; y < end_y; y++) {
+        u32 const block_row = y * scale_denominator / 8 - vcursor;
+        u32 const first_sample_row = y * scale_denominator % 8;
+        for (u32 x = 0; x < static_cast<u32>(bitmap_size.width()); x++) {
+            auto& block = mcu_row[block_row * context.mblock_meta.hpadded_count + x * scale_denominator / 8];
+            u32 const first_sample_index = first_sample_row * 8 + x * scale_denominator % 8;
+            callback(x, y, block, first_sample_index);
+        }
+    }
 }
 
-static ErrorOr<void> compose_bitmap(JPEGLoadingContext& context, Vector<Macroblock> const& macroblocks)
+// Both compose functions write the pixels of the MCU row starting at block row `vcursor`.
+static void compose_bitmap(JPEGLoadingContext& context, ReadonlySpan<Macroblock> mcu_row, u32 vcursor)
 {
-    context.bitmap = TRY(Bitmap::create(BitmapFormat::BGRx8888, { context.frame.width, context.frame.height }));
+    if (u32 const scale_denominator = context.scale_denominator; scale_denominator != 1) {
+        for_each_downscaled_pixel(context, context.bitmap->size(), mcu_row, vcursor, [&](u32 x, u32 y, Macroblock const& block, u32 first_sample_index) {
+            auto const r = average_samples(block.r, first_sample_index, scale_denominator);
+            auto const g = average_samples(block.g, first_sample_index, scale_denominator);
+            auto const b = average_samples(block.b, first_sample_index, scale_denominator);
+            context.bitmap->scanline(y)[x] = Color { (u8)r, (u8)g, (u8)b }.value();
+        });
+        return;
+    }
 
-    for (u32 y = context.frame.height - 1; y < context.frame.height; y--) {
-        u32 const block_row = y / 8;
+    u32 const end_y = min(context.frame.height, (vcursor + context.sampling_factors.vertical) * 8);
+    for (u32 y = vcursor * 8; y < end_y; y++) {
+        u32 const block_row = y / 8 - vcursor;
         u32 const pixel_row = y % 8;
-        for (u32 x = 0; x < context.frame.width; x++) {
-            u32 const block_column = x / 8;
-            auto& block = macroblocks[block_row * context.mblock_meta.hpadded_count + block_column];
-            u32 const pixel_column = x % 8;
-            u32 const pixel_index = pixel_row * 8 + pixel_column;
-            Color const color { (u8)block.y[pixel_index], (u8)block.cb[pixel_index], (u8)block.cr[pixel_index] };
-            context.bitmap->set_pixel(x, y, color);
+        auto* scanline = context.bitmap->scanline(y);
+        for (u32 block_x = 0; block_x < context.frame.width; block_x += 8) {
+            auto& block = mcu_row[block_row * context.mblock_meta.hpadded_count + block_x / 8];
+            auto const* r = &block.r[pixel_row * 8];
+            auto const* g = &block.g[pixel_row * 8];
+            auto const* b = &block.b[pixel_row * 8];
+            u32 const pixel_count = min(8u, context.frame.width - block_x);
+            for (u32 pixel_column = 0; pixel_column < pixel_count; pixel_column++)
+                scanline[block_x + pixel_column] = Color { (u8)r[pixel_column], (u8)g[pixel_column], (u8)b[pixel_column] }.value();
         }
     }
-
-    return {};
 }
 
-static ErrorOr<void> compose_cmyk_bitmap(JPEGLoadingContext& context, Vector<Macroblock>& macroblocks)
+static void compose_cmyk_bitmap(JPEGLoadingContext& context, Span<Macroblock> mcu_row, u32 vcursor)
 {
     if (context.options.cmyk == JPEGDecoderOptions::CMYK::Normal)
-        invert_colors_for_adobe_images(context, macroblocks);
-
-    context.cmyk_bitmap = TRY(Gfx::CMYKBitmap::create_with_size({ context.frame.width, context.frame.height }));
+        invert_colors_for_adobe_images(context, mcu_row);
+
+    if (u32 const scale_denominator = context.scale_denominator; scale_denominator != 1) {
+        for_each_downscaled_pixel(context, context.cmyk_bitmap->size(), mcu_row, vcursor, [&](u32 x, u32 y, Macroblock const& block, u32 first_sample_index) {
+            auto const cyan = average_samples(block.y, first_sample_index, scale_denominator);
+            auto const magenta = average_samples(block.cb, first_sample_index, scale_denominator);
+            auto const yellow = average_samples(block.cr, first_sample_index, scale_denominator);
+            auto const black = average_samples(block.k, first_sample_index, scale_denominator);
+            context.cmyk_bitmap->scanline(y)[x] = { (u8)cyan, (u8)magenta, (u8)yellow, (u8)black };
+        });
+        return;
+    }
 
-    for (u32 y = context.frame.height - 1; y < context.frame.height; y--) {
-        u32 const block_row = y / 8;
+    u32 const end_y = min(context.frame.height, (vcursor + context.sampling_factors.vertical) * 8);
+    for (u32 y = vcursor * 8; y < end_y; y++) {
+        u32 const block_row = y / 8 - vcursor;
         u32 const pixel_row = y % 8;
+        auto* scanline = context.cmyk_bitmap->scanline(y);
         for (u32 x = 0; x < context.frame.width; x++) {
-            u32 const block_column = x / 8;
-            auto& block = macroblocks[block_row * context.mblock_meta.hpadded_count + block_column];
-            u32 const pixel_column = x % 8;
-            u32 const pixel_index = pixel_row * 8 + pixel_column;
-            context.cmyk_bitmap->scanline(y)[x] = { (u8)block.y[pixel_index], (u8)block.cb[pixel_index], (u8)block.cr[pixel_index], (u8)block.k[pixel_index] };
+            auto& block = mcu_row[block_row * context.mblock_meta.hpadded_count + x / 8];
+            u32 const pixel_index = pixel_row * 8 + x % 8;
+            scanline[x] = { (u8)block.y[pixel_index], (u8)block.cb[pixel_index], (u8)block.cr[pixel_index], (u8)block.k[pixel_index] };
         }
     }
+}
 
-    return {};
+static void reconstruct_and_compose(JPEGLoadingContext& context, Vector<Macroblock>& macroblocks)
+{
+    Array<ScaledQuantizationTable, 4> scaled_quantization_tables;
+    for (u32 i = 0; i < scaled_quantization_tables.size(); ++i) {
+        if (context.registered_quantization_tables[i])
+            scaled_quantization_tables[i] = scale_quantization_table(context.quantization_tables[i]);
+    }
+
+    // Each row of MCUs is independent from the others from here on, so all remaining stages run on one row at a time
+    // while it is still in the cache, and large images are spread over several threads.
+    auto const decode_mcu_row = [&](u32 vcursor) {
+        reconstruct_samples(context, scaled_quantization_tables, macroblocks, vcursor);
+
+        auto mcu_row = macroblocks.span().slice(vcursor * context.mblock_meta.hpadded_count, context.sampling_factors.vertical * context.mblock_meta.hpadded_count);
+        handle_color_transform(context, mcu_row);
+        if (context.components.size() == 4)
+            compose_cmyk_bitmap(context, mcu_row, vcursor);
+        else
+            compose_bitmap(context, mcu_row, vcursor);
+    };
+
+    u32 const mcu_row_count = context.mblock_meta.vpadded_count / context.sampling_factors.vertical;
+    if (!should_decode_in_parallel(context)) {
+        for (u32 mcu_row = 0; mcu_row < mcu_row_count; ++mcu_row)
+            decode_mcu_row(mcu_row * context.sampling_factors.vertical);
+        return;
+    }
+
+    Threading::parallel_for(task_pool(), mcu_row_count, [&](size_t mcu_row) {
+        decode_mcu_row(mcu_row * context.sampling_factors.vertical);
+    });
 }
 
 static bool is_app_marker(Marker const marker)
@@ -1941,24 +2150,33 @@ static ErrorOr<void> decode_header(JPEGLoadingContext& context)
     return {};
 }
 
-static ErrorOr<Vector<Macroblock>> construct_macroblocks(JPEGLoadingContext& context)
+static ErrorOr<void> decode_scans(JPEGLoadingContext& context, Vector<Macroblock>& macroblocks)
 {
     // B.6 - Summary
     // See: Figure B.16 – Flow of compressed data syntax
     // This function handles the "Multi-scan" loop.
 
-    Vector<Macroblock> macroblocks;
-    TRY(macroblocks.try_resize(context.mblock_meta.padded_total));
-
     Marker marker = TRY(read_marker_at_cursor(context.stream));
     while (true) {
         if (is_miscellaneous_or_table_marker(marker)) {
             TRY(handle_miscellaneous_or_table(context.stream, context, marker));
         } else if (marker == JPEG_SOS) {
             TRY(read_start_of_scan(context.stream, context));
+
+            // At 1/8 of the size, only the DC coefficients are used, so the AC scans of progressive images don't matter.
+            if (context.scale_denominator == 8 && is_progressive(context.frame.type) && context.current_scan->spectral_selection_start != 0) {
+                Vector<size_t> restart_marker_offsets;
+                (void)TRY(context.stream.read_entropy_coded_data(restart_marker_offsets));
+                marker = TRY(read_marker_at_cursor(context.stream));
+                continue;
+            }
+
             TRY(decode_huffman_stream(context, macroblocks));
+
+            // Every row has at least a coarse version of its pixels after a complete scan.
+            context.decoded_row_count = context.frame.height;
         } else if (marker == JPEG_EOI) {
-            return macroblocks;
+            return {};
         } else {
             dbgln_if(JPEG_DEBUG, "Unexpected marker {:x}!", marker);
             return Error::from_string_literal("Unexpected marker");
@@ -1968,22 +2186,47 @@ static ErrorOr<Vector<Macroblock>> construct_macroblocks(JPEGLoadingContext& con
     }
 }
 
+static ErrorOr<Vector<Macroblock>> construct_macroblocks(JPEGLoadingContext& context)
+{
+    Vector<Macroblock> macroblocks;
+    TRY(macroblocks.try_resize(context.mblock_meta.padded_total));
+
+    // With truncated data, the error is where the data ends, and everything decoded until then is kept.
+    if (auto result = decode_scans(context, macroblocks); result.is_error() && !context.allow_truncated_data)
+        return result.release_error();
+    return macroblocks;
+}
+
 static ErrorOr<void> decode_jpeg(JPEGLoadingContext& context)
 {
     auto macroblocks = TRY(construct_macroblocks(context));
-    dequantize(context, macroblocks);
-    inverse_dct(context, macroblocks);
-    undo_subsampling(context, macroblocks);
-    TRY(handle_color_transform(context, macroblocks));
+    TRY(ensure_color_transform_is_supported(context));
+    IntSize const bitmap_size { ceil_div(context.frame.width, static_cast<u16>(context.scale_denominator)), ceil_div(context.frame.height, static_cast<u16>(context.scale_denominator)) };
     if (context.components.size() == 4)
-        TRY(compose_cmyk_bitmap(context, macroblocks));
+        context.cmyk_bitmap = TRY(Gfx::CMYKBitmap::create_with_size(bitmap_size));
     else
-        TRY(compose_bitmap(context, macroblocks));
+        context.bitmap = TRY(Bitmap::create(BitmapFormat::BGRx8888, bitmap_size));
+    reconstruct_and_compose(context, macroblocks);
     return {};
 }
 
-JPEGImageDecoderPlugin::JPEGImageDecoderPlugin(NonnullOwnPtr<JPEGLoadingContext> context)
-    : m_context(move(context))
+// Picks the smallest of the scales supported by decode_jpeg() that still gives at least the ideal size.
+static u8 scale_denominator_for_ideal_size(IntSize image_size, Optional<IntSize> ideal_size)
+{
+    if (!ideal_size.has_value() || ideal_size->is_empty())
+        return 1;
+
+    u8 scale_denominator = 1;
+    while (scale_denominator < 8
+        && image_size.width() / (scale_denominator * 2) >= ideal_size->width()
+        && image_size.height() / (scale_denominator * 2) >= ideal_size->height())
+        scale_denominator *= 2;
+    return scale_denominator;
+}
+
+JPEGImageDecoderPlugin::JPEGImageDecoderPlugin(ReadonlyBytes data, NonnullOwnPtr<JPEGLoadingContext> context)
+    : m_data(data)
+    , m_context(move(context))
 {
 }
 
@@ -2011,27 +2254,53 @@ ErrorOr<NonnullOwnPtr<ImageDecoderPlugin>> JPEGImageDecoderPlugin::create_with_o
 {
     auto stream = TRY(try_make<FixedMemoryStream>(data));
     auto context = TRY(JPEGLoadingContext::create(move(stream), options));
-    auto plugin = TRY(adopt_nonnull_own_or_enomem(new (nothrow) JPEGImageDecoderPlugin(move(context))));
+    auto plugin = TRY(adopt_nonnull_own_or_enomem(new (nothrow) JPEGImageDecoderPlugin(data, move(context))));
     TRY(decode_header(*plugin->m_context));
     return plugin;
 }
 
-ErrorOr<ImageFrameDescriptor> JPEGImageDecoderPlugin::frame(size_t index, Optional<IntSize>)
+ErrorOr<void> JPEGImageDecoderPlugin::decode_bitmap(u8 scale_denominator)
 {
-    if (index > 0)
-        return Error::from_string_literal("JPEGImageDecoderPlugin: Invalid frame index");
-
     if (m_context->state == JPEGLoadingContext::State::Error)
         return Error::from_string_literal("JPEGImageDecoderPlugin: Decoding failed");
 
-    if (m_context->state < JPEGLoadingContext::State::BitmapDecoded) {
-        if (auto result = decode_jpeg(*m_context); result.is_error()) {
-            m_context->state = JPEGLoadingContext::State::Error;
-            return result.release_error();
-        }
-        m_context->state = JPEGLoadingContext::State::BitmapDecoded;
+    if (m_context->state == JPEGLoadingContext::State::BitmapDecoded) {
+        // A bigger bitmap is always good enough.
+        if (m_context->scale_denominator <= scale_denominator)
+            return {};
+
+        // The image was downscaled for an earlier frame, so it has to be decoded from the start again.
+        auto stream = TRY(try_make<FixedMemoryStream>(m_data));
+        auto context = TRY(JPEGLoadingContext::create(move(stream), m_context->options));
+        context->allow_truncated_data = m_context->allow_truncated_data;
+        TRY(decode_header(*context));
+        m_context = move(context);
     }
 
+    m_context->scale_denominator = scale_denominator;
+    if (auto result = decode_jpeg(*m_context); result.is_error()) {
+        m_context->state = JPEGLoadingContext::State::Error;
+        return result.release_error();
+    }
+    m_context->state = JPEGLoadingContext::State::BitmapDecoded;
+    return {};
+}
+
+ErrorOr<PartialImageFrameDescriptor> JPEGImageDecoderPlugin::partial_frame()
+{
+    VERIFY(m_context->state == JPEGLoadingContext::State::HeaderDecoded);
+    m_context->allow_truncated_data = true;
+    auto frame = TRY(this->frame(0));
+    return PartialImageFrameDescriptor { frame.image, static_cast<int>(m_context->decoded_row_count) };
+}
+
+ErrorOr<ImageFrameDescriptor> JPEGImageDecoderPlugin::frame(size_t index, Optional<IntSize> ideal_size)
+{
+    if (index > 0)
+        return Error::from_string_literal("JPEGImageDecoderPlugin: Invalid frame index");
+
+    TRY(decode_bitmap(scale_denominator_for_ideal_size(size(), ideal_size)));
+
     if (m_context->cmyk_bitmap && !m_context->bitmap)
         return ImageFrameDescriptor { TRY(m_context->cmyk_bitmap->to_low_quality_rgb()), 0 };
 
@@ -2068,13 +2337,7 @@ ErrorOr<NonnullRefPtr<CMYKBitmap>> JPEGImageDecoderPlugin::cmyk_frame()
 {
     VERIFY(natural_frame_format() == NaturalFrameFormat::CMYK);
 
-    if (m_context->state < JPEGLoadingContext::State::BitmapDecoded) {
-        if (auto result = decode_jpeg(*m_context); result.is_error()) {
-            m_context->state = JPEGLoadingContext::State::Error;
-            return result.release_error();
-        }
-        m_context->state = JPEGLoadingContext::State::BitmapDecoded;
-    }
+    TRY(decode_bitmap(1));
 
     return *m_context->cmyk_bitmap;
 }
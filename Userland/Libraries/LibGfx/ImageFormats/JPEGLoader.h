@@ -45,9 +45,15 @@ public:
     virtual NaturalFrameFormat natural_frame_format() const override;
     virtual ErrorOr<NonnullRefPtr<CMYKBitmap>> cmyk_frame() override;
 
+    virtual bool supports_partial_decoding() const override { return true; }
+    virtual ErrorOr<PartialImageFrameDescriptor> partial_frame() override;
+
 private:
-    JPEGImageDecoderPlugin(NonnullOwnPtr<JPEGLoadingContext>);
+    JPEGImageDecoderPlugin(ReadonlyBytes, NonnullOwnPtr<JPEGLoadingContext>);
+
+    ErrorOr<void> decode_bitmap(u8 scale_denominator);
 
+    ReadonlyBytes m_data;
     NonnullOwnPtr<JPEGLoadingContext> m_context;
 };
 
@@ -250,7 +250,18 @@ public:
 
     ErrorOr<void> write_huffman_stream(Mode mode)
     {
-        for (auto& macroblock : m_macroblocks) {
+        for (size_t i = 0; i < m_macroblocks.size(); ++i) {
+            // B.2.1 - High-level syntax
+            // The restart markers RSTm are numbered modulo 8 and separate the intervals, so none follows the last one.
+            if (m_restart_interval != 0 && i != 0 && i % m_restart_interval == 0) {
+                TRY(m_bit_stream.align_to_byte_boundary(0xFF));
+                TRY(m_bit_stream.write_value<BigEndian<Marker>>(JPEG_RST0 + (i / m_restart_interval - 1) % 8));
+
+                // F.1.2.1.3 - The DC predictions are reset to zero at the start of each restart interval.
+                m_last_dc_values = {};
+            }
+
+            auto& macroblock = m_macroblocks[i];
             TRY(encode_dc(dc_luminance_huffman_table, macroblock.y, 0));
             TRY(encode_ac(ac_luminance_huffman_table, macroblock.y));
 
@@ -271,6 +282,8 @@ public:
         return {};
     }
 
+    void set_restart_interval(u16 restart_interval) { m_restart_interval = restart_interval; }
+
     void set_luminance_quantization_table(QuantizationTable const& table, int quality)
     {
         set_quantization_table(m_luminance_quantization_table, table, quality);
@@ -395,6 +408,7 @@ private:
 
     Vector<Macroblock> m_macroblocks {};
     Array<i16, 4> m_last_dc_values {};
+    u16 m_restart_interval { 0 };
 
     JPEGBigEndianOutputBitStream m_bit_stream;
 };
@@ -505,6 +519,20 @@ ErrorOr<void> add_ycck_color_transform_header(Stream& stream)
     return {};
 }
 
+ErrorOr<void> add_restart_interval(Stream& stream, u16 restart_interval)
+{
+    // B.2.4.4 - Restart interval definition syntax
+    TRY(stream.write_value<BigEndian<Marker>>(JPEG_DRI));
+
+    // Lr
+    TRY(stream.write_value<BigEndian<u16>>(4));
+
+    // Ri
+    TRY(stream.write_value<BigEndian<u16>>(restart_interval));
+
+    return {};
+}
+
 ErrorOr<void> add_quantization_table(Stream& stream, QuantizationTable const& table)
 {
     // B.2.4.1 - Quantization table-specification syntax
@@ -621,6 +649,11 @@ ErrorOr<void> add_headers(Stream& stream, JPEGEncodingContext& context, JPEGWrit
     TRY(add_huffman_table(stream, context.ac_luminance_huffman_table));
     TRY(add_huffman_table(stream, context.ac_chrominance_huffman_table));
 
+    if (options.restart_interval != 0) {
+        context.set_restart_interval(options.restart_interval);
+        TRY(add_restart_interval(stream, options.restart_interval));
+    }
+
     TRY(add_scan_header(stream, mode));
     return {};
 }
@@ -14,6 +14,10 @@ namespace Gfx {
 struct JPEGEncoderOptions {
     Optional<ReadonlyBytes> icc_data;
     u8 quality { 75 };
+
+    // Number of MCUs between restart markers, or 0 to not write any. Restart intervals let a decoder resynchronize
+    // after corrupted data and decode the intervals of the image independently from each other.
+    u16 restart_interval { 0 };
 };
 
 class JPEGWriter {
@@ -8,12 +8,14 @@
 #include <AK/Debug.h>
 #include <AK/Endian.h>
 #include <AK/MemoryStream.h>
+#include <AK/SIMDExtras.h>
 #include <AK/Vector.h>
 #include <LibCompress/Zlib.h>
 #include <LibGfx/ImageFormats/PNGLoader.h>
 #include <LibGfx/ImageFormats/TIFFLoader.h>
 #include <LibGfx/ImageFormats/TIFFMetadata.h>
 #include <LibGfx/Painter.h>
+#include <LibThreading/Parallel.h>
 
 namespace Gfx {
 
@@ -82,11 +84,6 @@ struct EmbeddedICCProfile {
     ReadonlyBytes compressed_data;
 };
 
-struct Scanline {
-    PNG::FilterType filter;
-    ReadonlyBytes data {};
-};
-
 struct [[gnu::packed]] PaletteEntry {
     u8 r;
     u8 g;
@@ -134,6 +131,9 @@ struct AnimationFrame {
     RefPtr<Bitmap> bitmap;
     ByteBuffer compressed_data;
 
+    // The frame's own pixels, if they were decoded ahead of rendering the frame onto the previous ones.
+    RefPtr<Bitmap> decoded_bitmap;
+
     AnimationFrame(fcTL_Chunk const& fcTL)
         : fcTL(fcTL)
     {
@@ -185,8 +185,6 @@ struct PNGLoadingContext {
     bool has_seen_idat_chunk { false };
     bool has_seen_actl_chunk_before_idat { false };
     bool has_alpha() const { return to_underlying(color_type) & 4 || palette_transparency_data.size() > 0; }
-    Vector<Scanline> scanlines;
-    ByteBuffer unfiltered_data;
     RefPtr<Gfx::Bitmap> bitmap;
     ByteBuffer compressed_data;
     Vector<PaletteEntry> palette_data;
@@ -202,6 +200,10 @@ struct PNGLoadingContext {
 
     OwnPtr<ExifMetadata> exif_metadata;
 
+    // Set for partial decoding, the data then ends wherever the download currently is.
+    bool allow_truncated_data { false };
+    int decoded_row_count { 0 };
+
     Checked<int> compute_row_size_for_width(int width)
     {
         Checked<int> row_size = width;
@@ -216,7 +218,7 @@ struct PNGLoadingContext {
         return row_size;
     }
 
-    PNGLoadingContext create_subimage_context(int width, int height)
+    PNGLoadingContext create_subimage_context(int width, int height) const
     {
         PNGLoadingContext subimage_context;
         subimage_context.state = State::ChunksDecoded;
@@ -272,6 +274,7 @@ public:
     }
 
     u8 const* current_data_ptr() const { return m_data_ptr; }
+    size_t size_remaining() const { return m_size_remaining; }
     bool at_end() const { return !m_size_remaining; }
 
 private:
@@ -281,20 +284,73 @@ private:
 
 static ErrorOr<void> process_chunk(Streamer&, PNGLoadingContext& context);
 
-union [[gnu::packed]] Pixel {
-    ARGB32 rgba { 0 };
-    u8 v[4];
-    struct {
-        u8 r;
-        u8 g;
-        u8 b;
-        u8 a;
-    };
-};
-static_assert(AssertSize<Pixel, 4>());
+template<size_t bytes_per_pixel>
+ALWAYS_INLINE static AK::SIMD::u8x4 load_pixel(u8 const* data)
+{
+    AK::SIMD::u8x4 pixel {};
+    __builtin_memcpy(&pixel, data, bytes_per_pixel);
+    return pixel;
+}
+
+template<size_t bytes_per_pixel>
+ALWAYS_INLINE static void store_pixel(u8* data, AK::SIMD::u8x4 pixel)
+{
+    __builtin_memcpy(data, &pixel, bytes_per_pixel);
+}
+
+// The same as unfilter_scanline(), but for all bytes of a pixel at once, since each of them only depends on the bytes
+// of the neighboring pixels.
+template<size_t bytes_per_pixel>
+static void unfilter_scanline_by_pixel(PNG::FilterType filter, Bytes scanline_data, ReadonlyBytes previous_scanlines_data)
+{
+    auto* data = scanline_data.data();
+    auto const* previous_data = previous_scanlines_data.data();
+    size_t const size = scanline_data.size();
+
+    AK::SIMD::u8x4 left {};
+    AK::SIMD::u8x4 upper_left {};
+    switch (filter) {
+    case PNG::FilterType::None:
+        break;
+    case PNG::FilterType::Sub:
+        for (size_t i = 0; i < size; i += bytes_per_pixel) {
+            left += load_pixel<bytes_per_pixel>(data + i);
+            store_pixel<bytes_per_pixel>(data + i, left);
+        }
+        break;
+    case PNG::FilterType::Up:
+        for (size_t i = 0; i < size; ++i)
+            data[i] += previous_data[i];
+        break;
+    case PNG::FilterType::Average:
+        for (size_t i = 0; i < size; i += bytes_per_pixel) {
+            auto const above = load_pixel<bytes_per_pixel>(previous_data + i);
+            auto const average = AK::SIMD::to_u8x4((AK::SIMD::to_u16x4(left) + AK::SIMD::to_u16x4(above)) / 2);
+            left = load_pixel<bytes_per_pixel>(data + i) + average;
+            store_pixel<bytes_per_pixel>(data + i, left);
+        }
+        break;
+    case PNG::FilterType::Paeth:
+        for (size_t i = 0; i < size; i += bytes_per_pixel) {
+            auto const above = load_pixel<bytes_per_pixel>(previous_data + i);
+            left = load_pixel<bytes_per_pixel>(data + i) + PNG::paeth_predictor(left, above, upper_left);
+            store_pixel<bytes_per_pixel>(data + i, left);
+            upper_left = above;
+        }
+        break;
+    }
+}
 
 void PNGImageDecoderPlugin::unfilter_scanline(PNG::FilterType filter, Bytes scanline_data, ReadonlyBytes previous_scanlines_data, u8 bytes_per_complete_pixel)
 {
+    // Most images have 3 or 4 bytes per pixel, whose bytes can be unfiltered all at once.
+    if (scanline_data.size() % bytes_per_complete_pixel == 0) {
+        if (bytes_per_complete_pixel == 4)
+            return unfilter_scanline_by_pixel<4>(filter, scanline_data, previous_scanlines_data);
+        if (bytes_per_complete_pixel == 3)
+            return unfilter_scanline_by_pixel<3>(filter, scanline_data, previous_scanlines_data);
+    }
+
     // https://www.w3.org/TR/png-3/#9Filter-types
     // "Filters are applied to bytes, not to pixels, regardless of the bit depth or colour type of the image."
     switch (filter) {
@@ -337,132 +393,62 @@ void PNGImageDecoderPlugin::unfilter_scanline(PNG::FilterType filter, Bytes scan
 }
 
 template<typename T>
-ALWAYS_INLINE static void unpack_grayscale_without_alpha(PNGLoadingContext& context)
+ALWAYS_INLINE static void unpack_grayscale_without_alpha(ReadonlyBytes scanline, Span<ARGB32> pixels)
 {
-    for (int y = 0; y < context.height; ++y) {
-        auto* gray_values = reinterpret_cast<T const*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = gray_values[i];
-            pixel.g = gray_values[i];
-            pixel.b = gray_values[i];
-            pixel.a = 0xff;
-        }
-    }
+    auto* gray_values = reinterpret_cast<T const*>(scanline.data());
+    for (size_t i = 0; i < pixels.size(); ++i)
+        pixels[i] = Color(gray_values[i], gray_values[i], gray_values[i]).value();
 }
 
 template<typename T>
-ALWAYS_INLINE static void unpack_grayscale_with_alpha(PNGLoadingContext& context)
+ALWAYS_INLINE static void unpack_grayscale_with_alpha(ReadonlyBytes scanline, Span<ARGB32> pixels)
 {
-    for (int y = 0; y < context.height; ++y) {
-        auto* tuples = reinterpret_cast<Tuple<T> const*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = tuples[i].gray;
-            pixel.g = tuples[i].gray;
-            pixel.b = tuples[i].gray;
-            pixel.a = tuples[i].a;
-        }
-    }
+    auto* tuples = reinterpret_cast<Tuple<T> const*>(scanline.data());
+    for (size_t i = 0; i < pixels.size(); ++i)
+        pixels[i] = Color(tuples[i].gray, tuples[i].gray, tuples[i].gray, tuples[i].a).value();
 }
 
 template<typename T>
-ALWAYS_INLINE static void unpack_triplets_without_alpha(PNGLoadingContext& context)
+ALWAYS_INLINE static void unpack_triplets_without_alpha(ReadonlyBytes scanline, Span<ARGB32> pixels)
 {
-    for (int y = 0; y < context.height; ++y) {
-        auto* triplets = reinterpret_cast<Triplet<T> const*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = triplets[i].r;
-            pixel.g = triplets[i].g;
-            pixel.b = triplets[i].b;
-            pixel.a = 0xff;
-        }
-    }
+    auto* triplets = reinterpret_cast<Triplet<T> const*>(scanline.data());
+    for (size_t i = 0; i < pixels.size(); ++i)
+        pixels[i] = Color(triplets[i].r, triplets[i].g, triplets[i].b).value();
 }
 
 template<typename T>
-ALWAYS_INLINE static void unpack_triplets_with_transparency_value(PNGLoadingContext& context, Triplet<T> transparency_value)
+ALWAYS_INLINE static void unpack_triplets_with_transparency_value(ReadonlyBytes scanline, Span<ARGB32> pixels, Triplet<T> transparency_value)
 {
-    for (int y = 0; y < context.height; ++y) {
-        auto* triplets = reinterpret_cast<Triplet<T> const*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = triplets[i].r;
-            pixel.g = triplets[i].g;
-            pixel.b = triplets[i].b;
-            if (triplets[i] == transparency_value)
-                pixel.a = 0x00;
-            else
-                pixel.a = 0xff;
-        }
-    }
+    auto* triplets = reinterpret_cast<Triplet<T> const*>(scanline.data());
+    for (size_t i = 0; i < pixels.size(); ++i)
+        pixels[i] = Color(triplets[i].r, triplets[i].g, triplets[i].b, triplets[i] == transparency_value ? 0x00 : 0xff).value();
 }
 
-NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
+template<typename T>
+ALWAYS_INLINE static void unpack_quartets(ReadonlyBytes scanline, Span<ARGB32> pixels)
 {
-    // First unfilter the scanlines:
-
-    // FIXME: Instead of creating a separate buffer for the scanlines that need to be
-    //        mutated, the mutation could be done in place (if the data was non-const).
-    size_t bytes_per_scanline = context.scanlines[0].data.size();
-    size_t bytes_needed_for_all_unfiltered_scanlines = 0;
-    for (int y = 0; y < context.height; ++y) {
-        if (context.scanlines[y].filter != PNG::FilterType::None) {
-            bytes_needed_for_all_unfiltered_scanlines += bytes_per_scanline;
-        }
-    }
-    context.unfiltered_data = TRY(ByteBuffer::create_uninitialized(bytes_needed_for_all_unfiltered_scanlines));
-
-    // From section 6.3 of http://www.libpng.org/pub/png/spec/1.2/PNG-Filters.html
-    // "bpp is defined as the number of bytes per complete pixel, rounding up to one.
-    // For example, for color type 2 with a bit depth of 16, bpp is equal to 6
-    // (three samples, two bytes per sample); for color type 0 with a bit depth of 2,
-    // bpp is equal to 1 (rounding up); for color type 4 with a bit depth of 16, bpp
-    // is equal to 4 (two-byte grayscale sample, plus two-byte alpha sample)."
-    u8 bytes_per_complete_pixel = ceil_div(context.bit_depth, (u8)8) * context.channels;
-
-    u8 dummy_scanline_bytes[bytes_per_scanline];
-    memset(dummy_scanline_bytes, 0, sizeof(dummy_scanline_bytes));
-    auto previous_scanlines_data = ReadonlyBytes { dummy_scanline_bytes, sizeof(dummy_scanline_bytes) };
-
-    for (int y = 0, data_start = 0; y < context.height; ++y) {
-        if (context.scanlines[y].filter != PNG::FilterType::None) {
-            auto scanline_data_slice = context.unfiltered_data.bytes().slice(data_start, bytes_per_scanline);
-
-            // Copy the current values over and set the scanline's data to the to-be-mutated slice
-            context.scanlines[y].data.copy_to(scanline_data_slice);
-            context.scanlines[y].data = scanline_data_slice;
-
-            PNGImageDecoderPlugin::unfilter_scanline(context.scanlines[y].filter, scanline_data_slice, previous_scanlines_data, bytes_per_complete_pixel);
-
-            data_start += bytes_per_scanline;
-        }
-        previous_scanlines_data = context.scanlines[y].data;
-    }
+    auto* quartets = reinterpret_cast<Quartet<T> const*>(scanline.data());
+    for (size_t i = 0; i < pixels.size(); ++i)
+        pixels[i] = Color(quartets[i].r, quartets[i].g, quartets[i].b, quartets[i].a).value();
+}
 
-    // Now unpack the scanlines to RGBA:
+// Converts an unfiltered scanline to the pixels of a BGRA8888 bitmap.
+static ErrorOr<void> unpack_scanline(PNGLoadingContext const& context, ReadonlyBytes scanline, Span<ARGB32> pixels)
+{
     switch (context.color_type) {
     case PNG::ColorType::Greyscale:
         if (context.bit_depth == 8) {
-            unpack_grayscale_without_alpha<u8>(context);
+            unpack_grayscale_without_alpha<u8>(scanline, pixels);
         } else if (context.bit_depth == 16) {
-            unpack_grayscale_without_alpha<u16>(context);
+            unpack_grayscale_without_alpha<u16>(scanline, pixels);
         } else if (context.bit_depth == 1 || context.bit_depth == 2 || context.bit_depth == 4) {
             auto bit_depth_squared = context.bit_depth * context.bit_depth;
             auto pixels_per_byte = 8 / context.bit_depth;
             auto mask = (1 << context.bit_depth) - 1;
-            for (int y = 0; y < context.height; ++y) {
-                auto* gray_values = context.scanlines[y].data.data();
-                for (int x = 0; x < context.width; ++x) {
-                    auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (x % pixels_per_byte));
-                    auto value = (gray_values[x / pixels_per_byte] >> bit_offset) & mask;
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[x];
-                    pixel.r = value * (0xff / bit_depth_squared);
-                    pixel.g = value * (0xff / bit_depth_squared);
-                    pixel.b = value * (0xff / bit_depth_squared);
-                    pixel.a = 0xff;
-                }
+            for (size_t x = 0; x < pixels.size(); ++x) {
+                auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (x % pixels_per_byte));
+                u8 value = ((scanline[x / pixels_per_byte] >> bit_offset) & mask) * (0xff / bit_depth_squared);
+                pixels[x] = Color(value, value, value).value();
             }
         } else {
             VERIFY_NOT_REACHED();
@@ -470,9 +456,9 @@ NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
         break;
     case PNG::ColorType::GreyscaleWithAlpha:
         if (context.bit_depth == 8) {
-            unpack_grayscale_with_alpha<u8>(context);
+            unpack_grayscale_with_alpha<u8>(scanline, pixels);
         } else if (context.bit_depth == 16) {
-            unpack_grayscale_with_alpha<u16>(context);
+            unpack_grayscale_with_alpha<u16>(scanline, pixels);
         } else {
             VERIFY_NOT_REACHED();
         }
@@ -480,102 +466,103 @@ NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
     case PNG::ColorType::Truecolor:
         if (context.palette_transparency_data.size() == 6) {
             if (context.bit_depth == 8) {
-                unpack_triplets_with_transparency_value<u8>(context, Triplet<u8> { context.palette_transparency_data[0], context.palette_transparency_data[2], context.palette_transparency_data[4] });
+                unpack_triplets_with_transparency_value<u8>(scanline, pixels, Triplet<u8> { context.palette_transparency_data[0], context.palette_transparency_data[2], context.palette_transparency_data[4] });
             } else if (context.bit_depth == 16) {
                 u16 tr = context.palette_transparency_data[0] | context.palette_transparency_data[1] << 8;
                 u16 tg = context.palette_transparency_data[2] | context.palette_transparency_data[3] << 8;
                 u16 tb = context.palette_transparency_data[4] | context.palette_transparency_data[5] << 8;
-                unpack_triplets_with_transparency_value<u16>(context, Triplet<u16> { tr, tg, tb });
+                unpack_triplets_with_transparency_value<u16>(scanline, pixels, Triplet<u16> { tr, tg, tb });
             } else {
                 VERIFY_NOT_REACHED();
             }
         } else {
             if (context.bit_depth == 8)
-                unpack_triplets_without_alpha<u8>(context);
+                unpack_triplets_without_alpha<u8>(scanline, pixels);
             else if (context.bit_depth == 16)
-                unpack_triplets_without_alpha<u16>(context);
+                unpack_triplets_without_alpha<u16>(scanline, pixels);
             else
                 VERIFY_NOT_REACHED();
         }
         break;
     case PNG::ColorType::TruecolorWithAlpha:
         if (context.bit_depth == 8) {
-            for (int y = 0; y < context.height; ++y) {
-                memcpy(context.bitmap->scanline(y), context.scanlines[y].data.data(), context.scanlines[y].data.size());
-            }
+            unpack_quartets<u8>(scanline, pixels);
         } else if (context.bit_depth == 16) {
-            for (int y = 0; y < context.height; ++y) {
-                auto* quartets = reinterpret_cast<Quartet<u16> const*>(context.scanlines[y].data.data());
-                for (int i = 0; i < context.width; ++i) {
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-                    pixel.r = quartets[i].r & 0xFF;
-                    pixel.g = quartets[i].g & 0xFF;
-                    pixel.b = quartets[i].b & 0xFF;
-                    pixel.a = quartets[i].a & 0xFF;
-                }
-            }
+            unpack_quartets<u16>(scanline, pixels);
         } else {
             VERIFY_NOT_REACHED();
         }
         break;
-    case PNG::ColorType::IndexedColor:
-        if (context.bit_depth == 8) {
-            for (int y = 0; y < context.height; ++y) {
-                auto* palette_index = context.scanlines[y].data.data();
-                for (int i = 0; i < context.width; ++i) {
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-                    if (palette_index[i] >= context.palette_data.size())
-                        return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range");
-                    auto& color = context.palette_data.at((int)palette_index[i]);
-                    auto transparency = context.palette_transparency_data.size() >= palette_index[i] + 1u
-                        ? context.palette_transparency_data[palette_index[i]]
-                        : 0xff;
-                    pixel.r = color.r;
-                    pixel.g = color.g;
-                    pixel.b = color.b;
-                    pixel.a = transparency;
-                }
-            }
-        } else if (context.bit_depth == 1 || context.bit_depth == 2 || context.bit_depth == 4) {
-            auto pixels_per_byte = 8 / context.bit_depth;
-            auto mask = (1 << context.bit_depth) - 1;
-            for (int y = 0; y < context.height; ++y) {
-                auto* palette_indices = context.scanlines[y].data.data();
-                for (int i = 0; i < context.width; ++i) {
-                    auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (i % pixels_per_byte));
-                    auto palette_index = (palette_indices[i / pixels_per_byte] >> bit_offset) & mask;
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-                    if ((size_t)palette_index >= context.palette_data.size())
-                        return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range");
-                    auto& color = context.palette_data.at(palette_index);
-                    auto transparency = context.palette_transparency_data.size() >= palette_index + 1u
-                        ? context.palette_transparency_data[palette_index]
-                        : 0xff;
-                    pixel.r = color.r;
-                    pixel.g = color.g;
-                    pixel.b = color.b;
-                    pixel.a = transparency;
-                }
+    case PNG::ColorType::IndexedColor: {
+        auto const pixels_per_byte = 8 / context.bit_depth;
+        auto const mask = (1 << context.bit_depth) - 1;
+        for (size_t i = 0; i < pixels.size(); ++i) {
+            size_t palette_index;
+            if (context.bit_depth == 8) {
+                palette_index = scanline[i];
+            } else if (context.bit_depth == 1 || context.bit_depth == 2 || context.bit_depth == 4) {
+                auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (i % pixels_per_byte));
+                palette_index = (scanline[i / pixels_per_byte] >> bit_offset) & mask;
+            } else {
+                VERIFY_NOT_REACHED();
             }
-        } else {
-            VERIFY_NOT_REACHED();
+
+            if (palette_index >= context.palette_data.size())
+                return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range");
+            auto& color = context.palette_data.at(palette_index);
+            auto transparency = context.palette_transparency_data.size() >= palette_index + 1u
+                ? context.palette_transparency_data[palette_index]
+                : 0xff;
+            pixels[i] = Color(color.r, color.g, color.b, transparency).value();
         }
         break;
+    }
     default:
         VERIFY_NOT_REACHED();
         break;
     }
 
-    // Swap r and b values:
-    for (int y = 0; y < context.height; ++y) {
-        auto* pixels = (Pixel*)context.bitmap->scanline(y);
-        for (int i = 0; i < context.bitmap->width(); ++i) {
-            auto& x = pixels[i];
-            swap(x.r, x.b);
+    return {};
+}
+
+// Reads the filtered scanlines of an image of `width` x `height` pixels from the decompressed image data, and calls
+// `on_scanline(y, scanline)` with each of them once it is unfiltered, while it's still in the cache. This only keeps
+// two scanlines in memory instead of all of them. Returns the number of scanlines that were read, which is only less
+// than `height` for truncated data.
+template<typename Callback>
+static ErrorOr<int> decode_scanlines(PNGLoadingContext& context, Stream& stream, int width, int height, Callback on_scanline)
+{
+    auto row_size = context.compute_row_size_for_width(width);
+    if (row_size.has_overflow())
+        return Error::from_string_literal("PNGImageDecoderPlugin: Row size overflow");
+
+    // From section 6.3 of http://www.libpng.org/pub/png/spec/1.2/PNG-Filters.html
+    // "bpp is defined as the number of bytes per complete pixel, rounding up to one.
+    // For example, for color type 2 with a bit depth of 16, bpp is equal to 6
+    // (three samples, two bytes per sample); for color type 0 with a bit depth of 2,
+    // bpp is equal to 1 (rounding up); for color type 4 with a bit depth of 16, bpp
+    // is equal to 4 (two-byte grayscale sample, plus two-byte alpha sample)."
+    u8 bytes_per_complete_pixel = ceil_div(context.bit_depth, (u8)8) * context.channels;
+
+    // The scanline above the first one is all zeroes.
+    auto scanline = TRY(ByteBuffer::create_zeroed(row_size.value()));
+    auto previous_scanline = TRY(ByteBuffer::create_zeroed(row_size.value()));
+
+    for (int y = 0; y < height; ++y) {
+        swap(scanline, previous_scanline);
+
+        auto filter_byte_or_error = stream.read_value<u8>();
+        if (filter_byte_or_error.is_error() || stream.read_until_filled(scanline).is_error()) {
+            if (context.allow_truncated_data)
+                return y;
+            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
         }
-    }
 
-    return {};
+        auto filter = TRY(PNG::filter_type(filter_byte_or_error.value()));
+        PNGImageDecoderPlugin::unfilter_scanline(filter, scanline, previous_scanline, bytes_per_complete_pixel);
+        TRY(on_scanline(y, scanline.bytes()));
+    }
+    return height;
 }
 
 static bool decode_png_header(PNGLoadingContext& context)
@@ -696,36 +683,26 @@ static bool decode_png_chunks(PNGLoadingContext& context)
     return true;
 }
 
-static ErrorOr<void> decode_png_bitmap_simple(PNGLoadingContext& context, ByteBuffer& decompression_buffer)
+static ErrorOr<void> decode_png_bitmap_simple(PNGLoadingContext& context, Stream& stream)
 {
-    Streamer streamer(decompression_buffer.data(), decompression_buffer.size());
-
-    for (int y = 0; y < context.height; ++y) {
-        u8 filter_byte;
-        if (!streamer.read(filter_byte)) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
-        }
-
-        if (filter_byte > 4) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Invalid PNG filter");
-        }
-
-        context.scanlines.append({ MUST(PNG::filter_type(filter_byte)) });
-        auto& scanline_buffer = context.scanlines.last().data;
-        auto row_size = context.compute_row_size_for_width(context.width);
-        if (row_size.has_overflow())
-            return Error::from_string_literal("PNGImageDecoderPlugin: Row size overflow");
+    context.bitmap = TRY(Bitmap::create(context.has_alpha() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, { context.width, context.height }));
 
-        if (!streamer.wrap_bytes(scanline_buffer, row_size.value())) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
-        }
+    auto decoded_row_count_or_error = decode_scanlines(context, stream, context.width, context.height, [&](int y, ReadonlyBytes scanline) {
+        return unpack_scanline(context, scanline, { context.bitmap->scanline(y), static_cast<size_t>(context.width) });
+    });
+    if (decoded_row_count_or_error.is_error()) {
+        context.state = PNGLoadingContext::State::Error;
+        return decoded_row_count_or_error.release_error();
     }
+    context.decoded_row_count = decoded_row_count_or_error.value();
 
-    context.bitmap = TRY(Bitmap::create(context.has_alpha() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, { context.width, context.height }));
-    return unfilter(context);
+    // Rows missing from truncated data are left blank.
+    if (context.decoded_row_count < context.height) {
+        auto blank_scanline = TRY(ByteBuffer::create_zeroed(context.compute_row_size_for_width(context.width).value()));
+        for (int y = context.decoded_row_count; y < context.height; ++y)
+            TRY(unpack_scanline(context, blank_scanline, { context.bitmap->scanline(y), static_cast<size_t>(context.width) }));
+    }
+    return {};
 }
 
 static int adam7_height(PNGLoadingContext& context, int pass)
@@ -778,7 +755,7 @@ static int adam7_startx[8] = { 0, 0, 4, 0, 2, 0, 1, 0 };
 static int adam7_stepy[8] = { 1, 8, 8, 8, 4, 4, 2, 2 };
 static int adam7_stepx[8] = { 1, 8, 8, 4, 4, 2, 2, 1 };
 
-static ErrorOr<void> decode_adam7_pass(PNGLoadingContext& context, Streamer& streamer, int pass)
+static ErrorOr<void> decode_adam7_pass(PNGLoadingContext& context, Stream& stream, int pass)
 {
     auto subimage_context = context.create_subimage_context(adam7_width(context, pass), adam7_height(context, pass));
 
@@ -786,51 +763,51 @@ static ErrorOr<void> decode_adam7_pass(PNGLoadingContext& context, Streamer& str
     if (!subimage_context.width || !subimage_context.height)
         return {};
 
-    for (int y = 0; y < subimage_context.height; ++y) {
-        u8 filter_byte;
-        if (!streamer.read(filter_byte)) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
-        }
-
-        if (filter_byte > 4) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Invalid PNG filter");
-        }
-
-        subimage_context.scanlines.append({ MUST(PNG::filter_type(filter_byte)) });
-        auto& scanline_buffer = subimage_context.scanlines.last().data;
-
-        auto row_size = context.compute_row_size_for_width(subimage_context.width);
-        if (row_size.has_overflow())
-            return Error::from_string_literal("PNGImageDecoderPlugin: Row size overflow");
-        if (!streamer.wrap_bytes(scanline_buffer, row_size.value())) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
-        }
-    }
-
-    subimage_context.bitmap = TRY(Bitmap::create(context.bitmap->format(), { subimage_context.width, subimage_context.height }));
-    TRY(unfilter(subimage_context));
-
-    // Copy the subimage data into the main image according to the pass pattern
-    for (int y = 0, dy = adam7_starty[pass]; y < subimage_context.height && dy < context.height; ++y, dy += adam7_stepy[pass]) {
-        for (int x = 0, dx = adam7_startx[pass]; x < subimage_context.width && dx < context.width; ++x, dx += adam7_stepx[pass]) {
-            context.bitmap->set_pixel(dx, dy, subimage_context.bitmap->get_pixel(x, y));
-        }
+    Vector<ARGB32> pixels;
+    TRY(pixels.try_resize(subimage_context.width));
+    auto decoded_row_count_or_error = decode_scanlines(subimage_context, stream, subimage_context.width, subimage_context.height, [&](int y, ReadonlyBytes scanline) -> ErrorOr<void> {
+        TRY(unpack_scanline(subimage_context, scanline, pixels));
+
+        // Copy the subimage pixels into the main image according to the pass pattern
+        int const dy = adam7_starty[pass] + y * adam7_stepy[pass];
+        if (dy >= context.height)
+            return {};
+        auto* destination = context.bitmap->scanline(dy);
+        for (int x = 0, dx = adam7_startx[pass]; x < subimage_context.width && dx < context.width; ++x, dx += adam7_stepx[pass])
+            destination[dx] = pixels[x];
+        return {};
+    });
+    if (decoded_row_count_or_error.is_error()) {
+        context.state = PNGLoadingContext::State::Error;
+        return decoded_row_count_or_error.release_error();
     }
     return {};
 }
 
-static ErrorOr<void> decode_png_adam7(PNGLoadingContext& context, ByteBuffer& decompression_buffer)
+static ErrorOr<void> decode_png_adam7(PNGLoadingContext& context, Stream& stream)
 {
-    Streamer streamer(decompression_buffer.data(), decompression_buffer.size());
     context.bitmap = TRY(Bitmap::create(context.has_alpha() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, { context.width, context.height }));
     for (int pass = 1; pass <= 7; ++pass)
-        TRY(decode_adam7_pass(context, streamer, pass));
+        TRY(decode_adam7_pass(context, stream, pass));
     return {};
 }
 
+static ErrorOr<void> decode_png_image_data(PNGLoadingContext& context, ReadonlyBytes compressed_data)
+{
+    // The scanlines are unfiltered as they come out of the decompressor, so the decompressed data is never all in memory.
+    auto compressed_data_stream = TRY(try_make<FixedMemoryStream>(compressed_data));
+    auto decompressor = TRY(Compress::ZlibDecompressor::create(move(compressed_data_stream)));
+
+    switch (context.interlace_method) {
+    case PngInterlaceMethod::Null:
+        return decode_png_bitmap_simple(context, *decompressor);
+    case PngInterlaceMethod::Adam7:
+        return decode_png_adam7(context, *decompressor);
+    default:
+        return Error::from_string_literal("PNGImageDecoderPlugin: Invalid interlace method");
+    }
+}
+
 static ErrorOr<void> decode_png_bitmap(PNGLoadingContext& context)
 {
     if (context.state < PNGLoadingContext::State::ChunksDecoded) {
@@ -844,39 +821,17 @@ static ErrorOr<void> decode_png_bitmap(PNGLoadingContext& context)
     if (context.color_type == PNG::ColorType::IndexedColor && context.palette_data.is_empty())
         return Error::from_string_literal("PNGImageDecoderPlugin: Didn't see a PLTE chunk for a palletized image, or it was empty.");
 
-    auto compressed_data_stream = make<FixedMemoryStream>(context.compressed_data.span());
-    auto decompressor_or_error = Compress::ZlibDecompressor::create(move(compressed_data_stream));
-    if (decompressor_or_error.is_error()) {
-        context.state = PNGLoadingContext::State::Error;
-        return decompressor_or_error.release_error();
-    }
-    auto decompressor = decompressor_or_error.release_value();
-    auto result_or_error = decompressor->read_until_eof();
-    if (result_or_error.is_error()) {
+    if (auto result = decode_png_image_data(context, context.compressed_data); result.is_error()) {
         context.state = PNGLoadingContext::State::Error;
-        return result_or_error.release_error();
+        return result.release_error();
     }
-    auto decompression_buffer = result_or_error.release_value();
     context.compressed_data.clear();
 
-    context.scanlines.ensure_capacity(context.height);
-    switch (context.interlace_method) {
-    case PngInterlaceMethod::Null:
-        TRY(decode_png_bitmap_simple(context, decompression_buffer));
-        break;
-    case PngInterlaceMethod::Adam7:
-        TRY(decode_png_adam7(context, decompression_buffer));
-        break;
-    default:
-        context.state = PNGLoadingContext::State::Error;
-        return Error::from_string_literal("PNGImageDecoderPlugin: Invalid interlace method");
-    }
-
     context.state = PNGLoadingContext::State::BitmapDecoded;
     return {};
 }
 
-static ErrorOr<RefPtr<Bitmap>> decode_png_animation_frame_bitmap(PNGLoadingContext& context, AnimationFrame& animation_frame)
+static ErrorOr<NonnullRefPtr<Bitmap>> decode_png_animation_frame_bitmap(PNGLoadingContext const& context, AnimationFrame const& animation_frame)
 {
     if (context.color_type == PNG::ColorType::IndexedColor && context.palette_data.is_empty())
         return Error::from_string_literal("PNGImageDecoderPlugin: Didn't see a PLTE chunk for a palletized image, or it was empty.");
@@ -885,26 +840,35 @@ static ErrorOr<RefPtr<Bitmap>> decode_png_animation_frame_bitmap(PNGLoadingConte
 
     auto frame_rect = animation_frame.rect();
     auto frame_context = context.create_subimage_context(frame_rect.width(), frame_rect.height());
+    frame_context.interlace_method = context.interlace_method;
+    TRY(decode_png_image_data(frame_context, animation_frame.compressed_data));
+    return frame_context.bitmap.release_nonnull();
+}
 
-    auto compressed_data_stream = make<FixedMemoryStream>(animation_frame.compressed_data.span());
-    auto decompressor = TRY(Compress::ZlibDecompressor::create(move(compressed_data_stream)));
-    auto decompression_buffer = TRY(decompressor->read_until_eof());
-    frame_context.compressed_data.clear();
-
-    frame_context.scanlines.ensure_capacity(frame_context.height);
-    switch (context.interlace_method) {
-    case PngInterlaceMethod::Null:
-        TRY(decode_png_bitmap_simple(frame_context, decompression_buffer));
-        break;
-    case PngInterlaceMethod::Adam7:
-        TRY(decode_png_adam7(frame_context, decompression_buffer));
-        break;
-    default:
-        return Error::from_string_literal("PNGImageDecoderPlugin: Invalid interlace method");
-    }
+static Threading::TaskPool& task_pool()
+{
+    static Threading::TaskPool pool;
+    return pool;
+}
 
-    context.state = PNGLoadingContext::State::BitmapDecoded;
-    return move(frame_context.bitmap);
+// Decoding an animation frame doesn't depend on the other frames, only rendering it on top of the previous one does.
+// So the frames that are going to be rendered next are decoded in parallel, and then rendered one after the other.
+static void decode_png_animation_frame_bitmaps_in_parallel(PNGLoadingContext& context, size_t first_index, size_t end_index)
+{
+    if (end_index <= first_index + 1)
+        return;
+
+    Threading::parallel_for(
+        task_pool(), end_index - first_index, [&](size_t i) {
+            auto& animation_frame = context.animation_frames[first_index + i];
+            if (animation_frame.bitmap || animation_frame.decoded_bitmap)
+                return;
+
+            // Errors are reported once the frame is decoded again for rendering it.
+            if (auto bitmap_or_error = decode_png_animation_frame_bitmap(context, animation_frame); !bitmap_or_error.is_error())
+                animation_frame.decoded_bitmap = bitmap_or_error.release_value();
+        },
+        1);
 }
 
 static bool is_valid_compression_method(u8 compression_method)
@@ -1201,13 +1165,23 @@ static ErrorOr<void> process_chunk(Streamer& streamer, PNGLoadingContext& contex
         dbgln_if(PNG_DEBUG, "Bail at chunk_type");
         return Error::from_string_literal("Error while reading from Streamer");
     }
+
+    // The image data is what takes the longest to download, so truncated data usually ends in an IDAT chunk.
+    bool const can_be_truncated = context.allow_truncated_data && chunk_type == "IDAT"sv;
+
     ReadonlyBytes chunk_data;
     if (!streamer.wrap_bytes(chunk_data, chunk_size)) {
+        if (can_be_truncated) {
+            (void)streamer.wrap_bytes(chunk_data, streamer.size_remaining());
+            return process_IDAT(chunk_data, context);
+        }
         dbgln_if(PNG_DEBUG, "Bail at chunk_data");
         return Error::from_string_literal("Error while reading from Streamer");
     }
     u32 chunk_crc;
     if (!streamer.read(chunk_crc)) {
+        if (can_be_truncated)
+            return process_IDAT(chunk_data, context);
         dbgln_if(PNG_DEBUG, "Bail at chunk_crc");
         return Error::from_string_literal("Error while reading from Streamer");
     }
@@ -1380,6 +1354,34 @@ static ErrorOr<RefPtr<Bitmap>> render_animation_frame(AnimationFrame const& prev
     return rendered_bitmap;
 }
 
+void PNGImageDecoderPlugin::decode_animation_frames_ahead(size_t first_index, size_t requested_index)
+{
+    // Frames are usually requested one after the other, so look at the chunks of the next few ones as well. A broken
+    // chunk only makes the frame it belongs to fail, once that frame is requested.
+    size_t const end_index = max(requested_index + 1, first_index + task_pool().concurrency() + 1);
+    auto const state = m_context->state;
+    if (!decode_png_animation_data_chunks(*m_context, end_index - 1))
+        m_context->state = state;
+
+    // The frame whose chunks are still being read when the data ends is not complete yet.
+    size_t const complete_frame_count = m_context->last_completed_animation_frame_index.has_value() ? *m_context->last_completed_animation_frame_index + 1 : 0;
+    decode_png_animation_frame_bitmaps_in_parallel(*m_context, first_index, min(end_index, min(complete_frame_count, m_context->animation_frames.size())));
+}
+
+bool PNGImageDecoderPlugin::supports_partial_decoding() const
+{
+    // FIXME: Interlaced images could show their complete passes as well.
+    return m_context->interlace_method == PngInterlaceMethod::Null;
+}
+
+ErrorOr<PartialImageFrameDescriptor> PNGImageDecoderPlugin::partial_frame()
+{
+    VERIFY(supports_partial_decoding());
+    m_context->allow_truncated_data = true;
+    auto frame = TRY(this->frame(0));
+    return PartialImageFrameDescriptor { frame.image, m_context->decoded_row_count };
+}
+
 ErrorOr<ImageFrameDescriptor> PNGImageDecoderPlugin::frame(size_t index, Optional<IntSize>)
 {
     if (m_context->state == PNGLoadingContext::State::Error)
@@ -1431,12 +1433,17 @@ ErrorOr<ImageFrameDescriptor> PNGImageDecoderPlugin::frame(size_t index, Optiona
             auto& animation_frame = m_context->animation_frames[i];
             animation_frame.bitmap = m_context->bitmap;
         } else {
+            if (!m_context->animation_frames[i].decoded_bitmap)
+                decode_animation_frames_ahead(i, index);
+
             auto& animation_frame = m_context->animation_frames[i];
             VERIFY(!animation_frame.bitmap);
 
-            auto decoded_bitmap = TRY(decode_png_animation_frame_bitmap(*m_context, animation_frame));
+            RefPtr<Bitmap> decoded_bitmap = move(animation_frame.decoded_bitmap);
+            if (!decoded_bitmap)
+                decoded_bitmap = TRY(decode_png_animation_frame_bitmap(*m_context, animation_frame));
 
-            auto prev_animation_frame = m_context->animation_frames[i - 1];
+            auto const& prev_animation_frame = m_context->animation_frames[i - 1];
             animation_frame.bitmap = TRY(render_animation_frame(prev_animation_frame, animation_frame, *decoded_bitmap));
         }
         m_context->animation_next_frame_to_render = i + 1;
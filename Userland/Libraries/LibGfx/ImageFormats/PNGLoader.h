@@ -30,12 +30,16 @@ public:
     virtual Optional<Metadata const&> metadata() override;
     virtual ErrorOr<Optional<ReadonlyBytes>> icc_data() override;
 
+    virtual bool supports_partial_decoding() const override;
+    virtual ErrorOr<PartialImageFrameDescriptor> partial_frame() override;
+
     static void unfilter_scanline(PNG::FilterType filter, Bytes scanline_data, ReadonlyBytes previous_scanlines_data, u8 bytes_per_complete_pixel);
 
 private:
     PNGImageDecoderPlugin(u8 const*, size_t);
     bool ensure_image_data_chunk_was_decoded();
     bool ensure_animation_frame_was_decoded(u32);
+    void decode_animation_frames_ahead(size_t first_index, size_t requested_index);
 
     OwnPtr<PNGLoadingContext> m_context;
 };
@@ -54,14 +54,28 @@ ALWAYS_INLINE u8 paeth_predictor(u8 a, u8 b, u8 c)
     return c;
 }
 
+// The same for all bytes of a pixel at once, with the branches replaced by masks.
 ALWAYS_INLINE AK::SIMD::u8x4 paeth_predictor(AK::SIMD::u8x4 a, AK::SIMD::u8x4 b, AK::SIMD::u8x4 c)
 {
-    return AK::SIMD::u8x4 {
-        paeth_predictor(a[0], b[0], c[0]),
-        paeth_predictor(a[1], b[1], c[1]),
-        paeth_predictor(a[2], b[2], c[2]),
-        paeth_predictor(a[3], b[3], c[3]),
+    using AK::SIMD::i16x4;
+    auto const abs = [](i16x4 value) {
+        auto const sign = value >> 15;
+        return (value ^ sign) - sign;
     };
+
+    auto const a16 = __builtin_convertvector(a, i16x4);
+    auto const b16 = __builtin_convertvector(b, i16x4);
+    auto const c16 = __builtin_convertvector(c, i16x4);
+
+    // pa = |p - a| = |b - c|, pb = |p - b| = |a - c|, pc = |p - c| = |a + b - 2c|
+    auto const pa = abs(b16 - c16);
+    auto const pb = abs(a16 - c16);
+    auto const pc = abs(a16 + b16 - c16 - c16);
+
+    i16x4 const use_a = (pa <= pb) & (pa <= pc);
+    i16x4 const use_b = ~use_a & (pb <= pc);
+    auto const predictor = (use_a & a16) | (use_b & b16) | (~(use_a | use_b) & c16);
+    return __builtin_convertvector(predictor, AK::SIMD::u8x4);
 }
 
 };
@@ -9,6 +9,7 @@
 #include <AK/Endian.h>
 #include <AK/Format.h>
 #include <AK/MemoryStream.h>
+#include <AK/SIMD.h>
 #include <AK/Vector.h>
 #include <LibCompress/Deflate.h>
 #include <LibGfx/ImageFormats/WebPLoaderLossless.h>
@@ -293,16 +294,20 @@ static ErrorOr<NonnullRefPtr<Bitmap>> decode_webp_chunk_VP8L_image(ImageKind ima
     ARGB32* end = bitmap->end();
     ARGB32* pixel = begin;
 
-    auto prefix_group = [prefix_bits, begin, &groups, size, &entropy_image](ARGB32* pixel) -> PrefixCodeGroup const& {
-        if (!prefix_bits)
-            return groups[0];
-
+    // The prefix code group only changes between blocks of the entropy image, so it's only looked up again once `pixel`
+    // reaches the end of the current block's part of the scanline.
+    PrefixCodeGroup const* current_group = &groups[0];
+    ARGB32* group_end = prefix_bits ? begin : end;
+    auto update_prefix_group = [prefix_bits, begin, &groups, size, &entropy_image, &current_group, &group_end](ARGB32* pixel) {
         size_t offset = pixel - begin;
         int x = offset % size.width();
         int y = offset / size.width();
 
         int meta_prefix_code = (entropy_image->scanline(y >> prefix_bits)[x >> prefix_bits] >> 8) & 0xffff;
-        return groups[meta_prefix_code];
+        current_group = &groups[meta_prefix_code];
+
+        int block_end = min(((x >> prefix_bits) + 1) << prefix_bits, size.width());
+        group_end = pixel + (block_end - x);
     };
 
     auto emit_pixel = [&pixel, &color_cache, color_cache_size, color_cache_code_bits](ARGB32 color) {
@@ -315,7 +320,9 @@ static ErrorOr<NonnullRefPtr<Bitmap>> decode_webp_chunk_VP8L_image(ImageKind ima
 
     while (pixel < end) {
         // "For the current position (x, y) in the image, the decoder first identifies the corresponding prefix code group"
-        auto const& group = prefix_group(pixel);
+        if (pixel >= group_end)
+            update_prefix_group(pixel);
+        auto const& group = *current_group;
 
         // "Next, read the symbol S from the bitstream using prefix code #1.
         //  Note that S is any integer in the range 0 to (256 + 24 + color_cache_size - 1)."
@@ -408,23 +415,54 @@ static ErrorOr<NonnullRefPtr<Bitmap>> decode_webp_chunk_VP8L_image(ImageKind ima
 
 namespace {
 
-static ARGB32 add_argb32(ARGB32 a, ARGB32 b)
+using AK::SIMD::i16x4;
+
+// Adds each of the four channels separately, without letting the carry of one channel spill into the next.
+ALWAYS_INLINE static ARGB32 add_argb32(ARGB32 a, ARGB32 b)
+{
+    u32 alpha_and_green = (a & 0xff00ff00) + (b & 0xff00ff00);
+    u32 red_and_blue = (a & 0x00ff00ff) + (b & 0x00ff00ff);
+    return (alpha_and_green & 0xff00ff00) | (red_and_blue & 0x00ff00ff);
+}
+
+ALWAYS_INLINE static i16x4 unpack_channels(ARGB32 pixel)
+{
+    AK::SIMD::u8x4 channels;
+    __builtin_memcpy(&channels, &pixel, sizeof(channels));
+    return __builtin_convertvector(channels, i16x4);
+}
+
+ALWAYS_INLINE static ARGB32 pack_channels(i16x4 channels)
+{
+    auto const bytes = __builtin_convertvector(channels, AK::SIMD::u8x4);
+    ARGB32 pixel;
+    __builtin_memcpy(&pixel, &bytes, sizeof(pixel));
+    return pixel;
+}
+
+// Moves each channel into its own 16-bit lane of a u64, leaving room for carries and borrows.
+ALWAYS_INLINE static u64 spread_channels(ARGB32 pixel)
+{
+    u64 channels = pixel;
+    channels = (channels | (channels << 16)) & 0x0000ffff0000ffffull;
+    return (channels | (channels << 8)) & 0x00ff00ff00ff00ffull;
+}
+
+ALWAYS_INLINE static ARGB32 gather_channels(u64 channels)
 {
-    auto a_color = Color::from_argb(a);
-    auto b_color = Color::from_argb(b);
-    return Color(a_color.red() + b_color.red(),
-        a_color.green() + b_color.green(),
-        a_color.blue() + b_color.blue(),
-        a_color.alpha() + b_color.alpha())
-        .value();
+    channels = (channels | (channels >> 8)) & 0x0000ffff0000ffffull;
+    return static_cast<ARGB32>(channels | (channels >> 16));
 }
 
 class Transform {
 public:
     virtual ~Transform();
 
-    // Could modify the input bitmap and return it, or could return a new bitmap.
-    virtual ErrorOr<NonnullRefPtr<Bitmap>> transform(NonnullRefPtr<Bitmap>) = 0;
+    // Applies the inverse transform to one scanline, in place. Scanlines are passed from top to bottom, and all
+    // transforms are applied to a scanline before the next one is decoded, so that it only has to be loaded once.
+    // `scanline` is as wide as the final image, but transforms only look at as many pixels as the image they were read
+    // for is wide. Only the color indexing transform produces more pixels than it consumes.
+    virtual ErrorOr<void> transform(int y, Span<ARGB32> scanline) = 0;
 };
 
 Transform::~Transform() = default;
@@ -433,39 +471,42 @@ Transform::~Transform() = default;
 class PredictorTransform : public Transform {
 public:
     static ErrorOr<NonnullOwnPtr<PredictorTransform>> read(LittleEndianInputBitStream&, IntSize const& image_size);
-    virtual ErrorOr<NonnullRefPtr<Bitmap>> transform(NonnullRefPtr<Bitmap>) override;
+    virtual ErrorOr<void> transform(int y, Span<ARGB32> scanline) override;
 
 private:
-    PredictorTransform(int size_bits, NonnullRefPtr<Bitmap> predictor_bitmap)
-        : m_size_bits(size_bits)
+    PredictorTransform(int width, int size_bits, NonnullRefPtr<Bitmap> predictor_bitmap, Vector<ARGB32> previous_scanline)
+        : m_width(width)
+        , m_size_bits(size_bits)
         , m_predictor_bitmap(move(predictor_bitmap))
+        , m_previous_scanline(move(previous_scanline))
     {
     }
 
-    // These capitalized functions are all from the spec:
-    static u8 Average2(u8 a, u8 b)
+    // These capitalized functions are all from the spec, but work on all four channels at once:
+    static u32 Average2(u32 a, u32 b)
     {
-        return (a + b) / 2;
+        // (a + b) / 2 for each channel, without overflowing into the next one.
+        return (a & b) + (((a ^ b) & 0xfefefefe) >> 1);
     }
 
     static u32 Select(u32 L, u32 T, u32 TL)
     {
         // "L = left pixel, T = top pixel, TL = top left pixel."
-
-#define ALPHA(x) ((x >> 24) & 0xff)
-#define RED(x) ((x >> 16) & 0xff)
-#define GREEN(x) ((x >> 8) & 0xff)
-#define BLUE(x) (x & 0xff)
+        auto left = unpack_channels(L);
+        auto top = unpack_channels(T);
+        auto top_left = unpack_channels(TL);
 
         // "ARGB component estimates for prediction."
-        int pAlpha = ALPHA(L) + ALPHA(T) - ALPHA(TL);
-        int pRed = RED(L) + RED(T) - RED(TL);
-        int pGreen = GREEN(L) + GREEN(T) - GREEN(TL);
-        int pBlue = BLUE(L) + BLUE(T) - BLUE(TL);
+        auto estimate = left + top - top_left;
 
         // "Manhattan distances to estimates for left and top pixels."
-        int pL = abs(pAlpha - (int)ALPHA(L)) + abs(pRed - (int)RED(L)) + abs(pGreen - (int)GREEN(L)) + abs(pBlue - (int)BLUE(L));
-        int pT = abs(pAlpha - (int)ALPHA(T)) + abs(pRed - (int)RED(T)) + abs(pGreen - (int)GREEN(T)) + abs(pBlue - (int)BLUE(T));
+        auto const manhattan_distance = [](i16x4 a, i16x4 b) {
+            auto difference = a - b;
+            difference = difference < 0 ? -difference : difference;
+            return difference[0] + difference[1] + difference[2] + difference[3];
+        };
+        int pL = manhattan_distance(estimate, left);
+        int pT = manhattan_distance(estimate, top);
 
         // "Return either left or top, the one closer to the prediction."
         if (pL < pT) {
@@ -473,47 +514,32 @@ private:
         } else {
             return T;
         }
-
-#undef BLUE
-#undef GREEN
-#undef RED
-#undef ALPHA
     }
 
     // "Clamp the input value between 0 and 255."
-    static int Clamp(int a)
-    {
-        return clamp(a, 0, 255);
-    }
-
-    static int ClampAddSubtractFull(int a, int b, int c)
-    {
-        return Clamp(a + b - c);
-    }
-
-    static int ClampAddSubtractHalf(int a, int b)
-    {
-        return Clamp(a + (a - b) / 2);
-    }
-
-    // ...and we're back from the spec!
-    static Color average2(Color a, Color b)
+    static u32 Clamp(i16x4 a)
     {
-        return Color(Average2(a.red(), b.red()),
-            Average2(a.green(), b.green()),
-            Average2(a.blue(), b.blue()),
-            Average2(a.alpha(), b.alpha()));
+        a = a < 0 ? 0 : a;
+        a = a > 255 ? 255 : a;
+        return pack_channels(a);
     }
 
-    static ARGB32 average2(ARGB32 a, ARGB32 b)
+    static u32 ClampAddSubtractHalf(u32 a, u32 b)
     {
-        return average2(Color::from_argb(a), Color::from_argb(b)).value();
+        auto a_channels = unpack_channels(a);
+        return Clamp(a_channels + (a_channels - unpack_channels(b)) / 2);
     }
 
-    static ErrorOr<ARGB32> predict(u8 predictor, ARGB32 TL, ARGB32 T, ARGB32 TR, ARGB32 L);
+    ErrorOr<void> add_predictions(u8 predictor, ARGB32* scanline, int begin, int end) const;
+    void add_clamp_add_subtract_full(ARGB32* scanline, int begin, int end) const;
 
+    int m_width;
     int m_size_bits;
     NonnullRefPtr<Bitmap> m_predictor_bitmap;
+
+    // The previous scanline as this transform produced it, before the transforms after it changed it. It has one extra
+    // pixel at the end, so that the TR-pixel of the rightmost column doesn't need special casing.
+    Vector<ARGB32> m_previous_scanline;
 };
 
 ErrorOr<NonnullOwnPtr<PredictorTransform>> PredictorTransform::read(LittleEndianInputBitStream& bit_stream, IntSize const& image_size)
@@ -528,141 +554,158 @@ ErrorOr<NonnullOwnPtr<PredictorTransform>> PredictorTransform::read(LittleEndian
 
     auto predictor_bitmap = TRY(decode_webp_chunk_VP8L_image(ImageKind::EntropyCoded, BitmapFormat::BGRx8888, predictor_image_size, bit_stream));
 
-    return adopt_nonnull_own_or_enomem(new (nothrow) PredictorTransform(size_bits, move(predictor_bitmap)));
+    Vector<ARGB32> previous_scanline;
+    TRY(previous_scanline.try_resize(image_size.width() + 1));
+
+    return adopt_nonnull_own_or_enomem(new (nothrow) PredictorTransform(image_size.width(), size_bits, move(predictor_bitmap), move(previous_scanline)));
 }
 
-ErrorOr<NonnullRefPtr<Bitmap>> PredictorTransform::transform(NonnullRefPtr<Bitmap> bitmap_ref)
+ErrorOr<void> PredictorTransform::transform(int y, Span<ARGB32> scanline_span)
 {
-    Bitmap& bitmap = *bitmap_ref;
+    ARGB32* scanline = scanline_span.data();
 
     // "There are special handling rules for some border pixels.
     //  If there is a prediction transform, regardless of the mode [0..13] for these pixels,
     //  the predicted value for the left-topmost pixel of the image is 0xff000000,
-    bitmap.scanline(0)[0] = add_argb32(bitmap.scanline(0)[0], 0xff000000);
-
     //  L-pixel for all pixels on the top row,
-    for (int x = 1; x < bitmap.width(); ++x)
-        bitmap.scanline(0)[x] = add_argb32(bitmap.scanline(0)[x], bitmap.scanline(0)[x - 1]);
-
     //  and T-pixel for all pixels on the leftmost column."
-    for (int y = 1; y < bitmap.height(); ++y)
-        bitmap.scanline(y)[0] = add_argb32(bitmap.scanline(y)[0], bitmap.scanline(y - 1)[0]);
-
-    ARGB32* bitmap_previous_scanline = bitmap.scanline(0);
-    for (int y = 1; y < bitmap.height(); ++y) {
-        ARGB32* bitmap_scanline = bitmap.scanline(y);
-
-        ARGB32 TL = bitmap_previous_scanline[0];
-        ARGB32 T = bitmap_previous_scanline[1];
-        ARGB32 TR = 2 < bitmap.width() ? bitmap_previous_scanline[2] : bitmap_previous_scanline[0];
-
-        ARGB32 L = bitmap_scanline[0];
-
-        int predictor_y = y >> m_size_bits;
-        ARGB32* predictor_scanline = m_predictor_bitmap->scanline(predictor_y);
+    if (y == 0) {
+        scanline[0] = add_argb32(scanline[0], 0xff000000);
+        for (int x = 1; x < m_width; ++x)
+            scanline[x] = add_argb32(scanline[x], scanline[x - 1]);
+    } else {
+        scanline[0] = add_argb32(scanline[0], m_previous_scanline[0]);
+
+        // https://developers.google.com/speed/webp/docs/webp_lossless_bitstream_specification#51_roles_of_image_data
+        // "The green component of a pixel defines which of the 14 predictors is used within a particular block of the ARGB image."
+        // Each block uses a single predictor, so look it up once per block instead of once per pixel.
+        ARGB32 const* predictor_scanline = m_predictor_bitmap->scanline(y >> m_size_bits);
+        for (int begin = 1; begin < m_width;) {
+            int end = min(((begin >> m_size_bits) + 1) << m_size_bits, m_width);
+            u8 predictor = Color::from_argb(predictor_scanline[begin >> m_size_bits]).green();
+            TRY(add_predictions(predictor, scanline, begin, end));
+            begin = end;
+        }
+    }
 
-        for (int x = 1; x < bitmap.width(); ++x) {
-            int predictor_x = x >> m_size_bits;
+    // "Addressing the TR-pixel for pixels on the rightmost column is exceptional.
+    //  The pixels on the rightmost column are predicted by using the modes [0..13] just like pixels not on the border,
+    //  but the leftmost pixel on the same row as the current pixel is instead used as the TR-pixel."
+    __builtin_memcpy(m_previous_scanline.data(), scanline, m_width * sizeof(ARGB32));
+    m_previous_scanline[m_width] = scanline[0];
+    return {};
+}
 
-            // https://developers.google.com/speed/webp/docs/webp_lossless_bitstream_specification#51_roles_of_image_data
-            // "The green component of a pixel defines which of the 14 predictors is used within a particular block of the ARGB image."
-            u8 predictor = Color::from_argb(predictor_scanline[predictor_x]).green();
+ErrorOr<void> PredictorTransform::add_predictions(u8 predictor, ARGB32* scanline, int begin, int end) const
+{
+    ARGB32 const* top = m_previous_scanline.data();
 
-            ARGB32 predicted = TRY(predict(predictor, TL, T, TR, L));
+    // `add` is instantiated separately for each predictor, so that every mode gets its own loop.
+    auto const add = [&](auto predict) {
+        for (int x = begin; x < end; ++x) {
+            ARGB32 predicted = predict(top[x - 1], top[x], top[x + 1], scanline[x - 1]);
 
             // "The final pixel value is obtained by adding each channel of the predicted value to the encoded residual value."
-            bitmap_scanline[x] = add_argb32(bitmap_scanline[x], predicted);
-
-            TL = T;
-            T = TR;
-
-            // "Addressing the TR-pixel for pixels on the rightmost column is exceptional.
-            //  The pixels on the rightmost column are predicted by using the modes [0..13] just like pixels not on the border,
-            //  but the leftmost pixel on the same row as the current pixel is instead used as the TR-pixel."
-            TR = x + 2 < bitmap.width() ? bitmap_previous_scanline[x + 2] : bitmap_previous_scanline[0];
-
-            L = bitmap_scanline[x];
+            scanline[x] = add_argb32(scanline[x], predicted);
         }
+    };
 
-        bitmap_previous_scanline = bitmap_scanline;
-    }
-    return bitmap_ref;
-}
-
-ErrorOr<ARGB32> PredictorTransform::predict(u8 predictor, ARGB32 TL, ARGB32 T, ARGB32 TR, ARGB32 L)
-{
     switch (predictor) {
     case 0:
         // "0xff000000 (represents solid black color in ARGB)"
-        return 0xff000000;
+        add([](u32, u32, u32, u32) { return 0xff000000u; });
+        return {};
     case 1:
         // "L"
-        return L;
+        add([](u32, u32, u32, u32 L) { return L; });
+        return {};
     case 2:
         // "T"
-        return T;
+        add([](u32, u32 T, u32, u32) { return T; });
+        return {};
     case 3:
         // "TR"
-        return TR;
+        add([](u32, u32, u32 TR, u32) { return TR; });
+        return {};
     case 4:
         // "TL"
-        return TL;
+        add([](u32 TL, u32, u32, u32) { return TL; });
+        return {};
     case 5:
         // "Average2(Average2(L, TR), T)"
-        return average2(average2(L, TR), T);
+        add([](u32, u32 T, u32 TR, u32 L) { return Average2(Average2(L, TR), T); });
+        return {};
     case 6:
         // "Average2(L, TL)"
-        return average2(L, TL);
+        add([](u32 TL, u32, u32, u32 L) { return Average2(L, TL); });
+        return {};
     case 7:
         // "Average2(L, T)"
-        return average2(L, T);
+        add([](u32, u32 T, u32, u32 L) { return Average2(L, T); });
+        return {};
     case 8:
         // "Average2(TL, T)"
-        return average2(TL, T);
+        add([](u32 TL, u32 T, u32, u32) { return Average2(TL, T); });
+        return {};
     case 9:
         // "Average2(T, TR)"
-        return average2(T, TR);
+        add([](u32, u32 T, u32 TR, u32) { return Average2(T, TR); });
+        return {};
     case 10:
         // "Average2(Average2(L, TL), Average2(T, TR))"
-        return average2(average2(L, TL), average2(T, TR));
+        add([](u32 TL, u32 T, u32 TR, u32 L) { return Average2(Average2(L, TL), Average2(T, TR)); });
+        return {};
     case 11:
         // "Select(L, T, TL)"
-        return Select(L, T, TL);
-    case 12: {
+        add([](u32 TL, u32 T, u32, u32 L) { return Select(L, T, TL); });
+        return {};
+    case 12:
         // "ClampAddSubtractFull(L, T, TL)"
-        auto color_L = Color::from_argb(L);
-        auto color_T = Color::from_argb(T);
-        auto color_TL = Color::from_argb(TL);
-        return Color(ClampAddSubtractFull(color_L.red(), color_T.red(), color_TL.red()),
-            ClampAddSubtractFull(color_L.green(), color_T.green(), color_TL.green()),
-            ClampAddSubtractFull(color_L.blue(), color_T.blue(), color_TL.blue()),
-            ClampAddSubtractFull(color_L.alpha(), color_T.alpha(), color_TL.alpha()))
-            .value();
-    }
-    case 13: {
+        add_clamp_add_subtract_full(scanline, begin, end);
+        return {};
+    case 13:
         // "ClampAddSubtractHalf(Average2(L, T), TL)"
-        auto color_L = Color::from_argb(L);
-        auto color_T = Color::from_argb(T);
-        auto color_TL = Color::from_argb(TL);
-        return Color(ClampAddSubtractHalf(Average2(color_L.red(), color_T.red()), color_TL.red()),
-            ClampAddSubtractHalf(Average2(color_L.green(), color_T.green()), color_TL.green()),
-            ClampAddSubtractHalf(Average2(color_L.blue(), color_T.blue()), color_TL.blue()),
-            ClampAddSubtractHalf(Average2(color_L.alpha(), color_T.alpha()), color_TL.alpha()))
-            .value();
-    }
+        add([](u32 TL, u32 T, u32, u32 L) { return ClampAddSubtractHalf(Average2(L, T), TL); });
+        return {};
     }
     return Error::from_string_literal("WebPImageDecoderPlugin: invalid predictor");
 }
 
+// This is the most common predictor in photos. Each pixel depends on the one to its left, so the loop is bound by
+// latency. To keep the chain short, the left pixel stays in spread-out form between iterations, and everything that
+// only depends on the previous scanline is computed off the chain.
+void PredictorTransform::add_clamp_add_subtract_full(ARGB32* scanline, int begin, int end) const
+{
+    constexpr u64 lane_ones = 0x0001000100010001ull;
+    constexpr u64 lane_bytes = 0x00ff00ff00ff00ffull;
+    ARGB32 const* top = m_previous_scanline.data();
+
+    u64 left = spread_channels(scanline[begin - 1]);
+    for (int x = begin; x < end; ++x) {
+        // L + T - TL + 256 is in [1, 766] for every channel, so no lane borrows from its neighbor.
+        u64 biased = left + ((spread_channels(top[x]) + (lane_ones << 8)) - spread_channels(top[x - 1]));
+
+        // Values in [256, 511] are in range after removing the bias, values in [512, 766] clamp to 255, and values
+        // below 256 clamp to 0.
+        u64 overflowed = (biased >> 9) & lane_ones;
+        u64 in_range = (biased >> 8) & ~(biased >> 9) & lane_ones;
+        u64 predicted = (biased & ((in_range << 8) - in_range)) | ((overflowed << 8) - overflowed);
+
+        left = (predicted + spread_channels(scanline[x])) & lane_bytes;
+        scanline[x] = gather_channels(left);
+    }
+}
+
 // https://developers.google.com/speed/webp/docs/webp_lossless_bitstream_specification#42_color_transform
 class ColorTransform : public Transform {
 public:
     static ErrorOr<NonnullOwnPtr<ColorTransform>> read(LittleEndianInputBitStream&, IntSize const& image_size);
-    virtual ErrorOr<NonnullRefPtr<Bitmap>> transform(NonnullRefPtr<Bitmap>) override;
+    virtual ErrorOr<void> transform(int y, Span<ARGB32> scanline) override;
 
 private:
-    ColorTransform(int size_bits, NonnullRefPtr<Bitmap> color_bitmap)
-        : m_size_bits(size_bits)
+    ColorTransform(int width, int size_bits, NonnullRefPtr<Bitmap> color_bitmap)
+        : m_width(width)
+        , m_size_bits(size_bits)
         , m_color_bitmap(move(color_bitmap))
     {
     }
@@ -672,8 +715,7 @@ private:
         return (transform * color) >> 5;
     }
 
-    static ARGB32 inverse_transform(ARGB32 pixel, ARGB32 transform);
-
+    int m_width;
     int m_size_bits;
     NonnullRefPtr<Bitmap> m_color_bitmap;
 };
@@ -690,75 +732,72 @@ ErrorOr<NonnullOwnPtr<ColorTransform>> ColorTransform::read(LittleEndianInputBit
 
     auto color_bitmap = TRY(decode_webp_chunk_VP8L_image(ImageKind::EntropyCoded, BitmapFormat::BGRx8888, color_image_size, bit_stream));
 
-    return adopt_nonnull_own_or_enomem(new (nothrow) ColorTransform(size_bits, move(color_bitmap)));
+    return adopt_nonnull_own_or_enomem(new (nothrow) ColorTransform(image_size.width(), size_bits, move(color_bitmap)));
 }
 
-ErrorOr<NonnullRefPtr<Bitmap>> ColorTransform::transform(NonnullRefPtr<Bitmap> bitmap_ref)
+ErrorOr<void> ColorTransform::transform(int y, Span<ARGB32> scanline)
 {
-    Bitmap& bitmap = *bitmap_ref;
-
-    for (int y = 0; y < bitmap.height(); ++y) {
-        ARGB32* bitmap_scanline = bitmap.scanline(y);
-
-        int color_y = y >> m_size_bits;
-        ARGB32* color_scanline = m_color_bitmap->scanline(color_y);
-
-        for (int x = 0; x < bitmap.width(); ++x) {
-            int color_x = x >> m_size_bits;
-            bitmap_scanline[x] = inverse_transform(bitmap_scanline[x], color_scanline[color_x]);
+    ARGB32 const* color_scanline = m_color_bitmap->scanline(y >> m_size_bits);
+
+    for (int begin = 0; begin < m_width; begin += 1 << m_size_bits) {
+        // https://developers.google.com/speed/webp/docs/webp_lossless_bitstream_specification#51_roles_of_image_data
+        // "Each ColorTransformElement 'cte' is treated as a pixel whose alpha component is 255,
+        // red component is cte.red_to_blue, green component is cte.green_to_blue
+        // and blue component is cte.green_to_red."
+        auto transform_color = Color::from_argb(color_scanline[begin >> m_size_bits]);
+        i8 red_to_blue = static_cast<i8>(transform_color.red());
+        i8 green_to_blue = static_cast<i8>(transform_color.green());
+        i8 green_to_red = static_cast<i8>(transform_color.blue());
+
+        int end = min(begin + (1 << m_size_bits), m_width);
+        for (int x = begin; x < end; ++x) {
+            ARGB32 pixel = scanline[x];
+
+            // "Transformed values of red and blue components"
+            int tmp_red = (pixel >> 16) & 0xff;
+            int green = (pixel >> 8) & 0xff;
+            int tmp_blue = pixel & 0xff;
+
+            // "Applying the inverse transform is just adding the color transform deltas"
+            tmp_red += ColorTransformDelta(green_to_red, green);
+            tmp_blue += ColorTransformDelta(green_to_blue, green);
+            tmp_blue += ColorTransformDelta(red_to_blue, tmp_red & 0xff);
+
+            scanline[x] = (pixel & 0xff00ff00) | ((tmp_red & 0xff) << 16) | (tmp_blue & 0xff);
         }
     }
-    return bitmap_ref;
-}
-
-ARGB32 ColorTransform::inverse_transform(ARGB32 pixel, ARGB32 transform)
-{
-    // https://developers.google.com/speed/webp/docs/webp_lossless_bitstream_specification#51_roles_of_image_data
-    // "Each ColorTransformElement 'cte' is treated as a pixel whose alpha component is 255,
-    // red component is cte.red_to_blue, green component is cte.green_to_blue
-    // and blue component is cte.green_to_red."
-    auto transform_color = Color::from_argb(transform);
-    i8 red_to_blue = static_cast<i8>(transform_color.red());
-    i8 green_to_blue = static_cast<i8>(transform_color.green());
-    i8 green_to_red = static_cast<i8>(transform_color.blue());
-
-    auto pixel_color = Color::from_argb(pixel);
-
-    // "Transformed values of red and blue components"
-    int tmp_red = pixel_color.red();
-    int green = pixel_color.green();
-    int tmp_blue = pixel_color.blue();
-
-    // "Applying the inverse transform is just adding the color transform deltas"
-    tmp_red += ColorTransformDelta(green_to_red, green);
-    tmp_blue += ColorTransformDelta(green_to_blue, green);
-    tmp_blue += ColorTransformDelta(red_to_blue, tmp_red & 0xff);
-
-    return Color(tmp_red & 0xff, green, tmp_blue & 0xff, pixel_color.alpha()).value();
+    return {};
 }
 
 // https://developers.google.com/speed/webp/docs/webp_lossless_bitstream_specification#43_subtract_green_transform
 class SubtractGreenTransform : public Transform {
 public:
-    virtual ErrorOr<NonnullRefPtr<Bitmap>> transform(NonnullRefPtr<Bitmap>) override;
+    explicit SubtractGreenTransform(int width)
+        : m_width(width)
+    {
+    }
+
+    virtual ErrorOr<void> transform(int y, Span<ARGB32> scanline) override;
+
+private:
+    int m_width;
 };
 
-ErrorOr<NonnullRefPtr<Bitmap>> SubtractGreenTransform::transform(NonnullRefPtr<Bitmap> bitmap)
+ErrorOr<void> SubtractGreenTransform::transform(int, Span<ARGB32> scanline)
 {
-    for (ARGB32& pixel : *bitmap) {
-        Color color = Color::from_argb(pixel);
-        u8 red = (color.red() + color.green()) & 0xff;
-        u8 blue = (color.blue() + color.green()) & 0xff;
-        pixel = Color(red, color.green(), blue, color.alpha()).value();
+    for (ARGB32& pixel : scanline.trim(m_width)) {
+        u32 green = (pixel >> 8) & 0xff;
+        u32 red_and_blue = ((pixel & 0x00ff00ff) + ((green << 16) | green)) & 0x00ff00ff;
+        pixel = (pixel & 0xff00ff00) | red_and_blue;
     }
-    return bitmap;
+    return {};
 }
 
 // https://developers.google.com/speed/webp/docs/webp_lossless_bitstream_specification#44_color_indexing_transform
 class ColorIndexingTransform : public Transform {
 public:
     static ErrorOr<NonnullOwnPtr<ColorIndexingTransform>> read(LittleEndianInputBitStream&, int original_width);
-    virtual ErrorOr<NonnullRefPtr<Bitmap>> transform(NonnullRefPtr<Bitmap>) override;
+    virtual ErrorOr<void> transform(int y, Span<ARGB32> scanline) override;
 
     // For a color indexing transform, the green channel of the source image is used as the index into a palette to produce an output color.
     // If the palette is small enough, several output pixels are bundled into a single input pixel.
@@ -776,16 +815,18 @@ public:
     int pixels_per_pixel() const { return m_pixels_per_pixel; }
 
 private:
-    ColorIndexingTransform(int pixels_per_pixel, int original_width, NonnullRefPtr<Bitmap> palette_bitmap)
+    ColorIndexingTransform(int pixels_per_pixel, int original_width, Array<ARGB32, 256> const& palette)
         : m_pixels_per_pixel(pixels_per_pixel)
         , m_original_width(original_width)
-        , m_palette_bitmap(palette_bitmap)
+        , m_palette(palette)
     {
     }
 
     int m_pixels_per_pixel;
     int m_original_width;
-    NonnullRefPtr<Bitmap> m_palette_bitmap;
+
+    // Always has 256 entries, so that every 8-bit index can be looked up without a bounds check.
+    Array<ARGB32, 256> m_palette;
 };
 
 ErrorOr<NonnullOwnPtr<ColorIndexingTransform>> ColorIndexingTransform::read(LittleEndianInputBitStream& bit_stream, int original_width)
@@ -813,48 +854,39 @@ ErrorOr<NonnullOwnPtr<ColorIndexingTransform>> ColorIndexingTransform::read(Litt
     // "The color table is always subtraction-coded to reduce image entropy. [...]  In decoding, every final color in the color table
     //  can be obtained by adding the previous color component values by each ARGB component separately,
     //  and storing the least significant 8 bits of the result."
-    for (ARGB32* pixel = palette_bitmap->begin() + 1; pixel != palette_bitmap->end(); ++pixel)
-        *pixel = add_argb32(*pixel, pixel[-1]);
+    // "If the index is equal or larger than color_table_size, the argb color value should be set to 0x00000000 (transparent black)."
+    Array<ARGB32, 256> palette {};
+    palette[0] = palette_bitmap->scanline(0)[0];
+    for (int i = 1; i < color_table_size; ++i)
+        palette[i] = add_argb32(palette_bitmap->scanline(0)[i], palette[i - 1]);
 
-    return adopt_nonnull_own_or_enomem(new (nothrow) ColorIndexingTransform(pixels_per_pixel, original_width, move(palette_bitmap)));
+    return adopt_nonnull_own_or_enomem(new (nothrow) ColorIndexingTransform(pixels_per_pixel, original_width, palette));
 }
 
-ErrorOr<NonnullRefPtr<Bitmap>> ColorIndexingTransform::transform(NonnullRefPtr<Bitmap> bitmap)
+ErrorOr<void> ColorIndexingTransform::transform(int, Span<ARGB32> scanline)
 {
+    // "The inverse transform for the image is simply replacing the pixel values (which are indices to the color table)
+    //  with the actual color table values. The indexing is done based on the green component of the ARGB color."
     if (pixels_per_pixel() == 1) {
-        for (ARGB32& pixel : *bitmap) {
-            // "The inverse transform for the image is simply replacing the pixel values (which are indices to the color table)
-            //  with the actual color table values. The indexing is done based on the green component of the ARGB color. [...]
-            //  If the index is equal or larger than color_table_size, the argb color value should be set to 0x00000000 (transparent black)."
-            u8 index = Color::from_argb(pixel).green();
-            pixel = index < m_palette_bitmap->width() ? m_palette_bitmap->scanline(0)[index] : 0;
-        }
-        return bitmap;
+        for (ARGB32& pixel : scanline.trim(m_original_width))
+            pixel = m_palette[(pixel >> 8) & 0xff];
+        return {};
     }
 
-    // Pixel bundling case.
-    VERIFY(ceil_div(m_original_width, pixels_per_pixel()) == bitmap->size().width());
-    IntSize unbundled_size = { m_original_width, bitmap->size().height() };
-    auto new_bitmap = TRY(Bitmap::create(BitmapFormat::BGRA8888, unbundled_size));
-
+    // Pixel bundling case. Unbundle from right to left, so that no input pixel is overwritten before it's read.
     unsigned bits_per_pixel = 8 / pixels_per_pixel();
     unsigned pixel_mask = (1 << bits_per_pixel) - 1;
-    for (int y = 0; y < bitmap->height(); ++y) {
-        ARGB32* bitmap_scanline = bitmap->scanline(y);
-        ARGB32* new_bitmap_scanline = new_bitmap->scanline(y);
-
-        for (int x = 0, new_x = 0; x < bitmap->width(); ++x, new_x += pixels_per_pixel()) {
-            u8 indexes = Color::from_argb(bitmap_scanline[x]).green();
-
-            for (int i = 0; i < pixels_per_pixel() && new_x + i < new_bitmap->width(); ++i) {
-                u8 index = indexes & pixel_mask;
-                new_bitmap_scanline[new_x + i] = index < m_palette_bitmap->width() ? m_palette_bitmap->scanline(0)[index] : 0;
-                indexes >>= bits_per_pixel;
-            }
+    for (int x = ceil_div(m_original_width, pixels_per_pixel()) - 1; x >= 0; --x) {
+        u8 indexes = (scanline[x] >> 8) & 0xff;
+
+        int new_x = x * pixels_per_pixel();
+        int count = min(pixels_per_pixel(), m_original_width - new_x);
+        for (int i = 0; i < count; ++i) {
+            scanline[new_x + i] = m_palette[indexes & pixel_mask];
+            indexes >>= bits_per_pixel;
         }
     }
-
-    return new_bitmap;
+    return {};
 }
 
 }
@@ -912,7 +944,7 @@ ErrorOr<NonnullRefPtr<Bitmap>> decode_webp_chunk_VP8L_contents(VP8LHeader const&
             TRY(transforms.try_append(TRY(ColorTransform::read(bit_stream, stored_size))));
             break;
         case SUBTRACT_GREEN_TRANSFORM:
-            TRY(transforms.try_append(TRY(try_make<SubtractGreenTransform>())));
+            TRY(transforms.try_append(TRY(try_make<SubtractGreenTransform>(stored_size.width()))));
             break;
         case COLOR_INDEXING_TRANSFORM: {
             auto color_indexing_transform = TRY(ColorIndexingTransform::read(bit_stream, stored_size.width()));
@@ -928,15 +960,31 @@ ErrorOr<NonnullRefPtr<Bitmap>> decode_webp_chunk_VP8L_contents(VP8LHeader const&
 
     auto format = vp8l_header.is_alpha_used ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888;
     auto bitmap = TRY(decode_webp_chunk_VP8L_image(ImageKind::SpatiallyCoded, format, stored_size, bit_stream));
+    if (transforms.is_empty() && vp8l_header.is_alpha_used)
+        return bitmap;
 
-    // "The inverse transforms are applied in the reverse order that they are read from the bitstream, that is, last one first."
-    for (auto const& transform : transforms.in_reverse())
-        bitmap = TRY(transform->transform(bitmap));
+    // With pixel bundling, the decoded image is narrower than the final one.
+    IntSize size { vp8l_header.width, vp8l_header.height };
+    bool is_bundled = stored_size != size;
+    auto output = is_bundled ? TRY(Bitmap::create(format, size)) : bitmap;
 
-    if (!vp8l_header.is_alpha_used)
-        bitmap->strip_alpha_channel();
+    // "The inverse transforms are applied in the reverse order that they are read from the bitstream, that is, last one first."
+    // All transforms are applied to a scanline before moving on to the next one, instead of each making a pass over the whole image.
+    for (int y = 0; y < size.height(); ++y) {
+        Span<ARGB32> scanline { output->scanline(y), static_cast<size_t>(size.width()) };
+        if (is_bundled)
+            __builtin_memcpy(scanline.data(), bitmap->scanline(y), stored_size.width() * sizeof(ARGB32));
+
+        for (auto& transform : transforms.in_reverse())
+            TRY(transform->transform(y, scanline));
+
+        if (!vp8l_header.is_alpha_used) {
+            for (ARGB32& pixel : scanline)
+                pixel |= 0xff000000;
+        }
+    }
 
-    return bitmap;
+    return output;
 }
 
 }
@@ -1043,16 +1043,35 @@ void predict_y_subblock(Bytes y_prediction, IntraBlockMode mode, int x, int y, R
 template<int N>
 void add_idct_to_prediction(Bytes prediction, Coefficients coefficients, int x, int y)
 {
-    Coefficients idct_output;
-    short_idct4x4llm_c(coefficients, idct_output, 4 * sizeof(i16));
+    // Most subblocks have no AC coefficients, and many have no coefficients at all. For those, the inverse DCT is a
+    // constant (or zero), so skip the full transform.
+    bool has_ac_coefficients = false;
+    for (int i = 1; i < 16; ++i)
+        has_ac_coefficients |= coefficients[i] != 0;
+
+    if (!has_ac_coefficients && coefficients[0] == 0)
+        return;
+
+    u8* output = prediction.offset_pointer(4 * y * N + 4 * x);
 
     // https://datatracker.ietf.org/doc/html/rfc6386#section-14.5 "Summation of Predictor and Residue"
     // FIXME: Could omit the clamp() call if FrameHeader.clamping_type == ClampingSpecification::NoClampingNecessary.
-    for (int py = 0; py < 4; ++py) {
-        for (int px = 0; px < 4; ++px) {
-            u8& p = prediction[(4 * y + py) * N + (4 * x + px)];
-            p = clamp(p + idct_output[py * 4 + px], 0, 255);
+    if (!has_ac_coefficients) {
+        // This is what short_idct4x4llm_c() computes when only the DC coefficient is set.
+        int dc = (coefficients[0] + 4) >> 3;
+        for (int py = 0; py < 4; ++py, output += N) {
+            for (int px = 0; px < 4; ++px)
+                output[px] = clamp(output[px] + dc, 0, 255);
         }
+        return;
+    }
+
+    Coefficients idct_output;
+    short_idct4x4llm_c(coefficients, idct_output, 4 * sizeof(i16));
+
+    for (int py = 0; py < 4; ++py, output += N) {
+        for (int px = 0; px < 4; ++px)
+            output[px] = clamp(output[px] + idct_output[py * 4 + px], 0, 255);
     }
 }
 
@@ -1117,20 +1136,36 @@ void process_subblocks(Bytes y_output, MacroblockMetadata const& metadata, int m
 
 void convert_yuv_to_rgb(Bitmap& bitmap, int mb_x, int mb_y, ReadonlyBytes y_data, ReadonlyBytes u_data, ReadonlyBytes v_data)
 {
-    for (int y = 0; y < 16; ++y) {
-        for (int x = 0; x < 16; ++x) {
-            u8 Y = y_data[y * 16 + x];
+    // The bitmap has the image's size, so macroblocks on the right and bottom edge can stick out of it.
+    int width = min(16, bitmap.width() - mb_x * 16);
+    int height = min(16, bitmap.height() - mb_y * 16);
+
+    // These are the fixed-point formulas from libwebp's yuv.h. They have 14 bits of precision.
+    auto const multiply_high = [](int value, int coefficient) { return (value * coefficient) >> 8; };
+    auto const clip_to_8_bits = [](int value) -> u8 {
+        if ((value & ~16383) == 0)
+            return value >> 6;
+        return value < 0 ? 0 : 255;
+    };
 
-            // FIXME: Could do nicer upsampling than just nearest neighbor
-            u8 U = u_data[(y / 2) * 8 + x / 2];
-            u8 V = v_data[(y / 2) * 8 + x / 2];
+    for (int y = 0; y < height; ++y) {
+        ARGB32* scanline = bitmap.scanline(mb_y * 16 + y) + mb_x * 16;
+        u8 const* y_row = y_data.offset_pointer(y * 16);
 
-            // XXX: These numbers are from the fixed-point values in libwebp's yuv.h. There's probably a better reference somewhere.
-            int r = 1.1655 * Y + 1.596 * V - 222.4;
-            int g = 1.1655 * Y - 0.3917 * U - 0.8129 * V + 136.0625;
-            int b = 1.1655 * Y + 2.0172 * U - 276.33;
+        // FIXME: Could do nicer upsampling than just nearest neighbor
+        u8 const* u_row = u_data.offset_pointer((y / 2) * 8);
+        u8 const* v_row = v_data.offset_pointer((y / 2) * 8);
 
-            bitmap.scanline(mb_y * 16 + y)[mb_x * 16 + x] = Color(clamp(r, 0, 255), clamp(g, 0, 255), clamp(b, 0, 255)).value();
+        for (int x = 0; x < width; ++x) {
+            int Y = multiply_high(y_row[x], 19077);
+            int U = u_row[x / 2];
+            int V = v_row[x / 2];
+
+            u8 r = clip_to_8_bits(Y + multiply_high(V, 26149) - 14234);
+            u8 g = clip_to_8_bits(Y - multiply_high(U, 6419) - multiply_high(V, 13320) + 8708);
+            u8 b = clip_to_8_bits(Y + multiply_high(U, 33050) - 17685);
+
+            scanline[x] = 0xff000000 | (r << 16) | (g << 8) | b;
         }
     }
 }
@@ -1280,16 +1315,12 @@ ErrorOr<NonnullRefPtr<Bitmap>> decode_webp_chunk_VP8_contents(VP8Header const& v
     // Done with the first partition!
 
     auto bitmap_format = include_alpha_channel ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888;
-    auto bitmap = TRY(Bitmap::create(bitmap_format, { macroblock_width * 16, macroblock_height * 16 }));
+    // Macroblocks that stick out of the image are decoded but not stored, so that the bitmap doesn't have to be cropped.
+    auto bitmap = TRY(Bitmap::create(bitmap_format, { static_cast<int>(vp8_header.width), static_cast<int>(vp8_header.height) }));
 
     auto data_partitions = TRY(split_data_partitions(vp8_header.second_partition, header.number_of_dct_partitions));
     TRY(decode_VP8_image_data(*bitmap, header, move(data_partitions), macroblock_width, macroblock_height, macroblock_metadata));
-
-    auto width = static_cast<int>(vp8_header.width);
-    auto height = static_cast<int>(vp8_header.height);
-    if (bitmap->physical_size() == IntSize { width, height })
-        return bitmap;
-    return bitmap->cropped({ 0, 0, width, height });
+    return bitmap;
 }
 
 }
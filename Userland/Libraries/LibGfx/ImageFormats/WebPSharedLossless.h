@@ -38,6 +38,14 @@ private:
     Variant<u32, Compress::CanonicalCode> m_code { 0 };
 };
 
+ALWAYS_INLINE ErrorOr<u32> CanonicalCode::read_symbol(LittleEndianInputBitStream& bit_stream) const
+{
+    // This is called several times per pixel, so it's inline. Compress::CanonicalCode decodes most symbols with a single table lookup.
+    if (auto const* single_symbol = m_code.get_pointer<u32>())
+        return *single_symbol;
+    return m_code.get<Compress::CanonicalCode>().read_symbol(bit_stream);
+}
+
 ALWAYS_INLINE ErrorOr<void> CanonicalCode::write_symbol(LittleEndianOutputBitStream& bit_stream, u32 symbol) const
 {
     TRY(m_code.visit(
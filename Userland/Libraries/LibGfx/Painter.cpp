@@ -14,13 +14,16 @@
 #include "Bitmap.h"
 #include "Font/Emoji.h"
 #include "Font/Font.h"
+#include <AK/Array.h>
 #include <AK/Assertions.h>
+#include <AK/BitCast.h>
 #include <AK/Debug.h>
 #include <AK/Function.h>
 #include <AK/Math.h>
 #include <AK/Memory.h>
 #include <AK/Queue.h>
 #include <AK/QuickSort.h>
+#include <AK/SIMDExtras.h>
 #include <AK/Stack.h>
 #include <AK/StdLibExtras.h>
 #include <AK/StringBuilder.h>
@@ -52,6 +55,49 @@ ALWAYS_INLINE Color get_pixel(Gfx::Bitmap const& bitmap, int x, int y)
     return bitmap.get_pixel(x, y);
 }
 
+ALWAYS_INLINE static AK::SIMD::u32x4 load_pixels(ARGB32 const* pixels)
+{
+    AK::SIMD::u32x4 result;
+    __builtin_memcpy(&result, pixels, sizeof(result));
+    return result;
+}
+
+ALWAYS_INLINE static void store_pixels(ARGB32* pixels, AK::SIMD::u32x4 value)
+{
+    __builtin_memcpy(pixels, &value, sizeof(value));
+}
+
+ALWAYS_INLINE static bool all_opaque(AK::SIMD::u32x4 pixels)
+{
+    return AK::SIMD::all(static_cast<AK::SIMD::i32x4>((pixels >> 24) == 0xff));
+}
+
+// Blends four pixels over four opaque pixels, giving the exact same result as Color::blend().
+ALWAYS_INLINE static AK::SIMD::u32x4 blend_over_opaque(AK::SIMD::u32x4 destination, AK::SIMD::u32x4 source)
+{
+    using AK::SIMD::u16x8;
+
+    // Each pixel is split into two 16-bit lanes per vector, holding blue and red or green and alpha.
+    auto const alpha = source >> 24;
+    auto const source_weight = bit_cast<u16x8>(alpha | (alpha << 16));
+    auto const destination_weight = 255 - source_weight;
+
+    auto blend_channels = [&](u16x8 destination_channels, u16x8 source_channels) {
+        u16x8 sum = destination_channels * destination_weight + source_channels * source_weight;
+        // This is an exact division by 255 for all sums up to 255 * 255.
+        return (sum + 1 + (sum >> 8)) >> 8;
+    };
+
+    auto blue_and_red = blend_channels(bit_cast<u16x8>(destination) & 0xff, bit_cast<u16x8>(source) & 0xff);
+    auto green = blend_channels(bit_cast<u16x8>(destination) >> 8, bit_cast<u16x8>(source) >> 8);
+    return bit_cast<AK::SIMD::u32x4>(blue_and_red | (green << 8)) | 0xff000000;
+}
+
+ALWAYS_INLINE static AK::SIMD::u32x4 swap_red_and_blue_channels(AK::SIMD::u32x4 pixels)
+{
+    return (pixels & 0xff00ff00) | ((pixels & 0xff) << 16) | ((pixels >> 16) & 0xff);
+}
+
 Painter::Painter(Gfx::Bitmap& bitmap)
     : m_target(bitmap)
 {
@@ -109,8 +155,20 @@ void Painter::fill_physical_rect(IntRect const& physical_rect, Color color)
     size_t const dst_skip = m_target->pitch() / sizeof(ARGB32);
 
     auto dst_format = target()->format();
+    bool const dst_has_alpha = dst_format == BitmapFormat::BGRA8888;
+    auto const source = AK::SIMD::expand4(color.value());
     for (int i = physical_rect.height() - 1; i >= 0; --i) {
-        for (int j = 0; j < physical_rect.width(); ++j)
+        int j = 0;
+        for (; j + 4 <= physical_rect.width(); j += 4) {
+            auto destination = load_pixels(dst + j);
+            if (dst_has_alpha && !all_opaque(destination)) {
+                for (int k = j; k < j + 4; ++k)
+                    dst[k] = Color::from_argb(dst[k]).blend(color).value();
+                continue;
+            }
+            store_pixels(dst + j, blend_over_opaque(destination, source));
+        }
+        for (; j < physical_rect.width(); ++j)
             dst[j] = color_for_format(dst_format, dst[j]).blend(color).value();
         dst += dst_skip;
     }
@@ -835,28 +893,60 @@ static void swap_red_and_blue_channels(Color& color)
     color = Color::from_argb(bgra);
 }
 
-// FIXME: This function is very unoptimized.
 template<BlitState::AlphaState has_alpha>
 static void do_blit_with_opacity(BlitState& state)
 {
+    // The opacity is folded into the alpha of each source pixel up front, so that rows can be blended four pixels
+    // at a time. Runs of opaque source pixels are copied as is.
+    Array<u8, 256> alpha_table;
+    for (size_t alpha = 0; alpha < alpha_table.size(); ++alpha) {
+        if constexpr (has_alpha & BlitState::SrcAlpha) {
+            float pixel_opacity = alpha / 255.0;
+            alpha_table[alpha] = 255 * (state.opacity * pixel_opacity);
+        } else {
+            alpha_table[alpha] = state.opacity * 255;
+        }
+    }
+
+    bool const swap_channels = state.src_format == BitmapFormat::RGBA8888;
+    auto source_pixel = [&](ARGB32 pixel) -> ARGB32 {
+        return (pixel & 0xffffff) | (static_cast<u32>(alpha_table[pixel >> 24]) << 24);
+    };
+    auto blend_pixel = [&](ARGB32 destination, ARGB32 source) {
+        Color dest_color = (has_alpha & BlitState::DstAlpha) ? Color::from_argb(destination) : Color::from_rgb(destination);
+        Color src_color_with_alpha = Color::from_argb(source_pixel(source));
+        if (swap_channels)
+            swap_red_and_blue_channels(src_color_with_alpha);
+        return dest_color.blend(src_color_with_alpha).value();
+    };
+
     for (int row = 0; row < state.row_count; ++row) {
-        for (int x = 0; x < state.column_count; ++x) {
-            Color dest_color = (has_alpha & BlitState::DstAlpha) ? Color::from_argb(state.dst[x]) : Color::from_rgb(state.dst[x]);
-            if constexpr (has_alpha & BlitState::SrcAlpha) {
-                Color src_color_with_alpha = Color::from_argb(state.src[x]);
-                if (state.src_format == BitmapFormat::RGBA8888)
-                    swap_red_and_blue_channels(src_color_with_alpha);
-                float pixel_opacity = src_color_with_alpha.alpha() / 255.0;
-                src_color_with_alpha.set_alpha(255 * (state.opacity * pixel_opacity));
-                state.dst[x] = dest_color.blend(src_color_with_alpha).value();
-            } else {
-                Color src_color_with_alpha = Color::from_rgb(state.src[x]);
-                if (state.src_format == BitmapFormat::RGBA8888)
-                    swap_red_and_blue_channels(src_color_with_alpha);
-                src_color_with_alpha.set_alpha(state.opacity * 255);
-                state.dst[x] = dest_color.blend(src_color_with_alpha).value();
+        int x = 0;
+        for (; x + 4 <= state.column_count; x += 4) {
+            AK::SIMD::u32x4 source {
+                source_pixel(state.src[x]),
+                source_pixel(state.src[x + 1]),
+                source_pixel(state.src[x + 2]),
+                source_pixel(state.src[x + 3]),
+            };
+            if (swap_channels)
+                source = swap_red_and_blue_channels(source);
+
+            if (all_opaque(source)) {
+                store_pixels(state.dst + x, source);
+                continue;
+            }
+
+            auto destination = load_pixels(state.dst + x);
+            if ((has_alpha & BlitState::DstAlpha) && !all_opaque(destination)) {
+                for (int i = x; i < x + 4; ++i)
+                    state.dst[i] = blend_pixel(state.dst[i], state.src[i]);
+                continue;
             }
+            store_pixels(state.dst + x, blend_over_opaque(destination, source));
         }
+        for (; x < state.column_count; ++x)
+            state.dst[x] = blend_pixel(state.dst[x], state.src[x]);
         state.dst += state.dst_pitch;
         state.src += state.src_pitch;
     }
@@ -1118,13 +1208,13 @@ ALWAYS_INLINE static void do_draw_integer_scaled_bitmap(Gfx::Bitmap& target, Int
             if (has_opacity)
                 src_pixel.set_alpha(src_pixel.alpha() * opacity);
             for (int yo = 0; yo < vfactor; ++yo) {
-                auto* scanline = (Color*)target.scanline(dst_y + yo);
                 int dst_x = dst_rect.x() + x * hfactor;
-                for (int xo = 0; xo < hfactor; ++xo) {
-                    if constexpr (has_alpha_channel)
+                if constexpr (has_alpha_channel) {
+                    auto* scanline = (Color*)target.scanline(dst_y + yo);
+                    for (int xo = 0; xo < hfactor; ++xo)
                         scanline[dst_x + xo] = scanline[dst_x + xo].blend(src_pixel);
-                    else
-                        scanline[dst_x + xo] = src_pixel;
+                } else {
+                    fast_u32_fill(target.scanline(dst_y + yo) + dst_x, src_pixel.value(), hfactor);
                 }
             }
         }
@@ -1220,60 +1310,80 @@ ALWAYS_INLINE static void do_draw_scaled_bitmap(Gfx::Bitmap& target, IntRect con
     i64 src_left = src_rect.left() * shift;
     i64 src_top = src_rect.top() * shift;
 
+    // Which two source pixels to mix along an axis, and how much of the second one to take.
+    struct SourceSample {
+        int first;
+        int second;
+        float ratio;
+    };
+
+    // The source columns and their weights are the same for every row, so compute them only once.
+    Vector<SourceSample> source_columns;
+    source_columns.ensure_capacity(clipped_rect.width());
+    for (int x = clipped_rect.left(); x < clipped_rect.right(); ++x) {
+        auto desired_x = (x - dst_rect.x()) * hscale + src_left;
+        if constexpr (scaling_mode == Painter::ScalingMode::BilinearBlend) {
+            auto shifted_x = desired_x + bilinear_offset_x;
+            source_columns.unchecked_append({
+                .first = static_cast<int>(clamp(shifted_x >> 32, clipped_src_rect.left(), clipped_src_rect.right() - 1)),
+                .second = static_cast<int>(clamp((shifted_x >> 32) + 1, clipped_src_rect.left(), clipped_src_rect.right() - 1)),
+                .ratio = (shifted_x & fractional_mask) / static_cast<float>(shift),
+            });
+        } else if constexpr (scaling_mode == Painter::ScalingMode::SmoothPixels) {
+            auto scaled_x1 = clamp(desired_x >> 32, clipped_src_rect.left(), clipped_src_rect.right() - 1);
+            float x_ratio = (desired_x & fractional_mask) / (float)shift;
+            source_columns.unchecked_append({
+                .first = static_cast<int>(clamp(scaled_x1 - 1, clipped_src_rect.left(), clipped_src_rect.right() - 1)),
+                .second = static_cast<int>(scaled_x1),
+                .ratio = clamp(x_ratio * dst_rect.width() / (float)src_rect.width(), 0.f, 1.f),
+            });
+        } else {
+            auto scaled_x = static_cast<int>(clamp(desired_x >> 32, clipped_src_rect.left(), clipped_src_rect.right() - 1));
+            source_columns.unchecked_append({ .first = scaled_x, .second = scaled_x, .ratio = 0.f });
+        }
+    }
+
     for (int y = clipped_rect.top(); y < clipped_rect.bottom(); ++y) {
         auto* scanline = reinterpret_cast<Color*>(target.scanline(y));
         auto desired_y = (y - dst_rect.y()) * vscale + src_top;
 
+        SourceSample row;
+        if constexpr (scaling_mode == Painter::ScalingMode::BilinearBlend) {
+            auto shifted_y = desired_y + bilinear_offset_y;
+            row = {
+                .first = static_cast<int>(clamp(shifted_y >> 32, clipped_src_rect.top(), clipped_src_rect.bottom() - 1)),
+                .second = static_cast<int>(clamp((shifted_y >> 32) + 1, clipped_src_rect.top(), clipped_src_rect.bottom() - 1)),
+                .ratio = (shifted_y & fractional_mask) / static_cast<float>(shift),
+            };
+        } else if constexpr (scaling_mode == Painter::ScalingMode::SmoothPixels) {
+            auto scaled_y1 = clamp(desired_y >> 32, clipped_src_rect.top(), clipped_src_rect.bottom() - 1);
+            float y_ratio = (desired_y & fractional_mask) / (float)shift;
+            row = {
+                .first = static_cast<int>(clamp(scaled_y1 - 1, clipped_src_rect.top(), clipped_src_rect.bottom() - 1)),
+                .second = static_cast<int>(scaled_y1),
+                .ratio = clamp(y_ratio * dst_rect.height() / (float)src_rect.height(), 0.f, 1.f),
+            };
+        } else {
+            auto scaled_y = static_cast<int>(clamp(desired_y >> 32, clipped_src_rect.top(), clipped_src_rect.bottom() - 1));
+            row = { .first = scaled_y, .second = scaled_y, .ratio = 0.f };
+        }
+
         for (int x = clipped_rect.left(); x < clipped_rect.right(); ++x) {
-            auto desired_x = (x - dst_rect.x()) * hscale + src_left;
+            auto const& column = source_columns[x - clipped_rect.left()];
 
             Color src_pixel;
-            if constexpr (scaling_mode == Painter::ScalingMode::BilinearBlend) {
-                auto shifted_x = desired_x + bilinear_offset_x;
-                auto shifted_y = desired_y + bilinear_offset_y;
-
-                auto scaled_x0 = clamp(shifted_x >> 32, clipped_src_rect.left(), clipped_src_rect.right() - 1);
-                auto scaled_x1 = clamp((shifted_x >> 32) + 1, clipped_src_rect.left(), clipped_src_rect.right() - 1);
-                auto scaled_y0 = clamp(shifted_y >> 32, clipped_src_rect.top(), clipped_src_rect.bottom() - 1);
-                auto scaled_y1 = clamp((shifted_y >> 32) + 1, clipped_src_rect.top(), clipped_src_rect.bottom() - 1);
+            if constexpr (scaling_mode == Painter::ScalingMode::BilinearBlend || scaling_mode == Painter::ScalingMode::SmoothPixels) {
+                auto top_left = get_pixel(source, column.first, row.first);
+                auto top_right = get_pixel(source, column.second, row.first);
+                auto bottom_left = get_pixel(source, column.first, row.second);
+                auto bottom_right = get_pixel(source, column.second, row.second);
 
-                float x_ratio = (shifted_x & fractional_mask) / static_cast<float>(shift);
-                float y_ratio = (shifted_y & fractional_mask) / static_cast<float>(shift);
+                auto top = top_left.mixed_with(top_right, column.ratio);
+                auto bottom = bottom_left.mixed_with(bottom_right, column.ratio);
 
-                auto top_left = get_pixel(source, scaled_x0, scaled_y0);
-                auto top_right = get_pixel(source, scaled_x1, scaled_y0);
-                auto bottom_left = get_pixel(source, scaled_x0, scaled_y1);
-                auto bottom_right = get_pixel(source, scaled_x1, scaled_y1);
-
-                auto top = top_left.mixed_with(top_right, x_ratio);
-                auto bottom = bottom_left.mixed_with(bottom_right, x_ratio);
-
-                src_pixel = top.mixed_with(bottom, y_ratio);
-            } else if constexpr (scaling_mode == Painter::ScalingMode::SmoothPixels) {
-                auto scaled_x1 = clamp(desired_x >> 32, clipped_src_rect.left(), clipped_src_rect.right() - 1);
-                auto scaled_x0 = clamp(scaled_x1 - 1, clipped_src_rect.left(), clipped_src_rect.right() - 1);
-                auto scaled_y1 = clamp(desired_y >> 32, clipped_src_rect.top(), clipped_src_rect.bottom() - 1);
-                auto scaled_y0 = clamp(scaled_y1 - 1, clipped_src_rect.top(), clipped_src_rect.bottom() - 1);
-
-                float x_ratio = (desired_x & fractional_mask) / (float)shift;
-                float y_ratio = (desired_y & fractional_mask) / (float)shift;
-
-                float scaled_x_ratio = clamp(x_ratio * dst_rect.width() / (float)src_rect.width(), 0.f, 1.f);
-                float scaled_y_ratio = clamp(y_ratio * dst_rect.height() / (float)src_rect.height(), 0.f, 1.f);
-
-                auto top_left = get_pixel(source, scaled_x0, scaled_y0);
-                auto top_right = get_pixel(source, scaled_x1, scaled_y0);
-                auto bottom_left = get_pixel(source, scaled_x0, scaled_y1);
-                auto bottom_right = get_pixel(source, scaled_x1, scaled_y1);
-
-                auto top = top_left.mixed_with(top_right, scaled_x_ratio);
-                auto bottom = bottom_left.mixed_with(bottom_right, scaled_x_ratio);
-
-                src_pixel = top.mixed_with(bottom, scaled_y_ratio);
+                src_pixel = top.mixed_with(bottom, row.ratio);
             } else {
-                auto scaled_x = clamp(desired_x >> 32, clipped_src_rect.left(), clipped_src_rect.right() - 1);
-                auto scaled_y = clamp(desired_y >> 32, clipped_src_rect.top(), clipped_src_rect.bottom() - 1);
-                src_pixel = get_pixel(source, scaled_x, scaled_y);
+                src_pixel = get_pixel(source, column.first, row.first);
             }
 
             if (has_opacity)
@@ -2445,6 +2555,31 @@ void Painter::draw_text_run(FloatPoint baseline_start, Utf8View const& string, F
     });
 }
 
+void Painter::draw_glyph_run(ReadonlySpan<DrawGlyphOrEmoji> glyph_run, Color color, FloatPoint translation, float scale)
+{
+    // Runs mostly consist of a single font, so remember the last one we resized.
+    Font const* last_font = nullptr;
+    RefPtr<Font const> last_scaled_font;
+    auto scaled_font = [&](Font const& font) -> Font const& {
+        if (scale == 1.0f)
+            return font;
+        if (&font != last_font) {
+            last_font = &font;
+            last_scaled_font = font.with_size(font.point_size() * scale);
+        }
+        return *last_scaled_font;
+    };
+
+    for (auto const& glyph_or_emoji : glyph_run) {
+        if (auto const* glyph = glyph_or_emoji.get_pointer<DrawGlyph>()) {
+            draw_glyph(glyph->position.scaled(scale).translated(translation), glyph->code_point, scaled_font(*glyph->font), color);
+        } else {
+            auto const& emoji = glyph_or_emoji.get<DrawEmoji>();
+            draw_emoji(emoji.position.scaled(scale).translated(translation).to_type<int>(), *emoji.emoji, scaled_font(*emoji.font));
+        }
+    }
+}
+
 void Painter::draw_scaled_bitmap_with_transform(IntRect const& dst_rect, Bitmap const& bitmap, FloatRect const& src_rect, AffineTransform const& transform, float opacity, Painter::ScalingMode scaling_mode)
 {
     if (transform.is_identity_or_translation_or_scale()) {
@@ -23,6 +23,7 @@
 #include <LibGfx/TextAlignment.h>
 #include <LibGfx/TextDirection.h>
 #include <LibGfx/TextElision.h>
+#include <LibGfx/TextLayout.h>
 #include <LibGfx/TextWrapping.h>
 
 namespace Gfx {
@@ -133,6 +134,9 @@ public:
     void draw_text_run(IntPoint baseline_start, Utf8View const&, Font const&, Color);
     void draw_text_run(FloatPoint baseline_start, Utf8View const&, Font const&, Color);
 
+    // Draws already positioned glyphs, scaled and then translated. Each font of the run is only resized once.
+    void draw_glyph_run(ReadonlySpan<DrawGlyphOrEmoji>, Color, FloatPoint translation = {}, float scale = 1.0f);
+
     enum class CornerOrientation {
         TopLeft,
         TopRight,
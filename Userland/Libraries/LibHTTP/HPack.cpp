@@ -0,0 +1,526 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/StringBuilder.h>
+#include <LibHTTP/HPack.h>
+
+namespace HTTP::HPack {
+
+struct StaticTableEntry {
+    StringView name;
+    StringView value;
+};
+
+// https://www.rfc-editor.org/rfc/rfc7541#appendix-A
+static constexpr Array<StaticTableEntry, 61> static_table { {
+    { ":authority"sv, ""sv },
+    { ":method"sv, "GET"sv },
+    { ":method"sv, "POST"sv },
+    { ":path"sv, "/"sv },
+    { ":path"sv, "/index.html"sv },
+    { ":scheme"sv, "http"sv },
+    { ":scheme"sv, "https"sv },
+    { ":status"sv, "200"sv },
+    { ":status"sv, "204"sv },
+    { ":status"sv, "206"sv },
+    { ":status"sv, "304"sv },
+    { ":status"sv, "400"sv },
+    { ":status"sv, "404"sv },
+    { ":status"sv, "500"sv },
+    { "accept-charset"sv, ""sv },
+    { "accept-encoding"sv, "gzip, deflate"sv },
+    { "accept-language"sv, ""sv },
+    { "accept-ranges"sv, ""sv },
+    { "accept"sv, ""sv },
+    { "access-control-allow-origin"sv, ""sv },
+    { "age"sv, ""sv },
+    { "allow"sv, ""sv },
+    { "authorization"sv, ""sv },
+    { "cache-control"sv, ""sv },
+    { "content-disposition"sv, ""sv },
+    { "content-encoding"sv, ""sv },
+    { "content-language"sv, ""sv },
+    { "content-length"sv, ""sv },
+    { "content-location"sv, ""sv },
+    { "content-range"sv, ""sv },
+    { "content-type"sv, ""sv },
+    { "cookie"sv, ""sv },
+    { "date"sv, ""sv },
+    { "etag"sv, ""sv },
+    { "expect"sv, ""sv },
+    { "expires"sv, ""sv },
+    { "from"sv, ""sv },
+    { "host"sv, ""sv },
+    { "if-match"sv, ""sv },
+    { "if-modified-since"sv, ""sv },
+    { "if-none-match"sv, ""sv },
+    { "if-range"sv, ""sv },
+    { "if-unmodified-since"sv, ""sv },
+    { "last-modified"sv, ""sv },
+    { "link"sv, ""sv },
+    { "location"sv, ""sv },
+    { "max-forwards"sv, ""sv },
+    { "proxy-authenticate"sv, ""sv },
+    { "proxy-authorization"sv, ""sv },
+    { "range"sv, ""sv },
+    { "referer"sv, ""sv },
+    { "refresh"sv, ""sv },
+    { "retry-after"sv, ""sv },
+    { "server"sv, ""sv },
+    { "set-cookie"sv, ""sv },
+    { "strict-transport-security"sv, ""sv },
+    { "transfer-encoding"sv, ""sv },
+    { "user-agent"sv, ""sv },
+    { "vary"sv, ""sv },
+    { "via"sv, ""sv },
+    { "www-authenticate"sv, ""sv },
+} };
+
+struct HuffmanCode {
+    u32 code { 0 };
+    u8 length { 0 };
+};
+
+static constexpr u16 end_of_string_symbol = 256;
+
+// https://www.rfc-editor.org/rfc/rfc7541#appendix-B
+static constexpr Array<HuffmanCode, 257> huffman_codes { {
+    { 0x1ff8, 13 }, { 0x7fffd8, 23 }, { 0xfffffe2, 28 }, { 0xfffffe3, 28 },
+    { 0xfffffe4, 28 }, { 0xfffffe5, 28 }, { 0xfffffe6, 28 }, { 0xfffffe7, 28 },
+    { 0xfffffe8, 28 }, { 0xffffea, 24 }, { 0x3ffffffc, 30 }, { 0xfffffe9, 28 },
+    { 0xfffffea, 28 }, { 0x3ffffffd, 30 }, { 0xfffffeb, 28 }, { 0xfffffec, 28 },
+    { 0xfffffed, 28 }, { 0xfffffee, 28 }, { 0xfffffef, 28 }, { 0xffffff0, 28 },
+    { 0xffffff1, 28 }, { 0xffffff2, 28 }, { 0x3ffffffe, 30 }, { 0xffffff3, 28 },
+    { 0xffffff4, 28 }, { 0xffffff5, 28 }, { 0xffffff6, 28 }, { 0xffffff7, 28 },
+    { 0xffffff8, 28 }, { 0xffffff9, 28 }, { 0xffffffa, 28 }, { 0xffffffb, 28 },
+    { 0x14, 6 }, { 0x3f8, 10 }, { 0x3f9, 10 }, { 0xffa, 12 },
+    { 0x1ff9, 13 }, { 0x15, 6 }, { 0xf8, 8 }, { 0x7fa, 11 },
+    { 0x3fa, 10 }, { 0x3fb, 10 }, { 0xf9, 8 }, { 0x7fb, 11 },
+    { 0xfa, 8 }, { 0x16, 6 }, { 0x17, 6 }, { 0x18, 6 },
+    { 0x0, 5 }, { 0x1, 5 }, { 0x2, 5 }, { 0x19, 6 },
+    { 0x1a, 6 }, { 0x1b, 6 }, { 0x1c, 6 }, { 0x1d, 6 },
+    { 0x1e, 6 }, { 0x1f, 6 }, { 0x5c, 7 }, { 0xfb, 8 },
+    { 0x7ffc, 15 }, { 0x20, 6 }, { 0xffb, 12 }, { 0x3fc, 10 },
+    { 0x1ffa, 13 }, { 0x21, 6 }, { 0x5d, 7 }, { 0x5e, 7 },
+    { 0x5f, 7 }, { 0x60, 7 }, { 0x61, 7 }, { 0x62, 7 },
+    { 0x63, 7 }, { 0x64, 7 }, { 0x65, 7 }, { 0x66, 7 },
+    { 0x67, 7 }, { 0x68, 7 }, { 0x69, 7 }, { 0x6a, 7 },
+    { 0x6b, 7 }, { 0x6c, 7 }, { 0x6d, 7 }, { 0x6e, 7 },
+    { 0x6f, 7 }, { 0x70, 7 }, { 0x71, 7 }, { 0x72, 7 },
+    { 0xfc, 8 }, { 0x73, 7 }, { 0xfd, 8 }, { 0x1ffb, 13 },
+    { 0x7fff0, 19 }, { 0x1ffc, 13 }, { 0x3ffc, 14 }, { 0x22, 6 },
+    { 0x7ffd, 15 }, { 0x3, 5 }, { 0x23, 6 }, { 0x4, 5 },
+    { 0x24, 6 }, { 0x5, 5 }, { 0x25, 6 }, { 0x26, 6 },
+    { 0x27, 6 }, { 0x6, 5 }, { 0x74, 7 }, { 0x75, 7 },
+    { 0x28, 6 }, { 0x29, 6 }, { 0x2a, 6 }, { 0x7, 5 },
+    { 0x2b, 6 }, { 0x76, 7 }, { 0x2c, 6 }, { 0x8, 5 },
+    { 0x9, 5 }, { 0x2d, 6 }, { 0x77, 7 }, { 0x78, 7 },
+    { 0x79, 7 }, { 0x7a, 7 }, { 0x7b, 7 }, { 0x7ffe, 15 },
+    { 0x7fc, 11 }, { 0x3ffd, 14 }, { 0x1ffd, 13 }, { 0xffffffc, 28 },
+    { 0xfffe6, 20 }, { 0x3fffd2, 22 }, { 0xfffe7, 20 }, { 0xfffe8, 20 },
+    { 0x3fffd3, 22 }, { 0x3fffd4, 22 }, { 0x3fffd5, 22 }, { 0x7fffd9, 23 },
+    { 0x3fffd6, 22 }, { 0x7fffda, 23 }, { 0x7fffdb, 23 }, { 0x7fffdc, 23 },
+    { 0x7fffdd, 23 }, { 0x7fffde, 23 }, { 0xffffeb, 24 }, { 0x7fffdf, 23 },
+    { 0xffffec, 24 }, { 0xffffed, 24 }, { 0x3fffd7, 22 }, { 0x7fffe0, 23 },
+    { 0xffffee, 24 }, { 0x7fffe1, 23 }, { 0x7fffe2, 23 }, { 0x7fffe3, 23 },
+    { 0x7fffe4, 23 }, { 0x1fffdc, 21 }, { 0x3fffd8, 22 }, { 0x7fffe5, 23 },
+    { 0x3fffd9, 22 }, { 0x7fffe6, 23 }, { 0x7fffe7, 23 }, { 0xffffef, 24 },
+    { 0x3fffda, 22 }, { 0x1fffdd, 21 }, { 0xfffe9, 20 }, { 0x3fffdb, 22 },
+    { 0x3fffdc, 22 }, { 0x7fffe8, 23 }, { 0x7fffe9, 23 }, { 0x1fffde, 21 },
+    { 0x7fffea, 23 }, { 0x3fffdd, 22 }, { 0x3fffde, 22 }, { 0xfffff0, 24 },
+    { 0x1fffdf, 21 }, { 0x3fffdf, 22 }, { 0x7fffeb, 23 }, { 0x7fffec, 23 },
+    { 0x1fffe0, 21 }, { 0x1fffe1, 21 }, { 0x3fffe0, 22 }, { 0x1fffe2, 21 },
+    { 0x7fffed, 23 }, { 0x3fffe1, 22 }, { 0x7fffee, 23 }, { 0x7fffef, 23 },
+    { 0xfffea, 20 }, { 0x3fffe2, 22 }, { 0x3fffe3, 22 }, { 0x3fffe4, 22 },
+    { 0x7ffff0, 23 }, { 0x3fffe5, 22 }, { 0x3fffe6, 22 }, { 0x7ffff1, 23 },
+    { 0x3ffffe0, 26 }, { 0x3ffffe1, 26 }, { 0xfffeb, 20 }, { 0x7fff1, 19 },
+    { 0x3fffe7, 22 }, { 0x7ffff2, 23 }, { 0x3fffe8, 22 }, { 0x1ffffec, 25 },
+    { 0x3ffffe2, 26 }, { 0x3ffffe3, 26 }, { 0x3ffffe4, 26 }, { 0x7ffffde, 27 },
+    { 0x7ffffdf, 27 }, { 0x3ffffe5, 26 }, { 0xfffff1, 24 }, { 0x1ffffed, 25 },
+    { 0x7fff2, 19 }, { 0x1fffe3, 21 }, { 0x3ffffe6, 26 }, { 0x7ffffe0, 27 },
+    { 0x7ffffe1, 27 }, { 0x3ffffe7, 26 }, { 0x7ffffe2, 27 }, { 0xfffff2, 24 },
+    { 0x1fffe4, 21 }, { 0x1fffe5, 21 }, { 0x3ffffe8, 26 }, { 0x3ffffe9, 26 },
+    { 0xffffffd, 28 }, { 0x7ffffe3, 27 }, { 0x7ffffe4, 27 }, { 0x7ffffe5, 27 },
+    { 0xfffec, 20 }, { 0xfffff3, 24 }, { 0xfffed, 20 }, { 0x1fffe6, 21 },
+    { 0x3fffe9, 22 }, { 0x1fffe7, 21 }, { 0x1fffe8, 21 }, { 0x7ffff3, 23 },
+    { 0x3fffea, 22 }, { 0x3fffeb, 22 }, { 0x1ffffee, 25 }, { 0x1ffffef, 25 },
+    { 0xfffff4, 24 }, { 0xfffff5, 24 }, { 0x3ffffea, 26 }, { 0x7ffff4, 23 },
+    { 0x3ffffeb, 26 }, { 0x7ffffe6, 27 }, { 0x3ffffec, 26 }, { 0x3ffffed, 26 },
+    { 0x7ffffe7, 27 }, { 0x7ffffe8, 27 }, { 0x7ffffe9, 27 }, { 0x7ffffea, 27 },
+    { 0x7ffffeb, 27 }, { 0xffffffe, 28 }, { 0x7ffffec, 27 }, { 0x7ffffed, 27 },
+    { 0x7ffffee, 27 }, { 0x7ffffef, 27 }, { 0x7fffff0, 27 }, { 0x3ffffee, 26 },
+    { 0x3fffffff, 30 },
+} };
+
+static constexpr u8 maximum_huffman_code_length = 30;
+
+// The code is canonical, so all codes of one length are consecutive numbers, given to the symbols in ascending order.
+// That makes a code easy to look up once its length is known, without needing a tree to walk.
+struct HuffmanDecodingTables {
+    Array<u32, maximum_huffman_code_length + 1> first_code {};
+    Array<u16, maximum_huffman_code_length + 1> first_symbol_index {};
+    Array<u16, maximum_huffman_code_length + 1> code_count {};
+    Array<u16, huffman_codes.size()> symbols_by_code {};
+};
+
+static constexpr HuffmanDecodingTables make_huffman_decoding_tables()
+{
+    HuffmanDecodingTables tables;
+    for (auto const& code : huffman_codes)
+        ++tables.code_count[code.length];
+
+    u32 next_code = 0;
+    u16 next_symbol_index = 0;
+    for (size_t length = 1; length <= maximum_huffman_code_length; ++length) {
+        tables.first_code[length] = next_code;
+        tables.first_symbol_index[length] = next_symbol_index;
+        next_code = (next_code + tables.code_count[length]) << 1;
+        next_symbol_index += tables.code_count[length];
+    }
+
+    Array<u16, maximum_huffman_code_length + 1> symbols_placed {};
+    for (u16 symbol = 0; symbol < huffman_codes.size(); ++symbol) {
+        auto length = huffman_codes[symbol].length;
+        tables.symbols_by_code[tables.first_symbol_index[length] + symbols_placed[length]++] = symbol;
+    }
+    return tables;
+}
+
+static constexpr auto huffman_decoding_tables = make_huffman_decoding_tables();
+
+ErrorOr<ByteString> decode_huffman(ReadonlyBytes bytes)
+{
+    StringBuilder builder;
+
+    u32 code = 0;
+    u8 code_length = 0;
+    for (auto byte : bytes) {
+        for (int bit = 7; bit >= 0; --bit) {
+            code = (code << 1) | ((byte >> bit) & 1);
+            ++code_length;
+            if (code_length > maximum_huffman_code_length)
+                return Error::from_string_literal("HPACK: Invalid Huffman code");
+
+            auto offset = code - huffman_decoding_tables.first_code[code_length];
+            if (code < huffman_decoding_tables.first_code[code_length] || offset >= huffman_decoding_tables.code_count[code_length])
+                continue;
+
+            auto symbol = huffman_decoding_tables.symbols_by_code[huffman_decoding_tables.first_symbol_index[code_length] + offset];
+            if (symbol == end_of_string_symbol)
+                return Error::from_string_literal("HPACK: Huffman-encoded string contains EOS");
+            builder.append(static_cast<char>(symbol));
+            code = 0;
+            code_length = 0;
+        }
+    }
+
+    // The string is padded to a whole byte with the most significant bits of the EOS code, which are all ones.
+    if (code_length > 7 || code != (1u << code_length) - 1)
+        return Error::from_string_literal("HPACK: Invalid Huffman padding");
+
+    return builder.to_byte_string();
+}
+
+size_t huffman_encoded_length(StringView string)
+{
+    size_t length_in_bits = 0;
+    for (auto byte : string.bytes())
+        length_in_bits += huffman_codes[byte].length;
+    return (length_in_bits + 7) / 8;
+}
+
+void encode_huffman(ByteBuffer& buffer, StringView string)
+{
+    u64 pending_bits = 0;
+    u8 pending_bit_count = 0;
+    for (auto byte : string.bytes()) {
+        auto const& code = huffman_codes[byte];
+        pending_bits = (pending_bits << code.length) | code.code;
+        pending_bit_count += code.length;
+        while (pending_bit_count >= 8) {
+            pending_bit_count -= 8;
+            buffer.append(static_cast<u8>(pending_bits >> pending_bit_count));
+        }
+    }
+
+    if (pending_bit_count > 0) {
+        auto padding_bit_count = 8 - pending_bit_count;
+        buffer.append(static_cast<u8>((pending_bits << padding_bit_count) | ((1u << padding_bit_count) - 1)));
+    }
+}
+
+void DynamicTable::insert(Header header)
+{
+    auto entry_size = size_of_entry(header);
+
+    // https://www.rfc-editor.org/rfc/rfc7541#section-4.4
+    // "an attempt to add an entry larger than the maximum size causes the table to be emptied of all existing entries
+    //  and results in an empty table."
+    if (entry_size > m_maximum_size) {
+        evict_entries_until_size_is_at_most(0);
+        return;
+    }
+
+    evict_entries_until_size_is_at_most(m_maximum_size - entry_size);
+    m_entries.append(move(header));
+    m_size += entry_size;
+}
+
+void DynamicTable::set_maximum_size(size_t maximum_size)
+{
+    m_maximum_size = maximum_size;
+    evict_entries_until_size_is_at_most(maximum_size);
+}
+
+void DynamicTable::evict_entries_until_size_is_at_most(size_t size)
+{
+    size_t evicted_entry_count = 0;
+    while (m_size > size) {
+        m_size -= size_of_entry(m_entries[evicted_entry_count]);
+        ++evicted_entry_count;
+    }
+    m_entries.remove(0, evicted_entry_count);
+}
+
+// https://www.rfc-editor.org/rfc/rfc7541#section-5.1
+static ErrorOr<u64> decode_integer(ReadonlyBytes bytes, size_t& offset, u8 prefix_length)
+{
+    if (offset >= bytes.size())
+        return Error::from_string_literal("HPACK: Truncated integer");
+
+    u8 const prefix_mask = (1u << prefix_length) - 1;
+    u64 value = bytes[offset++] & prefix_mask;
+    if (value < prefix_mask)
+        return value;
+
+    for (u8 shift = 0;; shift += 7) {
+        if (offset >= bytes.size())
+            return Error::from_string_literal("HPACK: Truncated integer");
+        // Nothing in a header block legitimately needs more than 32 bits.
+        if (shift > 28)
+            return Error::from_string_literal("HPACK: Integer is too large");
+
+        u8 byte = bytes[offset++];
+        value += static_cast<u64>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+}
+
+static void encode_integer(ByteBuffer& buffer, u8 first_byte_flags, u8 prefix_length, u64 value)
+{
+    u8 const prefix_mask = (1u << prefix_length) - 1;
+    if (value < prefix_mask) {
+        buffer.append(first_byte_flags | static_cast<u8>(value));
+        return;
+    }
+
+    buffer.append(first_byte_flags | prefix_mask);
+    value -= prefix_mask;
+    while (value >= 0x80) {
+        buffer.append(static_cast<u8>(value | 0x80));
+        value >>= 7;
+    }
+    buffer.append(static_cast<u8>(value));
+}
+
+// https://www.rfc-editor.org/rfc/rfc7541#section-5.2
+static ErrorOr<ByteString> decode_string(ReadonlyBytes bytes, size_t& offset)
+{
+    if (offset >= bytes.size())
+        return Error::from_string_literal("HPACK: Truncated string");
+
+    bool is_huffman_encoded = bytes[offset] & 0x80;
+    auto length = TRY(decode_integer(bytes, offset, 7));
+    if (length > bytes.size() - offset)
+        return Error::from_string_literal("HPACK: Truncated string");
+
+    auto string_bytes = bytes.slice(offset, length);
+    offset += length;
+
+    if (is_huffman_encoded)
+        return decode_huffman(string_bytes);
+    return ByteString { string_bytes };
+}
+
+static void encode_string(ByteBuffer& buffer, StringView string)
+{
+    auto huffman_length = huffman_encoded_length(string);
+    if (huffman_length < string.length()) {
+        encode_integer(buffer, 0x80, 7, huffman_length);
+        encode_huffman(buffer, string);
+        return;
+    }
+
+    encode_integer(buffer, 0, 7, string.length());
+    buffer.append(string.bytes());
+}
+
+Decoder::Decoder(size_t maximum_dynamic_table_size)
+    : m_dynamic_table_size_limit(maximum_dynamic_table_size)
+    , m_dynamic_table(maximum_dynamic_table_size)
+{
+}
+
+void Decoder::set_maximum_dynamic_table_size_limit(size_t limit)
+{
+    m_dynamic_table_size_limit = limit;
+    if (m_dynamic_table.maximum_size() > limit)
+        m_dynamic_table.set_maximum_size(limit);
+}
+
+// https://www.rfc-editor.org/rfc/rfc7541#section-2.3.3
+ErrorOr<Header> Decoder::header_at(u64 index) const
+{
+    if (index == 0)
+        return Error::from_string_literal("HPACK: Index 0 is not valid");
+
+    if (index <= static_table.size()) {
+        auto const& entry = static_table[index - 1];
+        return Header { entry.name, entry.value };
+    }
+
+    index -= static_table.size() + 1;
+    if (index >= m_dynamic_table.entry_count())
+        return Error::from_string_literal("HPACK: Index is out of bounds");
+    return m_dynamic_table.at(index);
+}
+
+// https://www.rfc-editor.org/rfc/rfc7541#section-6
+ErrorOr<Vector<Header>> Decoder::decode(ReadonlyBytes header_block)
+{
+    Vector<Header> headers;
+
+    size_t offset = 0;
+    while (offset < header_block.size()) {
+        u8 first_byte = header_block[offset];
+
+        // https://www.rfc-editor.org/rfc/rfc7541#section-6.1
+        if (first_byte & 0x80) {
+            auto index = TRY(decode_integer(header_block, offset, 7));
+            headers.append(TRY(header_at(index)));
+            continue;
+        }
+
+        // https://www.rfc-editor.org/rfc/rfc7541#section-6.3
+        if ((first_byte & 0xe0) == 0x20) {
+            // "This dynamic table size update MUST occur at the beginning of the first header block following the
+            //  change to the dynamic table size."
+            if (!headers.is_empty())
+                return Error::from_string_literal("HPACK: Dynamic table size update after a header field");
+
+            auto maximum_size = TRY(decode_integer(header_block, offset, 5));
+            if (maximum_size > m_dynamic_table_size_limit)
+                return Error::from_string_literal("HPACK: Dynamic table size update exceeds the limit");
+            m_dynamic_table.set_maximum_size(maximum_size);
+            continue;
+        }
+
+        // https://www.rfc-editor.org/rfc/rfc7541#section-6.2
+        // Literals with incremental indexing have a 6-bit index prefix, and those without indexing or that are never
+        // indexed have a 4-bit prefix.
+        bool with_incremental_indexing = (first_byte & 0xc0) == 0x40;
+        auto name_index = TRY(decode_integer(header_block, offset, with_incremental_indexing ? 6 : 4));
+
+        Header header;
+        if (name_index == 0)
+            header.name = TRY(decode_string(header_block, offset));
+        else
+            header.name = TRY(header_at(name_index)).name;
+        header.value = TRY(decode_string(header_block, offset));
+
+        if (with_incremental_indexing)
+            m_dynamic_table.insert(header);
+        headers.append(move(header));
+    }
+
+    return headers;
+}
+
+Encoder::Encoder(size_t maximum_dynamic_table_size)
+    : m_dynamic_table(maximum_dynamic_table_size)
+{
+}
+
+void Encoder::set_maximum_dynamic_table_size(size_t maximum_size)
+{
+    m_dynamic_table.set_maximum_size(maximum_size);
+
+    // NOTE: If the size went down and back up again since the last header block, the peer still has to learn about
+    //       the smallest size, as that's what evicted entries.
+    if (m_pending_dynamic_table_size_update.has_value())
+        m_pending_dynamic_table_size_update = min(*m_pending_dynamic_table_size_update, maximum_size);
+    else
+        m_pending_dynamic_table_size_update = maximum_size;
+}
+
+ByteBuffer Encoder::encode(ReadonlySpan<Header> headers)
+{
+    ByteBuffer buffer;
+
+    if (m_pending_dynamic_table_size_update.has_value()) {
+        encode_integer(buffer, 0x20, 5, *m_pending_dynamic_table_size_update);
+        if (*m_pending_dynamic_table_size_update != m_dynamic_table.maximum_size())
+            encode_integer(buffer, 0x20, 5, m_dynamic_table.maximum_size());
+        m_pending_dynamic_table_size_update.clear();
+    }
+
+    for (auto const& header : headers)
+        encode_header(buffer, { header.name.to_lowercase(), header.value });
+
+    return buffer;
+}
+
+// https://www.rfc-editor.org/rfc/rfc7541#section-7.1.3
+// Credentials are short enough to be guessed one character at a time by an attacker who can watch the compressed size
+// of the requests, so they are never entered into the table.
+static bool is_sensitive_header(StringView name)
+{
+    return name.is_one_of("authorization"sv, "proxy-authorization"sv);
+}
+
+void Encoder::encode_header(ByteBuffer& buffer, Header const& header)
+{
+    u64 name_index = 0;
+
+    for (size_t i = 0; i < static_table.size(); ++i) {
+        if (static_table[i].name != header.name)
+            continue;
+        if (static_table[i].value == header.value) {
+            encode_integer(buffer, 0x80, 7, i + 1);
+            return;
+        }
+        if (name_index == 0)
+            name_index = i + 1;
+    }
+
+    for (size_t i = 0; i < m_dynamic_table.entry_count(); ++i) {
+        auto const& entry = m_dynamic_table.at(i);
+        if (entry.name != header.name)
+            continue;
+        if (entry.value == header.value) {
+            encode_integer(buffer, 0x80, 7, static_table.size() + 1 + i);
+            return;
+        }
+        if (name_index == 0)
+            name_index = static_table.size() + 1 + i;
+    }
+
+    if (is_sensitive_header(header.name))
+        encode_integer(buffer, 0x10, 4, name_index);
+    else
+        encode_integer(buffer, 0x40, 6, name_index);
+
+    if (name_index == 0)
+        encode_string(buffer, header.name);
+    encode_string(buffer, header.value);
+
+    if (!is_sensitive_header(header.name))
+        m_dynamic_table.insert(header);
+}
+
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/ByteString.h>
+#include <AK/Error.h>
+#include <AK/Optional.h>
+#include <AK/Span.h>
+#include <AK/Vector.h>
+
+// HPACK: Header Compression for HTTP/2, https://www.rfc-editor.org/rfc/rfc7541
+namespace HTTP::HPack {
+
+// https://www.rfc-editor.org/rfc/rfc9113#name-defined-settings, SETTINGS_HEADER_TABLE_SIZE
+static constexpr size_t default_dynamic_table_size = 4096;
+
+struct Header {
+    ByteString name;
+    ByteString value;
+
+    bool operator==(Header const&) const = default;
+};
+
+// https://www.rfc-editor.org/rfc/rfc7541#section-2.3.2
+// Both ends of a connection keep one of these per direction, and update it in lockstep.
+class DynamicTable {
+public:
+    explicit DynamicTable(size_t maximum_size)
+        : m_maximum_size(maximum_size)
+    {
+    }
+
+    size_t size() const { return m_size; }
+    size_t maximum_size() const { return m_maximum_size; }
+    size_t entry_count() const { return m_entries.size(); }
+
+    // Index 0 is the most recently inserted entry.
+    Header const& at(size_t index) const { return m_entries[m_entries.size() - 1 - index]; }
+
+    void insert(Header);
+    void set_maximum_size(size_t);
+
+    // https://www.rfc-editor.org/rfc/rfc7541#section-4.1
+    static size_t size_of_entry(Header const& header) { return header.name.length() + header.value.length() + 32; }
+
+private:
+    void evict_entries_until_size_is_at_most(size_t);
+
+    // Oldest first, so inserting doesn't shift the whole table.
+    Vector<Header> m_entries;
+    size_t m_size { 0 };
+    size_t m_maximum_size { 0 };
+};
+
+class Decoder {
+public:
+    explicit Decoder(size_t maximum_dynamic_table_size = default_dynamic_table_size);
+
+    // Sets the largest dynamic table the peer is allowed to make us keep, i.e. what we advertised to it with
+    // SETTINGS_HEADER_TABLE_SIZE.
+    void set_maximum_dynamic_table_size_limit(size_t);
+
+    // Decodes one complete header block. An error here is a connection error of type COMPRESSION_ERROR, as the dynamic
+    // table can't be trusted to be in sync with the peer's anymore.
+    ErrorOr<Vector<Header>> decode(ReadonlyBytes header_block);
+
+    DynamicTable const& dynamic_table() const { return m_dynamic_table; }
+
+private:
+    ErrorOr<Header> header_at(u64 index) const;
+
+    size_t m_dynamic_table_size_limit { 0 };
+    DynamicTable m_dynamic_table;
+};
+
+class Encoder {
+public:
+    explicit Encoder(size_t maximum_dynamic_table_size = default_dynamic_table_size);
+
+    // Applies a SETTINGS_HEADER_TABLE_SIZE received from the peer. The change is signalled at the start of the next
+    // header block.
+    void set_maximum_dynamic_table_size(size_t);
+
+    // Header names are sent in lowercase, as HTTP/2 requires.
+    ByteBuffer encode(ReadonlySpan<Header>);
+
+    DynamicTable const& dynamic_table() const { return m_dynamic_table; }
+
+private:
+    void encode_header(ByteBuffer&, Header const&);
+
+    DynamicTable m_dynamic_table;
+    Optional<size_t> m_pending_dynamic_table_size_update;
+};
+
+// https://www.rfc-editor.org/rfc/rfc7541#section-5.2
+ErrorOr<ByteString> decode_huffman(ReadonlyBytes);
+void encode_huffman(ByteBuffer&, StringView);
+size_t huffman_encoded_length(StringView);
+
+}
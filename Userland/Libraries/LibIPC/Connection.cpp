@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ScopeGuard.h>
 #include <LibCore/System.h>
 #include <LibIPC/Connection.h>
 #include <LibIPC/File.h>
@@ -48,6 +49,37 @@ ErrorOr<void> ConnectionBase::post_message(MessageBuffer buffer)
     if (!m_socket->is_open())
         return Error::from_string_literal("Trying to post_message during IPC shutdown");
 
+    ++m_statistics.messages_sent;
+    m_statistics.bytes_sent += buffer.message_bytes().size();
+
+    if (buffer.message_bytes().size() >= SharedBufferPool::message_size_threshold) {
+        auto result = m_shared_buffer_pool.try_move_into_shared_buffer(buffer);
+        if (result.is_error())
+            dbgln("IPC::ConnectionBase ({:p}) couldn't use a shared buffer ({}), sending through the socket", this, result.error());
+        else if (result.value())
+            ++m_statistics.messages_sent_through_shared_buffers;
+    }
+
+    if (m_batch_depth == 0)
+        return transfer_message(buffer);
+
+    if (!m_batched_messages.has_value()) {
+        m_batched_messages = move(buffer);
+    } else if (auto result = m_batched_messages->append_message(move(buffer)); result.is_error()) {
+        shutdown_with_error(result.error());
+        return result.release_error();
+    }
+
+    // NOTE: Holding back more than this doesn't save anything, and would only delay the messages.
+    static constexpr size_t maximum_batch_size = 64 * KiB;
+    if (m_batched_messages->total_size() >= maximum_batch_size)
+        return flush_batched_messages();
+    return {};
+}
+
+ErrorOr<void> ConnectionBase::transfer_message(MessageBuffer& buffer)
+{
+    ++m_statistics.writes;
     if (auto result = buffer.transfer_message(*m_socket); result.is_error()) {
         shutdown_with_error(result.error());
         return result.release_error();
@@ -57,12 +89,55 @@ ErrorOr<void> ConnectionBase::post_message(MessageBuffer buffer)
     return {};
 }
 
+ErrorOr<void> ConnectionBase::end_batch()
+{
+    VERIFY(m_batch_depth > 0);
+    if (--m_batch_depth > 0)
+        return {};
+    return flush_batched_messages();
+}
+
+ErrorOr<void> ConnectionBase::flush_batched_messages()
+{
+    if (!m_batched_messages.has_value())
+        return {};
+
+    auto batch = m_batched_messages.release_value();
+    if (!m_socket->is_open())
+        return Error::from_string_literal("Trying to flush batched messages during IPC shutdown");
+    return transfer_message(batch);
+}
+
 void ConnectionBase::shutdown()
 {
+    m_batched_messages.clear();
     m_socket->close();
+
+    auto expected_responses = move(m_expected_responses);
+    for (auto& expected_response : expected_responses)
+        expected_response.handler(Error::from_string_literal("IPC peer disconnected before responding"));
+
     die();
 }
 
+void ConnectionBase::expect_response(u32 endpoint_magic, int message_id, ResponseHandler handler)
+{
+    m_expected_responses.append({ endpoint_magic, message_id, move(handler) });
+}
+
+bool ConnectionBase::try_handle_expected_response(NonnullOwnPtr<Message>& message)
+{
+    auto index = m_expected_responses.find_first_index_if([&](auto& expected_response) {
+        return expected_response.endpoint_magic == message->endpoint_magic() && expected_response.message_id == message->message_id();
+    });
+    if (!index.has_value())
+        return false;
+
+    auto expected_response = m_expected_responses.take(*index);
+    expected_response.handler(move(message));
+    return true;
+}
+
 void ConnectionBase::shutdown_with_error(Error const& error)
 {
     dbgln("IPC::ConnectionBase ({:p}) had an error ({}), disconnecting.", this, error);
@@ -72,18 +147,29 @@ void ConnectionBase::shutdown_with_error(Error const& error)
 void ConnectionBase::handle_messages()
 {
     auto messages = move(m_unprocessed_messages);
+    ScopeGuard reuse_capacity = [&] {
+        // NOTE: A handler may have spun a nested event loop that received more messages in the meantime.
+        if (!m_unprocessed_messages.is_empty())
+            return;
+        messages.clear_with_capacity();
+        m_unprocessed_messages = move(messages);
+    };
+
     for (auto& message : messages) {
-        if (message->endpoint_magic() == m_local_endpoint_magic) {
-            auto handler_result = m_local_stub.handle(*message);
-            if (handler_result.is_error()) {
-                dbgln("IPC::ConnectionBase::handle_messages: {}", handler_result.error());
-                continue;
-            }
+        if (message->endpoint_magic() != m_local_endpoint_magic) {
+            (void)try_handle_expected_response(message);
+            continue;
+        }
+
+        auto handler_result = m_local_stub.handle(*message);
+        if (handler_result.is_error()) {
+            dbgln("IPC::ConnectionBase::handle_messages: {}", handler_result.error());
+            continue;
+        }
 
-            if (auto response = handler_result.release_value()) {
-                if (auto post_result = post_message(*response); post_result.is_error()) {
-                    dbgln("IPC::ConnectionBase::handle_messages: {}", post_result.error());
-                }
+        if (auto response = handler_result.release_value()) {
+            if (auto post_result = post_message(*response); post_result.is_error()) {
+                dbgln("IPC::ConnectionBase::handle_messages: {}", post_result.error());
             }
         }
     }
@@ -110,7 +196,10 @@ ErrorOr<Vector<u8>> ConnectionBase::read_as_much_as_possible_from_socket_without
         m_unprocessed_bytes.clear();
     }
 
-    u8 buffer[4096];
+    // NOTE: Large reads mean fewer of them for large messages, the buffer is kept around for the next time.
+    static constexpr size_t receive_buffer_size = 64 * KiB;
+    if (m_receive_buffer.is_empty())
+        m_receive_buffer = TRY(ByteBuffer::create_uninitialized(receive_buffer_size));
     Vector<int> received_fds;
 
     bool should_shut_down = false;
@@ -122,7 +211,8 @@ ErrorOr<Vector<u8>> ConnectionBase::read_as_much_as_possible_from_socket_without
     };
 
     while (m_socket->is_open()) {
-        auto maybe_bytes_read = m_socket->receive_message({ buffer, 4096 }, MSG_DONTWAIT, received_fds);
+        auto maybe_bytes_read = m_socket->receive_message(m_receive_buffer.bytes(), MSG_DONTWAIT, received_fds);
+        ++m_statistics.reads;
         if (maybe_bytes_read.is_error()) {
             auto error = maybe_bytes_read.release_error();
             if (error.is_syscall() && error.code() == EAGAIN) {
@@ -189,15 +279,30 @@ ErrorOr<void> ConnectionBase::drain_messages_from_peer()
 
 OwnPtr<IPC::Message> ConnectionBase::wait_for_specific_endpoint_message_impl(u32 endpoint_magic, int message_id)
 {
+    // The peer can't respond to what it hasn't received yet.
+    if (auto result = flush_batched_messages(); result.is_error())
+        dbgln("IPC::ConnectionBase::wait_for_specific_endpoint_message_impl: {}", result.error());
+
+    // Responses of the same kind that are owed to asynchronous requests sent before this one come first.
+    size_t responses_to_skip = 0;
+    for (auto& expected_response : m_expected_responses) {
+        if (expected_response.endpoint_magic == endpoint_magic && expected_response.message_id == message_id)
+            ++responses_to_skip;
+    }
+
     for (;;) {
         // Double check we don't already have the event waiting for us.
         // Otherwise we might end up blocked for a while for no reason.
+        size_t skipped_responses = 0;
         for (size_t i = 0; i < m_unprocessed_messages.size(); ++i) {
             auto& message = m_unprocessed_messages[i];
             if (message->endpoint_magic() != endpoint_magic)
                 continue;
-            if (message->message_id() == message_id)
-                return m_unprocessed_messages.take(i);
+            if (message->message_id() != message_id)
+                continue;
+            if (skipped_responses++ < responses_to_skip)
+                continue;
+            return m_unprocessed_messages.take(i);
         }
 
         if (!m_socket->is_open())
@@ -9,15 +9,18 @@
 
 #include <AK/ByteBuffer.h>
 #include <AK/Queue.h>
+#include <AK/ScopeGuard.h>
 #include <AK/Try.h>
 #include <LibCore/Event.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/Notifier.h>
+#include <LibCore/Promise.h>
 #include <LibCore/Socket.h>
 #include <LibCore/Timer.h>
 #include <LibIPC/File.h>
 #include <LibIPC/Forward.h>
 #include <LibIPC/Message.h>
+#include <LibIPC/SharedBufferPool.h>
 #include <errno.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -46,6 +49,24 @@ public:
     bool is_open() const { return m_socket->is_open(); }
     ErrorOr<void> post_message(Message const&);
 
+    // Messages that are posted while a batch is open are held back, and written to the socket together once the
+    // outermost batch is closed, a synchronous message is waited for, or enough of them have piled up.
+    // NOTE: Batches are only meant to be opened on the thread that the connection belongs to.
+    void begin_batch() { ++m_batch_depth; }
+    ErrorOr<void> end_batch();
+    ErrorOr<void> flush_batched_messages();
+
+    struct Statistics {
+        u64 messages_sent { 0 };
+        u64 bytes_sent { 0 };
+        u64 messages_sent_through_shared_buffers { 0 };
+        u64 writes { 0 };
+        u64 messages_received { 0 };
+        u64 bytes_received { 0 };
+        u64 reads { 0 };
+    };
+    Statistics const& statistics() const { return m_statistics; }
+
     void shutdown();
     virtual void die() { }
 
@@ -59,12 +80,17 @@ protected:
     virtual void try_parse_messages(Vector<u8> const& bytes, size_t& index) = 0;
     virtual void shutdown_with_error(Error const&);
 
+    using ResponseHandler = Function<void(ErrorOr<NonnullOwnPtr<Message>>)>;
+    void expect_response(u32 endpoint_magic, int message_id, ResponseHandler);
+    bool try_handle_expected_response(NonnullOwnPtr<Message>&);
+
     OwnPtr<IPC::Message> wait_for_specific_endpoint_message_impl(u32 endpoint_magic, int message_id);
     void wait_for_socket_to_become_readable();
     ErrorOr<Vector<u8>> read_as_much_as_possible_from_socket_without_blocking();
     ErrorOr<void> drain_messages_from_peer();
 
     ErrorOr<void> post_message(MessageBuffer);
+    ErrorOr<void> transfer_message(MessageBuffer&);
     void handle_messages();
 
     IPC::Stub& m_local_stub;
@@ -76,6 +102,22 @@ protected:
     Vector<NonnullOwnPtr<Message>> m_unprocessed_messages;
     Queue<IPC::File> m_unprocessed_fds;
     ByteBuffer m_unprocessed_bytes;
+    ByteBuffer m_receive_buffer;
+
+    SharedBufferPool m_shared_buffer_pool;
+
+    Optional<MessageBuffer> m_batched_messages;
+    size_t m_batch_depth { 0 };
+
+    Statistics m_statistics;
+
+    struct ExpectedResponse {
+        u32 endpoint_magic { 0 };
+        int message_id { 0 };
+        ResponseHandler handler;
+    };
+    // NOTE: The peer handles requests in the order they were sent in, so this is also the order their responses arrive in.
+    Vector<ExpectedResponse> m_expected_responses;
 
     u32 m_local_endpoint_magic { 0 };
 
@@ -119,6 +161,27 @@ public:
         return wait_for_specific_endpoint_message<typename RequestType::ResponseType, PeerEndpoint>();
     }
 
+    // Sends a synchronous message without blocking, the returned promise is resolved once the response arrives.
+    // This allows many requests to be in flight on the same connection at once.
+    template<typename RequestType, typename... Args>
+    NonnullRefPtr<Core::Promise<NonnullOwnPtr<typename RequestType::ResponseType>>> send_async(Args&&... args)
+    {
+        using ResponseType = typename RequestType::ResponseType;
+        auto promise = Core::Promise<NonnullOwnPtr<ResponseType>>::construct();
+        if (auto result = post_message(RequestType(forward<Args>(args)...)); result.is_error()) {
+            promise->reject(result.release_error());
+            return promise;
+        }
+
+        expect_response(PeerEndpoint::static_magic(), ResponseType::static_message_id(), [promise](ErrorOr<NonnullOwnPtr<Message>> response) {
+            if (response.is_error())
+                promise->reject(response.release_error());
+            else
+                promise->resolve(response.release_value().template release_nonnull<ResponseType>());
+        });
+        return promise;
+    }
+
 protected:
     template<typename MessageType, typename Endpoint>
     OwnPtr<MessageType> wait_for_specific_endpoint_message()
@@ -133,10 +196,34 @@ protected:
         u32 message_size = 0;
         for (; index + sizeof(message_size) < bytes.size(); index += message_size) {
             memcpy(&message_size, bytes.data() + index, sizeof(message_size));
+            bool is_descriptor = message_size & SharedBufferPool::descriptor_flag;
+            message_size &= ~SharedBufferPool::descriptor_flag;
             if (message_size == 0 || bytes.size() - index - sizeof(uint32_t) < message_size)
                 break;
             index += sizeof(message_size);
             auto remaining_bytes = ReadonlyBytes { bytes.data() + index, message_size };
+            ++m_statistics.messages_received;
+
+            SharedBufferPool::Descriptor descriptor;
+            if (is_descriptor) {
+                if (message_size != sizeof(descriptor)) {
+                    dbgln("Received a shared buffer descriptor of the wrong size");
+                    break;
+                }
+                memcpy(&descriptor, remaining_bytes.data(), sizeof(descriptor));
+                auto shared_bytes = m_shared_buffer_pool.receive(descriptor, m_unprocessed_fds);
+                if (shared_bytes.is_error()) {
+                    dbgln("Failed to receive a message through a shared buffer: {}", shared_bytes.error());
+                    break;
+                }
+                remaining_bytes = shared_bytes.release_value();
+            }
+            m_statistics.bytes_received += remaining_bytes.size();
+            // NOTE: Decoded messages don't refer to the bytes they were decoded from, the buffer can be reused right away.
+            ScopeGuard release_shared_buffer = [&] {
+                if (is_descriptor)
+                    m_shared_buffer_pool.release(descriptor);
+            };
 
             auto local_message = LocalEndpoint::decode_message(remaining_bytes, m_unprocessed_fds);
             if (!local_message.is_error()) {
@@ -158,6 +245,28 @@ protected:
     }
 };
 
+// Holds back the messages posted to the connection until it goes out of scope, see ConnectionBase::begin_batch().
+class MessageBatch {
+    AK_MAKE_NONCOPYABLE(MessageBatch);
+    AK_MAKE_NONMOVABLE(MessageBatch);
+
+public:
+    explicit MessageBatch(ConnectionBase& connection)
+        : m_connection(connection)
+    {
+        m_connection->begin_batch();
+    }
+
+    ~MessageBatch()
+    {
+        if (auto result = m_connection->end_batch(); result.is_error())
+            dbgln("IPC::MessageBatch: {}", result.error());
+    }
+
+private:
+    NonnullRefPtr<ConnectionBase> m_connection;
+};
+
 }
 
 template<typename LocalEndpoint, typename PeerEndpoint>
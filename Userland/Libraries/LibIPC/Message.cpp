@@ -37,16 +37,57 @@ ErrorOr<void> MessageBuffer::append_file_descriptor(int fd)
     return {};
 }
 
-ErrorOr<void> MessageBuffer::transfer_message(Core::LocalSocket& socket)
+ErrorOr<void> MessageBuffer::append_message(MessageBuffer&& other)
+{
+    TRY(finalize_size_of_last_message());
+    TRY(other.finalize_size_of_last_message());
+
+    auto offset = m_data.size();
+    TRY(m_data.try_append(other.m_data.data(), other.m_data.size()));
+    TRY(m_fds.try_extend(move(other.m_fds)));
+    m_last_message_offset = offset + other.m_last_message_offset;
+    m_is_descriptor = other.m_is_descriptor;
+    m_message_count += other.m_message_count;
+    return {};
+}
+
+ReadonlyBytes MessageBuffer::message_bytes() const
 {
-    Checked<MessageSizeType> checked_message_size { m_data.size() };
+    return m_data.span().slice(m_last_message_offset + sizeof(MessageSizeType));
+}
+
+ErrorOr<void> MessageBuffer::finalize_size_of_last_message()
+{
+    Checked<MessageSizeType> checked_message_size { m_data.size() - m_last_message_offset };
     checked_message_size -= sizeof(MessageSizeType);
 
-    if (checked_message_size.has_overflow())
+    if (checked_message_size.has_overflow() || (checked_message_size.value() & SharedBufferPool::descriptor_flag))
         return Error::from_string_literal("Message is too large for IPC encoding");
 
-    MessageSizeType const message_size = checked_message_size.value();
-    m_data.span().overwrite(0, reinterpret_cast<u8 const*>(&message_size), sizeof(message_size));
+    MessageSizeType message_size = checked_message_size.value();
+    if (m_is_descriptor)
+        message_size |= SharedBufferPool::descriptor_flag;
+    m_data.span().overwrite(m_last_message_offset, reinterpret_cast<u8 const*>(&message_size), sizeof(message_size));
+    return {};
+}
+
+ErrorOr<void> MessageBuffer::replace_with_descriptor(SharedBufferPool::Descriptor const& descriptor, int new_buffer_fd)
+{
+    if (new_buffer_fd != -1) {
+        // NOTE: The peer needs the buffer before it can get to the file descriptors of the message itself.
+        auto auto_fd = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) AutoCloseFileDescriptor(new_buffer_fd)));
+        TRY(m_fds.try_prepend(move(auto_fd)));
+    }
+
+    m_data.resize(m_last_message_offset + sizeof(MessageSizeType));
+    TRY(append_data(reinterpret_cast<u8 const*>(&descriptor), sizeof(descriptor)));
+    m_is_descriptor = true;
+    return {};
+}
+
+ErrorOr<void> MessageBuffer::transfer_message(Core::LocalSocket& socket)
+{
+    TRY(finalize_size_of_last_message());
 
     auto raw_fds = Vector<int, 1> {};
     auto num_fds_to_transfer = m_fds.size();
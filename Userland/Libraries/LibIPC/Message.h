@@ -12,6 +12,7 @@
 #include <AK/RefPtr.h>
 #include <AK/Vector.h>
 #include <LibCore/Forward.h>
+#include <LibIPC/SharedBufferPool.h>
 #include <unistd.h>
 
 namespace IPC {
@@ -44,11 +45,28 @@ public:
 
     ErrorOr<void> append_file_descriptor(int fd);
 
+    // Appends another encoded message, so that both are transferred with the same write.
+    ErrorOr<void> append_message(MessageBuffer&&);
+
     ErrorOr<void> transfer_message(Core::LocalSocket& socket);
 
+    // The last encoded message, without the size that precedes it on the socket.
+    ReadonlyBytes message_bytes() const;
+
+    size_t message_count() const { return m_message_count; }
+    size_t total_size() const { return m_data.size(); }
+
 private:
+    friend class SharedBufferPool;
+    ErrorOr<void> replace_with_descriptor(SharedBufferPool::Descriptor const&, int new_buffer_fd);
+
+    ErrorOr<void> finalize_size_of_last_message();
+
     Vector<u8, 1024> m_data;
     Vector<NonnullRefPtr<AutoCloseFileDescriptor>, 1> m_fds;
+    size_t m_last_message_offset { 0 };
+    size_t m_message_count { 1 };
+    bool m_is_descriptor { false };
 };
 
 enum class ErrorCode : u32 {
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/IntegralMath.h>
+#include <LibIPC/Message.h>
+#include <LibIPC/SharedBufferPool.h>
+
+namespace IPC {
+
+ErrorOr<bool> SharedBufferPool::try_move_into_shared_buffer(MessageBuffer& message)
+{
+    auto bytes = message.message_bytes();
+    if (bytes.size() > NumericLimits<u32>::max())
+        return false;
+
+    auto needed_size = bytes.size() + header_size;
+    auto is_free = [&](auto& buffer) {
+        return buffer.is_valid() && AK::atomic_load(in_use_flag(buffer), AK::MemoryOrder::memory_order_acquire) == 0;
+    };
+
+    // Prefer a buffer that the peer already has, and otherwise replace one that is too small (or missing).
+    Optional<size_t> slot;
+    for (size_t i = 0; i < slot_count; ++i) {
+        if (is_free(m_sending_buffers[i]) && m_sending_buffers[i].size() >= needed_size) {
+            slot = i;
+            break;
+        }
+    }
+
+    Descriptor descriptor;
+    if (!slot.has_value()) {
+        for (size_t i = 0; i < slot_count; ++i) {
+            if (!m_sending_buffers[i].is_valid() || is_free(m_sending_buffers[i])) {
+                slot = i;
+                break;
+            }
+        }
+        if (!slot.has_value())
+            return false;
+
+        auto buffer_size = max(static_cast<size_t>(1) << AK::ceil_log2(needed_size), minimum_buffer_size);
+        if (buffer_size > NumericLimits<u32>::max())
+            return false;
+        m_sending_buffers[*slot] = TRY(Core::AnonymousBuffer::create_with_size(buffer_size));
+        descriptor.new_buffer_size = buffer_size;
+    }
+
+    auto& buffer = m_sending_buffers[*slot];
+    AK::atomic_store(in_use_flag(buffer), 1u, AK::MemoryOrder::memory_order_relaxed);
+    memcpy(buffer.data<u8>() + header_size, bytes.data(), bytes.size());
+
+    descriptor.slot = *slot;
+    descriptor.message_size = bytes.size();
+
+    auto new_buffer_fd = descriptor.new_buffer_size ? TRY(Core::System::dup(buffer.fd())) : -1;
+    TRY(message.replace_with_descriptor(descriptor, new_buffer_fd));
+    return true;
+}
+
+ErrorOr<ReadonlyBytes> SharedBufferPool::receive(Descriptor const& descriptor, Queue<File>& files)
+{
+    if (descriptor.slot >= slot_count)
+        return Error::from_string_literal("Shared buffer message refers to an invalid slot");
+
+    auto& buffer = m_received_buffers[descriptor.slot];
+    if (descriptor.new_buffer_size) {
+        if (files.is_empty())
+            return Error::from_string_literal("Shared buffer message is missing its file descriptor");
+        if (descriptor.new_buffer_size < header_size)
+            return Error::from_string_literal("Shared buffer is too small");
+        auto file = files.dequeue();
+        buffer = TRY(Core::AnonymousBuffer::create_from_anon_fd(file.take_fd(), descriptor.new_buffer_size));
+    }
+
+    if (!buffer.is_valid())
+        return Error::from_string_literal("Shared buffer message refers to a slot that was never sent");
+    if (descriptor.message_size > buffer.size() - header_size)
+        return Error::from_string_literal("Shared buffer message is larger than its buffer");
+    return ReadonlyBytes { buffer.data<u8>() + header_size, descriptor.message_size };
+}
+
+void SharedBufferPool::release(Descriptor const& descriptor)
+{
+    if (descriptor.slot >= slot_count)
+        return;
+    auto& buffer = m_received_buffers[descriptor.slot];
+    if (buffer.is_valid())
+        AK::atomic_store(in_use_flag(buffer), 0u, AK::MemoryOrder::memory_order_release);
+}
+
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Error.h>
+#include <AK/Queue.h>
+#include <LibCore/AnonymousBuffer.h>
+#include <LibIPC/File.h>
+
+namespace IPC {
+
+class MessageBuffer;
+
+// Large messages aren't written through the socket (and copied by the kernel on both ends), but into a shared memory
+// buffer, and only a descriptor of where to find them goes through the socket instead. Each side of a connection
+// sends from a few buffers of its own. The peer is sent the file descriptor of a buffer once, and keeps the buffer
+// mapped from then on. A buffer is marked as in use until the peer has decoded the message in it, after which it is
+// reused for the next large message.
+class SharedBufferPool {
+    AK_MAKE_NONCOPYABLE(SharedBufferPool);
+    AK_MAKE_NONMOVABLE(SharedBufferPool);
+
+public:
+    // Messages at least this large are sent through a shared buffer.
+    static constexpr size_t message_size_threshold = 64 * KiB;
+    // Set in the size that precedes a message on the socket if what follows is a Descriptor instead of the message.
+    static constexpr u32 descriptor_flag = 1u << 31;
+
+    struct [[gnu::packed]] Descriptor {
+        u32 slot { 0 };
+        u32 message_size { 0 };
+        // If not zero, the file descriptor of a new buffer of this size for the slot precedes those of the message.
+        u32 new_buffer_size { 0 };
+    };
+
+    SharedBufferPool() = default;
+
+    // Moves the message into a buffer that isn't in use. Returns false if there is none, in which case the message
+    // has to go through the socket after all.
+    ErrorOr<bool> try_move_into_shared_buffer(MessageBuffer&);
+
+    // Returns the message that the descriptor refers to, which stays valid until it is released.
+    ErrorOr<ReadonlyBytes> receive(Descriptor const&, Queue<File>&);
+    void release(Descriptor const&);
+
+private:
+    static constexpr size_t slot_count = 4;
+    // The first cache line of a buffer holds whether it is in use, the message comes after that.
+    static constexpr size_t header_size = 64;
+    static constexpr size_t minimum_buffer_size = 256 * KiB;
+
+    static u32* in_use_flag(Core::AnonymousBuffer& buffer) { return buffer.data<u32>(); }
+
+    Array<Core::AnonymousBuffer, slot_count> m_sending_buffers;
+    Array<Core::AnonymousBuffer, slot_count> m_received_buffers;
+};
+
+}
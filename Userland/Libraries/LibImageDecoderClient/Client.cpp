@@ -48,14 +48,15 @@ NonnullRefPtr<Core::Promise<DecodedImage>> Client::decode_image(ReadonlyBytes en
 
     memcpy(encoded_buffer.data<void>(), encoded_data.data(), encoded_data.size());
 
-    auto response = send_sync_but_allow_failure<Messages::ImageDecoderServer::DecodeImage>(move(encoded_buffer), ideal_size, mime_type);
-    if (!response) {
-        dbgln("ImageDecoder disconnected trying to decode image");
-        promise->reject(Error::from_string_literal("ImageDecoder disconnected"));
-        return promise;
-    }
-
-    m_pending_decoded_images.set(response->image_id(), promise);
+    // NOTE: The image ID arrives before the decoded image, so there's no need to block until we know it.
+    request_decode_image(move(encoded_buffer), ideal_size, mime_type)
+        ->when_resolved([this, promise](i64 image_id) {
+            m_pending_decoded_images.set(image_id, promise);
+        })
+        .when_rejected([promise](Error&) {
+            dbgln("ImageDecoder disconnected trying to decode image");
+            promise->reject(Error::from_string_literal("ImageDecoder disconnected"));
+        });
 
     return promise;
 }
@@ -37,4 +37,35 @@ void BasicBlock::grow(size_t additional_size)
     m_buffer.resize(m_buffer.size() + additional_size);
 }
 
+void BasicBlock::replace_instructions(Badge<Optimizer>, Vector<u8> buffer, HashMap<size_t, SourceRecord> source_map, size_t last_instruction_start_offset)
+{
+    // NOTE: The instructions that are still around have been moved into the new buffer, so they must not be destroyed here.
+    m_buffer = move(buffer);
+    m_source_map = move(source_map);
+    m_last_instruction_start_offset = last_instruction_start_offset;
+}
+
+void BasicBlock::absorb(Badge<Optimizer>, BasicBlock& successor)
+{
+    VERIFY(m_terminated);
+    auto& jump = *reinterpret_cast<Instruction*>(m_buffer.data() + m_last_instruction_start_offset);
+    VERIFY(jump.type() == Instruction::Type::Jump);
+    Instruction::destroy(jump);
+
+    auto offset = m_last_instruction_start_offset;
+    m_buffer.resize_and_keep_capacity(offset);
+    m_source_map.remove(offset);
+
+    m_buffer.append(successor.m_buffer.data(), successor.m_buffer.size());
+    for (auto& [successor_offset, source_record] : successor.m_source_map)
+        m_source_map.set(offset + successor_offset, source_record);
+    m_last_instruction_start_offset = offset + successor.m_last_instruction_start_offset;
+    m_terminated = successor.m_terminated;
+
+    successor.m_buffer.clear();
+    successor.m_source_map.clear();
+    successor.m_last_instruction_start_offset = 0;
+    successor.m_terminated = false;
+}
+
 }
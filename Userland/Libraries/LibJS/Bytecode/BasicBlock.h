@@ -64,6 +64,12 @@ public:
     [[nodiscard]] size_t last_instruction_start_offset() const { return m_last_instruction_start_offset; }
     void set_last_instruction_start_offset(size_t offset) { m_last_instruction_start_offset = offset; }
 
+    void set_index(Badge<Optimizer>, u32 index) { m_index = index; }
+    void replace_instructions(Badge<Optimizer>, Vector<u8> buffer, HashMap<size_t, SourceRecord> source_map, size_t last_instruction_start_offset);
+
+    // Replaces the jump at the end of this block with the instructions of the successor, which is left empty.
+    void absorb(Badge<Optimizer>, BasicBlock& successor);
+
 private:
     explicit BasicBlock(u32 index, String name);
 
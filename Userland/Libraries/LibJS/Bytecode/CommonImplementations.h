@@ -103,6 +103,44 @@ ALWAYS_INLINE ThrowCompletionOr<NonnullGCPtr<Object>> base_object_for_get(VM& vm
     return throw_null_or_undefined_property_access(vm, base_value, base_identifier, property_identifier);
 }
 
+// Returns the value of the property if the cache entry knows where to find it on objects of this shape.
+ALWAYS_INLINE Optional<Value> get_from_property_lookup_cache_entry(PropertyLookupCache::Entry const& entry, Object const& object, Shape const& shape)
+{
+    if (&shape != entry.shape)
+        return {};
+    if (entry.prototype) {
+        // OPTIMIZATION: If the prototype chain hasn't been mutated in a way that would invalidate the cache, we can use it.
+        if (!entry.prototype_chain_validity || !entry.prototype_chain_validity->is_valid())
+            return {};
+        return entry.prototype->get_direct(entry.property_offset.value());
+    }
+    // OPTIMIZATION: If the shape of the object hasn't changed, we can use the cached property offset.
+    return object.get_direct(entry.property_offset.value());
+}
+
+// Picks the entry that a lookup which missed the cache should be remembered in: the one for the same shape if there
+// is one, otherwise an unused one. Once all of them are taken, the site goes megamorphic for good.
+inline PropertyLookupCache::Entry& property_lookup_cache_entry_to_update(Interpreter& interpreter, PropertyLookupCache& cache, MegamorphicPropertyLookupCache& megamorphic_cache, Shape const& shape, DeprecatedFlyString const& property_name)
+{
+    if (!cache.is_megamorphic) {
+        for (auto& entry : cache.entries) {
+            if (&shape == entry.shape)
+                return entry;
+        }
+        for (auto& entry : cache.entries) {
+            if (!entry.shape)
+                return entry;
+        }
+        cache.is_megamorphic = true;
+        cache.entries = {};
+        interpreter.count_property_lookup(&PropertyLookupCacheStatistics::sites_gone_megamorphic);
+    }
+
+    auto& entry = megamorphic_cache.entry_for(shape, property_name);
+    entry.property_name = property_name;
+    return entry;
+}
+
 enum class GetByIdMode {
     Normal,
     Length,
@@ -127,38 +165,37 @@ inline ThrowCompletionOr<Value> get_by_id(VM& vm, Optional<DeprecatedFlyString c
     }
 
     auto& shape = base_obj->shape();
+    auto& interpreter = vm.bytecode_interpreter();
 
-    if (cache.prototype) {
-        // OPTIMIZATION: If the prototype chain hasn't been mutated in a way that would invalidate the cache, we can use it.
-        bool can_use_cache = [&]() -> bool {
-            if (&shape != cache.shape)
-                return false;
-            if (!cache.prototype_chain_validity)
-                return false;
-            if (!cache.prototype_chain_validity->is_valid())
-                return false;
-            return true;
-        }();
-        if (can_use_cache)
-            return cache.prototype->get_direct(cache.property_offset.value());
-    } else if (&shape == cache.shape) {
-        // OPTIMIZATION: If the shape of the object hasn't changed, we can use the cached property offset.
-        return base_obj->get_direct(cache.property_offset.value());
+    if (!cache.is_megamorphic) {
+        for (size_t i = 0; i < cache.entries.size(); ++i) {
+            if (auto value = get_from_property_lookup_cache_entry(cache.entries[i], *base_obj, shape); value.has_value()) {
+                interpreter.count_property_lookup(i == 0 ? &PropertyLookupCacheStatistics::monomorphic_hits : &PropertyLookupCacheStatistics::polymorphic_hits);
+                return value.release_value();
+            }
+        }
+    } else if (auto* entry = interpreter.megamorphic_get_cache().find(shape, property)) {
+        if (auto value = get_from_property_lookup_cache_entry(*entry, *base_obj, shape); value.has_value()) {
+            interpreter.count_property_lookup(&PropertyLookupCacheStatistics::megamorphic_hits);
+            return value.release_value();
+        }
     }
+    interpreter.count_property_lookup(&PropertyLookupCacheStatistics::misses);
 
     CacheablePropertyMetadata cacheable_metadata;
     auto value = TRY(base_obj->internal_get(property, this_value, &cacheable_metadata));
 
-    if (cacheable_metadata.type == CacheablePropertyMetadata::Type::OwnProperty) {
-        cache = {};
-        cache.shape = shape;
-        cache.property_offset = cacheable_metadata.property_offset.value();
-    } else if (cacheable_metadata.type == CacheablePropertyMetadata::Type::InPrototypeChain) {
-        cache = {};
-        cache.shape = &base_obj->shape();
-        cache.property_offset = cacheable_metadata.property_offset.value();
-        cache.prototype = *cacheable_metadata.prototype;
-        cache.prototype_chain_validity = *cacheable_metadata.prototype->shape().prototype_chain_validity();
+    if (cacheable_metadata.type != CacheablePropertyMetadata::Type::NotCacheable) {
+        auto& entry = property_lookup_cache_entry_to_update(interpreter, cache, interpreter.megamorphic_get_cache(), base_obj->shape(), property);
+        entry.shape = base_obj->shape();
+        entry.property_offset = cacheable_metadata.property_offset.value();
+        if (cacheable_metadata.type == CacheablePropertyMetadata::Type::InPrototypeChain) {
+            entry.prototype = *cacheable_metadata.prototype;
+            entry.prototype_chain_validity = *cacheable_metadata.prototype->shape().prototype_chain_validity();
+        } else {
+            entry.prototype = nullptr;
+            entry.prototype_chain_validity = nullptr;
+        }
     }
 
     return value;
@@ -210,6 +247,10 @@ inline ThrowCompletionOr<Value> get_by_value(VM& vm, Optional<DeprecatedFlyStrin
                     return fast_typed_array_get_element<i32>(typed_array, index);
                 case TypedArrayBase::Kind::Uint8ClampedArray:
                     return fast_typed_array_get_element<u8>(typed_array, index);
+                case TypedArrayBase::Kind::Float32Array:
+                    return fast_typed_array_get_element<float>(typed_array, index);
+                case TypedArrayBase::Kind::Float64Array:
+                    return fast_typed_array_get_element<double>(typed_array, index);
                 default:
                     // FIXME: Support more TypedArray kinds.
                     break;
@@ -316,17 +357,40 @@ inline ThrowCompletionOr<void> put_by_property_key(VM& vm, Value base, Value thi
         break;
     }
     case Op::PropertyKind::KeyValue: {
-        if (cache && cache->shape == &object->shape()) {
-            object->put_direct(*cache->property_offset, value);
-            return {};
+        auto& interpreter = vm.bytecode_interpreter();
+        // NOTE: The megamorphic cache is keyed by the property name, so only puts to string keys are cached.
+        if (!name.is_string())
+            cache = nullptr;
+
+        if (cache) {
+            // NOTE: Only own properties make it into the caches of puts, so an entry for the shape is all it takes.
+            auto& shape = object->shape();
+            PropertyLookupCache::Entry const* cached_entry = nullptr;
+            if (!cache->is_megamorphic) {
+                for (size_t i = 0; i < cache->entries.size(); ++i) {
+                    if (&shape == cache->entries[i].shape) {
+                        interpreter.count_property_lookup(i == 0 ? &PropertyLookupCacheStatistics::monomorphic_hits : &PropertyLookupCacheStatistics::polymorphic_hits);
+                        cached_entry = &cache->entries[i];
+                        break;
+                    }
+                }
+            } else if ((cached_entry = interpreter.megamorphic_put_cache().find(shape, name.as_string()))) {
+                interpreter.count_property_lookup(&PropertyLookupCacheStatistics::megamorphic_hits);
+            }
+            if (cached_entry) {
+                object->put_direct(*cached_entry->property_offset, value);
+                return {};
+            }
+            interpreter.count_property_lookup(&PropertyLookupCacheStatistics::misses);
         }
 
         CacheablePropertyMetadata cacheable_metadata;
         bool succeeded = TRY(object->internal_set(name, value, this_value, &cacheable_metadata));
 
         if (succeeded && cache && cacheable_metadata.type == CacheablePropertyMetadata::Type::OwnProperty) {
-            cache->shape = object->shape();
-            cache->property_offset = cacheable_metadata.property_offset.value();
+            auto& entry = property_lookup_cache_entry_to_update(interpreter, *cache, interpreter.megamorphic_put_cache(), object->shape(), name.as_string());
+            entry.shape = object->shape();
+            entry.property_offset = cacheable_metadata.property_offset.value();
         }
 
         if (!succeeded && vm.in_strict_mode()) {
@@ -442,13 +506,10 @@ inline ThrowCompletionOr<void> put_by_value(VM& vm, Value base, Optional<Depreca
         if (storage
             && storage->is_simple_storage()
             && !object.may_interfere_with_indexed_property_access()) {
-            auto maybe_value = storage->get(index);
-            if (maybe_value.has_value()) {
-                auto existing_value = maybe_value->value;
-                if (!existing_value.is_accessor()) {
-                    storage->put(index, value);
-                    return {};
-                }
+            auto& simple_storage = static_cast<SimpleIndexedPropertyStorage&>(*storage);
+            if (simple_storage.inline_has_index(index) && !simple_storage.elements()[index].is_accessor()) {
+                simple_storage.inline_put_existing(index, value);
+                return {};
             }
         }
 
@@ -486,6 +547,17 @@ inline ThrowCompletionOr<void> put_by_value(VM& vm, Value base, Optional<Depreca
                 }
             }
 
+            if (value.is_number() && is_valid_integer_index(typed_array, canonical_index)) {
+                if (typed_array.kind() == TypedArrayBase::Kind::Float32Array) {
+                    fast_typed_array_set_element<float>(typed_array, index, static_cast<float>(value.as_double()));
+                    return {};
+                }
+                if (typed_array.kind() == TypedArrayBase::Kind::Float64Array) {
+                    fast_typed_array_set_element<double>(typed_array, index, value.as_double());
+                    return {};
+                }
+            }
+
             if (typed_array.kind() == TypedArrayBase::Kind::Uint32Array && value.is_integral_number()) {
                 auto integer = value.as_double();
 
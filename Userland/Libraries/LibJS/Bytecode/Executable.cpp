@@ -6,8 +6,11 @@
 
 #include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/ExecutionStatistics.h>
 #include <LibJS/Bytecode/Instruction.h>
 #include <LibJS/Bytecode/RegexTable.h>
+#include <LibJS/JIT/Compiler.h>
+#include <LibJS/JIT/NativeExecutable.h>
 #include <LibJS/SourceCode.h>
 
 namespace JS::Bytecode {
@@ -40,12 +43,25 @@ Executable::Executable(
 
 Executable::~Executable() = default;
 
+JIT::NativeExecutable const* Executable::native_executable_if_hot()
+{
+    if (m_native_executable)
+        return m_native_executable.ptr();
+    if (m_did_try_to_compile_native_executable || ++m_hotness < JIT::Compiler::hotness_threshold)
+        return nullptr;
+
+    m_did_try_to_compile_native_executable = true;
+    m_native_executable = JIT::Compiler::compile(*this);
+    return m_native_executable.ptr();
+}
+
 void Executable::dump() const
 {
     warnln("\033[37;1mJS bytecode executable\033[0m \"{}\"", name);
     InstructionStreamIterator it(bytecode, this);
 
     size_t basic_block_offset_index = 0;
+    size_t instruction_count = 0;
 
     while (!it.at_end()) {
         bool print_basic_block_marker = false;
@@ -66,6 +82,7 @@ void Executable::dump() const
         warnln("{}", builder.string_view());
 
         ++it;
+        ++instruction_count;
     }
 
     if (!exception_handlers.is_empty()) {
@@ -81,6 +98,8 @@ void Executable::dump() const
     }
 
     warnln("");
+    warnln("{} instructions in {} basic blocks", instruction_count, basic_block_start_offsets.size());
+    warnln("");
 }
 
 void Executable::visit_edges(Visitor& visitor)
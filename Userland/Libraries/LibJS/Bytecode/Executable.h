@@ -13,6 +13,7 @@
 #include <AK/WeakPtr.h>
 #include <LibJS/Bytecode/IdentifierTable.h>
 #include <LibJS/Bytecode/Label.h>
+#include <LibJS/Bytecode/PropertyLookupCache.h>
 #include <LibJS/Bytecode/StringTable.h>
 #include <LibJS/Forward.h>
 #include <LibJS/Heap/Cell.h>
@@ -22,14 +23,11 @@
 
 namespace JS::Bytecode {
 
-struct PropertyLookupCache {
+struct ExecutionStatistics;
+
+struct GlobalVariableCache {
     WeakPtr<Shape> shape;
     Optional<u32> property_offset;
-    WeakPtr<Object> prototype;
-    WeakPtr<PrototypeChainValidity> prototype_chain_validity;
-};
-
-struct GlobalVariableCache : public PropertyLookupCache {
     u64 environment_serial_number { 0 };
 };
 
@@ -82,6 +80,9 @@ public:
 
     HashMap<size_t, SourceRecord> source_map;
 
+    // Only there once the interpreter has run this executable while collecting execution statistics.
+    OwnPtr<ExecutionStatistics> execution_statistics;
+
     ByteString const& get_string(StringTableIndex index) const { return string_table->get(index); }
     DeprecatedFlyString const& get_identifier(IdentifierTableIndex index) const { return identifier_table->get(index); }
 
@@ -96,10 +97,19 @@ public:
 
     [[nodiscard]] UnrealizedSourceRange source_range_at(size_t offset) const;
 
+    // Counts calls and loop iterations, and compiles the executable to native code once it has become hot.
+    // Returns null while it isn't hot yet, or if it can't be compiled.
+    [[nodiscard]] JIT::NativeExecutable const* native_executable_if_hot();
+    [[nodiscard]] JIT::NativeExecutable const* native_executable() const { return m_native_executable.ptr(); }
+
     void dump() const;
 
 private:
     virtual void visit_edges(Visitor&) override;
+
+    u32 m_hotness { 0 };
+    bool m_did_try_to_compile_native_executable { false };
+    OwnPtr<JIT::NativeExecutable> m_native_executable;
 };
 
 }
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BinarySearch.h>
+#include <AK/QuickSort.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/ExecutionStatistics.h>
+
+namespace JS::Bytecode {
+
+static constexpr size_t number_of_hot_basic_blocks_to_dump = 10;
+
+static constexpr StringView instruction_type_names[] = {
+#define __BYTECODE_OP(op) #op##sv,
+    ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+};
+
+void ExecutionStatistics::count_instruction(Executable const& executable, Instruction::Type type, size_t program_counter)
+{
+    ++instruction_counts[to_underlying(type)];
+
+    // NOTE: A basic block is entered both by jumping to it and by falling through from the one before it,
+    //       so every instruction has to be checked.
+    if (auto* block = binary_search(executable.basic_block_start_offsets, program_counter))
+        ++basic_block_hits[block - executable.basic_block_start_offsets.data()];
+}
+
+u64 ExecutionStatistics::executed_instructions() const
+{
+    u64 total = 0;
+    for (auto count : instruction_counts)
+        total += count;
+    return total;
+}
+
+void ExecutionStatistics::dump(Executable const& executable) const
+{
+    auto total = executed_instructions();
+    auto percentage = [&](u64 count) { return total ? static_cast<double>(count) * 100 / total : 0.0; };
+    warnln("\033[37;1mExecution statistics for \"{}\"\033[0m ({} instructions):", executable.name, total);
+
+    Vector<size_t> instruction_types;
+    for (size_t i = 0; i < number_of_instruction_types; ++i) {
+        if (instruction_counts[i] != 0)
+            instruction_types.append(i);
+    }
+    quick_sort(instruction_types, [&](auto a, auto b) { return instruction_counts[a] > instruction_counts[b]; });
+    for (auto type : instruction_types)
+        warnln("  {:30} {:>12} ({:.1}%)", instruction_type_names[type], instruction_counts[type], percentage(instruction_counts[type]));
+
+    Vector<size_t> basic_blocks;
+    for (size_t i = 0; i < basic_block_hits.size(); ++i) {
+        if (basic_block_hits[i] != 0)
+            basic_blocks.append(i);
+    }
+    quick_sort(basic_blocks, [&](auto a, auto b) { return basic_block_hits[a] > basic_block_hits[b]; });
+    if (basic_blocks.size() > number_of_hot_basic_blocks_to_dump)
+        basic_blocks.shrink(number_of_hot_basic_blocks_to_dump);
+    warnln("  Hottest basic blocks:");
+    for (auto block : basic_blocks)
+        warnln("    Block {:4} [{:4x}]: {}", block, executable.basic_block_start_offsets[block], basic_block_hits[block]);
+
+    property_lookups.dump();
+}
+
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Vector.h>
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/PropertyLookupCache.h>
+
+namespace JS::Bytecode {
+
+// NOTE: These are only counted while the interpreter collects execution statistics, which is slow, and meant for
+//       finding out what the interpreter spends its time on, and which scripts do something pathological.
+struct ExecutionStatistics {
+    static constexpr size_t number_of_instruction_types = 0
+#define __BYTECODE_OP(op) +1
+        ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+        ;
+
+    explicit ExecutionStatistics(size_t number_of_basic_blocks)
+    {
+        basic_block_hits.resize(number_of_basic_blocks);
+    }
+
+    void count_instruction(Executable const&, Instruction::Type, size_t program_counter);
+
+    u64 executed_instructions() const;
+    void dump(Executable const&) const;
+
+    AK::Array<u64, number_of_instruction_types> instruction_counts {};
+    Vector<u64> basic_block_hits;
+    PropertyLookupCacheStatistics property_lookups;
+};
+
+}
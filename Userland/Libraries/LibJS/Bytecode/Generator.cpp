@@ -10,7 +10,9 @@
 #include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/Generator.h>
 #include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/Optimizer.h>
 #include <LibJS/Bytecode/Register.h>
 #include <LibJS/Runtime/ECMAScriptFunctionObject.h>
 #include <LibJS/Runtime/VM.h>
@@ -241,6 +243,9 @@ CodeGenerationErrorOr<NonnullGCPtr<Executable>> Generator::emit_function_body_by
         }
     }
 
+    if (g_optimize_bytecode)
+        Optimizer::optimize(generator);
+
     bool is_strict_mode = false;
     if (is<Program>(node))
         is_strict_mode = static_cast<Program const&>(node).is_strict_mode();
@@ -342,6 +342,8 @@ public:
     [[nodiscard]] bool must_propagate_completion() const { return m_must_propagate_completion; }
 
 private:
+    friend class Optimizer;
+
     VM& m_vm;
 
     static CodeGenerationErrorOr<NonnullGCPtr<Executable>> emit_function_body_bytecode(VM&, ASTNode const&, FunctionKind, GCPtr<ECMAScriptFunctionObject const>, MustPropagateCompletion = MustPropagateCompletion::Yes);
@@ -6,6 +6,7 @@
 
 #include <AK/Debug.h>
 #include <AK/HashTable.h>
+#include <AK/QuickSort.h>
 #include <AK/TemporaryChange.h>
 #include <LibJS/AST.h>
 #include <LibJS/Bytecode/BasicBlock.h>
@@ -15,6 +16,7 @@
 #include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Bytecode/Label.h>
 #include <LibJS/Bytecode/Op.h>
+#include <LibJS/JIT/NativeExecutable.h>
 #include <LibJS/Runtime/AbstractOperations.h>
 #include <LibJS/Runtime/Array.h>
 #include <LibJS/Runtime/BigInt.h>
@@ -38,6 +40,14 @@
 namespace JS::Bytecode {
 
 bool g_dump_bytecode = false;
+bool g_optimize_bytecode = true;
+
+// NOTE: Processes on SerenityOS can't map executable memory unless they have pledged "prot_exec", so the JIT is opt-in there.
+#ifdef AK_OS_SERENITY
+bool g_jit_enabled = false;
+#else
+bool g_jit_enabled = true;
+#endif
 
 static ByteString format_operand(StringView name, Operand operand, Bytecode::Executable const& executable)
 {
@@ -226,7 +236,10 @@ ThrowCompletionOr<Value> Interpreter::run(Script& script_record, JS::GCPtr<Envir
 
     // 13. If result.[[Type]] is normal, then
     if (result.type() == Completion::Type::Normal) {
-        auto executable_result = JS::Bytecode::Generator::generate_from_ast_node(vm, script, {});
+        // NOTE: A Program that came out of the VM's program cache may have been compiled for an earlier run already.
+        CodeGenerationErrorOr<NonnullGCPtr<Executable>> executable_result = script.bytecode_executable()
+            ? CodeGenerationErrorOr<NonnullGCPtr<Executable>> { *script.bytecode_executable() }
+            : JS::Bytecode::Generator::generate_from_ast_node(vm, script, {});
 
         if (executable_result.is_error()) {
             if (auto error_string = executable_result.error().to_string(); error_string.is_error())
@@ -237,6 +250,8 @@ ThrowCompletionOr<Value> Interpreter::run(Script& script_record, JS::GCPtr<Envir
                 result = JS::throw_completion(JS::InternalError::create(realm(), error_string.release_value()));
         } else {
             auto executable = executable_result.release_value();
+            if (vm.program_cache())
+                const_cast<Program&>(script).set_bytecode_executable(executable);
 
             if (g_dump_bytecode)
                 executable->dump();
@@ -362,6 +377,16 @@ FLATTEN_ON_CLANG void Interpreter::run_bytecode(size_t entry_point)
     };
 #undef SET_UP_LABEL
 
+    // While execution statistics are collected, every instruction is counted before it goes to its actual handler.
+    static void* const counting_dispatch_table[] = {
+#define SET_UP_LABEL(name) &&count_instruction,
+        ENUMERATE_BYTECODE_OPS(SET_UP_LABEL)
+    };
+#undef SET_UP_LABEL
+
+    auto* statistics = m_collects_execution_statistics ? executable.execution_statistics.ptr() : nullptr;
+    auto const* dispatch_table = statistics ? counting_dispatch_table : bytecode_dispatch_table;
+
 #define DISPATCH_NEXT(name)                                                                         \
     do {                                                                                            \
         if constexpr (Op::name::IsVariableLength)                                                   \
@@ -369,13 +394,19 @@ FLATTEN_ON_CLANG void Interpreter::run_bytecode(size_t entry_point)
         else                                                                                        \
             program_counter += sizeof(Op::name);                                                    \
         auto& next_instruction = *reinterpret_cast<Instruction const*>(&bytecode[program_counter]); \
-        goto* bytecode_dispatch_table[static_cast<size_t>(next_instruction.type())];                \
+        goto* dispatch_table[static_cast<size_t>(next_instruction.type())];                         \
     } while (0)
 
     for (;;) {
     start:
         for (;;) {
-            goto* bytecode_dispatch_table[static_cast<size_t>((*reinterpret_cast<Instruction const*>(&bytecode[program_counter])).type())];
+            goto* dispatch_table[static_cast<size_t>((*reinterpret_cast<Instruction const*>(&bytecode[program_counter])).type())];
+
+        count_instruction: {
+            auto type = (*reinterpret_cast<Instruction const*>(&bytecode[program_counter])).type();
+            statistics->count_instruction(executable, type, program_counter);
+            goto* bytecode_dispatch_table[static_cast<size_t>(type)];
+        }
 
         handle_GetArgument: {
             auto const& instruction = *reinterpret_cast<Op::GetArgument const*>(&bytecode[program_counter]);
@@ -403,6 +434,13 @@ FLATTEN_ON_CLANG void Interpreter::run_bytecode(size_t entry_point)
 
         handle_Jump: {
             auto& instruction = *reinterpret_cast<Op::Jump const*>(&bytecode[program_counter]);
+            // NOTE: Jumping backwards means that we're in a loop, which may make it worth continuing in native code.
+            if (instruction.target().address() <= program_counter) {
+                if (auto* sampling_profiler = vm().sampling_profiler()) [[unlikely]]
+                    sampling_profiler->poll();
+                if (try_run_native_code(instruction.target().address()))
+                    return;
+            }
             program_counter = instruction.target().address();
             goto start;
         }
@@ -459,13 +497,13 @@ FLATTEN_ON_CLANG void Interpreter::run_bytecode(size_t entry_point)
             program_counter = result ? instruction.true_target().address() : instruction.false_target().address();      \
             goto start;                                                                                                 \
         }                                                                                                               \
-        auto result = op_snake_case(vm(), get(instruction.lhs()), get(instruction.rhs()));                              \
+        auto result = instruction.evaluate_condition(*this);                                                            \
         if (result.is_error()) {                                                                                        \
             if (handle_exception(program_counter, result.error_value()) == HandleExceptionResponse::ExitFromExecutable) \
                 return;                                                                                                 \
             goto start;                                                                                                 \
         }                                                                                                               \
-        if (result.value().to_boolean())                                                                                \
+        if (result.value())                                                                                             \
             program_counter = instruction.true_target().address();                                                      \
         else                                                                                                            \
             program_counter = instruction.false_target().address();                                                     \
@@ -721,7 +759,16 @@ Interpreter::ResultAndReturnRegister Interpreter::run_executable(Executable& exe
         running_execution_context.registers_and_constants_and_locals[executable.number_of_registers + i] = executable.constants[i];
     }
 
-    run_bytecode(entry_point.value_or(0));
+    if (auto* sampling_profiler = vm().sampling_profiler()) [[unlikely]]
+        sampling_profiler->poll();
+
+    if (m_collects_execution_statistics && !executable.execution_statistics) [[unlikely]] {
+        executable.execution_statistics = make<ExecutionStatistics>(executable.basic_block_start_offsets.size());
+        m_executables_with_execution_statistics.append(executable.make_weak_ptr<Executable>());
+    }
+
+    if (!try_run_native_code(entry_point.value_or(0)))
+        run_bytecode(entry_point.value_or(0));
 
     dbgln_if(JS_BYTECODE_DEBUG, "Bytecode::Interpreter did run unit {:p}", &executable);
 
@@ -755,6 +802,56 @@ Interpreter::ResultAndReturnRegister Interpreter::run_executable(Executable& exe
     return { return_value, running_execution_context.registers_and_constants_and_locals[0] };
 }
 
+bool Interpreter::try_run_native_code(size_t entry_point)
+{
+    if (!g_jit_enabled || m_collects_execution_statistics)
+        return false;
+
+    auto const* native_executable = current_executable().native_executable_if_hot();
+    if (!native_executable || !native_executable->can_enter_at(entry_point))
+        return false;
+
+    native_executable->run(*this, entry_point);
+    return true;
+}
+
+void Interpreter::set_collects_execution_statistics(bool collects_execution_statistics)
+{
+    m_collects_execution_statistics = collects_execution_statistics;
+    if (collects_execution_statistics)
+        return;
+
+    // NOTE: The statistics are only reset instead of thrown away, since some of these executables may still be running.
+    m_executables_with_execution_statistics.remove_all_matching([](auto& executable) { return !executable; });
+    for (auto& executable : m_executables_with_execution_statistics)
+        *executable->execution_statistics = ExecutionStatistics { executable->basic_block_start_offsets.size() };
+}
+
+void Interpreter::dump_execution_statistics() const
+{
+    Vector<Executable const*> executables;
+    for (auto& executable : m_executables_with_execution_statistics) {
+        if (executable && executable->execution_statistics->executed_instructions() != 0)
+            executables.append(executable.ptr());
+    }
+    quick_sort(executables, [](auto* a, auto* b) {
+        return a->execution_statistics->executed_instructions() > b->execution_statistics->executed_instructions();
+    });
+
+    for (auto* executable : executables)
+        executable->execution_statistics->dump(*executable);
+}
+
+u64 Interpreter::executed_instructions() const
+{
+    u64 total = 0;
+    for (auto& executable : m_executables_with_execution_statistics) {
+        if (executable)
+            total += executable->execution_statistics->executed_instructions();
+    }
+    return total;
+}
+
 void Interpreter::enter_unwind_context()
 {
     running_execution_context().unwind_contexts.empend(
@@ -903,8 +1000,8 @@ JS_ENUMERATE_COMMON_BINARY_OPS_WITH_FAST_PATH(JS_DEFINE_TO_BYTE_STRING_FOR_COMMO
 ThrowCompletionOr<void> Add::execute_impl(Bytecode::Interpreter& interpreter) const
 {
     auto& vm = interpreter.vm();
-    auto const lhs = interpreter.get(m_lhs);
-    auto const rhs = interpreter.get(m_rhs);
+    auto lhs = interpreter.get(m_lhs);
+    auto rhs = interpreter.get(m_rhs);
 
     if (lhs.is_number() && rhs.is_number()) {
         if (lhs.is_int32() && rhs.is_int32()) {
@@ -917,6 +1014,12 @@ ThrowCompletionOr<void> Add::execute_impl(Bytecode::Interpreter& interpreter) co
         return {};
     }
 
+    // OPTIMIZATION: Strings are already primitives, so appending one string to another can skip straight to the concatenation.
+    if (lhs.is_string() && rhs.is_string()) {
+        interpreter.set(m_dst, PrimitiveString::create(vm, lhs.as_string(), rhs.as_string()));
+        return {};
+    }
+
     interpreter.set(m_dst, TRY(add(vm, lhs, rhs)));
     return {};
 }
@@ -1112,6 +1215,16 @@ ThrowCompletionOr<void> GreaterThanEquals::execute_impl(Bytecode::Interpreter& i
     return {};
 }
 
+#define JS_DEFINE_EVALUATE_CONDITION_FOR_COMPARISON_OP(op_TitleCase, op_snake_case, numeric_operator)        \
+    ThrowCompletionOr<bool> Jump##op_TitleCase::evaluate_condition(Bytecode::Interpreter& interpreter) const \
+    {                                                                                                      \
+        auto result = TRY(op_snake_case(interpreter.vm(), interpreter.get(m_lhs), interpreter.get(m_rhs))); \
+        return result.to_boolean();                                                                        \
+    }
+
+JS_ENUMERATE_COMPARISON_OPS(JS_DEFINE_EVALUATE_CONDITION_FOR_COMPARISON_OP)
+#undef JS_DEFINE_EVALUATE_CONDITION_FOR_COMPARISON_OP
+
 static ThrowCompletionOr<Value> not_(VM&, Value value)
 {
     return Value(!value.to_boolean());
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/ExecutionStatistics.h>
 #include <LibJS/Bytecode/Label.h>
 #include <LibJS/Bytecode/Register.h>
 #include <LibJS/Forward.h>
@@ -80,8 +81,30 @@ public:
 
     ExecutionContext& running_execution_context() { return *m_running_execution_context; }
 
+    MegamorphicPropertyLookupCache& megamorphic_get_cache() { return m_megamorphic_get_cache; }
+    MegamorphicPropertyLookupCache& megamorphic_put_cache() { return m_megamorphic_put_cache; }
+    PropertyLookupCacheStatistics& property_lookup_cache_statistics() { return m_property_lookup_cache_statistics; }
+
+    // Counts a property lookup for all executables, and for the running one too while execution statistics are collected.
+    ALWAYS_INLINE void count_property_lookup(u64 PropertyLookupCacheStatistics::*counter)
+    {
+        ++(m_property_lookup_cache_statistics.*counter);
+        if (m_collects_execution_statistics && m_current_executable && m_current_executable->execution_statistics) [[unlikely]]
+            ++(m_current_executable->execution_statistics->property_lookups.*counter);
+    }
+
+    // NOTE: Native code can't count anything, so the JIT stays out of the way while execution statistics are collected.
+    bool collects_execution_statistics() const { return m_collects_execution_statistics; }
+    void set_collects_execution_statistics(bool);
+    void dump_execution_statistics() const;
+    u64 executed_instructions() const;
+
 private:
+    friend class JIT::Compiler;
+    friend class JIT::NativeExecutable;
+
     void run_bytecode(size_t entry_point);
+    [[nodiscard]] bool try_run_native_code(size_t entry_point);
 
     enum class HandleExceptionResponse {
         ExitFromExecutable,
@@ -99,9 +122,19 @@ private:
     Span<Value> m_arguments;
     Span<Value> m_registers_and_constants_and_locals;
     ExecutionContext* m_running_execution_context { nullptr };
+
+    // NOTE: Gets and puts don't share these, since a cached get doesn't mean that the property is writable.
+    MegamorphicPropertyLookupCache m_megamorphic_get_cache;
+    MegamorphicPropertyLookupCache m_megamorphic_put_cache;
+    PropertyLookupCacheStatistics m_property_lookup_cache_statistics;
+
+    bool m_collects_execution_statistics { false };
+    Vector<WeakPtr<Executable>> m_executables_with_execution_statistics;
 };
 
 extern bool g_dump_bytecode;
+extern bool g_optimize_bytecode;
+extern bool g_jit_enabled;
 
 ThrowCompletionOr<NonnullGCPtr<Bytecode::Executable>> compile(VM&, ASTNode const&, JS::FunctionKind kind, DeprecatedFlyString const& name);
 ThrowCompletionOr<NonnullGCPtr<Bytecode::Executable>> compile(VM&, ECMAScriptFunctionObject const&);
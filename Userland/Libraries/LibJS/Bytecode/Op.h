@@ -1623,7 +1623,7 @@ private:
         {                                                                                            \
         }                                                                                            \
                                                                                                      \
-        ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;                          \
+        ThrowCompletionOr<bool> evaluate_condition(Bytecode::Interpreter&) const;                    \
         ByteString to_byte_string_impl(Bytecode::Executable const&) const;                           \
         void visit_labels_impl(Function<void(Label&)> visitor)                                       \
         {                                                                                            \
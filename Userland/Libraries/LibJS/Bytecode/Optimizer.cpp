@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/BasicBlock.h>
+#include <LibJS/Bytecode/Generator.h>
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/Optimizer.h>
+#include <LibJS/Runtime/Value.h>
+
+namespace JS::Bytecode {
+
+void Optimizer::optimize(Generator& generator)
+{
+    Optimizer optimizer(generator);
+    optimizer.fold_constants();
+    optimizer.thread_jumps();
+    optimizer.merge_blocks();
+    optimizer.remove_unreachable_blocks();
+}
+
+template<typename Callback>
+static void for_each_instruction(BasicBlock& block, Callback callback)
+{
+    InstructionStreamIterator it(block.instruction_stream());
+    for (; !it.at_end(); ++it)
+        callback(const_cast<Instruction&>(*it));
+}
+
+static Optional<size_t> target_of_final_jump(BasicBlock const& block)
+{
+    if (!block.is_terminated() || block.size() == 0)
+        return {};
+    auto const& instruction = *reinterpret_cast<Instruction const*>(block.data() + block.last_instruction_start_offset());
+    if (instruction.type() != Instruction::Type::Jump)
+        return {};
+    return static_cast<Op::Jump const&>(instruction).target().basic_block_index();
+}
+
+// NOTE: Operations on numbers and booleans can neither have side effects nor throw, so they can happen ahead of time.
+static bool can_fold(Value value)
+{
+    return value.is_number() || value.is_boolean();
+}
+
+static Optional<Value> fold_binary_operation(VM& vm, Instruction::Type type, Value lhs, Value rhs)
+{
+    if (!can_fold(lhs) || !can_fold(rhs))
+        return {};
+
+    switch (type) {
+#define __FOLD_BINARY_OP(OpTitleCase, op_snake_case) \
+    case Instruction::Type::OpTitleCase:             \
+        return MUST(JS::op_snake_case(vm, lhs, rhs));
+        JS_ENUMERATE_COMMON_BINARY_OPS_WITH_FAST_PATH(__FOLD_BINARY_OP)
+        __FOLD_BINARY_OP(Div, div)
+        __FOLD_BINARY_OP(Exp, exp)
+        __FOLD_BINARY_OP(Mod, mod)
+#undef __FOLD_BINARY_OP
+    case Instruction::Type::LooselyEquals:
+        return Value(MUST(is_loosely_equal(vm, lhs, rhs)));
+    case Instruction::Type::LooselyInequals:
+        return Value(!MUST(is_loosely_equal(vm, lhs, rhs)));
+    case Instruction::Type::StrictlyEquals:
+        return Value(is_strictly_equal(lhs, rhs));
+    case Instruction::Type::StrictlyInequals:
+        return Value(!is_strictly_equal(lhs, rhs));
+    default:
+        return {};
+    }
+}
+
+static Optional<Value> fold_unary_operation(VM& vm, Instruction::Type type, Value value)
+{
+    if (!can_fold(value))
+        return {};
+
+    switch (type) {
+    case Instruction::Type::BitwiseNot:
+        return MUST(bitwise_not(vm, value));
+    case Instruction::Type::Not:
+        return Value(!value.to_boolean());
+    case Instruction::Type::UnaryPlus:
+        return MUST(unary_plus(vm, value));
+    case Instruction::Type::UnaryMinus:
+        return MUST(unary_minus(vm, value));
+    default:
+        return {};
+    }
+}
+
+Optimizer::Simplification Optimizer::simplify(Instruction const& instruction, Function<void(Instruction const&)> const& replace_with)
+{
+    auto& vm = m_generator.vm();
+    auto constant = [&](Operand operand) -> Optional<Value> {
+        if (!operand.is_constant())
+            return {};
+        return m_generator.m_constants[operand.index()];
+    };
+    auto replace_with_mov = [&](Operand dst, Value value) {
+        replace_with(Op::Mov { dst, m_generator.add_constant(value).operand() });
+        return Simplification::Replaced;
+    };
+    auto replace_with_jump = [&](Label target) {
+        replace_with(Op::Jump { target });
+        return Simplification::Replaced;
+    };
+
+    switch (instruction.type()) {
+    case Instruction::Type::Mov: {
+        auto const& mov = static_cast<Op::Mov const&>(instruction);
+        if (mov.dst() == mov.src())
+            return Simplification::Removed;
+        return Simplification::None;
+    }
+
+#define __SIMPLIFY_BINARY_OP(OpTitleCase, op_snake_case)                                                 \
+    case Instruction::Type::OpTitleCase: {                                                               \
+        auto const& operation = static_cast<Op::OpTitleCase const&>(instruction);                        \
+        auto lhs = constant(operation.lhs());                                                            \
+        auto rhs = constant(operation.rhs());                                                            \
+        if (!lhs.has_value() || !rhs.has_value())                                                        \
+            return Simplification::None;                                                                 \
+        if (auto result = fold_binary_operation(vm, instruction.type(), *lhs, *rhs); result.has_value()) \
+            return replace_with_mov(operation.dst(), *result);                                           \
+        return Simplification::None;                                                                     \
+    }
+        JS_ENUMERATE_COMMON_BINARY_OPS_WITH_FAST_PATH(__SIMPLIFY_BINARY_OP)
+        JS_ENUMERATE_COMMON_BINARY_OPS_WITHOUT_FAST_PATH(__SIMPLIFY_BINARY_OP)
+#undef __SIMPLIFY_BINARY_OP
+
+#define __SIMPLIFY_UNARY_OP(OpTitleCase, op_snake_case)                                           \
+    case Instruction::Type::OpTitleCase: {                                                        \
+        auto const& operation = static_cast<Op::OpTitleCase const&>(instruction);                 \
+        auto src = constant(operation.src());                                                     \
+        if (!src.has_value())                                                                     \
+            return Simplification::None;                                                          \
+        if (auto result = fold_unary_operation(vm, instruction.type(), *src); result.has_value()) \
+            return replace_with_mov(operation.dst(), *result);                                    \
+        return Simplification::None;                                                              \
+    }
+        JS_ENUMERATE_COMMON_UNARY_OPS(__SIMPLIFY_UNARY_OP)
+#undef __SIMPLIFY_UNARY_OP
+
+    case Instruction::Type::JumpIf: {
+        auto const& jump = static_cast<Op::JumpIf const&>(instruction);
+        if (jump.true_target().basic_block_index() == jump.false_target().basic_block_index())
+            return replace_with_jump(jump.true_target());
+        // NOTE: Converting a primitive to a boolean has no side effects.
+        auto condition = constant(jump.condition());
+        if (!condition.has_value() || condition->is_empty() || condition->is_object())
+            return Simplification::None;
+        return replace_with_jump(condition->to_boolean() ? jump.true_target() : jump.false_target());
+    }
+
+#define __SIMPLIFY_COMPARISON_JUMP(op_TitleCase, op_snake_case, numeric_operator)                  \
+    case Instruction::Type::Jump##op_TitleCase: {                                                  \
+        auto const& jump = static_cast<Op::Jump##op_TitleCase const&>(instruction);                \
+        auto lhs = constant(jump.lhs());                                                           \
+        auto rhs = constant(jump.rhs());                                                           \
+        if (!lhs.has_value() || !rhs.has_value())                                                  \
+            return Simplification::None;                                                           \
+        auto result = fold_binary_operation(vm, Instruction::Type::op_TitleCase, *lhs, *rhs);      \
+        if (!result.has_value())                                                                   \
+            return Simplification::None;                                                           \
+        return replace_with_jump(result->to_boolean() ? jump.true_target() : jump.false_target()); \
+    }
+        JS_ENUMERATE_COMPARISON_OPS(__SIMPLIFY_COMPARISON_JUMP)
+#undef __SIMPLIFY_COMPARISON_JUMP
+
+    default:
+        return Simplification::None;
+    }
+}
+
+void Optimizer::simplify_instructions(BasicBlock& block)
+{
+    Vector<u8> buffer;
+    buffer.ensure_capacity(block.size());
+    HashMap<size_t, SourceRecord> source_map;
+    size_t last_instruction_start_offset = 0;
+    bool did_change_anything = false;
+
+    InstructionStreamIterator it(block.instruction_stream());
+    for (; !it.at_end(); ++it) {
+        auto const& instruction = *it;
+        auto source_record = block.source_map().get(it.offset());
+        Function<void(Instruction const&)> append = [&](Instruction const& instruction_to_append) {
+            last_instruction_start_offset = buffer.size();
+            if (source_record.has_value())
+                source_map.set(buffer.size(), *source_record);
+            buffer.append(reinterpret_cast<u8 const*>(&instruction_to_append), instruction_to_append.length());
+        };
+
+        auto simplification = simplify(instruction, append);
+        if (simplification == Simplification::None) {
+            append(instruction);
+            continue;
+        }
+        did_change_anything = true;
+        Instruction::destroy(const_cast<Instruction&>(instruction));
+    }
+
+    if (did_change_anything)
+        block.replace_instructions({}, move(buffer), move(source_map), last_instruction_start_offset);
+}
+
+void Optimizer::fold_constants()
+{
+    for (auto& block : m_generator.m_root_basic_blocks)
+        simplify_instructions(*block);
+}
+
+void Optimizer::thread_jumps()
+{
+    auto& blocks = m_generator.m_root_basic_blocks;
+
+    // A block that consists of nothing but a jump can be skipped by jumping to where it jumps right away.
+    auto target_of_trampoline = [&](size_t index) -> Optional<size_t> {
+        auto const& block = *blocks[index];
+        if (block.last_instruction_start_offset() != 0)
+            return {};
+        return target_of_final_jump(block);
+    };
+
+    for (auto& block : blocks) {
+        for_each_instruction(*block, [&](Instruction& instruction) {
+            instruction.visit_labels([&](Label& label) {
+                auto index = label.basic_block_index();
+                // NOTE: Jumps can go around in circles, e.g. for `while (true) {}`, so we give up after visiting every block.
+                for (size_t steps = 0; steps < blocks.size(); ++steps) {
+                    auto target = target_of_trampoline(index);
+                    if (!target.has_value() || *target == index)
+                        break;
+                    index = *target;
+                }
+                label = Label { static_cast<u32>(index) };
+            });
+        });
+    }
+}
+
+void Optimizer::merge_blocks()
+{
+    auto& blocks = m_generator.m_root_basic_blocks;
+
+    // NOTE: Blocks that exceptions unwind to are entered without a jump, so those are counted as having another predecessor.
+    Vector<size_t> predecessor_counts;
+    predecessor_counts.resize(blocks.size());
+    ++predecessor_counts[0];
+    for (auto& block : blocks) {
+        for_each_instruction(*block, [&](Instruction& instruction) {
+            instruction.visit_labels([&](Label& label) {
+                ++predecessor_counts[label.basic_block_index()];
+            });
+        });
+        if (block->handler())
+            ++predecessor_counts[block->handler()->index()];
+        if (block->finalizer())
+            ++predecessor_counts[block->finalizer()->index()];
+    }
+
+    // A block that ends in a jump to a block that can't be entered in any other way can just continue with the code of that block.
+    for (auto& block : blocks) {
+        while (true) {
+            auto successor_index = target_of_final_jump(*block);
+            if (!successor_index.has_value() || *successor_index == block->index())
+                break;
+            if (predecessor_counts[*successor_index] != 1)
+                break;
+            auto& successor = *blocks[*successor_index];
+            if (successor.handler() != block->handler() || successor.finalizer() != block->finalizer())
+                break;
+            block->absorb({}, successor);
+            predecessor_counts[*successor_index] = 0;
+        }
+    }
+}
+
+void Optimizer::remove_unreachable_blocks()
+{
+    auto& blocks = m_generator.m_root_basic_blocks;
+
+    Vector<bool> is_reachable;
+    is_reachable.resize(blocks.size());
+    Vector<size_t> worklist;
+    auto mark_reachable = [&](size_t index) {
+        if (is_reachable[index])
+            return;
+        is_reachable[index] = true;
+        worklist.append(index);
+    };
+
+    mark_reachable(0);
+    while (!worklist.is_empty()) {
+        auto& block = *blocks[worklist.take_last()];
+        for_each_instruction(block, [&](Instruction& instruction) {
+            instruction.visit_labels([&](Label& label) {
+                mark_reachable(label.basic_block_index());
+            });
+        });
+        if (block.handler())
+            mark_reachable(block.handler()->index());
+        if (block.finalizer())
+            mark_reachable(block.finalizer()->index());
+    }
+
+    blocks.remove_all_matching([&](auto& block) { return !is_reachable[block->index()]; });
+
+    // NOTE: Labels refer to blocks by their index while generating code, so those have to follow the blocks that are left.
+    Vector<u32> new_indices;
+    new_indices.resize(is_reachable.size());
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        new_indices[blocks[i]->index()] = i;
+        blocks[i]->set_index({}, i);
+    }
+    for (auto& block : blocks) {
+        for_each_instruction(*block, [&](Instruction& instruction) {
+            instruction.visit_labels([&](Label& label) {
+                label = Label { new_indices[label.basic_block_index()] };
+            });
+        });
+    }
+}
+
+}
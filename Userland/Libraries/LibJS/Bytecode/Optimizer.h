@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <LibJS/Forward.h>
+
+namespace JS::Bytecode {
+
+// Cleans up the basic blocks that the generator emitted for a function, before they're linearized into an Executable.
+// Code is generated one AST node at a time, which leaves behind operations on constants, jumps to blocks that only
+// jump further, chains of blocks that could just as well be a single one, and blocks that nothing jumps to anymore.
+class Optimizer {
+public:
+    static void optimize(Generator&);
+
+private:
+    explicit Optimizer(Generator& generator)
+        : m_generator(generator)
+    {
+    }
+
+    void fold_constants();
+    void thread_jumps();
+    void merge_blocks();
+    void remove_unreachable_blocks();
+
+    enum class Simplification {
+        None,
+        Removed,
+        Replaced,
+    };
+    Simplification simplify(Instruction const&, Function<void(Instruction const&)> const& replace_with);
+    void simplify_instructions(BasicBlock&);
+
+    Generator& m_generator;
+};
+
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/DeprecatedFlyString.h>
+#include <AK/Format.h>
+#include <AK/HashFunctions.h>
+#include <AK/Vector.h>
+#include <AK/WeakPtr.h>
+#include <LibJS/Forward.h>
+
+namespace JS::Bytecode {
+
+// An inline cache for a single property access in the bytecode. Every entry remembers where the property was found
+// on objects of one shape, so a site that sees a handful of different shapes still takes the fast path for all of them.
+struct PropertyLookupCache {
+    static constexpr size_t max_number_of_shapes = 4;
+
+    struct Entry {
+        WeakPtr<Shape> shape;
+        Optional<u32> property_offset;
+        WeakPtr<Object> prototype;
+        WeakPtr<PrototypeChainValidity> prototype_chain_validity;
+    };
+
+    AK::Array<Entry, max_number_of_shapes> entries;
+
+    // Once a site has seen more shapes than fit into the entries, it only uses the interpreter's megamorphic cache.
+    bool is_megamorphic { false };
+};
+
+// A cache of property lookups keyed by the shape and the property name, which is shared by all the sites that went
+// megamorphic. It's direct-mapped, so a lookup is never more than a single hash and compare, and colliding lookups
+// simply replace each other.
+class MegamorphicPropertyLookupCache {
+public:
+    static constexpr size_t number_of_entries = 1024;
+
+    struct Entry : public PropertyLookupCache::Entry {
+        DeprecatedFlyString property_name;
+    };
+
+    MegamorphicPropertyLookupCache()
+    {
+        m_entries.resize(number_of_entries);
+    }
+
+    Entry* find(Shape const& shape, DeprecatedFlyString const& property_name)
+    {
+        auto& entry = entry_for(shape, property_name);
+        if (&shape != entry.shape || entry.property_name != property_name)
+            return nullptr;
+        return &entry;
+    }
+
+    Entry& entry_for(Shape const& shape, DeprecatedFlyString const& property_name)
+    {
+        static_assert(is_power_of_two(number_of_entries));
+        return m_entries[pair_int_hash(ptr_hash(&shape), property_name.hash()) & (number_of_entries - 1)];
+    }
+
+private:
+    Vector<Entry> m_entries;
+};
+
+// NOTE: These are only counted, so the hit rates of the caches can be looked at when profiling.
+struct PropertyLookupCacheStatistics {
+    u64 monomorphic_hits { 0 };
+    u64 polymorphic_hits { 0 };
+    u64 megamorphic_hits { 0 };
+    u64 misses { 0 };
+    u64 sites_gone_megamorphic { 0 };
+
+    void dump() const
+    {
+        auto total = monomorphic_hits + polymorphic_hits + megamorphic_hits + misses;
+        auto percentage = [&](u64 count) { return total ? static_cast<double>(count) * 100 / total : 0.0; };
+        warnln("Property lookup cache statistics ({} lookups):", total);
+        warnln("  Monomorphic hits:       {} ({:.1}%)", monomorphic_hits, percentage(monomorphic_hits));
+        warnln("  Polymorphic hits:       {} ({:.1}%)", polymorphic_hits, percentage(polymorphic_hits));
+        warnln("  Megamorphic hits:       {} ({:.1}%)", megamorphic_hits, percentage(megamorphic_hits));
+        warnln("  Misses:                 {} ({:.1}%)", misses, percentage(misses));
+        warnln("  Sites gone megamorphic: {}", sites_gone_megamorphic);
+    }
+};
+
+}
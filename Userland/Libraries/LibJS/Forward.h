@@ -321,8 +321,14 @@ class Generator;
 class Instruction;
 class Interpreter;
 class Operand;
+class Optimizer;
 class RegexTable;
 class Register;
 }
 
+namespace JIT {
+class Compiler;
+class NativeExecutable;
+}
+
 }
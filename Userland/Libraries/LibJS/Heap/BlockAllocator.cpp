@@ -5,12 +5,19 @@
  */
 
 #include <AK/Platform.h>
+#include <AK/QuickSort.h>
 #include <AK/Random.h>
+#include <AK/ScopeGuard.h>
 #include <AK/Vector.h>
 #include <LibJS/Heap/BlockAllocator.h>
+#include <LibJS/Heap/CompressedGCPtr.h>
 #include <LibJS/Heap/HeapBlock.h>
 #include <sys/mman.h>
 
+#ifdef JS_POINTER_COMPRESSION
+#    include <pthread.h>
+#endif
+
 #ifdef HAS_ADDRESS_SANITIZER
 #    include <sanitizer/asan_interface.h>
 #    include <sanitizer/lsan_interface.h>
@@ -26,8 +33,55 @@ namespace JS {
 // NOTE: If this changes, we need to update the mmap() code to ensure correct alignment.
 static_assert(HeapBlock::block_size == 4096);
 
+#ifdef JS_POINTER_COMPRESSION
+FlatPtr g_heap_cage_base;
+
+// Blocks of the heap cage that no BlockAllocator is using anymore. Their pages have been given back to the OS already.
+static Vector<void*> s_free_heap_cage_blocks;
+static pthread_mutex_t s_heap_cage_mutex = PTHREAD_MUTEX_INITIALIZER;
+static size_t s_heap_cage_next_unused_offset = HeapBlock::block_size;
+
+static void* allocate_block_from_heap_cage()
+{
+    pthread_mutex_lock(&s_heap_cage_mutex);
+    ScopeGuard unlock_mutex = [] { pthread_mutex_unlock(&s_heap_cage_mutex); };
+
+    if (!g_heap_cage_base) {
+        // NOTE: This only reserves the address space, the pages are mapped one block at a time as they're needed.
+        auto* cage = mmap(nullptr, heap_cage_size, PROT_NONE, MAP_ANONYMOUS | MAP_PRIVATE | MAP_NORESERVE, -1, 0);
+        VERIFY(cage != MAP_FAILED);
+        g_heap_cage_base = bit_cast<FlatPtr>(cage);
+    }
+
+    if (!s_free_heap_cage_blocks.is_empty())
+        return s_free_heap_cage_blocks.take_last();
+
+    // The first block of the cage is never used, so that an offset of 0 can stand for null.
+    VERIFY(s_heap_cage_next_unused_offset + HeapBlock::block_size <= heap_cage_size);
+    auto* block = bit_cast<void*>(g_heap_cage_base + s_heap_cage_next_unused_offset);
+    s_heap_cage_next_unused_offset += HeapBlock::block_size;
+
+    if (mmap(block, HeapBlock::block_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE | MAP_FIXED, -1, 0) != block) {
+        perror("mmap");
+        VERIFY_NOT_REACHED();
+    }
+    return block;
+}
+#endif
+
 BlockAllocator::~BlockAllocator()
 {
+#ifdef JS_POINTER_COMPRESSION
+    // NOTE: Unmapping the blocks would leave holes in the cage, so they're handed back to it for other heaps to use.
+    release_deallocated_blocks();
+    pthread_mutex_lock(&s_heap_cage_mutex);
+    for (auto* block : m_blocks) {
+        ASAN_UNPOISON_MEMORY_REGION(block, HeapBlock::block_size);
+        s_free_heap_cage_blocks.append(block);
+    }
+    pthread_mutex_unlock(&s_heap_cage_mutex);
+#else
+    m_blocks.extend(move(m_deallocated_blocks));
     for (auto* block : m_blocks) {
         ASAN_UNPOISON_MEMORY_REGION(block, HeapBlock::block_size);
         if (munmap(block, HeapBlock::block_size) < 0) {
@@ -35,14 +89,17 @@ BlockAllocator::~BlockAllocator()
             VERIFY_NOT_REACHED();
         }
     }
+#endif
 }
 
 void* BlockAllocator::allocate_block([[maybe_unused]] char const* name)
 {
-    if (!m_blocks.is_empty()) {
+    // Prefer the blocks that haven't been released yet, as their pages don't have to be faulted in again.
+    auto& cached_blocks = m_deallocated_blocks.is_empty() ? m_blocks : m_deallocated_blocks;
+    if (!cached_blocks.is_empty()) {
         // To reduce predictability, take a random block from the cache.
-        size_t random_index = get_random_uniform(m_blocks.size());
-        auto* block = m_blocks.unstable_take(random_index);
+        size_t random_index = get_random_uniform(cached_blocks.size());
+        auto* block = cached_blocks.unstable_take(random_index);
         ASAN_UNPOISON_MEMORY_REGION(block, HeapBlock::block_size);
         LSAN_REGISTER_ROOT_REGION(block, HeapBlock::block_size);
 #ifdef AK_OS_SERENITY
@@ -54,7 +111,15 @@ void* BlockAllocator::allocate_block([[maybe_unused]] char const* name)
         return block;
     }
 
-#ifdef AK_OS_SERENITY
+#if defined(JS_POINTER_COMPRESSION)
+    auto* block = allocate_block_from_heap_cage();
+#    ifdef AK_OS_SERENITY
+    if (set_mmap_name(block, HeapBlock::block_size, name) < 0) {
+        perror("set_mmap_name");
+        VERIFY_NOT_REACHED();
+    }
+#    endif
+#elif defined(AK_OS_SERENITY)
     auto* block = (HeapBlock*)serenity_mmap(nullptr, HeapBlock::block_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_RANDOMIZED | MAP_PRIVATE, 0, 0, HeapBlock::block_size, name);
 #else
     auto* block = (HeapBlock*)mmap(nullptr, HeapBlock::block_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, 0, 0);
@@ -68,31 +133,63 @@ void BlockAllocator::deallocate_block(void* block)
 {
     VERIFY(block);
 
-#if defined(USE_FALLBACK_BLOCK_DEALLOCATION)
-    // If we can't use any of the nicer techniques, unmap and remap the block to return the physical pages while keeping the VM.
-    if (munmap(block, HeapBlock::block_size) < 0) {
-        perror("munmap");
-        VERIFY_NOT_REACHED();
+    ASAN_POISON_MEMORY_REGION(block, HeapBlock::block_size);
+    LSAN_UNREGISTER_ROOT_REGION(block, HeapBlock::block_size);
+    m_deallocated_blocks.append(block);
+}
+
+void BlockAllocator::release_deallocated_blocks()
+{
+    if (m_deallocated_blocks.is_empty())
+        return;
+
+    quick_sort(m_deallocated_blocks);
+
+    auto* range_start = static_cast<u8*>(m_deallocated_blocks.first());
+    size_t range_size = 0;
+    for (auto* block : m_deallocated_blocks) {
+        if (static_cast<u8*>(block) != range_start + range_size) {
+            release_to_os(range_start, range_size);
+            range_start = static_cast<u8*>(block);
+            range_size = 0;
+        }
+        range_size += HeapBlock::block_size;
     }
-    if (mmap(block, HeapBlock::block_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE | MAP_FIXED, 0, 0) != block) {
-        perror("mmap");
-        VERIFY_NOT_REACHED();
+    release_to_os(range_start, range_size);
+
+    m_blocks.extend(move(m_deallocated_blocks));
+}
+
+void BlockAllocator::release_to_os(void* address, size_t size)
+{
+    ASAN_UNPOISON_MEMORY_REGION(address, size);
+
+#if defined(USE_FALLBACK_BLOCK_DEALLOCATION)
+    // If we can't use any of the nicer techniques, unmap and remap the blocks to return the physical pages while keeping the VM.
+    // NOTE: This is done one block at a time, so every block keeps being a mapping of its own.
+    for (auto* block = static_cast<u8*>(address); block < static_cast<u8*>(address) + size; block += HeapBlock::block_size) {
+        if (munmap(block, HeapBlock::block_size) < 0) {
+            perror("munmap");
+            VERIFY_NOT_REACHED();
+        }
+        if (mmap(block, HeapBlock::block_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE | MAP_FIXED, 0, 0) != block) {
+            perror("mmap");
+            VERIFY_NOT_REACHED();
+        }
     }
 #elif defined(MADV_FREE)
-    if (madvise(block, HeapBlock::block_size, MADV_FREE) < 0) {
+    if (madvise(address, size, MADV_FREE) < 0) {
         perror("madvise(MADV_FREE)");
         VERIFY_NOT_REACHED();
     }
 #elif defined(MADV_DONTNEED)
-    if (madvise(block, HeapBlock::block_size, MADV_DONTNEED) < 0) {
+    if (madvise(address, size, MADV_DONTNEED) < 0) {
         perror("madvise(MADV_DONTNEED)");
         VERIFY_NOT_REACHED();
     }
 #endif
 
-    ASAN_POISON_MEMORY_REGION(block, HeapBlock::block_size);
-    LSAN_UNREGISTER_ROOT_REGION(block, HeapBlock::block_size);
-    m_blocks.append(block);
+    ASAN_POISON_MEMORY_REGION(address, size);
 }
 
 }
@@ -19,8 +19,18 @@ public:
     void* allocate_block(char const* name);
     void deallocate_block(void*);
 
+    // Gives the physical pages of all blocks deallocated since the last call back to the OS. Neighbouring blocks
+    // are released together, so a collection that frees many blocks doesn't need a system call for each of them.
+    void release_deallocated_blocks();
+
 private:
+    static void release_to_os(void* address, size_t size);
+
+    // Blocks whose pages have been given back to the OS already.
     Vector<void*> m_blocks;
+
+    // Blocks that are free but still backed by physical pages.
+    Vector<void*> m_deallocated_blocks;
 };
 
 }
@@ -14,6 +14,7 @@
 #include <AK/StringView.h>
 #include <AK/Weakable.h>
 #include <LibJS/Forward.h>
+#include <LibJS/Heap/CompressedGCPtr.h>
 #include <LibJS/Heap/GCPtr.h>
 #include <LibJS/Heap/Internals.h>
 
@@ -75,6 +76,15 @@ public:
             visit_impl(const_cast<RemoveConst<T>&>(*cell.ptr()));
         }
 
+#ifdef JS_POINTER_COMPRESSION
+        template<typename T>
+        void visit(CompressedGCPtr<T> cell)
+        {
+            if (cell)
+                visit_impl(const_cast<RemoveConst<T>&>(*cell.ptr()));
+        }
+#endif
+
         template<typename T>
         void visit(ReadonlySpan<T> span)
         {
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Assertions.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Types.h>
+#include <LibJS/Heap/GCPtr.h>
+
+namespace JS {
+
+#ifdef JS_POINTER_COMPRESSION
+
+// With pointer compression, all heap blocks are allocated from a single reservation of address space, the heap cage.
+// A pointer to a cell can then be stored as a 32-bit offset from the start of the cage. Offset 0 is never handed out,
+// so it can stand for null.
+static constexpr size_t heap_cage_size = 4ull * 1024 * 1024 * 1024;
+extern FlatPtr g_heap_cage_base;
+
+template<typename T>
+class CompressedGCPtr {
+public:
+    constexpr CompressedGCPtr() = default;
+
+    CompressedGCPtr(T& ptr)
+        : m_offset(compress(&ptr))
+    {
+    }
+
+    CompressedGCPtr(T* ptr)
+        : m_offset(compress(ptr))
+    {
+    }
+
+    template<typename U>
+    CompressedGCPtr(GCPtr<U> const& other)
+    requires(IsConvertible<U*, T*>)
+        : m_offset(compress(other.ptr()))
+    {
+    }
+
+    template<typename U>
+    CompressedGCPtr(NonnullGCPtr<U> const& other)
+    requires(IsConvertible<U*, T*>)
+        : m_offset(compress(other.ptr()))
+    {
+    }
+
+    CompressedGCPtr(nullptr_t)
+    {
+    }
+
+    T* operator->() const
+    {
+        VERIFY(m_offset);
+        return ptr();
+    }
+
+    T& operator*() const
+    {
+        VERIFY(m_offset);
+        return *ptr();
+    }
+
+    T* ptr() const
+    {
+        if (!m_offset)
+            return nullptr;
+        return bit_cast<T*>(g_heap_cage_base + m_offset);
+    }
+
+    explicit operator bool() const { return m_offset != 0; }
+    bool operator!() const { return m_offset == 0; }
+
+    operator T*() const { return ptr(); }
+
+    bool operator==(CompressedGCPtr const& other) const { return m_offset == other.m_offset; }
+
+private:
+    static u32 compress(T const* ptr)
+    {
+        if (!ptr)
+            return 0;
+        auto offset = bit_cast<FlatPtr>(ptr) - g_heap_cage_base;
+        VERIFY(offset > 0 && offset < heap_cage_size);
+        return static_cast<u32>(offset);
+    }
+
+    u32 m_offset { 0 };
+};
+
+#else
+
+// Without pointer compression, this is just a regular GCPtr.
+template<typename T>
+using CompressedGCPtr = GCPtr<T>;
+
+#endif
+
+}
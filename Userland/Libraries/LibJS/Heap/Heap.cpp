@@ -64,6 +64,8 @@ Heap::~Heap()
 {
     vm().string_cache().clear();
     vm().byte_string_cache().clear();
+    if (auto* program_cache = vm().program_cache())
+        program_cache->clear();
     collect_garbage(CollectionType::CollectEverything);
 }
 
@@ -269,9 +271,9 @@ void Heap::collect_garbage(CollectionType collection_type, bool print_report)
     perf_event(PERF_EVENT_SIGNPOST, gc_perf_string_id, global_gc_counter++);
 #endif
 
-    Core::ElapsedTimer collection_measurement_timer;
-    if (print_report)
-        collection_measurement_timer.start();
+    auto collection_timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+    auto phase_timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+    GarbageCollectionStatistics::Collection collection;
 
     if (collection_type == CollectionType::CollectGarbage) {
         if (m_gc_deferrals) {
@@ -280,10 +282,82 @@ void Heap::collect_garbage(CollectionType collection_type, bool print_report)
         }
         HashMap<Cell*, HeapRoot> roots;
         gather_roots(roots);
+        collection.gather_roots_time = phase_timer.elapsed_time();
+
+        phase_timer.start();
         mark_live_cells(roots);
+        collection.mark_time = phase_timer.elapsed_time();
     }
+
+    phase_timer.start();
     finalize_unmarked_cells();
-    sweep_dead_cells(print_report, collection_measurement_timer);
+    collection.finalize_time = phase_timer.elapsed_time();
+
+    phase_timer.start();
+    sweep_dead_cells(collection);
+    collection.sweep_time = phase_timer.elapsed_time();
+
+    collection.total_time = collection_timer.elapsed_time();
+    record_collection(collection, print_report);
+}
+
+void Heap::did_become_idle()
+{
+    if (m_collecting_garbage || m_gc_deferrals)
+        return;
+
+    release_deallocated_blocks();
+
+    // NOTE: Collecting with little garbage around would only cost time without making the next pause any shorter.
+    if (m_allocated_bytes_since_last_gc < m_gc_bytes_threshold / 2)
+        return;
+
+    ++m_garbage_collection_statistics.number_of_idle_collections;
+    m_allocated_bytes_since_last_gc = 0;
+    collect_garbage();
+}
+
+void Heap::release_deallocated_blocks()
+{
+    for (auto& allocator : m_all_cell_allocators)
+        allocator.block_allocator().release_deallocated_blocks();
+}
+
+void Heap::record_collection(GarbageCollectionStatistics::Collection const& collection, bool print_report)
+{
+    auto& statistics = m_garbage_collection_statistics;
+    ++statistics.number_of_collections;
+    statistics.total_pause_time += collection.total_time;
+    statistics.longest_pause_time = max(statistics.longest_pause_time, collection.total_time);
+    statistics.last_collection = collection;
+
+    if (on_garbage_collection)
+        on_garbage_collection(collection);
+
+    if (!print_report)
+        return;
+
+    dbgln("Garbage collection report");
+    dbgln("=============================================");
+    dbgln("     Time spent: {} ms", collection.total_time.to_milliseconds());
+    dbgln("   Gather roots: {} us", collection.gather_roots_time.to_microseconds());
+    dbgln("        Marking: {} us", collection.mark_time.to_microseconds());
+    dbgln("     Finalizing: {} us", collection.finalize_time.to_microseconds());
+    dbgln("       Sweeping: {} us", collection.sweep_time.to_microseconds());
+    dbgln("     Live cells: {} ({} bytes)", collection.live_cells, collection.live_cell_bytes);
+    dbgln("Collected cells: {} ({} bytes)", collection.collected_cells, collection.collected_cell_bytes);
+    dbgln("    Live blocks: {} ({} bytes)", collection.live_blocks, collection.live_blocks * HeapBlock::block_size);
+    dbgln("   Freed blocks: {} ({} bytes)", collection.freed_blocks, collection.freed_blocks * HeapBlock::block_size);
+    dbgln("=============================================");
+}
+
+void GarbageCollectionStatistics::dump() const
+{
+    auto average_pause_time = number_of_collections ? total_pause_time.to_microseconds() / static_cast<i64>(number_of_collections) : 0;
+    warnln("Garbage collection statistics ({} collections, {} while idle):", number_of_collections, number_of_idle_collections);
+    warnln("  Total pause time:   {} us", total_pause_time.to_microseconds());
+    warnln("  Average pause time: {} us", average_pause_time);
+    warnln("  Longest pause time: {} us", longest_pause_time.to_microseconds());
 }
 
 void Heap::gather_roots(HashMap<Cell*, HeapRoot>& roots)
@@ -478,7 +552,7 @@ void Heap::finalize_unmarked_cells()
     });
 }
 
-void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measurement_timer)
+void Heap::sweep_dead_cells(GarbageCollectionStatistics::Collection& collection)
 {
     dbgln_if(HEAP_DEBUG, "sweep_dead_cells:");
     Vector<HeapBlock*, 32> empty_blocks;
@@ -515,6 +589,10 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
     for (auto& weak_container : m_weak_containers)
         weak_container.remove_dead_cells({});
 
+    // NOTE: The blocks that became empty in this collection are only released to the OS when the heap is idle, or at
+    //       the latest in the next collection. Until then, allocations can reuse them without faulting pages back in.
+    release_deallocated_blocks();
+
     for (auto* block : empty_blocks) {
         dbgln_if(HEAP_DEBUG, " - HeapBlock empty @ {}: cell_size={}", block, block->cell_size());
         block->cell_allocator().block_did_become_empty({}, *block);
@@ -534,23 +612,15 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
 
     m_gc_bytes_threshold = live_cell_bytes > GC_MIN_BYTES_THRESHOLD ? live_cell_bytes : GC_MIN_BYTES_THRESHOLD;
 
-    if (print_report) {
-        Duration const time_spent = measurement_timer.elapsed_time();
-        size_t live_block_count = 0;
-        for_each_block([&](auto&) {
-            ++live_block_count;
-            return IterationDecision::Continue;
-        });
-
-        dbgln("Garbage collection report");
-        dbgln("=============================================");
-        dbgln("     Time spent: {} ms", time_spent.to_milliseconds());
-        dbgln("     Live cells: {} ({} bytes)", live_cells, live_cell_bytes);
-        dbgln("Collected cells: {} ({} bytes)", collected_cells, collected_cell_bytes);
-        dbgln("    Live blocks: {} ({} bytes)", live_block_count, live_block_count * HeapBlock::block_size);
-        dbgln("   Freed blocks: {} ({} bytes)", empty_blocks.size(), empty_blocks.size() * HeapBlock::block_size);
-        dbgln("=============================================");
-    }
+    collection.live_cells = live_cells;
+    collection.live_cell_bytes = live_cell_bytes;
+    collection.collected_cells = collected_cells;
+    collection.collected_cell_bytes = collected_cell_bytes;
+    collection.freed_blocks = empty_blocks.size();
+    for_each_block([&](auto&) {
+        ++collection.live_blocks;
+        return IterationDecision::Continue;
+    });
 }
 
 void Heap::defer_gc()
@@ -7,10 +7,12 @@
 #pragma once
 
 #include <AK/Badge.h>
+#include <AK/Function.h>
 #include <AK/HashTable.h>
 #include <AK/IntrusiveList.h>
 #include <AK/Noncopyable.h>
 #include <AK/NonnullOwnPtr.h>
+#include <AK/Time.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
 #include <LibCore/Forward.h>
@@ -28,6 +30,32 @@
 
 namespace JS {
 
+// NOTE: These are always kept up to date, so pause times can be looked at without rebuilding with a debug flag.
+struct GarbageCollectionStatistics {
+    struct Collection {
+        Duration gather_roots_time;
+        Duration mark_time;
+        Duration finalize_time;
+        Duration sweep_time;
+        Duration total_time;
+
+        size_t live_cells { 0 };
+        size_t live_cell_bytes { 0 };
+        size_t collected_cells { 0 };
+        size_t collected_cell_bytes { 0 };
+        size_t live_blocks { 0 };
+        size_t freed_blocks { 0 };
+    };
+
+    u64 number_of_collections { 0 };
+    u64 number_of_idle_collections { 0 };
+    Duration total_pause_time;
+    Duration longest_pause_time;
+    Collection last_collection;
+
+    void dump() const;
+};
+
 class Heap : public HeapBase {
     AK_MAKE_NONCOPYABLE(Heap);
     AK_MAKE_NONMOVABLE(Heap);
@@ -66,6 +94,15 @@ public:
     void collect_garbage(CollectionType = CollectionType::CollectGarbage, bool print_report = false);
     AK::JsonObject dump_graph();
 
+    // Called by the embedder when it has nothing else to do for a while. If a good part of the allocation budget
+    // has been used up already, the collection that would otherwise interrupt a later allocation happens now.
+    void did_become_idle();
+
+    GarbageCollectionStatistics const& garbage_collection_statistics() const { return m_garbage_collection_statistics; }
+
+    // Called after every garbage collection. Must not allocate any cells.
+    Function<void(GarbageCollectionStatistics::Collection const&)> on_garbage_collection;
+
     bool should_collect_on_every_allocation() const { return m_should_collect_on_every_allocation; }
     void set_should_collect_on_every_allocation(bool b) { m_should_collect_on_every_allocation = b; }
 
@@ -118,7 +155,9 @@ private:
     void gather_asan_fake_stack_roots(HashMap<FlatPtr, HeapRoot>&, FlatPtr, FlatPtr min_block_address, FlatPtr max_block_address);
     void mark_live_cells(HashMap<Cell*, HeapRoot> const& live_cells);
     void finalize_unmarked_cells();
-    void sweep_dead_cells(bool print_report, Core::ElapsedTimer const&);
+    void sweep_dead_cells(GarbageCollectionStatistics::Collection&);
+    void release_deallocated_blocks();
+    void record_collection(GarbageCollectionStatistics::Collection const&, bool print_report);
 
     ALWAYS_INLINE CellAllocator& allocator_for_size(size_t cell_size)
     {
@@ -160,6 +199,8 @@ private:
     bool m_should_gc_when_deferral_ends { false };
 
     bool m_collecting_garbage { false };
+
+    GarbageCollectionStatistics m_garbage_collection_statistics;
 };
 
 inline void Heap::did_create_handle(Badge<HandleImpl>, HandleImpl& impl)
@@ -0,0 +1,487 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/JIT/Compiler.h>
+#include <LibJS/Runtime/Value.h>
+
+namespace JS::JIT {
+
+#ifdef JIT_ARCH_SUPPORTED
+
+using Assembler = ::JIT::Assembler;
+using Reg = Assembler::Reg;
+using Condition = Assembler::Condition;
+
+static Assembler::Operand reg(Reg reg) { return Assembler::Operand::Register(reg); }
+static Assembler::Operand imm(u64 value) { return Assembler::Operand::Imm(value); }
+
+static constexpr auto GPR0 = Reg::RAX;
+static constexpr auto GPR1 = Reg::RDX;
+// Never holds anything across more than a couple of instructions.
+static constexpr auto SCRATCH = Reg::RCX;
+static constexpr auto RETURN_VALUE = Reg::RAX;
+
+static constexpr auto ARG0 = Reg::RDI;
+static constexpr auto ARG1 = Reg::RSI;
+static constexpr auto ARG2 = Reg::RDX;
+static constexpr auto ARG3 = Reg::RCX;
+
+// These are callee-saved, so that they survive the calls into C++.
+// NOTE: R12 and R13 can't be the base of a memory operand without a SIB byte or a displacement, which the assembler
+//       doesn't do, so they aren't used for anything that is.
+static constexpr auto REGISTERS_AND_CONSTANTS_AND_LOCALS = Reg::RBX;
+static constexpr auto ARGUMENTS = Reg::R14;
+static constexpr auto INTERPRETER = Reg::R15;
+
+template<typename OpType>
+static constexpr bool can_throw = !IsSame<decltype(declval<OpType const&>().execute_impl(declval<Bytecode::Interpreter&>())), void>;
+
+OwnPtr<NativeExecutable> Compiler::compile(Bytecode::Executable& executable)
+{
+    Compiler compiler { executable };
+    return compiler.compile_executable();
+}
+
+OwnPtr<NativeExecutable> Compiler::compile_executable()
+{
+    // NOTE: All labels exist up front, so that the references to them stay valid while the code is generated.
+    for (auto offset : m_executable.basic_block_start_offsets)
+        m_block_labels.set(offset, {});
+    for (auto const& handlers : m_executable.exception_handlers) {
+        if (handlers.handler_offset.has_value())
+            m_block_labels.set(*handlers.handler_offset, {});
+        if (handlers.finalizer_offset.has_value())
+            m_block_labels.set(*handlers.finalizer_offset, {});
+    }
+
+    compile_entry();
+
+    NativeExecutable::BlockOffsets block_offsets;
+    Bytecode::InstructionStreamIterator it(m_executable.bytecode, &m_executable);
+    while (!it.at_end()) {
+        if (auto label = m_block_labels.find(it.offset()); label != m_block_labels.end()) {
+            label->value.link(m_assembler);
+            block_offsets.set(it.offset(), m_output.size());
+        }
+
+        if (!compile_instruction(*it)) {
+            dbgln_if(JS_JIT_DEBUG, "JIT: Can't compile {} of \"{}\"", (*it).to_byte_string(m_executable), m_executable.name);
+            return nullptr;
+        }
+        ++it;
+    }
+
+    auto exit_offset = m_output.size();
+    m_exit_label.link(m_assembler);
+    m_assembler.exit();
+
+    for (auto const& [offset, label] : m_block_labels) {
+        if (!label.offset_of_label_in_instruction_stream.has_value())
+            m_has_unknown_jump_target = true;
+    }
+    if (m_has_unknown_jump_target) {
+        dbgln_if(JS_JIT_DEBUG, "JIT: \"{}\" jumps somewhere other than the start of an instruction", m_executable.name);
+        return nullptr;
+    }
+
+    dbgln_if(JS_JIT_DEBUG, "JIT: Compiled \"{}\" ({} bytes of bytecode) to {} bytes of native code", m_executable.name, m_executable.bytecode.size(), m_output.size());
+    return NativeExecutable::create(m_output, move(block_offsets), exit_offset);
+}
+
+void Compiler::compile_entry()
+{
+    // void entry(u8 const* block, Value* registers_and_constants_and_locals, Bytecode::Interpreter*, Value* arguments)
+    m_assembler.enter();
+    m_assembler.mov(reg(REGISTERS_AND_CONSTANTS_AND_LOCALS), reg(ARG1));
+    m_assembler.mov(reg(INTERPRETER), reg(ARG2));
+    m_assembler.mov(reg(ARGUMENTS), reg(ARG3));
+    m_assembler.jump(reg(ARG0));
+}
+
+bool Compiler::compile_instruction(Bytecode::Instruction const& instruction)
+{
+    switch (instruction.type()) {
+#define __BYTECODE_OP(op)                   \
+    case Bytecode::Instruction::Type::op: \
+        return compile(static_cast<Bytecode::Op::op const&>(instruction));
+        ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+    }
+    VERIFY_NOT_REACHED();
+}
+
+Assembler::Label& Compiler::label_for(Bytecode::Label const& label)
+{
+    auto it = m_block_labels.find(label.address());
+    if (it == m_block_labels.end()) {
+        // NOTE: This makes the compilation fail once it's done, until then any label will do.
+        m_has_unknown_jump_target = true;
+        return m_exit_label;
+    }
+    return it->value;
+}
+
+void Compiler::load_operand(Reg dst, Bytecode::Operand operand)
+{
+    m_assembler.mov(reg(dst), Assembler::Operand::Mem64BaseAndOffset(REGISTERS_AND_CONSTANTS_AND_LOCALS, operand.index() * sizeof(Value)));
+}
+
+void Compiler::store_operand(Bytecode::Operand operand, Reg src)
+{
+    m_assembler.mov(Assembler::Operand::Mem64BaseAndOffset(REGISTERS_AND_CONSTANTS_AND_LOCALS, operand.index() * sizeof(Value)), reg(src));
+}
+
+void Compiler::jump_if_not_int32(Reg value, Assembler::Label& label)
+{
+    m_assembler.mov(reg(SCRATCH), reg(value));
+    m_assembler.shift_right(reg(SCRATCH), imm(TAG_SHIFT));
+    m_assembler.jump_if(reg(SCRATCH), Condition::NotEqualTo, imm(INT32_TAG), label);
+}
+
+void Compiler::box_int32(Reg value)
+{
+    // NOTE: This expects the upper half of the register to be zero, which any 32-bit operation leaves it as.
+    m_assembler.mov(reg(SCRATCH), imm(SHIFTED_INT32_TAG));
+    m_assembler.bitwise_or(reg(value), reg(SCRATCH));
+}
+
+void Compiler::call_with_instruction(u64 function, Bytecode::Instruction const& instruction)
+{
+    m_assembler.mov(reg(ARG0), reg(INTERPRETER));
+    m_assembler.mov(reg(ARG1), imm(bit_cast<FlatPtr>(&instruction)));
+    m_assembler.native_call(function);
+}
+
+void Compiler::jump_to_result_unless_null()
+{
+    Assembler::Label next;
+    m_assembler.jump_if(reg(RETURN_VALUE), Condition::EqualTo, imm(0), next);
+    m_assembler.jump(reg(RETURN_VALUE));
+    next.link(m_assembler);
+}
+
+template<typename OpType>
+bool Compiler::compile(OpType const& instruction)
+{
+    if constexpr (requires(Bytecode::Interpreter& interpreter) { instruction.execute_impl(interpreter); }) {
+        compile_call_to_interpreter(instruction);
+        return true;
+    } else {
+        return false;
+    }
+}
+
+template<typename OpType>
+void Compiler::compile_call_to_interpreter(OpType const& instruction)
+{
+    call_with_instruction(bit_cast<u64>(&cxx_execute<OpType>), instruction);
+    if constexpr (OpType::IsTerminator)
+        m_assembler.jump(reg(RETURN_VALUE));
+    else if constexpr (can_throw<OpType>)
+        jump_to_result_unless_null();
+}
+
+bool Compiler::compile(Bytecode::Op::Mov const& instruction)
+{
+    load_operand(GPR0, instruction.src());
+    store_operand(instruction.dst(), GPR0);
+    return true;
+}
+
+bool Compiler::compile(Bytecode::Op::GetArgument const& instruction)
+{
+    m_assembler.mov(reg(GPR0), Assembler::Operand::Mem64BaseAndOffset(ARGUMENTS, instruction.index() * sizeof(Value)));
+    store_operand(instruction.dst(), GPR0);
+    return true;
+}
+
+bool Compiler::compile(Bytecode::Op::SetArgument const& instruction)
+{
+    load_operand(GPR0, instruction.src());
+    m_assembler.mov(Assembler::Operand::Mem64BaseAndOffset(ARGUMENTS, instruction.index() * sizeof(Value)), reg(GPR0));
+    return true;
+}
+
+bool Compiler::compile(Bytecode::Op::End const& instruction)
+{
+    load_operand(GPR0, instruction.value());
+    store_operand(Bytecode::Operand(Bytecode::Register::accumulator()), GPR0);
+    m_assembler.jump(m_exit_label);
+    return true;
+}
+
+bool Compiler::compile(Bytecode::Op::Jump const& instruction)
+{
+    m_assembler.jump(label_for(instruction.target()));
+    return true;
+}
+
+void Compiler::compile_to_boolean_jump(Bytecode::Operand condition, Assembler::Label& true_target, Assembler::Label& false_target)
+{
+    Assembler::Label not_boolean;
+    Assembler::Label slow_case;
+
+    load_operand(GPR0, condition);
+    m_assembler.mov(reg(SCRATCH), reg(GPR0));
+    m_assembler.shift_right(reg(SCRATCH), imm(TAG_SHIFT));
+
+    m_assembler.jump_if(reg(SCRATCH), Condition::NotEqualTo, imm(BOOLEAN_TAG), not_boolean);
+    m_assembler.test(reg(GPR0), imm(1));
+    m_assembler.jump_if(Condition::NotEqualTo, true_target);
+    m_assembler.jump(false_target);
+
+    not_boolean.link(m_assembler);
+    m_assembler.jump_if(reg(SCRATCH), Condition::NotEqualTo, imm(INT32_TAG), slow_case);
+    m_assembler.mov32(reg(GPR0), reg(GPR0));
+    m_assembler.jump_if(reg(GPR0), Condition::NotEqualTo, imm(0), true_target);
+    m_assembler.jump(false_target);
+
+    slow_case.link(m_assembler);
+    m_assembler.mov(reg(ARG0), reg(REGISTERS_AND_CONSTANTS_AND_LOCALS));
+    m_assembler.mov(reg(ARG1), imm(condition.index()));
+    m_assembler.native_call(bit_cast<u64>(&cxx_to_boolean));
+    m_assembler.jump_if(reg(RETURN_VALUE), Condition::NotEqualTo, imm(0), true_target);
+    m_assembler.jump(false_target);
+}
+
+bool Compiler::compile(Bytecode::Op::JumpIf const& instruction)
+{
+    compile_to_boolean_jump(instruction.condition(), label_for(instruction.true_target()), label_for(instruction.false_target()));
+    return true;
+}
+
+bool Compiler::compile(Bytecode::Op::JumpTrue const& instruction)
+{
+    Assembler::Label next;
+    compile_to_boolean_jump(instruction.condition(), label_for(instruction.target()), next);
+    next.link(m_assembler);
+    return true;
+}
+
+bool Compiler::compile(Bytecode::Op::JumpFalse const& instruction)
+{
+    Assembler::Label next;
+    compile_to_boolean_jump(instruction.condition(), next, label_for(instruction.target()));
+    next.link(m_assembler);
+    return true;
+}
+
+bool Compiler::compile(Bytecode::Op::JumpNullish const& instruction)
+{
+    load_operand(GPR0, instruction.condition());
+    m_assembler.shift_right(reg(GPR0), imm(TAG_SHIFT));
+    m_assembler.bitwise_and(reg(GPR0), imm(IS_NULLISH_EXTRACT_PATTERN));
+    m_assembler.jump_if(reg(GPR0), Condition::EqualTo, imm(IS_NULLISH_PATTERN), label_for(instruction.true_target()));
+    m_assembler.jump(label_for(instruction.false_target()));
+    return true;
+}
+
+bool Compiler::compile(Bytecode::Op::JumpUndefined const& instruction)
+{
+    load_operand(GPR0, instruction.condition());
+    m_assembler.shift_right(reg(GPR0), imm(TAG_SHIFT));
+    m_assembler.jump_if(reg(GPR0), Condition::EqualTo, imm(UNDEFINED_TAG), label_for(instruction.true_target()));
+    m_assembler.jump(label_for(instruction.false_target()));
+    return true;
+}
+
+bool Compiler::compile(Bytecode::Op::EnterUnwindContext const& instruction)
+{
+    m_assembler.mov(reg(ARG0), reg(INTERPRETER));
+    m_assembler.native_call(bit_cast<u64>(&cxx_enter_unwind_context));
+    m_assembler.jump(label_for(instruction.entry_point()));
+    return true;
+}
+
+template<typename OpType, typename EmitOperation>
+void Compiler::compile_int32_fast_path(OpType const& instruction, Bytecode::Operand dst, Bytecode::Operand lhs, Optional<Bytecode::Operand> rhs, EmitOperation emit_operation)
+{
+    Assembler::Label slow_case;
+    Assembler::Label done;
+
+    load_operand(GPR0, lhs);
+    jump_if_not_int32(GPR0, slow_case);
+    if (rhs.has_value()) {
+        load_operand(GPR1, *rhs);
+        jump_if_not_int32(GPR1, slow_case);
+    }
+
+    // NOTE: The operation jumps to the slow case if it overflows, which then starts over from the operands.
+    emit_operation(slow_case);
+    box_int32(GPR0);
+    store_operand(dst, GPR0);
+    m_assembler.jump(done);
+
+    slow_case.link(m_assembler);
+    compile_call_to_interpreter(instruction);
+    done.link(m_assembler);
+}
+
+bool Compiler::compile(Bytecode::Op::Increment const& instruction)
+{
+    compile_int32_fast_path(instruction, instruction.dst(), instruction.dst(), {}, [&](Assembler::Label& overflow) {
+        m_assembler.inc32(reg(GPR0), overflow);
+    });
+    return true;
+}
+
+bool Compiler::compile(Bytecode::Op::Decrement const& instruction)
+{
+    compile_int32_fast_path(instruction, instruction.dst(), instruction.dst(), {}, [&](Assembler::Label& overflow) {
+        m_assembler.dec32(reg(GPR0), overflow);
+    });
+    return true;
+}
+
+bool Compiler::compile(Bytecode::Op::Add const& instruction)
+{
+    compile_int32_fast_path(instruction, instruction.dst(), instruction.lhs(), instruction.rhs(), [&](Assembler::Label& overflow) {
+        m_assembler.add32(reg(GPR0), reg(GPR1), overflow);
+    });
+    return true;
+}
+
+bool Compiler::compile(Bytecode::Op::Sub const& instruction)
+{
+    compile_int32_fast_path(instruction, instruction.dst(), instruction.lhs(), instruction.rhs(), [&](Assembler::Label& overflow) {
+        m_assembler.sub32(reg(GPR0), reg(GPR1), overflow);
+    });
+    return true;
+}
+
+template<typename OpType>
+bool Compiler::compile_comparison_jump(OpType const& instruction, Condition condition)
+{
+    auto& true_target = label_for(instruction.true_target());
+    auto& false_target = label_for(instruction.false_target());
+    Assembler::Label slow_case;
+
+    load_operand(GPR0, instruction.lhs());
+    load_operand(GPR1, instruction.rhs());
+    jump_if_not_int32(GPR0, slow_case);
+    jump_if_not_int32(GPR1, slow_case);
+    m_assembler.sign_extend_32_to_64_bits(GPR0);
+    m_assembler.sign_extend_32_to_64_bits(GPR1);
+    m_assembler.cmp(reg(GPR0), reg(GPR1));
+    m_assembler.jump_if(condition, true_target);
+    m_assembler.jump(false_target);
+
+    // The slow case returns 0 or 1 for the result of the comparison, or where to continue if it threw.
+    slow_case.link(m_assembler);
+    call_with_instruction(bit_cast<u64>(&cxx_evaluate_condition<OpType>), instruction);
+    m_assembler.jump_if(reg(RETURN_VALUE), Condition::EqualTo, imm(0), false_target);
+    m_assembler.jump_if(reg(RETURN_VALUE), Condition::EqualTo, imm(1), true_target);
+    m_assembler.jump(reg(RETURN_VALUE));
+    return true;
+}
+
+bool Compiler::compile(Bytecode::Op::JumpLessThan const& instruction)
+{
+    return compile_comparison_jump(instruction, Condition::SignedLessThan);
+}
+
+bool Compiler::compile(Bytecode::Op::JumpLessThanEquals const& instruction)
+{
+    return compile_comparison_jump(instruction, Condition::SignedLessThanOrEqualTo);
+}
+
+bool Compiler::compile(Bytecode::Op::JumpGreaterThan const& instruction)
+{
+    return compile_comparison_jump(instruction, Condition::SignedGreaterThan);
+}
+
+bool Compiler::compile(Bytecode::Op::JumpGreaterThanEquals const& instruction)
+{
+    return compile_comparison_jump(instruction, Condition::SignedGreaterThanOrEqualTo);
+}
+
+// NOTE: Two int32 values are equal in every kind of equality if they are the same number.
+bool Compiler::compile(Bytecode::Op::JumpLooselyEquals const& instruction)
+{
+    return compile_comparison_jump(instruction, Condition::EqualTo);
+}
+
+bool Compiler::compile(Bytecode::Op::JumpLooselyInequals const& instruction)
+{
+    return compile_comparison_jump(instruction, Condition::NotEqualTo);
+}
+
+bool Compiler::compile(Bytecode::Op::JumpStrictlyEquals const& instruction)
+{
+    return compile_comparison_jump(instruction, Condition::EqualTo);
+}
+
+bool Compiler::compile(Bytecode::Op::JumpStrictlyInequals const& instruction)
+{
+    return compile_comparison_jump(instruction, Condition::NotEqualTo);
+}
+
+void Compiler::set_program_counter(Bytecode::Interpreter& interpreter, Bytecode::Instruction const& instruction)
+{
+    interpreter.m_program_counter.value() = reinterpret_cast<u8 const*>(&instruction) - interpreter.current_executable().bytecode.data();
+}
+
+u8 const* Compiler::handle_exception(Bytecode::Interpreter& interpreter, Value exception)
+{
+    auto const& native_executable = *interpreter.current_executable().native_executable();
+    auto& program_counter = interpreter.m_program_counter.value();
+    if (interpreter.handle_exception(program_counter, exception) == Bytecode::Interpreter::HandleExceptionResponse::ExitFromExecutable)
+        return native_executable.exit_address();
+    return native_executable.address_of_block(program_counter);
+}
+
+template<typename OpType>
+u8 const* Compiler::cxx_execute(Bytecode::Interpreter& interpreter, OpType const& instruction)
+{
+    set_program_counter(interpreter, instruction);
+    if constexpr (can_throw<OpType>) {
+        auto result = instruction.execute_impl(interpreter);
+        if (result.is_error())
+            return handle_exception(interpreter, result.error_value());
+    } else {
+        instruction.execute_impl(interpreter);
+    }
+
+    // NOTE: The instructions that end a block without jumping anywhere (like Return and Yield) leave the executable.
+    if constexpr (OpType::IsTerminator)
+        return interpreter.current_executable().native_executable()->exit_address();
+    return nullptr;
+}
+
+template<typename OpType>
+u64 Compiler::cxx_evaluate_condition(Bytecode::Interpreter& interpreter, OpType const& instruction)
+{
+    set_program_counter(interpreter, instruction);
+    auto result = instruction.evaluate_condition(interpreter);
+    if (result.is_error())
+        return bit_cast<FlatPtr>(handle_exception(interpreter, result.error_value()));
+    return result.value() ? 1 : 0;
+}
+
+u64 Compiler::cxx_to_boolean(Value const* registers_and_constants_and_locals, u64 index)
+{
+    return registers_and_constants_and_locals[index].to_boolean() ? 1 : 0;
+}
+
+void Compiler::cxx_enter_unwind_context(Bytecode::Interpreter& interpreter)
+{
+    interpreter.enter_unwind_context();
+}
+
+#else
+
+OwnPtr<NativeExecutable> Compiler::compile(Bytecode::Executable&)
+{
+    return nullptr;
+}
+
+#endif
+
+}
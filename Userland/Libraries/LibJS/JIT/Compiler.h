@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/OwnPtr.h>
+#include <AK/Vector.h>
+#include <LibJIT/Assembler.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/JIT/NativeExecutable.h>
+
+namespace JS::JIT {
+
+// A baseline compiler, which turns a Bytecode::Executable into machine code that does exactly what the interpreter
+// would do. Most instructions become a call to the interpreter's implementation of them (which still saves the
+// dispatch between them), while moves, jumps and the arithmetic on int32 values get a fast path in machine code.
+// Executables with an instruction that the compiler doesn't support keep running in the interpreter.
+class Compiler {
+public:
+    // How many calls and loop iterations an executable goes through in the interpreter before it's compiled.
+    static constexpr u32 hotness_threshold = 500;
+
+    static OwnPtr<NativeExecutable> compile(Bytecode::Executable&);
+
+#ifdef JIT_ARCH_SUPPORTED
+private:
+    using Assembler = ::JIT::Assembler;
+
+    explicit Compiler(Bytecode::Executable& executable)
+        : m_executable(executable)
+        , m_assembler(m_output)
+    {
+    }
+
+    OwnPtr<NativeExecutable> compile_executable();
+    void compile_entry();
+    bool compile_instruction(Bytecode::Instruction const&);
+
+    bool compile(Bytecode::Op::Mov const&);
+    bool compile(Bytecode::Op::GetArgument const&);
+    bool compile(Bytecode::Op::SetArgument const&);
+    bool compile(Bytecode::Op::End const&);
+    bool compile(Bytecode::Op::Jump const&);
+    bool compile(Bytecode::Op::JumpIf const&);
+    bool compile(Bytecode::Op::JumpTrue const&);
+    bool compile(Bytecode::Op::JumpFalse const&);
+    bool compile(Bytecode::Op::JumpNullish const&);
+    bool compile(Bytecode::Op::JumpUndefined const&);
+    bool compile(Bytecode::Op::EnterUnwindContext const&);
+    bool compile(Bytecode::Op::Increment const&);
+    bool compile(Bytecode::Op::Decrement const&);
+    bool compile(Bytecode::Op::Add const&);
+    bool compile(Bytecode::Op::Sub const&);
+#define JS_DECLARE_COMPILE_COMPARISON_JUMP(op_TitleCase, op_snake_case, numeric_operator) \
+    bool compile(Bytecode::Op::Jump##op_TitleCase const&);
+    JS_ENUMERATE_COMPARISON_OPS(JS_DECLARE_COMPILE_COMPARISON_JUMP)
+#undef JS_DECLARE_COMPILE_COMPARISON_JUMP
+
+    // Any other instruction calls into the interpreter's implementation of it, if it has one.
+    template<typename OpType>
+    bool compile(OpType const&);
+
+    template<typename OpType>
+    void compile_call_to_interpreter(OpType const&);
+    template<typename OpType, typename EmitOperation>
+    void compile_int32_fast_path(OpType const&, Bytecode::Operand dst, Bytecode::Operand lhs, Optional<Bytecode::Operand> rhs, EmitOperation);
+    template<typename OpType>
+    bool compile_comparison_jump(OpType const&, Assembler::Condition);
+    void compile_to_boolean_jump(Bytecode::Operand condition, Assembler::Label& true_target, Assembler::Label& false_target);
+
+    void load_operand(Assembler::Reg, Bytecode::Operand);
+    void store_operand(Bytecode::Operand, Assembler::Reg);
+    void jump_if_not_int32(Assembler::Reg, Assembler::Label&);
+    void box_int32(Assembler::Reg);
+    void call_with_instruction(u64 function, Bytecode::Instruction const&);
+    void jump_to_result_unless_null();
+
+    Assembler::Label& label_for(Bytecode::Label const&);
+
+    // These are called from the machine code. Those that can throw return where to continue in the machine code.
+    template<typename OpType>
+    static u8 const* cxx_execute(Bytecode::Interpreter&, OpType const&);
+    template<typename OpType>
+    static u64 cxx_evaluate_condition(Bytecode::Interpreter&, OpType const&);
+    static u64 cxx_to_boolean(Value const* registers_and_constants_and_locals, u64 index);
+    static void cxx_enter_unwind_context(Bytecode::Interpreter&);
+
+    static void set_program_counter(Bytecode::Interpreter&, Bytecode::Instruction const&);
+    static u8 const* handle_exception(Bytecode::Interpreter&, Value exception);
+
+    Bytecode::Executable& m_executable;
+    Vector<u8> m_output;
+    Assembler m_assembler;
+
+    HashMap<size_t, Assembler::Label> m_block_labels;
+    Assembler::Label m_exit_label;
+    bool m_has_unknown_jump_target { false };
+#endif
+};
+
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/TemporaryChange.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/JIT/NativeExecutable.h>
+#include <LibJS/Runtime/Error.h>
+#include <sys/mman.h>
+
+namespace JS::JIT {
+
+// The arguments that the machine code is entered with, see Compiler::compile_entry().
+using EntryPoint = void (*)(u8 const* block, Value* registers_and_constants_and_locals, Bytecode::Interpreter*, Value* arguments);
+
+OwnPtr<NativeExecutable> NativeExecutable::create(ReadonlyBytes machine_code, BlockOffsets block_offsets, size_t exit_offset)
+{
+    auto* memory = mmap(nullptr, machine_code.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        dbgln("JIT: Failed to map memory for native code: {}", AK::Error::from_errno(errno));
+        return nullptr;
+    }
+    memcpy(memory, machine_code.data(), machine_code.size());
+
+    if (mprotect(memory, machine_code.size(), PROT_READ | PROT_EXEC) < 0) {
+        dbgln("JIT: Failed to make native code executable: {}", AK::Error::from_errno(errno));
+        munmap(memory, machine_code.size());
+        return nullptr;
+    }
+
+    auto* native_executable = new (nothrow) NativeExecutable(static_cast<u8*>(memory), machine_code.size(), move(block_offsets), exit_offset);
+    if (!native_executable)
+        munmap(memory, machine_code.size());
+    return adopt_own_if_nonnull(native_executable);
+}
+
+NativeExecutable::NativeExecutable(u8* code, size_t size, BlockOffsets block_offsets, size_t exit_offset)
+    : m_code(code)
+    , m_size(size)
+    , m_block_offsets(move(block_offsets))
+    , m_exit_offset(exit_offset)
+{
+}
+
+NativeExecutable::~NativeExecutable()
+{
+    munmap(m_code, m_size);
+}
+
+u8 const* NativeExecutable::address_of_block(size_t bytecode_offset) const
+{
+    return m_code + m_block_offsets.get(bytecode_offset).value();
+}
+
+void NativeExecutable::run(Bytecode::Interpreter& interpreter, size_t entry_point) const
+{
+    auto& vm = interpreter.vm();
+    if (vm.did_reach_stack_space_limit()) {
+        interpreter.reg(Bytecode::Register::exception()) = vm.throw_completion<InternalError>(ErrorType::CallStackSizeExceeded).release_value().value();
+        return;
+    }
+
+    // NOTE: The machine code keeps this up to date whenever it calls into anything that may observe it.
+    size_t program_counter = entry_point;
+    TemporaryChange change(interpreter.m_program_counter, Optional<size_t&>(program_counter));
+
+    auto entry = reinterpret_cast<EntryPoint>(m_code);
+    entry(address_of_block(entry_point), interpreter.m_registers_and_constants_and_locals.data(), &interpreter, interpreter.m_arguments.data());
+}
+
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/OwnPtr.h>
+#include <AK/Span.h>
+#include <LibJS/Forward.h>
+
+namespace JS::JIT {
+
+// The machine code that a Bytecode::Executable has been compiled to. It works on the same registers, locals and
+// constants as the interpreter does, so execution can move from the interpreter into native code at the start of
+// any basic block.
+class NativeExecutable {
+    AK_MAKE_NONCOPYABLE(NativeExecutable);
+    AK_MAKE_NONMOVABLE(NativeExecutable);
+
+public:
+    // Maps the bytecode offset of each basic block to the offset of its machine code.
+    using BlockOffsets = HashMap<size_t, size_t>;
+
+    static OwnPtr<NativeExecutable> create(ReadonlyBytes machine_code, BlockOffsets, size_t exit_offset);
+    ~NativeExecutable();
+
+    [[nodiscard]] bool can_enter_at(size_t bytecode_offset) const { return m_block_offsets.contains(bytecode_offset); }
+
+    // Runs the executable from the basic block at the given bytecode offset, with the interpreter's current state.
+    void run(Bytecode::Interpreter&, size_t entry_point) const;
+
+    [[nodiscard]] u8 const* address_of_block(size_t bytecode_offset) const;
+    [[nodiscard]] u8 const* exit_address() const { return m_code + m_exit_offset; }
+
+private:
+    NativeExecutable(u8* code, size_t size, BlockOffsets, size_t exit_offset);
+
+    u8* m_code { nullptr };
+    size_t m_size { 0 };
+    BlockOffsets m_block_offsets;
+    size_t m_exit_offset { 0 };
+};
+
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/AST.h>
+#include <LibJS/ProgramCache.h>
+#include <LibJS/SourceCode.h>
+
+namespace JS {
+
+ProgramCache::ProgramCache() = default;
+ProgramCache::~ProgramCache() = default;
+
+RefPtr<Program> ProgramCache::find(StringView source_text, StringView filename, size_t line_number_offset)
+{
+    auto source_hash = source_text.hash();
+
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        auto& entry = m_entries[i];
+        if (entry.source_hash != source_hash || entry.line_number_offset != line_number_offset || entry.filename != filename)
+            continue;
+        if (entry.program->source_code().code().bytes_as_string_view() != source_text)
+            continue;
+
+        auto program = entry.program;
+        m_entries.append(m_entries.take(i));
+        return program;
+    }
+
+    return nullptr;
+}
+
+void ProgramCache::add(StringView source_text, StringView filename, size_t line_number_offset, NonnullRefPtr<Program> program)
+{
+    if (source_text.length() > max_total_source_length)
+        return;
+
+    while (!m_entries.is_empty() && m_total_source_length + source_text.length() > max_total_source_length)
+        m_total_source_length -= m_entries.take_first().source_length;
+
+    m_entries.append({ source_text.hash(), source_text.length(), filename, line_number_offset, move(program) });
+    m_total_source_length += source_text.length();
+}
+
+void ProgramCache::clear()
+{
+    m_entries.clear();
+    m_total_source_length = 0;
+}
+
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteString.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/RefPtr.h>
+#include <AK/Vector.h>
+#include <LibJS/Forward.h>
+
+namespace JS {
+
+// Keeps the parse trees of recently parsed scripts around, so a script that is parsed again (e.g. when a page is
+// reloaded, or another page loads the same library) doesn't have to be. Functions keep their bytecode on the nodes
+// of the parse tree, so reusing it skips most of the code generation as well.
+class ProgramCache {
+public:
+    // NOTE: Parse trees take up a lot more memory than the source text itself, so this is kept fairly small.
+    static constexpr size_t max_total_source_length = 16 * MiB;
+
+    ProgramCache();
+    ~ProgramCache();
+
+    RefPtr<Program> find(StringView source_text, StringView filename, size_t line_number_offset);
+    void add(StringView source_text, StringView filename, size_t line_number_offset, NonnullRefPtr<Program>);
+
+    void clear();
+
+private:
+    struct Entry {
+        unsigned source_hash { 0 };
+        size_t source_length { 0 };
+        ByteString filename;
+        size_t line_number_offset { 0 };
+        NonnullRefPtr<Program> program;
+    };
+
+    // Least recently used first.
+    Vector<Entry> m_entries;
+    size_t m_total_source_length { 0 };
+};
+
+}
@@ -31,6 +31,24 @@ JS_DEFINE_ALLOCATOR(ArrayPrototype);
 
 static HashTable<NonnullGCPtr<Object>> s_array_join_seen_objects;
 
+// OPTIMIZATION: The elements of an object that only holds numbers without any holes in between are all plain own data
+//               properties, so searching through them doesn't need to go through [[HasProperty]] and [[Get]] for each.
+static SimpleIndexedPropertyStorage const* packed_number_elements(Object const& object, u64 length)
+{
+    if (object.may_interfere_with_indexed_property_access())
+        return nullptr;
+
+    auto const* storage = object.indexed_properties().storage();
+    if (!storage || !storage->is_simple_storage())
+        return nullptr;
+
+    auto const& simple_storage = static_cast<SimpleIndexedPropertyStorage const&>(*storage);
+    if (!simple_storage.contains_only_numbers() || simple_storage.is_holey() || simple_storage.array_like_size() < length)
+        return nullptr;
+
+    return &simple_storage;
+}
+
 ArrayPrototype::ArrayPrototype(Realm& realm)
     : Array(realm.intrinsics().object_prototype())
 {
@@ -742,6 +760,28 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::includes)
             from_index = from_argument;
     }
     auto value_to_find = vm.argument(0);
+
+    if (auto const* storage = packed_number_elements(this_object, length)) {
+        if (!value_to_find.is_number())
+            return Value(false);
+        auto const* elements = storage->elements().data();
+        if (value_to_find.is_nan()) {
+            if (storage->element_kind() == SimpleIndexedPropertyStorage::ElementKind::Int32)
+                return Value(false);
+            for (u64 i = from_index; i < length; ++i) {
+                if (elements[i].is_nan())
+                    return Value(true);
+            }
+            return Value(false);
+        }
+        auto number_to_find = value_to_find.as_double();
+        for (u64 i = from_index; i < length; ++i) {
+            if (elements[i].as_double() == number_to_find)
+                return Value(true);
+        }
+        return Value(false);
+    }
+
     for (u64 i = from_index; i < length; ++i) {
         auto element = TRY(this_object->get(i));
         if (same_value_zero(element, value_to_find))
@@ -795,6 +835,19 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::index_of)
         k = max(length + n, 0);
     }
 
+    if (auto const* storage = packed_number_elements(object, length)) {
+        // NOTE: IsStrictlyEqual is never true for NaN, or for a number and a value of another type.
+        if (!search_element.is_number() || search_element.is_nan())
+            return Value(-1);
+        auto const* elements = storage->elements().data();
+        auto number_to_find = search_element.as_double();
+        for (; k < length; ++k) {
+            if (elements[k].as_double() == number_to_find)
+                return Value(k);
+        }
+        return Value(-1);
+    }
+
     // 10. Repeat, while k < len,
     for (; k < length; ++k) {
         auto property_key = PropertyKey { k };
@@ -906,6 +959,19 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::last_index_of)
         k = (double)length + n;
     }
 
+    if (auto const* storage = packed_number_elements(object, length)) {
+        // NOTE: IsStrictlyEqual is never true for NaN, or for a number and a value of another type.
+        if (!search_element.is_number() || search_element.is_nan())
+            return Value(-1);
+        auto const* elements = storage->elements().data();
+        auto number_to_find = search_element.as_double();
+        for (; k >= 0; --k) {
+            if (elements[static_cast<size_t>(k)].as_double() == number_to_find)
+                return Value((size_t)k);
+        }
+        return Value(-1);
+    }
+
     // 8. Repeat, while k ≥ 0,
     for (; k >= 0; --k) {
         auto property_key = PropertyKey { k };
@@ -48,68 +48,90 @@ ThrowCompletionOr<void> AsyncFunctionDriverWrapper::await(JS::Value value)
     if (!m_suspended_execution_context)
         m_suspended_execution_context = vm.running_execution_context().copy();
 
+    // OPTIMIZATION: Awaiting a value that isn't an object can't run any user code, and neither can awaiting a %Promise%
+    //               that has already settled once PromiseResolve() has returned it. In both cases, all that steps 2-7
+    //               end up doing is enqueueing a job that resumes us, so we enqueue one directly instead.
+    if (!value.is_object()) {
+        enqueue_resume_job(realm, value, true);
+        return {};
+    }
+
     // 2. Let promise be ? PromiseResolve(%Promise%, value).
     auto* promise_object = TRY(promise_resolve(vm, realm.intrinsics().promise_constructor(), value));
+    auto& promise = verify_cast<Promise>(*promise_object);
+
+    if (promise.state() != Promise::State::Pending) {
+        if (promise.state() == Promise::State::Rejected && !promise.is_handled())
+            vm.host_promise_rejection_tracker(promise, Promise::RejectionOperation::Handle);
+        promise.set_is_handled();
 
-    // 3. Let fulfilledClosure be a new Abstract Closure with parameters (v) that captures asyncContext and performs the
-    //    following steps when called:
-    auto fulfilled_closure = [this](VM& vm) -> ThrowCompletionOr<Value> {
-        auto value = vm.argument(0);
+        m_current_promise = nullptr;
+        enqueue_resume_job(realm, promise.result(), promise.state() == Promise::State::Fulfilled);
+        return {};
+    }
+
+    // NOTE: The closures don't capture anything that changes from one await to the next, so they are only created once.
+    if (!m_on_fulfilled) {
+        // 3. Let fulfilledClosure be a new Abstract Closure with parameters (v) that captures asyncContext and performs the
+        //    following steps when called:
+        auto fulfilled_closure = [this](VM& vm) -> ThrowCompletionOr<Value> {
+            auto value = vm.argument(0);
 
-        // a. Let prevContext be the running execution context.
-        auto& prev_context = vm.running_execution_context();
+            // a. Let prevContext be the running execution context.
+            auto& prev_context = vm.running_execution_context();
 
-        // FIXME: b. Suspend prevContext.
+            // FIXME: b. Suspend prevContext.
 
-        // c. Push asyncContext onto the execution context stack; asyncContext is now the running execution context.
-        TRY(vm.push_execution_context(*m_suspended_execution_context, {}));
+            // c. Push asyncContext onto the execution context stack; asyncContext is now the running execution context.
+            TRY(vm.push_execution_context(*m_suspended_execution_context, {}));
 
-        // d. Resume the suspended evaluation of asyncContext using NormalCompletion(v) as the result of the operation that
-        //    suspended it.
-        continue_async_execution(vm, value, true);
+            // d. Resume the suspended evaluation of asyncContext using NormalCompletion(v) as the result of the operation that
+            //    suspended it.
+            continue_async_execution(vm, value, true);
 
-        // e. Assert: When we reach this step, asyncContext has already been removed from the execution context stack and
-        //    prevContext is the currently running execution context.
-        VERIFY(&vm.running_execution_context() == &prev_context);
+            // e. Assert: When we reach this step, asyncContext has already been removed from the execution context stack and
+            //    prevContext is the currently running execution context.
+            VERIFY(&vm.running_execution_context() == &prev_context);
 
-        // f. Return undefined.
-        return js_undefined();
-    };
+            // f. Return undefined.
+            return js_undefined();
+        };
 
-    // 4. Let onFulfilled be CreateBuiltinFunction(fulfilledClosure, 1, "", « »).
-    auto on_fulfilled = NativeFunction::create(realm, move(fulfilled_closure), 1, "");
+        // 4. Let onFulfilled be CreateBuiltinFunction(fulfilledClosure, 1, "", « »).
+        m_on_fulfilled = NativeFunction::create(realm, move(fulfilled_closure), 1, "");
 
-    // 5. Let rejectedClosure be a new Abstract Closure with parameters (reason) that captures asyncContext and performs the
-    //    following steps when called:
-    auto rejected_closure = [this](VM& vm) -> ThrowCompletionOr<Value> {
-        auto reason = vm.argument(0);
+        // 5. Let rejectedClosure be a new Abstract Closure with parameters (reason) that captures asyncContext and performs the
+        //    following steps when called:
+        auto rejected_closure = [this](VM& vm) -> ThrowCompletionOr<Value> {
+            auto reason = vm.argument(0);
 
-        // a. Let prevContext be the running execution context.
-        auto& prev_context = vm.running_execution_context();
+            // a. Let prevContext be the running execution context.
+            auto& prev_context = vm.running_execution_context();
 
-        // FIXME: b. Suspend prevContext.
+            // FIXME: b. Suspend prevContext.
 
-        // c. Push asyncContext onto the execution context stack; asyncContext is now the running execution context.
-        TRY(vm.push_execution_context(*m_suspended_execution_context, {}));
+            // c. Push asyncContext onto the execution context stack; asyncContext is now the running execution context.
+            TRY(vm.push_execution_context(*m_suspended_execution_context, {}));
 
-        // d. Resume the suspended evaluation of asyncContext using ThrowCompletion(reason) as the result of the operation that
-        //    suspended it.
-        continue_async_execution(vm, reason, false);
+            // d. Resume the suspended evaluation of asyncContext using ThrowCompletion(reason) as the result of the operation that
+            //    suspended it.
+            continue_async_execution(vm, reason, false);
 
-        // e. Assert: When we reach this step, asyncContext has already been removed from the execution context stack and
-        //    prevContext is the currently running execution context.
-        VERIFY(&vm.running_execution_context() == &prev_context);
+            // e. Assert: When we reach this step, asyncContext has already been removed from the execution context stack and
+            //    prevContext is the currently running execution context.
+            VERIFY(&vm.running_execution_context() == &prev_context);
 
-        // f. Return undefined.
-        return js_undefined();
-    };
+            // f. Return undefined.
+            return js_undefined();
+        };
 
-    // 6. Let onRejected be CreateBuiltinFunction(rejectedClosure, 1, "", « »).
-    auto on_rejected = NativeFunction::create(realm, move(rejected_closure), 1, "");
+        // 6. Let onRejected be CreateBuiltinFunction(rejectedClosure, 1, "", « »).
+        m_on_rejected = NativeFunction::create(realm, move(rejected_closure), 1, "");
+    }
 
     // 7. Perform PerformPromiseThen(promise, onFulfilled, onRejected).
-    m_current_promise = verify_cast<Promise>(promise_object);
-    m_current_promise->perform_then(on_fulfilled, on_rejected, {});
+    m_current_promise = &promise;
+    m_current_promise->perform_then(m_on_fulfilled, m_on_rejected, {});
 
     // 8. Remove asyncContext from the execution context stack and restore the execution context that is at the top of the
     //    execution context stack as the running execution context.
@@ -123,6 +145,24 @@ ThrowCompletionOr<void> AsyncFunctionDriverWrapper::await(JS::Value value)
     return {};
 }
 
+void AsyncFunctionDriverWrapper::enqueue_resume_job(Realm& realm, Value value, bool is_successful)
+{
+    m_resume_value = value;
+    m_resume_is_successful = is_successful;
+
+    // NOTE: There is never more than one await in flight, so the same job can be reused for all of them.
+    if (!m_resume_job) {
+        m_resume_job = create_heap_function(heap(), [this]() -> ThrowCompletionOr<Value> {
+            auto& vm = this->vm();
+            TRY(vm.push_execution_context(*m_suspended_execution_context, {}));
+            continue_async_execution(vm, exchange(m_resume_value, js_undefined()), m_resume_is_successful);
+            return js_undefined();
+        });
+    }
+
+    vm().host_enqueue_promise_job(*m_resume_job, &realm);
+}
+
 void AsyncFunctionDriverWrapper::continue_async_execution(VM& vm, Value value, bool is_successful, IsInitialExecution is_initial_execution)
 {
     auto generator_result = is_successful
@@ -192,6 +232,10 @@ void AsyncFunctionDriverWrapper::visit_edges(Cell::Visitor& visitor)
     visitor.visit(m_top_level_promise);
     if (m_current_promise)
         visitor.visit(m_current_promise);
+    visitor.visit(m_on_fulfilled);
+    visitor.visit(m_on_rejected);
+    visitor.visit(m_resume_job);
+    visitor.visit(m_resume_value);
     if (m_suspended_execution_context)
         m_suspended_execution_context->visit_edges(visitor);
 }
@@ -8,6 +8,7 @@
 
 #include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Runtime/ECMAScriptFunctionObject.h>
+#include <LibJS/Heap/HeapFunction.h>
 #include <LibJS/Runtime/GeneratorObject.h>
 #include <LibJS/Runtime/Object.h>
 #include <LibJS/Runtime/Promise.h>
@@ -34,10 +35,16 @@ public:
 private:
     AsyncFunctionDriverWrapper(Realm&, NonnullGCPtr<GeneratorObject>, NonnullGCPtr<Promise> top_level_promise);
     ThrowCompletionOr<void> await(Value);
+    void enqueue_resume_job(Realm&, Value, bool is_successful);
 
     NonnullGCPtr<GeneratorObject> m_generator_object;
     NonnullGCPtr<Promise> m_top_level_promise;
     GCPtr<Promise> m_current_promise { nullptr };
+    GCPtr<NativeFunction> m_on_fulfilled;
+    GCPtr<NativeFunction> m_on_rejected;
+    GCPtr<HeapFunction<ThrowCompletionOr<Value>()>> m_resume_job;
+    Value m_resume_value;
+    bool m_resume_is_successful { true };
     Handle<AsyncFunctionDriverWrapper> m_self_handle;
     OwnPtr<ExecutionContext> m_suspended_execution_context;
 };
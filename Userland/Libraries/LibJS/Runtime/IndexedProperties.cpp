@@ -18,6 +18,12 @@ SimpleIndexedPropertyStorage::SimpleIndexedPropertyStorage(Vector<Value>&& initi
     , m_array_size(initial_values.size())
     , m_packed_elements(move(initial_values))
 {
+    for (auto value : m_packed_elements) {
+        if (value.is_empty())
+            m_is_holey = true;
+        else
+            update_element_kind(value);
+    }
 }
 
 bool SimpleIndexedPropertyStorage::has_index(u32 index) const
@@ -48,9 +54,16 @@ void SimpleIndexedPropertyStorage::put(u32 index, Value value, PropertyAttribute
     VERIFY(attributes == default_attributes);
 
     if (index >= m_array_size) {
+        if (index > m_array_size)
+            m_is_holey = true;
         m_array_size = index + 1;
         grow_storage_if_needed();
     }
+
+    if (value.is_empty())
+        m_is_holey = true;
+    else
+        update_element_kind(value);
     m_packed_elements[index] = value;
 }
 
@@ -58,6 +71,7 @@ void SimpleIndexedPropertyStorage::remove(u32 index)
 {
     VERIFY(index < m_array_size);
     m_packed_elements[index] = {};
+    m_is_holey = true;
 }
 
 ValueAndAttributes SimpleIndexedPropertyStorage::take_first()
@@ -76,6 +90,13 @@ ValueAndAttributes SimpleIndexedPropertyStorage::take_last()
 
 bool SimpleIndexedPropertyStorage::set_array_like_size(size_t new_size)
 {
+    if (new_size == 0) {
+        m_element_kind = ElementKind::Int32;
+        m_is_holey = false;
+    } else if (new_size > m_array_size) {
+        m_is_holey = true;
+    }
+
     m_array_size = new_size;
     m_packed_elements.resize_and_keep_capacity(new_size);
     return true;
@@ -56,6 +56,14 @@ private:
 
 class SimpleIndexedPropertyStorage final : public IndexedPropertyStorage {
 public:
+    // What kind of values the elements are known to be. This only ever moves from the more specific kinds towards
+    // Elements (except when the storage is emptied), so code that checks for a kind can rely on it for all elements.
+    enum class ElementKind : u8 {
+        Int32,
+        Double,
+        Elements,
+    };
+
     SimpleIndexedPropertyStorage()
         : IndexedPropertyStorage(IsSimpleStorage::Yes) {};
     explicit SimpleIndexedPropertyStorage(Vector<Value>&& initial_values);
@@ -74,6 +82,13 @@ public:
 
     Vector<Value> const& elements() const { return m_packed_elements; }
 
+    ElementKind element_kind() const { return m_element_kind; }
+    bool contains_only_numbers() const { return m_element_kind != ElementKind::Elements; }
+
+    // Whether any of the indices below the array-like size may be missing an element. This is conservative: filling
+    // in a hole doesn't make the storage packed again.
+    bool is_holey() const { return m_is_holey; }
+
     [[nodiscard]] bool inline_has_index(u32 index) const
     {
         return index < m_array_size && !m_packed_elements.data()[index].is_empty();
@@ -86,13 +101,31 @@ public:
         return ValueAndAttributes { m_packed_elements.data()[index], default_attributes };
     }
 
+    // Overwrites an element that is known to exist, without any of the bookkeeping needed to grow the storage.
+    void inline_put_existing(u32 index, Value value)
+    {
+        VERIFY(inline_has_index(index));
+        update_element_kind(value);
+        m_packed_elements.data()[index] = value;
+    }
+
 private:
     friend GenericIndexedPropertyStorage;
 
     void grow_storage_if_needed();
 
+    void update_element_kind(Value value)
+    {
+        if (m_element_kind == ElementKind::Int32 && !value.is_int32())
+            m_element_kind = value.is_number() ? ElementKind::Double : ElementKind::Elements;
+        else if (m_element_kind == ElementKind::Double && !value.is_number())
+            m_element_kind = ElementKind::Elements;
+    }
+
     size_t m_array_size { 0 };
     Vector<Value> m_packed_elements;
+    ElementKind m_element_kind { ElementKind::Int32 };
+    bool m_is_holey { false };
 };
 
 class GenericIndexedPropertyStorage final : public IndexedPropertyStorage {
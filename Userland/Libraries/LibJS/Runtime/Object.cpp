@@ -1416,9 +1416,13 @@ void Object::visit_edges(Cell::Visitor& visitor)
     visitor.visit(m_shape);
     visitor.visit(m_storage);
 
-    m_indexed_properties.for_each_value([&visitor](auto& value) {
-        visitor.visit(value);
-    });
+    // OPTIMIZATION: Elements that are all numbers don't point to any cells, so there's nothing to visit.
+    auto const* indexed_storage = m_indexed_properties.storage();
+    if (!indexed_storage || !indexed_storage->is_simple_storage() || !static_cast<SimpleIndexedPropertyStorage const&>(*indexed_storage).contains_only_numbers()) {
+        m_indexed_properties.for_each_value([&visitor](auto& value) {
+            visitor.visit(value);
+        });
+    }
 
     if (m_private_elements) {
         for (auto& private_element : *m_private_elements)
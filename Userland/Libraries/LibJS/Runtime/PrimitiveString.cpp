@@ -23,6 +23,8 @@ JS_DEFINE_ALLOCATOR(PrimitiveString);
 
 PrimitiveString::PrimitiveString(PrimitiveString& lhs, PrimitiveString& rhs)
     : m_is_rope(true)
+    , m_rope_depth(max(lhs.m_is_rope ? lhs.m_rope_depth : 0, rhs.m_is_rope ? rhs.m_rope_depth : 0) + 1)
+    , m_rope_length(lhs.approximate_length() + rhs.approximate_length())
     , m_lhs(&lhs)
     , m_rhs(&rhs)
 {
@@ -76,6 +78,19 @@ bool PrimitiveString::is_empty() const
     VERIFY_NOT_REACHED();
 }
 
+size_t PrimitiveString::approximate_length() const
+{
+    if (m_is_rope)
+        return m_rope_length;
+    if (has_utf8_string())
+        return m_utf8_string->bytes().size();
+    if (has_byte_string())
+        return m_byte_string->length();
+    if (has_utf16_string())
+        return m_utf16_string->length_in_code_units();
+    VERIFY_NOT_REACHED();
+}
+
 String PrimitiveString::utf8_string() const
 {
     resolve_rope_if_needed(EncodingPreference::UTF8);
@@ -243,7 +258,20 @@ NonnullGCPtr<PrimitiveString> PrimitiveString::create(VM& vm, PrimitiveString& l
     if (rhs_empty)
         return lhs;
 
-    return vm.heap().allocate_without_realm<PrimitiveString>(lhs, rhs);
+    auto rope = vm.heap().allocate_without_realm<PrimitiveString>(lhs, rhs);
+
+    // NOTE: Appending short strings in a loop builds a rope with one level per iteration, which keeps every one of
+    //       the pieces alive until the rope is finally resolved. Once a rope consists of mostly tiny pieces, we resolve
+    //       it right away. Since that only happens once there's been an append for every 16 characters of the result,
+    //       the copying works out to a constant amount per append.
+    static constexpr u32 minimum_rope_depth_to_resolve = 256;
+    static constexpr size_t minimum_average_piece_length = 16;
+    if (rope->m_rope_depth >= minimum_rope_depth_to_resolve && rope->m_rope_depth * minimum_average_piece_length > rope->m_rope_length) {
+        auto preference = rhs.has_utf16_string() && !rhs.has_utf8_string() ? EncodingPreference::UTF16 : EncodingPreference::UTF8;
+        rope->resolve_rope_if_needed(preference);
+    }
+
+    return rope;
 }
 
 void PrimitiveString::resolve_rope_if_needed(EncodingPreference preference) const
@@ -274,7 +302,12 @@ void PrimitiveString::resolve_rope_if_needed(EncodingPreference preference) cons
         // The caller wants a UTF-16 string, so we can simply concatenate all the pieces
         // into a UTF-16 code unit buffer and create a Utf16String from it.
 
+        size_t length_in_code_units = 0;
+        for (auto const* current : pieces)
+            length_in_code_units += current->utf16_string_view().length_in_code_units();
+
         Utf16Data code_units;
+        code_units.ensure_capacity(length_in_code_units);
         for (auto const* current : pieces)
             code_units.extend(current->utf16_string().string());
 
@@ -286,7 +319,11 @@ void PrimitiveString::resolve_rope_if_needed(EncodingPreference preference) cons
     }
 
     // Now that we have all the pieces, we can concatenate them using a StringBuilder.
-    StringBuilder builder;
+    // NOTE: Combining surrogate pairs only ever makes the result shorter, so this is enough to never have to grow the buffer.
+    size_t length_in_bytes = 0;
+    for (auto const* current : pieces)
+        length_in_bytes += current->utf8_string_view().length();
+    StringBuilder builder(length_in_bytes);
 
     // We keep track of the previous piece in order to handle surrogate pairs spread across two pieces.
     PrimitiveString const* previous = nullptr;
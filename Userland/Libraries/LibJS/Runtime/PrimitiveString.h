@@ -67,8 +67,15 @@ private:
     };
     void resolve_rope_if_needed(EncodingPreference) const;
 
+    // NOTE: This is measured in whatever unit the string is currently stored in, so it's only good for heuristics.
+    size_t approximate_length() const;
+
     mutable bool m_is_rope { false };
 
+    // The number of ropes on the longest path from this rope down to a resolved string.
+    u32 m_rope_depth { 0 };
+    size_t m_rope_length { 0 };
+
     mutable GCPtr<PrimitiveString> m_lhs;
     mutable GCPtr<PrimitiveString> m_rhs;
 
@@ -5,6 +5,7 @@
  */
 
 #include <LibJS/Heap/DeferGC.h>
+#include <LibJS/Heap/HeapBlock.h>
 #include <LibJS/Runtime/Shape.h>
 #include <LibJS/Runtime/VM.h>
 
@@ -21,31 +22,64 @@ Shape::~Shape()
         s_all_prototype_shapes.remove(this);
 }
 
+ShapeMemoryReport Shape::memory_report()
+{
+    ShapeMemoryReport report;
+    HashTable<PropertyTable const*> seen_property_tables;
+
+    Shape::cell_allocator.allocator.get().for_each_block([&](HeapBlock& block) {
+        block.for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
+            auto const& shape = static_cast<Shape const&>(*cell);
+            ++report.shapes;
+            if (shape.m_dictionary)
+                ++report.dictionary_shapes;
+            if (shape.m_is_prototype_shape)
+                ++report.prototype_shapes;
+
+            if (shape.m_property_table) {
+                ++report.shapes_with_property_table;
+                if (shape.m_property_table->ref_count() > 1)
+                    ++report.shapes_sharing_property_table;
+                if (seen_property_tables.set(shape.m_property_table.ptr()) == AK::HashSetResult::InsertedNewEntry) {
+                    ++report.property_tables;
+                    report.property_table_entries += shape.m_property_table->properties.size();
+                }
+            }
+
+            if (shape.m_forward_transition)
+                ++report.inline_forward_transitions;
+            if (shape.m_forward_transitions) {
+                ++report.forward_transition_tables;
+                report.forward_transition_table_entries += shape.m_forward_transitions->size();
+            }
+        });
+        return IterationDecision::Continue;
+    });
+
+    return report;
+}
+
 NonnullGCPtr<Shape> Shape::create_cacheable_dictionary_transition()
 {
-    auto new_shape = heap().allocate_without_realm<Shape>(m_realm);
+    auto new_shape = heap().allocate_without_realm<Shape>(*m_realm);
     new_shape->m_dictionary = true;
     new_shape->m_cacheable = true;
     new_shape->m_prototype = m_prototype;
     invalidate_prototype_if_needed_for_new_prototype(new_shape);
-    ensure_property_table();
-    new_shape->ensure_property_table();
-    (*new_shape->m_property_table) = *m_property_table;
-    new_shape->m_property_count = new_shape->m_property_table->size();
+    new_shape->m_property_table = copy_of_property_table();
+    new_shape->m_property_count = m_property_count;
     return new_shape;
 }
 
 NonnullGCPtr<Shape> Shape::create_uncacheable_dictionary_transition()
 {
-    auto new_shape = heap().allocate_without_realm<Shape>(m_realm);
+    auto new_shape = heap().allocate_without_realm<Shape>(*m_realm);
     new_shape->m_dictionary = true;
     new_shape->m_cacheable = true;
     new_shape->m_prototype = m_prototype;
     invalidate_prototype_if_needed_for_new_prototype(new_shape);
-    ensure_property_table();
-    new_shape->ensure_property_table();
-    (*new_shape->m_property_table) = *m_property_table;
-    new_shape->m_property_count = new_shape->m_property_table->size();
+    new_shape->m_property_table = copy_of_property_table();
+    new_shape->m_property_count = m_property_count;
     return new_shape;
 }
 
@@ -53,6 +87,8 @@ GCPtr<Shape> Shape::get_or_prune_cached_forward_transition(TransitionKey const&
 {
     if (m_is_prototype_shape)
         return nullptr;
+    if (m_forward_transition && m_forward_transition->m_property_key == key.property_key && m_forward_transition->m_attributes == key.attributes)
+        return m_forward_transition.ptr();
     if (!m_forward_transitions)
         return nullptr;
     auto it = m_forward_transitions->find(key);
@@ -107,11 +143,8 @@ NonnullGCPtr<Shape> Shape::create_put_transition(StringOrSymbol const& property_
         return *existing_shape;
     auto new_shape = heap().allocate_without_realm<Shape>(*this, property_key, attributes, TransitionType::Put);
     invalidate_prototype_if_needed_for_new_prototype(new_shape);
-    if (!m_is_prototype_shape) {
-        if (!m_forward_transitions)
-            m_forward_transitions = make<HashMap<TransitionKey, WeakPtr<Shape>>>();
-        m_forward_transitions->set(key, new_shape.ptr());
-    }
+    if (!m_is_prototype_shape)
+        set_cached_forward_transition(key, new_shape);
     return new_shape;
 }
 
@@ -122,14 +155,22 @@ NonnullGCPtr<Shape> Shape::create_configure_transition(StringOrSymbol const& pro
         return *existing_shape;
     auto new_shape = heap().allocate_without_realm<Shape>(*this, property_key, attributes, TransitionType::Configure);
     invalidate_prototype_if_needed_for_new_prototype(new_shape);
-    if (!m_is_prototype_shape) {
-        if (!m_forward_transitions)
-            m_forward_transitions = make<HashMap<TransitionKey, WeakPtr<Shape>>>();
-        m_forward_transitions->set(key, new_shape.ptr());
-    }
+    if (!m_is_prototype_shape)
+        set_cached_forward_transition(key, new_shape);
     return new_shape;
 }
 
+void Shape::set_cached_forward_transition(TransitionKey const& key, NonnullGCPtr<Shape> new_shape)
+{
+    if (!m_forward_transition) {
+        m_forward_transition = new_shape.ptr();
+        return;
+    }
+    if (!m_forward_transitions)
+        m_forward_transitions = make<HashMap<TransitionKey, WeakPtr<Shape>>>();
+    m_forward_transitions->set(key, new_shape.ptr());
+}
+
 NonnullGCPtr<Shape> Shape::create_prototype_transition(Object* new_prototype)
 {
     if (new_prototype)
@@ -152,9 +193,9 @@ Shape::Shape(Realm& realm)
 }
 
 Shape::Shape(Shape& previous_shape, StringOrSymbol const& property_key, PropertyAttributes attributes, TransitionType transition_type)
-    : m_realm(previous_shape.m_realm)
+    : m_property_key(property_key)
+    , m_realm(previous_shape.m_realm)
     , m_previous(&previous_shape)
-    , m_property_key(property_key)
     , m_prototype(previous_shape.m_prototype)
     , m_property_count(transition_type == TransitionType::Put ? previous_shape.m_property_count + 1 : previous_shape.m_property_count)
     , m_attributes(attributes)
@@ -163,9 +204,9 @@ Shape::Shape(Shape& previous_shape, StringOrSymbol const& property_key, Property
 }
 
 Shape::Shape(Shape& previous_shape, StringOrSymbol const& property_key, TransitionType transition_type)
-    : m_realm(previous_shape.m_realm)
+    : m_property_key(property_key)
+    , m_realm(previous_shape.m_realm)
     , m_previous(&previous_shape)
-    , m_property_key(property_key)
     , m_prototype(previous_shape.m_prototype)
     , m_property_count(previous_shape.m_property_count - 1)
     , m_transition_type(transition_type)
@@ -191,7 +232,8 @@ void Shape::visit_edges(Cell::Visitor& visitor)
     m_property_key.visit_edges(visitor);
 
     // NOTE: We don't need to mark the keys in the property table, since they are guaranteed
-    //       to also be marked by the chain of shapes leading up to this one.
+    //       to also be marked by the chain of shapes leading up to this one. A table that's shared with shapes further
+    //       down the chain may contain keys past m_property_count that nothing marks, but those are never dereferenced.
 
     visitor.ignore(m_prototype_transitions);
 
@@ -214,8 +256,9 @@ Optional<PropertyMetadata> Shape::lookup(StringOrSymbol const& property_key) con
 {
     if (m_property_count == 0)
         return {};
-    auto property = property_table().get(property_key);
-    if (!property.has_value())
+    ensure_property_table();
+    auto property = m_property_table->properties.get(property_key);
+    if (!property.has_value() || property->offset >= m_property_count)
         return {};
     return property;
 }
@@ -223,45 +266,98 @@ Optional<PropertyMetadata> Shape::lookup(StringOrSymbol const& property_key) con
 FLATTEN OrderedHashMap<StringOrSymbol, PropertyMetadata> const& Shape::property_table() const
 {
     ensure_property_table();
-    return *m_property_table;
+    if (m_property_table->properties.size() != m_property_count)
+        m_property_table = copy_of_property_table();
+
+    // NOTE: Appending to the table while it's being iterated over would be visible to the caller.
+    m_property_table->is_frozen = true;
+    return m_property_table->properties;
+}
+
+NonnullRefPtr<Shape::PropertyTable> Shape::copy_of_property_table() const
+{
+    ensure_property_table();
+    auto table = adopt_ref(*new PropertyTable);
+    for (auto const& it : m_property_table->properties) {
+        if (table->properties.size() == m_property_count)
+            break;
+        table->properties.set(it.key, it.value);
+    }
+    return table;
+}
+
+void Shape::ensure_exclusive_property_table() const
+{
+    ensure_property_table();
+    if (m_property_table->ref_count() == 1 && m_property_table->properties.size() == m_property_count)
+        return;
+    m_property_table = copy_of_property_table();
 }
 
 void Shape::ensure_property_table() const
 {
     if (m_property_table)
         return;
-    m_property_table = make<OrderedHashMap<StringOrSymbol, PropertyMetadata>>();
-
-    u32 next_offset = 0;
 
     Vector<Shape const&, 64> transition_chain;
     transition_chain.append(*this);
+    Shape const* shape_with_table = nullptr;
     for (auto shape = m_previous; shape; shape = shape->m_previous) {
         if (shape->m_property_table) {
-            *m_property_table = *shape->m_property_table;
-            next_offset = shape->m_property_count;
+            shape_with_table = shape;
             break;
         }
         transition_chain.append(*shape);
     }
 
+    u32 next_offset = 0;
+
+    if (shape_with_table) {
+        next_offset = shape_with_table->m_property_count;
+
+        // If nothing has been added to the table past the properties of the shape it belongs to, and only new properties
+        // are added along the way to this shape, all the shapes in between can share that table.
+        auto& table = *shape_with_table->m_property_table;
+        bool can_share_table = !shape_with_table->m_dictionary
+            && !table.is_frozen
+            && table.properties.size() == shape_with_table->m_property_count;
+        for (auto const& shape : transition_chain) {
+            if (shape.m_transition_type != TransitionType::Put && shape.m_transition_type != TransitionType::Prototype)
+                can_share_table = false;
+        }
+
+        if (can_share_table) {
+            for (auto const& shape : transition_chain.in_reverse()) {
+                if (shape.m_transition_type == TransitionType::Put)
+                    table.properties.set(shape.m_property_key, { next_offset++, shape.m_attributes });
+                shape.m_property_table = &table;
+            }
+            return;
+        }
+
+        m_property_table = shape_with_table->copy_of_property_table();
+    } else {
+        m_property_table = adopt_ref(*new PropertyTable);
+    }
+
+    auto& properties = m_property_table->properties;
     for (auto const& shape : transition_chain.in_reverse()) {
         if (!shape.m_property_key.is_valid()) {
             // Ignore prototype transitions as they don't affect the key map.
             continue;
         }
         if (shape.m_transition_type == TransitionType::Put) {
-            m_property_table->set(shape.m_property_key, { next_offset++, shape.m_attributes });
+            properties.set(shape.m_property_key, { next_offset++, shape.m_attributes });
         } else if (shape.m_transition_type == TransitionType::Configure) {
-            auto it = m_property_table->find(shape.m_property_key);
-            VERIFY(it != m_property_table->end());
+            auto it = properties.find(shape.m_property_key);
+            VERIFY(it != properties.end());
             it->value.attributes = shape.m_attributes;
         } else if (shape.m_transition_type == TransitionType::Delete) {
-            auto remove_it = m_property_table->find(shape.m_property_key);
-            VERIFY(remove_it != m_property_table->end());
+            auto remove_it = properties.find(shape.m_property_key);
+            VERIFY(remove_it != properties.end());
             auto removed_offset = remove_it->value.offset;
-            m_property_table->remove(remove_it);
-            for (auto& it : *m_property_table) {
+            properties.remove(remove_it);
+            for (auto& it : properties) {
                 if (it.value.offset > removed_offset)
                     --it.value.offset;
             }
@@ -285,8 +381,8 @@ NonnullGCPtr<Shape> Shape::create_delete_transition(StringOrSymbol const& proper
 void Shape::add_property_without_transition(StringOrSymbol const& property_key, PropertyAttributes attributes)
 {
     VERIFY(property_key.is_valid());
-    ensure_property_table();
-    if (m_property_table->set(property_key, { m_property_count, attributes }) == AK::HashSetResult::InsertedNewEntry) {
+    ensure_exclusive_property_table();
+    if (m_property_table->properties.set(property_key, { m_property_count, attributes }) == AK::HashSetResult::InsertedNewEntry) {
         VERIFY(m_property_count < NumericLimits<u32>::max());
         ++m_property_count;
     }
@@ -302,19 +398,22 @@ void Shape::set_property_attributes_without_transition(StringOrSymbol const& pro
 {
     VERIFY(is_dictionary());
     VERIFY(m_property_table);
-    auto it = m_property_table->find(property_key);
-    VERIFY(it != m_property_table->end());
+    ensure_exclusive_property_table();
+    auto& properties = m_property_table->properties;
+    auto it = properties.find(property_key);
+    VERIFY(it != properties.end());
     it->value.attributes = attributes;
-    m_property_table->set(property_key, it->value);
+    properties.set(property_key, it->value);
 }
 
 void Shape::remove_property_without_transition(StringOrSymbol const& property_key, u32 offset)
 {
     VERIFY(is_uncacheable_dictionary());
     VERIFY(m_property_table);
-    if (m_property_table->remove(property_key))
+    ensure_exclusive_property_table();
+    if (m_property_table->properties.remove(property_key))
         --m_property_count;
-    for (auto& it : *m_property_table) {
+    for (auto& it : m_property_table->properties) {
         VERIFY(it.value.offset != offset);
         if (it.value.offset > offset)
             --it.value.offset;
@@ -335,14 +434,12 @@ NonnullGCPtr<Shape> Shape::clone_for_prototype()
 {
     VERIFY(!m_is_prototype_shape);
     VERIFY(!m_prototype_chain_validity);
-    auto new_shape = heap().allocate_without_realm<Shape>(m_realm);
+    auto new_shape = heap().allocate_without_realm<Shape>(*m_realm);
     s_all_prototype_shapes.set(new_shape);
     new_shape->m_is_prototype_shape = true;
     new_shape->m_prototype = m_prototype;
-    ensure_property_table();
-    new_shape->ensure_property_table();
-    (*new_shape->m_property_table) = *m_property_table;
-    new_shape->m_property_count = new_shape->m_property_table->size();
+    new_shape->m_property_table = copy_of_property_table();
+    new_shape->m_property_count = m_property_count;
     new_shape->m_prototype_chain_validity = heap().allocate_without_realm<PrototypeChainValidity>();
     return new_shape;
 }
@@ -8,6 +8,8 @@
 
 #include <AK/HashMap.h>
 #include <AK/OwnPtr.h>
+#include <AK/RefCounted.h>
+#include <AK/RefPtr.h>
 #include <AK/StringView.h>
 #include <AK/WeakPtr.h>
 #include <AK/Weakable.h>
@@ -47,6 +49,19 @@ private:
     size_t padding { 0 };
 };
 
+struct ShapeMemoryReport {
+    size_t shapes { 0 };
+    size_t dictionary_shapes { 0 };
+    size_t prototype_shapes { 0 };
+    size_t shapes_with_property_table { 0 };
+    size_t shapes_sharing_property_table { 0 };
+    size_t property_tables { 0 };
+    size_t property_table_entries { 0 };
+    size_t inline_forward_transitions { 0 };
+    size_t forward_transition_tables { 0 };
+    size_t forward_transition_table_entries { 0 };
+};
+
 class Shape final : public Cell {
     JS_CELL(Shape, Cell);
     JS_DECLARE_ALLOCATOR(Shape);
@@ -54,6 +69,8 @@ class Shape final : public Cell {
 public:
     virtual ~Shape() override;
 
+    [[nodiscard]] static ShapeMemoryReport memory_report();
+
     enum class TransitionType : u8 {
         Invalid,
         Put,
@@ -87,9 +104,9 @@ public:
     [[nodiscard]] bool is_prototype_shape() const { return m_is_prototype_shape; }
     void set_prototype_shape();
 
-    GCPtr<PrototypeChainValidity> prototype_chain_validity() const { return m_prototype_chain_validity; }
+    GCPtr<PrototypeChainValidity> prototype_chain_validity() const { return m_prototype_chain_validity.ptr(); }
 
-    Realm& realm() const { return m_realm; }
+    Realm& realm() const { return *m_realm; }
 
     Object* prototype() { return m_prototype; }
     Object const* prototype() const { return m_prototype; }
@@ -120,20 +137,37 @@ private:
     [[nodiscard]] GCPtr<Shape> get_or_prune_cached_prototype_transition(Object* prototype);
     [[nodiscard]] GCPtr<Shape> get_or_prune_cached_delete_transition(StringOrSymbol const&);
 
+    // The properties of a shape, in the order they were added in. Shapes along a chain of put transitions share the
+    // table of their common ancestor, so a table can hold more properties than a shape that uses it. Each shape only
+    // sees the first property_count() of them, which are exactly the ones it has.
+    struct PropertyTable : public RefCounted<PropertyTable> {
+        OrderedHashMap<StringOrSymbol, PropertyMetadata> properties;
+
+        // Once the table has been handed out through property_table(), nothing may be appended to it anymore.
+        bool is_frozen { false };
+    };
+
     void ensure_property_table() const;
+    void ensure_exclusive_property_table() const;
+    [[nodiscard]] NonnullRefPtr<PropertyTable> copy_of_property_table() const;
 
-    NonnullGCPtr<Realm> m_realm;
+    void set_cached_forward_transition(TransitionKey const&, NonnullGCPtr<Shape>);
 
-    mutable OwnPtr<OrderedHashMap<StringOrSymbol, PropertyMetadata>> m_property_table;
+    mutable RefPtr<PropertyTable> m_property_table;
 
+    // NOTE: Most shapes only ever get a single forward transition, so the first one is kept inline. Its key doesn't
+    //       need to be stored, as it's the property key and attributes of the shape that the transition leads to.
+    WeakPtr<Shape> m_forward_transition;
     OwnPtr<HashMap<TransitionKey, WeakPtr<Shape>>> m_forward_transitions;
     OwnPtr<HashMap<GCPtr<Object>, WeakPtr<Shape>>> m_prototype_transitions;
     OwnPtr<HashMap<StringOrSymbol, WeakPtr<Shape>>> m_delete_transitions;
-    GCPtr<Shape> m_previous;
     StringOrSymbol m_property_key;
-    GCPtr<Object> m_prototype;
 
-    GCPtr<PrototypeChainValidity> m_prototype_chain_validity;
+    // NOTE: These are kept next to each other and the property count, so they pack into 20 bytes when compressed.
+    CompressedGCPtr<Realm> m_realm;
+    CompressedGCPtr<Shape> m_previous;
+    CompressedGCPtr<Object> m_prototype;
+    CompressedGCPtr<PrototypeChainValidity> m_prototype_chain_validity;
 
     u32 m_property_count { 0 };
 
@@ -472,14 +472,19 @@ JS_DEFINE_NATIVE_FUNCTION(TypedArrayPrototype::every)
 // NOTE: This function assumes that the index is valid within the TypedArray,
 //       and that the TypedArray is not detached.
 template<typename T>
-inline void fast_typed_array_fill(TypedArrayBase& typed_array, u32 begin, u32 end, T value)
+inline void fast_typed_array_fill(VM& vm, TypedArrayBase& typed_array, u32 begin, u32 end, Value value)
 {
+    using UnderlyingBufferDataType = Conditional<IsSame<ClampedU8, T>, u8, T>;
+
+    if (begin >= end)
+        return;
+
     Checked<size_t> computed_begin = begin;
-    computed_begin *= sizeof(T);
+    computed_begin *= sizeof(UnderlyingBufferDataType);
     computed_begin += typed_array.byte_offset();
 
     Checked<size_t> computed_end = end;
-    computed_end *= sizeof(T);
+    computed_end *= sizeof(UnderlyingBufferDataType);
     computed_end += typed_array.byte_offset();
 
     if (computed_begin.has_overflow() || computed_end.has_overflow()) [[unlikely]] {
@@ -491,10 +496,22 @@ inline void fast_typed_array_fill(TypedArrayBase& typed_array, u32 begin, u32 en
         return;
     }
 
+    // Every element gets the same bytes, so the value only needs to be converted once.
+    AK::Array<u8, sizeof(UnderlyingBufferDataType)> raw_bytes;
+    numeric_to_raw_bytes<T>(vm, value, true, raw_bytes);
+
     auto& array_buffer = *typed_array.viewed_array_buffer();
-    auto* slot = reinterpret_cast<T*>(array_buffer.buffer().offset_pointer(computed_begin.value()));
-    for (auto i = begin; i < end; ++i)
-        *(slot++) = value;
+    auto* slot = array_buffer.buffer().offset_pointer(computed_begin.value());
+
+    if constexpr (sizeof(UnderlyingBufferDataType) == 1) {
+        __builtin_memset(slot, raw_bytes[0], end - begin);
+    } else {
+        UnderlyingBufferDataType element;
+        __builtin_memcpy(&element, raw_bytes.data(), sizeof(element));
+        auto* elements = reinterpret_cast<UnderlyingBufferDataType*>(slot);
+        for (auto i = begin; i < end; ++i)
+            *(elements++) = element;
+    }
 }
 
 // 23.2.3.9 %TypedArray%.prototype.fill ( value [ , start [ , end ] ] ), https://tc39.es/ecma262/#sec-%typedarray%.prototype.fill
@@ -565,51 +582,18 @@ JS_DEFINE_NATIVE_FUNCTION(TypedArrayPrototype::fill)
     // 17. Set final to min(final, len).
     final = min(final, length);
 
-    if (value.is_int32()) {
-        switch (typed_array->kind()) {
-        case TypedArrayBase::Kind::Uint8Array:
-            fast_typed_array_fill<u8>(*typed_array, k, final, static_cast<u8>(value.as_i32()));
-            return typed_array;
-        case TypedArrayBase::Kind::Uint16Array:
-            fast_typed_array_fill<u16>(*typed_array, k, final, static_cast<u16>(value.as_i32()));
-            return typed_array;
-        case TypedArrayBase::Kind::Uint32Array:
-            fast_typed_array_fill<u32>(*typed_array, k, final, static_cast<u32>(value.as_i32()));
-            return typed_array;
-        case TypedArrayBase::Kind::Int8Array:
-            fast_typed_array_fill<i8>(*typed_array, k, final, static_cast<i8>(value.as_i32()));
-            return typed_array;
-        case TypedArrayBase::Kind::Int16Array:
-            fast_typed_array_fill<i16>(*typed_array, k, final, static_cast<i16>(value.as_i32()));
-            return typed_array;
-        case TypedArrayBase::Kind::Int32Array:
-            fast_typed_array_fill<i32>(*typed_array, k, final, value.as_i32());
-            return typed_array;
-        case TypedArrayBase::Kind::Uint8ClampedArray:
-            fast_typed_array_fill<u8>(*typed_array, k, final, clamp(value.as_i32(), 0, 255));
-            return typed_array;
-        default:
-            // FIXME: Support more TypedArray kinds.
-            break;
-        }
-    }
-
     // 18. Repeat, while k < final,
-    while (k < final) {
-        // a. Let Pk be ! ToString(𝔽(k)).
-        // b. Perform ! Set(O, Pk, value, true).
-        CanonicalIndex canonical_index { CanonicalIndex::Type::Index, k };
-        switch (typed_array->kind()) {
+    //     a. Let Pk be ! ToString(𝔽(k)).
+    //     b. Perform ! Set(O, Pk, value, true).
+    //     c. Set k to k + 1.
+    // OPTIMIZATION: Nothing can observe the elements being set one by one, so they're written directly into the buffer.
+    switch (typed_array->kind()) {
 #define __JS_ENUMERATE(ClassName, snake_name, PrototypeName, ConstructorName, Type) \
     case TypedArrayBase::Kind::ClassName:                                           \
-        (void)typed_array_set_element<Type>(*typed_array, canonical_index, value);  \
+        fast_typed_array_fill<Type>(vm, *typed_array, k, final, value);             \
         break;
-            JS_ENUMERATE_TYPED_ARRAYS
+        JS_ENUMERATE_TYPED_ARRAYS
 #undef __JS_ENUMERATE
-        }
-
-        // c. Set k to k + 1.
-        ++k;
     }
 
     // 19. Return O.
@@ -1722,6 +1706,17 @@ JS_DEFINE_NATIVE_FUNCTION(TypedArrayPrototype::slice)
                 return array;
             }
 
+            // OPTIMIZATION: Unless the bytes are copied forward onto themselves (which can only happen if the species
+            //               constructor returned a view onto the same buffer), a single memmove copies the same bytes.
+            auto byte_count = limit.value() - target_byte_index;
+            if (&source_buffer != &target_buffer
+                || target_byte_index <= source_byte_index.value()
+                || target_byte_index >= source_byte_index.value() + byte_count) {
+                VERIFY(source_byte_index.value() + byte_count <= source_buffer.byte_length());
+                target_buffer.buffer().overwrite(target_byte_index, source_buffer.buffer().data() + source_byte_index.value(), byte_count);
+                target_byte_index = limit.value();
+            }
+
             // ix. Repeat, while targetByteIndex < limit,
             while (target_byte_index < limit) {
                 // 1. Let value be GetValueFromBuffer(srcBuffer, srcByteIndex, uint8, true, unordered).
@@ -215,7 +215,7 @@ void VM::gather_roots(HashMap<Cell*, HeapRoot>& roots)
     for (auto& saved_stack : m_saved_execution_context_stacks)
         gather_roots_from_execution_context_stack(saved_stack);
 
-    for (auto& job : m_promise_jobs)
+    for (auto& job : m_promise_jobs.span().slice(m_first_queued_promise_job))
         roots.set(job, HeapRoot { .type = HeapRoot::Type::VM });
 }
 
@@ -366,12 +366,16 @@ void VM::run_queued_promise_jobs()
 {
     dbgln_if(PROMISE_DEBUG, "Running queued promise jobs");
 
-    while (!m_promise_jobs.is_empty()) {
-        auto job = m_promise_jobs.take_first();
+    // NOTE: Taking jobs off the front would move everything behind them every time, so the queue is only cleared
+    //       once it has been drained.
+    while (m_first_queued_promise_job < m_promise_jobs.size()) {
+        auto job = m_promise_jobs[m_first_queued_promise_job++];
         dbgln_if(PROMISE_DEBUG, "Calling promise job function");
 
         [[maybe_unused]] auto result = job->function()();
     }
+    m_promise_jobs.clear_with_capacity();
+    m_first_queued_promise_job = 0;
 }
 
 // 9.5.4 HostEnqueuePromiseJob ( job, realm ), https://tc39.es/ecma262/#sec-hostenqueuepromisejob
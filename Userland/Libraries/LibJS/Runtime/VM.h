@@ -19,6 +19,7 @@
 #include <LibJS/Heap/Heap.h>
 #include <LibJS/Heap/MarkedVector.h>
 #include <LibJS/ModuleLoading.h>
+#include <LibJS/ProgramCache.h>
 #include <LibJS/Runtime/CommonPropertyNames.h>
 #include <LibJS/Runtime/Completion.h>
 #include <LibJS/Runtime/Error.h>
@@ -26,6 +27,7 @@
 #include <LibJS/Runtime/ExecutionContext.h>
 #include <LibJS/Runtime/Promise.h>
 #include <LibJS/Runtime/Value.h>
+#include <LibJS/SamplingProfiler.h>
 
 namespace JS {
 
@@ -75,6 +77,14 @@ public:
         return m_byte_string_cache;
     }
 
+    // NOTE: Only embedders that parse the same scripts over and over (like a web browser) enable this.
+    ProgramCache* program_cache() { return m_program_cache.ptr(); }
+    void enable_program_cache() { m_program_cache = make<ProgramCache>(); }
+
+    SamplingProfiler* sampling_profiler() { return m_sampling_profiler.ptr(); }
+    void enable_sampling_profiler(Duration interval = SamplingProfiler::default_interval) { m_sampling_profiler = make<SamplingProfiler>(*this, interval); }
+    void disable_sampling_profiler() { m_sampling_profiler = nullptr; }
+
     PrimitiveString& empty_string() { return *m_empty_string; }
 
     PrimitiveString& single_ascii_character_string(u8 character)
@@ -280,6 +290,9 @@ private:
     HashMap<String, GCPtr<PrimitiveString>> m_string_cache;
     HashMap<ByteString, GCPtr<PrimitiveString>> m_byte_string_cache;
 
+    OwnPtr<ProgramCache> m_program_cache;
+    OwnPtr<SamplingProfiler> m_sampling_profiler;
+
     Heap m_heap;
 
     Vector<ExecutionContext*> m_execution_context_stack;
@@ -292,6 +305,7 @@ private:
     HashMap<String, NonnullGCPtr<Symbol>> m_global_symbol_registry;
 
     Vector<NonnullGCPtr<HeapFunction<ThrowCompletionOr<Value>()>>> m_promise_jobs;
+    size_t m_first_queued_promise_job { 0 };
 
     Vector<GCPtr<FinalizationRegistry>> m_finalization_registry_cleanup_jobs;
 
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/QuickSort.h>
+#include <AK/StringBuilder.h>
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Runtime/ECMAScriptFunctionObject.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/SamplingProfiler.h>
+
+#ifdef AK_OS_SERENITY
+#    include <serenity.h>
+#endif
+
+namespace JS {
+
+SamplingProfiler::SamplingProfiler(VM& vm, Duration interval)
+    : m_vm(vm)
+    , m_interval(interval)
+    , m_next_sample_time(MonotonicTime::now_coarse() + interval)
+{
+}
+
+void SamplingProfiler::sample_if_due()
+{
+    m_polls_until_clock_check = polls_per_clock_check;
+
+    auto now = MonotonicTime::now_coarse();
+    if (now < m_next_sample_time)
+        return;
+    m_next_sample_time = now + m_interval;
+
+    take_sample();
+}
+
+static ByteString describe_frame(ExecutionContext const& context)
+{
+    auto name = context.function_name ? context.function_name->byte_string() : ByteString {};
+
+    // Native functions don't have any bytecode, and thus no source code either.
+    if (!context.executable)
+        return ByteString::formatted("{} (native)", name.is_empty() ? "<unknown>"sv : name.view());
+
+    auto const& filename = context.executable->source_code->filename();
+    if (!context.function)
+        return ByteString::formatted("<top level> ({})", filename);
+
+    // NOTE: Every function is identified by where it starts rather than where it currently is, so each of them ends up
+    //       as a single frame in the collected stacks.
+    size_t line = 0;
+    if (is<ECMAScriptFunctionObject>(*context.function))
+        line = static_cast<ECMAScriptFunctionObject const&>(*context.function).ecmascript_code().source_range().start.line;
+    return ByteString::formatted("{} ({}:{})", name.is_empty() ? "<anonymous>"sv : name.view(), filename, line);
+}
+
+void SamplingProfiler::take_sample()
+{
+    auto const& execution_context_stack = m_vm.execution_context_stack();
+    if (execution_context_stack.is_empty())
+        return;
+
+    Vector<ByteString, 32> frames;
+    frames.ensure_capacity(execution_context_stack.size());
+    for (auto const* context : execution_context_stack)
+        frames.unchecked_append(describe_frame(*context));
+
+    ++m_sample_count;
+
+    StringBuilder folded_stack;
+    folded_stack.join(';', frames);
+    m_folded_stack_counts.ensure(folded_stack.to_byte_string(), [] { return 0; })++;
+
+#ifdef AK_OS_SERENITY
+    StringBuilder signpost;
+    signpost.append(signpost_prefix);
+    for (auto const& frame : frames.in_reverse())
+        signpost.appendff("{}\n", frame);
+
+    auto signpost_string = signpost.to_byte_string();
+    auto string_id = m_signpost_string_ids.ensure(signpost_string, [&] {
+        return perf_register_string(signpost_string.characters(), signpost_string.length());
+    });
+    perf_event(PERF_EVENT_SIGNPOST, string_id, m_sample_count);
+#endif
+}
+
+void SamplingProfiler::dump_folded_stacks() const
+{
+    struct FoldedStack {
+        StringView frames;
+        u64 count { 0 };
+    };
+    Vector<FoldedStack> stacks;
+    stacks.ensure_capacity(m_folded_stack_counts.size());
+    for (auto const& it : m_folded_stack_counts)
+        stacks.unchecked_append({ it.key, it.value });
+
+    quick_sort(stacks, [](auto const& a, auto const& b) { return a.count > b.count; });
+
+    for (auto const& stack : stacks)
+        warnln("{} {}", stack.frames, stack.count);
+}
+
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteString.h>
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/Time.h>
+#include <AK/Vector.h>
+#include <LibJS/Forward.h>
+
+namespace JS {
+
+// Periodically records the stack of JavaScript functions that are currently running.
+//
+// The interpreter polls the profiler whenever it enters a function or jumps backwards in a loop, and a sample is taken
+// once the sampling interval has passed since the previous one. On Serenity, every sample is also emitted as a signpost
+// for the kernel's profiling buffer, which records the native stack along with it. Profiler then combines the two into
+// a single stack of native and JavaScript frames.
+class SamplingProfiler {
+    AK_MAKE_NONCOPYABLE(SamplingProfiler);
+    AK_MAKE_NONMOVABLE(SamplingProfiler);
+
+public:
+    // NOTE: Profiler recognizes the signposts of JavaScript samples by this prefix. After it, there's one line per frame,
+    //       starting with the innermost one.
+    static constexpr StringView signpost_prefix = "JavaScript stack\n"sv;
+
+    static constexpr Duration default_interval = Duration::from_milliseconds(1);
+
+    SamplingProfiler(VM&, Duration interval);
+
+    ALWAYS_INLINE void poll()
+    {
+        if (--m_polls_until_clock_check == 0) [[unlikely]]
+            sample_if_due();
+    }
+
+    u64 sample_count() const { return m_sample_count; }
+
+    // Prints one line for every distinct stack that was seen, in the "folded" format that flame graph tools understand:
+    // the frames from the outermost to the innermost one separated by semicolons, followed by the number of samples.
+    void dump_folded_stacks() const;
+
+private:
+    static constexpr u32 polls_per_clock_check = 256;
+
+    void sample_if_due();
+    void take_sample();
+
+    VM& m_vm;
+    Duration m_interval;
+    MonotonicTime m_next_sample_time;
+    u32 m_polls_until_clock_check { polls_per_clock_check };
+    u64 m_sample_count { 0 };
+
+    HashMap<ByteString, u64> m_folded_stack_counts;
+
+#ifdef AK_OS_SERENITY
+    HashMap<ByteString, int> m_signpost_string_ids;
+#endif
+};
+
+}
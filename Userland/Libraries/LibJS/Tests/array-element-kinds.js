@@ -0,0 +1,73 @@
+test("arrays of numbers can start holding other values", () => {
+    const array = [1, 2, 3];
+    array[1] = 2.5;
+    array[2] = { value: 42 };
+    gc();
+    expect(array[0]).toBe(1);
+    expect(array[1]).toBe(2.5);
+    expect(array[2].value).toBe(42);
+});
+
+test("objects stored into a previously numeric array survive garbage collection", () => {
+    const array = [];
+    for (let i = 0; i < 100; ++i) array.push(i);
+    for (let i = 0; i < 100; ++i) array[i] = { i };
+    gc();
+    for (let i = 0; i < 100; ++i) expect(array[i].i).toBe(i);
+});
+
+test("emptied arrays can hold numbers again", () => {
+    const array = ["a", "b"];
+    array.length = 0;
+    array.push(1, 2);
+    array[1] = {};
+    gc();
+    expect(typeof array[1]).toBe("object");
+});
+
+test("includes on numeric arrays", () => {
+    expect([1, 2, 3].includes(2)).toBeTrue();
+    expect([1, 2, 3].includes(2.0)).toBeTrue();
+    expect([1, 2, 3].includes("2")).toBeFalse();
+    expect([1, 2, 3].includes(NaN)).toBeFalse();
+    expect([1, NaN, 3].includes(NaN)).toBeTrue();
+    expect([1.5, -0, 3].includes(0)).toBeTrue();
+    expect([1, 2, 3].includes(1, 1)).toBeFalse();
+    expect([1, 2, 3].includes(3, -1)).toBeTrue();
+});
+
+test("indexOf and lastIndexOf on numeric arrays", () => {
+    expect([1, 2, 3, 2].indexOf(2)).toBe(1);
+    expect([1, 2, 3, 2].lastIndexOf(2)).toBe(3);
+    expect([1, 2, 3, 2].indexOf(2, 2)).toBe(3);
+    expect([1, 2, 3, 2].lastIndexOf(2, 2)).toBe(1);
+    expect([1, NaN].indexOf(NaN)).toBe(-1);
+    expect([1, NaN].lastIndexOf(NaN)).toBe(-1);
+    expect([0.5, -0].indexOf(0)).toBe(1);
+    expect([1, 2].indexOf("1")).toBe(-1);
+    expect([1, 2].lastIndexOf("2")).toBe(-1);
+});
+
+test("searching arrays with holes looks at the prototype", () => {
+    const array = [1, , 3];
+    Array.prototype[1] = 2;
+    try {
+        expect(array.includes(2)).toBeTrue();
+        expect(array.indexOf(2)).toBe(1);
+        expect(array.lastIndexOf(2)).toBe(1);
+    } finally {
+        delete Array.prototype[1];
+    }
+});
+
+test("fromIndex conversion can change the array", () => {
+    const array = [1, 2, 3];
+    const fromIndex = {
+        valueOf() {
+            array.length = 1;
+            return 0;
+        },
+    };
+    expect(array.includes(3, fromIndex)).toBeFalse();
+    expect(array.includes(undefined, { valueOf: () => ((array.length = 0), 0) })).toBeTrue();
+});
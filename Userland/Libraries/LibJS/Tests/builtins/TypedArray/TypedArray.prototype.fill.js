@@ -75,3 +75,35 @@ test("basic functionality", () => {
         expect(typedArray[2]).toBe(0n);
     });
 });
+
+test("value is converted to the element type", () => {
+    expect(Array.from(new Uint8Array(3).fill(257))).toEqual([1, 1, 1]);
+    expect(Array.from(new Uint8Array(3).fill(1.9))).toEqual([1, 1, 1]);
+    expect(Array.from(new Uint8ClampedArray(3).fill(300))).toEqual([255, 255, 255]);
+    expect(Array.from(new Uint8ClampedArray(3).fill(1.5))).toEqual([2, 2, 2]);
+    expect(Array.from(new Int16Array(3).fill(-1.5))).toEqual([-1, -1, -1]);
+    expect(Array.from(new Uint32Array(3).fill(-1))).toEqual([4294967295, 4294967295, 4294967295]);
+    expect(Array.from(new Float32Array(3).fill(0.1))).toEqual([
+        Math.fround(0.1),
+        Math.fround(0.1),
+        Math.fround(0.1),
+    ]);
+    expect(Array.from(new Float64Array(3).fill(0.1))).toEqual([0.1, 0.1, 0.1]);
+    expect(new Float64Array(2).fill(NaN)[1]).toBeNaN();
+    expect(Array.from(new BigInt64Array(2).fill(-1n))).toEqual([-1n, -1n]);
+    expect(Array.from(new BigUint64Array(2).fill(-1n))).toEqual([2n ** 64n - 1n, 2n ** 64n - 1n]);
+});
+
+test("only the given range is filled", () => {
+    TYPED_ARRAYS.forEach(T => {
+        const typedArray = new T(100);
+        typedArray.fill(7, 10, 90);
+        expect(typedArray[9]).toBe(0);
+        expect(typedArray[10]).toBe(7);
+        expect(typedArray[89]).toBe(7);
+        expect(typedArray[90]).toBe(0);
+
+        typedArray.fill(3, 50, 40);
+        expect(typedArray[45]).toBe(7);
+    });
+});
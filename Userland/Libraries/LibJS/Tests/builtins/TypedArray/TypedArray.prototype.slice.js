@@ -65,3 +65,24 @@ test("basic functionality", () => {
         expect(second_slice).toHaveLength(0);
     });
 });
+
+test("species constructor viewing the same buffer", () => {
+    const typedArray = new Uint8Array([1, 2, 3, 4, 5, 6]);
+    typedArray.constructor = {
+        [Symbol.species]: function (length) {
+            return new Uint8Array(typedArray.buffer, 1, length);
+        },
+    };
+
+    // The bytes are copied forward one at a time, so they overwrite the bytes that are about to be copied.
+    typedArray.slice(0, 4);
+    expect(Array.from(typedArray)).toEqual([1, 1, 1, 1, 1, 6]);
+});
+
+test("large slices", () => {
+    const typedArray = new Float64Array(1000).map((_, i) => i / 2);
+    const slice = typedArray.slice(100, 900);
+    expect(slice).toHaveLength(800);
+    expect(slice[0]).toBe(50);
+    expect(slice[799]).toBe(449.5);
+});
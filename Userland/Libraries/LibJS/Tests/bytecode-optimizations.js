@@ -0,0 +1,105 @@
+test("operations on constants", () => {
+    expect(60 * 60 * 1000).toBe(3600000);
+    expect(1 + 2 * 3 - 4 / 8).toBe(6.5);
+    expect(2 ** 10 % 1000).toBe(24);
+    expect(-0 * 1).toBe(-0);
+    expect(0 / 0).toBeNaN();
+    expect(1 / 0).toBe(Infinity);
+    expect(~5 | (1 << 4)).toBe(-6);
+    expect(-1 >>> 28).toBe(15);
+    expect(true + true).toBe(2);
+    expect(!0).toBeTrue();
+    expect(+true).toBe(1);
+    expect(1 == true).toBeTrue();
+    expect(1 === true).toBeFalse();
+    expect(NaN !== NaN).toBeTrue();
+    expect(typeof 1).toBe("number");
+    expect("1" + 2).toBe("12");
+});
+
+test("conditions on constants", () => {
+    let reached = [];
+    if (1) reached.push("if");
+    if (0) reached.push("not reached");
+    else reached.push("else");
+    if (1 < 2) reached.push("less");
+    if (2 == "2") reached.push("loosely equal");
+    while (true) {
+        reached.push("loop");
+        break;
+    }
+    do reached.push("do");
+    while (false);
+    expect(reached).toEqual(["if", "else", "less", "loosely equal", "loop", "do"]);
+});
+
+test("control flow through chains of jumps", () => {
+    const log = [];
+    outer: for (let i = 0; i < 3; ++i) {
+        for (let j = 0; j < 3; ++j) {
+            if (j === 1) continue outer;
+            if (i === 2) break outer;
+            log.push(`${i}${j}`);
+        }
+    }
+    expect(log).toEqual(["00", "10"]);
+
+    const switched = value => {
+        let result = "";
+        switch (value) {
+            case 1:
+                result += "a";
+            case 2:
+                result += "b";
+                break;
+            default:
+                result += "c";
+        }
+        return result;
+    };
+    expect([1, 2, 3].map(switched)).toEqual(["ab", "b", "c"]);
+});
+
+test("jumping through finally blocks", () => {
+    const log = [];
+    const f = () => {
+        for (let i = 0; i < 3; ++i) {
+            try {
+                if (i === 0) continue;
+                if (i === 1) return "returned";
+            } finally {
+                log.push(i);
+            }
+        }
+        return "not reached";
+    };
+    expect(f()).toBe("returned");
+    expect(log).toEqual([0, 1]);
+
+    const g = () => {
+        try {
+            throw 1;
+        } catch (e) {
+            return e + 1;
+        } finally {
+            log.push("finally");
+        }
+    };
+    expect(g()).toBe(2);
+    expect(log.at(-1)).toBe("finally");
+});
+
+test("generators resume after optimized jumps", () => {
+    function* g() {
+        while (true) {
+            const value = yield 1 + 1;
+            if (value === undefined) continue;
+            if (value > 1) return value;
+        }
+    }
+    const generator = g();
+    expect(generator.next().value).toBe(2);
+    expect(generator.next().value).toBe(2);
+    expect(generator.next(1).value).toBe(2);
+    expect(generator.next(5)).toEqual({ value: 5, done: true });
+});
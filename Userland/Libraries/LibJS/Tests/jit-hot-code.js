@@ -0,0 +1,88 @@
+// These run often enough for the executables to get compiled to native code, and check that it behaves the same.
+
+test("int32 arithmetic in a hot loop", () => {
+    let sum = 0;
+    for (let i = 0; i < 10000; ++i) {
+        sum += i;
+    }
+    expect(sum).toBe(49995000);
+});
+
+test("int32 overflow falls back to doubles", () => {
+    let value = 2147483600;
+    for (let i = 0; i < 1000; ++i) {
+        value++;
+    }
+    expect(value).toBe(2147484600);
+
+    let difference = -2147483600;
+    for (let i = 0; i < 1000; ++i) {
+        difference = difference - 1;
+    }
+    expect(difference).toBe(-2147484600);
+});
+
+test("comparisons of values other than int32", () => {
+    let count = 0;
+    for (let x = 0.5; x < 1000.5; x += 1) {
+        if (x >= "500") count++;
+    }
+    expect(count).toBe(500);
+
+    let nullish = 0;
+    const values = [null, undefined, 0, "", false, {}];
+    for (let i = 0; i < 3000; ++i) {
+        if ((values[i % values.length] ?? "nullish") === "nullish") nullish++;
+    }
+    expect(nullish).toBe(1000);
+});
+
+test("hot function calls", () => {
+    function add(a, b) {
+        return a + b;
+    }
+    let result = 0;
+    for (let i = 0; i < 2000; ++i) {
+        result = add(result, i % 3 === 0 ? "" + 1 : 1);
+    }
+    expect(typeof result).toBe("string");
+});
+
+test("exceptions thrown and caught in hot code", () => {
+    function maybeThrow(i) {
+        if (i % 10 === 0) throw new Error(`${i}`);
+        return i;
+    }
+    let caught = 0;
+    let sum = 0;
+    for (let i = 0; i < 2000; ++i) {
+        try {
+            sum += maybeThrow(i);
+        } catch (e) {
+            expect(e.message).toBe(`${i}`);
+            caught++;
+        }
+    }
+    expect(caught).toBe(200);
+    expect(sum).toBe(1800000);
+});
+
+test("exceptions propagating out of hot code", () => {
+    function throwAt(n) {
+        for (let i = 0; ; ++i) {
+            if (i === n) throw new TypeError("done");
+        }
+    }
+    expect(() => throwAt(5000)).toThrowWithMessage(TypeError, "done");
+});
+
+test("generators resumed in hot code", () => {
+    function* counter() {
+        for (let i = 0; i < 1000; ++i) yield i;
+    }
+    let sum = 0;
+    for (let j = 0; j < 5; ++j) {
+        for (const value of counter()) sum += value;
+    }
+    expect(sum).toBe(5 * 499500);
+});
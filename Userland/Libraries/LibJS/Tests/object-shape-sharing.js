@@ -0,0 +1,91 @@
+test("objects built in the same order see their own properties", () => {
+    const a = {};
+    a.x = 1;
+    a.y = 2;
+    const b = {};
+    b.x = 3;
+    b.y = 4;
+    b.z = 5;
+    const c = {};
+    c.x = 6;
+
+    expect(Object.keys(a)).toEqual(["x", "y"]);
+    expect(Object.keys(b)).toEqual(["x", "y", "z"]);
+    expect(Object.keys(c)).toEqual(["x"]);
+    expect(a.z).toBeUndefined();
+    expect(c.y).toBeUndefined();
+    expect(b.z).toBe(5);
+});
+
+test("objects that branch off a shared prefix", () => {
+    const a = {};
+    a.x = 1;
+    a.y = 2;
+    const b = {};
+    b.x = 3;
+    b.w = 4;
+
+    expect(Object.keys(a)).toEqual(["x", "y"]);
+    expect(Object.keys(b)).toEqual(["x", "w"]);
+    expect(a.w).toBeUndefined();
+    expect(b.y).toBeUndefined();
+    expect(a.y).toBe(2);
+    expect(b.w).toBe(4);
+});
+
+test("looking at a shorter shape does not leak the properties of a longer one", () => {
+    const long = {};
+    long.p = 1;
+    long.q = 2;
+    long.r = 3;
+    expect(Object.keys(long)).toEqual(["p", "q", "r"]);
+
+    const short = {};
+    short.p = 4;
+    expect(Object.keys(short)).toEqual(["p"]);
+    expect("q" in short).toBeFalse();
+
+    short.s = 5;
+    expect(Object.keys(short)).toEqual(["p", "s"]);
+    expect(Object.keys(long)).toEqual(["p", "q", "r"]);
+});
+
+test("deleting and reconfiguring properties does not affect other objects", () => {
+    const a = {};
+    a.x = 1;
+    a.y = 2;
+    a.z = 3;
+    const b = {};
+    b.x = 4;
+    b.y = 5;
+    b.z = 6;
+
+    delete a.y;
+    expect(Object.keys(a)).toEqual(["x", "z"]);
+    expect(Object.keys(b)).toEqual(["x", "y", "z"]);
+
+    Object.defineProperty(b, "x", { enumerable: false });
+    expect(Object.keys(b)).toEqual(["y", "z"]);
+    expect(Object.getOwnPropertyDescriptor(b, "x").enumerable).toBeFalse();
+
+    const c = {};
+    c.x = 7;
+    c.y = 8;
+    expect(Object.keys(c)).toEqual(["x", "y"]);
+    expect(Object.getOwnPropertyDescriptor(c, "x").enumerable).toBeTrue();
+});
+
+test("many objects going through the same transitions", () => {
+    const objects = [];
+    for (let i = 0; i < 100; ++i) {
+        const o = {};
+        for (let j = 0; j <= i % 10; ++j) o["p" + j] = i * 100 + j;
+        objects.push(o);
+    }
+    for (let i = 0; i < 100; ++i) {
+        const o = objects[i];
+        expect(Object.keys(o).length).toBe((i % 10) + 1);
+        for (let j = 0; j <= i % 10; ++j) expect(o["p" + j]).toBe(i * 100 + j);
+        expect(o["p" + ((i % 10) + 1)]).toBeUndefined();
+    }
+});
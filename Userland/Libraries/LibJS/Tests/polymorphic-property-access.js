@@ -0,0 +1,55 @@
+test("property access that sees a few different shapes", () => {
+    const objects = [{ x: 1 }, { y: 0, x: 2 }, { z: 0, y: 0, x: 3 }, { w: 0, z: 0, y: 0, x: 4 }];
+    let sum = 0;
+    for (let i = 0; i < 1000; ++i) sum += objects[i % objects.length].x;
+    expect(sum).toBe(2500);
+});
+
+test("property access that sees many different shapes", () => {
+    const objects = [];
+    for (let i = 0; i < 50; ++i) {
+        const object = {};
+        object[`p${i}`] = i;
+        object.x = i;
+        objects.push(object);
+    }
+    let sum = 0;
+    for (let i = 0; i < 1000; ++i) sum += objects[i % objects.length].x;
+    expect(sum).toBe(24500);
+
+    for (let i = 0; i < 1000; ++i) objects[i % objects.length].x = -i;
+    expect(objects[0].x).toBe(-950);
+    expect(objects[49].x).toBe(-999);
+});
+
+test("polymorphic access to a property of the prototype", () => {
+    class A {
+        get value() {
+            return "A";
+        }
+    }
+    const proto = { value: "proto" };
+    const objects = [new A(), Object.create(proto), { value: "own" }];
+    const read = () => objects.map(object => object.value).join();
+    for (let i = 0; i < 10; ++i) expect(read()).toBe("A,proto,own");
+
+    proto.value = "changed";
+    expect(read()).toBe("A,changed,own");
+    Object.setPrototypeOf(objects[1], { value: "other" });
+    expect(read()).toBe("A,other,own");
+});
+
+test("megamorphic put does not write to read-only properties", () => {
+    const objects = [];
+    for (let i = 0; i < 10; ++i) {
+        const object = {};
+        object[`p${i}`] = i;
+        object.x = 0;
+        objects.push(object);
+    }
+    for (const object of objects) object.x = 1;
+    const frozen = Object.freeze({ x: 0 });
+    for (const object of [...objects, frozen]) object.x = 2;
+    expect(frozen.x).toBe(0);
+    expect(objects.every(object => object.x === 2)).toBeTrue();
+});
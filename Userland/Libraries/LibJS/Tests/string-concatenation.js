@@ -28,3 +28,28 @@ test("adding strings with dangling surrogates", () => {
     expect("\ud834a" + "\udf06").toBe("\ud834a\udf06");
     expect("\ud834" + "a\udf06").toBe("\ud834a\udf06");
 });
+
+test("appending to a string in a loop", () => {
+    let s = "";
+    for (let i = 0; i < 10000; ++i) s += String.fromCharCode(97 + (i % 26));
+    expect(s.length).toBe(10000);
+    expect(s.substring(0, 28)).toBe("abcdefghijklmnopqrstuvwxyzab");
+    expect(s[9999]).toBe(String.fromCharCode(97 + (9999 % 26)));
+
+    let t = "";
+    for (let i = 0; i < 10000; ++i) t = (i % 10) + t;
+    expect(t.length).toBe(10000);
+    expect(t.substring(0, 10)).toBe("9876543210");
+});
+
+test("appending surrogate halves in a loop", () => {
+    let s = "";
+    for (let i = 0; i < 1000; ++i) {
+        s += "\ud834";
+        s += "\udf06";
+    }
+    expect(s.length).toBe(2000);
+    expect(s.codePointAt(0)).toBe(0x1d306);
+    expect(s.codePointAt(1998)).toBe(0x1d306);
+    expect(s).toBe("𝌆".repeat(1000));
+});
@@ -292,3 +292,54 @@ describe("await observably looks up constructor of Promise objects", () => {
     runQueuedPromiseJobs();
     expect(calls).toBe(4);
 });
+
+test("await resumes in the same order no matter what is awaited", () => {
+    const log = [];
+    async function primitives() {
+        for (let i = 0; i < 3; ++i) log.push("primitive " + (await i));
+    }
+    async function settled() {
+        for (let i = 0; i < 3; ++i) log.push("settled " + (await Promise.resolve(i)));
+    }
+    async function rejected() {
+        for (let i = 0; i < 3; ++i) {
+            try {
+                await Promise.reject(i);
+            } catch (e) {
+                log.push("rejected " + e);
+            }
+        }
+    }
+    async function pending() {
+        let resolve;
+        const promise = new Promise(r => (resolve = r));
+        Promise.resolve().then(() => resolve("later"));
+        log.push("pending " + (await promise));
+    }
+
+    primitives();
+    settled();
+    rejected();
+    pending();
+    Promise.resolve()
+        .then(() => log.push("then 1"))
+        .then(() => log.push("then 2"))
+        .then(() => log.push("then 3"));
+    runQueuedPromiseJobs();
+
+    expect(log).toEqual([
+        "primitive 0",
+        "settled 0",
+        "rejected 0",
+        "then 1",
+        "primitive 1",
+        "settled 1",
+        "rejected 1",
+        "pending later",
+        "then 2",
+        "primitive 2",
+        "settled 2",
+        "rejected 2",
+        "then 3",
+    ]);
+});
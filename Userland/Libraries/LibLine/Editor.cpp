@@ -822,6 +822,16 @@ auto Editor::get_line(ByteString const& prompt) -> Result<ByteString, Editor::Er
     return m_input_error.has_value() ? Result<ByteString, Editor::Error> { m_input_error.value() } : Result<ByteString, Editor::Error> { m_returned_line };
 }
 
+static bool has_pending_input()
+{
+    timeval timeout { 0, 0 };
+    fd_set readfds;
+    FD_ZERO(&readfds);
+    FD_SET(0, &readfds);
+
+    return select(1, &readfds, nullptr, nullptr, &timeout) > 0 && FD_ISSET(0, &readfds);
+}
+
 ErrorOr<void> Editor::try_update_once()
 {
     if (m_was_interrupted) {
@@ -833,6 +843,12 @@ ErrorOr<void> Editor::try_update_once()
     if (m_always_refresh)
         m_refresh_needed = true;
 
+    // If more input is already waiting (e.g. something is being pasted), skip redrawing (and with it,
+    // calling on_display_refresh) until all of it has been handled, so we only draw the final result.
+    auto more_input_is_pending = !m_incomplete_data.is_empty() || has_pending_input();
+    if (more_input_is_pending && !m_finish && !m_always_refresh && m_times_tab_pressed == 0)
+        return {};
+
     TRY(refresh_display());
 
     if (m_finish)
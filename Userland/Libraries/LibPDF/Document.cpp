@@ -6,6 +6,7 @@
 
 #include <LibPDF/CommonNames.h>
 #include <LibPDF/Document.h>
+#include <LibPDF/Fonts/PDFFont.h>
 #include <LibPDF/Parser.h>
 #include <LibTextCodec/Decoder.h>
 
@@ -129,6 +130,8 @@ Document::Document(NonnullRefPtr<DocumentParser> const& parser)
     m_parser->set_document(this);
 }
 
+Document::~Document() = default;
+
 PDFErrorOr<void> Document::initialize()
 {
     if (m_security_handler)
@@ -151,6 +154,20 @@ PDFErrorOr<Value> Document::get_or_load_value(u32 index)
     return object;
 }
 
+PDFErrorOr<NonnullRefPtr<PDFFont>> Document::get_or_load_font(NonnullRefPtr<DictObject> const& font_dictionary, float font_size)
+{
+    FontCacheKey key { font_dictionary, font_size };
+    if (auto font = m_font_cache.get(key); font.has_value()) {
+        // Update the potentially-stale size set in Renderer::text_set_matrix_and_line_matrix().
+        font.value()->set_font_size(font_size);
+        return *font.value();
+    }
+
+    auto font = TRY(PDFFont::create(this, font_dictionary, font_size));
+    m_font_cache.set(move(key), font);
+    return font;
+}
+
 u32 Document::get_first_page_index() const
 {
     // FIXME: A PDF can have a different default first page, which
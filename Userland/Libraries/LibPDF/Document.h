@@ -107,6 +107,8 @@ public:
 
     static PDFErrorOr<NonnullRefPtr<Document>> create(ReadonlyBytes bytes);
 
+    ~Document();
+
     // If a security handler is present, it is the caller's responsibility to ensure
     // this document is unencrypted before calling this function. The user does not
     // need to handle the case where the user password is the empty string.
@@ -122,6 +124,9 @@ public:
 
     [[nodiscard]] PDFErrorOr<Value> get_or_load_value(u32 index);
 
+    // Loading a font parses its font program, so fonts are shared by all pages of the document.
+    PDFErrorOr<NonnullRefPtr<PDFFont>> get_or_load_font(NonnullRefPtr<DictObject> const& font_dictionary, float font_size);
+
     [[nodiscard]] u32 get_first_page_index() const;
 
     [[nodiscard]] u32 get_page_count() const;
@@ -192,6 +197,21 @@ private:
     Vector<u32> m_page_object_indices;
     HashMap<u32, Page> m_pages;
     HashMap<u32, Value> m_values;
+
+    struct FontCacheKey {
+        NonnullRefPtr<DictObject> font_dictionary;
+        float font_size;
+
+        bool operator==(FontCacheKey const&) const = default;
+    };
+    struct FontCacheKeyTraits : public DefaultTraits<FontCacheKey> {
+        static unsigned hash(FontCacheKey const& key)
+        {
+            return pair_int_hash(ptr_hash(key.font_dictionary.ptr()), int_hash(bit_cast<u32>(key.font_size)));
+        }
+    };
+    HashMap<FontCacheKey, NonnullRefPtr<PDFFont>, FontCacheKeyTraits> m_font_cache;
+
     RefPtr<OutlineDict> m_outline;
     RefPtr<SecurityHandler> m_security_handler;
 };
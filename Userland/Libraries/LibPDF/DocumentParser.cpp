@@ -590,17 +590,19 @@ PDFErrorOr<NonnullRefPtr<DictObject>> DocumentParser::parse_file_trailer()
     return parse_dict();
 }
 
-PDFErrorOr<Value> DocumentParser::parse_compressed_object_with_index(u32 index)
+PDFErrorOr<DocumentParser::ObjectStream const*> DocumentParser::object_stream_with_index(u32 index)
 {
-    auto object_stream_index = m_xref_table->object_stream_for_object(index);
-    auto stream_offset = m_xref_table->byte_offset_for_object(object_stream_index);
+    if (auto object_stream = m_object_streams.get(index); object_stream.has_value())
+        return object_stream.value();
+
+    auto stream_offset = m_xref_table->byte_offset_for_object(index);
 
     m_reader.move_to(stream_offset);
 
     auto obj_stream = TRY(parse_indirect_value());
     auto stream = TRY(indirect_value_as_stream(obj_stream));
 
-    if (obj_stream->index() != object_stream_index)
+    if (obj_stream->index() != index)
         return error("Mismatching object stream index");
 
     auto dict = stream->dict();
@@ -617,16 +619,38 @@ PDFErrorOr<Value> DocumentParser::parse_compressed_object_with_index(u32 index)
     // The data was already decrypted when reading the outer compressed ObjStm.
     stream_parser.set_encryption_enabled(false);
 
+    HashMap<u32, u32> object_offsets;
+    TRY(object_offsets.try_ensure_capacity(object_count));
+
     for (u32 i = 0; i < object_count; ++i) {
         auto object_number = TRY(stream_parser.parse_number());
         auto object_offset = TRY(stream_parser.parse_number());
 
-        if (object_number.get_u32() == index) {
-            stream_parser.move_to(first_object_offset + object_offset.get_u32());
-            break;
-        }
+        // If an object is listed more than once, the first occurrence is the one that is used.
+        object_offsets.ensure(object_number.get_u32(), [&] { return first_object_offset + object_offset.get_u32(); });
     }
 
+    auto object_stream = make<ObjectStream>(move(stream), move(object_offsets));
+    auto const* object_stream_ptr = object_stream.ptr();
+    m_object_streams.set(index, move(object_stream));
+    return object_stream_ptr;
+}
+
+PDFErrorOr<Value> DocumentParser::parse_compressed_object_with_index(u32 index)
+{
+    auto object_stream_index = m_xref_table->object_stream_for_object(index);
+    auto const* object_stream = TRY(object_stream_with_index(object_stream_index));
+
+    Parser stream_parser(m_document, object_stream->stream->bytes());
+
+    // The data was already decrypted when reading the outer compressed ObjStm.
+    stream_parser.set_encryption_enabled(false);
+
+    auto object_offset = object_stream->object_offsets.get(index);
+    if (!object_offset.has_value())
+        return error("Object not found in object stream");
+    stream_parser.move_to(object_offset.value());
+
     stream_parser.push_reference({ index, 0 });
     auto value = TRY(stream_parser.parse_value());
     stream_parser.pop_reference();
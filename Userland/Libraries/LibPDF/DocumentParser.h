@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
 #include <LibPDF/Parser.h>
 
 namespace PDF {
@@ -97,11 +99,22 @@ private:
     PDFErrorOr<NonnullRefPtr<DictObject>> parse_file_trailer();
     PDFErrorOr<Value> parse_compressed_object_with_index(u32 index);
 
+    // A decoded object stream (ObjStm), along with the offsets of the objects stored in it.
+    struct ObjectStream {
+        NonnullRefPtr<StreamObject> stream;
+        HashMap<u32, u32> object_offsets;
+    };
+    PDFErrorOr<ObjectStream const*> object_stream_with_index(u32 index);
+
     bool navigate_to_before_eof_marker();
     bool navigate_to_after_startxref();
 
     RefPtr<XRefTable> m_xref_table;
     Optional<LinearizationDictionary> m_linearization_dictionary;
+
+    // Object streams usually hold many objects, so we keep them decoded instead of decompressing them again for every
+    // object that is loaded from them.
+    HashMap<u32, NonnullOwnPtr<ObjectStream>> m_object_streams;
 };
 
 }
@@ -108,13 +108,6 @@ public:
 
     static ErrorOr<NonnullRefPtr<Gfx::Bitmap>> apply_page_rotation(NonnullRefPtr<Gfx::Bitmap>, Page const&, int extra_degrees = 0);
 
-    struct FontCacheKey {
-        NonnullRefPtr<DictObject> font_dictionary;
-        float font_size;
-
-        bool operator==(FontCacheKey const&) const = default;
-    };
-
     ALWAYS_INLINE GraphicsState const& state() const { return m_graphics_state_stack.last(); }
     ALWAYS_INLINE TextState const& text_state() const { return state().text_state; }
 
@@ -186,8 +179,6 @@ private:
 
     Gfx::AffineTransform calculate_image_space_transformation(Gfx::IntSize);
 
-    PDFErrorOr<NonnullRefPtr<PDFFont>> get_font(FontCacheKey const&);
-
     class ScopedState;
 
     RefPtr<Document> m_document;
@@ -205,21 +196,12 @@ private:
     bool mutable m_text_rendering_matrix_is_dirty { true };
     Gfx::AffineTransform mutable m_text_rendering_matrix;
 
-    HashMap<FontCacheKey, NonnullRefPtr<PDFFont>> m_font_cache;
 };
 
 }
 
 namespace AK {
 
-template<>
-struct Traits<PDF::Renderer::FontCacheKey> : public DefaultTraits<PDF::Renderer::FontCacheKey> {
-    static unsigned hash(PDF::Renderer::FontCacheKey const& key)
-    {
-        return pair_int_hash(ptr_hash(key.font_dictionary.ptr()), int_hash(bit_cast<u32>(key.font_size)));
-    }
-};
-
 template<>
 struct Formatter<PDF::LineCapStyle> : Formatter<StringView> {
     ErrorOr<void> format(FormatBuilder& builder, PDF::LineCapStyle const& style)
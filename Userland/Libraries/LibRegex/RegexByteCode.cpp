@@ -904,6 +904,50 @@ ByteString OpCode_Compare::arguments_string() const
     return ByteString::formatted("argc={}, args={} ", arguments_count(), arguments_size());
 }
 
+bool OpCode_Compare::only_compares_single_characters() const
+{
+    size_t offset { state().instruction_position + 3 };
+
+    for (size_t i = 0; i < arguments_count(); ++i) {
+        switch ((CharacterCompareType)m_bytecode->at(offset++)) {
+        case CharacterCompareType::Inverse:
+        case CharacterCompareType::TemporaryInverse:
+        case CharacterCompareType::AnyChar:
+        case CharacterCompareType::And:
+        case CharacterCompareType::Or:
+        case CharacterCompareType::EndAndOr:
+            break;
+        case CharacterCompareType::Char:
+        case CharacterCompareType::CharClass:
+        case CharacterCompareType::CharRange:
+        case CharacterCompareType::Property:
+        case CharacterCompareType::GeneralCategory:
+        case CharacterCompareType::Script:
+        case CharacterCompareType::ScriptExtension:
+            ++offset;
+            break;
+        case CharacterCompareType::LookupTable:
+            offset += m_bytecode->at(offset) + 1;
+            break;
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+bool OpCode_Compare::matches_byte(u8 byte, AllOptions options) const
+{
+    char character = static_cast<char>(byte);
+    MatchInput input;
+    input.view = StringView { &character, 1 };
+    input.regex_options = options;
+
+    MatchState state;
+    state.instruction_position = this->state().instruction_position;
+    return execute(input, state) == ExecutionResult::Continue && state.string_position == 1;
+}
+
 Vector<CompareTypeAndValuePair> OpCode_Compare::flat_compares() const
 {
     Vector<CompareTypeAndValuePair> result;
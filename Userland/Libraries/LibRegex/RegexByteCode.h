@@ -765,6 +765,13 @@ public:
     Vector<CompareTypeAndValuePair> flat_compares() const;
     static bool matches_character_class(CharClass, u32, bool insensitive);
 
+    // Whether every compare in this op consumes exactly one character, i.e. there are no strings or backreferences.
+    bool only_compares_single_characters() const;
+
+    // Runs this op against a one-byte input, for callers that need to know what a non-Unicode match of a byte string
+    // can consume here.
+    bool matches_byte(u8, AllOptions) const;
+
 private:
     ALWAYS_INLINE static void compare_char(MatchInput const& input, MatchState& state, u32 ch1, bool inverse, bool& inverse_matched);
     ALWAYS_INLINE static bool compare_string(MatchInput const& input, MatchState& state, RegexStringView str, bool& had_zero_length_match);
@@ -0,0 +1,344 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibRegex/RegexDFA.h>
+
+namespace regex {
+
+OwnPtr<LazyDFA> LazyDFA::try_create(ByteCode const& bytecode)
+{
+    bool has_capture_groups = false;
+    bool has_anchors = false;
+
+    MatchState state;
+    while (state.instruction_position < bytecode.size()) {
+        auto& opcode = bytecode.get_opcode(state);
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Compare:
+            if (!static_cast<OpCode_Compare const&>(opcode).only_compares_single_characters())
+                return nullptr;
+            break;
+        case OpCodeId::Jump:
+        case OpCodeId::ForkJump:
+        case OpCodeId::ForkStay:
+        case OpCodeId::ForkReplaceJump:
+        case OpCodeId::ForkReplaceStay:
+            break;
+        case OpCodeId::JumpNonEmpty:
+            if (static_cast<OpCode_JumpNonEmpty const&>(opcode).checkpoint() >= 64)
+                return nullptr;
+            break;
+        case OpCodeId::Checkpoint:
+            if (static_cast<OpCode_Checkpoint const&>(opcode).id() >= 64)
+                return nullptr;
+            break;
+        case OpCodeId::CheckBegin:
+        case OpCodeId::CheckEnd:
+            has_anchors = true;
+            break;
+        case OpCodeId::SaveLeftCaptureGroup:
+        case OpCodeId::SaveRightCaptureGroup:
+        case OpCodeId::SaveRightNamedCaptureGroup:
+        case OpCodeId::ClearCaptureGroup:
+            has_capture_groups = true;
+            break;
+        default:
+            return nullptr;
+        }
+        state.instruction_position += opcode.size();
+    }
+
+    return adopt_own(*new LazyDFA(has_capture_groups, has_anchors));
+}
+
+LazyDFA::LazyDFA(bool has_capture_groups, bool has_anchors)
+    : m_has_capture_groups(has_capture_groups)
+    , m_has_anchors(has_anchors)
+{
+    reset_cache({});
+}
+
+unsigned LazyDFA::StateKeyTraits::hash(StateKey const& key)
+{
+    unsigned hash = pair_int_hash(key.is_match, key.is_at_beginning);
+    for (auto const& thread : key.threads)
+        hash = pair_int_hash(hash, ThreadTraits::hash(thread));
+    return hash;
+}
+
+bool LazyDFA::can_execute(MatchInput const& input) const
+{
+    // NOTE: The DFA steps through the input one byte at a time, which is exactly what the bytecode does for non-Unicode
+    //       matches on byte strings. Other views can compare surrogate pairs or whole code points at once.
+    if (!input.view.is_string_view() || input.view.unicode())
+        return false;
+
+    if (m_has_capture_groups && !input.regex_options.has_flag_set(AllFlags::SkipSubExprResults))
+        return false;
+
+    if (m_has_anchors) {
+        if (input.regex_options.has_flag_set(AllFlags::Multiline)
+            || input.regex_options.has_flag_set(AllFlags::MatchNotBeginOfLine)
+            || input.regex_options.has_flag_set(AllFlags::MatchNotEndOfLine))
+            return false;
+    }
+
+    return true;
+}
+
+void LazyDFA::reset_cache(AllOptions options) const
+{
+    m_cached_options = options;
+    m_states.clear();
+    m_state_indices.clear();
+    m_start_states.fill(unknown_state);
+
+    auto dead_state_index = intern({});
+    VERIFY(dead_state_index == dead_state);
+}
+
+u32 LazyDFA::intern(StateKey key) const
+{
+    if (auto index = m_state_indices.get(key); index.has_value())
+        return *index;
+
+    auto index = static_cast<u32>(m_states.size());
+    auto state = make<State>();
+    state->key = key;
+    state->transitions.fill(unknown_state);
+    m_states.append(move(state));
+    m_state_indices.set(move(key), index);
+    return index;
+}
+
+bool LazyDFA::add_closure(ByteCode const& bytecode, Thread start, ClosureMode mode, bool is_at_beginning, Vector<Thread>& threads, HashTable<Thread, ThreadTraits>& seen_threads, HashTable<Thread, ThreadTraits>& visited)
+{
+    // This walks all the paths that don't consume any input in the order the backtracking matcher would, and collects
+    // the threads that they end up in. Reaching the end of the bytecode is a match, at which point the matcher wouldn't
+    // look at any of the remaining paths.
+    Vector<Thread, 16> stack;
+    stack.append(start);
+
+    MatchState state;
+    while (!stack.is_empty()) {
+        auto thread = stack.take_last();
+        if (visited.set(thread) != HashSetResult::InsertedNewEntry)
+            continue;
+
+        if (thread.instruction_position >= bytecode.size())
+            return true;
+
+        state.instruction_position = thread.instruction_position;
+        auto& opcode = bytecode.get_opcode(state);
+        auto next_position = thread.instruction_position + opcode.size();
+        auto checkpoints = thread.checkpoints_since_last_compare;
+
+        auto add_thread = [&](Thread thread) {
+            if (seen_threads.set(thread) == HashSetResult::InsertedNewEntry)
+                threads.append(thread);
+        };
+
+        // NOTE: The stack is processed from the back, so the alternative that's tried first has to be pushed last.
+        auto fork = [&](ssize_t offset, bool prefer_jump) {
+            Thread jump_thread { next_position + offset, checkpoints };
+            Thread stay_thread { next_position, checkpoints };
+            if (prefer_jump) {
+                stack.append(stay_thread);
+                stack.append(jump_thread);
+            } else {
+                stack.append(jump_thread);
+                stack.append(stay_thread);
+            }
+        };
+
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Compare:
+            if (mode == ClosureMode::BeforeCharacter)
+                add_thread({ thread.instruction_position, 0 });
+            break;
+        case OpCodeId::CheckEnd:
+            if (mode == ClosureMode::AtEnd)
+                stack.append({ next_position, checkpoints });
+            else
+                add_thread(thread);
+            break;
+        case OpCodeId::CheckBegin:
+            if (is_at_beginning)
+                stack.append({ next_position, checkpoints });
+            break;
+        case OpCodeId::Jump:
+            stack.append({ next_position + static_cast<OpCode_Jump const&>(opcode).offset(), checkpoints });
+            break;
+        case OpCodeId::ForkJump:
+            fork(static_cast<OpCode_ForkJump const&>(opcode).offset(), true);
+            break;
+        case OpCodeId::ForkReplaceJump:
+            fork(static_cast<OpCode_ForkReplaceJump const&>(opcode).offset(), true);
+            break;
+        case OpCodeId::ForkStay:
+            fork(static_cast<OpCode_ForkStay const&>(opcode).offset(), false);
+            break;
+        case OpCodeId::ForkReplaceStay:
+            fork(static_cast<OpCode_ForkReplaceStay const&>(opcode).offset(), false);
+            break;
+        case OpCodeId::JumpNonEmpty: {
+            auto& jump = static_cast<OpCode_JumpNonEmpty const&>(opcode);
+            if (checkpoints & (1ull << jump.checkpoint())) {
+                // Nothing was consumed since the checkpoint, so this doesn't loop again.
+                stack.append({ next_position, checkpoints });
+                break;
+            }
+            switch (jump.form()) {
+            case OpCodeId::Jump:
+                stack.append({ next_position + jump.offset(), checkpoints });
+                break;
+            case OpCodeId::ForkJump:
+            case OpCodeId::ForkReplaceJump:
+                fork(jump.offset(), true);
+                break;
+            case OpCodeId::ForkStay:
+            case OpCodeId::ForkReplaceStay:
+                fork(jump.offset(), false);
+                break;
+            default:
+                VERIFY_NOT_REACHED();
+            }
+            break;
+        }
+        case OpCodeId::Checkpoint:
+            stack.append({ next_position, checkpoints | (1ull << static_cast<OpCode_Checkpoint const&>(opcode).id()) });
+            break;
+        case OpCodeId::SaveLeftCaptureGroup:
+        case OpCodeId::SaveRightCaptureGroup:
+        case OpCodeId::SaveRightNamedCaptureGroup:
+        case OpCodeId::ClearCaptureGroup:
+            stack.append({ next_position, checkpoints });
+            break;
+        default:
+            VERIFY_NOT_REACHED();
+        }
+    }
+
+    return false;
+}
+
+u32 LazyDFA::start_state(ByteCode const& bytecode, bool is_at_beginning) const
+{
+    auto& start_state_index = m_start_states[is_at_beginning ? 1 : 0];
+    if (start_state_index != unknown_state)
+        return start_state_index;
+
+    StateKey key;
+    key.is_at_beginning = is_at_beginning;
+    HashTable<Thread, ThreadTraits> seen_threads;
+    HashTable<Thread, ThreadTraits> visited;
+    key.is_match = add_closure(bytecode, {}, ClosureMode::BeforeCharacter, is_at_beginning, key.threads, seen_threads, visited);
+
+    start_state_index = intern(move(key));
+    return start_state_index;
+}
+
+u32 LazyDFA::transition(ByteCode const& bytecode, u32 state_index, u8 ch) const
+{
+    if (auto next = m_states[state_index]->transitions[ch]; next != unknown_state)
+        return next;
+
+    StateKey key;
+    HashTable<Thread, ThreadTraits> seen_threads;
+    HashTable<Thread, ThreadTraits> visited;
+    for (auto const& thread : m_states[state_index]->key.threads) {
+        MatchState state;
+        state.instruction_position = thread.instruction_position;
+        auto& opcode = bytecode.get_opcode(state);
+
+        // Threads waiting for the end of the input can't go anywhere once there's another character.
+        if (opcode.opcode_id() != OpCodeId::Compare)
+            continue;
+
+        if (!static_cast<OpCode_Compare const&>(opcode).matches_byte(ch, m_cached_options))
+            continue;
+
+        auto next_position = thread.instruction_position + opcode.size();
+
+        if (add_closure(bytecode, { next_position, 0 }, ClosureMode::BeforeCharacter, false, key.threads, seen_threads, visited)) {
+            key.is_match = true;
+            break;
+        }
+    }
+
+    if (m_states.size() >= max_state_count) {
+        dbgln_if(REGEX_DEBUG, "LazyDFA: Reached {} states, starting over", m_states.size());
+        reset_cache(m_cached_options);
+        return intern(move(key));
+    }
+
+    auto next = intern(move(key));
+    m_states[state_index]->transitions[ch] = next;
+    return next;
+}
+
+bool LazyDFA::matches_at_end(ByteCode const& bytecode, u32 state_index) const
+{
+    auto& dfa_state = *m_states[state_index];
+    if (dfa_state.key.is_match)
+        return true;
+    if (dfa_state.matches_at_end.has_value())
+        return *dfa_state.matches_at_end;
+
+    bool matches = false;
+    Vector<Thread> threads;
+    HashTable<Thread, ThreadTraits> seen_threads;
+    HashTable<Thread, ThreadTraits> visited;
+    for (auto const& thread : dfa_state.key.threads) {
+        if (add_closure(bytecode, thread, ClosureMode::AtEnd, dfa_state.key.is_at_beginning, threads, seen_threads, visited)) {
+            matches = true;
+            break;
+        }
+    }
+
+    dfa_state.matches_at_end = matches;
+    return matches;
+}
+
+bool LazyDFA::execute(ByteCode const& bytecode, MatchInput const& input, MatchState& state, size_t& operations) const
+{
+    if (m_cached_options.value() != input.regex_options.value())
+        reset_cache(input.regex_options);
+
+    auto view = input.view.string_view();
+    auto position = state.string_position;
+    Optional<size_t> match_end;
+
+    auto current = start_state(bytecode, position == 0);
+    for (;;) {
+        ++operations;
+
+        auto const& dfa_state = *m_states[current];
+        if (dfa_state.key.is_match)
+            match_end = position;
+        if (dfa_state.key.threads.is_empty())
+            break;
+
+        if (position == view.length()) {
+            if (matches_at_end(bytecode, current))
+                match_end = position;
+            break;
+        }
+
+        current = transition(bytecode, current, static_cast<u8>(view[position]));
+        ++position;
+    }
+
+    if (!match_end.has_value())
+        return false;
+
+    state.string_position = *match_end;
+    state.string_position_in_code_units = *match_end;
+    return true;
+}
+
+}
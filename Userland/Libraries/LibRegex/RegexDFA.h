@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "RegexByteCode.h"
+#include "RegexMatch.h"
+#include "RegexOptions.h"
+
+#include <AK/Array.h>
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/OwnPtr.h>
+#include <AK/Vector.h>
+
+namespace regex {
+
+// A DFA that is built lazily while matching, for the patterns that only need backtracking to pick between alternatives.
+//
+// Every state of the DFA is the list of bytecode positions that a backtracking matcher would still try from the current
+// input position, in the order it would try them. Once one of them reaches the end of the bytecode, all the ones it
+// would only have tried afterwards are dropped. This way, the DFA finds the very same match as the backtracking
+// matcher, but only ever looks at every character of the input once per match attempt.
+//
+// States and transitions are only created once the input actually reaches them, and they're cached across matches.
+class LazyDFA {
+    AK_MAKE_NONCOPYABLE(LazyDFA);
+    AK_MAKE_NONMOVABLE(LazyDFA);
+
+public:
+    // Returns null if the bytecode uses anything a DFA can't express, like backreferences, lookarounds or repetitions
+    // with counters.
+    static OwnPtr<LazyDFA> try_create(ByteCode const&);
+
+    bool can_execute(MatchInput const&) const;
+
+    // Matches from state.string_position onwards, and moves it to the end of the match if there is one.
+    bool execute(ByteCode const&, MatchInput const&, MatchState&, size_t& operations) const;
+
+private:
+    LazyDFA(bool has_capture_groups, bool has_anchors);
+
+    // A position in the bytecode that's waiting for the next character (or, for CheckEnd, for the end of the input).
+    struct Thread {
+        size_t instruction_position { 0 };
+
+        // The checkpoints that were passed since the last character was consumed. JumpNonEmpty only loops back if its
+        // checkpoint isn't among them.
+        u64 checkpoints_since_last_compare { 0 };
+
+        bool operator==(Thread const&) const = default;
+    };
+
+    struct ThreadTraits : public DefaultTraits<Thread> {
+        static unsigned hash(Thread const& thread) { return pair_int_hash(ptr_hash(thread.instruction_position), u64_hash(thread.checkpoints_since_last_compare)); }
+    };
+
+    struct StateKey {
+        Vector<Thread> threads;
+        bool is_match { false };
+        bool is_at_beginning { false };
+
+        bool operator==(StateKey const&) const = default;
+    };
+
+    struct StateKeyTraits : public DefaultTraits<StateKey> {
+        static unsigned hash(StateKey const&);
+    };
+
+    static constexpr u32 unknown_state = NumericLimits<u32>::max();
+    static constexpr u32 dead_state = 0;
+
+    // NOTE: Once there are this many states, the cache is thrown away and built again from scratch.
+    static constexpr size_t max_state_count = 2048;
+
+    struct State {
+        StateKey key;
+        Optional<bool> matches_at_end;
+        AK::Array<u32, 256> transitions;
+    };
+
+    void reset_cache(AllOptions) const;
+    u32 intern(StateKey) const;
+    u32 start_state(ByteCode const&, bool is_at_beginning) const;
+    u32 transition(ByteCode const&, u32 state_index, u8 ch) const;
+    bool matches_at_end(ByteCode const&, u32 state_index) const;
+
+    enum class ClosureMode {
+        BeforeCharacter,
+        AtEnd,
+    };
+    static bool add_closure(ByteCode const&, Thread, ClosureMode, bool is_at_beginning, Vector<Thread>& threads, HashTable<Thread, ThreadTraits>& seen_threads, HashTable<Thread, ThreadTraits>& visited);
+
+    bool m_has_capture_groups { false };
+    bool m_has_anchors { false };
+
+    mutable AllOptions m_cached_options;
+    mutable Vector<NonnullOwnPtr<State>> m_states;
+    mutable HashMap<StateKey, u32, StateKeyTraits> m_state_indices;
+    mutable AK::Array<u32, 2> m_start_states { unknown_state, unknown_state };
+};
+
+}
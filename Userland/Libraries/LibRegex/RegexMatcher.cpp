@@ -59,6 +59,7 @@ Regex<Parser>::Regex(Regex&& regex)
     : pattern_value(move(regex.pattern_value))
     , parser_result(move(regex.parser_result))
     , matcher(move(regex.matcher))
+    , lazy_dfa(move(regex.lazy_dfa))
     , start_offset(regex.start_offset)
 {
     if (matcher)
@@ -71,6 +72,7 @@ Regex<Parser>& Regex<Parser>::operator=(Regex&& regex)
     pattern_value = move(regex.pattern_value);
     parser_result = move(regex.parser_result);
     matcher = move(regex.matcher);
+    lazy_dfa = move(regex.lazy_dfa);
     if (matcher)
         matcher->reset_pattern({}, this);
     start_offset = regex.start_offset;
@@ -185,6 +187,26 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
 
     auto single_match_only = input.regex_options.has_flag_set(AllFlags::SingleMatch);
 
+    // When searching a byte string, positions where no match can start are skipped without running the bytecode.
+    // NOTE: The prefilter was computed with the pattern's own options, so it only applies if nothing that changes what a
+    //       character compare matches was added since.
+    auto const& optimization_data = m_pattern->parser_result.optimization_data;
+    constexpr auto compare_flags = AllFlags::Insensitive | AllFlags::SingleLine | AllFlags::Unicode | AllFlags::Internal_ConsiderNewline | AllFlags::Internal_ECMA262DotSemantics;
+    auto has_prefilter = (optimization_data.literal_prefix.has_value() || optimization_data.starting_bytes.has_value())
+        && (input.regex_options & compare_flags.value()).value() == (m_pattern->parser_result.options & compare_flags.value()).value();
+
+    auto find_next_candidate = [&](StringView view, size_t start) -> Optional<size_t> {
+        if (optimization_data.literal_prefix.has_value())
+            return view.find(*optimization_data.literal_prefix, start);
+
+        auto const& starting_bytes = *optimization_data.starting_bytes;
+        for (auto index = start; index < view.length(); ++index) {
+            if (starting_bytes[static_cast<u8>(view[index])])
+                return index;
+        }
+        return {};
+    };
+
     for (auto const& view : views) {
         if (lines_to_skip != 0) {
             ++input.line;
@@ -231,10 +253,19 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
             }
         }
 
+        auto can_skip_to_candidates = has_prefilter && continue_search && view.is_string_view() && !view.unicode();
+
         for (; view_index <= view_length; ++view_index) {
             if (view_index == view_length && input.regex_options.has_flag_set(AllFlags::Multiline))
                 break;
 
+            if (can_skip_to_candidates) {
+                auto candidate = find_next_candidate(view.string_view(), view_index);
+                if (!candidate.has_value())
+                    break;
+                view_index = *candidate;
+            }
+
             auto& match_length_minimum = m_pattern->parser_result.match_length_minimum;
             // FIXME: More performant would be to know the remaining minimum string
             //        length needed to match from the current position onwards within
@@ -439,6 +470,9 @@ bool Matcher<Parser>::execute(MatchInput const& input, MatchState& state, size_t
         return true;
     }
 
+    if (m_pattern->lazy_dfa && m_pattern->lazy_dfa->can_execute(input))
+        return m_pattern->lazy_dfa->execute(m_pattern->parser_result.bytecode, input, state, operations);
+
     BumpAllocatedLinkedList<MatchState> states_to_try_next;
 #if REGEX_DEBUG
     size_t recursion_level = 0;
@@ -29,14 +29,24 @@ void Regex<Parser>::run_optimization_passes()
     parser_result.bytecode.flatten();
 
     auto blocks = split_basic_blocks(parser_result.bytecode);
-    if (attempt_rewrite_entire_match_as_substring_search(blocks))
+    auto is_substring_search = attempt_rewrite_entire_match_as_substring_search(blocks);
+    if (!is_substring_search) {
+        // Rewrite fork loops as atomic groups
+        // e.g. a*b -> (ATOMIC a*)b
+        attempt_rewrite_loops_as_atomic_groups(blocks);
+
+        parser_result.bytecode.flatten();
+    }
+
+    if (parser_result.error != Error::NoError)
         return;
 
-    // Rewrite fork loops as atomic groups
-    // e.g. a*b -> (ATOMIC a*)b
-    attempt_rewrite_loops_as_atomic_groups(blocks);
+    // Searches can skip ahead to where a match could start.
+    fill_search_prefilter_data();
 
-    parser_result.bytecode.flatten();
+    // If the pattern only ever backtracks to try another alternative, it can be matched with a DFA instead.
+    if (!is_substring_search)
+        lazy_dfa = LazyDFA::try_create(parser_result.bytecode);
 }
 
 template<typename Parser>
@@ -572,6 +582,105 @@ bool Regex<Parser>::attempt_rewrite_entire_match_as_substring_search(BasicBlockL
     return true;
 }
 
+template<typename Parser>
+void Regex<Parser>::fill_search_prefilter_data()
+{
+    auto& bytecode = parser_result.bytecode;
+    auto is_unicode = parser_result.options.has_flag_set(AllFlags::Unicode);
+
+    // Everything before the first jump runs for every match, so a run of character compares there is a required prefix.
+    StringBuilder prefix;
+    MatchState state;
+    while (state.instruction_position < bytecode.size()) {
+        auto& opcode = bytecode.get_opcode(state);
+        if (opcode.opcode_id() == OpCodeId::Compare) {
+            auto& compare = static_cast<OpCode_Compare const&>(opcode);
+            if (compare.arguments_count() != 1)
+                break;
+            auto flat_compares = compare.flat_compares();
+            if (flat_compares.size() != 1 || flat_compares.first().type != CharacterCompareType::Char)
+                break;
+            auto ch = flat_compares.first().value;
+            if (ch > 0xff || (is_unicode && ch > 0x7f))
+                break;
+            prefix.append(bit_cast<char>(static_cast<u8>(ch)));
+        } else if (opcode.opcode_id() != OpCodeId::SaveLeftCaptureGroup && opcode.opcode_id() != OpCodeId::Checkpoint) {
+            break;
+        }
+        state.instruction_position += opcode.size();
+    }
+    if (!prefix.is_empty() && !parser_result.options.has_flag_set(AllFlags::Insensitive)) {
+        parser_result.optimization_data.literal_prefix = prefix.to_byte_string();
+        return;
+    }
+
+    // Otherwise, collect the first bytes of all the paths through the pattern. That only works if all of them consume
+    // something first, and some extra bytes (like both paths of a JumpNonEmpty) don't hurt.
+    AK::Array<bool, 256> starting_bytes {};
+    Vector<size_t> positions_to_visit;
+    HashTable<size_t> visited;
+    positions_to_visit.append(0);
+    while (!positions_to_visit.is_empty()) {
+        auto position = positions_to_visit.take_last();
+        if (visited.set(position) != HashSetResult::InsertedNewEntry)
+            continue;
+
+        // This path matches without consuming anything.
+        if (position >= bytecode.size())
+            return;
+
+        state.instruction_position = position;
+        auto& opcode = bytecode.get_opcode(state);
+        auto next_position = position + opcode.size();
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Compare: {
+            auto& compare = static_cast<OpCode_Compare const&>(opcode);
+            if (!compare.only_compares_single_characters())
+                return;
+            for (size_t byte = 0; byte < 256; ++byte) {
+                if (!starting_bytes[byte] && compare.matches_byte(byte, parser_result.options))
+                    starting_bytes[byte] = true;
+            }
+            break;
+        }
+        case OpCodeId::Jump:
+            positions_to_visit.append(next_position + static_cast<OpCode_Jump const&>(opcode).offset());
+            break;
+        case OpCodeId::ForkJump:
+        case OpCodeId::ForkStay:
+        case OpCodeId::ForkReplaceJump:
+        case OpCodeId::ForkReplaceStay:
+        case OpCodeId::JumpNonEmpty:
+            positions_to_visit.append(next_position);
+            positions_to_visit.append(next_position + static_cast<ssize_t>(opcode.argument(0)));
+            break;
+        case OpCodeId::Checkpoint:
+        case OpCodeId::SaveLeftCaptureGroup:
+        case OpCodeId::SaveRightCaptureGroup:
+        case OpCodeId::SaveRightNamedCaptureGroup:
+        case OpCodeId::ClearCaptureGroup:
+            positions_to_visit.append(next_position);
+            break;
+        default:
+            return;
+        }
+    }
+
+    // A single starting byte is better found with memchr().
+    Optional<u8> only_starting_byte;
+    for (size_t byte = 0; byte < 256; ++byte) {
+        if (!starting_bytes[byte])
+            continue;
+        if (only_starting_byte.has_value()) {
+            parser_result.optimization_data.starting_bytes = starting_bytes;
+            return;
+        }
+        only_starting_byte = byte;
+    }
+    if (only_starting_byte.has_value())
+        parser_result.optimization_data.literal_prefix = ByteString::repeated(bit_cast<char>(*only_starting_byte), 1);
+}
+
 template<typename Parser>
 void Regex<Parser>::attempt_rewrite_loops_as_atomic_groups(BasicBlockList const& basic_blocks)
 {
@@ -11,6 +11,7 @@
 #include "RegexLexer.h"
 #include "RegexOptions.h"
 
+#include <AK/Array.h>
 #include <AK/Forward.h>
 #include <AK/StringBuilder.h>
 #include <AK/Types.h>
@@ -58,6 +59,9 @@ public:
 
         struct {
             Optional<ByteString> pure_substring_search;
+            // Every match starts with this string, or with one of these bytes, when matching a byte string.
+            Optional<ByteString> literal_prefix;
+            Optional<AK::Array<bool, 256>> starting_bytes;
         } optimization_data {};
     };
 
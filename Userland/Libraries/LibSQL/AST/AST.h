@@ -1058,6 +1058,24 @@ private:
     RefPtr<ReturningClause> m_returning_clause;
 };
 
+// Describes how a Select statement will be executed, see Select::plan().
+struct SelectPlan {
+    Vector<NonnullRefPtr<TableDef>> tables;
+
+    // When selecting from a single table, rows are filtered and collected while the table is scanned,
+    // rather than after all rows have been read.
+    bool scan_single_table { false };
+
+    Optional<size_t> limit;
+    size_t offset { 0 };
+
+    // Scanning stops once this many rows passed the WHERE clause. This is only set when the order in
+    // which rows are produced is the order in which they are returned.
+    Optional<size_t> maximum_row_count;
+
+    ErrorOr<Vector<ByteString>> describe(Select const&) const;
+};
+
 class Select : public Statement {
 public:
     Select(RefPtr<CommonTableExpressionList> common_table_expression_list, bool select_all, Vector<NonnullRefPtr<ResultColumn>> result_column_list, Vector<NonnullRefPtr<TableOrSubquery>> table_or_subquery_list, RefPtr<Expression> where_clause, RefPtr<GroupByClause> group_by_clause, Vector<NonnullRefPtr<OrderingTerm>> ordering_term_list, RefPtr<LimitClause> limit_clause)
@@ -1080,6 +1098,8 @@ public:
     RefPtr<GroupByClause> const& group_by_clause() const { return m_group_by_clause; }
     Vector<NonnullRefPtr<OrderingTerm>> const& ordering_term_list() const { return m_ordering_term_list; }
     RefPtr<LimitClause> const& limit_clause() const { return m_limit_clause; }
+
+    ResultOr<SelectPlan> plan(ExecutionContext&) const;
     ResultOr<ResultSet> execute(ExecutionContext&) const override;
 
 private:
@@ -1093,6 +1113,30 @@ private:
     RefPtr<LimitClause> m_limit_clause;
 };
 
+class Explain : public Statement {
+public:
+    Explain(NonnullRefPtr<Select> select_statement)
+        : m_select_statement(move(select_statement))
+    {
+    }
+
+    NonnullRefPtr<Select> const& select_statement() const { return m_select_statement; }
+    ResultOr<ResultSet> execute(ExecutionContext&) const override;
+
+private:
+    NonnullRefPtr<Select> m_select_statement;
+};
+
+class BeginTransaction : public Statement {
+public:
+    ResultOr<ResultSet> execute(ExecutionContext&) const override;
+};
+
+class CommitTransaction : public Statement {
+public:
+    ResultOr<ResultSet> execute(ExecutionContext&) const override;
+};
+
 class DescribeTable : public Statement {
 public:
     DescribeTable(NonnullRefPtr<QualifiedTableName> qualified_table_name)
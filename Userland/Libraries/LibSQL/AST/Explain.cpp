@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibSQL/AST/AST.h>
+#include <LibSQL/Database.h>
+#include <LibSQL/Meta.h>
+#include <LibSQL/ResultSet.h>
+
+namespace SQL::AST {
+
+ResultOr<ResultSet> Explain::execute(ExecutionContext& context) const
+{
+    auto plan = TRY(m_select_statement->plan(context));
+    auto steps = TRY(plan.describe(*m_select_statement));
+
+    auto descriptor = adopt_ref(*new TupleDescriptor);
+    descriptor->append(TupleElementDescriptor { .name = "Plan", .type = SQLType::Text });
+
+    ResultSet result { SQLCommand::Explain, { "Plan" } };
+    TRY(result.try_ensure_capacity(steps.size()));
+
+    for (auto& step : steps) {
+        Tuple tuple(descriptor);
+        tuple[0] = step;
+
+        result.insert_row(tuple, Tuple {});
+    }
+
+    return result;
+}
+
+}
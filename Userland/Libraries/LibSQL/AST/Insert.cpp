@@ -22,8 +22,8 @@ ResultOr<ResultSet> Insert::execute(ExecutionContext& context) const
             return Result { SQLCommand::Insert, SQLErrorCode::ColumnDoesNotExist, column };
     }
 
-    ResultSet result { SQLCommand::Insert };
-    TRY(result.try_ensure_capacity(m_chained_expressions.size()));
+    Vector<Row> rows;
+    TRY(rows.try_ensure_capacity(m_chained_expressions.size()));
 
     for (auto& row_expr : m_chained_expressions) {
         for (auto& column_def : table_def->columns()) {
@@ -51,10 +51,17 @@ ResultOr<ResultSet> Insert::execute(ExecutionContext& context) const
             row[element_index] = move(values[ix]);
         }
 
-        TRY(context.database->insert(row));
-        result.insert_row(row, {});
+        rows.unchecked_append(row);
     }
 
+    TRY(context.database->insert(rows.span()));
+
+    ResultSet result { SQLCommand::Insert };
+    TRY(result.try_ensure_capacity(rows.size()));
+
+    for (auto& row : rows)
+        result.insert_row(row, {});
+
     return result;
 }
 
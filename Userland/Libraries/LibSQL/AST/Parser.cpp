@@ -49,6 +49,13 @@ NonnullRefPtr<Statement> Parser::parse_statement()
         return parse_drop_table_statement();
     case TokenType::Describe:
         return parse_describe_table_statement();
+    case TokenType::Explain:
+        return parse_explain_statement();
+    case TokenType::Begin:
+        return parse_begin_transaction_statement();
+    case TokenType::Commit:
+    case TokenType::End:
+        return parse_commit_transaction_statement();
     case TokenType::Insert:
         return parse_insert_statement({});
     case TokenType::Update:
@@ -58,7 +65,7 @@ NonnullRefPtr<Statement> Parser::parse_statement()
     case TokenType::Select:
         return parse_select_statement({});
     default:
-        expected("CREATE, ALTER, DROP, DESCRIBE, INSERT, UPDATE, DELETE, or SELECT"sv);
+        expected("CREATE, ALTER, DROP, DESCRIBE, EXPLAIN, BEGIN, COMMIT, END, INSERT, UPDATE, DELETE, or SELECT"sv);
         return create_ast_node<ErrorStatement>();
     }
 }
@@ -194,6 +201,37 @@ NonnullRefPtr<DescribeTable> Parser::parse_describe_table_statement()
     return create_ast_node<DescribeTable>(move(table_name));
 }
 
+NonnullRefPtr<Statement> Parser::parse_explain_statement()
+{
+    consume(TokenType::Explain);
+
+    if (!match(TokenType::Select)) {
+        expected("SELECT"sv);
+        return create_ast_node<ErrorStatement>();
+    }
+
+    return create_ast_node<Explain>(parse_select_statement({}));
+}
+
+NonnullRefPtr<BeginTransaction> Parser::parse_begin_transaction_statement()
+{
+    // https://sqlite.org/lang_transaction.html
+    consume(TokenType::Begin);
+    consume_if(TokenType::Transaction);
+
+    return create_ast_node<BeginTransaction>();
+}
+
+NonnullRefPtr<CommitTransaction> Parser::parse_commit_transaction_statement()
+{
+    // https://sqlite.org/lang_transaction.html
+    if (!consume_if(TokenType::End))
+        consume(TokenType::Commit);
+    consume_if(TokenType::Transaction);
+
+    return create_ast_node<CommitTransaction>();
+}
+
 NonnullRefPtr<Insert> Parser::parse_insert_statement(RefPtr<CommonTableExpressionList> common_table_expression_list)
 {
     // https://sqlite.org/lang_insert.html
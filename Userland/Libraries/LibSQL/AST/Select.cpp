@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Checked.h>
 #include <AK/NumericLimits.h>
 #include <LibSQL/AST/AST.h>
 #include <LibSQL/Database.h>
@@ -37,21 +38,85 @@ static ByteString result_column_name(ResultColumn const& column, size_t column_i
     return fallback_column_name();
 }
 
-ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
+static ResultOr<Optional<size_t>> evaluate_size(ExecutionContext& context, Expression const& expression, StringView error_message)
 {
-    Vector<NonnullRefPtr<ResultColumn const>> columns;
-    Vector<ByteString> column_names;
+    auto value = TRY(expression.evaluate(context));
+    if (value.is_null())
+        return OptionalNone {};
+
+    auto size = value.to_int<size_t>();
+    if (!size.has_value())
+        return Result { SQLCommand::Select, SQLErrorCode::SyntaxError, error_message };
+    return size;
+}
 
-    auto const& result_column_list = this->result_column_list();
-    VERIFY(!result_column_list.is_empty());
+ResultOr<SelectPlan> Select::plan(ExecutionContext& context) const
+{
+    SelectPlan plan;
 
     for (auto& table_descriptor : table_or_subquery_list()) {
         if (!table_descriptor->is_table())
             return Result { SQLCommand::Select, SQLErrorCode::NotYetImplemented, "Sub-selects are not yet implemented"sv };
 
         auto table_def = TRY(context.database->get_table(table_descriptor->schema_name(), table_descriptor->table_name()));
+        TRY(plan.tables.try_append(move(table_def)));
+    }
+
+    plan.scan_single_table = plan.tables.size() == 1 && plan.tables[0]->num_columns() > 0;
 
-        if (result_column_list.size() == 1 && result_column_list[0]->type() == ResultType::All) {
+    if (m_limit_clause != nullptr) {
+        plan.limit = TRY(evaluate_size(context, *m_limit_clause->limit_expression(), "LIMIT clause must evaluate to an integer value"sv));
+
+        if (m_limit_clause->offset_expression() != nullptr)
+            plan.offset = TRY(evaluate_size(context, *m_limit_clause->offset_expression(), "OFFSET clause must evaluate to an integer value"sv)).value_or(0);
+
+        // Without an ORDER BY clause, rows are returned in the order the scan produces them. So once enough
+        // rows have been produced to satisfy the LIMIT, the remainder of the table does not need to be read.
+        if (plan.limit.has_value() && plan.scan_single_table && m_ordering_term_list.is_empty()) {
+            Checked<size_t> maximum_row_count = plan.offset;
+            maximum_row_count += plan.limit.value();
+            if (!maximum_row_count.has_overflow())
+                plan.maximum_row_count = maximum_row_count.value();
+        }
+    }
+
+    return plan;
+}
+
+ErrorOr<Vector<ByteString>> SelectPlan::describe(Select const& select) const
+{
+    Vector<ByteString> steps;
+
+    for (auto const& table : tables)
+        TRY(steps.try_append(ByteString::formatted("SCAN TABLE {}.{}", table->parent()->name(), table->name())));
+    if (tables.size() > 1)
+        TRY(steps.try_append("CARTESIAN PRODUCT"));
+
+    if (select.where_clause())
+        TRY(steps.try_append(scan_single_table ? "FILTER DURING SCAN" : "FILTER"));
+    if (!select.ordering_term_list().is_empty())
+        TRY(steps.try_append("SORT"));
+
+    if (limit.has_value())
+        TRY(steps.try_append(ByteString::formatted("LIMIT {} OFFSET {}", limit.value(), offset)));
+    if (maximum_row_count.has_value())
+        TRY(steps.try_append(ByteString::formatted("STOP SCAN AFTER {} ROWS", maximum_row_count.value())));
+
+    return steps;
+}
+
+ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
+{
+    auto plan = TRY(this->plan(context));
+
+    Vector<NonnullRefPtr<ResultColumn const>> columns;
+    Vector<ByteString> column_names;
+
+    auto const& result_column_list = this->result_column_list();
+    VERIFY(!result_column_list.is_empty());
+
+    if (result_column_list.size() == 1 && result_column_list[0]->type() == ResultType::All) {
+        for (auto& table_def : plan.tables) {
             TRY(columns.try_ensure_capacity(columns.size() + table_def->columns().size()));
             TRY(column_names.try_ensure_capacity(column_names.size() + table_def->columns().size()));
 
@@ -64,9 +129,7 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
                 column_names.unchecked_append(col->name());
             }
         }
-    }
-
-    if (result_column_list.size() != 1 || result_column_list[0]->type() != ResultType::All) {
+    } else {
         TRY(columns.try_ensure_capacity(result_column_list.size()));
         TRY(column_names.try_ensure_capacity(result_column_list.size()));
 
@@ -87,33 +150,9 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
 
     auto descriptor = adopt_ref(*new TupleDescriptor);
     Tuple tuple(descriptor);
-    Vector<Tuple> rows;
     descriptor->empend("__unity__"sv);
     tuple.append(Value { true });
-    rows.append(tuple);
-
-    for (auto& table_descriptor : table_or_subquery_list()) {
-        if (!table_descriptor->is_table())
-            return Result { SQLCommand::Select, SQLErrorCode::NotYetImplemented, "Sub-selects are not yet implemented"sv };
-
-        auto table_def = TRY(context.database->get_table(table_descriptor->schema_name(), table_descriptor->table_name()));
-        if (table_def->num_columns() == 0)
-            continue;
-
-        auto old_descriptor_size = descriptor->size();
-        descriptor->extend(table_def->to_tuple_descriptor());
-
-        while (!rows.is_empty() && (rows.first().size() == old_descriptor_size)) {
-            auto cartesian_row = rows.take_first();
-            auto table_rows = TRY(context.database->select_all(*table_def));
-
-            for (auto& table_row : table_rows) {
-                auto new_row = cartesian_row;
-                new_row.extend(table_row);
-                rows.append(new_row);
-            }
-        }
-    }
+    auto unity_row = tuple;
 
     bool has_ordering { false };
     auto sort_descriptor = adopt_ref(*new TupleDescriptor);
@@ -123,13 +162,14 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
     }
     Tuple sort_key(sort_descriptor);
 
-    for (auto& row : rows) {
+    size_t row_count = 0;
+    auto process_row = [&](Tuple& row) -> ResultOr<IterationDecision> {
         context.current_row = &row;
 
         if (where_clause()) {
             auto where_result = TRY(where_clause()->evaluate(context)).to_bool();
             if (!where_result.has_value() || !where_result.value())
-                continue;
+                return IterationDecision::Continue;
         }
 
         tuple.clear();
@@ -148,35 +188,53 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
         }
 
         result.insert_row(tuple, sort_key);
-    }
 
-    if (m_limit_clause != nullptr) {
-        size_t limit_value = NumericLimits<size_t>::max();
-        size_t offset_value = 0;
+        if (plan.maximum_row_count.has_value() && ++row_count >= plan.maximum_row_count.value())
+            return IterationDecision::Break;
+        return IterationDecision::Continue;
+    };
 
-        auto limit = TRY(m_limit_clause->limit_expression()->evaluate(context));
-        if (!limit.is_null()) {
-            auto limit_value_maybe = limit.to_int<size_t>();
-            if (!limit_value_maybe.has_value())
-                return Result { SQLCommand::Select, SQLErrorCode::SyntaxError, "LIMIT clause must evaluate to an integer value"sv };
+    if (plan.scan_single_table) {
+        auto& table_def = *plan.tables[0];
+        descriptor->extend(table_def.to_tuple_descriptor());
 
-            limit_value = limit_value_maybe.value();
+        if (plan.maximum_row_count != 0u) {
+            TRY(context.database->for_each_row(table_def, [&](Row& table_row) -> ResultOr<IterationDecision> {
+                auto row = unity_row;
+                row.extend(table_row);
+                return process_row(row);
+            }));
         }
+    } else {
+        Vector<Tuple> rows;
+        rows.append(unity_row);
+
+        for (auto& table_def : plan.tables) {
+            if (table_def->num_columns() == 0)
+                continue;
+
+            auto old_descriptor_size = descriptor->size();
+            descriptor->extend(table_def->to_tuple_descriptor());
 
-        if (m_limit_clause->offset_expression() != nullptr) {
-            auto offset = TRY(m_limit_clause->offset_expression()->evaluate(context));
-            if (!offset.is_null()) {
-                auto offset_value_maybe = offset.to_int<size_t>();
-                if (!offset_value_maybe.has_value())
-                    return Result { SQLCommand::Select, SQLErrorCode::SyntaxError, "OFFSET clause must evaluate to an integer value"sv };
+            while (!rows.is_empty() && (rows.first().size() == old_descriptor_size)) {
+                auto cartesian_row = rows.take_first();
+                auto table_rows = TRY(context.database->select_all(*table_def));
 
-                offset_value = offset_value_maybe.value();
+                for (auto& table_row : table_rows) {
+                    auto new_row = cartesian_row;
+                    new_row.extend(table_row);
+                    rows.append(new_row);
+                }
             }
         }
 
-        result.limit(offset_value, limit_value);
+        for (auto& row : rows)
+            (void)TRY(process_row(row));
     }
 
+    if (m_limit_clause != nullptr)
+        result.limit(plan.offset, plan.limit.value_or(NumericLimits<size_t>::max()));
+
     return result;
 }
 
@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibSQL/AST/AST.h>
+#include <LibSQL/Database.h>
+
+namespace SQL::AST {
+
+ResultOr<ResultSet> BeginTransaction::execute(ExecutionContext& context) const
+{
+    TRY(context.database->begin_transaction());
+    return ResultSet { SQLCommand::Begin };
+}
+
+ResultOr<ResultSet> CommitTransaction::execute(ExecutionContext& context) const
+{
+    // The changes made during the transaction are committed once the statement completes, see Statement::execute().
+    TRY(context.database->end_transaction());
+    return ResultSet { SQLCommand::Commit };
+}
+
+}
@@ -87,6 +87,26 @@ ErrorOr<void> Database::commit()
     return {};
 }
 
+ResultOr<void> Database::begin_transaction()
+{
+    VERIFY(is_open());
+    if (m_in_transaction)
+        return Result { SQLCommand::Begin, SQLErrorCode::TransactionAlreadyActive };
+
+    m_in_transaction = true;
+    return {};
+}
+
+ResultOr<void> Database::end_transaction()
+{
+    VERIFY(is_open());
+    if (!m_in_transaction)
+        return Result { SQLCommand::Commit, SQLErrorCode::NoActiveTransaction };
+
+    m_in_transaction = false;
+    return {};
+}
+
 ResultOr<void> Database::add_schema(SchemaDef const& schema)
 {
     VERIFY(is_open());
@@ -202,19 +222,35 @@ ErrorOr<Vector<Row>> Database::match(TableDef& table, Key const& key)
 
 ErrorOr<void> Database::insert(Row& row)
 {
-    VERIFY(m_table_cache.get(row.table().key().hash()).has_value());
+    return insert(Span<Row> { &row, 1 });
+}
+
+ErrorOr<void> Database::insert(Span<Row> rows)
+{
+    if (rows.is_empty())
+        return {};
+
+    auto& table = rows[0].table();
+    VERIFY(m_table_cache.get(table.key().hash()).has_value());
     // TODO: implement table constraints such as unique, foreign key, etc.
 
-    row.set_block_index(m_heap->request_new_block_index());
-    row.set_next_block_index(row.table().block_index());
-    TRY(update(row));
+    // Rows are prepended to the table's chain of rows, so only the table's pointer to the first row in
+    // the tables B-Tree needs to be updated, once for all rows.
+    for (auto& row : rows) {
+        VERIFY(&row.table() == &table);
 
-    // TODO update indexes defined on table.
+        row.set_block_index(m_heap->request_new_block_index());
+        row.set_next_block_index(table.block_index());
+        TRY(update(row));
+
+        // TODO update indexes defined on table.
+
+        table.set_block_index(row.block_index());
+    }
 
-    auto table_key = row.table().key();
-    table_key.set_block_index(row.block_index());
+    auto table_key = table.key();
+    table_key.set_block_index(table.block_index());
     VERIFY(m_tables->update_key_pointer(table_key));
-    row.table().set_block_index(row.block_index());
     return {};
 }
 
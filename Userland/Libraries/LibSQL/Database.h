@@ -8,12 +8,15 @@
 #pragma once
 
 #include <AK/ByteString.h>
+#include <AK/IterationDecision.h>
 #include <AK/NonnullRefPtr.h>
 #include <AK/RefPtr.h>
 #include <LibSQL/Forward.h>
 #include <LibSQL/Heap.h>
+#include <LibSQL/Key.h>
 #include <LibSQL/Meta.h>
 #include <LibSQL/Result.h>
+#include <LibSQL/Row.h>
 #include <LibSQL/Serializer.h>
 
 namespace SQL {
@@ -31,6 +34,12 @@ public:
     ResultOr<void> open();
     bool is_open() const { return m_open; }
     ErrorOr<void> commit();
+
+    // While a transaction is active, statements do not commit their changes. Note that transactions are not
+    // isolated: they are shared by all users of this Database.
+    bool is_in_transaction() const { return m_in_transaction; }
+    ResultOr<void> begin_transaction();
+    ResultOr<void> end_transaction();
     ErrorOr<size_t> file_size_in_bytes() const { return m_heap->file_size_in_bytes(); }
 
     ResultOr<void> add_schema(SchemaDef const&);
@@ -43,7 +52,23 @@ public:
 
     ErrorOr<Vector<Row>> select_all(TableDef&);
     ErrorOr<Vector<Row>> match(TableDef&, Key const&);
+
+    // Visits the rows of a table in the same order as select_all(), without reading the whole table up front.
+    template<typename Callback>
+    ResultOr<void> for_each_row(TableDef& table, Callback callback)
+    {
+        VERIFY(m_table_cache.get(table.key().hash()).has_value());
+        for (auto block_index = table.block_index(); block_index;) {
+            auto row = m_serializer.deserialize_block<Row>(block_index, table, block_index);
+            block_index = row.next_block_index();
+            if (TRY(callback(row)) == IterationDecision::Break)
+                break;
+        }
+        return {};
+    }
+
     ErrorOr<void> insert(Row&);
+    ErrorOr<void> insert(Span<Row>);
     ErrorOr<void> remove(Row&);
     ErrorOr<void> update(Row&);
 
@@ -51,6 +76,7 @@ private:
     explicit Database(NonnullRefPtr<Heap>);
 
     bool m_open { false };
+    bool m_in_transaction { false };
     NonnullRefPtr<Heap> m_heap;
     Serializer m_serializer;
     RefPtr<BTree> m_schemas;
@@ -35,6 +35,7 @@ namespace SQL::AST {
 class AddColumn;
 class AlterTable;
 class ASTNode;
+class BeginTransaction;
 class BetweenExpression;
 class BinaryOperatorExpression;
 class BlobLiteral;
@@ -45,6 +46,7 @@ class CollateExpression;
 class ColumnDefinition;
 class ColumnNameExpression;
 class CommonTableExpression;
+class CommitTransaction;
 class CommonTableExpressionList;
 class CreateTable;
 class Delete;
@@ -53,6 +55,7 @@ class DropTable;
 class ErrorExpression;
 class ErrorStatement;
 class ExistsExpression;
+class Explain;
 class Expression;
 class GroupByClause;
 class InChainedExpression;
@@ -8,6 +8,7 @@
 #include <AK/ByteString.h>
 #include <AK/Format.h>
 #include <AK/QuickSort.h>
+#include <AK/ScopeGuard.h>
 #include <LibCore/System.h>
 #include <LibSQL/Heap.h>
 #include <sys/stat.h>
@@ -26,10 +27,11 @@ Heap::Heap(ByteString file_name)
 
 Heap::~Heap()
 {
-    if (m_file && !m_write_ahead_log.is_empty()) {
+    if (m_file) {
         if (auto maybe_error = flush(); maybe_error.is_error())
             warnln("~Heap({}): {}", name(), maybe_error.error());
     }
+    drop_all_pages();
 }
 
 ErrorOr<void> Heap::open()
@@ -60,6 +62,7 @@ ErrorOr<void> Heap::open()
 
     if (file_size > 0) {
         if (auto error_maybe = read_zero_block(); error_maybe.is_error()) {
+            drop_all_pages();
             m_file = nullptr;
             return error_maybe.release_error();
         }
@@ -70,6 +73,7 @@ ErrorOr<void> Heap::open()
     // FIXME: We should more gracefully handle version incompatibilities. For now, we drop the database.
     if (m_version != VERSION) {
         dbgln_if(SQL_DEBUG, "Heap file {} opened has incompatible version {}. Deleting for version {}.", name(), m_version, VERSION);
+        drop_all_pages();
         m_file = nullptr;
 
         TRY(Core::System::unlink(name()));
@@ -79,8 +83,9 @@ ErrorOr<void> Heap::open()
     // Perform a heap scan to find all free blocks
     // FIXME: this is very inefficient; store free blocks in a persistent heap structure
     for (Block::Index index = 1; index <= m_highest_block_written; ++index) {
-        auto block_data = TRY(read_raw_block(index));
-        auto size_in_bytes = *reinterpret_cast<u32*>(block_data.data());
+        auto* page = TRY(pin_page(index, ReadPageContents::Yes));
+        auto size_in_bytes = page->size_in_bytes();
+        unpin_page(*page);
         if (size_in_bytes == 0)
             TRY(m_free_block_indices.try_append(index));
     }
@@ -97,7 +102,8 @@ ErrorOr<size_t> Heap::file_size_in_bytes() const
 
 bool Heap::has_block(Block::Index index) const
 {
-    return (index <= m_highest_block_written || m_write_ahead_log.contains(index))
+    // NOTE: Pages beyond the highest block written can only be in the pool if they were written to.
+    return (index <= m_highest_block_written || m_pages.contains(index))
         && !m_free_block_indices.contains_slow(index);
 }
 
@@ -109,18 +115,29 @@ Block::Index Heap::request_new_block_index()
 }
 
 ErrorOr<ByteBuffer> Heap::read_storage(Block::Index index)
+{
+    ByteBuffer data;
+    TRY(read_storage(index, data));
+    return data;
+}
+
+ErrorOr<void> Heap::read_storage(Block::Index index, ByteBuffer& data)
 {
     dbgln_if(SQL_DEBUG, "{}({})", __FUNCTION__, index);
 
-    // Reconstruct the data storage from a potential chain of blocks
-    ByteBuffer data;
+    // Reconstruct the data storage from a potential chain of blocks. The buffer's capacity is kept, so that
+    // callers can reuse it across reads.
+    data.clear_with_capacity();
     while (index > 0) {
-        auto block = TRY(read_block(index));
-        dbgln_if(SQL_DEBUG, "  -> {} bytes", block.size_in_bytes());
-        TRY(data.try_append(block.data().bytes().slice(0, block.size_in_bytes())));
-        index = block.next_block();
+        auto* page = TRY(pin_page(index, ReadPageContents::Yes));
+        ScopeGuard unpin_guard = [&] { unpin_page(*page); };
+
+        auto size_in_bytes = page->size_in_bytes();
+        dbgln_if(SQL_DEBUG, "  -> {} bytes", size_in_bytes);
+        TRY(data.try_append(page->data.bytes().slice(Block::HEADER_SIZE, size_in_bytes)));
+        index = page->next_block();
     }
-    return data;
+    return {};
 }
 
 ErrorOr<void> Heap::write_storage(Block::Index index, ReadonlyBytes data)
@@ -141,16 +158,10 @@ ErrorOr<void> Heap::write_storage(Block::Index index, ReadonlyBytes data)
         auto block_data_size = AK::min(remaining_size, Block::DATA_SIZE);
         remaining_size -= block_data_size;
 
-        ByteBuffer block_data;
-        if (has_block(index)) {
-            auto existing_block = TRY(read_block(index));
-            block_data = existing_block.data();
-            TRY(block_data.try_resize(block_data_size));
-            existing_next_block_index = existing_block.next_block();
-        } else {
-            block_data = TRY(ByteBuffer::create_uninitialized(block_data_size));
-            existing_next_block_index = 0;
-        }
+        auto block_exists = has_block(index);
+        auto* page = TRY(pin_page(index, block_exists ? ReadPageContents::Yes : ReadPageContents::No));
+        ScopeGuard unpin_guard = [&] { unpin_page(*page); };
+        existing_next_block_index = block_exists ? page->next_block() : 0;
 
         Block::Index next_block_index = existing_next_block_index;
         if (next_block_index == 0 && remaining_size > 0)
@@ -158,8 +169,11 @@ ErrorOr<void> Heap::write_storage(Block::Index index, ReadonlyBytes data)
         else if (remaining_size == 0)
             next_block_index = 0;
 
-        block_data.bytes().overwrite(0, data.offset(offset_in_data), block_data_size);
-        TRY(write_block({ index, block_data_size, next_block_index, move(block_data) }));
+        auto page_data = page->data.bytes().slice(Block::HEADER_SIZE);
+        page_data.overwrite(0, data.offset(offset_in_data), block_data_size);
+        page_data.slice(block_data_size).fill(0);
+        page->write_header(block_data_size, next_block_index);
+        page->is_dirty = true;
 
         index = next_block_index;
         offset_in_data += block_data_size;
@@ -172,32 +186,6 @@ ErrorOr<void> Heap::write_storage(Block::Index index, ReadonlyBytes data)
     return {};
 }
 
-ErrorOr<ByteBuffer> Heap::read_raw_block(Block::Index index)
-{
-    VERIFY(m_file);
-    VERIFY(index < m_next_block);
-
-    if (auto wal_entry = m_write_ahead_log.get(index); wal_entry.has_value())
-        return wal_entry.value();
-
-    TRY(m_file->seek(index * Block::SIZE, SeekMode::SetPosition));
-    auto buffer = TRY(ByteBuffer::create_uninitialized(Block::SIZE));
-    TRY(m_file->read_until_filled(buffer));
-    return buffer;
-}
-
-ErrorOr<Block> Heap::read_block(Block::Index index)
-{
-    dbgln_if(SQL_DEBUG, "{}({})", __FUNCTION__, index);
-
-    auto buffer = TRY(read_raw_block(index));
-    auto size_in_bytes = *reinterpret_cast<u32*>(buffer.offset_pointer(0));
-    auto next_block = *reinterpret_cast<Block::Index*>(buffer.offset_pointer(sizeof(u32)));
-    auto data = TRY(buffer.slice(Block::HEADER_SIZE, Block::DATA_SIZE));
-
-    return Block { index, size_in_bytes, next_block, move(data) };
-}
-
 ErrorOr<void> Heap::write_raw_block(Block::Index index, ReadonlyBytes data)
 {
     dbgln_if(SQL_DEBUG, "Write raw block {}", index);
@@ -214,77 +202,131 @@ ErrorOr<void> Heap::write_raw_block(Block::Index index, ReadonlyBytes data)
     return {};
 }
 
-ErrorOr<void> Heap::write_raw_block_to_wal(Block::Index index, ByteBuffer&& data)
+ErrorOr<void> Heap::free_storage(Block::Index index)
 {
     dbgln_if(SQL_DEBUG, "{}({})", __FUNCTION__, index);
-    VERIFY(index < m_next_block);
-    VERIFY(data.size() == Block::SIZE);
-
-    TRY(m_write_ahead_log.try_set(index, move(data)));
+    VERIFY(index > 0);
 
+    while (index > 0) {
+        auto* page = TRY(pin_page(index, ReadPageContents::Yes));
+        ScopeGuard unpin_guard = [&] { unpin_page(*page); };
+        index = page->next_block();
+        TRY(free_block(*page));
+    }
     return {};
 }
 
-ErrorOr<void> Heap::write_block(Block const& block)
+ErrorOr<void> Heap::free_block(Page& page)
 {
-    dbgln_if(SQL_DEBUG, "{}({})", __FUNCTION__, block.index());
-    VERIFY(block.index() < m_next_block);
-    VERIFY(block.next_block() < m_next_block);
-    VERIFY(block.size_in_bytes() > 0);
-    VERIFY(block.data().size() <= Block::DATA_SIZE);
-
-    auto size_in_bytes = block.size_in_bytes();
-    auto next_block = block.next_block();
+    dbgln_if(SQL_DEBUG, "{}({})", __FUNCTION__, page.index);
 
-    auto heap_data = TRY(ByteBuffer::create_zeroed(Block::SIZE));
-    heap_data.overwrite(0, &size_in_bytes, sizeof(size_in_bytes));
-    heap_data.overwrite(sizeof(size_in_bytes), &next_block, sizeof(next_block));
+    VERIFY(page.index > 0);
+    VERIFY(has_block(page.index));
 
-    block.data().bytes().copy_to(heap_data.bytes().slice(Block::HEADER_SIZE));
+    // Zero out freed blocks to facilitate a free block scan upon opening the database later
+    page.data.bytes().fill(0);
+    page.is_dirty = true;
 
-    return write_raw_block_to_wal(block.index(), move(heap_data));
+    return m_free_block_indices.try_append(page.index);
 }
 
-ErrorOr<void> Heap::free_storage(Block::Index index)
+ErrorOr<void> Heap::flush()
 {
-    dbgln_if(SQL_DEBUG, "{}({})", __FUNCTION__, index);
-    VERIFY(index > 0);
-
-    while (index > 0) {
-        auto block = TRY(read_block(index));
-        TRY(free_block(block));
-        index = block.next_block();
+    VERIFY(m_file);
+    Vector<Page*> dirty_pages;
+    for (auto& it : m_pages) {
+        if (it.value->is_dirty)
+            TRY(dirty_pages.try_append(it.value.ptr()));
+    }
+    quick_sort(dirty_pages, [](auto* a, auto* b) { return a->index < b->index; });
+    for (auto* page : dirty_pages) {
+        dbgln_if(SQL_DEBUG, "Flushing block {}", page->index);
+        TRY(write_page(*page));
     }
+    dbgln_if(SQL_DEBUG, "Buffer pool flushed; new number of blocks = {}", m_highest_block_written);
     return {};
 }
 
-ErrorOr<void> Heap::free_block(Block const& block)
+u32 Heap::Page::size_in_bytes() const
 {
-    auto index = block.index();
-    dbgln_if(SQL_DEBUG, "{}({})", __FUNCTION__, index);
-
-    VERIFY(index > 0);
-    VERIFY(has_block(index));
+    u32 size_in_bytes;
+    memcpy(&size_in_bytes, data.offset_pointer(0), sizeof(size_in_bytes));
+    return size_in_bytes;
+}
 
-    // Zero out freed blocks to facilitate a free block scan upon opening the database later
-    auto zeroed_data = TRY(ByteBuffer::create_zeroed(Block::SIZE));
-    TRY(write_raw_block_to_wal(index, move(zeroed_data)));
+Block::Index Heap::Page::next_block() const
+{
+    Block::Index next_block;
+    memcpy(&next_block, data.offset_pointer(sizeof(u32)), sizeof(next_block));
+    return next_block;
+}
 
-    return m_free_block_indices.try_append(index);
+void Heap::Page::write_header(u32 size_in_bytes, Block::Index next_block)
+{
+    data.overwrite(0, &size_in_bytes, sizeof(size_in_bytes));
+    data.overwrite(sizeof(size_in_bytes), &next_block, sizeof(next_block));
 }
 
-ErrorOr<void> Heap::flush()
+ErrorOr<Heap::Page*> Heap::pin_page(Block::Index index, ReadPageContents read_contents)
 {
     VERIFY(m_file);
-    auto indices = m_write_ahead_log.keys();
-    quick_sort(indices);
-    for (auto index : indices) {
-        dbgln_if(SQL_DEBUG, "Flushing block {}", index);
-        auto& data = m_write_ahead_log.get(index).value();
-        TRY(write_raw_block(index, data));
+    VERIFY(index < m_next_block);
+
+    if (auto existing_page = m_pages.get(index); existing_page.has_value()) {
+        auto& page = *existing_page.value();
+        if (page.pin_count++ == 0)
+            m_unpinned_pages.remove(page);
+        return &page;
+    }
+
+    auto page = TRY(take_page_for_reuse());
+    if (read_contents == ReadPageContents::Yes) {
+        dbgln_if(SQL_DEBUG, "Read raw block {}", index);
+        TRY(m_file->seek(index * Block::SIZE, SeekMode::SetPosition));
+        TRY(m_file->read_until_filled(page->data));
     }
-    m_write_ahead_log.clear();
-    dbgln_if(SQL_DEBUG, "WAL flushed; new number of blocks = {}", m_highest_block_written);
+    page->index = index;
+    page->is_dirty = false;
+    page->pin_count = 1;
+
+    auto* page_pointer = page.ptr();
+    TRY(m_pages.try_set(index, move(page)));
+    return page_pointer;
+}
+
+void Heap::unpin_page(Page& page)
+{
+    VERIFY(page.pin_count > 0);
+    if (--page.pin_count == 0)
+        m_unpinned_pages.prepend(page);
+}
+
+ErrorOr<NonnullOwnPtr<Heap::Page>> Heap::take_page_for_reuse()
+{
+    if (m_pages.size() < BUFFER_POOL_SIZE || m_unpinned_pages.is_empty()) {
+        auto page = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Page));
+        page->data = TRY(ByteBuffer::create_zeroed(Block::SIZE));
+        return page;
+    }
+
+    // Evict the least recently used page.
+    auto* victim = m_unpinned_pages.last();
+    if (victim->is_dirty)
+        TRY(write_page(*victim));
+    m_unpinned_pages.remove(*victim);
+    return m_pages.take(victim->index).release_value();
+}
+
+void Heap::drop_all_pages()
+{
+    m_unpinned_pages.clear();
+    m_pages.clear();
+}
+
+ErrorOr<void> Heap::write_page(Page& page)
+{
+    TRY(write_raw_block(page.index, page.data));
+    page.is_dirty = false;
     return {};
 }
 
@@ -299,7 +341,10 @@ ErrorOr<void> Heap::read_zero_block()
 {
     dbgln_if(SQL_DEBUG, "Read zero block from {}", name());
 
-    auto block = TRY(read_raw_block(0));
+    auto* page = TRY(pin_page(0, ReadPageContents::Yes));
+    ScopeGuard unpin_guard = [&] { unpin_page(*page); };
+    auto& block = page->data;
+
     auto file_id_buffer = TRY(block.slice(0, FILE_ID.length()));
     auto file_id = StringView(file_id_buffer);
     if (file_id != FILE_ID) {
@@ -339,16 +384,20 @@ ErrorOr<void> Heap::update_zero_block()
             dbgln_if(SQL_DEBUG, "User value {}: {}", ix, m_user_values[ix]);
     }
 
-    auto buffer = TRY(ByteBuffer::create_zeroed(Block::SIZE));
-    auto buffer_bytes = buffer.bytes();
+    auto* page = TRY(pin_page(0, ReadPageContents::No));
+    ScopeGuard unpin_guard = [&] { unpin_page(*page); };
+
+    auto buffer_bytes = page->data.bytes();
+    buffer_bytes.fill(0);
     buffer_bytes.overwrite(0, FILE_ID.characters_without_null_termination(), FILE_ID.length());
     buffer_bytes.overwrite(VERSION_OFFSET, &m_version, sizeof(u32));
     buffer_bytes.overwrite(SCHEMAS_ROOT_OFFSET, &m_schemas_root, sizeof(u32));
     buffer_bytes.overwrite(TABLES_ROOT_OFFSET, &m_tables_root, sizeof(u32));
     buffer_bytes.overwrite(TABLE_COLUMNS_ROOT_OFFSET, &m_table_columns_root, sizeof(u32));
     buffer_bytes.overwrite(USER_VALUES_OFFSET, m_user_values.data(), m_user_values.size() * sizeof(u32));
+    page->is_dirty = true;
 
-    return write_raw_block_to_wal(0, move(buffer));
+    return {};
 }
 
 ErrorOr<void> Heap::initialize_zero_block()
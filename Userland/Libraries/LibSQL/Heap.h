@@ -11,6 +11,7 @@
 #include <AK/ByteString.h>
 #include <AK/Debug.h>
 #include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
 #include <AK/RefCounted.h>
 #include <AK/Vector.h>
 #include <LibCore/File.h>
@@ -66,7 +67,10 @@ private:
  */
 class Heap : public RefCounted<Heap> {
 public:
-    static constexpr u32 VERSION = 5;
+    static constexpr u32 VERSION = 6;
+
+    // The number of blocks kept in memory by the buffer pool. Pinned pages may temporarily exceed this.
+    static constexpr size_t BUFFER_POOL_SIZE = 256;
 
     static ErrorOr<NonnullRefPtr<Heap>> create(ByteString);
     virtual ~Heap();
@@ -116,21 +120,47 @@ public:
     }
 
     ErrorOr<ByteBuffer> read_storage(Block::Index);
+    ErrorOr<void> read_storage(Block::Index, ByteBuffer&);
     ErrorOr<void> write_storage(Block::Index, ReadonlyBytes);
     ErrorOr<void> free_storage(Block::Index);
 
     ErrorOr<void> flush();
 
 private:
+    /**
+     * A Page holds the raw contents of a single block in the buffer pool. Pages that are not pinned
+     * are kept in least-recently-used order, and are evicted from the pool in that order. Dirty pages
+     * are written back to the file when they are evicted, or when the Heap is flushed.
+     */
+    struct Page {
+        Block::Index index { 0 };
+        ByteBuffer data;
+        bool is_dirty { false };
+        u32 pin_count { 0 };
+        IntrusiveListNode<Page> lru_list_node;
+
+        u32 size_in_bytes() const;
+        Block::Index next_block() const;
+        void write_header(u32 size_in_bytes, Block::Index next_block);
+
+        using List = IntrusiveList<&Page::lru_list_node>;
+    };
+
+    enum class ReadPageContents {
+        No,
+        Yes,
+    };
+
     explicit Heap(ByteString);
 
-    ErrorOr<ByteBuffer> read_raw_block(Block::Index);
-    ErrorOr<void> write_raw_block(Block::Index, ReadonlyBytes);
-    ErrorOr<void> write_raw_block_to_wal(Block::Index, ByteBuffer&&);
+    ErrorOr<Page*> pin_page(Block::Index, ReadPageContents);
+    void unpin_page(Page&);
+    ErrorOr<NonnullOwnPtr<Page>> take_page_for_reuse();
+    void drop_all_pages();
 
-    ErrorOr<Block> read_block(Block::Index);
-    ErrorOr<void> write_block(Block const&);
-    ErrorOr<void> free_block(Block const&);
+    ErrorOr<void> write_raw_block(Block::Index, ReadonlyBytes);
+    ErrorOr<void> write_page(Page&);
+    ErrorOr<void> free_block(Page&);
 
     ErrorOr<void> read_zero_block();
     ErrorOr<void> initialize_zero_block();
@@ -146,7 +176,8 @@ private:
     Block::Index m_table_columns_root { 0 };
     u32 m_version { VERSION };
     Array<u32, 16> m_user_values { 0 };
-    HashMap<Block::Index, ByteBuffer> m_write_ahead_log;
+    HashMap<Block::Index, NonnullOwnPtr<Page>> m_pages;
+    Page::List m_unpinned_pages;
     Vector<Block::Index> m_free_block_indices;
 };
 
@@ -16,9 +16,12 @@ namespace SQL {
 
 #define ENUMERATE_SQL_COMMANDS(S) \
     S(Unknown)                    \
+    S(Begin)                      \
+    S(Commit)                     \
     S(Create)                     \
     S(Delete)                     \
     S(Describe)                   \
+    S(Explain)                    \
     S(Insert)                     \
     S(Select)                     \
     S(Update)
@@ -57,6 +60,7 @@ constexpr char const* command_tag(SQLCommand command)
     S(InvalidOperator, "Invalid operator '{}'")                                                   \
     S(InvalidType, "Invalid type '{}'")                                                           \
     S(InvalidValueType, "Invalid type for attribute '{}'")                                        \
+    S(NoActiveTransaction, "No transaction is active")                                            \
     S(NoError, "No error")                                                                        \
     S(NotYetImplemented, "{}")                                                                    \
     S(NumericOperatorTypeMismatch, "Cannot apply '{}' operator to non-numeric operands")          \
@@ -65,7 +69,8 @@ constexpr char const* command_tag(SQLCommand command)
     S(StatementUnavailable, "Statement with id '{}' Unavailable")                                 \
     S(SyntaxError, "Syntax Error")                                                                \
     S(TableDoesNotExist, "Table '{}' does not exist")                                             \
-    S(TableExists, "Table '{}' already exist")
+    S(TableExists, "Table '{}' already exist")                                                    \
+    S(TransactionAlreadyActive, "A transaction is already active")
 
 enum class SQLErrorCode {
 #undef __ENUMERATE_SQL_ERROR
@@ -49,24 +49,27 @@ void SQLClient::execution_error(u64 statement_id, u64 execution_id, SQLErrorCode
     on_execution_error(move(error));
 }
 
-void SQLClient::next_result(u64 statement_id, u64 execution_id, Vector<Value> const& row)
+void SQLClient::next_results(u64 statement_id, u64 execution_id, Vector<Vector<Value>> const& rows)
 {
+    // The server sends the next batch of rows only once this batch has been handled.
     ScopeGuard guard { [&]() { async_ready_for_next_result(statement_id, execution_id); } };
 
-    if (!on_next_result) {
-        StringBuilder builder;
-        builder.join(", "sv, row, "\"{}\""sv);
-        outln("{}", builder.string_view());
-        return;
+    for (auto& row : const_cast<Vector<Vector<Value>>&>(rows)) {
+        if (!on_next_result) {
+            StringBuilder builder;
+            builder.join(", "sv, row, "\"{}\""sv);
+            outln("{}", builder.string_view());
+            continue;
+        }
+
+        ExecutionResult result {
+            .statement_id = statement_id,
+            .execution_id = execution_id,
+            .values = move(row),
+        };
+
+        on_next_result(move(result));
     }
-
-    ExecutionResult result {
-        .statement_id = statement_id,
-        .execution_id = execution_id,
-        .values = move(const_cast<Vector<Value>&>(row)),
-    };
-
-    on_next_result(move(result));
 }
 
 void SQLClient::results_exhausted(u64 statement_id, u64 execution_id, size_t total_rows)
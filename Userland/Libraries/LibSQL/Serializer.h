@@ -26,13 +26,13 @@ public:
 
     void read_storage(Block::Index block_index)
     {
-        m_buffer = m_heap->read_storage(block_index).release_value_but_fixme_should_propagate_errors();
+        m_heap->read_storage(block_index, m_buffer).release_value_but_fixme_should_propagate_errors();
         m_current_offset = 0;
     }
 
     void reset()
     {
-        m_buffer.clear();
+        m_buffer.clear_with_capacity();
         m_current_offset = 0;
     }
 
@@ -40,12 +40,25 @@ void Tuple::deserialize(Serializer& serializer)
     serializer.deserialize_to<u32>(m_block_index);
     dbgln_if(SQL_DEBUG, "block_index: {}", m_block_index);
     auto number_of_elements = serializer.deserialize<u32>();
-    m_data.clear();
-    m_descriptor->clear();
-    for (auto ix = 0u; ix < number_of_elements; ++ix) {
-        m_descriptor->append(serializer.deserialize<TupleElementDescriptor>());
-        m_data.append(serializer.deserialize<Value>());
+
+    // The element descriptors are not stored with the tuple. They are owned by whatever the tuple was read for, e.g. the
+    // table of a row or the index of a key. A tuple without a descriptor gets one inferred from its values.
+    if (m_descriptor->is_empty()) {
+        m_data.clear();
+        m_data.ensure_capacity(number_of_elements);
+
+        for (auto ix = 0u; ix < number_of_elements; ++ix) {
+            m_data.unchecked_append(serializer.deserialize<Value>());
+            m_descriptor->append(m_data.last().descriptor());
+        }
+        return;
     }
+
+    VERIFY(number_of_elements == m_descriptor->size());
+    m_data.resize(number_of_elements);
+
+    for (auto& value : m_data)
+        serializer.deserialize_to(value);
 }
 
 void Tuple::serialize(Serializer& serializer) const
@@ -53,11 +66,9 @@ void Tuple::serialize(Serializer& serializer) const
     VERIFY(m_descriptor->size() == m_data.size());
     dbgln_if(SQL_DEBUG, "Serializing tuple with block_index {}", block_index());
     serializer.serialize<u32>(block_index());
-    serializer.serialize<u32>(m_descriptor->size());
-    for (auto ix = 0u; ix < m_descriptor->size(); ix++) {
-        serializer.serialize<TupleElementDescriptor>((*m_descriptor)[ix]);
-        serializer.serialize<Value>(m_data[ix]);
-    }
+    serializer.serialize<u32>(m_data.size());
+    for (auto const& value : m_data)
+        serializer.serialize<Value>(value);
 }
 
 Tuple::Tuple(Tuple const& other)
@@ -123,12 +134,8 @@ void Tuple::extend(Tuple const& other)
 size_t Tuple::length() const
 {
     size_t len = 2 * sizeof(u32);
-    for (auto ix = 0u; ix < m_descriptor->size(); ix++) {
-        auto& descriptor = (*m_descriptor)[ix];
-        auto& value = m_data[ix];
-        len += descriptor.length();
-        len += value.length();
-    }
+    for (auto const& value : m_data)
+        len += sizeof(u8) + value.length();
     return len;
 }
 
@@ -777,8 +777,10 @@ void Value::deserialize(Serializer& serializer)
     auto type_data = static_cast<TypeData>(type_flags & 0xf0);
     m_type = static_cast<SQLType>(type_flags & 0x0f);
 
-    if (type_data == TypeData::Null)
+    if (type_data == TypeData::Null) {
+        m_value = {};
         return;
+    }
 
     switch (m_type) {
     case SQLType::Null:
@@ -24,6 +24,14 @@ static constexpr int MAX_TEXTURE_SIZE = 2048;
 static constexpr float MAX_TEXTURE_LOD_BIAS = 2.f;
 static constexpr int SUBPIXEL_BITS = 4;
 
+// Triangles are binned into horizontal bands of this many rows, which are rasterized in parallel. This needs to be
+// a multiple of 2 so that pixel quads never straddle two bins.
+static constexpr int RASTERIZER_BIN_HEIGHT = 32;
+static_assert(RASTERIZER_BIN_HEIGHT % 2 == 0);
+
+// Below this total area of triangle bounds (in pixels), spreading the triangles over several threads costs more than it saves.
+static constexpr int RASTERIZER_PARALLEL_AREA_THRESHOLD = 128 * 128;
+
 static constexpr int NUM_SHADER_INPUTS = 64;
 
 // Verify that we have enough inputs to hold vertex color and texture coordinates for all fixed function texture units
@@ -25,6 +25,7 @@
 #include <LibSoftGPU/SIMD.h>
 #include <LibSoftGPU/Shader.h>
 #include <LibSoftGPU/ShaderCompiler.h>
+#include <LibThreading/Parallel.h>
 #include <math.h>
 
 namespace SoftGPU {
@@ -53,6 +54,12 @@ using AK::SIMD::u32x4;
 
 static constexpr int subpixel_factor = 1 << SUBPIXEL_BITS;
 
+static Threading::TaskPool& task_pool()
+{
+    static Threading::TaskPool pool;
+    return pool;
+}
+
 // Returns positive values for counter-clockwise rotation of vertices. Note that it returns the
 // area of a parallelogram with sides {a, b} and {b, c}, so _double_ the area of the triangle {a, b, c}.
 constexpr static i32 edge_function(IntVector2 const& a, IntVector2 const& b, IntVector2 const& c)
@@ -223,7 +230,7 @@ ALWAYS_INLINE static Vector4<f32x4> blend_colors(
 }
 
 template<typename CB1, typename CB2, typename CB3>
-ALWAYS_INLINE void Device::rasterize(Gfx::IntRect& render_bounds, CB1 set_coverage_mask, CB2 set_quad_depth, CB3 set_quad_attributes)
+ALWAYS_INLINE void Device::rasterize(Gfx::IntRect& render_bounds, ShaderProcessor& shader_processor, CB1 set_coverage_mask, CB2 set_quad_depth, CB3 set_quad_attributes)
 {
     // Return if alpha testing is a no-op
     if (m_options.enable_alpha_test && m_options.alpha_test_func == GPU::AlphaTestFunction::Never)
@@ -301,7 +308,6 @@ ALWAYS_INLINE void Device::rasterize(Gfx::IntRect& render_bounds, CB1 set_covera
     }
 
     // Rasterize all quads
-    // FIXME: this could be embarrassingly parallel
     for (int qy = qy0; qy <= qy1; qy += 2) {
         for (int qx = qx0; qx <= qx1; qx += 2) {
             PixelQuad quad;
@@ -454,7 +460,7 @@ ALWAYS_INLINE void Device::rasterize(Gfx::IntRect& render_bounds, CB1 set_covera
             INCREASE_STATISTICS_COUNTER(g_num_pixels_shaded, maskcount(quad.mask));
 
             set_quad_attributes(quad);
-            shade_fragments(quad);
+            shade_fragments(quad, shader_processor);
 
             // Alpha testing
             if (m_options.enable_alpha_test) {
@@ -546,6 +552,7 @@ void Device::rasterize_line_antialiased(GPU::Vertex& from, GPU::Vertex& to)
     f32x4 distance_along_line;
     rasterize(
         render_bounds,
+        m_shader_processor,
         [&from_coords4, &distance_along_line, &line_vector4, &line_dot4, &line_radius](auto& quad) {
             auto const screen_coordinates4 = to_vec2_f32x4(quad.screen_coordinates);
             auto const pixel_vector = screen_coordinates4 - from_coords4;
@@ -602,6 +609,7 @@ void Device::rasterize_point_aliased(GPU::Vertex& point)
     // Rasterize the point as a rect
     rasterize(
         point_rect,
+        m_shader_processor,
         [](auto& quad) {
             // We already passed in point_rect, so this doesn't matter
             quad.mask = expand4(~0);
@@ -634,6 +642,7 @@ void Device::rasterize_point_antialiased(GPU::Vertex& point)
     // Rasterize using a 2D signed distance field for a circle
     rasterize(
         render_bounds,
+        m_shader_processor,
         [&center4, &radius](auto& quad) {
             auto screen_coords = to_vec2_f32x4(quad.screen_coordinates);
             auto distance_to_point = length(center4 - screen_coords) - radius;
@@ -662,7 +671,7 @@ void Device::rasterize_point(GPU::Vertex& point)
         rasterize_point_aliased(point);
 }
 
-void Device::rasterize_triangle(Triangle& triangle)
+bool Device::setup_triangle(Triangle& triangle, Gfx::IntRect& render_bounds)
 {
     INCREASE_STATISTICS_COUNTER(g_num_rasterized_triangles, 1);
 
@@ -672,26 +681,40 @@ void Device::rasterize_triangle(Triangle& triangle)
 
     auto triangle_area = edge_function(v0, v1, v2);
     if (triangle_area == 0)
-        return;
+        return false;
 
     // Perform face culling
     if (m_options.enable_culling) {
         bool is_front = (m_options.front_face == GPU::WindingOrder::CounterClockwise ? triangle_area > 0 : triangle_area < 0);
 
         if (!is_front && m_options.cull_back)
-            return;
+            return false;
 
         if (is_front && m_options.cull_front)
-            return;
+            return false;
     }
 
     // Force counter-clockwise ordering of vertices
     if (triangle_area < 0) {
         swap(triangle.vertices[0], triangle.vertices[1]);
         swap(v0, v1);
-        triangle_area *= -1;
     }
 
+    // Calculate render bounds based on the triangle's vertices
+    render_bounds.set_left(min(min(v0.x(), v1.x()), v2.x()) / subpixel_factor);
+    render_bounds.set_right(max(max(v0.x(), v1.x()), v2.x()) / subpixel_factor + 1);
+    render_bounds.set_top(min(min(v0.y(), v1.y()), v2.y()) / subpixel_factor);
+    render_bounds.set_bottom(max(max(v0.y(), v1.y()), v2.y()) / subpixel_factor + 1);
+    return true;
+}
+
+ALWAYS_INLINE void Device::rasterize_triangle_impl(Triangle const& triangle, Gfx::IntRect const& render_bounds, Gfx::IntRect const& clip_rect, ShaderProcessor& shader_processor)
+{
+    auto v0 = (triangle.vertices[0].window_coordinates.xy() * subpixel_factor).to_rounded<int>();
+    auto v1 = (triangle.vertices[1].window_coordinates.xy() * subpixel_factor).to_rounded<int>();
+    auto v2 = (triangle.vertices[2].window_coordinates.xy() * subpixel_factor).to_rounded<int>();
+    auto const triangle_area = edge_function(v0, v1, v2);
+
     auto const& vertex0 = triangle.vertices[0];
     auto const& vertex1 = triangle.vertices[1];
     auto const& vertex2 = triangle.vertices[2];
@@ -724,13 +747,6 @@ void Device::rasterize_triangle(Triangle& triangle)
             && edges.z() >= zero.z();
     };
 
-    // Calculate render bounds based on the triangle's vertices
-    Gfx::IntRect render_bounds;
-    render_bounds.set_left(min(min(v0.x(), v1.x()), v2.x()) / subpixel_factor);
-    render_bounds.set_right(max(max(v0.x(), v1.x()), v2.x()) / subpixel_factor + 1);
-    render_bounds.set_top(min(min(v0.y(), v1.y()), v2.y()) / subpixel_factor);
-    render_bounds.set_bottom(max(max(v0.y(), v1.y()), v2.y()) / subpixel_factor + 1);
-
     // Calculate depth of fragment for fog;
     // OpenGL 1.5 chapter 3.10: "An implementation may choose to approximate the
     // eye-coordinate distance from the eye to each fragment center by |Ze|."
@@ -772,8 +788,10 @@ void Device::rasterize_triangle(Triangle& triangle)
         expand4(vertex2.window_coordinates.z() + depth_offset),
     };
 
+    auto clipped_render_bounds = render_bounds.intersected(clip_rect);
     rasterize(
-        render_bounds,
+        clipped_render_bounds,
+        shader_processor,
         [&](auto& quad) {
             auto edge_values = calculate_edge_values4(quad.screen_coordinates * subpixel_factor + half_pixel_offset);
             quad.mask = test_point4(edge_values);
@@ -809,6 +827,27 @@ void Device::rasterize_triangle(Triangle& triangle)
         });
 }
 
+#if ARCH(X86_64)
+// This is the same code as rasterize_triangle_impl(), but compiled for AVX2. Shading and blending are inlined into it.
+[[gnu::target("avx2")]] void Device::rasterize_triangle_with_avx2(Triangle const& triangle, Gfx::IntRect const& render_bounds, Gfx::IntRect const& clip_rect, ShaderProcessor& shader_processor)
+{
+    rasterize_triangle_impl(triangle, render_bounds, clip_rect, shader_processor);
+}
+#endif
+
+// Rasterizes the part of a triangle, as prepared by setup_triangle(), that lies within the clip rect. This can be called
+// for disjoint clip rects on several threads at once, as long as each thread uses its own shader processor.
+void Device::rasterize_triangle(Triangle const& triangle, Gfx::IntRect const& render_bounds, Gfx::IntRect const& clip_rect, ShaderProcessor& shader_processor)
+{
+#if ARCH(X86_64)
+    if (cpu_has_avx2()) {
+        rasterize_triangle_with_avx2(triangle, render_bounds, clip_rect, shader_processor);
+        return;
+    }
+#endif
+    rasterize_triangle_impl(triangle, render_bounds, clip_rect, shader_processor);
+}
+
 Device::Device(Gfx::IntSize size)
     : m_frame_buffer(FrameBuffer<GPU::ColorType, GPU::DepthType, GPU::StencilType>::try_create(size).release_value_but_fixme_should_propagate_errors())
     , m_shader_processor(m_samplers)
@@ -1019,7 +1058,28 @@ void Device::draw_primitives(GPU::PrimitiveType primitive_type, Vector<GPU::Vert
     if (vertices.is_empty())
         return;
 
-    // First, transform all vertices
+    transform_vertices(vertices);
+    rasterize_primitives(primitive_type, vertices);
+}
+
+void Device::draw_indexed_primitives(GPU::PrimitiveType primitive_type, Vector<GPU::Vertex>& vertices, Vector<u32> const& indices)
+{
+    if (indices.is_empty())
+        return;
+
+    // Vertices that are shared by several primitives are only transformed and lit once
+    transform_vertices(vertices);
+
+    m_indexed_vertices.clear_with_capacity();
+    m_indexed_vertices.ensure_capacity(indices.size());
+    for (auto index : indices)
+        m_indexed_vertices.unchecked_append(vertices[index]);
+
+    rasterize_primitives(primitive_type, m_indexed_vertices);
+}
+
+void Device::transform_vertices(Vector<GPU::Vertex>& vertices)
+{
     for (auto& vertex : vertices) {
         vertex.eye_coordinates = m_model_view_transform * vertex.position;
 
@@ -1039,7 +1099,10 @@ void Device::draw_primitives(GPU::PrimitiveType primitive_type, Vector<GPU::Vert
             vertex.tex_coords[i] = texture_unit_configuration.transformation_matrix * vertex.tex_coords[i];
         }
     }
+}
 
+void Device::rasterize_primitives(GPU::PrimitiveType primitive_type, Vector<GPU::Vertex>& vertices)
+{
     // Window coordinate calculation
     auto const viewport = m_options.viewport;
     auto const viewport_half_width = viewport.width() / 2.f;
@@ -1187,14 +1250,82 @@ void Device::draw_primitives(GPU::PrimitiveType primitive_type, Vector<GPU::Vert
         }
     }
 
-    for (auto& triangle : m_processed_triangles)
-        rasterize_triangle(triangle);
+    rasterize_triangles();
+}
+
+void Device::rasterize_triangles()
+{
+    auto clip_rect = m_frame_buffer->rect();
+    if (m_options.scissor_enabled)
+        clip_rect.intersect(m_options.scissor_box);
+
+    m_processed_triangle_bounds.clear_with_capacity();
+    size_t total_area = 0;
+    for (auto& triangle : m_processed_triangles) {
+        Gfx::IntRect render_bounds;
+        if (!setup_triangle(triangle, render_bounds))
+            render_bounds = {};
+        m_processed_triangle_bounds.append(render_bounds);
+        total_area += render_bounds.intersected(clip_rect).size().area();
+    }
+
+    // NOTE: The statistics counters are not thread-safe, so we only bin triangles if they are disabled.
+    if (!ENABLE_STATISTICS_OVERLAY && total_area >= RASTERIZER_PARALLEL_AREA_THRESHOLD && task_pool().concurrency() > 0) {
+        rasterize_triangles_in_bins();
+        return;
+    }
+
+    for (size_t i = 0; i < m_processed_triangles.size(); ++i) {
+        if (!m_processed_triangle_bounds[i].is_empty())
+            rasterize_triangle(m_processed_triangles[i], m_processed_triangle_bounds[i], clip_rect, m_shader_processor);
+    }
+}
+
+// Sorts the triangles into horizontal bins of the frame buffer and rasterizes the bins in parallel. Every bin draws its
+// triangles in submission order, so the result is the same as drawing the triangles one after the other. Each bin also
+// only touches its own rows of the color, depth and stencil buffers, so the workers never share any cache lines.
+void Device::rasterize_triangles_in_bins()
+{
+    auto clip_rect = m_frame_buffer->rect();
+    if (m_options.scissor_enabled)
+        clip_rect.intersect(m_options.scissor_box);
+
+    auto const bin_count = static_cast<size_t>(ceil_div(m_frame_buffer->rect().height(), RASTERIZER_BIN_HEIGHT));
+    if (m_triangle_bins.size() < bin_count)
+        m_triangle_bins.resize(bin_count);
+    for (auto& bin : m_triangle_bins)
+        bin.clear_with_capacity();
+
+    for (size_t i = 0; i < m_processed_triangles.size(); ++i) {
+        auto render_bounds = m_processed_triangle_bounds[i].intersected(clip_rect);
+        if (render_bounds.is_empty())
+            continue;
+        auto const first_bin = render_bounds.top() / RASTERIZER_BIN_HEIGHT;
+        auto const last_bin = (render_bounds.bottom() - 1) / RASTERIZER_BIN_HEIGHT;
+        for (auto bin = first_bin; bin <= last_bin; ++bin)
+            m_triangle_bins[bin].append(i);
+    }
+
+    // A shader processor keeps the registers of the shader it executes, so every bin needs its own.
+    if (m_current_fragment_shader) {
+        while (m_bin_shader_processors.size() < bin_count)
+            m_bin_shader_processors.append(make<ShaderProcessor>(m_samplers));
+    }
+
+    Threading::parallel_for(
+        task_pool(), bin_count, [&](size_t bin) {
+            auto& shader_processor = m_current_fragment_shader ? *m_bin_shader_processors[bin] : m_shader_processor;
+            auto bin_rect = Gfx::IntRect { 0, static_cast<int>(bin) * RASTERIZER_BIN_HEIGHT, m_frame_buffer->rect().width(), RASTERIZER_BIN_HEIGHT }.intersected(clip_rect);
+            for (auto triangle_index : m_triangle_bins[bin])
+                rasterize_triangle(m_processed_triangles[triangle_index], m_processed_triangle_bounds[triangle_index], bin_rect, shader_processor);
+        },
+        1);
 }
 
-ALWAYS_INLINE void Device::shade_fragments(PixelQuad& quad)
+ALWAYS_INLINE void Device::shade_fragments(PixelQuad& quad, ShaderProcessor& shader_processor)
 {
     if (m_current_fragment_shader) {
-        m_shader_processor.execute(quad, *m_current_fragment_shader);
+        shader_processor.execute(quad, *m_current_fragment_shader);
         return;
     }
 
@@ -8,7 +8,9 @@
 #pragma once
 
 #include <AK/Array.h>
+#include <AK/NonnullOwnPtr.h>
 #include <AK/NonnullRefPtr.h>
+#include <AK/Platform.h>
 #include <AK/RefPtr.h>
 #include <AK/Vector.h>
 #include <LibGPU/Device.h>
@@ -50,6 +52,7 @@ public:
     virtual GPU::DeviceInfo info() const override;
 
     virtual void draw_primitives(GPU::PrimitiveType, Vector<GPU::Vertex>& vertices) override;
+    virtual void draw_indexed_primitives(GPU::PrimitiveType, Vector<GPU::Vertex>& vertices, Vector<u32> const& indices) override;
     virtual void resize(Gfx::IntSize min_size) override;
     virtual void clear_color(FloatVector4 const&) override;
     virtual void clear_depth(GPU::DepthType) override;
@@ -93,7 +96,7 @@ private:
     GPU::ImageDataLayout depth_buffer_data_layout(Vector2<u32> size, Vector2<i32> offset);
 
     template<typename CB1, typename CB2, typename CB3>
-    void rasterize(Gfx::IntRect& render_bounds, CB1 set_coverage_mask, CB2 set_quad_depth, CB3 set_quad_attributes);
+    void rasterize(Gfx::IntRect& render_bounds, ShaderProcessor&, CB1 set_coverage_mask, CB2 set_quad_depth, CB3 set_quad_attributes);
 
     void rasterize_line_aliased(GPU::Vertex&, GPU::Vertex&);
     void rasterize_line_antialiased(GPU::Vertex&, GPU::Vertex&);
@@ -103,8 +106,18 @@ private:
     void rasterize_point_antialiased(GPU::Vertex&);
     void rasterize_point(GPU::Vertex&);
 
-    void rasterize_triangle(Triangle&);
-    void shade_fragments(PixelQuad&);
+    void transform_vertices(Vector<GPU::Vertex>&);
+    void rasterize_primitives(GPU::PrimitiveType, Vector<GPU::Vertex>&);
+
+    bool setup_triangle(Triangle&, Gfx::IntRect& render_bounds);
+    void rasterize_triangle(Triangle const&, Gfx::IntRect const& render_bounds, Gfx::IntRect const& clip_rect, ShaderProcessor&);
+    void rasterize_triangle_impl(Triangle const&, Gfx::IntRect const& render_bounds, Gfx::IntRect const& clip_rect, ShaderProcessor&);
+#if ARCH(X86_64)
+    [[gnu::target("avx2")]] void rasterize_triangle_with_avx2(Triangle const&, Gfx::IntRect const& render_bounds, Gfx::IntRect const& clip_rect, ShaderProcessor&);
+#endif
+    void rasterize_triangles();
+    void rasterize_triangles_in_bins();
+    void shade_fragments(PixelQuad&, ShaderProcessor&);
 
     RefPtr<FrameBuffer<GPU::ColorType, GPU::DepthType, GPU::StencilType>> m_frame_buffer {};
     GPU::RasterizerOptions m_options;
@@ -115,7 +128,11 @@ private:
     Clipper m_clipper;
     Vector<Triangle> m_triangle_list;
     Vector<Triangle> m_processed_triangles;
+    Vector<Gfx::IntRect> m_processed_triangle_bounds;
+    Vector<Vector<u32>> m_triangle_bins;
+    Vector<NonnullOwnPtr<ShaderProcessor>> m_bin_shader_processors;
     Vector<GPU::Vertex> m_clipped_vertices;
+    Vector<GPU::Vertex> m_indexed_vertices;
     float m_one_over_fog_depth;
     Array<Sampler, GPU::NUM_TEXTURE_UNITS> m_samplers;
     bool m_samplers_need_texture_staging { false };
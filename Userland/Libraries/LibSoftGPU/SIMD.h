@@ -7,14 +7,44 @@
 
 #pragma once
 
+#include <AK/Platform.h>
 #include <AK/SIMDExtras.h>
 #include <AK/SIMDMath.h>
 #include <LibGfx/Vector2.h>
 #include <LibGfx/Vector3.h>
 #include <LibGfx/Vector4.h>
 
+#if ARCH(X86_64)
+#    include <cpuid.h>
+#endif
+
 namespace SoftGPU {
 
+#if ARCH(X86_64)
+// The fragment pipeline has copies that are compiled for AVX2, which are used if this returns true.
+// NOTE: These copies must not be compiled with FMA enabled, since contracting the multiplications and additions
+//       would round differently and make the output depend on the CPU.
+inline bool cpu_has_avx2()
+{
+    static bool const has_avx2 = [] {
+        u32 eax, ebx, ecx, edx;
+        // The OS has to save the YMM registers too, which it tells with OSXSAVE and XCR0.
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_OSXSAVE) || !(ecx & bit_AVX))
+            return false;
+        u32 xcr0_low, xcr0_high;
+        asm volatile("xgetbv"
+                     : "=a"(xcr0_low), "=d"(xcr0_high)
+                     : "c"(0));
+        if ((xcr0_low & 0b110) != 0b110)
+            return false;
+        if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+            return false;
+        return (ebx & bit_AVX2) != 0;
+    }();
+    return has_avx2;
+}
+#endif
+
 ALWAYS_INLINE static constexpr Vector2<AK::SIMD::f32x4> expand4(Vector2<float> const& v)
 {
     return Vector2<AK::SIMD::f32x4> {
@@ -103,55 +103,7 @@ ALWAYS_INLINE static Vector4<f32x4> texel4border(Image const& image, u32x4 level
     };
 }
 
-Vector4<AK::SIMD::f32x4> Sampler::sample_2d(Vector2<AK::SIMD::f32x4> const& uv) const
-{
-    if (m_config.bound_image.is_null())
-        return expand4(FloatVector4 { 1, 0, 0, 1 });
-
-    auto const& image = *static_ptr_cast<Image>(m_config.bound_image);
-
-    // FIXME: Make base level configurable with glTexParameteri(GL_TEXTURE_BASE_LEVEL, base_level)
-    constexpr unsigned base_level = 0;
-
-    // Determine the texture scale factor. See OpenGL 1.5 spec chapter 3.8.8.
-    // FIXME: Static casting from u32 to float could silently truncate here.
-    // u16 should be plenty enough for texture dimensions and would allow textures of up to 65536x65536x65536 pixels.
-    auto texel_coordinates = uv;
-    texel_coordinates.set_x(texel_coordinates.x() * static_cast<float>(image.width_at_level(base_level)));
-    texel_coordinates.set_y(texel_coordinates.y() * static_cast<float>(image.height_at_level(base_level)));
-    auto dtdx = ddx(texel_coordinates);
-    auto dtdy = ddy(texel_coordinates);
-    auto scale_factor = max(dtdx.dot(dtdx), dtdy.dot(dtdy));
-
-    // FIXME: Here we simply determine the filter based on the single scale factor of the upper left pixel.
-    // Actually, we could end up with different scale factors for each pixel. This however would break our
-    // parallelisation as we could also end up with different filter modes per pixel.
-
-    // Note: scale_factor approximates texels per pixel. This means a scale factor less than 1 indicates texture magnification.
-    if (scale_factor[0] <= 1.f)
-        return sample_2d_lod(uv, expand4(base_level), m_config.texture_mag_filter);
-
-    if (m_config.mipmap_filter == GPU::MipMapFilter::None)
-        return sample_2d_lod(uv, expand4(base_level), m_config.texture_min_filter);
-
-    auto texture_lod_bias = AK::clamp(m_config.level_of_detail_bias, -MAX_TEXTURE_LOD_BIAS, MAX_TEXTURE_LOD_BIAS);
-    // FIXME: Instead of clamping to num_levels - 1, actually make the max mipmap level configurable with glTexParameteri(GL_TEXTURE_MAX_LEVEL, max_level)
-    auto min_level = expand4(static_cast<float>(base_level));
-    auto max_level = expand4(static_cast<float>(image.number_of_levels()) - 1.f);
-    auto lambda_xy = log2_approximate(scale_factor) * .5f + texture_lod_bias;
-    auto level = clamp(lambda_xy, min_level, max_level);
-
-    auto lower_level_texel = sample_2d_lod(uv, to_u32x4(level), m_config.texture_min_filter);
-
-    if (m_config.mipmap_filter == GPU::MipMapFilter::Nearest)
-        return lower_level_texel;
-
-    auto higher_level_texel = sample_2d_lod(uv, to_u32x4(min(level + 1.f, max_level)), m_config.texture_min_filter);
-
-    return mix(lower_level_texel, higher_level_texel, frac_int_range(level));
-}
-
-Vector4<AK::SIMD::f32x4> Sampler::sample_2d_lod(Vector2<AK::SIMD::f32x4> const& uv, AK::SIMD::u32x4 level, GPU::TextureFilter filter) const
+ALWAYS_INLINE Vector4<AK::SIMD::f32x4> Sampler::sample_2d_lod(Vector2<AK::SIMD::f32x4> const& uv, AK::SIMD::u32x4 level, GPU::TextureFilter filter) const
 {
     auto const& image = *static_ptr_cast<Image>(m_config.bound_image);
 
@@ -240,4 +192,68 @@ Vector4<AK::SIMD::f32x4> Sampler::sample_2d_lod(Vector2<AK::SIMD::f32x4> const&
     return mix(lerp_0, lerp_1, beta);
 }
 
+ALWAYS_INLINE Vector4<AK::SIMD::f32x4> Sampler::sample_2d_impl(Vector2<AK::SIMD::f32x4> const& uv) const
+{
+    if (m_config.bound_image.is_null())
+        return expand4(FloatVector4 { 1, 0, 0, 1 });
+
+    auto const& image = *static_ptr_cast<Image>(m_config.bound_image);
+
+    // FIXME: Make base level configurable with glTexParameteri(GL_TEXTURE_BASE_LEVEL, base_level)
+    constexpr unsigned base_level = 0;
+
+    // Determine the texture scale factor. See OpenGL 1.5 spec chapter 3.8.8.
+    // FIXME: Static casting from u32 to float could silently truncate here.
+    // u16 should be plenty enough for texture dimensions and would allow textures of up to 65536x65536x65536 pixels.
+    auto texel_coordinates = uv;
+    texel_coordinates.set_x(texel_coordinates.x() * static_cast<float>(image.width_at_level(base_level)));
+    texel_coordinates.set_y(texel_coordinates.y() * static_cast<float>(image.height_at_level(base_level)));
+    auto dtdx = ddx(texel_coordinates);
+    auto dtdy = ddy(texel_coordinates);
+    auto scale_factor = max(dtdx.dot(dtdx), dtdy.dot(dtdy));
+
+    // FIXME: Here we simply determine the filter based on the single scale factor of the upper left pixel.
+    // Actually, we could end up with different scale factors for each pixel. This however would break our
+    // parallelisation as we could also end up with different filter modes per pixel.
+
+    // Note: scale_factor approximates texels per pixel. This means a scale factor less than 1 indicates texture magnification.
+    if (scale_factor[0] <= 1.f)
+        return sample_2d_lod(uv, expand4(base_level), m_config.texture_mag_filter);
+
+    if (m_config.mipmap_filter == GPU::MipMapFilter::None)
+        return sample_2d_lod(uv, expand4(base_level), m_config.texture_min_filter);
+
+    auto texture_lod_bias = AK::clamp(m_config.level_of_detail_bias, -MAX_TEXTURE_LOD_BIAS, MAX_TEXTURE_LOD_BIAS);
+    // FIXME: Instead of clamping to num_levels - 1, actually make the max mipmap level configurable with glTexParameteri(GL_TEXTURE_MAX_LEVEL, max_level)
+    auto min_level = expand4(static_cast<float>(base_level));
+    auto max_level = expand4(static_cast<float>(image.number_of_levels()) - 1.f);
+    auto lambda_xy = log2_approximate(scale_factor) * .5f + texture_lod_bias;
+    auto level = clamp(lambda_xy, min_level, max_level);
+
+    auto lower_level_texel = sample_2d_lod(uv, to_u32x4(level), m_config.texture_min_filter);
+
+    if (m_config.mipmap_filter == GPU::MipMapFilter::Nearest)
+        return lower_level_texel;
+
+    auto higher_level_texel = sample_2d_lod(uv, to_u32x4(min(level + 1.f, max_level)), m_config.texture_min_filter);
+
+    return mix(lower_level_texel, higher_level_texel, frac_int_range(level));
+}
+
+#if ARCH(X86_64)
+[[gnu::target("avx2")]] Vector4<AK::SIMD::f32x4> Sampler::sample_2d_with_avx2(Vector2<AK::SIMD::f32x4> const& uv) const
+{
+    return sample_2d_impl(uv);
+}
+#endif
+
+Vector4<AK::SIMD::f32x4> Sampler::sample_2d(Vector2<AK::SIMD::f32x4> const& uv) const
+{
+#if ARCH(X86_64)
+    if (cpu_has_avx2())
+        return sample_2d_with_avx2(uv);
+#endif
+    return sample_2d_impl(uv);
+}
+
 }
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Platform.h>
 #include <AK/SIMD.h>
 #include <LibGPU/SamplerConfig.h>
 #include <LibGfx/Vector2.h>
@@ -21,6 +22,10 @@ public:
     GPU::SamplerConfig const& config() const { return m_config; }
 
 private:
+    Vector4<AK::SIMD::f32x4> sample_2d_impl(Vector2<AK::SIMD::f32x4> const& uv) const;
+#if ARCH(X86_64)
+    [[gnu::target("avx2")]] Vector4<AK::SIMD::f32x4> sample_2d_with_avx2(Vector2<AK::SIMD::f32x4> const& uv) const;
+#endif
     Vector4<AK::SIMD::f32x4> sample_2d_lod(Vector2<AK::SIMD::f32x4> const& uv, AK::SIMD::u32x4 level, GPU::TextureFilter) const;
 
     GPU::SamplerConfig m_config;
@@ -6,6 +6,7 @@
 
 #include <LibGfx/Vector2.h>
 #include <LibGfx/Vector4.h>
+#include <LibSoftGPU/SIMD.h>
 #include <LibSoftGPU/Shader.h>
 #include <LibSoftGPU/ShaderProcessor.h>
 
@@ -13,43 +14,7 @@ namespace SoftGPU {
 
 using AK::SIMD::f32x4;
 
-void ShaderProcessor::execute(PixelQuad& quad, Shader const& shader)
-{
-    auto& instructions = shader.instructions();
-    for (size_t program_counter = 0; program_counter < instructions.size(); ++program_counter) {
-        auto instruction = instructions[program_counter];
-        switch (instruction.operation) {
-        case Opcode::Input:
-            op_input(quad, instruction.arguments);
-            break;
-        case Opcode::Output:
-            op_output(quad, instruction.arguments);
-            break;
-        case Opcode::Sample2D:
-            op_sample2d(instruction.arguments);
-            break;
-        case Opcode::Swizzle:
-            op_swizzle(instruction.arguments);
-            break;
-        case Opcode::Add:
-            op_add(instruction.arguments);
-            break;
-        case Opcode::Sub:
-            op_sub(instruction.arguments);
-            break;
-        case Opcode::Mul:
-            op_mul(instruction.arguments);
-            break;
-        case Opcode::Div:
-            op_div(instruction.arguments);
-            break;
-        default:
-            VERIFY_NOT_REACHED();
-        }
-    }
-}
-
-void ShaderProcessor::op_input(PixelQuad const& quad, Instruction::Arguments arguments)
+ALWAYS_INLINE void ShaderProcessor::op_input(PixelQuad const& quad, Instruction::Arguments arguments)
 {
     set_register(arguments.input.target_register, quad.get_input_float(arguments.input.input_index));
     set_register(arguments.input.target_register + 1, quad.get_input_float(arguments.input.input_index + 1));
@@ -57,7 +22,7 @@ void ShaderProcessor::op_input(PixelQuad const& quad, Instruction::Arguments arg
     set_register(arguments.input.target_register + 3, quad.get_input_float(arguments.input.input_index + 3));
 }
 
-void ShaderProcessor::op_output(PixelQuad& quad, Instruction::Arguments arguments)
+ALWAYS_INLINE void ShaderProcessor::op_output(PixelQuad& quad, Instruction::Arguments arguments)
 {
     quad.set_output(arguments.output.output_index, get_register(arguments.output.source_register));
     quad.set_output(arguments.output.output_index + 1, get_register(arguments.output.source_register + 1));
@@ -65,7 +30,7 @@ void ShaderProcessor::op_output(PixelQuad& quad, Instruction::Arguments argument
     quad.set_output(arguments.output.output_index + 3, get_register(arguments.output.source_register + 3));
 }
 
-void ShaderProcessor::op_sample2d(Instruction::Arguments arguments)
+ALWAYS_INLINE void ShaderProcessor::op_sample2d(Instruction::Arguments arguments)
 {
     Vector2<AK::SIMD::f32x4> coordinates = {
         get_register(arguments.sample.coordinates_register),
@@ -78,7 +43,7 @@ void ShaderProcessor::op_sample2d(Instruction::Arguments arguments)
     set_register(arguments.sample.target_register + 3, sample.w());
 }
 
-void ShaderProcessor::op_swizzle(Instruction::Arguments arguments)
+ALWAYS_INLINE void ShaderProcessor::op_swizzle(Instruction::Arguments arguments)
 {
     f32x4 inputs[] {
         get_register(arguments.swizzle.source_register),
@@ -94,7 +59,7 @@ void ShaderProcessor::op_swizzle(Instruction::Arguments arguments)
 }
 
 #define SHADER_BINOP(NAME, OP)                                                            \
-    void ShaderProcessor::op_##NAME(Instruction::Arguments arguments)                     \
+    ALWAYS_INLINE void ShaderProcessor::op_##NAME(Instruction::Arguments arguments)       \
     {                                                                                     \
         auto const target = arguments.binop.target_register;                              \
         auto const source1 = arguments.binop.source_register1;                            \
@@ -112,4 +77,58 @@ SHADER_BINOP(div, /)
 
 #undef SHADER_BINOP
 
+ALWAYS_INLINE void ShaderProcessor::execute_impl(PixelQuad& quad, Shader const& shader)
+{
+    auto& instructions = shader.instructions();
+    for (size_t program_counter = 0; program_counter < instructions.size(); ++program_counter) {
+        auto instruction = instructions[program_counter];
+        switch (instruction.operation) {
+        case Opcode::Input:
+            op_input(quad, instruction.arguments);
+            break;
+        case Opcode::Output:
+            op_output(quad, instruction.arguments);
+            break;
+        case Opcode::Sample2D:
+            op_sample2d(instruction.arguments);
+            break;
+        case Opcode::Swizzle:
+            op_swizzle(instruction.arguments);
+            break;
+        case Opcode::Add:
+            op_add(instruction.arguments);
+            break;
+        case Opcode::Sub:
+            op_sub(instruction.arguments);
+            break;
+        case Opcode::Mul:
+            op_mul(instruction.arguments);
+            break;
+        case Opcode::Div:
+            op_div(instruction.arguments);
+            break;
+        default:
+            VERIFY_NOT_REACHED();
+        }
+    }
+}
+
+#if ARCH(X86_64)
+[[gnu::target("avx2")]] void ShaderProcessor::execute_with_avx2(PixelQuad& quad, Shader const& shader)
+{
+    execute_impl(quad, shader);
+}
+#endif
+
+void ShaderProcessor::execute(PixelQuad& quad, Shader const& shader)
+{
+#if ARCH(X86_64)
+    if (cpu_has_avx2()) {
+        execute_with_avx2(quad, shader);
+        return;
+    }
+#endif
+    execute_impl(quad, shader);
+}
+
 }
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/Array.h>
+#include <AK/Platform.h>
 #include <AK/SIMD.h>
 #include <AK/Vector.h>
 #include <LibGPU/Config.h>
@@ -30,6 +31,11 @@ public:
     ALWAYS_INLINE void set_register(u16 index, AK::SIMD::f32x4 value) { m_registers[index] = value; }
 
 private:
+    void execute_impl(PixelQuad&, Shader const&);
+#if ARCH(X86_64)
+    [[gnu::target("avx2")]] void execute_with_avx2(PixelQuad&, Shader const&);
+#endif
+
     void op_input(PixelQuad const&, Instruction::Arguments);
     void op_output(PixelQuad&, Instruction::Arguments);
     void op_sample2d(Instruction::Arguments);
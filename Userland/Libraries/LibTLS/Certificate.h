@@ -7,7 +7,9 @@
 #pragma once
 
 #include <AK/ByteBuffer.h>
+#include <AK/ByteString.h>
 #include <AK/Forward.h>
+#include <AK/HashMap.h>
 #include <AK/Optional.h>
 #include <AK/Time.h>
 #include <AK/Types.h>
@@ -299,6 +301,7 @@ public:
     DefaultRootCACertificates();
 
     Vector<Certificate> const& certificates() const { return m_ca_certificates; }
+    HashMap<ByteString, Certificate> const& certificates_by_subject() const { return m_ca_certificates_by_subject; }
 
     static ErrorOr<Vector<Certificate>> parse_pem_root_certificate_authorities(ByteBuffer&);
     static ErrorOr<Vector<Certificate>> load_certificates(Span<ByteString> custom_cert_paths = {});
@@ -309,6 +312,7 @@ public:
 
 private:
     Vector<Certificate> m_ca_certificates;
+    HashMap<ByteString, Certificate> m_ca_certificates_by_subject;
 };
 
 }
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCrypto/Hash/SHA2.h>
+#include <LibTLS/CertificateCache.h>
+
+namespace TLS {
+
+template<typename Entry>
+static void evict_least_recently_used_entry(HashMap<ByteBuffer, Entry>& entries)
+{
+    auto least_recently_used = entries.begin();
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        if (it->value.last_use < least_recently_used->value.last_use)
+            least_recently_used = it;
+    }
+    entries.remove(least_recently_used);
+}
+
+CertificateCache& CertificateCache::the()
+{
+    static thread_local CertificateCache s_the;
+    return s_the;
+}
+
+ErrorOr<Certificate> CertificateCache::parse_certificate(ReadonlyBytes der)
+{
+    auto digest = Crypto::Hash::SHA256::hash(der.data(), der.size());
+    auto fingerprint = TRY(ByteBuffer::copy(digest.bytes()));
+
+    if (auto it = m_certificates.find(fingerprint); it != m_certificates.end()) {
+        it->value.last_use = m_next_use++;
+        return it->value.certificate;
+    }
+
+    auto certificate = TRY(Certificate::parse_certificate(der));
+    certificate.fingerprint = fingerprint;
+
+    if (m_certificates.size() >= maximum_certificate_count)
+        evict_least_recently_used_entry(m_certificates);
+    m_certificates.set(move(fingerprint), { certificate, m_next_use++ });
+
+    return certificate;
+}
+
+Optional<ByteBuffer> CertificateCache::chain_key(ReadonlySpan<Certificate> chain)
+{
+    ByteBuffer key;
+    for (auto const& certificate : chain) {
+        if (certificate.fingerprint.is_empty())
+            return {};
+        if (key.try_append(certificate.fingerprint).is_error())
+            return {};
+    }
+    return key;
+}
+
+bool CertificateCache::is_verified_chain(ByteBuffer const& chain_key)
+{
+    auto it = m_verified_chains.find(chain_key);
+    if (it == m_verified_chains.end())
+        return false;
+
+    if (it->value.expiration_time <= UnixDateTime::now()) {
+        m_verified_chains.remove(it);
+        return false;
+    }
+
+    it->value.last_use = m_next_use++;
+    return true;
+}
+
+void CertificateCache::did_verify_chain(ByteBuffer chain_key, UnixDateTime expiration_time)
+{
+    expiration_time = min(expiration_time, UnixDateTime::now() + maximum_chain_lifetime);
+
+    if (!m_verified_chains.contains(chain_key) && m_verified_chains.size() >= maximum_chain_count)
+        evict_least_recently_used_entry(m_verified_chains);
+    m_verified_chains.set(move(chain_key), { expiration_time, m_next_use++ });
+}
+
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Error.h>
+#include <AK/HashMap.h>
+#include <AK/Optional.h>
+#include <AK/Span.h>
+#include <AK/Time.h>
+#include <LibTLS/Certificate.h>
+
+namespace TLS {
+
+// Lets repeated connections to the same servers skip the expensive parts of checking their certificates: parsing the
+// DER encoding of each certificate, and verifying the signatures along the chain up to a root certificate.
+//
+// Like DefaultRootCACertificates, there is one of these per thread, as certificates hold reference-counted strings
+// that can't be shared between threads.
+class CertificateCache {
+public:
+    static constexpr size_t maximum_certificate_count = 256;
+    static constexpr size_t maximum_chain_count = 128;
+
+    // A chain is verified again after this long, even if none of its certificates expire before that.
+    static constexpr AK::Duration maximum_chain_lifetime = AK::Duration::from_seconds(60 * 60);
+
+    static CertificateCache& the();
+
+    // Returns the certificate parsed earlier from the same DER encoding, or parses it. Certificates parsed this way
+    // have their fingerprint set to the SHA-256 digest of their encoding.
+    ErrorOr<Certificate> parse_certificate(ReadonlyBytes der);
+
+    // Identifies a chain by the fingerprints of its certificates. There is none if any of them lacks a fingerprint.
+    static Optional<ByteBuffer> chain_key(ReadonlySpan<Certificate>);
+
+    // Whether the chain was verified against the default root certificates before, and is still valid.
+    bool is_verified_chain(ByteBuffer const& chain_key);
+    void did_verify_chain(ByteBuffer chain_key, UnixDateTime expiration_time);
+
+private:
+    struct CertificateEntry {
+        Certificate certificate;
+        u64 last_use { 0 };
+    };
+
+    struct ChainEntry {
+        UnixDateTime expiration_time;
+        u64 last_use { 0 };
+    };
+
+    HashMap<ByteBuffer, CertificateEntry> m_certificates;
+    HashMap<ByteBuffer, ChainEntry> m_verified_chains;
+    u64 m_next_use { 0 };
+};
+
+}
@@ -68,6 +68,7 @@ enum class CipherAlgorithm {
     AES_128_CCM_8,
     AES_256_CBC,
     AES_256_GCM,
+    CHACHA20_POLY1305,
 };
 
 constexpr size_t cipher_key_size(CipherAlgorithm algorithm)
@@ -80,6 +81,7 @@ constexpr size_t cipher_key_size(CipherAlgorithm algorithm)
         return 128;
     case CipherAlgorithm::AES_256_CBC:
     case CipherAlgorithm::AES_256_GCM:
+    case CipherAlgorithm::CHACHA20_POLY1305:
         return 256;
     case CipherAlgorithm::Invalid:
     default:
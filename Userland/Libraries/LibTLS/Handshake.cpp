@@ -34,6 +34,25 @@ ByteBuffer TLSv12::build_hello()
     builder.append(version);
     builder.append(m_context.local_random, sizeof(m_context.local_random));
 
+    if (can_resume_sessions()) {
+        m_context.offered_session = SessionCache::the().session_for(m_context.extensions.SNI);
+        if (m_context.offered_session.has_value() && !m_context.options.usable_cipher_suites.contains_slow(m_context.offered_session->cipher))
+            m_context.offered_session.clear();
+    }
+
+    if (m_context.offered_session.has_value()) {
+        auto const& session = *m_context.offered_session;
+        if (!session.ticket.is_empty()) {
+            // RFC 5077 section 3.4: The server echoes this session ID if it accepts the ticket, which is how we can
+            // tell that the session is being resumed.
+            fill_with_random(m_context.session_id);
+            m_context.session_id_size = sizeof(m_context.session_id);
+        } else {
+            memcpy(m_context.session_id, session.session_id.data(), session.session_id.size());
+            m_context.session_id_size = session.session_id.size();
+        }
+    }
+
     builder.append(m_context.session_id_size);
     if (m_context.session_id_size)
         builder.append(m_context.session_id, m_context.session_id_size);
@@ -89,6 +108,14 @@ ByteBuffer TLSv12::build_hello()
     if (enable_extended_master_secret)
         extension_length += 4;
 
+    // session_ticket: an empty extension asks the server for a ticket, otherwise it carries the ticket to resume.
+    bool offer_session_ticket = can_resume_sessions();
+    ReadonlyBytes session_ticket;
+    if (m_context.offered_session.has_value())
+        session_ticket = m_context.offered_session->ticket;
+    if (offer_session_ticket)
+        extension_length += 4 + session_ticket.size();
+
     builder.append((u16)extension_length);
 
     if (sni_length) {
@@ -139,9 +166,28 @@ ByteBuffer TLSv12::build_hello()
         builder.append((u16)0);
     }
 
+    if (offer_session_ticket) {
+        // session_ticket extension
+        builder.append((u16)ExtensionType::SESSION_TICKET);
+        builder.append((u16)session_ticket.size());
+        if (!session_ticket.is_empty())
+            builder.append(session_ticket);
+    }
+
     if (alpn_length) {
-        // TODO
-        VERIFY_NOT_REACHED();
+        // application_layer_protocol_negotiation extension
+        builder.append((u16)ExtensionType::APPLICATION_LAYER_PROTOCOL_NEGOTIATION);
+        builder.append((u16)(alpn_length + 2));
+        builder.append((u16)alpn_length);
+        if (!m_context.negotiated_alpn.is_empty()) {
+            builder.append((u8)alpn_negotiated_length);
+            builder.append((u8 const*)m_context.negotiated_alpn.characters(), alpn_negotiated_length);
+        } else {
+            for (auto& alpn : m_context.alpn) {
+                builder.append((u8)alpn.length());
+                builder.append((u8 const*)alpn.characters(), alpn.length());
+            }
+        }
     }
 
     // set the "length" field of the packet
@@ -227,6 +273,96 @@ ssize_t TLSv12::handle_handshake_finished(ReadonlyBytes buffer, WritePacketStage
 
     // TODO: Compare Hashes
     dbgln_if(TLS_DEBUG, "FIXME: handle_handshake_finished :: Check message validity");
+
+    if (m_context.is_resumed_session) {
+        // In an abbreviated handshake, the server finishes first, and the handshake is done once we have replied.
+        write_packets = WritePacketStage::Finished;
+        return index + size;
+    }
+
+    did_finish_handshake();
+
+    return index + size;
+}
+
+ssize_t TLSv12::handle_new_session_ticket(ReadonlyBytes buffer)
+{
+    // https://datatracker.ietf.org/doc/html/rfc5077#section-3.3
+    if (m_context.connection_status != ConnectionStatus::Negotiating && m_context.connection_status != ConnectionStatus::KeyExchange) {
+        dbgln("unexpected new session ticket message");
+        return (i8)Error::UnexpectedMessage;
+    }
+
+    if (buffer.size() < 3 + 4 + 2)
+        return (i8)Error::NeedMoreData;
+
+    size_t size = buffer[0] * 0x10000 + buffer[1] * 0x100 + buffer[2];
+    if (size < 4 + 2)
+        return (i8)Error::BrokenPacket;
+    if (buffer.size() - 3 < size)
+        return (i8)Error::NeedMoreData;
+
+    auto lifetime_hint = AK::convert_between_host_and_network_endian(ByteReader::load32(buffer.offset_pointer(3)));
+    size_t ticket_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(7)));
+    if (ticket_length + 4 + 2 != size)
+        return (i8)Error::BrokenPacket;
+
+    // An empty ticket means that the server changed its mind about issuing one.
+    auto ticket_or_error = ByteBuffer::copy(buffer.slice(9, ticket_length));
+    if (ticket_or_error.is_error())
+        return (i8)Error::OutOfMemory;
+    m_context.session_ticket = ticket_or_error.release_value();
+    m_context.session_ticket_lifetime_hint = lifetime_hint;
+
+    dbgln_if(TLS_DEBUG, "Received a session ticket of {} bytes, lifetime hint {}s", ticket_length, lifetime_hint);
+
+    return 3 + size;
+}
+
+bool TLSv12::can_resume_sessions() const
+{
+    // Resuming a session skips verifying the server's certificate chain, so only share sessions between connections
+    // that would have verified it in the same way.
+    auto const& options = m_context.options;
+    return !m_context.is_server
+        && options.enable_session_resumption
+        && options.validate_certificates
+        && !options.allow_self_signed_certificates
+        && !options.root_certificates.has_value()
+        && options.use_sni
+        && !m_context.extensions.SNI.is_empty();
+}
+
+void TLSv12::store_session_for_resumption()
+{
+    if (!can_resume_sessions())
+        return;
+
+    // Keep the ticket we offered if the server accepted it without issuing a new one.
+    ByteBuffer ticket = m_context.session_ticket;
+    if (ticket.is_empty() && m_context.is_resumed_session && m_context.offered_session.has_value())
+        ticket = m_context.offered_session->ticket;
+
+    if (ticket.is_empty() && m_context.session_id_size == 0)
+        return;
+
+    auto lifetime = SessionCache::maximum_session_lifetime;
+    if (m_context.session_ticket_lifetime_hint != 0)
+        lifetime = min(lifetime, AK::Duration::from_seconds(m_context.session_ticket_lifetime_hint));
+
+    SessionCache::Session session;
+    session.session_id = MUST(ByteBuffer::copy(m_context.session_id, m_context.session_id_size));
+    session.ticket = move(ticket);
+    session.master_key = m_context.master_key;
+    session.cipher = m_context.cipher;
+    session.extended_master_secret = m_context.extensions.extended_master_secret;
+    session.expiration_time = MonotonicTime::now_coarse() + lifetime;
+
+    SessionCache::the().store(m_context.extensions.SNI, move(session));
+}
+
+void TLSv12::did_finish_handshake()
+{
     m_context.connection_status = ConnectionStatus::Established;
 
     if (m_handshake_timeout_timer) {
@@ -236,10 +372,10 @@ ssize_t TLSv12::handle_handshake_finished(ReadonlyBytes buffer, WritePacketStage
         m_handshake_timeout_timer = nullptr;
     }
 
+    store_session_for_resumption();
+
     if (on_connected)
         on_connected();
-
-    return index + size;
 }
 
 ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
@@ -391,6 +527,16 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
                 payload_res = (i8)Error::UnexpectedMessage;
             }
             break;
+        case HandshakeType::NEW_SESSION_TICKET:
+            if (m_context.handshake_messages[3] >= 1) {
+                dbgln("unexpected new session ticket message");
+                payload_res = (i8)Error::UnexpectedMessage;
+                break;
+            }
+            ++m_context.handshake_messages[3];
+            dbgln_if(TLS_DEBUG, "new session ticket");
+            payload_res = handle_new_session_ticket(buffer.slice(1, payload_size));
+            break;
         case HandshakeType::CLIENT_KEY_EXCHANGE_RESERVED:
             if (m_context.handshake_messages[9] >= 1) {
                 dbgln("unexpected client key exchange message");
@@ -547,7 +693,7 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
                 auto packet = build_handshake_finished();
                 write_packet(packet);
             }
-            m_context.connection_status = ConnectionStatus::Established;
+            did_finish_handshake();
             break;
         }
         payload_size++;
@@ -10,6 +10,7 @@
 
 #include <LibCore/Timer.h>
 #include <LibCrypto/ASN1/DER.h>
+#include <LibTLS/CertificateCache.h>
 #include <LibTLS/TLSv12.h>
 
 namespace TLS {
@@ -75,7 +76,7 @@ ssize_t TLSv12::handle_certificate(ReadonlyBytes buffer)
             }
             remaining -= certificate_size_specific;
 
-            auto certificate = Certificate::parse_certificate(buffer.slice(res_cert, certificate_size_specific), false);
+            auto certificate = CertificateCache::the().parse_certificate(buffer.slice(res_cert, certificate_size_specific));
             if (!certificate.is_error()) {
                 m_context.certificates.empend(certificate.value());
                 valid_certificate = true;
@@ -41,7 +41,8 @@ bool TLSv12::expand_key()
 
     size_t offset = 0;
     if (is_aead) {
-        iv_size = 4; // Explicit IV size.
+        // The fixed part of the nonce, the rest is explicit (GCM) or the sequence number (ChaCha20-Poly1305, RFC 7905).
+        iv_size = get_cipher_algorithm(m_context.cipher) == CipherAlgorithm::CHACHA20_POLY1305 ? 12 : 4;
     } else {
         memcpy(m_context.crypto.local_mac, key + offset, mac_size);
         offset += mac_size;
@@ -96,6 +97,15 @@ bool TLSv12::expand_key()
         m_cipher_remote = Crypto::Cipher::AESCipher::GCMMode(ReadonlyBytes { server_key, key_size }, key_size * 8, Crypto::Cipher::Intent::Decryption, Crypto::Cipher::PaddingMode::RFC5246);
         break;
     }
+    case CipherAlgorithm::CHACHA20_POLY1305: {
+        VERIFY(is_aead);
+        memcpy(m_context.crypto.local_aead_iv, client_iv, iv_size);
+        memcpy(m_context.crypto.remote_aead_iv, server_iv, iv_size);
+
+        m_cipher_local = Crypto::AEAD::ChaCha20Poly1305(ReadonlyBytes { client_key, key_size }, ReadonlyBytes { client_iv, iv_size });
+        m_cipher_remote = Crypto::AEAD::ChaCha20Poly1305(ReadonlyBytes { server_key, key_size }, ReadonlyBytes { server_iv, iv_size });
+        break;
+    }
     case CipherAlgorithm::AES_128_CCM:
         dbgln("Requested unimplemented AES CCM cipher");
         TODO();
@@ -61,6 +61,13 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
         return (i8)Error::NeedMoreData;
     }
 
+    // The server agrees to resume the session we offered by echoing its session ID.
+    auto const& offered_session = m_context.offered_session;
+    bool is_resuming_session = offered_session.has_value()
+        && session_length != 0
+        && session_length == m_context.session_id_size
+        && ReadonlyBytes { m_context.session_id, m_context.session_id_size } == buffer.slice(res, session_length);
+
     if (session_length && session_length <= 32) {
         memcpy(m_context.session_id, buffer.offset_pointer(res), session_length);
         m_context.session_id_size = session_length;
@@ -84,6 +91,10 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
         dbgln("No supported cipher could be agreed upon");
         return (i8)Error::NoCommonCipher;
     }
+    if (is_resuming_session && cipher != offered_session->cipher) {
+        dbgln("Server resumed a session with a different cipher suite");
+        return (i8)Error::NotSafe;
+    }
     m_context.cipher = cipher;
     dbgln_if(TLS_DEBUG, "Cipher: {}", enum_to_string(cipher));
 
@@ -157,15 +168,15 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
                     size_t alpn_position = 0;
                     while (alpn_position < alpn_length) {
                         u8 alpn_size = alpn[alpn_position++];
-                        if (alpn_size + alpn_position >= extension_length)
+                        if (alpn_size + alpn_position > alpn_length)
                             break;
-                        ByteString alpn_str { (char const*)alpn + alpn_position, alpn_length };
+                        ByteString alpn_str { (char const*)alpn + alpn_position, alpn_size };
                         if (alpn_size && m_context.alpn.contains_slow(alpn_str)) {
                             m_context.negotiated_alpn = alpn_str;
-                            dbgln("negotiated alpn: {}", alpn_str);
+                            dbgln_if(TLS_DEBUG, "negotiated alpn: {}", alpn_str);
                             break;
                         }
-                        alpn_position += alpn_length;
+                        alpn_position += alpn_size;
                         if (!m_context.is_server) // server hello must contain one ALPN
                             break;
                     }
@@ -190,12 +201,35 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
         } else if (extension_type == ExtensionType::EXTENDED_MASTER_SECRET) {
             m_context.extensions.extended_master_secret = true;
             res += extension_length;
+        } else if (extension_type == ExtensionType::SESSION_TICKET) {
+            // RFC 5077 section 3.2: An empty extension, saying that a NewSessionTicket message will follow.
+            res += extension_length;
         } else {
             dbgln("Encountered unknown extension {} with length {}", enum_to_string(extension_type), extension_length);
             res += extension_length;
         }
     }
 
+    if (is_resuming_session) {
+        // RFC 7627 section 5.3: A session has to be resumed with the same kind of master secret it was created with.
+        if (m_context.extensions.extended_master_secret != offered_session->extended_master_secret) {
+            dbgln("Server resumed a session with a different extended_master_secret setting");
+            return (i8)Error::NotSafe;
+        }
+
+        dbgln_if(TLS_DEBUG, "Resuming session");
+        m_context.is_resumed_session = true;
+        m_context.master_key = offered_session->master_key;
+        if (!expand_key())
+            return (i8)Error::NotSafe;
+
+        // The server's ChangeCipherSpec and Finished come next, there is no key exchange.
+        m_context.connection_status = ConnectionStatus::KeyExchange;
+    } else if (offered_session.has_value()) {
+        // The server didn't want to resume the session, so it's of no further use.
+        SessionCache::the().remove(m_context.extensions.SNI);
+    }
+
     return res;
 }
 
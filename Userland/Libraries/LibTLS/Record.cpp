@@ -6,13 +6,25 @@
 
 #include <AK/Debug.h>
 #include <AK/Endian.h>
-#include <AK/MemoryStream.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/Timer.h>
 #include <LibTLS/TLSv12.h>
 
+// Up to this much of outgoing records are collected before writing them to the socket, so that a large message is sent
+// with a few large writes instead of one per record.
+constexpr static size_t MaximumBufferedRecordsSize = 64 * KiB;
+
 namespace TLS {
 
+// https://www.rfc-editor.org/rfc/rfc7905#section-2
+// The per-record nonce is the fixed IV with the sequence number XORed into its last eight bytes.
+static void compute_chacha20_poly1305_nonce(u8 const (&fixed_iv)[12], u64 sequence_number, u8 (&nonce)[12])
+{
+    memcpy(nonce, fixed_iv, 12);
+    for (size_t i = 0; i < 8; ++i)
+        nonce[4 + i] ^= static_cast<u8>(sequence_number >> (56 - 8 * i));
+}
+
 ByteBuffer TLSv12::build_alert(bool critical, u8 code)
 {
     PacketBuilder builder(ContentType::ALERT, (u16)m_context.options.version);
@@ -35,34 +47,100 @@ void TLSv12::alert(AlertLevel level, AlertDescription code)
     MUST(flush());
 }
 
-void TLSv12::write_packet(ByteBuffer& packet, bool immediately)
+void TLSv12::schedule_or_perform_flush(bool immediately)
 {
-    auto schedule_or_perform_flush = [&](bool immediate) {
-        if (m_context.connection_status > ConnectionStatus::Disconnected) {
-            if (!m_has_scheduled_write_flush && !immediate) {
-                dbgln_if(TLS_DEBUG, "Scheduling write of {}", m_context.tls_buffer.size());
-                Core::deferred_invoke([this] { write_into_socket(); });
-                m_has_scheduled_write_flush = true;
-            } else {
-                // multiple packet are available, let's flush some out
-                dbgln_if(TLS_DEBUG, "Flushing scheduled write of {}", m_context.tls_buffer.size());
-                write_into_socket();
-                // the deferred invoke is still in place
-                m_has_scheduled_write_flush = true;
-            }
+    if (m_context.connection_status > ConnectionStatus::Disconnected) {
+        if (!m_has_scheduled_write_flush && !immediately) {
+            dbgln_if(TLS_DEBUG, "Scheduling write of {}", m_context.tls_buffer.size());
+            Core::deferred_invoke([this] { write_into_socket(); });
+            m_has_scheduled_write_flush = true;
+        } else {
+            // multiple packet are available, let's flush some out
+            dbgln_if(TLS_DEBUG, "Flushing scheduled write of {}", m_context.tls_buffer.size());
+            write_into_socket();
+            // the deferred invoke is still in place
+            m_has_scheduled_write_flush = true;
         }
-    };
-    // Record size limit is 18432 bytes, leave some headroom and flush at 16K.
-    if (m_context.tls_buffer.size() + packet.size() > 16 * KiB)
+    }
+}
+
+ErrorOr<Bytes> TLSv12::reserve_space_for_record(size_t size)
+{
+    // Records are collected until there is enough of them for one large write, rather than being written one by one.
+    if (m_context.tls_buffer.size() + size > MaximumBufferedRecordsSize)
         schedule_or_perform_flush(true);
 
-    if (m_context.tls_buffer.try_append(packet.data(), packet.size()).is_error()) {
+    return m_context.tls_buffer.get_bytes_for_writing(size);
+}
+
+void TLSv12::write_packet(ByteBuffer& packet, bool immediately)
+{
+    auto space_or_error = reserve_space_for_record(packet.size());
+    if (space_or_error.is_error()) {
         // Toooooo bad, drop the record on the ground.
         return;
     }
+    packet.bytes().copy_to(space_or_error.value());
     schedule_or_perform_flush(immediately);
 }
 
+static void build_aead_additional_data(u8 (&aad)[13], u64 sequence_number, ReadonlyBytes type_and_version, u16 length)
+{
+    // AEAD AAD (13)
+    // Seq. no (8)
+    // content type (1)
+    // version (2)
+    // length (2)
+    ByteReader::store(aad, AK::convert_between_host_and_network_endian(sequence_number));
+    type_and_version.copy_to(Bytes { aad + 8, 3 });
+    ByteReader::store(aad + 11, AK::convert_between_host_and_network_endian(length));
+}
+
+void TLSv12::encrypt_aead_record(Bytes record, ReadonlyBytes plaintext)
+{
+    constexpr size_t header_size = 5;
+    auto explicit_nonce_length = iv_length();
+    VERIFY(record.size() == header_size + plaintext.size() + aead_record_overhead());
+
+    u8 aad[13];
+    build_aead_additional_data(aad, m_context.local_sequence_number, record.trim(3), plaintext.size());
+    ByteReader::store(record.offset_pointer(3), AK::convert_between_host_and_network_endian(static_cast<u16>(record.size() - header_size)));
+
+    auto ciphertext = record.slice(header_size + explicit_nonce_length, plaintext.size());
+    auto tag = record.slice_from_end(16);
+
+    m_cipher_local.visit(
+        [&](Crypto::Cipher::AESCipher::GCMMode& gcm) {
+            // AEAD IV (12)
+            // IV (4)
+            // (Nonce) (8)
+            // -- Our GCM impl takes 16 bytes
+            // zero (4)
+            u8 iv[16];
+            Bytes iv_bytes { iv, 16 };
+            Bytes { m_context.crypto.local_aead_iv, 4 }.copy_to(iv_bytes);
+            fill_with_random(iv_bytes.slice(4, 8));
+            memset(iv_bytes.offset(12), 0, 4);
+
+            // write the random part of the iv out
+            iv_bytes.slice(4, 8).copy_to(record.slice(header_size, explicit_nonce_length));
+
+            gcm.encrypt(plaintext, ciphertext, iv_bytes, { aad, 13 }, tag);
+        },
+        [&](Crypto::AEAD::ChaCha20Poly1305& chacha20_poly1305) {
+            // The nonce is implicit, so nothing goes between the header and the ciphertext.
+            u8 nonce[12];
+            compute_chacha20_poly1305_nonce(m_context.crypto.local_aead_iv, m_context.local_sequence_number, nonce);
+            chacha20_poly1305.set_nonce({ nonce, 12 });
+
+            if (chacha20_poly1305.encrypt({ aad, 13 }, plaintext, ciphertext, tag).is_error()) {
+                dbgln("LibTLS: Failed to allocate enough memory for the ciphertext");
+                VERIFY_NOT_REACHED();
+            }
+        },
+        [&](auto&) { VERIFY_NOT_REACHED(); });
+}
+
 void TLSv12::update_packet(ByteBuffer& packet)
 {
     u32 header_size = 5;
@@ -75,33 +153,27 @@ void TLSv12::update_packet(ByteBuffer& packet)
                 update_hash(packet.bytes(), header_size);
             }
         }
-        if (m_context.cipher_spec_set && m_context.crypto.created) {
-            size_t length = packet.size() - header_size;
-            size_t block_size = 0;
-            size_t padding = 0;
-            size_t mac_size = 0;
-
-            m_cipher_local.visit(
-                [&](Empty&) { VERIFY_NOT_REACHED(); },
-                [&](Crypto::Cipher::AESCipher::GCMMode& gcm) {
-                    VERIFY(is_aead());
-                    block_size = gcm.cipher().block_size();
-                    padding = 0;
-                    mac_size = 0; // AEAD provides its own authentication scheme.
-                },
-                [&](Crypto::Cipher::AESCipher::CBCMode& cbc) {
-                    VERIFY(!is_aead());
-                    block_size = cbc.cipher().block_size();
-                    // If the length is already a multiple a block_size,
-                    // an entire block of padding is added.
-                    // In short, we _never_ have no padding.
-                    mac_size = mac_length();
-                    length += mac_size;
-                    padding = block_size - length % block_size;
-                    length += padding;
-                });
-
-            if (m_context.crypto.created == 1) {
+        if (m_context.cipher_spec_set && m_context.crypto.created == 1) {
+            if (is_aead()) {
+                // Make room for the explicit nonce and the tag, and encrypt the packet where it is.
+                auto plaintext_length = packet.size() - header_size;
+                auto explicit_nonce_length = iv_length();
+                packet.resize(packet.size() + aead_record_overhead());
+                memmove(packet.offset_pointer(header_size + explicit_nonce_length), packet.offset_pointer(header_size), plaintext_length);
+                encrypt_aead_record(packet.bytes(), packet.bytes().slice(header_size + explicit_nonce_length, plaintext_length));
+            } else {
+                auto& cbc = m_cipher_local.get<Crypto::Cipher::AESCipher::CBCMode>();
+
+                size_t length = packet.size() - header_size;
+                size_t block_size = cbc.cipher().block_size();
+                size_t mac_size = mac_length();
+                // If the length is already a multiple a block_size,
+                // an entire block of padding is added.
+                // In short, we _never_ have no padding.
+                length += mac_size;
+                size_t padding = block_size - length % block_size;
+                length += padding;
+
                 // `buffer' will continue to be encrypted
                 auto buffer_result = ByteBuffer::create_uninitialized(length);
                 if (buffer_result.is_error()) {
@@ -116,108 +188,47 @@ void TLSv12::update_packet(ByteBuffer& packet)
                 buffer.overwrite(buffer_position, packet.offset_pointer(header_size), packet.size() - header_size);
                 buffer_position += packet.size() - header_size;
 
-                ByteBuffer ct;
-
-                m_cipher_local.visit(
-                    [&](Empty&) { VERIFY_NOT_REACHED(); },
-                    [&](Crypto::Cipher::AESCipher::GCMMode& gcm) {
-                        VERIFY(is_aead());
-                        // We need enough space for a header, the data, a tag, and the IV
-                        auto ct_buffer_result = ByteBuffer::create_uninitialized(length + header_size + iv_size + 16);
-                        if (ct_buffer_result.is_error()) {
-                            dbgln("LibTLS: Failed to allocate enough memory for the ciphertext");
-                            VERIFY_NOT_REACHED();
-                        }
-                        ct = ct_buffer_result.release_value();
-
-                        // copy the header over
-                        ct.overwrite(0, packet.data(), header_size - 2);
-
-                        // AEAD AAD (13)
-                        // Seq. no (8)
-                        // content type (1)
-                        // version (2)
-                        // length (2)
-                        u8 aad[13];
-                        Bytes aad_bytes { aad, 13 };
-                        FixedMemoryStream aad_stream { aad_bytes };
-
-                        u64 seq_no = AK::convert_between_host_and_network_endian(m_context.local_sequence_number);
-                        u16 len = AK::convert_between_host_and_network_endian((u16)(packet.size() - header_size));
-
-                        MUST(aad_stream.write_value(seq_no));                              // sequence number
-                        MUST(aad_stream.write_until_depleted(packet.bytes().slice(0, 3))); // content-type + version
-                        MUST(aad_stream.write_value(len));                                 // length
-                        VERIFY(MUST(aad_stream.tell()) == MUST(aad_stream.size()));
-
-                        // AEAD IV (12)
-                        // IV (4)
-                        // (Nonce) (8)
-                        // -- Our GCM impl takes 16 bytes
-                        // zero (4)
-                        u8 iv[16];
-                        Bytes iv_bytes { iv, 16 };
-                        Bytes { m_context.crypto.local_aead_iv, 4 }.copy_to(iv_bytes);
-                        fill_with_random(iv_bytes.slice(4, 8));
-                        memset(iv_bytes.offset(12), 0, 4);
-
-                        // write the random part of the iv out
-                        iv_bytes.slice(4, 8).copy_to(ct.bytes().slice(header_size));
-
-                        // Write the encrypted data and the tag
-                        gcm.encrypt(
-                            packet.bytes().slice(header_size, length),
-                            ct.bytes().slice(header_size + 8, length),
-                            iv_bytes,
-                            aad_bytes,
-                            ct.bytes().slice(header_size + 8 + length, 16));
-
-                        VERIFY(header_size + 8 + length + 16 == ct.size());
-                    },
-                    [&](Crypto::Cipher::AESCipher::CBCMode& cbc) {
-                        VERIFY(!is_aead());
-                        // We need enough space for a header, iv_length bytes of IV and whatever the packet contains
-                        auto ct_buffer_result = ByteBuffer::create_uninitialized(length + header_size + iv_size);
-                        if (ct_buffer_result.is_error()) {
-                            dbgln("LibTLS: Failed to allocate enough memory for the ciphertext");
-                            VERIFY_NOT_REACHED();
-                        }
-                        ct = ct_buffer_result.release_value();
-
-                        // copy the header over
-                        ct.overwrite(0, packet.data(), header_size - 2);
-
-                        // get the appropriate HMAC value for the entire packet
-                        auto mac = hmac_message(packet, {}, mac_size, true);
-
-                        // write the MAC
-                        buffer.overwrite(buffer_position, mac.data(), mac.size());
-                        buffer_position += mac.size();
-
-                        // Apply the padding (a packet MUST always be padded)
-                        memset(buffer.offset_pointer(buffer_position), padding - 1, padding);
-                        buffer_position += padding;
-
-                        VERIFY(buffer_position == buffer.size());
-
-                        auto iv_buffer_result = ByteBuffer::create_uninitialized(iv_size);
-                        if (iv_buffer_result.is_error()) {
-                            dbgln("LibTLS: Failed to allocate memory for IV");
-                            VERIFY_NOT_REACHED();
-                        }
-                        auto iv = iv_buffer_result.release_value();
-                        fill_with_random(iv);
-
-                        // write it into the ciphertext portion of the message
-                        ct.overwrite(header_size, iv.data(), iv.size());
-
-                        VERIFY(header_size + iv_size + length == ct.size());
-                        VERIFY(length % block_size == 0);
-
-                        // get a block to encrypt into
-                        auto view = ct.bytes().slice(header_size + iv_size, length);
-                        cbc.encrypt(buffer, view, iv);
-                    });
+                // We need enough space for a header, iv_length bytes of IV and whatever the packet contains
+                auto ct_buffer_result = ByteBuffer::create_uninitialized(length + header_size + iv_size);
+                if (ct_buffer_result.is_error()) {
+                    dbgln("LibTLS: Failed to allocate enough memory for the ciphertext");
+                    VERIFY_NOT_REACHED();
+                }
+                auto ct = ct_buffer_result.release_value();
+
+                // copy the header over
+                ct.overwrite(0, packet.data(), header_size - 2);
+
+                // get the appropriate HMAC value for the entire packet
+                auto mac = hmac_message(packet, {}, mac_size, true);
+
+                // write the MAC
+                buffer.overwrite(buffer_position, mac.data(), mac.size());
+                buffer_position += mac.size();
+
+                // Apply the padding (a packet MUST always be padded)
+                memset(buffer.offset_pointer(buffer_position), padding - 1, padding);
+                buffer_position += padding;
+
+                VERIFY(buffer_position == buffer.size());
+
+                auto iv_buffer_result = ByteBuffer::create_uninitialized(iv_size);
+                if (iv_buffer_result.is_error()) {
+                    dbgln("LibTLS: Failed to allocate memory for IV");
+                    VERIFY_NOT_REACHED();
+                }
+                auto iv = iv_buffer_result.release_value();
+                fill_with_random(iv);
+
+                // write it into the ciphertext portion of the message
+                ct.overwrite(header_size, iv.data(), iv.size());
+
+                VERIFY(header_size + iv_size + length == ct.size());
+                VERIFY(length % block_size == 0);
+
+                // get a block to encrypt into
+                auto view = ct.bytes().slice(header_size + iv_size, length);
+                cbc.encrypt(buffer, view, iv);
 
                 // store the correct ciphertext length into the packet
                 u16 ct_length = (u16)ct.size() - header_size;
@@ -225,7 +236,7 @@ void TLSv12::update_packet(ByteBuffer& packet)
                 ByteReader::store(ct.offset_pointer(header_size - 2), AK::convert_between_host_and_network_endian(ct_length));
 
                 // replace the packet with the ciphertext
-                packet = ct;
+                packet = move(ct);
             }
         }
     }
@@ -306,7 +317,7 @@ ByteBuffer TLSv12::hmac_message(ReadonlyBytes buf, Optional<ReadonlyBytes> const
     return mac_result.release_value();
 }
 
-ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
+ssize_t TLSv12::handle_message(Bytes buffer)
 {
     auto res { 5ll };
     size_t header_size = res;
@@ -365,34 +376,11 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
                 }
 
                 auto packet_length = length - iv_length() - 16;
-                auto payload = plain;
-                auto decrypted_result = ByteBuffer::create_uninitialized(packet_length);
-                if (decrypted_result.is_error()) {
-                    dbgln("Failed to allocate memory for the packet");
-                    return_value = Error::DecryptionFailed;
-                    return;
-                }
-                decrypted = decrypted_result.release_value();
 
-                // AEAD AAD (13)
-                // Seq. no (8)
-                // content type (1)
-                // version (2)
-                // length (2)
                 u8 aad[13];
-                Bytes aad_bytes { aad, 13 };
-                FixedMemoryStream aad_stream { aad_bytes };
-
-                u64 seq_no = AK::convert_between_host_and_network_endian(m_context.remote_sequence_number);
-                u16 len = AK::convert_between_host_and_network_endian((u16)packet_length);
-
-                MUST(aad_stream.write_value(seq_no));                                    // sequence number
-                MUST(aad_stream.write_until_depleted(buffer.slice(0, header_size - 2))); // content-type + version
-                MUST(aad_stream.write_value(len));                                       // length
-                VERIFY(MUST(aad_stream.tell()) == MUST(aad_stream.size()));
+                build_aead_additional_data(aad, m_context.remote_sequence_number, buffer.trim(header_size - 2), packet_length);
 
-                auto nonce = payload.slice(0, iv_length());
-                payload = payload.slice(iv_length());
+                auto nonce = buffer.slice(header_size, iv_length());
 
                 // AEAD IV (12)
                 // IV (4)
@@ -405,14 +393,15 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
                 nonce.copy_to(iv_bytes.slice(4));
                 memset(iv_bytes.offset(12), 0, 4);
 
-                auto ciphertext = payload.slice(0, payload.size() - 16);
-                auto tag = payload.slice(ciphertext.size());
+                // The record is decrypted where it is, as nothing else needs the ciphertext.
+                auto ciphertext = buffer.slice(header_size + iv_length(), packet_length);
+                auto tag = buffer.slice(header_size + iv_length() + packet_length, 16);
 
                 auto consistency = gcm.decrypt(
                     ciphertext,
-                    decrypted,
+                    ciphertext,
                     iv_bytes,
-                    aad_bytes,
+                    { aad, 13 },
                     tag);
 
                 if (consistency != Crypto::VerificationConsistency::Consistent) {
@@ -424,7 +413,47 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
                     return;
                 }
 
-                plain = decrypted;
+                plain = ciphertext;
+            },
+            [&](Crypto::AEAD::ChaCha20Poly1305& chacha20_poly1305) {
+                VERIFY(is_aead());
+                if (length < 16) {
+                    dbgln("Invalid packet length");
+                    auto packet = build_alert(true, (u8)AlertDescription::DECRYPT_ERROR);
+                    write_packet(packet);
+                    return_value = Error::BrokenPacket;
+                    return;
+                }
+
+                auto packet_length = length - 16;
+
+                u8 aad[13];
+                build_aead_additional_data(aad, m_context.remote_sequence_number, buffer.trim(header_size - 2), packet_length);
+
+                u8 nonce[12];
+                compute_chacha20_poly1305_nonce(m_context.crypto.remote_aead_iv, m_context.remote_sequence_number, nonce);
+                chacha20_poly1305.set_nonce({ nonce, 12 });
+
+                auto ciphertext = buffer.slice(header_size, packet_length);
+                auto tag = buffer.slice(header_size + packet_length, 16);
+
+                auto consistency = chacha20_poly1305.decrypt({ aad, 13 }, ciphertext, ciphertext, tag);
+                if (consistency.is_error()) {
+                    dbgln("Failed to allocate memory for the packet");
+                    return_value = Error::DecryptionFailed;
+                    return;
+                }
+
+                if (consistency.value() != Crypto::VerificationConsistency::Consistent) {
+                    dbgln("integrity check failed");
+                    auto packet = build_alert(true, (u8)AlertDescription::BAD_RECORD_MAC);
+                    write_packet(packet);
+
+                    return_value = Error::IntegrityCheckFailed;
+                    return;
+                }
+
+                plain = ciphertext;
             },
             [&](Crypto::Cipher::AESCipher::CBCMode& cbc) {
                 VERIFY(!is_aead());
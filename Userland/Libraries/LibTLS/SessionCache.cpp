@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTLS/SessionCache.h>
+
+namespace TLS {
+
+SessionCache& SessionCache::the()
+{
+    static SessionCache s_the;
+    return s_the;
+}
+
+Optional<SessionCache::Session> SessionCache::session_for(ByteString const& host)
+{
+    return m_sessions.with_locked([&](auto& sessions) -> Optional<Session> {
+        auto it = sessions.find(host);
+        if (it == sessions.end())
+            return {};
+
+        if (it->value.expiration_time <= MonotonicTime::now_coarse()) {
+            sessions.remove(it);
+            return {};
+        }
+
+        return it->value;
+    });
+}
+
+void SessionCache::store(ByteString const& host, Session session)
+{
+    m_sessions.with_locked([&](auto& sessions) {
+        if (!sessions.contains(host) && sessions.size() >= maximum_session_count) {
+            // Make room by dropping the session that would have expired first.
+            auto oldest = sessions.begin();
+            for (auto it = sessions.begin(); it != sessions.end(); ++it) {
+                if (it->value.expiration_time < oldest->value.expiration_time)
+                    oldest = it;
+            }
+            sessions.remove(oldest);
+        }
+
+        sessions.set(host, move(session));
+    });
+}
+
+void SessionCache::remove(ByteString const& host)
+{
+    m_sessions.with_locked([&](auto& sessions) {
+        sessions.remove(host);
+    });
+}
+
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/ByteString.h>
+#include <AK/HashMap.h>
+#include <AK/Optional.h>
+#include <AK/Time.h>
+#include <LibThreading/MutexProtected.h>
+#include <LibTLS/CipherSuite.h>
+
+namespace TLS {
+
+// The sessions negotiated with each server, shared by all the connections made by this process, so that a new
+// connection to a server we have talked to before can resume a session with an abbreviated handshake instead of doing
+// the whole key exchange and certificate verification again.
+// https://datatracker.ietf.org/doc/html/rfc5246#section-7.3
+class SessionCache {
+public:
+    struct Session {
+        // Either of these identifies the session to the server. A session ticket (RFC 5077) is used in preference
+        // to the session ID, as it doesn't depend on the server keeping the session around.
+        ByteBuffer session_id;
+        ByteBuffer ticket;
+
+        ByteBuffer master_key;
+        CipherSuite cipher { CipherSuite::TLS_NULL_WITH_NULL_NULL };
+        bool extended_master_secret { false };
+
+        MonotonicTime expiration_time { MonotonicTime::now() };
+    };
+
+    // RFC 5246 suggests an upper limit of 24 hours for session ID lifetimes, a ticket's lifetime hint can make it shorter.
+    static constexpr AK::Duration maximum_session_lifetime = AK::Duration::from_seconds(24 * 60 * 60);
+    static constexpr size_t maximum_session_count = 256;
+
+    static SessionCache& the();
+
+    Optional<Session> session_for(ByteString const& host);
+    void store(ByteString const& host, Session);
+    void remove(ByteString const& host);
+
+private:
+    Threading::MutexProtected<HashMap<ByteString, Session>> m_sessions;
+};
+
+}
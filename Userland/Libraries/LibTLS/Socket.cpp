@@ -16,6 +16,8 @@
 // which will be sent as a single record containing a single ApplicationData message.
 constexpr static size_t MaximumApplicationDataChunkSize = 16 * KiB;
 
+constexpr static size_t ReadBufferSize = 64 * KiB;
+
 namespace TLS {
 
 ErrorOr<Bytes> TLSv12::read_some(Bytes bytes)
@@ -39,8 +41,21 @@ ErrorOr<size_t> TLSv12::write_some(ReadonlyBytes bytes)
     }
 
     for (size_t offset = 0; offset < bytes.size(); offset += MaximumApplicationDataChunkSize) {
-        PacketBuilder builder { ContentType::APPLICATION_DATA, m_context.options.version, bytes.size() - offset };
-        builder.append(bytes.slice(offset, min(bytes.size() - offset, MaximumApplicationDataChunkSize)));
+        auto chunk = bytes.slice(offset, min(bytes.size() - offset, MaximumApplicationDataChunkSize));
+
+        if (m_context.cipher_spec_set && m_context.crypto.created == 1 && is_aead()) {
+            // Encrypt the data straight from the caller's buffer into the outgoing one.
+            auto record = TRY(reserve_space_for_record(5 + chunk.size() + aead_record_overhead()));
+            record[0] = to_underlying(ContentType::APPLICATION_DATA);
+            ByteReader::store(record.offset_pointer(1), AK::convert_between_host_and_network_endian(static_cast<u16>(m_context.options.version)));
+            encrypt_aead_record(record, chunk);
+            ++m_context.local_sequence_number;
+            schedule_or_perform_flush(false);
+            continue;
+        }
+
+        PacketBuilder builder { ContentType::APPLICATION_DATA, m_context.options.version, chunk.size() };
+        builder.append(chunk);
         auto packet = builder.build();
 
         update_packet(packet);
@@ -51,9 +66,15 @@ ErrorOr<size_t> TLSv12::write_some(ReadonlyBytes bytes)
 }
 
 ErrorOr<NonnullOwnPtr<TLSv12>> TLSv12::connect(ByteString const& host, u16 port, Options options)
+{
+    auto address = TRY(Core::Socket::resolve_host(host, Core::Socket::SocketType::Stream));
+    return connect(Core::SocketAddress { address, port }, host, move(options));
+}
+
+ErrorOr<NonnullOwnPtr<TLSv12>> TLSv12::connect(Core::SocketAddress const& address, ByteString const& host, Options options)
 {
     auto promise = Core::Promise<Empty>::construct();
-    OwnPtr<Core::Socket> tcp_socket = TRY(Core::TCPSocket::connect(host, port));
+    OwnPtr<Core::Socket> tcp_socket = TRY(Core::TCPSocket::connect(address));
     TRY(tcp_socket->set_blocking(false));
     auto tls_socket = make<TLSv12>(move(tcp_socket), move(options));
     tls_socket->set_sni(host);
@@ -164,12 +185,14 @@ ErrorOr<void> TLSv12::read_from_socket()
     if (!check_connection_state(true))
         return {};
 
-    u8 buffer[16 * KiB];
-    Bytes bytes { buffer, array_size(buffer) };
+    // A full record is a little over 16 KiB, so this fits a few of them at once.
+    if (m_read_buffer.is_empty())
+        m_read_buffer = TRY(ByteBuffer::create_uninitialized(ReadBufferSize));
+
     Bytes read_bytes {};
     auto& stream = underlying_stream();
     do {
-        auto result = stream.read_some(bytes);
+        auto result = stream.read_some(m_read_buffer);
         if (result.is_error()) {
             if (result.error().is_errno() && result.error().code() != EINTR) {
                 if (result.error().code() != EAGAIN)
@@ -299,7 +322,7 @@ ErrorOr<bool> TLSv12::flush()
     } while (!out_bytes.is_empty());
 
     if (out_bytes.is_empty() && !error.has_value()) {
-        m_context.tls_buffer.clear();
+        m_context.tls_buffer.clear_with_capacity();
         return true;
     }
 
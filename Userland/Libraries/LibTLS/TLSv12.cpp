@@ -19,6 +19,7 @@
 #include <LibCrypto/PK/Code/EMSA_PKCS1_V1_5.h>
 #include <LibFileSystem/FileSystem.h>
 #include <LibTLS/Certificate.h>
+#include <LibTLS/CertificateCache.h>
 #include <LibTLS/TLSv12.h>
 #include <errno.h>
 
@@ -28,26 +29,32 @@
 
 namespace TLS {
 
-void TLSv12::consume(ReadonlyBytes record)
+void TLSv12::consume(Bytes data)
 {
     if (m_context.critical_error) {
         dbgln("There has been a critical error ({}), refusing to continue", (i8)m_context.critical_error);
         return;
     }
 
-    if (record.size() == 0) {
+    if (data.size() == 0) {
         return;
     }
 
-    dbgln_if(TLS_DEBUG, "Consuming {} bytes", record.size());
+    dbgln_if(TLS_DEBUG, "Consuming {} bytes", data.size());
 
-    if (m_context.message_buffer.try_append(record).is_error()) {
-        dbgln("Not enough space in message buffer, dropping the record");
-        return;
+    // Records that arrived whole are handled right where they were read into, only a partial record has to be kept in
+    // the message buffer until the rest of it arrives.
+    bool is_using_message_buffer = !m_context.message_buffer.is_empty();
+    if (is_using_message_buffer) {
+        if (m_context.message_buffer.try_append(data).is_error()) {
+            dbgln("Not enough space in message buffer, dropping the record");
+            return;
+        }
+        data = m_context.message_buffer.bytes();
     }
 
     size_t index { 0 };
-    size_t buffer_length = m_context.message_buffer.size();
+    size_t buffer_length = data.size();
 
     size_t size_offset { 3 }; // read the common record header
     size_t header_size { 5 };
@@ -55,12 +62,12 @@ void TLSv12::consume(ReadonlyBytes record)
     dbgln_if(TLS_DEBUG, "message buffer length {}", buffer_length);
 
     while (buffer_length >= 5) {
-        auto length = AK::convert_between_host_and_network_endian(ByteReader::load16(m_context.message_buffer.offset_pointer(index + size_offset))) + header_size;
+        auto length = AK::convert_between_host_and_network_endian(ByteReader::load16(data.offset_pointer(index + size_offset))) + header_size;
         if (length > buffer_length) {
             dbgln_if(TLS_DEBUG, "Need more data: {} > {}", length, buffer_length);
             break;
         }
-        auto consumed = handle_message(m_context.message_buffer.bytes().slice(index, length));
+        auto consumed = handle_message(data.slice(index, length));
 
         if constexpr (TLS_DEBUG) {
             if (consumed > 0)
@@ -95,9 +102,15 @@ void TLSv12::consume(ReadonlyBytes record)
         return;
     }
 
+    if (!is_using_message_buffer) {
+        if (buffer_length && m_context.message_buffer.try_append(data.slice(index, buffer_length)).is_error())
+            dbgln("Not enough space in message buffer, dropping the record");
+        return;
+    }
+
     if (index) {
-        // FIXME: Propagate errors.
-        m_context.message_buffer = MUST(m_context.message_buffer.slice(index, m_context.message_buffer.size() - index));
+        memmove(m_context.message_buffer.data(), m_context.message_buffer.offset_pointer(index), buffer_length);
+        m_context.message_buffer.trim(buffer_length, false);
     }
 }
 
@@ -198,22 +211,28 @@ void TLSv12::try_disambiguate_error() const
     dbgln("- {}", enum_to_value((AlertDescription)m_context.critical_error));
 }
 
-void TLSv12::set_root_certificates(Vector<Certificate> certificates)
+static HashMap<ByteString, Certificate> root_certificates_by_subject(Vector<Certificate> const& certificates)
 {
-    if (!m_context.root_certificates.is_empty()) {
-        dbgln("TLS warn: resetting root certificates!");
-        m_context.root_certificates.clear();
-    }
-
+    HashMap<ByteString, Certificate> root_certificates;
     for (auto& cert : certificates) {
         if (!cert.is_valid()) {
             dbgln("Certificate for {} is invalid, things may or may not work!", cert.subject.to_string());
         }
         // FIXME: Figure out what we should do when our root certs are invalid.
 
-        m_context.root_certificates.set(MUST(cert.subject.to_string()).to_byte_string(), cert);
+        root_certificates.set(MUST(cert.subject.to_string()).to_byte_string(), cert);
     }
-    dbgln_if(TLS_DEBUG, "{}: Set {} root certificates", this, m_context.root_certificates.size());
+    return root_certificates;
+}
+
+void TLSv12::set_root_certificates(Vector<Certificate> certificates)
+{
+    if (m_context.root_certificates && !m_context.root_certificates->is_empty())
+        dbgln("TLS warn: resetting root certificates!");
+
+    m_context.custom_root_certificates = root_certificates_by_subject(certificates);
+    m_context.root_certificates = &m_context.custom_root_certificates;
+    dbgln_if(TLS_DEBUG, "{}: Set {} root certificates", this, m_context.root_certificates->size());
 }
 
 static bool wildcard_matches(StringView host, StringView subject)
@@ -282,8 +301,20 @@ bool Context::verify_chain(StringView host) const
         return false;
     }
 
+    // The name has to be checked every time, but the signatures only have to be verified once for each chain.
+    Optional<ByteBuffer> chain_key;
+    if (uses_default_root_certificates())
+        chain_key = CertificateCache::chain_key(*local_chain);
+    if (chain_key.has_value() && CertificateCache::the().is_verified_chain(*chain_key)) {
+        dbgln_if(TLS_DEBUG, "verify_chain: Chain was already verified");
+        return true;
+    }
+
+    auto chain_expiration_time = UnixDateTime::latest();
+
     for (size_t cert_index = 0; cert_index < local_chain->size(); ++cert_index) {
         auto const& cert = local_chain->at(cert_index);
+        chain_expiration_time = min(chain_expiration_time, cert.validity.not_after);
 
         auto subject_string = MUST(cert.subject.to_string());
         auto issuer_string = MUST(cert.issuer.to_string());
@@ -293,7 +324,7 @@ bool Context::verify_chain(StringView host) const
             return false;
         }
 
-        auto maybe_root_certificate = root_certificates.get(issuer_string.to_byte_string());
+        auto maybe_root_certificate = root_certificates->get(issuer_string.to_byte_string());
         if (maybe_root_certificate.has_value()) {
             auto& root_certificate = *maybe_root_certificate;
             auto verification_correct = verify_certificate_pair(cert, root_certificate);
@@ -304,6 +335,8 @@ bool Context::verify_chain(StringView host) const
             }
 
             // Root certificate reached, and correctly verified, so we can stop now
+            if (chain_key.has_value())
+                CertificateCache::the().did_verify_chain(chain_key.release_value(), min(chain_expiration_time, root_certificate.validity.not_after));
             return true;
         }
 
@@ -512,11 +545,13 @@ TLSv12::TLSv12(StreamVariantType stream, Options options)
 {
     m_context.options = move(options);
     m_context.is_server = false;
+    m_context.alpn = m_context.options.alpn_protocols;
     m_context.tls_buffer = {};
 
-    set_root_certificates(m_context.options.root_certificates.has_value()
-            ? *m_context.options.root_certificates
-            : DefaultRootCACertificates::the().certificates());
+    if (m_context.options.root_certificates.has_value())
+        set_root_certificates(*m_context.options.root_certificates);
+    else
+        m_context.root_certificates = &DefaultRootCACertificates::the().certificates_by_subject();
 
     setup_connection();
 }
@@ -565,6 +600,7 @@ DefaultRootCACertificates::DefaultRootCACertificates()
     }
 
     m_ca_certificates = load_result.release_value();
+    m_ca_certificates_by_subject = root_certificates_by_subject(m_ca_certificates);
 }
 
 DefaultRootCACertificates& DefaultRootCACertificates::the()
@@ -13,6 +13,7 @@
 #include <LibCore/Notifier.h>
 #include <LibCore/Socket.h>
 #include <LibCore/Timer.h>
+#include <LibCrypto/AEAD/ChaCha20Poly1305.h>
 #include <LibCrypto/Authentication/HMAC.h>
 #include <LibCrypto/BigInt/UnsignedBigInteger.h>
 #include <LibCrypto/Cipher/AES.h>
@@ -20,6 +21,7 @@
 #include <LibCrypto/Hash/HashManager.h>
 #include <LibCrypto/PK/RSA.h>
 #include <LibTLS/CipherSuite.h>
+#include <LibTLS/SessionCache.h>
 #include <LibTLS/TLSPacketBuilder.h>
 
 namespace TLS {
@@ -95,22 +97,24 @@ enum ClientVerificationStaus {
 // the preferred order.
 //
 // https://wiki.mozilla.org/Security/Server_Side_TLS
-#define ENUMERATE_CIPHERS(C)                                                                                                                                      \
-    C(true, CipherSuite::TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::ECDHE_ECDSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true) \
-    C(true, CipherSuite::TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::ECDHE_RSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true)     \
-    C(true, CipherSuite::TLS_ECDHE_ECDSA_WITH_AES_256_GCM_SHA384, KeyExchangeAlgorithm::ECDHE_ECDSA, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 8, true) \
-    C(true, CipherSuite::TLS_ECDHE_RSA_WITH_AES_256_GCM_SHA384, KeyExchangeAlgorithm::ECDHE_RSA, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 8, true)     \
-    C(true, CipherSuite::TLS_DHE_RSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::DHE_RSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true)         \
-    C(true, CipherSuite::TLS_DHE_RSA_WITH_AES_256_GCM_SHA384, KeyExchangeAlgorithm::DHE_RSA, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 8, true)         \
-    C(true, CipherSuite::TLS_ECDHE_ECDSA_WITH_AES_128_CBC_SHA, KeyExchangeAlgorithm::ECDHE_ECDSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA1, 16, false)    \
-    C(true, CipherSuite::TLS_ECDHE_RSA_WITH_AES_128_CBC_SHA, KeyExchangeAlgorithm::ECDHE_RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA1, 16, false)        \
-    C(true, CipherSuite::TLS_ECDHE_ECDSA_WITH_AES_256_CBC_SHA, KeyExchangeAlgorithm::ECDHE_ECDSA, CipherAlgorithm::AES_256_CBC, Crypto::Hash::SHA1, 16, false)    \
-    C(true, CipherSuite::TLS_ECDHE_RSA_WITH_AES_256_CBC_SHA, KeyExchangeAlgorithm::ECDHE_RSA, CipherAlgorithm::AES_256_CBC, Crypto::Hash::SHA1, 16, false)        \
-    C(true, CipherSuite::TLS_RSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true)                 \
-    C(true, CipherSuite::TLS_RSA_WITH_AES_256_GCM_SHA384, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 8, true)                 \
-    C(true, CipherSuite::TLS_RSA_WITH_AES_128_CBC_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA256, 16, false)               \
-    C(true, CipherSuite::TLS_RSA_WITH_AES_256_CBC_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_CBC, Crypto::Hash::SHA256, 16, false)               \
-    C(true, CipherSuite::TLS_RSA_WITH_AES_128_CBC_SHA, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA1, 16, false)                    \
+#define ENUMERATE_CIPHERS(C)                                                                                                                                                  \
+    C(true, CipherSuite::TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::ECDHE_ECDSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true)             \
+    C(true, CipherSuite::TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::ECDHE_RSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true)                 \
+    C(true, CipherSuite::TLS_ECDHE_ECDSA_WITH_AES_256_GCM_SHA384, KeyExchangeAlgorithm::ECDHE_ECDSA, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 8, true)             \
+    C(true, CipherSuite::TLS_ECDHE_RSA_WITH_AES_256_GCM_SHA384, KeyExchangeAlgorithm::ECDHE_RSA, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 8, true)                 \
+    C(true, CipherSuite::TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256, KeyExchangeAlgorithm::ECDHE_ECDSA, CipherAlgorithm::CHACHA20_POLY1305, Crypto::Hash::SHA256, 0, true) \
+    C(true, CipherSuite::TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256, KeyExchangeAlgorithm::ECDHE_RSA, CipherAlgorithm::CHACHA20_POLY1305, Crypto::Hash::SHA256, 0, true)     \
+    C(true, CipherSuite::TLS_DHE_RSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::DHE_RSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true)                     \
+    C(true, CipherSuite::TLS_DHE_RSA_WITH_AES_256_GCM_SHA384, KeyExchangeAlgorithm::DHE_RSA, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 8, true)                     \
+    C(true, CipherSuite::TLS_ECDHE_ECDSA_WITH_AES_128_CBC_SHA, KeyExchangeAlgorithm::ECDHE_ECDSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA1, 16, false)                \
+    C(true, CipherSuite::TLS_ECDHE_RSA_WITH_AES_128_CBC_SHA, KeyExchangeAlgorithm::ECDHE_RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA1, 16, false)                    \
+    C(true, CipherSuite::TLS_ECDHE_ECDSA_WITH_AES_256_CBC_SHA, KeyExchangeAlgorithm::ECDHE_ECDSA, CipherAlgorithm::AES_256_CBC, Crypto::Hash::SHA1, 16, false)                \
+    C(true, CipherSuite::TLS_ECDHE_RSA_WITH_AES_256_CBC_SHA, KeyExchangeAlgorithm::ECDHE_RSA, CipherAlgorithm::AES_256_CBC, Crypto::Hash::SHA1, 16, false)                    \
+    C(true, CipherSuite::TLS_RSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true)                             \
+    C(true, CipherSuite::TLS_RSA_WITH_AES_256_GCM_SHA384, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 8, true)                             \
+    C(true, CipherSuite::TLS_RSA_WITH_AES_128_CBC_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA256, 16, false)                           \
+    C(true, CipherSuite::TLS_RSA_WITH_AES_256_CBC_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_CBC, Crypto::Hash::SHA256, 16, false)                           \
+    C(true, CipherSuite::TLS_RSA_WITH_AES_128_CBC_SHA, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA1, 16, false)                                \
     C(true, CipherSuite::TLS_RSA_WITH_AES_256_CBC_SHA, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_CBC, Crypto::Hash::SHA1, 16, false)
 
 constexpr KeyExchangeAlgorithm get_key_exchange_algorithm(CipherSuite suite)
@@ -195,6 +199,12 @@ struct Options {
     OPTION_WITH_DEFAULTS(Function<Vector<Certificate>()>, certificate_provider, [] { return Vector<Certificate> {}; })
     OPTION_WITH_DEFAULTS(bool, enable_extended_master_secret, true)
 
+    // Offers to resume the last session negotiated with the same host, from the process-wide SessionCache.
+    OPTION_WITH_DEFAULTS(bool, enable_session_resumption, true)
+
+    // The application protocols to offer through ALPN (RFC 7301), most preferred first, e.g. "h2" and "http/1.1".
+    OPTION_WITH_DEFAULTS(Vector<ByteString>, alpn_protocols, )
+
 #undef OPTION_WITH_DEFAULTS
 };
 
@@ -247,6 +257,16 @@ struct Context {
     u8 session_id[32];
     u8 session_id_size { 0 };
     CipherSuite cipher;
+
+    // The session we asked the server to resume, and whether it agreed to. A resumed session skips the key exchange,
+    // and the server sends its Finished message before we send ours.
+    Optional<SessionCache::Session> offered_session;
+    bool is_resumed_session { false };
+
+    // The session ticket the server issued in this handshake, if any (RFC 5077).
+    ByteBuffer session_ticket;
+    u32 session_ticket_lifetime_hint { 0 };
+
     bool is_server { false };
     Vector<Certificate> certificates;
     Certificate private_key;
@@ -260,8 +280,8 @@ struct Context {
         u8 local_mac[32];
         u8 local_iv[16];
         u8 remote_iv[16];
-        u8 local_aead_iv[4];
-        u8 remote_aead_iv[4];
+        u8 local_aead_iv[12];
+        u8 remote_aead_iv[12];
     } crypto;
 
     Crypto::Hash::Manager handshake_hash;
@@ -300,10 +320,15 @@ struct Context {
     // message flags
     u8 handshake_messages[11] { 0 };
     ByteBuffer user_data;
-    HashMap<ByteString, Certificate> root_certificates;
+
+    // The trusted root certificates by subject. These are either the ones in DefaultRootCACertificates, shared by all
+    // connections, or custom ones set on this connection.
+    HashMap<ByteString, Certificate> const* root_certificates { nullptr };
+    HashMap<ByteString, Certificate> custom_root_certificates;
+    bool uses_default_root_certificates() const { return root_certificates != &custom_root_certificates; }
 
     Vector<ByteString> alpn;
-    StringView negotiated_alpn;
+    ByteString negotiated_alpn;
 
     size_t send_retries { 0 };
 
@@ -358,6 +383,8 @@ public:
     virtual void set_notifications_enabled(bool enabled) override { underlying_stream().set_notifications_enabled(enabled); }
 
     static ErrorOr<NonnullOwnPtr<TLSv12>> connect(ByteString const& host, u16 port, Options = {});
+    // Connects to an address that was already resolved, with the host name only used to identify the server.
+    static ErrorOr<NonnullOwnPtr<TLSv12>> connect(Core::SocketAddress const&, ByteString const& host, Options = {});
     static ErrorOr<NonnullOwnPtr<TLSv12>> connect(ByteString const& host, Core::Socket& underlying_stream, Options = {});
 
     using StreamVariantType = Variant<OwnPtr<Core::Socket>, Core::Socket*>;
@@ -408,7 +435,7 @@ public:
 private:
     void setup_connection();
 
-    void consume(ReadonlyBytes record);
+    void consume(Bytes);
 
     ByteBuffer hmac_message(ReadonlyBytes buf, Optional<ReadonlyBytes> const buf2, size_t mac_length, bool local = false);
     void ensure_hmac(size_t digest_size, bool local);
@@ -417,6 +444,17 @@ private:
     void update_hash(ReadonlyBytes in, size_t header_size);
 
     void write_packet(ByteBuffer& packet, bool immediately = false);
+    void schedule_or_perform_flush(bool immediately);
+
+    // Returns space at the end of the outgoing buffer to put a record of the given size into.
+    ErrorOr<Bytes> reserve_space_for_record(size_t);
+
+    // The explicit nonce (for GCM) and the tag an AEAD cipher adds to each record.
+    size_t aead_record_overhead() const { return iv_length() + 16; }
+
+    // Encrypts the plaintext into a record that only has its header filled in yet, and has exactly enough room for the
+    // encrypted plaintext. The plaintext may be in the record already, where its ciphertext is going to be.
+    void encrypt_aead_record(Bytes record, ReadonlyBytes plaintext);
 
     ByteBuffer build_client_key_exchange();
     ByteBuffer build_server_key_exchange();
@@ -439,6 +477,7 @@ private:
 
     ssize_t handle_server_hello(ReadonlyBytes, WritePacketStage&);
     ssize_t handle_handshake_finished(ReadonlyBytes, WritePacketStage&);
+    ssize_t handle_new_session_ticket(ReadonlyBytes);
     ssize_t handle_certificate(ReadonlyBytes);
     ssize_t handle_server_key_exchange(ReadonlyBytes);
     ssize_t handle_dhe_rsa_server_key_exchange(ReadonlyBytes);
@@ -448,7 +487,7 @@ private:
     ssize_t handle_server_hello_done(ReadonlyBytes);
     ssize_t handle_certificate_verify(ReadonlyBytes);
     ssize_t handle_handshake_payload(ReadonlyBytes);
-    ssize_t handle_message(ReadonlyBytes);
+    ssize_t handle_message(Bytes);
 
     void pseudorandom_function(Bytes output, ReadonlyBytes secret, u8 const* label, size_t label_length, ReadonlyBytes seed, ReadonlyBytes seed_b);
 
@@ -523,6 +562,10 @@ private:
 
     bool expand_key();
 
+    bool can_resume_sessions() const;
+    void store_session_for_resumption();
+    void did_finish_handshake();
+
     bool compute_master_secret_from_pre_master_secret(size_t length);
 
     void try_disambiguate_error() const;
@@ -537,10 +580,14 @@ private:
     using CipherVariant = Variant<
         Empty,
         Crypto::Cipher::AESCipher::CBCMode,
-        Crypto::Cipher::AESCipher::GCMMode>;
+        Crypto::Cipher::AESCipher::GCMMode,
+        Crypto::AEAD::ChaCha20Poly1305>;
     CipherVariant m_cipher_local {};
     CipherVariant m_cipher_remote {};
 
+    // What is read from the socket goes here first. Whole records are decrypted where they are.
+    ByteBuffer m_read_buffer;
+
     bool m_has_scheduled_write_flush { false };
     bool m_has_scheduled_app_data_flush { false };
     i32 m_max_wait_time_for_handshake_in_seconds { 10 };
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonArray.h>
+#include <AK/JsonValue.h>
+#include <AK/QuickSort.h>
+#include <LibCore/File.h>
+#include <LibTest/Benchmark.h>
+#include <math.h>
+#include <time.h>
+
+namespace Test {
+
+// Linearly interpolates between the two closest ranks, the samples have to be sorted.
+static u64 percentile(Vector<u64> const& sorted_samples, double fraction)
+{
+    VERIFY(!sorted_samples.is_empty());
+    auto rank = fraction * (sorted_samples.size() - 1);
+    auto lower = static_cast<size_t>(rank);
+    auto upper = min(lower + 1, sorted_samples.size() - 1);
+    auto weight = rank - lower;
+    return static_cast<u64>(round(sorted_samples[lower] * (1 - weight) + sorted_samples[upper] * weight));
+}
+
+BenchmarkStatistics BenchmarkStatistics::compute(Vector<u64> samples)
+{
+    BenchmarkStatistics statistics;
+    if (samples.is_empty())
+        return statistics;
+
+    quick_sort(samples);
+    statistics.sample_count = samples.size();
+    statistics.min = samples.first();
+    statistics.max = samples.last();
+    statistics.median = percentile(samples, 0.5);
+    statistics.first_quartile = percentile(samples, 0.25);
+    statistics.third_quartile = percentile(samples, 0.75);
+    statistics.p90 = percentile(samples, 0.9);
+
+    double sum = 0;
+    for (auto sample : samples)
+        sum += sample;
+    statistics.mean = sum / samples.size();
+
+    if (samples.size() > 1) {
+        double sum_of_squared_deviations = 0;
+        for (auto sample : samples)
+            sum_of_squared_deviations += (sample - statistics.mean) * (sample - statistics.mean);
+        statistics.standard_deviation = sqrt(sum_of_squared_deviations / (samples.size() - 1));
+    }
+
+    if (statistics.median != 0) {
+        Vector<u64> deviations;
+        deviations.ensure_capacity(samples.size());
+        for (auto sample : samples)
+            deviations.unchecked_append(sample > statistics.median ? sample - statistics.median : statistics.median - sample);
+        quick_sort(deviations);
+        statistics.relative_median_absolute_deviation = percentile(deviations, 0.5) / static_cast<double>(statistics.median);
+    }
+
+    return statistics;
+}
+
+JsonObject BenchmarkStatistics::to_json() const
+{
+    JsonObject object;
+    object.set("samples", sample_count);
+    object.set("min", min);
+    object.set("max", max);
+    object.set("median", median);
+    object.set("first_quartile", first_quartile);
+    object.set("third_quartile", third_quartile);
+    object.set("p90", p90);
+    object.set("mean", mean);
+    object.set("standard_deviation", standard_deviation);
+    object.set("relative_median_absolute_deviation", relative_median_absolute_deviation);
+    return object;
+}
+
+Optional<BenchmarkStatistics> BenchmarkStatistics::from_json(JsonObject const& object)
+{
+    auto median = object.get_u64("median"sv);
+    auto first_quartile = object.get_u64("first_quartile"sv);
+    auto third_quartile = object.get_u64("third_quartile"sv);
+    if (!median.has_value() || !first_quartile.has_value() || !third_quartile.has_value())
+        return {};
+
+    // Only what is needed to compare against is required.
+    BenchmarkStatistics statistics;
+    statistics.median = *median;
+    statistics.first_quartile = *first_quartile;
+    statistics.third_quartile = *third_quartile;
+    statistics.sample_count = object.get_u64("samples"sv).value_or(0);
+    statistics.min = object.get_u64("min"sv).value_or(0);
+    statistics.max = object.get_u64("max"sv).value_or(0);
+    statistics.p90 = object.get_u64("p90"sv).value_or(0);
+    statistics.mean = object.get_double_with_precision_loss("mean"sv).value_or(0);
+    statistics.standard_deviation = object.get_double_with_precision_loss("standard_deviation"sv).value_or(0);
+    statistics.relative_median_absolute_deviation = object.get_double_with_precision_loss("relative_median_absolute_deviation"sv).value_or(0);
+    return statistics;
+}
+
+JsonObject BenchmarkResult::to_json() const
+{
+    JsonObject object;
+    object.set("name", name);
+    object.set("passed", result == TestResult::Passed);
+    object.set("warmup_runs", warmup_runs);
+    object.set("nanoseconds", nanoseconds.to_json());
+    if (cycles.has_value())
+        object.set("cycles", cycles->to_json());
+    return object;
+}
+
+u64 BenchmarkRunner::now_in_nanoseconds()
+{
+    struct timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<u64>(now.tv_sec) * 1'000'000'000 + now.tv_nsec;
+}
+
+Optional<u64> BenchmarkRunner::read_cycle_counter()
+{
+#if ARCH(X86_64)
+    return __builtin_ia32_rdtsc();
+#else
+    return {};
+#endif
+}
+
+bool BenchmarkRunner::should_continue(Vector<u64> const& samples, u64 total_nanoseconds) const
+{
+    if (samples.size() < m_options.min_runs)
+        return true;
+    if (samples.size() >= m_options.max_runs || m_options.min_time_ms == 0)
+        return false;
+    if (total_nanoseconds < m_options.min_time_ms * 1'000'000)
+        return true;
+
+    // NOTE: A handful of samples is needed for the deviation to mean anything.
+    if (samples.size() < 5)
+        return true;
+    auto statistics = BenchmarkStatistics::compute(samples);
+    return statistics.relative_median_absolute_deviation > m_options.max_relative_deviation;
+}
+
+ErrorOr<BenchmarkBaseline> BenchmarkBaseline::load(StringView path)
+{
+    auto file = TRY(Core::File::open(path, Core::File::OpenMode::Read));
+    auto contents = TRY(file->read_until_eof());
+    auto json = TRY(JsonValue::from_string(contents));
+    if (!json.is_object())
+        return Error::from_string_literal("Benchmark baseline is not a JSON object");
+
+    BenchmarkBaseline baseline;
+    auto const& object = json.as_object();
+    auto suite_name = object.get_byte_string("suite"sv).value_or({});
+    auto benchmarks = object.get_array("benchmarks"sv);
+    if (!benchmarks.has_value())
+        return Error::from_string_literal("Benchmark baseline has no benchmarks");
+
+    TRY(benchmarks->try_for_each([&](JsonValue const& value) -> ErrorOr<void> {
+        if (!value.is_object())
+            return Error::from_string_literal("Benchmark baseline has an invalid benchmark");
+        auto name = value.as_object().get_byte_string("name"sv);
+        auto nanoseconds = value.as_object().get_object("nanoseconds"sv);
+        if (!name.has_value() || !nanoseconds.has_value())
+            return Error::from_string_literal("Benchmark baseline has an invalid benchmark");
+        if (auto statistics = BenchmarkStatistics::from_json(*nanoseconds); statistics.has_value())
+            TRY(baseline.m_statistics.try_set(ByteString::formatted("{}/{}", suite_name, *name), statistics.release_value()));
+        return {};
+    }));
+    return baseline;
+}
+
+Optional<BenchmarkStatistics const&> BenchmarkBaseline::get(StringView suite_name, StringView benchmark_name) const
+{
+    auto it = m_statistics.find(ByteString::formatted("{}/{}", suite_name, benchmark_name));
+    if (it == m_statistics.end())
+        return {};
+    return it->value;
+}
+
+BenchmarkComparison compare_against_baseline(BenchmarkStatistics const& current, BenchmarkStatistics const& baseline, double regression_threshold)
+{
+    BenchmarkComparison comparison;
+    if (baseline.median == 0)
+        return comparison;
+    comparison.ratio = current.median / static_cast<double>(baseline.median);
+    comparison.is_regression = comparison.ratio > 1 + regression_threshold && current.first_quartile > baseline.third_quartile;
+    return comparison;
+}
+
+ErrorOr<void> write_benchmark_results(StringView path, StringView suite_name, Vector<BenchmarkResult> const& results)
+{
+    JsonArray benchmarks;
+    for (auto const& result : results)
+        TRY(benchmarks.append(result.to_json()));
+
+    JsonObject object;
+    object.set("suite", suite_name);
+    object.set("benchmarks", move(benchmarks));
+
+    auto json = object.serialized<StringBuilder>();
+    auto file = TRY(Core::File::open(path, Core::File::OpenMode::Write | Core::File::OpenMode::Truncate));
+    TRY(file->write_until_depleted(json.bytes()));
+    return {};
+}
+
+ByteString format_nanoseconds(double nanoseconds)
+{
+    if (nanoseconds < 1'000)
+        return ByteString::formatted("{:.0f}ns", nanoseconds);
+    if (nanoseconds < 1'000'000)
+        return ByteString::formatted("{:.2f}µs", nanoseconds / 1'000);
+    if (nanoseconds < 1'000'000'000)
+        return ByteString::formatted("{:.2f}ms", nanoseconds / 1'000'000);
+    return ByteString::formatted("{:.2f}s", nanoseconds / 1'000'000'000);
+}
+
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteString.h>
+#include <AK/HashMap.h>
+#include <AK/JsonObject.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <LibTest/TestResult.h>
+
+namespace Test {
+
+// Summary statistics of the measurements of a benchmark, one sample per run.
+struct BenchmarkStatistics {
+    static BenchmarkStatistics compute(Vector<u64> samples);
+
+    JsonObject to_json() const;
+    static Optional<BenchmarkStatistics> from_json(JsonObject const&);
+
+    size_t sample_count { 0 };
+    u64 min { 0 };
+    u64 max { 0 };
+    u64 median { 0 };
+    u64 first_quartile { 0 };
+    u64 third_quartile { 0 };
+    u64 p90 { 0 };
+    double mean { 0 };
+    double standard_deviation { 0 };
+    // The median absolute deviation relative to the median, which unlike the standard deviation isn't thrown off by
+    // the occasional outlier (the scheduler getting in the way, for example).
+    double relative_median_absolute_deviation { 0 };
+};
+
+struct BenchmarkOptions {
+    // Runs before the measured ones, to warm up caches and let lazy initialization happen.
+    u64 warmup_runs { 0 };
+    u64 min_runs { 1 };
+    u64 max_runs { 1000 };
+    // If set, keep running until the measured runs took at least this long in total and are stable, or max_runs
+    // is reached.
+    u64 min_time_ms { 0 };
+    double max_relative_deviation { 0.02 };
+};
+
+struct BenchmarkResult {
+    ByteString name;
+    TestResult result { TestResult::NotRun };
+    BenchmarkStatistics nanoseconds;
+    Optional<BenchmarkStatistics> cycles;
+    u64 warmup_runs { 0 };
+
+    JsonObject to_json() const;
+};
+
+class BenchmarkRunner {
+public:
+    explicit BenchmarkRunner(BenchmarkOptions options)
+        : m_options(options)
+    {
+    }
+
+    // Calls `run` until the options are satisfied, and measures each call after the warmup. `run` returns whether to
+    // carry on, a failing benchmark isn't run any further.
+    template<typename Callback>
+    BenchmarkResult run(ByteString name, Callback run)
+    {
+        BenchmarkResult result { .name = move(name), .warmup_runs = m_options.warmup_runs };
+        for (u64 i = 0; i < m_options.warmup_runs; ++i) {
+            if (!run())
+                return result;
+        }
+
+        Vector<u64> nanoseconds;
+        Vector<u64> cycles;
+        u64 total_nanoseconds = 0;
+        while (should_continue(nanoseconds, total_nanoseconds)) {
+            auto start_cycles = read_cycle_counter();
+            auto start = now_in_nanoseconds();
+            bool carry_on = run();
+            auto elapsed = now_in_nanoseconds() - start;
+            auto end_cycles = read_cycle_counter();
+
+            nanoseconds.append(elapsed);
+            total_nanoseconds += elapsed;
+            if (start_cycles.has_value() && end_cycles.has_value())
+                cycles.append(*end_cycles - *start_cycles);
+            if (!carry_on)
+                break;
+        }
+
+        result.nanoseconds = BenchmarkStatistics::compute(move(nanoseconds));
+        if (!cycles.is_empty())
+            result.cycles = BenchmarkStatistics::compute(move(cycles));
+        return result;
+    }
+
+    static u64 now_in_nanoseconds();
+    // The time stamp counter where there is one that userspace can read, which counts (reference) cycles.
+    static Optional<u64> read_cycle_counter();
+
+private:
+    bool should_continue(Vector<u64> const& samples, u64 total_nanoseconds) const;
+
+    BenchmarkOptions m_options;
+};
+
+// The results of an earlier run, as written by write_benchmark_results(), to compare against.
+class BenchmarkBaseline {
+public:
+    static ErrorOr<BenchmarkBaseline> load(StringView path);
+
+    Optional<BenchmarkStatistics const&> get(StringView suite_name, StringView benchmark_name) const;
+
+private:
+    HashMap<ByteString, BenchmarkStatistics> m_statistics;
+};
+
+struct BenchmarkComparison {
+    // New median divided by the baseline median, i.e. less than 1 if the benchmark got faster.
+    double ratio { 1 };
+    // Slower by more than the threshold, with the interquartile ranges not overlapping either, so that noise alone
+    // is unlikely to be the explanation.
+    bool is_regression { false };
+};
+
+BenchmarkComparison compare_against_baseline(BenchmarkStatistics const& current, BenchmarkStatistics const& baseline, double regression_threshold);
+
+ErrorOr<void> write_benchmark_results(StringView path, StringView suite_name, Vector<BenchmarkResult> const&);
+
+ByteString format_nanoseconds(double);
+
+}
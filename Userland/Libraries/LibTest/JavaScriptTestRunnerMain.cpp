@@ -95,6 +95,8 @@ int main(int argc, char** argv)
     StringView specified_test_root;
     ByteString common_path;
     ByteString test_glob;
+    bool disable_jit = false;
+    bool disable_bytecode_optimizations = false;
 
     Core::ArgsParser args_parser;
     args_parser.add_option(print_times, "Show duration of each test", "show-time", 't');
@@ -118,6 +120,8 @@ int main(int argc, char** argv)
     args_parser.add_option(per_file, "Show detailed per-file results as JSON (implies -j)", "per-file");
     args_parser.add_option(g_collect_on_every_allocation, "Collect garbage after every allocation", "collect-often", 'g');
     args_parser.add_option(JS::Bytecode::g_dump_bytecode, "Dump the bytecode", "dump-bytecode", 'd');
+    args_parser.add_option(disable_jit, "Disable the JIT compiler", "disable-jit", {});
+    args_parser.add_option(disable_bytecode_optimizations, "Disable the bytecode optimizations", "disable-bytecode-optimizations", {});
     args_parser.add_option(test_glob, "Only run tests matching the given glob", "filter", 'f', "glob");
     for (auto& entry : g_extra_args)
         args_parser.add_option(*entry.key, entry.value.get<0>().characters(), entry.value.get<1>().characters(), entry.value.get<2>());
@@ -128,6 +132,11 @@ int main(int argc, char** argv)
     if (per_file)
         print_json = true;
 
+    if (disable_jit)
+        JS::Bytecode::g_jit_enabled = false;
+    if (disable_bytecode_optimizations)
+        JS::Bytecode::g_optimize_bytecode = false;
+
     test_glob = ByteString::formatted("*{}*", test_glob);
 
     if (getenv("DISABLE_DBG_OUTPUT")) {
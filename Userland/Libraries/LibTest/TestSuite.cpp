@@ -7,6 +7,7 @@
 
 #include <AK/Function.h>
 #include <LibCore/ArgsParser.h>
+#include <LibTest/Benchmark.h>
 #include <LibTest/Macros.h>
 #include <LibTest/TestResult.h>
 #include <LibTest/TestSuite.h>
@@ -130,12 +131,27 @@ int TestSuite::main(ByteString const& suite_name, Span<StringView> arguments)
 
     args_parser.add_option(do_tests_only, "Only run tests.", "tests");
     args_parser.add_option(do_benchmarks_only, "Only run benchmarks.", "bench");
-    args_parser.add_option(m_benchmark_repetitions, "Number of times to repeat each benchmark (default 1)", "benchmark_repetitions", 0, "N");
+    args_parser.add_option(m_benchmark_options.min_runs, "Number of times to repeat each benchmark (default 1)", "benchmark_repetitions", 0, "N");
+    args_parser.add_option(m_benchmark_options.warmup_runs, "Number of unmeasured runs before each benchmark (default 0)", "benchmark_warmup", 0, "N");
+    args_parser.add_option(m_benchmark_options.min_time_ms, "Repeat each benchmark until it ran for this long and its timings are stable (default 0, off)", "benchmark_min_time", 0, "MS");
+    args_parser.add_option(m_benchmark_options.max_runs, "Maximum number of times to repeat each benchmark with --benchmark_min_time (default 1000)", "benchmark_max_repetitions", 0, "N");
+    args_parser.add_option(m_benchmark_json_path, "Write the benchmark results to a JSON file", "benchmark_json", 0, "FILE");
+    args_parser.add_option(m_benchmark_baseline_path, "Compare the benchmark results against a JSON file from an earlier run", "benchmark_baseline", 0, "FILE");
+    args_parser.add_option(m_benchmark_regression_percentage, "Fail benchmarks that got slower than the baseline by more than this (default 5)", "benchmark_regression_threshold", 0, "PERCENT");
     args_parser.add_option(m_randomized_runs, "Number of times to run each RANDOMIZED_TEST_CASE (default 100)", "randomized_runs", 0, "RUNS");
     args_parser.add_option(do_list_cases, "List available test cases.", "list");
     args_parser.add_positional_argument(search_string, "Only run matching cases.", "pattern", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
+    if (!m_benchmark_baseline_path.is_empty()) {
+        auto baseline = BenchmarkBaseline::load(m_benchmark_baseline_path);
+        if (baseline.is_error()) {
+            warnln("Failed to load benchmark baseline from {}: {}", m_benchmark_baseline_path, baseline.error());
+            return 1;
+        }
+        m_benchmark_baseline = baseline.release_value();
+    }
+
     if (m_setup)
         m_setup();
 
@@ -174,6 +190,45 @@ Vector<NonnullRefPtr<TestCase>> TestSuite::find_cases(ByteString const& search,
     return matches;
 }
 
+u64 TestSuite::run_benchmark(TestCase const& test_case)
+{
+    BenchmarkRunner runner { m_benchmark_options };
+    auto result = runner.run(test_case.name(), [&] {
+        test_case.func()();
+        if (m_current_test_result == TestResult::NotRun)
+            m_current_test_result = TestResult::Passed;
+        return m_current_test_result == TestResult::Passed;
+    });
+
+    auto const& statistics = result.nanoseconds;
+    if (statistics.sample_count > 1) {
+        dbgln("{} benchmark '{}' in {} median ({} to {} interquartile, p90={}, min={}, max={}, mean={}±{}, {} runs)",
+            test_result_to_string(m_current_test_result), test_case.name(),
+            format_nanoseconds(statistics.median), format_nanoseconds(statistics.first_quartile), format_nanoseconds(statistics.third_quartile),
+            format_nanoseconds(statistics.p90), format_nanoseconds(statistics.min), format_nanoseconds(statistics.max),
+            format_nanoseconds(statistics.mean), format_nanoseconds(statistics.standard_deviation), statistics.sample_count);
+    } else {
+        dbgln("{} benchmark '{}' in {}", test_result_to_string(m_current_test_result), test_case.name(), format_nanoseconds(statistics.median));
+    }
+    if (result.cycles.has_value())
+        dbgln("    {} cycles median", result.cycles->median);
+
+    if (m_benchmark_baseline.has_value() && m_current_test_result == TestResult::Passed) {
+        if (auto baseline = m_benchmark_baseline->get(m_suite_name, test_case.name()); baseline.has_value()) {
+            auto comparison = compare_against_baseline(statistics, *baseline, m_benchmark_regression_percentage / 100.0);
+            dbgln("    {:.1f}% {} than the baseline ({} median){}",
+                fabs(comparison.ratio - 1) * 100, comparison.ratio > 1 ? "slower" : "faster", format_nanoseconds(baseline->median),
+                comparison.is_regression ? ", which is a regression" : "");
+            if (comparison.is_regression)
+                m_current_test_result = TestResult::Failed;
+        }
+    }
+
+    result.result = m_current_test_result;
+    m_benchmark_results.append(move(result));
+    return (statistics.mean * statistics.sample_count) / 1'000'000;
+}
+
 int TestSuite::run(Vector<NonnullRefPtr<TestCase>> const& tests)
 {
     size_t test_count = 0;
@@ -186,40 +241,24 @@ int TestSuite::run(Vector<NonnullRefPtr<TestCase>> const& tests)
 
     for (auto const& t : tests) {
         auto const test_type = t->is_benchmark() ? "benchmark" : "test";
-        auto const repetitions = t->is_benchmark() ? m_benchmark_repetitions : 1;
 
         warnln("Running {} '{}'.", test_type, t->name());
         m_current_test_result = TestResult::NotRun;
         enable_reporting();
 
         u64 total_time = 0;
-        u64 sum_of_squared_times = 0;
-        u64 min_time = NumericLimits<u64>::max();
-        u64 max_time = 0;
 
-        for (u64 i = 0; i < repetitions; ++i) {
+        if (t->is_benchmark()) {
+            total_time = run_benchmark(*t);
+        } else {
             TestElapsedTimer timer;
             t->func()();
-            auto const iteration_time = timer.elapsed_milliseconds();
-            total_time += iteration_time;
-            sum_of_squared_times += iteration_time * iteration_time;
-            min_time = min(min_time, iteration_time);
-            max_time = max(max_time, iteration_time);
+            total_time = timer.elapsed_milliseconds();
 
             // Non-randomized tests don't touch the test result when passing.
             if (m_current_test_result == TestResult::NotRun)
                 m_current_test_result = TestResult::Passed;
-        }
 
-        if (repetitions != 1) {
-            double average = total_time / double(repetitions);
-            double average_squared = average * average;
-            double standard_deviation = sqrt((sum_of_squared_times + repetitions * average_squared - 2 * total_time * average) / (repetitions - 1));
-
-            dbgln("{} {} '{}' on average in {:.1f}±{:.1f}ms (min={}ms, max={}ms, total={}ms)",
-                test_result_to_string(m_current_test_result), test_type, t->name(),
-                average, standard_deviation, min_time, max_time, total_time);
-        } else {
             dbgln("{} {} '{}' in {}ms", test_result_to_string(m_current_test_result), test_type, t->name(), total_time);
         }
 
@@ -282,6 +321,11 @@ int TestSuite::run(Vector<NonnullRefPtr<TestCase>> const& tests)
         }
     }
 
+    if (!m_benchmark_json_path.is_empty()) {
+        if (auto result = write_benchmark_results(m_benchmark_json_path, m_suite_name, m_benchmark_results); result.is_error())
+            warnln("Failed to write benchmark results to {}: {}", m_benchmark_json_path, result.error());
+    }
+
     // We have multiple TestResults, all except for Passed being "bad".
     // Let's get a count of them:
     return (int)(test_count - test_passed_count + benchmark_count - benchmark_passed_count);
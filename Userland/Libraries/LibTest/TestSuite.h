@@ -9,7 +9,9 @@
 
 #include <AK/ByteString.h>
 #include <AK/Function.h>
+#include <AK/Optional.h>
 #include <AK/Vector.h>
+#include <LibTest/Benchmark.h>
 #include <LibTest/Macros.h>
 #include <LibTest/Randomized/RandomnessSource.h>
 #include <LibTest/TestCase.h>
@@ -63,12 +65,20 @@ public:
     u64 randomized_runs() { return m_randomized_runs; }
 
 private:
+    // Returns how long the measured runs took in total, in milliseconds.
+    u64 run_benchmark(TestCase const&);
+
     static TestSuite* s_global;
     Vector<NonnullRefPtr<TestCase>> m_cases;
     u64 m_testtime = 0;
     u64 m_benchtime = 0;
     ByteString m_suite_name;
-    u64 m_benchmark_repetitions = 1;
+    BenchmarkOptions m_benchmark_options;
+    StringView m_benchmark_json_path;
+    StringView m_benchmark_baseline_path;
+    double m_benchmark_regression_percentage = 5;
+    Optional<BenchmarkBaseline> m_benchmark_baseline;
+    Vector<BenchmarkResult> m_benchmark_results;
     u64 m_randomized_runs = 100;
     Function<void()> m_setup;
     TestResult m_current_test_result = TestResult::NotRun;
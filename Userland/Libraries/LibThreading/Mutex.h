@@ -20,15 +20,30 @@ class Mutex {
     friend class ConditionVariable;
 
 public:
+    enum class Protocol {
+        None,
+        // Lends the priority of waiting threads to the owner. Use this for mutexes shared with real-time threads.
+        PriorityInherit,
+    };
+
     Mutex()
+        : Mutex(Protocol::None)
+    {
+    }
+
+    explicit Mutex(Protocol protocol)
         : m_lock_count(0)
     {
-#ifndef AK_OS_SERENITY
+#ifdef AK_OS_SERENITY
+        if (protocol == Protocol::None)
+            return;
+#endif
         pthread_mutexattr_t attr;
         pthread_mutexattr_init(&attr);
         pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+        if (protocol == Protocol::PriorityInherit)
+            pthread_mutexattr_setprotocol(&attr, PTHREAD_PRIO_INHERIT);
         pthread_mutex_init(&m_mutex, &attr);
-#endif
     }
     ~Mutex()
     {
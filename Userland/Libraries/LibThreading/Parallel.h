@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/QuickSort.h>
+#include <AK/Span.h>
+#include <LibThreading/ThreadPool.h>
+
+namespace Threading {
+
+using TaskPool = ThreadPool<Function<void()>>;
+
+// Calls `callback` with each index in [0, count), in chunks of `grain_size` indices that are spread over the workers
+// of the pool. The calling thread works on the chunks as well, and returns once all of them are done. By default,
+// there are a few chunks per worker, so that a worker that is done early has something left to steal.
+template<typename Callback>
+void parallel_for(TaskPool& pool, size_t count, Callback callback, size_t grain_size = 0)
+{
+    if (grain_size == 0)
+        grain_size = max(ceil_div(count, (pool.concurrency() + 1) * 4), static_cast<size_t>(1));
+
+    if (count <= grain_size) {
+        for (size_t i = 0; i < count; ++i)
+            callback(i);
+        return;
+    }
+
+    TaskGroup group { pool };
+    for (size_t start = grain_size; start < count; start += grain_size) {
+        group.spawn([&callback, start, end = min(start + grain_size, count)] {
+            for (size_t i = start; i < end; ++i)
+                callback(i);
+        });
+    }
+    for (size_t i = 0; i < grain_size; ++i)
+        callback(i);
+    group.join();
+}
+
+template<typename T, typename Callback>
+void parallel_for_each(TaskPool& pool, Span<T> span, Callback callback, size_t grain_size = 0)
+{
+    parallel_for(
+        pool, span.size(), [&](size_t index) { callback(span[index]); }, grain_size);
+}
+
+namespace Detail {
+
+// Below this, splitting up the work any further costs more than it saves.
+static constexpr size_t parallel_sort_threshold = 4096;
+
+template<typename T, typename LessThan>
+void parallel_sort(TaskGroup<TaskPool>& group, Span<T> span, LessThan const& less_than)
+{
+    while (span.size() > parallel_sort_threshold) {
+        // Partition around the median of the first, middle and last element, which is swapped to the front.
+        auto middle = span.size() / 2;
+        auto last = span.size() - 1;
+        if (less_than(span[middle], span[0]))
+            swap(span[middle], span[0]);
+        if (less_than(span[last], span[middle]))
+            swap(span[last], span[middle]);
+        if (less_than(span[middle], span[0]))
+            swap(span[middle], span[0]);
+        swap(span[0], span[middle]);
+
+        // NOTE: Both sides stop at elements that are equal to the pivot, which keeps the halves balanced on duplicates.
+        size_t i = 0;
+        size_t j = span.size();
+        while (true) {
+            do
+                ++i;
+            while (i < span.size() && less_than(span[i], span[0]));
+            do
+                --j;
+            while (less_than(span[0], span[j]));
+            if (i >= j)
+                break;
+            swap(span[i], span[j]);
+        }
+        swap(span[0], span[j]);
+
+        group.spawn([&group, left = span.slice(0, j), &less_than] {
+            parallel_sort(group, left, less_than);
+        });
+        span = span.slice(j + 1);
+    }
+    quick_sort(span, less_than);
+}
+
+}
+
+// Sorts the span using the workers of the pool, the calling thread takes part in the sorting as well.
+// Like quick_sort(), this is not a stable sort.
+template<typename T, typename LessThan>
+void parallel_sort(TaskPool& pool, Span<T> span, LessThan less_than)
+{
+    TaskGroup group { pool };
+    Detail::parallel_sort(group, span, less_than);
+    group.join();
+}
+
+template<typename T>
+void parallel_sort(TaskPool& pool, Span<T> span)
+{
+    parallel_sort(pool, span, [](auto& a, auto& b) { return a < b; });
+}
+
+}
@@ -6,9 +6,13 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/Concepts.h>
+#include <AK/MPMCQueue.h>
+#include <AK/NonnullOwnPtr.h>
 #include <AK/Noncopyable.h>
 #include <AK/Queue.h>
+#include <AK/RefPtr.h>
 #include <LibCore/System.h>
 #include <LibThreading/ConditionVariable.h>
 #include <LibThreading/MutexProtected.h>
@@ -16,36 +20,77 @@
 
 namespace Threading {
 
+namespace Detail {
+
+// The work of a single worker. The worker itself takes work from the back, i.e. what it submitted last and what is
+// most likely still in the cache. Other workers steal from the front, and so get the oldest (and for work that is
+// split up recursively, the biggest) pieces.
+template<typename Work>
+class WorkDeque {
+public:
+    bool is_empty() const { return m_head == m_work.size(); }
+
+    void push(Work work) { m_work.append(move(work)); }
+
+    Optional<Work> pop()
+    {
+        if (is_empty())
+            return {};
+        auto work = m_work.take_last();
+        reset_if_empty();
+        return work;
+    }
+
+    Optional<Work> steal()
+    {
+        if (is_empty())
+            return {};
+        auto work = move(m_work[m_head++]);
+        reset_if_empty();
+        // NOTE: Stolen work leaves a gap at the front, which is only closed up once it is a sizeable part of the deque.
+        if (m_head >= 64 && m_head * 2 >= m_work.size()) {
+            m_work.remove(0, m_head);
+            m_head = 0;
+        }
+        return work;
+    }
+
+private:
+    void reset_if_empty()
+    {
+        if (!is_empty())
+            return;
+        m_work.clear_with_capacity();
+        m_head = 0;
+    }
+
+    Vector<Work> m_work;
+    size_t m_head { 0 };
+};
+
+}
+
 template<typename Pool>
 struct ThreadPoolLooper {
     IterationDecision next(Pool& pool, bool wait)
     {
-        Optional<typename Pool::Work> entry;
         while (true) {
-            entry = pool.m_work_queue.with_locked([&](auto& queue) -> Optional<typename Pool::Work> {
-                if (queue.is_empty())
-                    return {};
-                return queue.dequeue();
-            });
-            if (entry.has_value())
-                break;
+            if (pool.try_run_pending_work())
+                return IterationDecision::Continue;
             if (pool.m_should_exit)
                 return IterationDecision::Break;
 
             if (!wait)
                 return IterationDecision::Continue;
 
-            pool.m_mutex.lock();
-            pool.m_work_available.wait();
-            pool.m_mutex.unlock();
+            pool.wait_for_work();
         }
-
-        pool.m_busy_count++;
-        pool.m_handler(entry.release_value());
-        return IterationDecision::Continue;
     }
 };
 
+// Each worker has a deque of its own, which the work that is submitted from within that worker goes onto, all other
+// work goes onto a shared lock-free queue. Workers that run out of work take it from the shared queue and otherwise steal it
+// from another worker, so that submitting and running work mostly doesn't contend with the other workers.
 template<typename TWork, template<typename> class Looper = ThreadPoolLooper>
 class ThreadPool {
     AK_MAKE_NONCOPYABLE(ThreadPool);
@@ -56,7 +101,7 @@ public:
     friend struct ThreadPoolLooper<ThreadPool>;
 
     ThreadPool(Optional<size_t> concurrency = {})
-    requires(IsFunction<Work>)
+    requires(IsCallableWithArguments<Work, void>)
         : m_handler([](Work work) { return work(); })
         , m_work_available(m_mutex)
         , m_work_done(m_mutex)
@@ -74,69 +119,222 @@ public:
 
     ~ThreadPool()
     {
-        m_should_exit.store(true, AK::MemoryOrder::memory_order_release);
-        for (auto& worker : m_workers) {
+        {
+            MutexLocker locker(m_mutex);
+            m_should_exit.store(true, AK::MemoryOrder::memory_order_release);
             m_work_available.broadcast();
-            (void)worker->join();
         }
+        for (auto& worker : m_workers)
+            (void)worker->thread->join();
     }
 
+    size_t concurrency() const { return m_workers.size(); }
+
     void submit(Work work)
     {
-        m_work_queue.with_locked([&](auto& queue) {
-            queue.enqueue({ move(work) });
-        });
-        m_work_available.broadcast();
+        m_unfinished_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+        // NOTE: This pairs up with wait_for_work(), either the worker sees the new work or we see that it is asleep.
+        m_queued_count.fetch_add(1);
+        if (auto* worker = current_worker()) {
+            worker->work.with_locked([&](auto& deque) {
+                deque.push(move(work));
+            });
+        } else if (!m_shared_queue.try_enqueue(move(work))) {
+            m_overflow_queue.with_locked([&](auto& queue) {
+                queue.enqueue(move(work));
+            });
+        }
+
+        if (m_sleeping_count.load() > 0) {
+            MutexLocker locker(m_mutex);
+            m_work_available.signal();
+        }
+    }
+
+    // Runs a single piece of work on the calling thread, if there is any.
+    bool try_run_pending_work()
+    {
+        auto work = take_work();
+        if (!work.has_value())
+            return false;
+
+        m_handler(work.release_value());
+        if (m_unfinished_count.fetch_sub(1, AK::MemoryOrder::memory_order_acq_rel) == 1) {
+            MutexLocker locker(m_mutex);
+            m_work_done.broadcast();
+        }
+        return true;
     }
 
     void wait_for_all()
     {
-        while (true) {
-            if (m_work_queue.with_locked([](auto& queue) { return queue.is_empty(); }))
-                break;
-            m_mutex.lock();
+        // Waiting from within a worker would wait for the worker itself.
+        VERIFY(!current_worker());
+
+        MutexLocker locker(m_mutex);
+        while (m_unfinished_count.load(AK::MemoryOrder::memory_order_acquire) > 0)
             m_work_done.wait();
-            m_mutex.unlock();
+    }
+
+private:
+    struct Worker {
+        Worker(ThreadPool& pool, size_t index)
+            : pool(pool)
+            , index(index)
+        {
         }
 
-        while (m_busy_count.load(AK::MemoryOrder::memory_order_acquire) > 0) {
-            m_mutex.lock();
-            m_work_done.wait();
-            m_mutex.unlock();
+        ThreadPool& pool;
+        size_t index { 0 };
+        MutexProtected<Detail::WorkDeque<Work>> work;
+        RefPtr<Thread> thread;
+    };
+
+    Worker* current_worker() const
+    {
+        if (s_current_worker && &s_current_worker->pool == this)
+            return s_current_worker;
+        return nullptr;
+    }
+
+    Optional<Work> take_work()
+    {
+        auto* worker = current_worker();
+        if (worker) {
+            if (auto work = worker->work.with_locked([](auto& deque) { return deque.pop(); }); work.has_value())
+                return took_work(move(work));
+        }
+
+        if (auto work = m_shared_queue.try_dequeue(); work.has_value())
+            return took_work(move(work));
+        if (auto work = m_overflow_queue.with_locked([](auto& queue) -> Optional<Work> {
+                if (queue.is_empty())
+                    return {};
+                return queue.dequeue();
+            });
+            work.has_value())
+            return took_work(move(work));
+
+        // Start looking at the next worker along, so that thieves are spread out over their victims.
+        auto start = worker ? worker->index + 1 : 0;
+        for (size_t i = 0; i < m_workers.size(); ++i) {
+            auto& victim = *m_workers[(start + i) % m_workers.size()];
+            if (&victim == worker)
+                continue;
+            if (auto work = victim.work.with_locked([](auto& deque) { return deque.steal(); }); work.has_value())
+                return took_work(move(work));
         }
+        return {};
+    }
+
+    Optional<Work> took_work(Optional<Work> work)
+    {
+        m_queued_count.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+        return work;
+    }
+
+    void wait_for_work()
+    {
+        MutexLocker locker(m_mutex);
+        m_sleeping_count.fetch_add(1);
+        while (m_queued_count.load() == 0 && !m_should_exit.load(AK::MemoryOrder::memory_order_acquire))
+            m_work_available.wait();
+        m_sleeping_count.fetch_sub(1);
     }
 
-private:
     void initialize_workers(size_t concurrency)
     {
-        for (size_t i = 0; i < concurrency; ++i) {
-            m_workers.append(Thread::construct([this]() -> intptr_t {
+        for (size_t i = 0; i < concurrency; ++i)
+            m_workers.append(make<Worker>(*this, i));
+
+        for (auto& worker : m_workers) {
+            worker->thread = Thread::construct([this, worker = worker.ptr()]() -> intptr_t {
+                s_current_worker = worker;
                 Looper<ThreadPool> thread_looper;
                 for (; !m_should_exit;) {
                     auto result = thread_looper.next(*this, true);
-                    m_busy_count--;
-                    m_work_done.signal();
                     if (result == IterationDecision::Break)
                         break;
                 }
 
                 return 0;
             },
-                "ThreadPool worker"sv));
+                "ThreadPool worker"sv);
         }
 
         for (auto& worker : m_workers)
-            worker->start();
+            worker->thread->start();
     }
 
-    Vector<NonnullRefPtr<Thread>> m_workers;
-    MutexProtected<Queue<Work>> m_work_queue;
+    static inline thread_local Worker* s_current_worker { nullptr };
+
+    Vector<NonnullOwnPtr<Worker>> m_workers;
+    MPMCQueue<Work, 256> m_shared_queue;
+    // Only used once the shared queue is full, the order that work is run in isn't guaranteed anyway.
+    MutexProtected<Queue<Work>> m_overflow_queue;
     Function<void(Work)> m_handler;
     Mutex m_mutex;
     ConditionVariable m_work_available;
     ConditionVariable m_work_done;
     Atomic<bool> m_should_exit { false };
-    Atomic<size_t> m_busy_count { 0 };
+    // Work that was submitted but not taken by a worker yet.
+    Atomic<size_t> m_queued_count { 0 };
+    // Work that was submitted but hasn't finished running yet.
+    Atomic<size_t> m_unfinished_count { 0 };
+    Atomic<size_t> m_sleeping_count { 0 };
+};
+
+// Work that belongs together, so that it can be waited for as a whole. Whoever joins the group helps out with the
+// work of the pool in the meantime, so joining a group from within a worker of the same pool is fine, and is how
+// nested parallelism is expressed.
+template<typename Pool>
+class TaskGroup {
+    AK_MAKE_NONCOPYABLE(TaskGroup);
+    AK_MAKE_NONMOVABLE(TaskGroup);
+
+public:
+    explicit TaskGroup(Pool& pool)
+        : m_pool(pool)
+        , m_done(m_mutex)
+    {
+    }
+
+    ~TaskGroup() { join(); }
+
+    Pool& pool() { return m_pool; }
+
+    template<typename Callback>
+    void spawn(Callback callback)
+    {
+        m_pending_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+        m_pool.submit([this, callback = move(callback)]() mutable {
+            callback();
+            // NOTE: The count has to drop under the lock, so that join() can't return (and destroy us) in between.
+            MutexLocker locker(m_mutex);
+            if (m_pending_count.fetch_sub(1, AK::MemoryOrder::memory_order_acq_rel) == 1)
+                m_done.broadcast();
+        });
+    }
+
+    void join()
+    {
+        while (m_pending_count.load(AK::MemoryOrder::memory_order_acquire) > 0) {
+            if (m_pool.try_run_pending_work())
+                continue;
+            // Nothing is left to help with, everything that remains of the group is already running elsewhere.
+            MutexLocker locker(m_mutex);
+            if (m_pending_count.load(AK::MemoryOrder::memory_order_acquire) > 0)
+                m_done.wait();
+        }
+        // Wait for whoever finished the last task to let go of the lock.
+        MutexLocker locker(m_mutex);
+    }
+
+private:
+    Pool& m_pool;
+    Mutex m_mutex;
+    ConditionVariable m_done;
+    Atomic<size_t> m_pending_count { 0 };
 };
 
 }
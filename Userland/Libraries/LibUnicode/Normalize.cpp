@@ -297,8 +297,34 @@ static Vector<u32> normalize_implementation(Utf8View string, NormalizationForm f
     VERIFY_NOT_REACHED();
 }
 
+// NOTE: This is written as a plain loop over every byte, so that the compiler can vectorize it.
+static u8 largest_byte(StringView string)
+{
+    u8 largest = 0;
+    for (auto byte : string.bytes())
+        largest = max(largest, byte);
+    return largest;
+}
+
+// OPTIMIZATION: ASCII text is left unchanged by all normalization forms. Text that contains nothing at or above U+0300
+//               is also already in NFC, as none of those code points has an NFC_Quick_Check value other than Yes. In UTF-8,
+//               those are exactly the strings whose bytes are all smaller than 0xCC, the lead byte of U+0300.
+static bool is_normalized_quick_check(StringView string, NormalizationForm form)
+{
+    auto largest = largest_byte(string);
+    if (largest < 0x80)
+        return true;
+    return form == NormalizationForm::NFC && largest < 0xCC;
+}
+
 String normalize(StringView string, NormalizationForm form)
 {
+    if (is_normalized_quick_check(string, form)) {
+        // Invalid UTF-8 still has to go through the full algorithm, which replaces it with U+FFFD.
+        if (auto result = String::from_utf8(string); !result.is_error())
+            return result.release_value();
+    }
+
     auto const code_points = normalize_implementation(Utf8View { string }, form);
 
     StringBuilder builder;
@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/CharacterTypes.h>
 #include <AK/Utf16View.h>
 #include <AK/Utf32View.h>
 #include <AK/Utf8View.h>
@@ -86,6 +87,18 @@ static void for_each_grapheme_segmentation_boundary_impl([[maybe_unused]] ViewTy
         for (++it; it != view.end(); ++it, code_point = next_code_point) {
             next_code_point = *it;
 
+            // OPTIMIZATION: No ASCII code point is an Extend, ZWJ, SpacingMark, Prepend, Hangul or Regional_Indicator
+            //               character, nor Extended_Pictographic or an Indic conjunct consonant. So between two of them,
+            //               the only rules that matter are GB3 (no break within CR LF) and GB999 (break everywhere else).
+            if (is_ascii(code_point) && is_ascii(next_code_point)) {
+                current_ri_chain = 0;
+                if (code_point == '\r' && next_code_point == '\n')
+                    continue;
+                if (callback(code_unit_offset_of(view, it)) == IterationDecision::Break)
+                    return;
+                continue;
+            }
+
             // GB9c
             if (code_point_has_property(code_point, Property::InCB_Consonant)) {
                 auto it_copy = it;
@@ -32,6 +32,27 @@ Vector<EscapeSequenceParser::OscParameter> EscapeSequenceParser::osc_parameters(
     return params;
 }
 
+void EscapeSequenceParser::on_input(ReadonlyBytes bytes)
+{
+    // Printable ASCII in the ground state never changes state, so hand whole runs of it to the executor at once.
+    auto is_printable = [](u8 byte) { return byte >= 0x20 && byte <= 0x7f; };
+
+    size_t i = 0;
+    while (i < bytes.size()) {
+        if (!m_state_machine.is_in_initial_state() || !is_printable(bytes[i])) {
+            on_input(bytes[i++]);
+            continue;
+        }
+
+        size_t run_end = i + 1;
+        while (run_end < bytes.size() && is_printable(bytes[run_end]))
+            ++run_end;
+        dbgln_if(ESCAPE_SEQUENCE_DEBUG, "on_input printable run of {} bytes", run_end - i);
+        m_executor.emit_printable_run(bytes.slice(i, run_end - i));
+        i = run_end;
+    }
+}
+
 void EscapeSequenceParser::perform_action(EscapeSequenceStateMachine::Action action, u8 byte)
 {
     auto advance_utf8 = [&](u8 byte) {
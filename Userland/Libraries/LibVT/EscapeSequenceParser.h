@@ -25,6 +25,11 @@ public:
     using OscParameters = ReadonlySpan<OscParameter>;
 
     virtual void emit_code_point(u32) = 0;
+    virtual void emit_printable_run(ReadonlyBytes bytes)
+    {
+        for (auto byte : bytes)
+            emit_code_point(byte);
+    }
     virtual void execute_control_code(u8) = 0;
     virtual void execute_escape_sequence(Intermediates intermediates, bool ignore, u8 last_byte) = 0;
     virtual void execute_csi_sequence(Parameters parameters, Intermediates intermediates, bool ignore, u8 last_byte) = 0;
@@ -45,6 +50,8 @@ public:
         m_state_machine.advance(byte);
     }
 
+    void on_input(ReadonlyBytes);
+
 private:
     static constexpr size_t MAX_INTERMEDIATES = 2;
     static constexpr size_t MAX_PARAMETERS = 16;
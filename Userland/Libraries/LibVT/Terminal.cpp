@@ -1044,6 +1044,11 @@ void Terminal::on_input(u8 byte)
     m_parser.on_input(byte);
 }
 
+void Terminal::on_input(ReadonlyBytes bytes)
+{
+    m_parser.on_input(bytes);
+}
+
 void Terminal::emit_code_point(u32 code_point)
 {
     auto working_set = m_working_sets[m_active_working_set_index];
@@ -1069,6 +1074,27 @@ void Terminal::emit_code_point(u32 code_point)
     }
 }
 
+void Terminal::emit_printable_run(ReadonlyBytes bytes)
+{
+    auto working_set = m_working_sets[m_active_working_set_index];
+    while (!bytes.is_empty()) {
+        // Fill the current line up to (but not including) its last column in one go, and only move the cursor afterwards.
+        // Reaching the last column involves the wrapping dance in emit_code_point(), so leave that to it.
+        auto row = cursor_row();
+        auto column = cursor_column();
+        auto count = min<size_t>(columns() - column - 1, bytes.size());
+        if (count == 0) {
+            emit_code_point(bytes[0]);
+            bytes = bytes.slice(1);
+            continue;
+        }
+        for (size_t i = 0; i < count; ++i)
+            put_character_at(row, column + i, m_character_set_translator.translate_code_point(working_set, bytes[i]));
+        set_cursor(row, column + count, true);
+        bytes = bytes.slice(count);
+    }
+}
+
 void Terminal::execute_control_code(u8 code)
 {
     ArmedScopeGuard clear_position_before_cr {
@@ -1376,8 +1402,7 @@ void Terminal::execute_dcs_sequence()
 
 void Terminal::inject_string(StringView str)
 {
-    for (size_t i = 0; i < str.length(); ++i)
-        on_input(str[i]);
+    on_input(str.bytes());
 }
 
 void Terminal::emit_string(StringView string)
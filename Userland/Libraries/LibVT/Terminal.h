@@ -77,6 +77,7 @@ public:
 #endif
 
     void on_input(u8);
+    void on_input(ReadonlyBytes);
 
     void set_cursor(unsigned row, unsigned column, bool skip_debug = false);
 
@@ -196,6 +197,7 @@ public:
 protected:
     // ^EscapeSequenceExecutor
     virtual void emit_code_point(u32) override;
+    virtual void emit_printable_run(ReadonlyBytes) override;
     virtual void execute_control_code(u8) override;
     virtual void execute_escape_sequence(Intermediates intermediates, bool ignore, u8 last_byte) override;
     virtual void execute_csi_sequence(Parameters parameters, Intermediates intermediates, bool ignore, u8 last_byte) override;
@@ -70,8 +70,12 @@ void TerminalWidget::set_pty_master_fd(int fd)
             return;
         }
 
-        for (ssize_t i = 0; i < nread; ++i)
-            m_terminal.on_input(buffer[i]);
+        {
+            TemporaryChange processing_input { m_is_processing_pty_input, true };
+            m_terminal.on_input(ReadonlyBytes { buffer, static_cast<size_t>(nread) });
+        }
+        if (m_scrollbar_was_at_max_before_history_change.has_value())
+            update_scrollbar_for_history(m_scrollbar_was_at_max_before_history_change.release_value());
 
         auto owned_by_startup_process = m_startup_process_owns_pty;
         auto pgrp = tcgetpgrp(m_ptm_fd);
@@ -1040,14 +1044,26 @@ int TerminalWidget::last_selection_column_on_row(int row) const
 
 void TerminalWidget::terminal_history_changed(int delta)
 {
+    // If the history buffer wrapped around, the selection needs to be offset accordingly.
+    if (m_selection.is_valid() && delta < 0)
+        m_selection.offset_row(delta);
+
     bool was_max = m_scrollbar->value() == m_scrollbar->max();
+    if (m_is_processing_pty_input) {
+        // Every scrolled line ends up here, so only touch the scrollbar once the whole chunk of input has been processed.
+        if (!m_scrollbar_was_at_max_before_history_change.has_value())
+            m_scrollbar_was_at_max_before_history_change = was_max;
+        return;
+    }
+    update_scrollbar_for_history(was_max);
+}
+
+void TerminalWidget::update_scrollbar_for_history(bool was_max)
+{
     m_scrollbar->set_max(m_terminal.history_size());
     if (was_max)
         m_scrollbar->set_value(m_scrollbar->max());
     m_scrollbar->update();
-    // If the history buffer wrapped around, the selection needs to be offset accordingly.
-    if (m_selection.is_valid() && delta < 0)
-        m_selection.offset_row(delta);
 }
 
 void TerminalWidget::terminal_did_perform_possibly_partial_clear()
@@ -163,6 +163,7 @@ private:
     Gfx::IntSize widget_size_for_font(Gfx::Font const&) const;
 
     void update_cursor();
+    void update_scrollbar_for_history(bool was_at_max);
     void invalidate_cursor();
 
     void relayout(Gfx::IntSize);
@@ -221,6 +222,8 @@ private:
 
     bool m_has_logical_focus { false };
     bool m_in_relayout { false };
+    bool m_is_processing_pty_input { false };
+    Optional<bool> m_scrollbar_was_at_max_before_history_change;
 
     RefPtr<Core::Notifier> m_notifier;
 
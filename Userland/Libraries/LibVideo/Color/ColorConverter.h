@@ -8,6 +8,8 @@
 
 #include <AK/Array.h>
 #include <AK/Function.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
 #include <LibGfx/Color.h>
 #include <LibGfx/Matrix4x4.h>
 #include <LibVideo/Color/CodingIndependentCodePoints.h>
@@ -153,6 +155,29 @@ public:
     // Fast conversion of 8-bit YUV to full-range RGB.
     template<MatrixCoefficients MC, VideoFullRangeFlag FR, Unsigned T>
     static ALWAYS_INLINE Gfx::Color convert_simple_yuv_to_rgb(T y_in, T u_in, T v_in)
+    {
+        i32 red;
+        i32 green;
+        i32 blue;
+        convert_simple_yuv_to_rgb_components<MC, FR>(static_cast<i32>(y_in), static_cast<i32>(u_in), static_cast<i32>(v_in), red, green, blue);
+        return Gfx::Color(u8(red), u8(green), u8(blue));
+    }
+
+    // Converts four pixels at once with the same math as above, returning them as ARGB32 values.
+    template<MatrixCoefficients MC, VideoFullRangeFlag FR>
+    static ALWAYS_INLINE AK::SIMD::u32x4 convert_simple_yuv_to_rgb(AK::SIMD::u16x4 y_in, AK::SIMD::u16x4 u_in, AK::SIMD::u16x4 v_in)
+    {
+        AK::SIMD::i32x4 red;
+        AK::SIMD::i32x4 green;
+        AK::SIMD::i32x4 blue;
+        convert_simple_yuv_to_rgb_components<MC, FR>(AK::SIMD::to_i32x4(y_in), AK::SIMD::to_i32x4(u_in), AK::SIMD::to_i32x4(v_in), red, green, blue);
+        return 0xff000000u | (AK::SIMD::to_u32x4(red) << 16) | (AK::SIMD::to_u32x4(green) << 8) | AK::SIMD::to_u32x4(blue);
+    }
+
+private:
+    // The fixed-point math shared by the scalar and vector conversions above. I is either i32 or AK::SIMD::i32x4.
+    template<MatrixCoefficients MC, VideoFullRangeFlag FR, typename I>
+    static ALWAYS_INLINE void convert_simple_yuv_to_rgb_components(I y_in, I u_in, I v_in, I& red, I& green, I& blue)
     {
         static constexpr i32 bit_depth = 8;
         static constexpr i32 maximum_value = (1 << bit_depth) - 1;
@@ -197,13 +222,9 @@ public:
             return range_factors;
         }();
 
-        i32 y = y_in + range_factors.y_offset;
-        i32 u = u_in + range_factors.uv_offset;
-        i32 v = v_in + range_factors.uv_offset;
-
-        i32 red;
-        i32 green;
-        i32 blue;
+        I y = y_in + range_factors.y_offset;
+        I u = u_in + range_factors.uv_offset;
+        I v = v_in + range_factors.uv_offset;
 
         constexpr i32 y_scale = range_factors.y_scale;
         constexpr i32 uv_scale = range_factors.uv_scale;
@@ -231,19 +252,21 @@ public:
             blue = y * y_scale + u * multiply(coef(94070), uv_scale);
         }
 
-        red = clamp(red, 0, maximum_value * one);
-        green = clamp(green, 0, maximum_value * one);
-        blue = clamp(blue, 0, maximum_value * one);
+        // NOTE: These are written as conditionals rather than clamp() so that they also apply lane-wise to vectors.
+        constexpr i32 max_component = maximum_value * one;
+        red = red < 0 ? 0 : red;
+        red = red > max_component ? max_component : red;
+        green = green < 0 ? 0 : green;
+        green = green > max_component ? max_component : green;
+        blue = blue < 0 ? 0 : blue;
+        blue = blue > max_component ? max_component : blue;
 
         // This compiles down to a bit shift if maximum_value == 255
         red /= fraction(maximum_value, 255);
         green /= fraction(maximum_value, 255);
         blue /= fraction(maximum_value, 255);
-
-        return Gfx::Color(u8(red), u8(green), u8(blue));
     }
 
-private:
     static constexpr size_t to_linear_size = 64;
     static constexpr size_t to_non_linear_size = 64;
 
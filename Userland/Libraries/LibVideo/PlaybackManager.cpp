@@ -133,10 +133,45 @@ void PlaybackManager::dispatch_decoder_error(DecoderError error)
 
 void PlaybackManager::dispatch_new_frame(RefPtr<Gfx::Bitmap> frame)
 {
+    recycle_presented_bitmaps();
+    if (frame != nullptr) {
+        if (m_presented_bitmaps.size() >= maximum_presented_bitmap_count)
+            m_presented_bitmaps.take_first();
+        m_presented_bitmaps.append(*frame);
+    }
+
     if (on_video_frame)
         on_video_frame(move(frame));
 }
 
+void PlaybackManager::recycle_presented_bitmaps()
+{
+    // NOTE: Bitmaps are not atomically reference counted. Every reference to a presented bitmap other than ours
+    //       belongs to a client on this thread, so its reference count can only be inspected safely here. Once
+    //       only we hold on to one, it is handed back to the decoder thread through the mutex-protected pool.
+    Threading::MutexLocker locker(m_bitmap_pool_mutex);
+    m_presented_bitmaps.remove_all_matching([&](auto const& bitmap) {
+        if (bitmap->ref_count() != 1)
+            return false;
+        if (m_bitmap_pool.size() < frame_buffer_count)
+            m_bitmap_pool.append(bitmap);
+        return true;
+    });
+}
+
+DecoderErrorOr<NonnullRefPtr<Gfx::Bitmap>> PlaybackManager::take_bitmap_from_pool(Gfx::IntSize size)
+{
+    {
+        Threading::MutexLocker locker(m_bitmap_pool_mutex);
+        while (!m_bitmap_pool.is_empty()) {
+            auto bitmap = m_bitmap_pool.take_last();
+            if (bitmap->size() == size)
+                return bitmap;
+        }
+    }
+    return DECODER_TRY_ALLOC(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, size));
+}
+
 bool PlaybackManager::dispatch_frame_queue_item(FrameQueueItem&& item)
 {
     if (item.is_error()) {
@@ -258,7 +293,11 @@ void PlaybackManager::decode_and_queue_one_sample()
                 break;
             }
 
-            auto bitmap_result = decoded_frame->to_bitmap();
+            auto bitmap_result = [&]() -> DecoderErrorOr<NonnullRefPtr<Gfx::Bitmap>> {
+                auto bitmap = TRY(take_bitmap_from_pool({ decoded_frame->width(), decoded_frame->height() }));
+                TRY(decoded_frame->output_to_bitmap(bitmap));
+                return bitmap;
+            }();
 
             if (bitmap_result.is_error())
                 item_to_enqueue = FrameQueueItem::error_marker(bitmap_result.release_error(), sample->timestamp());
@@ -168,6 +168,9 @@ private:
 
     void dispatch_decoder_error(DecoderError error);
     void dispatch_new_frame(RefPtr<Gfx::Bitmap> frame);
+    // Must be called on the main thread, see the note in the implementation.
+    void recycle_presented_bitmaps();
+    DecoderErrorOr<NonnullRefPtr<Gfx::Bitmap>> take_bitmap_from_pool(Gfx::IntSize);
     // Returns whether we changed playback states. If so, any PlaybackStateHandler processing must cease.
     [[nodiscard]] bool dispatch_frame_queue_item(FrameQueueItem&&);
     void dispatch_state_change();
@@ -196,6 +199,12 @@ private:
 
     u64 m_skipped_frames { 0 };
 
+    // Bitmaps that have been passed to on_video_frame, which are returned to the pool once no client references them.
+    static constexpr size_t maximum_presented_bitmap_count = frame_buffer_count;
+    Vector<NonnullRefPtr<Gfx::Bitmap>> m_presented_bitmaps;
+    Threading::Mutex m_bitmap_pool_mutex;
+    Vector<NonnullRefPtr<Gfx::Bitmap>> m_bitmap_pool;
+
     // This is a nested class to allow private access.
     class PlaybackStateHandler {
     public:
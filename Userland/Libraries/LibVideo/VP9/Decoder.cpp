@@ -6,6 +6,8 @@
  */
 
 #include <AK/IntegralMath.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
 #include <AK/TypedTransfer.h>
 #include <LibGfx/Size.h>
 #include <LibVideo/Color/CodingIndependentCodePoints.h>
@@ -158,7 +160,7 @@ DecoderErrorOr<void> Decoder::create_video_frame(FrameContext const& frame_conte
         DECODER_TRY_ALLOC(FixedArray<u16>::create(output_uv_size.width() * output_uv_size.height())),
         DECODER_TRY_ALLOC(FixedArray<u16>::create(output_uv_size.width() * output_uv_size.height())),
     };
-    for (u8 plane = 0; plane < 3; plane++) {
+    TRY(m_parser->run_in_parallel(3, [&](u32 plane) -> DecoderErrorOr<void> {
         auto& buffer = output_buffers[plane];
         auto decoded_width = plane == 0 ? decoded_y_width : decoded_uv_width;
         auto output_size = plane == 0 ? output_y_size : output_uv_size;
@@ -170,7 +172,8 @@ DecoderErrorOr<void> Decoder::create_video_frame(FrameContext const& frame_conte
                 decoded_buffer.data() + row * decoded_width,
                 output_size.width() * sizeof(*buffer.data()));
         }
-    }
+        return {};
+    }));
 
     auto frame = DECODER_TRY_ALLOC(adopt_nonnull_own_or_enomem(new (nothrow) SubsampledYUVFrame(
         { output_y_size.width(), output_y_size.height() },
@@ -1279,12 +1282,21 @@ DecoderErrorOr<void> Decoder::reconstruct_templated(u8 plane, BlockContext const
     auto width_in_frame_buffer = min(block_size, frame_size.width() - transform_block_x);
     auto height_in_frame_buffer = min(block_size, frame_size.height() - transform_block_y);
 
+    auto bit_depth = block_context.frame_context.color_config.bit_depth;
+    auto const maximum_sample_value = static_cast<i32>((1u << bit_depth) - 1u);
     for (auto i = 0u; i < height_in_frame_buffer; i++) {
-        for (auto j = 0u; j < width_in_frame_buffer; j++) {
-            auto index = (transform_block_y + i) * frame_size.width() + transform_block_x + j;
-            auto dequantized_value = dequantized[i * block_size + j];
-            current_buffer[index] = clip_1(block_context.frame_context.color_config.bit_depth, current_buffer[index] + dequantized_value);
+        auto* samples = &current_buffer[(transform_block_y + i) * frame_size.width() + transform_block_x];
+        auto const* residuals = &dequantized[i * block_size];
+
+        auto j = 0u;
+        for (; j + 4 <= width_in_frame_buffer; j += 4) {
+            auto values = AK::SIMD::to_i32x4(AK::SIMD::load_unaligned<AK::SIMD::u16x4>(&samples[j])) + AK::SIMD::load_unaligned<AK::SIMD::i32x4>(&residuals[j]);
+            values = values < 0 ? 0 : values;
+            values = values > maximum_sample_value ? maximum_sample_value : values;
+            AK::SIMD::store_unaligned(&samples[j], AK::SIMD::to_u16x4(values));
         }
+        for (; j < width_in_frame_buffer; j++)
+            samples[j] = clip_1(bit_depth, samples[j] + residuals[j]);
     }
 
     return {};
@@ -1823,8 +1835,16 @@ ALWAYS_INLINE DecoderErrorOr<void> Decoder::inverse_transform_2d(BlockContext co
     // 2. The row transforms with i = 0..(n0-1) are applied as follows:
     for (auto i = 0u; i < block_size; i++) {
         // 1. Set T[ j ] equal to Dequant[ i ][ j ] for j = 0..(n0-1).
-        for (auto j = 0u; j < block_size; j++)
+        bool row_is_zero = true;
+        for (auto j = 0u; j < block_size; j++) {
             row[j] = dequantized[i * block_size + j];
+            row_is_zero &= row[j] == 0;
+        }
+
+        // All of the transforms are linear and map zero to zero, including their rounding. Most rows of a
+        // block usually have no coefficients left after quantization, so skip transforming those.
+        if (row_is_zero)
+            continue;
 
         // 2. If Lossless is equal to 1, invoke the Inverse WHT process as specified in section 8.7.1.10 with shift equal
         //    to 2.
@@ -1905,6 +1925,51 @@ ALWAYS_INLINE DecoderErrorOr<void> Decoder::inverse_transform_2d(BlockContext co
     return {};
 }
 
+void Decoder::copy_frame_to_reference_frame_plane(FrameContext const& frame_context, u8 plane, Vector<u16>& frame_store_buffer)
+{
+    // FIXME: Frame width is not equal to the buffer's stride. If we store the stride of the buffer with the reference
+    //        frame, we can just copy the framebuffer data instead. Alternatively, we should crop the output framebuffer.
+    auto width = frame_context.size().width();
+    auto height = frame_context.size().height();
+    auto stride = frame_context.decoded_size(plane > 0).width();
+    if (plane > 0) {
+        width = y_size_to_uv_size(frame_context.color_config.subsampling_x, width);
+        height = y_size_to_uv_size(frame_context.color_config.subsampling_y, height);
+    }
+
+    auto const& original_buffer = get_output_buffer(plane);
+    auto frame_store_width = width + MV_BORDER * 2;
+    auto frame_store_height = height + MV_BORDER * 2;
+    frame_store_buffer.resize_and_keep_capacity(frame_store_width * frame_store_height);
+
+    VERIFY(original_buffer.size() >= width * height);
+    for (auto destination_y = 0u; destination_y < frame_store_height; destination_y++) {
+        // Offset the source row by the motion vector border and then clamp it to the range of 0...height.
+        // This will create an extended border on the top and bottom of the reference frame to avoid having to bounds check
+        // inter-prediction.
+        auto source_y = min(destination_y >= MV_BORDER ? destination_y - MV_BORDER : 0, height - 1);
+        auto const* source = &original_buffer[source_y * stride];
+        auto* destination = &frame_store_buffer[destination_y * frame_store_width + MV_BORDER];
+        AK::TypedTransfer<RemoveReference<decltype(*destination)>>::copy(destination, source, width);
+    }
+
+    for (auto destination_y = 0u; destination_y < frame_store_height; destination_y++) {
+        // Stretch the leftmost samples out into the border.
+        auto sample = frame_store_buffer[destination_y * frame_store_width + MV_BORDER];
+
+        for (auto destination_x = 0u; destination_x < MV_BORDER; destination_x++) {
+            frame_store_buffer[destination_y * frame_store_width + destination_x] = sample;
+        }
+
+        // Stretch the rightmost samples out into the border.
+        sample = frame_store_buffer[destination_y * frame_store_width + MV_BORDER + width - 1];
+
+        for (auto destination_x = MV_BORDER + width; destination_x < frame_store_width; destination_x++) {
+            frame_store_buffer[destination_y * frame_store_width + destination_x] = sample;
+        }
+    }
+}
+
 DecoderErrorOr<void> Decoder::update_reference_frames(FrameContext const& frame_context)
 {
     // This process is invoked as the final step in decoding a frame.
@@ -1914,6 +1979,7 @@ DecoderErrorOr<void> Decoder::update_reference_frames(FrameContext const& frame_
 
     // 1. For each value of i from 0 to NUM_REF_FRAMES - 1, the following applies if bit i of refresh_frame_flags
     // is equal to 1 (i.e. if (refresh_frame_flags>>i)&1 is equal to 1):
+    Optional<u8> first_updated_reference_frame_index;
     for (u8 i = 0; i < NUM_REF_FRAMES; i++) {
         if (frame_context.should_update_reference_frame_at_index(i)) {
             auto& reference_frame = m_parser->m_reference_frames[i];
@@ -1934,50 +2000,24 @@ DecoderErrorOr<void> Decoder::update_reference_frames(FrameContext const& frame_
             // 0..((FrameWidth+subsampling_x) >> subsampling_x)-1, for y = 0..((FrameHeight+subsampling_y) >>
             // subsampling_y)-1.
 
-            // FIXME: Frame width is not equal to the buffer's stride. If we store the stride of the buffer with the reference
-            //        frame, we can just copy the framebuffer data instead. Alternatively, we should crop the output framebuffer.
-            for (auto plane = 0u; plane < 3; plane++) {
-                auto width = frame_context.size().width();
-                auto height = frame_context.size().height();
-                auto stride = frame_context.decoded_size(plane > 0).width();
-                if (plane > 0) {
-                    width = y_size_to_uv_size(frame_context.color_config.subsampling_x, width);
-                    height = y_size_to_uv_size(frame_context.color_config.subsampling_y, height);
-                }
-
-                auto const& original_buffer = get_output_buffer(plane);
-                auto& frame_store_buffer = reference_frame.frame_planes[plane];
-                auto frame_store_width = width + MV_BORDER * 2;
-                auto frame_store_height = height + MV_BORDER * 2;
-                frame_store_buffer.resize_and_keep_capacity(frame_store_width * frame_store_height);
-
-                VERIFY(original_buffer.size() >= width * height);
-                for (auto destination_y = 0u; destination_y < frame_store_height; destination_y++) {
-                    // Offset the source row by the motion vector border and then clamp it to the range of 0...height.
-                    // This will create an extended border on the top and bottom of the reference frame to avoid having to bounds check
-                    // inter-prediction.
-                    auto source_y = min(destination_y >= MV_BORDER ? destination_y - MV_BORDER : 0, height - 1);
-                    auto const* source = &original_buffer[source_y * stride];
-                    auto* destination = &frame_store_buffer[destination_y * frame_store_width + MV_BORDER];
-                    AK::TypedTransfer<RemoveReference<decltype(*destination)>>::copy(destination, source, width);
-                }
-
-                for (auto destination_y = 0u; destination_y < frame_store_height; destination_y++) {
-                    // Stretch the leftmost samples out into the border.
-                    auto sample = frame_store_buffer[destination_y * frame_store_width + MV_BORDER];
-
-                    for (auto destination_x = 0u; destination_x < MV_BORDER; destination_x++) {
-                        frame_store_buffer[destination_y * frame_store_width + destination_x] = sample;
-                    }
-
-                    // Stretch the rightmost samples out into the border.
-                    sample = frame_store_buffer[destination_y * frame_store_width + MV_BORDER + width - 1];
-
-                    for (auto destination_x = MV_BORDER + width; destination_x < frame_store_width; destination_x++) {
-                        frame_store_buffer[destination_y * frame_store_width + destination_x] = sample;
-                    }
+            // Keyframes and golden frames commonly refresh several reference frames at once. All of them receive the same
+            // samples, so the bordered frame store is only built once and then copied over.
+            if (first_updated_reference_frame_index.has_value()) {
+                auto const& first_reference_frame = m_parser->m_reference_frames[first_updated_reference_frame_index.value()];
+                for (auto plane = 0u; plane < 3; plane++) {
+                    auto& frame_store_buffer = reference_frame.frame_planes[plane];
+                    frame_store_buffer.clear_with_capacity();
+                    DECODER_TRY_ALLOC(frame_store_buffer.try_extend(first_reference_frame.frame_planes[plane]));
                 }
+                continue;
             }
+            first_updated_reference_frame_index = i;
+
+            // The planes are independent of each other, so they are copied in parallel.
+            TRY(m_parser->run_in_parallel(3, [&](u32 plane) -> DecoderErrorOr<void> {
+                copy_frame_to_reference_frame_plane(frame_context, plane, reference_frame.frame_planes[plane]);
+                return {};
+            }));
         }
     }
 
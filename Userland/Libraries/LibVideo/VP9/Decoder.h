@@ -139,6 +139,7 @@ private:
 
     /* (8.10) Reference Frame Update Process */
     DecoderErrorOr<void> update_reference_frames(FrameContext const&);
+    void copy_frame_to_reference_frame_plane(FrameContext const&, u8 plane, Vector<u16>& frame_store_buffer);
 
     NonnullOwnPtr<Parser> m_parser;
 
@@ -940,8 +940,27 @@ DecoderErrorOr<void> Parser::decode_tiles(FrameContext& frame_context)
         return {};
     };
 
+    TRY(run_in_parallel(tile_cols, [&](u32 tile_col) {
+        return decode_tile_column(tile_workloads[tile_col]);
+    }));
+
+    // Sum up all tile contexts' syntax element counters after all decodes have finished.
+    for (auto& tile_contexts : tile_workloads) {
+        for (auto& tile_context : tile_contexts) {
+            *frame_context.counter += *tile_context.counter;
+        }
+    }
+
+    return {};
+}
+
+DecoderErrorOr<void> Parser::run_in_parallel(u32 task_count, Function<DecoderErrorOr<void>(u32)> const& task)
+{
+    if (task_count == 0)
+        return {};
+
 #ifdef VP9_TILE_THREADING
-    auto const worker_count = tile_cols - 1;
+    auto const worker_count = task_count - 1;
 
     if (m_worker_threads.size() < worker_count) {
         m_worker_threads.clear();
@@ -951,38 +970,28 @@ DecoderErrorOr<void> Parser::decode_tiles(FrameContext& frame_context)
     }
     VERIFY(m_worker_threads.size() >= worker_count);
 
-    // Start tile column decoding tasks in thread workers starting from the second column.
-    for (auto tile_col = 1u; tile_col < tile_cols; tile_col++) {
-        auto& column_workload = tile_workloads[tile_col];
-        m_worker_threads[tile_col - 1]->start_task([&decode_tile_column, &column_workload]() -> DecoderErrorOr<void> {
-            return decode_tile_column(column_workload);
+    // Start the tasks in thread workers starting from the second one.
+    for (auto index = 1u; index < task_count; index++) {
+        m_worker_threads[index - 1]->start_task([&task, index]() -> DecoderErrorOr<void> {
+            return task(index);
         });
     }
 
-    // Decode the first column in this thread.
-    auto result = decode_tile_column(tile_workloads[0]);
+    // Run the first task in this thread.
+    auto result = task(0);
 
-    for (auto& worker_thread : m_worker_threads) {
-        auto task_result = worker_thread->wait_until_task_is_finished();
+    for (auto i = 0u; i < worker_count; i++) {
+        auto task_result = m_worker_threads[i]->wait_until_task_is_finished();
         if (!result.is_error() && task_result.is_error())
             result = move(task_result);
     }
 
-    if (result.is_error())
-        return result;
+    return result;
 #else
-    for (auto& column_workloads : tile_workloads)
-        TRY(decode_tile_column(column_workloads));
-#endif
-
-    // Sum up all tile contexts' syntax element counters after all decodes have finished.
-    for (auto& tile_contexts : tile_workloads) {
-        for (auto& tile_context : tile_contexts) {
-            *frame_context.counter += *tile_context.counter;
-        }
-    }
-
+    for (auto index = 0u; index < task_count; index++)
+        TRY(task(index));
     return {};
+#endif
 }
 
 DecoderErrorOr<void> Parser::decode_tile(TileContext& tile_context)
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <AK/Array.h>
+#include <AK/Function.h>
 #include <AK/OwnPtr.h>
 #include <AK/Span.h>
 #include <LibGfx/Size.h>
@@ -91,6 +92,8 @@ private:
 
     /* (6.4) Decode Tiles Syntax */
     DecoderErrorOr<void> decode_tiles(FrameContext&);
+    // Runs the task for every index below task_count, each on a separate thread. The first task runs on the calling thread.
+    DecoderErrorOr<void> run_in_parallel(u32 task_count, Function<DecoderErrorOr<void>(u32)> const& task);
     DecoderErrorOr<void> decode_tile(TileContext&);
     void clear_left_context(TileContext&);
     DecoderErrorOr<void> decode_partition(TileContext&, u32 row, u32 column, BlockSubsize subsize);
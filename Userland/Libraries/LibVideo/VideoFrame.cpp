@@ -6,6 +6,7 @@
 
 #include <AK/NonnullOwnPtr.h>
 #include <AK/OwnPtr.h>
+#include <AK/SIMDExtras.h>
 #include <LibVideo/Color/ColorConverter.h>
 
 #include "VideoFrame.h"
@@ -57,8 +58,24 @@ ALWAYS_INLINE void interpolate_row(u32 const row, u32 const width, u16 const* pl
     }
 }
 
-template<u32 subsampling_horizontal, u32 subsampling_vertical, typename Convert>
-ALWAYS_INLINE DecoderErrorOr<void> convert_to_bitmap_subsampled(Convert convert, u32 const width, u32 const height, FixedArray<u16> const& plane_y, FixedArray<u16> const& plane_u, FixedArray<u16> const& plane_v, Gfx::Bitmap& bitmap)
+template<MatrixCoefficients MC, VideoFullRangeFlag FR>
+ALWAYS_INLINE void convert_simple_row(u16 const* y_row, u16 const* u_row, u16 const* v_row, Gfx::ARGB32* scan_line, u32 const width)
+{
+    using namespace AK::SIMD;
+
+    u32 column = 0;
+    for (; column + 4 <= width; column += 4) {
+        auto y = load_unaligned<u16x4>(&y_row[column]);
+        auto u = load_unaligned<u16x4>(&u_row[column]);
+        auto v = load_unaligned<u16x4>(&v_row[column]);
+        store_unaligned(&scan_line[column], ColorConverter::convert_simple_yuv_to_rgb<MC, FR>(y, u, v));
+    }
+    for (; column < width; column++)
+        scan_line[column] = ColorConverter::convert_simple_yuv_to_rgb<MC, FR>(y_row[column], u_row[column], v_row[column]).value();
+}
+
+template<u32 subsampling_horizontal, u32 subsampling_vertical, typename ConvertRow>
+ALWAYS_INLINE DecoderErrorOr<void> convert_to_bitmap_subsampled(ConvertRow convert_row, u32 const width, u32 const height, FixedArray<u16> const& plane_y, FixedArray<u16> const& plane_u, FixedArray<u16> const& plane_v, Gfx::Bitmap& bitmap)
 {
     VERIFY(bitmap.width() >= 0 && static_cast<u32>(bitmap.width()) == width);
     VERIFY(bitmap.height() >= 0 && static_cast<u32>(bitmap.height()) == height);
@@ -98,15 +115,11 @@ ALWAYS_INLINE DecoderErrorOr<void> convert_to_bitmap_subsampled(Convert convert,
         auto const* y_row_a = &plane_y[static_cast<size_t>(row) * width];
         auto* scan_line_a = bitmap.scanline(static_cast<int>(row));
 
-        for (size_t column = 0; column < width; column++) {
-            scan_line_a[column] = convert(y_row_a[column], u_row_a[column], v_row_a[column]).value();
-        }
+        convert_row(y_row_a, u_row_a, v_row_a, scan_line_a, width);
         if constexpr (subsampling_vertical != 0) {
             auto const* y_row_b = &plane_y[static_cast<size_t>(row + 1) * width];
             auto* scan_line_b = bitmap.scanline(static_cast<int>(row + 1));
-            for (size_t column = 0; column < width; column++) {
-                scan_line_b[column] = convert(y_row_b[column], u_row_b[column], v_row_b[column]).value();
-            }
+            convert_row(y_row_b, u_row_b, v_row_b, scan_line_b, width);
         }
 
         AK::TypedTransfer<RemoveReference<decltype(*u_row_a)>>::move(u_row_a, u_row_b, width);
@@ -118,9 +131,7 @@ ALWAYS_INLINE DecoderErrorOr<void> convert_to_bitmap_subsampled(Convert convert,
         if ((height & 1) == 0) {
             auto const* y_row = &plane_y[static_cast<size_t>(height - 1) * width];
             auto* scan_line = bitmap.scanline(static_cast<int>(height - 1));
-            for (size_t column = 0; column < width; column++) {
-                scan_line[column] = convert(y_row[column], u_row_a[column], v_row_a[column]).value();
-            }
+            convert_row(y_row, u_row_a, v_row_a, scan_line, width);
         }
     }
 
@@ -135,19 +146,22 @@ static ALWAYS_INLINE DecoderErrorOr<void> convert_to_bitmap_selecting_converter(
     if (bit_depth == 8 && cicp.transfer_characteristics() == output_cicp.transfer_characteristics() && cicp.color_primaries() == output_cicp.color_primaries() && cicp.video_full_range_flag() == VideoFullRangeFlag::Studio) {
         switch (cicp.matrix_coefficients()) {
         case MatrixCoefficients::BT709:
-            return convert_to_bitmap_subsampled<subsampling_horizontal, subsampling_vertical>([](u16 y, u16 u, u16 v) { return ColorConverter::convert_simple_yuv_to_rgb<MatrixCoefficients::BT709, VideoFullRangeFlag::Studio>(y, u, v); }, width, height, plane_y, plane_u, plane_v, bitmap);
+            return convert_to_bitmap_subsampled<subsampling_horizontal, subsampling_vertical>(convert_simple_row<MatrixCoefficients::BT709, VideoFullRangeFlag::Studio>, width, height, plane_y, plane_u, plane_v, bitmap);
         case MatrixCoefficients::BT601:
-            return convert_to_bitmap_subsampled<subsampling_horizontal, subsampling_vertical>([](u16 y, u16 u, u16 v) { return ColorConverter::convert_simple_yuv_to_rgb<MatrixCoefficients::BT601, VideoFullRangeFlag::Studio>(y, u, v); }, width, height, plane_y, plane_u, plane_v, bitmap);
+            return convert_to_bitmap_subsampled<subsampling_horizontal, subsampling_vertical>(convert_simple_row<MatrixCoefficients::BT601, VideoFullRangeFlag::Studio>, width, height, plane_y, plane_u, plane_v, bitmap);
         case MatrixCoefficients::BT2020ConstantLuminance:
         case MatrixCoefficients::BT2020NonConstantLuminance:
-            return convert_to_bitmap_subsampled<subsampling_horizontal, subsampling_vertical>([](u16 y, u16 u, u16 v) { return ColorConverter::convert_simple_yuv_to_rgb<MatrixCoefficients::BT2020ConstantLuminance, VideoFullRangeFlag::Studio>(y, u, v); }, width, height, plane_y, plane_u, plane_v, bitmap);
+            return convert_to_bitmap_subsampled<subsampling_horizontal, subsampling_vertical>(convert_simple_row<MatrixCoefficients::BT2020ConstantLuminance, VideoFullRangeFlag::Studio>, width, height, plane_y, plane_u, plane_v, bitmap);
         default:
             VERIFY_NOT_REACHED();
         }
     }
 
     auto converter = TRY(ColorConverter::create(bit_depth, cicp, output_cicp));
-    return convert_to_bitmap_subsampled<subsampling_horizontal, subsampling_vertical>([&](u16 y, u16 u, u16 v) { return converter.convert_yuv(y, u, v); }, width, height, plane_y, plane_u, plane_v, bitmap);
+    return convert_to_bitmap_subsampled<subsampling_horizontal, subsampling_vertical>([&](u16 const* y_row, u16 const* u_row, u16 const* v_row, Gfx::ARGB32* scan_line, u32 const width) {
+        for (u32 column = 0; column < width; column++)
+            scan_line[column] = converter.convert_yuv(y_row[column], u_row[column], v_row[column]).value();
+    }, width, height, plane_y, plane_u, plane_v, bitmap);
 }
 
 static DecoderErrorOr<void> convert_to_bitmap_selecting_subsampling(bool subsampling_horizontal, bool subsampling_vertical, CodingIndependentCodePoints cicp, u8 bit_depth, u32 const width, u32 const height, FixedArray<u16> const& plane_y, FixedArray<u16> const& plane_u, FixedArray<u16> const& plane_v, Gfx::Bitmap& bitmap)
@@ -193,21 +193,40 @@ void Device::encode_constant_buffer(Gfx::FloatMatrix4x4 const& matrix, Vector<fl
     }
 }
 
+Device::VertexData Device::to_vertex_data(GPU::Vertex const& vertex)
+{
+    return {
+        vertex.tex_coords[0].x(),
+        vertex.tex_coords[0].y(),
+        vertex.tex_coords[0].z(),
+        vertex.position.x(),
+        vertex.position.y(),
+        vertex.position.z(),
+    };
+}
+
 void Device::draw_primitives(GPU::PrimitiveType primitive_type, Vector<GPU::Vertex>& vertices)
 {
     // Transform incoming vertices to our own format.
     m_vertices.clear_with_capacity();
-    for (auto& vertex : vertices) {
-        m_vertices.append({
-            vertex.tex_coords[0].x(),
-            vertex.tex_coords[0].y(),
-            vertex.tex_coords[0].z(),
-            vertex.position.x(),
-            vertex.position.y(),
-            vertex.position.z(),
-        });
-    }
+    for (auto& vertex : vertices)
+        m_vertices.append(to_vertex_data(vertex));
+
+    draw_vertex_data(primitive_type);
+}
+
+void Device::draw_indexed_primitives(GPU::PrimitiveType primitive_type, Vector<GPU::Vertex>& vertices, Vector<u32> const& indices)
+{
+    // FIXME: Upload the indices to an index buffer instead of expanding them here.
+    m_vertices.clear_with_capacity();
+    for (auto index : indices)
+        m_vertices.append(to_vertex_data(vertices[index]));
 
+    draw_vertex_data(primitive_type);
+}
+
+void Device::draw_vertex_data(GPU::PrimitiveType primitive_type)
+{
     // Compute combined transform matrix
     // Flip the y axis. This is done because OpenGLs coordinate space has a Y-axis of
     // Opposite direction to that of LibGfx
@@ -27,6 +27,7 @@ public:
     virtual GPU::DeviceInfo info() const override;
 
     virtual void draw_primitives(GPU::PrimitiveType, Vector<GPU::Vertex>& vertices) override;
+    virtual void draw_indexed_primitives(GPU::PrimitiveType, Vector<GPU::Vertex>& vertices, Vector<u32> const& indices) override;
     virtual void resize(Gfx::IntSize min_size) override;
     virtual void clear_color(FloatVector4 const&) override;
     virtual void clear_depth(GPU::DepthType) override;
@@ -94,6 +95,9 @@ private:
         float z;
     };
 
+    static VertexData to_vertex_data(GPU::Vertex const&);
+    void draw_vertex_data(GPU::PrimitiveType);
+
     Vector<VertexData> m_vertices;
 
     Vector<float> m_constant_buffer_data;
@@ -9,6 +9,7 @@
 #include <LibWasm/AbstractMachine/Configuration.h>
 #include <LibWasm/AbstractMachine/Interpreter.h>
 #include <LibWasm/AbstractMachine/Validator.h>
+#include <LibWasm/JIT/Compiler.h>
 #include <LibWasm/Types.h>
 
 namespace Wasm {
@@ -120,6 +121,15 @@ DataInstance* Store::get(DataAddress address)
     return &m_datas[value];
 }
 
+JIT::NativeFunction const* WasmFunction::native_function()
+{
+    if (!m_did_try_to_compile_native_function) {
+        m_did_try_to_compile_native_function = true;
+        m_native_function = JIT::Compiler::compile(m_type, m_code, m_module.types());
+    }
+    return m_native_function.ptr();
+}
+
 ErrorOr<void, ValidationError> AbstractMachine::validate(Module& module)
 {
     if (module.validation_status() != Module::ValidationStatus::Unchecked) {
@@ -135,6 +145,10 @@ ErrorOr<void, ValidationError> AbstractMachine::validate(Module& module)
         return result.release_error();
     }
 
+    // NOTE: The validator only knows about real wasm instructions, so this has to wait until it has seen the module.
+    for (auto& function : module.functions())
+        BytecodeInterpreter::fuse_instructions(function.body());
+
     return {};
 }
 
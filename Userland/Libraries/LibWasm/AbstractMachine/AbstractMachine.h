@@ -13,6 +13,7 @@
 #include <AK/Result.h>
 #include <AK/StackInfo.h>
 #include <AK/UFixedBigInt.h>
+#include <LibWasm/JIT/NativeFunction.h>
 #include <LibWasm/Types.h>
 
 // NOTE: Special case for Wasm::Result.
@@ -344,10 +345,15 @@ public:
     auto& module() const { return m_module; }
     auto& code() const { return m_code; }
 
+    // Compiled the first time it's asked for, null if the function can't be compiled.
+    JIT::NativeFunction const* native_function();
+
 private:
     FunctionType m_type;
     ModuleInstance const& m_module;
     Module::Function const& m_code;
+    OwnPtr<JIT::NativeFunction> m_native_function;
+    bool m_did_try_to_compile_native_function { false };
 };
 
 class HostFunction {
@@ -437,6 +443,7 @@ public:
                 return false;
         }
         auto previous_size = m_size;
+        reserve_for_growth(new_size);
         if (m_data.try_resize(new_size).is_error())
             return false;
         m_size = new_size;
@@ -459,6 +466,21 @@ private:
     {
     }
 
+    // NOTE: Memories usually grow a page or so at a time, and every time the data doesn't fit anymore, all of it has to
+    //       be copied. So if there's a maximum, all the space for it is reserved right away (as long as that isn't too
+    //       much), and the data never moves again. Otherwise, ByteBuffer grows its capacity geometrically.
+    void reserve_for_growth(u64 new_size)
+    {
+        if (new_size <= m_data.capacity())
+            return;
+        auto max = m_type.limits().max();
+        if (!max.has_value())
+            return;
+        auto max_size = static_cast<u64>(max.value()) * Constants::page_size;
+        if (max_size <= Constants::max_reserved_memory_size)
+            (void)m_data.try_ensure_capacity(max_size);
+    }
+
     MemoryType m_type;
     size_t m_size { 0 };
     ByteBuffer m_data;
@@ -62,6 +62,112 @@ void BytecodeInterpreter::interpret(Configuration& configuration)
     }
 }
 
+void BytecodeInterpreter::fuse_instructions(Expression& expression)
+{
+    // NOTE: A synthetic instruction takes the place of the first instruction of the sequence it stands for, and skips
+    //       over the rest of it when it's done. The other instructions of the sequence are left where they are, so that
+    //       the instruction pointers in structured instructions and labels stay the same. Branches only ever go to (or
+    //       right past) a structured instruction, and none of the sequences contain one, so nothing can branch into the
+    //       middle of a sequence either.
+    auto& instructions = expression.instructions();
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        auto is = [&](size_t offset, OpCode opcode) {
+            return i + offset < instructions.size() && instructions[i + offset].opcode() == opcode;
+        };
+        auto const& first = instructions[i];
+        auto const& second = i + 1 < instructions.size() ? instructions[i + 1] : first;
+
+        // local.get a, local.get b, i32.add
+        if (is(0, Instructions::local_get) && is(1, Instructions::local_get) && is(2, Instructions::i32_add)) {
+            Instruction::LocalPairArgs args { first.arguments().get<LocalIndex>(), second.arguments().get<LocalIndex>() };
+            instructions[i] = Instruction { Instructions::synthetic_i32_add2local, args };
+            i += 2;
+            continue;
+        }
+
+        // local.get a, i32.const c, i32.add
+        if (is(0, Instructions::local_get) && is(1, Instructions::i32_const) && is(2, Instructions::i32_add)) {
+            Instruction::LocalAndConstArgs args { first.arguments().get<LocalIndex>(), second.arguments().get<i32>() };
+            instructions[i] = Instruction { Instructions::synthetic_i32_addconstlocal, args };
+            i += 2;
+            continue;
+        }
+
+        // local.get a, i32.add
+        if (is(0, Instructions::local_get) && is(1, Instructions::i32_add)) {
+            auto local = first.arguments().get<LocalIndex>();
+            instructions[i] = Instruction { Instructions::synthetic_i32_addlocal, local };
+            i += 1;
+            continue;
+        }
+
+        // i32.const c, local.set a
+        if (is(0, Instructions::i32_const) && is(1, Instructions::local_set)) {
+            Instruction::LocalAndConstArgs args { second.arguments().get<LocalIndex>(), first.arguments().get<i32>() };
+            instructions[i] = Instruction { Instructions::synthetic_local_seti32_const, args };
+            i += 1;
+            continue;
+        }
+
+        // i32.eqz or any other i32 comparison, br_if l
+        if (is(1, Instructions::br_if)) {
+            switch (first.opcode().value()) {
+            case Instructions::i32_eqz.value():
+            case Instructions::i32_eq.value():
+            case Instructions::i32_ne.value():
+            case Instructions::i32_lts.value():
+            case Instructions::i32_ltu.value():
+            case Instructions::i32_gts.value():
+            case Instructions::i32_gtu.value():
+            case Instructions::i32_les.value():
+            case Instructions::i32_leu.value():
+            case Instructions::i32_ges.value():
+            case Instructions::i32_geu.value(): {
+                Instruction::CompareAndBranchArgs args { first.opcode(), second.arguments().get<LabelIndex>() };
+                instructions[i] = Instruction { Instructions::synthetic_br_if_i32_compare, args };
+                i += 1;
+                continue;
+            }
+            default:
+                break;
+            }
+        }
+    }
+}
+
+bool BytecodeInterpreter::pop_and_compare_i32(Configuration& configuration, OpCode comparison)
+{
+    auto rhs = configuration.stack().pop().get<Value>().to<i32>().value();
+    if (comparison == Instructions::i32_eqz)
+        return rhs == 0;
+
+    auto lhs = configuration.stack().pop().get<Value>().to<i32>().value();
+    switch (comparison.value()) {
+    case Instructions::i32_eq.value():
+        return lhs == rhs;
+    case Instructions::i32_ne.value():
+        return lhs != rhs;
+    case Instructions::i32_lts.value():
+        return lhs < rhs;
+    case Instructions::i32_ltu.value():
+        return bit_cast<u32>(lhs) < bit_cast<u32>(rhs);
+    case Instructions::i32_gts.value():
+        return lhs > rhs;
+    case Instructions::i32_gtu.value():
+        return bit_cast<u32>(lhs) > bit_cast<u32>(rhs);
+    case Instructions::i32_les.value():
+        return lhs <= rhs;
+    case Instructions::i32_leu.value():
+        return bit_cast<u32>(lhs) <= bit_cast<u32>(rhs);
+    case Instructions::i32_ges.value():
+        return lhs >= rhs;
+    case Instructions::i32_geu.value():
+        return bit_cast<u32>(lhs) >= bit_cast<u32>(rhs);
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
 void BytecodeInterpreter::branch_to_label(Configuration& configuration, LabelIndex index)
 {
     dbgln_if(WASM_TRACE_DEBUG, "Branch to label with index {}...", index.value());
@@ -102,16 +208,15 @@ void BytecodeInterpreter::load_and_push(Configuration& configuration, Instructio
         return;
     }
     u64 instance_address = static_cast<u64>(bit_cast<u32>(base.value())) + arg.offset;
-    Checked addition { instance_address };
-    addition += sizeof(ReadType);
-    if (addition.has_overflow() || addition.value() > memory->size()) {
+    // NOTE: Both the base and the offset are 32-bit values, so this can't overflow.
+    if (instance_address + sizeof(ReadType) > memory->size()) {
         m_trap = Trap { "Memory access out of bounds" };
         dbgln("LibWasm: Memory access out of bounds (expected {} to be less than or equal to {})", instance_address + sizeof(ReadType), memory->size());
         return;
     }
     dbgln_if(WASM_TRACE_DEBUG, "load({} : {}) -> stack", instance_address, sizeof(ReadType));
-    auto slice = memory->data().bytes().slice(instance_address, sizeof(ReadType));
-    configuration.stack().peek() = Value(static_cast<PushType>(read_value<ReadType>(slice)));
+    auto value = read_value<ReadType>(memory->data().data() + instance_address);
+    configuration.stack().peek() = Value(static_cast<PushType>(value));
 }
 
 template<typename TDst, typename TSrc>
@@ -137,23 +242,22 @@ void BytecodeInterpreter::load_and_push_mxn(Configuration& configuration, Instru
         return;
     }
     u64 instance_address = static_cast<u64>(bit_cast<u32>(base.value())) + arg.offset;
-    Checked addition { instance_address };
-    addition += M * N / 8;
-    if (addition.has_overflow() || addition.value() > memory->size()) {
+    // NOTE: Both the base and the offset are 32-bit values, so this can't overflow.
+    if (instance_address + M * N / 8 > memory->size()) {
         m_trap = Trap { "Memory access out of bounds" };
         dbgln("LibWasm: Memory access out of bounds (expected {} to be less than or equal to {})", instance_address + M * N / 8, memory->size());
         return;
     }
     dbgln_if(WASM_TRACE_DEBUG, "vec-load({} : {}) -> stack", instance_address, M * N / 8);
-    auto slice = memory->data().bytes().slice(instance_address, M * N / 8);
+    auto const* data = memory->data().data() + instance_address;
     using V64 = NativeVectorType<M, N, SetSign>;
     using V128 = NativeVectorType<M * 2, N, SetSign>;
 
     V64 bytes { 0 };
-    if (bit_cast<FlatPtr>(slice.data()) % sizeof(V64) == 0)
-        bytes = *bit_cast<V64*>(slice.data());
+    if (bit_cast<FlatPtr>(data) % sizeof(V64) == 0)
+        bytes = *bit_cast<V64 const*>(data);
     else
-        ByteReader::load(slice.data(), bytes);
+        ByteReader::load(data, bytes);
 
     configuration.stack().peek() = Value(bit_cast<u128>(convert_vector<V128>(bytes)));
 }
@@ -175,16 +279,14 @@ void BytecodeInterpreter::load_and_push_m_splat(Configuration& configuration, In
         return;
     }
     u64 instance_address = static_cast<u64>(bit_cast<u32>(base.value())) + arg.offset;
-    Checked addition { instance_address };
-    addition += M / 8;
-    if (addition.has_overflow() || addition.value() > memory->size()) {
+    // NOTE: Both the base and the offset are 32-bit values, so this can't overflow.
+    if (instance_address + M / 8 > memory->size()) {
         m_trap = Trap { "Memory access out of bounds" };
         dbgln("LibWasm: Memory access out of bounds (expected {} to be less than or equal to {})", instance_address + M / 8, memory->size());
         return;
     }
     dbgln_if(WASM_TRACE_DEBUG, "vec-splat({} : {}) -> stack", instance_address, M / 8);
-    auto slice = memory->data().bytes().slice(instance_address, M / 8);
-    auto value = read_value<NativeIntegralType<M>>(slice);
+    auto value = read_value<NativeIntegralType<M>>(memory->data().data() + instance_address);
     set_top_m_splat<M, NativeIntegralType>(configuration, value);
 }
 
@@ -388,49 +490,35 @@ void BytecodeInterpreter::store_to_memory(Configuration& configuration, Instruct
     auto& address = configuration.frame().module().memories()[arg.memory_index.value()];
     auto memory = configuration.store().get(address);
     u64 instance_address = static_cast<u64>(bit_cast<u32>(base)) + arg.offset;
-    Checked addition { instance_address };
-    addition += data.size();
-    if (addition.has_overflow() || addition.value() > memory->size()) {
+    // NOTE: Both the base and the offset are 32-bit values, so this can't overflow.
+    if (instance_address + data.size() > memory->size()) {
         m_trap = Trap { "Memory access out of bounds" };
         dbgln("LibWasm: Memory access out of bounds (expected 0 <= {} and {} <= {})", instance_address, instance_address + data.size(), memory->size());
         return;
     }
     dbgln_if(WASM_TRACE_DEBUG, "temporary({}b) -> store({})", data.size(), instance_address);
-    data.copy_to(memory->data().bytes().slice(instance_address, data.size()));
+    __builtin_memcpy(memory->data().data() + instance_address, data.data(), data.size());
 }
 
+// NOTE: The caller has already made sure that the whole value is in bounds.
 template<typename T>
-T BytecodeInterpreter::read_value(ReadonlyBytes data)
+T BytecodeInterpreter::read_value(u8 const* data)
 {
-    FixedMemoryStream stream { data };
-    auto value_or_error = stream.read_value<LittleEndian<T>>();
-    if (value_or_error.is_error()) {
-        dbgln("Read from {} failed", data.data());
-        m_trap = Trap { "Read from memory failed" };
-    }
-    return value_or_error.release_value();
+    T value;
+    ByteReader::load(data, value);
+    return AK::convert_between_host_and_little_endian(value);
 }
 
 template<>
-float BytecodeInterpreter::read_value<float>(ReadonlyBytes data)
+float BytecodeInterpreter::read_value<float>(u8 const* data)
 {
-    FixedMemoryStream stream { data };
-    auto raw_value_or_error = stream.read_value<LittleEndian<u32>>();
-    if (raw_value_or_error.is_error())
-        m_trap = Trap { "Read from memory failed" };
-    auto raw_value = raw_value_or_error.release_value();
-    return bit_cast<float>(static_cast<u32>(raw_value));
+    return bit_cast<float>(read_value<u32>(data));
 }
 
 template<>
-double BytecodeInterpreter::read_value<double>(ReadonlyBytes data)
+double BytecodeInterpreter::read_value<double>(u8 const* data)
 {
-    FixedMemoryStream stream { data };
-    auto raw_value_or_error = stream.read_value<LittleEndian<u64>>();
-    if (raw_value_or_error.is_error())
-        m_trap = Trap { "Read from memory failed" };
-    auto raw_value = raw_value_or_error.release_value();
-    return bit_cast<double>(static_cast<u64>(raw_value));
+    return bit_cast<double>(read_value<u64>(data));
 }
 
 template<typename V, typename T>
@@ -514,6 +602,44 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
     case Instructions::i32_const.value():
         configuration.stack().push(Value(ValueType { ValueType::I32 }, static_cast<i64>(instruction.arguments().get<i32>())));
         return;
+    case Instructions::synthetic_i32_add2local.value(): {
+        auto& args = instruction.arguments().get<Instruction::LocalPairArgs>();
+        auto& locals = configuration.frame().locals();
+        auto lhs = locals[args.lhs.value()].to<u32>().value();
+        auto rhs = locals[args.rhs.value()].to<u32>().value();
+        configuration.stack().push(Value(static_cast<i32>(lhs + rhs)));
+        ip = ip.value() + 3;
+        return;
+    }
+    case Instructions::synthetic_i32_addconstlocal.value(): {
+        auto& args = instruction.arguments().get<Instruction::LocalAndConstArgs>();
+        auto lhs = configuration.frame().locals()[args.local.value()].to<u32>().value();
+        configuration.stack().push(Value(static_cast<i32>(lhs + bit_cast<u32>(args.value))));
+        ip = ip.value() + 3;
+        return;
+    }
+    case Instructions::synthetic_i32_addlocal.value(): {
+        auto& entry = configuration.stack().peek();
+        auto lhs = entry.get<Value>().to<u32>().value();
+        auto rhs = configuration.frame().locals()[instruction.arguments().get<LocalIndex>().value()].to<u32>().value();
+        entry = Value(static_cast<i32>(lhs + rhs));
+        ip = ip.value() + 2;
+        return;
+    }
+    case Instructions::synthetic_local_seti32_const.value(): {
+        auto& args = instruction.arguments().get<Instruction::LocalAndConstArgs>();
+        configuration.frame().locals()[args.local.value()] = Value(args.value);
+        ip = ip.value() + 2;
+        return;
+    }
+    case Instructions::synthetic_br_if_i32_compare.value(): {
+        auto& args = instruction.arguments().get<Instruction::CompareAndBranchArgs>();
+        if (!pop_and_compare_i32(configuration, args.comparison)) {
+            ip = ip.value() + 2;
+            return;
+        }
+        return branch_to_label(configuration, args.label);
+    }
     case Instructions::i64_const.value():
         configuration.stack().push(Value(ValueType { ValueType::I64 }, instruction.arguments().get<i64>()));
         return;
@@ -776,19 +902,12 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         auto value = configuration.stack().pop().get<Value>().to<i32>().value();
         auto destination_offset = configuration.stack().pop().get<Value>().to<i32>().value();
 
-        TRAP_IF_NOT(static_cast<size_t>(destination_offset + count) <= instance->data().size());
-
-        if (count == 0)
-            return;
+        // NOTE: The offset and the count are both 32-bit values, so this can't overflow.
+        auto destination = static_cast<u64>(bit_cast<u32>(destination_offset));
+        auto size = static_cast<u64>(bit_cast<u32>(count));
+        TRAP_IF_NOT(destination + size <= instance->size());
 
-        Instruction synthetic_store_instruction {
-            Instructions::i32_store8,
-            Instruction::MemoryArgument { 0, 0 }
-        };
-
-        for (auto i = 0; i < count; ++i) {
-            store_to_memory(configuration, synthetic_store_instruction, { &value, sizeof(value) }, destination_offset);
-        }
+        __builtin_memset(instance->data().data() + destination, static_cast<u8>(value), size);
         return;
     }
     // https://webassembly.github.io/spec/core/bikeshed/#exec-memory-copy
@@ -803,29 +922,14 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         auto source_offset = configuration.stack().pop().get<Value>().to<i32>().value();
         auto destination_offset = configuration.stack().pop().get<Value>().to<i32>().value();
 
-        TRAP_IF_NOT(static_cast<size_t>(source_offset + count) <= source_instance->data().size());
-        TRAP_IF_NOT(static_cast<size_t>(destination_offset + count) <= destination_instance->data().size());
-
-        if (count == 0)
-            return;
-
-        Instruction synthetic_store_instruction {
-            Instructions::i32_store8,
-            Instruction::MemoryArgument { 0, 0, args.dst_index }
-        };
-
-        if (destination_offset <= source_offset) {
-            for (auto i = 0; i < count; ++i) {
-                auto value = source_instance->data()[source_offset + i];
-                store_to_memory(configuration, synthetic_store_instruction, { &value, sizeof(value) }, destination_offset + i);
-            }
-        } else {
-            for (auto i = count - 1; i >= 0; --i) {
-                auto value = source_instance->data()[source_offset + i];
-                store_to_memory(configuration, synthetic_store_instruction, { &value, sizeof(value) }, destination_offset + i);
-            }
-        }
+        auto source = static_cast<u64>(bit_cast<u32>(source_offset));
+        auto destination = static_cast<u64>(bit_cast<u32>(destination_offset));
+        auto size = static_cast<u64>(bit_cast<u32>(count));
+        TRAP_IF_NOT(source + size <= source_instance->size());
+        TRAP_IF_NOT(destination + size <= destination_instance->size());
 
+        // NOTE: The ranges may overlap if both are in the same memory.
+        __builtin_memmove(destination_instance->data().data() + destination, source_instance->data().data() + source, size);
         return;
     }
     // https://webassembly.github.io/spec/core/bikeshed/#exec-memory-init
@@ -837,19 +941,19 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         auto source_offset = *configuration.stack().pop().get<Value>().to<i32>();
         auto destination_offset = *configuration.stack().pop().get<Value>().to<i32>();
 
-        TRAP_IF_NOT(count > 0);
-        TRAP_IF_NOT(source_offset + count > 0);
-        TRAP_IF_NOT(static_cast<size_t>(source_offset + count) <= data.size());
+        auto memory_address = configuration.frame().module().memories()[args.memory_index.value()];
+        auto memory = configuration.store().get(memory_address);
+        auto source = static_cast<u64>(bit_cast<u32>(source_offset));
+        auto destination = static_cast<u64>(bit_cast<u32>(destination_offset));
+        auto size = static_cast<u64>(bit_cast<u32>(count));
+        TRAP_IF_NOT(source + size <= data.size());
+        TRAP_IF_NOT(destination + size <= memory->size());
 
-        Instruction synthetic_store_instruction {
-            Instructions::i32_store8,
-            Instruction::MemoryArgument { 0, 0, args.memory_index }
-        };
+        // NOTE: A dropped data segment has no data at all.
+        if (size == 0)
+            return;
 
-        for (size_t i = 0; i < (size_t)count; ++i) {
-            auto value = data.data()[source_offset + i];
-            store_to_memory(configuration, synthetic_store_instruction, { &value, sizeof(value) }, destination_offset + i);
-        }
+        __builtin_memcpy(memory->data().data() + destination, data.data().data() + source, size);
         return;
     }
     // https://webassembly.github.io/spec/core/bikeshed/#exec-data-drop
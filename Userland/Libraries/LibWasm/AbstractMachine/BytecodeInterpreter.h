@@ -29,6 +29,11 @@ struct BytecodeInterpreter : public Interpreter {
             [](JS::Completion const& completion) { return completion.value()->to_string_without_side_effects().to_byte_string(); });
     }
     virtual void clear_trap() override { m_trap = Empty {}; }
+    virtual bool can_run_native_code() const override { return true; }
+
+    // Replaces common sequences of instructions in a validated function body with synthetic instructions that do the
+    // same thing in a single step.
+    static void fuse_instructions(Expression&);
 
     struct CallFrameHandle {
         explicit CallFrameHandle(BytecodeInterpreter& interpreter, Configuration& configuration)
@@ -46,6 +51,7 @@ struct BytecodeInterpreter : public Interpreter {
 protected:
     virtual void interpret(Configuration&, InstructionPointer&, Instruction const&);
     void branch_to_label(Configuration&, LabelIndex);
+    static bool pop_and_compare_i32(Configuration&, OpCode comparison);
     template<typename ReadT, typename PushT>
     void load_and_push(Configuration&, Instruction const&);
     template<typename PopT, typename StoreT>
@@ -78,7 +84,7 @@ protected:
     MakeSigned<T> checked_signed_truncate(V);
 
     template<typename T>
-    T read_value(ReadonlyBytes data);
+    T read_value(u8 const* data);
 
     Vector<Value> pop_values(Configuration& configuration, size_t count);
     ALWAYS_INLINE bool trap_if_not(bool value, StringView reason)
@@ -99,6 +105,9 @@ struct DebuggerBytecodeInterpreter : public BytecodeInterpreter {
     }
     virtual ~DebuggerBytecodeInterpreter() override = default;
 
+    // NOTE: The hooks have to see every instruction, so everything runs in the interpreter.
+    virtual bool can_run_native_code() const override { return false; }
+
     Function<bool(Configuration&, InstructionPointer&, Instruction const&)> pre_interpret_hook;
     Function<bool(Configuration&, InstructionPointer&, Instruction const&, Interpreter const&)> post_interpret_hook;
 
@@ -43,6 +43,11 @@ Result Configuration::call(Interpreter& interpreter, FunctionAddress address, Ve
     if (!function)
         return Trap {};
     if (auto* wasm_function = function->get_pointer<WasmFunction>()) {
+        if (interpreter.can_run_native_code()) {
+            if (auto const* native_function = wasm_function->native_function())
+                return call_native_function(*wasm_function, *native_function, move(arguments));
+        }
+
         Vector<Value> locals = move(arguments);
         locals.ensure_capacity(locals.size() + wasm_function->code().locals().size());
         for (auto& type : wasm_function->code().locals())
@@ -63,6 +68,32 @@ Result Configuration::call(Interpreter& interpreter, FunctionAddress address, Ve
     return host_function.function()(*this, arguments);
 }
 
+Result Configuration::call_native_function(WasmFunction const& function, JIT::NativeFunction const& native_function, Vector<Value> arguments)
+{
+    // The locals come first, followed by the operand stack, which is where the results end up.
+    Vector<u64> slots;
+    slots.resize(native_function.slot_count());
+    for (size_t i = 0; i < arguments.size(); ++i)
+        slots[i] = bit_cast<u64>(arguments[i].to<i64>().value());
+
+    Bytes memory;
+    if (!function.module().memories().is_empty())
+        memory = m_store.get(function.module().memories().first())->data().bytes();
+
+    auto instruction_budget = m_should_limit_instruction_count ? Constants::max_allowed_executed_instructions_per_call : NumericLimits<u64>::max();
+    auto status = native_function.run(slots, memory, instruction_budget);
+    if (status != JIT::NativeFunction::Status::Returned)
+        return Trap { ByteString(JIT::NativeFunction::trap_reason(status)) };
+
+    // NOTE: Results are returned in reverse order, just like the ones that come off the stack in execute().
+    auto const& result_types = function.type().results();
+    Vector<Value> results;
+    results.ensure_capacity(result_types.size());
+    for (size_t i = result_types.size(); i > 0; --i)
+        results.append(Value(result_types[i - 1], slots[native_function.local_count() + i - 1]));
+    return Result { move(results) };
+}
+
 Result Configuration::execute(Interpreter& interpreter)
 {
     interpreter.interpret(*this);
@@ -74,6 +74,8 @@ public:
     void dump_stack();
 
 private:
+    Result call_native_function(WasmFunction const&, JIT::NativeFunction const&, Vector<Value> arguments);
+
     Store& m_store;
     size_t m_current_frame_index { 0 };
     Stack m_stack;
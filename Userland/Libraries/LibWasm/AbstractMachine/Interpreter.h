@@ -16,6 +16,7 @@ struct Interpreter {
     virtual bool did_trap() const = 0;
     virtual ByteString trap_reason() const = 0;
     virtual void clear_trap() = 0;
+    virtual bool can_run_native_code() const { return false; }
 };
 
 }
@@ -9,8 +9,10 @@
 #include <AK/SourceLocation.h>
 #include <AK/TemporaryChange.h>
 #include <AK/Try.h>
+#include <LibThreading/Parallel.h>
 #include <LibWasm/AbstractMachine/Validator.h>
 #include <LibWasm/Printer/Printer.h>
+#include <LibWasm/TaskPool.h>
 
 namespace Wasm {
 
@@ -256,30 +258,92 @@ ErrorOr<void, ValidationError> Validator::validate(TableSection const& section)
 
 ErrorOr<void, ValidationError> Validator::validate(CodeSection const& section)
 {
-    size_t index = m_context.imported_function_count;
-    for (auto& entry : section.functions()) {
-        auto function_index = index++;
-        TRY(validate(FunctionIndex { function_index }));
-        auto& function_type = m_context.functions[function_index];
-        auto& function = entry.func();
-
-        auto function_validator = fork();
-        function_validator.m_context.locals = {};
-        function_validator.m_context.locals.extend(function_type.parameters());
-        for (auto& local : function.locals()) {
-            for (size_t i = 0; i < local.n(); ++i)
-                function_validator.m_context.locals.append(local.type());
-        }
+    auto& functions = section.functions();
+    if (functions.size() < Constants::min_function_count_for_parallel_processing) {
+        for (size_t i = 0; i < functions.size(); ++i)
+            TRY(validate_function(m_context.imported_function_count + i, functions[i]));
+        return {};
+    }
+
+    // NOTE: The vectors in a context share their storage, and the reference counts of that aren't atomic.
+    //       So every chunk of functions gets its own validator with a copy of the context that shares nothing.
+    auto chunk_size = ceil_div(functions.size(), (task_pool().concurrency() + 1) * 4);
+    auto chunk_count = ceil_div(functions.size(), chunk_size);
+    Vector<Context> chunk_contexts;
+    chunk_contexts.ensure_capacity(chunk_count);
+    for (size_t i = 0; i < chunk_count; ++i)
+        chunk_contexts.unchecked_append(isolated_copy(m_context));
+
+    Vector<Optional<ValidationError>> chunk_errors;
+    chunk_errors.resize(chunk_count);
+    Threading::parallel_for(
+        task_pool(), chunk_count, [&](size_t chunk_index) {
+            Validator validator { move(chunk_contexts[chunk_index]) };
+            auto start = chunk_index * chunk_size;
+            auto end = min(start + chunk_size, functions.size());
+            for (auto i = start; i < end; ++i) {
+                auto result = validator.validate_function(m_context.imported_function_count + i, functions[i]);
+                if (result.is_error()) {
+                    chunk_errors[chunk_index] = result.release_error();
+                    return;
+                }
+            }
+        },
+        1);
+
+    // Report the same error that validating the functions one after another would have.
+    for (auto& error : chunk_errors) {
+        if (error.has_value())
+            return error.release_value();
+    }
+    return {};
+}
 
-        function_validator.m_context.labels = { ResultType { function_type.results() } };
-        function_validator.m_context.return_ = ResultType { function_type.results() };
+ErrorOr<void, ValidationError> Validator::validate_function(size_t function_index, CodeSection::Code const& entry)
+{
+    TRY(validate(FunctionIndex { function_index }));
+    auto& function_type = m_context.functions[function_index];
+    auto& function = entry.func();
 
-        TRY(function_validator.validate(function.body(), function_type.results()));
+    auto function_validator = fork();
+    function_validator.m_context.locals = {};
+    function_validator.m_context.locals.extend(function_type.parameters());
+    for (auto& local : function.locals()) {
+        for (size_t i = 0; i < local.n(); ++i)
+            function_validator.m_context.locals.append(local.type());
     }
 
+    function_validator.m_context.labels = { ResultType { function_type.results() } };
+    function_validator.m_context.return_ = ResultType { function_type.results() };
+
+    TRY(function_validator.validate(function.body(), function_type.results()));
     return {};
 }
 
+Context Validator::isolated_copy(Context const& context)
+{
+    auto copy_of = [](auto const& vector) {
+        RemoveCVReference<decltype(vector)> copy;
+        copy.extend(vector);
+        return copy;
+    };
+
+    return Context {
+        .types = copy_of(context.types),
+        .functions = copy_of(context.functions),
+        .tables = copy_of(context.tables),
+        .memories = copy_of(context.memories),
+        .globals = copy_of(context.globals),
+        .elements = copy_of(context.elements),
+        .datas = copy_of(context.datas),
+        .locals = copy_of(context.locals),
+        .labels = copy_of(context.labels),
+        .return_ = context.return_,
+        .references = context.references,
+        .imported_function_count = context.imported_function_count,
+    };
+}
+
 ErrorOr<void, ValidationError> Validator::validate(TableType const& type)
 {
     return validate(type.limits(), 32);
@@ -267,6 +267,11 @@ private:
     {
     }
 
+    ErrorOr<void, ValidationError> validate_function(size_t function_index, CodeSection::Code const&);
+
+    // A copy of the context that no other one shares any storage with, so it can be used on another thread.
+    static Context isolated_copy(Context const&);
+
     struct Errors {
         static ValidationError invalid(StringView name) { return ByteString::formatted("Invalid {}", name); }
 
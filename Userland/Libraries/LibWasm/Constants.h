@@ -43,5 +43,7 @@ static constexpr auto minimum_stack_space_to_keep_free = 256 * KiB; // Note: Val
 static constexpr auto max_allowed_executed_instructions_per_call = 256 * 1024 * 1024;
 static constexpr auto max_allowed_vector_size = 500 * MiB;
 static constexpr auto max_allowed_function_locals_per_type = 42069; // Note: VERY arbitrary.
+static constexpr auto max_reserved_memory_size = 256 * MiB;
+static constexpr auto min_function_count_for_parallel_processing = 64; // Note: Below this, handing out the work costs more than it saves.
 
 }
@@ -0,0 +1,826 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibWasm/JIT/Compiler.h>
+#include <LibWasm/Opcode.h>
+#include <LibWasm/Printer/Printer.h>
+
+namespace Wasm::JIT {
+
+#ifdef JIT_ARCH_SUPPORTED
+
+using Assembler = ::JIT::Assembler;
+using Reg = Assembler::Reg;
+using Condition = Assembler::Condition;
+using Extension = Assembler::Extension;
+
+static Assembler::Operand reg(Reg reg) { return Assembler::Operand::Register(reg); }
+static Assembler::Operand imm(u64 value) { return Assembler::Operand::Imm(value); }
+static Assembler::Operand mem(Reg base, u64 offset = 0) { return Assembler::Operand::Mem64BaseAndOffset(base, offset); }
+
+static constexpr auto GPR0 = Reg::RAX;
+static constexpr auto GPR1 = Reg::RDX;
+// Shifts take their count in CL, so this is also where that goes.
+static constexpr auto SCRATCH = Reg::RCX;
+static constexpr auto RETURN_VALUE = Reg::RAX;
+
+static constexpr auto ARG0 = Reg::RDI;
+static constexpr auto ARG1 = Reg::RSI;
+static constexpr auto ARG2 = Reg::RDX;
+static constexpr auto ARG3 = Reg::RCX;
+
+// NOTE: R12 and R13 can't be the base of a memory operand without a SIB byte or a displacement, which the assembler
+//       doesn't do, so they aren't used for anything that is.
+static constexpr auto SLOTS = Reg::RBX;
+static constexpr auto MEMORY_BASE = Reg::R14;
+static constexpr auto MEMORY_SIZE = Reg::R15;
+static constexpr auto INSTRUCTION_BUDGET = Reg::R12;
+
+// Slots are addressed with a 32-bit displacement.
+static constexpr size_t max_slot_count = NumericLimits<i32>::max() / sizeof(u64);
+
+static constexpr Condition invert(Condition condition)
+{
+    return static_cast<Condition>(to_underlying(condition) ^ 1);
+}
+
+static bool is_supported_type(ValueType const& type)
+{
+    return type.kind() == ValueType::I32 || type.kind() == ValueType::I64;
+}
+
+OwnPtr<NativeFunction> Compiler::compile(FunctionType const& type, Module::Function const& function, Span<FunctionType const> module_types)
+{
+    Compiler compiler { type, function, module_types };
+    return compiler.compile_function();
+}
+
+OwnPtr<NativeFunction> Compiler::compile_function()
+{
+    for (auto const& type : m_type.parameters()) {
+        if (!is_supported_type(type))
+            return nullptr;
+    }
+    for (auto const& type : m_type.results()) {
+        if (!is_supported_type(type))
+            return nullptr;
+    }
+    for (auto const& type : m_function.locals()) {
+        if (!is_supported_type(type))
+            return nullptr;
+    }
+    m_local_count = m_type.parameters().size() + m_function.locals().size();
+
+    compile_entry();
+
+    m_control_frames.append({ .kind = ControlFrame::Kind::Block, .result_count = m_type.results().size() });
+
+    auto const& instructions = m_function.body().instructions();
+    for (m_instruction_index = 0; m_instruction_index < instructions.size(); ++m_instruction_index) {
+        auto const& instruction = instructions[m_instruction_index];
+        auto compiled = m_is_unreachable ? compile_unreachable_instruction(instruction) : compile_instruction(instruction);
+        if (!compiled) {
+            dbgln_if(WASM_JIT_DEBUG, "Wasm JIT: Can't compile {} at ip {}", instruction_name(instruction.opcode()), m_instruction_index);
+            return nullptr;
+        }
+    }
+
+    // NOTE: Falling off the end of the body is a branch to the function's own frame, but its results are already where
+    //       they need to be.
+    VERIFY(m_control_frames.size() == 1);
+    m_control_frames.first().label.link(m_assembler);
+    compile_exits();
+
+    auto slot_count = m_local_count + max(m_max_height, m_type.results().size());
+    if (slot_count > max_slot_count)
+        return nullptr;
+
+    dbgln_if(WASM_JIT_DEBUG, "Wasm JIT: Compiled {} instructions to {} bytes of native code", instructions.size(), m_output.size());
+    return NativeFunction::create(m_output, m_local_count, slot_count);
+}
+
+void Compiler::compile_entry()
+{
+    // u64 entry(u64* slots, u8* memory, u64 memory_size, u64 instruction_budget)
+    m_assembler.enter();
+    m_assembler.mov(reg(SLOTS), reg(ARG0));
+    m_assembler.mov(reg(MEMORY_BASE), reg(ARG1));
+    m_assembler.mov(reg(MEMORY_SIZE), reg(ARG2));
+    m_assembler.mov(reg(INSTRUCTION_BUDGET), reg(ARG3));
+}
+
+void Compiler::compile_exits()
+{
+    auto exit_with = [&](NativeFunction::Status status) {
+        m_assembler.mov(reg(RETURN_VALUE), imm(to_underlying(status)));
+        m_assembler.exit();
+    };
+
+    exit_with(NativeFunction::Status::Returned);
+
+    m_unreachable_trap_label.link(m_assembler);
+    exit_with(NativeFunction::Status::Unreachable);
+
+    m_out_of_bounds_trap_label.link(m_assembler);
+    exit_with(NativeFunction::Status::MemoryAccessOutOfBounds);
+
+    m_instruction_limit_trap_label.link(m_assembler);
+    exit_with(NativeFunction::Status::ExceededInstructionLimit);
+}
+
+Assembler::Operand Compiler::local(LocalIndex index) const
+{
+    return mem(SLOTS, index.value() * sizeof(u64));
+}
+
+Assembler::Operand Compiler::stack_slot(size_t height) const
+{
+    return mem(SLOTS, (m_local_count + height) * sizeof(u64));
+}
+
+Assembler::Operand Compiler::push()
+{
+    auto slot = stack_slot(m_height++);
+    m_max_height = max(m_max_height, m_height);
+    return slot;
+}
+
+Assembler::Operand Compiler::pop()
+{
+    VERIFY(m_height > 0);
+    return stack_slot(--m_height);
+}
+
+Assembler::Operand Compiler::top() const
+{
+    VERIFY(m_height > 0);
+    return stack_slot(m_height - 1);
+}
+
+bool Compiler::resolve_block_type(BlockType const& block_type, size_t& parameter_count, size_t& result_count) const
+{
+    switch (block_type.kind()) {
+    case BlockType::Empty:
+        parameter_count = 0;
+        result_count = 0;
+        return true;
+    case BlockType::Type:
+        parameter_count = 0;
+        result_count = 1;
+        return is_supported_type(block_type.value_type());
+    case BlockType::Index: {
+        auto const& type = m_module_types[block_type.type_index().value()];
+        for (auto const& parameter : type.parameters()) {
+            if (!is_supported_type(parameter))
+                return false;
+        }
+        for (auto const& result : type.results()) {
+            if (!is_supported_type(result))
+                return false;
+        }
+        parameter_count = type.parameters().size();
+        result_count = type.results().size();
+        return true;
+    }
+    }
+    VERIFY_NOT_REACHED();
+}
+
+Compiler::ControlFrame& Compiler::frame_for(LabelIndex index)
+{
+    VERIFY(index.value() < m_control_frames.size());
+    return m_control_frames[m_control_frames.size() - 1 - index.value()];
+}
+
+bool Compiler::branch_needs_copy(ControlFrame const& frame) const
+{
+    auto arity = frame.branch_arity();
+    return arity > 0 && m_height - arity != frame.base_height;
+}
+
+void Compiler::copy_branch_results(ControlFrame const& frame)
+{
+    // NOTE: The results always move down the stack, so copying them from the bottom up never overwrites one that's
+    //       still needed.
+    auto arity = frame.branch_arity();
+    for (size_t i = 0; i < arity; ++i) {
+        m_assembler.mov(reg(SCRATCH), stack_slot(m_height - arity + i));
+        m_assembler.mov(stack_slot(frame.base_height + i), reg(SCRATCH));
+    }
+}
+
+bool Compiler::compile_block(ControlFrame::Kind kind, Instruction::StructuredInstructionArgs const& arguments)
+{
+    ControlFrame frame { .kind = kind };
+    if (!resolve_block_type(arguments.block_type, frame.parameter_count, frame.result_count))
+        return false;
+
+    if (kind == ControlFrame::Kind::If) {
+        // NOTE: Both arms of an `if` would need their own copy of its parameters.
+        if (frame.parameter_count > 0)
+            return false;
+        m_assembler.mov32(reg(GPR0), pop());
+        m_assembler.jump_if(reg(GPR0), Condition::EqualTo, imm(0), frame.else_label);
+    }
+
+    frame.base_height = m_height - frame.parameter_count;
+    m_control_frames.append(move(frame));
+
+    if (kind == ControlFrame::Kind::Loop) {
+        m_control_frames.last().label.link(m_assembler);
+
+        // NOTE: Straight-line code always runs out at some point, so only loops have to pay for what they execute.
+        //       The whole body is paid for up front, whether or not all of it runs.
+        auto cost = min(arguments.end_ip.value() - m_instruction_index, static_cast<size_t>(NumericLimits<i32>::max()));
+        m_assembler.sub(reg(INSTRUCTION_BUDGET), imm(cost));
+        m_assembler.jump_if(Condition::UnsignedLessThan, m_instruction_limit_trap_label);
+    }
+    return true;
+}
+
+void Compiler::compile_else()
+{
+    auto& frame = m_control_frames.last();
+    VERIFY(frame.kind == ControlFrame::Kind::If);
+    if (!m_is_unreachable)
+        m_assembler.jump(frame.label);
+    frame.else_label.link(m_assembler);
+    frame.has_else = true;
+    m_height = frame.base_height + frame.parameter_count;
+    m_is_unreachable = false;
+}
+
+void Compiler::compile_end()
+{
+    VERIFY(m_control_frames.size() > 1);
+    auto frame = m_control_frames.take_last();
+    if (frame.kind == ControlFrame::Kind::If && !frame.has_else)
+        frame.else_label.link(m_assembler);
+    if (frame.kind != ControlFrame::Kind::Loop)
+        frame.label.link(m_assembler);
+    m_height = frame.base_height + frame.result_count;
+    m_is_unreachable = false;
+}
+
+void Compiler::compile_branch(LabelIndex index)
+{
+    auto& frame = frame_for(index);
+    copy_branch_results(frame);
+    m_assembler.jump(frame.label);
+    m_is_unreachable = true;
+    m_unreachable_depth = 0;
+}
+
+void Compiler::compile_branch_if(Condition condition, LabelIndex index)
+{
+    auto& frame = frame_for(index);
+    if (!branch_needs_copy(frame)) {
+        m_assembler.jump_if(condition, frame.label);
+        return;
+    }
+
+    Assembler::Label not_taken;
+    m_assembler.jump_if(invert(condition), not_taken);
+    copy_branch_results(frame);
+    m_assembler.jump(frame.label);
+    not_taken.link(m_assembler);
+}
+
+void Compiler::compile_comparison(Condition condition, bool is_64_bit, Extension extension)
+{
+    auto rhs = pop();
+    auto lhs = top();
+    if (is_64_bit) {
+        m_assembler.mov(reg(GPR0), lhs);
+        m_assembler.mov(reg(GPR1), rhs);
+    } else {
+        m_assembler.mov32(reg(GPR0), lhs, extension);
+        m_assembler.mov32(reg(GPR1), rhs, extension);
+    }
+    // NOTE: This has to happen before the comparison, as clearing a register changes the flags.
+    m_assembler.mov(reg(SCRATCH), imm(0));
+    m_assembler.cmp(reg(GPR0), reg(GPR1));
+    m_assembler.set_if(condition, reg(SCRATCH));
+    m_assembler.mov(lhs, reg(SCRATCH));
+}
+
+void Compiler::compile_comparison_and_branch(OpCode comparison, LabelIndex index)
+{
+    if (comparison == Instructions::i32_eqz) {
+        m_assembler.mov32(reg(GPR0), pop());
+        m_assembler.cmp(reg(GPR0), imm(0));
+        return compile_branch_if(Condition::EqualTo, index);
+    }
+
+    Condition condition;
+    auto extension = Extension::ZeroExtend;
+    switch (comparison.value()) {
+    case Instructions::i32_eq.value():
+        condition = Condition::EqualTo;
+        break;
+    case Instructions::i32_ne.value():
+        condition = Condition::NotEqualTo;
+        break;
+    case Instructions::i32_lts.value():
+        condition = Condition::SignedLessThan;
+        extension = Extension::SignExtend;
+        break;
+    case Instructions::i32_ltu.value():
+        condition = Condition::UnsignedLessThan;
+        break;
+    case Instructions::i32_gts.value():
+        condition = Condition::SignedGreaterThan;
+        extension = Extension::SignExtend;
+        break;
+    case Instructions::i32_gtu.value():
+        condition = Condition::UnsignedGreaterThan;
+        break;
+    case Instructions::i32_les.value():
+        condition = Condition::SignedLessThanOrEqualTo;
+        extension = Extension::SignExtend;
+        break;
+    case Instructions::i32_leu.value():
+        condition = Condition::UnsignedLessThanOrEqualTo;
+        break;
+    case Instructions::i32_ges.value():
+        condition = Condition::SignedGreaterThanOrEqualTo;
+        extension = Extension::SignExtend;
+        break;
+    case Instructions::i32_geu.value():
+        condition = Condition::UnsignedGreaterThanOrEqualTo;
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+    auto rhs = pop();
+    auto lhs = pop();
+    m_assembler.mov32(reg(GPR0), lhs, extension);
+    m_assembler.mov32(reg(GPR1), rhs, extension);
+    m_assembler.cmp(reg(GPR0), reg(GPR1));
+    compile_branch_if(condition, index);
+}
+
+template<typename EmitOperation>
+void Compiler::compile_binary_operation(EmitOperation emit)
+{
+    auto rhs = pop();
+    auto lhs = top();
+    m_assembler.mov(reg(GPR0), lhs);
+    m_assembler.mov(reg(GPR1), rhs);
+    emit(reg(GPR0), reg(GPR1));
+    m_assembler.mov(lhs, reg(GPR0));
+}
+
+template<typename EmitOperation>
+void Compiler::compile_shift(EmitOperation emit)
+{
+    // NOTE: Both wasm and x86 only look at the lowest 5 (or 6, for 64-bit values) bits of the count.
+    auto count = pop();
+    auto value = top();
+    m_assembler.mov(reg(GPR0), value);
+    m_assembler.mov(reg(SCRATCH), count);
+    emit(reg(GPR0));
+    m_assembler.mov(value, reg(GPR0));
+}
+
+void Compiler::compute_effective_address(Assembler::Operand base, Instruction::MemoryArgument const& argument, size_t size)
+{
+    // GPR0 = base + offset, which can't overflow as both of them are 32-bit values.
+    m_assembler.mov32(reg(GPR0), base);
+    if (argument.offset != 0) {
+        m_assembler.mov(reg(SCRATCH), imm(argument.offset));
+        m_assembler.add(reg(GPR0), reg(SCRATCH));
+    }
+
+    m_assembler.mov(reg(SCRATCH), reg(GPR0));
+    m_assembler.add(reg(SCRATCH), imm(size));
+    m_assembler.jump_if(reg(SCRATCH), Condition::UnsignedGreaterThan, reg(MEMORY_SIZE), m_out_of_bounds_trap_label);
+
+    m_assembler.add(reg(GPR0), reg(MEMORY_BASE));
+}
+
+bool Compiler::compile_load(Instruction::MemoryArgument const& argument, size_t size, Extension extension, bool is_64_bit)
+{
+    if (argument.memory_index.value() != 0)
+        return false;
+
+    auto slot = top();
+    compute_effective_address(slot, argument, size);
+    switch (size) {
+    case 1:
+        m_assembler.mov8(reg(GPR1), mem(GPR0), extension);
+        break;
+    case 2:
+        m_assembler.mov16(reg(GPR1), mem(GPR0), extension);
+        break;
+    case 4:
+        m_assembler.mov32(reg(GPR1), mem(GPR0), is_64_bit ? extension : Extension::ZeroExtend);
+        break;
+    case 8:
+        m_assembler.mov(reg(GPR1), mem(GPR0));
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+    if (is_64_bit && size < 4 && extension == Extension::SignExtend)
+        m_assembler.sign_extend_32_to_64_bits(GPR1);
+    m_assembler.mov(slot, reg(GPR1));
+    return true;
+}
+
+bool Compiler::compile_store(Instruction::MemoryArgument const& argument, size_t size)
+{
+    if (argument.memory_index.value() != 0)
+        return false;
+
+    auto value = pop();
+    auto base = pop();
+    compute_effective_address(base, argument, size);
+    m_assembler.mov(reg(GPR1), value);
+    switch (size) {
+    case 1:
+        m_assembler.mov8(mem(GPR0), reg(GPR1));
+        break;
+    case 2:
+        m_assembler.mov16(mem(GPR0), reg(GPR1));
+        break;
+    case 4:
+        m_assembler.mov32(mem(GPR0), reg(GPR1));
+        break;
+    case 8:
+        m_assembler.mov(mem(GPR0), reg(GPR1));
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+    return true;
+}
+
+bool Compiler::compile_unreachable_instruction(Instruction const& instruction)
+{
+    // Nothing in here can run, all that matters is where the current block ends.
+    switch (instruction.opcode().value()) {
+    case Instructions::block.value():
+    case Instructions::loop.value():
+    case Instructions::if_.value():
+        ++m_unreachable_depth;
+        return true;
+    case Instructions::structured_else.value():
+        if (m_unreachable_depth == 0)
+            compile_else();
+        return true;
+    case Instructions::structured_end.value():
+        if (m_unreachable_depth == 0)
+            compile_end();
+        else
+            --m_unreachable_depth;
+        return true;
+    default:
+        return true;
+    }
+}
+
+bool Compiler::compile_instruction(Instruction const& instruction)
+{
+    auto const& arguments = instruction.arguments();
+
+    switch (instruction.opcode().value()) {
+    case Instructions::unreachable.value():
+        m_assembler.jump(m_unreachable_trap_label);
+        m_is_unreachable = true;
+        m_unreachable_depth = 0;
+        return true;
+    case Instructions::nop.value():
+        return true;
+    case Instructions::block.value():
+        return compile_block(ControlFrame::Kind::Block, arguments.get<Instruction::StructuredInstructionArgs>());
+    case Instructions::loop.value():
+        return compile_block(ControlFrame::Kind::Loop, arguments.get<Instruction::StructuredInstructionArgs>());
+    case Instructions::if_.value():
+        return compile_block(ControlFrame::Kind::If, arguments.get<Instruction::StructuredInstructionArgs>());
+    case Instructions::structured_else.value():
+        compile_else();
+        return true;
+    case Instructions::structured_end.value():
+        compile_end();
+        return true;
+    case Instructions::br.value():
+        compile_branch(arguments.get<LabelIndex>());
+        return true;
+    case Instructions::br_if.value():
+        m_assembler.mov32(reg(GPR0), pop());
+        m_assembler.cmp(reg(GPR0), imm(0));
+        compile_branch_if(Condition::NotEqualTo, arguments.get<LabelIndex>());
+        return true;
+    case Instructions::br_table.value(): {
+        auto const& table = arguments.get<Instruction::TableBranchArgs>();
+        if (table.labels.size() > NumericLimits<i32>::max())
+            return false;
+        m_assembler.mov32(reg(GPR0), pop());
+        for (size_t i = 0; i < table.labels.size(); ++i) {
+            Assembler::Label next;
+            m_assembler.jump_if(reg(GPR0), Condition::NotEqualTo, imm(i), next);
+            compile_branch(table.labels[i]);
+            next.link(m_assembler);
+        }
+        compile_branch(table.default_);
+        return true;
+    }
+    case Instructions::return_.value():
+        compile_branch(LabelIndex { m_control_frames.size() - 1 });
+        return true;
+    case Instructions::drop.value():
+        (void)pop();
+        return true;
+    case Instructions::select_typed.value():
+        for (auto const& type : arguments.get<Vector<ValueType>>()) {
+            if (!is_supported_type(type))
+                return false;
+        }
+        [[fallthrough]];
+    case Instructions::select.value(): {
+        auto condition = pop();
+        auto if_false = pop();
+        auto if_true = top();
+        m_assembler.mov32(reg(SCRATCH), condition);
+        m_assembler.mov(reg(GPR0), if_true);
+        m_assembler.mov(reg(GPR1), if_false);
+        m_assembler.cmp(reg(SCRATCH), imm(0));
+        m_assembler.mov_if(Condition::EqualTo, reg(GPR0), reg(GPR1));
+        m_assembler.mov(if_true, reg(GPR0));
+        return true;
+    }
+    case Instructions::local_get.value():
+        m_assembler.mov(reg(GPR0), local(arguments.get<LocalIndex>()));
+        m_assembler.mov(push(), reg(GPR0));
+        return true;
+    case Instructions::local_set.value():
+        m_assembler.mov(reg(GPR0), pop());
+        m_assembler.mov(local(arguments.get<LocalIndex>()), reg(GPR0));
+        return true;
+    case Instructions::local_tee.value():
+        m_assembler.mov(reg(GPR0), top());
+        m_assembler.mov(local(arguments.get<LocalIndex>()), reg(GPR0));
+        return true;
+    case Instructions::i32_const.value():
+        m_assembler.mov(reg(GPR0), imm(bit_cast<u32>(arguments.get<i32>())));
+        m_assembler.mov(push(), reg(GPR0));
+        return true;
+    case Instructions::i64_const.value():
+        m_assembler.mov(reg(GPR0), imm(bit_cast<u64>(arguments.get<i64>())));
+        m_assembler.mov(push(), reg(GPR0));
+        return true;
+
+    case Instructions::i32_load.value():
+        return compile_load(arguments.get<Instruction::MemoryArgument>(), 4, Extension::ZeroExtend, false);
+    case Instructions::i64_load.value():
+        return compile_load(arguments.get<Instruction::MemoryArgument>(), 8, Extension::ZeroExtend, true);
+    case Instructions::i32_load8_s.value():
+        return compile_load(arguments.get<Instruction::MemoryArgument>(), 1, Extension::SignExtend, false);
+    case Instructions::i32_load8_u.value():
+        return compile_load(arguments.get<Instruction::MemoryArgument>(), 1, Extension::ZeroExtend, false);
+    case Instructions::i32_load16_s.value():
+        return compile_load(arguments.get<Instruction::MemoryArgument>(), 2, Extension::SignExtend, false);
+    case Instructions::i32_load16_u.value():
+        return compile_load(arguments.get<Instruction::MemoryArgument>(), 2, Extension::ZeroExtend, false);
+    case Instructions::i64_load8_s.value():
+        return compile_load(arguments.get<Instruction::MemoryArgument>(), 1, Extension::SignExtend, true);
+    case Instructions::i64_load8_u.value():
+        return compile_load(arguments.get<Instruction::MemoryArgument>(), 1, Extension::ZeroExtend, true);
+    case Instructions::i64_load16_s.value():
+        return compile_load(arguments.get<Instruction::MemoryArgument>(), 2, Extension::SignExtend, true);
+    case Instructions::i64_load16_u.value():
+        return compile_load(arguments.get<Instruction::MemoryArgument>(), 2, Extension::ZeroExtend, true);
+    case Instructions::i64_load32_s.value():
+        return compile_load(arguments.get<Instruction::MemoryArgument>(), 4, Extension::SignExtend, true);
+    case Instructions::i64_load32_u.value():
+        return compile_load(arguments.get<Instruction::MemoryArgument>(), 4, Extension::ZeroExtend, true);
+    case Instructions::i32_store.value():
+    case Instructions::i64_store32.value():
+        return compile_store(arguments.get<Instruction::MemoryArgument>(), 4);
+    case Instructions::i64_store.value():
+        return compile_store(arguments.get<Instruction::MemoryArgument>(), 8);
+    case Instructions::i32_store8.value():
+    case Instructions::i64_store8.value():
+        return compile_store(arguments.get<Instruction::MemoryArgument>(), 1);
+    case Instructions::i32_store16.value():
+    case Instructions::i64_store16.value():
+        return compile_store(arguments.get<Instruction::MemoryArgument>(), 2);
+
+    case Instructions::i32_eqz.value():
+    case Instructions::i64_eqz.value(): {
+        auto slot = top();
+        if (instruction.opcode() == Instructions::i32_eqz)
+            m_assembler.mov32(reg(GPR0), slot);
+        else
+            m_assembler.mov(reg(GPR0), slot);
+        m_assembler.mov(reg(SCRATCH), imm(0));
+        m_assembler.cmp(reg(GPR0), imm(0));
+        m_assembler.set_if(Condition::EqualTo, reg(SCRATCH));
+        m_assembler.mov(slot, reg(SCRATCH));
+        return true;
+    }
+    case Instructions::i32_eq.value():
+        compile_comparison(Condition::EqualTo, false, Extension::ZeroExtend);
+        return true;
+    case Instructions::i32_ne.value():
+        compile_comparison(Condition::NotEqualTo, false, Extension::ZeroExtend);
+        return true;
+    case Instructions::i32_lts.value():
+        compile_comparison(Condition::SignedLessThan, false, Extension::SignExtend);
+        return true;
+    case Instructions::i32_ltu.value():
+        compile_comparison(Condition::UnsignedLessThan, false, Extension::ZeroExtend);
+        return true;
+    case Instructions::i32_gts.value():
+        compile_comparison(Condition::SignedGreaterThan, false, Extension::SignExtend);
+        return true;
+    case Instructions::i32_gtu.value():
+        compile_comparison(Condition::UnsignedGreaterThan, false, Extension::ZeroExtend);
+        return true;
+    case Instructions::i32_les.value():
+        compile_comparison(Condition::SignedLessThanOrEqualTo, false, Extension::SignExtend);
+        return true;
+    case Instructions::i32_leu.value():
+        compile_comparison(Condition::UnsignedLessThanOrEqualTo, false, Extension::ZeroExtend);
+        return true;
+    case Instructions::i32_ges.value():
+        compile_comparison(Condition::SignedGreaterThanOrEqualTo, false, Extension::SignExtend);
+        return true;
+    case Instructions::i32_geu.value():
+        compile_comparison(Condition::UnsignedGreaterThanOrEqualTo, false, Extension::ZeroExtend);
+        return true;
+    case Instructions::i64_eq.value():
+        compile_comparison(Condition::EqualTo, true, Extension::ZeroExtend);
+        return true;
+    case Instructions::i64_ne.value():
+        compile_comparison(Condition::NotEqualTo, true, Extension::ZeroExtend);
+        return true;
+    case Instructions::i64_lts.value():
+        compile_comparison(Condition::SignedLessThan, true, Extension::ZeroExtend);
+        return true;
+    case Instructions::i64_ltu.value():
+        compile_comparison(Condition::UnsignedLessThan, true, Extension::ZeroExtend);
+        return true;
+    case Instructions::i64_gts.value():
+        compile_comparison(Condition::SignedGreaterThan, true, Extension::ZeroExtend);
+        return true;
+    case Instructions::i64_gtu.value():
+        compile_comparison(Condition::UnsignedGreaterThan, true, Extension::ZeroExtend);
+        return true;
+    case Instructions::i64_les.value():
+        compile_comparison(Condition::SignedLessThanOrEqualTo, true, Extension::ZeroExtend);
+        return true;
+    case Instructions::i64_leu.value():
+        compile_comparison(Condition::UnsignedLessThanOrEqualTo, true, Extension::ZeroExtend);
+        return true;
+    case Instructions::i64_ges.value():
+        compile_comparison(Condition::SignedGreaterThanOrEqualTo, true, Extension::ZeroExtend);
+        return true;
+    case Instructions::i64_geu.value():
+        compile_comparison(Condition::UnsignedGreaterThanOrEqualTo, true, Extension::ZeroExtend);
+        return true;
+
+    // NOTE: Only the lower half of the slot of an i32 value matters, so the 32-bit operations can work on whatever the
+    //       upper half contains.
+    case Instructions::i32_add.value():
+        compile_binary_operation([&](auto dst, auto src) { m_assembler.add32(dst, src, {}); });
+        return true;
+    case Instructions::i32_sub.value():
+        compile_binary_operation([&](auto dst, auto src) { m_assembler.sub32(dst, src, {}); });
+        return true;
+    case Instructions::i32_mul.value():
+        compile_binary_operation([&](auto dst, auto src) { m_assembler.mul32(dst, src, {}); });
+        return true;
+    case Instructions::i32_and.value():
+        compile_binary_operation([&](auto dst, auto src) { m_assembler.bitwise_and32(dst, src); });
+        return true;
+    case Instructions::i32_or.value():
+        compile_binary_operation([&](auto dst, auto src) { m_assembler.bitwise_or32(dst, src); });
+        return true;
+    case Instructions::i32_xor.value():
+        compile_binary_operation([&](auto dst, auto src) { m_assembler.bitwise_xor32(dst, src); });
+        return true;
+    case Instructions::i32_shl.value():
+        compile_shift([&](auto dst) { m_assembler.shift_left32(dst, {}); });
+        return true;
+    case Instructions::i32_shrs.value():
+        compile_shift([&](auto dst) { m_assembler.arithmetic_right_shift32(dst, {}); });
+        return true;
+    case Instructions::i32_shru.value():
+        compile_shift([&](auto dst) { m_assembler.shift_right32(dst, {}); });
+        return true;
+    case Instructions::i64_add.value():
+        compile_binary_operation([&](auto dst, auto src) { m_assembler.add(dst, src); });
+        return true;
+    case Instructions::i64_sub.value():
+        compile_binary_operation([&](auto dst, auto src) { m_assembler.sub(dst, src); });
+        return true;
+    case Instructions::i64_mul.value():
+        compile_binary_operation([&](auto dst, auto src) { m_assembler.mul(dst, src); });
+        return true;
+    case Instructions::i64_and.value():
+        compile_binary_operation([&](auto dst, auto src) { m_assembler.bitwise_and(dst, src); });
+        return true;
+    case Instructions::i64_or.value():
+        compile_binary_operation([&](auto dst, auto src) { m_assembler.bitwise_or(dst, src); });
+        return true;
+    case Instructions::i64_xor.value():
+        compile_binary_operation([&](auto dst, auto src) { m_assembler.bitwise_xor(dst, src); });
+        return true;
+    case Instructions::i64_shl.value():
+        compile_shift([&](auto dst) { m_assembler.shift_left(dst, {}); });
+        return true;
+    case Instructions::i64_shrs.value():
+        compile_shift([&](auto dst) { m_assembler.arithmetic_right_shift(dst, {}); });
+        return true;
+    case Instructions::i64_shru.value():
+        compile_shift([&](auto dst) { m_assembler.shift_right(dst, {}); });
+        return true;
+
+    case Instructions::i32_wrap_i64.value():
+        return true;
+    case Instructions::i64_extend_si32.value():
+    case Instructions::i64_extend32_s.value():
+        m_assembler.mov32(reg(GPR0), top(), Extension::SignExtend);
+        m_assembler.mov(top(), reg(GPR0));
+        return true;
+    case Instructions::i64_extend_ui32.value():
+        m_assembler.mov32(reg(GPR0), top());
+        m_assembler.mov(top(), reg(GPR0));
+        return true;
+    case Instructions::i32_extend8_s.value():
+    case Instructions::i64_extend8_s.value():
+        m_assembler.mov8(reg(GPR0), top(), Extension::SignExtend);
+        if (instruction.opcode() == Instructions::i64_extend8_s)
+            m_assembler.sign_extend_32_to_64_bits(GPR0);
+        m_assembler.mov(top(), reg(GPR0));
+        return true;
+    case Instructions::i32_extend16_s.value():
+    case Instructions::i64_extend16_s.value():
+        m_assembler.mov16(reg(GPR0), top(), Extension::SignExtend);
+        if (instruction.opcode() == Instructions::i64_extend16_s)
+            m_assembler.sign_extend_32_to_64_bits(GPR0);
+        m_assembler.mov(top(), reg(GPR0));
+        return true;
+
+    // See BytecodeInterpreter::fuse_instructions(). The instructions these stand for follow them, and are skipped.
+    case Instructions::synthetic_i32_add2local.value(): {
+        auto const& locals = arguments.get<Instruction::LocalPairArgs>();
+        m_assembler.mov(reg(GPR0), local(locals.lhs));
+        m_assembler.mov(reg(GPR1), local(locals.rhs));
+        m_assembler.add32(reg(GPR0), reg(GPR1), {});
+        m_assembler.mov(push(), reg(GPR0));
+        m_instruction_index += 2;
+        return true;
+    }
+    case Instructions::synthetic_i32_addconstlocal.value(): {
+        auto const& local_and_value = arguments.get<Instruction::LocalAndConstArgs>();
+        m_assembler.mov(reg(GPR0), local(local_and_value.local));
+        m_assembler.mov(reg(GPR1), imm(bit_cast<u32>(local_and_value.value)));
+        m_assembler.add32(reg(GPR0), reg(GPR1), {});
+        m_assembler.mov(push(), reg(GPR0));
+        m_instruction_index += 2;
+        return true;
+    }
+    case Instructions::synthetic_i32_addlocal.value():
+        m_assembler.mov(reg(GPR0), top());
+        m_assembler.mov(reg(GPR1), local(arguments.get<LocalIndex>()));
+        m_assembler.add32(reg(GPR0), reg(GPR1), {});
+        m_assembler.mov(top(), reg(GPR0));
+        m_instruction_index += 1;
+        return true;
+    case Instructions::synthetic_local_seti32_const.value(): {
+        auto const& local_and_value = arguments.get<Instruction::LocalAndConstArgs>();
+        m_assembler.mov(reg(GPR0), imm(bit_cast<u32>(local_and_value.value)));
+        m_assembler.mov(local(local_and_value.local), reg(GPR0));
+        m_instruction_index += 1;
+        return true;
+    }
+    case Instructions::synthetic_br_if_i32_compare.value(): {
+        auto const& comparison_and_label = arguments.get<Instruction::CompareAndBranchArgs>();
+        compile_comparison_and_branch(comparison_and_label.comparison, comparison_and_label.label);
+        m_instruction_index += 1;
+        return true;
+    }
+
+    default:
+        return false;
+    }
+}
+
+#else
+
+OwnPtr<NativeFunction> Compiler::compile(FunctionType const&, Module::Function const&, Span<FunctionType const>)
+{
+    return nullptr;
+}
+
+#endif
+
+}
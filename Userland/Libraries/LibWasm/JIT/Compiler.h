@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/OwnPtr.h>
+#include <AK/Span.h>
+#include <AK/Vector.h>
+#include <LibJIT/Assembler.h>
+#include <LibWasm/JIT/NativeFunction.h>
+#include <LibWasm/Types.h>
+
+namespace Wasm::JIT {
+
+// A single-pass baseline compiler, which turns the body of a validated function into machine code.
+//
+// The validator already made sure that the operand stack has the same height every time execution reaches a given
+// instruction, so every value on it can live in a fixed slot, right after the locals. That way, the machine code
+// doesn't need a stack of its own, and a branch only has to copy its results to the bottom of the block it leaves.
+//
+// Only functions that work on i32 and i64 values, and don't call anything or touch globals and tables, are compiled.
+// All the others keep running in the BytecodeInterpreter.
+class Compiler {
+public:
+    static OwnPtr<NativeFunction> compile(FunctionType const&, Module::Function const&, Span<FunctionType const> module_types);
+
+#ifdef JIT_ARCH_SUPPORTED
+private:
+    using Assembler = ::JIT::Assembler;
+
+    Compiler(FunctionType const& type, Module::Function const& function, Span<FunctionType const> module_types)
+        : m_type(type)
+        , m_function(function)
+        , m_module_types(module_types)
+        , m_assembler(m_output)
+    {
+    }
+
+    struct ControlFrame {
+        enum class Kind {
+            Block,
+            Loop,
+            If,
+        };
+
+        Kind kind { Kind::Block };
+
+        // The height of the operand stack below the parameters of the block.
+        size_t base_height { 0 };
+        size_t parameter_count { 0 };
+        size_t result_count { 0 };
+
+        // Where a branch to this frame goes: the start of a loop, or the end of anything else.
+        Assembler::Label label;
+
+        // Where an `if` goes if its condition is false.
+        Assembler::Label else_label;
+        bool has_else { false };
+
+        size_t branch_arity() const { return kind == Kind::Loop ? parameter_count : result_count; }
+    };
+
+    OwnPtr<NativeFunction> compile_function();
+    void compile_entry();
+    void compile_exits();
+    bool compile_instruction(Instruction const&);
+    bool compile_unreachable_instruction(Instruction const&);
+
+    bool compile_block(ControlFrame::Kind, Instruction::StructuredInstructionArgs const&);
+    void compile_else();
+    void compile_end();
+    void compile_branch(LabelIndex);
+    void compile_branch_if(Assembler::Condition, LabelIndex);
+    void compile_comparison(Assembler::Condition, bool is_64_bit, Assembler::Extension);
+    void compile_comparison_and_branch(OpCode comparison, LabelIndex);
+    template<typename EmitOperation>
+    void compile_binary_operation(EmitOperation);
+    template<typename EmitOperation>
+    void compile_shift(EmitOperation);
+    bool compile_load(Instruction::MemoryArgument const&, size_t size, Assembler::Extension, bool is_64_bit);
+    bool compile_store(Instruction::MemoryArgument const&, size_t size);
+    void compute_effective_address(Assembler::Operand base, Instruction::MemoryArgument const&, size_t size);
+
+    bool resolve_block_type(BlockType const&, size_t& parameter_count, size_t& result_count) const;
+    ControlFrame& frame_for(LabelIndex);
+    void copy_branch_results(ControlFrame const&);
+    bool branch_needs_copy(ControlFrame const&) const;
+
+    Assembler::Operand local(LocalIndex) const;
+    Assembler::Operand stack_slot(size_t height) const;
+    Assembler::Operand push();
+    Assembler::Operand pop();
+    Assembler::Operand top() const;
+
+    FunctionType const& m_type;
+    Module::Function const& m_function;
+    Span<FunctionType const> m_module_types;
+
+    Vector<u8> m_output;
+    Assembler m_assembler;
+
+    size_t m_local_count { 0 };
+    size_t m_height { 0 };
+    size_t m_max_height { 0 };
+
+    // The frame of the function body itself is the first one, and a branch to it returns.
+    Vector<ControlFrame> m_control_frames;
+
+    // After an unconditional branch, everything up to the end of the current block is skipped.
+    bool m_is_unreachable { false };
+    size_t m_unreachable_depth { 0 };
+
+    size_t m_instruction_index { 0 };
+
+    Assembler::Label m_unreachable_trap_label;
+    Assembler::Label m_out_of_bounds_trap_label;
+    Assembler::Label m_instruction_limit_trap_label;
+#endif
+};
+
+}
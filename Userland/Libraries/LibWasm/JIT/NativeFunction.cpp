@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Error.h>
+#include <AK/Format.h>
+#include <LibWasm/JIT/NativeFunction.h>
+#include <sys/mman.h>
+
+namespace Wasm::JIT {
+
+// The arguments that the machine code is entered with, see Compiler::compile_entry().
+using EntryPoint = u64 (*)(u64* slots, u8* memory, u64 memory_size, u64 instruction_budget);
+
+OwnPtr<NativeFunction> NativeFunction::create(ReadonlyBytes machine_code, size_t local_count, size_t slot_count)
+{
+    auto* memory = mmap(nullptr, machine_code.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        dbgln("Wasm JIT: Failed to map memory for native code: {}", AK::Error::from_errno(errno));
+        return nullptr;
+    }
+    memcpy(memory, machine_code.data(), machine_code.size());
+
+    if (mprotect(memory, machine_code.size(), PROT_READ | PROT_EXEC) < 0) {
+        dbgln("Wasm JIT: Failed to make native code executable: {}", AK::Error::from_errno(errno));
+        munmap(memory, machine_code.size());
+        return nullptr;
+    }
+
+    auto* native_function = new (nothrow) NativeFunction(static_cast<u8*>(memory), machine_code.size(), local_count, slot_count);
+    if (!native_function)
+        munmap(memory, machine_code.size());
+    return adopt_own_if_nonnull(native_function);
+}
+
+NativeFunction::NativeFunction(u8* code, size_t size, size_t local_count, size_t slot_count)
+    : m_code(code)
+    , m_size(size)
+    , m_local_count(local_count)
+    , m_slot_count(slot_count)
+{
+}
+
+NativeFunction::~NativeFunction()
+{
+    munmap(m_code, m_size);
+}
+
+NativeFunction::Status NativeFunction::run(Span<u64> slots, Bytes memory, u64 instruction_budget) const
+{
+    VERIFY(slots.size() >= m_slot_count);
+    auto entry = reinterpret_cast<EntryPoint>(m_code);
+    return static_cast<Status>(entry(slots.data(), memory.data(), memory.size(), instruction_budget));
+}
+
+StringView NativeFunction::trap_reason(Status status)
+{
+    switch (status) {
+    case Status::Returned:
+        break;
+    case Status::Unreachable:
+        return "Unreachable"sv;
+    case Status::MemoryAccessOutOfBounds:
+        return "Memory access out of bounds"sv;
+    case Status::ExceededInstructionLimit:
+        return "Exceeded maximum allowed number of instructions"sv;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Noncopyable.h>
+#include <AK/OwnPtr.h>
+#include <AK/Span.h>
+#include <AK/StringView.h>
+#include <AK/Types.h>
+
+namespace Wasm::JIT {
+
+// The machine code that a function has been compiled to, see Compiler.
+class NativeFunction {
+    AK_MAKE_NONCOPYABLE(NativeFunction);
+    AK_MAKE_NONMOVABLE(NativeFunction);
+
+public:
+    enum class Status : u64 {
+        Returned = 0,
+        Unreachable,
+        MemoryAccessOutOfBounds,
+        ExceededInstructionLimit,
+    };
+
+    static OwnPtr<NativeFunction> create(ReadonlyBytes machine_code, size_t local_count, size_t slot_count);
+    ~NativeFunction();
+
+    // Every local and every value on the operand stack has a slot of its own. The locals (the arguments followed by the
+    // declared locals) come first, so that's also where the function expects its arguments. Once it returns, its
+    // results are in the slots right after the locals.
+    [[nodiscard]] size_t local_count() const { return m_local_count; }
+    [[nodiscard]] size_t slot_count() const { return m_slot_count; }
+
+    // NOTE: The function only ever accesses the first memory of its module, which can't grow while it's running.
+    //       Every iteration of a loop uses up as many instructions from the budget as there are in its body.
+    Status run(Span<u64> slots, Bytes memory, u64 instruction_budget) const;
+
+    static StringView trap_reason(Status);
+
+private:
+    NativeFunction(u8* code, size_t size, size_t local_count, size_t slot_count);
+
+    u8* m_code { nullptr };
+    size_t m_size { 0 };
+    size_t m_local_count { 0 };
+    size_t m_slot_count { 0 };
+};
+
+}
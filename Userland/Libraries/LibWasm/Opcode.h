@@ -460,8 +460,18 @@ namespace Instructions {
     ENUMERATE_SINGLE_BYTE_WASM_OPCODES(M) \
     ENUMERATE_MULTI_BYTE_WASM_OPCODES(M)
 
+// These are never seen in wasm at all, they're what the bytecode interpreter fuses common instruction sequences into
+// once a module has been validated. See BytecodeInterpreter::fuse_instructions().
+#define ENUMERATE_SYNTHETIC_INSTRUCTION_OPCODES(M)         \
+    M(synthetic_i32_add2local, 0xfe00000000000000ull)      \
+    M(synthetic_i32_addlocal, 0xfe00000000000001ull)       \
+    M(synthetic_i32_addconstlocal, 0xfe00000000000002ull)  \
+    M(synthetic_local_seti32_const, 0xfe00000000000003ull) \
+    M(synthetic_br_if_i32_compare, 0xfe00000000000004ull)
+
 #define M(name, value) static constexpr OpCode name = value;
 ENUMERATE_WASM_OPCODES(M)
+ENUMERATE_SYNTHETIC_INSTRUCTION_OPCODES(M)
 #undef M
 
 }
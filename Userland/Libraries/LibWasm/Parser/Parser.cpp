@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ByteBuffer.h>
 #include <AK/ConstrainedStream.h>
 #include <AK/Debug.h>
 #include <AK/Endian.h>
@@ -12,6 +13,8 @@
 #include <AK/ScopeGuard.h>
 #include <AK/ScopeLogger.h>
 #include <AK/UFixedBigInt.h>
+#include <LibThreading/Parallel.h>
+#include <LibWasm/TaskPool.h>
 #include <LibWasm/Types.h>
 
 namespace Wasm {
@@ -1320,6 +1323,16 @@ ParseResult<CodeSection::Func> CodeSection::Func::parse(Stream& stream)
     return Func { locals, body };
 }
 
+// Parses a function body from a stream that ends where the body does, anything left over means the size was wrong.
+static ParseResult<CodeSection::Code> parse_code(Stream& stream, size_t size)
+{
+    auto func = TRY(CodeSection::Func::parse(stream));
+    if (!stream.is_eof())
+        return ParseError::InvalidSize;
+
+    return CodeSection::Code { static_cast<u32>(size), func };
+}
+
 ParseResult<CodeSection::Code> CodeSection::Code::parse(Stream& stream)
 {
     ScopeLogger<WASM_BINPARSER_DEBUG> logger("Code"sv);
@@ -1329,17 +1342,64 @@ ParseResult<CodeSection::Code> CodeSection::Code::parse(Stream& stream)
     size_t size = size_or_error.release_value();
 
     auto constrained_stream = ConstrainedStream { MaybeOwned<Stream>(stream), size };
-
-    auto func = TRY(Func::parse(constrained_stream));
-
-    return Code { static_cast<u32>(size), func };
+    return parse_code(constrained_stream, size);
 }
 
 ParseResult<CodeSection> CodeSection::parse(Stream& stream)
 {
     ScopeLogger<WASM_BINPARSER_DEBUG> logger("CodeSection"sv);
-    auto result = TRY(parse_vector<Code>(stream));
-    return CodeSection { result };
+    auto count_or_error = stream.read_value<LEB128<u32>>();
+    if (count_or_error.is_error())
+        return with_eof_check(stream, ParseError::ExpectedSize);
+    size_t count = count_or_error.release_value();
+
+    Vector<Code> functions;
+    if (count < Constants::min_function_count_for_parallel_processing) {
+        for (size_t i = 0; i < count; ++i)
+            functions.append(TRY(Code::parse(stream)));
+        return CodeSection { move(functions) };
+    }
+
+    // Every body starts with its size, so they can all be cut out of the stream first, and then parsed independently.
+    struct BodyExtent {
+        size_t offset { 0 };
+        size_t size { 0 };
+    };
+    Vector<BodyExtent> extents;
+    ByteBuffer bodies;
+    for (size_t i = 0; i < count; ++i) {
+        auto size_or_error = stream.read_value<LEB128<u32>>();
+        if (size_or_error.is_error())
+            return with_eof_check(stream, ParseError::InvalidSize);
+        size_t size = size_or_error.release_value();
+        if (bodies.size() + size > Constants::max_allowed_vector_size)
+            return with_eof_check(stream, ParseError::HugeAllocationRequested);
+
+        auto offset = bodies.size();
+        auto bytes_or_error = bodies.get_bytes_for_writing(size);
+        if (bytes_or_error.is_error())
+            return with_eof_check(stream, ParseError::HugeAllocationRequested);
+        if (stream.read_until_filled(bytes_or_error.release_value()).is_error())
+            return ParseError::UnexpectedEof;
+        extents.append({ offset, size });
+    }
+
+    Vector<Optional<ParseResult<Code>>> results;
+    results.resize(count);
+    Threading::parallel_for(task_pool(), count, [&](size_t index) {
+        auto extent = extents[index];
+        FixedMemoryStream body_stream { bodies.bytes().slice(extent.offset, extent.size) };
+        results[index] = parse_code(body_stream, extent.size);
+    });
+
+    // Report the same error that parsing the bodies one after another would have.
+    functions.ensure_capacity(count);
+    for (auto& result : results) {
+        if (result->is_error())
+            return result->error();
+        functions.unchecked_append(result->release_value());
+    }
+    return CodeSection { move(functions) };
 }
 
 ParseResult<DataSection::Data> DataSection::Data::parse(Stream& stream)
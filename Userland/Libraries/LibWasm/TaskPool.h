@@ -0,0 +1,16 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <LibThreading/Parallel.h>
+
+namespace Wasm {
+
+// The workers that parsing and validating a module spread their work over, started the first time they're needed.
+Threading::TaskPool& task_pool();
+
+}
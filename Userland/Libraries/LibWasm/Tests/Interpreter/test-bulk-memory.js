@@ -0,0 +1,61 @@
+// (memory 1)
+// (data "hello")
+// (func (export "fill") (param i32 i32 i32)
+//     (memory.fill (local.get 0) (local.get 1) (local.get 2)))
+// (func (export "copy") (param i32 i32 i32)
+//     (memory.copy (local.get 0) (local.get 1) (local.get 2)))
+// (func (export "init") (param i32 i32 i32)
+//     (memory.init 0 (local.get 0) (local.get 1) (local.get 2)))
+// (func (export "load8") (param i32) (result i32)
+//     (i32.load8_u (local.get 0)))
+// prettier-ignore
+const binary = new Uint8Array([
+        0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x02, 0x60, 0x03, 0x7f, 0x7f, 0x7f,
+        0x00, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x03, 0x05, 0x04, 0x00, 0x00, 0x00, 0x01, 0x05, 0x03, 0x01,
+        0x00, 0x01, 0x07, 0x1e, 0x04, 0x04, 0x66, 0x69, 0x6c, 0x6c, 0x00, 0x00, 0x04, 0x63, 0x6f, 0x70,
+        0x79, 0x00, 0x01, 0x04, 0x69, 0x6e, 0x69, 0x74, 0x00, 0x02, 0x05, 0x6c, 0x6f, 0x61, 0x64, 0x38,
+        0x00, 0x03, 0x0c, 0x01, 0x01, 0x0a, 0x2f, 0x04, 0x0b, 0x00, 0x20, 0x00, 0x20, 0x01, 0x20, 0x02,
+        0xfc, 0x0b, 0x00, 0x0b, 0x0c, 0x00, 0x20, 0x00, 0x20, 0x01, 0x20, 0x02, 0xfc, 0x0a, 0x00, 0x00,
+        0x0b, 0x0c, 0x00, 0x20, 0x00, 0x20, 0x01, 0x20, 0x02, 0xfc, 0x08, 0x00, 0x00, 0x0b, 0x07, 0x00,
+        0x20, 0x00, 0x2d, 0x00, 0x00, 0x0b, 0x0b, 0x08, 0x01, 0x01, 0x05, 0x68, 0x65, 0x6c, 0x6c, 0x6f,
+]);
+
+const readBytes = (module, address, count) => {
+    const load8 = module.getExport("load8");
+    const bytes = [];
+    for (let i = 0; i < count; ++i) bytes.push(module.invoke(load8, address + i));
+    return bytes;
+};
+
+test("memory.fill", () => {
+    const module = parseWebAssemblyModule(binary);
+    const fill = module.getExport("fill");
+    module.invoke(fill, 10, 0x1ff, 4);
+    expect(readBytes(module, 9, 6)).toEqual([0, 255, 255, 255, 255, 0]);
+    module.invoke(fill, 65536, 1, 0);
+    expect(() => module.invoke(fill, 65535, 1, 2)).toThrow(TypeError);
+    expect(() => module.invoke(fill, -1, 1, 2)).toThrow(TypeError);
+    expect(readBytes(module, 65534, 2)).toEqual([0, 0]);
+});
+
+test("memory.init and memory.copy", () => {
+    const module = parseWebAssemblyModule(binary);
+    const init = module.getExport("init");
+    const copy = module.getExport("copy");
+    module.invoke(init, 20, 1, 4);
+    expect(readBytes(module, 20, 5)).toEqual([101, 108, 108, 111, 0]);
+    module.invoke(copy, 21, 20, 4);
+    expect(readBytes(module, 20, 6)).toEqual([101, 101, 108, 108, 111, 0]);
+    module.invoke(copy, 20, 21, 4);
+    expect(readBytes(module, 20, 6)).toEqual([101, 108, 108, 111, 111, 0]);
+    module.invoke(init, 65536, 0, 0);
+});
+
+test("out of bounds bulk memory operations trap", () => {
+    const module = parseWebAssemblyModule(binary);
+    const init = module.getExport("init");
+    const copy = module.getExport("copy");
+    expect(() => module.invoke(copy, 0, 65535, 2)).toThrow(TypeError);
+    expect(() => module.invoke(init, 65535, 0, 2)).toThrow(TypeError);
+    expect(() => module.invoke(init, 0, 3, 3)).toThrow(TypeError);
+});
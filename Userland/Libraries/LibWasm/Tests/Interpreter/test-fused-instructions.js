@@ -0,0 +1,53 @@
+// (func (export "sum") (param $n i32) (result i32) (local $i i32) (local $sum i32)
+//     (local.set $i (i32.const 0))
+//     (block (loop
+//         (br_if 1 (i32.ge_s (local.get $i) (local.get $n)))
+//         (local.set $sum (i32.add (local.get $sum) (local.get $i)))
+//         (local.set $i (i32.add (local.get $i) (i32.const 1)))
+//         (br 0)))
+//     (local.get $sum))
+// (func (export "add3") (param i32 i32 i32) (result i32)
+//     (i32.add (i32.add (local.get 0) (local.get 1)) (local.get 2)))
+// (func (export "below") (param i32 i32) (result i32)
+//     (block (result i32)
+//         (br_if 0 (i32.const 1) (i32.lt_u (local.get 0) (local.get 1)))
+//         (drop)
+//         (i32.const 0)))
+// prettier-ignore
+const binary = new Uint8Array([
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x13, 0x03, 0x60, 0x01, 0x7f, 0x01, 0x7f,
+    0x60, 0x03, 0x7f, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x03, 0x04, 0x03,
+    0x00, 0x01, 0x02, 0x07, 0x16, 0x03, 0x03, 0x73, 0x75, 0x6d, 0x00, 0x00, 0x04, 0x61, 0x64, 0x64,
+    0x33, 0x00, 0x01, 0x05, 0x62, 0x65, 0x6c, 0x6f, 0x77, 0x00, 0x02, 0x0a, 0x46, 0x03, 0x27, 0x01,
+    0x02, 0x7f, 0x41, 0x00, 0x21, 0x01, 0x02, 0x40, 0x03, 0x40, 0x20, 0x01, 0x20, 0x00, 0x4e, 0x0d,
+    0x01, 0x20, 0x02, 0x20, 0x01, 0x6a, 0x21, 0x02, 0x20, 0x01, 0x41, 0x01, 0x6a, 0x21, 0x01, 0x0c,
+    0x00, 0x0b, 0x0b, 0x20, 0x02, 0x0b, 0x0a, 0x00, 0x20, 0x00, 0x20, 0x01, 0x6a, 0x20, 0x02, 0x6a,
+    0x0b, 0x11, 0x00, 0x02, 0x7f, 0x41, 0x01, 0x20, 0x00, 0x20, 0x01, 0x49, 0x0d, 0x00, 0x1a, 0x41,
+    0x00, 0x0b, 0x0b,
+]);
+
+test("fused local.get and i32.add", () => {
+    const module = parseWebAssemblyModule(binary);
+    const add3 = module.getExport("add3");
+    expect(module.invoke(add3, 1, 2, 3)).toBe(6);
+    expect(module.invoke(add3, 0x7fffffff, 1, 0)).toBe(-0x80000000);
+    expect(module.invoke(add3, -1, -1, 2)).toBe(0);
+});
+
+test("fused i32 comparison and br_if", () => {
+    const module = parseWebAssemblyModule(binary);
+    const below = module.getExport("below");
+    expect(module.invoke(below, 1, 2)).toBe(1);
+    expect(module.invoke(below, 2, 1)).toBe(0);
+    expect(module.invoke(below, 2, 2)).toBe(0);
+    expect(module.invoke(below, -1, 1)).toBe(0);
+    expect(module.invoke(below, 1, -1)).toBe(1);
+});
+
+test("loop made of fused instructions", () => {
+    const module = parseWebAssemblyModule(binary);
+    const sum = module.getExport("sum");
+    expect(module.invoke(sum, 0)).toBe(0);
+    expect(module.invoke(sum, 10)).toBe(45);
+    expect(module.invoke(sum, 100000)).toBe(704982704);
+});
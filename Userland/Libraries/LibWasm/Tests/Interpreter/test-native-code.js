@@ -0,0 +1,178 @@
+// (memory 1)
+// (func (export "fib") (param $n i32) (result i64) (local $a i64) (local $b i64) (local $t i64)
+//     (local.set $a (i64.const 0))
+//     (local.set $b (i64.const 1))
+//     (block (loop
+//         (br_if 1 (i32.eqz (local.get $n)))
+//         (local.set $t (i64.add (local.get $a) (local.get $b)))
+//         (local.set $a (local.get $b))
+//         (local.set $b (local.get $t))
+//         (local.set $n (i32.sub (local.get $n) (i32.const 1)))
+//         (br 0)))
+//     (local.get $a))
+// (func (export "memsum") (param $n i32) (result i32) (local $i i32) (local $sum i32)
+//     (block (loop
+//         (br_if 1 (i32.ge_s (local.get $i) (local.get $n)))
+//         (i32.store (i32.mul (local.get $i) (i32.const 4)) (i32.mul (local.get $i) (i32.const 3)))
+//         (local.set $i (i32.add (local.get $i) (i32.const 1)))
+//         (br 0)))
+//     (local.set $i (i32.const 0))
+//     (block (loop
+//         (br_if 1 (i32.ge_s (local.get $i) (local.get $n)))
+//         (local.set $sum (i32.add (local.get $sum) (i32.load (i32.mul (local.get $i) (i32.const 4)))))
+//         (local.set $i (i32.add (local.get $i) (i32.const 1)))
+//         (br 0)))
+//     (local.get $sum))
+// (func (export "load") (param i32) (result i32)
+//     (i32.load offset=1 align=1 (local.get 0)))
+// (func (export "bytes") (param i32) (result i64)
+//     (i32.store16 (i32.const 100) (local.get 0))
+//     (i64.add (i64.add (i64.load8_s (i32.const 100)) (i64.load16_u (i32.const 100))) (i64.load32_s (i32.const 100))))
+// (func (export "pick") (param i32) (result i32)
+//     (block (block (block (block (br_table 0 1 2 3 (local.get 0)))
+//         (return (i32.const 10)))
+//         (return (i32.const 20)))
+//         (return (i32.const 30)))
+//     (i32.const -1))
+// (func (export "bits") (param $a i32) (param $b i32) (result i32)
+//     (i32.and
+//         (i32.add
+//             (i32.xor
+//                 (i32.xor
+//                     (i32.or (i32.xor (i32.shl (local.get $a) (local.get $b)) (i32.shr_s (local.get $a) (local.get $b)))
+//                             (i32.shr_u (local.get $a) (local.get $b)))
+//                     (i32.shl (i32.lt_s (local.get $a) (local.get $b)) (i32.const 3)))
+//                 (i32.shl (i32.lt_u (local.get $a) (local.get $b)) (i32.const 5)))
+//             (i32.mul (local.get $a) (local.get $b)))
+//         (i32.extend8_s (local.get $a))))
+// (func (export "wide") (param $a i64) (param $b i64) (result i64)
+//     (i64.and
+//         (i64.add
+//             (i64.sub
+//                 (i64.add (i64.xor (i64.mul (local.get $a) (local.get $b)) (i64.shl (local.get $a) (local.get $b)))
+//                          (i64.shr_s (local.get $a) (local.get $b)))
+//                 (i64.shr_u (local.get $a) (local.get $b)))
+//             (i64.extend_i32_u (i64.lt_s (local.get $a) (local.get $b))))
+//         (i64.extend_i32_s (i32.wrap_i64 (local.get $a)))))
+// (func (export "choose") (param i32 i32 i32) (result i32)
+//     (i32.add (select (local.get 0) (local.get 1) (local.get 2))
+//              (if (result i32) (local.get 2) (then (i32.const 100)) (else (i32.const 200)))))
+// (func (export "trap") (result i32)
+//     (unreachable))
+// (func (export "nested") (param $n i32) (result i32) (local $i i32)
+//     (block (result i32) (loop
+//         (br_if 1 (local.tee $i (i32.add (local.get $i) (i32.const 7))) (i32.gt_s (local.get $i) (local.get $n)))
+//         (drop)
+//         (br 0))
+//         (i32.const -1)))
+// prettier-ignore
+const binary = new Uint8Array([
+        0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x22, 0x06, 0x60, 0x01, 0x7f, 0x01, 0x7e,
+        0x60, 0x01, 0x7f, 0x01, 0x7f, 0x60, 0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x02, 0x7e, 0x7e, 0x01,
+        0x7e, 0x60, 0x03, 0x7f, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x00, 0x01, 0x7f, 0x03, 0x0b, 0x0a, 0x00,
+        0x01, 0x01, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x01, 0x05, 0x03, 0x01, 0x00, 0x01, 0x07, 0x4d,
+        0x0a, 0x03, 0x66, 0x69, 0x62, 0x00, 0x00, 0x06, 0x6d, 0x65, 0x6d, 0x73, 0x75, 0x6d, 0x00, 0x01,
+        0x04, 0x6c, 0x6f, 0x61, 0x64, 0x00, 0x02, 0x05, 0x62, 0x79, 0x74, 0x65, 0x73, 0x00, 0x03, 0x04,
+        0x70, 0x69, 0x63, 0x6b, 0x00, 0x04, 0x04, 0x62, 0x69, 0x74, 0x73, 0x00, 0x05, 0x04, 0x77, 0x69,
+        0x64, 0x65, 0x00, 0x06, 0x06, 0x63, 0x68, 0x6f, 0x6f, 0x73, 0x65, 0x00, 0x07, 0x04, 0x74, 0x72,
+        0x61, 0x70, 0x00, 0x08, 0x06, 0x6e, 0x65, 0x73, 0x74, 0x65, 0x64, 0x00, 0x09, 0x0a, 0xe2, 0x02,
+        0x0a, 0x35, 0x03, 0x01, 0x7e, 0x01, 0x7e, 0x01, 0x7e, 0x42, 0x00, 0x21, 0x01, 0x42, 0x01, 0x21,
+        0x02, 0x02, 0x40, 0x03, 0x40, 0x20, 0x00, 0x45, 0x0d, 0x01, 0x20, 0x01, 0x20, 0x02, 0x7c, 0x21,
+        0x03, 0x20, 0x02, 0x21, 0x01, 0x20, 0x03, 0x21, 0x02, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x21, 0x00,
+        0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x01, 0x0b, 0x52, 0x02, 0x01, 0x7f, 0x01, 0x7f, 0x02, 0x40, 0x03,
+        0x40, 0x20, 0x01, 0x20, 0x00, 0x4e, 0x0d, 0x01, 0x20, 0x01, 0x41, 0x04, 0x6c, 0x20, 0x01, 0x41,
+        0x03, 0x6c, 0x36, 0x02, 0x00, 0x20, 0x01, 0x41, 0x01, 0x6a, 0x21, 0x01, 0x0c, 0x00, 0x0b, 0x0b,
+        0x41, 0x00, 0x21, 0x01, 0x02, 0x40, 0x03, 0x40, 0x20, 0x01, 0x20, 0x00, 0x4e, 0x0d, 0x01, 0x20,
+        0x02, 0x20, 0x01, 0x41, 0x04, 0x6c, 0x28, 0x02, 0x00, 0x6a, 0x21, 0x02, 0x20, 0x01, 0x41, 0x01,
+        0x6a, 0x21, 0x01, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x02, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x28, 0x00,
+        0x01, 0x0b, 0x1e, 0x00, 0x41, 0xe4, 0x00, 0x20, 0x00, 0x3b, 0x01, 0x00, 0x41, 0xe4, 0x00, 0x30,
+        0x00, 0x00, 0x41, 0xe4, 0x00, 0x33, 0x01, 0x00, 0x7c, 0x41, 0xe4, 0x00, 0x34, 0x02, 0x00, 0x7c,
+        0x0b, 0x21, 0x00, 0x02, 0x40, 0x02, 0x40, 0x02, 0x40, 0x02, 0x40, 0x20, 0x00, 0x0e, 0x03, 0x00,
+        0x01, 0x02, 0x03, 0x0b, 0x41, 0x0a, 0x0f, 0x0b, 0x41, 0x14, 0x0f, 0x0b, 0x41, 0x1e, 0x0f, 0x0b,
+        0x41, 0x7f, 0x0b, 0x2f, 0x00, 0x20, 0x00, 0x20, 0x01, 0x74, 0x20, 0x00, 0x20, 0x01, 0x75, 0x73,
+        0x20, 0x00, 0x20, 0x01, 0x76, 0x72, 0x20, 0x00, 0x20, 0x01, 0x48, 0x41, 0x03, 0x74, 0x73, 0x20,
+        0x00, 0x20, 0x01, 0x49, 0x41, 0x05, 0x74, 0x73, 0x20, 0x00, 0x20, 0x01, 0x6c, 0x6a, 0x20, 0x00,
+        0xc0, 0x71, 0x0b, 0x25, 0x00, 0x20, 0x00, 0x20, 0x01, 0x7e, 0x20, 0x00, 0x20, 0x01, 0x86, 0x85,
+        0x20, 0x00, 0x20, 0x01, 0x87, 0x7c, 0x20, 0x00, 0x20, 0x01, 0x88, 0x7d, 0x20, 0x00, 0x20, 0x01,
+        0x53, 0xad, 0x7c, 0x20, 0x00, 0xa7, 0xac, 0x83, 0x0b, 0x16, 0x00, 0x20, 0x00, 0x20, 0x01, 0x20,
+        0x02, 0x1b, 0x20, 0x02, 0x04, 0x7f, 0x41, 0xe4, 0x00, 0x05, 0x41, 0xc8, 0x01, 0x0b, 0x6a, 0x0b,
+        0x03, 0x00, 0x00, 0x0b, 0x1d, 0x01, 0x01, 0x7f, 0x02, 0x7f, 0x03, 0x40, 0x20, 0x01, 0x41, 0x07,
+        0x6a, 0x22, 0x01, 0x20, 0x01, 0x20, 0x00, 0x4a, 0x0d, 0x01, 0x1a, 0x0c, 0x00, 0x0b, 0x41, 0x7f,
+        0x0b, 0x0b,
+]);
+
+test("loops with i64 arithmetic", () => {
+    const module = parseWebAssemblyModule(binary);
+    const fib = module.getExport("fib");
+    expect(module.invoke(fib, 0)).toBe(0n);
+    expect(module.invoke(fib, 10)).toBe(55n);
+    expect(module.invoke(fib, 90)).toBe(2880067194370816120n);
+});
+
+test("memory loads and stores", () => {
+    const module = parseWebAssemblyModule(binary);
+    const memsum = module.getExport("memsum");
+    expect(module.invoke(memsum, 100)).toBe(14850);
+    const load = module.getExport("load");
+    expect(module.invoke(load, 4)).toBe(100663296);
+    expect(module.invoke(load, 65531)).toBe(0);
+    const bytes = module.getExport("bytes");
+    expect(module.invoke(bytes, 0x1280)).toBe(9344n);
+    expect(module.invoke(bytes, 0xff7f)).toBe(130941n);
+    expect(module.invoke(bytes, -1)).toBe(131069n);
+});
+
+test("out of bounds memory accesses trap", () => {
+    const module = parseWebAssemblyModule(binary);
+    const load = module.getExport("load");
+    expect(() => module.invoke(load, 65532)).toThrowWithMessage(
+        TypeError,
+        "Execution trapped: Memory access out of bounds"
+    );
+    expect(() => module.invoke(load, -1)).toThrowWithMessage(
+        TypeError,
+        "Execution trapped: Memory access out of bounds"
+    );
+});
+
+test("br_table and return", () => {
+    const module = parseWebAssemblyModule(binary);
+    const pick = module.getExport("pick");
+    expect(module.invoke(pick, 0)).toBe(10);
+    expect(module.invoke(pick, 1)).toBe(20);
+    expect(module.invoke(pick, 2)).toBe(30);
+    expect(module.invoke(pick, 3)).toBe(-1);
+    expect(module.invoke(pick, 4)).toBe(-1);
+    expect(module.invoke(pick, -1)).toBe(-1);
+});
+
+test("integer operations", () => {
+    const module = parseWebAssemblyModule(binary);
+    const bits = module.getExport("bits");
+    expect(module.invoke(bits, -12345, 3)).toBe(536833861);
+    expect(module.invoke(bits, 7, 35)).toBe(5);
+    expect(module.invoke(bits, 0x12345678, -3)).toBe(56);
+    const wide = module.getExport("wide");
+    expect(module.invoke(wide, -5n, 3n)).toBe(-2305843009213693910n);
+    expect(module.invoke(wide, 0x123456789n, 70n)).toBe(553723136n);
+});
+
+test("select and if with results", () => {
+    const module = parseWebAssemblyModule(binary);
+    const choose = module.getExport("choose");
+    expect(module.invoke(choose, 1, 2, 0)).toBe(202);
+    expect(module.invoke(choose, 1, 2, 5)).toBe(101);
+});
+
+test("branching out of a loop with a value", () => {
+    const module = parseWebAssemblyModule(binary);
+    const nested = module.getExport("nested");
+    expect(module.invoke(nested, 30)).toBe(35);
+    expect(module.invoke(nested, -5)).toBe(7);
+});
+
+test("unreachable traps", () => {
+    const module = parseWebAssemblyModule(binary);
+    const trap = module.getExport("trap");
+    expect(() => module.invoke(trap)).toThrowWithMessage(TypeError, "Execution trapped: Unreachable");
+});
@@ -0,0 +1,74 @@
+// Enough functions that their bodies are parsed and validated in parallel.
+const functionCount = 500;
+
+const leb128 = value => {
+    const bytes = [];
+    do {
+        let byte = value & 0x7f;
+        value >>>= 7;
+        if (value !== 0) byte |= 0x80;
+        bytes.push(byte);
+    } while (value !== 0);
+    return bytes;
+};
+
+const section = (id, contents) => [id, ...leb128(contents.length), ...contents];
+
+// Function `i` is (func (param i32) (result i32) (i32.add (local.get 0) (i32.const i))), the first and last one are
+// exported as "first" and "last", and `patchBody` gets to change the bytes of every body.
+const makeModule = (patchBody = (index, body) => body) => {
+    const types = [0x01, 0x60, 0x01, 0x7f, 0x01, 0x7f];
+    const functions = [...leb128(functionCount)];
+    const code = [...leb128(functionCount)];
+    for (let i = 0; i < functionCount; ++i) {
+        functions.push(0x00);
+        const body = patchBody(i, [0x00, 0x20, 0x00, 0x41, ...leb128(i), 0x6a, 0x0b]);
+        code.push(...leb128(body.length), ...body);
+    }
+    const exports = [
+        0x02,
+        0x05,
+        ...Array.from("first", c => c.charCodeAt(0)),
+        0x00,
+        0x00,
+        0x04,
+        ...Array.from("last", c => c.charCodeAt(0)),
+        0x00,
+        ...leb128(functionCount - 1),
+    ];
+    return new Uint8Array([
+        0x00,
+        0x61,
+        0x73,
+        0x6d,
+        0x01,
+        0x00,
+        0x00,
+        0x00,
+        ...section(0x01, types),
+        ...section(0x03, functions),
+        ...section(0x07, exports),
+        ...section(0x0a, code),
+    ]);
+};
+
+test("large code section", () => {
+    const module = parseWebAssemblyModule(makeModule());
+    expect(module.invoke(module.getExport("first"), 10)).toBe(10);
+    expect(module.invoke(module.getExport("last"), 10)).toBe(10 + functionCount - 1);
+});
+
+test("invalid function in a large code section", () => {
+    for (const invalidIndex of [0, 321, functionCount - 1]) {
+        const binary = makeModule((index, body) => (index === invalidIndex ? [0x00, 0x6a, 0x0b] : body));
+        expect(() => parseWebAssemblyModule(binary)).toThrowWithMessage(
+            TypeError,
+            "Validation failed: Invalid stack state, expected i32 but got <nothing>"
+        );
+    }
+});
+
+test("function body with the wrong size in a large code section", () => {
+    const binary = makeModule((index, body) => (index === 123 ? [...body, 0x01] : body));
+    expect(() => parseWebAssemblyModule(binary)).toThrow(SyntaxError);
+});
@@ -452,6 +452,22 @@ public:
         u8 lanes[16];
     };
 
+    // Arguments of the synthetic instructions, see BytecodeInterpreter::fuse_instructions().
+    struct LocalPairArgs {
+        LocalIndex lhs;
+        LocalIndex rhs;
+    };
+
+    struct LocalAndConstArgs {
+        LocalIndex local;
+        i32 value;
+    };
+
+    struct CompareAndBranchArgs {
+        OpCode comparison;
+        LabelIndex label;
+    };
+
     template<typename T>
     explicit Instruction(OpCode opcode, T argument)
         : m_opcode(opcode)
@@ -468,6 +484,7 @@ private:
     OpCode m_opcode { 0 };
     Variant<
         BlockType,
+        CompareAndBranchArgs,
         DataIndex,
         ElementIndex,
         FunctionIndex,
@@ -475,7 +492,9 @@ private:
         IndirectCallArgs,
         LabelIndex,
         LaneIndex,
+        LocalAndConstArgs,
         LocalIndex,
+        LocalPairArgs,
         MemoryArgument,
         MemoryAndLaneArgument,
         MemoryCopyArgs,
@@ -673,6 +692,7 @@ public:
     }
 
     auto& instructions() const { return m_instructions; }
+    auto& instructions() { return m_instructions; }
 
     static ParseResult<Expression> parse(Stream& stream);
 
@@ -971,6 +991,7 @@ public:
         auto& type() const { return m_type; }
         auto& locals() const { return m_local_types; }
         auto& body() const { return m_body; }
+        auto& body() { return m_body; }
 
     private:
         TypeIndex m_type;
@@ -1007,6 +1028,7 @@ public:
 
     auto& sections() const { return m_sections; }
     auto& functions() const { return m_functions; }
+    auto& functions() { return m_functions; }
     auto& type(TypeIndex index) const
     {
         FunctionType const* type = nullptr;
@@ -43,6 +43,7 @@
 #include <LibWeb/Namespace.h>
 #include <LibWeb/NavigationTiming/EntryNames.h>
 #include <LibWeb/PerformanceTimeline/EntryTypes.h>
+#include <LibWeb/PhaseTimer.h>
 #include <LibWeb/Platform/EventLoopPlugin.h>
 #include <LibWeb/SVG/AttributeNames.h>
 #include <LibWeb/SVG/TagNames.h>
@@ -86,6 +87,14 @@ ErrorOr<void> initialize_main_thread_vm()
     //       This avoids doing an exhaustive garbage collection on process exit.
     s_main_thread_vm->ref();
 
+    // NOTE: Pages load the same scripts over and over again (think reloads, or a library that's shared by all the pages
+    //       of a site), so it pays off to keep their parse trees and bytecode around.
+    s_main_thread_vm->enable_program_cache();
+
+    s_main_thread_vm->heap().on_garbage_collection = [](auto const& collection) {
+        record_completed_phase(Phase::GarbageCollection, collection.total_time);
+    };
+
     auto& custom_data = verify_cast<WebEngineCustomData>(*s_main_thread_vm->custom_data());
     custom_data.event_loop = s_main_thread_vm->heap().allocate_without_realm<HTML::EventLoop>();
 
@@ -195,10 +195,76 @@ static inline bool is_E(u32 code_point)
     return code_point == 0x45;
 }
 
+// Tokenizing only depends on the input, so the tokens of large stylesheets are kept around for other documents in this
+// process that load the same stylesheet (e.g. the same CSS framework on every page of a site). The rules built from
+// them belong to a realm and can't be shared, but the parser can start straight from the cached tokens.
+static constexpr size_t minimum_length_of_cached_input = 4 * KiB;
+static constexpr size_t maximum_number_of_cached_inputs = 8;
+
+struct CachedTokens {
+    u32 hash { 0 };
+    ByteString encoding;
+    ByteString input;
+    Vector<Token> tokens;
+};
+
+static Vector<CachedTokens>& token_cache()
+{
+    static Vector<CachedTokens> cache;
+    return cache;
+}
+
+static Optional<Vector<Token>> cached_tokens_for(StringView input, StringView encoding, u32 hash)
+{
+    auto& cache = token_cache();
+    for (size_t i = 0; i < cache.size(); ++i) {
+        auto& entry = cache[i];
+        if (entry.hash != hash || entry.input != input || entry.encoding != encoding)
+            continue;
+        // Keep the most recently used entry at the end, so the least recently used one is evicted first.
+        auto tokens = entry.tokens;
+        if (i != cache.size() - 1)
+            cache.append(cache.take(i));
+        return tokens;
+    }
+    return {};
+}
+
+static void cache_tokens_for(StringView input, StringView encoding, u32 hash, Vector<Token> const& tokens)
+{
+    auto& cache = token_cache();
+    if (cache.size() == maximum_number_of_cached_inputs)
+        cache.take_first();
+    cache.append({ hash, encoding, input, tokens });
+}
+
+// If the input is plain ASCII and contains none of the code points that filtering replaces, filtering it would
+// produce the exact same bytes, so there's no need to go through the decoder one code point at a time.
+static bool can_skip_filtering_code_points(StringView input, StringView encoding)
+{
+    if (!encoding.equals_ignoring_ascii_case("utf-8"sv))
+        return false;
+    for (auto byte : input.bytes()) {
+        if (byte >= 0x80 || byte == '\r' || byte == '\f' || byte == '\0')
+            return false;
+    }
+    return true;
+}
+
 ErrorOr<Vector<Token>> Tokenizer::tokenize(StringView input, StringView encoding)
 {
+    Optional<u32> hash;
+    if (input.length() >= minimum_length_of_cached_input) {
+        hash = input.hash();
+        if (auto tokens = cached_tokens_for(input, encoding, *hash); tokens.has_value())
+            return tokens.release_value();
+    }
+
     // https://www.w3.org/TR/css-syntax-3/#css-filter-code-points
     auto filter_code_points = [](StringView input, auto encoding) -> ErrorOr<String> {
+        if (can_skip_filtering_code_points(input, encoding))
+            return String::from_utf8_without_validation(input.bytes());
+
         auto decoder = TextCodec::decoder_for(encoding);
         VERIFY(decoder.has_value());
 
@@ -242,7 +308,11 @@ ErrorOr<Vector<Token>> Tokenizer::tokenize(StringView input, StringView encoding
     };
 
     Tokenizer tokenizer { TRY(filter_code_points(input, encoding)) };
-    return tokenizer.tokenize();
+    auto tokens = TRY(tokenizer.tokenize());
+
+    if (hash.has_value())
+        cache_tokens_for(input, encoding, *hash, tokens);
+    return tokens;
 }
 
 Tokenizer::Tokenizer(String decoded_input)
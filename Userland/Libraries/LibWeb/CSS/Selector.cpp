@@ -41,10 +41,12 @@ void Selector::collect_ancestor_hashes()
         return false;
     };
 
+    // NOTE: Whatever is on the left of a descendant or child combinator has to match an ancestor, and so does whatever
+    //       is further left than that, since siblings share their ancestors.
     auto last_combinator = m_compound_selectors.last().combinator;
     for (ssize_t compound_selector_index = static_cast<ssize_t>(m_compound_selectors.size()) - 2; compound_selector_index >= 0; --compound_selector_index) {
         auto const& compound_selector = m_compound_selectors[compound_selector_index];
-        if (last_combinator == Combinator::Descendant) {
+        if (last_combinator == Combinator::Descendant || last_combinator == Combinator::ImmediateChild) {
             for (auto const& simple_selector : compound_selector.simple_selectors) {
                 switch (simple_selector.type) {
                 case SimpleSelector::Type::Id:
@@ -53,7 +55,8 @@ void Selector::collect_ancestor_hashes()
                         return;
                     break;
                 case SimpleSelector::Type::TagName:
-                    if (append_unique_hash(simple_selector.qualified_name().name.name.hash()))
+                    // NOTE: Tag names are never matched case-sensitively, see for_each_element_hash() in StyleComputer.
+                    if (append_unique_hash(simple_selector.qualified_name().name.lowercase_name.hash()))
                         return;
                     break;
                 case SimpleSelector::Type::Attribute:
@@ -65,6 +65,7 @@
 #include <LibWeb/DOM/Attr.h>
 #include <LibWeb/DOM/Document.h>
 #include <LibWeb/DOM/Element.h>
+#include <LibWeb/DOM/NamedNodeMap.h>
 #include <LibWeb/DOM/ShadowRoot.h>
 #include <LibWeb/HTML/HTMLBRElement.h>
 #include <LibWeb/HTML/HTMLHtmlElement.h>
@@ -746,17 +747,17 @@ void StyleComputer::set_all_properties(DOM::Element& element, Optional<CSS::Sele
         auto property_id = (CSS::PropertyID)i;
 
         if (value.is_revert()) {
-            style.m_property_values[to_underlying(property_id)] = properties_for_revert[to_underlying(property_id)];
-            style.m_property_values[to_underlying(property_id)].important = important;
+            style.properties()[to_underlying(property_id)] = properties_for_revert[to_underlying(property_id)];
+            style.properties()[to_underlying(property_id)].important = important;
             continue;
         }
 
         if (value.is_unset()) {
             if (is_inherited_property(property_id))
-                style.m_property_values[to_underlying(property_id)] = { get_inherit_value(document.realm(), property_id, &element, pseudo_element), nullptr };
+                style.properties()[to_underlying(property_id)] = { get_inherit_value(document.realm(), property_id, &element, pseudo_element), nullptr };
             else
-                style.m_property_values[to_underlying(property_id)] = { property_initial_value(document.realm(), property_id), nullptr };
-            style.m_property_values[to_underlying(property_id)].important = important;
+                style.properties()[to_underlying(property_id)] = { property_initial_value(document.realm(), property_id), nullptr };
+            style.properties()[to_underlying(property_id)].important = important;
             continue;
         }
 
@@ -766,7 +767,7 @@ void StyleComputer::set_all_properties(DOM::Element& element, Optional<CSS::Sele
         if (!property_value->is_unresolved())
             set_property_expanding_shorthands(style, property_id, property_value, declaration, properties_for_revert);
 
-        style.m_property_values[to_underlying(property_id)].important = important;
+        style.properties()[to_underlying(property_id)].important = important;
 
         set_property_expanding_shorthands(style, property_id, value, declaration, properties_for_revert, important);
     }
@@ -1570,7 +1571,7 @@ void StyleComputer::compute_cascaded_values(StyleProperties& style, DOM::Element
             // FIXME: This is not very efficient, we should only resolve the custom properties that are actually used.
             for (auto i = to_underlying(CSS::first_property_id); i <= to_underlying(CSS::last_property_id); ++i) {
                 auto property_id = (CSS::PropertyID)i;
-                auto& property = style.m_property_values[i];
+                auto& property = style.properties()[i];
                 if (property.style && property.style->is_unresolved())
                     property.style = Parser::Parser::resolve_unresolved_style_value(Parser::ParsingContext { document() }, element, pseudo_element, property_id, property.style->as_unresolved());
             }
@@ -1679,12 +1680,12 @@ void StyleComputer::compute_defaulted_property_value(StyleProperties& style, DOM
 {
     // FIXME: If we don't know the correct initial value for a property, we fall back to InitialStyleValue.
 
-    auto& value_slot = style.m_property_values[to_underlying(property_id)];
+    auto& value_slot = style.properties()[to_underlying(property_id)];
     if (!value_slot.style) {
         if (is_inherited_property(property_id))
-            style.m_property_values[to_underlying(property_id)] = { get_inherit_value(document().realm(), property_id, element, pseudo_element), nullptr, StyleProperties::Important::No, StyleProperties::Inherited::Yes };
+            style.properties()[to_underlying(property_id)] = { get_inherit_value(document().realm(), property_id, element, pseudo_element), nullptr, StyleProperties::Important::No, StyleProperties::Inherited::Yes };
         else
-            style.m_property_values[to_underlying(property_id)] = { property_initial_value(document().realm(), property_id), nullptr };
+            style.properties()[to_underlying(property_id)] = { property_initial_value(document().realm(), property_id), nullptr };
         return;
     }
 
@@ -2141,7 +2142,7 @@ void StyleComputer::absolutize_values(StyleProperties& style) const
     //       We have to resolve them right away, so that the *computed* line-height is ready for inheritance.
     //       We can't simply absolutize *all* percentage values against the font size,
     //       because most percentages are relative to containing block metrics.
-    auto& line_height_value_slot = style.m_property_values[to_underlying(CSS::PropertyID::LineHeight)].style;
+    auto& line_height_value_slot = style.properties()[to_underlying(CSS::PropertyID::LineHeight)].style;
     if (line_height_value_slot && line_height_value_slot->is_percentage()) {
         line_height_value_slot = LengthStyleValue::create(
             Length::make_px(CSSPixels::nearest_value_for(font_size * static_cast<double>(line_height_value_slot->as_percentage().percentage().as_fraction()))));
@@ -2154,8 +2155,8 @@ void StyleComputer::absolutize_values(StyleProperties& style) const
     if (line_height_value_slot && line_height_value_slot->is_length())
         line_height_value_slot = LengthStyleValue::create(Length::make_px(line_height));
 
-    for (size_t i = 0; i < style.m_property_values.size(); ++i) {
-        auto& value_slot = style.m_property_values[i];
+    for (size_t i = 0; i < style.properties().size(); ++i) {
+        auto& value_slot = style.properties()[i];
         if (!value_slot.style)
             continue;
         value_slot.style = value_slot.style->absolutized(viewport_rect(), font_metrics, m_root_element_font_metrics);
@@ -2341,6 +2342,14 @@ RefPtr<StyleProperties> StyleComputer::compute_style_impl(DOM::Element& element,
         return style;
     }
 
+    // OPTIMIZATION: Siblings that are indistinguishable to the selectors in the document end up with the same style,
+    //               so if we just computed it for one of them, we can reuse it.
+    bool const style_can_be_shared = mode == ComputeStyleMode::Normal && !pseudo_element.has_value() && can_share_style(element);
+    if (style_can_be_shared) {
+        if (auto shared_style = find_shared_style(element))
+            return shared_style;
+    }
+
     auto style = StyleProperties::create();
     // 1. Perform the cascade. This produces the "specified style"
     bool did_match_any_pseudo_element_rules = false;
@@ -2370,9 +2379,125 @@ RefPtr<StyleProperties> StyleComputer::compute_style_impl(DOM::Element& element,
     // 8. Let the element adjust computed style
     element.adjust_computed_style(style);
 
+    if (style_can_be_shared)
+        add_style_sharing_candidate(element, style);
+
     return style;
 }
 
+static constexpr size_t max_style_sharing_selector_count = 256;
+static constexpr size_t max_style_sharing_candidate_count = 8;
+
+void StyleComputer::collect_style_sharing_selectors(Selector const& selector)
+{
+    if (m_has_too_many_style_sharing_selectors)
+        return;
+
+    auto const& compound_selectors = selector.compound_selectors();
+    auto const& subject = compound_selectors.last();
+
+    bool subject_has_pseudo_class = false;
+    for (auto const& simple_selector : subject.simple_selectors) {
+        // NOTE: Rules for pseudo-elements don't contribute to the style of the element itself.
+        if (simple_selector.type == Selector::SimpleSelector::Type::PseudoElement)
+            return;
+        if (simple_selector.type == Selector::SimpleSelector::Type::PseudoClass)
+            subject_has_pseudo_class = true;
+    }
+
+    // NOTE: Two siblings have the same ancestors, so only the parts of a selector that look at the element itself, or at
+    //       its previous siblings, can tell them apart. The tag name and attributes are compared separately.
+    RefPtr<Selector> selector_to_check;
+    if (subject.combinator == Selector::Combinator::NextSibling || subject.combinator == Selector::Combinator::SubsequentSibling) {
+        auto compound_selectors_copy = compound_selectors;
+        selector_to_check = Selector::create(move(compound_selectors_copy));
+    } else if (subject_has_pseudo_class)
+        selector_to_check = Selector::create({ Selector::CompoundSelector { Selector::Combinator::None, subject.simple_selectors } });
+
+    if (!selector_to_check)
+        return;
+
+    if (m_serialized_style_sharing_selectors.set(selector_to_check->serialize()) != HashSetResult::InsertedNewEntry)
+        return;
+
+    if (m_style_sharing_selectors.size() == max_style_sharing_selector_count) {
+        m_has_too_many_style_sharing_selectors = true;
+        m_style_sharing_selectors.clear();
+        m_serialized_style_sharing_selectors.clear();
+        return;
+    }
+    m_style_sharing_selectors.append(selector_to_check.release_nonnull());
+}
+
+bool StyleComputer::can_share_style(DOM::Element const& element) const
+{
+    if (m_has_too_many_style_sharing_selectors)
+        return false;
+
+    if (m_style_sharing_candidates.is_empty() || m_style_sharing_candidates.last().parent.ptr() != element.parent_element())
+        return false;
+
+    // NOTE: Inline styles, shadow trees and animations are specific to each element.
+    if (element.inline_style() || element.is_shadow_host())
+        return false;
+    if (element.has_associated_animations() || element.cached_animation_name_animation())
+        return false;
+
+    return true;
+}
+
+bool StyleComputer::can_share_style_with(DOM::Element const& element, DOM::Element const& candidate) const
+{
+    if (element.local_name() != candidate.local_name() || element.namespace_uri() != candidate.namespace_uri())
+        return false;
+
+    // NOTE: This covers the ID, the classes, attribute selectors and presentational hints all at once.
+    if (element.attribute_list_size() != candidate.attribute_list_size())
+        return false;
+    if (auto const* attributes = element.attributes()) {
+        auto const& candidate_attributes = *candidate.attributes();
+        for (u32 i = 0; i < attributes->length(); ++i) {
+            auto const& attribute = *attributes->item(i);
+            auto const& candidate_attribute = *candidate_attributes.item(i);
+            if (attribute.local_name() != candidate_attribute.local_name()
+                || attribute.namespace_uri() != candidate_attribute.namespace_uri()
+                || attribute.value() != candidate_attribute.value())
+                return false;
+        }
+    }
+
+    for (auto const& selector : m_style_sharing_selectors) {
+        if (SelectorEngine::matches(selector, {}, element) != SelectorEngine::matches(selector, {}, candidate))
+            return false;
+    }
+    return true;
+}
+
+RefPtr<StyleProperties> StyleComputer::find_shared_style(DOM::Element& element) const
+{
+    for (auto const& candidate : m_style_sharing_candidates.last().candidates) {
+        if (!can_share_style_with(element, candidate.element))
+            continue;
+
+        // NOTE: The custom properties of the element come from the rules it matched, which are the same ones.
+        element.set_custom_properties({}, candidate.element->custom_properties({}));
+        return candidate.style->clone();
+    }
+    return nullptr;
+}
+
+void StyleComputer::add_style_sharing_candidate(DOM::Element const& element, StyleProperties const& style) const
+{
+    // NOTE: The cascade may have started an animation for the element, which would make its style unique.
+    if (element.cached_animation_name_animation())
+        return;
+
+    auto& candidates = m_style_sharing_candidates.last().candidates;
+    if (candidates.size() == max_style_sharing_candidate_count)
+        candidates.take_first();
+    candidates.append({ element, style.clone() });
+}
+
 void StyleComputer::build_rule_cache_if_needed() const
 {
     if (m_author_rule_cache && m_user_rule_cache && m_user_agent_rule_cache)
@@ -2412,6 +2537,9 @@ NonnullOwnPtr<StyleComputer::RuleCache> StyleComputer::make_rule_cache_for_casca
                     SelectorEngine::can_use_fast_matches(selector),
                 };
 
+                m_style_invalidation_data->collect_from_selector(selector);
+                collect_style_sharing_selectors(selector);
+
                 for (auto const& simple_selector : selector.compound_selectors().last().simple_selectors) {
                     if (!matching_rule.contains_pseudo_element) {
                         if (simple_selector.type == CSS::Selector::SimpleSelector::Type::PseudoElement) {
@@ -2535,6 +2663,10 @@ void StyleComputer::build_rule_cache()
         m_user_style_sheet = JS::make_handle(parse_css_stylesheet(CSS::Parser::ParsingContext(document()), user_style_source.value()));
     }
 
+    m_style_invalidation_data = make<StyleInvalidationData>();
+    m_style_sharing_selectors.clear();
+    m_serialized_style_sharing_selectors.clear();
+    m_has_too_many_style_sharing_selectors = false;
     m_author_rule_cache = make_rule_cache_for_cascade_origin(CascadeOrigin::Author);
     m_user_rule_cache = make_rule_cache_for_cascade_origin(CascadeOrigin::User);
     m_user_agent_rule_cache = make_rule_cache_for_cascade_origin(CascadeOrigin::UserAgent);
@@ -2553,6 +2685,17 @@ void StyleComputer::invalidate_rule_cache()
     // NOTE: It might not be necessary to throw away the UA rule cache.
     //       If we are sure that it's safe, we could keep it as an optimization.
     m_user_agent_rule_cache = nullptr;
+    m_style_invalidation_data = nullptr;
+    m_style_sharing_selectors.clear();
+    m_serialized_style_sharing_selectors.clear();
+    for (auto& style_sharing_candidates : m_style_sharing_candidates)
+        style_sharing_candidates.candidates.clear();
+}
+
+StyleInvalidationData const& StyleComputer::style_invalidation_data() const
+{
+    build_rule_cache_if_needed();
+    return *m_style_invalidation_data;
 }
 
 void StyleComputer::did_load_font(FlyString const&)
@@ -2666,7 +2809,12 @@ void StyleComputer::compute_math_depth(StyleProperties& style, DOM::Element cons
 
 static void for_each_element_hash(DOM::Element const& element, auto callback)
 {
-    callback(element.local_name().hash());
+    // NOTE: Selectors hash the lowercase version of their tag names. In HTML documents, they only match elements with
+    //       the same local name, and everywhere else, they match it ASCII case-insensitively.
+    if (element.document().document_type() == DOM::Document::Type::HTML)
+        callback(element.local_name().hash());
+    else
+        callback(element.local_name().ascii_case_insensitive_hash());
     if (element.id().has_value())
         callback(element.id().value().hash());
     for (auto const& class_ : element.class_names())
@@ -2679,6 +2827,7 @@ static void for_each_element_hash(DOM::Element const& element, auto callback)
 void StyleComputer::reset_ancestor_filter()
 {
     m_ancestor_filter.clear();
+    m_style_sharing_candidates.clear();
 }
 
 void StyleComputer::push_ancestor(DOM::Element const& element)
@@ -2686,6 +2835,7 @@ void StyleComputer::push_ancestor(DOM::Element const& element)
     for_each_element_hash(element, [&](u32 hash) {
         m_ancestor_filter.increment(hash);
     });
+    m_style_sharing_candidates.append({ element, {} });
 }
 
 void StyleComputer::pop_ancestor(DOM::Element const& element)
@@ -2693,6 +2843,8 @@ void StyleComputer::pop_ancestor(DOM::Element const& element)
     for_each_element_hash(element, [&](u32 hash) {
         m_ancestor_filter.decrement(hash);
     });
+    if (!m_style_sharing_candidates.is_empty() && m_style_sharing_candidates.last().parent.ptr() == &element)
+        m_style_sharing_candidates.take_last();
 }
 
 }
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <AK/HashMap.h>
+#include <AK/HashTable.h>
 #include <AK/Optional.h>
 #include <AK/OwnPtr.h>
 #include <LibWeb/Animations/KeyframeEffect.h>
@@ -15,6 +16,7 @@
 #include <LibWeb/CSS/CSSKeyframesRule.h>
 #include <LibWeb/CSS/CSSStyleDeclaration.h>
 #include <LibWeb/CSS/Selector.h>
+#include <LibWeb/CSS/StyleInvalidation.h>
 #include <LibWeb/CSS/StyleProperties.h>
 #include <LibWeb/Forward.h>
 #include <LibWeb/Loader/ResourceLoader.h>
@@ -133,6 +135,9 @@ public:
     Vector<MatchingRule> collect_matching_rules(DOM::Element const&, CascadeOrigin, Optional<CSS::Selector::PseudoElement::Type>) const;
 
     void invalidate_rule_cache();
+    void build_rule_cache_if_needed() const;
+
+    [[nodiscard]] StyleInvalidationData const& style_invalidation_data() const;
 
     Gfx::Font const& initial_font() const;
 
@@ -162,6 +167,12 @@ private:
 
     [[nodiscard]] bool should_reject_with_ancestor_filter(Selector const&) const;
 
+    void collect_style_sharing_selectors(Selector const&);
+    [[nodiscard]] bool can_share_style(DOM::Element const&) const;
+    [[nodiscard]] bool can_share_style_with(DOM::Element const&, DOM::Element const& candidate) const;
+    RefPtr<StyleProperties> find_shared_style(DOM::Element&) const;
+    void add_style_sharing_candidate(DOM::Element const&, StyleProperties const&) const;
+
     RefPtr<StyleProperties> compute_style_impl(DOM::Element&, Optional<CSS::Selector::PseudoElement::Type>, ComputeStyleMode) const;
     void compute_cascaded_values(StyleProperties&, DOM::Element&, Optional<CSS::Selector::PseudoElement::Type>, bool& did_match_any_pseudo_element_rules, ComputeStyleMode) const;
     static RefPtr<Gfx::FontCascadeList const> find_matching_font_weight_ascending(Vector<MatchingFontCandidate> const& candidates, int target_weight, float font_size_in_pt, bool inclusive);
@@ -194,7 +205,6 @@ private:
     void cascade_declarations(StyleProperties&, DOM::Element&, Optional<CSS::Selector::PseudoElement::Type>, Vector<MatchingRule> const&, CascadeOrigin, Important) const;
 
     void build_rule_cache();
-    void build_rule_cache_if_needed() const;
 
     JS::NonnullGCPtr<DOM::Document> m_document;
 
@@ -217,6 +227,7 @@ private:
     OwnPtr<RuleCache> m_author_rule_cache;
     OwnPtr<RuleCache> m_user_rule_cache;
     OwnPtr<RuleCache> m_user_agent_rule_cache;
+    OwnPtr<StyleInvalidationData> m_style_invalidation_data;
     JS::Handle<CSSStyleSheet> m_user_style_sheet;
 
     using FontLoaderList = Vector<NonnullOwnPtr<FontLoader>>;
@@ -228,6 +239,25 @@ private:
     CSSPixelRect m_viewport_rect;
 
     CountingBloomFilter<u8, 14> m_ancestor_filter;
+
+    // Selectors that may match one of two siblings with the same tag name and attributes, but not the other.
+    // If there are too many of them to check, style sharing is disabled.
+    Vector<NonnullRefPtr<Selector>> m_style_sharing_selectors;
+    HashTable<String> m_serialized_style_sharing_selectors;
+    bool m_has_too_many_style_sharing_selectors { false };
+
+    struct StyleSharingCandidate {
+        JS::NonnullGCPtr<DOM::Element const> element;
+        NonnullRefPtr<StyleProperties> style;
+    };
+
+    // The elements whose style was recently computed, for each ancestor of the element being styled.
+    // The children of an element can only share their style with each other.
+    struct StyleSharingCandidates {
+        JS::NonnullGCPtr<DOM::Element const> parent;
+        Vector<StyleSharingCandidate> candidates;
+    };
+    mutable Vector<StyleSharingCandidates> m_style_sharing_candidates;
 };
 
 class FontLoader : public ResourceClient {
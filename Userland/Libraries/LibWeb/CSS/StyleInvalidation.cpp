@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibWeb/CSS/Selector.h>
 #include <LibWeb/CSS/StyleInvalidation.h>
 #include <LibWeb/CSS/StyleProperties.h>
 
@@ -58,4 +59,82 @@ RequiredInvalidationAfterStyleChange compute_property_invalidation(CSS::Property
     return invalidation;
 }
 
+static StyleInvalidationScope scope_for_compound_selector(Selector const& selector, size_t compound_selector_index)
+{
+    auto const& compound_selectors = selector.compound_selectors();
+    if (compound_selector_index == compound_selectors.size() - 1)
+        return StyleInvalidationScope::Self;
+
+    // NOTE: Whatever is on the right of a compound selector has to be found in the subtree of the element it matched,
+    //       or in the subtree of its parent if they are connected by a sibling combinator.
+    switch (compound_selectors[compound_selector_index + 1].combinator) {
+    case Selector::Combinator::ImmediateChild:
+    case Selector::Combinator::Descendant:
+        return StyleInvalidationScope::Subtree;
+    case Selector::Combinator::NextSibling:
+    case Selector::Combinator::SubsequentSibling:
+        return StyleInvalidationScope::Siblings;
+    case Selector::Combinator::None:
+    case Selector::Combinator::Column:
+        break;
+    }
+    return StyleInvalidationScope::Document;
+}
+
+void StyleInvalidationData::collect_from_selector(Selector const& selector)
+{
+    collect_from_selector(selector, StyleInvalidationScope::Self);
+}
+
+void StyleInvalidationData::collect_from_selector(Selector const& selector, StyleInvalidationScope minimum_scope)
+{
+    auto add = [](auto& scopes, FlyString const& name, StyleInvalidationScope scope) {
+        auto& existing_scope = scopes.ensure(name);
+        existing_scope = max(existing_scope, scope);
+    };
+
+    for (size_t compound_selector_index = 0; compound_selector_index < selector.compound_selectors().size(); ++compound_selector_index) {
+        auto scope = max(minimum_scope, scope_for_compound_selector(selector, compound_selector_index));
+        for (auto const& simple_selector : selector.compound_selectors()[compound_selector_index].simple_selectors) {
+            switch (simple_selector.type) {
+            case Selector::SimpleSelector::Type::Id:
+                add(m_id_scopes, simple_selector.name(), scope);
+                break;
+            case Selector::SimpleSelector::Type::Class:
+                add(m_class_scopes, simple_selector.name(), scope);
+                break;
+            case Selector::SimpleSelector::Type::Attribute:
+                add(m_attribute_scopes, simple_selector.attribute().qualified_name.name.lowercase_name, scope);
+                break;
+            case Selector::SimpleSelector::Type::PseudoClass: {
+                auto const& pseudo_class = simple_selector.pseudo_class();
+                auto argument_scope = scope;
+                switch (pseudo_class.type) {
+                case PseudoClass::Is:
+                case PseudoClass::Where:
+                case PseudoClass::Not:
+                case PseudoClass::Host:
+                    break;
+                case PseudoClass::NthChild:
+                case PseudoClass::NthLastChild:
+                    // NOTE: Whether a sibling matches the argument changes the index of all the others.
+                    argument_scope = max(argument_scope, StyleInvalidationScope::Siblings);
+                    break;
+                default:
+                    argument_scope = StyleInvalidationScope::Document;
+                    break;
+                }
+                for (auto const& argument_selector : pseudo_class.argument_selector_list)
+                    collect_from_selector(argument_selector, argument_scope);
+                break;
+            }
+            case Selector::SimpleSelector::Type::Universal:
+            case Selector::SimpleSelector::Type::TagName:
+            case Selector::SimpleSelector::Type::PseudoElement:
+                break;
+            }
+        }
+    }
+}
+
 }
@@ -6,7 +6,10 @@
 
 #pragma once
 
+#include <AK/FlyString.h>
+#include <AK/HashMap.h>
 #include <LibWeb/CSS/PropertyID.h>
+#include <LibWeb/Forward.h>
 
 namespace Web::CSS {
 
@@ -30,4 +33,37 @@ struct RequiredInvalidationAfterStyleChange {
 
 RequiredInvalidationAfterStyleChange compute_property_invalidation(CSS::PropertyID property_id, RefPtr<CSS::StyleValue const> const& old_value, RefPtr<CSS::StyleValue const> const& new_value);
 
+// Which elements may have to recompute their style after a class, ID or attribute of an element changed.
+// Each scope includes all the elements of the ones before it.
+enum class StyleInvalidationScope : u8 {
+    None,
+    // Only the element itself.
+    Self,
+    // The element and its descendants.
+    Subtree,
+    // The element, its siblings, and their descendants.
+    Siblings,
+    // Everything.
+    Document,
+};
+
+// Records, for every class, ID and attribute name that appears in the selectors of a document's style sheets,
+// how far a change to it can reach. Anything that doesn't appear in any selector can't change which rules match.
+class StyleInvalidationData {
+public:
+    void collect_from_selector(Selector const&);
+
+    [[nodiscard]] StyleInvalidationScope scope_for_class(FlyString const& class_name) const { return m_class_scopes.get(class_name).value_or(StyleInvalidationScope::None); }
+    [[nodiscard]] StyleInvalidationScope scope_for_id(FlyString const& id) const { return m_id_scopes.get(id).value_or(StyleInvalidationScope::None); }
+    [[nodiscard]] StyleInvalidationScope scope_for_attribute(FlyString const& attribute_name) const { return m_attribute_scopes.get(attribute_name).value_or(StyleInvalidationScope::None); }
+
+private:
+    void collect_from_selector(Selector const&, StyleInvalidationScope minimum_scope);
+
+    // NOTE: These are ASCII case-insensitive, since classes and IDs are matched that way in quirks mode.
+    HashMap<FlyString, StyleInvalidationScope, AK::ASCIICaseInsensitiveFlyStringTraits> m_class_scopes;
+    HashMap<FlyString, StyleInvalidationScope, AK::ASCIICaseInsensitiveFlyStringTraits> m_id_scopes;
+    HashMap<FlyString, StyleInvalidationScope, AK::ASCIICaseInsensitiveFlyStringTraits> m_attribute_scopes;
+};
+
 }
@@ -34,19 +34,28 @@
 
 namespace Web::CSS {
 
+StyleProperties::StyleProperties(StyleProperties const& other)
+    : m_data(other.m_data)
+    , m_animated_property_values(other.m_animated_property_values)
+    , m_math_depth(other.m_math_depth)
+    , m_font_list(other.m_font_list)
+    , m_line_height(other.m_line_height)
+{
+}
+
 bool StyleProperties::is_property_important(CSS::PropertyID property_id) const
 {
-    return m_property_values[to_underlying(property_id)].style && m_property_values[to_underlying(property_id)].important == Important::Yes;
+    return properties()[to_underlying(property_id)].style && properties()[to_underlying(property_id)].important == Important::Yes;
 }
 
 bool StyleProperties::is_property_inherited(CSS::PropertyID property_id) const
 {
-    return m_property_values[to_underlying(property_id)].style && m_property_values[to_underlying(property_id)].inherited == Inherited::Yes;
+    return properties()[to_underlying(property_id)].style && properties()[to_underlying(property_id)].inherited == Inherited::Yes;
 }
 
 void StyleProperties::set_property(CSS::PropertyID id, NonnullRefPtr<StyleValue const> value, CSS::CSSStyleDeclaration const* source_declaration, Inherited inherited, Important important)
 {
-    m_property_values[to_underlying(id)] = StyleAndSourceDeclaration { move(value), source_declaration, important, inherited };
+    properties()[to_underlying(id)] = StyleAndSourceDeclaration { move(value), source_declaration, important, inherited };
 }
 
 void StyleProperties::set_animated_property(CSS::PropertyID id, NonnullRefPtr<StyleValue const> value)
@@ -65,19 +74,19 @@ NonnullRefPtr<StyleValue const> StyleProperties::property(CSS::PropertyID proper
         return *animated_value;
 
     // By the time we call this method, all properties have values assigned.
-    return *m_property_values[to_underlying(property_id)].style;
+    return *properties()[to_underlying(property_id)].style;
 }
 
 RefPtr<StyleValue const> StyleProperties::maybe_null_property(CSS::PropertyID property_id) const
 {
     if (auto animated_value = m_animated_property_values.get(property_id).value_or(nullptr))
         return *animated_value;
-    return m_property_values[to_underlying(property_id)].style;
+    return properties()[to_underlying(property_id)].style;
 }
 
 CSS::CSSStyleDeclaration const* StyleProperties::property_source_declaration(CSS::PropertyID property_id) const
 {
-    return m_property_values[to_underlying(property_id)].declaration;
+    return properties()[to_underlying(property_id)].declaration;
 }
 
 CSS::Size StyleProperties::size_value(CSS::PropertyID id) const
@@ -611,12 +620,17 @@ Optional<CSS::Positioning> StyleProperties::position() const
 
 bool StyleProperties::operator==(StyleProperties const& other) const
 {
-    if (m_property_values.size() != other.m_property_values.size())
+    if (m_data == other.m_data)
+        return true;
+
+    auto const& property_values = properties();
+    auto const& other_property_values = other.properties();
+    if (property_values.size() != other_property_values.size())
         return false;
 
-    for (size_t i = 0; i < m_property_values.size(); ++i) {
-        auto const& my_style = m_property_values[i];
-        auto const& other_style = other.m_property_values[i];
+    for (size_t i = 0; i < property_values.size(); ++i) {
+        auto const& my_style = property_values[i];
+        auto const& other_style = other_property_values[i];
         if (!my_style.style) {
             if (other_style.style)
                 return false;
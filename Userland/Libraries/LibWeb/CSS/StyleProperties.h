@@ -20,16 +20,23 @@ namespace Web::CSS {
 
 class StyleProperties : public RefCounted<StyleProperties> {
 public:
-    StyleProperties() = default;
+    StyleProperties()
+        : m_data(adopt_ref(*new Data))
+    {
+    }
 
     static NonnullRefPtr<StyleProperties> create() { return adopt_ref(*new StyleProperties); }
 
+    // NOTE: This is cheap, since the property values are only copied once either of the two StyleProperties changes them.
+    NonnullRefPtr<StyleProperties> clone() const { return adopt_ref(*new StyleProperties(*this)); }
+
     template<typename Callback>
     inline void for_each_property(Callback callback) const
     {
-        for (size_t i = 0; i < m_property_values.size(); ++i) {
-            if (m_property_values[i].style)
-                callback((CSS::PropertyID)i, *m_property_values[i].style);
+        auto const& property_values = properties();
+        for (size_t i = 0; i < property_values.size(); ++i) {
+            if (property_values[i].style)
+                callback((CSS::PropertyID)i, *property_values[i].style);
         }
     }
 
@@ -51,8 +58,14 @@ public:
     };
     using PropertyValues = Array<StyleAndSourceDeclaration, to_underlying(CSS::last_property_id) + 1>;
 
-    auto& properties() { return m_property_values; }
-    auto const& properties() const { return m_property_values; }
+    PropertyValues& properties()
+    {
+        // We're handing out a mutable reference, so make sure we own the property values exclusively.
+        if (m_data->ref_count() > 1)
+            m_data = adopt_ref(*new Data(*m_data));
+        return m_data->property_values;
+    }
+    PropertyValues const& properties() const { return m_data->property_values; }
 
     HashMap<CSS::PropertyID, NonnullRefPtr<StyleValue const>> const& animated_property_values() const { return m_animated_property_values; }
     void reset_animated_properties();
@@ -188,7 +201,18 @@ public:
 private:
     friend class StyleComputer;
 
-    PropertyValues m_property_values;
+    StyleProperties(StyleProperties const&);
+
+    struct Data : public RefCounted<Data> {
+        Data() = default;
+        Data(Data const& other)
+            : property_values(other.property_values)
+        {
+        }
+
+        PropertyValues property_values;
+    };
+    NonnullRefPtr<Data> m_data;
     HashMap<CSS::PropertyID, NonnullRefPtr<StyleValue const>> m_animated_property_values;
 
     Optional<CSS::Overflow> overflow(CSS::PropertyID) const;
@@ -110,6 +110,7 @@
 #include <LibWeb/Layout/Viewport.h>
 #include <LibWeb/Namespace.h>
 #include <LibWeb/Page/Page.h>
+#include <LibWeb/PhaseTimer.h>
 #include <LibWeb/Painting/ViewportPaintable.h>
 #include <LibWeb/PermissionsPolicy/AutoplayAllowlist.h>
 #include <LibWeb/ResizeObserver/ResizeObserver.h>
@@ -1013,6 +1014,17 @@ URL::URL Document::parse_url(StringView url) const
 }
 
 void Document::set_needs_layout()
+{
+    m_needs_to_discard_cached_layout_results = true;
+    schedule_relayout();
+}
+
+void Document::set_needs_layout(Badge<Layout::Node>)
+{
+    schedule_relayout();
+}
+
+void Document::schedule_relayout()
 {
     if (m_needs_layout)
         return;
@@ -1081,6 +1093,8 @@ void Document::update_layout()
     if (!navigable)
         return;
 
+    PhaseTimer phase_timer { Phase::Layout };
+
     auto* document_element = this->document_element();
     auto viewport_rect = this->viewport_rect();
 
@@ -1091,7 +1105,13 @@ void Document::update_layout()
         if (document_element && document_element->layout_node()) {
             propagate_overflow_to_viewport(*document_element, *m_layout_root);
         }
+    } else if (m_needs_to_discard_cached_layout_results) {
+        m_layout_root->for_each_in_inclusive_subtree_of_type<Layout::Box>([](auto& box) {
+            box.reset_cached_intrinsic_sizes();
+            return TraversalDecision::Continue;
+        });
     }
+    m_needs_to_discard_cached_layout_results = false;
 
     Layout::LayoutState layout_state;
 
@@ -1138,30 +1158,38 @@ void Document::update_layout()
     m_needs_layout = false;
 }
 
-[[nodiscard]] static CSS::RequiredInvalidationAfterStyleChange update_style_recursively(Node& node, CSS::StyleComputer& style_computer)
+[[nodiscard]] static CSS::RequiredInvalidationAfterStyleChange update_style_recursively(Node& node, CSS::StyleComputer& style_computer, bool parent_style_changed)
 {
     bool const needs_full_style_update = node.document().needs_full_style_update();
     CSS::RequiredInvalidationAfterStyleChange invalidation;
 
-    if (node.is_element())
-        style_computer.push_ancestor(static_cast<Element const&>(node));
-
     // NOTE: If the current node has `display:none`, we can disregard all invalidation
     //       caused by its children, as they will not be rendered anyway.
     //       We will still recompute style for the children, though.
     bool is_display_none = false;
 
+    // NOTE: If the style of an element changed, the style of its children has to be recomputed as well, since they may
+    //       inherit from it, even if nothing invalidated them directly. Nodes without a style of their own, like shadow
+    //       roots, pass this on from their parent.
+    bool style_changed = parent_style_changed;
+
     if (is<Element>(node)) {
-        invalidation |= static_cast<Element&>(node).recompute_style();
+        auto element_invalidation = static_cast<Element&>(node).recompute_style();
+        style_changed = !element_invalidation.is_none();
+        invalidation |= element_invalidation;
         is_display_none = static_cast<Element&>(node).computed_css_values()->display().is_none();
     }
     node.set_needs_style_update(false);
 
-    if (needs_full_style_update || node.child_needs_style_update()) {
+    // NOTE: This only happens now, so the node's own tag, id and classes don't get mistaken for those of an ancestor.
+    if (node.is_element())
+        style_computer.push_ancestor(static_cast<Element const&>(node));
+
+    if (needs_full_style_update || style_changed || node.child_needs_style_update()) {
         if (node.is_element()) {
             if (auto* shadow_root = static_cast<DOM::Element&>(node).shadow_root_internal()) {
-                if (needs_full_style_update || shadow_root->needs_style_update() || shadow_root->child_needs_style_update()) {
-                    auto subtree_invalidation = update_style_recursively(*shadow_root, style_computer);
+                if (needs_full_style_update || style_changed || shadow_root->needs_style_update() || shadow_root->child_needs_style_update()) {
+                    auto subtree_invalidation = update_style_recursively(*shadow_root, style_computer, style_changed);
                     if (!is_display_none)
                         invalidation |= subtree_invalidation;
                 }
@@ -1169,8 +1197,8 @@ void Document::update_layout()
         }
 
         node.for_each_child([&](auto& child) {
-            if (needs_full_style_update || child.needs_style_update() || child.child_needs_style_update()) {
-                auto subtree_invalidation = update_style_recursively(child, style_computer);
+            if (needs_full_style_update || style_changed || child.needs_style_update() || child.child_needs_style_update()) {
+                auto subtree_invalidation = update_style_recursively(child, style_computer, style_changed);
                 if (!is_display_none)
                     invalidation |= subtree_invalidation;
             }
@@ -1191,6 +1219,8 @@ void Document::update_style()
     if (!browsing_context())
         return;
 
+    PhaseTimer phase_timer { Phase::Style };
+
     update_animated_style_if_needed();
 
     // Associated with each top-level browsing context is a current transition generation that is incremented on each
@@ -1209,14 +1239,18 @@ void Document::update_style()
 
     evaluate_media_rules();
 
+    // NOTE: Build the rule cache up front, so that it doesn't change while we are computing styles with it. The cache is
+    //       only read from during the traversal below, which is what would allow styling subtrees on separate threads.
+    style_computer().build_rule_cache_if_needed();
     style_computer().reset_ancestor_filter();
 
-    auto invalidation = update_style_recursively(*this, style_computer());
+    auto invalidation = update_style_recursively(*this, style_computer(), false);
     if (invalidation.rebuild_layout_tree) {
         invalidate_layout();
     } else {
+        // NOTE: Elements whose style change needs a relayout have already marked their layout nodes in recompute_style().
         if (invalidation.relayout)
-            set_needs_layout();
+            schedule_relayout();
         if (invalidation.rebuild_stacking_context_tree)
             invalidate_stacking_context_tree();
     }
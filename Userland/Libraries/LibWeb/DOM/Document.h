@@ -232,6 +232,7 @@ public:
     void update_animated_style_if_needed();
 
     void set_needs_layout();
+    void set_needs_layout(Badge<Layout::Node>);
 
     void invalidate_layout();
     void invalidate_stacking_context_tree();
@@ -681,6 +682,7 @@ private:
     virtual JS::GCPtr<EventTarget> global_event_handlers_to_event_target(FlyString const&) final { return *this; }
 
     void tear_down_layout_tree();
+    void schedule_relayout();
 
     void run_unloading_cleanup_steps();
 
@@ -791,6 +793,10 @@ private:
 
     bool m_needs_layout { false };
 
+    // Set when something that layout depends on has changed without telling us which layout nodes it affects,
+    // so nothing that previous layouts cached on the layout tree can be reused.
+    bool m_needs_to_discard_cached_layout_results { false };
+
     bool m_needs_full_style_update { false };
 
     bool m_needs_animated_style_update { false };
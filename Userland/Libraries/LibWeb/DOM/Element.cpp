@@ -446,7 +446,7 @@ void Element::run_attribute_change_steps(FlyString const& local_name, Optional<S
 
     // AD-HOC: Run our own internal attribute change handler.
     attribute_changed(local_name, value);
-    invalidate_style_after_attribute_change(local_name);
+    invalidate_style_after_attribute_change(local_name, old_value);
 
     document().bump_dom_tree_version();
 }
@@ -556,6 +556,8 @@ CSS::RequiredInvalidationAfterStyleChange Element::recompute_style()
     if (!invalidation.rebuild_layout_tree && layout_node()) {
         // If we're keeping the layout tree, we can just apply the new style to the existing layout tree.
         layout_node()->apply_style(*m_computed_css_values);
+        if (invalidation.relayout)
+            layout_node()->set_needs_layout();
         if (invalidation.repaint && paintable())
             paintable()->set_needs_display();
     }
@@ -1783,13 +1785,65 @@ ErrorOr<void> Element::scroll_into_view(Optional<Variant<bool, ScrollIntoViewOpt
     // FIXME: 8. Optionally perform some other action that brings the element to the user’s attention.
 }
 
-void Element::invalidate_style_after_attribute_change(FlyString const& attribute_name)
+void Element::invalidate_style_after_attribute_change(FlyString const& attribute_name, Optional<String> const& old_value)
 {
-    // FIXME: Only invalidate if the attribute can actually affect style.
-    (void)attribute_name;
+    // NOTE: There's nothing to be gained from looking at the style sheets if all of the element's style has to be
+    //       computed anyway.
+    if (document().needs_full_style_update())
+        return;
+    if (!is_connected()) {
+        invalidate_style();
+        return;
+    }
 
-    // FIXME: This will need to become smarter when we implement the :has() selector.
-    invalidate_style();
+    auto const& invalidation_data = document().style_computer().style_invalidation_data();
+    auto scope = invalidation_data.scope_for_attribute(attribute_name);
+
+    if (attribute_name == HTML::AttributeNames::class_) {
+        // NOTE: Only the classes that were added or removed can change which selectors match.
+        auto old_class_list = old_value.value_or(String {});
+        auto old_classes = old_class_list.bytes_as_string_view().split_view_if(Infra::is_ascii_whitespace);
+        for (auto const& old_class : old_classes) {
+            if (!m_classes.contains_slow(old_class))
+                scope = max(scope, invalidation_data.scope_for_class(MUST(FlyString::from_utf8(old_class))));
+        }
+        for (auto const& new_class : m_classes) {
+            if (!old_classes.contains_slow(new_class.bytes_as_string_view()))
+                scope = max(scope, invalidation_data.scope_for_class(new_class));
+        }
+    } else if (attribute_name == HTML::AttributeNames::id) {
+        if (old_value.has_value())
+            scope = max(scope, invalidation_data.scope_for_id(MUST(FlyString::from_utf8(*old_value))));
+        if (m_id.has_value())
+            scope = max(scope, invalidation_data.scope_for_id(*m_id));
+    } else if (attribute_name == HTML::AttributeNames::style) {
+        // NOTE: attribute_changed() already took care of the declarations of the element itself.
+    } else {
+        // FIXME: Any other attribute may affect presentational hints or the state of a pseudo-class, so for now,
+        //        we have to assume that it affects the whole subtree.
+        scope = max(scope, CSS::StyleInvalidationScope::Subtree);
+    }
+
+    switch (scope) {
+    case CSS::StyleInvalidationScope::None:
+        break;
+    case CSS::StyleInvalidationScope::Self:
+        // NOTE: Descendants that inherit from this element are updated along with it, see update_style_recursively().
+        set_needs_style_update(true);
+        break;
+    case CSS::StyleInvalidationScope::Subtree:
+        invalidate_style();
+        break;
+    case CSS::StyleInvalidationScope::Siblings:
+        if (auto* parent = parent_or_shadow_host())
+            parent->invalidate_style();
+        else
+            invalidate_style();
+        break;
+    case CSS::StyleInvalidationScope::Document:
+        document().invalidate_style();
+        break;
+    }
 }
 
 // https://www.w3.org/TR/wai-aria-1.2/#tree_exclusion
@@ -2074,13 +2128,13 @@ void Element::set_prefix(Optional<FlyString> value)
     m_qualified_name.set_prefix(move(value));
 }
 
-void Element::for_each_attribute(Function<void(Attr const&)> callback) const
+void Element::for_each_attribute(FunctionRef<void(Attr const&)> callback) const
 {
     for (size_t i = 0; i < m_attributes->length(); ++i)
         callback(*m_attributes->item(i));
 }
 
-void Element::for_each_attribute(Function<void(FlyString const&, String const&)> callback) const
+void Element::for_each_attribute(FunctionRef<void(FlyString const&, String const&)> callback) const
 {
     for_each_attribute([&callback](Attr const& attr) {
         callback(attr.name(), attr.value());
@@ -314,6 +314,12 @@ void dump_tree(StringBuilder& builder, Layout::Node const& layout_node, bool sho
 
         builder.appendff(" children: {}", box.children_are_inline() ? "inline" : "not-inline");
 
+        // NOTE: These depend on how often layout ran, so they are only shown in interactive dumps, not in test output.
+        if (interactive) {
+            if (auto const* intrinsic_sizes = box.cached_intrinsic_sizes_if_any())
+                builder.appendff(" (intrinsic size cache: {} hits, {} misses)", intrinsic_sizes->hit_count, intrinsic_sizes->miss_count);
+        }
+
         if (is<Layout::FrameBox>(box)) {
             auto const& frame_box = static_cast<Layout::FrameBox const&>(box);
             if (auto* nested_browsing_context = frame_box.dom_node().nested_browsing_context()) {
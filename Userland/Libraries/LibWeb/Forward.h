@@ -568,6 +568,7 @@ namespace Web::Painting {
 class AudioPaintable;
 class ButtonPaintable;
 class CheckBoxPaintable;
+class CommandList;
 class LabelablePaintable;
 class MediaPaintable;
 class Paintable;
@@ -8,32 +8,166 @@
 #include <LibJS/Heap/Heap.h>
 #include <LibJS/Runtime/Realm.h>
 #include <LibWeb/HTML/AnimatedBitmapDecodedImageData.h>
+#include <LibWeb/Platform/ImageCodecPlugin.h>
 
 namespace Web::HTML {
 
 JS_DEFINE_ALLOCATOR(AnimatedBitmapDecodedImageData);
 
+// Once the decoded frames of all discardable images take up more than this, the frames of the images that went unused
+// the longest are discarded.
+static constexpr size_t decoded_frames_memory_budget_in_bytes = 256 * MiB;
+
+// Images that were painted this recently are most likely still on screen, so they keep their frames even if that means
+// going over the budget. Otherwise, they would flicker while being decoded again.
+static constexpr auto minimum_time_unused_before_discarding = AK::Duration::from_seconds(1);
+
+static size_t s_size_of_decoded_frames_in_bytes = 0;
+
+// All discardable images that currently have their frames, least recently used first.
+static AnimatedBitmapDecodedImageData::List& images_with_decoded_frames()
+{
+    static AnimatedBitmapDecodedImageData::List list;
+    return list;
+}
+
 ErrorOr<JS::NonnullGCPtr<AnimatedBitmapDecodedImageData>> AnimatedBitmapDecodedImageData::create(JS::Realm& realm, Vector<Frame>&& frames, size_t loop_count, bool animated)
 {
     return realm.heap().allocate<AnimatedBitmapDecodedImageData>(realm, move(frames), loop_count, animated);
 }
 
-AnimatedBitmapDecodedImageData::AnimatedBitmapDecodedImageData(Vector<Frame>&& frames, size_t loop_count, bool animated)
+ErrorOr<JS::NonnullGCPtr<AnimatedBitmapDecodedImageData>> AnimatedBitmapDecodedImageData::create_discardable(JS::Realm& realm, Vector<Frame>&& frames, size_t loop_count, bool animated, ByteBuffer encoded_data, JS::NonnullGCPtr<JS::HeapFunction<void()>> on_frames_decoded_again)
+{
+    auto image_data = realm.heap().allocate<AnimatedBitmapDecodedImageData>(realm, move(frames), loop_count, animated, move(encoded_data), on_frames_decoded_again);
+    image_data->did_decode_frames();
+    return image_data;
+}
+
+AnimatedBitmapDecodedImageData::AnimatedBitmapDecodedImageData(Vector<Frame>&& frames, size_t loop_count, bool animated, ByteBuffer encoded_data, JS::GCPtr<JS::HeapFunction<void()>> on_frames_decoded_again)
     : m_frames(move(frames))
     , m_loop_count(loop_count)
     , m_animated(animated)
+    , m_size(m_frames.first().bitmap->size())
+    , m_encoded_data(move(encoded_data))
+    , m_on_frames_decoded_again(on_frames_decoded_again)
 {
 }
 
 AnimatedBitmapDecodedImageData::~AnimatedBitmapDecodedImageData() = default;
 
+void AnimatedBitmapDecodedImageData::finalize()
+{
+    Base::finalize();
+    if (m_list_node.is_in_list()) {
+        s_size_of_decoded_frames_in_bytes -= m_size_of_decoded_frames_in_bytes;
+        images_with_decoded_frames().remove(*this);
+    }
+}
+
+void AnimatedBitmapDecodedImageData::visit_edges(Cell::Visitor& visitor)
+{
+    Base::visit_edges(visitor);
+    visitor.visit(m_on_frames_decoded_again);
+}
+
 RefPtr<Gfx::ImmutableBitmap> AnimatedBitmapDecodedImageData::bitmap(size_t frame_index, Gfx::IntSize) const
 {
     if (frame_index >= m_frames.size())
         return nullptr;
+
+    if (is_discardable()) {
+        // NOTE: Giving up and getting back the frames doesn't change what this image is, only what it costs to keep around.
+        auto& self = const_cast<AnimatedBitmapDecodedImageData&>(*this);
+        if (m_has_discarded_frames) {
+            self.decode_frames_again();
+            return nullptr;
+        }
+        self.did_use_frames();
+    }
+
     return m_frames[frame_index].bitmap;
 }
 
+void AnimatedBitmapDecodedImageData::did_decode_frames()
+{
+    VERIFY(is_discardable());
+
+    m_size_of_decoded_frames_in_bytes = 0;
+    for (auto const& frame : m_frames)
+        m_size_of_decoded_frames_in_bytes += frame.bitmap->bitmap().size_in_bytes();
+    s_size_of_decoded_frames_in_bytes += m_size_of_decoded_frames_in_bytes;
+
+    m_has_discarded_frames = false;
+    did_use_frames();
+    discard_frames_over_budget();
+}
+
+void AnimatedBitmapDecodedImageData::did_use_frames()
+{
+    m_last_use = MonotonicTime::now_coarse();
+    images_with_decoded_frames().append(*this);
+}
+
+void AnimatedBitmapDecodedImageData::discard_frames()
+{
+    VERIFY(!m_has_discarded_frames);
+
+    // NOTE: Whatever still holds on to one of these bitmaps (e.g. a display list that hasn't been painted yet) keeps it
+    //       alive until it's done with it.
+    for (auto& frame : m_frames)
+        frame.bitmap = nullptr;
+
+    s_size_of_decoded_frames_in_bytes -= m_size_of_decoded_frames_in_bytes;
+    m_size_of_decoded_frames_in_bytes = 0;
+    m_has_discarded_frames = true;
+    images_with_decoded_frames().remove(*this);
+}
+
+void AnimatedBitmapDecodedImageData::discard_frames_over_budget()
+{
+    auto now = MonotonicTime::now_coarse();
+    auto& images = images_with_decoded_frames();
+
+    for (auto it = images.begin(); it != images.end() && s_size_of_decoded_frames_in_bytes > decoded_frames_memory_budget_in_bytes;) {
+        auto& image = *it;
+        ++it;
+
+        // The list is ordered by last use, so every image after this one was used even more recently.
+        if (now - image.m_last_use < minimum_time_unused_before_discarding)
+            break;
+        image.discard_frames();
+    }
+}
+
+void AnimatedBitmapDecodedImageData::decode_frames_again()
+{
+    if (m_is_decoding_frames_again)
+        return;
+    m_is_decoding_frames_again = true;
+
+    auto on_decoded = [strong_this = JS::Handle(*this)](Platform::DecodedImage& result) -> ErrorOr<void> {
+        auto& self = *strong_this;
+        self.m_is_decoding_frames_again = false;
+
+        // The encoded data didn't change, so this should never happen, but don't trust the decoder on that.
+        if (!self.m_has_discarded_frames || result.frames.size() != self.m_frames.size())
+            return {};
+
+        for (size_t i = 0; i < result.frames.size(); ++i)
+            self.m_frames[i].bitmap = Gfx::ImmutableBitmap::create(*result.frames[i].bitmap);
+        self.did_decode_frames();
+
+        self.m_on_frames_decoded_again->function()();
+        return {};
+    };
+
+    auto on_failed = [strong_this = JS::Handle(*this)](Error&) {
+        strong_this->m_is_decoding_frames_again = false;
+    };
+
+    (void)Platform::ImageCodecPlugin::the().decode_image(m_encoded_data.bytes(), move(on_decoded), move(on_failed));
+}
+
 int AnimatedBitmapDecodedImageData::frame_duration(size_t frame_index) const
 {
     if (frame_index >= m_frames.size())
@@ -43,17 +177,17 @@ int AnimatedBitmapDecodedImageData::frame_duration(size_t frame_index) const
 
 Optional<CSSPixels> AnimatedBitmapDecodedImageData::intrinsic_width() const
 {
-    return m_frames.first().bitmap->width();
+    return m_size.width();
 }
 
 Optional<CSSPixels> AnimatedBitmapDecodedImageData::intrinsic_height() const
 {
-    return m_frames.first().bitmap->height();
+    return m_size.height();
 }
 
 Optional<CSSPixelFraction> AnimatedBitmapDecodedImageData::intrinsic_aspect_ratio() const
 {
-    return CSSPixels(m_frames.first().bitmap->width()) / CSSPixels(m_frames.first().bitmap->height());
+    return CSSPixels(m_size.width()) / CSSPixels(m_size.height());
 }
 
 }
@@ -6,7 +6,11 @@
 
 #pragma once
 
+#include <AK/ByteBuffer.h>
+#include <AK/IntrusiveList.h>
+#include <AK/Time.h>
 #include <LibGfx/ImmutableBitmap.h>
+#include <LibJS/Heap/HeapFunction.h>
 #include <LibWeb/HTML/DecodedImageData.h>
 
 namespace Web::HTML {
@@ -22,6 +26,11 @@ public:
     };
 
     static ErrorOr<JS::NonnullGCPtr<AnimatedBitmapDecodedImageData>> create(JS::Realm&, Vector<Frame>&&, size_t loop_count, bool animated);
+
+    // Images that keep their encoded data can give up their decoded frames when over the memory budget, and decode
+    // them again the next time they're painted. `on_frames_decoded_again` is invoked once that has happened.
+    static ErrorOr<JS::NonnullGCPtr<AnimatedBitmapDecodedImageData>> create_discardable(JS::Realm&, Vector<Frame>&&, size_t loop_count, bool animated, ByteBuffer encoded_data, JS::NonnullGCPtr<JS::HeapFunction<void()>> on_frames_decoded_again);
+
     virtual ~AnimatedBitmapDecodedImageData() override;
 
     virtual RefPtr<Gfx::ImmutableBitmap> bitmap(size_t frame_index, Gfx::IntSize = {}) const override;
@@ -36,11 +45,39 @@ public:
     virtual Optional<CSSPixelFraction> intrinsic_aspect_ratio() const override;
 
 private:
-    AnimatedBitmapDecodedImageData(Vector<Frame>&&, size_t loop_count, bool animated);
+    AnimatedBitmapDecodedImageData(Vector<Frame>&&, size_t loop_count, bool animated, ByteBuffer encoded_data = {}, JS::GCPtr<JS::HeapFunction<void()>> on_frames_decoded_again = {});
+
+    virtual void finalize() override;
+    virtual void visit_edges(Cell::Visitor&) override;
+
+    bool is_discardable() const { return !m_encoded_data.is_empty(); }
+
+    void did_decode_frames();
+    void did_use_frames();
+    void discard_frames();
+    void decode_frames_again();
+
+    static void discard_frames_over_budget();
 
     Vector<Frame> m_frames;
     size_t m_loop_count { 0 };
     bool m_animated { false };
+
+    // The size of the first frame, which stays known while the frames are discarded.
+    Gfx::IntSize m_size;
+
+    ByteBuffer m_encoded_data;
+    JS::GCPtr<JS::HeapFunction<void()>> m_on_frames_decoded_again;
+
+    size_t m_size_of_decoded_frames_in_bytes { 0 };
+    MonotonicTime m_last_use { MonotonicTime::now_coarse() };
+    bool m_has_discarded_frames { false };
+    bool m_is_decoding_frames_again { false };
+
+    IntrusiveListNode<AnimatedBitmapDecodedImageData> m_list_node;
+
+public:
+    using List = IntrusiveList<&AnimatedBitmapDecodedImageData::m_list_node>;
 };
 
 }
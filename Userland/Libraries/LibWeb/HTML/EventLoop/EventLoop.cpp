@@ -16,6 +16,7 @@
 #include <LibWeb/HighResolutionTime/Performance.h>
 #include <LibWeb/HighResolutionTime/TimeOrigin.h>
 #include <LibWeb/Page/Page.h>
+#include <LibWeb/PhaseTimer.h>
 #include <LibWeb/Platform/EventLoopPlugin.h>
 #include <LibWeb/Platform/Timer.h>
 
@@ -159,6 +160,8 @@ void EventLoop::process()
     oldest_task = task_queue.take_first_runnable();
 
     if (oldest_task) {
+        TraceScope trace_scope { "task"sv };
+
         // 5. Set the event loop's currently running task to oldestTask.
         m_currently_running_task = oldest_task.ptr();
 
@@ -186,6 +189,9 @@ void EventLoop::process()
     // FIXME:     3. Report long tasks, passing in taskStartTime, now (the end time of the task), top-level browsing contexts, and oldestTask.
 
     // FIXME: 12. Update the rendering: if this is a window event loop, then:
+    Optional<MonotonicTime> rendering_started_at;
+    if (is_rendering_trace_enabled())
+        rendering_started_at = MonotonicTime::now();
 
     // FIXME:     1. Let docs be all Document objects whose relevant agent's event loop is this event loop, sorted arbitrarily except that the following conditions must be met:
     //               - Any Document B whose browsing context's container document is A must be listed after A in the list.
@@ -334,6 +340,9 @@ void EventLoop::process()
         }
     });
 
+    if (rendering_started_at.has_value())
+        record_trace_event("update-the-rendering"sv, *rendering_started_at);
+
     // 13. If all of the following are true
     // - this is a window event loop
     // - there is no task in this event loop's task queues whose document is fully active
@@ -351,6 +360,9 @@ void EventLoop::process()
         //    perform the start an idle period algorithm for win with computeDeadline. [REQUESTIDLECALLBACK]
         for (auto& win : same_loop_windows())
             win->start_an_idle_period();
+
+        // NOTE: Nothing is waiting to run, so this is the least noticeable time to collect garbage.
+        heap().did_become_idle();
     }
 
     // FIXME: 14. If this is a worker event loop, then:
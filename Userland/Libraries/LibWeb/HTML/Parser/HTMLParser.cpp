@@ -22,6 +22,7 @@
 #include <LibWeb/DOM/ProcessingInstruction.h>
 #include <LibWeb/DOM/QualifiedName.h>
 #include <LibWeb/DOM/Text.h>
+#include <LibWeb/DOMURL/DOMURL.h>
 #include <LibWeb/HTML/CustomElements/CustomElementDefinition.h>
 #include <LibWeb/HTML/EventLoop/EventLoop.h>
 #include <LibWeb/HTML/EventNames.h>
@@ -37,8 +38,10 @@
 #include <LibWeb/HighResolutionTime/TimeOrigin.h>
 #include <LibWeb/Infra/CharacterTypes.h>
 #include <LibWeb/Infra/Strings.h>
+#include <LibWeb/Loader/ResourceLoader.h>
 #include <LibWeb/MathML/TagNames.h>
 #include <LibWeb/Namespace.h>
+#include <LibWeb/PhaseTimer.h>
 #include <LibWeb/SVG/SVGScriptElement.h>
 #include <LibWeb/SVG/TagNames.h>
 
@@ -171,6 +174,8 @@ void HTMLParser::visit_edges(Cell::Visitor& visitor)
 
 void HTMLParser::run(HTMLTokenizer::StopAtInsertionPoint stop_at_insertion_point)
 {
+    PhaseTimer phase_timer { Phase::HTMLParsing };
+
     for (;;) {
         // FIXME: Find a better way to say that we come from Document::close() and want to process EOF.
         if (!m_tokenizer.is_eof_inserted() && m_tokenizer.is_insertion_point_reached())
@@ -2743,6 +2748,103 @@ void HTMLParser::decrement_script_nesting_level()
     --m_script_nesting_level;
 }
 
+// https://html.spec.whatwg.org/multipage/parsing.html#start-the-speculative-html-parser
+void HTMLParser::start_the_speculative_html_parser()
+{
+    // NOTE: Instead of building a tree of speculative mock elements in parallel, we tokenize the rest of the input right
+    //       away. That is cheap compared to waiting for the script that blocks the parser, and the only tree
+    //       construction state that matters for finding the resources is which elements switch the tokenizer into a
+    //       text state. As this runs to completion, there is nothing to do when the speculative parser is stopped.
+    if (!m_document->browsing_context())
+        return;
+
+    // NOTE: The end of the input has been looked at by an earlier run already, so only look at what document.write()
+    //       inserted in front of it since then.
+    auto input = m_tokenizer.unprocessed_input();
+    if (input.length() <= m_length_of_input_seen_by_speculative_parser)
+        return;
+    auto unseen_input = input.substring_view(0, input.length() - m_length_of_input_seen_by_speculative_parser);
+    m_length_of_input_seen_by_speculative_parser = input.length();
+
+    HTMLTokenizer speculative_tokenizer { unseen_input, "utf-8"sv };
+    for (;;) {
+        auto token = speculative_tokenizer.next_token();
+        if (!token.has_value() || token->is_end_of_file())
+            break;
+        if (!token->is_start_tag())
+            continue;
+
+        speculatively_fetch(*token);
+
+        auto const& tag_name = token->tag_name();
+        if (tag_name == HTML::TagNames::script)
+            speculative_tokenizer.switch_to(HTMLTokenizer::State::ScriptData);
+        else if (tag_name.is_one_of(HTML::TagNames::title, HTML::TagNames::textarea))
+            speculative_tokenizer.switch_to(HTMLTokenizer::State::RCDATA);
+        else if (tag_name.is_one_of(HTML::TagNames::style, HTML::TagNames::xmp, HTML::TagNames::iframe, HTML::TagNames::noembed, HTML::TagNames::noframes)
+            || (tag_name == HTML::TagNames::noscript && m_scripting_enabled))
+            speculative_tokenizer.switch_to(HTMLTokenizer::State::RAWTEXT);
+        else if (tag_name == HTML::TagNames::plaintext)
+            speculative_tokenizer.switch_to(HTMLTokenizer::State::PLAINTEXT);
+    }
+}
+
+// https://html.spec.whatwg.org/multipage/parsing.html#speculative-fetch
+void HTMLParser::speculatively_fetch(HTMLToken const& token)
+{
+    auto const& tag_name = token.tag_name();
+
+    auto resolve_url = [&](FlyString const& attribute_name) -> Optional<URL::URL> {
+        auto value = token.attribute(attribute_name);
+        if (!value.has_value())
+            return {};
+        auto url = DOMURL::parse(*value, m_speculative_base_url.value_or(m_document->base_url()));
+        if (!url.is_valid())
+            return {};
+        return url;
+    };
+
+    // NOTE: Only the first base element with an href attribute sets the document base URL.
+    if (tag_name == HTML::TagNames::base) {
+        if (!m_speculative_base_url.has_value() && !m_document->first_base_element_with_href_in_tree_order())
+            m_speculative_base_url = resolve_url(HTML::AttributeNames::href);
+        return;
+    }
+
+    Optional<URL::URL> url;
+    bool is_preload = false;
+    if (tag_name.is_one_of(HTML::TagNames::script, HTML::TagNames::img)) {
+        url = resolve_url(HTML::AttributeNames::src);
+    } else if (tag_name == HTML::TagNames::link) {
+        auto rel = MUST(Infra::to_ascii_lowercase(token.attribute(HTML::AttributeNames::rel).value_or(String {})));
+        for (auto keyword : rel.bytes_as_string_view().split_view_if(Infra::is_ascii_whitespace)) {
+            if (keyword.is_one_of("stylesheet"sv, "preload"sv)) {
+                url = resolve_url(HTML::AttributeNames::href);
+                is_preload = keyword == "preload"sv;
+                break;
+            }
+        }
+    }
+    if (!url.has_value())
+        return;
+
+    // If url is already in the list of speculative fetch URLs, return.
+    if (m_speculative_fetch_urls.set(*url) != HashSetResult::InsertedNewEntry)
+        return;
+
+    // NOTE: Preloads go through ResourceLoader's resource cache, just like the ones that HTMLLinkElement starts, so
+    //       the link element picks up the response of this fetch once it gets inserted. Everything else is fetched
+    //       without a cache for now, so fetching it twice would only waste bandwidth. We set up a connection to its
+    //       origin instead.
+    if (is_preload) {
+        LoadRequest request;
+        request.set_url(*url);
+        (void)ResourceLoader::the().load_resource(Resource::Type::Generic, request);
+    } else {
+        ResourceLoader::the().preconnect(*url);
+    }
+}
+
 // https://html.spec.whatwg.org/multipage/parsing.html#parsing-main-incdata
 void HTMLParser::handle_text(HTMLToken& token)
 {
@@ -2826,7 +2928,8 @@ void HTMLParser::handle_text(HTMLToken& token)
                     // 2. Set the pending parsing-blocking script to null.
                     auto the_script = document().take_pending_parsing_blocking_script({});
 
-                    // FIXME: 3. Start the speculative HTML parser for this instance of the HTML parser.
+                    // 3. Start the speculative HTML parser for this instance of the HTML parser.
+                    start_the_speculative_html_parser();
 
                     // 4. Block the tokenizer for this instance of the HTML parser, such that the event loop will not run tasks that invoke the tokenizer.
                     m_tokenizer.set_blocked(true);
@@ -2845,7 +2948,8 @@ void HTMLParser::handle_text(HTMLToken& token)
                     if (m_aborted)
                         return;
 
-                    // FIXME: 7. Stop the speculative HTML parser for this instance of the HTML parser.
+                    // 7. Stop the speculative HTML parser for this instance of the HTML parser.
+                    // NOTE: Our speculative HTML parser has already run to completion.
 
                     // 8. Unblock the tokenizer for this instance of the HTML parser, such that tasks that invoke the tokenizer can again be run.
                     m_tokenizer.set_blocked(false);
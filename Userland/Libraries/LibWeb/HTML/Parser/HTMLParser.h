@@ -146,6 +146,8 @@ private:
     void parse_generic_raw_text_element(HTMLToken&);
     void increment_script_nesting_level();
     void decrement_script_nesting_level();
+    void start_the_speculative_html_parser();
+    void speculatively_fetch(HTMLToken const&);
     void reset_the_insertion_mode_appropriately();
 
     void adjust_mathml_attributes(HTMLToken&);
@@ -187,6 +189,14 @@ private:
     bool m_stop_parsing { false };
     size_t m_script_nesting_level { 0 };
 
+    // https://html.spec.whatwg.org/multipage/parsing.html#list-of-speculative-fetch-urls
+    HashTable<URL::URL> m_speculative_fetch_urls;
+    Optional<URL::URL> m_speculative_base_url;
+
+    // How much of the end of the input the speculative HTML parser has already looked at. Everything else in front of
+    // it was inserted by document.write() since then.
+    size_t m_length_of_input_seen_by_speculative_parser { 0 };
+
     JS::Realm& realm();
 
     JS::GCPtr<DOM::Document> m_document;
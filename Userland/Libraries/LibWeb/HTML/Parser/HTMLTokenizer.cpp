@@ -155,6 +155,8 @@ namespace Web::HTML {
     do {                                                \
         create_new_token(HTMLToken::Type::Character);   \
         m_current_token.set_code_point(code_point);     \
+        if (m_queued_tokens.is_empty())                 \
+            return move(m_current_token);               \
         m_queued_tokens.enqueue(move(m_current_token)); \
         return m_queued_tokens.dequeue();               \
     } while (0)
@@ -198,20 +200,19 @@ Optional<u32> HTMLTokenizer::next_code_point()
     if (m_utf8_iterator == m_utf8_view.end())
         return {};
 
-    u32 code_point;
+    u32 code_point = *m_utf8_iterator;
     // https://html.spec.whatwg.org/multipage/parsing.html#preprocessing-the-input-stream:tokenization
     // https://infra.spec.whatwg.org/#normalize-newlines
-    if (peek_code_point(0).value_or(0) == '\r' && peek_code_point(1).value_or(0) == '\n') {
+    if (code_point == '\r' && peek_code_point(1).value_or(0) == '\n') {
         // replace every U+000D CR U+000A LF code point pair with a single U+000A LF code point,
         skip(2);
         code_point = '\n';
-    } else if (peek_code_point(0).value_or(0) == '\r') {
+    } else if (code_point == '\r') {
         // replace every remaining U+000D CR code point with a U+000A LF code point.
         skip(1);
         code_point = '\n';
     } else {
         skip(1);
-        code_point = *m_prev_utf8_iterator;
     }
 
     dbgln_if(TOKENIZER_TRACE_DEBUG, "(Tokenizer) Next code_point: {}", code_point);
@@ -238,6 +239,38 @@ void HTMLTokenizer::skip(size_t count)
     }
 }
 
+// NOTE: Attribute values are mostly made of ASCII code points that the attribute value states just append to the current
+//       builder one by one. This appends a whole run of those in one go, up to the next code point that needs to go
+//       through the state machine, and updates the source positions as if they had been consumed one by one.
+void HTMLTokenizer::consume_plain_ascii_run_into_current_builder(char quote)
+{
+    auto offset = m_utf8_view.byte_offset_of(m_utf8_iterator);
+    auto end = m_utf8_view.byte_length();
+    if (m_insertion_point.defined)
+        end = min(end, max(offset, m_insertion_point.position));
+
+    auto const* bytes = m_utf8_view.bytes();
+    size_t length = 0;
+    while (offset + length < end) {
+        auto byte = bytes[offset + length];
+        if (!is_ascii(byte) || byte == quote || byte == '&' || byte == '\0' || byte == '\r' || byte == '\n')
+            break;
+        ++length;
+    }
+    if (length == 0)
+        return;
+
+    m_current_builder.append(StringView { bytes + offset, length });
+
+    if (!m_source_positions.is_empty()) {
+        m_source_positions.append(m_source_positions.last());
+        m_source_positions.last().column += length;
+        m_source_positions.last().byte_offset += length;
+    }
+    m_prev_utf8_iterator = m_utf8_view.iterator_at_byte_offset_without_validation(offset + length - 1);
+    m_utf8_iterator = m_utf8_view.iterator_at_byte_offset_without_validation(offset + length);
+}
+
 Optional<u32> HTMLTokenizer::peek_code_point(size_t offset) const
 {
     auto it = m_utf8_iterator;
@@ -1272,6 +1305,7 @@ _StartOfFunction:
                 ANYTHING_ELSE
                 {
                     m_current_builder.append_code_point(current_input_character.value());
+                    consume_plain_ascii_run_into_current_builder('"');
                     continue;
                 }
             }
@@ -1304,6 +1338,7 @@ _StartOfFunction:
                 ANYTHING_ELSE
                 {
                     m_current_builder.append_code_point(current_input_character.value());
+                    consume_plain_ascii_run_into_current_builder('\'');
                     continue;
                 }
             }
@@ -130,6 +130,9 @@ public:
 
     ByteString source() const { return m_decoded_input; }
 
+    // The part of the input that hasn't been tokenized yet.
+    StringView unprocessed_input() const { return m_decoded_input.substring_view(m_utf8_view.byte_offset_of(m_utf8_iterator)); }
+
     void insert_input_at_insertion_point(StringView input);
     void insert_eof();
     bool is_eof_inserted();
@@ -155,6 +158,7 @@ private:
     void skip(size_t count);
     Optional<u32> next_code_point();
     Optional<u32> peek_code_point(size_t offset) const;
+    void consume_plain_ascii_run_into_current_builder(char quote);
     bool consume_next_if_match(StringView, CaseSensitivity = CaseSensitivity::CaseSensitive);
     void create_new_token(HTMLToken::Type);
     bool current_end_tag_token_is_appropriate() const;
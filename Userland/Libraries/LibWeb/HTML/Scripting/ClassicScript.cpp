@@ -11,6 +11,7 @@
 #include <LibWeb/HTML/Scripting/ClassicScript.h>
 #include <LibWeb/HTML/Scripting/Environments.h>
 #include <LibWeb/HTML/Scripting/ExceptionReporter.h>
+#include <LibWeb/PhaseTimer.h>
 #include <LibWeb/WebIDL/DOMException.h>
 
 namespace Web::HTML {
@@ -83,6 +84,8 @@ JS::Completion ClassicScript::run(RethrowErrors rethrow_errors, JS::GCPtr<JS::En
     if (settings.can_run_script() == RunScriptDecision::DoNotRun)
         return JS::normal_completion({});
 
+    PhaseTimer phase_timer { Phase::JavaScript };
+
     // 3. Prepare to run script given settings.
     settings.prepare_to_run_script();
 
@@ -8,6 +8,7 @@
 #include <LibWeb/HTML/Scripting/Environments.h>
 #include <LibWeb/HTML/Scripting/Fetching.h>
 #include <LibWeb/HTML/Scripting/ModuleScript.h>
+#include <LibWeb/PhaseTimer.h>
 #include <LibWeb/WebIDL/DOMException.h>
 #include <LibWeb/WebIDL/ExceptionOr.h>
 
@@ -130,6 +131,8 @@ JS::Promise* JavaScriptModuleScript::run(PreventErrorReporting)
         return promise;
     }
 
+    PhaseTimer phase_timer { Phase::JavaScript };
+
     // 3. Prepare to run script given settings.
     settings.prepare_to_run_script();
 
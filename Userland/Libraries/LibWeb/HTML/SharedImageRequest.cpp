@@ -12,6 +12,7 @@
 #include <LibWeb/Fetch/Infrastructure/HTTP/Responses.h>
 #include <LibWeb/HTML/AnimatedBitmapDecodedImageData.h>
 #include <LibWeb/HTML/DecodedImageData.h>
+#include <LibWeb/HTML/Navigable.h>
 #include <LibWeb/HTML/SharedImageRequest.h>
 #include <LibWeb/Page/Page.h>
 #include <LibWeb/Platform/ImageCodecPlugin.h>
@@ -169,7 +170,8 @@ void SharedImageRequest::handle_successful_fetch(URL::URL const& url_string, Str
         return;
     }
 
-    auto handle_successful_bitmap_decode = [strong_this = JS::Handle(*this), handle_successful_decode = move(handle_successful_decode)](Web::Platform::DecodedImage& result) -> ErrorOr<void> {
+    // NOTE: The encoded data is kept, so that the decoded frames can be discarded and decoded again when we're low on memory.
+    auto handle_successful_bitmap_decode = [strong_this = JS::Handle(*this), encoded_data = data, handle_successful_decode = move(handle_successful_decode)](Web::Platform::DecodedImage& result) mutable -> ErrorOr<void> {
         Vector<AnimatedBitmapDecodedImageData::Frame> frames;
         for (auto& frame : result.frames) {
             frames.append(AnimatedBitmapDecodedImageData::Frame {
@@ -177,7 +179,12 @@ void SharedImageRequest::handle_successful_fetch(URL::URL const& url_string, Str
                 .duration = static_cast<int>(frame.duration),
             });
         }
-        strong_this->m_image_data = AnimatedBitmapDecodedImageData::create(strong_this->m_document->realm(), move(frames), result.loop_count, result.is_animated).release_value_but_fixme_should_propagate_errors();
+        auto& realm = strong_this->m_document->realm();
+        auto on_frames_decoded_again = JS::create_heap_function(realm.heap(), [document = strong_this->m_document] {
+            if (auto navigable = document->navigable())
+                navigable->set_needs_display();
+        });
+        strong_this->m_image_data = AnimatedBitmapDecodedImageData::create_discardable(realm, move(frames), result.loop_count, result.is_animated, move(encoded_data), on_frames_decoded_again).release_value_but_fixme_should_propagate_errors();
         handle_successful_decode(*strong_this);
         return {};
     };
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibJS/Runtime/Shape.h>
 #include <LibJS/Runtime/VM.h>
 #include <LibWeb/Bindings/InternalsPrototype.h>
 #include <LibWeb/Bindings/Intrinsics.h>
@@ -62,6 +63,26 @@ JS::Object* Internals::hit_test(double x, double y)
     return nullptr;
 }
 
+JS::Object* Internals::shape_memory_report()
+{
+    auto report = JS::Shape::memory_report();
+    auto result = JS::Object::create(realm(), nullptr);
+    auto define = [&](char const* name, size_t value) {
+        result->define_direct_property(name, JS::Value(value), JS::default_attributes);
+    };
+    define("shapes", report.shapes);
+    define("dictionaryShapes", report.dictionary_shapes);
+    define("prototypeShapes", report.prototype_shapes);
+    define("shapesWithPropertyTable", report.shapes_with_property_table);
+    define("shapesSharingPropertyTable", report.shapes_sharing_property_table);
+    define("propertyTables", report.property_tables);
+    define("propertyTableEntries", report.property_table_entries);
+    define("inlineForwardTransitions", report.inline_forward_transitions);
+    define("forwardTransitionTables", report.forward_transition_tables);
+    define("forwardTransitionTableEntries", report.forward_transition_table_entries);
+    return result;
+}
+
 void Internals::send_text(HTML::HTMLElement& target, String const& text)
 {
     auto& page = global_object().browsing_context()->page();
@@ -22,6 +22,7 @@ public:
 
     void gc();
     JS::Object* hit_test(double x, double y);
+    JS::Object* shape_memory_report();
 
     void send_text(HTML::HTMLElement&, String const&);
     void commit_text();
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/HashMap.h>
 #include <AK/OwnPtr.h>
 #include <LibGfx/Rect.h>
 #include <LibJS/Heap/Cell.h>
@@ -54,6 +55,30 @@ public:
 
     bool is_user_scrollable() const;
 
+    // We cache intrinsic sizes once determined, as they only depend on the box's own style and contents.
+    // This avoids computing them several times while performing flex layout, and lets later layouts reuse them until
+    // Node::set_needs_layout() is called on this box or one of its descendants.
+    struct IntrinsicSizes {
+        Optional<CSSPixels> min_content_width;
+        Optional<CSSPixels> max_content_width;
+
+        HashMap<CSSPixels, Optional<CSSPixels>> min_content_height;
+        HashMap<CSSPixels, Optional<CSSPixels>> max_content_height;
+
+        // How often the sizes above were looked up, and how often they had to be computed. Shown in layout tree dumps.
+        u32 hit_count { 0 };
+        u32 miss_count { 0 };
+    };
+
+    IntrinsicSizes& cached_intrinsic_sizes() const
+    {
+        if (!m_cached_intrinsic_sizes)
+            m_cached_intrinsic_sizes = make<IntrinsicSizes>();
+        return *m_cached_intrinsic_sizes;
+    }
+    IntrinsicSizes const* cached_intrinsic_sizes_if_any() const { return m_cached_intrinsic_sizes; }
+    void reset_cached_intrinsic_sizes() const { m_cached_intrinsic_sizes = nullptr; }
+
 protected:
     Box(DOM::Document&, DOM::Node*, NonnullRefPtr<CSS::StyleProperties>);
     Box(DOM::Document&, DOM::Node*, NonnullOwnPtr<CSS::ComputedValues>);
@@ -64,6 +89,8 @@ private:
     Optional<CSSPixels> m_natural_width;
     Optional<CSSPixels> m_natural_height;
     Optional<CSSPixelFraction> m_natural_aspect_ratio;
+
+    OwnPtr<IntrinsicSizes> mutable m_cached_intrinsic_sizes;
 };
 
 template<>
@@ -1440,11 +1440,12 @@ CSSPixels FormattingContext::calculate_min_content_width(Layout::Box const& box)
     if (box.has_natural_width())
         return *box.natural_width();
 
-    auto& root_state = m_state.m_root;
-
-    auto& cache = *root_state.intrinsic_sizes.ensure(&box, [] { return adopt_own(*new LayoutState::IntrinsicSizes); });
-    if (cache.min_content_width.has_value())
+    auto& cache = box.cached_intrinsic_sizes();
+    if (cache.min_content_width.has_value()) {
+        ++cache.hit_count;
         return *cache.min_content_width;
+    }
+    ++cache.miss_count;
 
     LayoutState throwaway_state(&m_state);
 
@@ -1478,11 +1479,12 @@ CSSPixels FormattingContext::calculate_max_content_width(Layout::Box const& box)
     if (box.has_natural_width())
         return *box.natural_width();
 
-    auto& root_state = m_state.m_root;
-
-    auto& cache = *root_state.intrinsic_sizes.ensure(&box, [] { return adopt_own(*new LayoutState::IntrinsicSizes); });
-    if (cache.max_content_width.has_value())
+    auto& cache = box.cached_intrinsic_sizes();
+    if (cache.max_content_width.has_value()) {
+        ++cache.hit_count;
         return *cache.max_content_width;
+    }
+    ++cache.miss_count;
 
     LayoutState throwaway_state(&m_state);
 
@@ -1522,13 +1524,15 @@ CSSPixels FormattingContext::calculate_min_content_height(Layout::Box const& box
         return *box.natural_height();
 
     auto get_cache_slot = [&]() -> Optional<CSSPixels>* {
-        auto& root_state = m_state.m_root;
-        auto& cache = *root_state.intrinsic_sizes.ensure(&box, [] { return adopt_own(*new LayoutState::IntrinsicSizes); });
+        auto& cache = box.cached_intrinsic_sizes();
         return &cache.min_content_height.ensure(width);
     };
 
-    if (auto* cache_slot = get_cache_slot(); cache_slot && cache_slot->has_value())
+    if (auto* cache_slot = get_cache_slot(); cache_slot && cache_slot->has_value()) {
+        ++box.cached_intrinsic_sizes().hit_count;
         return cache_slot->value();
+    }
+    ++box.cached_intrinsic_sizes().miss_count;
 
     LayoutState throwaway_state(&m_state);
 
@@ -1566,13 +1570,15 @@ CSSPixels FormattingContext::calculate_max_content_height(Layout::Box const& box
         return *box.natural_height();
 
     auto get_cache_slot = [&]() -> Optional<CSSPixels>* {
-        auto& root_state = m_state.m_root;
-        auto& cache = *root_state.intrinsic_sizes.ensure(&box, [] { return adopt_own(*new LayoutState::IntrinsicSizes); });
+        auto& cache = box.cached_intrinsic_sizes();
         return &cache.max_content_height.ensure(width);
     };
 
-    if (auto* cache_slot = get_cache_slot(); cache_slot && cache_slot->has_value())
+    if (auto* cache_slot = get_cache_slot(); cache_slot && cache_slot->has_value()) {
+        ++box.cached_intrinsic_sizes().hit_count;
         return cache_slot->value();
+    }
+    ++box.cached_intrinsic_sizes().miss_count;
 
     LayoutState throwaway_state(&m_state);
 
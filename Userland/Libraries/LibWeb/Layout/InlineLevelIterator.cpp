@@ -195,14 +195,9 @@ Optional<InlineLevelIterator::Item> InlineLevelIterator::next_without_lookahead(
             };
         }
 
-        Vector<Gfx::DrawGlyphOrEmoji> glyph_run;
-        float glyph_run_width = 0;
-        Gfx::for_each_glyph_position(
-            { 0, 0 }, chunk.view, text_node.computed_values().font_list(), [&](Gfx::DrawGlyphOrEmoji const& glyph_or_emoji) {
-                glyph_run.append(glyph_or_emoji);
-                return IterationDecision::Continue;
-            },
-            Gfx::IncludeLeftBearing::No, glyph_run_width);
+        auto const& shaped_chunk = text_node.shaped_chunk(chunk);
+        auto glyph_run = shaped_chunk.glyph_run;
+        float glyph_run_width = shaped_chunk.width;
 
         if (!m_text_node_context->is_last_chunk)
             glyph_run_width += text_node.first_available_font().glyph_spacing();
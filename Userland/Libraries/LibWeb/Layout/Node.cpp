@@ -987,6 +987,16 @@ void Node::set_paintable(JS::GCPtr<Painting::Paintable> paintable)
     m_paintable = move(paintable);
 }
 
+void Node::set_needs_layout()
+{
+    // NOTE: The intrinsic sizes of a box depend on its contents, so they are stale for this node and all its ancestors.
+    for (auto* ancestor = this; ancestor; ancestor = ancestor->parent()) {
+        if (is<Box>(*ancestor))
+            static_cast<Box const&>(*ancestor).reset_cached_intrinsic_sizes();
+    }
+    document().set_needs_layout({});
+}
+
 JS::GCPtr<Painting::Paintable> Node::create_paintable() const
 {
     return nullptr;
@@ -70,6 +70,10 @@ public:
 
     virtual JS::GCPtr<Painting::Paintable> create_paintable() const;
 
+    // Schedules a layout update after something that affects the layout of this node has changed. Unlike
+    // DOM::Document::set_needs_layout(), this keeps whatever was cached about boxes outside the ancestor chain.
+    void set_needs_layout();
+
     DOM::Document& document();
     DOM::Document const& document() const;
 
@@ -304,6 +304,7 @@ static ErrorOr<String> apply_text_transform(String const& string, CSS::TextTrans
 void TextNode::invalidate_text_for_rendering()
 {
     m_text_for_rendering = {};
+    m_shaped_chunks.clear();
 }
 
 String const& TextNode::text_for_rendering() const
@@ -313,9 +314,34 @@ String const& TextNode::text_for_rendering() const
     return *m_text_for_rendering;
 }
 
+TextNode::ShapedChunk const& TextNode::shaped_chunk(Chunk const& chunk) const
+{
+    auto const& font_list = computed_values().font_list();
+    if (m_font_list_of_shaped_chunks != &font_list) {
+        m_shaped_chunks.clear();
+        m_font_list_of_shaped_chunks = font_list;
+    }
+
+    auto& shaped_chunk = m_shaped_chunks.ensure(chunk.start, [] { return ShapedChunk { .length = NumericLimits<size_t>::max() }; });
+    if (shaped_chunk.length == chunk.length)
+        return shaped_chunk;
+
+    shaped_chunk.length = chunk.length;
+    shaped_chunk.glyph_run.clear_with_capacity();
+    Gfx::for_each_glyph_position(
+        { 0, 0 }, chunk.view, font_list, [&](Gfx::DrawGlyphOrEmoji const& glyph_or_emoji) {
+            shaped_chunk.glyph_run.append(glyph_or_emoji);
+            return IterationDecision::Continue;
+        },
+        Gfx::IncludeLeftBearing::No, shaped_chunk.width);
+    return shaped_chunk;
+}
+
 // NOTE: This collapses whitespace into a single ASCII space if the CSS white-space property tells us to.
 void TextNode::compute_text_for_rendering()
 {
+    m_shaped_chunks.clear();
+
     bool collapse = [](CSS::WhiteSpace white_space) {
         switch (white_space) {
         case CSS::WhiteSpace::Normal:
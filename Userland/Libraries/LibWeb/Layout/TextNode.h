@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include <AK/HashMap.h>
 #include <AK/Utf8View.h>
+#include <LibGfx/TextLayout.h>
 #include <LibWeb/DOM/Text.h>
 #include <LibWeb/Layout/Node.h>
 
@@ -51,12 +53,28 @@ public:
     void invalidate_text_for_rendering();
     void compute_text_for_rendering();
 
+    // The glyphs of a chunk, positioned relative to the start of the chunk, and their total width.
+    struct ShapedChunk {
+        size_t length { 0 };
+        Vector<Gfx::DrawGlyphOrEmoji> glyph_run;
+        float width { 0 };
+    };
+
+    // NOTE: Shaping a chunk only depends on its text and the font list, so the result is kept until either changes.
+    //       This avoids shaping the same text again every time it is laid out, which happens several times per layout
+    //       when intrinsic sizes are computed.
+    ShapedChunk const& shaped_chunk(Chunk const&) const;
+
     virtual JS::GCPtr<Painting::Paintable> create_paintable() const override;
 
 private:
     virtual bool is_text_node() const final { return true; }
 
     Optional<String> m_text_for_rendering;
+
+    // Keyed by the offset of the chunk in the text for rendering.
+    mutable HashMap<size_t, ShapedChunk> m_shaped_chunks;
+    mutable RefPtr<Gfx::FontCascadeList const> m_font_list_of_shaped_chunks;
 };
 
 template<>
@@ -513,7 +513,7 @@ RefPtr<ResourceLoaderConnectorRequest> ResourceLoader::start_network_request(Loa
 
     HashMap<ByteString, ByteString> headers;
     headers.set("User-Agent", m_user_agent.to_byte_string());
-    headers.set("Accept-Encoding", "gzip, deflate, br");
+    headers.set("Accept-Encoding", "gzip, deflate, br, zstd");
 
     for (auto const& it : request.headers()) {
         headers.set(it.key, it.value);
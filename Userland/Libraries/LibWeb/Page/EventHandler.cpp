@@ -18,6 +18,7 @@
 #include <LibWeb/HTML/HTMLMediaElement.h>
 #include <LibWeb/HTML/HTMLVideoElement.h>
 #include <LibWeb/Layout/Viewport.h>
+#include <LibWeb/Loader/ResourceLoader.h>
 #include <LibWeb/Page/EventHandler.h>
 #include <LibWeb/Page/Page.h>
 #include <LibWeb/Painting/PaintableBox.h>
@@ -399,6 +400,15 @@ bool EventHandler::handle_mousedown(CSSPixelPoint position, CSSPixelPoint screen
     if (!paint_root() || paint_root() != node->document().paintable_box())
         return true;
 
+    // NOTE: Pressing the mouse button on a link is a good hint that it's about to be followed, usually a hundred
+    //       milliseconds or more before the click is. That's enough to have a connection to its origin ready by then.
+    if (button == GUI::MouseButton::Primary) {
+        if (JS::GCPtr<HTML::HTMLAnchorElement const> link = node->enclosing_link_element()) {
+            if (auto url = document->parse_url(link->href()); url.is_valid())
+                ResourceLoader::the().preconnect(url);
+        }
+    }
+
     if (button == GUI::MouseButton::Primary) {
         if (auto result = paint_root()->hit_test(position, Painting::HitTestType::TextCursor); result.has_value()) {
             auto paintable = result->paintable;
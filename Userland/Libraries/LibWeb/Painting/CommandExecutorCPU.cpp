@@ -27,22 +27,7 @@ CommandExecutorCPU::CommandExecutorCPU(Gfx::Bitmap& bitmap, bool enable_affine_c
 
 CommandResult CommandExecutorCPU::draw_glyph_run(DrawGlyphRun const& command)
 {
-    auto& painter = this->painter();
-    auto const& glyphs = command.glyph_run->glyphs();
-    for (auto& glyph_or_emoji : glyphs) {
-        auto transformed_glyph = glyph_or_emoji;
-        transformed_glyph.visit([&](auto& glyph) {
-            glyph.position = glyph.position.scaled(command.scale).translated(command.translation);
-            glyph.font = glyph.font->with_size(glyph.font->point_size() * static_cast<float>(command.scale));
-        });
-        if (glyph_or_emoji.has<Gfx::DrawGlyph>()) {
-            auto& glyph = transformed_glyph.get<Gfx::DrawGlyph>();
-            painter.draw_glyph(glyph.position, glyph.code_point, *glyph.font, command.color);
-        } else {
-            auto& emoji = transformed_glyph.get<Gfx::DrawEmoji>();
-            painter.draw_emoji(emoji.position.to_type<int>(), *emoji.emoji, *emoji.font);
-        }
-    }
+    painter().draw_glyph_run(command.glyph_run->glyphs(), command.color, command.translation, static_cast<float>(command.scale));
     return CommandResult::Continue;
 }
 
@@ -289,15 +274,7 @@ CommandResult CommandExecutorCPU::paint_text_shadow(PaintTextShadow const& comma
     // FIXME: "Spread" the shadow somehow.
     Gfx::IntPoint const baseline_start(command.text_rect.x(), command.text_rect.y() + command.fragment_baseline);
     shadow_painter.translate(baseline_start);
-    for (auto const& glyph_or_emoji : command.glyph_run) {
-        if (glyph_or_emoji.has<Gfx::DrawGlyph>()) {
-            auto const& glyph = glyph_or_emoji.get<Gfx::DrawGlyph>();
-            shadow_painter.draw_glyph(glyph.position, glyph.code_point, *glyph.font, command.color);
-        } else {
-            auto const& emoji = glyph_or_emoji.get<Gfx::DrawEmoji>();
-            shadow_painter.draw_emoji(emoji.position.to_type<int>(), *emoji.emoji, *emoji.font);
-        }
-    }
+    shadow_painter.draw_glyph_run(command.glyph_run, command.color);
 
     // Blur
     Gfx::StackBlurFilter filter(*shadow_bitmap);
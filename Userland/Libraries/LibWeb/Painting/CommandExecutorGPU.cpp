@@ -6,6 +6,7 @@
 
 #include <LibAccelGfx/GlyphAtlas.h>
 #include <LibWeb/Painting/BorderRadiusCornerClipper.h>
+#include <LibWeb/Painting/CommandExecutorCPU.h>
 #include <LibWeb/Painting/CommandExecutorGPU.h>
 
 namespace Web::Painting {
@@ -31,6 +32,32 @@ CommandExecutorGPU::~CommandExecutorGPU()
     painter().flush(m_target_bitmap);
 }
 
+template<typename CommandType>
+void CommandExecutorGPU::execute_on_cpu(CommandType const& command, Gfx::IntRect const& bounding_rect, CommandResult (CommandExecutorCPU::*execute)(CommandType const&))
+{
+    // Commands without a GPU implementation are rasterized by the CPU executor into a bitmap that covers only their
+    // visible part, which is then composited like any other bitmap. This keeps their position in the paint order.
+    auto translation = painter().transform().translation().to_type<int>();
+    auto visible_rect = painter().clip_rect().intersected(bounding_rect.translated(translation)).translated(-translation);
+    if (visible_rect.is_empty())
+        return;
+
+    auto bitmap_or_error = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, visible_rect.size());
+    if (bitmap_or_error.is_error()) {
+        dbgln("Failed to allocate bitmap for command rasterized on CPU: {}", bitmap_or_error.error());
+        return;
+    }
+    auto bitmap = bitmap_or_error.release_value();
+    bitmap->fill(Color::Transparent);
+
+    auto translated_command = command;
+    translated_command.translate_by(-visible_rect.location());
+    CommandExecutorCPU cpu_executor(*bitmap);
+    (cpu_executor.*execute)(translated_command);
+
+    painter().draw_scaled_bitmap(visible_rect, *bitmap, bitmap->rect());
+}
+
 CommandResult CommandExecutorGPU::draw_glyph_run(DrawGlyphRun const& command)
 {
     Vector<Gfx::DrawGlyphOrEmoji> transformed_glyph_run;
@@ -48,15 +75,18 @@ CommandResult CommandExecutorGPU::draw_glyph_run(DrawGlyphRun const& command)
     return CommandResult::Continue;
 }
 
-CommandResult CommandExecutorGPU::draw_text(DrawText const&)
+CommandResult CommandExecutorGPU::draw_text(DrawText const& command)
 {
-    // FIXME
+    execute_on_cpu(command, command.bounding_rect(), &CommandExecutorCPU::draw_text);
     return CommandResult::Continue;
 }
 
 CommandResult CommandExecutorGPU::fill_rect(FillRect const& command)
 {
-    // FIXME: Support clip paths
+    if (!command.clip_paths.is_empty()) {
+        execute_on_cpu(command, command.bounding_rect(), &CommandExecutorCPU::fill_rect);
+        return CommandResult::Continue;
+    }
     painter().fill_rect(command.rect, command.color);
     return CommandResult::Continue;
 }
@@ -84,7 +114,10 @@ CommandResult CommandExecutorGPU::draw_scaled_bitmap(DrawScaledBitmap const& com
 
 CommandResult CommandExecutorGPU::draw_scaled_immutable_bitmap(DrawScaledImmutableBitmap const& command)
 {
-    // TODO: Support clip paths
+    if (!command.clip_paths.is_empty()) {
+        execute_on_cpu(command, command.bounding_rect(), &CommandExecutorCPU::draw_scaled_immutable_bitmap);
+        return CommandResult::Continue;
+    }
     painter().draw_scaled_immutable_bitmap(command.dst_rect, command.bitmap, command.src_rect, to_accelgfx_scaling_mode(command.scaling_mode));
     return CommandResult::Continue;
 }
@@ -156,6 +189,7 @@ CommandResult CommandExecutorGPU::pop_stacking_context(PopStackingContext const&
     auto stacking_context = m_stacking_contexts.take_last();
     VERIFY(stacking_context.stacking_context_depth == 0);
     if (stacking_context.painter.is_owned()) {
+        stacking_context.painter->flush_batched_rects();
         painter().blit_canvas(stacking_context.destination, *stacking_context.canvas, stacking_context.opacity, stacking_context.transform);
     }
     painter().restore();
@@ -163,23 +197,45 @@ CommandResult CommandExecutorGPU::pop_stacking_context(PopStackingContext const&
     return CommandResult::Continue;
 }
 
+static bool can_paint_linear_gradient_on_gpu(PaintLinearGradient const& command)
+{
+    // AccelGfx only knows how to paint left-to-right gradients with stops that span exactly the whole rect.
+    auto const& linear_gradient_data = command.linear_gradient_data;
+    auto const& color_stops = linear_gradient_data.color_stops;
+    if (!command.clip_paths.is_empty() || linear_gradient_data.gradient_angle != 90.0f || color_stops.repeat_length.has_value())
+        return false;
+    if (color_stops.list.size() < 2 || color_stops.list.first().position != 0.0f || color_stops.list.last().position != 1.0f)
+        return false;
+    for (size_t i = 0; i < color_stops.list.size(); ++i) {
+        if (color_stops.list[i].transition_hint.has_value())
+            return false;
+        if (i > 0 && color_stops.list[i].position < color_stops.list[i - 1].position)
+            return false;
+    }
+    return true;
+}
+
 CommandResult CommandExecutorGPU::paint_linear_gradient(PaintLinearGradient const& command)
 {
-    // FIXME: Support clip paths
+    if (!can_paint_linear_gradient_on_gpu(command)) {
+        execute_on_cpu(command, command.bounding_rect(), &CommandExecutorCPU::paint_linear_gradient);
+        return CommandResult::Continue;
+    }
     auto const& linear_gradient_data = command.linear_gradient_data;
     painter().fill_rect_with_linear_gradient(command.gradient_rect, linear_gradient_data.color_stops.list, linear_gradient_data.gradient_angle, linear_gradient_data.color_stops.repeat_length);
     return CommandResult::Continue;
 }
 
-CommandResult CommandExecutorGPU::paint_outer_box_shadow(PaintOuterBoxShadow const&)
+CommandResult CommandExecutorGPU::paint_outer_box_shadow(PaintOuterBoxShadow const& command)
 {
-    // FIXME
+    execute_on_cpu(command, command.bounding_rect(), &CommandExecutorCPU::paint_outer_box_shadow);
     return CommandResult::Continue;
 }
 
-CommandResult CommandExecutorGPU::paint_inner_box_shadow(PaintInnerBoxShadow const&)
+CommandResult CommandExecutorGPU::paint_inner_box_shadow(PaintInnerBoxShadow const& command)
 {
-    // FIXME
+    // Inner shadows are painted inside the border box only.
+    execute_on_cpu(command, command.outer_box_shadow_params.device_content_rect.to_type<int>(), &CommandExecutorCPU::paint_inner_box_shadow);
     return CommandResult::Continue;
 }
 
@@ -208,7 +264,10 @@ CommandResult CommandExecutorGPU::paint_text_shadow(PaintTextShadow const& comma
 
 CommandResult CommandExecutorGPU::fill_rect_with_rounded_corners(FillRectWithRoundedCorners const& command)
 {
-    // FIXME: Support clip paths
+    if (!command.clip_paths.is_empty()) {
+        execute_on_cpu(command, command.bounding_rect(), &CommandExecutorCPU::fill_rect_with_rounded_corners);
+        return CommandResult::Continue;
+    }
     painter().fill_rect_with_rounded_corners(
         command.rect, command.color,
         { static_cast<float>(command.top_left_radius.horizontal_radius), static_cast<float>(command.top_left_radius.vertical_radius) },
@@ -218,33 +277,33 @@ CommandResult CommandExecutorGPU::fill_rect_with_rounded_corners(FillRectWithRou
     return CommandResult::Continue;
 }
 
-CommandResult CommandExecutorGPU::fill_path_using_color(FillPathUsingColor const&)
+CommandResult CommandExecutorGPU::fill_path_using_color(FillPathUsingColor const& command)
 {
-    // FIXME
+    execute_on_cpu(command, command.bounding_rect(), &CommandExecutorCPU::fill_path_using_color);
     return CommandResult::Continue;
 }
 
-CommandResult CommandExecutorGPU::fill_path_using_paint_style(FillPathUsingPaintStyle const&)
+CommandResult CommandExecutorGPU::fill_path_using_paint_style(FillPathUsingPaintStyle const& command)
 {
-    // FIXME
+    execute_on_cpu(command, command.bounding_rect(), &CommandExecutorCPU::fill_path_using_paint_style);
     return CommandResult::Continue;
 }
 
-CommandResult CommandExecutorGPU::stroke_path_using_color(StrokePathUsingColor const&)
+CommandResult CommandExecutorGPU::stroke_path_using_color(StrokePathUsingColor const& command)
 {
-    // FIXME
+    execute_on_cpu(command, command.bounding_rect(), &CommandExecutorCPU::stroke_path_using_color);
     return CommandResult::Continue;
 }
 
-CommandResult CommandExecutorGPU::stroke_path_using_paint_style(StrokePathUsingPaintStyle const&)
+CommandResult CommandExecutorGPU::stroke_path_using_paint_style(StrokePathUsingPaintStyle const& command)
 {
-    // FIXME
+    execute_on_cpu(command, command.bounding_rect(), &CommandExecutorCPU::stroke_path_using_paint_style);
     return CommandResult::Continue;
 }
 
-CommandResult CommandExecutorGPU::draw_ellipse(DrawEllipse const&)
+CommandResult CommandExecutorGPU::draw_ellipse(DrawEllipse const& command)
 {
-    // FIXME
+    execute_on_cpu(command, command.bounding_rect(), &CommandExecutorCPU::draw_ellipse);
     return CommandResult::Continue;
 }
 
@@ -263,14 +322,18 @@ CommandResult CommandExecutorGPU::fill_ellipse(FillEllipse const& command)
 
 CommandResult CommandExecutorGPU::draw_line(DrawLine const& command)
 {
-    // FIXME: Pass line style and alternate color once AccelGfx::Painter supports it
+    if (command.style != Gfx::Painter::LineStyle::Solid || command.alternate_color != Color::Transparent) {
+        auto bounding_rect = Gfx::IntRect::from_two_points(command.from, command.to).inflated(command.thickness * 2, command.thickness * 2);
+        execute_on_cpu(command, bounding_rect, &CommandExecutorCPU::draw_line);
+        return CommandResult::Continue;
+    }
     painter().draw_line(command.from, command.to, command.thickness, command.color);
     return CommandResult::Continue;
 }
 
-CommandResult CommandExecutorGPU::draw_signed_distance_field(DrawSignedDistanceField const&)
+CommandResult CommandExecutorGPU::draw_signed_distance_field(DrawSignedDistanceField const& command)
 {
-    // FIXME
+    execute_on_cpu(command, command.bounding_rect(), &CommandExecutorCPU::draw_signed_distance_field);
     return CommandResult::Continue;
 }
 
@@ -280,27 +343,40 @@ CommandResult CommandExecutorGPU::apply_backdrop_filter(ApplyBackdropFilter cons
     return CommandResult::Continue;
 }
 
-CommandResult CommandExecutorGPU::draw_rect(DrawRect const&)
+CommandResult CommandExecutorGPU::draw_rect(DrawRect const& command)
 {
-    // FIXME
+    // Same pixels as Gfx::Painter::draw_rect(): one-pixel edges, with the corners left out of rough rects.
+    auto const& rect = command.rect;
+    if (rect.is_empty())
+        return CommandResult::Continue;
+    int corner_inset = command.rough ? 1 : 0;
+    painter().fill_rect(Gfx::IntRect { rect.x() + corner_inset, rect.y(), rect.width() - 2 * corner_inset, 1 }, command.color);
+    if (rect.height() > 1)
+        painter().fill_rect(Gfx::IntRect { rect.x() + corner_inset, rect.bottom() - 1, rect.width() - 2 * corner_inset, 1 }, command.color);
+    if (rect.height() > 2) {
+        painter().fill_rect(Gfx::IntRect { rect.x(), rect.y() + 1, 1, rect.height() - 2 }, command.color);
+        if (rect.width() > 1)
+            painter().fill_rect(Gfx::IntRect { rect.right() - 1, rect.y() + 1, 1, rect.height() - 2 }, command.color);
+    }
     return CommandResult::Continue;
 }
 
-CommandResult CommandExecutorGPU::paint_radial_gradient(PaintRadialGradient const&)
+CommandResult CommandExecutorGPU::paint_radial_gradient(PaintRadialGradient const& command)
 {
-    // FIXME
+    execute_on_cpu(command, command.bounding_rect(), &CommandExecutorCPU::paint_radial_gradient);
     return CommandResult::Continue;
 }
 
-CommandResult CommandExecutorGPU::paint_conic_gradient(PaintConicGradient const&)
+CommandResult CommandExecutorGPU::paint_conic_gradient(PaintConicGradient const& command)
 {
-    // FIXME
+    execute_on_cpu(command, command.bounding_rect(), &CommandExecutorCPU::paint_conic_gradient);
     return CommandResult::Continue;
 }
 
-CommandResult CommandExecutorGPU::draw_triangle_wave(DrawTriangleWave const&)
+CommandResult CommandExecutorGPU::draw_triangle_wave(DrawTriangleWave const& command)
 {
-    // FIXME
+    auto bounding_rect = Gfx::IntRect::from_two_points(command.p1, command.p2).inflated(2 * (command.amplitude + command.thickness), 2 * (command.amplitude + command.thickness));
+    execute_on_cpu(command, bounding_rect, &CommandExecutorCPU::draw_triangle_wave);
     return CommandResult::Continue;
 }
 
@@ -12,6 +12,8 @@
 
 namespace Web::Painting {
 
+class CommandExecutorCPU;
+
 class CommandExecutorGPU : public CommandExecutor {
 public:
     CommandResult draw_glyph_run(DrawGlyphRun const&) override;
@@ -84,6 +86,9 @@ private:
         Gfx::FloatRect sample_canvas_bottom_left_rect;
     };
 
+    template<typename CommandType>
+    void execute_on_cpu(CommandType const&, Gfx::IntRect const& bounding_rect, CommandResult (CommandExecutorCPU::*execute)(CommandType const&));
+
     [[nodiscard]] AccelGfx::Painter const& painter() const { return *m_stacking_contexts.last().painter; }
     [[nodiscard]] AccelGfx::Painter& painter() { return *m_stacking_contexts.last().painter; }
 
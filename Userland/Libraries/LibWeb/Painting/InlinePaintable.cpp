@@ -187,7 +187,7 @@ void InlinePaintable::for_each_fragment(Callback callback) const
     }
 }
 
-TraversalDecision InlinePaintable::hit_test(CSSPixelPoint position, HitTestType type, Function<TraversalDecision(HitTestResult)> const& callback) const
+TraversalDecision InlinePaintable::hit_test(CSSPixelPoint position, HitTestType type, FunctionRef<TraversalDecision(HitTestResult)> callback) const
 {
     if (clip_rect().has_value() && !clip_rect().value().contains(position))
         return TraversalDecision::Continue;
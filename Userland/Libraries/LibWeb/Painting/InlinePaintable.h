@@ -35,7 +35,7 @@ public:
 
     virtual bool is_inline_paintable() const override { return true; }
 
-    virtual TraversalDecision hit_test(CSSPixelPoint, HitTestType, Function<TraversalDecision(HitTestResult)> const& callback) const override;
+    virtual TraversalDecision hit_test(CSSPixelPoint, HitTestType, FunctionRef<TraversalDecision(HitTestResult)> callback) const override;
 
     void set_box_shadow_data(Vector<ShadowData>&& box_shadow_data) { m_box_shadow_data = move(box_shadow_data); }
     Vector<ShadowData> const& box_shadow_data() const { return m_box_shadow_data; }
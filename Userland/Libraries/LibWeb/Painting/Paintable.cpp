@@ -102,7 +102,7 @@ bool Paintable::handle_mousewheel(Badge<EventHandler>, CSSPixelPoint, unsigned,
     return false;
 }
 
-TraversalDecision Paintable::hit_test(CSSPixelPoint, HitTestType, Function<TraversalDecision(HitTestResult)> const&) const
+TraversalDecision Paintable::hit_test(CSSPixelPoint, HitTestType, FunctionRef<TraversalDecision(HitTestResult)>) const
 {
     return TraversalDecision::Continue;
 }
@@ -137,7 +137,7 @@ public:
     virtual void apply_clip_overflow_rect(PaintContext&, PaintPhase) const { }
     virtual void clear_clip_overflow_rect(PaintContext&, PaintPhase) const { }
 
-    [[nodiscard]] virtual TraversalDecision hit_test(CSSPixelPoint, HitTestType, Function<TraversalDecision(HitTestResult)> const& callback) const;
+    [[nodiscard]] virtual TraversalDecision hit_test(CSSPixelPoint, HitTestType, FunctionRef<TraversalDecision(HitTestResult)> callback) const;
 
     virtual bool wants_mouse_events() const { return false; }
 
@@ -755,7 +755,7 @@ Layout::BlockContainer& PaintableWithLines::layout_box()
     return static_cast<Layout::BlockContainer&>(PaintableBox::layout_box());
 }
 
-TraversalDecision PaintableBox::hit_test(CSSPixelPoint position, HitTestType type, Function<TraversalDecision(HitTestResult)> const& callback) const
+TraversalDecision PaintableBox::hit_test(CSSPixelPoint position, HitTestType type, FunctionRef<TraversalDecision(HitTestResult)> callback) const
 {
     if (clip_rect().has_value() && !clip_rect()->contains(position))
         return TraversalDecision::Continue;
@@ -806,7 +806,7 @@ Optional<HitTestResult> PaintableBox::hit_test(CSSPixelPoint position, HitTestTy
     return result;
 }
 
-TraversalDecision PaintableWithLines::hit_test(CSSPixelPoint position, HitTestType type, Function<TraversalDecision(HitTestResult)> const& callback) const
+TraversalDecision PaintableWithLines::hit_test(CSSPixelPoint position, HitTestType type, FunctionRef<TraversalDecision(HitTestResult)> callback) const
 {
     if (clip_rect().has_value() && !clip_rect()->contains(position))
         return TraversalDecision::Continue;
@@ -26,7 +26,7 @@ Layout::SVGForeignObjectBox const& SVGForeignObjectPaintable::layout_box() const
     return static_cast<Layout::SVGForeignObjectBox const&>(layout_node());
 }
 
-TraversalDecision SVGForeignObjectPaintable::hit_test(CSSPixelPoint position, HitTestType type, Function<TraversalDecision(HitTestResult)> const& callback) const
+TraversalDecision SVGForeignObjectPaintable::hit_test(CSSPixelPoint position, HitTestType type, FunctionRef<TraversalDecision(HitTestResult)> callback) const
 {
     return PaintableWithLines::hit_test(position, type, callback);
 }
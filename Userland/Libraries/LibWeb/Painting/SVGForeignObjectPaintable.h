@@ -20,7 +20,7 @@ class SVGForeignObjectPaintable final : public PaintableWithLines
 public:
     static JS::NonnullGCPtr<SVGForeignObjectPaintable> create(Layout::SVGForeignObjectBox const&);
 
-    virtual TraversalDecision hit_test(CSSPixelPoint, HitTestType, Function<TraversalDecision(HitTestResult)> const& callback) const override;
+    virtual TraversalDecision hit_test(CSSPixelPoint, HitTestType, FunctionRef<TraversalDecision(HitTestResult)> callback) const override;
 
     virtual void paint(PaintContext&, PaintPhase) const override;
 
@@ -18,7 +18,7 @@ class SVGPathPaintable final : public SVGGraphicsPaintable {
 public:
     static JS::NonnullGCPtr<SVGPathPaintable> create(Layout::SVGGraphicsBox const&);
 
-    virtual TraversalDecision hit_test(CSSPixelPoint, HitTestType, Function<TraversalDecision(HitTestResult)> const& callback) const override;
+    virtual TraversalDecision hit_test(CSSPixelPoint, HitTestType, FunctionRef<TraversalDecision(HitTestResult)> callback) const override;
 
     virtual void paint(PaintContext&, PaintPhase) const override;
 
@@ -6,7 +6,10 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
+#include <AK/HashFunctions.h>
 #include <AK/NumericLimits.h>
+#include <AK/HashMap.h>
 #include <LibGfx/DisjointRectSet.h>
 #include <LibGfx/Filters/StackBlurFilter.h>
 #include <LibGfx/Font/Font.h>
@@ -304,6 +307,83 @@ Gfx::IntRect get_outer_box_shadow_bounding_rect(PaintOuterBoxShadowParams params
     };
 }
 
+// Everything that the blurred bitmap of an outer box-shadow depends on. Where the shadow ends up doesn't matter, so
+// boxes that look alike share a bitmap.
+struct OuterBoxShadowBitmapKey {
+    Gfx::IntSize size;
+    int double_radius { 0 };
+    int blur_radius { 0 };
+    Color color;
+    // The horizontal and vertical radius of the top-left, top-right, bottom-right and bottom-left corner.
+    Array<int, 8> corners {};
+
+    bool operator==(OuterBoxShadowBitmapKey const&) const = default;
+};
+
+}
+
+template<>
+struct AK::Traits<Web::Painting::OuterBoxShadowBitmapKey> : public DefaultTraits<Web::Painting::OuterBoxShadowBitmapKey> {
+    static unsigned hash(Web::Painting::OuterBoxShadowBitmapKey const& key)
+    {
+        auto hash = pair_int_hash(key.size.width(), key.size.height());
+        hash = pair_int_hash(hash, pair_int_hash(key.double_radius, key.blur_radius));
+        hash = pair_int_hash(hash, key.color.value());
+        for (auto radius : key.corners)
+            hash = pair_int_hash(hash, radius);
+        return hash;
+    }
+};
+
+namespace Web::Painting {
+
+// Blurring the shadow is by far the most expensive part of painting it, and the same shadows are painted again on
+// every frame. So the most recently used blurred bitmaps are kept around, up to a budget of pixels.
+static constexpr size_t outer_box_shadow_cache_capacity_in_pixels = 4 * 1024 * 1024;
+
+static RefPtr<Gfx::Bitmap> blurred_outer_box_shadow_bitmap(OuterBoxShadowBitmapKey const& key)
+{
+    static OrderedHashMap<OuterBoxShadowBitmapKey, NonnullRefPtr<Gfx::Bitmap>> s_cache;
+    static size_t s_cached_pixel_count = 0;
+
+    if (auto cached = s_cache.get(key); cached.has_value()) {
+        // Move the entry to the back, so that the least recently used entries are at the front.
+        NonnullRefPtr<Gfx::Bitmap> bitmap = *cached.value();
+        s_cache.remove(key);
+        s_cache.set(key, bitmap);
+        return bitmap;
+    }
+
+    auto shadows_bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, key.size);
+    if (shadows_bitmap.is_error()) {
+        dbgln("Unable to allocate temporary bitmap {} for box-shadow rendering: {}", key.size, shadows_bitmap.error());
+        return nullptr;
+    }
+    auto shadow_bitmap = shadows_bitmap.release_value();
+    Gfx::Painter corner_painter { *shadow_bitmap };
+    Gfx::AntiAliasingPainter aa_corner_painter { corner_painter };
+
+    auto const& corners = key.corners;
+    aa_corner_painter.fill_rect_with_rounded_corners(
+        shadow_bitmap->rect().shrunken(key.double_radius, key.double_radius, key.double_radius, key.double_radius),
+        key.color, { corners[0], corners[1] }, { corners[2], corners[3] }, { corners[4], corners[5] }, { corners[6], corners[7] });
+    Gfx::StackBlurFilter filter(*shadow_bitmap);
+    filter.process_rgba(key.blur_radius, key.color);
+
+    size_t pixel_count = static_cast<size_t>(key.size.width()) * key.size.height();
+    if (pixel_count > outer_box_shadow_cache_capacity_in_pixels)
+        return shadow_bitmap;
+
+    while (s_cached_pixel_count + pixel_count > outer_box_shadow_cache_capacity_in_pixels) {
+        auto oldest = s_cache.begin();
+        s_cached_pixel_count -= static_cast<size_t>(oldest->value->width()) * oldest->value->height();
+        s_cache.remove(oldest);
+    }
+    s_cache.set(key, shadow_bitmap);
+    s_cached_pixel_count += pixel_count;
+    return shadow_bitmap;
+}
+
 void paint_outer_box_shadow(Gfx::Painter& painter, PaintOuterBoxShadowParams params)
 {
     auto const& box_shadow_data = params.box_shadow_data;
@@ -422,20 +502,21 @@ void paint_outer_box_shadow(Gfx::Painter& painter, PaintOuterBoxShadowParams par
         painter.fill_rect(inner.to_type<int>(), box_shadow_data.color);
     };
 
-    auto shadows_bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, shadow_bitmap_rect.size().to_type<int>());
-    if (shadows_bitmap.is_error()) {
-        dbgln("Unable to allocate temporary bitmap {} for box-shadow rendering: {}", shadow_bitmap_rect, shadows_bitmap.error());
+    OuterBoxShadowBitmapKey shadow_bitmap_key {
+        .size = shadow_bitmap_rect.size().to_type<int>(),
+        .double_radius = double_radius.value(),
+        .blur_radius = blur_radius.value(),
+        .color = box_shadow_data.color,
+        .corners = {
+            top_left_shadow_corner.horizontal_radius, top_left_shadow_corner.vertical_radius,
+            top_right_shadow_corner.horizontal_radius, top_right_shadow_corner.vertical_radius,
+            bottom_right_shadow_corner.horizontal_radius, bottom_right_shadow_corner.vertical_radius,
+            bottom_left_shadow_corner.horizontal_radius, bottom_left_shadow_corner.vertical_radius },
+    };
+    auto maybe_shadow_bitmap = blurred_outer_box_shadow_bitmap(shadow_bitmap_key);
+    if (!maybe_shadow_bitmap)
         return;
-    }
-    auto shadow_bitmap = shadows_bitmap.release_value();
-    Gfx::Painter corner_painter { *shadow_bitmap };
-    Gfx::AntiAliasingPainter aa_corner_painter { corner_painter };
-
-    aa_corner_painter.fill_rect_with_rounded_corners(
-        shadow_bitmap_rect.shrunken(double_radius, double_radius, double_radius, double_radius).to_type<int>(),
-        box_shadow_data.color, top_left_shadow_corner, top_right_shadow_corner, bottom_right_shadow_corner, bottom_left_shadow_corner);
-    Gfx::StackBlurFilter filter(*shadow_bitmap);
-    filter.process_rgba(blur_radius.value(), box_shadow_data.color);
+    auto shadow_bitmap = maybe_shadow_bitmap.release_nonnull();
 
     auto paint_shadow = [&](DevicePixelRect clip_rect) {
         Gfx::PainterStateSaver save { painter };
@@ -331,7 +331,7 @@ void StackingContext::paint(PaintContext& context) const
     context.recording_painter().restore();
 }
 
-TraversalDecision StackingContext::hit_test(CSSPixelPoint position, HitTestType type, Function<TraversalDecision(HitTestResult)> const& callback) const
+TraversalDecision StackingContext::hit_test(CSSPixelPoint position, HitTestType type, FunctionRef<TraversalDecision(HitTestResult)> callback) const
 {
     if (!paintable().is_visible())
         return TraversalDecision::Continue;
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/CircularQueue.h>
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/OwnPtr.h>
+#include <LibWeb/PhaseTimer.h>
+#include <unistd.h>
+
+namespace Web {
+
+static PhaseTimings s_phase_timings;
+static PhaseTimer* s_current_timer { nullptr };
+
+struct TraceEvent {
+    StringView name;
+    MonotonicTime started_at;
+    Duration duration;
+};
+
+// Once full, the oldest events are dropped, so the trace always covers the most recent frames.
+static constexpr size_t rendering_trace_capacity = 64 * KiB;
+using RenderingTrace = CircularQueue<TraceEvent, rendering_trace_capacity>;
+
+static bool s_rendering_trace_enabled { false };
+static OwnPtr<RenderingTrace> s_rendering_trace;
+
+StringView phase_name(Phase phase)
+{
+    switch (phase) {
+    case Phase::HTMLParsing:
+        return "html-parsing"sv;
+    case Phase::Style:
+        return "style"sv;
+    case Phase::Layout:
+        return "layout"sv;
+    case Phase::Paint:
+        return "paint"sv;
+    case Phase::JavaScript:
+        return "javascript"sv;
+    case Phase::GarbageCollection:
+        return "garbage-collection"sv;
+    case Phase::__Count:
+        break;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+PhaseTimings const& phase_timings()
+{
+    return s_phase_timings;
+}
+
+void reset_phase_timings()
+{
+    s_phase_timings = {};
+}
+
+void record_completed_phase(Phase phase, Duration duration)
+{
+    auto now = MonotonicTime::now();
+    s_phase_timings[to_underlying(phase)] += duration;
+
+    // The running phase was interrupted, so move its start forward by the time that has just been accounted for.
+    if (s_current_timer)
+        s_current_timer->m_started_at = min(s_current_timer->m_started_at + duration, now);
+
+    if (s_rendering_trace_enabled)
+        record_trace_event(phase_name(phase), now - duration);
+}
+
+bool is_rendering_trace_enabled()
+{
+    return s_rendering_trace_enabled;
+}
+
+void set_rendering_trace_enabled(bool enabled)
+{
+    if (enabled && !s_rendering_trace_enabled)
+        s_rendering_trace = make<RenderingTrace>();
+    s_rendering_trace_enabled = enabled;
+}
+
+void record_trace_event(StringView name, MonotonicTime started_at)
+{
+    if (!s_rendering_trace_enabled)
+        return;
+    s_rendering_trace->enqueue({ name, started_at, MonotonicTime::now() - started_at });
+}
+
+ByteString take_rendering_trace_json()
+{
+    auto pid = getpid();
+
+    JsonArray trace_events;
+    if (s_rendering_trace) {
+        while (!s_rendering_trace->is_empty()) {
+            auto event = s_rendering_trace->dequeue();
+
+            JsonObject trace_event;
+            trace_event.set("name", event.name);
+            trace_event.set("cat", "rendering");
+            trace_event.set("ph", "X");
+            trace_event.set("ts", event.started_at.nanoseconds() / 1000);
+            trace_event.set("dur", event.duration.to_microseconds());
+            trace_event.set("pid", pid);
+            trace_event.set("tid", pid);
+            trace_events.must_append(move(trace_event));
+        }
+    }
+
+    JsonObject trace;
+    trace.set("traceEvents", move(trace_events));
+    trace.set("displayTimeUnit", "ms");
+    return trace.to_byte_string();
+}
+
+PhaseTimer::PhaseTimer(Phase phase)
+    : m_phase(phase)
+    , m_entered_at(MonotonicTime::now())
+    , m_started_at(m_entered_at)
+    , m_outer_timer(s_current_timer)
+{
+    // Pause the phase we are nested in.
+    if (m_outer_timer)
+        s_phase_timings[to_underlying(m_outer_timer->m_phase)] += m_started_at - m_outer_timer->m_started_at;
+    s_current_timer = this;
+}
+
+PhaseTimer::~PhaseTimer()
+{
+    VERIFY(s_current_timer == this);
+
+    auto now = MonotonicTime::now();
+    s_phase_timings[to_underlying(m_phase)] += now - m_started_at;
+
+    // Resume the phase we were nested in.
+    s_current_timer = m_outer_timer;
+    if (m_outer_timer)
+        m_outer_timer->m_started_at = now;
+
+    if (s_rendering_trace_enabled)
+        record_trace_event(phase_name(m_phase), m_entered_at);
+}
+
+}
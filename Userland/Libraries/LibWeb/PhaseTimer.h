@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/ByteString.h>
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <AK/StdLibExtras.h>
+#include <AK/StringView.h>
+#include <AK/Time.h>
+
+namespace Web {
+
+// The big phases of loading and rendering a document. The time spent in each of them is summed up over the whole
+// process, so tools like headless-browser can tell where page loads spend their time.
+enum class Phase : u8 {
+    HTMLParsing,
+    Style,
+    Layout,
+    Paint,
+    JavaScript,
+    GarbageCollection,
+    __Count,
+};
+
+using PhaseTimings = Array<Duration, to_underlying(Phase::__Count)>;
+
+StringView phase_name(Phase);
+PhaseTimings const& phase_timings();
+void reset_phase_timings();
+
+// Attributes time that has already been spent to the given phase, and takes it out of the phase that was running
+// meanwhile. This is for work that is only reported once it's over, like garbage collections.
+void record_completed_phase(Phase, Duration);
+
+// While the rendering trace is enabled, every phase and trace scope is also recorded into a bounded buffer, which can
+// be taken as JSON in the Chrome trace event format (as understood by chrome://tracing and Perfetto).
+bool is_rendering_trace_enabled();
+void set_rendering_trace_enabled(bool);
+ByteString take_rendering_trace_json();
+
+// Records a span from started_at until now into the rendering trace. The name must outlive the trace.
+void record_trace_event(StringView name, MonotonicTime started_at);
+
+// Attributes the time until it is destroyed to the given phase. Phases nest (e.g. a script running while parsing HTML,
+// which then updates the layout), in which case the time is only attributed to the innermost one.
+class PhaseTimer {
+    AK_MAKE_NONCOPYABLE(PhaseTimer);
+    AK_MAKE_NONMOVABLE(PhaseTimer);
+
+public:
+    explicit PhaseTimer(Phase);
+    ~PhaseTimer();
+
+private:
+    friend void record_completed_phase(Phase, Duration);
+
+    Phase m_phase;
+    MonotonicTime m_entered_at;
+    MonotonicTime m_started_at;
+    PhaseTimer* m_outer_timer { nullptr };
+};
+
+// Records the time until it is destroyed into the rendering trace, without attributing it to any phase.
+class TraceScope {
+    AK_MAKE_NONCOPYABLE(TraceScope);
+    AK_MAKE_NONMOVABLE(TraceScope);
+
+public:
+    explicit TraceScope(StringView name)
+        : m_name(name)
+    {
+        if (is_rendering_trace_enabled())
+            m_started_at = MonotonicTime::now();
+    }
+
+    ~TraceScope()
+    {
+        if (m_started_at.has_value())
+            record_trace_event(m_name, *m_started_at);
+    }
+
+private:
+    StringView m_name;
+    Optional<MonotonicTime> m_started_at;
+};
+
+}
@@ -559,6 +559,19 @@ ErrorOr<LexicalPath> ViewImplementation::dump_gc_graph()
     return path;
 }
 
+ErrorOr<LexicalPath> ViewImplementation::dump_rendering_trace(StringView directory)
+{
+    auto rendering_trace_json = client().take_rendering_trace(page_id());
+
+    LexicalPath path { directory };
+    path = path.append(TRY(Core::DateTime::now().to_string("rendering-trace-%Y-%m-%d-%H-%M-%S.json"sv)));
+
+    auto trace_file = TRY(Core::File::open(path.string(), Core::File::OpenMode::Write));
+    TRY(trace_file->write_until_depleted(rendering_trace_json.bytes()));
+
+    return path;
+}
+
 void ViewImplementation::set_user_style_sheet(String source)
 {
     client().async_set_user_style(page_id(), move(source));
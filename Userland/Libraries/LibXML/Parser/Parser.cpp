@@ -83,7 +83,8 @@ void Parser::append_node(NonnullOwnPtr<Node> node)
 void Parser::append_text(StringView text, LineTrackingLexer::Position position)
 {
     if (m_listener) {
-        m_listener->text(text);
+        if (!text.is_empty())
+            m_listener->text(text);
         return;
     }
 
@@ -152,6 +153,16 @@ void Parser::leave_node()
     if (m_listener) {
         auto& element = m_entered_node->content.get<Node::Element>();
         m_listener->element_end(element.name);
+
+        // Listeners only see events, so there's no need to keep the tree around once an element is done.
+        // Text and comments are never appended in this mode, so the node being left is always the last child.
+        auto* parent = m_entered_node->parent;
+        if (parent)
+            (void)parent->content.get<Node::Element>().children.take_last();
+        else
+            m_root_node.clear();
+        m_entered_node = parent;
+        return;
     }
 
     m_entered_node = m_entered_node->parent;
@@ -546,12 +557,22 @@ ErrorOr<Name, ParseError> Parser::parse_name()
     auto accept = accept_rule();
 
     auto rest = m_lexer.consume_while(s_name_characters);
-    StringBuilder builder;
-    builder.append(start);
-    builder.append(rest);
 
     rollback.disarm();
-    return builder.to_byte_string();
+    return intern_name({ start.characters_without_null_termination(), start.length() + rest.length() });
+}
+
+Name Parser::intern_name(StringView name)
+{
+    // Documents tend to repeat the same few element and attribute names many times over,
+    // so share a single allocation for each of them rather than creating a new one every time.
+    auto hash = name.hash();
+    if (auto it = m_interned_names.find(hash, [&](auto& entry) { return entry == name; }); it != m_interned_names.end())
+        return *it;
+
+    Name interned_name = name;
+    m_interned_names.set(interned_name);
+    return interned_name;
 }
 
 // 2.8.28. doctypedecl, https://www.w3.org/TR/2006/REC-xml11-20060816/#NT-doctypedecl
@@ -730,7 +751,11 @@ ErrorOr<ByteString, ParseError> Parser::parse_attribute_value_inner(StringView d
             else
                 builder.append(TRY(resolve_reference(reference.get<EntityReference>(), ReferencePlacement::AttributeValue)));
         } else {
-            builder.append(m_lexer.consume());
+            auto text = m_lexer.consume_while([&](char ch) { return ch != '<' && ch != '&' && !disallow.contains(ch); });
+            // Most attribute values contain no references, so they can be returned without an intermediate copy.
+            if (builder.is_empty() && (m_lexer.is_eof() || m_lexer.next_is(is_any_of(disallow))))
+                return ByteString { text };
+            builder.append(text);
         }
     }
     return builder.to_byte_string();
@@ -896,34 +921,21 @@ ErrorOr<StringView, ParseError> Parser::parse_char_data()
     auto rule = enter_rule();
 
     // CharData ::= [^<&]* - ([^<&]* ']]>' [^<&]*)
-    auto cend_state = 0; // 1: ], 2: ], 3: >
-    auto text = m_lexer.consume_while([&](auto ch) {
-        if (ch == '<' || ch == '&' || cend_state == 3)
-            return false;
-        switch (cend_state) {
-        case 0:
-        case 1:
-            if (ch == ']')
-                cend_state++;
-            else
-                cend_state = 0;
-            return true;
-        case 2:
-            if (ch == '>') {
-                cend_state++;
-                return true;
-            }
-            cend_state = 0;
-            return true;
-        default:
-            VERIFY_NOT_REACHED();
-        }
-    });
-    if (cend_state == 3) {
-        m_lexer.retreat(3);
-        text = text.substring_view(0, text.length() - 3);
+    // Scan the remaining input directly rather than feeding it through the lexer one character at a time,
+    // stopping at the first markup delimiter or at a ']]>' sequence (which is not allowed in character data).
+    auto remaining = m_lexer.remaining();
+    size_t length = 0;
+    for (; length < remaining.length(); ++length) {
+        auto ch = remaining[length];
+        if (ch == '<' || ch == '&')
+            break;
+        if (ch == ']' && remaining.substring_view(length).starts_with("]]>"sv))
+            break;
     }
 
+    auto text = remaining.substring_view(0, length);
+    m_lexer.ignore(length);
+
     rollback.disarm();
     return text;
 }
@@ -11,6 +11,7 @@
 #include <AK/Function.h>
 #include <AK/GenericLexer.h>
 #include <AK/HashMap.h>
+#include <AK/HashTable.h>
 #include <AK/OwnPtr.h>
 #include <AK/SourceLocation.h>
 #include <AK/TemporaryChange.h>
@@ -103,6 +104,7 @@ private:
     ErrorOr<void, ParseError> parse_processing_instruction();
     ErrorOr<Name, ParseError> parse_processing_instruction_target();
     ErrorOr<Name, ParseError> parse_name();
+    Name intern_name(StringView);
     ErrorOr<NonnullOwnPtr<Node>, ParseError> parse_empty_element_tag();
     ErrorOr<NonnullOwnPtr<Node>, ParseError> parse_start_tag();
     ErrorOr<Name, ParseError> parse_end_tag();
@@ -211,6 +213,8 @@ private:
 
     Vector<ParseError> m_parse_errors;
 
+    HashTable<Name> m_interned_names;
+
     Optional<Doctype> m_doctype;
 };
 }
@@ -25,39 +25,68 @@ bool ClientAudioStream::is_connected() const
     return m_client && m_client->is_open();
 }
 
-ErrorOr<Audio::Sample, ClientAudioStream::ErrorState> ClientAudioStream::get_next_sample(u32 audiodevice_sample_rate)
+size_t ClientAudioStream::read_samples(Span<Audio::Sample> buffer, u32 audiodevice_sample_rate)
+{
+    size_t samples_written = 0;
+    while (samples_written < buffer.size()) {
+        if (m_in_chunk_location >= m_current_audio_chunk.size()) {
+            auto result = read_next_chunk(audiodevice_sample_rate);
+            if (result.is_error()) {
+                m_underrunning = result.error() == ErrorState::ClientUnderrun;
+                return samples_written;
+            }
+            continue;
+        }
+
+        auto samples_to_copy = min(m_current_audio_chunk.size() - m_in_chunk_location, buffer.size() - samples_written);
+        m_current_audio_chunk.span().slice(m_in_chunk_location, samples_to_copy).copy_to(buffer.slice(samples_written));
+        m_in_chunk_location += samples_to_copy;
+        samples_written += samples_to_copy;
+    }
+
+    m_underrunning = false;
+    return samples_written;
+}
+
+ErrorOr<void, ClientAudioStream::ErrorState> ClientAudioStream::read_next_chunk(u32 audiodevice_sample_rate)
 {
     // Note: Even though we only check client state here, we will probably close the client much earlier.
     if (!is_connected())
         return ErrorState::ClientDisconnected;
 
     if (m_paused)
+        return ErrorState::ClientPaused;
+
+    auto result = m_buffer->dequeue();
+    if (result.is_error()) {
+        if (result.error() == Audio::AudioQueue::QueueStatus::Empty) {
+            dbgln_if(AUDIO_DEBUG, "Audio client {} can't keep up!", m_client->client_id());
+        }
+
         return ErrorState::ClientUnderrun;
+    }
 
-    if (m_in_chunk_location >= m_current_audio_chunk.size()) {
-        auto result = m_buffer->dequeue();
-        if (result.is_error()) {
-            if (result.error() == Audio::AudioQueue::QueueStatus::Empty) {
-                dbgln_if(AUDIO_DEBUG, "Audio client {} can't keep up!", m_client->client_id());
-            }
+    // The chunk's storage is reused, so that the mixer thread doesn't allocate once it's warmed up.
+    m_current_audio_chunk.clear_with_capacity();
+    m_in_chunk_location = 0;
 
-            return ErrorState::ClientUnderrun;
-        }
-        // FIXME: Our resampler and the way we resample here are bad.
-        //        Ideally, we should both do perfect band-corrected resampling,
-        //        as well as carry resampling state over between buffers.
-        auto maybe_resampled = Audio::ResampleHelper<Audio::Sample> { m_sample_rate == 0 ? audiodevice_sample_rate : m_sample_rate, audiodevice_sample_rate }
-                                   .try_resample(result.release_value());
-        if (maybe_resampled.is_error())
+    auto source_sample_rate = m_sample_rate == 0 ? audiodevice_sample_rate : m_sample_rate;
+    if (source_sample_rate == audiodevice_sample_rate) {
+        m_resampler.clear();
+        auto const& samples = result.value();
+        if (m_current_audio_chunk.try_append(samples.data(), samples.size()).is_error())
             return ErrorState::ResamplingError;
-
-        // If the sample rate changes underneath us, we will still play the existing buffer unchanged until we're done.
-        // This is not a significant problem since the buffers are very small (~100 samples or less).
-        m_current_audio_chunk = maybe_resampled.release_value();
-        m_in_chunk_location = 0;
+        return {};
     }
 
-    return m_current_audio_chunk[m_in_chunk_location++];
+    // FIXME: Our resampler is bad. Ideally, we should do perfect band-corrected resampling.
+    // Keeping the resampler around between chunks at least carries its state over between buffers.
+    if (!m_resampler.has_value() || m_resampler->source() != source_sample_rate || m_resampler->target() != audiodevice_sample_rate)
+        m_resampler.emplace(source_sample_rate, audiodevice_sample_rate);
+    if (m_resampler->try_resample_into_end(m_current_audio_chunk, result.release_value()).is_error())
+        return ErrorState::ResamplingError;
+
+    return {};
 }
 
 void ClientAudioStream::set_buffer(NonnullOwnPtr<Audio::AudioQueue> buffer)
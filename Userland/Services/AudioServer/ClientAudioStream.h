@@ -14,6 +14,7 @@
 #include <AK/RefCounted.h>
 #include <AK/WeakPtr.h>
 #include <LibAudio/Queue.h>
+#include <LibAudio/Resampler.h>
 
 namespace AudioServer {
 
@@ -29,7 +30,10 @@ public:
     explicit ClientAudioStream(ConnectionFromClient&);
     ~ClientAudioStream() = default;
 
-    ErrorOr<Audio::Sample, ErrorState> get_next_sample(u32 audiodevice_sample_rate);
+    // Fills the buffer with as many samples as the client provides, and returns the number of samples written.
+    size_t read_samples(Span<Audio::Sample> buffer, u32 audiodevice_sample_rate);
+    // Whether the client is playing, but the last read came up short.
+    bool is_underrunning() const { return m_underrunning; }
     void clear();
 
     bool is_connected() const;
@@ -48,9 +52,13 @@ public:
     void set_sample_rate(u32 sample_rate);
 
 private:
+    ErrorOr<void, ErrorState> read_next_chunk(u32 audiodevice_sample_rate);
+
     OwnPtr<Audio::AudioQueue> m_buffer;
     Vector<Audio::Sample> m_current_audio_chunk;
-    size_t m_in_chunk_location;
+    size_t m_in_chunk_location { 0 };
+    Optional<Audio::ResampleHelper<Audio::Sample>> m_resampler;
+    bool m_underrunning { false };
 
     bool m_paused { true };
     bool m_muted { false };
@@ -61,6 +61,11 @@ void ConnectionFromManagerClient::set_device_sample_rate(u32 sample_rate)
     m_mixer.audiodevice_set_sample_rate(sample_rate);
 }
 
+Messages::AudioManagerServer::GetMixerStatisticsResponse ConnectionFromManagerClient::get_mixer_statistics()
+{
+    return { static_cast<u32>(m_mixer.buffer_size()), m_mixer.mixed_buffer_count(), m_mixer.underrun_count() };
+}
+
 Messages::AudioManagerServer::IsMainMixMutedResponse ConnectionFromManagerClient::is_main_mix_muted()
 {
     return m_mixer.is_muted();
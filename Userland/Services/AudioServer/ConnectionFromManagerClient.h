@@ -36,6 +36,7 @@ private:
     virtual void set_main_mix_muted(bool) override;
     virtual void set_device_sample_rate(u32 sample_rate) override;
     virtual Messages::AudioManagerServer::GetDeviceSampleRateResponse get_device_sample_rate() override;
+    virtual Messages::AudioManagerServer::GetMixerStatisticsResponse get_mixer_statistics() override;
 
     Mixer& m_mixer;
 };
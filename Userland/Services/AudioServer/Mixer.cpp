@@ -7,19 +7,79 @@
 
 #include "Mixer.h"
 #include <AK/Array.h>
+#include <AK/Endian.h>
 #include <AK/Format.h>
-#include <AK/MemoryStream.h>
 #include <AK/NumericLimits.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDMath.h>
 #include <AudioServer/ConnectionFromClient.h>
 #include <AudioServer/ConnectionFromManagerClient.h>
 #include <AudioServer/Mixer.h>
 #include <LibCore/ConfigFile.h>
 #include <LibCore/Timer.h>
 #include <pthread.h>
+#include <sched.h>
 #include <sys/ioctl.h>
 
 namespace AudioServer {
 
+using AK::SIMD::f32x4;
+using AK::SIMD::i32x4;
+
+// A sample is two floats, so every vector holds two consecutive stereo samples.
+static_assert(sizeof(Audio::Sample) == 2 * sizeof(float));
+constexpr size_t SAMPLES_PER_VECTOR = sizeof(f32x4) / sizeof(Audio::Sample);
+
+static void mix_samples_into(Span<Audio::Sample> mixed_samples, ReadonlySpan<Audio::Sample> samples, float gain)
+{
+    VERIFY(samples.size() <= mixed_samples.size());
+    auto* mixed_data = reinterpret_cast<u8*>(mixed_samples.data());
+    auto const* data = reinterpret_cast<u8 const*>(samples.data());
+
+    size_t i = 0;
+    for (; i + SAMPLES_PER_VECTOR <= samples.size(); i += SAMPLES_PER_VECTOR) {
+        f32x4 mixed;
+        f32x4 sample;
+        __builtin_memcpy(&mixed, mixed_data + i * sizeof(Audio::Sample), sizeof(f32x4));
+        __builtin_memcpy(&sample, data + i * sizeof(Audio::Sample), sizeof(f32x4));
+        mixed += sample * gain;
+        __builtin_memcpy(mixed_data + i * sizeof(Audio::Sample), &mixed, sizeof(f32x4));
+    }
+    for (; i < samples.size(); ++i) {
+        mixed_samples[i].left += samples[i].left * gain;
+        mixed_samples[i].right += samples[i].right * gain;
+    }
+}
+
+// Applies the gain, clips and writes the samples as interleaved little-endian 16-bit PCM.
+static void convert_to_pcm(ReadonlySpan<Audio::Sample> samples, float gain, Bytes output)
+{
+    VERIFY(output.size() >= samples.size() * 2 * sizeof(i16));
+    auto const* data = reinterpret_cast<u8 const*>(samples.data());
+    constexpr auto sample_scale = static_cast<float>(NumericLimits<i16>::max());
+
+    size_t i = 0;
+    if constexpr (HostIsLittleEndian) {
+        for (; i + SAMPLES_PER_VECTOR <= samples.size(); i += SAMPLES_PER_VECTOR) {
+            f32x4 sample;
+            __builtin_memcpy(&sample, data + i * sizeof(Audio::Sample), sizeof(f32x4));
+            sample = AK::SIMD::clamp(sample * gain, -1.0f, 1.0f) * sample_scale;
+            auto pcm = __builtin_convertvector(__builtin_convertvector(sample, i32x4), AK::SIMD::i16x4);
+            __builtin_memcpy(output.offset_pointer(i * 2 * sizeof(i16)), &pcm, sizeof(pcm));
+        }
+    }
+    for (; i < samples.size(); ++i) {
+        auto sample = samples[i];
+        sample.left *= gain;
+        sample.right *= gain;
+        sample.clip();
+        LittleEndian<i16> left = static_cast<i16>(sample.left * sample_scale);
+        LittleEndian<i16> right = static_cast<i16>(sample.right * sample_scale);
+        __builtin_memcpy(output.offset_pointer(i * 2 * sizeof(i16)), &left, sizeof(i16));
+        __builtin_memcpy(output.offset_pointer(i * 2 * sizeof(i16) + sizeof(i16)), &right, sizeof(i16));
+    }
+}
+
 Mixer::Mixer(NonnullRefPtr<Core::ConfigFile> config, NonnullOwnPtr<Core::File> device)
     : m_device(move(device))
     , m_sound_thread(Threading::Thread::construct(
@@ -33,7 +93,20 @@ Mixer::Mixer(NonnullRefPtr<Core::ConfigFile> config, NonnullOwnPtr<Core::File> d
     m_muted = m_config->read_bool_entry("Master", "Mute", false);
     m_main_volume = static_cast<double>(m_config->read_num_entry("Master", "Volume", 100)) / 100.0;
 
+    // Low-latency mode writes smaller buffers to the hardware, which requires the mixer thread to be scheduled promptly.
+    auto low_latency = m_config->read_bool_entry("Mixer", "LowLatency", false);
+    if (low_latency) {
+        auto buffer_size = m_config->read_num_entry("Mixer", "LowLatencyBufferSize", static_cast<i32>(DEFAULT_LOW_LATENCY_BUFFER_SIZE));
+        m_buffer_size = clamp(static_cast<size_t>(max(buffer_size, 0)), MINIMUM_HARDWARE_BUFFER_SIZE, HARDWARE_BUFFER_SIZE);
+    }
+
     m_sound_thread->start();
+
+    if (low_latency) {
+        if (auto result = m_sound_thread->set_priority(THREAD_PRIORITY_MAX); result.is_error())
+            dbgln("Failed to raise the mixer thread priority for low-latency mode: {}", result.error());
+        dbgln("Mixer running in low-latency mode with {} sample buffers", m_buffer_size);
+    }
 }
 
 NonnullRefPtr<ClientAudioStream> Mixer::create_queue(ConnectionFromClient& client)
@@ -68,6 +141,9 @@ void Mixer::mix()
         active_mix_queues.remove_all_matching([&](auto& entry) { return !entry->is_connected(); });
 
         Array<Audio::Sample, HARDWARE_BUFFER_SIZE> mixed_buffer;
+        Array<Audio::Sample, HARDWARE_BUFFER_SIZE> stream_buffer;
+        auto mixed_samples = mixed_buffer.span().trim(m_buffer_size);
+        auto device_sample_rate = audiodevice_get_sample_rate();
 
         m_main_volume.advance_time();
 
@@ -79,43 +155,28 @@ void Mixer::mix()
             }
             queue->volume().advance_time();
 
-            // FIXME: Perform sample extraction and mixing in two separate loops so they can be more easily vectorized.
-            for (auto& mixed_sample : mixed_buffer) {
-                auto sample_or_error = queue->get_next_sample(audiodevice_get_sample_rate());
-                if (sample_or_error.is_error())
-                    break;
-                if (queue->is_muted())
-                    continue;
-                auto sample = sample_or_error.release_value();
-                sample.log_multiply(SAMPLE_HEADROOM);
-                sample.log_multiply(static_cast<float>(queue->volume()));
-                mixed_sample += sample;
-            }
+            // Extract all samples first, so that mixing can happen in one vectorized pass.
+            auto was_underrunning = queue->is_underrunning();
+            auto sample_count = queue->read_samples(stream_buffer.span().trim(m_buffer_size), device_sample_rate);
+            if (!was_underrunning && queue->is_underrunning())
+                m_underrun_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+            if (queue->is_muted())
+                continue;
+
+            auto gain = Audio::Sample::linear_to_log(SAMPLE_HEADROOM) * Audio::Sample::linear_to_log(static_cast<float>(queue->volume()));
+            mix_samples_into(mixed_samples, stream_buffer.span().trim(sample_count), gain);
         }
 
+        auto buffer_size_bytes = m_buffer_size * 2 * sizeof(i16);
         // Even though it's not realistic, the user expects no sound at 0%.
         if (m_muted || m_main_volume < 0.01) {
-            m_device->write_until_depleted(m_zero_filled_buffer).release_value_but_fixme_should_propagate_errors();
+            m_device->write_until_depleted(m_zero_filled_buffer.span().trim(buffer_size_bytes)).release_value_but_fixme_should_propagate_errors();
         } else {
-            FixedMemoryStream stream { m_stream_buffer.span() };
-
-            for (auto& mixed_sample : mixed_buffer) {
-                mixed_sample.log_multiply(static_cast<float>(m_main_volume));
-                mixed_sample.clip();
-
-                LittleEndian<i16> out_sample;
-                out_sample = static_cast<i16>(mixed_sample.left * NumericLimits<i16>::max());
-                MUST(stream.write_value(out_sample));
-
-                out_sample = static_cast<i16>(mixed_sample.right * NumericLimits<i16>::max());
-                MUST(stream.write_value(out_sample));
-            }
-
-            auto buffered_bytes = MUST(stream.tell());
-            VERIFY(buffered_bytes == m_stream_buffer.size());
-            m_device->write_until_depleted({ m_stream_buffer.data(), buffered_bytes })
+            convert_to_pcm(mixed_samples, Audio::Sample::linear_to_log(static_cast<float>(m_main_volume)), m_stream_buffer.span());
+            m_device->write_until_depleted(m_stream_buffer.span().trim(buffer_size_bytes))
                 .release_value_but_fixme_should_propagate_errors();
         }
+        m_mixed_buffer_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
     }
 }
 
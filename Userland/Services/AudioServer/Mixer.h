@@ -35,6 +35,10 @@ constexpr double SAMPLE_HEADROOM = 0.95;
 constexpr size_t HARDWARE_BUFFER_SIZE = 512;
 // The hardware buffer size in bytes; there's two channels of 16-bit samples.
 constexpr size_t HARDWARE_BUFFER_SIZE_BYTES = HARDWARE_BUFFER_SIZE * 2 * sizeof(i16);
+// In low-latency mode, the hardware receives smaller buffers of this many samples by default.
+constexpr size_t DEFAULT_LOW_LATENCY_BUFFER_SIZE = 128;
+// Buffers smaller than this can't reliably be mixed and written before the hardware runs out of samples.
+constexpr size_t MINIMUM_HARDWARE_BUFFER_SIZE = 32;
 
 class Mixer : public Core::EventReceiver {
     C_OBJECT_ABSTRACT(Mixer)
@@ -60,13 +64,20 @@ public:
     int audiodevice_set_sample_rate(u32 sample_rate);
     u32 audiodevice_get_sample_rate() const;
 
+    // The number of samples that is mixed and written to the hardware at once.
+    size_t buffer_size() const { return m_buffer_size; }
+    u64 mixed_buffer_count() const { return m_mixed_buffer_count.load(AK::MemoryOrder::memory_order_relaxed); }
+    // How often a playing client failed to provide samples in time, so that it was cut off.
+    u64 underrun_count() const { return m_underrun_count.load(AK::MemoryOrder::memory_order_relaxed); }
+
 private:
     Mixer(NonnullRefPtr<Core::ConfigFile> config, NonnullOwnPtr<Core::File> device);
 
     void request_setting_sync();
 
     Vector<NonnullRefPtr<ClientAudioStream>> m_pending_mixing;
-    Threading::Mutex m_pending_mutex;
+    // The mixer thread may run at real-time priority, so clients adding streams must not be able to stall it.
+    Threading::Mutex m_pending_mutex { Threading::Mutex::Protocol::PriorityInherit };
     Threading::ConditionVariable m_mixing_necessary { m_pending_mutex };
 
     NonnullOwnPtr<Core::File> m_device;
@@ -77,6 +88,10 @@ private:
     bool m_muted { false };
     FadingProperty<double> m_main_volume { 1 };
 
+    size_t m_buffer_size { HARDWARE_BUFFER_SIZE };
+    Atomic<u64> m_mixed_buffer_count { 0 };
+    Atomic<u64> m_underrun_count { 0 };
+
     NonnullRefPtr<Core::ConfigFile> m_config;
     RefPtr<Core::Timer> m_config_write_timer;
 
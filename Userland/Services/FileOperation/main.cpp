@@ -239,20 +239,21 @@ ErrorOr<int> execute_work_items(Vector<WorkItem> const& items)
             auto source_file = TRY(Core::File::open(source, Core::File::OpenMode::Read));
             // FIXME: When the file already exists, let the user choose the next action instead of renaming it by default.
             auto destination_file = TRY(open_destination_file(destination, mode));
-            auto buffer = TRY(ByteBuffer::create_zeroed(64 * KiB));
 
+            print_progress();
             while (true) {
-                print_progress();
-                auto bytes_read = TRY(source_file->read_some(buffer.bytes()));
-                if (bytes_read.is_empty())
-                    break;
-                if (auto result = destination_file->write_until_depleted(bytes_read); result.is_error()) {
+                // Let the kernel move the data over in large chunks, rather than copying it through our address space.
+                auto bytes_copied_or_error = Core::System::sendfile(destination_file->fd(), source_file->fd(), nullptr, 1 * MiB);
+                if (bytes_copied_or_error.is_error()) {
                     // FIXME: Return the formatted string directly. There is no way to do this right now without the temporary going out of scope and being destroyed.
-                    report_warning(ByteString::formatted("Failed to write to destination file: {}", result.error()));
-                    return result.release_error();
+                    report_warning(ByteString::formatted("Failed to write to destination file: {}", bytes_copied_or_error.error()));
+                    return bytes_copied_or_error.release_error();
                 }
-                item_done += bytes_read.size();
-                executed_work_bytes += bytes_read.size();
+                auto bytes_copied = bytes_copied_or_error.release_value();
+                if (bytes_copied == 0)
+                    break;
+                item_done += bytes_copied;
+                executed_work_bytes += bytes_copied;
                 print_progress();
                 // FIXME: Remove this once the kernel is smart enough to schedule other threads
                 //        while we're doing heavy I/O. Right now, copying a large file will totally
@@ -6,18 +6,26 @@
 
 #include "LookupServer.h"
 #include "ConnectionFromClient.h"
+#include <AK/AllOf.h>
+#include <AK/AnyOf.h>
 #include <AK/BufferedStream.h>
 #include <AK/ByteString.h>
 #include <AK/Debug.h>
 #include <AK/HashMap.h>
+#include <AK/IPv4Address.h>
 #include <AK/Random.h>
+#include <AK/ScopeGuard.h>
 #include <AK/StdLibExtras.h>
 #include <AK/StringBuilder.h>
+#include <AK/Time.h>
 #include <LibCore/ConfigFile.h>
 #include <LibCore/File.h>
 #include <LibCore/LocalServer.h>
+#include <LibCore/System.h>
 #include <LibDNS/Packet.h>
 #include <limits.h>
+#include <netinet/in.h>
+#include <poll.h>
 #include <stdio.h>
 #include <time.h>
 #include <unistd.h>
@@ -28,6 +36,17 @@ static LookupServer* s_the;
 // NOTE: This is the TTL we return for the hostname or answers from /etc/hosts.
 static constexpr u32 s_static_ttl = 86400;
 
+static constexpr size_t s_max_cache_entries = 1024;
+// NOTE: RFC 2308 derives this from the SOA record in the authority section, which we don't parse, so use a fixed value instead.
+static constexpr time_t s_negative_ttl = 60;
+// RFC 8767: If no nameserver answers, expired records may be served for a while, with a short TTL.
+static constexpr time_t s_max_stale_time = 86400;
+static constexpr u32 s_stale_ttl = 30;
+// Entries that have been hit this many times are refreshed in the background during the last tenth of their TTL.
+static constexpr u32 s_prefetch_minimum_hits = 3;
+static constexpr int s_upstream_attempts = 3;
+static constexpr auto s_upstream_attempt_timeout = Duration::from_seconds(1);
+
 LookupServer& LookupServer::the()
 {
     VERIFY(s_the);
@@ -188,16 +207,35 @@ ErrorOr<Vector<Answer>> LookupServer::lookup(Name const& name, RecordType record
     }
 
     // Third, try our cache.
-    if (auto cached_answers = m_lookup_cache.find(name); cached_answers != m_lookup_cache.end()) {
-        for (auto& answer : cached_answers->value) {
-            // TODO: Actually remove expired answers from the cache.
-            if (answer.type() == record_type && !answer.has_expired()) {
-                dbgln_if(LOOKUPSERVER_DEBUG, "Cache hit: {} -> {}", name.as_string(), answer.record_data());
-                add_answer(answer);
-            }
+    if (auto cached_entry = m_lookup_cache.find(name); cached_entry != m_lookup_cache.end()) {
+        auto& entry = cached_entry->value;
+        auto now = time(nullptr);
+        entry.last_used = now;
+
+        bool is_about_to_expire = false;
+        for (auto& answer : entry.answers) {
+            if (answer.type() != record_type || answer.has_expired())
+                continue;
+            dbgln_if(LOOKUPSERVER_DEBUG, "Cache hit: {} -> {}", name.as_string(), answer.record_data());
+            add_answer(answer);
+            auto remaining_ttl = answer.received_time() + answer.ttl() - now;
+            if (remaining_ttl * 10 <= answer.ttl())
+                is_about_to_expire = true;
         }
-        if (!answers.is_empty())
+        if (!answers.is_empty()) {
+            ++entry.hit_count;
+            if (is_about_to_expire && entry.hit_count >= s_prefetch_minimum_hits)
+                schedule_prefetch(name, record_type);
             return answers;
+        }
+
+        bool is_known_to_not_exist = any_of(entry.negative_answers, [&](auto const& negative_answer) {
+            return negative_answer.type == record_type && negative_answer.expiry > now;
+        });
+        if (is_known_to_not_exist) {
+            dbgln_if(LOOKUPSERVER_DEBUG, "Negative cache hit: {} has no {} records", name.as_string(), record_type);
+            return answers;
+        }
     }
 
     // Fourth, look up .local names using mDNS instead of DNS nameservers.
@@ -209,119 +247,263 @@ ErrorOr<Vector<Answer>> LookupServer::lookup(Name const& name, RecordType record
     }
 
     // Fifth, ask the upstream nameservers.
-    for (auto& nameserver : m_nameservers) {
-        dbgln_if(LOOKUPSERVER_DEBUG, "Doing lookup using nameserver '{}'", nameserver);
-        bool did_get_response = false;
-        int retries = 3;
-        Vector<Answer> upstream_answers;
-        do {
-            auto upstream_answers_or_error = lookup(name, nameserver, did_get_response, record_type);
-            if (upstream_answers_or_error.is_error())
+    if (auto upstream_answers = lookup_upstream(name, record_type); upstream_answers.has_value()) {
+        for (auto& answer : *upstream_answers)
+            add_answer(answer);
+        return answers;
+    }
+
+    // Sixth, fall back to stale answers if none of the nameservers could be reached.
+    if (auto cached_entry = m_lookup_cache.find(name); cached_entry != m_lookup_cache.end()) {
+        auto now = time(nullptr);
+        for (auto& answer : cached_entry->value.answers) {
+            if (answer.type() != record_type || now >= static_cast<time_t>(answer.received_time() + answer.ttl() + s_max_stale_time))
                 continue;
-            upstream_answers = upstream_answers_or_error.release_value();
-            if (did_get_response)
-                break;
-        } while (--retries);
-        if (!upstream_answers.is_empty()) {
-            for (auto& answer : upstream_answers) {
-                add_answer(answer);
-                put_in_cache(answer);
-            }
-            break;
-        } else {
-            if (!did_get_response)
-                dbgln("Never got a response from '{}', trying next nameserver", nameserver);
-            else
-                dbgln("Received response from '{}' but no result(s), trying next nameserver", nameserver);
+            dbgln_if(LOOKUPSERVER_DEBUG, "Serving stale answer: {} -> {}", name.as_string(), answer.record_data());
+            answers.empend(name, answer.type(), answer.class_code(), s_stale_ttl, answer.record_data(), false);
         }
     }
 
-    // Sixth, fail.
-    if (answers.is_empty()) {
+    // Seventh, fail.
+    if (answers.is_empty())
         dbgln("Tried all nameservers but never got a response :(");
-        return Vector<Answer> {};
-    }
 
     return answers;
 }
 
-ErrorOr<Vector<Answer>> LookupServer::lookup(Name const& name, ByteString const& nameserver, bool& did_get_response, RecordType record_type, ShouldRandomizeCase should_randomize_case)
+Optional<Vector<Answer>> LookupServer::lookup_upstream(Name const& name, RecordType record_type)
 {
-    Packet request;
-    request.set_is_query();
-    request.set_id(get_random_uniform(UINT16_MAX));
-    Name name_in_question = name;
-    if (should_randomize_case == ShouldRandomizeCase::Yes)
-        name_in_question.randomize_case();
-    request.add_question({ name_in_question, record_type, RecordClass::IN, false });
+    // Clients asking for an IPv4 address are likely to ask for the IPv6 address next, so resolve both at once.
+    Vector<RecordType, 2> record_types { record_type };
+    if (record_type == RecordType::A)
+        record_types.append(RecordType::AAAA);
 
-    auto buffer = TRY(request.to_byte_buffer());
+    auto results = query_upstream(name, record_types);
 
-    auto udp_socket = TRY(Core::UDPSocket::connect(nameserver, 53, Duration::from_seconds(1)));
-    TRY(udp_socket->set_blocking(true));
+    Optional<Vector<Answer>> requested_answers;
+    for (size_t i = 0; i < record_types.size(); ++i) {
+        auto& result = results[i];
+        if (!result.did_get_response)
+            continue;
 
-    TRY(udp_socket->write_until_depleted(buffer));
+        Vector<Answer> matching_answers;
+        for (auto& answer : result.answers) {
+            put_in_cache(answer);
+            if (answer.type() != record_types[i])
+                continue;
+            // Records found through a CNAME belong to the canonical name, so also remember them for the name we were asked about.
+            if (answer.name() != name)
+                put_in_cache(Answer { name, answer.type(), answer.class_code(), answer.ttl(), answer.record_data(), false });
+            matching_answers.append(answer);
+        }
+        if (matching_answers.is_empty())
+            put_negative_in_cache(name, record_types[i]);
 
-    u8 response_buffer[4096];
-    auto nrecv = TRY(udp_socket->read_some({ response_buffer, sizeof(response_buffer) })).size();
-    if (udp_socket->is_eof())
-        return Vector<Answer> {};
+        if (i == 0)
+            requested_answers = move(matching_answers);
+    }
+    return requested_answers;
+}
 
-    did_get_response = true;
+static ErrorOr<int> connect_to_nameserver(ByteString const& nameserver)
+{
+    // NOTE: Nameservers have to be given as addresses, resolving their names would have to go through ourselves.
+    auto address = IPv4Address::from_string(nameserver);
+    if (!address.has_value())
+        return Error::from_string_literal("Nameserver is not an IPv4 address");
+
+    auto fd = TRY(Core::System::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0));
+    sockaddr_in socket_address {};
+    socket_address.sin_family = AF_INET;
+    socket_address.sin_port = htons(53);
+    socket_address.sin_addr.s_addr = address->to_in_addr_t();
+    if (auto result = Core::System::connect(fd, reinterpret_cast<sockaddr const*>(&socket_address), sizeof(socket_address)); result.is_error()) {
+        (void)Core::System::close(fd);
+        return result.release_error();
+    }
+    return fd;
+}
 
-    auto response_or_error = Packet::from_raw_packet({ response_buffer, nrecv });
-    if (response_or_error.is_error())
-        return Vector<Answer> {};
+Vector<LookupServer::UpstreamResult> LookupServer::query_upstream(Name const& name, ReadonlySpan<RecordType> record_types)
+{
+    Vector<UpstreamResult> results;
+    results.resize(record_types.size());
 
-    auto response = response_or_error.release_value();
+    Vector<int> sockets;
+    ScopeGuard close_sockets = [&] {
+        for (auto fd : sockets)
+            (void)Core::System::close(fd);
+    };
+    for (auto& nameserver : m_nameservers) {
+        auto fd_or_error = connect_to_nameserver(nameserver);
+        if (fd_or_error.is_error()) {
+            dbgln("LookupServer: Can't reach nameserver '{}': {}", nameserver, fd_or_error.error());
+            continue;
+        }
+        sockets.append(fd_or_error.release_value());
+    }
 
-    if (response.id() != request.id()) {
-        dbgln("LookupServer: ID mismatch ({} vs {}) :(", response.id(), request.id());
-        return Vector<Answer> {};
+    // Every nameserver gets asked every question at once, and the first usable response for each question wins.
+    struct PendingQuery {
+        size_t socket_index { 0 };
+        size_t record_type_index { 0 };
+        u16 id { 0 };
+        Name name_in_question;
+        ShouldRandomizeCase should_randomize_case { ShouldRandomizeCase::Yes };
+    };
+    Vector<PendingQuery> queries;
+    for (size_t socket_index = 0; socket_index < sockets.size(); ++socket_index) {
+        for (size_t record_type_index = 0; record_type_index < record_types.size(); ++record_type_index)
+            queries.append({ .socket_index = socket_index, .record_type_index = record_type_index });
     }
 
-    if (response.code() == Packet::Code::REFUSED) {
-        if (should_randomize_case == ShouldRandomizeCase::Yes) {
-            // Retry with 0x20 case randomization turned off.
-            return lookup(name, nameserver, did_get_response, record_type, ShouldRandomizeCase::No);
+    auto send_query = [&](PendingQuery& query) {
+        Packet request;
+        request.set_is_query();
+        query.id = get_random_uniform(UINT16_MAX);
+        request.set_id(query.id);
+        query.name_in_question = name;
+        if (query.should_randomize_case == ShouldRandomizeCase::Yes)
+            query.name_in_question.randomize_case();
+        request.add_question({ query.name_in_question, record_types[query.record_type_index], RecordClass::IN, false });
+
+        auto buffer_or_error = request.to_byte_buffer();
+        if (buffer_or_error.is_error())
+            return;
+        auto buffer = buffer_or_error.release_value();
+        if (auto result = Core::System::send(sockets[query.socket_index], buffer.data(), buffer.size(), 0); result.is_error())
+            dbgln_if(LOOKUPSERVER_DEBUG, "Failed to send query to nameserver: {}", result.error());
+    };
+
+    auto receive_response = [&](size_t socket_index) {
+        u8 response_buffer[4096];
+        auto nrecv_or_error = Core::System::recv(sockets[socket_index], response_buffer, sizeof(response_buffer), 0);
+        if (nrecv_or_error.is_error())
+            return;
+
+        auto response_or_error = Packet::from_raw_packet({ response_buffer, static_cast<size_t>(nrecv_or_error.value()) });
+        if (response_or_error.is_error())
+            return;
+        auto response = response_or_error.release_value();
+
+        auto query = queries.find_if([&](auto const& query) { return query.socket_index == socket_index && query.id == response.id(); });
+        if (query == queries.end()) {
+            dbgln("LookupServer: No query with ID {} :(", response.id());
+            return;
         }
-        return Vector<Answer> {};
-    }
 
-    if (response.question_count() != request.question_count()) {
-        dbgln("LookupServer: Question count ({} vs {}) :(", response.question_count(), request.question_count());
-        return Vector<Answer> {};
-    }
+        auto& result = results[query->record_type_index];
+        if (result.did_get_response)
+            return;
 
-    // Verify the questions in our request and in their response match, ignoring case.
-    for (size_t i = 0; i < request.question_count(); ++i) {
-        auto& request_question = request.questions()[i];
-        auto& response_question = response.questions()[i];
-        bool match = request_question.class_code() == response_question.class_code()
-            && request_question.record_type() == response_question.record_type()
-            && request_question.name().as_string().equals_ignoring_ascii_case(response_question.name().as_string());
+        if (response.code() == Packet::Code::REFUSED) {
+            if (query->should_randomize_case == ShouldRandomizeCase::Yes) {
+                // Retry with 0x20 case randomization turned off.
+                query->should_randomize_case = ShouldRandomizeCase::No;
+                send_query(*query);
+            }
+            return;
+        }
+        // Let another nameserver have a go at it.
+        if (response.code() != Packet::Code::NOERROR && response.code() != Packet::Code::NXDOMAIN)
+            return;
+
+        if (response.question_count() != 1) {
+            dbgln("LookupServer: Question count ({} vs 1) :(", response.question_count());
+            return;
+        }
+
+        // Verify the question in our request and in their response match, ignoring case.
+        auto& response_question = response.questions()[0];
+        bool match = response_question.class_code() == RecordClass::IN
+            && response_question.record_type() == record_types[query->record_type_index]
+            && query->name_in_question.as_string().equals_ignoring_ascii_case(response_question.name().as_string());
         if (!match) {
             dbgln("Request and response questions do not match");
-            dbgln("   Request: name=_{}_, type={}, class={}", request_question.name().as_string(), response_question.record_type(), response_question.class_code());
+            dbgln("   Request: name=_{}_, type={}", query->name_in_question.as_string(), record_types[query->record_type_index]);
             dbgln("  Response: name=_{}_, type={}, class={}", response_question.name().as_string(), response_question.record_type(), response_question.class_code());
-            return Vector<Answer> {};
+            return;
         }
-    }
 
-    if (response.answer_count() < 1) {
-        dbgln("LookupServer: No answers :(");
-        return Vector<Answer> {};
+        result.did_get_response = true;
+        result.answers = response.answers();
+    };
+
+    auto all_questions_answered = [&] {
+        return all_of(results, [](auto const& result) { return result.did_get_response; });
+    };
+
+    for (int attempt = 0; attempt < s_upstream_attempts && !sockets.is_empty() && !all_questions_answered(); ++attempt) {
+        for (auto& query : queries) {
+            if (!results[query.record_type_index].did_get_response)
+                send_query(query);
+        }
+
+        auto deadline = MonotonicTime::now() + s_upstream_attempt_timeout;
+        while (!all_questions_answered()) {
+            auto remaining = deadline - MonotonicTime::now();
+            if (remaining <= Duration::zero())
+                break;
+
+            Vector<pollfd> poll_fds;
+            for (auto fd : sockets)
+                poll_fds.append({ .fd = fd, .events = POLLIN, .revents = 0 });
+            auto ready_or_error = Core::System::poll(poll_fds, static_cast<int>(remaining.to_milliseconds()));
+            if (ready_or_error.is_error()) {
+                if (ready_or_error.error().code() == EINTR)
+                    continue;
+                break;
+            }
+            if (ready_or_error.value() == 0)
+                break;
+
+            for (size_t socket_index = 0; socket_index < sockets.size(); ++socket_index) {
+                if (poll_fds[socket_index].revents & POLLIN)
+                    receive_response(socket_index);
+            }
+        }
     }
 
-    Vector<Answer, 8> answers;
-    for (auto& answer : response.answers()) {
-        put_in_cache(answer);
-        if (answer.type() != record_type)
-            continue;
-        answers.append(answer);
+    return results;
+}
+
+LookupServer::CacheEntry& LookupServer::ensure_cache_entry(Name const& name)
+{
+    if (auto it = m_lookup_cache.find(name); it != m_lookup_cache.end())
+        return it->value;
+
+    // Prevent the cache from growing too big by evicting the entry that was used the longest time ago.
+    if (m_lookup_cache.size() >= s_max_cache_entries) {
+        auto least_recently_used = m_lookup_cache.begin();
+        for (auto it = m_lookup_cache.begin(); it != m_lookup_cache.end(); ++it) {
+            if (it->value.last_used < least_recently_used->value.last_used)
+                least_recently_used = it;
+        }
+        dbgln_if(LOOKUPSERVER_DEBUG, "Evicting cache entry: {}", least_recently_used->key.as_string());
+        m_lookup_cache.remove(least_recently_used);
     }
 
-    return answers;
+    return m_lookup_cache.ensure(name, [] { return CacheEntry { .last_used = time(nullptr) }; });
+}
+
+void LookupServer::put_negative_in_cache(Name const& name, RecordType record_type)
+{
+    auto& entry = ensure_cache_entry(name);
+    entry.negative_answers.remove_all_matching([&](auto const& negative_answer) { return negative_answer.type == record_type; });
+    entry.negative_answers.append({ record_type, time(nullptr) + s_negative_ttl });
+}
+
+void LookupServer::schedule_prefetch(Name const& name, RecordType record_type)
+{
+    auto key = ByteString::formatted("{}/{}", name.as_string().to_lowercase(), to_underlying(record_type));
+    if (m_pending_prefetches.set(key) != AK::HashSetResult::InsertedNewEntry)
+        return;
+
+    dbgln_if(LOOKUPSERVER_DEBUG, "Prefetching {} records for '{}' before they expire", record_type, name.as_string());
+    deferred_invoke([this, name, record_type, key = move(key)] {
+        (void)lookup_upstream(name, record_type);
+        m_pending_prefetches.remove(key);
+    });
 }
 
 void LookupServer::put_in_cache(Answer const& answer)
@@ -329,31 +511,32 @@ void LookupServer::put_in_cache(Answer const& answer)
     if (answer.has_expired())
         return;
 
-    // Prevent the cache from growing too big.
-    // TODO: Evict least used entries.
-    if (m_lookup_cache.size() >= 256)
-        m_lookup_cache.remove(m_lookup_cache.begin());
-
-    auto it = m_lookup_cache.find(answer.name());
-    if (it == m_lookup_cache.end())
-        m_lookup_cache.set(answer.name(), { answer });
-    else {
-        if (answer.mdns_cache_flush()) {
-            auto now = time(nullptr);
+    auto& entry = ensure_cache_entry(answer.name());
+    auto now = time(nullptr);
 
-            it->value.remove_all_matching([&](Answer const& other_answer) {
-                if (other_answer.type() != answer.type() || other_answer.class_code() != answer.class_code())
-                    return false;
+    if (answer.mdns_cache_flush()) {
+        entry.answers.remove_all_matching([&](Answer const& other_answer) {
+            if (other_answer.type() != answer.type() || other_answer.class_code() != answer.class_code())
+                return false;
 
-                if (other_answer.received_time() >= now - 1)
-                    return false;
+            if (other_answer.received_time() >= now - 1)
+                return false;
 
-                dbgln_if(LOOKUPSERVER_DEBUG, "Removing cache entry: {}", other_answer.name());
-                return true;
-            });
-        }
-        it->value.append(answer);
+            dbgln_if(LOOKUPSERVER_DEBUG, "Removing cache entry: {}", other_answer.name());
+            return true;
+        });
     }
+
+    // Replace older copies of this record, and drop records that are too old to even be served stale.
+    entry.answers.remove_all_matching([&](Answer const& other_answer) {
+        if (now >= static_cast<time_t>(other_answer.received_time() + other_answer.ttl() + s_max_stale_time))
+            return true;
+        return other_answer.type() == answer.type()
+            && other_answer.class_code() == answer.class_code()
+            && other_answer.record_data() == answer.record_data();
+    });
+    entry.negative_answers.remove_all_matching([&](auto const& negative_answer) { return negative_answer.type == answer.type(); });
+    entry.answers.append(answer);
 }
 
 }
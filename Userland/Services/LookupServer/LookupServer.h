@@ -9,6 +9,7 @@
 #include "ConnectionFromClient.h"
 #include "DNSServer.h"
 #include "MulticastDNS.h"
+#include <AK/HashTable.h>
 #include <LibCore/EventReceiver.h>
 #include <LibCore/FileWatcher.h>
 #include <LibDNS/Name.h>
@@ -29,11 +30,31 @@ public:
 private:
     LookupServer();
 
+    struct CacheEntry {
+        struct NegativeAnswer {
+            RecordType type;
+            time_t expiry;
+        };
+        Vector<Answer> answers;
+        Vector<NegativeAnswer> negative_answers;
+        time_t last_used { 0 };
+        u32 hit_count { 0 };
+    };
+
+    struct UpstreamResult {
+        bool did_get_response { false };
+        Vector<Answer> answers;
+    };
+
     ErrorOr<HashMap<Name, Vector<Answer>, Name::Traits>> try_load_etc_hosts();
     void load_etc_hosts();
+    CacheEntry& ensure_cache_entry(Name const&);
     void put_in_cache(Answer const&);
+    void put_negative_in_cache(Name const&, RecordType);
+    void schedule_prefetch(Name const&, RecordType);
 
-    ErrorOr<Vector<Answer>> lookup(Name const& hostname, ByteString const& nameserver, bool& did_get_response, RecordType record_type, ShouldRandomizeCase = ShouldRandomizeCase::Yes);
+    Optional<Vector<Answer>> lookup_upstream(Name const&, RecordType);
+    Vector<UpstreamResult> query_upstream(Name const&, ReadonlySpan<RecordType>);
 
     OwnPtr<IPC::MultiServer<ConnectionFromClient>> m_server;
     RefPtr<DNSServer> m_dns_server;
@@ -41,7 +62,8 @@ private:
     Vector<ByteString> m_nameservers;
     RefPtr<Core::FileWatcher> m_file_watcher;
     HashMap<Name, Vector<Answer>, Name::Traits> m_etc_hosts;
-    HashMap<Name, Vector<Answer>, Name::Traits> m_lookup_cache;
+    HashMap<Name, CacheEntry, Name::Traits> m_lookup_cache;
+    HashTable<ByteString> m_pending_prefetches;
 };
 
 }
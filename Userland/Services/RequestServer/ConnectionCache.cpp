@@ -14,6 +14,39 @@ namespace RequestServer::ConnectionCache {
 Threading::RWLockProtected<HashMap<ConnectionKey, NonnullOwnPtr<Vector<NonnullOwnPtr<Connection<Core::TCPSocket, Core::Socket>>>>>> g_tcp_connection_cache {};
 Threading::RWLockProtected<HashMap<ConnectionKey, NonnullOwnPtr<Vector<NonnullOwnPtr<Connection<TLS::TLSv12>>>>>> g_tls_connection_cache {};
 Threading::RWLockProtected<HashMap<ByteString, InferredServerProperties>> g_inferred_server_properties;
+Threading::RWLockProtected<HashMap<ByteString, HostStatistics>> g_host_statistics;
+
+struct ResolvedHost {
+    IPv4Address address;
+    MonotonicTime expiry;
+};
+static Threading::RWLockProtected<HashMap<ByteString, ResolvedHost>> s_resolved_hosts;
+
+ErrorOr<IPv4Address> resolve_host(ByteString const& hostname)
+{
+    auto now = MonotonicTime::now_coarse();
+    auto update_statistics = [&](auto callback) {
+        g_host_statistics.with_write_locked([&](auto& map) { callback(map.ensure(hostname)); });
+    };
+
+    auto cached_address = s_resolved_hosts.with_read_locked([&](auto const& map) -> Optional<IPv4Address> {
+        if (auto it = map.find(hostname); it != map.end() && it->value.expiry > now)
+            return it->value.address;
+        return {};
+    });
+    if (cached_address.has_value()) {
+        update_statistics([](auto& statistics) { ++statistics.dns_cache_hits; });
+        return *cached_address;
+    }
+
+    update_statistics([](auto& statistics) { ++statistics.dns_lookups; });
+    auto address = TRY(Core::Socket::resolve_host(hostname, Core::Socket::SocketType::Stream));
+    s_resolved_hosts.with_write_locked([&](auto& map) {
+        map.remove_all_matching([&](auto const&, auto const& resolved_host) { return resolved_host.expiry <= now; });
+        map.set(hostname, { address, now + ResolvedHostLifetime });
+    });
+    return address;
+}
 
 void request_did_finish(URL::URL const& url, Core::Socket const* socket)
 {
@@ -77,6 +110,7 @@ void request_did_finish(URL::URL const& url, Core::Socket const* socket)
                             return;
 
                         dbgln_if(REQUESTSERVER_DEBUG, "Removing no-longer-used connection {} (socket {})", ptr, ptr->socket.ptr());
+                        g_host_statistics.with_write_locked([&](auto& map) { ++map.ensure(key.hostname).idle_connections_closed; });
                         cache.with_write_locked([&](CacheType& cache) {
                             auto did_remove = cache_entry.remove_first_matching([&](auto& entry) { return entry == ptr; });
                             VERIFY(did_remove);
@@ -160,6 +194,14 @@ void dump_jobs()
             }
         }
     });
+
+    g_host_statistics.with_read_locked([](auto& statistics) {
+        dbgln("=========== Host Statistics ==========");
+        for (auto& [hostname, host_statistics] : statistics) {
+            dbgln(" - {}: {} connections opened, {} requests on open connections, {} idle connections closed, {} DNS cache hits, {} DNS lookups",
+                hostname, host_statistics.connections_opened, host_statistics.requests_on_open_connections, host_statistics.idle_connections_closed, host_statistics.dns_cache_hits, host_statistics.dns_lookups);
+        }
+    });
 }
 
 size_t hits;
@@ -30,6 +30,9 @@ enum class CacheLevel {
 
 namespace RequestServer::ConnectionCache {
 
+// Looks the host up, or reuses a recent lookup of it (e.g. one made ahead of time for a DNS prefetch).
+ErrorOr<IPv4Address> resolve_host(ByteString const& hostname);
+
 struct Proxy {
     Core::ProxyData data;
     OwnPtr<Core::SOCKSProxyClient> proxy_client_storage {};
@@ -38,7 +41,12 @@ struct Proxy {
     ErrorOr<NonnullOwnPtr<StorageType>> tunnel(URL::URL const& url, Args&&... args)
     {
         if (data.type == Core::ProxyData::Direct) {
-            return TRY(SocketType::connect(TRY(url.serialized_host()).to_byte_string(), url.port_or_default(), forward<Args>(args)...));
+            auto hostname = TRY(url.serialized_host()).to_byte_string();
+            Core::SocketAddress address { TRY(resolve_host(hostname)), url.port_or_default() };
+            if constexpr (IsSame<SocketType, TLS::TLSv12>)
+                return TRY(SocketType::connect(address, hostname, forward<Args>(args)...));
+            else
+                return TRY(SocketType::connect(address, forward<Args>(args)...));
         }
         if (data.type == Core::ProxyData::SOCKS5) {
             if constexpr (requires { SocketType::connect(declval<ByteString>(), *proxy_client_storage, forward<Args>(args)...); }) {
@@ -171,9 +179,19 @@ struct InferredServerProperties {
     size_t requests_served_per_connection { NumericLimits<size_t>::max() };
 };
 
+// Dumped along with the jobs, to see how well connections get reused and whether idle ones are kept long enough.
+struct HostStatistics {
+    size_t connections_opened { 0 };
+    size_t requests_on_open_connections { 0 };
+    size_t idle_connections_closed { 0 };
+    size_t dns_cache_hits { 0 };
+    size_t dns_lookups { 0 };
+};
+
 extern Threading::RWLockProtected<HashMap<ConnectionKey, NonnullOwnPtr<Vector<NonnullOwnPtr<Connection<Core::TCPSocket, Core::Socket>>>>>> g_tcp_connection_cache;
 extern Threading::RWLockProtected<HashMap<ConnectionKey, NonnullOwnPtr<Vector<NonnullOwnPtr<Connection<TLS::TLSv12>>>>>> g_tls_connection_cache;
 extern Threading::RWLockProtected<HashMap<ByteString, InferredServerProperties>> g_inferred_server_properties;
+extern Threading::RWLockProtected<HashMap<ByteString, HostStatistics>> g_host_statistics;
 
 void request_did_finish(URL::URL const&, Core::Socket const*);
 void dump_jobs();
@@ -181,6 +199,9 @@ void dump_jobs();
 constexpr static size_t MaxConcurrentConnectionsPerURL = 4;
 constexpr static size_t ConnectionKeepAliveTimeMilliseconds = 20'000;
 constexpr static size_t ConnectionCacheQueueHighWatermark = 4;
+// getaddrinfo() doesn't tell us the TTL of what it resolved, so use a lifetime that is short enough to not get in the
+// way of hosts moving to another address, and long enough to outlive the time between a DNS prefetch and the request.
+constexpr static auto ResolvedHostLifetime = AK::Duration::from_seconds(60);
 
 template<typename T>
 ErrorOr<void> recreate_socket_if_needed(T& connection, URL::URL const& url)
@@ -235,6 +256,9 @@ void ensure_connection(auto& cache, const URL::URL& url, auto job, Core::ProxyDa
     using CacheEntryType = RemoveCVReference<decltype(*declval<typename RemoveCVReference<decltype(cache)>::ProtectedType>().begin()->value)>;
 
     auto hostname = url.serialized_host().release_value_but_fixme_should_propagate_errors().to_byte_string();
+    auto update_statistics = [hostname](auto callback) {
+        g_host_statistics.with_write_locked([&](auto& map) { callback(map.ensure(hostname)); });
+    };
     auto& properties = g_inferred_server_properties.with_write_locked([&](auto& map) -> InferredServerProperties& { return map.ensure(hostname); });
 
     auto& sockets_for_url = *cache.with_write_locked([&](auto& map) -> NonnullOwnPtr<CacheEntryType>& {
@@ -277,6 +301,7 @@ void ensure_connection(auto& cache, const URL::URL& url, auto job, Core::ProxyDa
 
         auto connection_result = proxy.tunnel<typename ConnectionType::SocketType, typename ConnectionType::StorageType>(url);
         misses++;
+        update_statistics([](auto& statistics) { ++statistics.connections_opened; });
         if (connection_result.is_error()) {
             dbgln("ConnectionCache: Connection to {} failed: {}", url, connection_result.error());
             Core::deferred_invoke([job] {
@@ -313,6 +338,7 @@ void ensure_connection(auto& cache, const URL::URL& url, auto job, Core::ProxyDa
     } else {
         index = it.index();
         hits++;
+        update_statistics([](auto& statistics) { ++statistics.requests_on_open_connections; });
     }
 
     dbgln_if(REQUESTSERVER_DEBUG, "ConnectionCache: Hits: {}, Misses: {}", RequestServer::ConnectionCache::hits, RequestServer::ConnectionCache::misses);
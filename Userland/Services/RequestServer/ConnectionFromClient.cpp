@@ -9,11 +9,14 @@
 #include <AK/NonnullOwnPtr.h>
 #include <AK/RefCounted.h>
 #include <AK/Weakable.h>
+#include <LibCore/File.h>
 #include <LibCore/Proxy.h>
 #include <LibCore/Socket.h>
+#include <LibCore/System.h>
 #include <LibWebSocket/ConnectionInfo.h>
 #include <LibWebSocket/Message.h>
 #include <RequestServer/ConnectionFromClient.h>
+#include <RequestServer/HttpCache.h>
 #include <RequestServer/Protocol.h>
 #include <RequestServer/Request.h>
 #include <RequestServer/RequestClientEndpoint.h>
@@ -102,6 +105,13 @@ void ConnectionFromClient::worker_do_work(Work work)
 {
     work.visit(
         [&](StartRequest& start_request) {
+            if (HttpCache::can_use_cache_for(start_request.method, start_request.url, start_request.request_headers)) {
+                if (auto response = HttpCache::the().fresh_response_for(start_request.url, start_request.request_headers); response.has_value()) {
+                    respond_from_cache(start_request.request_id, response.release_value());
+                    return;
+                }
+            }
+
             auto* protocol = Protocol::find_by_name(start_request.url.scheme().to_byte_string());
             if (!protocol) {
                 dbgln("StartRequest: No protocol handler for URL: '{}'", start_request.url);
@@ -129,7 +139,7 @@ void ConnectionFromClient::worker_do_work(Work work)
             if (cache_level == CacheLevel::ResolveOnly) {
                 Core::deferred_invoke([host = url.serialized_host().release_value_but_fixme_should_propagate_errors().to_byte_string()] {
                     dbgln("EnsureConnection: DNS-preload for {}", host);
-                    auto resolved_host = Core::Socket::resolve_host(host, Core::Socket::SocketType::Stream);
+                    auto resolved_host = ConnectionCache::resolve_host(host);
                     if (resolved_host.is_error())
                         dbgln("EnsureConnection: DNS-preload failed for {}", host);
                 });
@@ -153,6 +163,33 @@ void ConnectionFromClient::worker_do_work(Work work)
         [&](Empty) {});
 }
 
+void ConnectionFromClient::respond_from_cache(i32 request_id, HttpCache::Response response)
+{
+    auto send_response = [&]() -> ErrorOr<void> {
+        auto fds = TRY(Core::System::pipe2(O_NONBLOCK));
+        auto output_stream = TRY(Core::File::adopt_fd(fds[1], Core::File::OpenMode::Write));
+
+        {
+            auto lock = Threading::MutexLocker(m_ipc_mutex);
+            (void)post_message(Messages::RequestClient::RequestStarted(request_id, IPC::File::adopt_fd(fds[0])));
+            async_headers_became_available(request_id, move(response.headers), response.status_code);
+        }
+
+        // NOTE: This blocks until the client has read everything that doesn't fit in the pipe, which is fine on a worker thread.
+        TRY(output_stream->set_blocking(true));
+        TRY(output_stream->write_until_depleted(response.body));
+        return {};
+    };
+
+    auto result = send_response();
+    if (result.is_error())
+        dbgln("StartRequest: Failed to send the cached response for request {}: {}", request_id, result.error());
+
+    auto lock = Threading::MutexLocker(m_ipc_mutex);
+    async_request_progress(request_id, response.body.size(), response.body.size());
+    async_request_finished(request_id, !result.is_error(), response.body.size());
+}
+
 void ConnectionFromClient::die()
 {
     auto client_id = this->client_id();
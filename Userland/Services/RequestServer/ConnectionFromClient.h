@@ -13,6 +13,7 @@
 #include <LibThreading/ThreadPool.h>
 #include <LibWebSocket/WebSocket.h>
 #include <RequestServer/Forward.h>
+#include <RequestServer/HttpCache.h>
 #include <RequestServer/RequestClientEndpoint.h>
 #include <RequestServer/RequestServerEndpoint.h>
 
@@ -66,6 +67,7 @@ private:
     using Work = Variant<StartRequest, EnsureConnection, Empty>;
 
     void worker_do_work(Work);
+    void respond_from_cache(i32 request_id, HttpCache::Response);
 
     Threading::MutexProtected<HashMap<i32, OwnPtr<Request>>> m_requests;
     HashMap<i32, RefPtr<WebSocket::WebSocket>> m_websockets;
@@ -0,0 +1,384 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <LibCore/DateTime.h>
+#include <RequestServer/HttpCache.h>
+
+namespace RequestServer {
+
+static constexpr size_t maximum_size_of_cache_in_bytes = 64 * MiB;
+static constexpr size_t maximum_size_of_entry_in_bytes = 8 * MiB;
+
+// Like other browsers, never consider a response fresh for longer than a week based on its Last-Modified date alone.
+static constexpr auto maximum_heuristic_freshness_lifetime = AK::Duration::from_seconds(7 * 24 * 60 * 60);
+
+HttpCache& HttpCache::the()
+{
+    static HttpCache s_the;
+    return s_the;
+}
+
+static ByteString cache_key(URL::URL const& url)
+{
+    return url.serialize(URL::ExcludeFragment::Yes);
+}
+
+static Optional<ByteString> request_header(HttpCache::RequestHeaders const& headers, StringView name)
+{
+    for (auto const& [header_name, value] : headers) {
+        if (header_name.equals_ignoring_ascii_case(name))
+            return value;
+    }
+    return {};
+}
+
+static Optional<ByteString> response_header(HttpCache::ResponseHeaders const& headers, StringView name)
+{
+    if (auto it = headers.find(name); it != headers.end())
+        return it->value;
+    return {};
+}
+
+// https://httpwg.org/specs/rfc9111.html#field.cache-control
+// Returns the value of the directive if it is present, or an empty string if it's present without a value.
+static Optional<StringView> cache_control_directive(Optional<ByteString> const& cache_control, StringView name)
+{
+    if (!cache_control.has_value())
+        return {};
+
+    for (auto directive : cache_control->split_view(',')) {
+        auto equals_sign = directive.find('=');
+        auto directive_name = directive.substring_view(0, equals_sign.value_or(directive.length())).trim_whitespace();
+        if (!directive_name.equals_ignoring_ascii_case(name))
+            continue;
+        if (!equals_sign.has_value())
+            return ""sv;
+
+        auto value = directive.substring_view(*equals_sign + 1).trim_whitespace();
+        if (value.length() >= 2 && value.starts_with('"') && value.ends_with('"'))
+            value = value.substring_view(1, value.length() - 2);
+        return value;
+    }
+    return {};
+}
+
+// https://httpwg.org/specs/rfc9110.html#http.date
+static Optional<UnixDateTime> parse_http_date(Optional<ByteString> const& value)
+{
+    if (!value.has_value())
+        return {};
+
+    // FIXME: Also accept the obsolete RFC 850 and asctime() formats.
+    auto date_time = Core::DateTime::parse("%a, %d %b %Y %H:%M:%S %Z"sv, *value);
+    if (!date_time.has_value())
+        return {};
+    return UnixDateTime::from_seconds_since_epoch(date_time->timestamp());
+}
+
+// https://httpwg.org/specs/rfc9110.html#rfc.section.15.1
+static bool is_heuristically_cacheable_status(u32 status_code)
+{
+    static constexpr Array heuristically_cacheable_status_codes { 200u, 203u, 204u, 206u, 300u, 301u, 308u, 404u, 405u, 410u, 414u, 501u };
+    return heuristically_cacheable_status_codes.contains_slow(status_code);
+}
+
+// https://httpwg.org/specs/rfc9111.html#calculating.freshness.lifetime
+static AK::Duration freshness_lifetime(HttpCache::Response const& response, UnixDateTime response_time)
+{
+    auto cache_control = response_header(response.headers, "Cache-Control"sv);
+
+    // NOTE: This is a private cache, so s-maxage doesn't apply to it.
+    if (auto max_age = cache_control_directive(cache_control, "max-age"sv); max_age.has_value()) {
+        // An invalid max-age means that the response is stale.
+        auto seconds = max_age->to_number<i64>();
+        if (!seconds.has_value() || *seconds < 0)
+            return AK::Duration::zero();
+        return AK::Duration::from_seconds(*seconds);
+    }
+
+    // If there is no Date, the cache is supposed to use the time it received the response at instead.
+    auto date = parse_http_date(response_header(response.headers, "Date"sv)).value_or(response_time);
+
+    if (auto expires = response_header(response.headers, "Expires"sv); expires.has_value()) {
+        // An invalid date, like "0", means that the response is already expired.
+        auto expires_date = parse_http_date(expires);
+        if (!expires_date.has_value())
+            return AK::Duration::zero();
+        return max(*expires_date - date, AK::Duration::zero());
+    }
+
+    // https://httpwg.org/specs/rfc9111.html#heuristic.freshness
+    if (cache_control_directive(cache_control, "public"sv).has_value() || is_heuristically_cacheable_status(response.status_code)) {
+        if (auto last_modified = parse_http_date(response_header(response.headers, "Last-Modified"sv)); last_modified.has_value() && *last_modified < date) {
+            auto lifetime = AK::Duration::from_milliseconds((date - *last_modified).to_milliseconds() / 10);
+            return min(lifetime, maximum_heuristic_freshness_lifetime);
+        }
+    }
+
+    return AK::Duration::zero();
+}
+
+static bool has_validator(HttpCache::Response const& response)
+{
+    return response.headers.contains("ETag"sv) || response.headers.contains("Last-Modified"sv);
+}
+
+// https://httpwg.org/specs/rfc9111.html#response.cacheability
+static bool is_storable(HttpCache::Response const& response, HttpCache::RequestHeaders const& request_headers, AK::Duration lifetime)
+{
+    // NOTE: Only status codes whose semantics we know for sure are stored.
+    if (!is_heuristically_cacheable_status(response.status_code) || response.status_code == 206)
+        return false;
+
+    if (cache_control_directive(request_header(request_headers, "Cache-Control"sv), "no-store"sv).has_value())
+        return false;
+    if (cache_control_directive(response_header(response.headers, "Cache-Control"sv), "no-store"sv).has_value())
+        return false;
+
+    // A response that varies on everything can never be selected again.
+    if (auto vary = response_header(response.headers, "Vary"sv); vary.has_value() && vary->trim_whitespace() == "*"sv)
+        return false;
+
+    // NOTE: Replaying a stored Set-Cookie would set the same cookie again every time the response is used.
+    if (response.headers.contains("Set-Cookie"sv))
+        return false;
+
+    // A response that is never fresh and can't be revalidated would never get used.
+    return lifetime > AK::Duration::zero() || has_validator(response);
+}
+
+bool HttpCache::is_safe_method(ByteString const& method)
+{
+    return method.is_one_of_ignoring_ascii_case("GET"sv, "HEAD"sv, "OPTIONS"sv, "TRACE"sv);
+}
+
+bool HttpCache::can_use_cache_for(ByteString const& method, URL::URL const& url, RequestHeaders const& request_headers)
+{
+    if (!url.scheme().is_one_of("http"sv, "https"sv))
+        return false;
+    if (!method.equals_ignoring_ascii_case("GET"sv))
+        return false;
+
+    // NOTE: Responses to requests with credentials are only reusable with explicit permission, so don't bother.
+    if (request_header(request_headers, "Authorization"sv).has_value())
+        return false;
+
+    // Leave partial and conditional requests the client made itself alone.
+    static constexpr Array headers_to_leave_alone { "Range"sv, "If-Match"sv, "If-None-Match"sv, "If-Modified-Since"sv, "If-Unmodified-Since"sv, "If-Range"sv };
+    for (auto header_name : headers_to_leave_alone) {
+        if (request_header(request_headers, header_name).has_value())
+            return false;
+    }
+
+    return !cache_control_directive(request_header(request_headers, "Cache-Control"sv), "no-store"sv).has_value();
+}
+
+// https://httpwg.org/specs/rfc9111.html#age.calculations
+AK::Duration HttpCache::Entry::current_age(UnixDateTime now) const
+{
+    return corrected_initial_age + max(now - response_time, AK::Duration::zero());
+}
+
+bool HttpCache::Entry::is_fresh(UnixDateTime now) const
+{
+    return !requires_revalidation && current_age(now) < freshness_lifetime;
+}
+
+// https://httpwg.org/specs/rfc9111.html#caching.negotiated.responses
+bool HttpCache::Entry::matches(RequestHeaders const& request_headers) const
+{
+    for (auto const& [name, stored_value] : selecting_request_headers) {
+        if (request_header(request_headers, name).value_or({}) != stored_value)
+            return false;
+    }
+    return true;
+}
+
+Optional<HttpCache::Response> HttpCache::fresh_response_for(URL::URL const& url, RequestHeaders const& request_headers)
+{
+    // https://httpwg.org/specs/rfc9111.html#cache-request-directive
+    auto cache_control = request_header(request_headers, "Cache-Control"sv);
+    if (cache_control_directive(cache_control, "no-cache"sv).has_value())
+        return {};
+    if (!cache_control.has_value() && request_header(request_headers, "Pragma"sv).value_or({}).contains("no-cache"sv, CaseSensitivity::CaseInsensitive))
+        return {};
+
+    Optional<AK::Duration> maximum_age;
+    if (auto max_age = cache_control_directive(cache_control, "max-age"sv); max_age.has_value())
+        maximum_age = AK::Duration::from_seconds(max_age->to_number<i64>().value_or(0));
+
+    return m_state.with_locked([&](State& state) -> Optional<Response> {
+        auto it = state.entries.find(cache_key(url));
+        if (it == state.entries.end() || !it->value.matches(request_headers))
+            return {};
+
+        auto& entry = it->value;
+        auto now = UnixDateTime::now();
+        if (!entry.is_fresh(now))
+            return {};
+
+        auto age = entry.current_age(now);
+        if (maximum_age.has_value() && age > *maximum_age)
+            return {};
+
+        entry.last_use = state.next_use++;
+
+        auto response = entry.response;
+        response.headers.set("Age"sv, ByteString::number(age.to_seconds()));
+        return response;
+    });
+}
+
+Optional<HttpCache::Response> HttpCache::stale_response_for(URL::URL const& url, RequestHeaders& request_headers)
+{
+    auto response = m_state.with_locked([&](State& state) -> Optional<Response> {
+        auto it = state.entries.find(cache_key(url));
+        if (it == state.entries.end() || !it->value.matches(request_headers) || !has_validator(it->value.response))
+            return {};
+
+        it->value.last_use = state.next_use++;
+        return it->value.response;
+    });
+    if (!response.has_value())
+        return {};
+
+    // https://httpwg.org/specs/rfc9111.html#validation.sent
+    if (auto etag = response_header(response->headers, "ETag"sv); etag.has_value())
+        request_headers.set("If-None-Match", etag.release_value());
+    if (auto last_modified = response_header(response->headers, "Last-Modified"sv); last_modified.has_value())
+        request_headers.set("If-Modified-Since", last_modified.release_value());
+
+    return response;
+}
+
+void HttpCache::invalidate(URL::URL const& url)
+{
+    m_state.with_locked([&](State& state) {
+        if (auto entry = state.entries.take(cache_key(url)); entry.has_value())
+            state.size_in_bytes -= entry->size_in_bytes;
+    });
+}
+
+void HttpCache::store(URL::URL const& url, RequestHeaders const& request_headers, UnixDateTime request_time, Response response)
+{
+    auto response_time = UnixDateTime::now();
+    auto lifetime = freshness_lifetime(response, response_time);
+    if (!is_storable(response, request_headers, lifetime))
+        return;
+
+    Entry entry;
+
+    if (auto vary = response_header(response.headers, "Vary"sv); vary.has_value()) {
+        for (auto name : vary->split_view(',')) {
+            auto lowercase_name = name.trim_whitespace().to_lowercase_string();
+            entry.selecting_request_headers.set(lowercase_name, request_header(request_headers, lowercase_name).value_or({}));
+        }
+    }
+
+    // https://httpwg.org/specs/rfc9111.html#age.calculations
+    auto date = parse_http_date(response_header(response.headers, "Date"sv)).value_or(response_time);
+    auto age_value = AK::Duration::from_seconds(response_header(response.headers, "Age"sv).value_or({}).to_number<i64>().value_or(0));
+    auto apparent_age = max(response_time - date, AK::Duration::zero());
+    auto response_delay = response_time - request_time;
+    entry.corrected_initial_age = max(apparent_age, age_value + response_delay);
+
+    entry.response_time = response_time;
+    entry.freshness_lifetime = lifetime;
+    entry.requires_revalidation = cache_control_directive(response_header(response.headers, "Cache-Control"sv), "no-cache"sv).has_value();
+
+    entry.size_in_bytes = response.body.size();
+    for (auto const& [name, value] : response.headers)
+        entry.size_in_bytes += name.length() + value.length();
+    if (entry.size_in_bytes > maximum_size_of_entry_in_bytes)
+        return;
+
+    entry.response = move(response);
+
+    m_state.with_locked([&](State& state) {
+        entry.last_use = state.next_use++;
+
+        auto key = cache_key(url);
+        if (auto previous_entry = state.entries.take(key); previous_entry.has_value())
+            state.size_in_bytes -= previous_entry->size_in_bytes;
+
+        state.size_in_bytes += entry.size_in_bytes;
+        state.entries.set(move(key), move(entry));
+        evict_entries_over_budget(state);
+    });
+}
+
+void HttpCache::evict_entries_over_budget(State& state)
+{
+    while (state.size_in_bytes > maximum_size_of_cache_in_bytes) {
+        auto least_recently_used = state.entries.begin();
+        for (auto it = state.entries.begin(); it != state.entries.end(); ++it) {
+            if (it->value.last_use < least_recently_used->value.last_use)
+                least_recently_used = it;
+        }
+
+        state.size_in_bytes -= least_recently_used->value.size_in_bytes;
+        state.entries.remove(least_recently_used);
+    }
+}
+
+HttpCache::Recorder::Recorder(Stream& output_stream, URL::URL url, RequestHeaders request_headers, Optional<Response> response_being_revalidated)
+    : m_output_stream(output_stream)
+    , m_url(move(url))
+    , m_request_headers(move(request_headers))
+    , m_request_time(UnixDateTime::now())
+    , m_response_being_revalidated(move(response_being_revalidated))
+{
+}
+
+ErrorOr<Bytes> HttpCache::Recorder::read_some(Bytes)
+{
+    return Error::from_errno(EBADF);
+}
+
+ErrorOr<size_t> HttpCache::Recorder::write_some(ReadonlyBytes bytes)
+{
+    auto written = TRY(m_output_stream.write_some(bytes));
+    if (m_body_is_too_large)
+        return written;
+
+    if (m_body.size() + written > maximum_size_of_entry_in_bytes || m_body.try_append(bytes.trim(written)).is_error()) {
+        m_body_is_too_large = true;
+        m_body.clear();
+    }
+    return written;
+}
+
+// https://httpwg.org/specs/rfc9111.html#freshening.responses
+Optional<HttpCache::Response> HttpCache::Recorder::freshen_response_being_revalidated(ResponseHeaders const& not_modified_headers) const
+{
+    if (!m_response_being_revalidated.has_value())
+        return {};
+
+    auto response = *m_response_being_revalidated;
+    response.headers.remove("Age"sv);
+    for (auto const& [name, value] : not_modified_headers) {
+        // The 304 response describes the stored response, except for its own length.
+        if (name.equals_ignoring_ascii_case("Content-Length"sv))
+            continue;
+        response.headers.set(name, value);
+    }
+    return response;
+}
+
+void HttpCache::Recorder::did_revalidate(Response response)
+{
+    HttpCache::the().store(m_url, m_request_headers, m_request_time, move(response));
+}
+
+void HttpCache::Recorder::did_finish(u32 status_code, ResponseHeaders const& headers)
+{
+    if (m_body_is_too_large)
+        return;
+    HttpCache::the().store(m_url, m_request_headers, m_request_time, Response { status_code, headers, move(m_body) });
+}
+
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/ByteString.h>
+#include <AK/HashMap.h>
+#include <AK/Optional.h>
+#include <AK/Stream.h>
+#include <AK/Time.h>
+#include <LibThreading/MutexProtected.h>
+#include <LibURL/URL.h>
+
+namespace RequestServer {
+
+// A private HTTP cache (RFC 9111) that lives in memory, shared by all clients of this RequestServer.
+//
+// Only responses to GET requests are stored. A fresh response is sent to the client without going to the network at
+// all, while a stale one is revalidated with a conditional request if it has a validator.
+class HttpCache {
+public:
+    using RequestHeaders = HashMap<ByteString, ByteString>;
+    using ResponseHeaders = HashMap<ByteString, ByteString, CaseInsensitiveStringTraits>;
+
+    struct Response {
+        u32 status_code { 0 };
+        ResponseHeaders headers;
+        ByteBuffer body;
+    };
+
+    // Passes everything the network request writes on to the client, and keeps a copy of it for the cache.
+    class Recorder final : public Stream {
+    public:
+        Recorder(Stream& output_stream, URL::URL url, RequestHeaders request_headers, Optional<Response> response_being_revalidated);
+
+        virtual ErrorOr<Bytes> read_some(Bytes) override;
+        virtual ErrorOr<size_t> write_some(ReadonlyBytes) override;
+        virtual bool is_eof() const override { return m_output_stream.is_eof(); }
+        virtual bool is_open() const override { return m_output_stream.is_open(); }
+        virtual void close() override { m_output_stream.close(); }
+
+        // Returns the stored response to send in place of a 304 (Not Modified) response, with its headers updated.
+        Optional<Response> freshen_response_being_revalidated(ResponseHeaders const& not_modified_headers) const;
+
+        void did_revalidate(Response);
+        void did_finish(u32 status_code, ResponseHeaders const&);
+
+    private:
+        Stream& m_output_stream;
+
+        URL::URL m_url;
+        RequestHeaders m_request_headers;
+        UnixDateTime m_request_time;
+        Optional<Response> m_response_being_revalidated;
+
+        ByteBuffer m_body;
+        bool m_body_is_too_large { false };
+    };
+
+    static HttpCache& the();
+
+    static bool can_use_cache_for(ByteString const& method, URL::URL const&, RequestHeaders const&);
+    static bool is_safe_method(ByteString const& method);
+
+    Optional<Response> fresh_response_for(URL::URL const&, RequestHeaders const&);
+
+    // Returns a stored response that is no longer fresh but can be revalidated, and adds the conditional headers to do
+    // so to the request headers.
+    Optional<Response> stale_response_for(URL::URL const&, RequestHeaders&);
+
+    void invalidate(URL::URL const&);
+
+private:
+    struct Entry {
+        Response response;
+
+        // The values of the request headers named by the response's Vary header field, by lowercase name.
+        HashMap<ByteString, ByteString> selecting_request_headers;
+
+        UnixDateTime response_time;
+        AK::Duration corrected_initial_age;
+        AK::Duration freshness_lifetime;
+        bool requires_revalidation { false };
+
+        u64 last_use { 0 };
+        size_t size_in_bytes { 0 };
+
+        AK::Duration current_age(UnixDateTime now) const;
+        bool is_fresh(UnixDateTime now) const;
+        bool matches(RequestHeaders const&) const;
+    };
+
+    struct State {
+        HashMap<ByteString, Entry> entries;
+        size_t size_in_bytes { 0 };
+        u64 next_use { 0 };
+    };
+
+    void store(URL::URL const&, RequestHeaders const&, UnixDateTime request_time, Response);
+    void evict_entries_over_budget(State&);
+
+    Threading::MutexProtected<State> m_state;
+};
+
+}
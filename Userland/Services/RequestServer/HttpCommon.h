@@ -16,6 +16,7 @@
 #include <LibHTTP/HttpRequest.h>
 #include <RequestServer/ConnectionCache.h>
 #include <RequestServer/ConnectionFromClient.h>
+#include <RequestServer/HttpCache.h>
 #include <RequestServer/Request.h>
 
 namespace RequestServer::Detail {
@@ -90,7 +91,17 @@ OwnPtr<Request> start_request(TBadgedProtocol&& protocol, i32 request_id, Connec
     else
         request.set_method(HTTP::HttpRequest::Method::GET);
     request.set_url(url);
-    request.set_headers(headers);
+
+    // NOTE: If the cache has a stale response for this request, the request is turned into a conditional one, so the
+    //       stored response can be reused if it turns out to be unchanged.
+    auto request_headers = headers;
+    Optional<HttpCache::Response> response_being_revalidated;
+    bool const can_use_cache = HttpCache::can_use_cache_for(method, url, headers);
+    if (can_use_cache)
+        response_being_revalidated = HttpCache::the().stale_response_for(url, request_headers);
+    else if (!HttpCache::is_safe_method(method))
+        HttpCache::the().invalidate(url);
+    request.set_headers(request_headers);
 
     auto allocated_body_result = ByteBuffer::copy(body);
     if (allocated_body_result.is_error())
@@ -98,9 +109,16 @@ OwnPtr<Request> start_request(TBadgedProtocol&& protocol, i32 request_id, Connec
     request.set_body(allocated_body_result.release_value());
 
     auto output_stream = MUST(Core::File::adopt_fd(pipe_result.value().write_fd, Core::File::OpenMode::Write));
-    auto job = TJob::construct(move(request), *output_stream);
+
+    OwnPtr<HttpCache::Recorder> cache_recorder;
+    if (can_use_cache)
+        cache_recorder = make<HttpCache::Recorder>(*output_stream, url, headers, move(response_being_revalidated));
+
+    auto job = TJob::construct(move(request), cache_recorder ? static_cast<Stream&>(*cache_recorder) : *output_stream);
     auto protocol_request = TRequest::create_with_job(forward<TBadgedProtocol>(protocol), client, (TJob&)*job, move(output_stream), request_id);
     protocol_request->set_request_fd(pipe_result.value().read_fd);
+    if (cache_recorder)
+        protocol_request->set_cache_recorder(cache_recorder.release_nonnull());
 
     Core::deferred_invoke([=] {
         if constexpr (IsSame<typename TBadgedProtocol::Type, HttpsProtocol>)
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibCore/File.h>
 #include <RequestServer/ConnectionFromClient.h>
 #include <RequestServer/Request.h>
 
@@ -24,6 +25,15 @@ void Request::stop()
 void Request::set_response_headers(HashMap<ByteString, ByteString, CaseInsensitiveStringTraits> const& response_headers)
 {
     m_response_headers = response_headers;
+
+    if (m_cache_recorder && m_status_code == 304) {
+        m_revalidated_response = m_cache_recorder->freshen_response_being_revalidated(response_headers);
+        if (m_revalidated_response.has_value()) {
+            m_status_code = m_revalidated_response->status_code;
+            m_response_headers = m_revalidated_response->headers;
+        }
+    }
+
     m_client.did_receive_headers({}, *this);
 }
 
@@ -31,8 +41,31 @@ void Request::set_certificate(ByteString, ByteString)
 {
 }
 
+static ErrorOr<void> write_body(Core::File& output_stream, ReadonlyBytes body)
+{
+    TRY(output_stream.set_blocking(true));
+    return output_stream.write_until_depleted(body);
+}
+
 void Request::did_finish(bool success)
 {
+    if (success && m_cache_recorder) {
+        if (m_revalidated_response.has_value()) {
+            // NOTE: The 304 response didn't have a body, so nothing else is going to write to the stream anymore.
+            auto const& body = m_revalidated_response->body;
+            if (auto result = write_body(*m_output_stream, body); result.is_error()) {
+                dbgln("Request: Failed to send the revalidated response for {}: {}", url(), result.error());
+                m_client.did_finish_request({}, *this, false);
+                return;
+            }
+            set_downloaded_size(body.size());
+            did_progress(body.size(), body.size());
+            m_cache_recorder->did_revalidate(m_revalidated_response.release_value());
+        } else if (m_status_code.has_value()) {
+            m_cache_recorder->did_finish(*m_status_code, m_response_headers);
+        }
+    }
+
     m_client.did_finish_request({}, *this, success);
 }
 
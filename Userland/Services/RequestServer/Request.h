@@ -12,6 +12,7 @@
 #include <AK/RefCounted.h>
 #include <LibURL/URL.h>
 #include <RequestServer/Forward.h>
+#include <RequestServer/HttpCache.h>
 
 namespace RequestServer {
 
@@ -42,6 +43,8 @@ public:
     void set_downloaded_size(size_t size) { m_downloaded_size = size; }
     Core::File const& output_stream() const { return *m_output_stream; }
 
+    void set_cache_recorder(NonnullOwnPtr<HttpCache::Recorder> recorder) { m_cache_recorder = move(recorder); }
+
 protected:
     explicit Request(ConnectionFromClient&, NonnullOwnPtr<Core::File>&&, i32 request_id);
 
@@ -54,6 +57,11 @@ private:
     size_t m_downloaded_size { 0 };
     NonnullOwnPtr<Core::File> m_output_stream;
     HashMap<ByteString, ByteString, CaseInsensitiveStringTraits> m_response_headers;
+
+    OwnPtr<HttpCache::Recorder> m_cache_recorder;
+
+    // The stored response that is sent in place of a 304 (Not Modified) response.
+    Optional<HttpCache::Response> m_revalidated_response;
 };
 
 }
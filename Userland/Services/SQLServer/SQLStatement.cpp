@@ -15,6 +15,17 @@ namespace SQLServer {
 static HashMap<SQL::StatementID, NonnullRefPtr<SQLStatement>> s_statements;
 static SQL::StatementID s_next_statement_id = 0;
 
+struct PendingCommit {
+    NonnullRefPtr<SQLStatement> statement;
+    SQL::ResultSet result;
+    SQL::ExecutionID execution_id { 0 };
+};
+
+// Statements executed outside of a transaction are not committed one by one. Instead, all statements executed
+// against a database during one iteration of the event loop share a single commit, and their results are only
+// sent to the clients once that commit has succeeded.
+static HashMap<SQL::Database const*, Vector<PendingCommit>> s_pending_commits;
+
 RefPtr<SQLStatement> SQLStatement::statement_for(SQL::StatementID statement_id)
 {
     if (s_statements.contains(statement_id))
@@ -70,42 +81,80 @@ Optional<SQL::ExecutionID> SQLStatement::execute(Vector<SQL::Value> placeholder_
     auto execution_id = m_next_execution_id++;
 
     Core::deferred_invoke([this, strong_this = NonnullRefPtr(*this), placeholder_values = move(placeholder_values), execution_id] {
-        auto execution_result = m_statement->execute(connection().database(), placeholder_values);
+        auto database = connection().database();
+
+        SQL::AST::ExecutionContext context { database, m_statement.ptr(), placeholder_values, nullptr };
+        auto execution_result = m_statement->execute(context);
 
         if (execution_result.is_error()) {
             report_error(execution_result.release_error(), execution_id);
             return;
         }
 
-        auto client_connection = ConnectionFromClient::client_connection_for(connection().client_id());
-        if (!client_connection) {
-            warnln("Cannot return statement execution results. Client disconnected");
+        if (database->is_in_transaction()) {
+            send_execution_success(execution_result.release_value(), execution_id);
             return;
         }
 
-        auto result = execution_result.release_value();
-        auto result_size = result.size();
-
-        if (should_send_result_rows(result)) {
-            client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), true, 0, 0, 0);
-
-            m_ongoing_executions.set(execution_id, { move(result), result_size });
-            ready_for_next_result(execution_id);
-        } else {
-            if (result.command() == SQL::SQLCommand::Insert)
-                client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, result_size, 0, 0);
-            else if (result.command() == SQL::SQLCommand::Update)
-                client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, 0, result_size, 0);
-            else if (result.command() == SQL::SQLCommand::Delete)
-                client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, 0, 0, result_size);
-            else
-                client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, 0, 0, 0);
-        }
+        schedule_commit(move(database), move(strong_this), execution_result.release_value(), execution_id);
     });
 
     return execution_id;
 }
 
+void SQLStatement::schedule_commit(NonnullRefPtr<SQL::Database> database, NonnullRefPtr<SQLStatement> statement, SQL::ResultSet result, SQL::ExecutionID execution_id)
+{
+    auto& pending_commits = s_pending_commits.ensure(database.ptr());
+    auto is_first_pending_commit = pending_commits.is_empty();
+
+    pending_commits.append({ move(statement), move(result), execution_id });
+    if (!is_first_pending_commit)
+        return;
+
+    Core::deferred_invoke([database = move(database)] {
+        auto pending_commits = s_pending_commits.take(database.ptr()).release_value();
+        dbgln_if(SQLSERVER_DEBUG, "Committing {} statement execution(s)", pending_commits.size());
+
+        if (auto result = database->commit(); result.is_error()) {
+            SQL::Result error { result.release_error() };
+
+            for (auto& pending_commit : pending_commits)
+                pending_commit.statement->report_error(error, pending_commit.execution_id);
+            return;
+        }
+
+        for (auto& pending_commit : pending_commits)
+            pending_commit.statement->send_execution_success(move(pending_commit.result), pending_commit.execution_id);
+    });
+}
+
+void SQLStatement::send_execution_success(SQL::ResultSet result, SQL::ExecutionID execution_id)
+{
+    auto client_connection = ConnectionFromClient::client_connection_for(connection().client_id());
+    if (!client_connection) {
+        warnln("Cannot return statement execution results. Client disconnected");
+        return;
+    }
+
+    auto result_size = result.size();
+
+    if (should_send_result_rows(result)) {
+        client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), true, 0, 0, 0);
+
+        m_ongoing_executions.set(execution_id, { move(result), result_size });
+        ready_for_next_result(execution_id);
+    } else {
+        if (result.command() == SQL::SQLCommand::Insert)
+            client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, result_size, 0, 0);
+        else if (result.command() == SQL::SQLCommand::Update)
+            client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, 0, result_size, 0);
+        else if (result.command() == SQL::SQLCommand::Delete)
+            client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, 0, 0, result_size);
+        else
+            client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, 0, 0, 0);
+    }
+}
+
 void SQLStatement::ready_for_next_result(SQL::ExecutionID execution_id)
 {
     auto client_connection = ConnectionFromClient::client_connection_for(connection().client_id());
@@ -119,14 +168,21 @@ void SQLStatement::ready_for_next_result(SQL::ExecutionID execution_id)
         return;
     }
 
-    if (execution->result.is_empty()) {
+    if (execution->next_row_index == execution->result.size()) {
         client_connection->async_results_exhausted(statement_id(), execution_id, execution->result_size);
         m_ongoing_executions.remove(execution_id);
         return;
     }
 
-    auto result_row = execution->result.take_first();
-    client_connection->async_next_result(statement_id(), execution_id, result_row.row.take_data());
+    auto batch_size = min(result_batch_size, execution->result.size() - execution->next_row_index);
+
+    Vector<Vector<SQL::Value>> rows;
+    rows.ensure_capacity(batch_size);
+
+    for (size_t i = 0; i < batch_size; ++i)
+        rows.unchecked_append(execution->result[execution->next_row_index++].row.take_data());
+
+    client_connection->async_next_results(statement_id(), execution_id, move(rows));
 }
 
 bool SQLStatement::should_send_result_rows(SQL::ResultSet const& result) const
@@ -136,6 +192,7 @@ bool SQLStatement::should_send_result_rows(SQL::ResultSet const& result) const
 
     switch (result.command()) {
     case SQL::SQLCommand::Describe:
+    case SQL::SQLCommand::Explain:
     case SQL::SQLCommand::Select:
         return true;
     default:
@@ -32,14 +32,22 @@ private:
     SQLStatement(DatabaseConnection&, NonnullRefPtr<SQL::AST::Statement> statement);
 
     bool should_send_result_rows(SQL::ResultSet const& result) const;
+    void send_execution_success(SQL::ResultSet, SQL::ExecutionID execution_id);
     void report_error(SQL::Result, SQL::ExecutionID execution_id);
 
+    static void schedule_commit(NonnullRefPtr<SQL::Database>, NonnullRefPtr<SQLStatement>, SQL::ResultSet, SQL::ExecutionID);
+
     DatabaseConnection& m_connection;
     SQL::StatementID m_statement_id { 0 };
 
+    // The number of result rows sent to the client in a single next_results message. The client acknowledges every
+    // batch with ready_for_next_result before the next one is sent, so at most one batch per execution is in flight.
+    static constexpr size_t result_batch_size = 64;
+
     struct Execution {
         SQL::ResultSet result;
         size_t result_size { 0 };
+        size_t next_row_index { 0 };
     };
     HashMap<SQL::ExecutionID, Execution> m_ongoing_executions;
     SQL::ExecutionID m_next_execution_id { 0 };
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "BootTrace.h"
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/Time.h>
+#include <LibCore/File.h>
+
+namespace BootTrace {
+
+static Optional<ByteString> s_output_path;
+static JsonArray s_events;
+
+void enable(ByteString output_path)
+{
+    s_output_path = move(output_path);
+}
+
+bool is_enabled()
+{
+    return s_output_path.has_value();
+}
+
+static ErrorOr<void> write_events()
+{
+    auto file = TRY(Core::File::open(*s_output_path, Core::File::OpenMode::Write | Core::File::OpenMode::Truncate));
+    auto serialized_events = s_events.to_byte_string();
+    TRY(file->write_until_depleted(serialized_events.bytes()));
+    return {};
+}
+
+void record(StringView service_name, StringView event, pid_t pid, Optional<i64> duration_in_microseconds)
+{
+    if (!is_enabled())
+        return;
+
+    JsonObject object;
+    object.set("timestamp", MonotonicTime::now().nanoseconds() / 1000);
+    object.set("service", service_name);
+    object.set("event", event);
+    if (pid >= 0)
+        object.set("pid", pid);
+    if (duration_in_microseconds.has_value())
+        object.set("duration", *duration_in_microseconds);
+    s_events.must_append(move(object));
+
+    if (auto result = write_events(); result.is_error())
+        dbgln("Failed to write boot trace to {}: {}", *s_output_path, result.error());
+}
+
+}
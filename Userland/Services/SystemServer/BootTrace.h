@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteString.h>
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <sys/types.h>
+
+// The boot trace is a JSON timeline of what SystemServer did with its services, and when. It is only recorded
+// if SystemServer was asked to (see --boot-trace), and is rewritten after every event so it stays useful no
+// matter when it's looked at.
+namespace BootTrace {
+
+void enable(ByteString output_path);
+bool is_enabled();
+
+// Timestamps are taken from the monotonic clock, i.e. they are relative to the kernel having booted.
+void record(StringView service_name, StringView event, pid_t pid = -1, Optional<i64> duration_in_microseconds = {});
+
+}
@@ -5,6 +5,7 @@
  */
 
 #include "Service.h"
+#include "BootTrace.h"
 #include <AK/Debug.h>
 #include <AK/HashMap.h>
 #include <AK/JsonArray.h>
@@ -94,6 +95,7 @@ ErrorOr<void> Service::handle_socket_connection()
 {
     VERIFY(m_sockets.size() == 1);
     dbgln_if(SERVICE_DEBUG, "Ready to read on behalf of {}", name());
+    BootTrace::record(name(), "socket-activation"sv);
 
     int socket_fd = m_sockets[0].fd;
 
@@ -101,7 +103,8 @@ ErrorOr<void> Service::handle_socket_connection()
         auto const accepted_fd = TRY(Core::System::accept(socket_fd, nullptr, nullptr));
 
         TRY(determine_account(accepted_fd));
-        TRY(spawn(accepted_fd));
+        if (!TRY(hand_over_to_prespawned_instance(accepted_fd)))
+            TRY(spawn(accepted_fd));
         TRY(Core::System::close(accepted_fd));
     } else {
         remove_child(*m_socket_notifier);
@@ -119,9 +122,63 @@ ErrorOr<void> Service::activate()
         setup_notifier();
     else
         TRY(spawn());
+
+    if (m_prespawn)
+        TRY(prespawn());
+    return {};
+}
+
+ErrorOr<void> Service::prespawn()
+{
+    VERIFY(m_prespawn);
+    VERIFY(!m_prespawned_instance.has_value());
+
+    int takeover_fds[2];
+    TRY(Core::System::socketpair(AF_LOCAL, SOCK_STREAM | SOCK_CLOEXEC, 0, takeover_fds));
+
+    // We can't know who is going to connect yet, so the instance runs as the same user as we do.
+    auto uid = getuid();
+    m_account = TRY(Core::Account::from_uid(uid, Core::Account::Read::PasswdOnly));
+
+    auto result = spawn(takeover_fds[1], SocketTakeover::Deferred);
+    TRY(Core::System::close(takeover_fds[1]));
+
+    if (result.is_error()) {
+        TRY(Core::System::close(takeover_fds[0]));
+        return result.release_error();
+    }
+
+    m_prespawned_instance = PrespawnedInstance { takeover_fds[0], uid };
     return {};
 }
 
+ErrorOr<bool> Service::hand_over_to_prespawned_instance(int accepted_fd)
+{
+    if (!m_prespawned_instance.has_value() || m_prespawned_instance->uid != m_account->uid())
+        return false;
+
+    auto takeover_fd = m_prespawned_instance.release_value().takeover_fd;
+
+    // The instance waits for the byte that follows the socket. If it has died in the meantime, sending will fail.
+    auto result = [&]() -> ErrorOr<void> {
+        TRY(Core::System::sendfd(takeover_fd, accepted_fd));
+
+        u8 const wake_up = 0;
+        TRY(Core::System::send(takeover_fd, &wake_up, sizeof(wake_up), MSG_NOSIGNAL));
+        return {};
+    }();
+
+    TRY(Core::System::close(takeover_fd));
+    if (result.is_error())
+        dbgln("{}: Failed to hand connection over to prespawned instance: {}", name(), result.error());
+
+    // Get an instance ready for the next connection.
+    if (auto prespawn_result = prespawn(); prespawn_result.is_error())
+        dbgln("{}: Failed to prespawn instance: {}", name(), prespawn_result.error());
+
+    return !result.is_error();
+}
+
 ErrorOr<void> Service::change_privileges()
 {
     // NOTE: Dropping privileges makes sense when SystemServer is running
@@ -143,7 +200,7 @@ ErrorOr<void> Service::change_privileges()
     return {};
 }
 
-ErrorOr<void> Service::spawn(int socket_fd)
+ErrorOr<void> Service::spawn(int socket_fd, SocketTakeover socket_takeover)
 {
     if (!FileSystem::exists(m_executable_path)) {
         dbgln("{}: binary \"{}\" does not exist, skipping service.", name(), m_executable_path);
@@ -218,6 +275,9 @@ ErrorOr<void> Service::spawn(int socket_fd)
         if (!m_sockets.is_empty()) {
             // The new descriptor is !CLOEXEC here.
             TRY(Core::Environment::set("SOCKET_TAKEOVER"sv, socket_takeover_builder.string_view(), Core::Environment::Overwrite::Yes));
+
+            if (socket_takeover == SocketTakeover::Deferred)
+                TRY(Core::Environment::set("SOCKET_TAKEOVER_DEFERRED"sv, "1"sv, Core::Environment::Overwrite::Yes));
         }
 
         TRY(change_privileges());
@@ -233,10 +293,13 @@ ErrorOr<void> Service::spawn(int socket_fd)
         }));
 
         TRY(Core::System::exec(m_executable_path, arguments, Core::System::SearchInPath::No));
-    } else if (!m_multi_instance) {
+    } else {
         // We are the parent.
-        m_pid = pid;
-        s_service_map.set(pid, this);
+        BootTrace::record(name(), "spawn"sv, pid, m_run_timer.elapsed_time().to_microseconds());
+        if (!m_multi_instance) {
+            m_pid = pid;
+            s_service_map.set(pid, this);
+        }
     }
 
     return {};
@@ -254,13 +317,15 @@ ErrorOr<void> Service::did_exit(int status)
     if (WIFSIGNALED(status))
         dbgln("Service {} terminated due to signal {}", name(), WTERMSIG(status));
 
+    auto run_time = m_run_timer.elapsed_time();
+    BootTrace::record(name(), "exit"sv, m_pid, run_time.to_microseconds());
+
     s_service_map.remove(m_pid);
     m_pid = -1;
 
     if (!m_keep_alive)
         return {};
 
-    auto run_time = m_run_timer.elapsed_time();
     bool exited_successfully = WIFEXITED(status) && WEXITSTATUS(status) == 0;
 
     if (!exited_successfully && run_time < 1_sec) {
@@ -321,6 +386,7 @@ Service::Service(Core::ConfigFile const& config, StringView name)
     m_system_modes = config.read_entry(name, "SystemModes", "graphical").split(',');
     m_multi_instance = config.read_bool_entry(name, "MultiInstance");
     m_accept_socket_connections = config.read_bool_entry(name, "AcceptSocketConnections");
+    m_prespawn = config.read_bool_entry(name, "Prespawn");
 
     ByteString socket_entry = config.read_entry(name, "Socket");
     ByteString socket_permissions_entry = config.read_entry(name, "SocketPermissions", "0600");
@@ -354,6 +420,8 @@ Service::Service(Core::ConfigFile const& config, StringView name)
     VERIFY(!m_lazy || m_sockets.size() == 1);
     // AcceptSocketConnections always requires Socket (single), Lazy, and MultiInstance.
     VERIFY(!m_accept_socket_connections || (m_sockets.size() == 1 && m_lazy && m_multi_instance));
+    // Prespawn requires AcceptSocketConnections.
+    VERIFY(!m_prespawn || m_accept_socket_connections);
     // MultiInstance doesn't work with KeepAlive.
     VERIFY(!m_multi_instance || !m_keep_alive);
 }
@@ -32,7 +32,13 @@ public:
 private:
     Service(Core::ConfigFile const&, StringView name);
 
-    ErrorOr<void> spawn(int socket_fd = -1);
+    enum class SocketTakeover {
+        Immediate,
+        Deferred,
+    };
+    ErrorOr<void> spawn(int socket_fd = -1, SocketTakeover = SocketTakeover::Immediate);
+    ErrorOr<void> prespawn();
+    ErrorOr<bool> hand_over_to_prespawned_instance(int accepted_fd);
 
     ErrorOr<void> determine_account(int fd);
 
@@ -64,6 +70,9 @@ private:
     bool m_accept_socket_connections { false };
     // Whether we should only spawn this service once somebody connects to the socket.
     bool m_lazy;
+    // Whether we should keep an instance spawned ahead of time, which is handed the next accepted connection. This
+    // requires AcceptSocketConnections.
+    bool m_prespawn { false };
     // The name of the user we should run this service as.
     Optional<ByteString> m_user;
     // The working directory in which to spawn the service.
@@ -77,6 +86,14 @@ private:
     // Socket descriptors for this service.
     Vector<SocketDescriptor> m_sockets;
 
+    struct PrespawnedInstance {
+        // Our end of the socket over which the instance receives its accepted connection.
+        int takeover_fd { -1 };
+        // The user the instance runs as. Connections from other users get a regular instance.
+        uid_t uid { 0 };
+    };
+    Optional<PrespawnedInstance> m_prespawned_instance;
+
     // The resolved user account to run this service as.
     Optional<Core::Account> m_account;
     bool m_must_login { false };
@@ -6,6 +6,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include "BootTrace.h"
 #include "Service.h"
 #include <AK/Assertions.h>
 #include <AK/ByteBuffer.h>
@@ -218,11 +219,13 @@ static ErrorOr<void> activate_services(Core::ConfigFile const& config)
     }
     // After we've set them all up, activate them!
     dbgln("Activating {} services...", g_services.size());
+    auto activation_timer = Core::ElapsedTimer::start_new();
     for (auto& service : g_services) {
         dbgln_if(SYSTEMSERVER_DEBUG, "Activating {}", service->name());
         if (auto result = service->activate(); result.is_error())
             dbgln("{}: {}", service->name(), result.release_error());
     }
+    BootTrace::record("SystemServer"sv, "activated-services"sv, getpid(), activation_timer.elapsed_time().to_microseconds());
 
     return {};
 }
@@ -284,8 +287,10 @@ static ErrorOr<void> activate_user_services_based_on_system_mode()
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
     bool user = false;
+    StringView boot_trace_path;
     Core::ArgsParser args_parser;
     args_parser.add_option(user, "Run in user-mode", "user", 'u');
+    args_parser.add_option(boot_trace_path, "Write a JSON timeline of service startup to this file", "boot-trace", 't', "path");
     args_parser.parse(arguments);
 
     if (!user) {
@@ -294,7 +299,13 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         TRY(SystemServer::reopen_base_file_descriptors());
     }
 
-    TRY(Core::System::pledge("stdio proc exec tty accept unix rpath wpath cpath chown fattr id sigaction"));
+    // NOTE: The trace is only written once all the file systems are mounted, so it can't end up hidden below one of them.
+    if (!boot_trace_path.is_empty()) {
+        BootTrace::enable(boot_trace_path);
+        BootTrace::record("SystemServer"sv, "start"sv, getpid());
+    }
+
+    TRY(Core::System::pledge("stdio proc exec tty accept unix rpath wpath cpath chown fattr id sigaction sendfd"));
 
     if (!user) {
         TRY(SystemServer::create_tmp_coredump_directory());
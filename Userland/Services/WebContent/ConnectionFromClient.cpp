@@ -14,6 +14,7 @@
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/Font/FontDatabase.h>
 #include <LibGfx/SystemTheme.h>
+#include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Heap/Heap.h>
 #include <LibJS/Runtime/ConsoleObject.h>
 #include <LibWeb/ARIA/RoleType.h>
@@ -41,6 +42,7 @@
 #include <LibWeb/Painting/StackingContext.h>
 #include <LibWeb/Painting/ViewportPaintable.h>
 #include <LibWeb/PermissionsPolicy/AutoplayAllowlist.h>
+#include <LibWeb/PhaseTimer.h>
 #include <LibWeb/Platform/EventLoopPlugin.h>
 #include <LibWebView/Attribute.h>
 #include <WebContent/ConnectionFromClient.h>
@@ -361,6 +363,33 @@ void ConnectionFromClient::debug_request(u64 page_id, ByteString const& request,
         return;
     }
 
+    if (request == "sample-javascript-stacks") {
+        auto& vm = Web::Bindings::main_thread_vm();
+        if (argument == "on") {
+            vm.enable_sampling_profiler();
+        } else if (auto* sampling_profiler = vm.sampling_profiler()) {
+            sampling_profiler->dump_folded_stacks();
+            vm.disable_sampling_profiler();
+        }
+        return;
+    }
+
+    if (request == "collect-execution-statistics") {
+        auto& interpreter = Web::Bindings::main_thread_vm().bytecode_interpreter();
+        if (argument == "on") {
+            interpreter.set_collects_execution_statistics(true);
+        } else if (interpreter.collects_execution_statistics()) {
+            interpreter.dump_execution_statistics();
+            interpreter.set_collects_execution_statistics(false);
+        }
+        return;
+    }
+
+    if (request == "record-rendering-trace") {
+        Web::set_rendering_trace_enabled(argument == "on");
+        return;
+    }
+
     if (request == "set-line-box-borders") {
         bool state = argument == "on";
         page->set_should_show_line_box_borders(state);
@@ -814,6 +843,22 @@ Messages::WebContentServer::DumpGcGraphResponse ConnectionFromClient::dump_gc_gr
     return MUST(String::from_byte_string(gc_graph_json.to_byte_string()));
 }
 
+Messages::WebContentServer::TakePhaseTimingsResponse ConnectionFromClient::take_phase_timings(u64)
+{
+    JsonObject timings_json;
+    for (size_t i = 0; i < to_underlying(Web::Phase::__Count); ++i) {
+        auto phase = static_cast<Web::Phase>(i);
+        timings_json.set(Web::phase_name(phase), static_cast<double>(Web::phase_timings()[i].to_microseconds()) / 1000.0);
+    }
+    Web::reset_phase_timings();
+    return MUST(String::from_byte_string(timings_json.to_byte_string()));
+}
+
+Messages::WebContentServer::TakeRenderingTraceResponse ConnectionFromClient::take_rendering_trace(u64)
+{
+    return MUST(String::from_byte_string(Web::take_rendering_trace_json()));
+}
+
 Messages::WebContentServer::GetSelectedTextResponse ConnectionFromClient::get_selected_text(u64 page_id)
 {
     if (auto page = this->page(page_id); page.has_value())
@@ -123,6 +123,8 @@ private:
     virtual void take_dom_node_screenshot(u64 page_id, i32 node_id) override;
 
     virtual Messages::WebContentServer::DumpGcGraphResponse dump_gc_graph(u64 page_id) override;
+    virtual Messages::WebContentServer::TakePhaseTimingsResponse take_phase_timings(u64 page_id) override;
+    virtual Messages::WebContentServer::TakeRenderingTraceResponse take_rendering_trace(u64 page_id) override;
 
     virtual Messages::WebContentServer::GetLocalStorageEntriesResponse get_local_storage_entries(u64 page_id) override;
     virtual Messages::WebContentServer::GetSessionStorageEntriesResponse get_session_storage_entries(u64 page_id) override;
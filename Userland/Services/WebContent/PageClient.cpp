@@ -22,6 +22,7 @@
 #include <LibWeb/Painting/CommandExecutorCPU.h>
 #include <LibWeb/Painting/PaintableBox.h>
 #include <LibWeb/Painting/ViewportPaintable.h>
+#include <LibWeb/PhaseTimer.h>
 #include <LibWeb/Platform/Timer.h>
 #include <LibWebView/Attribute.h>
 #include <WebContent/ConnectionFromClient.h>
@@ -67,10 +68,11 @@ PageClient::PageClient(PageHost& owner, u64 id)
     if (s_use_gpu_painter) {
         auto context = AccelGfx::Context::create();
         if (context.is_error()) {
-            dbgln("Failed to create AccelGfx context: {}", context.error());
-            VERIFY_NOT_REACHED();
+            // Not every machine that asks for GPU painting can provide it, so this page is painted on the CPU instead.
+            dbgln("Failed to create AccelGfx context, falling back to CPU painting: {}", context.error());
+        } else {
+            m_accelerated_graphics_context = context.release_value();
         }
-        m_accelerated_graphics_context = context.release_value();
     }
 #endif
 }
@@ -203,7 +205,21 @@ void PageClient::paint_next_frame()
 
 void PageClient::paint(Web::DevicePixelRect const& content_rect, Gfx::Bitmap& target, Web::PaintOptions paint_options)
 {
+    Web::PhaseTimer phase_timer { Web::Phase::Paint };
+
     Web::Painting::CommandList painting_commands;
+    {
+        Web::TraceScope trace_scope { "record-painting-commands"sv };
+        record_painting_commands(painting_commands, content_rect, paint_options);
+    }
+    {
+        Web::TraceScope trace_scope { "execute-painting-commands"sv };
+        execute_painting_commands(painting_commands, target);
+    }
+}
+
+void PageClient::record_painting_commands(Web::Painting::CommandList& painting_commands, Web::DevicePixelRect const& content_rect, Web::PaintOptions paint_options)
+{
     Web::Painting::RecordingPainter recording_painter(painting_commands);
 
     Gfx::IntRect bitmap_rect { {}, content_rect.size().to_type<int>() };
@@ -214,23 +230,31 @@ void PageClient::paint(Web::DevicePixelRect const& content_rect, Gfx::Bitmap& ta
     paint_config.should_show_line_box_borders = m_should_show_line_box_borders;
     paint_config.has_focus = m_has_focus;
     page().top_level_traversable()->paint(recording_painter, paint_config);
+}
 
+// NOTE: This must not look at the page, only at the recorded commands, so that it doesn't matter what JS, style and
+//       layout do between recording a frame and rasterizing it.
+void PageClient::execute_painting_commands(Web::Painting::CommandList& painting_commands, Gfx::Bitmap& target)
+{
     if (s_use_gpu_painter) {
 #ifdef HAS_ACCELERATED_GRAPHICS
-        Web::Painting::CommandExecutorGPU painting_command_executor(*m_accelerated_graphics_context, target);
-        painting_commands.execute(painting_command_executor);
+        if (m_accelerated_graphics_context) {
+            Web::Painting::CommandExecutorGPU painting_command_executor(*m_accelerated_graphics_context, target);
+            painting_commands.execute(painting_command_executor);
+            return;
+        }
 #else
         static bool has_warned_about_configuration = false;
 
         if (!has_warned_about_configuration) {
-            warnln("\033[31;1mConfigured to use GPU painter, but current platform does not have accelerated graphics\033[0m");
+            warnln("\033[31;1mConfigured to use GPU painter, but current platform does not have accelerated graphics, falling back to CPU painter\033[0m");
             has_warned_about_configuration = true;
         }
 #endif
-    } else {
-        Web::Painting::CommandExecutorCPU painting_command_executor(target, s_use_experimental_cpu_transform_support);
-        painting_commands.execute(painting_command_executor);
     }
+
+    Web::Painting::CommandExecutorCPU painting_command_executor(target, s_use_experimental_cpu_transform_support);
+    painting_commands.execute(painting_command_executor);
 }
 
 void PageClient::set_viewport_rect(Web::DevicePixelRect const& rect)
@@ -85,6 +85,9 @@ public:
     virtual double device_pixels_per_css_pixel() const override { return m_device_pixels_per_css_pixel; }
 
 private:
+    void record_painting_commands(Web::Painting::CommandList&, Web::DevicePixelRect const& content_rect, Web::PaintOptions);
+    void execute_painting_commands(Web::Painting::CommandList&, Gfx::Bitmap& target);
+
     PageClient(PageHost&, u64 id);
 
     virtual void visit_edges(JS::Cell::Visitor&) override;
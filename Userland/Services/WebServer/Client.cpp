@@ -25,19 +25,88 @@
 #include <LibURL/URL.h>
 #include <WebServer/Client.h>
 #include <WebServer/Configuration.h>
+#include <WebServer/FileCache.h>
 #include <stdio.h>
 #include <unistd.h>
 
 namespace WebServer {
 
+static constexpr size_t maximum_request_size = 64 * KiB;
+static constexpr int idle_timeout_seconds = 15;
+
+static Optional<StringView> header_value(HTTP::HttpRequest const& request, StringView name)
+{
+    auto it = request.headers().find_if([&](auto& header) { return header.name.equals_ignoring_ascii_case(name); });
+    if (it.is_end())
+        return {};
+    return it->value.view().trim_whitespace();
+}
+
+// Returns the length of the first complete request in the buffer, including its body, if there is one.
+static Optional<size_t> find_complete_request_length(ReadonlyBytes input)
+{
+    StringView input_view { input };
+    auto end_of_headers = input_view.find("\r\n\r\n"sv);
+    if (!end_of_headers.has_value())
+        return {};
+
+    size_t content_length = 0;
+    for (auto line : input_view.substring_view(0, *end_of_headers).split_view("\r\n"sv)) {
+        auto colon = line.find(':');
+        if (!colon.has_value() || !line.substring_view(0, *colon).trim_whitespace().equals_ignoring_ascii_case("Content-Length"sv))
+            continue;
+        content_length = line.substring_view(*colon + 1).trim_whitespace().to_number<size_t>().value_or(0);
+    }
+
+    auto length = *end_of_headers + 4 + content_length;
+    if (length > input.size())
+        return {};
+    return length;
+}
+
+static bool should_keep_alive(HTTP::HttpRequest const& request, ReadonlyBytes raw_request)
+{
+    if (auto connection = header_value(request, "Connection"sv); connection.has_value()) {
+        if (connection->equals_ignoring_ascii_case("close"sv))
+            return false;
+        if (connection->equals_ignoring_ascii_case("keep-alive"sv))
+            return true;
+    }
+
+    // HTTP/1.1 connections are persistent unless the client asks otherwise, older ones aren't.
+    StringView raw_request_view { raw_request };
+    auto request_line = raw_request_view.substring_view(0, raw_request_view.find("\r\n"sv).value_or(raw_request_view.length()));
+    return request_line.ends_with("HTTP/1.1"sv);
+}
+
+static bool accepts_gzip(HTTP::HttpRequest const& request)
+{
+    auto accept_encoding = header_value(request, "Accept-Encoding"sv);
+    if (!accept_encoding.has_value())
+        return false;
+    for (auto coding : accept_encoding->split_view(',')) {
+        auto parts = coding.split_view(';');
+        if (parts.is_empty() || !parts[0].trim_whitespace().equals_ignoring_ascii_case("gzip"sv))
+            continue;
+        if (parts.size() > 1 && parts[1].trim_whitespace().is_one_of("q=0"sv, "q=0.0"sv, "q=0.00"sv, "q=0.000"sv))
+            return false;
+        return true;
+    }
+    return false;
+}
+
 Client::Client(NonnullOwnPtr<Core::BufferedTCPSocket> socket, Core::EventReceiver* parent)
     : Core::EventReceiver(parent)
     , m_socket(move(socket))
+    , m_idle_timer(Core::Timer::create_single_shot(idle_timeout_seconds * 1000, [this] { die(); }, this))
 {
 }
 
 void Client::die()
 {
+    if (!m_socket->is_open())
+        return;
+    m_idle_timer->stop();
     m_socket->close();
     deferred_invoke([this] { remove_from_parent(); });
 }
@@ -57,43 +126,52 @@ void Client::start()
             die();
         }
     };
+    m_idle_timer->start();
 }
 
 ErrorOr<void, Client::WrappedError> Client::on_ready_to_read()
 {
     // FIXME: Mostly copied from LibWeb/WebDriver/Client.cpp. As noted there, this should be move the LibHTTP and made spec compliant.
     auto buffer = TRY(ByteBuffer::create_uninitialized(m_socket->buffer_size()));
+    m_idle_timer->restart();
 
     for (;;) {
         if (!TRY(m_socket->can_read_without_blocking()))
             break;
 
         auto data = TRY(m_socket->read_some(buffer));
-        TRY(m_remaining_request.try_append(StringView { data }));
+        TRY(m_pending_input.try_append(data));
 
         if (m_socket->is_eof())
             break;
     }
+    auto peer_closed = m_socket->is_eof();
 
-    if (m_remaining_request.is_empty())
-        return {};
+    // Clients may pipeline several requests without waiting for our responses, so answer everything that arrived in order.
+    for (;;) {
+        auto request_length = find_complete_request_length(m_pending_input);
+        if (!request_length.has_value()) {
+            if (m_pending_input.size() > maximum_request_size)
+                return HTTP::HttpRequest::ParseError::RequestTooLarge;
+            break;
+        }
 
-    auto request = TRY(m_remaining_request.to_byte_buffer());
-    dbgln_if(WEBSERVER_DEBUG, "Got raw request: '{}'", ByteString::copy(request));
+        auto raw_request = m_pending_input.bytes().trim(*request_length);
+        dbgln_if(WEBSERVER_DEBUG, "Got raw request: '{}'", ByteString::copy(raw_request));
 
-    auto maybe_parsed_request = HTTP::HttpRequest::from_raw_request(TRY(m_remaining_request.to_byte_buffer()));
-    if (maybe_parsed_request.is_error()) {
-        if (maybe_parsed_request.error() == HTTP::HttpRequest::ParseError::RequestIncomplete) {
-            // If request is not complete we need to wait for more data to arrive
+        auto request = TRY(HTTP::HttpRequest::from_raw_request(raw_request));
+        m_keep_alive = should_keep_alive(request, raw_request);
+        TRY(handle_request(request));
+
+        m_pending_input = TRY(ByteBuffer::copy(m_pending_input.bytes().slice(*request_length)));
+        if (!m_keep_alive) {
+            die();
             return {};
         }
-        return maybe_parsed_request.error();
     }
 
-    m_remaining_request.clear();
-
-    TRY(handle_request(maybe_parsed_request.value()));
-
+    if (peer_closed)
+        die();
     return {};
 }
 
@@ -166,21 +244,111 @@ ErrorOr<bool> Client::handle_request(HTTP::HttpRequest const& request)
         return false;
     }
 
-    auto stream = TRY(Core::File::open(real_path.bytes_as_string_view(), Core::File::OpenMode::Read));
+    auto st = TRY(Core::System::stat(real_path.bytes_as_string_view()));
+    auto const size = static_cast<u64>(st.st_size);
+    auto mime_type = TRY(String::from_utf8(Core::guess_mime_type_based_on_filename(real_path.bytes_as_string_view())));
 
-    auto const info = ContentInfo {
-        .type = TRY(String::from_utf8(Core::guess_mime_type_based_on_filename(real_path.bytes_as_string_view()))),
-        .length = static_cast<u64>(TRY(FileSystem::size_from_stat(real_path.bytes_as_string_view())))
+    Optional<ByteRange> range;
+    if (auto range_header = header_value(request, "Range"sv); range_header.has_value()) {
+        bool is_satisfiable = true;
+        range = parse_range_header(*range_header, size, is_satisfiable);
+        if (!is_satisfiable) {
+            Vector<String> headers {};
+            TRY(headers.try_append(TRY(String::formatted("Content-Range: bytes */{}", size))));
+            TRY(send_error_response(416, request, move(headers)));
+            return false;
+        }
+    }
+
+    ContentInfo info {
+        .type = mime_type,
+        .length = range.has_value() ? range->end - range->start + 1 : size,
+        .varies_on_encoding = FileCache::is_compressible(mime_type),
+        .range = range,
+        .full_length = size,
     };
-    TRY(send_response(*stream, request, move(info)));
+
+    if (auto const* cached_file = TRY(FileCache::the().lookup(real_path, mime_type, size, st.st_mtime))) {
+        // Ranges always refer to the identity encoding, so only whole-file responses are compressed.
+        info.is_gzip_encoded = !range.has_value() && cached_file->gzip_contents.has_value() && accepts_gzip(request);
+        auto contents = info.is_gzip_encoded ? cached_file->gzip_contents->bytes() : cached_file->contents.bytes();
+        if (range.has_value())
+            contents = contents.slice(range->start, info.length);
+        info.length = contents.size();
+
+        FixedMemoryStream stream { contents };
+        TRY(send_response(stream, request, move(info)));
+        return true;
+    }
+
+    auto stream = TRY(Core::File::open(real_path.bytes_as_string_view(), Core::File::OpenMode::Read));
+    TRY(send_file_response(*stream, request, move(info)));
     return true;
 }
 
-ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& request, ContentInfo content_info)
+Optional<Client::ByteRange> Client::parse_range_header(StringView value, u64 size, bool& is_satisfiable)
 {
-    StringBuilder builder;
-    TRY(builder.try_append("HTTP/1.0 200 OK\r\n"sv));
+    is_satisfiable = true;
+
+    // Only a single range is supported; anything else is ignored and answered with the whole file, which is allowed.
+    if (!value.starts_with("bytes="sv) || value.contains(','))
+        return {};
+    auto spec = value.substring_view(6).trim_whitespace();
+    auto dash = spec.find('-');
+    if (!dash.has_value())
+        return {};
+    auto first = spec.substring_view(0, *dash).trim_whitespace();
+    auto last = spec.substring_view(*dash + 1).trim_whitespace();
+
+    if (first.is_empty()) {
+        // "-n" asks for the last n bytes.
+        auto suffix_length = last.to_number<u64>();
+        if (!suffix_length.has_value())
+            return {};
+        if (*suffix_length == 0 || size == 0) {
+            is_satisfiable = false;
+            return {};
+        }
+        return ByteRange { size - min(*suffix_length, size), size - 1 };
+    }
+
+    auto start = first.to_number<u64>();
+    if (!start.has_value())
+        return {};
+    auto end = size > 0 ? size - 1 : 0;
+    if (!last.is_empty()) {
+        auto requested_end = last.to_number<u64>();
+        if (!requested_end.has_value() || *requested_end < *start)
+            return {};
+        end = min(*requested_end, end);
+    }
+
+    if (*start >= size) {
+        is_satisfiable = false;
+        return {};
+    }
+    return ByteRange { *start, end };
+}
+
+ErrorOr<void> Client::append_status_line_and_common_headers(StringBuilder& builder, unsigned code)
+{
+    TRY(builder.try_appendff("HTTP/1.1 {} {}\r\n", code, HTTP::HttpResponse::reason_phrase_for_code(code)));
     TRY(builder.try_append("Server: WebServer (SerenityOS)\r\n"sv));
+    if (m_keep_alive) {
+        TRY(builder.try_append("Connection: keep-alive\r\n"sv));
+        TRY(builder.try_appendff("Keep-Alive: timeout={}\r\n", idle_timeout_seconds));
+    } else {
+        TRY(builder.try_append("Connection: close\r\n"sv));
+    }
+    return {};
+}
+
+ErrorOr<void> Client::send_response_header(HTTP::HttpRequest const& request, ContentInfo const& content_info)
+{
+    auto code = content_info.range.has_value() ? 206u : 200u;
+
+    StringBuilder builder;
+    TRY(append_status_line_and_common_headers(builder, code));
     TRY(builder.try_append("X-Frame-Options: SAMEORIGIN\r\n"sv));
     TRY(builder.try_append("X-Content-Type-Options: nosniff\r\n"sv));
     TRY(builder.try_append("Pragma: no-cache\r\n"sv));
@@ -188,18 +356,34 @@ ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& r
         TRY(builder.try_appendff("Content-Type: {}; charset=utf-8\r\n", content_info.type));
     else
         TRY(builder.try_appendff("Content-Type: {}\r\n", content_info.type));
+    if (content_info.is_gzip_encoded)
+        TRY(builder.try_append("Content-Encoding: gzip\r\n"sv));
+    if (content_info.varies_on_encoding)
+        TRY(builder.try_append("Vary: Accept-Encoding\r\n"sv));
+    TRY(builder.try_append("Accept-Ranges: bytes\r\n"sv));
+    if (content_info.range.has_value())
+        TRY(builder.try_appendff("Content-Range: bytes {}-{}/{}\r\n", content_info.range->start, content_info.range->end, content_info.full_length));
     TRY(builder.try_appendff("Content-Length: {}\r\n", content_info.length));
     TRY(builder.try_append("\r\n"sv));
 
     auto builder_contents = TRY(builder.to_byte_buffer());
     TRY(m_socket->write_until_depleted(builder_contents));
-    log_response(200, request);
+    log_response(code, request);
+    return {};
+}
 
+ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& request, ContentInfo content_info)
+{
+    TRY(send_response_header(request, content_info));
+
+    // The connection may carry further responses, so send exactly as many bytes as we announced.
     char buffer[PAGE_SIZE];
-    do {
-        auto size = TRY(response.read_some({ buffer, sizeof(buffer) })).size();
-        if (response.is_eof() && size == 0)
-            break;
+    auto remaining = content_info.length;
+    while (remaining > 0) {
+        auto size = TRY(response.read_some({ buffer, min<u64>(sizeof(buffer), remaining) })).size();
+        if (size == 0)
+            return Error::from_string_literal("Response ended before its announced length");
+        remaining -= size;
 
         ReadonlyBytes write_buffer { buffer, size };
         while (!write_buffer.is_empty()) {
@@ -211,26 +395,46 @@ ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& r
 
             write_buffer = write_buffer.slice(nwritten);
         }
-    } while (true);
+    }
 
-    auto keep_alive = false;
-    if (auto it = request.headers().find_if([](auto& header) { return header.name.equals_ignoring_ascii_case("Connection"sv); }); !it.is_end()) {
-        if (it->value.trim_whitespace().equals_ignoring_ascii_case("keep-alive"sv))
-            keep_alive = true;
+    return {};
+}
+
+ErrorOr<void> Client::send_file_response(Core::File& file, HTTP::HttpRequest const& request, ContentInfo content_info)
+{
+#ifdef AK_OS_SERENITY
+    // Let the kernel move the file's contents into the socket, instead of copying every chunk through our buffer.
+    auto socket_fd = m_socket->underlying_socket().fd();
+    if (!socket_fd.has_value())
+        return Error::from_errno(ENOTCONN);
+
+    TRY(send_response_header(request, content_info));
+
+    off_t offset = content_info.range.has_value() ? content_info.range->start : 0;
+    auto remaining = content_info.length;
+    while (remaining > 0) {
+        auto nsent = TRY(Core::System::sendfile(*socket_fd, file.fd(), &offset, remaining));
+        if (nsent == 0)
+            return Error::from_string_literal("File ended before its announced length");
+        remaining -= nsent;
     }
-    if (!keep_alive)
-        m_socket->close();
 
     return {};
+#else
+    if (content_info.range.has_value())
+        TRY(file.seek(content_info.range->start, SeekMode::SetPosition));
+    return send_response(file, request, move(content_info));
+#endif
 }
 
 ErrorOr<void> Client::send_redirect(StringView redirect_path, HTTP::HttpRequest const& request)
 {
     StringBuilder builder;
-    TRY(builder.try_append("HTTP/1.0 301 Moved Permanently\r\n"sv));
+    TRY(append_status_line_and_common_headers(builder, 301));
     TRY(builder.try_append("Location: "sv));
     TRY(builder.try_append(redirect_path));
     TRY(builder.try_append("\r\n"sv));
+    TRY(builder.try_append("Content-Length: 0\r\n"sv));
     TRY(builder.try_append("\r\n"sv));
 
     auto builder_contents = TRY(builder.to_byte_buffer());
@@ -353,9 +557,7 @@ ErrorOr<void> Client::send_error_response(unsigned code, HTTP::HttpRequest const
     TRY(content_builder.try_append("</h1></body></html>"sv));
 
     StringBuilder header_builder;
-    TRY(header_builder.try_appendff("HTTP/1.0 {} ", code));
-    TRY(header_builder.try_append(reason_phrase));
-    TRY(header_builder.try_append("\r\n"sv));
+    TRY(append_status_line_and_common_headers(header_builder, code));
 
     for (auto& header : headers) {
         TRY(header_builder.try_append(header));
@@ -7,9 +7,12 @@
 
 #pragma once
 
+#include <AK/ByteBuffer.h>
 #include <AK/String.h>
 #include <LibCore/EventReceiver.h>
+#include <LibCore/Forward.h>
 #include <LibCore/Socket.h>
+#include <LibCore/Timer.h>
 #include <LibHTTP/Forward.h>
 #include <LibHTTP/HttpRequest.h>
 
@@ -26,23 +29,38 @@ private:
 
     using WrappedError = Variant<AK::Error, HTTP::HttpRequest::ParseError>;
 
+    struct ByteRange {
+        u64 start { 0 };
+        u64 end { 0 };
+    };
+
     struct ContentInfo {
         String type;
         u64 length {};
+        bool is_gzip_encoded { false };
+        bool varies_on_encoding { false };
+        Optional<ByteRange> range {};
+        u64 full_length {};
     };
 
     ErrorOr<void, WrappedError> on_ready_to_read();
     ErrorOr<bool> handle_request(HTTP::HttpRequest const&);
+    ErrorOr<void> append_status_line_and_common_headers(StringBuilder&, unsigned code);
+    ErrorOr<void> send_response_header(HTTP::HttpRequest const&, ContentInfo const&);
     ErrorOr<void> send_response(Stream&, HTTP::HttpRequest const&, ContentInfo);
+    ErrorOr<void> send_file_response(Core::File&, HTTP::HttpRequest const&, ContentInfo);
     ErrorOr<void> send_redirect(StringView redirect, HTTP::HttpRequest const&);
     ErrorOr<void> send_error_response(unsigned code, HTTP::HttpRequest const&, Vector<String> const& headers = {});
     void die();
     void log_response(unsigned code, HTTP::HttpRequest const&);
     ErrorOr<void> handle_directory_listing(String const& requested_path, String const& real_path, HTTP::HttpRequest const&);
     bool verify_credentials(Vector<HTTP::HttpRequest::Header> const&);
+    static Optional<ByteRange> parse_range_header(StringView, u64 size, bool& is_satisfiable);
 
     NonnullOwnPtr<Core::BufferedTCPSocket> m_socket;
-    StringBuilder m_remaining_request;
+    NonnullRefPtr<Core::Timer> m_idle_timer;
+    ByteBuffer m_pending_input;
+    bool m_keep_alive { false };
 };
 
 }
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibCompress/Gzip.h>
+#include <LibCore/File.h>
+#include <WebServer/FileCache.h>
+
+namespace WebServer {
+
+static constexpr size_t maximum_file_size = 1 * MiB;
+static constexpr size_t maximum_total_size = 32 * MiB;
+static constexpr size_t maximum_tracked_entries = 4096;
+static constexpr u32 minimum_hits_before_caching = 2;
+
+FileCache& FileCache::the()
+{
+    static FileCache s_the;
+    return s_the;
+}
+
+bool FileCache::is_compressible(StringView mime_type)
+{
+    return mime_type.starts_with("text/"sv)
+        || mime_type.is_one_of("application/javascript"sv, "application/json"sv, "application/xml"sv, "image/svg+xml"sv);
+}
+
+ErrorOr<FileCache::Entry const*> FileCache::lookup(String const& path, StringView mime_type, u64 size, time_t modification_time)
+{
+    if (size > maximum_file_size)
+        return nullptr;
+
+    auto it = m_entries.find(path);
+    if (it == m_entries.end()) {
+        // Forget about files that were only requested once, so that crawling the whole document root doesn't grow us forever.
+        if (m_entries.size() >= maximum_tracked_entries)
+            m_entries.remove_all_matching([](auto&, auto& entry) { return !entry->is_loaded; });
+        auto entry = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Entry { .size = size, .modification_time = modification_time }));
+        TRY(m_entries.try_set(path, move(entry)));
+        it = m_entries.find(path);
+    }
+
+    auto& entry = *it->value;
+    entry.last_used = MonotonicTime::now_coarse();
+    if (entry.size != size || entry.modification_time != modification_time) {
+        dbgln_if(WEBSERVER_DEBUG, "File cache: '{}' was modified", path);
+        unload(entry);
+        entry.size = size;
+        entry.modification_time = modification_time;
+        entry.hit_count = 0;
+    }
+
+    if (entry.is_loaded)
+        return &entry;
+    if (++entry.hit_count < minimum_hits_before_caching)
+        return nullptr;
+
+    auto file = TRY(Core::File::open(path, Core::File::OpenMode::Read));
+    auto contents = TRY(file->read_until_eof());
+    // The file changed between the caller's stat() and us reading it, let the caller deal with it.
+    if (contents.size() != size)
+        return nullptr;
+
+    Optional<ByteBuffer> gzip_contents;
+    if (is_compressible(mime_type)) {
+        auto compressed = TRY(Compress::GzipCompressor::compress_all(contents));
+        if (compressed.size() < contents.size())
+            gzip_contents = move(compressed);
+    }
+
+    entry.contents = move(contents);
+    entry.gzip_contents = move(gzip_contents);
+    evict_until_there_is_room_for(entry.memory_size());
+    entry.is_loaded = true;
+    m_total_size += entry.memory_size();
+    dbgln_if(WEBSERVER_DEBUG, "File cache: Loaded '{}' ({} bytes, {} bytes total)", path, entry.memory_size(), m_total_size);
+    return &entry;
+}
+
+void FileCache::unload(Entry& entry)
+{
+    if (!entry.is_loaded)
+        return;
+    m_total_size -= entry.memory_size();
+    entry.contents.clear();
+    entry.gzip_contents.clear();
+    entry.is_loaded = false;
+}
+
+void FileCache::evict_until_there_is_room_for(size_t size)
+{
+    while (m_total_size + size > maximum_total_size) {
+        Entry* least_recently_used = nullptr;
+        for (auto& it : m_entries) {
+            if (it.value->is_loaded && (!least_recently_used || it.value->last_used < least_recently_used->last_used))
+                least_recently_used = it.value.ptr();
+        }
+        if (!least_recently_used)
+            return;
+        unload(*least_recently_used);
+    }
+}
+
+}
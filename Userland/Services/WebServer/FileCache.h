@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/String.h>
+#include <AK/Time.h>
+
+namespace WebServer {
+
+// Keeps small files that are requested repeatedly in memory, along with a gzip-compressed copy if that's worthwhile.
+class FileCache {
+public:
+    struct Entry {
+        ByteBuffer contents;
+        Optional<ByteBuffer> gzip_contents;
+        u64 size { 0 };
+        time_t modification_time { 0 };
+        MonotonicTime last_used { MonotonicTime::now_coarse() };
+        u32 hit_count { 0 };
+        bool is_loaded { false };
+
+        size_t memory_size() const { return contents.size() + (gzip_contents.has_value() ? gzip_contents->size() : 0); }
+    };
+
+    static FileCache& the();
+    static bool is_compressible(StringView mime_type);
+
+    // Returns nullptr if the file should be served from disk.
+    ErrorOr<Entry const*> lookup(String const& path, StringView mime_type, u64 size, time_t modification_time);
+
+private:
+    void unload(Entry&);
+    void evict_until_there_is_room_for(size_t);
+
+    HashMap<String, NonnullOwnPtr<Entry>> m_entries;
+    size_t m_total_size { 0 };
+};
+
+}
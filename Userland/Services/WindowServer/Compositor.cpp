@@ -24,6 +24,7 @@
 #include <LibGfx/Painter.h>
 #include <LibGfx/StylePainter.h>
 #include <LibThreading/BackgroundAction.h>
+#include <LibThreading/Parallel.h>
 
 namespace WindowServer {
 
@@ -47,7 +48,7 @@ static WallpaperMode mode_to_enum(ByteString const& name)
 Compositor::Compositor()
 {
     m_display_link_notify_timer = add<Core::Timer>(
-        1000 / 60, [this] {
+        display_link_interval_ms, [this] {
             notify_display_links();
         });
 
@@ -105,6 +106,7 @@ void CompositorScreenData::init_bitmaps(Compositor& compositor, Screen& screen)
     m_flush_rects.clear_with_capacity();
     m_flush_transparent_rects.clear_with_capacity();
     m_flush_special_rects.clear_with_capacity();
+    m_stale_back_buffer_rects.clear_with_capacity();
 
     auto size = screen.size();
     m_front_bitmap = nullptr;
@@ -163,6 +165,56 @@ Gfx::IntPoint Compositor::window_transition_offset(Window& window)
     return window.window_stack().transition_offset();
 }
 
+static Threading::TaskPool& task_pool()
+{
+    static Threading::TaskPool pool;
+    return pool;
+}
+
+static void copy_rect_between_buffers(Screen& screen, Gfx::Bitmap& to_bitmap, Gfx::Bitmap const& from_bitmap, Gfx::IntRect const& rect)
+{
+    // Almost everything in Compositor is in logical coordinates, with the painters having
+    // a scale applied. But this routine accesses the buffer pixels directly, so it
+    // must work in physical coordinates.
+    auto scaled_rect = rect * screen.scale_factor();
+    Gfx::ARGB32* to_ptr = to_bitmap.scanline(scaled_rect.y()) + scaled_rect.x();
+    Gfx::ARGB32 const* from_ptr = from_bitmap.scanline(scaled_rect.y()) + scaled_rect.x();
+    size_t to_pitch = to_bitmap.pitch();
+    size_t from_pitch = from_bitmap.pitch();
+
+    for (int y = 0; y < scaled_rect.height(); ++y) {
+        fast_u32_copy(to_ptr, from_ptr, scaled_rect.width());
+        from_ptr = (Gfx::ARGB32 const*)((u8 const*)from_ptr + from_pitch);
+        to_ptr = (Gfx::ARGB32*)((u8*)to_ptr + to_pitch);
+    }
+}
+
+static void copy_rects_between_buffers(Screen& screen, Gfx::Bitmap& to_bitmap, Gfx::Bitmap const& from_bitmap, ReadonlySpan<Gfx::IntRect> rects)
+{
+    // Large updates (like a fullscreen window, or all of a 4K screen after a theme change) are split into bands of
+    // scanlines that are copied on several threads. Small ones aren't worth waking up the workers for.
+    static constexpr int lines_per_band = 32;
+    static constexpr size_t min_area_for_parallel_copy = 256 * 256;
+
+    size_t area = 0;
+    for (auto const& rect : rects)
+        area += rect.size().area() * screen.scale_factor() * screen.scale_factor();
+    if (area < min_area_for_parallel_copy) {
+        for (auto const& rect : rects)
+            copy_rect_between_buffers(screen, to_bitmap, from_bitmap, rect);
+        return;
+    }
+
+    Vector<Gfx::IntRect, 64> bands;
+    for (auto const& rect : rects) {
+        for (int y = rect.top(); y < rect.bottom(); y += lines_per_band)
+            bands.append({ rect.x(), y, rect.width(), min(lines_per_band, rect.bottom() - y) });
+    }
+    Threading::parallel_for(task_pool(), bands.size(), [&](size_t band_index) {
+        copy_rect_between_buffers(screen, to_bitmap, from_bitmap, bands[band_index]);
+    });
+}
+
 void Compositor::compose()
 {
     auto& wm = WindowManager::the();
@@ -180,6 +232,8 @@ void Compositor::compose()
         return;
     }
 
+    auto compose_start_time = MonotonicTime::now();
+
     if (m_occlusions_dirty) {
         m_occlusions_dirty = false;
         recompute_occlusions();
@@ -235,6 +289,29 @@ void Compositor::compose()
         return IterationDecision::Continue;
     });
 
+    auto* fullscreen_window = wm.active_fullscreen_window();
+    // FIXME: Remove the !WindowSwitcher::the().is_visible() check when WindowSwitcher is an overlay
+    bool compose_only_fullscreen_window = fullscreen_window && fullscreen_window->is_opaque() && !WindowSwitcher::the().is_visible();
+
+    // Bring the back buffers up to date with what was flipped to the front last time, except for the areas that an
+    // opaque fullscreen window is about to paint over anyway. A fullscreen window that repaints all of itself every
+    // frame (like a video or a game) then costs a single copy of its backing store per frame.
+    Screen::for_each([&](auto& screen) {
+        auto& screen_data = screen.compositor_screen_data();
+        if (screen_data.m_stale_back_buffer_rects.is_empty())
+            return IterationDecision::Continue;
+        if (m_invalidated_window && compose_only_fullscreen_window && !window_stack_transition_in_progress && !fullscreen_window->screens().is_empty()) {
+            Gfx::DisjointIntRectSet repainted_rects;
+            fullscreen_window->opaque_rects().for_each_intersected(fullscreen_window->dirty_rects(), [&](Gfx::IntRect const& rect) {
+                repainted_rects.add(rect);
+                return IterationDecision::Continue;
+            });
+            screen_data.m_stale_back_buffer_rects = screen_data.m_stale_back_buffer_rects.shatter(repainted_rects);
+        }
+        screen_data.update_stale_back_buffer_rects(screen);
+        return IterationDecision::Continue;
+    });
+
     Color background_color = wm.palette().desktop_background();
     if (m_custom_background_color.has_value())
         background_color = m_custom_background_color.value();
@@ -528,9 +605,7 @@ void Compositor::compose()
 
     // Paint the window stack.
     if (m_invalidated_window) {
-        auto* fullscreen_window = wm.active_fullscreen_window();
-        // FIXME: Remove the !WindowSwitcher::the().is_visible() check when WindowSwitcher is an overlay
-        if (fullscreen_window && fullscreen_window->is_opaque() && !WindowSwitcher::the().is_visible()) {
+        if (compose_only_fullscreen_window) {
             compose_window(*fullscreen_window);
             fullscreen_window->clear_dirty_rects();
         } else {
@@ -571,8 +646,10 @@ void Compositor::compose()
         Screen::for_each([&](auto& screen) {
             auto screen_rect = screen.rect();
             auto& screen_data = screen.compositor_screen_data();
+            Vector<Gfx::IntRect, 32> rects;
             for (auto& rect : screen_data.m_flush_transparent_rects.rects())
-                screen_data.m_back_painter->blit(rect.location(), *screen_data.m_temp_bitmap, rect.translated(-screen_rect.location()));
+                rects.append(rect.translated(-screen_rect.location()));
+            copy_rects_between_buffers(screen, *screen_data.m_back_bitmap, *screen_data.m_temp_bitmap, rects);
             return IterationDecision::Continue;
         });
     }
@@ -599,10 +676,35 @@ void Compositor::compose()
         screen_data.draw_cursor(cursor_screen, cursor_rect);
     }
 
+    u64 dirty_area = 0;
     Screen::for_each([&](auto& screen) {
+        auto& screen_data = screen.compositor_screen_data();
+        if (screen_data.m_have_flush_rects) {
+            for (auto& rect : screen_data.m_flush_rects.rects())
+                dirty_area += rect.size().area();
+            for (auto& rect : screen_data.m_flush_transparent_rects.rects())
+                dirty_area += rect.size().area();
+            for (auto& rect : screen_data.m_flush_special_rects.rects())
+                dirty_area += rect.size().area();
+        }
         flush(screen);
         return IterationDecision::Continue;
     });
+
+    auto compose_end_time = MonotonicTime::now();
+    m_last_compose_time = compose_end_time - compose_start_time;
+    m_last_compose_dirty_area = dirty_area;
+
+    // Clients that draw every frame are told to start on the next one as soon as this one has been presented, instead
+    // of at some unrelated point in time, so that what they draw is picked up by the very next compose pass. The timer
+    // keeps them going while nothing else causes a compose.
+    if (m_display_link_count > 0) {
+        auto minimum_interval = Duration::from_milliseconds(display_link_interval_ms / 2);
+        if (!m_last_display_link_notification_time.has_value() || compose_end_time - *m_last_display_link_notification_time >= minimum_interval) {
+            notify_display_links();
+            m_display_link_notify_timer->restart();
+        }
+    }
 }
 
 void Compositor::flush(Screen& screen)
@@ -665,47 +767,28 @@ void Compositor::flush(Screen& screen)
         screen_data.m_has_flipped = true;
     }
 
+    Vector<Gfx::IntRect, 32> rects_to_copy;
     auto do_flush = [&](Gfx::IntRect rect) {
         VERIFY(screen_rect.contains(rect));
-        rect.translate_by(-screen_rect.location());
-
-        // Almost everything in Compositor is in logical coordinates, with the painters having
-        // a scale applied. But this routine accesses the backbuffer pixels directly, so it
-        // must work in physical coordinates.
-        auto scaled_rect = rect * screen.scale_factor();
-        Gfx::ARGB32* front_ptr = screen_data.m_front_bitmap->scanline(scaled_rect.y()) + scaled_rect.x();
-        Gfx::ARGB32* back_ptr = screen_data.m_back_bitmap->scanline(scaled_rect.y()) + scaled_rect.x();
-        size_t pitch = screen_data.m_back_bitmap->pitch();
 
         // NOTE: The meaning of a flush depends on whether we can flip buffers or not.
         //
-        //       If flipping is supported, flushing means that we've flipped, and now we
-        //       copy the changed bits from the front buffer to the back buffer, to keep
-        //       them in sync.
+        //       If flipping is supported, flushing means that we've flipped, and the changed
+        //       bits have to be copied from the front buffer to the back buffer to keep them
+        //       in sync. That copy is deferred until right before the next compose, where
+        //       it can be skipped for anything that is going to be repainted anyway.
         //
         //       If flipping is not supported, flushing means that we copy the changed
         //       rects from the backing bitmap to the display framebuffer.
-
-        Gfx::ARGB32* to_ptr;
-        Gfx::ARGB32 const* from_ptr;
-
         if (screen_data.m_screen_can_set_buffer) {
-            to_ptr = back_ptr;
-            from_ptr = front_ptr;
-        } else {
-            to_ptr = front_ptr;
-            from_ptr = back_ptr;
+            screen_data.m_stale_back_buffer_rects.add(rect);
+            return;
         }
 
-        for (int y = 0; y < scaled_rect.height(); ++y) {
-            fast_u32_copy(to_ptr, from_ptr, scaled_rect.width());
-            from_ptr = (Gfx::ARGB32 const*)((u8 const*)from_ptr + pitch);
-            to_ptr = (Gfx::ARGB32*)((u8*)to_ptr + pitch);
-        }
+        rect.translate_by(-screen_rect.location());
+        rects_to_copy.append(rect);
         if (device_can_flush_buffers) {
-            // Whether or not we need to flush buffers, we need to at least track what we modified
-            // so that we can flush these areas next time before we flip buffers. Or, if we don't
-            // support buffer flipping then we will flush them shortly.
+            // If we don't support buffer flipping then we will flush these areas shortly.
             screen.queue_flush_display_rect(rect);
         }
     };
@@ -715,6 +798,7 @@ void Compositor::flush(Screen& screen)
         do_flush(rect);
     for (auto& rect : screen_data.m_flush_special_rects.rects())
         do_flush(rect);
+    copy_rects_between_buffers(screen, *screen_data.m_front_bitmap, *screen_data.m_back_bitmap, rects_to_copy);
     if (device_can_flush_buffers && !screen_data.m_screen_can_set_buffer) {
         // If we also support flipping buffers we don't really need to flush these areas right now.
         // Instead, we skip this step and just keep track of them until shortly before the next flip.
@@ -872,6 +956,23 @@ void CompositorScreenData::clear_wallpaper_bitmap()
     m_wallpaper_bitmap = nullptr;
 }
 
+void CompositorScreenData::update_stale_back_buffer_rects(Screen& screen)
+{
+    VERIFY(m_screen_can_set_buffer);
+    auto screen_rect = screen.rect();
+    Vector<Gfx::IntRect, 32> rects;
+    for (auto rect : m_stale_back_buffer_rects.rects()) {
+        rect.translate_by(-screen_rect.location());
+        rects.append(rect);
+        if (screen.can_device_flush_buffers()) {
+            // We need to track what we modified so that we can flush these areas before we flip buffers next time.
+            screen.queue_flush_display_rect(rect);
+        }
+    }
+    copy_rects_between_buffers(screen, *m_back_bitmap, *m_front_bitmap, rects);
+    m_stale_back_buffer_rects.clear_with_capacity();
+}
+
 void CompositorScreenData::flip_buffers(Screen& screen)
 {
     VERIFY(m_screen_can_set_buffer);
@@ -1055,6 +1156,7 @@ void Compositor::update_fonts()
 
 void Compositor::notify_display_links()
 {
+    m_last_display_link_notification_time = MonotonicTime::now();
     ConnectionFromClient::for_each_client([](auto& client) {
         client.notify_display_link({});
     });
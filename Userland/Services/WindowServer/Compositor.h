@@ -8,6 +8,7 @@
 
 #include <AK/OwnPtr.h>
 #include <AK/RefPtr.h>
+#include <AK/Time.h>
 #include <LibCore/EventReceiver.h>
 #include <LibGfx/Color.h>
 #include <LibGfx/DisjointRectSet.h>
@@ -54,11 +55,14 @@ struct CompositorScreenData {
     Gfx::DisjointIntRectSet m_flush_rects;
     Gfx::DisjointIntRectSet m_flush_transparent_rects;
     Gfx::DisjointIntRectSet m_flush_special_rects;
+    // Areas that were flipped to the front buffer, but haven't been copied back to the back buffer yet.
+    Gfx::DisjointIntRectSet m_stale_back_buffer_rects;
 
     Gfx::Painter& overlay_painter() { return *m_temp_painter; }
 
     void init_bitmaps(Compositor&, Screen&);
     void flip_buffers(Screen&);
+    void update_stale_back_buffer_rects(Screen&);
     void draw_cursor(Screen&, Gfx::IntRect const&);
     bool restore_cursor_back(Screen&, Gfx::IntRect&);
     void clear_wallpaper_bitmap();
@@ -184,6 +188,10 @@ public:
 
     void set_flash_flush(bool b) { m_flash_flush = b; }
 
+    // How long the last compose pass took, and how many (logical) pixels it updated on all screens.
+    Duration last_compose_time() const { return m_last_compose_time; }
+    u64 last_compose_dirty_area() const { return m_last_compose_dirty_area; }
+
     static NonnullOwnPtr<CompositorScreenData> create_screen_data(Badge<Screen>)
     {
         return adopt_own(*new CompositorScreenData());
@@ -224,6 +232,9 @@ private:
     bool m_overlay_rects_changed { false };
     bool m_animations_running { false };
 
+    Duration m_last_compose_time;
+    u64 m_last_compose_dirty_area { 0 };
+
     IntrusiveList<&Overlay::m_list_node> m_overlay_list;
     Gfx::DisjointIntRectSet m_overlay_rects;
     Gfx::DisjointIntRectSet m_last_rendered_overlay_rects;
@@ -241,6 +252,8 @@ private:
 
     RefPtr<Core::Timer> m_display_link_notify_timer;
     size_t m_display_link_count { 0 };
+    Optional<MonotonicTime> m_last_display_link_notification_time;
+    static constexpr int display_link_interval_ms = 1000 / 60;
 
     WindowStack* m_current_window_stack { nullptr };
     WindowStack* m_transitioning_to_window_stack { nullptr };
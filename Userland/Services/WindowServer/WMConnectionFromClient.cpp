@@ -5,6 +5,7 @@
  */
 
 #include <WindowServer/AppletManager.h>
+#include <WindowServer/Compositor.h>
 #include <WindowServer/ConnectionFromClient.h>
 #include <WindowServer/Screen.h>
 #include <WindowServer/WMConnectionFromClient.h>
@@ -187,4 +188,10 @@ void WMConnectionFromClient::set_keymap(ByteString const& keymap)
     WindowManager::the().keymap_switcher()->set_keymap(keymap);
 }
 
+Messages::WindowManagerServer::GetComposeStatisticsResponse WMConnectionFromClient::get_compose_statistics()
+{
+    auto& compositor = Compositor::the();
+    return { static_cast<u64>(compositor.last_compose_time().to_microseconds()), compositor.last_compose_dirty_area() };
+}
+
 }
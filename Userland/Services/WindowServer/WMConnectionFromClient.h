@@ -32,6 +32,7 @@ public:
     virtual void set_manager_window(i32) override;
     virtual void set_workspace(u32, u32) override;
     virtual void set_keymap(ByteString const&) override;
+    virtual Messages::WindowManagerServer::GetComposeStatisticsResponse get_compose_statistics() override;
 
     unsigned event_mask() const { return m_event_mask; }
     int window_id() const { return m_window_id; }
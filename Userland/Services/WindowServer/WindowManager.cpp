@@ -426,6 +426,8 @@ void WindowManager::greet_window_manager(WMConnectionFromClient& conn)
     if (conn.window_id() < 0)
         return;
 
+    // NOTE: This sends a couple of messages for every window, which the WM can just as well receive all at once.
+    IPC::MessageBatch batch { conn };
     tell_wm_about_current_window_stack(conn);
 
     for_each_window_stack([&](auto& window_stack) {
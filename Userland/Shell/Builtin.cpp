@@ -229,6 +229,42 @@ ErrorOr<int> Shell::builtin_unalias(Main::Arguments arguments)
     return failed ? 1 : 0;
 }
 
+ErrorOr<int> Shell::builtin_hash(Main::Arguments arguments)
+{
+    bool forget_all { false };
+    Vector<ByteString> names;
+
+    Core::ArgsParser parser;
+    parser.set_general_help("Remember or display the locations of commands found in PATH");
+    parser.add_option(forget_all, "Forget all remembered locations", nullptr, 'r');
+    parser.add_positional_argument(names, "Commands to look up", "name", Core::ArgsParser::Required::No);
+
+    if (!parser.parse(arguments, Core::ArgsParser::FailureBehavior::PrintUsage))
+        return 1;
+
+    if (forget_all)
+        m_executable_path_cache.clear();
+
+    if (names.is_empty()) {
+        if (!forget_all) {
+            for (auto& entry : m_executable_path_cache)
+                outln("{}\t{}", entry.key, entry.value);
+        }
+        return 0;
+    }
+
+    bool failed { false };
+    for (auto& name : names) {
+        m_executable_path_cache.remove(name);
+        if (!resolve_executable_path(name).has_value()) {
+            warnln("hash: {}: not found", name);
+            failed = true;
+        }
+    }
+
+    return failed ? 1 : 0;
+}
+
 ErrorOr<int> Shell::builtin_break(Main::Arguments arguments)
 {
     unsigned count = 1;
@@ -607,6 +607,29 @@ Optional<Shell::RunnablePath> Shell::runnable_path_for(StringView name)
     return *found;
 }
 
+Optional<ByteString> Shell::resolve_executable_path(StringView name)
+{
+    if (name.is_empty() || name.contains('/'))
+        return {};
+
+    ByteString search_path = getenv("PATH");
+    if (search_path != m_executable_path_cache_search_path) {
+        m_executable_path_cache.clear();
+        m_executable_path_cache_search_path = move(search_path);
+    }
+
+    if (auto cached_path = m_executable_path_cache.get(name); cached_path.has_value())
+        return cached_path.release_value();
+
+    auto resolved_path_or_error = Core::System::resolve_executable_from_environment(name);
+    if (resolved_path_or_error.is_error())
+        return {};
+
+    auto resolved_path = resolved_path_or_error.release_value().to_byte_string();
+    m_executable_path_cache.set(name, resolved_path);
+    return resolved_path;
+}
+
 Optional<ByteString> Shell::help_path_for(Vector<RunnablePath> visited, Shell::RunnablePath const& runnable_path)
 {
     switch (runnable_path.kind) {
@@ -817,6 +840,11 @@ ErrorOr<RefPtr<Job>> Shell::run_command(const AST::Command& command)
 
     argv.append(nullptr);
 
+    // Look the command up in the parent, so the result is remembered for the next time it's run.
+    Optional<ByteString> executable_path;
+    if (!copy_argv.is_empty())
+        executable_path = resolve_executable_path(copy_argv.first());
+
     auto sync_pipe = TRY(Core::System::pipe2(0));
     auto child = TRY(Core::System::fork());
 
@@ -873,7 +901,7 @@ ErrorOr<RefPtr<Job>> Shell::run_command(const AST::Command& command)
         // We no longer need the jobs here.
         jobs.clear();
 
-        execute_process(move(argv));
+        execute_process(move(argv), executable_path);
         VERIFY_NOT_REACHED();
     }
 
@@ -968,7 +996,7 @@ ErrorOr<void> Shell::execute_process(Span<StringView> argv)
     execute_process(move(args));
 }
 
-void Shell::execute_process(Vector<char const*>&& argv)
+void Shell::execute_process(Vector<char const*>&& argv, Optional<ByteString> const& executable_path)
 {
     for (auto& promise : m_active_promises) {
         MUST(Core::System::pledge("stdio rpath exec"sv, promise.data.exec_promises));
@@ -976,6 +1004,10 @@ void Shell::execute_process(Vector<char const*>&& argv)
             MUST(Core::System::unveil(item.path, item.access));
     }
 
+    // If the remembered location has gone stale, fall back to searching PATH below.
+    if (executable_path.has_value())
+        (void)execv(executable_path->characters(), const_cast<char* const*>(argv.data()));
+
     int rc = execvp(argv[0], const_cast<char* const*>(argv.data()));
     if (rc < 0) {
         auto parts = StringView { argv[0], strlen(argv[0]) }.split_view('/');
@@ -1553,10 +1585,17 @@ void Shell::remove_entry_from_cache(StringView entry)
 ErrorOr<void> Shell::highlight(Line::Editor& editor) const
 {
     auto line = editor.line();
-    auto ast = parse(line, m_is_interactive);
-    if (!ast)
+
+    // The display is often refreshed without the line having changed (e.g. when the cursor moves across
+    // styles or the terminal is resized), so only reparse when the line is actually different.
+    if (!m_last_highlighted_ast || line != m_last_highlighted_line) {
+        m_last_highlighted_ast = parse(line, m_is_interactive);
+        m_last_highlighted_line = move(line);
+    }
+
+    if (!m_last_highlighted_ast)
         return {};
-    return ast->highlight_in_editor(editor, const_cast<Shell&>(*this));
+    return m_last_highlighted_ast->highlight_in_editor(editor, const_cast<Shell&>(*this));
 }
 
 Vector<Line::CompletionSuggestion> Shell::complete()
@@ -36,6 +36,7 @@
     __ENUMERATE_SHELL_BUILTIN(exit, InAllModes)              \
     __ENUMERATE_SHELL_BUILTIN(export, InAllModes)            \
     __ENUMERATE_SHELL_BUILTIN(glob, InAllModes)              \
+    __ENUMERATE_SHELL_BUILTIN(hash, InAllModes)              \
     __ENUMERATE_SHELL_BUILTIN(unalias, InAllModes)           \
     __ENUMERATE_SHELL_BUILTIN(unset, InAllModes)             \
     __ENUMERATE_SHELL_BUILTIN(set, InAllModes)               \
@@ -169,6 +170,7 @@ public:
 
     int run_command(StringView, Optional<SourcePosition> = {});
     Optional<RunnablePath> runnable_path_for(StringView);
+    Optional<ByteString> resolve_executable_path(StringView);
     Optional<ByteString> help_path_for(Vector<RunnablePath> visited, RunnablePath const& runnable_path);
     ErrorOr<RefPtr<Job>> run_command(const AST::Command&);
     Vector<NonnullRefPtr<Job>> run_commands(Vector<AST::Command>&);
@@ -448,7 +450,7 @@ private:
     void run_tail(RefPtr<Job>);
     void run_tail(const AST::Command&, const AST::NodeWithAction&, int head_exit_code);
 
-    [[noreturn]] void execute_process(Vector<char const*>&& argv);
+    [[noreturn]] void execute_process(Vector<char const*>&& argv, Optional<ByteString> const& executable_path = {});
     ErrorOr<void> execute_process(Span<StringView> argv);
 
     virtual void custom_event(Core::CustomEvent&) override;
@@ -500,6 +502,14 @@ private:
     Vector<NonnullRefPtr<AST::Redirection>> m_global_redirections;
 
     HashMap<ByteString, ByteString> m_aliases;
+
+    mutable ByteString m_last_highlighted_line;
+    mutable RefPtr<AST::Node> m_last_highlighted_ast;
+
+    // Where commands were last found in PATH, only valid as long as PATH is unchanged.
+    HashMap<ByteString, ByteString> m_executable_path_cache;
+    ByteString m_executable_path_cache_search_path;
+
     bool m_is_interactive { true };
     bool m_is_subshell { false };
     bool m_should_reinstall_signal_handlers { true };
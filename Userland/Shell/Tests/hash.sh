@@ -0,0 +1,13 @@
+#!/bin/Shell
+
+source $(dirname "$0")/test-commons.inc
+
+hash -r
+if not test -z "$(hash)" { fail "'hash -r' did not forget remembered commands" }
+
+ls > /dev/null
+if test -z "$(hash)" { fail "running a command did not remember its location" }
+
+if hash this-command-does-not-exist 2> /dev/null { fail "'hash' found a command that does not exist" }
+
+echo PASS
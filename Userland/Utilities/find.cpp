@@ -943,6 +943,10 @@ static void walk_tree(FileData& root_data, Command& command, u32 depth = 0)
         return;
     }
 
+    // None of the entries would be visited, so don't bother reading the directory.
+    if (g_max_depth.has_value() && depth >= g_max_depth.value())
+        return;
+
     int dirfd = openat(root_data.dirfd, root_data.basename, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
     if (dirfd < 0) {
         if (errno == ENOTDIR) {
@@ -978,9 +982,6 @@ static void walk_tree(FileData& root_data, Command& command, u32 depth = 0)
 
         bool should_increase_depth = false;
         if (g_max_depth.has_value() || g_min_depth.has_value()) {
-            if (g_max_depth.has_value() && depth >= g_max_depth.value())
-                return;
-
             if (file_data.d_type == DT_UNKNOWN)
                 file_data.ensure_stat();
 
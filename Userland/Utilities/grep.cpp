@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AllOf.h>
 #include <AK/Assertions.h>
 #include <AK/ByteString.h>
 #include <AK/LexicalPath.h>
@@ -14,6 +15,7 @@
 #include <LibCore/ArgsParser.h>
 #include <LibCore/DirIterator.h>
 #include <LibCore/File.h>
+#include <LibCore/MappedFile.h>
 #include <LibCore/System.h>
 #include <LibFileSystem/FileSystem.h>
 #include <LibMain/Main.h>
@@ -113,6 +115,58 @@ static void append_formatted_path(StringBuilder& builder, StringView path, Optio
         builder.append("\033]8;;\033\\"sv);
 }
 
+static ErrorOr<OwnPtr<Core::MappedFile>> map_file_for_searching(StringView filename)
+{
+    if (filename == '-')
+        return nullptr;
+
+    // Only regular files with a known size can be mapped, everything else (pipes, devices,
+    // synthetic files reporting a size of zero) still goes through buffered reads.
+    auto stat = TRY(Core::System::stat(filename));
+    if (!S_ISREG(stat.st_mode) || stat.st_size == 0)
+        return nullptr;
+
+    return TRY(Core::MappedFile::map(filename));
+}
+
+// Invokes the callback for each line in the given file contents. If any literals are given, lines that
+// don't contain at least one of them are skipped without being looked at.
+template<typename Callback>
+static void for_each_candidate_line(StringView contents, ReadonlySpan<ByteString> literals, Callback callback)
+{
+    size_t line_number = 1;
+    size_t offset = 0;
+
+    while (offset < contents.length()) {
+        auto line_start = offset;
+
+        if (!literals.is_empty()) {
+            Optional<size_t> next_literal;
+            for (auto const& literal : literals) {
+                auto position = contents.find(literal, offset);
+                if (position.has_value() && (!next_literal.has_value() || *position < *next_literal))
+                    next_literal = position;
+            }
+            if (!next_literal.has_value())
+                return;
+
+            for (auto i = offset; i < *next_literal; ++i) {
+                if (contents[i] == '\n') {
+                    ++line_number;
+                    line_start = i + 1;
+                }
+            }
+        }
+
+        auto line_end = contents.find('\n', line_start).value_or(contents.length());
+        if (callback(contents.substring_view(line_start, line_end - line_start), line_number) == IterationDecision::Break)
+            return;
+
+        ++line_number;
+        offset = line_end + 1;
+    }
+}
+
 ErrorOr<int> serenity_main(Main::Arguments args)
 {
     TRY(Core::System::pledge("stdio rpath"));
@@ -229,6 +283,11 @@ ErrorOr<int> serenity_main(Main::Arguments args)
 
     auto user_has_specified_files = !files.is_empty();
 
+    // A line can only match a fixed string if it contains it verbatim, which lets us jump straight to candidate lines.
+    Vector<ByteString> literal_prefilter;
+    if (fixed_strings && !case_insensitive && !invert_match && all_of(patterns, [](auto const& pattern) { return !pattern.is_empty(); }))
+        literal_prefilter = patterns;
+
     PosixOptions options {};
     if (case_insensitive)
         options |= PosixFlags::Insensitive;
@@ -295,15 +354,9 @@ ErrorOr<int> serenity_main(Main::Arguments args)
 
         auto exit_status = ExitStatus::NoLinesMatched;
 
-        auto handle_file = [&matches, binary_mode, count_lines, quiet_mode, disable_hyperlinks, colored_output,
+        auto handle_file = [&matches, &literal_prefilter, binary_mode, count_lines, quiet_mode, disable_hyperlinks, colored_output,
                                &matched_line_count, &exit_status](StringView filename, bool print_filename) -> ErrorOr<void> {
-            auto file = TRY(Core::File::open_file_or_standard_stream(filename, Core::File::OpenMode::Read));
-            auto buffered_file = TRY(Core::InputBufferedFile::create(move(file)));
-
-            for (size_t line_number = 1; TRY(buffered_file->can_read_line()); ++line_number) {
-                Array<u8, PAGE_SIZE> buffer;
-                auto line = TRY(buffered_file->read_line(buffer));
-
+            auto handle_line = [&](StringView line, size_t line_number) {
                 auto is_binary = line.contains('\0');
 
                 auto matched = matches(line, filename, line_number, print_filename, is_binary);
@@ -311,6 +364,21 @@ ErrorOr<int> serenity_main(Main::Arguments args)
                     if (exit_status == ExitStatus::NoLinesMatched)
                         exit_status = ExitStatus::SomethingMatched;
                     if (is_binary && binary_mode == BinaryFileMode::Binary)
+                        return IterationDecision::Break;
+                }
+                return IterationDecision::Continue;
+            };
+
+            if (auto mapped_file = TRY(map_file_for_searching(filename))) {
+                for_each_candidate_line(StringView { mapped_file->bytes() }, literal_prefilter, handle_line);
+            } else {
+                auto file = TRY(Core::File::open_file_or_standard_stream(filename, Core::File::OpenMode::Read));
+                auto buffered_file = TRY(Core::InputBufferedFile::create(move(file)));
+
+                for (size_t line_number = 1; TRY(buffered_file->can_read_line()); ++line_number) {
+                    Array<u8, PAGE_SIZE> buffer;
+                    auto line = TRY(buffered_file->read_line(buffer));
+                    if (handle_line(line, line_number) == IterationDecision::Break)
                         break;
                 }
             }
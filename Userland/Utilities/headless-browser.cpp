@@ -11,11 +11,13 @@
 #include <AK/ByteBuffer.h>
 #include <AK/ByteString.h>
 #include <AK/Function.h>
+#include <AK/JsonArray.h>
 #include <AK/JsonObject.h>
 #include <AK/JsonParser.h>
 #include <AK/LexicalPath.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/Platform.h>
+#include <AK/QuickSort.h>
 #include <AK/String.h>
 #include <AK/Vector.h>
 #include <Ladybird/Types.h>
@@ -23,6 +25,7 @@
 #include <LibCore/ConfigFile.h>
 #include <LibCore/DirIterator.h>
 #include <LibCore/Directory.h>
+#include <LibCore/ElapsedTimer.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/File.h>
 #include <LibCore/Promise.h>
@@ -158,6 +161,14 @@ public:
         return String::from_byte_string(client().dump_text(0));
     }
 
+    ErrorOr<JsonObject> take_phase_timings()
+    {
+        auto timings = TRY(JsonValue::from_string(client().take_phase_timings(0)));
+        if (!timings.is_object())
+            return Error::from_string_literal("Malformed phase timings");
+        return timings.as_object();
+    }
+
     void clear_content_filters()
     {
         client().async_set_content_filters(0, {});
@@ -658,6 +669,99 @@ static ErrorOr<int> run_tests(HeadlessWebContentView& view, StringView test_root
     return 1;
 }
 
+static ErrorOr<Optional<JsonObject>> run_benchmark_iteration(HeadlessWebContentView& view, StringView page_path)
+{
+    Core::EventLoop loop;
+    bool did_timeout = false;
+
+    auto timeout_timer = Core::Timer::create_single_shot(DEFAULT_TIMEOUT_MS, [&] {
+        did_timeout = true;
+        loop.quit(0);
+    });
+
+    auto url = URL::create_with_file_scheme(TRY(FileSystem::real_path(page_path)));
+
+    // Throw away whatever the previous page (or the initial about:blank) accumulated.
+    (void)TRY(view.take_phase_timings());
+
+    auto timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+
+    view.on_load_finish = [&](auto const& loaded_url) {
+        if (!url.equals(loaded_url, URL::ExcludeFragment::Yes))
+            return;
+
+        // NOTE: The load event doesn't imply that anything has been painted yet, so we take a screenshot to include
+        //       the first paint of the page in the measurement.
+        (void)view.take_screenshot();
+        loop.quit(0);
+    };
+
+    view.load(url);
+
+    timeout_timer->start();
+    loop.exec();
+
+    view.on_load_finish = {};
+
+    if (did_timeout)
+        return OptionalNone {};
+
+    auto total_time = timer.elapsed_time();
+
+    auto result = TRY(view.take_phase_timings());
+    result.set("total", static_cast<double>(total_time.to_microseconds()) / 1000.0);
+    return result;
+}
+
+static ErrorOr<int> run_benchmarks(HeadlessWebContentView& view, StringView benchmark_path, int iterations)
+{
+    view.clear_content_filters();
+
+    Vector<ByteString> page_paths;
+    if (FileSystem::is_directory(benchmark_path)) {
+        TRY(Core::Directory::for_each_entry(benchmark_path, Core::DirIterator::SkipDots, [&](Core::DirectoryEntry const& entry, Core::Directory const&) -> ErrorOr<IterationDecision> {
+            if (entry.type != Core::DirectoryEntry::Type::Directory && entry.name.ends_with(".html"sv))
+                TRY(page_paths.try_append(LexicalPath::join(benchmark_path, entry.name).string()));
+            return IterationDecision::Continue;
+        }));
+        quick_sort(page_paths);
+    } else {
+        TRY(page_paths.try_append(benchmark_path));
+    }
+
+    size_t timeout_count = 0;
+
+    JsonArray pages;
+    for (auto const& page_path : page_paths) {
+        warnln("Benchmarking {}", page_path);
+
+        JsonArray runs;
+        for (int i = 0; i < iterations; ++i) {
+            auto run = TRY(run_benchmark_iteration(view, page_path));
+            if (!run.has_value()) {
+                warnln("{}: Timed out", page_path);
+                ++timeout_count;
+                break;
+            }
+            TRY(runs.append(run.release_value()));
+        }
+
+        JsonObject page;
+        page.set("path", LexicalPath::basename(page_path));
+        page.set("runs", move(runs));
+        TRY(pages.append(move(page)));
+    }
+
+    // All times are in milliseconds. The phase timings are exclusive: time spent in a nested phase (e.g. a script run
+    // by the HTML parser) is only attributed to the innermost phase.
+    JsonObject report;
+    report.set("iterations", iterations);
+    report.set("pages", move(pages));
+    outln("{}", report.to_byte_string());
+
+    return timeout_count == 0 ? 0 : 1;
+}
+
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
     Core::EventLoop event_loop;
@@ -673,6 +777,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     bool is_layout_test_mode = false;
     StringView test_root_path;
     ByteString test_glob;
+    StringView benchmark_path;
+    int benchmark_iterations = 5;
     Vector<ByteString> certificates;
 
 #if !defined(AK_OS_SERENITY)
@@ -689,6 +795,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_option(test_glob, "Only run tests matching the given glob", "filter", 'f', "glob");
     args_parser.add_option(dump_failed_ref_tests, "Dump screenshots of failing ref tests", "dump-failed-ref-tests", 'D');
     args_parser.add_option(dump_gc_graph, "Dump GC graph", "dump-gc-graph", 'G');
+    args_parser.add_option(benchmark_path, "Load the page, or each page in the directory, and print per-phase timings as JSON", "benchmark", 'b', "path");
+    args_parser.add_option(benchmark_iterations, "Number of times to load each benchmark page (default: 5)", "iterations", 'i', "n");
     args_parser.add_option(resources_folder, "Path of the base resources folder (defaults to /res)", "resources", 'r', "resources-root-path");
     args_parser.add_option(web_driver_ipc_path, "Path to the WebDriver IPC socket", "webdriver-ipc-path", 0, "path");
     args_parser.add_option(is_layout_test_mode, "Enable layout test mode", "layout-test-mode");
@@ -708,8 +816,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     // FIXME: Allow passing the window size as an argument.
     static constexpr Gfx::IntSize window_size { 800, 600 };
 
-    if (!test_root_path.is_empty()) {
-        // --run-tests implies --layout-test-mode.
+    if (!test_root_path.is_empty() || !benchmark_path.is_empty()) {
+        // --run-tests and --benchmark imply --layout-test-mode.
         is_layout_test_mode = true;
     }
 
@@ -722,6 +830,14 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         return run_tests(*view, test_root_path, test_glob, dump_failed_ref_tests, dump_gc_graph);
     }
 
+    if (!benchmark_path.is_empty()) {
+        if (benchmark_iterations <= 0) {
+            warnln("Invalid number of iterations: {}", benchmark_iterations);
+            return 1;
+        }
+        return run_benchmarks(*view, benchmark_path, benchmark_iterations);
+    }
+
     auto url = WebView::sanitize_url(raw_url);
     if (!url.has_value()) {
         warnln("Invalid URL: \"{}\"", raw_url);
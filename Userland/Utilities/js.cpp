@@ -533,6 +533,12 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     bool disable_syntax_highlight = false;
     bool disable_debug_printing = false;
     bool use_test262_global = false;
+    bool disable_jit = false;
+    bool disable_bytecode_optimizations = false;
+    bool dump_property_lookup_cache_statistics = false;
+    bool dump_execution_statistics = false;
+    bool dump_gc_statistics = false;
+    bool sample_javascript_stacks = false;
     StringView evaluate_script;
     Vector<StringView> script_paths;
 
@@ -540,6 +546,12 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.set_general_help("This is a JavaScript interpreter.");
     args_parser.add_option(s_dump_ast, "Dump the AST", "dump-ast", 'A');
     args_parser.add_option(JS::Bytecode::g_dump_bytecode, "Dump the bytecode", "dump-bytecode", 'd');
+    args_parser.add_option(disable_jit, "Disable the JIT compiler", "disable-jit", {});
+    args_parser.add_option(disable_bytecode_optimizations, "Disable the bytecode optimizations", "disable-bytecode-optimizations", {});
+    args_parser.add_option(dump_property_lookup_cache_statistics, "Dump the hit rates of the property lookup caches on exit", "dump-property-lookup-cache-statistics", {});
+    args_parser.add_option(dump_execution_statistics, "Count the instructions and basic blocks that each executable runs, and dump the counts on exit", "dump-execution-statistics", {});
+    args_parser.add_option(dump_gc_statistics, "Dump the garbage collector's pause times on exit", "dump-gc-statistics", {});
+    args_parser.add_option(sample_javascript_stacks, "Sample the stack of JavaScript functions, and dump the folded stacks on exit", "sample-javascript-stacks", {});
     args_parser.add_option(s_as_module, "Treat as module", "as-module", 'm');
     args_parser.add_option(s_print_last_result, "Print last result", "print-last-result", 'l');
     args_parser.add_option(s_strip_ansi, "Disable ANSI colors", "disable-ansi-colors", 'i');
@@ -553,12 +565,20 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.parse(arguments);
 
     bool syntax_highlight = !disable_syntax_highlight;
+    if (disable_jit)
+        JS::Bytecode::g_jit_enabled = false;
+    if (disable_bytecode_optimizations)
+        JS::Bytecode::g_optimize_bytecode = false;
 
     AK::set_debug_enabled(!disable_debug_printing);
     s_history_path = TRY(String::formatted("{}/.js-history", Core::StandardPaths::home_directory()));
 
     g_vm = TRY(JS::VM::create());
     g_vm->set_dynamic_imports_allowed(true);
+    if (dump_execution_statistics)
+        g_vm->bytecode_interpreter().set_collects_execution_statistics(true);
+    if (sample_javascript_stacks)
+        g_vm->enable_sampling_profiler();
 
     if (!disable_debug_printing) {
         // NOTE: These will print out both warnings when using something like Promise.reject().catch(...) -
@@ -840,7 +860,16 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
         // We resolve modules as if it is the first file
 
-        if (!TRY(parse_and_run(realm, builder.string_view(), source_name)))
+        auto success = TRY(parse_and_run(realm, builder.string_view(), source_name));
+        if (dump_property_lookup_cache_statistics)
+            g_vm->bytecode_interpreter().property_lookup_cache_statistics().dump();
+        if (dump_execution_statistics)
+            g_vm->bytecode_interpreter().dump_execution_statistics();
+        if (dump_gc_statistics)
+            g_vm->heap().garbage_collection_statistics().dump();
+        if (sample_javascript_stacks)
+            g_vm->sampling_profiler()->dump_folded_stacks();
+        if (!success)
             return 1;
     }
 
@@ -54,6 +54,10 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
                 event_mask |= PERF_EVENT_SYSCALL;
             else if (event_type == "filesystem")
                 event_mask |= PERF_EVENT_FILESYSTEM;
+            else if (event_type == "mutex_wait")
+                event_mask |= PERF_EVENT_MUTEX_WAIT;
+            else if (event_type == "mutex_hold")
+                event_mask |= PERF_EVENT_MUTEX_HOLD;
             else {
                 warnln("Unknown event type '{}' specified.", event_type);
                 exit(1);
@@ -65,7 +69,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     auto print_types = [] {
         outln();
-        outln("Event type can be one of: sample, context_switch, page_fault, syscall, filesystem, kmalloc and kfree.");
+        outln("Event type can be one of: sample, context_switch, page_fault, syscall, filesystem, kmalloc, kfree, mutex_wait and mutex_hold.");
     };
 
     if (!args_parser.parse(arguments, Core::ArgsParser::FailureBehavior::PrintUsage)) {
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AllOf.h>
 #include <AK/Assertions.h>
 #include <AK/DOSPackedTime.h>
 #include <AK/NumberFormat.h>
@@ -162,31 +163,51 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     Vector<Archive::ZipMember> zip_directories;
 
-    auto success = TRY(zip_file->for_each_member([&](auto zip_member) {
-        bool keep_file = false;
+    auto extract_member = [&](Archive::ZipMember const& zip_member) {
+        if (!unpack_zip_member(zip_member, quiet))
+            return false;
+        if (zip_member.is_directory)
+            zip_directories.append(zip_member);
+        return true;
+    };
 
-        if (!file_filters.is_empty()) {
-            for (auto& filter : file_filters) {
-                // Convert underscore wildcards (usual unzip convention) to question marks (as used by StringUtils)
-                auto string_filter = filter.replace("_"sv, "?"sv, ReplaceMode::All);
-                if (zip_member.name.bytes_as_string_view().matches(string_filter, CaseSensitivity::CaseSensitive)) {
-                    keep_file = true;
-                    break;
-                }
+    // Filters without any wildcards name members directly, so look them up in the archive's index instead of scanning every member.
+    bool filters_are_literal_names = !file_filters.is_empty() && all_of(file_filters, [](StringView filter) {
+        return !filter.contains('*') && !filter.contains('?') && !filter.contains('_') && !filter.contains('\\');
+    });
+
+    bool success = true;
+    if (filters_are_literal_names) {
+        for (auto filter : file_filters) {
+            auto zip_member = TRY(zip_file->member_with_name(filter));
+            if (zip_member.has_value() && !extract_member(*zip_member)) {
+                success = false;
+                break;
             }
-        } else {
-            keep_file = true;
         }
+    } else {
+        success = TRY(zip_file->for_each_member([&](auto zip_member) {
+            bool keep_file = false;
+
+            if (!file_filters.is_empty()) {
+                for (auto& filter : file_filters) {
+                    // Convert underscore wildcards (usual unzip convention) to question marks (as used by StringUtils)
+                    auto string_filter = filter.replace("_"sv, "?"sv, ReplaceMode::All);
+                    if (zip_member.name.bytes_as_string_view().matches(string_filter, CaseSensitivity::CaseSensitive)) {
+                        keep_file = true;
+                        break;
+                    }
+                }
+            } else {
+                keep_file = true;
+            }
 
-        if (keep_file) {
-            if (!unpack_zip_member(zip_member, quiet))
+            if (keep_file && !extract_member(zip_member))
                 return IterationDecision::Break;
-            if (zip_member.is_directory)
-                zip_directories.append(zip_member);
-        }
 
-        return IterationDecision::Continue;
-    }));
+            return IterationDecision::Continue;
+        }));
+    }
 
     if (!success) {
         return 1;